@@ -1,9 +1,21 @@
 #include "AssetStore.hpp"
+#include "CookedMesh.hpp"
+#include "CookedPhysicsMesh.hpp"
+#include "CompressedImage.hpp"
+#include "BlockCompressor.hpp"
 #include "Model.hpp"
 #include "Image.hpp"
 
+#include <GraphicsEngine_LL/MeshOptimizer.hpp>
+#include <GraphicsEngine_LL/MeshSimplifier.hpp>
+#include <BaseLibrary/FrameProfiler.hpp>
+#include <BaseLibrary/JobSystem/Parallel.hpp>
+#include <BaseLibrary/Memory/MemoryTracker.hpp>
+
 #include <rapidjson/document.h>
+#include <algorithm>
 #include <cstdlib>
+#include <optional>
 
 #include <InlineMath.hpp>
 
@@ -22,6 +34,7 @@ struct StringErrorPosition {
 	std::string line;
 };
 static StringErrorPosition GetStringErrorPosition(const std::string& str, size_t errorCharacter);
+static std::string ReadText(const std::filesystem::path& path);
 
 
 
@@ -33,72 +46,431 @@ AssetStore::AssetStore(gxeng::GraphicsEngine* graphicsEngine, pxeng_bl::PhysicsE
 
 
 std::shared_ptr<gxeng::Mesh> AssetStore::LoadGraphicsMesh(std::filesystem::path path) {
-	auto& cache = m_cachedGraphicsMeshes[path];
-	if (!cache.m_forced) {
-		cache.m_forced = cache.m_reference.lock();
+	return Load(m_cachedGraphicsMeshes, path, [this, path] { return ForceLoadGraphicsMesh(path); });
+}
+
+
+std::shared_ptr<gxeng::Image> AssetStore::LoadImage(std::filesystem::path path) {
+	return Load(m_cachedImages, path, [this, path] { return ForceLoadImage(path); });
+}
+
+
+std::shared_ptr<gxeng::MaterialShader> AssetStore::LoadMaterialShader(std::filesystem::path path) {
+	return Load(m_cachedMaterialShaders, path, [this, path] { return ForceLoadMaterialShader(path); });
+}
+
+
+std::shared_ptr<gxeng::Material> AssetStore::LoadMaterial(std::filesystem::path path) {
+	return GetMaterial(Load(m_cachedMaterials, path, [this, path] { return ForceLoadMaterial(path); }));
+}
+
+
+std::shared_ptr<pxeng_bl::MeshShape> AssetStore::LoadPhysicsMesh(std::filesystem::path path, bool dynamic) {
+	return Load(dynamic ? m_cachedDynamicPhysicsMeshes : m_cachedPhysicsMeshes, path, [this, path, dynamic] { return ForceLoadPhysicsMesh(path, dynamic); });
+}
+
+
+jobs::Future<std::shared_ptr<gxeng::Mesh>> AssetStore::LoadGraphicsMeshAsync(std::filesystem::path path) {
+	return LoadAsync(m_cachedGraphicsMeshes, path, [this, path] { return ForceLoadGraphicsMesh(path); });
+}
+
+
+jobs::Future<std::shared_ptr<gxeng::Image>> AssetStore::LoadImageAsync(std::filesystem::path path) {
+	return LoadAsync(m_cachedImages, path, [this, path] { return ForceLoadImage(path); });
+}
+
+
+jobs::Future<std::shared_ptr<gxeng::Material>> AssetStore::LoadMaterialAsync(std::filesystem::path path) {
+	auto resources = LoadAsync(m_cachedMaterials, path, [this, path] { return ForceLoadMaterial(path); });
+
+	auto unwrap = [](jobs::Future<std::shared_ptr<MaterialResources>> resources) -> jobs::Future<std::shared_ptr<gxeng::Material>> {
+		co_return GetMaterial(co_await resources);
+	};
+	return m_graphicsEngine->GetJobScheduler().Enqueue(jobs::JobOptions{ jobs::eJobPriority::BACKGROUND }, unwrap, std::move(resources));
+}
+
+
+jobs::Future<std::shared_ptr<pxeng_bl::MeshShape>> AssetStore::LoadPhysicsMeshAsync(std::filesystem::path path, bool dynamic) {
+	return LoadAsync(dynamic ? m_cachedDynamicPhysicsMeshes : m_cachedPhysicsMeshes, path, [this, path, dynamic] { return ForceLoadPhysicsMesh(path, dynamic); });
+}
+
+
+void AssetStore::PrefetchGraphicsMesh(std::filesystem::path path) {
+	Prefetch(m_cachedGraphicsMeshes, path, [this, path] { return ForceLoadGraphicsMesh(path); });
+}
+
+
+void AssetStore::PrefetchImage(std::filesystem::path path) {
+	Prefetch(m_cachedImages, path, [this, path] { return ForceLoadImage(path); });
+}
+
+
+void AssetStore::PrefetchMaterial(std::filesystem::path path) {
+	Prefetch(m_cachedMaterials, path, [this, path] { return ForceLoadMaterial(path); });
+}
+
+
+void AssetStore::SetCacheBudget(uint64_t cpuBytes, uint64_t gpuBytes) {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	m_budget = { cpuBytes, gpuBytes };
+	Trim();
+}
+
+
+void AssetStore::TrimCache() {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	Trim();
+}
+
+
+AssetCacheStatistics AssetStore::GetCacheStatistics() const {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	AssetCacheStatistics statistics = m_statistics;
+
+	auto& self = const_cast<AssetStore&>(*this);
+	AssetSize total;
+	std::vector<RetainedAsset> retained;
+	CollectCached(self.m_cachedGraphicsMeshes, total, retained);
+	CollectCached(self.m_cachedImages, total, retained);
+	CollectCached(self.m_cachedMaterials, total, retained);
+	statistics.cpuBytes = total.cpu;
+	statistics.gpuBytes = total.gpu;
+	statistics.retainedCount = retained.size();
+	return statistics;
+}
+
+
+template <class T, class LoadFunc>
+std::shared_ptr<T> AssetStore::Load(AssetMap<T>& assets, const std::filesystem::path& path, LoadFunc load) {
+	std::unique_lock<std::mutex> lk(m_mtx);
+	auto& cache = assets[path]; // Nodes of the map are never erased, the reference stays valid without the lock.
+	if (cache.m_asset) {
+		cache.m_lastUse = ++m_clock;
+		++m_statistics.hits;
+		return cache.m_asset;
 	}
-	if (!cache.m_forced) {
-		cache.m_forced = ForceLoadGraphicsMesh(path);
-		cache.m_reference = cache.m_forced;
+	++m_statistics.misses;
+
+	// Loading does not wait for an async load of the same asset:
+	// that would block the calling thread, which may well be a worker the async load needs.
+	lk.unlock();
+	std::shared_ptr<T> asset;
+	{
+		MemoryTagScope memoryTag(eMemoryTag::ASSETS);
+		asset = load();
 	}
-	return cache.m_forced;
+	lk.lock();
+
+	cache.m_lastUse = ++m_clock;
+	if (cache.m_asset) {
+		return cache.m_asset;
+	}
+	cache.m_asset = asset;
+	Trim();
+	return asset;
 }
 
 
-std::shared_ptr<gxeng::Image> AssetStore::LoadImage(std::filesystem::path path) {
-	auto& cache = m_cachedImages[path];
-	if (!cache.m_forced) {
-		cache.m_forced = cache.m_reference.lock();
+template <class T, class LoadFunc>
+jobs::Future<std::shared_ptr<T>> AssetStore::LoadAsync(AssetMap<T>& assets, const std::filesystem::path& path, LoadFunc load) {
+	jobs::Scheduler& scheduler = m_graphicsEngine->GetJobScheduler();
+	const jobs::JobOptions options{ jobs::eJobPriority::BACKGROUND };
+
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	auto& cache = assets[path];
+	if (auto asset = cache.m_asset) {
+		cache.m_lastUse = ++m_clock;
+		cache.m_pending.reset();
+		++m_statistics.hits;
+		return scheduler.Enqueue(options, [asset] { return asset; });
+	}
+
+	// Start a new load unless one is still running, a finished one has failed.
+	if (!cache.m_pending || cache.m_pending->ready()) {
+		StartLoad(cache, std::move(load));
+	}
+	else {
+		++m_statistics.hits;
+	}
+
+	// Every caller gets a future of its own that joins the shared load.
+	auto join = [](std::shared_ptr<jobs::Future<std::shared_ptr<T>>> pending) -> jobs::Future<std::shared_ptr<T>> {
+		co_return co_await *pending;
+	};
+	return scheduler.Enqueue(options, join, cache.m_pending);
+}
+
+
+template <class T, class LoadFunc>
+void AssetStore::Prefetch(AssetMap<T>& assets, const std::filesystem::path& path, LoadFunc load) {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	auto& cache = assets[path];
+	if (cache.m_asset) {
+		// Moves it to the back of the eviction order, it's about to be needed.
+		cache.m_lastUse = ++m_clock;
+		return;
 	}
-	if (!cache.m_forced) {
-		cache.m_forced = ForceLoadImage(path);
-		cache.m_reference = cache.m_forced;
+	if (!cache.m_pending || cache.m_pending->ready()) {
+		StartLoad(cache, std::move(load));
+		++m_statistics.prefetches;
 	}
-	return cache.m_forced;
 }
 
 
-std::shared_ptr<gxeng::MaterialShader> AssetStore::LoadMaterialShader(std::filesystem::path path) {
-	auto& cache = m_cachedMaterialShaders[path];
-	if (!cache.m_forced) {
-		cache.m_forced = cache.m_reference.lock();
+template <class T, class LoadFunc>
+void AssetStore::StartLoad(CachedAsset<T>& cache, LoadFunc load) {
+	jobs::Scheduler& scheduler = m_graphicsEngine->GetJobScheduler();
+	const jobs::JobOptions options{ jobs::eJobPriority::BACKGROUND };
+
+	auto job = [this, &cache, load = std::move(load)] {
+		std::shared_ptr<T> asset;
+		{
+			MemoryTagScope memoryTag(eMemoryTag::ASSETS);
+			asset = load();
+		}
+
+		std::lock_guard<std::mutex> lkg(m_mtx);
+		cache.m_lastUse = ++m_clock;
+		if (cache.m_asset) {
+			return cache.m_asset;
+		}
+		cache.m_asset = asset;
+		Trim();
+		return asset;
+	};
+	cache.m_pending = std::make_shared<jobs::Future<std::shared_ptr<T>>>(scheduler.Enqueue(options, std::move(job)));
+	++m_statistics.misses;
+}
+
+
+void AssetStore::Trim() {
+	// Finished loads hold a reference to their result, which would count as a user.
+	ResetFinishedLoads(m_cachedGraphicsMeshes);
+	ResetFinishedLoads(m_cachedImages);
+	ResetFinishedLoads(m_cachedMaterialShaders);
+	ResetFinishedLoads(m_cachedMaterials);
+	ResetFinishedLoads(m_cachedPhysicsMeshes);
+	ResetFinishedLoads(m_cachedDynamicPhysicsMeshes);
+
+	// Evicted materials release their images, those are only unused in the next round.
+	std::vector<RetainedAsset> retained;
+	for (;;) {
+		AssetSize total;
+		retained.clear();
+		CollectCached(m_cachedGraphicsMeshes, total, retained);
+		CollectCached(m_cachedImages, total, retained);
+		CollectCached(m_cachedMaterials, total, retained);
+
+		auto fits = [&] { return total.cpu <= m_budget.cpu && total.gpu <= m_budget.gpu; };
+		if (fits()) {
+			return;
+		}
+
+		std::sort(retained.begin(), retained.end(), [](const RetainedAsset& lhs, const RetainedAsset& rhs) {
+			return lhs.lastUse < rhs.lastUse;
+		});
+		size_t evictionCount = 0;
+		for (const RetainedAsset& asset : retained) {
+			if (fits()) {
+				break;
+			}
+			asset.evict(asset.cache);
+			total.cpu -= asset.size.cpu;
+			total.gpu -= asset.size.gpu;
+			++evictionCount;
+		}
+		m_statistics.evictions += evictionCount;
+		if (evictionCount == 0) {
+			return;
+		}
 	}
-	if (!cache.m_forced) {
-		cache.m_forced = ForceLoadMaterialShader(path);
-		cache.m_reference = cache.m_forced;
+}
+
+
+template <class T>
+void AssetStore::ResetFinishedLoads(AssetMap<T>& assets) {
+	for (auto& [path, cache] : assets) {
+		if (cache.m_pending && cache.m_pending->ready()) {
+			cache.m_pending.reset();
+		}
 	}
-	return cache.m_forced;
 }
 
 
-std::shared_ptr<gxeng::Material> AssetStore::LoadMaterial(std::filesystem::path path) {
-	auto& cache = m_cachedMaterials[path];
-	if (!cache.m_forced) {
-		cache.m_forced = cache.m_reference.lock();
+template <class T>
+void AssetStore::CollectCached(AssetMap<T>& assets, AssetSize& total, std::vector<RetainedAsset>& retained) {
+	for (auto& [path, cache] : assets) {
+		if (!cache.m_asset) {
+			continue;
+		}
+		AssetSize size = GetAssetSize(*cache.m_asset);
+		total.cpu += size.cpu;
+		total.gpu += size.gpu;
+		if (cache.m_asset.use_count() == 1) {
+			auto evict = [](void* entry) { static_cast<CachedAsset<T>*>(entry)->m_asset.reset(); };
+			retained.push_back({ cache.m_lastUse, size, &cache, evict });
+		}
 	}
-	if (!cache.m_forced) {
-		cache.m_forced = ForceLoadMaterial(path);
-		cache.m_reference = cache.m_forced;
+}
+
+
+AssetStore::AssetSize AssetStore::GetAssetSize(const gxeng::Mesh& mesh) {
+	AssetSize size;
+	for (size_t stream = 0; stream < mesh.GetNumStreams(); ++stream) {
+		size.gpu += mesh.GetVertexBuffer(stream).GetSize();
+	}
+	if (mesh.GetNumStreams() > 0) {
+		size.gpu += mesh.GetIndexBuffer().GetSize();
 	}
-	return cache.m_forced;
+	return size;
 }
 
 
-std::shared_ptr<pxeng_bl::MeshShape> AssetStore::LoadPhysicsMesh(std::filesystem::path path, bool dynamic) {
-	auto& cache = m_cachedPhysicsMeshes[path];
-	if (!cache.m_forced) {
-		cache.m_forced = cache.m_reference.lock();
+AssetStore::AssetSize AssetStore::GetAssetSize(const gxeng::Image& image) {
+	return { image.GetSourceSize(), image.GetMemorySize() };
+}
+
+
+AssetStore::AssetSize AssetStore::GetAssetSize(const MaterialResources&) {
+	// The images are counted on their own.
+	return {};
+}
+
+
+std::shared_ptr<gxeng::Material> AssetStore::GetMaterial(std::shared_ptr<MaterialResources> resources) {
+	gxeng::Material* material = resources->material.get();
+	return std::shared_ptr<gxeng::Material>(std::move(resources), material);
+}
+
+
+void AssetStore::SetHotReload(bool enabled) {
+	m_hotReload = enabled;
+	m_fileWatcher.ClearDirectories();
+	if (enabled) {
+		for (const auto& directory : m_directories) {
+			m_fileWatcher.AddDirectory(directory);
+		}
+	}
+}
+
+
+size_t AssetStore::ReloadChangedAssets() {
+	// Loads started by the last call are swapped in first, so that a file changing every time does not stall the swap.
+	size_t swapped = 0;
+	for (auto it = m_reloads.begin(); it != m_reloads.end();) {
+		if (!it->ready()) {
+			++it;
+			continue;
+		}
+		try {
+			it->get()();
+			++swapped;
+		}
+		catch (std::exception&) {
+			// The file may be half written or broken, the old asset is kept then.
+		}
+		it = m_reloads.erase(it);
+	}
+
+	if (!m_hotReload) {
+		return swapped;
+	}
+	std::vector<std::filesystem::path> changedFiles = m_fileWatcher.Poll();
+	if (changedFiles.empty()) {
+		return swapped;
+	}
+	std::unordered_set<std::filesystem::path, PathHash> changed(changedFiles.begin(), changedFiles.end());
+
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	StartReloads(m_cachedGraphicsMeshes, changed, [this](const std::filesystem::path& path, std::shared_ptr<gxeng::Mesh> mesh) -> ReloadResult {
+		std::shared_ptr<gxeng::Mesh> reloaded = ForceLoadGraphicsMesh(path);
+		return [mesh, reloaded] { *mesh = std::move(*reloaded); };
+	});
+	StartReloads(m_cachedImages, changed, [this](const std::filesystem::path& path, std::shared_ptr<gxeng::Image> image) -> ReloadResult {
+		std::shared_ptr<gxeng::Image> reloaded = ForceLoadImage(path);
+		return [image, reloaded] { *image = std::move(*reloaded); };
+	});
+	StartReloads(m_cachedMaterials, changed, [this](const std::filesystem::path& path, std::shared_ptr<MaterialResources> material) -> ReloadResult {
+		std::shared_ptr<MaterialResources> reloaded = ForceLoadMaterial(path);
+		return [material, reloaded] { SwapMaterial(*material, *reloaded); };
+	});
+	StartReloads(m_cachedMaterialShaders, changed, [this](const std::filesystem::path& path, std::shared_ptr<gxeng::MaterialShader> shader) -> ReloadResult {
+		// Material shaders are linked to their ports, so the graph is set again instead of moving a new one in.
+		auto graph = std::dynamic_pointer_cast<gxeng::MaterialShaderGraph>(shader);
+		if (!graph) {
+			return [] {};
+		}
+		std::string desc = ReadText(GetFullPath(path));
+		std::unique_ptr<gxeng::MaterialShaderGraph> check(m_graphicsEngine->CreateMaterialShaderGraph());
+		check->SetGraph(desc);
+		return [this, graph, desc = std::move(desc)] {
+			graph->SetGraph(desc);
+			RebuildMaterials(graph.get());
+		};
+	});
+	return swapped;
+}
+
+
+template <class T, class ReloadFunc>
+void AssetStore::StartReloads(AssetMap<T>& assets, const std::unordered_set<std::filesystem::path, PathHash>& changed, ReloadFunc reload) {
+	jobs::Scheduler& scheduler = m_graphicsEngine->GetJobScheduler();
+	const jobs::JobOptions options{ jobs::eJobPriority::BACKGROUND };
+
+	for (auto& [path, cache] : assets) {
+		if (!cache.m_asset) {
+			continue;
+		}
+		std::filesystem::path fullPath;
+		try {
+			fullPath = std::filesystem::absolute(GetFullPath(path)).lexically_normal();
+		}
+		catch (std::exception&) {
+			continue; // Deleted, the asset in memory stays.
+		}
+		if (changed.count(fullPath) > 0) {
+			m_reloads.push_back(scheduler.Enqueue(options, [reload, path = path, asset = cache.m_asset] { return reload(path, asset); }));
+		}
 	}
-	if (!cache.m_forced) {
-		cache.m_forced = ForceLoadPhysicsMesh(path, dynamic);
-		cache.m_reference = cache.m_forced;
+}
+
+
+void AssetStore::RebuildMaterials(const gxeng::MaterialShader* shader) {
+	std::vector<std::pair<std::filesystem::path, std::shared_ptr<MaterialResources>>> materials;
+	{
+		std::lock_guard<std::mutex> lkg(m_mtx);
+		for (auto& [path, cache] : m_cachedMaterials) {
+			if (cache.m_asset && cache.m_asset->shader.get() == shader) {
+				materials.push_back({ path, cache.m_asset });
+			}
+		}
+	}
+
+	// The parameters of the materials follow the inputs of the shader.
+	for (auto& [path, material] : materials) {
+		try {
+			std::shared_ptr<MaterialResources> reloaded = ForceLoadMaterial(path);
+			SwapMaterial(*material, *reloaded);
+		}
+		catch (std::exception&) {
+			// Left as it is, the material is rebuilt when its file is fixed.
+		}
 	}
-	return cache.m_forced;
+}
+
+
+void AssetStore::SwapMaterial(MaterialResources& target, MaterialResources& source) {
+	*target.material = std::move(*source.material);
+	target.shader = std::move(source.shader);
+	target.images = std::move(source.images);
 }
 
 
 void AssetStore::AddSourceDirectory(std::filesystem::path directory) {
 	m_directories.insert(directory);
+	if (m_hotReload) {
+		m_fileWatcher.AddDirectory(directory);
+	}
 }
 void AssetStore::RemoveSourceDirectory(std::filesystem::path directory) {
 	auto it = m_directories.find(directory);
@@ -106,28 +478,121 @@ void AssetStore::RemoveSourceDirectory(std::filesystem::path directory) {
 		throw InvalidArgumentException("Directory is not part of the asset store.");
 	}
 	m_directories.erase(it);
+	m_fileWatcher.RemoveDirectory(directory);
 }
 void AssetStore::ClearSourceDirectories() {
 	m_directories.clear();
+	m_fileWatcher.ClearDirectories();
 }
 
 
 std::shared_ptr<gxeng::Mesh> AssetStore::ForceLoadGraphicsMesh(std::filesystem::path path) {
 	path = GetFullPath(path);
 
-	Model model{ path.generic_u8string() };
+	std::shared_ptr<gxeng::Mesh> mesh(m_graphicsEngine->CreateMesh());
+
+	// Importing is slow, so meshes are cooked next to their source file at first load.
+	std::filesystem::path cookedPath = path;
+	cookedPath += ".cooked";
+	uint64_t sourceStamp = CookedMesh::GetSourceStamp(path);
+	if (std::filesystem::exists(cookedPath)) {
+		try {
+			std::optional<CookedMesh> cooked;
+			{
+				INL_PROFILE_SCOPE("Asset read");
+				cooked.emplace(cookedPath);
+			}
+			if (cooked->GetSourceStamp() == sourceStamp) {
+				INL_PROFILE_SCOPE("Asset upload");
+				mesh->SetPacked(cooked->GetData());
+				return mesh;
+			}
+		}
+		catch (RuntimeException&) {
+			// Corrupt or of an older version, cook it again.
+		}
+	}
+
+	std::optional<Model> model;
+	{
+		INL_PROFILE_SCOPE("Asset decode");
+		model.emplace(path.generic_u8string());
+	}
 
 	CoordSysLayout csys;
 	csys.x = AxisDir::POS_X;
 	csys.y = AxisDir::POS_Z;
 	csys.z = AxisDir::NEG_Y;
 
-	auto vertices = model.GetVertices<gxeng::Position<0>, gxeng::Normal<0>, gxeng::TexCoord<0>>(0, csys);
-	auto indices = model.GetIndices(0);
+	// Submeshes are extracted in parallel and merged, the mesh is drawn with a single material.
+	using VertexT = gxeng::Vertex<gxeng::Position<0>, gxeng::Normal<0>, gxeng::TexCoord<0>>;
+	std::vector<VertexT> vertices;
+	std::vector<unsigned> indices;
+	{
+		INL_PROFILE_SCOPE("Asset vertex conversion");
+		const size_t submeshCount = model->SubmeshCount();
+		std::vector<std::vector<VertexT>> submeshVertices(submeshCount);
+		std::vector<std::vector<unsigned>> submeshIndices(submeshCount);
+		jobs::CooperativeFor(&m_graphicsEngine->GetJobScheduler(), submeshCount, 1, [&](size_t first, size_t last) {
+			for (size_t submesh = first; submesh < last; ++submesh) {
+				submeshVertices[submesh] = model->GetVertices<gxeng::Position<0>, gxeng::Normal<0>, gxeng::TexCoord<0>>(unsigned(submesh), csys);
+				submeshIndices[submesh] = model->GetIndices(unsigned(submesh));
+			}
+		});
 
-	std::shared_ptr<gxeng::Mesh> mesh(m_graphicsEngine->CreateMesh());
+		for (size_t submesh = 0; submesh < submeshCount; ++submesh) {
+			const unsigned baseVertex = unsigned(vertices.size());
+			vertices.insert(vertices.end(), submeshVertices[submesh].begin(), submeshVertices[submesh].end());
+			for (unsigned index : submeshIndices[submesh]) {
+				indices.push_back(baseVertex + index);
+			}
+		}
+	}
+	if (vertices.empty()) {
+		throw InvalidArgumentException("Model has no vertices.", path.generic_u8string());
+	}
 
-	mesh->Set(vertices.data(), &vertices[0].GetReader(), vertices.size(), indices.data(), indices.size());
+	// Coarser levels of detail only re-index the same vertices.
+	std::vector<std::vector<unsigned>> lodIndices;
+	{
+		INL_PROFILE_SCOPE("Asset mesh optimization");
+		std::vector<Vec3> positions;
+		positions.reserve(vertices.size());
+		for (const auto& vertex : vertices) {
+			positions.push_back(Vec3(vertex.position));
+		}
+		indices = gxeng::MeshOptimizer::OptimizeVertexCache(indices, vertices.size());
+		indices = gxeng::MeshOptimizer::OptimizeOverdraw(indices, positions);
+		lodIndices = gxeng::MeshSimplifier::BuildLodChain(positions, indices);
+		for (size_t level = 1; level < lodIndices.size(); ++level) {
+			lodIndices[level] = gxeng::MeshOptimizer::OptimizeVertexCache(lodIndices[level], vertices.size());
+		}
+
+		// Vertices in the order the levels first read them, the finest level first.
+		std::vector<unsigned> remap = gxeng::MeshOptimizer::OptimizeVertexFetch(lodIndices, vertices.size());
+		decltype(vertices) reordered(vertices.size());
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			reordered[remap[i]] = vertices[i];
+		}
+		vertices = std::move(reordered);
+	}
+
+	std::vector<uint8_t> storage;
+	gxeng::Mesh::PackedData packed;
+	{
+		INL_PROFILE_SCOPE("Asset vertex compression");
+		packed = gxeng::Mesh::Pack(vertices.data(), &vertices[0].GetReader(), vertices.size(), lodIndices, storage, &m_graphicsEngine->GetJobScheduler());
+	}
+	try {
+		INL_PROFILE_SCOPE("Asset cook write");
+		CookedMesh::Write(cookedPath, packed, sourceStamp);
+	}
+	catch (FileNotFoundException&) {
+		// Asset directories may be read-only, the mesh is imported every time then.
+	}
+
+	INL_PROFILE_SCOPE("Asset upload");
+	mesh->SetPacked(packed);
 
 	return mesh;
 }
@@ -135,13 +600,13 @@ std::shared_ptr<gxeng::Mesh> AssetStore::ForceLoadGraphicsMesh(std::filesystem::
 
 std::shared_ptr<gxeng::MaterialShader> AssetStore::ForceLoadMaterialShader(std::filesystem::path path) {
 	path = GetFullPath(path);
-
-	std::ifstream file(path);
-	if (!file.is_open()) {
-		throw FileNotFoundException("Asset file exists but cannot be opened.", path.generic_u8string());
+	std::string desc;
+	{
+		INL_PROFILE_SCOPE("Asset read");
+		desc = ReadText(path);
 	}
-	std::string desc((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 
+	INL_PROFILE_SCOPE("Asset material shader");
 	std::shared_ptr<gxeng::MaterialShaderGraph> resource(m_graphicsEngine->CreateMaterialShaderGraph());
 	resource->SetGraph(desc);
 
@@ -149,45 +614,54 @@ std::shared_ptr<gxeng::MaterialShader> AssetStore::ForceLoadMaterialShader(std::
 }
 
 
-std::shared_ptr<gxeng::Material> AssetStore::ForceLoadMaterial(std::filesystem::path path) {
+auto AssetStore::ForceLoadMaterial(std::filesystem::path path) -> std::shared_ptr<MaterialResources> {
 	using namespace rapidjson;
 
 	path = GetFullPath(path);
 
-	std::ifstream file(path);
-	if (!file.is_open()) {
-		throw FileNotFoundException("Asset file exists but cannot be opened.", path.generic_u8string());
+	std::string desc;
+	{
+		INL_PROFILE_SCOPE("Asset read");
+		std::ifstream file(path);
+		if (!file.is_open()) {
+			throw FileNotFoundException("Asset file exists but cannot be opened.", path.generic_u8string());
+		}
+		desc.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
 	}
-	std::string desc((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 
-	// Parse document
+	// Parse document, the shader and the images are loaded in their own zones after it.
 	Document doc;
-	doc.Parse(desc.c_str());
-	ParseErrorCode ec = doc.GetParseError();
-	if (ec != kParseErrorNone) {
-		size_t errorCharacter = doc.GetErrorOffset();
-		auto[lineNumber, characterNumber, line] = GetStringErrorPosition(desc, errorCharacter);
-		throw InvalidArgumentException("JSON descripion has syntax errors.", "Check line " + std::to_string(lineNumber) + ":" + std::to_string(characterNumber));
-	}
+	{
+		INL_PROFILE_SCOPE("Asset material");
+		doc.Parse(desc.c_str());
+		ParseErrorCode ec = doc.GetParseError();
+		if (ec != kParseErrorNone) {
+			size_t errorCharacter = doc.GetErrorOffset();
+			auto[lineNumber, characterNumber, line] = GetStringErrorPosition(desc, errorCharacter);
+			throw InvalidArgumentException("JSON descripion has syntax errors.", "Check line " + std::to_string(lineNumber) + ":" + std::to_string(characterNumber));
+		}
 
-	AssertThrow(doc.IsObject(), "Material JSON document must have an object as root.");
-	AssertThrow(doc.HasMember("shader") && doc["shader"].IsString(), R"(Material JSON document must have members "shader" and "inputs")");
-	AssertThrow(doc.HasMember("inputs"), R"(Material JSON document must have members "header", "shader" and "inputs")");
+		AssertThrow(doc.IsObject(), "Material JSON document must have an object as root.");
+		AssertThrow(doc.HasMember("shader") && doc["shader"].IsString(), R"(Material JSON document must have members "shader" and "inputs")");
+		AssertThrow(doc.HasMember("inputs"), R"(Material JSON document must have members "header", "shader" and "inputs")");
+	}
 
 
 	std::string shaderName = doc["shader"].GetString();
 
-	std::shared_ptr<gxeng::MaterialShader> shader = LoadMaterialShader(shaderName);
-	std::shared_ptr<gxeng::Material> material(m_graphicsEngine->CreateMaterial());
-	material->SetShader(shader.get());
+	auto resources = std::make_shared<MaterialResources>();
+	resources->shader = LoadMaterialShader(shaderName);
+	resources->material.reset(m_graphicsEngine->CreateMaterial());
+	gxeng::Material& material = *resources->material;
+	material.SetShader(resources->shader.get());
 
 	const auto& inputs = doc["inputs"];
 
 
-	auto SetParam = [this](gxeng::Material::Parameter& param, const std::string& name, const Value& value) {
+	auto SetParam = [this, &resources](gxeng::Material::Parameter& param, const std::string& name, const Value& value) {
 		try {
 			if (value.IsString()) {
-				SetMaterialParameter(param, value.GetString());
+				SetMaterialParameter(param, value.GetString(), resources->images);
 			}
 			else if (value.IsFloat()) {
 				SetMaterialParameter(param, value.GetFloat());
@@ -204,14 +678,14 @@ std::shared_ptr<gxeng::Material> AssetStore::ForceLoadMaterial(std::filesystem::
 	if (inputs.IsObject()) {
 		for (auto it = inputs.MemberBegin(); it != inputs.MemberEnd(); ++it) {
 			std::string name = it->name.GetString();
-			gxeng::Material::Parameter& param = (*material)[name];
+			gxeng::Material::Parameter& param = material[name];
 			SetParam(param, name, it->value);
 		}
 	}
 	else if (inputs.IsArray()) {
 		int idx;
 		for (auto it = inputs.Begin(); it != inputs.End(); ++it, ++idx) {
-			gxeng::Material::Parameter& param = (*material)[idx];
+			gxeng::Material::Parameter& param = material[idx];
 			SetParam(param, std::to_string(idx), *it);
 		}
 	}
@@ -219,27 +693,68 @@ std::shared_ptr<gxeng::Material> AssetStore::ForceLoadMaterial(std::filesystem::
 		throw InvalidArgumentException("Material JSON input list must be an object with key-value pairs or an array with the values.");
 	}
 
-	return material;
+	return resources;
 }
 
 
 std::shared_ptr<pxeng_bl::MeshShape> AssetStore::ForceLoadPhysicsMesh(std::filesystem::path path, bool dynamic) {
 	path = GetFullPath(path);
 
-	Model model{ path.generic_u8string() };
+	std::shared_ptr<pxeng_bl::MeshShape> mesh(m_physicsEngine->CreateMeshShape());
+
+	// Building the BVH of large static meshes is slow, it is cooked next to the source at first load.
+	std::filesystem::path cookedPath = path;
+	cookedPath += ".cookedphysics";
+	uint64_t sourceHash = 0;
+	if (!dynamic) {
+		sourceHash = CookedPhysicsMesh::GetSourceHash(path);
+		if (std::filesystem::exists(cookedPath)) {
+			try {
+				INL_PROFILE_SCOPE("Asset read");
+				if (CookedPhysicsMesh::Read(cookedPath, sourceHash, *mesh)) {
+					return mesh;
+				}
+			}
+			catch (RuntimeException&) {
+				// Corrupt or of an older version, cook it again.
+			}
+		}
+	}
+
+	std::optional<Model> model;
+	{
+		INL_PROFILE_SCOPE("Asset decode");
+		model.emplace(path.generic_u8string());
+	}
 
 	CoordSysLayout csys;
 	csys.x = AxisDir::POS_X;
 	csys.y = AxisDir::POS_Z;
 	csys.z = AxisDir::NEG_Y;
 
-	auto vertices = model.GetVertices<gxeng::Position<0>>(0, csys);
-	auto indices = model.GetIndices(0);
+	std::vector<gxeng::Vertex<gxeng::Position<0>>> vertices;
+	std::vector<unsigned> indices;
+	{
+		INL_PROFILE_SCOPE("Asset vertex conversion");
+		vertices = model->GetVertices<gxeng::Position<0>>(0, csys);
+		indices = model->GetIndices(0);
+	}
 
-	std::shared_ptr<pxeng_bl::MeshShape> mesh(m_physicsEngine->CreateMeshShape());
-	
 	static_assert(sizeof(vertices[0]) == sizeof(Vec3));
-	mesh->SetMesh(reinterpret_cast<const Vec3*>(vertices.data()), vertices.size(), indices.data(), indices.size());
+	{
+		INL_PROFILE_SCOPE("Asset physics mesh");
+		mesh->SetMesh(reinterpret_cast<const Vec3*>(vertices.data()), vertices.size(), indices.data(), indices.size(), dynamic);
+	}
+
+	if (!dynamic && mesh->GetBvhSize() > 0) {
+		try {
+			INL_PROFILE_SCOPE("Asset cook write");
+			CookedPhysicsMesh::Write(cookedPath, *mesh, sourceHash);
+		}
+		catch (FileNotFoundException&) {
+			// Asset directories may be read-only, the BVH is built every time then.
+		}
+	}
 
 	return mesh;
 }
@@ -268,16 +783,78 @@ gxeng::IPixelReader& GetPixelReader(eChannelType channelType, int channelCount)
 }
 
 
+// Streams the levels from the mapped file, which stays open as long as the image.
+class CompressedMipSource : public gxeng::IMipSource {
+public:
+	explicit CompressedMipSource(std::unique_ptr<CompressedImage> image) : m_image(std::move(image)) {}
+
+	const void* GetMipData(unsigned mipLevel, size_t& bytesPerRow) const override {
+		const CompressedImage::MipLevel& level = m_image->GetMipLevels()[mipLevel];
+		bytesPerRow = level.bytesPerRow;
+		return level.data;
+	}
+private:
+	std::unique_ptr<CompressedImage> m_image;
+};
+
+
+static void SetCompressedImage(gxeng::Image& resource, std::unique_ptr<CompressedImage> image) {
+	uint32_t width = image->GetWidth();
+	uint32_t height = image->GetHeight();
+	gxeng::ePixelChannelType channelType = image->GetChannelType();
+	int channelCount = image->GetChannelCount();
+	int mipCount = (int)image->GetMipLevels().size();
+	resource.SetStreamedLayout(width, height, channelType, channelCount, gxeng::ePixelClass::LINEAR, mipCount, std::make_shared<CompressedMipSource>(std::move(image)));
+}
+
+
 std::shared_ptr<gxeng::Image> AssetStore::ForceLoadImage(std::filesystem::path path) {
 	path = GetFullPath(path);
 
-	Image image{ path.generic_u8string() };
+	std::shared_ptr<gxeng::Image> resource(m_graphicsEngine->CreateImage());
+
+	// Block compressed files are streamed straight from the mapped file.
+	if (CompressedImage::IsCompressedImageFile(path)) {
+		try {
+			INL_PROFILE_SCOPE("Asset read");
+			SetCompressedImage(*resource, std::make_unique<CompressedImage>(path));
+			return resource;
+		}
+		catch (NotSupportedException&) {
+			// Not block compressed, FreeImage reads the rest.
+		}
+	}
+
+	std::filesystem::path cookedPath = path;
+	cookedPath += ".cooked.dds";
+	if (m_compressTextures && std::filesystem::exists(cookedPath) && std::filesystem::last_write_time(cookedPath) >= std::filesystem::last_write_time(path)) {
+		try {
+			INL_PROFILE_SCOPE("Asset read");
+			SetCompressedImage(*resource, std::make_unique<CompressedImage>(cookedPath));
+			return resource;
+		}
+		catch (Exception&) {
+			// Corrupt, cook it again.
+		}
+	}
+
+	std::optional<Image> decoded;
+	{
+		INL_PROFILE_SCOPE("Asset decode");
+		decoded.emplace(path.generic_u8string());
+	}
+	const Image& image = *decoded;
 	int channelCount = image.GetChannelCount();
 	eChannelType channelType = image.GetType();
 
+	if (m_compressTextures && channelType == eChannelType::INT8) {
+		CookImage(*resource, image, cookedPath);
+		return resource;
+	}
+
 	gxeng::IPixelReader& reader = GetPixelReader(channelType, channelCount);
-	
-	std::shared_ptr<gxeng::Image> resource(m_graphicsEngine->CreateImage());
+
+	INL_PROFILE_SCOPE("Asset upload");
 	resource->SetLayout(image.GetWidth(), (uint32_t)image.GetHeight(), gxeng::ePixelChannelType::INT8_NORM, 4, gxeng::ePixelClass::LINEAR);
 	resource->Update(0, 0, image.GetWidth(), (uint32_t)image.GetHeight(), 0, image.GetData(), reader);
 
@@ -285,7 +862,48 @@ std::shared_ptr<gxeng::Image> AssetStore::ForceLoadImage(std::filesystem::path p
 }
 
 
-void AssetStore::SetMaterialParameter(gxeng::Material::Parameter& param, std::string value) {
+void AssetStore::CookImage(gxeng::Image& resource, const Image& image, const std::filesystem::path& cookedPath) {
+	uint32_t width = (uint32_t)image.GetWidth();
+	uint32_t height = (uint32_t)image.GetHeight();
+	bool hasAlpha;
+	std::vector<std::vector<uint8_t>> mipLevels;
+	{
+		INL_PROFILE_SCOPE("Asset block compression");
+		std::vector<uint8_t> pixels = BlockCompressor::ToRgba(static_cast<const uint8_t*>(image.GetData()), width, height, image.GetChannelCount(), image.GetBytesPerRow());
+
+		// Images without transparency only need BC1, half the size of BC3.
+		hasAlpha = BlockCompressor::HasAlpha(pixels);
+
+		uint32_t mipWidth = width, mipHeight = height;
+		while (true) {
+			mipLevels.push_back(hasAlpha ? BlockCompressor::CompressBc3(pixels, mipWidth, mipHeight) : BlockCompressor::CompressBc1(pixels, mipWidth, mipHeight));
+			if (mipWidth == 1 && mipHeight == 1) {
+				break;
+			}
+			pixels = BlockCompressor::Downsample(pixels, mipWidth, mipHeight);
+			mipWidth = std::max(mipWidth / 2, 1u);
+			mipHeight = std::max(mipHeight / 2, 1u);
+		}
+	}
+	gxeng::ePixelChannelType channelType = hasAlpha ? gxeng::ePixelChannelType::BC3 : gxeng::ePixelChannelType::BC1;
+
+	try {
+		INL_PROFILE_SCOPE("Asset cook write");
+		CompressedImage::WriteDds(cookedPath, width, height, channelType, mipLevels);
+	}
+	catch (FileNotFoundException&) {
+		// Asset directories may be read-only, the image is compressed every time then.
+	}
+
+	INL_PROFILE_SCOPE("Asset upload");
+	resource.SetLayout(width, height, channelType, 4, gxeng::ePixelClass::LINEAR, (int)mipLevels.size());
+	for (size_t i = 0; i < mipLevels.size(); ++i) {
+		resource.UpdateCompressed((int)i, mipLevels[i].data());
+	}
+}
+
+
+void AssetStore::SetMaterialParameter(gxeng::Material::Parameter& param, std::string value, std::vector<std::shared_ptr<gxeng::Image>>& images) {
 	switch (param.GetType()) {
 		case gxeng::eMaterialShaderParamType::COLOR: {
 			const char* endptr;
@@ -309,6 +927,7 @@ void AssetStore::SetMaterialParameter(gxeng::Material::Parameter& param, std::st
 		case gxeng::eMaterialShaderParamType::BITMAP_VALUE_2D: {
 			auto image = LoadImage(value);
 			param = image.get();
+			images.push_back(std::move(image));
 			break;
 		}
 		default: throw InvalidArgumentException("Parameter and given value have different types.");
@@ -341,6 +960,15 @@ std::filesystem::path AssetStore::GetFullPath(std::filesystem::path localPath) c
 
 
 
+std::string ReadText(const std::filesystem::path& path) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		throw FileNotFoundException("Asset file exists but cannot be opened.", path.generic_u8string());
+	}
+	return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+
 StringErrorPosition GetStringErrorPosition(const std::string& str, size_t errorCharacter) {
 	int currentCharacter = 0;
 	int characterNumber = 0;
@@ -1,9 +1,16 @@
 #pragma once
 
 #include <unordered_map>
+#include <limits>
+#include <vector>
 #include <memory>
+#include <mutex>
 #include <string_view>
 #include <filesystem>
+#include <functional>
+
+#include <BaseLibrary/FileWatcher.hpp>
+#include <BaseLibrary/JobSystem/Future.hpp>
 
 #include <GraphicsEngine_LL/GraphicsEngine.hpp>
 #include <GraphicsEngine_LL/Mesh.hpp>
@@ -20,18 +27,41 @@
 namespace inl::asset {
 
 
+class Image;
+
+
+/// <summary> Counters of the asset cache since the store was created, and the memory it holds right now. </summary>
+struct AssetCacheStatistics {
+	uint64_t hits = 0; // Requests served from memory or by joining a load in progress.
+	uint64_t misses = 0; // Requests that had to read the file, including prefetches.
+	uint64_t evictions = 0; // Unused assets released to stay within the budget.
+	uint64_t prefetches = 0; // Prefetch hints that started a load.
+	uint64_t cpuBytes = 0; // Held by the cached meshes and images, used or not.
+	uint64_t gpuBytes = 0;
+	size_t retainedCount = 0; // Cached meshes, images and materials nobody else holds.
+};
+
+
 /// <summary>
 /// Loads assets from disk into CPU or GPU memory.
-/// Assets are cached in memory and are not released until explicitely requested.
+/// Assets are cached in memory. Meshes, images and materials are kept after their last user releases them,
+/// for as long as the cache fits the budget of <see cref="SetCacheBudget"/>, the least recently requested go first.
+/// Material shaders and physics meshes are kept until the store is destroyed.
+/// <para/>
+/// The async variants parse and decode on the background lane of the graphics engine's job system,
+/// GPU uploads are queued for the next frame. Concurrent requests for the same path share one load.
+/// The store must outlive the loads it has started.
 /// </summary>
 class AssetStore {
 public:
 	AssetStore(gxeng::GraphicsEngine* graphicsEngine, pxeng_bl::PhysicsEngine* physicsEngine);
+	AssetStore(const AssetStore&) = delete;
+	AssetStore& operator=(const AssetStore&) = delete;
 
 	/// <summary> Loads a model file from a common format such as FBX. </summary>
 	std::shared_ptr<gxeng::Mesh> LoadGraphicsMesh(std::filesystem::path path);
 
-	/// <summary> Loads an image file from a common format such as JPG or TIF. </summary>
+	/// <summary> Loads an image file from a common format such as JPG or TIF, or a block compressed DDS or KTX2 file. </summary>
 	std::shared_ptr<gxeng::Image> LoadImage(std::filesystem::path path);
 
 	/// <summary> Loads a material shader from a JSON graph description. </summary>
@@ -43,6 +73,40 @@ public:
 	/// <summary> Loads a model file from a common format such as FBX. </summary>
 	std::shared_ptr<pxeng_bl::MeshShape> LoadPhysicsMesh(std::filesystem::path path, bool dynamic);
 
+	jobs::Future<std::shared_ptr<gxeng::Mesh>> LoadGraphicsMeshAsync(std::filesystem::path path);
+	jobs::Future<std::shared_ptr<gxeng::Image>> LoadImageAsync(std::filesystem::path path);
+	jobs::Future<std::shared_ptr<gxeng::Material>> LoadMaterialAsync(std::filesystem::path path);
+	jobs::Future<std::shared_ptr<pxeng_bl::MeshShape>> LoadPhysicsMeshAsync(std::filesystem::path path, bool dynamic);
+
+	/// <summary> Starts loading the asset in the background if it's not in memory, for example when the camera nears a zone. </summary>
+	/// <remarks> The asset is then retained like a recently released one until it is requested or evicted. </remarks>
+	void PrefetchGraphicsMesh(std::filesystem::path path);
+	void PrefetchImage(std::filesystem::path path);
+	void PrefetchMaterial(std::filesystem::path path);
+
+	/// <summary> Sets how much memory the cached meshes and images may take before unused ones are released. </summary>
+	/// <remarks> Assets in use are never released, so the cache may exceed the budget.
+	///		CPU memory counts the sources streamed images read their levels from. Unlimited by default. </remarks>
+	void SetCacheBudget(uint64_t cpuBytes, uint64_t gpuBytes);
+
+	/// <summary> Releases unused assets until the cache fits the budget. </summary>
+	/// <remarks> Loads do this already, call it after dropping many assets at once to free their memory right away. </remarks>
+	void TrimCache();
+
+	AssetCacheStatistics GetCacheStatistics() const;
+
+	/// <summary> Watches the source directories for changes, see <see cref="ReloadChangedAssets"/>. Off by default. </summary>
+	void SetHotReload(bool enabled);
+
+	/// <summary> Swaps the assets reloaded in the background into the objects in use,
+	///		then starts reloading the cached assets whose files changed since the last call. </summary>
+	/// <remarks> Meshes, images, materials and material shaders keep their address, so entities and materials pointing to them
+	///		pick up the new contents. Call it between frames, like other changes to meshes and images, a few times a second.
+	///		Materials are rebuilt when their material shader changes. When a reload fails the old asset stays,
+	///		and is reloaded again when its file next changes. </remarks>
+	/// <returns> The number of assets swapped. </returns>
+	size_t ReloadChangedAssets();
+
 	/// <summary> Adds a new source directory to look for assets. </summary>
 	void AddSourceDirectory(std::filesystem::path directory);
 
@@ -52,17 +116,10 @@ public:
 	/// <summary> Removes all added asset directories. </summary>
 	void ClearSourceDirectories();
 
-private:
-	std::shared_ptr<gxeng::Mesh> ForceLoadGraphicsMesh(std::filesystem::path path);
-	std::shared_ptr<gxeng::Image> ForceLoadImage(std::filesystem::path path);
-	std::shared_ptr<gxeng::MaterialShader> ForceLoadMaterialShader(std::filesystem::path path);
-	std::shared_ptr<gxeng::Material> ForceLoadMaterial(std::filesystem::path path);
-	std::shared_ptr<pxeng_bl::MeshShape> ForceLoadPhysicsMesh(std::filesystem::path path, bool dynamic);
-
-	void SetMaterialParameter(gxeng::Material::Parameter& param, std::string value);
-	void SetMaterialParameter(gxeng::Material::Parameter& param, float value);
+	/// <summary> When enabled, 8 bit images are block compressed with mips at first load and cooked next to their source. </summary>
+	/// <remarks> DDS and KTX2 files are always uploaded as they are, this only concerns formats like PNG or JPG. </remarks>
+	void SetTextureCompression(bool enabled) { m_compressTextures = enabled; }
 
-	std::filesystem::path GetFullPath(std::filesystem::path localPath) const;
 private:
 	struct PathHash {
 		size_t operator()(const std::filesystem::path& obj) const {
@@ -71,16 +128,94 @@ private:
 	};
 	template <class T>
 	struct CachedAsset {
-		std::weak_ptr<T> m_reference;
-		std::shared_ptr<T> m_forced;
+		std::shared_ptr<T> m_asset;
+		std::shared_ptr<jobs::Future<std::shared_ptr<T>>> m_pending; // The async load in progress, if any.
+		uint64_t m_lastUse = 0; // Tick of the cache clock when last requested or loaded.
+	};
+	template <class T>
+	using AssetMap = std::unordered_map<std::filesystem::path, CachedAsset<T>, PathHash>;
+	/// <summary> The material only points to its shader and images, the pointers handed out own them too. </summary>
+	struct MaterialResources {
+		std::shared_ptr<gxeng::MaterialShader> shader;
+		std::vector<std::shared_ptr<gxeng::Image>> images;
+		std::unique_ptr<gxeng::Material> material; // Last, so that it goes before what it points to.
+	};
+	using ReloadResult = std::function<void()>; // Swaps the reloaded asset in.
+	struct AssetSize {
+		uint64_t cpu = 0;
+		uint64_t gpu = 0;
 	};
+	struct RetainedAsset {
+		uint64_t lastUse;
+		AssetSize size;
+		void* cache;
+		void (*evict)(void* cache);
+	};
+
+	/// <summary> Returns the cached asset or loads it on the calling thread. </summary>
+	template <class T, class LoadFunc>
+	std::shared_ptr<T> Load(AssetMap<T>& assets, const std::filesystem::path& path, LoadFunc load);
+	/// <summary> Returns the cached asset or joins the load in progress, or starts one. </summary>
+	template <class T, class LoadFunc>
+	jobs::Future<std::shared_ptr<T>> LoadAsync(AssetMap<T>& assets, const std::filesystem::path& path, LoadFunc load);
+	/// <summary> Starts the load unless the asset is cached or a load is in progress. </summary>
+	template <class T, class LoadFunc>
+	void Prefetch(AssetMap<T>& assets, const std::filesystem::path& path, LoadFunc load);
+	/// <summary> Enqueues a background load that caches its result. Requires the lock. </summary>
+	template <class T, class LoadFunc>
+	void StartLoad(CachedAsset<T>& cache, LoadFunc load);
+
+	/// <summary> Evicts the least recently used unused assets until the cache fits the budget. Requires the lock. </summary>
+	void Trim();
+	template <class T>
+	static void ResetFinishedLoads(AssetMap<T>& assets);
+	/// <summary> Adds up the size of the cached assets and lists the unused ones. </summary>
+	template <class T>
+	static void CollectCached(AssetMap<T>& assets, AssetSize& total, std::vector<RetainedAsset>& retained);
+	static AssetSize GetAssetSize(const gxeng::Mesh& mesh);
+	static AssetSize GetAssetSize(const gxeng::Image& image);
+	static AssetSize GetAssetSize(const MaterialResources& material);
+	static std::shared_ptr<gxeng::Material> GetMaterial(std::shared_ptr<MaterialResources> resources);
+
+	/// <summary> Starts reloading the cached assets of any of the <paramref name="changed"/> files. Requires the lock. </summary>
+	template <class T, class ReloadFunc>
+	void StartReloads(AssetMap<T>& assets, const std::unordered_set<std::filesystem::path, PathHash>& changed, ReloadFunc reload);
+	/// <summary> Rebuilds the materials of the shader in place, on the calling thread. </summary>
+	void RebuildMaterials(const gxeng::MaterialShader* shader);
+	static void SwapMaterial(MaterialResources& target, MaterialResources& source);
+
+	std::shared_ptr<gxeng::Mesh> ForceLoadGraphicsMesh(std::filesystem::path path);
+	std::shared_ptr<gxeng::Image> ForceLoadImage(std::filesystem::path path);
+	std::shared_ptr<gxeng::MaterialShader> ForceLoadMaterialShader(std::filesystem::path path);
+	std::shared_ptr<MaterialResources> ForceLoadMaterial(std::filesystem::path path);
+	std::shared_ptr<pxeng_bl::MeshShape> ForceLoadPhysicsMesh(std::filesystem::path path, bool dynamic);
+
+	/// <summary> Compresses the image with a full mip chain, saves it to <paramref name="cookedPath"/> and uploads it. </summary>
+	void CookImage(gxeng::Image& resource, const Image& image, const std::filesystem::path& cookedPath);
+
+	/// <summary> Images the parameter loads are added to <paramref name="images"/>, the material keeps them alive. </summary>
+	void SetMaterialParameter(gxeng::Material::Parameter& param, std::string value, std::vector<std::shared_ptr<gxeng::Image>>& images);
+	void SetMaterialParameter(gxeng::Material::Parameter& param, float value);
+
+	std::filesystem::path GetFullPath(std::filesystem::path localPath) const;
 private:
 	std::unordered_set<std::filesystem::path, PathHash> m_directories;
-	std::unordered_map<std::filesystem::path, CachedAsset<gxeng::Mesh>, PathHash> m_cachedGraphicsMeshes;
-	std::unordered_map<std::filesystem::path, CachedAsset<gxeng::Image>, PathHash> m_cachedImages;
-	std::unordered_map<std::filesystem::path, CachedAsset<gxeng::MaterialShader>, PathHash> m_cachedMaterialShaders;
-	std::unordered_map<std::filesystem::path, CachedAsset<gxeng::Material>, PathHash> m_cachedMaterials;
-	std::unordered_map<std::filesystem::path, CachedAsset<pxeng_bl::MeshShape>, PathHash> m_cachedPhysicsMeshes;
+	AssetMap<gxeng::Mesh> m_cachedGraphicsMeshes;
+	AssetMap<gxeng::Image> m_cachedImages;
+	AssetMap<gxeng::MaterialShader> m_cachedMaterialShaders;
+	AssetMap<MaterialResources> m_cachedMaterials;
+	AssetMap<pxeng_bl::MeshShape> m_cachedPhysicsMeshes;
+	AssetMap<pxeng_bl::MeshShape> m_cachedDynamicPhysicsMeshes; // Static meshes and hulls of the same file differ.
+	mutable std::mutex m_mtx; // Guards the caches and the statistics, loads run without holding it.
+	uint64_t m_clock = 0;
+	AssetSize m_budget = { std::numeric_limits<uint64_t>::max(), std::numeric_limits<uint64_t>::max() };
+	AssetCacheStatistics m_statistics;
+
+	bool m_compressTextures = false;
+
+	bool m_hotReload = false;
+	FileWatcher m_fileWatcher;
+	std::vector<jobs::Future<ReloadResult>> m_reloads; // Loads of changed files in progress.
 
 	gxeng::GraphicsEngine* m_graphicsEngine;
 	pxeng_bl::PhysicsEngine* m_physicsEngine;
@@ -0,0 +1,225 @@
+#include "BlockCompressor.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+
+namespace inl::asset {
+
+
+namespace {
+
+uint16_t PackRgb565(int r, int g, int b) {
+	return uint16_t((r * 31 + 127) / 255 << 11 | (g * 63 + 127) / 255 << 5 | (b * 31 + 127) / 255);
+}
+
+void UnpackRgb565(uint16_t color, int (&rgb)[3]) {
+	int r = color >> 11 & 31, g = color >> 5 & 63, b = color & 31;
+	rgb[0] = r << 3 | r >> 2;
+	rgb[1] = g << 2 | g >> 4;
+	rgb[2] = b << 3 | b >> 2;
+}
+
+} // namespace
+
+
+std::vector<uint8_t> BlockCompressor::ToRgba(const uint8_t* pixels, uint32_t width, uint32_t height, int channelCount, size_t bytesPerRow) {
+	std::vector<uint8_t> rgba(size_t(width) * height * 4, 0);
+	size_t pitch = bytesPerRow > 0 ? bytesPerRow : size_t(width) * channelCount;
+	for (uint32_t y = 0; y < height; ++y) {
+		const uint8_t* row = pixels + y * pitch;
+		for (uint32_t x = 0; x < width; ++x) {
+			uint8_t* dst = &rgba[(size_t(y) * width + x) * 4];
+			std::memcpy(dst, row + size_t(x) * channelCount, std::min(channelCount, 4));
+			if (channelCount < 4) {
+				dst[3] = 255;
+			}
+		}
+	}
+	return rgba;
+}
+
+
+bool BlockCompressor::HasAlpha(const std::vector<uint8_t>& rgba) {
+	for (size_t i = 3; i < rgba.size(); i += 4) {
+		if (rgba[i] != 255) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+std::vector<uint8_t> BlockCompressor::Downsample(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height) {
+	uint32_t newWidth = std::max(width / 2, 1u);
+	uint32_t newHeight = std::max(height / 2, 1u);
+	std::vector<uint8_t> result(size_t(newWidth) * newHeight * 4);
+	for (uint32_t y = 0; y < newHeight; ++y) {
+		uint32_t y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+		for (uint32_t x = 0; x < newWidth; ++x) {
+			uint32_t x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+			for (int c = 0; c < 4; ++c) {
+				int sum = rgba[(size_t(y0) * width + x0) * 4 + c] + rgba[(size_t(y0) * width + x1) * 4 + c]
+					+ rgba[(size_t(y1) * width + x0) * 4 + c] + rgba[(size_t(y1) * width + x1) * 4 + c];
+				result[(size_t(y) * newWidth + x) * 4 + c] = uint8_t((sum + 2) / 4);
+			}
+		}
+	}
+	return result;
+}
+
+
+std::vector<uint8_t> BlockCompressor::CompressBc1(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height) {
+	uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+	std::vector<uint8_t> result(size_t(blocksX) * blocksY * 8);
+	uint8_t block[16][4];
+	for (uint32_t by = 0; by < blocksY; ++by) {
+		for (uint32_t bx = 0; bx < blocksX; ++bx) {
+			LoadBlock(rgba, width, height, bx, by, block);
+			EncodeColor(block, &result[(size_t(by) * blocksX + bx) * 8]);
+		}
+	}
+	return result;
+}
+
+
+std::vector<uint8_t> BlockCompressor::CompressBc3(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height) {
+	uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+	std::vector<uint8_t> result(size_t(blocksX) * blocksY * 16);
+	uint8_t block[16][4];
+	for (uint32_t by = 0; by < blocksY; ++by) {
+		for (uint32_t bx = 0; bx < blocksX; ++bx) {
+			LoadBlock(rgba, width, height, bx, by, block);
+			uint8_t* output = &result[(size_t(by) * blocksX + bx) * 16];
+			EncodeAlpha(block, output);
+			EncodeColor(block, output + 8);
+		}
+	}
+	return result;
+}
+
+
+void BlockCompressor::LoadBlock(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t (&block)[16][4]) {
+	// Blocks over the edge repeat the last row and column.
+	for (uint32_t y = 0; y < 4; ++y) {
+		uint32_t sy = std::min(blockY * 4 + y, height - 1);
+		for (uint32_t x = 0; x < 4; ++x) {
+			uint32_t sx = std::min(blockX * 4 + x, width - 1);
+			std::memcpy(block[y * 4 + x], &rgba[(size_t(sy) * width + sx) * 4], 4);
+		}
+	}
+}
+
+
+void BlockCompressor::EncodeColor(const uint8_t (&block)[16][4], uint8_t* output) {
+	int lower[3] = { 255, 255, 255 }, upper[3] = { 0, 0, 0 };
+	for (const auto& pixel : block) {
+		for (int c = 0; c < 3; ++c) {
+			lower[c] = std::min(lower[c], int(pixel[c]));
+			upper[c] = std::max(upper[c], int(pixel[c]));
+		}
+	}
+
+	// The box diagonal that follows the colors: flip red and blue against green if they anti-correlate.
+	int mean[3];
+	for (int c = 0; c < 3; ++c) {
+		mean[c] = (lower[c] + upper[c]) / 2;
+	}
+	int covarianceRG = 0, covarianceBG = 0;
+	for (const auto& pixel : block) {
+		covarianceRG += (pixel[0] - mean[0]) * (pixel[1] - mean[1]);
+		covarianceBG += (pixel[2] - mean[2]) * (pixel[1] - mean[1]);
+	}
+	if (covarianceRG < 0) {
+		std::swap(lower[0], upper[0]);
+	}
+	if (covarianceBG < 0) {
+		std::swap(lower[2], upper[2]);
+	}
+
+	// Inset the box a little, the extremes are rarely hit after quantization.
+	for (int c = 0; c < 3; ++c) {
+		int inset = (upper[c] - lower[c]) / 16;
+		upper[c] = std::clamp(upper[c] - inset, 0, 255);
+		lower[c] = std::clamp(lower[c] + inset, 0, 255);
+	}
+
+	uint16_t color0 = PackRgb565(upper[0], upper[1], upper[2]);
+	uint16_t color1 = PackRgb565(lower[0], lower[1], lower[2]);
+	if (color0 < color1) {
+		std::swap(color0, color1); // The greater endpoint first selects the four color mode.
+	}
+
+	uint32_t indices = 0;
+	if (color0 != color1) {
+		int palette[4][3];
+		UnpackRgb565(color0, palette[0]);
+		UnpackRgb565(color1, palette[1]);
+		for (int c = 0; c < 3; ++c) {
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+		for (int i = 0; i < 16; ++i) {
+			int bestIndex = 0, bestDistance = INT32_MAX;
+			for (int p = 0; p < 4; ++p) {
+				int distance = 0;
+				for (int c = 0; c < 3; ++c) {
+					int d = block[i][c] - palette[p][c];
+					distance += d * d;
+				}
+				if (distance < bestDistance) {
+					bestDistance = distance;
+					bestIndex = p;
+				}
+			}
+			indices |= uint32_t(bestIndex) << (2 * i);
+		}
+	}
+
+	output[0] = uint8_t(color0);
+	output[1] = uint8_t(color0 >> 8);
+	output[2] = uint8_t(color1);
+	output[3] = uint8_t(color1 >> 8);
+	for (int i = 0; i < 4; ++i) {
+		output[4 + i] = uint8_t(indices >> (8 * i));
+	}
+}
+
+
+void BlockCompressor::EncodeAlpha(const uint8_t (&block)[16][4], uint8_t* output) {
+	int alpha0 = 0, alpha1 = 255;
+	for (const auto& pixel : block) {
+		alpha0 = std::max(alpha0, int(pixel[3]));
+		alpha1 = std::min(alpha1, int(pixel[3]));
+	}
+
+	// With the greater endpoint first, the other six values are interpolated between them.
+	uint64_t indices = 0;
+	if (alpha0 != alpha1) {
+		int palette[8] = { alpha0, alpha1 };
+		for (int i = 1; i < 7; ++i) {
+			palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+		}
+		for (int i = 0; i < 16; ++i) {
+			int bestIndex = 0, bestDistance = INT32_MAX;
+			for (int p = 0; p < 8; ++p) {
+				int distance = std::abs(block[i][3] - palette[p]);
+				if (distance < bestDistance) {
+					bestDistance = distance;
+					bestIndex = p;
+				}
+			}
+			indices |= uint64_t(bestIndex) << (3 * i);
+		}
+	}
+
+	output[0] = uint8_t(alpha0);
+	output[1] = uint8_t(alpha1);
+	for (int i = 0; i < 6; ++i) {
+		output[2 + i] = uint8_t(indices >> (8 * i));
+	}
+}
+
+
+} // namespace inl::asset
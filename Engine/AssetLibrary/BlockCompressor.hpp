@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace inl::asset {
+
+
+/// <summary>
+/// Compresses 8 bit RGBA images into BC1 or BC3 blocks for the texture cook step.
+/// </summary>
+/// <remarks> Endpoints come from the bounding box of each block's colors, which is fast but
+///		falls somewhat short of the quality of dedicated offline compressors. </remarks>
+class BlockCompressor {
+public:
+	/// <summary> Converts 1-4 channel 8 bit pixels to tightly packed RGBA, missing channels are zero, missing alpha is opaque. </summary>
+	static std::vector<uint8_t> ToRgba(const uint8_t* pixels, uint32_t width, uint32_t height, int channelCount, size_t bytesPerRow);
+
+	/// <summary> True if any pixel is not fully opaque. </summary>
+	static bool HasAlpha(const std::vector<uint8_t>& rgba);
+
+	/// <summary> Halves the image with a box filter. Odd sizes round down, but no side gets smaller than one pixel. </summary>
+	static std::vector<uint8_t> Downsample(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height);
+
+	/// <summary> Encodes the colors into BC1 blocks, alpha is dropped. </summary>
+	/// <returns> The blocks row by row, 8 bytes each. </returns>
+	static std::vector<uint8_t> CompressBc1(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height);
+
+	/// <summary> Encodes the colors and the alpha into BC3 blocks. </summary>
+	/// <returns> The blocks row by row, 16 bytes each. </returns>
+	static std::vector<uint8_t> CompressBc3(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height);
+private:
+	static void LoadBlock(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t (&block)[16][4]);
+	static void EncodeColor(const uint8_t (&block)[16][4], uint8_t* output);
+	static void EncodeAlpha(const uint8_t (&block)[16][4], uint8_t* output);
+};
+
+
+} // namespace inl::asset
@@ -0,0 +1,330 @@
+#include "CompressedImage.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+
+
+namespace inl::asset {
+
+
+namespace {
+
+constexpr uint32_t MakeFourCC(char a, char b, char c, char d) {
+	return uint32_t(uint8_t(a)) | uint32_t(uint8_t(b)) << 8 | uint32_t(uint8_t(c)) << 16 | uint32_t(uint8_t(d)) << 24;
+}
+
+constexpr uint32_t DDS_MAGIC = MakeFourCC('D', 'D', 'S', ' ');
+constexpr uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000, DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+constexpr uint32_t DDPF_FOURCC = 0x4;
+constexpr uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200, DDSCAPS2_VOLUME = 0x200000;
+constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+
+struct DdsPixelFormat {
+	uint32_t size;
+	uint32_t flags;
+	uint32_t fourCC;
+	uint32_t rgbBitCount;
+	uint32_t masks[4];
+};
+
+struct DdsHeader {
+	uint32_t size;
+	uint32_t flags;
+	uint32_t height;
+	uint32_t width;
+	uint32_t pitchOrLinearSize;
+	uint32_t depth;
+	uint32_t mipMapCount;
+	uint32_t reserved1[11];
+	DdsPixelFormat pixelFormat;
+	uint32_t caps;
+	uint32_t caps2;
+	uint32_t caps3;
+	uint32_t caps4;
+	uint32_t reserved2;
+};
+
+struct DdsHeaderDx10 {
+	uint32_t dxgiFormat;
+	uint32_t resourceDimension;
+	uint32_t miscFlag;
+	uint32_t arraySize;
+	uint32_t miscFlags2;
+};
+
+static_assert(sizeof(DdsHeader) == 124, "DDS header size is fixed by the format.");
+
+
+constexpr uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+struct Ktx2Header {
+	uint8_t identifier[12];
+	uint32_t vkFormat;
+	uint32_t typeSize;
+	uint32_t pixelWidth;
+	uint32_t pixelHeight;
+	uint32_t pixelDepth;
+	uint32_t layerCount;
+	uint32_t faceCount;
+	uint32_t levelCount;
+	uint32_t supercompressionScheme;
+	uint32_t dfdByteOffset;
+	uint32_t dfdByteLength;
+	uint32_t kvdByteOffset;
+	uint32_t kvdByteLength;
+	uint64_t sgdByteOffset;
+	uint64_t sgdByteLength;
+};
+
+struct Ktx2Level {
+	uint64_t byteOffset;
+	uint64_t byteLength;
+	uint64_t uncompressedByteLength;
+};
+
+static_assert(sizeof(Ktx2Header) == 80, "KTX2 header size is fixed by the format.");
+
+
+bool FormatFromFourCC(uint32_t fourCC, gxeng::ePixelChannelType& channelType) {
+	switch (fourCC) {
+		case MakeFourCC('D', 'X', 'T', '1'): channelType = gxeng::ePixelChannelType::BC1; return true;
+		case MakeFourCC('D', 'X', 'T', '2'):
+		case MakeFourCC('D', 'X', 'T', '3'): channelType = gxeng::ePixelChannelType::BC2; return true;
+		case MakeFourCC('D', 'X', 'T', '4'):
+		case MakeFourCC('D', 'X', 'T', '5'): channelType = gxeng::ePixelChannelType::BC3; return true;
+		case MakeFourCC('A', 'T', 'I', '1'):
+		case MakeFourCC('B', 'C', '4', 'U'): channelType = gxeng::ePixelChannelType::BC4; return true;
+		case MakeFourCC('A', 'T', 'I', '2'):
+		case MakeFourCC('B', 'C', '5', 'U'): channelType = gxeng::ePixelChannelType::BC5; return true;
+		default: return false;
+	}
+}
+
+
+bool FormatFromDxgi(uint32_t dxgiFormat, gxeng::ePixelChannelType& channelType) {
+	// Values of DXGI_FORMAT, typeless and sRGB ones are read as unsigned normalized.
+	switch (dxgiFormat) {
+		case 70: case 71: case 72: channelType = gxeng::ePixelChannelType::BC1; return true;
+		case 73: case 74: case 75: channelType = gxeng::ePixelChannelType::BC2; return true;
+		case 76: case 77: case 78: channelType = gxeng::ePixelChannelType::BC3; return true;
+		case 79: case 80: channelType = gxeng::ePixelChannelType::BC4; return true;
+		case 82: case 83: channelType = gxeng::ePixelChannelType::BC5; return true;
+		case 94: case 95: channelType = gxeng::ePixelChannelType::BC6H; return true;
+		case 97: case 98: case 99: channelType = gxeng::ePixelChannelType::BC7; return true;
+		default: return false;
+	}
+}
+
+
+bool FormatFromVulkan(uint32_t vkFormat, gxeng::ePixelChannelType& channelType) {
+	// Values of VkFormat, sRGB ones are read as unsigned normalized.
+	switch (vkFormat) {
+		case 131: case 132: case 133: case 134: channelType = gxeng::ePixelChannelType::BC1; return true;
+		case 135: case 136: channelType = gxeng::ePixelChannelType::BC2; return true;
+		case 137: case 138: channelType = gxeng::ePixelChannelType::BC3; return true;
+		case 139: channelType = gxeng::ePixelChannelType::BC4; return true;
+		case 141: channelType = gxeng::ePixelChannelType::BC5; return true;
+		case 143: channelType = gxeng::ePixelChannelType::BC6H; return true;
+		case 145: case 146: channelType = gxeng::ePixelChannelType::BC7; return true;
+		default: return false;
+	}
+}
+
+
+size_t GetMipSize(uint32_t width, uint32_t height, size_t blockSize) {
+	return size_t((width + 3) / 4) * size_t((height + 3) / 4) * blockSize;
+}
+
+} // namespace
+
+
+CompressedImage::CompressedImage(const std::filesystem::path& path) : m_file(path) {
+	if (m_file.GetSize() >= sizeof(uint32_t) && *static_cast<const uint32_t*>(m_file.GetData()) == DDS_MAGIC) {
+		ParseDds(path);
+	}
+	else if (m_file.GetSize() >= sizeof(KTX2_IDENTIFIER) && std::memcmp(m_file.GetData(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0) {
+		ParseKtx2(path);
+	}
+	else {
+		throw NotSupportedException("Image is neither a DDS nor a KTX2 file.", path.generic_string());
+	}
+}
+
+
+bool CompressedImage::IsCompressedImageFile(const std::filesystem::path& path) {
+	std::string extension = path.extension().generic_string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)std::tolower(c); });
+	return extension == ".dds" || extension == ".ktx2";
+}
+
+
+void CompressedImage::WriteDds(const std::filesystem::path& path, uint32_t width, uint32_t height, gxeng::ePixelChannelType channelType, const std::vector<std::vector<uint8_t>>& mipLevels) {
+	if (channelType != gxeng::ePixelChannelType::BC1 && channelType != gxeng::ePixelChannelType::BC3) {
+		throw InvalidArgumentException("Only BC1 and BC3 images can be written.");
+	}
+	if (mipLevels.empty()) {
+		throw InvalidArgumentException("At least one mip level is needed.");
+	}
+
+	DdsHeader header = {};
+	header.size = sizeof(DdsHeader);
+	header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+	header.height = height;
+	header.width = width;
+	header.pitchOrLinearSize = uint32_t(mipLevels[0].size());
+	header.mipMapCount = uint32_t(mipLevels.size());
+	header.pixelFormat.size = sizeof(DdsPixelFormat);
+	header.pixelFormat.flags = DDPF_FOURCC;
+	header.pixelFormat.fourCC = channelType == gxeng::ePixelChannelType::BC1 ? MakeFourCC('D', 'X', 'T', '1') : MakeFourCC('D', 'X', 'T', '5');
+	header.caps = DDSCAPS_TEXTURE | (mipLevels.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+	std::filesystem::path temporaryPath = path;
+	temporaryPath += ".tmp";
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			throw FileNotFoundException("Image file cannot be created.", path.generic_string());
+		}
+		file.write(reinterpret_cast<const char*>(&DDS_MAGIC), sizeof(DDS_MAGIC));
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		for (const auto& level : mipLevels) {
+			file.write(reinterpret_cast<const char*>(level.data()), level.size());
+		}
+		if (!file.good()) {
+			file.close();
+			std::error_code ec;
+			std::filesystem::remove(temporaryPath, ec);
+			throw FileNotFoundException("Image file cannot be written.", path.generic_string());
+		}
+	}
+	std::filesystem::rename(temporaryPath, path);
+}
+
+
+size_t CompressedImage::GetBlockSize(gxeng::ePixelChannelType channelType) {
+	return channelType == gxeng::ePixelChannelType::BC1 || channelType == gxeng::ePixelChannelType::BC4 ? 8 : 16;
+}
+
+
+void CompressedImage::ParseDds(const std::filesystem::path& path) {
+	size_t offset = sizeof(uint32_t) + sizeof(DdsHeader);
+	if (m_file.GetSize() < offset) {
+		throw RuntimeException("DDS file is truncated.", path.generic_string());
+	}
+	DdsHeader header;
+	std::memcpy(&header, static_cast<const uint8_t*>(m_file.GetData()) + sizeof(uint32_t), sizeof(header));
+	if (header.size != sizeof(DdsHeader) || header.pixelFormat.size != sizeof(DdsPixelFormat)) {
+		throw RuntimeException("DDS file is corrupt.", path.generic_string());
+	}
+	if ((header.caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) != 0) {
+		throw NotSupportedException("Only 2D textures are supported.", path.generic_string());
+	}
+	if ((header.pixelFormat.flags & DDPF_FOURCC) == 0) {
+		throw NotSupportedException("DDS file is not block compressed.", path.generic_string());
+	}
+
+	gxeng::ePixelChannelType channelType;
+	if (header.pixelFormat.fourCC == MakeFourCC('D', 'X', '1', '0')) {
+		if (m_file.GetSize() < offset + sizeof(DdsHeaderDx10)) {
+			throw RuntimeException("DDS file is truncated.", path.generic_string());
+		}
+		DdsHeaderDx10 headerDx10;
+		std::memcpy(&headerDx10, static_cast<const uint8_t*>(m_file.GetData()) + offset, sizeof(headerDx10));
+		offset += sizeof(DdsHeaderDx10);
+		if (headerDx10.resourceDimension != DDS_DIMENSION_TEXTURE2D || headerDx10.arraySize > 1) {
+			throw NotSupportedException("Only 2D textures are supported.", path.generic_string());
+		}
+		if (!FormatFromDxgi(headerDx10.dxgiFormat, channelType)) {
+			throw NotSupportedException("DDS file is not block compressed.", path.generic_string());
+		}
+	}
+	else if (!FormatFromFourCC(header.pixelFormat.fourCC, channelType)) {
+		throw NotSupportedException("DDS file is not block compressed.", path.generic_string());
+	}
+
+	SetFormat(channelType);
+	uint32_t mipCount = (header.flags & DDSD_MIPMAPCOUNT) != 0 ? std::max(header.mipMapCount, 1u) : 1u;
+	AddMipLevels(path, header.width, header.height, mipCount, offset);
+}
+
+
+void CompressedImage::ParseKtx2(const std::filesystem::path& path) {
+	if (m_file.GetSize() < sizeof(Ktx2Header)) {
+		throw RuntimeException("KTX2 file is truncated.", path.generic_string());
+	}
+	Ktx2Header header;
+	std::memcpy(&header, m_file.GetData(), sizeof(header));
+	if (header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1) {
+		throw NotSupportedException("Only 2D textures are supported.", path.generic_string());
+	}
+	if (header.supercompressionScheme != 0) {
+		throw NotSupportedException("Supercompressed KTX2 files are not supported.", path.generic_string());
+	}
+	gxeng::ePixelChannelType channelType;
+	if (!FormatFromVulkan(header.vkFormat, channelType)) {
+		throw NotSupportedException("KTX2 file is not block compressed.", path.generic_string());
+	}
+	SetFormat(channelType);
+	if (header.pixelWidth == 0 || header.pixelHeight == 0) {
+		throw RuntimeException("Image has no pixels.", path.generic_string());
+	}
+
+	// The level index starts with the finest level, whatever order the data is stored in.
+	uint32_t levelCount = std::max(header.levelCount, 1u);
+	if ((m_file.GetSize() - sizeof(Ktx2Header)) / sizeof(Ktx2Level) < levelCount) {
+		throw RuntimeException("KTX2 file is truncated.", path.generic_string());
+	}
+	const uint8_t* levelIndex = static_cast<const uint8_t*>(m_file.GetData()) + sizeof(Ktx2Header);
+	size_t blockSize = GetBlockSize(channelType);
+	for (uint32_t i = 0; i < levelCount; ++i) {
+		Ktx2Level level;
+		std::memcpy(&level, levelIndex + i * sizeof(Ktx2Level), sizeof(level));
+		uint32_t width = std::max(header.pixelWidth >> i, 1u);
+		uint32_t height = std::max(header.pixelHeight >> i, 1u);
+		if (level.byteOffset > m_file.GetSize() || level.byteLength > m_file.GetSize() - level.byteOffset || level.byteLength < GetMipSize(width, height, blockSize)) {
+			throw RuntimeException("KTX2 file is corrupt.", path.generic_string());
+		}
+		m_mipLevels.push_back({ static_cast<const uint8_t*>(m_file.GetData()) + level.byteOffset, width, height, (width + 3) / 4 * blockSize });
+	}
+}
+
+
+void CompressedImage::SetFormat(gxeng::ePixelChannelType channelType) {
+	m_channelType = channelType;
+	switch (channelType) {
+		case gxeng::ePixelChannelType::BC4: m_channelCount = 1; break;
+		case gxeng::ePixelChannelType::BC5: m_channelCount = 2; break;
+		case gxeng::ePixelChannelType::BC6H: m_channelCount = 3; break;
+		default: m_channelCount = 4; break;
+	}
+}
+
+
+void CompressedImage::AddMipLevels(const std::filesystem::path& path, uint32_t width, uint32_t height, uint32_t count, size_t offset) {
+	if (width == 0 || height == 0) {
+		throw RuntimeException("Image has no pixels.", path.generic_string());
+	}
+	size_t blockSize = GetBlockSize(m_channelType);
+	for (uint32_t i = 0; i < count; ++i) {
+		uint32_t mipWidth = std::max(width >> i, 1u);
+		uint32_t mipHeight = std::max(height >> i, 1u);
+		size_t size = GetMipSize(mipWidth, mipHeight, blockSize);
+		if (size > m_file.GetSize() - offset) {
+			throw RuntimeException("Image file is truncated.", path.generic_string());
+		}
+		m_mipLevels.push_back({ static_cast<const uint8_t*>(m_file.GetData()) + offset, mipWidth, mipHeight, (mipWidth + 3) / 4 * blockSize });
+		offset += size;
+		if (mipWidth == 1 && mipHeight == 1) {
+			break;
+		}
+	}
+}
+
+
+
+} // namespace inl::asset
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <GraphicsEngine/Resources/Pixel.hpp>
+#include <BaseLibrary/Platform/MappedFile.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+
+namespace inl::asset {
+
+
+/// <summary>
+/// A block compressed texture from a DDS or KTX2 file, with all its mip levels.
+/// The file is mapped into memory and the mips point into it, so they can be uploaded as they are.
+/// </summary>
+/// <remarks> Only 2D textures without supercompression are supported. sRGB formats are loaded as linear. </remarks>
+class CompressedImage {
+public:
+	struct MipLevel {
+		const void* data;
+		uint32_t width;
+		uint32_t height;
+		size_t bytesPerRow; // Of a row of 4x4 blocks.
+	};
+public:
+	/// <exception cref="FileNotFoundException"> If the file cannot be opened. </exception>
+	/// <exception cref="NotSupportedException"> If the file is not block compressed or has an unsupported layout. </exception>
+	/// <exception cref="RuntimeException"> If the file is corrupt. </exception>
+	explicit CompressedImage(const std::filesystem::path& path);
+
+	/// <summary> True for the extensions of the file formats this class reads. </summary>
+	static bool IsCompressedImageFile(const std::filesystem::path& path);
+
+	uint32_t GetWidth() const { return m_mipLevels[0].width; }
+	uint32_t GetHeight() const { return m_mipLevels[0].height; }
+	gxeng::ePixelChannelType GetChannelType() const { return m_channelType; }
+	int GetChannelCount() const { return m_channelCount; }
+
+	/// <summary> The finest level first, the data is valid while this object lives. </summary>
+	const std::vector<MipLevel>& GetMipLevels() const { return m_mipLevels; }
+
+	/// <summary> Writes the mip levels into a DDS file. </summary>
+	/// <param name="channelType"> Either <see cref="gxeng::ePixelChannelType::BC1"/> or <see cref="gxeng::ePixelChannelType::BC3"/>. </param>
+	/// <param name="mipLevels"> The packed blocks of each level, the finest first. </param>
+	static void WriteDds(const std::filesystem::path& path, uint32_t width, uint32_t height, gxeng::ePixelChannelType channelType, const std::vector<std::vector<uint8_t>>& mipLevels);
+
+	/// <summary> Size of a 4x4 block of the format in bytes. </summary>
+	static size_t GetBlockSize(gxeng::ePixelChannelType channelType);
+private:
+	void ParseDds(const std::filesystem::path& path);
+	void ParseKtx2(const std::filesystem::path& path);
+	void SetFormat(gxeng::ePixelChannelType channelType);
+	void AddMipLevels(const std::filesystem::path& path, uint32_t width, uint32_t height, uint32_t count, size_t offset);
+private:
+	MappedFile m_file;
+	gxeng::ePixelChannelType m_channelType = gxeng::ePixelChannelType::BC1;
+	int m_channelCount = 0;
+	std::vector<MipLevel> m_mipLevels;
+};
+
+
+
+} // namespace inl::asset
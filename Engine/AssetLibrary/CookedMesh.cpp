@@ -0,0 +1,220 @@
+#include "CookedMesh.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <cstring>
+#include <fstream>
+
+
+namespace inl::asset {
+
+
+namespace {
+
+constexpr uint32_t MAGIC = 'I' | 'N' << 8 | 'L' << 16 | 'M' << 24;
+
+struct FileHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t sourceStamp;
+	uint32_t numStreams;
+	uint32_t numElements;
+	uint32_t numLods;
+	uint32_t is32BitIndex;
+	uint32_t numMeshlets;
+	uint32_t padding;
+	uint64_t numVertices;
+	uint64_t numIndices;
+	float boundsLower[3];
+	float boundsUpper[3];
+	float positionOffset[3];
+	float positionScale;
+};
+
+struct FileStream {
+	uint32_t stride;
+	uint32_t numElements;
+};
+
+struct FileElement {
+	int32_t semantic;
+	int32_t index;
+	int32_t offset;
+	int32_t format;
+};
+
+static_assert(sizeof(gxeng::Mesh::Lod) == 16, "Levels of detail are stored as they are in memory.");
+static_assert(sizeof(gxeng::Meshlet) == 40, "Meshlets are stored as they are in memory.");
+
+
+size_t AlignUp(size_t offset) {
+	return (offset + CookedMesh::DATA_ALIGNMENT - 1) / CookedMesh::DATA_ALIGNMENT * CookedMesh::DATA_ALIGNMENT;
+}
+
+
+class Reader {
+public:
+	Reader(const MappedFile& file, const std::filesystem::path& path) : m_file(file), m_path(path) {}
+
+	template <class T>
+	const T* Read(size_t count) {
+		return static_cast<const T*>(ReadBytes(count * sizeof(T)));
+	}
+	const void* ReadBytes(size_t size) {
+		if (size > m_file.GetSize() - m_offset) {
+			throw RuntimeException("Cooked mesh file is truncated.", m_path.generic_string());
+		}
+		const void* data = static_cast<const uint8_t*>(m_file.GetData()) + m_offset;
+		m_offset += size;
+		return data;
+	}
+	void Align() {
+		m_offset = std::min(AlignUp(m_offset), m_file.GetSize());
+	}
+private:
+	const MappedFile& m_file;
+	const std::filesystem::path& m_path;
+	size_t m_offset = 0;
+};
+
+} // namespace
+
+
+CookedMesh::CookedMesh(const std::filesystem::path& path) : m_file(path) {
+	Reader reader{ m_file, path };
+
+	const FileHeader& header = *reader.Read<FileHeader>(1);
+	if (header.magic != MAGIC) {
+		throw RuntimeException("File is not a cooked mesh.", path.generic_string());
+	}
+	if (header.version != VERSION) {
+		throw RuntimeException("Cooked mesh is of a different version.", path.generic_string());
+	}
+	if (header.numVertices > m_file.GetSize() || header.numIndices > m_file.GetSize()) {
+		throw RuntimeException("Cooked mesh file is corrupt.", path.generic_string());
+	}
+	m_sourceStamp = header.sourceStamp;
+
+	const FileStream* streams = reader.Read<FileStream>(header.numStreams);
+	const FileElement* elements = reader.Read<FileElement>(header.numElements);
+	const gxeng::Mesh::Lod* lods = reader.Read<gxeng::Mesh::Lod>(header.numLods);
+	const gxeng::Meshlet* meshlets = reader.Read<gxeng::Meshlet>(header.numMeshlets);
+
+	size_t elementIndex = 0;
+	for (uint32_t i = 0; i < header.numStreams; ++i) {
+		if (streams[i].numElements > header.numElements - elementIndex) {
+			throw RuntimeException("Cooked mesh file is corrupt.", path.generic_string());
+		}
+		std::vector<gxeng::Mesh::Element> streamElements;
+		for (uint32_t j = 0; j < streams[i].numElements; ++j, ++elementIndex) {
+			streamElements.push_back({ gxeng::eVertexElementSemantic(elements[elementIndex].semantic), elements[elementIndex].index, elements[elementIndex].offset, gxapi::eFormat(elements[elementIndex].format) });
+		}
+		m_data.layout.push_back(std::move(streamElements));
+	}
+	for (uint32_t i = 0; i < header.numStreams; ++i) {
+		reader.Align();
+		m_data.streams.push_back({ reader.ReadBytes(header.numVertices * streams[i].stride), streams[i].stride, header.numVertices });
+	}
+	reader.Align();
+	m_data.indices = reader.ReadBytes(header.numIndices * (header.is32BitIndex ? sizeof(uint32_t) : sizeof(uint16_t)));
+	m_data.numIndices = header.numIndices;
+	m_data.is32BitIndex = header.is32BitIndex != 0;
+
+	m_data.lods.assign(lods, lods + header.numLods);
+	m_data.meshlets.assign(meshlets, meshlets + header.numMeshlets);
+	for (const auto& lod : m_data.lods) {
+		if (lod.firstIndex > m_data.numIndices || lod.indexCount > m_data.numIndices - lod.firstIndex
+			|| lod.firstMeshlet > header.numMeshlets || lod.meshletCount > header.numMeshlets - lod.firstMeshlet) {
+			throw RuntimeException("Cooked mesh file is corrupt.", path.generic_string());
+		}
+	}
+	for (const auto& meshlet : m_data.meshlets) {
+		if (meshlet.firstIndex > m_data.numIndices || meshlet.indexCount > m_data.numIndices - meshlet.firstIndex) {
+			throw RuntimeException("Cooked mesh file is corrupt.", path.generic_string());
+		}
+	}
+	m_data.localBounds = gxeng::BoundingBox(Vec3(header.boundsLower[0], header.boundsLower[1], header.boundsLower[2]),
+											Vec3(header.boundsUpper[0], header.boundsUpper[1], header.boundsUpper[2]));
+	m_data.positionQuantization.offset = Vec3(header.positionOffset[0], header.positionOffset[1], header.positionOffset[2]);
+	m_data.positionQuantization.scale = header.positionScale;
+}
+
+
+uint64_t CookedMesh::GetSourceStamp(const std::filesystem::path& sourcePath) {
+	uint64_t time = (uint64_t)std::filesystem::last_write_time(sourcePath).time_since_epoch().count();
+	uint64_t size = (uint64_t)std::filesystem::file_size(sourcePath);
+	return time ^ (size * 0x9E3779B97F4A7C15ull);
+}
+
+
+void CookedMesh::Write(const std::filesystem::path& path, const gxeng::Mesh::PackedData& data, uint64_t sourceStamp) {
+	if (data.streams.size() != data.layout.size()) {
+		throw InvalidArgumentException("Every vertex stream must have its elements.");
+	}
+
+	FileHeader header = {};
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.sourceStamp = sourceStamp;
+	header.numStreams = uint32_t(data.streams.size());
+	header.numLods = uint32_t(data.lods.size());
+	header.numMeshlets = uint32_t(data.meshlets.size());
+	header.is32BitIndex = data.is32BitIndex;
+	header.numVertices = data.streams.empty() ? 0 : data.streams[0].count;
+	header.numIndices = data.numIndices;
+	std::memcpy(header.boundsLower, &data.localBounds.lower.x, sizeof(header.boundsLower));
+	std::memcpy(header.boundsUpper, &data.localBounds.upper.x, sizeof(header.boundsUpper));
+	std::memcpy(header.positionOffset, &data.positionQuantization.offset.x, sizeof(header.positionOffset));
+	header.positionScale = data.positionQuantization.scale;
+
+	std::vector<FileStream> streams;
+	std::vector<FileElement> elements;
+	for (size_t i = 0; i < data.streams.size(); ++i) {
+		streams.push_back({ data.streams[i].stride, uint32_t(data.layout[i].size()) });
+		for (const auto& element : data.layout[i]) {
+			elements.push_back({ int32_t(element.semantic), int32_t(element.index), int32_t(element.offset), int32_t(element.format) });
+		}
+	}
+	header.numElements = uint32_t(elements.size());
+
+	// Readers never see a half written file, it only replaces the old one once complete.
+	std::filesystem::path temporaryPath = path;
+	temporaryPath += ".tmp";
+	std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		throw FileNotFoundException("Cooked mesh file cannot be created.", path.generic_string());
+	}
+	size_t offset = 0;
+	auto write = [&](const void* bytes, size_t size) {
+		file.write(static_cast<const char*>(bytes), size);
+		offset += size;
+	};
+	auto align = [&] {
+		static constexpr char zeros[DATA_ALIGNMENT] = {};
+		write(zeros, AlignUp(offset) - offset);
+	};
+
+	write(&header, sizeof(header));
+	write(streams.data(), streams.size() * sizeof(FileStream));
+	write(elements.data(), elements.size() * sizeof(FileElement));
+	write(data.lods.data(), data.lods.size() * sizeof(gxeng::Mesh::Lod));
+	write(data.meshlets.data(), data.meshlets.size() * sizeof(gxeng::Meshlet));
+	for (const auto& stream : data.streams) {
+		align();
+		write(stream.data, stream.count * stream.stride);
+	}
+	align();
+	write(data.indices, data.numIndices * (data.is32BitIndex ? sizeof(uint32_t) : sizeof(uint16_t)));
+
+	file.close();
+	if (!file.good()) {
+		std::error_code ec;
+		std::filesystem::remove(temporaryPath, ec);
+		throw FileNotFoundException("Cooked mesh file cannot be written.", path.generic_string());
+	}
+	std::filesystem::rename(temporaryPath, path);
+}
+
+
+
+} // namespace inl::asset
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <GraphicsEngine_LL/Mesh.hpp>
+#include <BaseLibrary/Platform/MappedFile.hpp>
+
+#include <cstdint>
+#include <filesystem>
+
+
+namespace inl::asset {
+
+
+/// <summary>
+/// A mesh saved with its vertices already compressed and its indices converted to the GPU format.
+/// Loading maps the file and hands the streams straight to <see cref="gxeng::Mesh::SetPacked"/>.
+/// </summary>
+/// <remarks>
+/// The file is a header followed by the stream descriptions, vertex elements, levels of detail and meshlets,
+/// then the vertex streams and the index buffer, each aligned to <see cref="DATA_ALIGNMENT"/>.
+/// </remarks>
+class CookedMesh {
+public:
+	/// <summary> Increment when the file layout, the vertex compression or the import changes, older files are cooked again then. </summary>
+	static constexpr uint32_t VERSION = 5;
+	static constexpr size_t DATA_ALIGNMENT = 16;
+
+	/// <summary> Maps the file and checks whether it's a cooked mesh of the current version. </summary>
+	/// <exception cref="FileNotFoundException"> If the file cannot be opened. </exception>
+	/// <exception cref="RuntimeException"> If the file is corrupt or of another version. </exception>
+	explicit CookedMesh(const std::filesystem::path& path);
+
+	/// <summary> Points into the mapped file, only valid while this object lives. </summary>
+	const gxeng::Mesh::PackedData& GetData() const { return m_data; }
+
+	/// <summary> The stamp of the source file the mesh was cooked from. </summary>
+	uint64_t GetSourceStamp() const { return m_sourceStamp; }
+
+	/// <summary> Changes whenever the file is modified. </summary>
+	static uint64_t GetSourceStamp(const std::filesystem::path& sourcePath);
+
+	/// <summary> Writes a cooked mesh. <paramref name="sourceStamp"/> tells later whether it's out of date. </summary>
+	/// <exception cref="FileNotFoundException"> If the file cannot be written. </exception>
+	static void Write(const std::filesystem::path& path, const gxeng::Mesh::PackedData& data, uint64_t sourceStamp);
+private:
+	MappedFile m_file;
+	gxeng::Mesh::PackedData m_data;
+	uint64_t m_sourceStamp = 0;
+};
+
+
+
+} // namespace inl::asset
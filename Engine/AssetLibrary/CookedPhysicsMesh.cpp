@@ -0,0 +1,195 @@
+#include "CookedPhysicsMesh.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+#include <PhysicsEngine_Bullet/MeshShape.hpp>
+
+#include <LinearMath/btAlignedAllocator.h>
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+
+namespace inl::asset {
+
+
+namespace {
+
+constexpr uint32_t MAGIC = 'I' | 'N' << 8 | 'L' << 16 | 'P' << 24;
+
+struct FileHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t sourceHash;
+	uint32_t bulletVersion; // The in place format of the BVH may change between versions.
+	uint32_t scalarSize;
+	uint64_t numVertices;
+	uint64_t numIndices;
+	uint64_t bvhSize;
+};
+
+
+size_t AlignUp(size_t offset) {
+	return (offset + CookedPhysicsMesh::DATA_ALIGNMENT - 1) / CookedPhysicsMesh::DATA_ALIGNMENT * CookedPhysicsMesh::DATA_ALIGNMENT;
+}
+
+
+struct Layout {
+	size_t verticesOffset;
+	size_t indicesOffset;
+	size_t bvhOffset;
+	size_t fileSize;
+};
+
+// Overflows with corrupt headers are caught by comparing against the size of the file.
+Layout GetLayout(const FileHeader& header) {
+	Layout layout;
+	layout.verticesOffset = AlignUp(sizeof(FileHeader));
+	layout.indicesOffset = AlignUp(layout.verticesOffset + header.numVertices * 3 * sizeof(btScalar));
+	layout.bvhOffset = AlignUp(layout.indicesOffset + header.numIndices * sizeof(int));
+	layout.fileSize = layout.bvhOffset + header.bvhSize;
+	return layout;
+}
+
+} // namespace
+
+
+bool CookedPhysicsMesh::Read(const std::filesystem::path& path, uint64_t sourceHash, pxeng_bl::MeshShape& shape) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) {
+		throw FileNotFoundException("Cooked physics mesh cannot be opened.", path.generic_string());
+	}
+	size_t size = (size_t)file.tellg();
+	file.seekg(0);
+
+	FileHeader header;
+	if (size < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+		throw RuntimeException("Cooked physics mesh is truncated.", path.generic_string());
+	}
+	if (header.magic != MAGIC) {
+		throw RuntimeException("File is not a cooked physics mesh.", path.generic_string());
+	}
+	if (header.version != VERSION || header.bulletVersion != BT_BULLET_VERSION || header.scalarSize != sizeof(btScalar)) {
+		throw RuntimeException("Cooked physics mesh is of a different version.", path.generic_string());
+	}
+	if (header.sourceHash != sourceHash) {
+		return false;
+	}
+	if (header.numVertices > size || header.numIndices > size || header.bvhSize > size || GetLayout(header).fileSize != size) {
+		throw RuntimeException("Cooked physics mesh is corrupt.", path.generic_string());
+	}
+	Layout layout = GetLayout(header);
+
+	std::vector<btScalar> vertices(header.numVertices * 3);
+	std::vector<int> indices(header.numIndices);
+	file.seekg(layout.verticesOffset);
+	file.read(reinterpret_cast<char*>(vertices.data()), vertices.size() * sizeof(btScalar));
+	file.seekg(layout.indicesOffset);
+	file.read(reinterpret_cast<char*>(indices.data()), indices.size() * sizeof(int));
+
+	// The BVH is loaded in place, so it gets a buffer of its own that the shape keeps.
+	std::shared_ptr<void> bvh(btAlignedAlloc(header.bvhSize, DATA_ALIGNMENT), [](void* ptr) { btAlignedFree(ptr); });
+	file.seekg(layout.bvhOffset);
+	file.read(static_cast<char*>(bvh.get()), header.bvhSize);
+	if (!file) {
+		throw RuntimeException("Cooked physics mesh cannot be read.", path.generic_string());
+	}
+
+	for (int index : indices) {
+		if (index < 0 || uint64_t(index) >= header.numVertices) {
+			throw RuntimeException("Cooked physics mesh is corrupt.", path.generic_string());
+		}
+	}
+
+	try {
+		shape.SetCookedMesh(std::move(vertices), std::move(indices), std::move(bvh), header.bvhSize);
+	}
+	catch (InvalidArgumentException&) {
+		throw RuntimeException("Cooked physics mesh is corrupt.", path.generic_string());
+	}
+	return true;
+}
+
+
+void CookedPhysicsMesh::Write(const std::filesystem::path& path, const pxeng_bl::MeshShape& shape, uint64_t sourceHash) {
+	size_t bvhSize = shape.GetBvhSize();
+	if (bvhSize == 0) {
+		throw InvalidArgumentException("Only static meshes can be cooked.");
+	}
+
+	FileHeader header = {};
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.sourceHash = sourceHash;
+	header.bulletVersion = BT_BULLET_VERSION;
+	header.scalarSize = sizeof(btScalar);
+	header.numVertices = shape.GetVertices().size() / 3;
+	header.numIndices = shape.GetIndices().size();
+	header.bvhSize = bvhSize;
+	Layout layout = GetLayout(header);
+
+	std::unique_ptr<void, void (*)(void*)> bvh(btAlignedAlloc(bvhSize, DATA_ALIGNMENT), [](void* ptr) { btAlignedFree(ptr); });
+	shape.SerializeBvh(bvh.get());
+
+	// Readers never see a half written file, it only replaces the old one once complete.
+	std::filesystem::path temporaryPath = path;
+	temporaryPath += ".tmp";
+	std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		throw FileNotFoundException("Cooked physics mesh cannot be created.", path.generic_string());
+	}
+	size_t offset = 0;
+	auto write = [&](const void* bytes, size_t size) {
+		file.write(static_cast<const char*>(bytes), size);
+		offset += size;
+	};
+	auto alignTo = [&](size_t target) {
+		static constexpr char zeros[DATA_ALIGNMENT] = {};
+		write(zeros, target - offset);
+	};
+
+	write(&header, sizeof(header));
+	alignTo(layout.verticesOffset);
+	write(shape.GetVertices().data(), shape.GetVertices().size() * sizeof(btScalar));
+	alignTo(layout.indicesOffset);
+	write(shape.GetIndices().data(), shape.GetIndices().size() * sizeof(int));
+	alignTo(layout.bvhOffset);
+	write(bvh.get(), bvhSize);
+
+	file.close();
+	if (!file.good()) {
+		std::error_code ec;
+		std::filesystem::remove(temporaryPath, ec);
+		throw FileNotFoundException("Cooked physics mesh cannot be written.", path.generic_string());
+	}
+	std::filesystem::rename(temporaryPath, path);
+}
+
+
+uint64_t CookedPhysicsMesh::GetSourceHash(const std::filesystem::path& sourcePath) {
+	std::ifstream file(sourcePath, std::ios::binary);
+	if (!file.is_open()) {
+		throw FileNotFoundException("Source file cannot be opened.", sourcePath.generic_string());
+	}
+
+	// FNV-1a over 64 bit words, fast enough to hash large levels at every load.
+	uint64_t hash = 14695981039346656037ull;
+	std::vector<uint64_t> block(64 * 1024);
+	while (file) {
+		file.read(reinterpret_cast<char*>(block.data()), block.size() * sizeof(uint64_t));
+		size_t read = (size_t)file.gcount();
+		std::memset(reinterpret_cast<char*>(block.data()) + read, 0, (sizeof(uint64_t) - read % sizeof(uint64_t)) % sizeof(uint64_t));
+		for (size_t i = 0; i < (read + sizeof(uint64_t) - 1) / sizeof(uint64_t); ++i) {
+			hash ^= block[i];
+			hash *= 1099511628211ull;
+		}
+		hash ^= read;
+		hash *= 1099511628211ull;
+	}
+	return hash | 1;
+}
+
+
+
+} // namespace inl::asset
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+
+namespace inl::pxeng_bl {
+class MeshShape;
+}
+
+
+namespace inl::asset {
+
+
+/// <summary>
+/// A static physics mesh saved with its triangles and its BVH, so that loading it does not build the BVH.
+/// </summary>
+/// <remarks>
+/// The file is a header, the vertices, the indices and the BVH in Bullet's in place format,
+/// each aligned to <see cref="DATA_ALIGNMENT"/>. The BVH is loaded in the buffer the file was read into.
+/// Files are keyed by the hash of the source's content, so they stay valid when assets are copied.
+/// </remarks>
+class CookedPhysicsMesh {
+public:
+	/// <summary> Increment when the file layout or the BVH settings change, older files are cooked again then. </summary>
+	static constexpr uint32_t VERSION = 1;
+	static constexpr size_t DATA_ALIGNMENT = 16;
+
+	/// <summary> Reads the file and sets up <paramref name="shape"/> if it's a cooked mesh of
+	///		<paramref name="sourceHash"/> and of the current version. </summary>
+	/// <returns> False if the file is of another source. </returns>
+	/// <exception cref="FileNotFoundException"> If the file cannot be opened. </exception>
+	/// <exception cref="RuntimeException"> If the file is corrupt or of another version. </exception>
+	static bool Read(const std::filesystem::path& path, uint64_t sourceHash, pxeng_bl::MeshShape& shape);
+
+	/// <summary> Writes a static mesh shape. </summary>
+	/// <exception cref="InvalidArgumentException"> If the shape is not a static mesh. </exception>
+	/// <exception cref="FileNotFoundException"> If the file cannot be written. </exception>
+	static void Write(const std::filesystem::path& path, const pxeng_bl::MeshShape& shape, uint64_t sourceHash);
+
+	/// <summary> Hash of the content of the file, never zero. </summary>
+	/// <exception cref="FileNotFoundException"> If the file cannot be opened. </exception>
+	static uint64_t GetSourceHash(const std::filesystem::path& sourcePath);
+};
+
+
+
+} // namespace inl::asset
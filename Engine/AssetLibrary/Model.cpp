@@ -6,6 +6,11 @@
 #include <assimp/scene.h>
 #include <assimp/mesh.h>
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define INL_MODEL_TRANSFORM_SSE
+#endif
+
 namespace inl {
 namespace asset {
 
@@ -128,6 +133,36 @@ std::vector<unsigned> Model::GetIndices(unsigned submeshID) const {
 }
 
 
+void Model::TransformVectors(const aiVector3D* source, size_t count, const Mat44& matrix, bool project, std::vector<Vec3>& destination) {
+	destination.resize(count);
+
+#ifdef INL_MODEL_TRANSFORM_SSE
+	// The result is the rows weighted by the vector's coordinates, computed for all four columns at once.
+	__m128 rows[4];
+	for (int i = 0; i < 4; ++i) {
+		rows[i] = _mm_set_ps(matrix(i, 3), matrix(i, 2), matrix(i, 1), matrix(i, 0));
+	}
+	for (size_t i = 0; i < count; ++i) {
+		const aiVector3D& v = source[i];
+		__m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(v.x), rows[0]), _mm_mul_ps(_mm_set1_ps(v.y), rows[1])),
+								   _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v.z), rows[2]), rows[3]));
+		if (project) {
+			result = _mm_div_ps(result, _mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 3, 3, 3)));
+		}
+		alignas(16) float lanes[4];
+		_mm_store_ps(lanes, result);
+		destination[i] = { lanes[0], lanes[1], lanes[2] };
+	}
+#else
+	for (size_t i = 0; i < count; ++i) {
+		const aiVector3D& v = source[i];
+		Vec4 result = Vec4(v.x, v.y, v.z, 1.0f) * matrix;
+		destination[i] = project ? result.xyz / result.w : result.xyz;
+	}
+#endif
+}
+
+
 
 } // namespace asset
 } // namespace inl
@@ -10,6 +10,7 @@
 
 #include <vector>
 #include <memory>
+#include <type_traits>
 
 
 namespace inl {
@@ -30,6 +31,7 @@ public:
 
 	unsigned SubmeshCount() const;
 
+	/// <remarks> Thread safe, submeshes can be read in parallel. </remarks>
 	template <typename... AttribT>
 	std::vector<gxeng::Vertex<AttribT...>> GetVertices(unsigned submeshID, CoordSysLayout cSysLayout = { AxisDir::POS_X, AxisDir::POS_Y, AxisDir::POS_Z }) const;
 
@@ -46,6 +48,16 @@ protected:
 	Mat44 m_invTrTransform;
 
 private:
+	/// <summary> Attributes that go through a matrix, transformed for all vertices of the submesh before the vertices are filled. </summary>
+	struct TransformedAttributes {
+		std::vector<Vec3> positions;
+		std::vector<Vec3> normals;
+		std::vector<Vec3> tangents;
+		std::vector<Vec3> bitangents;
+	};
+
+	/// <summary> Computes (v|1) * matrix for each vector, divided by the resulting w if <paramref name="project"/> is set. </summary>
+	static void TransformVectors(const aiVector3D* source, size_t count, const Mat44& matrix, bool project, std::vector<Vec3>& destination);
 
 	template <typename VertexT, typename... AttribsT>
 	struct VertexAttributeSetter;
@@ -76,9 +88,31 @@ inline std::vector<gxeng::Vertex<AttribT...>> Model::GetVertices(unsigned submes
 
 	const Mat44 normalTransform = posTransform.Inverse().Transpose();
 
+	// Positions are multiplied as column vectors, directions as row vectors, with the perspective division.
+	TransformedAttributes transformed;
+	if constexpr ((std::is_same_v<AttribT, gxeng::Position<0>> || ...)) {
+		assert(mesh->HasPositions());
+		TransformVectors(mesh->mVertices, mesh->mNumVertices, posTransform.Transposed(), false, transformed.positions);
+	}
+	if constexpr ((std::is_same_v<AttribT, gxeng::Normal<0>> || ...)) {
+		if (mesh->HasNormals()) {
+			TransformVectors(mesh->mNormals, mesh->mNumVertices, normalTransform, true, transformed.normals);
+		}
+	}
+	if constexpr ((std::is_same_v<AttribT, gxeng::Tangent<0>> || ...)) {
+		if (mesh->HasTangentsAndBitangents()) {
+			TransformVectors(mesh->mTangents, mesh->mNumVertices, normalTransform, true, transformed.tangents);
+		}
+	}
+	if constexpr ((std::is_same_v<AttribT, gxeng::Bitangent<0>> || ...)) {
+		if (mesh->HasTangentsAndBitangents()) {
+			TransformVectors(mesh->mBitangents, mesh->mNumVertices, normalTransform, true, transformed.bitangents);
+		}
+	}
+
 	for (uint32_t i = 0; i < mesh->mNumVertices; i++) {
 		VertexT newVertex;
-		VertexAttributeSetter<VertexT, AttribT...>()(newVertex, mesh, i, posTransform, normalTransform);
+		VertexAttributeSetter<VertexT, AttribT...>()(newVertex, mesh, i, transformed);
 		result.push_back(newVertex);
 	}
 
@@ -88,7 +122,7 @@ inline std::vector<gxeng::Vertex<AttribT...>> Model::GetVertices(unsigned submes
 
 template <typename VertexT>
 struct Model::VertexAttributeSetter<VertexT> {
-	inline void operator()(VertexT&, const aiMesh*, uint32_t, const Mat44&, const Mat44&) {}
+	inline void operator()(VertexT&, const aiMesh*, uint32_t, const TransformedAttributes&) {}
 };
 
 
@@ -99,16 +133,13 @@ struct Model::VertexAttributeSetter<VertexT, gxeng::Position<semanticIndex>, Tai
 		VertexT& target,
 		const aiMesh* mesh,
 		uint32_t vertexIndex,
-		const Mat44& posTr,
-		const Mat44& normTr
+		const TransformedAttributes& transformed
 		) {
-		using DataType = gxeng::VertexPartReader<gxeng::eVertexElementSemantic::POSITION>::DataType;
 		assert(mesh->HasPositions());
 		assert(vertexIndex < mesh->mNumVertices);
-		const aiVector3D& pos = mesh->mVertices[vertexIndex];
-		target.position = (posTr * Vec4(pos.x, pos.y, pos.z, 1)).xyz;
+		target.position = transformed.positions[vertexIndex];
 
-		VertexAttributeSetter<VertexT, TailAttribT...>()(target, mesh, vertexIndex, posTr, normTr);
+		VertexAttributeSetter<VertexT, TailAttribT...>()(target, mesh, vertexIndex, transformed);
 	}
 };
 
@@ -120,19 +151,15 @@ struct Model::VertexAttributeSetter<VertexT, gxeng::Normal<semanticIndex>, TailA
 		VertexT& target,
 		const aiMesh* mesh,
 		uint32_t vertexIndex,
-		const Mat44& posTr,
-		const Mat44& normTr
+		const TransformedAttributes& transformed
 		) {
-		using DataType = gxeng::VertexPartReader<gxeng::eVertexElementSemantic::NORMAL>::DataType;
 		if (mesh->HasNormals() == false) {
 			throw InvalidCallException("Vertex array requested with normals but loaded mesh does not have such an attribute.");
 		}
 		assert(vertexIndex < mesh->mNumVertices);
-		const aiVector3D& normal = mesh->mNormals[vertexIndex];
-		target.normal = normTr * (Vec3)DataType(normal.x, normal.y, normal.z);
-		//target.normal = DataType(normal.x, normal.y, normal.z);
+		target.normal = transformed.normals[vertexIndex];
 
-		VertexAttributeSetter<VertexT, TailAttribT...>()(target, mesh, vertexIndex, posTr, normTr);
+		VertexAttributeSetter<VertexT, TailAttribT...>()(target, mesh, vertexIndex, transformed);
 	}
 };
 
@@ -144,18 +171,15 @@ struct Model::VertexAttributeSetter<VertexT, gxeng::Tangent<semanticIndex>, Tail
 		VertexT& target,
 		const aiMesh* mesh,
 		uint32_t vertexIndex,
-		const Mat44& posTr,
-		const Mat44& normTr
+		const TransformedAttributes& transformed
 		) {
-		using DataType = typename gxeng::VertexPart<gxeng::eVertexElementSemantic::NORMAL>::DataType;
 		if (mesh->HasTangentsAndBitangents() == false) {
 			throw InvalidCallException("Vertex array requested with tangents but loaded mesh does not have such an attribute.");
 		}
 		assert(vertexIndex < mesh->mNumVertices);
-		const aiVector3D& tangent = mesh->mTangents[vertexIndex];
-		target.tangent = normTr * DataType(tangent.x, tangent.y, tangent.z);
+		target.tangent = transformed.tangents[vertexIndex];
 
-		VertexAttributeSetter<VertexT, TailAttribT...>()(target, mesh, vertexIndex, posTr, normTr);
+		VertexAttributeSetter<VertexT, TailAttribT...>()(target, mesh, vertexIndex, transformed);
 	}
 };
 
@@ -167,18 +191,15 @@ struct Model::VertexAttributeSetter<VertexT, gxeng::Bitangent<semanticIndex>, Ta
 		VertexT& target,
 		const aiMesh* mesh,
 		uint32_t vertexIndex,
-		const Mat44& posTr,
-		const Mat44& normTr
+		const TransformedAttributes& transformed
 		) {
-		using DataType = typename gxeng::VertexPart<gxeng::eVertexElementSemantic::NORMAL>::DataType;
 		if (mesh->HasTangentsAndBitangents() == false) {
 			throw InvalidCallException("Vertex array requested with bitangents but loaded mesh does not have such an attribute.");
 		}
 		assert(vertexIndex < mesh->mNumVertices);
-		const aiVector3D& bitangent = mesh->mBitangents[vertexIndex];
-		target.bitangent = normTr * DataType(bitangent.x, bitangent.y, bitangent.z);
+		target.bitangent = transformed.bitangents[vertexIndex];
 
-		VertexAttributeSetter<VertexT, TailAttribT...>()(target, mesh, vertexIndex, posTr, normTr);
+		VertexAttributeSetter<VertexT, TailAttribT...>()(target, mesh, vertexIndex, transformed);
 	}
 };
 
@@ -189,8 +210,7 @@ struct Model::VertexAttributeSetter<VertexT, gxeng::TexCoord<semanticIndex>, Tai
 		VertexT& target,
 		const aiMesh* mesh,
 		uint32_t vertexIndex,
-		const Mat44& posTr,
-		const Mat44& normTr
+		const TransformedAttributes& transformed
 		) {
 		using DataType = gxeng::VertexPartReader<gxeng::eVertexElementSemantic::TEX_COORD>::DataType;
 		if (mesh->HasTextureCoords(semanticIndex) == false) {
@@ -203,7 +223,7 @@ struct Model::VertexAttributeSetter<VertexT, gxeng::TexCoord<semanticIndex>, Tai
 		const aiVector3D& texCoords = mesh->mTextureCoords[semanticIndex][vertexIndex];
 		target.texCoord = DataType(texCoords.x, texCoords.y);
 
-		VertexAttributeSetter<VertexT, TailAttribT...>()(target, mesh, vertexIndex, posTr, normTr);
+		VertexAttributeSetter<VertexT, TailAttribT...>()(target, mesh, vertexIndex, transformed);
 	}
 };
 
@@ -214,8 +234,7 @@ struct Model::VertexAttributeSetter<VertexT, gxeng::Color<semanticIndex>, TailAt
 		VertexT& target,
 		const aiMesh* mesh,
 		uint32_t vertexIndex,
-		const Mat44& posTr,
-		const Mat44& normTr
+		const TransformedAttributes& transformed
 		) {
 		using DataType = gxeng::VertexPartReader<gxeng::eVertexElementSemantic::COLOR>::DataType;
 		if (mesh->HasVertexColors(semanticIndex) == false) {
@@ -228,7 +247,7 @@ struct Model::VertexAttributeSetter<VertexT, gxeng::Color<semanticIndex>, TailAt
 		const aiColor4D& color = mesh->mColors[semanticIndex][vertexIndex];
 		target.color = DataType(color.r, color.g, color.b);
 
-		VertexAttributeSetter<VertexT, TailAttribT...>()(target, mesh, vertexIndex, posTr, normTr);
+		VertexAttributeSetter<VertexT, TailAttribT...>()(target, mesh, vertexIndex, transformed);
 	}
 };
 
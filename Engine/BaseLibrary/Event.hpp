@@ -1,10 +1,11 @@
 #pragma once
 
 #include "Delegate.hpp"
-#include "SpinMutex.hpp"
 #include "TemplateUtil.hpp"
 
-#include <set>
+#include <algorithm>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <vector>
 #include <typeindex>
@@ -20,6 +21,8 @@ namespace inl {
 
 /// <summary> You can sign up functors, then fire the event by calling it's (), 
 ///		and all the signed up functors will be called. </summary>
+/// <remarks> Signed up functors are kept in an immutable list that is replaced on every change,
+///		firing the event only takes the current list, it doesn't lock or allocate. </remarks>
 template <class... ArgsT>
 class Event {
 	// Helper class to store comparable functors
@@ -30,8 +33,8 @@ class Event {
 
 			// Compares two comparable functors as -1, 0, +1 for less, equal and greater (like strcmp)
 			compare = [](const std::function<void(ArgsT...)>& lhs, const std::function<void(ArgsT...)>& rhs) {
-				const ComparableFun* target1 = lhs.target<const ComparableFun>();
-				const ComparableFun* target2 = rhs.target<const ComparableFun>();
+				const ComparableFun* target1 = lhs.template target<const ComparableFun>();
+				const ComparableFun* target2 = rhs.template target<const ComparableFun>();
 				if (target1 == nullptr || target2 == nullptr) {
 					return
 						((std::type_index)rhs.target_type() < (std::type_index)lhs.target_type())
@@ -55,7 +58,13 @@ class Event {
 		}
 
 		std::function<void(ArgsT...)> callee; // Underlying functor.
-		std::function<int(const std::function<void(ArgsT...)>&, const std::function<void(ArgsT...)>&)> compare; // Comparison inner helper.
+		int (*compare)(const std::function<void(ArgsT...)>&, const std::function<void(ArgsT...)>&); // Comparison inner helper.
+	};
+
+	// The signed up functors, never changed once published.
+	struct Handlers {
+		std::vector<std::function<void(ArgsT...)>> simples; // These functions cannot be removed via -=
+		std::vector<Comparable> comparables; // Sorted, these function can be removed by -= because they have < and ==
 	};
 
 	// Functors having both < and == are considered comparable.
@@ -65,39 +74,41 @@ public:
 	Event() = default;
 
 	/// <summary> All signed up functors are copied as well and signed up for the new event. </summary>
-	Event(const Event& other) : m_simples(other.m_simples), m_comparables(other.m_comparables) {}
+	Event(const Event& other) : m_handlers(other.GetHandlers()) {}
 
 	/// <summary> All signed up functors are copied as well and signed up for the new event, old event is empty. </summary>
-	Event(Event&& other) : m_simples(std::move(other.m_simples)), m_comparables(std::move(other.m_comparables)) {}
+	Event(Event&& other) : m_handlers(other.GetHandlers()) {
+		other.SetHandlers(nullptr);
+	}
 
 	/// <summary> All signed up functors are copied as well and signed up for the new event. </summary>
 	Event& operator=(const Event& other) {
-		m_simples = other.m_simples;
-		m_comparables = other.m_comparables;
+		SetHandlers(other.GetHandlers());
 
 		return *this;
 	}
 
 	/// <summary> All signed up functors are copied as well and signed up for the new event, old event is empty. </summary>
 	Event& operator=(Event&& other) {
-		m_simples = std::move(other.m_simples);
-		m_comparables = std::move(other.m_comparables);
+		auto handlers = other.GetHandlers();
+		other.SetHandlers(nullptr);
+		SetHandlers(std::move(handlers));
 
 		return *this;
 	}
 
 	/// <summary> Fire off the event, call all signed up functors with given arguments. </summary>
+	/// <remarks> Functors signed up or removed by a fired functor only take effect from the next firing. </remarks>
 	void operator()(ArgsT... args) {
-		std::unique_lock<SpinMutex> lkg(m_mtx);
-		// Copy so that if a fired functor changes m_simples/m_comparables iterators won't invalidate.
-		auto simples = m_simples;
-		auto comparables = m_comparables;
-		lkg.unlock();
+		auto handlers = GetHandlers();
+		if (!handlers) {
+			return;
+		}
 
-		for (auto& callee : simples) {
+		for (auto& callee : handlers->simples) {
 			callee(args...);
 		}
-		for (auto& callee : comparables) {
+		for (auto& callee : handlers->comparables) {
 			callee(args...);
 		}
 	}
@@ -105,9 +116,13 @@ public:
 	/// <summary> Signs up functor for the event. You may remove this functor via <see cref="operator-="/>. </summary>
 	template <class ComparableFun>
 	std::enable_if_t<IsComparable<ComparableFun>, void> operator+=(const ComparableFun& fun) {
+		Comparable comparable(fun);
+
 		std::lock_guard<decltype(m_mtx)> lkg(m_mtx);
-		
-		m_comparables.insert(Comparable(fun));
+		auto handlers = CopyHandlers();
+		auto it = std::upper_bound(handlers->comparables.begin(), handlers->comparables.end(), comparable);
+		handlers->comparables.insert(it, std::move(comparable));
+		SetHandlers(std::move(handlers));
 	}
 
 	/// <summary> Signs up functor for the event. You can't remove this functor later. </summary>
@@ -116,29 +131,50 @@ public:
 		std::function<void(ArgsT...)> callee = fun;
 
 		std::lock_guard<decltype(m_mtx)> lkg(m_mtx);
-
-		m_simples.push_back(callee);
+		auto handlers = CopyHandlers();
+		handlers->simples.push_back(std::move(callee));
+		SetHandlers(std::move(handlers));
 	}
 
 	/// <summary> Remove previously signed up functor. </summary>
 	/// <returns> True if the functor was found and removed, false if not found. </returns>
 	template <class ComparableFun>
 	std::enable_if_t<IsComparable<ComparableFun>, bool> operator-=(const ComparableFun& fun) {
-		std::lock_guard<decltype(m_mtx)> lkg(m_mtx);
+		Comparable comparable(fun);
 
-		auto it = m_comparables.find(Comparable(fun));
-		if (it != m_comparables.end()) {
-			m_comparables.erase(it);
-			return true;
+		std::lock_guard<decltype(m_mtx)> lkg(m_mtx);
+		auto current = GetHandlers();
+		if (!current) {
+			return false;
 		}
-		return false;
+		auto it = std::lower_bound(current->comparables.begin(), current->comparables.end(), comparable);
+		if (it == current->comparables.end() || comparable < *it) {
+			return false;
+		}
+		auto handlers = std::make_shared<Handlers>(*current);
+		handlers->comparables.erase(handlers->comparables.begin() + (it - current->comparables.begin()));
+		SetHandlers(std::move(handlers));
+		return true;
 	}
 
 private:
-	SpinMutex m_mtx;
+	std::shared_ptr<const Handlers> GetHandlers() const {
+		return std::atomic_load_explicit(&m_handlers, std::memory_order_acquire);
+	}
+
+	void SetHandlers(std::shared_ptr<const Handlers> handlers) {
+		std::atomic_store_explicit(&m_handlers, std::move(handlers), std::memory_order_release);
+	}
 
-	std::vector<std::function<void(ArgsT...)>> m_simples; // These functions cannot be removed via -=
-	std::multiset<Comparable> m_comparables; // These function can be removed by -= because they have < and ==
+	// Changes are made to a copy of the current list, which then replaces it.
+	std::shared_ptr<Handlers> CopyHandlers() const {
+		auto current = GetHandlers();
+		return current ? std::make_shared<Handlers>(*current) : std::make_shared<Handlers>();
+	}
+
+private:
+	std::mutex m_mtx; // Serializes changes, firing does not take it.
+	std::shared_ptr<const Handlers> m_handlers;
 };
 
 
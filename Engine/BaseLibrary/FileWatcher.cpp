@@ -0,0 +1,81 @@
+#include "FileWatcher.hpp"
+
+#include <algorithm>
+
+
+namespace inl {
+
+
+void FileWatcher::AddDirectory(const std::filesystem::path& directory) {
+	std::filesystem::path normalized = Normalize(directory);
+	if (m_directories.count(normalized) == 0) {
+		m_directories.insert({ normalized, Scan(normalized) });
+	}
+}
+
+
+void FileWatcher::RemoveDirectory(const std::filesystem::path& directory) {
+	m_directories.erase(Normalize(directory));
+}
+
+
+void FileWatcher::ClearDirectories() {
+	m_directories.clear();
+}
+
+
+std::vector<std::filesystem::path> FileWatcher::Poll() {
+	std::vector<std::filesystem::path> changed;
+	for (auto& [directory, files] : m_directories) {
+		FileStates current = Scan(directory);
+		for (const auto& [path, state] : current) {
+			auto it = files.find(path);
+			if (it == files.end() || !(it->second == state)) {
+				changed.push_back(path);
+			}
+		}
+		for (const auto& [path, state] : files) {
+			if (current.count(path) == 0) {
+				changed.push_back(path);
+			}
+		}
+		files = std::move(current);
+	}
+
+	// Nested directories report their files twice.
+	std::sort(changed.begin(), changed.end());
+	changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+	return changed;
+}
+
+
+std::filesystem::path FileWatcher::Normalize(const std::filesystem::path& directory) {
+	std::error_code ec;
+	std::filesystem::path absolute = std::filesystem::absolute(directory, ec);
+	return (ec ? directory : absolute).lexically_normal();
+}
+
+
+auto FileWatcher::Scan(const std::filesystem::path& directory) -> FileStates {
+	FileStates files;
+
+	// Files may come and go during the scan, those are simply picked up by the next one.
+	std::error_code ec;
+	std::filesystem::recursive_directory_iterator it(directory, std::filesystem::directory_options::skip_permission_denied, ec);
+	for (; !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+		std::error_code fileEc;
+		if (!it->is_regular_file(fileEc) || fileEc) {
+			continue;
+		}
+		FileState state;
+		state.writeTime = it->last_write_time(fileEc);
+		state.size = it->file_size(fileEc);
+		if (!fileEc) {
+			files.insert({ it->path(), state });
+		}
+	}
+	return files;
+}
+
+
+} // namespace inl
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+
+
+namespace inl {
+
+
+/// <summary>
+/// Finds the files that were created, modified or deleted in a set of directories,
+/// including their subdirectories.
+/// </summary>
+/// <remarks>
+/// Each poll compares the write time and size of every file with the previous poll.
+/// That is portable and quick enough for asset and shader directories when polled a few times a second.
+/// Not thread safe.
+/// </remarks>
+class FileWatcher {
+public:
+	/// <summary> Starts watching the directory. Files already in it are not reported. </summary>
+	/// <remarks> Missing directories are watched as well, their files are reported once they appear. </remarks>
+	void AddDirectory(const std::filesystem::path& directory);
+
+	/// <summary> Stops watching the directory, does nothing if it's not watched. </summary>
+	void RemoveDirectory(const std::filesystem::path& directory);
+
+	void ClearDirectories();
+
+	/// <summary> Returns the files that changed since the last poll, as absolute paths, each once. </summary>
+	std::vector<std::filesystem::path> Poll();
+
+private:
+	struct FileState {
+		std::filesystem::file_time_type writeTime;
+		uintmax_t size;
+		bool operator==(const FileState& rhs) const { return writeTime == rhs.writeTime && size == rhs.size; }
+	};
+	struct PathHash {
+		size_t operator()(const std::filesystem::path& obj) const {
+			return std::filesystem::hash_value(obj);
+		}
+	};
+	using FileStates = std::unordered_map<std::filesystem::path, FileState, PathHash>;
+
+	static std::filesystem::path Normalize(const std::filesystem::path& directory);
+	static FileStates Scan(const std::filesystem::path& directory);
+
+private:
+	std::unordered_map<std::filesystem::path, FileStates, PathHash> m_directories;
+};
+
+
+} // namespace inl
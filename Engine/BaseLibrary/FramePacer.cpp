@@ -0,0 +1,144 @@
+#include "FramePacer.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#elif defined(__linux__)
+#include <cerrno>
+#include <ctime>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+namespace inl {
+
+
+static inline void SpinPause() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_pause();
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_ia32_pause();
+#endif
+}
+
+
+FramePacer::FramePacer() {
+#if defined(_WIN32)
+	// High resolution timers are only available since Windows 10 1803, older ones get a regular timer.
+	m_waitableTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (!m_waitableTimer) {
+		m_waitableTimer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+	}
+#endif
+	Reset();
+}
+
+
+FramePacer::~FramePacer() {
+#if defined(_WIN32)
+	if (m_waitableTimer) {
+		CloseHandle(m_waitableTimer);
+	}
+#endif
+}
+
+
+void FramePacer::SetTargetFrameTime(double seconds) {
+	m_targetFrameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(std::max(seconds, 0.0)));
+}
+
+
+double FramePacer::GetTargetFrameTime() const {
+	return std::chrono::duration<double>(m_targetFrameTime).count();
+}
+
+
+void FramePacer::SetTargetFrameRate(double framesPerSecond) {
+	SetTargetFrameTime(framesPerSecond > 0.0 ? 1.0 / framesPerSecond : 0.0);
+}
+
+
+void FramePacer::SetSpinTime(double seconds) {
+	m_spinTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(std::max(seconds, 0.0)));
+}
+
+
+double FramePacer::GetSpinTime() const {
+	return std::chrono::duration<double>(m_spinTime).count();
+}
+
+
+double FramePacer::Wait() {
+	Clock::time_point now = Clock::now();
+
+	if (m_targetFrameTime > Clock::duration::zero()) {
+		m_frameDeadline += m_targetFrameTime;
+		if (now - m_frameDeadline > m_targetFrameTime) {
+			// Too late to catch up, start a new schedule.
+			m_frameDeadline = now;
+		}
+
+		Clock::duration sleepTime = m_frameDeadline - now - m_spinTime - m_sleepOvershoot;
+		if (sleepTime > Clock::duration::zero()) {
+			Sleep(sleepTime);
+			Clock::duration overshoot = std::max(Clock::now() - now - sleepTime, Clock::duration::zero());
+			m_sleepOvershoot = (m_sleepOvershoot * 7 + overshoot) / 8;
+		}
+		while (Clock::now() < m_frameDeadline) {
+			SpinPause();
+		}
+		now = Clock::now();
+	}
+	else {
+		m_frameDeadline = now;
+	}
+
+	double frameTime = std::chrono::duration<double>(now - m_frameBegin).count();
+	m_frameBegin = now;
+	return frameTime;
+}
+
+
+void FramePacer::Reset() {
+	m_frameBegin = Clock::now();
+	m_frameDeadline = m_frameBegin;
+}
+
+
+void FramePacer::Sleep(Clock::duration duration) {
+#if defined(_WIN32)
+	if (m_waitableTimer) {
+		// Negative due time is relative, in 100 ns units.
+		LARGE_INTEGER dueTime;
+		dueTime.QuadPart = -std::max<LONGLONG>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / 100);
+		if (SetWaitableTimer(m_waitableTimer, &dueTime, 0, nullptr, nullptr, FALSE)) {
+			WaitForSingleObject(m_waitableTimer, INFINITE);
+			return;
+		}
+	}
+	std::this_thread::sleep_for(duration);
+#elif defined(__linux__)
+	auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+	timespec request;
+	request.tv_sec = time_t(nanoseconds / 1000000000);
+	request.tv_nsec = long(nanoseconds % 1000000000);
+	while (clock_nanosleep(CLOCK_MONOTONIC, 0, &request, &request) == EINTR) {
+		// Interrupted by a signal, sleep for the rest.
+	}
+#else
+	std::this_thread::sleep_for(duration);
+#endif
+}
+
+
+} // namespace inl
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+
+
+namespace inl {
+
+
+/// <summary>
+/// Limits the frame rate of a loop by waiting at the end of each frame until the target frame time passes.
+/// </summary>
+/// <remarks>
+/// <para> Most of the wait is slept with the most precise timer of the system,
+///		the last part is spun, because sleeps overshoot. The thread is only busy for that last part. </para>
+/// <para> Frames are scheduled one target frame time after one another, so that short
+///		overshoots are made up for in the next frame. A frame that overruns by more than the
+///		target frame time restarts the schedule instead of running the next ones back-to-back. </para>
+/// </remarks>
+class FramePacer {
+public:
+	FramePacer();
+	FramePacer(const FramePacer&) = delete;
+	FramePacer& operator=(const FramePacer&) = delete;
+	~FramePacer();
+
+	/// <summary> Frames take at least this long, in seconds. Zero turns pacing off. </summary>
+	void SetTargetFrameTime(double seconds);
+	double GetTargetFrameTime() const;
+
+	/// <summary> Sets the target frame time to match the frame rate. Zero turns pacing off. </summary>
+	void SetTargetFrameRate(double framesPerSecond);
+
+	/// <summary> Sleeping stops this long before the end of the frame, the rest is spun. In seconds. </summary>
+	/// <remarks> The average overshoot of the sleeps is measured and spun in addition. </remarks>
+	void SetSpinTime(double seconds);
+	double GetSpinTime() const;
+
+	/// <summary> Waits until the current frame reaches the target frame time. </summary>
+	/// <returns> Length of the frame that ended in seconds, measured from the end of the previous call. </returns>
+	double Wait();
+
+	/// <summary> Starts a new frame now, the time since the last wait is not counted. </summary>
+	void Reset();
+private:
+	using Clock = std::chrono::steady_clock;
+
+	void Sleep(Clock::duration duration);
+
+	Clock::duration m_targetFrameTime = Clock::duration::zero();
+	Clock::duration m_spinTime = std::chrono::microseconds(300);
+	Clock::duration m_sleepOvershoot = Clock::duration::zero(); // Moving average of how much later sleeps return.
+	Clock::time_point m_frameBegin;
+	Clock::time_point m_frameDeadline;
+
+	void* m_waitableTimer = nullptr; // Windows timer handle, null elsewhere.
+};
+
+
+} // namespace inl
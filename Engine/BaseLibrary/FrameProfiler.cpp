@@ -0,0 +1,217 @@
+#include "FrameProfiler.hpp"
+
+#include "ThreadName.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+
+namespace inl {
+
+
+namespace {
+
+struct ThreadCache {
+	uint64_t profilerId = 0;
+	void* buffer = nullptr;
+};
+
+thread_local ThreadCache threadCache;
+thread_local uint32_t threadDepth = 0;
+std::atomic_uint64_t nextProfilerId = 1;
+
+
+void WriteEscaped(std::ostream& output, const char* str) {
+	for (; *str != '\0'; ++str) {
+		if (*str == '"' || *str == '\\') {
+			output << '\\';
+		}
+		output << *str;
+	}
+}
+
+} // namespace
+
+
+FrameProfiler::FrameProfiler()
+	: m_id(nextProfilerId++) {
+	m_timer.Start();
+}
+
+
+FrameProfiler& FrameProfiler::GetGlobal() {
+	static FrameProfiler profiler;
+	return profiler;
+}
+
+
+void FrameProfiler::BeginFrame(uint64_t index) {
+	m_currentFrame.index = index;
+	m_currentFrame.begin = Now();
+}
+
+
+void FrameProfiler::EndFrame() {
+	ProfiledFrame frame;
+	frame.index = m_currentFrame.index;
+	frame.begin = m_currentFrame.begin;
+	frame.end = Now();
+
+	{
+		std::lock_guard<std::mutex> lock(m_threadsMtx);
+		for (auto& thread : m_threads) {
+			std::lock_guard<SpinMutex> threadLock(thread->mtx);
+			frame.zones.insert(frame.zones.end(), thread->zones.begin(), thread->zones.end());
+			frame.counters.insert(frame.counters.end(), thread->counters.begin(), thread->counters.end());
+			thread->zones.clear();
+			thread->counters.clear();
+		}
+	}
+	std::sort(frame.zones.begin(), frame.zones.end(), [](const ProfileZone& lhs, const ProfileZone& rhs) {
+		return lhs.begin < rhs.begin;
+	});
+	std::sort(frame.counters.begin(), frame.counters.end(), [](const ProfileCounter& lhs, const ProfileCounter& rhs) {
+		return lhs.time < rhs.time;
+	});
+
+	std::lock_guard<std::mutex> lock(m_historyMtx);
+	m_history.push_back(std::move(frame));
+	while (m_history.size() > HistoryLength) {
+		m_history.pop_front();
+	}
+}
+
+
+double FrameProfiler::Now() const {
+	return m_timer.Elapsed();
+}
+
+
+void FrameProfiler::Record(const char* name, uint32_t depth, double begin, double end) {
+	ThreadBuffer& buffer = GetThreadBuffer();
+	std::lock_guard<SpinMutex> lock(buffer.mtx);
+	buffer.zones.push_back({ name, buffer.index, depth, begin, end });
+}
+
+
+void FrameProfiler::RecordCounter(const char* name, double value) {
+	if (!IsEnabled()) {
+		return;
+	}
+	double time = Now();
+	ThreadBuffer& buffer = GetThreadBuffer();
+	std::lock_guard<SpinMutex> lock(buffer.mtx);
+	buffer.counters.push_back({ name, time, value });
+}
+
+
+const char* FrameProfiler::Intern(const std::string& name) {
+	std::lock_guard<std::mutex> lock(m_threadsMtx);
+	return m_names.insert(name).first->c_str(); // Nodes of an unordered_set stay in place.
+}
+
+
+ProfiledFrame FrameProfiler::GetLastFrame() const {
+	std::lock_guard<std::mutex> lock(m_historyMtx);
+	return m_history.empty() ? ProfiledFrame{} : m_history.back();
+}
+
+
+std::vector<ProfiledFrame> FrameProfiler::GetHistory() const {
+	std::lock_guard<std::mutex> lock(m_historyMtx);
+	return { m_history.begin(), m_history.end() };
+}
+
+
+std::vector<std::string> FrameProfiler::GetThreadNames() const {
+	std::lock_guard<std::mutex> lock(m_threadsMtx);
+	return m_threadNames;
+}
+
+
+uint32_t FrameProfiler::GetCurrentThread() {
+	return GetThreadBuffer().index;
+}
+
+
+void FrameProfiler::ExportChromeTrace(std::ostream& output) const {
+	ExportChromeTrace(output, GetHistory(), GetThreadNames());
+}
+
+
+void FrameProfiler::ExportChromeTrace(std::ostream& output, const std::vector<ProfiledFrame>& frames, const std::vector<std::string>& threadNames) {
+	output << "{\"traceEvents\":[";
+	bool first = true;
+	auto separate = [&] {
+		output << (first ? "\n" : ",\n");
+		first = false;
+	};
+
+	for (size_t thread = 0; thread < threadNames.size(); ++thread) {
+		separate();
+		output << R"({"name":"thread_name","ph":"M","pid":0,"tid":)" << thread << R"(,"args":{"name":")";
+		WriteEscaped(output, threadNames[thread].c_str());
+		output << "\"}}";
+	}
+
+	// Timestamps and durations are in microseconds.
+	for (const auto& frame : frames) {
+		for (const auto& zone : frame.zones) {
+			separate();
+			output << "{\"name\":\"";
+			WriteEscaped(output, zone.name);
+			output << R"(","ph":"X","pid":0,"tid":)" << zone.thread
+				   << ",\"ts\":" << zone.begin * 1e6
+				   << ",\"dur\":" << (zone.end - zone.begin) * 1e6 << "}";
+		}
+		for (const auto& counter : frame.counters) {
+			separate();
+			output << "{\"name\":\"";
+			WriteEscaped(output, counter.name);
+			output << R"(","ph":"C","pid":0,"ts":)" << counter.time * 1e6
+				   << ",\"args\":{\"value\":" << counter.value << "}}";
+		}
+	}
+	output << "\n]}\n";
+}
+
+
+FrameProfiler::ThreadBuffer& FrameProfiler::GetThreadBuffer() {
+	if (threadCache.profilerId == m_id) {
+		return *static_cast<ThreadBuffer*>(threadCache.buffer);
+	}
+
+	std::lock_guard<std::mutex> lock(m_threadsMtx);
+	auto id = std::this_thread::get_id();
+	auto it = std::find_if(m_threads.begin(), m_threads.end(), [id](const auto& thread) { return thread->owner == id; });
+	if (it == m_threads.end()) {
+		auto buffer = std::make_unique<ThreadBuffer>();
+		buffer->owner = id;
+		buffer->index = (uint32_t)m_threads.size();
+		const std::string& name = GetCurrentThreadName();
+		m_threadNames.push_back(name.empty() ? "Thread " + std::to_string(buffer->index) : name);
+		m_threads.push_back(std::move(buffer));
+		it = m_threads.end() - 1;
+	}
+	threadCache = { m_id, it->get() };
+	return **it;
+}
+
+
+
+ProfileScope::ProfileScope(const char* name, FrameProfiler& profiler)
+	: m_profiler(profiler.IsEnabled() ? &profiler : nullptr),
+	  m_name(name),
+	  m_depth(threadDepth++),
+	  m_begin(m_profiler ? m_profiler->Now() : 0.0) {}
+
+
+ProfileScope::~ProfileScope() {
+	--threadDepth;
+	if (m_profiler) {
+		m_profiler->Record(m_name, m_depth, m_begin, m_profiler->Now());
+	}
+}
+
+
+} // namespace inl
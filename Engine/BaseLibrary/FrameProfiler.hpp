@@ -0,0 +1,146 @@
+#pragma once
+
+#include "SpinMutex.hpp"
+#include "Timer.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+
+namespace inl {
+
+
+struct ProfileZone {
+	const char* name;
+	uint32_t thread; // Index into the profiler's thread names.
+	uint32_t depth; // Number of enclosing zones on the same thread.
+	double begin; // Seconds since the profiler was created.
+	double end;
+};
+
+
+struct ProfileCounter {
+	const char* name;
+	double time; // Seconds since the profiler was created.
+	double value;
+};
+
+
+struct ProfiledFrame {
+	uint64_t index = 0;
+	double begin = 0.0;
+	double end = 0.0;
+	std::vector<ProfileZone> zones; // Ordered by begin time.
+	std::vector<ProfileCounter> counters; // Ordered by time.
+};
+
+
+/// <summary>
+/// Collects named CPU time ranges from any thread, grouped by frames.
+/// </summary>
+/// <remarks> Zones are recorded into per-thread buffers, recording only contends with
+///		<see cref="EndFrame"/>. The last <see cref="HistoryLength"/> frames are kept. </remarks>
+class FrameProfiler {
+public:
+	static constexpr size_t HistoryLength = 120;
+
+public:
+	FrameProfiler();
+	FrameProfiler(const FrameProfiler&) = delete;
+	FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+	/// <summary> The profiler the engine's zones go to. </summary>
+	static FrameProfiler& GetGlobal();
+
+	void SetEnabled(bool enabled) { m_enabled = enabled; }
+	bool IsEnabled() const { return m_enabled; }
+
+	void BeginFrame(uint64_t index);
+	/// <summary> Moves the zones recorded since <see cref="BeginFrame"/> into the history. </summary>
+	/// <remarks> Zones that end later on other threads go to the next frame. </remarks>
+	void EndFrame();
+
+	/// <summary> Seconds since the profiler was created. </summary>
+	double Now() const;
+
+	/// <summary> Adds a finished zone on the calling thread. </summary>
+	/// <param name="name"> Must outlive the profiler, use <see cref="Intern"/> for generated names. </param>
+	void Record(const char* name, uint32_t depth, double begin, double end);
+
+	/// <summary> Adds a sample of a named value, such as an object count, at the current time. </summary>
+	/// <param name="name"> Must outlive the profiler, like zone names. </param>
+	void RecordCounter(const char* name, double value);
+
+	/// <summary> Returns a copy of the string that lives as long as the profiler. </summary>
+	const char* Intern(const std::string& name);
+
+	/// <summary> The last finished frame, empty if there is none. </summary>
+	ProfiledFrame GetLastFrame() const;
+	std::vector<ProfiledFrame> GetHistory() const;
+	std::vector<std::string> GetThreadNames() const;
+	/// <summary> Index of the calling thread in <see cref="GetThreadNames"/>. </summary>
+	uint32_t GetCurrentThread();
+
+	/// <summary> Writes the history in the Chrome trace event format, as loaded by chrome://tracing. </summary>
+	void ExportChromeTrace(std::ostream& output) const;
+	static void ExportChromeTrace(std::ostream& output, const std::vector<ProfiledFrame>& frames, const std::vector<std::string>& threadNames);
+
+private:
+	struct ThreadBuffer {
+		std::thread::id owner;
+		uint32_t index;
+		SpinMutex mtx;
+		std::vector<ProfileZone> zones;
+		std::vector<ProfileCounter> counters;
+	};
+
+	ThreadBuffer& GetThreadBuffer();
+
+private:
+	const uint64_t m_id; // Tells apart per-thread caches of different profilers.
+	mutable Timer m_timer;
+	std::atomic_bool m_enabled = true;
+
+	std::vector<std::unique_ptr<ThreadBuffer>> m_threads;
+	std::vector<std::string> m_threadNames;
+	std::unordered_set<std::string> m_names;
+	mutable std::mutex m_threadsMtx; // Protects threads and names.
+
+	ProfiledFrame m_currentFrame;
+	std::deque<ProfiledFrame> m_history;
+	mutable std::mutex m_historyMtx;
+};
+
+
+/// <summary> Records the time from construction to destruction as a zone. </summary>
+/// <remarks> Must be destroyed on the thread it was created on, don't let it span a co_await. </remarks>
+class ProfileScope {
+public:
+	explicit ProfileScope(const char* name, FrameProfiler& profiler = FrameProfiler::GetGlobal());
+	~ProfileScope();
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	FrameProfiler* m_profiler; // Null if the profiler was disabled.
+	const char* m_name;
+	uint32_t m_depth;
+	double m_begin;
+};
+
+
+} // namespace inl
+
+
+#define INL_PROFILE_CONCAT_IMPL(a, b) a##b
+#define INL_PROFILE_CONCAT(a, b) INL_PROFILE_CONCAT_IMPL(a, b)
+/// <summary> Profiles the rest of the enclosing block as a zone of the global profiler. </summary>
+#define INL_PROFILE_SCOPE(name) ::inl::ProfileScope INL_PROFILE_CONCAT(profileScope_, __LINE__)(name)
@@ -41,6 +41,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define LTALLOC_VERSION "1.0.0" // (2015/06/16) - standard STL allocator provided [see ltalloc.hpp file](ltalloc.hpp)
 #define LTALLOC_VERSION "0.0.0" // (2013/xx/xx) - fork from public repository */
 
+#if defined(__cplusplus) && defined(INL_MEMORY_TRACKING)
+#include "../Memory/MemoryTracker.hpp"//before the keyword macros below, standard headers use them
+#endif
+
 //Customizable constants
 //#define LTALLOC_DISABLE_OPERATOR_NEW_OVERRIDE
 //#define LTALLOC_AUTO_GC_INTERVAL 3.0
@@ -943,15 +947,42 @@ continue_:;
 #define THROWS throw(std::bad_alloc)
 #endif
 
-void *operator new  (size_t size) THROWS                         {return ltmalloc<true> (size);}
-void *operator new  (size_t size, const std::nothrow_t&) throw() {return ltmalloc<false>(size);}
-void *operator new[](size_t size) THROWS                         {return ltmalloc<true> (size);}
-void *operator new[](size_t size, const std::nothrow_t&) throw() {return ltmalloc<false>(size);}
+#ifdef INL_MEMORY_TRACKING
+// Each block starts with a header that tells the size and the tag it is counted for.
+// The header is 16 bytes so that the user's memory stays as aligned as the block.
+struct alignas(16) TrackedHeader { size_t size; inl::eMemoryTag tag; };
+template <bool throw_> static void *tracked_new(size_t size)
+{
+	TrackedHeader *header = (TrackedHeader*)ltmalloc<throw_>(size + sizeof(TrackedHeader));
+	if (unlikely(!header)) return NULL;
+	header->size = size;
+	header->tag = inl::MemoryTracker::GetThreadTag();
+	inl::MemoryTracker::RecordAllocation(header->tag, size);
+	return header + 1;
+}
+static void tracked_delete(void *p)
+{
+	if (!p) return;
+	TrackedHeader *header = (TrackedHeader*)p - 1;
+	inl::MemoryTracker::RecordFree(header->tag, header->size);
+	ltfree(header);
+}
+#define LTALLOC_NEW(throw_, size) tracked_new<throw_>(size)
+#define LTALLOC_DELETE(p) tracked_delete(p)
+#else
+#define LTALLOC_NEW(throw_, size) ltmalloc<throw_>(size)
+#define LTALLOC_DELETE(p) ltfree(p)
+#endif
+
+void *operator new  (size_t size) THROWS                         {return LTALLOC_NEW(true,  size);}
+void *operator new  (size_t size, const std::nothrow_t&) throw() {return LTALLOC_NEW(false, size);}
+void *operator new[](size_t size) THROWS                         {return LTALLOC_NEW(true,  size);}
+void *operator new[](size_t size, const std::nothrow_t&) throw() {return LTALLOC_NEW(false, size);}
 
-void operator delete  (void* p)                        throw() {ltfree(p);}
-void operator delete  (void* p, const std::nothrow_t&) throw() {ltfree(p);}
-void operator delete[](void* p)                        throw() {ltfree(p);}
-void operator delete[](void* p, const std::nothrow_t&) throw() {ltfree(p);}
+void operator delete  (void* p)                        throw() {LTALLOC_DELETE(p);}
+void operator delete  (void* p, const std::nothrow_t&) throw() {LTALLOC_DELETE(p);}
+void operator delete[](void* p)                        throw() {LTALLOC_DELETE(p);}
+void operator delete[](void* p, const std::nothrow_t&) throw() {LTALLOC_DELETE(p);}
 #endif
 
 /* @r-lyeh's { */
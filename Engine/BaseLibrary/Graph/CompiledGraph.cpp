@@ -0,0 +1,259 @@
+#include "CompiledGraph.hpp"
+
+#include "../Exception/Exception.hpp"
+#include "../JobSystem/Parallel.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace inl {
+
+
+// Kernel calls per job, a single call of an arithmetic kernel takes a few nanoseconds.
+static constexpr size_t JobKernelCalls = 4096;
+
+
+namespace {
+
+	// How values of a port type are stored in the arena.
+	struct ValueType {
+		size_t size;
+		size_t alignment;
+		void (*readPort)(const InputPortBase* port, void* value);
+	};
+
+	template <class T>
+	std::pair<std::type_index, ValueType> MakeValueType() {
+		// Ports of InputPortConfig use the default converter.
+		auto readPort = [](const InputPortBase* port, void* value) {
+			*reinterpret_cast<T*>(value) = static_cast<const InputPort<T>*>(port)->Get();
+		};
+		return { typeid(T), ValueType{ sizeof(T), alignof(T), readPort } };
+	}
+
+	const ValueType* FindValueType(std::type_index type) {
+		static const std::unordered_map<std::type_index, ValueType> valueTypes = {
+			MakeValueType<bool>(),
+			MakeValueType<char>(),
+			MakeValueType<signed char>(),
+			MakeValueType<unsigned char>(),
+			MakeValueType<short>(),
+			MakeValueType<unsigned short>(),
+			MakeValueType<int>(),
+			MakeValueType<unsigned int>(),
+			MakeValueType<long>(),
+			MakeValueType<unsigned long>(),
+			MakeValueType<long long>(),
+			MakeValueType<unsigned long long>(),
+			MakeValueType<float>(),
+			MakeValueType<double>(),
+		};
+		auto it = valueTypes.find(type);
+		return it != valueTypes.end() ? &it->second : nullptr;
+	}
+
+	uint32_t Allocate(size_t& arenaSize, const ValueType& valueType) {
+		size_t offset = (arenaSize + valueType.alignment - 1) / valueType.alignment * valueType.alignment;
+		arenaSize = offset + valueType.size;
+		return uint32_t(offset);
+	}
+
+} // namespace
+
+
+CompiledGraph::CompiledGraph(const std::vector<NodeBase*>& nodes) {
+	std::unordered_map<const NodeBase*, size_t> nodeIndices;
+	std::unordered_map<const OutputPortBase*, std::pair<size_t, size_t>> outputOwners;
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		if (!nodes[i]->GetKernel()) {
+			throw InvalidArgumentException("Node cannot be compiled, it has no kernel.", nodes[i]->GetClassName());
+		}
+		if (!nodeIndices.insert({ nodes[i], i }).second) {
+			throw InvalidArgumentException("Node is listed more than once.", nodes[i]->GetClassName());
+		}
+		for (size_t j = 0; j < nodes[i]->GetNumOutputs(); ++j) {
+			outputOwners.insert({ nodes[i]->GetOutput(j), { i, j } });
+		}
+	}
+
+	// Sort the nodes into levels, each level only reads the outputs of earlier ones.
+	std::vector<std::vector<size_t>> consumers(nodes.size());
+	std::vector<size_t> numPending(nodes.size(), 0);
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		for (size_t j = 0; j < nodes[i]->GetNumInputs(); ++j) {
+			auto it = outputOwners.find(nodes[i]->GetInput(j)->GetLink());
+			if (it != outputOwners.end()) {
+				consumers[it->second.first].push_back(i);
+				++numPending[i];
+			}
+		}
+	}
+
+	std::vector<size_t> order;
+	order.reserve(nodes.size());
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		if (numPending[i] == 0) {
+			order.push_back(i);
+		}
+	}
+	m_levels.push_back(0);
+	for (size_t levelBegin = 0; levelBegin < order.size();) {
+		size_t levelEnd = order.size();
+		for (size_t k = levelBegin; k < levelEnd; ++k) {
+			for (size_t consumer : consumers[order[k]]) {
+				if (--numPending[consumer] == 0) {
+					order.push_back(consumer);
+				}
+			}
+		}
+		std::sort(order.begin() + levelEnd, order.end());
+		m_levels.push_back(levelEnd);
+		levelBegin = levelEnd;
+	}
+	if (order.size() != nodes.size()) {
+		throw InvalidArgumentException("Nodes with circular links cannot be compiled.");
+	}
+
+	// Give each output a slot first, then each unlinked input.
+	size_t arenaSize = 0;
+	std::vector<uint32_t> outputOffsets;
+	std::vector<size_t> firstOutputOffset(nodes.size());
+	for (size_t i : order) {
+		firstOutputOffset[i] = outputOffsets.size();
+		for (size_t j = 0; j < nodes[i]->GetNumOutputs(); ++j) {
+			const ValueType* valueType = FindValueType(nodes[i]->GetOutput(j)->GetType());
+			if (!valueType) {
+				throw InvalidArgumentException("Node cannot be compiled, an output type is not supported.", nodes[i]->GetClassName());
+			}
+			outputOffsets.push_back(Allocate(arenaSize, *valueType));
+		}
+	}
+
+	std::vector<std::pair<uint32_t, const InputPortBase*>> initialInputs;
+	for (size_t i : order) {
+		const NodeBase* node = nodes[i];
+		Step step;
+		step.kernel = node->GetKernel();
+		step.firstInput = uint32_t(m_offsets.size());
+		for (size_t j = 0; j < node->GetNumInputs(); ++j) {
+			const InputPortBase* port = node->GetInput(j);
+			const ValueType* valueType = FindValueType(port->GetType());
+			if (!valueType) {
+				throw InvalidArgumentException("Node cannot be compiled, an input type is not supported.", node->GetClassName());
+			}
+			auto it = outputOwners.find(port->GetLink());
+			if (it != outputOwners.end()) {
+				auto [source, sourcePort] = it->second;
+				if (nodes[source]->GetOutput(sourcePort)->GetType() != port->GetType()) {
+					throw InvalidArgumentException("Linked ports of compiled nodes must have the same type.", node->GetClassName());
+				}
+				m_offsets.push_back(outputOffsets[firstOutputOffset[source] + sourcePort]);
+				m_ports.push_back({ port->GetType(), true });
+			}
+			else {
+				uint32_t offset = Allocate(arenaSize, *valueType);
+				if (port->IsSet()) {
+					initialInputs.push_back({ offset, port });
+				}
+				m_offsets.push_back(offset);
+				m_ports.push_back({ port->GetType(), false });
+			}
+		}
+		step.firstOutput = uint32_t(m_offsets.size());
+		for (size_t j = 0; j < node->GetNumOutputs(); ++j) {
+			m_offsets.push_back(outputOffsets[firstOutputOffset[i] + j]);
+			m_ports.push_back({ node->GetOutput(j)->GetType(), false });
+		}
+		m_nodeSteps.insert({ node, m_steps.size() });
+		m_steps.push_back(step);
+	}
+
+	m_initialState.resize(arenaSize, std::byte(0));
+	for (auto [offset, port] : initialInputs) {
+		FindValueType(port->GetType())->readPort(port, m_initialState.data() + offset);
+	}
+}
+
+
+std::vector<std::byte> CompiledGraph::CreateState() const {
+	return m_initialState;
+}
+
+
+void CompiledGraph::Execute(std::vector<std::byte>& state, jobs::Scheduler* scheduler) const {
+	if (state.size() != m_initialState.size()) {
+		throw InvalidArgumentException("State was not created by this graph.");
+	}
+
+	std::byte* arena = state.data();
+	for (size_t level = 0; level + 1 < m_levels.size(); ++level) {
+		size_t first = m_levels[level];
+		size_t last = m_levels[level + 1];
+		if (scheduler && last - first >= ParallelLevelWidth) {
+			jobs::CooperativeFor(scheduler, last - first, ParallelLevelWidth, [&](size_t chunkFirst, size_t chunkLast) {
+				ExecuteSteps(arena, first + chunkFirst, first + chunkLast);
+			});
+		}
+		else {
+			ExecuteSteps(arena, first, last);
+		}
+	}
+}
+
+
+void CompiledGraph::Execute(std::vector<std::byte>* states, size_t count, jobs::Scheduler* scheduler) const {
+	for (size_t i = 0; i < count; ++i) {
+		if (states[i].size() != m_initialState.size()) {
+			throw InvalidArgumentException("State was not created by this graph.");
+		}
+	}
+
+	size_t chunkSize = std::max(size_t(1), JobKernelCalls / std::max(size_t(1), m_steps.size()));
+	jobs::CooperativeFor(scheduler, count, chunkSize, [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i) {
+			ExecuteSteps(states[i].data(), 0, m_steps.size());
+		}
+	});
+}
+
+
+void CompiledGraph::ExecuteSteps(std::byte* arena, size_t first, size_t last) const {
+	const uint32_t* offsets = m_offsets.data();
+	for (size_t i = first; i < last; ++i) {
+		const Step& step = m_steps[i];
+		step.kernel({ arena, offsets + step.firstInput, offsets + step.firstOutput });
+	}
+}
+
+
+uint32_t CompiledGraph::FindInput(const NodeBase* node, size_t index, std::type_index type) const {
+	auto it = m_nodeSteps.find(node);
+	if (it == m_nodeSteps.end() || index >= node->GetNumInputs()) {
+		throw InvalidArgumentException("Node or port is not part of the graph.");
+	}
+	size_t port = m_steps[it->second].firstInput + index;
+	if (m_ports[port].type != type) {
+		throw InvalidArgumentException("Port has a different type.", type.name());
+	}
+	if (m_ports[port].linked) {
+		throw InvalidArgumentException("Linked inputs are set by their link.");
+	}
+	return m_offsets[port];
+}
+
+
+uint32_t CompiledGraph::FindOutput(const NodeBase* node, size_t index, std::type_index type) const {
+	auto it = m_nodeSteps.find(node);
+	if (it == m_nodeSteps.end() || index >= node->GetNumOutputs()) {
+		throw InvalidArgumentException("Node or port is not part of the graph.");
+	}
+	size_t port = m_steps[it->second].firstOutput + index;
+	if (m_ports[port].type != type) {
+		throw InvalidArgumentException("Port has a different type.", type.name());
+	}
+	return m_offsets[port];
+}
+
+
+} // namespace inl
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Node.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+
+namespace inl {
+
+namespace jobs {
+	class Scheduler;
+}
+
+
+/// <summary>
+/// <para> A network of nodes flattened into a list of kernel calls. </para>
+/// <para>
+/// Compiling sorts the nodes so that each comes after the nodes it reads from, and gives every
+/// output port and every input port without a link a slot in a value arena. Executing calls the
+/// <see cref="NodeBase::GetKernel"/> of each node in order on the arena, so no ports, notifications
+/// or virtual calls are involved. The same compiled graph can execute any number of arenas,
+/// one for each instance of the network.
+/// </para>
+/// <para>
+/// Only nodes that have a kernel and ports of plain arithmetic types can be compiled, and linked
+/// ports must have the same type. The nodes must exist and keep their links while the graph is in use.
+/// </para>
+/// </summary>
+class CompiledGraph {
+public:
+	/// <summary> Nodes of the same level at which executing a single arena is split into jobs. </summary>
+	static constexpr size_t ParallelLevelWidth = 256;
+
+	/// <param name="nodes"> The network. Links from nodes not in the list count as unlinked inputs. </param>
+	/// <exception cref="InvalidArgumentException"> If the nodes contain a cycle, or a node or link cannot be compiled. </exception>
+	explicit CompiledGraph(const std::vector<NodeBase*>& nodes);
+
+	/// <summary> Creates an arena for one instance of the network. </summary>
+	/// <remarks> Unlinked inputs start from the values set on their ports at compile time, everything else is zero. </remarks>
+	std::vector<std::byte> CreateState() const;
+
+	/// <summary> Calls the kernels of all nodes on the arena. </summary>
+	/// <param name="scheduler"> Levels with many independent nodes are split into jobs here. Null runs everything on the calling thread. </param>
+	void Execute(std::vector<std::byte>& state, jobs::Scheduler* scheduler = nullptr) const;
+	/// <summary> Executes many instances of the network, split into jobs. </summary>
+	void Execute(std::vector<std::byte>* states, size_t count, jobs::Scheduler* scheduler = nullptr) const;
+
+	/// <summary> Sets the value of an unlinked input in the arena. </summary>
+	/// <exception cref="InvalidArgumentException"> If the port is linked or the type differs. </exception>
+	template <class T>
+	void SetInput(std::vector<std::byte>& state, const NodeBase* node, size_t index, const T& value) const;
+	/// <summary> Gets the value of an output in the arena. </summary>
+	/// <exception cref="InvalidArgumentException"> If the type differs. </exception>
+	template <class T>
+	const T& GetOutput(const std::vector<std::byte>& state, const NodeBase* node, size_t index) const;
+
+	size_t GetNumNodes() const { return m_steps.size(); }
+	/// <summary> Number of groups of nodes that only depend on earlier groups. </summary>
+	size_t GetNumLevels() const { return m_levels.size() - 1; }
+	/// <summary> Size of one arena in bytes. </summary>
+	size_t GetStateSize() const { return m_initialState.size(); }
+private:
+	struct Step {
+		NodeKernel kernel;
+		uint32_t firstInput; // Index into the offsets of the ports.
+		uint32_t firstOutput;
+	};
+	struct PortInfo {
+		std::type_index type;
+		bool linked;
+	};
+
+	void ExecuteSteps(std::byte* arena, size_t first, size_t last) const;
+	uint32_t FindInput(const NodeBase* node, size_t index, std::type_index type) const;
+	uint32_t FindOutput(const NodeBase* node, size_t index, std::type_index type) const;
+
+private:
+	std::vector<Step> m_steps; // In the order of execution.
+	std::vector<size_t> m_levels; // First step of each level, and the end of the last.
+	std::vector<uint32_t> m_offsets; // Arena offsets of the input then the output ports of each step.
+	std::vector<PortInfo> m_ports; // Same order as the offsets.
+	std::unordered_map<const NodeBase*, size_t> m_nodeSteps;
+	std::vector<std::byte> m_initialState;
+};
+
+
+template <class T>
+void CompiledGraph::SetInput(std::vector<std::byte>& state, const NodeBase* node, size_t index, const T& value) const {
+	*reinterpret_cast<T*>(state.data() + FindInput(node, index, typeid(T))) = value;
+}
+
+
+template <class T>
+const T& CompiledGraph::GetOutput(const std::vector<std::byte>& state, const NodeBase* node, size_t index) const {
+	return *reinterpret_cast<const T*>(state.data() + FindOutput(node, index, typeid(T)));
+}
+
+
+} // namespace inl
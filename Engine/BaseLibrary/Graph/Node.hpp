@@ -9,6 +9,7 @@
 #include "Port.hpp"
 
 #include <cstddef>
+#include <cstdint>
 #include <type_traits>
 #include <string>
 #include <initializer_list>
@@ -27,6 +28,22 @@ namespace inl {
 class InputPortBase;
 
 
+/// <summary> Where a node kernel finds its port values in the arena of a <see cref="CompiledGraph"/>. </summary>
+struct NodeKernelArgs {
+	std::byte* arena;
+	const uint32_t* inputs; // Offsets into the arena for each input port.
+	const uint32_t* outputs; // Offsets into the arena for each output port.
+
+	template <class T>
+	const T& GetInput(size_t index) const { return *reinterpret_cast<const T*>(arena + inputs[index]); }
+	template <class T>
+	T& GetOutput(size_t index) const { return *reinterpret_cast<T*>(arena + outputs[index]); }
+};
+
+/// <summary> Computes the outputs of a node from its inputs, without going through its ports. </summary>
+using NodeKernel = void (*)(const NodeKernelArgs& args);
+
+
 /// <summary>
 /// <para> Base class for nodes. </para>
 /// <para>
@@ -72,6 +89,10 @@ public:
 	/// <summary> Called by the input ports of the node to notify new data. </summary>
 	virtual void Notify(InputPortBase* sender) = 0;
 
+	/// <summary> Returns the function that does what <see cref="Update"/> does on the values of a <see cref="CompiledGraph"/>. </summary>
+	/// <returns> Null if the node can only be evaluated through its ports. </returns>
+	virtual NodeKernel GetKernel() const { return nullptr; }
+
 	/// <summary> Returns the name of the input port. This is optionally specified for the node class. </summary>
 	virtual const std::string& GetInputName(size_t index) const override { static const std::string n = ""; return n; }
 	/// <summary> Returns the name of the output port. This is optionally specified for the node class. </summary>
@@ -14,6 +14,16 @@ NodeBase* NodeFactory::CreateNode(const std::string& name) const {
 	}
 }
 
+const std::function<NodeBase*()>* NodeFactory::FindCreator(const std::string& name) const {
+	auto it = registeredClasses.find(name);
+	if (it == registeredClasses.end() || !it->second.creator) {
+		return nullptr;
+	}
+	else {
+		return &it->second.creator;
+	}
+}
+
 const NodeFactory::NodeInfo* NodeFactory::GetNodeInfo(const std::string& name) const {
 	auto it = registeredClasses.find(name);
 	if (it == registeredClasses.end()) {
@@ -57,6 +57,10 @@ public:
 	/// <summary> Instantiate node class by name. </summary>
 	virtual NodeBase* CreateNode(const std::string& name) const;
 
+	/// <summary> Get the function that instantiates a node class, so that many nodes can be created with a single lookup. </summary>
+	/// <returns> Null if there is no such class. Valid until another class is registered. </returns>
+	const std::function<NodeBase*()>* FindCreator(const std::string& name) const;
+
 	/// <summary> Get information about a node by name. </summary>
 	const NodeInfo* GetNodeInfo(const std::string& name) const;
 
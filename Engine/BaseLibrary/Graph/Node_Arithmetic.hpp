@@ -27,6 +27,13 @@ public:
 		Update();
 	}
 
+	NodeKernel GetKernel() const override {
+		return &Kernel;
+	}
+	static void Kernel(const NodeKernelArgs& args) {
+		args.GetOutput<ArithmeticT>(0) = Operator()(args.GetInput<ArithmeticT>(0), args.GetInput<ArithmeticT>(1));
+	}
+
 	static std::string Info_GetName() {
 		return name;
 	}
@@ -25,6 +25,13 @@ public:
 		Update();
 	}
 
+	NodeKernel GetKernel() const override {
+		return &Kernel;
+	}
+	static void Kernel(const NodeKernelArgs& args) {
+		args.GetOutput<bool>(0) = OperatorT()(args.GetInput<OperandT>(0), args.GetInput<OperandT>(1));
+	}
+
 	static std::string Info_GetName() {
 		return name;
 	}
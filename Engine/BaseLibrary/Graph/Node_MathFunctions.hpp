@@ -28,6 +28,13 @@ public:
 		Update();
 	}
 
+	NodeKernel GetKernel() const override {
+		return &Kernel;
+	}
+	static void Kernel(const NodeKernelArgs& args) {
+		args.GetOutput<ArithmeticT>(0) = Function(args.GetInput<ArithmeticT>(0));
+	}
+
 	static std::string Info_GetName() {
 		return name;
 	}
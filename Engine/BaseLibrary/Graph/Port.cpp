@@ -47,6 +47,9 @@ OutputPortBase* InputPortBase::GetLink() const {
 
 void InputPortBase::SetLinkState(OutputPortBase* link) {
 	this->link = link;
+	if (link != nullptr) {
+		OnLinked(link->GetType());
+	}
 }
 
 
@@ -196,6 +196,8 @@ protected:
 class InputPortBase : public ISerializableInputPort {
 	friend class OutputPortBase;
 	friend class OutputPort<Any>;
+	template <class T>
+	friend class OutputPort;
 public:
 	InputPortBase();
 	~InputPortBase();
@@ -241,6 +243,11 @@ protected:
 	OutputPortBase* link;
 	void NotifyAll();
 	virtual void SetConvert(const void* object, std::type_index type) = 0;
+	/// <summary> Sets a value of the type of the linked output port, and notifies the observers. </summary>
+	/// <remarks> Called by typed output ports with the conversion picked when they were linked. </remarks>
+	virtual void SetFromLink(const void* object) {}
+	/// <summary> Picks the conversion from the type of a newly linked output port. </summary>
+	virtual void OnLinked(std::type_index sourceType) {}
 private:
 	// should only be called by an output port when it's ready with building up the linkage
 	// this function only sets internal state of the inputport to represent the link set up by outputport
@@ -315,16 +322,24 @@ public:
 	}
 
 	std::string ToString() const override {
-		return converter.ToString(data);
+		return GetConverter().ToString(data);
 	}
 
 	virtual bool IsCompatible(std::type_index type) const override;
 protected:
 	virtual void SetConvert(const void* object, std::type_index type) override;
+	void SetFromLink(const void* object) override;
+	void OnLinked(std::type_index sourceType) override;
 private:
+	// Converters are stateless, all ports of a type share one.
+	static const ConverterT& GetConverter() {
+		static const ConverterT converter;
+		return converter;
+	}
+
 	bool isSet;
 	T data;
-	ConverterT converter;
+	std::function<void(const void*, void*)> linkConverter; // Empty if the linked port has the same type.
 };
 
 
@@ -335,7 +350,32 @@ void InputPort<T, ConverterT>::SetConvert(const void* object, std::type_index ty
 		data = *reinterpret_cast<const T*>(object);
 	}
 	else {
-		converter[type](object, &data);
+		GetConverter()[type](object, &data);
+	}
+}
+
+
+template <class T, class ConverterT>
+void InputPort<T, ConverterT>::SetFromLink(const void* object) {
+	if (linkConverter) {
+		linkConverter(object, &data);
+	}
+	else {
+		data = *reinterpret_cast<const T*>(object);
+	}
+	isSet = true;
+	NotifyAll();
+}
+
+
+template <class T, class ConverterT>
+void InputPort<T, ConverterT>::OnLinked(std::type_index sourceType) {
+	// Any-type output ports convert the values they carry one by one.
+	if (sourceType != typeid(T) && GetConverter().CanConvert(sourceType)) {
+		linkConverter = GetConverter()[sourceType];
+	}
+	else {
+		linkConverter = nullptr;
 	}
 }
 
@@ -346,7 +386,7 @@ bool InputPort<T, ConverterT>::IsCompatible(std::type_index type) const {
 		return true;
 	}
 	else {
-		return converter.CanConvert(type);
+		return GetConverter().CanConvert(type);
 	}
 }
 
@@ -433,6 +473,9 @@ protected:
 		isSet = true;
 		// conversion does nothing
 	}
+	void SetFromLink(const void* object) override {
+		Set();
+	}
 private:
 	bool isSet;
 };
@@ -573,14 +616,12 @@ private:
 template <class T>
 void OutputPort<T>::Set(const T& data) {
 	for (auto v : links) {
-		if (v->GetType() == GetType()) {
-			static_cast<InputPort<T>*>(v)->Set(data);
-		}
-		else if (v->GetType() == typeid(Any)) {
+		// Only ports of dynamic type need the value boxed, the rest convert with what they picked when linked.
+		if (v->GetType() == typeid(Any)) {
 			static_cast<InputPort<Any>*>(v)->Set(data);
 		}
 		else {
-			v->SetConvert(data);
+			v->SetFromLink(&data);
 		}
 	}
 }
@@ -4,6 +4,7 @@
 #include <BaseLibrary/Range.hpp>
 #include <BaseLibrary/Exception/Exception.hpp>
 
+#include <algorithm>
 #include <sstream>
 
 #include <rapidjson/encodings.h>
@@ -21,6 +22,7 @@ namespace inl {
 static void AssertThrow(bool condition, const std::string& message);
 static NodeDescription ParseNode(const rapidjson::GenericValue<rapidjson::UTF8<>>& jsonObj);
 static LinkDescription ParseLink(const rapidjson::GenericValue<rapidjson::UTF8<>>& jsonObj);
+static bool RefersTo(const LinkDescription& link, const NodeDescription& node, bool source);
 
 struct StringErrorPosition {
 	int lineNumber;
@@ -42,6 +44,98 @@ void GraphParser::Parse(const std::string& json) {
 }
 
 
+size_t GraphParser::AddNode(NodeDescription node) {
+	AssertThrow(node.id || node.name, "Node must have either id or name.");
+	AssertThrow(!node.name || m_nameLookup.count(node.name.value()) == 0, "Node names must be unique.");
+	AssertThrow(!node.id || m_idLookup.count(node.id.value()) == 0, "Node ids must be unique.");
+
+	size_t index = m_nodeDescs.size();
+	if (node.name) {
+		m_nameLookup.insert({ node.name.value(), index });
+	}
+	if (node.id) {
+		m_idLookup.insert({ node.id.value(), index });
+	}
+	m_nodeDescs.push_back(std::move(node));
+	return index;
+}
+
+
+void GraphParser::RemoveNode(size_t index) {
+	if (index >= m_nodeDescs.size()) {
+		throw OutOfRangeException("Node was not found.");
+	}
+	const NodeDescription& node = m_nodeDescs[index];
+
+	auto linksEnd = std::remove_if(m_linkDescs.begin(), m_linkDescs.end(), [&node](const LinkDescription& link) {
+		return RefersTo(link, node, true) || RefersTo(link, node, false);
+	});
+	m_linkDescs.erase(linksEnd, m_linkDescs.end());
+
+	if (node.name) {
+		m_nameLookup.erase(node.name.value());
+	}
+	if (node.id) {
+		m_idLookup.erase(node.id.value());
+	}
+	m_nodeDescs.erase(m_nodeDescs.begin() + index);
+
+	// Only the indices of the nodes after the removed one change.
+	for (size_t i = index; i < m_nodeDescs.size(); ++i) {
+		if (m_nodeDescs[i].name) {
+			m_nameLookup[m_nodeDescs[i].name.value()] = i;
+		}
+		if (m_nodeDescs[i].id) {
+			m_idLookup[m_nodeDescs[i].id.value()] = i;
+		}
+	}
+}
+
+
+void GraphParser::SetDefaultInput(size_t node, size_t port, std::optional<std::string> value) {
+	if (node >= m_nodeDescs.size()) {
+		throw OutOfRangeException("Node was not found.");
+	}
+	auto& defaultInputs = m_nodeDescs[node].defaultInputs;
+	if (defaultInputs.size() < port + 1) {
+		defaultInputs.resize(port + 1);
+	}
+	defaultInputs[port] = std::move(value);
+}
+
+
+void GraphParser::SetMetaData(size_t node, NodeMetaDescription metaData) {
+	if (node >= m_nodeDescs.size()) {
+		throw OutOfRangeException("Node was not found.");
+	}
+	m_nodeDescs[node].metaData = metaData;
+}
+
+
+size_t GraphParser::AddLink(LinkDescription link) {
+	AssertThrow((link.srcid || link.srcname) && (link.dstid || link.dstname), "Link must have src and dst.");
+	AssertThrow((link.srcpidx || link.srcpname) && (link.dstpidx || link.dstpname), "Link must have srcp and dstp.");
+	FindNode(link.srcid, link.srcname);
+	FindNode(link.dstid, link.dstname);
+
+	m_linkDescs.push_back(std::move(link));
+	return m_linkDescs.size() - 1;
+}
+
+
+void GraphParser::RemoveLink(size_t index) {
+	if (index >= m_linkDescs.size()) {
+		throw OutOfRangeException("Link was not found.");
+	}
+	m_linkDescs.erase(m_linkDescs.begin() + index);
+}
+
+
+std::string GraphParser::Serialize() const {
+	return MakeJson(m_nodeDescs, m_linkDescs, m_header);
+}
+
+
 std::string GraphParser::Serialize(const ISerializableNode* const* nodes,
 								   const NodeMetaDescription* metaData,
 								   size_t count,
@@ -521,6 +615,16 @@ LinkDescription ParseLink(const rapidjson::GenericValue<rapidjson::UTF8<>>& obj)
 }
 
 
+bool RefersTo(const LinkDescription& link, const NodeDescription& node, bool source) {
+	const auto& id = source ? link.srcid : link.dstid;
+	const auto& name = source ? link.srcname : link.dstname;
+	if (id) {
+		return node.id == id;
+	}
+	return name && node.name == name;
+}
+
+
 StringErrorPosition GetStringErrorPosition(const std::string& str, size_t errorCharacter) {
 	int currentCharacter = 0;
 	int characterNumber = 0;
@@ -37,10 +37,29 @@ struct GraphHeader {
 };
 
 
+/// <summary> Parses graph descriptions and keeps the parsed model for lookups and edits. </summary>
+/// <remarks> The edit methods apply a single change to the model and its lookup tables,
+///		so that editing one node or link does not need the whole document to be parsed again. </remarks>
 class GraphParser {
 public:
 	void Parse(const std::string& json);
 
+	/// <summary> Appends a node to the model, returns its index. </summary>
+	/// <exception cref="InvalidArgumentException"> If the node has neither id nor name, or they are already taken. </exception>
+	size_t AddNode(NodeDescription node);
+	/// <summary> Removes a node and the links that refer to it. Nodes after it move one index down. </summary>
+	void RemoveNode(size_t index);
+	void SetDefaultInput(size_t node, size_t port, std::optional<std::string> value);
+	void SetMetaData(size_t node, NodeMetaDescription metaData);
+
+	/// <summary> Appends a link between two nodes of the model, returns its index. </summary>
+	/// <exception cref="OutOfRangeException"> If either end refers to a node not in the model. </exception>
+	size_t AddLink(LinkDescription link);
+	void RemoveLink(size_t index);
+
+	/// <summary> Writes the current model back to JSON. </summary>
+	std::string Serialize() const;
+
 	// TODO: make common interface for all node/port systems.
 	static std::string Serialize(const ISerializableNode* const* nodes,
 								 const NodeMetaDescription* metaData,
@@ -18,6 +18,14 @@ struct Link {
 };
 
 
+/// <summary> What a node of a running graph took in one frame. </summary>
+struct NodeCost {
+	float setupMilliseconds = 0.0f; // CPU time of preparing the node.
+	float executeMilliseconds = 0.0f; // CPU time of recording its work.
+	float gpuMilliseconds = 0.0f; // Zero if the GPU is not measured.
+};
+
+
 class IEditorGraph {
 public:
 	virtual ~IEditorGraph() = default;
@@ -30,6 +38,8 @@ public:
 
 	virtual Link Link(IGraphEditorNode* sourceNode, int sourcePort, IGraphEditorNode* targetNode, int targetPort) = 0;
 	virtual void Unlink(IGraphEditorNode* targetNode, int targetPort) = 0;
+	/// <summary> Sets the value of an unlinked input port, only the given port is converted and checked. </summary>
+	virtual void SetDefaultInput(IGraphEditorNode* node, int port, const std::string& value) = 0;
 
 	virtual std::vector<IGraphEditorNode*> GetNodes() const = 0;
 	virtual std::vector<inl::Link> GetLinks() const = 0;
@@ -41,6 +51,11 @@ public:
 	virtual const std::string& GetContentType() const = 0;
 	virtual void Clear() = 0;
 
+	/// <summary> Costs of the node in the recent frames of the running graph, oldest first. </summary>
+	/// <remarks> The node is matched to the running graph by its name. Empty if there is no match
+	///		or the graph is not measured. </remarks>
+	virtual std::vector<NodeCost> GetCostHistory(const IGraphEditorNode* node) const { return {}; }
+
 };
 
 
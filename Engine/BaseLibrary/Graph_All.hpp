@@ -4,6 +4,7 @@
 #include "Graph/Node_Comparison.hpp"
 #include "Graph/Node_Logic.hpp"
 #include "Graph/Node_MathFunctions.hpp"
+#include "Graph/CompiledGraph.hpp"
 
 #include "Graph/Node.hpp"
 #include "Graph/Node.hpp"
@@ -1,6 +1,7 @@
 #include "ConditionVariable.hpp"
 #include <mutex>
 #include "Future.hpp"
+#include "Tracer.hpp"
 
 
 namespace inl::jobs {
@@ -14,7 +15,8 @@ ConditionVariable::CvarAwaiter::CvarAwaiter(CvarAwaiter&& rhs)
 	m_next(rhs.m_next),
 	m_awaitingHandle(std::move(rhs.m_awaitingHandle)),
 	m_mutexAwaiter(std::move(rhs.m_mutexAwaiter)),
-	m_scheduler(rhs.m_scheduler)
+	m_scheduler(rhs.m_scheduler),
+	m_options(rhs.m_options)
 {
 	rhs.m_awaitingHandle = {};
 	rhs.m_next = nullptr;
@@ -30,10 +32,12 @@ bool ConditionVariable::CvarAwaiter::await_ready() const noexcept {
 }
 
 
-bool ConditionVariable::CvarAwaiter::await_suspend(std::experimental::coroutine_handle<> awaitingCoroutine, Scheduler* scheduler) noexcept {
+bool ConditionVariable::CvarAwaiter::await_suspend(std::experimental::coroutine_handle<> awaitingCoroutine, Scheduler* scheduler, JobOptions options) noexcept {
 	// Coroutine is suspended.
 	m_awaitingHandle = awaitingCoroutine;
 	m_scheduler = scheduler;
+	m_options = options;
+	Tracer::Record(eTraceEvent::SUSPEND_CONDITION_VARIABLE, awaitingCoroutine.address());
 
 	// Add this to the waiting list.
 	bool success;
@@ -73,16 +77,19 @@ void ConditionVariable::WaitExplicit(UniqueLock& lock) {
 void ConditionVariable::AwakeAwaiter(CvarAwaiter* last) {
 	last->m_mutexAwaiter.emplace(last->m_mtx.Lock());
 
-	bool isReady = last->m_mutexAwaiter->await_ready();
+	// We are on the notifier's thread, which often still holds the mutex, so spinning here would only
+	// delay the notifier. The waiter is queued on the mutex instead and resumed directly by Unlock.
+	last->m_mutexAwaiter->m_wasAwaited = true;
+	bool isReady = last->m_mutexAwaiter->TryAcquire(false);
 	bool isSuspended = true;
 	if (!isReady) {
 		// Hack it into the mutex's awake queue if mutex could not be acquired immediately.
-		isSuspended = last->m_mutexAwaiter->await_suspend(last->m_awaitingHandle, last->m_scheduler);
+		isSuspended = last->m_mutexAwaiter->await_suspend(last->m_awaitingHandle, last->m_scheduler, last->m_options);
 	}
 	if (isReady || !isSuspended) {
 		// Resume coroutine if mutex has been acquired immediately.
 		if (last->m_scheduler) {
-			last->m_scheduler->Resume(last->m_awaitingHandle);
+			last->m_scheduler->Resume(last->m_awaitingHandle, last->m_options);
 		}
 		else {
 			last->m_awaitingHandle.resume();
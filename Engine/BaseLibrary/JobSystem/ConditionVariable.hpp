@@ -30,13 +30,14 @@ public:
 	protected:
 		CvarAwaiter(const ConditionVariable& cvar, UniqueLock& mtx, std::function<bool()> pred = {}) noexcept
 			: m_cvar(cvar), m_mtx(mtx), m_pred(pred) {}
-		bool await_suspend(std::experimental::coroutine_handle<> awaitingCoroutine, Scheduler* scheduler = nullptr) noexcept;
+		bool await_suspend(std::experimental::coroutine_handle<> awaitingCoroutine, Scheduler* scheduler = nullptr, JobOptions options = {}) noexcept;
 
 	private:
 		std::experimental::coroutine_handle<> m_awaitingHandle;
 		std::function<bool()> m_pred;
 		CvarAwaiter* m_next = nullptr;
 		Scheduler* m_scheduler = nullptr;
+		JobOptions m_options;
 		const ConditionVariable& m_cvar;
 		std::optional<MutexAwaiter> m_mutexAwaiter;
 		UniqueLock& m_mtx;
@@ -63,10 +64,12 @@ private:
 template <class T>
 bool ConditionVariable::CvarAwaiter::await_suspend(T awaitingCoroutine) noexcept {
 	Scheduler* scheduler = nullptr;
+	JobOptions options;
 	if constexpr (std::is_base_of_v<SchedulablePromiseTag, std::decay_t<decltype(awaitingCoroutine.promise())>>) {
 		scheduler = static_cast<const SchedulablePromiseTag&>(awaitingCoroutine.promise()).m_scheduler;
+		options = static_cast<const SchedulablePromiseTag&>(awaitingCoroutine.promise()).m_options;
 	}
-	return await_suspend(std::experimental::coroutine_handle<>(awaitingCoroutine), scheduler);
+	return await_suspend(std::experimental::coroutine_handle<>(awaitingCoroutine), scheduler, options);
 }
 
 template <class Predicate>
@@ -1,5 +1,6 @@
 #include "Fence.hpp"
 #include "Scheduler.hpp"
+#include "Tracer.hpp"
 
 #include <mutex>
 #include <future>
@@ -21,9 +22,10 @@ Fence::FenceAwaiter::FenceAwaiter(const Fence& f, uint64_t expected) noexcept
 	a = 0;
 }
 
-bool Fence::FenceAwaiter::await_suspend(std::experimental::coroutine_handle<> awaitingCoroutine, Scheduler* scheduler) noexcept {
+bool Fence::FenceAwaiter::await_suspend(std::experimental::coroutine_handle<> awaitingCoroutine, Scheduler* scheduler, JobOptions options) noexcept {
 	m_awaitingHandle = awaitingCoroutine;
 	m_scheduler = scheduler;
+	m_options = options;
 
 	std::lock_guard<SpinMutex> lkg(m_fence.m_mtx);
 
@@ -37,6 +39,8 @@ bool Fence::FenceAwaiter::await_suspend(std::experimental::coroutine_handle<> aw
 	m_next = first;
 	m_fence.m_firstAwaiter = this;
 
+	// Signal takes the lock before resuming, so the coroutine is still suspended here.
+	Tracer::Record(eTraceEvent::SUSPEND_FENCE, awaitingCoroutine.address());
 	return true;
 }
 
@@ -84,7 +88,7 @@ void Fence::Signal(uint64_t value) {
 				++awoke;
 				// Resume coroutine if expected value is satisfied.
 				if (list->m_scheduler) {
-					list->m_scheduler->Resume(list->m_awaitingHandle);
+					list->m_scheduler->Resume(list->m_awaitingHandle, list->m_options);
 				}
 				else {
 					list->m_awaitingHandle.resume();
@@ -24,13 +24,14 @@ public:
 		void await_resume() noexcept {}
 	private:
 		FenceAwaiter(const Fence& f, uint64_t expected) noexcept;
-		bool await_suspend(std::experimental::coroutine_handle<> awaitingCoroutine, Scheduler* scheduler = nullptr) noexcept;
+		bool await_suspend(std::experimental::coroutine_handle<> awaitingCoroutine, Scheduler* scheduler = nullptr, JobOptions options = {}) noexcept;
 	private:
 		std::experimental::coroutine_handle<> m_awaitingHandle;
 		const Fence& m_fence;
 		FenceAwaiter* m_next;
 		const uint64_t m_targetValue;
 		Scheduler* m_scheduler;
+		JobOptions m_options;
 	};
 public:
 	Fence(uint64_t initial = 0);
@@ -54,10 +55,12 @@ private:
 template <class T>
 bool Fence::FenceAwaiter::await_suspend(T awaitingCoroutine) noexcept {
 	Scheduler* scheduler = nullptr;
+	JobOptions options;
 	if constexpr (std::is_base_of_v<SchedulablePromiseTag, std::decay_t<decltype(awaitingCoroutine.promise())>>) {
 		scheduler = static_cast<const SchedulablePromiseTag&>(awaitingCoroutine.promise()).m_scheduler;
+		options = static_cast<const SchedulablePromiseTag&>(awaitingCoroutine.promise()).m_options;
 	}
-	return await_suspend(std::experimental::coroutine_handle<>(awaitingCoroutine), scheduler);
+	return await_suspend(std::experimental::coroutine_handle<>(awaitingCoroutine), scheduler, options);
 }
 
 
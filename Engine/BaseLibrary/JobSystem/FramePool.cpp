@@ -0,0 +1,157 @@
+#include "FramePool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+
+namespace inl::jobs {
+
+
+namespace {
+
+	constexpr int NumSizeClasses = 7; // 64, 128 ... 4096
+	static_assert(FramePool::MinClassSize << (NumSizeClasses - 1) == FramePool::MaxClassSize);
+
+	int SizeClassOf(size_t size) {
+		int sizeClass = 0;
+		size_t classSize = FramePool::MinClassSize;
+		while (classSize < size) {
+			classSize *= 2;
+			++sizeClass;
+		}
+		return sizeClass;
+	}
+
+	size_t ClassSize(int sizeClass) {
+		return FramePool::MinClassSize << sizeClass;
+	}
+
+
+	struct GlobalCounters {
+		std::atomic_uint64_t numAllocations = 0;
+		std::atomic_uint64_t numPoolHits = 0;
+		std::atomic_uint64_t numOversized = 0;
+		std::atomic_uint64_t numDeallocations = 0;
+		std::atomic_uint64_t numReleased = 0;
+		std::atomic_int64_t numCached = 0;
+	};
+
+	GlobalCounters& Counters() {
+		static GlobalCounters counters;
+		return counters;
+	}
+
+
+	struct FreeFrame {
+		FreeFrame* next;
+	};
+
+	struct ThreadCache {
+		FreeFrame* heads[NumSizeClasses] = {};
+		size_t counts[NumSizeClasses] = {};
+
+		~ThreadCache() {
+			Release();
+		}
+
+		void Release() noexcept {
+			for (int sizeClass = 0; sizeClass < NumSizeClasses; ++sizeClass) {
+				size_t released = counts[sizeClass];
+				while (heads[sizeClass]) {
+					FreeFrame* frame = heads[sizeClass];
+					heads[sizeClass] = frame->next;
+					::operator delete(frame);
+				}
+				counts[sizeClass] = 0;
+				Counters().numReleased += released;
+				Counters().numCached -= (int64_t)released;
+			}
+		}
+	};
+
+	thread_local ThreadCache threadCache;
+
+} // namespace
+
+
+
+void* FramePool::Allocate(size_t size) {
+	auto& counters = Counters();
+	counters.numAllocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (size > MaxClassSize) {
+		counters.numOversized.fetch_add(1, std::memory_order_relaxed);
+		return ::operator new(size);
+	}
+
+	int sizeClass = SizeClassOf(size);
+	ThreadCache& cache = threadCache;
+	if (FreeFrame* frame = cache.heads[sizeClass]) {
+		cache.heads[sizeClass] = frame->next;
+		--cache.counts[sizeClass];
+		counters.numPoolHits.fetch_add(1, std::memory_order_relaxed);
+		counters.numCached.fetch_sub(1, std::memory_order_relaxed);
+		return frame;
+	}
+	return ::operator new(ClassSize(sizeClass));
+}
+
+
+void FramePool::Deallocate(void* ptr, size_t size) noexcept {
+	if (!ptr) {
+		return;
+	}
+	auto& counters = Counters();
+	counters.numDeallocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (size > MaxClassSize) {
+		::operator delete(ptr);
+		return;
+	}
+
+	int sizeClass = SizeClassOf(size);
+	ThreadCache& cache = threadCache;
+	if (cache.counts[sizeClass] >= MaxCachedPerClass) {
+		counters.numReleased.fetch_add(1, std::memory_order_relaxed);
+		::operator delete(ptr);
+		return;
+	}
+
+	FreeFrame* frame = static_cast<FreeFrame*>(ptr);
+	frame->next = cache.heads[sizeClass];
+	cache.heads[sizeClass] = frame;
+	++cache.counts[sizeClass];
+	counters.numCached.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+void FramePool::ReleaseThreadCache() noexcept {
+	threadCache.Release();
+}
+
+
+FramePoolStatistics FramePool::GetStatistics() {
+	auto& counters = Counters();
+	FramePoolStatistics statistics;
+	statistics.numAllocations = counters.numAllocations;
+	statistics.numPoolHits = counters.numPoolHits;
+	statistics.numOversized = counters.numOversized;
+	statistics.numDeallocations = counters.numDeallocations;
+	statistics.numReleased = counters.numReleased;
+	statistics.numCached = (uint64_t)std::max(int64_t(0), counters.numCached.load());
+	return statistics;
+}
+
+
+void FramePool::ResetStatistics() {
+	auto& counters = Counters();
+	counters.numAllocations = 0;
+	counters.numPoolHits = 0;
+	counters.numOversized = 0;
+	counters.numDeallocations = 0;
+	counters.numReleased = 0;
+}
+
+
+} // namespace inl::jobs
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace inl::jobs {
+
+
+struct FramePoolStatistics {
+	uint64_t numAllocations = 0; ///< Total number of frames allocated through the pool.
+	uint64_t numPoolHits = 0; ///< Allocations served from a thread's cache.
+	uint64_t numOversized = 0; ///< Allocations too large to be pooled, served by the global allocator.
+	uint64_t numDeallocations = 0; ///< Total number of frames given back to the pool.
+	uint64_t numReleased = 0; ///< Frames given back to the global allocator because a cache was full or released.
+	uint64_t numCached = 0; ///< Frames currently sitting in thread caches.
+};
+
+
+/// <summary> Recycles coroutine frames of job system promises. </summary>
+/// <remarks> Each thread keeps a small free-list per power of two size class. A frame is
+///		put into the cache of the thread that frees it, which need not be the one that
+///		allocated it, so frames naturally migrate to the workers that finish jobs. </remarks>
+class FramePool {
+public:
+	static constexpr size_t MinClassSize = 64;
+	static constexpr size_t MaxClassSize = 4096;
+	static constexpr size_t MaxCachedPerClass = 256;
+
+	static void* Allocate(size_t size);
+	static void Deallocate(void* ptr, size_t size) noexcept;
+
+	/// <summary> Returns all frames cached by the calling thread to the global allocator. </summary>
+	static void ReleaseThreadCache() noexcept;
+
+	static FramePoolStatistics GetStatistics();
+	static void ResetStatistics();
+};
+
+
+} // namespace inl::jobs
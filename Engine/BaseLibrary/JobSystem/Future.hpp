@@ -2,6 +2,7 @@
 
 
 #include "Fence.hpp"
+#include "FramePool.hpp"
 
 #include <experimental/coroutine>
 #include <cassert>
@@ -22,6 +23,31 @@ class Scheduler;
 // Shared state
 //------------------------------------------------------------------------------
 
+namespace impl {
+
+	/// <summary> Gets notified once when a future it's attached to becomes ready. </summary>
+	/// <remarks> Lets combinators like <see cref="WhenAll"/> wait for many futures
+	///		without allocating a waiter per future. </remarks>
+	class FutureContinuation {
+	public:
+		virtual void OnReady(size_t index) noexcept = 0;
+	protected:
+		~FutureContinuation() = default;
+	};
+
+	inline FutureContinuation* const completedContinuation = reinterpret_cast<FutureContinuation*>(~size_t(0));
+
+	template <class State>
+	void NotifyContinuation(State& state) {
+		FutureContinuation* continuation = state.continuation.exchange(completedContinuation, std::memory_order_acq_rel);
+		if (continuation) {
+			continuation->OnReady(state.continuationIndex);
+		}
+	}
+
+} // namespace impl
+
+
 template <class T>
 struct SharedState {
 	SharedState() {
@@ -31,6 +57,8 @@ struct SharedState {
 	T value;
 	std::exception_ptr ex;
 	std::atomic_flag coroStarted;
+	std::atomic<impl::FutureContinuation*> continuation = nullptr; // Completed tag once ready.
+	size_t continuationIndex = 0;
 };
 
 template <>
@@ -41,6 +69,8 @@ struct SharedState<void> {
 	Fence fence;
 	std::exception_ptr ex;
 	std::atomic_flag coroStarted;
+	std::atomic<impl::FutureContinuation*> continuation = nullptr; // Completed tag once ready.
+	size_t continuationIndex = 0;
 };
 
 
@@ -93,6 +123,10 @@ public:
 template <class T>
 class CoroPromiseBase : public Promise<T> {
 public:
+	// Coroutine frames are recycled, jobs are launched in great numbers every frame.
+	static void* operator new(size_t size) { return FramePool::Allocate(size); }
+	static void operator delete(void* ptr, size_t size) noexcept { FramePool::Deallocate(ptr, size); }
+
 	auto initial_suspend() { return std::experimental::suspend_always(); }
 	auto final_suspend() { return std::experimental::suspend_never(); }
 	//void unhandled_exception() { this->set_exception(std::current_exception()); }
@@ -154,9 +188,18 @@ public:
 	using promise_type = CoroPromise<T>;
 	auto operator co_await() const;
 
-	void Schedule(Scheduler& scheduler);
+	void Schedule(Scheduler& scheduler, JobOptions options = {});
 	void Run();
 
+	/// <summary> Makes the future call continuation->OnReady(index) once it's ready. </summary>
+	/// <returns> False if the future is already ready, the continuation is not called then. </returns>
+	/// <remarks> Only one continuation can be attached at a time. </remarks>
+	bool AttachContinuation(impl::FutureContinuation* continuation, size_t index) const noexcept;
+
+	/// <summary> Removes the continuation if it has not been called yet. </summary>
+	/// <returns> False if the future became ready meanwhile, so the continuation is or will shortly be called. </returns>
+	bool DetachContinuation(impl::FutureContinuation* continuation) const noexcept;
+
 protected:
 	using handle_type = std::experimental::coroutine_handle<promise_type>;
 	Future(handle_type coroutineHandle, std::shared_ptr<SharedState<T>> sharedState) 
@@ -194,6 +237,7 @@ template <class T>
 void PromiseBase<T>::set_exception(std::exception_ptr ex) {
 	m_sharedState->ex = std::move(ex);
 	m_sharedState->fence.Signal(1);
+	impl::NotifyContinuation(*m_sharedState);
 }
 
 
@@ -201,10 +245,12 @@ template <class T>
 void Promise<T>::set_value(T value) {
 	PromiseBase<T>::m_sharedState->value = std::move(value);
 	PromiseBase<T>::m_sharedState->fence.Signal(1);
+	impl::NotifyContinuation(*PromiseBase<T>::m_sharedState);
 }
 
 inline void Promise<void>::set_value() {
 	m_sharedState->fence.Signal(1);
+	impl::NotifyContinuation(*m_sharedState);
 }
 
 
@@ -226,7 +272,8 @@ inline Future<void> CoroPromise<void>::get_return_object() {
 
 template <class T>
 Future<T>::~Future() {
-	if (valid() && !m_alreadyRun) {
+	// Futures of promises have no coroutine to forget about.
+	if (valid() && m_handle && !m_alreadyRun) {
 		std::terminate();
 	}
 }
@@ -246,12 +293,12 @@ void Future<T>::wait() const {
 	assert(valid());
 
 	// Run if needed.
-	bool hasStarted = m_sharedState->coroStarted.test_and_set();
+	bool hasStarted = !m_handle || m_sharedState->coroStarted.test_and_set();
 	if (!hasStarted) {
 		m_alreadyRun = true;
 		Scheduler* scheduler = m_handle.promise().m_scheduler;
 		if (scheduler != nullptr) {
-			scheduler->Resume(m_handle);
+			scheduler->Resume(m_handle, m_handle.promise().m_options);
 		}
 		else {
 			m_handle.resume();
@@ -286,8 +333,26 @@ auto Future<T>::operator co_await() const {
 
 
 template <class T>
-void Future<T>::Schedule(Scheduler& scheduler) {
+void Future<T>::Schedule(Scheduler& scheduler, JobOptions options) {
 	m_handle.promise().m_scheduler = &scheduler;
+	m_handle.promise().m_options = options;
+}
+
+
+template <class T>
+bool Future<T>::AttachContinuation(impl::FutureContinuation* continuation, size_t index) const noexcept {
+	m_sharedState->continuationIndex = index;
+	impl::FutureContinuation* expected = nullptr;
+	bool attached = m_sharedState->continuation.compare_exchange_strong(expected, continuation, std::memory_order_acq_rel);
+	assert(attached || expected == impl::completedContinuation); // Another continuation is already attached.
+	return attached;
+}
+
+
+template <class T>
+bool Future<T>::DetachContinuation(impl::FutureContinuation* continuation) const noexcept {
+	impl::FutureContinuation* expected = continuation;
+	return m_sharedState->continuation.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
 }
 
 
@@ -326,12 +391,12 @@ namespace inl::jobs {
 template <class T>
 template <class HandleT>
 bool Awaiter<T>::await_suspend(HandleT awaitingCoroutine) noexcept {
-	bool hasStarted = m_future->m_sharedState->coroStarted.test_and_set();
+	bool hasStarted = !m_future->m_handle || m_future->m_sharedState->coroStarted.test_and_set();
 	if (!hasStarted) {
 		Scheduler* scheduler = m_future->m_handle.promise().m_scheduler;
 		m_future->m_alreadyRun = true;
 		if (scheduler != nullptr) {
-			scheduler->Resume(m_future->m_handle);
+			scheduler->Resume(m_future->m_handle, m_future->m_handle.promise().m_options);
 		}
 		else {
 			m_future->m_handle.resume();
@@ -343,12 +408,12 @@ bool Awaiter<T>::await_suspend(HandleT awaitingCoroutine) noexcept {
 
 template <class T>
 void Future<T>::Run() {
-	bool hasStarted = m_sharedState->coroStarted.test_and_set();
+	bool hasStarted = !m_handle || m_sharedState->coroStarted.test_and_set();
 	if (!hasStarted) {
 		m_alreadyRun = true;
 		Scheduler* scheduler = m_handle.promise().m_scheduler;
 		if (scheduler != nullptr) {
-			scheduler->Resume(m_handle);
+			scheduler->Resume(m_handle, m_handle.promise().m_options);
 		}
 		else {
 			m_handle.resume();
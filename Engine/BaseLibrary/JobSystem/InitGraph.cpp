@@ -0,0 +1,273 @@
+#include "InitGraph.hpp"
+
+#include "Scheduler.hpp"
+#include "../Exception/Exception.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <utility>
+
+
+namespace inl::jobs {
+
+
+InitGraph::~InitGraph() {
+	if (m_scheduler && !m_waited) {
+		try {
+			Wait();
+		}
+		catch (...) {
+			// Nobody to report it to.
+		}
+	}
+}
+
+
+InitGraph::TaskId InitGraph::Add(const char* name, std::function<void()> task, std::initializer_list<TaskId> dependencies) {
+	return AddTask(name, std::move(task), false, dependencies);
+}
+
+
+InitGraph::TaskId InitGraph::AddOnCaller(const char* name, std::function<void()> task, std::initializer_list<TaskId> dependencies) {
+	return AddTask(name, std::move(task), true, dependencies);
+}
+
+
+InitGraph::TaskId InitGraph::AddTask(const char* name, std::function<void()> task, bool onCaller, std::initializer_list<TaskId> dependencies) {
+	if (m_scheduler) {
+		throw InvalidCallException("Tasks cannot be added once the graph has started.");
+	}
+	const TaskId id = m_tasks.size();
+	for (TaskId dependency : dependencies) {
+		if (dependency >= id) {
+			throw InvalidArgumentException("Dependencies must be added before the tasks depending on them.");
+		}
+	}
+
+	Task& added = m_tasks.emplace_back();
+	added.name = name;
+	added.func = std::move(task);
+	added.onCaller = onCaller;
+	added.dependencies = dependencies;
+	added.numPending = dependencies.size();
+	added.zone.name = name;
+	for (TaskId dependency : dependencies) {
+		m_tasks[dependency].dependents.push_back(id);
+	}
+	return id;
+}
+
+
+void InitGraph::Start(Scheduler& scheduler) {
+	if (m_scheduler) {
+		throw InvalidCallException("The graph has already started.");
+	}
+	m_scheduler = &scheduler;
+	m_begin = FrameProfiler::GetGlobal().Now();
+
+	std::vector<TaskId> ready;
+	for (TaskId id = 0; id < m_tasks.size(); ++id) {
+		if (m_tasks[id].numPending == 0) {
+			ready.push_back(id);
+		}
+	}
+	Dispatch(ready);
+}
+
+
+void InitGraph::Wait() {
+	if (!m_scheduler) {
+		throw InvalidCallException("The graph has not started.");
+	}
+
+	std::unique_lock lk(m_mtx);
+	while (m_numDone < m_tasks.size()) {
+		if (!m_readyOnCaller.empty()) {
+			const TaskId id = m_readyOnCaller.front();
+			m_readyOnCaller.erase(m_readyOnCaller.begin());
+			lk.unlock();
+			Run(id);
+			lk.lock();
+		}
+		else {
+			m_cv.wait(lk);
+		}
+	}
+	lk.unlock();
+
+	WaitJobs();
+	m_waited = true;
+	if (m_exception) {
+		std::rethrow_exception(std::exchange(m_exception, nullptr));
+	}
+}
+
+
+ProfiledFrame InitGraph::GetTimeline() const {
+	ProfiledFrame timeline;
+	timeline.begin = m_begin;
+	timeline.end = m_begin;
+	for (const Task& task : m_tasks) {
+		if (!task.skipped) {
+			timeline.zones.push_back(task.zone);
+			timeline.end = std::max(timeline.end, task.zone.end);
+		}
+	}
+	std::sort(timeline.zones.begin(), timeline.zones.end(), [](const ProfileZone& lhs, const ProfileZone& rhs) {
+		return lhs.begin < rhs.begin;
+	});
+	return timeline;
+}
+
+
+void InitGraph::WriteReport(std::ostream& output) const {
+	const ProfiledFrame timeline = GetTimeline();
+	const std::vector<std::string> threadNames = FrameProfiler::GetGlobal().GetThreadNames();
+	const auto milliseconds = [](double seconds) { return seconds * 1000.0; };
+
+	const auto flags = output.flags();
+	const auto precision = output.precision();
+	output << std::fixed << std::setprecision(1);
+
+	output << "Initialization took " << milliseconds(timeline.end - timeline.begin) << " ms:" << std::endl;
+	for (const ProfileZone& zone : timeline.zones) {
+		output << "  +" << std::setw(7) << milliseconds(zone.begin - timeline.begin) << " ms "
+			   << std::setw(7) << milliseconds(zone.end - zone.begin) << " ms  " << zone.name;
+		if (zone.thread < threadNames.size()) {
+			output << " [" << threadNames[zone.thread] << "]";
+		}
+		output << std::endl;
+	}
+	for (const Task& task : m_tasks) {
+		if (task.skipped) {
+			output << "  skipped: " << task.name << std::endl;
+		}
+	}
+
+	// The chain that ended last, following the dependency that was waited on the longest.
+	std::vector<const Task*> criticalPath;
+	const Task* current = nullptr;
+	for (const Task& task : m_tasks) {
+		if (!task.skipped && (!current || task.zone.end > current->zone.end)) {
+			current = &task;
+		}
+	}
+	while (current) {
+		criticalPath.push_back(current);
+		const Task* latest = nullptr;
+		for (TaskId dependency : current->dependencies) {
+			const Task& task = m_tasks[dependency];
+			if (!latest || task.zone.end > latest->zone.end) {
+				latest = &task;
+			}
+		}
+		current = latest;
+	}
+	if (!criticalPath.empty()) {
+		output << "Critical path:";
+		for (auto it = criticalPath.rbegin(); it != criticalPath.rend(); ++it) {
+			output << (it == criticalPath.rbegin() ? " " : " -> ") << (*it)->name;
+		}
+		output << std::endl;
+	}
+
+	output.flags(flags);
+	output.precision(precision);
+}
+
+
+void InitGraph::Dispatch(const std::vector<TaskId>& ready) {
+	for (TaskId id : ready) {
+		if (m_tasks[id].onCaller) {
+			std::lock_guard lk(m_mtx);
+			m_readyOnCaller.push_back(id);
+			m_cv.notify_all();
+		}
+		else {
+			// Enqueued without holding the lock, the job may run inline and finish right away.
+			auto job = m_scheduler->Enqueue(JobOptions{ eJobPriority::BACKGROUND }, [this, id] {
+				Run(id);
+			});
+			std::lock_guard lk(m_mtx);
+			m_jobs.push_back(std::move(job));
+		}
+	}
+}
+
+
+void InitGraph::Run(TaskId id) {
+	FrameProfiler& profiler = FrameProfiler::GetGlobal();
+	Task& task = m_tasks[id];
+	task.zone.thread = profiler.GetCurrentThread();
+	task.zone.begin = profiler.Now();
+
+	std::exception_ptr exception;
+	try {
+		task.func();
+	}
+	catch (...) {
+		exception = std::current_exception();
+	}
+	task.func = nullptr; // Releases whatever the task has captured.
+	task.zone.end = profiler.Now();
+
+	Dispatch(Finish(id, std::move(exception)));
+}
+
+
+std::vector<InitGraph::TaskId> InitGraph::Finish(TaskId id, std::exception_ptr exception) {
+	std::vector<TaskId> ready;
+	std::lock_guard lk(m_mtx);
+
+	// Skipped tasks finish at once, along with whatever depends on them.
+	std::vector<std::pair<TaskId, bool>> finished = { { id, bool(exception) } };
+	if (exception && !m_exception) {
+		m_exception = std::move(exception);
+	}
+	while (!finished.empty()) {
+		const auto [current, failed] = finished.back();
+		finished.pop_back();
+		++m_numDone;
+		for (TaskId dependentId : m_tasks[current].dependents) {
+			Task& dependent = m_tasks[dependentId];
+			dependent.skipped = dependent.skipped || failed;
+			if (--dependent.numPending == 0) {
+				if (dependent.skipped) {
+					finished.push_back({ dependentId, true });
+				}
+				else {
+					ready.push_back(dependentId);
+				}
+			}
+		}
+	}
+
+	if (m_numDone == m_tasks.size()) {
+		m_cv.notify_all();
+	}
+	return ready;
+}
+
+
+void InitGraph::WaitJobs() {
+	// A job's future is pushed by the thread that enqueued it, which is either the caller
+	// or another job of the graph, so once the list stays empty every job has been waited for.
+	std::vector<Future<void>> jobs;
+	while (true) {
+		{
+			std::lock_guard lk(m_mtx);
+			jobs.swap(m_jobs);
+		}
+		if (jobs.empty()) {
+			break;
+		}
+		for (auto& job : jobs) {
+			job.wait();
+		}
+		jobs.clear();
+	}
+}
+
+
+} // namespace inl::jobs
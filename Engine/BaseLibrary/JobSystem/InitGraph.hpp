@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Future.hpp"
+#include "../FrameProfiler.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <iosfwd>
+#include <mutex>
+#include <vector>
+
+
+namespace inl::jobs {
+
+
+class Scheduler;
+
+
+/// <summary>
+/// Runs initialization tasks as soon as the tasks they depend on are done,
+/// and records when each of them ran.
+/// </summary>
+/// <remarks>
+/// <para> Tasks go to the background lane of the job scheduler, except those added by
+///		<see cref="AddOnCaller"/>, which run on the thread that calls <see cref="Wait"/>. </para>
+/// <para> If a task throws, the tasks depending on it are skipped, and <see cref="Wait"/> rethrows
+///		the first exception once all other tasks are done. </para>
+/// <para> The graph is not thread safe: add the tasks, start, then wait from the same thread.
+///		Destroying a started graph waits for it. </para>
+/// </remarks>
+class InitGraph {
+public:
+	using TaskId = size_t;
+
+	InitGraph() = default;
+	InitGraph(const InitGraph&) = delete;
+	InitGraph& operator=(const InitGraph&) = delete;
+	~InitGraph();
+
+	/// <summary> Adds a task that runs on a job worker. </summary>
+	/// <param name="name"> Name in the timeline, must outlive the graph like profiler zone names. </param>
+	/// <param name="dependencies"> Tasks added earlier that must finish first. </param>
+	TaskId Add(const char* name, std::function<void()> task, std::initializer_list<TaskId> dependencies = {});
+
+	/// <summary> Adds a task that runs on the thread calling <see cref="Wait"/>, for work that is not thread safe. </summary>
+	TaskId AddOnCaller(const char* name, std::function<void()> task, std::initializer_list<TaskId> dependencies = {});
+
+	/// <summary> Starts the tasks that have no dependencies. </summary>
+	void Start(Scheduler& scheduler);
+
+	/// <summary> Runs the caller's tasks, and returns when all tasks are done. </summary>
+	/// <exception> The first exception a task has thrown. </exception>
+	void Wait();
+
+	/// <summary> The tasks as zones of a single frame, from the start of the graph to the end of the last task. </summary>
+	/// <remarks> Thread indices are those of <see cref="FrameProfiler::GetGlobal"/>,
+	///		so that the timeline can be exported by <see cref="FrameProfiler::ExportChromeTrace"/>. </remarks>
+	ProfiledFrame GetTimeline() const;
+
+	/// <summary> Writes the timeline as text, a line per task, and the longest chain of dependencies. </summary>
+	void WriteReport(std::ostream& output) const;
+private:
+	struct Task {
+		const char* name;
+		std::function<void()> func;
+		bool onCaller;
+		std::vector<TaskId> dependencies;
+		std::vector<TaskId> dependents;
+		size_t numPending = 0; // Dependencies not done yet.
+		bool skipped = false; // A dependency failed.
+		ProfileZone zone = {};
+	};
+
+	TaskId AddTask(const char* name, std::function<void()> task, bool onCaller, std::initializer_list<TaskId> dependencies);
+	void Dispatch(const std::vector<TaskId>& ready);
+	void Run(TaskId id);
+	std::vector<TaskId> Finish(TaskId id, std::exception_ptr exception);
+	void WaitJobs();
+
+private:
+	std::vector<Task> m_tasks;
+	Scheduler* m_scheduler = nullptr;
+	bool m_waited = false;
+	double m_begin = 0.0;
+
+	std::mutex m_mtx;
+	std::condition_variable m_cv;
+	std::vector<TaskId> m_readyOnCaller;
+	std::vector<Future<void>> m_jobs;
+	size_t m_numDone = 0;
+	std::exception_ptr m_exception;
+};
+
+
+} // namespace inl::jobs
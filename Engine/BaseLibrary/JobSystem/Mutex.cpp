@@ -2,12 +2,38 @@
 #include <cassert>
 #include <iostream>
 #include "Scheduler.hpp"
+#include "Tracer.hpp"
 #include <wrl/wrappers/corewrappers.h>
 
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 
 namespace inl::jobs {
 
 
+//------------------------------------------------------------------------------
+// Spinning
+//------------------------------------------------------------------------------
+
+static constexpr uint32_t InitialSpinLimit = 256;
+static constexpr uint32_t MinSpinLimit = 16;
+static constexpr uint32_t MaxSpinLimit = 4096;
+static constexpr uint32_t MaxBackoff = 64;
+
+static inline void SpinPause() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_pause();
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_ia32_pause();
+#endif
+}
+
+
+
 //------------------------------------------------------------------------------
 // MutexAwaiter
 //------------------------------------------------------------------------------
@@ -16,6 +42,7 @@ Mutex::MutexAwaiter::MutexAwaiter(MutexAwaiter&& rhs) noexcept
 	: m_awaitingHandle(std::move(rhs.m_awaitingHandle)),
 	m_next(rhs.m_next),
 	m_scheduler(rhs.m_scheduler),
+	m_options(rhs.m_options),
 	m_mtx(rhs.m_mtx),
 	m_wasAwaited(rhs.m_wasAwaited)
 {
@@ -37,11 +64,23 @@ bool Mutex::MutexAwaiter::await_ready() const noexcept {
 	}
 	m_wasAwaited = true;
 
+	return TryAcquire(true);
+}
+
+
+bool Mutex::MutexAwaiter::TryAcquire(bool allowSpinning) const noexcept {
+	MutexAwaiter* self = const_cast<MutexAwaiter*>(this);
+	m_mtx.m_numLocks.fetch_add(1, std::memory_order_relaxed);
+
 	// Null in awaiter list means the mutex is free, so try to lock it.
 	MutexAwaiter* expected = nullptr;
-	bool success = m_mtx.m_firstAwaiter.compare_exchange_strong(expected, const_cast<MutexAwaiter*>(this));
+	bool success = m_mtx.m_firstAwaiter.compare_exchange_strong(expected, self);
+	if (!success) {
+		m_mtx.m_numContended.fetch_add(1, std::memory_order_relaxed);
+		success = allowSpinning && m_mtx.m_mode == eMutexMode::ADAPTIVE && m_mtx.SpinLock(self);
+	}
 	if (success) {
-		m_mtx.m_holder = const_cast<MutexAwaiter*>(this);
+		m_mtx.m_holder = self;
 	}
 	return success;
 }
@@ -51,10 +90,12 @@ Mutex::MutexAwaiter::MutexAwaiter(Mutex& mtx)
 	: m_mtx(mtx)
 {}
 
-bool Mutex::MutexAwaiter::await_suspend(std::experimental::coroutine_handle<> awaitingCoroutine, Scheduler* scheduler) noexcept {
+bool Mutex::MutexAwaiter::await_suspend(std::experimental::coroutine_handle<> awaitingCoroutine, Scheduler* scheduler, JobOptions options) noexcept {
 	// Coroutine is suspended.
 	m_awaitingHandle = awaitingCoroutine;
 	m_scheduler = scheduler;
+	m_options = options;
+	Mutex& mtx = m_mtx; // *this may be resumed and destroyed on another thread once it's in the list.
 
 	// Add this to the waiting list.
 	bool success;
@@ -74,6 +115,8 @@ bool Mutex::MutexAwaiter::await_suspend(std::experimental::coroutine_handle<> aw
 		return false;
 	}
 
+	mtx.m_numSuspended.fetch_add(1, std::memory_order_relaxed);
+	Tracer::Record(eTraceEvent::SUSPEND_MUTEX, awaitingCoroutine.address());
 	return true;
 }
 
@@ -83,9 +126,13 @@ bool Mutex::MutexAwaiter::await_suspend(std::experimental::coroutine_handle<> aw
 // Mutex
 //------------------------------------------------------------------------------
 
-Mutex::Mutex() noexcept {
+Mutex::Mutex(eMutexMode mode) noexcept
+	: m_mode(mode)
+{
 	m_firstAwaiter = nullptr;
 	m_holder = nullptr;
+	m_spinLimit = InitialSpinLimit;
+	ResetStatistics();
 }
 
 
@@ -106,16 +153,66 @@ void Mutex::LockExplicit() {
 
 
 bool Mutex::TryLock() {
+	m_numLocks.fetch_add(1, std::memory_order_relaxed);
+
 	// Null in awaiter list means the mutex is free, so try to lock it.
 	MutexAwaiter* expected = nullptr;
 	bool success = m_firstAwaiter.compare_exchange_strong(expected, tryLockTag);
 	if (success) {
 		m_holder = tryLockTag;
 	}
+	else {
+		m_numContended.fetch_add(1, std::memory_order_relaxed);
+	}
 	return success;
 }
 
 
+MutexStatistics Mutex::GetStatistics() const {
+	MutexStatistics statistics;
+	statistics.numLocks = m_numLocks.load(std::memory_order_relaxed);
+	statistics.numContended = m_numContended.load(std::memory_order_relaxed);
+	statistics.numSpinAcquired = m_numSpinAcquired.load(std::memory_order_relaxed);
+	statistics.numSuspended = m_numSuspended.load(std::memory_order_relaxed);
+	return statistics;
+}
+
+
+void Mutex::ResetStatistics() {
+	m_numLocks = 0;
+	m_numContended = 0;
+	m_numSpinAcquired = 0;
+	m_numSuspended = 0;
+}
+
+
+bool Mutex::SpinLock(MutexAwaiter* awaiter) {
+	const uint32_t limit = m_spinLimit.load(std::memory_order_relaxed);
+
+	// The list is only null when nobody holds the mutex. When coroutines are already parked,
+	// Unlock hands the mutex straight to them and it never becomes null, so we don't barge in.
+	uint32_t backoff = 1;
+	for (uint32_t spins = 0; spins < limit; spins += backoff, backoff = std::min(2 * backoff, MaxBackoff)) {
+		for (uint32_t i = 0; i < backoff; ++i) {
+			SpinPause();
+		}
+		MutexAwaiter* expected = nullptr;
+		if (m_firstAwaiter.load(std::memory_order_relaxed) == nullptr && m_firstAwaiter.compare_exchange_weak(expected, awaiter)) {
+			m_numSpinAcquired.fetch_add(1, std::memory_order_relaxed);
+			// Move the budget towards twice what was needed this time.
+			int64_t target = std::max(int64_t(2) * spins, int64_t(MinSpinLimit));
+			int64_t newLimit = int64_t(limit) + (target - int64_t(limit)) / 8;
+			m_spinLimit.store(uint32_t(std::clamp(newLimit, int64_t(MinSpinLimit), int64_t(MaxSpinLimit))), std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	// Spinning did not pay off, spin less next time.
+	m_spinLimit.store(std::max(MinSpinLimit, limit / 2), std::memory_order_relaxed);
+	return false;
+}
+
+
 void Mutex::Unlock() {
 	// Peek into the list.
 	MutexAwaiter* list = m_firstAwaiter;
@@ -133,7 +230,7 @@ void Mutex::Unlock() {
 		m_holder = prev;
 		prev->m_next = nullptr;
 		if (prev->m_scheduler) {
-			prev->m_scheduler->Resume(prev->m_awaitingHandle);
+			prev->m_scheduler->Resume(prev->m_awaitingHandle, prev->m_options);
 		}
 		else {
 			prev->m_awaitingHandle.resume();
@@ -157,7 +254,7 @@ void Mutex::Unlock() {
 			// Awake that prev.
 			m_holder = prev;
 			if (prev->m_scheduler) {
-				prev->m_scheduler->Resume(prev->m_awaitingHandle);
+				prev->m_scheduler->Resume(prev->m_awaitingHandle, prev->m_options);
 			}
 			else {
 				prev->m_awaitingHandle.resume();
@@ -2,12 +2,31 @@
 
 #include "SchedulablePromiseTag.hpp"
 #include <atomic>
+#include <cstdint>
 #include <experimental/coroutine>
 
 
 namespace inl::jobs {
 
 
+enum class eMutexMode {
+	/// <summary> Suspends the coroutine right away if the mutex is taken. </summary>
+	PARK,
+	/// <summary> Spins for a while with backoff before suspending. The spin budget adapts
+	///		to how long spinning took to succeed recently. Meant for very short critical sections. </summary>
+	ADAPTIVE,
+};
+
+
+/// <summary> Contention counters of a <see cref="Mutex"/>. </summary>
+struct MutexStatistics {
+	uint64_t numLocks = 0; /// <summary> Lock attempts, including TryLock. </summary>
+	uint64_t numContended = 0; /// <summary> Attempts that found the mutex taken. </summary>
+	uint64_t numSpinAcquired = 0; /// <summary> Contended attempts that got the mutex by spinning. </summary>
+	uint64_t numSuspended = 0; /// <summary> Contended attempts that suspended the coroutine. </summary>
+};
+
+
 class Mutex {
 public:
 	class MutexAwaiter {
@@ -26,16 +45,18 @@ public:
 		void await_resume() noexcept {}
 	private:
 		MutexAwaiter(Mutex& mtx);
-		bool await_suspend(std::experimental::coroutine_handle<> awaitingCoroutine, Scheduler* scheduler = nullptr) noexcept;
+		bool TryAcquire(bool allowSpinning) const noexcept;
+		bool await_suspend(std::experimental::coroutine_handle<> awaitingCoroutine, Scheduler* scheduler = nullptr, JobOptions options = {}) noexcept;
 	private:
 		std::experimental::coroutine_handle<> m_awaitingHandle;
 		MutexAwaiter* m_next = nullptr;
 		Scheduler* m_scheduler = nullptr;
+		JobOptions m_options;
 		Mutex& m_mtx;
 		mutable bool m_wasAwaited = false;
 	};
 public:
-	Mutex() noexcept;
+	Mutex(eMutexMode mode = eMutexMode::PARK) noexcept;
 	Mutex(const Mutex&) = delete;
 	Mutex(Mutex&&) noexcept = default;
 	Mutex& operator=(const Mutex&) = delete;
@@ -46,10 +67,23 @@ public:
 	void LockExplicit();
 	bool TryLock();
 	void Unlock();
+
+	eMutexMode GetMode() const { return m_mode; }
+	MutexStatistics GetStatistics() const;
+	void ResetStatistics();
+private:
+	bool SpinLock(MutexAwaiter* awaiter);
 private:
 	std::atomic<MutexAwaiter*> m_firstAwaiter; // Nullptr if free, otherwise last in the list owns mutex. Lst is a dangling pointer.
 	volatile MutexAwaiter* m_holder; // If same as the last in the list above. Used to figure out where the list ends, because last pointer in list in always dangling.
 	inline static MutexAwaiter* tryLockTag = reinterpret_cast<MutexAwaiter*>(~size_t(0));
+
+	eMutexMode m_mode;
+	std::atomic_uint32_t m_spinLimit;
+	std::atomic_uint64_t m_numLocks;
+	std::atomic_uint64_t m_numContended;
+	std::atomic_uint64_t m_numSpinAcquired;
+	std::atomic_uint64_t m_numSuspended;
 };
 
 
@@ -83,10 +117,12 @@ private:
 template <class T>
 bool Mutex::MutexAwaiter::await_suspend(T awaitingCoroutine) noexcept {
 	Scheduler* scheduler = nullptr;
+	JobOptions options;
 	if constexpr (std::is_base_of_v<SchedulablePromiseTag, std::decay_t<decltype(awaitingCoroutine.promise())>>) {
 		scheduler = static_cast<const SchedulablePromiseTag&>(awaitingCoroutine.promise()).m_scheduler;
+		options = static_cast<const SchedulablePromiseTag&>(awaitingCoroutine.promise()).m_options;
 	}
-	return await_suspend(std::experimental::coroutine_handle<>(awaitingCoroutine), scheduler);
+	return await_suspend(std::experimental::coroutine_handle<>(awaitingCoroutine), scheduler, options);
 }
 
 
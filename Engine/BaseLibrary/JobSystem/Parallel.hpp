@@ -0,0 +1,230 @@
+#pragma once
+
+#include "Future.hpp"
+#include "Fence.hpp"
+#include "Scheduler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace inl::jobs {
+
+
+namespace impl {
+
+	/// <summary> Splits [0, count) into chunks of at least grainSize items. </summary>
+	/// <remarks> A grain size of zero picks one so that every worker gets a few chunks,
+	///		which leaves some room for balancing uneven work. </remarks>
+	inline size_t ChunkSize(size_t count, size_t grainSize) {
+		if (grainSize == 0) {
+			size_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+			grainSize = count / (4 * numThreads);
+		}
+		return std::max(size_t(1), grainSize);
+	}
+
+	inline size_t ChunkCount(size_t count, size_t chunkSize) {
+		return (count + chunkSize - 1) / chunkSize;
+	}
+
+
+	/// <summary> Completion tracking shared by the chunks of one parallel call. </summary>
+	struct ParallelJoin {
+		Fence fence{ 0 };
+		std::atomic_uint64_t numFinished = 0;
+		std::exception_ptr ex;
+		SpinMutex exMtx;
+
+		void ChunkFailed(std::exception_ptr chunkEx) {
+			std::lock_guard<SpinMutex> lkg(exMtx);
+			if (!ex) {
+				ex = std::move(chunkEx);
+			}
+		}
+		void ChunkFinished() {
+			// Fence ignores values lower than the current, so out of order signals are fine.
+			fence.Signal(numFinished.fetch_add(1) + 1);
+		}
+		void RethrowIfFailed() {
+			if (ex) {
+				std::rethrow_exception(ex);
+			}
+		}
+	};
+
+
+	/// <summary> Runs chunkFunc(chunkIndex, first, last) for each chunk of [0, count)
+	///		as separate jobs and resumes once all of them finished. </summary>
+	template <class ChunkFunc>
+	Future<void> ForEachChunk(Scheduler& scheduler, size_t count, size_t chunkSize, ChunkFunc chunkFunc) {
+		struct State : ParallelJoin {
+			State(ChunkFunc chunkFunc) : chunkFunc(std::move(chunkFunc)) {}
+			ChunkFunc chunkFunc;
+		};
+
+		size_t numChunks = ChunkCount(count, chunkSize);
+		if (numChunks == 0) {
+			co_return;
+		}
+
+		auto state = std::make_shared<State>(std::move(chunkFunc));
+		auto runChunk = [](std::shared_ptr<State> state, size_t chunkIndex, size_t first, size_t last) {
+			try {
+				state->chunkFunc(chunkIndex, first, last);
+			}
+			catch (...) {
+				state->ChunkFailed(std::current_exception());
+			}
+			state->ChunkFinished();
+		};
+
+		// The futures are not needed, the fence tracks completion.
+		for (size_t chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex) {
+			size_t first = chunkIndex * chunkSize;
+			size_t last = std::min(count, first + chunkSize);
+			scheduler.Enqueue(runChunk, state, chunkIndex, first, last);
+		}
+
+		co_await state->fence.Wait(numChunks);
+		state->RethrowIfFailed();
+	}
+
+} // namespace impl
+
+
+
+/// <summary> Calls func(index) for every index in [first, last). </summary>
+/// <param name="grainSize"> Minimum number of indices processed by a single job, 0 to choose automatically. </param>
+/// <remarks> Func is called concurrently from many threads.
+///		If any call throws, the first exception is rethrown once all chunks finished. </remarks>
+template <class IndexT, class Func>
+Future<void> ParallelFor(Scheduler& scheduler, IndexT first, IndexT last, size_t grainSize, Func func) {
+	static_assert(std::is_integral_v<IndexT>, "Indices must be integers.");
+	size_t count = last > first ? size_t(last - first) : 0;
+	size_t chunkSize = impl::ChunkSize(count, grainSize);
+
+	auto chunkFunc = [first, func = std::move(func)](size_t, size_t chunkFirst, size_t chunkLast) {
+		for (size_t i = chunkFirst; i < chunkLast; ++i) {
+			func(IndexT(first + i));
+		}
+	};
+	co_await impl::ForEachChunk(scheduler, count, chunkSize, std::move(chunkFunc));
+}
+
+
+/// <summary> Computes reduce(...reduce(reduce(identity, map(first)), map(first+1))..., map(last-1)). </summary>
+/// <param name="grainSize"> Minimum number of indices processed by a single job, 0 to choose automatically. </param>
+/// <remarks> Reduce must be associative. Chunks are combined in index order,
+///		so the result is deterministic even for floating point values. </remarks>
+template <class IndexT, class T, class MapFunc, class ReduceFunc>
+Future<T> ParallelReduce(Scheduler& scheduler, IndexT first, IndexT last, size_t grainSize, T identity, MapFunc map, ReduceFunc reduce) {
+	static_assert(std::is_integral_v<IndexT>, "Indices must be integers.");
+	size_t count = last > first ? size_t(last - first) : 0;
+	size_t chunkSize = impl::ChunkSize(count, grainSize);
+	size_t numChunks = impl::ChunkCount(count, chunkSize);
+
+	auto partials = std::make_shared<std::vector<T>>(numChunks, identity);
+	auto chunkFunc = [first, partials, identity, map = std::move(map), reduce](size_t chunkIndex, size_t chunkFirst, size_t chunkLast) {
+		T accumulator = identity;
+		for (size_t i = chunkFirst; i < chunkLast; ++i) {
+			accumulator = reduce(std::move(accumulator), map(IndexT(first + i)));
+		}
+		(*partials)[chunkIndex] = std::move(accumulator);
+	};
+	co_await impl::ForEachChunk(scheduler, count, chunkSize, std::move(chunkFunc));
+
+	T result = std::move(identity);
+	for (auto& partial : *partials) {
+		result = reduce(std::move(result), std::move(partial));
+	}
+	co_return result;
+}
+
+
+/// <summary> Sorts [first, last) using multiple jobs. </summary>
+/// <param name="grainSize"> Minimum number of elements sorted by a single job, 0 to choose automatically. </param>
+/// <remarks> Chunks are sorted in parallel, then merged pairwise in parallel rounds.
+///		The sort is not stable. </remarks>
+template <class RandomIt, class Compare = std::less<>>
+Future<void> ParallelSort(Scheduler& scheduler, RandomIt first, RandomIt last, size_t grainSize = 0, Compare comp = {}) {
+	size_t count = (size_t)std::distance(first, last);
+	size_t chunkSize = impl::ChunkSize(count, grainSize);
+
+	co_await impl::ForEachChunk(scheduler, count, chunkSize, [first, comp](size_t, size_t chunkFirst, size_t chunkLast) {
+		std::sort(first + chunkFirst, first + chunkLast, comp);
+	});
+
+	// Each round merges pairs of neighbouring sorted runs, doubling the run length.
+	for (size_t runSize = chunkSize; runSize < count; runSize *= 2) {
+		co_await impl::ForEachChunk(scheduler, count, 2 * runSize, [first, comp, runSize](size_t, size_t pairFirst, size_t pairLast) {
+			size_t middle = std::min(pairFirst + runSize, pairLast);
+			std::inplace_merge(first + pairFirst, first + middle, first + pairLast, comp);
+		});
+	}
+}
+
+
+/// <summary> Calls func(first, last) for consecutive chunks of [0, count) and returns once all of them finished. </summary>
+/// <param name="scheduler"> Helper jobs are enqueued here, null runs every chunk on the calling thread. </param>
+/// <remarks> Unlike the other algorithms, this blocks instead of returning a future.
+///		The calling thread works on chunks too and only waits for chunks already running elsewhere,
+///		so it never waits for helper jobs still queued behind it, and can be used from inside jobs.
+///		If any call throws, the first exception is rethrown once all chunks finished. </remarks>
+template <class Func>
+void CooperativeFor(Scheduler* scheduler, size_t count, size_t chunkSize, const Func& func) {
+	chunkSize = std::max(size_t(1), chunkSize);
+	size_t numChunks = impl::ChunkCount(count, chunkSize);
+	if (numChunks == 0) {
+		return;
+	}
+
+	struct State {
+		std::atomic_size_t nextChunk = 0;
+		std::atomic_size_t numFinished = 0;
+		std::exception_ptr ex;
+		SpinMutex exMtx;
+	};
+	auto state = std::make_shared<State>();
+
+	// Helpers that start late find no chunks left and never touch func.
+	auto work = [state, numChunks, count, chunkSize, &func] {
+		size_t chunk;
+		while ((chunk = state->nextChunk.fetch_add(1)) < numChunks) {
+			try {
+				func(chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize));
+			}
+			catch (...) {
+				std::lock_guard<SpinMutex> lkg(state->exMtx);
+				if (!state->ex) {
+					state->ex = std::current_exception();
+				}
+			}
+			state->numFinished.fetch_add(1, std::memory_order_release);
+		}
+	};
+
+	if (scheduler) {
+		size_t numHelpers = std::min(numChunks, size_t(std::max(1u, std::thread::hardware_concurrency()))) - 1;
+		for (size_t i = 0; i < numHelpers; ++i) {
+			scheduler->Enqueue(work);
+		}
+	}
+	work();
+	while (state->numFinished.load(std::memory_order_acquire) < numChunks) {
+		std::this_thread::yield();
+	}
+	if (state->ex) {
+		std::rethrow_exception(state->ex);
+	}
+}
+
+
+} // namespace inl::jobs
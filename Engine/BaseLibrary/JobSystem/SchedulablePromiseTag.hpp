@@ -1,13 +1,38 @@
 #pragma once
 
+#include <cstdint>
+
 namespace inl::jobs {
 
 
 class Scheduler;
 
+
+/// <summary> Lanes of the scheduler, higher priority lanes are always emptied first. </summary>
+enum class eJobPriority {
+	/// <summary> Latency sensitive work that others wait on, such as GPU submission. </summary>
+	CRITICAL = 0,
+	/// <summary> Regular per-frame work. </summary>
+	FRAME = 1,
+	/// <summary> Work that may take several frames, such as asset loading. </summary>
+	BACKGROUND = 2,
+};
+
+constexpr int NumJobPriorities = 3;
+
+
+struct JobOptions {
+	eJobPriority priority = eJobPriority::FRAME;
+	/// <summary> Bit N set means the job may run on worker N. Zero means any worker. </summary>
+	/// <remarks> Only a hint: schedulers without distinct workers ignore it. </remarks>
+	uint64_t affinityMask = 0;
+};
+
+
 struct SchedulablePromiseTag {
 	Scheduler* m_scheduler = nullptr;
+	JobOptions m_options;
 };
 
 
-}
\ No newline at end of file
+}
@@ -30,15 +30,24 @@ public:
 	virtual ~Scheduler() = default;
 
 
-	template <class Func, class... Args>
+	template <class Func, class... Args, class = std::enable_if_t<!std::is_same_v<std::decay_t<Func>, JobOptions>>>
 	auto Enqueue(Func func, Args... args) {
+		return Enqueue(JobOptions{}, std::move(func), std::forward<Args>(args)...);
+	}
+
+	/// <summary> Enqueues the job in the lane given by <paramref name="options"/>. </summary>
+	/// <remarks> The options stick to the coroutine: every time it is resumed after
+	///		a suspension it goes back to the same lane. </remarks>
+	template <class Func, class... Args>
+	auto Enqueue(const JobOptions& options, Func func, Args... args) {
 		static_assert(std::is_invocable<Func, Args...>::value, "Object must be callable with given arguments.");
-		auto task = MakeTask(std::move(func), this, std::forward<Args>(args)...);
+		auto task = MakeTask(std::move(func), this, options, std::forward<Args>(args)...);
 		task.Run();
 		return task;
 	}
-	
-	virtual void Resume(std::experimental::coroutine_handle<> coroutine) = 0;
+
+	void Resume(std::experimental::coroutine_handle<> coroutine) { Resume(coroutine, JobOptions{}); }
+	virtual void Resume(std::experimental::coroutine_handle<> coroutine, const JobOptions& options) = 0;
 protected:
 	template <class Func, class... Args>
 	static auto Wrapper(Func func, Args... args) -> Future<std::invoke_result_t<Func, Args...>> {
@@ -54,19 +63,19 @@ protected:
 	}
 
 	template <class Func, class... Args>
-	static auto MakeTask(Func func, Scheduler* scheduler, Args... args) {
+	static auto MakeTask(Func func, Scheduler* scheduler, JobOptions options, Args... args) {
 		if constexpr (is_schedulable<Func, Args...>::value) {
-			auto task = [](Func func, Scheduler* scheduler, Args... args) -> std::invoke_result_t<Func, Args...> {
+			auto task = [](Func func, Scheduler* scheduler, JobOptions options, Args... args) -> std::invoke_result_t<Func, Args...> {
 				auto innerTask = func(std::forward<Args>(args)...);
-				innerTask.Schedule(*scheduler);
+				innerTask.Schedule(*scheduler, options);
 				co_return co_await innerTask;
-			}(std::move(func), scheduler, std::forward<Args>(args)...);
+			}(std::move(func), scheduler, options, std::forward<Args>(args)...);
 			//auto task = func(std::forward<Args>(args)...);
 			return task;
 		}
 		else {
 			auto task = Wrapper(std::move(func), std::forward<Args>(args)...);
-			task.Schedule(*scheduler);
+			task.Schedule(*scheduler, options);
 			return task;
 		}
 	}
@@ -75,7 +84,8 @@ protected:
 
 class ImmediateScheduler : public Scheduler {
 public:
-	void Resume(std::experimental::coroutine_handle<> coroutine) override {
+	using Scheduler::Resume;
+	void Resume(std::experimental::coroutine_handle<> coroutine, const JobOptions&) override {
 		if (!coroutine.done()) {
 			coroutine.resume();
 		}
@@ -1,21 +1,34 @@
 #include "ThreadpoolScheduler.hpp"
+#include "Tracer.hpp"
 #include <BaseLibrary/ThreadName.hpp>
+#include <algorithm>
 #include <sstream>
 
 namespace inl::jobs {
 
 
-ThreadpoolScheduler::ThreadpoolScheduler(int threadCount) {
+thread_local ThreadpoolScheduler::CurrentWorker ThreadpoolScheduler::currentWorker;
+
+
+ThreadpoolScheduler::ThreadpoolScheduler(int threadCount, eQueueMode mode)
+	: m_mode(mode)
+{
 	m_running = true;
+	m_numSharedTasks = 0;
+	m_pinnedRoundRobin = 0;
+	m_numSleeping = 0;
 	m_workers.resize(threadCount);
+	for (auto& worker : m_workers) {
+		worker = std::make_unique<Worker>();
+	}
 
 	int threadIndex = 0;
 	for (auto& worker : m_workers) {
-		worker = std::thread([this](int threadIndex) {
+		worker->thread = std::thread([this](int threadIndex) {
 			std::stringstream ss;
 			ss << "Jobsys Pool #" << threadIndex;
 			SetCurrentThreadName(ss.str().c_str());
-			ThreadFunc();
+			ThreadFunc(threadIndex);
 		},
 		threadIndex);
 		++threadIndex;
@@ -27,33 +40,169 @@ ThreadpoolScheduler::~ThreadpoolScheduler() {
 }
 
 
-void ThreadpoolScheduler::Resume(handle_t coroutine) {
-	m_tasks2.enqueue(std::move(coroutine));
+void ThreadpoolScheduler::Resume(handle_t coroutine, const JobOptions& options) {
+	int pinnedWorker = SelectPinnedWorker(options.affinityMask);
+
+	if (pinnedWorker >= 0) {
+		Worker& worker = *m_workers[pinnedWorker];
+		worker.pinnedTasks.enqueue(std::move(coroutine));
+		++worker.numPinnedTasks;
+		WakeWorkers(true); // Only one particular worker can take it, so wake all.
+		return;
+	}
+
+	// Continuations resumed from one of our own workers stay on that worker.
+	if (m_mode == eQueueMode::WORK_STEALING && options.priority == eJobPriority::FRAME && currentWorker.scheduler == this) {
+		m_workers[currentWorker.index]->localTasks.Push(std::move(coroutine));
+	}
+	else {
+		m_tasks[(int)options.priority].enqueue(std::move(coroutine));
+	}
+	++m_numSharedTasks;
+	WakeWorkers(false);
 }
 
 
 void ThreadpoolScheduler::ShutdownThreads() {
-	for (auto& w : m_workers) {
-		m_tasks2.enqueue({});
+	m_running = false;
+	{
+		std::lock_guard<std::mutex> lkg(m_sleepMtx);
 	}
+	m_sleepCv.notify_all();
 	for (auto& w : m_workers) {
-		w.join();
+		w->thread.join();
 	}
 }
 
 
-void ThreadpoolScheduler::ThreadFunc() {
-	bool finishTokenSeen = false;
+void ThreadpoolScheduler::ThreadFunc(int workerIndex) {
+	currentWorker.scheduler = this;
+	currentWorker.index = workerIndex;
+
+	Worker& self = *m_workers[workerIndex];
+	auto hasWork = [this, &self] {
+		return m_numSharedTasks > 0 || self.numPinnedTasks > 0;
+	};
+
 	do {
 		handle_t handle;
-		m_tasks2.wait_dequeue(handle);
-		if (handle) {
+		if (FindTask(workerIndex, handle)) {
+			// The frame may be gone after resume, only its address is kept for the end event.
+			const void* address = handle.address();
+			Tracer::Record(eTraceEvent::RESUME_BEGIN, address);
 			handle.resume();
+			Tracer::Record(eTraceEvent::RESUME_END, address);
+			continue;
+		}
+
+		// Counters are increased after the task is queued, so a task may be
+		// momentarily invisible even though the counters say there's work.
+		if (hasWork()) {
+			std::this_thread::yield();
+			continue;
+		}
+		if (!m_running) {
+			break;
+		}
+
+		// Announce that we are going to sleep before checking the counters a last time,
+		// so that Resume either sees us sleeping or we see its task.
+		std::unique_lock<std::mutex> lk(m_sleepMtx);
+		++m_numSleeping;
+		m_sleepCv.wait(lk, [this, &hasWork] { return hasWork() || !m_running; });
+		--m_numSleeping;
+	} while (true);
+
+	currentWorker = {};
+}
+
+
+bool ThreadpoolScheduler::FindTask(int workerIndex, handle_t& handle) {
+	Worker& self = *m_workers[workerIndex];
+
+	if (self.numPinnedTasks > 0 && self.pinnedTasks.try_dequeue(handle)) {
+		--self.numPinnedTasks;
+		return true;
+	}
+	if (FindSharedTask(workerIndex, handle)) {
+		--m_numSharedTasks;
+		return true;
+	}
+	return false;
+}
+
+
+bool ThreadpoolScheduler::FindSharedTask(int workerIndex, handle_t& handle) {
+	const bool stealing = m_mode == eQueueMode::WORK_STEALING;
+
+	if (m_tasks[(int)eJobPriority::CRITICAL].try_dequeue(handle)) {
+		return true;
+	}
+
+	// Own work first, newest first.
+	if (stealing && m_workers[workerIndex]->localTasks.Pop(handle)) {
+		return true;
+	}
+
+	// Then work injected from outside the pool.
+	if (m_tasks[(int)eJobPriority::FRAME].try_dequeue(handle)) {
+		return true;
+	}
+
+	// Steal the oldest work of the others, starting at the neighbour
+	// so that thieves don't all hammer the same victim.
+	if (stealing) {
+		const int numWorkers = (int)m_workers.size();
+		for (int offset = 1; offset < numWorkers; ++offset) {
+			int victim = (workerIndex + offset) % numWorkers;
+			if (m_workers[victim]->localTasks.Steal(handle)) {
+				return true;
+			}
+		}
+	}
+
+	return m_tasks[(int)eJobPriority::BACKGROUND].try_dequeue(handle);
+}
+
+
+int ThreadpoolScheduler::SelectPinnedWorker(uint64_t affinityMask) {
+	const int numCandidates = std::min((int)m_workers.size(), 64);
+	if (numCandidates < 64) {
+		affinityMask &= (uint64_t(1) << numCandidates) - 1;
+	}
+	if (affinityMask == 0) {
+		return -1;
+	}
+
+	// Prefer staying on the current worker.
+	if (currentWorker.scheduler == this && currentWorker.index < 64 && (affinityMask & (uint64_t(1) << currentWorker.index))) {
+		return currentWorker.index;
+	}
+
+	// Distribute among allowed workers otherwise.
+	int first = int(m_pinnedRoundRobin.fetch_add(1) % (unsigned)numCandidates);
+	for (int offset = 0; offset < numCandidates; ++offset) {
+		int index = (first + offset) % numCandidates;
+		if (affinityMask & (uint64_t(1) << index)) {
+			return index;
+		}
+	}
+	return -1;
+}
+
+
+void ThreadpoolScheduler::WakeWorkers(bool all) {
+	if (m_numSleeping > 0) {
+		{
+			std::lock_guard<std::mutex> lkg(m_sleepMtx);
+		}
+		if (all) {
+			m_sleepCv.notify_all();
 		}
 		else {
-			finishTokenSeen = true;
+			m_sleepCv.notify_one();
 		}
-	} while (!finishTokenSeen);
+	}
 }
 
 
@@ -1,38 +1,80 @@
 #pragma once
 
 #include "Scheduler.hpp"
+#include "WorkStealingQueue.hpp"
 #include <thread>
-#include <queue>
-#include <mutex>
 #include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
 
-#include <moodycamel/blockingconcurrentqueue.h>
+#include <moodycamel/concurrentqueue.h>
 
 namespace inl::jobs {
 
 
+enum class eQueueMode {
+	/// <summary> All workers take tasks from a single shared FIFO queue. </summary>
+	SHARED,
+	/// <summary> Each worker has its own LIFO deque and steals from the others when idle. </summary>
+	WORK_STEALING,
+};
+
+
+/// <remarks> Workers look for work in the following order: tasks pinned to the worker,
+///		critical lane, own deque (work stealing only), frame lane, other workers' deques
+///		(work stealing only), background lane. Worker N corresponds to bit N of
+///		<see cref="JobOptions::affinityMask"/>. </remarks>
 class ThreadpoolScheduler : public Scheduler {
 public:
 	using handle_t = std::experimental::coroutine_handle<>;
 
-	ThreadpoolScheduler(int threadCount = std::thread::hardware_concurrency());
+	ThreadpoolScheduler(int threadCount = std::thread::hardware_concurrency(), eQueueMode mode = eQueueMode::SHARED);
 	~ThreadpoolScheduler();
 
-	void Resume(handle_t coroutine) override;
+	using Scheduler::Resume;
+	void Resume(handle_t coroutine, const JobOptions& options) override;
+
+	eQueueMode GetQueueMode() const { return m_mode; }
+	size_t GetNumWorkers() const { return m_workers.size(); }
 
 private:
+	struct Worker {
+		std::thread thread;
+		WorkStealingQueue<handle_t> localTasks;
+		moodycamel::ConcurrentQueue<handle_t> pinnedTasks;
+		std::atomic_size_t numPinnedTasks = 0;
+	};
+
 	void ShutdownThreads();
-	void ThreadFunc();
+	void ThreadFunc(int workerIndex);
+	bool FindTask(int workerIndex, handle_t& handle);
+	bool FindSharedTask(int workerIndex, handle_t& handle);
+	int SelectPinnedWorker(uint64_t affinityMask);
+	void WakeWorkers(bool all);
 
 private:
-	std::vector<std::thread> m_workers;
-	std::queue<handle_t> m_tasks;
-	std::mutex m_queueMtx;
-	std::condition_variable m_cv;
+	eQueueMode m_mode;
+	std::vector<std::unique_ptr<Worker>> m_workers;
+
+	// In work stealing mode FRAME tasks resumed by a worker go to the worker's local deque,
+	// the shared frame lane only gets tasks coming from outside the pool.
+	moodycamel::ConcurrentQueue<handle_t> m_tasks[NumJobPriorities];
+	std::atomic_size_t m_numSharedTasks; // Tasks that any worker can run: lanes plus local deques.
+	std::atomic_uint m_pinnedRoundRobin;
 	std::atomic_bool m_running;
 
-	moodycamel::BlockingConcurrentQueue<handle_t> m_tasks2;
+	std::mutex m_sleepMtx;
+	std::condition_variable m_sleepCv;
+	std::atomic_int m_numSleeping;
+
+	struct CurrentWorker {
+		const ThreadpoolScheduler* scheduler = nullptr;
+		int index = -1;
+	};
+	static thread_local CurrentWorker currentWorker;
 };
 
 
-} // namespace inl::jobs
\ No newline at end of file
+} // namespace inl::jobs
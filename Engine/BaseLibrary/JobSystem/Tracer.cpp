@@ -0,0 +1,199 @@
+#include "Tracer.hpp"
+
+#include "../SpinMutex.hpp"
+#include "../ThreadName.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace inl::jobs {
+
+
+std::atomic_bool Tracer::s_enabled = false;
+
+
+namespace {
+
+	struct TraceRecord {
+		int64_t timestamp; // Nanoseconds of the steady clock.
+		const void* coroutine;
+		eTraceEvent type;
+	};
+
+	// Written only by its own thread, the lock is there for the exporter and is practically never contended.
+	struct ThreadBuffer {
+		SpinMutex mtx;
+		std::string name;
+		uint32_t threadId = 0;
+		std::vector<TraceRecord> records;
+		uint64_t numRecorded = 0;
+	};
+
+	// Buffers outlive their threads so that events of exited threads can still be exported.
+	struct Registry {
+		std::mutex mtx;
+		std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+	};
+
+	Registry& GetRegistry() {
+		static Registry registry;
+		return registry;
+	}
+
+	ThreadBuffer& GetThreadBuffer() {
+		thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+			auto buffer = std::make_shared<ThreadBuffer>();
+			buffer->records.resize(Tracer::EventsPerThread);
+
+			Registry& registry = GetRegistry();
+			std::lock_guard<std::mutex> lkg(registry.mtx);
+			buffer->threadId = uint32_t(registry.buffers.size() + 1);
+			buffer->name = GetCurrentThreadName();
+			if (buffer->name.empty()) {
+				buffer->name = "Thread #" + std::to_string(buffer->threadId);
+			}
+			registry.buffers.push_back(buffer);
+			return buffer;
+		}();
+		return *buffer;
+	}
+
+	const char* SuspendReason(eTraceEvent type) {
+		switch (type) {
+			case eTraceEvent::SUSPEND_MUTEX: return "Mutex";
+			case eTraceEvent::SUSPEND_FENCE: return "Fence";
+			case eTraceEvent::SUSPEND_CONDITION_VARIABLE: return "ConditionVariable";
+			default: return nullptr;
+		}
+	}
+
+	void WriteEscaped(std::ostream& os, const std::string& str) {
+		for (char c : str) {
+			if (c == '"' || c == '\\') {
+				os << '\\' << c;
+			}
+			else if ((unsigned char)c < 0x20) {
+				os << ' ';
+			}
+			else {
+				os << c;
+			}
+		}
+	}
+
+	void WriteTimestamp(std::ostream& os, int64_t nanoseconds) {
+		// Chrome expects microseconds, keep the nanosecond precision as fraction.
+		os << nanoseconds / 1000 << '.' << char('0' + nanoseconds / 100 % 10) << char('0' + nanoseconds / 10 % 10) << char('0' + nanoseconds % 10);
+	}
+
+} // namespace
+
+
+void Tracer::RecordImpl(eTraceEvent type, const void* coroutine) {
+	int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+	ThreadBuffer& buffer = GetThreadBuffer();
+	std::lock_guard<SpinMutex> lkg(buffer.mtx);
+	buffer.records[buffer.numRecorded % EventsPerThread] = { timestamp, coroutine, type };
+	++buffer.numRecorded;
+}
+
+
+void Tracer::WriteChromeTrace(std::ostream& os) {
+	struct ThreadSnapshot {
+		std::string name;
+		uint32_t threadId;
+		std::vector<TraceRecord> records;
+	};
+
+	// Copy the events out so that workers are blocked only briefly.
+	std::vector<ThreadSnapshot> snapshots;
+	{
+		Registry& registry = GetRegistry();
+		std::lock_guard<std::mutex> lkg(registry.mtx);
+		for (auto& buffer : registry.buffers) {
+			std::lock_guard<SpinMutex> lkgBuffer(buffer->mtx);
+			ThreadSnapshot snapshot{ buffer->name, buffer->threadId, {} };
+			uint64_t first = buffer->numRecorded > EventsPerThread ? buffer->numRecorded - EventsPerThread : 0;
+			snapshot.records.reserve(size_t(buffer->numRecorded - first));
+			for (uint64_t i = first; i < buffer->numRecorded; ++i) {
+				snapshot.records.push_back(buffer->records[i % EventsPerThread]);
+			}
+			snapshots.push_back(std::move(snapshot));
+		}
+	}
+
+	int64_t origin = INT64_MAX;
+	for (auto& snapshot : snapshots) {
+		if (!snapshot.records.empty()) {
+			origin = std::min(origin, snapshot.records.front().timestamp);
+		}
+	}
+
+	os << "{\"traceEvents\":[";
+	bool firstEvent = true;
+	auto beginEvent = [&]() -> std::ostream& {
+		os << (firstEvent ? "\n" : ",\n");
+		firstEvent = false;
+		return os;
+	};
+
+	for (auto& snapshot : snapshots) {
+		beginEvent() << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << snapshot.threadId << R"(,"args":{"name":")";
+		WriteEscaped(os, snapshot.name);
+		os << "\"}}";
+
+		// Pair up resume begin/end into complete events. Workers don't nest resumes,
+		// an unpaired end at the start is the remainder of an overwritten slice.
+		const TraceRecord* open = nullptr;
+		const char* suspendReason = nullptr;
+		for (auto& record : snapshot.records) {
+			switch (record.type) {
+				case eTraceEvent::RESUME_BEGIN:
+					open = &record;
+					suspendReason = nullptr;
+					break;
+				case eTraceEvent::RESUME_END:
+					if (open) {
+						beginEvent() << R"({"name":"Job","cat":"jobs","ph":"X","pid":1,"tid":)" << snapshot.threadId << ",\"ts\":";
+						WriteTimestamp(os, open->timestamp - origin);
+						os << ",\"dur\":";
+						WriteTimestamp(os, record.timestamp - open->timestamp);
+						os << R"(,"args":{"coroutine":")" << open->coroutine << '"';
+						if (suspendReason) {
+							os << R"(,"suspendedOn":")" << suspendReason << '"';
+						}
+						os << "}}";
+					}
+					open = nullptr;
+					break;
+				default:
+					suspendReason = SuspendReason(record.type);
+					beginEvent() << R"({"name":"Wait )" << suspendReason << R"(","cat":"jobs","ph":"i","s":"t","pid":1,"tid":)" << snapshot.threadId << ",\"ts\":";
+					WriteTimestamp(os, record.timestamp - origin);
+					os << R"(,"args":{"coroutine":")" << record.coroutine << "\"}}";
+					break;
+			}
+		}
+	}
+
+	os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+
+void Tracer::Clear() {
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lkg(registry.mtx);
+	for (auto& buffer : registry.buffers) {
+		std::lock_guard<SpinMutex> lkgBuffer(buffer->mtx);
+		buffer->numRecorded = 0;
+	}
+}
+
+
+} // namespace inl::jobs
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+
+namespace inl::jobs {
+
+
+enum class eTraceEvent : uint8_t {
+	/// <summary> A worker started running a coroutine. </summary>
+	RESUME_BEGIN,
+	/// <summary> The coroutine returned control to the worker, either suspended or finished. </summary>
+	RESUME_END,
+	/// <summary> The coroutine suspended waiting for a <see cref="Mutex"/>. </summary>
+	SUSPEND_MUTEX,
+	/// <summary> The coroutine suspended waiting for a <see cref="Fence"/>. </summary>
+	SUSPEND_FENCE,
+	/// <summary> The coroutine suspended waiting for a <see cref="ConditionVariable"/>. </summary>
+	SUSPEND_CONDITION_VARIABLE,
+};
+
+
+/// <summary>
+/// Records job system events into per-thread ring buffers and exports them as
+/// Chrome trace_event JSON, which chrome://tracing and Perfetto can open.
+/// </summary>
+/// <remarks> Disabled by default. When disabled, recording an event is a single relaxed load.
+///		Each thread keeps the last <see cref="EventsPerThread"/> events; older ones are overwritten.
+///		Threads are named after <see cref="SetCurrentThreadName"/> in the trace. </remarks>
+class Tracer {
+public:
+	static constexpr size_t EventsPerThread = 16384;
+
+	static void Enable(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+	static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+	/// <summary> Records an event on the calling thread. </summary>
+	/// <param name="coroutine"> Address of the coroutine frame, used to correlate events of the same job. </param>
+	static void Record(eTraceEvent type, const void* coroutine) {
+		if (IsEnabled()) {
+			RecordImpl(type, coroutine);
+		}
+	}
+
+	/// <summary> Writes the recorded events of all threads as a Chrome trace JSON document. </summary>
+	/// <remarks> Can be called while workers are running, events recorded meanwhile may be missed. </remarks>
+	static void WriteChromeTrace(std::ostream& os);
+
+	/// <summary> Discards all recorded events. </summary>
+	static void Clear();
+private:
+	static void RecordImpl(eTraceEvent type, const void* coroutine);
+private:
+	static std::atomic_bool s_enabled;
+};
+
+
+} // namespace inl::jobs
@@ -3,6 +3,12 @@
 #include <iostream>
 #include "Future.hpp"
 #include "Fence.hpp"
+#include "Scheduler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <thread>
 
 
 namespace inl::jobs {
@@ -36,6 +42,173 @@ namespace impl {
 		co_await WaitAllHelper(std::forward<Awaitable>(awaitables)...);
 	}
 
+
+	inline void ResumeAwaiting(std::experimental::coroutine_handle<> handle, Scheduler* scheduler, const JobOptions& options) {
+		if (scheduler) {
+			scheduler->Resume(handle, options);
+		}
+		else {
+			handle.resume();
+		}
+	}
+
+
+	/// <summary> Awaiter of <see cref="WhenAll"/>. Lives in the awaiting coroutine's frame. </summary>
+	template <class FutureIter>
+	class WhenAllAwaiter : public FutureContinuation {
+	public:
+		WhenAllAwaiter(FutureIter first, FutureIter last) : m_first(first), m_last(last), m_remaining(0) {}
+		WhenAllAwaiter(const WhenAllAwaiter&) = delete;
+		WhenAllAwaiter& operator=(const WhenAllAwaiter&) = delete;
+
+		bool await_ready() const noexcept {
+			return std::all_of(m_first, m_last, [](const auto& future) { return future.ready(); });
+		}
+		template <class T>
+		bool await_suspend(T awaitingCoroutine) noexcept {
+			Scheduler* scheduler = nullptr;
+			JobOptions options;
+			if constexpr (std::is_base_of_v<SchedulablePromiseTag, std::decay_t<decltype(awaitingCoroutine.promise())>>) {
+				scheduler = static_cast<const SchedulablePromiseTag&>(awaitingCoroutine.promise()).m_scheduler;
+				options = static_cast<const SchedulablePromiseTag&>(awaitingCoroutine.promise()).m_options;
+			}
+			return Suspend(std::experimental::coroutine_handle<>(awaitingCoroutine), scheduler, options);
+		}
+		void await_resume() noexcept {}
+
+		void OnReady(size_t) noexcept override {
+			if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				ResumeAwaiting(m_awaitingHandle, m_scheduler, m_options);
+			}
+		}
+	private:
+		bool Suspend(std::experimental::coroutine_handle<> awaitingCoroutine, Scheduler* scheduler, JobOptions options) noexcept {
+			m_awaitingHandle = awaitingCoroutine;
+			m_scheduler = scheduler;
+			m_options = options;
+
+			// One extra count is held while attaching, so that no future can resume us halfway through.
+			m_remaining.store(size_t(std::distance(m_first, m_last)) + 1, std::memory_order_relaxed);
+			size_t index = 0;
+			for (auto it = m_first; it != m_last; ++it, ++index) {
+				if (!it->AttachContinuation(this, index)) {
+					m_remaining.fetch_sub(1, std::memory_order_relaxed);
+				}
+				it->Run();
+			}
+
+			// If we drop the last count, everything is already done and there's no need to suspend.
+			// Otherwise *this may be resumed and destroyed on another thread from here on.
+			return m_remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+		}
+	private:
+		FutureIter m_first;
+		FutureIter m_last;
+		std::atomic_size_t m_remaining;
+		std::experimental::coroutine_handle<> m_awaitingHandle;
+		Scheduler* m_scheduler = nullptr;
+		JobOptions m_options;
+	};
+
+
+	/// <summary> Awaiter of <see cref="WhenAny"/>. Lives in the awaiting coroutine's frame. </summary>
+	template <class FutureIter>
+	class WhenAnyAwaiter : public FutureContinuation {
+	public:
+		WhenAnyAwaiter(FutureIter first, FutureIter last)
+			: m_first(first), m_last(last), m_resumeToken(2), m_triggered(false), m_numArrived(0)
+		{
+			assert(first != last);
+		}
+		WhenAnyAwaiter(const WhenAnyAwaiter&) = delete;
+		WhenAnyAwaiter& operator=(const WhenAnyAwaiter&) = delete;
+
+		bool await_ready() noexcept {
+			size_t index = 0;
+			for (auto it = m_first; it != m_last; ++it, ++index) {
+				if (it->ready()) {
+					m_winner = index;
+					return true;
+				}
+			}
+			return false;
+		}
+		template <class T>
+		bool await_suspend(T awaitingCoroutine) noexcept {
+			Scheduler* scheduler = nullptr;
+			JobOptions options;
+			if constexpr (std::is_base_of_v<SchedulablePromiseTag, std::decay_t<decltype(awaitingCoroutine.promise())>>) {
+				scheduler = static_cast<const SchedulablePromiseTag&>(awaitingCoroutine.promise()).m_scheduler;
+				options = static_cast<const SchedulablePromiseTag&>(awaitingCoroutine.promise()).m_options;
+			}
+			return Suspend(std::experimental::coroutine_handle<>(awaitingCoroutine), scheduler, options);
+		}
+		size_t await_resume() noexcept {
+			// Futures that could not be detached are calling OnReady right now, wait until they are out.
+			size_t numExpectedArrivals = m_numImmediate;
+			auto it = m_first;
+			for (size_t index = 0; index < m_numAttached; ++index, ++it) {
+				if (!it->DetachContinuation(this)) {
+					++numExpectedArrivals;
+				}
+			}
+			while (m_numArrived.load(std::memory_order_acquire) < numExpectedArrivals) {
+				std::this_thread::yield();
+			}
+			return m_winner;
+		}
+
+		void OnReady(size_t index) noexcept override {
+			// Only the first future to finish may resume, and only if attaching has finished too.
+			bool resume = false;
+			std::experimental::coroutine_handle<> handle;
+			Scheduler* scheduler = nullptr;
+			JobOptions options;
+			if (!m_triggered.exchange(true, std::memory_order_acq_rel)) {
+				m_winner = index;
+				resume = m_resumeToken.fetch_sub(1, std::memory_order_acq_rel) == 1;
+				handle = m_awaitingHandle;
+				scheduler = m_scheduler;
+				options = m_options;
+			}
+			m_numArrived.fetch_add(1, std::memory_order_release); // Last access to *this.
+			if (resume) {
+				ResumeAwaiting(handle, scheduler, options);
+			}
+		}
+	private:
+		bool Suspend(std::experimental::coroutine_handle<> awaitingCoroutine, Scheduler* scheduler, JobOptions options) noexcept {
+			m_awaitingHandle = awaitingCoroutine;
+			m_scheduler = scheduler;
+			m_options = options;
+
+			size_t index = 0;
+			for (auto it = m_first; it != m_last; ++it, ++index) {
+				if (!it->AttachContinuation(this, index)) {
+					m_numImmediate = 1;
+					OnReady(index);
+					break;
+				}
+				++m_numAttached;
+				it->Run();
+			}
+
+			return m_resumeToken.fetch_sub(1, std::memory_order_acq_rel) != 1;
+		}
+	private:
+		FutureIter m_first;
+		FutureIter m_last;
+		std::atomic_int m_resumeToken; // Dropped by the first OnReady and by Suspend, whoever drops it last resumes.
+		std::atomic_bool m_triggered;
+		std::atomic_size_t m_numArrived;
+		size_t m_numAttached = 0;
+		size_t m_numImmediate = 0;
+		size_t m_winner = 0;
+		std::experimental::coroutine_handle<> m_awaitingHandle;
+		Scheduler* m_scheduler = nullptr;
+		JobOptions m_options;
+	};
+
 } // namespace impl
 
 
@@ -69,6 +242,36 @@ Future<void> WaitAll(Awaitable&&... awaitables) {
 }
 
 
+/// <summary> Resumes the awaiting coroutine once, when the last of the futures is ready. </summary>
+/// <remarks> Starts the futures that haven't been started yet. The result doesn't rethrow the
+///		futures' exceptions, await or get the futures for that afterwards, which won't suspend.
+///		The wait is bookkept by a counter in the awaiting coroutine frame, nothing is allocated. </remarks>
+template <class FutureIter>
+impl::WhenAllAwaiter<FutureIter> WhenAll(FutureIter first, FutureIter last) {
+	return impl::WhenAllAwaiter<FutureIter>(first, last);
+}
+
+template <class FutureRange>
+auto WhenAll(FutureRange& futures) {
+	return WhenAll(std::begin(futures), std::end(futures));
+}
+
+
+/// <summary> Resumes the awaiting coroutine when the first of the futures is ready. </summary>
+/// <returns> The index of the ready future in the range. </returns>
+/// <remarks> The range must not be empty. Futures are started in order until one is found ready.
+///		Nothing is allocated, but resuming briefly waits for futures that are finishing concurrently. </remarks>
+template <class FutureIter>
+impl::WhenAnyAwaiter<FutureIter> WhenAny(FutureIter first, FutureIter last) {
+	return impl::WhenAnyAwaiter<FutureIter>(first, last);
+}
+
+template <class FutureRange>
+auto WhenAny(FutureRange& futures) {
+	return WhenAny(std::begin(futures), std::end(futures));
+}
+
+
 
 
 } // namespace inl::jobs
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../SpinMutex.hpp"
+
+#include <deque>
+#include <mutex>
+
+
+namespace inl::jobs {
+
+
+/// <summary> Double ended task queue owned by a single worker thread. </summary>
+/// <remarks> The owner pushes and pops at the back (LIFO) so that freshly resumed
+///		continuations run while their frames are still hot in the cache.
+///		Other workers steal from the front (FIFO), taking the oldest, coldest work. </remarks>
+template <class T>
+class WorkStealingQueue {
+public:
+	void Push(T item);
+	bool Pop(T& item);
+	bool Steal(T& item);
+	bool Empty() const;
+private:
+	std::deque<T> m_items;
+	mutable SpinMutex m_mtx;
+};
+
+
+template <class T>
+void WorkStealingQueue<T>::Push(T item) {
+	std::lock_guard<SpinMutex> lkg(m_mtx);
+	m_items.push_back(std::move(item));
+}
+
+template <class T>
+bool WorkStealingQueue<T>::Pop(T& item) {
+	std::lock_guard<SpinMutex> lkg(m_mtx);
+	if (m_items.empty()) {
+		return false;
+	}
+	item = std::move(m_items.back());
+	m_items.pop_back();
+	return true;
+}
+
+template <class T>
+bool WorkStealingQueue<T>::Steal(T& item) {
+	std::unique_lock<SpinMutex> lk(m_mtx, std::try_to_lock);
+	if (!lk.owns_lock() || m_items.empty()) {
+		return false;
+	}
+	item = std::move(m_items.front());
+	m_items.pop_front();
+	return true;
+}
+
+template <class T>
+bool WorkStealingQueue<T>::Empty() const {
+	std::lock_guard<SpinMutex> lkg(m_mtx);
+	return m_items.empty();
+}
+
+
+} // namespace inl::jobs
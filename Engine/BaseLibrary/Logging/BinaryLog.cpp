@@ -0,0 +1,137 @@
+#include "BinaryLog.hpp"
+#include "LogFormat.hpp"
+
+#include "../Serialization/BinaryStream.hpp"
+
+#include <cstring>
+#include <unordered_map>
+
+
+namespace inl {
+
+
+namespace {
+
+	// Parameters of decoded events only have their text.
+	struct DecodedParameter : public EventParameter {
+		DecodedParameter(std::string name, std::string text) : EventParameter(name), text(std::move(text)) {}
+
+		std::string text;
+
+		std::string ToString() const override { return text; }
+		EventParameter* Clone() const override { return new DecodedParameter{ *this }; }
+	};
+
+	void ReadArgument(BinaryStreamReader& reader, LogRecord& record) {
+		uint64_t type = reader.ReadVarint();
+		switch (eLogArgumentType(type)) {
+			case eLogArgumentType::BOOL: record.PushBool(reader.ReadBool()); break;
+			case eLogArgumentType::INT: record.PushInt(reader.ReadVarintSigned()); break;
+			case eLogArgumentType::UINT: record.PushUint(reader.ReadVarint()); break;
+			case eLogArgumentType::FLOAT: record.PushFloat(reader.ReadDouble()); break;
+			case eLogArgumentType::STRING: record.PushString(reader.ReadString()); break;
+			default: throw InvalidArgumentException("Unknown argument type in binary log.", std::to_string(type));
+		}
+	}
+
+	const std::string& FindName(const std::unordered_map<uint64_t, std::string>& names, uint64_t id) {
+		auto it = names.find(id);
+		if (it == names.end()) {
+			throw InvalidArgumentException("Binary log uses an id before it is introduced.", std::to_string(id));
+		}
+		return it->second;
+	}
+
+} // namespace
+
+
+bool DecodeBinaryLog(std::istream& binaryLog, std::ostream& text) {
+	BinaryStreamReader reader(binaryLog);
+
+	char magic[sizeof(impl::BinaryLogMagic)];
+	try {
+		reader.ReadBytes(magic, sizeof(magic));
+	}
+	catch (OutOfRangeException&) {
+		throw InvalidArgumentException("Data is not a binary log.");
+	}
+	if (std::memcmp(magic, impl::BinaryLogMagic, sizeof(magic)) != 0) {
+		throw InvalidArgumentException("Data is not a binary log.");
+	}
+	uint64_t version = reader.ReadVarint();
+	if (version > impl::BinaryLogVersion) {
+		throw InvalidArgumentException("Binary log is of a newer version.", std::to_string(version));
+	}
+
+	std::unordered_map<uint64_t, std::string> pipes;
+	std::unordered_map<uint64_t, std::string> formats;
+	try {
+		while (binaryLog.peek() != std::istream::traits_type::eof()) {
+			uint64_t tag = reader.ReadVarint();
+			switch (impl::eBinaryLogTag(tag)) {
+				case impl::eBinaryLogTag::FORMAT: {
+					uint64_t id = reader.ReadVarint();
+					formats[id] = reader.ReadString();
+					break;
+				}
+				case impl::eBinaryLogTag::PIPE: {
+					uint64_t id = reader.ReadVarint();
+					pipes[id] = reader.ReadString();
+					break;
+				}
+				case impl::eBinaryLogTag::EVENT: {
+					const std::string& pipeName = FindName(pipes, reader.ReadVarint());
+					int64_t microseconds = reader.ReadVarintSigned();
+					LogEvent evt(reader.ReadString());
+					uint64_t numParameters = reader.ReadVarint();
+					for (uint64_t i = 0; i < numParameters; ++i) {
+						std::string name = reader.ReadString();
+						evt.PutParameter(DecodedParameter(std::move(name), reader.ReadString()));
+					}
+					impl::WriteTextEvent(text, microseconds, pipeName, evt);
+					break;
+				}
+				case impl::eBinaryLogTag::RECORD: {
+					const std::string& pipeName = FindName(pipes, reader.ReadVarint());
+					int64_t microseconds = reader.ReadVarintSigned();
+					LogRecord record;
+					record.formatId = uint32_t(reader.ReadVarint());
+					const std::string& format = FindName(formats, record.formatId);
+					uint64_t numArguments = reader.ReadVarint();
+					for (uint64_t i = 0; i < numArguments; ++i) {
+						ReadArgument(reader, record);
+					}
+					impl::WriteTextEvent(text, microseconds, pipeName, LogEvent(record.Format(format)));
+					break;
+				}
+				case impl::eBinaryLogTag::DROPPED: {
+					text << "[" << reader.ReadVarint() << " events were dropped, logging threads outpaced the writer.]\n";
+					break;
+				}
+				default: throw InvalidArgumentException("Unknown entry in binary log.", std::to_string(tag));
+			}
+		}
+	}
+	catch (OutOfRangeException&) {
+		return false;
+	}
+	return true;
+}
+
+
+namespace impl {
+
+	void WriteTextEvent(std::ostream& stream, int64_t microseconds, const std::string& pipeName, const LogEvent& evt) {
+		stream
+			<< "[" << microseconds / 1.e6 << "]"
+			<< "[" << pipeName << "] "
+			<< evt.GetMessage() << "\n";
+		for (size_t i = 0; i < evt.GetNumParameters(); i++) {
+			stream << "   " << evt[i].name << " = " << evt[i].ToString() << "\n";
+		}
+	}
+
+} // namespace impl
+
+
+} // namespace inl
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Event.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+
+
+namespace inl {
+
+
+/// <summary> How a logger writes its file. </summary>
+enum class eLogFileFormat {
+	/// <summary> Human readable lines. </summary>
+	TEXT,
+	/// <summary> Compact entries that <see cref="DecodeBinaryLog"/> turns into text,
+	///		messages of <see cref="LogFormat"/>s are never formatted by the program. </summary>
+	BINARY,
+};
+
+
+/// <summary> Writes the text of a binary log, the same the logger would have written in text format. </summary>
+/// <returns> False if the log ends in the middle of an entry, what comes before is written. </returns>
+/// <exception cref="InvalidArgumentException"> If the data is not a binary log, or of a newer version. </exception>
+bool DecodeBinaryLog(std::istream& binaryLog, std::ostream& text);
+
+
+namespace impl {
+
+	// The log starts with the magic and the version, entries follow, each starting with its tag.
+	constexpr char BinaryLogMagic[8] = { 'I', 'N', 'L', 'L', 'O', 'G', 'B', 'N' };
+	constexpr uint64_t BinaryLogVersion = 1;
+
+	enum class eBinaryLogTag : uint32_t {
+		FORMAT = 1, // id, format string, before the first record of the format
+		PIPE = 2, // id, name, before the first entry of the pipe
+		EVENT = 3, // pipe id, microseconds, message, parameters as name and text
+		RECORD = 4, // pipe id, microseconds, format id, typed arguments
+		DROPPED = 5, // number of events dropped since the last such entry
+	};
+
+	/// <summary> Writes the lines of an event in text format. </summary>
+	void WriteTextEvent(std::ostream& stream, int64_t microseconds, const std::string& pipeName, const LogEvent& evt);
+
+} // namespace impl
+
+
+} // namespace inl
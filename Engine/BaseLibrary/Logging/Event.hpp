@@ -180,6 +180,7 @@ public:
 
 	LogEvent(const LogEvent&);
 	LogEvent(LogEvent&&) = default;
+	LogEvent& operator=(LogEvent&&) = default;
 	~LogEvent() = default;
 
 	/// <summary> Set message of the event. </summary>
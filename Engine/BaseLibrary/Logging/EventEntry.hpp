@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Event.hpp"
+#include "LogFormat.hpp"
 
 #include <chrono>
 #include <deque>
@@ -12,6 +13,9 @@ namespace inl {
 struct EventEntry {
 	std::chrono::high_resolution_clock::time_point timestamp;
 	LogEvent event;
+	/// <summary> Events of a <see cref="LogFormat"/> have a record instead of a message, formatted when written. </summary>
+	bool isRecord = false;
+	LogRecord record;
 };
 
 
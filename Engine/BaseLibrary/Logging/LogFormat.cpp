@@ -0,0 +1,159 @@
+#include "LogFormat.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <sstream>
+
+
+namespace inl {
+
+
+namespace {
+
+	// Formats are never removed, so the strings don't move and can be read without the lock.
+	struct FormatTable {
+		std::mutex mutex;
+		std::deque<std::string> formats; // Id is index + 1, 0 is no format.
+	};
+
+	FormatTable& GetFormatTable() {
+		static FormatTable table;
+		return table;
+	}
+
+} // namespace
+
+
+LogFormat::LogFormat(const char* format) {
+	FormatTable& table = GetFormatTable();
+	std::lock_guard<std::mutex> lk(table.mutex);
+	auto it = std::find(table.formats.begin(), table.formats.end(), format);
+	if (it == table.formats.end()) {
+		table.formats.emplace_back(format);
+		it = table.formats.end() - 1;
+	}
+	m_id = uint32_t(it - table.formats.begin()) + 1;
+	m_format = &*it;
+}
+
+
+const std::string* LogFormat::Find(uint32_t id) {
+	FormatTable& table = GetFormatTable();
+	std::lock_guard<std::mutex> lk(table.mutex);
+	if (id == 0 || id > table.formats.size()) {
+		return nullptr;
+	}
+	return &table.formats[id - 1];
+}
+
+
+void LogRecord::PushBool(bool value) {
+	uint8_t byte = value ? 1 : 0;
+	PushFixed(eLogArgumentType::BOOL, &byte, 1);
+}
+
+
+void LogRecord::PushInt(int64_t value) {
+	PushFixed(eLogArgumentType::INT, &value, sizeof(value));
+}
+
+
+void LogRecord::PushUint(uint64_t value) {
+	PushFixed(eLogArgumentType::UINT, &value, sizeof(value));
+}
+
+
+void LogRecord::PushFloat(double value) {
+	PushFixed(eLogArgumentType::FLOAT, &value, sizeof(value));
+}
+
+
+void LogRecord::PushString(std::string_view value) {
+	if (!Reserve(1)) {
+		return;
+	}
+	size_t length = std::min(value.size(), std::min(size_t(255), MaxBytes - size - 1));
+	types[numArguments++] = eLogArgumentType::STRING;
+	data[size++] = uint8_t(length);
+	std::memcpy(data + size, value.data(), length);
+	size += uint8_t(length);
+}
+
+
+std::string LogRecord::Format(const std::string& format) const {
+	std::string message;
+	size_t offset = 0;
+	size_t index = 0;
+	size_t begin = 0;
+	for (size_t pos = format.find("{}"); pos != std::string::npos; pos = format.find("{}", begin)) {
+		message.append(format, begin, pos - begin);
+		if (index < numArguments) {
+			message += ArgumentToString(index++, offset);
+		}
+		else {
+			message += "{}";
+		}
+		begin = pos + 2;
+	}
+	message.append(format, begin, std::string::npos);
+	return message;
+}
+
+
+std::string LogRecord::ArgumentToString(size_t index, size_t& offset) const {
+	std::stringstream ss;
+	switch (types[index]) {
+		case eLogArgumentType::BOOL: {
+			ss << (data[offset] != 0 ? "true" : "false");
+			offset += 1;
+			break;
+		}
+		case eLogArgumentType::INT: {
+			int64_t value;
+			std::memcpy(&value, data + offset, sizeof(value));
+			ss << value;
+			offset += sizeof(value);
+			break;
+		}
+		case eLogArgumentType::UINT: {
+			uint64_t value;
+			std::memcpy(&value, data + offset, sizeof(value));
+			ss << value;
+			offset += sizeof(value);
+			break;
+		}
+		case eLogArgumentType::FLOAT: {
+			double value;
+			std::memcpy(&value, data + offset, sizeof(value));
+			ss << value;
+			offset += sizeof(value);
+			break;
+		}
+		case eLogArgumentType::STRING: {
+			size_t length = data[offset];
+			ss.write(reinterpret_cast<const char*>(data + offset + 1), std::streamsize(length));
+			offset += 1 + length;
+			break;
+		}
+	}
+	return ss.str();
+}
+
+
+bool LogRecord::Reserve(size_t bytes) {
+	return numArguments < MaxArguments && size + bytes <= MaxBytes;
+}
+
+
+void LogRecord::PushFixed(eLogArgumentType type, const void* value, size_t bytes) {
+	if (!Reserve(bytes)) {
+		return;
+	}
+	types[numArguments++] = type;
+	std::memcpy(data + size, value, bytes);
+	size += uint8_t(bytes);
+}
+
+
+} // namespace inl
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+
+namespace inl {
+
+
+/// <summary>
+/// A message format that is logged by its id, the arguments are stored as they are
+/// and the message is only formatted when it is written as text, or when a binary log is decoded.
+/// </summary>
+/// <remarks>
+/// <para> Each "{}" in the format is replaced by the next argument. </para>
+/// <para> Formats are meant to be static objects, they are interned when constructed and never released. </para>
+/// </remarks>
+class LogFormat {
+public:
+	explicit LogFormat(const char* format);
+	LogFormat(const LogFormat&) = delete;
+	LogFormat& operator=(const LogFormat&) = delete;
+
+	uint32_t GetId() const { return m_id; }
+	const std::string& GetFormat() const { return *m_format; }
+
+	/// <summary> Returns the format of the id, or null if there is none. </summary>
+	static const std::string* Find(uint32_t id);
+private:
+	uint32_t m_id;
+	const std::string* m_format;
+};
+
+
+enum class eLogArgumentType : uint8_t {
+	BOOL,
+	INT,
+	UINT,
+	FLOAT,
+	STRING,
+};
+
+
+/// <summary>
+/// The id of a <see cref="LogFormat"/> and its arguments, packed into a fixed size without allocations.
+/// </summary>
+/// <remarks> Arguments that don't fit are dropped, strings are truncated to the space left. </remarks>
+struct LogRecord {
+	static constexpr size_t MaxArguments = 8;
+	static constexpr size_t MaxBytes = 112;
+
+	uint32_t formatId = 0;
+	uint8_t numArguments = 0;
+	uint8_t size = 0; // Bytes of data used.
+	eLogArgumentType types[MaxArguments];
+	uint8_t data[MaxBytes];
+
+	template <class... Args>
+	void Pack(const Args&... args) { (Push(args), ...); }
+
+	template <class T>
+	void Push(const T& value);
+	void PushBool(bool value);
+	void PushInt(int64_t value);
+	void PushUint(uint64_t value);
+	void PushFloat(double value);
+	void PushString(std::string_view value);
+
+	/// <summary> Replaces the placeholders of the format with the arguments. </summary>
+	std::string Format(const std::string& format) const;
+	/// <summary> Converts the argument at <paramref name="offset"/> to text, and moves the offset past it. </summary>
+	std::string ArgumentToString(size_t index, size_t& offset) const;
+private:
+	bool Reserve(size_t bytes);
+	void PushFixed(eLogArgumentType type, const void* value, size_t bytes);
+};
+
+
+
+template <class T>
+void LogRecord::Push(const T& value) {
+	if constexpr (std::is_same_v<T, bool>) {
+		PushBool(value);
+	}
+	else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+		PushInt(int64_t(value));
+	}
+	else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+		PushUint(uint64_t(value));
+	}
+	else if constexpr (std::is_floating_point_v<T>) {
+		PushFloat(double(value));
+	}
+	else {
+		static_assert(std::is_convertible_v<const T&, std::string_view>, "Log arguments must be arithmetic or strings.");
+		PushString(std::string_view(value));
+	}
+}
+
+
+} // namespace inl
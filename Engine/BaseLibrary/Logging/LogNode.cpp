@@ -1,22 +1,102 @@
 #include "LogNode.hpp"
 #include "LogPipe.hpp"
 
+#include "../ThreadName.hpp"
+
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cstring>
 #include <iostream>
+#include <optional>
+#include <sstream>
 
 
 namespace inl {
 
 
-LogNode::LogNode() {
+namespace impl {
+
+	/// <summary> Single producer, single consumer queue of events. </summary>
+	/// <remarks> The producer is the thread that owns the ring, the consumer is whoever holds the node's mtx exclusively. </remarks>
+	class EventRing {
+	public:
+		explicit EventRing(size_t capacity) : slots(capacity) {}
+
+		/// <summary> Returns false and leaves the event alone if the ring is full. </summary>
+		bool Push(QueuedEvent&& event) {
+			size_t currentTail = tail.load(std::memory_order_relaxed);
+			if (currentTail - head.load(std::memory_order_acquire) == slots.size()) {
+				return false;
+			}
+			slots[currentTail % slots.size()].emplace(std::move(event));
+			tail.store(currentTail + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// <summary> Moves all events queued so far to the end of <paramref name="events"/>. </summary>
+		void PopAll(std::vector<QueuedEvent>& events) {
+			size_t currentHead = head.load(std::memory_order_relaxed);
+			size_t currentTail = tail.load(std::memory_order_acquire);
+			for (; currentHead != currentTail; ++currentHead) {
+				auto& slot = slots[currentHead % slots.size()];
+				events.push_back(std::move(*slot));
+				slot.reset();
+			}
+			head.store(currentHead, std::memory_order_release);
+		}
+
+		/// <summary> True if more than half full, the writer is woken early then. </summary>
+		bool IsFilling() const {
+			return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed) > slots.size() / 2;
+		}
+		bool IsEmpty() const {
+			return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+		}
+
+		std::atomic_bool abandoned = false; // The owner thread has exited.
+	private:
+		std::vector<std::optional<QueuedEvent>> slots;
+		std::atomic_size_t head = 0;
+		std::atomic_size_t tail = 0;
+	};
+
+} // namespace impl
+
+
+namespace {
+
+	std::atomic_uint64_t nodeCounter = 0;
+
+	// Rings the thread has created, by node id, so that finding one takes no lock.
+	struct ThreadRings {
+		~ThreadRings() {
+			for (auto& [nodeId, ring] : rings) {
+				ring->abandoned = true;
+			}
+		}
+		std::vector<std::pair<uint64_t, std::shared_ptr<impl::EventRing>>> rings;
+	};
+
+	thread_local ThreadRings threadRings;
+
+} // namespace
+
+
+LogNode::LogNode() : id(++nodeCounter) {
 	prohibitPipes = false;
 	startTime = std::chrono::high_resolution_clock::now();
 	outputStream = nullptr;
 	pendingEvents = 0;
+	async = false;
+	writerWake = false;
+	flushRequested = false;
+	droppedEvents = 0;
 }
 
 LogNode::~LogNode() {
+	SetAsync(false);
+
 	// this code is probably not necessery since i replaced all shit with shared and weak ptrs
 
 	//prohibitPipes = true;
@@ -44,11 +124,21 @@ LogNode::~LogNode() {
 
 
 void LogNode::Flush() {
+	if (async) {
+		flushRequested = true;
+		writerWake = true;
+		writerSignal.notify_one();
+		return;
+	}
+
 	// Exclude all action by pipes.
 	prohibitPipes = true;
 	mtx.lock();
 	prohibitPipes = false;
 
+	// Events queued while the node was asynchronous are older than any in the pipes.
+	WriteQueuedEvents(false);
+
 	// promote all pipes to shared_ptr
 	std::vector<PipeInfoShared> promotedPipes;
 	bool dirty = false;
@@ -72,6 +162,7 @@ void LogNode::Flush() {
 	// pop events from pipes
 	while (true) {
 		EventBuffer* oldestBuffer = nullptr;
+		LogPipe* oldestPipe = nullptr;
 		std::string* oldestPipeName = nullptr;
 		std::chrono::high_resolution_clock::time_point oldestTimestamp = std::chrono::high_resolution_clock::time_point::max();
 		for (auto& pipeInfo : promotedPipes) {
@@ -80,21 +171,14 @@ void LogNode::Flush() {
 			{
 				oldestTimestamp = pipeInfo.pipe->buffer[0].timestamp;
 				oldestBuffer = &pipeInfo.pipe->buffer;
+				oldestPipe = pipeInfo.pipe.get();
 				oldestPipeName = &pipeInfo.name;
 			}
 		}
 		if (oldestBuffer) {
-			LogEvent& evt = (*oldestBuffer)[0].event;
-
 			// write event to file
 			if (outputStream && outputStream->good()) {
-				*outputStream
-					<< "[" << std::chrono::duration_cast<std::chrono::microseconds>(oldestTimestamp - startTime).count() / 1.e6 << "]"
-					<< "[" << *oldestPipeName << "] "
-					<< evt.GetMessage() << "\n";
-				for (size_t i = 0; i < evt.GetNumParameters(); i++) {
-					*outputStream << "   " << evt[i].name << " = " << evt[i].ToString() << "\n";
-				}
+				WriteEntry(*outputStream, (*oldestBuffer)[0], oldestPipe->id, *oldestPipeName);
 			}
 
 			// pop event
@@ -123,6 +207,242 @@ void LogNode::NotifyNewEvent() {
 }
 
 
+void LogNode::QueueEvent(impl::QueuedEvent&& event) {
+	impl::EventRing& ring = GetThreadRing();
+	if (!ring.Push(std::move(event))) {
+		++droppedEvents;
+	}
+	if (ring.IsFilling() && !writerWake.exchange(true)) {
+		writerSignal.notify_one();
+	}
+}
+
+
+impl::EventRing& LogNode::GetThreadRing() {
+	for (auto& [nodeId, ring] : threadRings.rings) {
+		if (nodeId == id) {
+			return *ring;
+		}
+	}
+
+	// Only the first event of a thread registers its ring.
+	auto ring = std::make_shared<impl::EventRing>(ringCapacity);
+	{
+		std::lock_guard<std::mutex> lk(ringsMtx);
+		rings.push_back(ring);
+	}
+	// Rings of nodes that are gone are of no use.
+	auto& cached = threadRings.rings;
+	cached.erase(std::remove_if(cached.begin(), cached.end(), [](const auto& entry) { return entry.second.use_count() == 1; }), cached.end());
+	cached.push_back({ id, ring });
+	return *ring;
+}
+
+
+void LogNode::WriteQueuedEvents(bool flush) {
+	std::vector<std::shared_ptr<impl::EventRing>> currentRings;
+	{
+		std::lock_guard<std::mutex> lk(ringsMtx);
+		// Rings of exited threads are dropped once their events are written.
+		rings.erase(std::remove_if(rings.begin(), rings.end(), [](const auto& ring) { return ring->abandoned && ring->IsEmpty(); }), rings.end());
+		currentRings = rings;
+	}
+
+	std::vector<impl::QueuedEvent> events;
+	for (auto& ring : currentRings) {
+		ring->PopAll(events);
+	}
+	// Each ring is in order already, so a stable sort keeps the order of events with the same timestamp.
+	std::stable_sort(events.begin(), events.end(), [](const impl::QueuedEvent& lhs, const impl::QueuedEvent& rhs) {
+		return lhs.entry.timestamp < rhs.entry.timestamp;
+	});
+
+	size_t dropped = droppedEvents.exchange(0);
+	if (!outputStream || !outputStream->good() || (events.empty() && dropped == 0)) {
+		return;
+	}
+
+	// Text is formatted in memory first, the stream is written in one go.
+	std::ostringstream text;
+	for (auto& event : events) {
+		WriteEntry(text, event.entry, event.pipeId, *event.pipeName);
+	}
+	WriteDropped(text, dropped);
+	if (!binaryWriter) {
+		std::string buffer = text.str();
+		outputStream->write(buffer.data(), std::streamsize(buffer.size()));
+	}
+	if (flush) {
+		outputStream->flush();
+	}
+}
+
+
+void LogNode::WriterThread() {
+	SetCurrentThreadName("Log Writer Thread");
+
+	bool running = true;
+	while (running) {
+		{
+			// A wake-up that comes between checking and waiting is only late by the interval.
+			std::unique_lock<std::mutex> lk(writerMtx);
+			writerSignal.wait_for(lk, writerInterval, [this] { return writerWake || !async; });
+		}
+		writerWake = false;
+		running = async;
+		bool flush = flushRequested.exchange(false) || !running;
+
+		prohibitPipes = true;
+		mtx.lock();
+		prohibitPipes = false;
+		WriteQueuedEvents(flush);
+		mtx.unlock();
+	}
+}
+
+
+void LogNode::SetAsync(bool async) {
+	std::lock_guard<std::mutex> lk(asyncMtx);
+	if (this->async == async) {
+		return;
+	}
+	if (async) {
+		this->async = true;
+		writer = std::thread(&LogNode::WriterThread, this);
+	}
+	else {
+		{
+			std::lock_guard<std::mutex> writerLk(writerMtx);
+			this->async = false;
+		}
+		writerSignal.notify_one();
+		writer.join();
+	}
+}
+
+
+bool LogNode::IsAsync() const {
+	return async;
+}
+
+
+void LogNode::WriteEntry(std::ostream& textStream, const EventEntry& entry, uint32_t pipeId, const std::string& pipeName) {
+	if (binaryWriter) {
+		WriteBinaryEntry(entry, pipeId, pipeName);
+		return;
+	}
+
+	int64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>(entry.timestamp - startTime).count();
+	if (entry.isRecord) {
+		const std::string* format = LogFormat::Find(entry.record.formatId);
+		impl::WriteTextEvent(textStream, microseconds, pipeName, LogEvent(entry.record.Format(format ? *format : "{}")));
+	}
+	else {
+		impl::WriteTextEvent(textStream, microseconds, pipeName, entry.event);
+	}
+}
+
+
+void LogNode::WriteBinaryEntry(const EventEntry& entry, uint32_t pipeId, const std::string& pipeName) {
+	BinaryStreamWriter& writer = *binaryWriter;
+	try {
+		if (pipeId >= writtenPipes.size() || !writtenPipes[pipeId]) {
+			writtenPipes.resize(std::max(writtenPipes.size(), size_t(pipeId) + 1), false);
+			writtenPipes[pipeId] = true;
+			writer.WriteVarint(uint64_t(impl::eBinaryLogTag::PIPE));
+			writer.WriteVarint(pipeId);
+			writer.WriteString(pipeName);
+		}
+
+		int64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>(entry.timestamp - startTime).count();
+		if (entry.isRecord) {
+			const LogRecord& record = entry.record;
+			if (record.formatId >= writtenFormats.size() || !writtenFormats[record.formatId]) {
+				const std::string* format = LogFormat::Find(record.formatId);
+				writtenFormats.resize(std::max(writtenFormats.size(), size_t(record.formatId) + 1), false);
+				writtenFormats[record.formatId] = true;
+				writer.WriteVarint(uint64_t(impl::eBinaryLogTag::FORMAT));
+				writer.WriteVarint(record.formatId);
+				writer.WriteString(format ? *format : "{}");
+			}
+
+			writer.WriteVarint(uint64_t(impl::eBinaryLogTag::RECORD));
+			writer.WriteVarint(pipeId);
+			writer.WriteVarintSigned(microseconds);
+			writer.WriteVarint(record.formatId);
+			writer.WriteVarint(record.numArguments);
+			size_t offset = 0;
+			for (size_t i = 0; i < record.numArguments; ++i) {
+				writer.WriteVarint(uint64_t(record.types[i]));
+				switch (record.types[i]) {
+					case eLogArgumentType::BOOL: writer.WriteBool(record.data[offset] != 0); offset += 1; break;
+					case eLogArgumentType::INT: {
+						int64_t value;
+						std::memcpy(&value, record.data + offset, sizeof(value));
+						writer.WriteVarintSigned(value);
+						offset += sizeof(value);
+						break;
+					}
+					case eLogArgumentType::UINT: {
+						uint64_t value;
+						std::memcpy(&value, record.data + offset, sizeof(value));
+						writer.WriteVarint(value);
+						offset += sizeof(value);
+						break;
+					}
+					case eLogArgumentType::FLOAT: {
+						double value;
+						std::memcpy(&value, record.data + offset, sizeof(value));
+						writer.WriteDouble(value);
+						offset += sizeof(value);
+						break;
+					}
+					case eLogArgumentType::STRING: {
+						size_t length = record.data[offset];
+						writer.WriteString(std::string_view(reinterpret_cast<const char*>(record.data + offset + 1), length));
+						offset += 1 + length;
+						break;
+					}
+				}
+			}
+		}
+		else {
+			const LogEvent& evt = entry.event;
+			writer.WriteVarint(uint64_t(impl::eBinaryLogTag::EVENT));
+			writer.WriteVarint(pipeId);
+			writer.WriteVarintSigned(microseconds);
+			writer.WriteString(evt.GetMessage());
+			writer.WriteVarint(evt.GetNumParameters());
+			for (size_t i = 0; i < evt.GetNumParameters(); i++) {
+				writer.WriteString(evt[i].name);
+				writer.WriteString(evt[i].ToString());
+			}
+		}
+	}
+	catch (RuntimeException&) {
+		// The stream is bad now, nothing more is written to it.
+	}
+}
+
+
+void LogNode::WriteDropped(std::ostream& textStream, size_t dropped) {
+	if (dropped == 0) {
+		return;
+	}
+	if (binaryWriter) {
+		try {
+			binaryWriter->WriteVarint(uint64_t(impl::eBinaryLogTag::DROPPED));
+			binaryWriter->WriteVarint(dropped);
+		}
+		catch (RuntimeException&) {
+		}
+	}
+	else {
+		textStream << "[" << dropped << " events were dropped, logging threads outpaced the writer.]\n";
+	}
+}
+
+
 void LogNode::AddPipe(std::shared_ptr<LogPipe> pipe, const std::string& name) {
 	// Exclude all action by pipes.
 	// And anyone else for that matter.
@@ -131,17 +451,31 @@ void LogNode::AddPipe(std::shared_ptr<LogPipe> pipe, const std::string& name) {
 	prohibitPipes = false;
 
 	pipes.push_back({ pipe, name });
+	pipe->name = std::make_shared<const std::string>(name);
+	pipe->id = nextPipeId++;
 
 	mtx.unlock();
 }
 
 
-void LogNode::SetOutputStream(std::ostream* outputStream) {
+void LogNode::SetOutputStream(std::ostream* outputStream, eLogFileFormat format) {
 	prohibitPipes = true;
 	mtx.lock();
 	prohibitPipes = false;
 
 	this->outputStream = outputStream;
+	binaryWriter.reset();
+	writtenPipes.clear();
+	writtenFormats.clear();
+	if (outputStream && format == eLogFileFormat::BINARY) {
+		binaryWriter = std::make_unique<BinaryStreamWriter>(*outputStream);
+		try {
+			binaryWriter->WriteBytes(impl::BinaryLogMagic, sizeof(impl::BinaryLogMagic));
+			binaryWriter->WriteVarint(impl::BinaryLogVersion);
+		}
+		catch (RuntimeException&) {
+		}
+	}
 
 	mtx.unlock();
 }
@@ -1,18 +1,45 @@
 #pragma once
 
+#include "BinaryLog.hpp"
+#include "EventEntry.hpp"
+#include "../Serialization/BinaryStream.hpp"
+
 #include <shared_mutex>
 #include <atomic>
 #include <memory>
 #include <vector>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
 
 namespace inl {
 
+class LogPipe;
+
+namespace impl {
+	/// <summary> An event waiting in the ring of a thread. </summary>
+	struct QueuedEvent {
+		EventEntry entry;
+		uint32_t pipeId;
+		std::shared_ptr<const std::string> pipeName;
+	};
+
+	class EventRing;
+}
+
 /// <summary>
 /// The LogNode groups together a list of LogPipes.
 /// Each pipe collects and buffers events, the lognode periodically sorts
 /// and writes these messages to an output stream.
 /// </summary>
+/// <remarks>
+/// In asynchronous mode, each thread queues its events into its own lock-free ring,
+/// and a writer thread merges the rings by timestamp and writes them to the stream.
+/// Logging threads never wait for the writer, the events of a full ring are dropped and counted.
+/// </remarks>
 class LogNode {
 	friend class LogPipe;
 private:
@@ -29,16 +56,36 @@ public:
 	~LogNode();
 
 	/// <summary> Force writing all pending events to disk. </summary>
+	/// <remarks> In asynchronous mode, this only wakes the writer thread and returns. </remarks>
 	void Flush();
 
+	/// <summary> Starts or stops the writer thread of asynchronous mode. </summary>
+	/// <remarks> Stopping waits until the writer has written all the queued events. </remarks>
+	void SetAsync(bool async);
+	/// <summary> True if events are written by the writer thread. </summary>
+	bool IsAsync() const;
+
 	/// <summar> Create a pipe connected to *this. </summary>
 	void AddPipe(std::shared_ptr<LogPipe> pipe, const std::string& name);
 
 	/// <summary> Specify output stream. </summary>
-	void SetOutputStream(std::ostream* outputStream);
+	/// <param name="format"> Binary streams must be opened in binary mode. </param>
+	void SetOutputStream(std::ostream* outputStream, eLogFileFormat format = eLogFileFormat::TEXT);
 private:
 	/// <summary> Call this from Pipe whenever a new message is buffered. </summary>
 	void NotifyNewEvent();
+	/// <summary> Call this from Pipe in asynchronous mode instead of buffering the event. </summary>
+	void QueueEvent(impl::QueuedEvent&& event);
+
+	/// <summary> Ring of the calling thread, created on its first event. </summary>
+	impl::EventRing& GetThreadRing();
+	/// <summary> Writes the events queued in the rings to the output. mtx must be locked exclusively. </summary>
+	void WriteQueuedEvents(bool flush);
+	void WriterThread();
+	/// <summary> Writes an entry in the format of the output, text goes to <paramref name="textStream"/>. </summary>
+	void WriteEntry(std::ostream& textStream, const EventEntry& entry, uint32_t pipeId, const std::string& pipeName);
+	void WriteBinaryEntry(const EventEntry& entry, uint32_t pipeId, const std::string& pipeName);
+	void WriteDropped(std::ostream& textStream, size_t dropped);
 	
 	std::vector<PipeInfo> pipes; /// <summary> List of associated pipes. </summary>	
 	std::shared_timed_mutex mtx; /// <summary> Synchronize pipes with node. Node uses exclusive, pipes use shared mode. </summary>
@@ -46,9 +93,28 @@ private:
 	std::atomic_ptrdiff_t pendingEvents; /// <summary> Number of pending events. </summary>
 
 	std::ostream* outputStream;
+	std::unique_ptr<BinaryStreamWriter> binaryWriter; /// <summary> Writes the output stream if it's binary. </summary>
+	std::vector<bool> writtenPipes; /// <summary> Pipe ids already introduced in the binary output. </summary>
+	std::vector<bool> writtenFormats; /// <summary> Format ids already introduced in the binary output. </summary>
+	uint32_t nextPipeId = 0;
 	std::chrono::high_resolution_clock::time_point startTime; /// <summary> When the logging started. </summary>
 
 	static constexpr ptrdiff_t flushThreshold = 1000; /// <summary> Auto-flush if pending more than this. </summary>
+
+	const uint64_t id; /// <summary> Unique among all nodes, identifies the rings of threads. </summary>
+	std::vector<std::shared_ptr<impl::EventRing>> rings; /// <summary> Rings of the threads that logged in asynchronous mode. </summary>
+	std::mutex ringsMtx; /// <summary> Protects the list of rings, not their contents. </summary>
+	std::atomic_bool async; /// <summary> True while the writer thread runs. </summary>
+	std::atomic_bool writerWake; /// <summary> Set to have the writer write before its interval is over. </summary>
+	std::atomic_bool flushRequested; /// <summary> Set to have the writer flush the stream too. </summary>
+	std::atomic_size_t droppedEvents; /// <summary> Events dropped because a ring was full, reported by the writer. </summary>
+	std::thread writer;
+	std::mutex writerMtx; /// <summary> Only for waiting on writerSignal. </summary>
+	std::condition_variable writerSignal;
+	std::mutex asyncMtx; /// <summary> Serializes switching modes. </summary>
+
+	static constexpr size_t ringCapacity = 4096; /// <summary> Events a thread may queue before the writer catches up. </summary>
+	static constexpr std::chrono::milliseconds writerInterval{ 100 }; /// <summary> How often the writer looks for events without being woken. </summary>
 };
 
 
@@ -18,6 +18,11 @@ void LogPipe::PutEvent(const LogEvent& evt) {
 		return;
 	}
 
+	if (node->IsAsync()) {
+		node->QueueEvent({ { std::chrono::high_resolution_clock::now(), evt }, id, name });
+		return;
+	}
+
 	// Spin until we're allowed to even try to lock.
 	// This is to avoid starvation of LogNode.
 	while (node->prohibitPipes) {
@@ -42,6 +47,11 @@ void LogPipe::PutEvent(LogEvent&& evt) {
 		return;
 	}
 
+	if (node->IsAsync()) {
+		node->QueueEvent({ { std::chrono::high_resolution_clock::now(), std::move(evt) }, id, name });
+		return;
+	}
+
 	// Spin until we're allowed to even try to lock.
 	// This is to avoid starvation of LogNode.
 	while (node->prohibitPipes) {
@@ -62,6 +72,37 @@ void LogPipe::PutEvent(LogEvent&& evt) {
 }
 
 
+void LogPipe::PutRecord(const LogRecord& record) {
+	if (!node) {
+		return;
+	}
+
+	EventEntry entry;
+	entry.timestamp = std::chrono::high_resolution_clock::now();
+	entry.isRecord = true;
+	entry.record = record;
+
+	if (node->IsAsync()) {
+		node->QueueEvent({ std::move(entry), id, name });
+		return;
+	}
+
+	while (node->prohibitPipes) {
+		std::this_thread::yield();
+	}
+
+	node->mtx.lock_shared();
+	pipeLock.lock();
+
+	buffer.push_back(std::move(entry));
+
+	pipeLock.unlock();
+	node->mtx.unlock_shared();
+
+	node->NotifyNewEvent();
+}
+
+
 std::shared_ptr<LogNode> LogPipe::GetNode() {
 	return node;
 }
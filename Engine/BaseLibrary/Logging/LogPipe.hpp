@@ -4,6 +4,7 @@
 
 #include <mutex>
 #include <memory>
+#include <string>
 
 
 namespace inl {
@@ -26,6 +27,8 @@ public:
 	void PutEvent(const LogEvent& evt);
 	/// <summary> Add a new event for logging. </summary>
 	void PutEvent(LogEvent&& evt);
+	/// <summary> Add a new event for logging, its message is formatted when written. </summary>
+	void PutRecord(const LogRecord& record);
 
 	/// <summary> Get attached log node. </summary>
 	std::shared_ptr<LogNode> GetNode();
@@ -33,6 +36,8 @@ private:
 	EventBuffer buffer; /// <sumary> Temporary buffer for events, so less disk writes. </summary>
 	std::shared_ptr<LogNode> node; /// <summary> Which node *this belongs to. </summary>
 	std::mutex pipeLock; /// <summary> Prevent concurrent access to this pipe instance. </summary>
+	std::shared_ptr<const std::string> name; /// <summary> Queued events keep it, they may be written after the pipe is gone. </summary>
+	uint32_t id = 0; /// <summary> Identifies the pipe in binary logs. </summary>
 };
 
 
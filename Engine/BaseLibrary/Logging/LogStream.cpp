@@ -20,6 +20,7 @@ LogStream::LogStream() {
 LogStream::LogStream(LogStream&& rhs) {
 	pipe = rhs.pipe;
 	rhs.pipe.reset();
+	minimumLevel = rhs.GetMinimumLevel();
 }
 
 LogStream::~LogStream() {
@@ -35,6 +36,7 @@ LogStream& LogStream::operator=(LogStream&& rhs) {
 
 	pipe = rhs.pipe;
 	rhs.pipe.reset();
+	minimumLevel = rhs.GetMinimumLevel();
 
 	return *this;
 }
@@ -58,6 +60,22 @@ void LogStream::Event(inl::LogEvent&& e, eEventDisplayMode displayMode) {
 	//std::cout << "Event(&&): " << (end - start) << " cycles\n";
 }
 
+void LogStream::Event(eLogLevel level, const inl::LogEvent& e) {
+	if (IsEnabled(level)) {
+		pipe->PutEvent(e);
+	}
+}
+
+void LogStream::Event(eLogLevel level, inl::LogEvent&& e) {
+	if (IsEnabled(level)) {
+		pipe->PutEvent(std::move(e));
+	}
+}
+
+void LogStream::Record(const LogRecord& record) {
+	pipe->PutRecord(record);
+}
+
 
 
 } // namespace inl
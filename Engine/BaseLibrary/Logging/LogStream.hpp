@@ -2,7 +2,9 @@
 
 #include "Event.hpp"
 #include "EventEntry.hpp"
+#include "LogFormat.hpp"
 
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <chrono>
@@ -25,6 +27,42 @@ enum class eEventDisplayMode {
 	STDERR,
 };
 
+/// <summary> Severity of events, streams drop the events below their minimum. </summary>
+enum class eLogLevel {
+	VERBOSE,
+	DEBUG,
+	INFO,
+	WARNING,
+	ERROR,
+	/// <summary> As a minimum, drops all events. </summary>
+	OFF,
+};
+
+
+/// <summary> Sites of <see cref="INL_LOG"/> below this level are not compiled at all. </summary>
+/// <remarks> Define it for the build to override, release builds drop verbose and debug events by default. </remarks>
+#ifndef INL_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define INL_LOG_MIN_LEVEL ::inl::eLogLevel::INFO
+#else
+#define INL_LOG_MIN_LEVEL ::inl::eLogLevel::VERBOSE
+#endif
+#endif
+
+
+/// <summary> Logs an event of the level through the stream. The event and its arguments are only evaluated
+///		if the level passes both <see cref="INL_LOG_MIN_LEVEL"/> and the minimum of the stream. </summary>
+/// <remarks> Usage: INL_LOG(stream, eLogLevel::DEBUG, format, args...) or INL_LOG(stream, eLogLevel::INFO, LogEvent(...)). </remarks>
+#define INL_LOG(stream, level, ...)                \
+	do {                                           \
+		if constexpr ((level) >= INL_LOG_MIN_LEVEL) { \
+			if ((stream).IsEnabled(level)) {         \
+				(stream).Event((level), __VA_ARGS__);  \
+			}                                        \
+		}                                          \
+	} while (false)
+
+
 /// <summary> 
 /// Used to create individual stream that all belong to a Logger.
 /// Each stream is independent, but events are logged into the same file.
@@ -52,11 +90,56 @@ public:
 	/// <param name="displayMode"> Optionally display event immediatly to stdout or stderr. 
 	///		Event is still logged. </param>
 	void Event(inl::LogEvent&& e, eEventDisplayMode displayMode = eEventDisplayMode::DONT_DISPLAY);
+
+	/// <summary> Log an event if the level is not below the minimum of the stream. </summary>
+	void Event(eLogLevel level, const inl::LogEvent& e);
+	/// <summary> Log an event if the level is not below the minimum of the stream. </summary>
+	void Event(eLogLevel level, inl::LogEvent&& e);
+	/// <summary> Log a formatted event if the level is not below the minimum of the stream. </summary>
+	/// <remarks> The arguments are not packed if the event is dropped, see the overload without level. </remarks>
+	template <class... Args>
+	void Event(eLogLevel level, const LogFormat& format, const Args&... args);
+
+	/// <summary> Events below this level are dropped, the default lets all of them through. </summary>
+	/// <remarks> Thread safe, other threads see the change with their next event. </remarks>
+	void SetMinimumLevel(eLogLevel level) { minimumLevel.store(level, std::memory_order_relaxed); }
+	eLogLevel GetMinimumLevel() const { return minimumLevel.load(std::memory_order_relaxed); }
+	/// <summary> True if events of the level are logged, check it before building expensive events. </summary>
+	bool IsEnabled(eLogLevel level) const { return pipe && level >= minimumLevel.load(std::memory_order_relaxed); }
+
+	/// <summary> Log an event whose message is only formatted when it's written, or never in binary logs. </summary>
+	/// <remarks> The arguments are copied into a fixed size record, in asynchronous mode this neither locks nor allocates.
+	///		Use it for frequent diagnostics, with a static format:
+	///		<code> static const LogFormat format("Frame {} took {} ms"); stream.Event(format, frame, ms); </code></remarks>
+	template <class... Args>
+	void Event(const LogFormat& format, const Args&... args);
+private:
+	void Record(const LogRecord& record);
 private:
 	std::shared_ptr<LogPipe> pipe; // log goes through this pipe
+	std::atomic<eLogLevel> minimumLevel = eLogLevel::VERBOSE;
 };
 
 
+template <class... Args>
+void LogStream::Event(eLogLevel level, const LogFormat& format, const Args&... args) {
+	if (IsEnabled(level)) {
+		Event(format, args...);
+	}
+}
+
+
+template <class... Args>
+void LogStream::Event(const LogFormat& format, const Args&... args) {
+	if (pipe) {
+		LogRecord record;
+		record.formatId = format.GetId();
+		record.Pack(args...);
+		Record(record);
+	}
+}
+
+
 /// <summary> Just a little helper to expose only the ctor to Logger, not the whole class. </summary>
 class LoggerInterface {
 	friend class Logger;
@@ -14,11 +14,14 @@ Logger::Logger() {
 }
 
 Logger::~Logger() {
-
+	// Streams may keep the node alive, the writer must be done with the file before it closes.
+	myNode->SetAsync(false);
+	myNode->SetOutputStream(nullptr);
 }
 
-bool Logger::OpenFile(const std::string& path) {
-	std::ofstream newStream(path, std::ios::out | std::ios::trunc);
+bool Logger::OpenFile(const std::string& path, eLogFileFormat format) {
+	auto mode = std::ios::out | std::ios::trunc | (format == eLogFileFormat::BINARY ? std::ios::binary : std::ios::openmode(0));
+	std::ofstream newStream(path, mode);
 	if (!newStream.is_open()) {
 		myNode->SetOutputStream(nullptr);
 		return false;
@@ -27,13 +30,13 @@ bool Logger::OpenFile(const std::string& path) {
 		myNode->SetOutputStream(nullptr);
 		outputFile->close();
 		*outputFile = std::move(newStream);
-		myNode->SetOutputStream(outputFile.get());
+		myNode->SetOutputStream(outputFile.get(), format);
 		return true;
 	}
 }
 
-void Logger::OpenStream(std::ostream* stream) {
-	myNode->SetOutputStream(stream);
+void Logger::OpenStream(std::ostream* stream, eLogFileFormat format) {
+	myNode->SetOutputStream(stream, format);
 	outputFile->close();
 }
 
@@ -52,6 +55,10 @@ void Logger::Flush() {
 	myNode->Flush();
 }
 
+void Logger::SetAsync(bool async) {
+	myNode->SetAsync(async);
+}
+
 
 
 
@@ -24,10 +24,12 @@ public:
 	~Logger();
 
 	/// <summary> Open a log file for output. </summary>
-	bool OpenFile(const std::string& path);
+	/// <param name="format"> Binary logs are turned into text by <see cref="DecodeBinaryLog"/>. </param>
+	bool OpenFile(const std::string& path, eLogFileFormat format = eLogFileFormat::TEXT);
 
 	/// <summary> Use an already opened output stream. </summary>
-	void OpenStream(std::ostream* stream);
+	/// <param name="format"> Binary streams must be opened in binary mode. </param>
+	void OpenStream(std::ostream* stream, eLogFileFormat format = eLogFileFormat::TEXT);
 
 	/// <summary> Stop logging to output stream, close file, if any. </summary>
 	void CloseStream();
@@ -36,7 +38,12 @@ public:
 	LogStream CreateLogStream(const std::string& name);
 
 	/// <summary> Write all pending events to log file immediately. </summary>
+	/// <remarks> In asynchronous mode, the writer thread is only told to write them. </remarks>
 	void Flush();
+
+	/// <summary> In asynchronous mode, events are written by a background thread, logging and flushing never wait for disk writes. </summary>
+	/// <remarks> Turning it off waits until the queued events are written. </remarks>
+	void SetAsync(bool async);
 private:
 	// do not ever flip the order of the two below!
 	// myNode must be destroyed first because it's using outputFile
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "Logging/BinaryLog.hpp"
 #include "Logging/Event.hpp"
+#include "Logging/LogFormat.hpp"
 #include "Logging/Logger.hpp"
 #include "Logging/LogStream.hpp"
 #include "Logging/LogCentre.hpp"
\ No newline at end of file
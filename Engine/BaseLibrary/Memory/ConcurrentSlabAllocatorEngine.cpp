@@ -0,0 +1,218 @@
+#include "ConcurrentSlabAllocatorEngine.hpp"
+#include "../BitOperations.hpp"
+
+#include <cassert>
+#include <algorithm>
+#include <new>
+
+
+namespace inl {
+
+
+ConcurrentSlabAllocatorEngine::ConcurrentSlabAllocatorEngine()
+	: m_head(MakeHead(InvalidBlock, 0)), m_poolSize(0), m_numBlocks(0)
+{
+	for (auto& ptr : m_segmentPtrs) {
+		ptr = nullptr;
+	}
+}
+
+
+ConcurrentSlabAllocatorEngine::ConcurrentSlabAllocatorEngine(size_t poolSize)
+	: ConcurrentSlabAllocatorEngine()
+{
+	Grow(poolSize);
+}
+
+
+ConcurrentSlabAllocatorEngine::ConcurrentSlabAllocatorEngine(ConcurrentSlabAllocatorEngine&& rhs) noexcept
+	: ConcurrentSlabAllocatorEngine()
+{
+	*this = std::move(rhs);
+}
+
+
+ConcurrentSlabAllocatorEngine& ConcurrentSlabAllocatorEngine::operator=(ConcurrentSlabAllocatorEngine&& rhs) noexcept {
+	for (unsigned segment = 0; segment < MaxSegments; ++segment) {
+		m_segments[segment] = std::move(rhs.m_segments[segment]);
+		m_segmentPtrs[segment] = rhs.m_segmentPtrs[segment].exchange(nullptr);
+	}
+	m_head = rhs.m_head.exchange(MakeHead(InvalidBlock, 0));
+	m_poolSize = rhs.m_poolSize.exchange(0);
+	m_numBlocks = rhs.m_numBlocks;
+	rhs.m_numBlocks = 0;
+	return *this;
+}
+
+
+size_t ConcurrentSlabAllocatorEngine::Allocate() {
+	size_t index;
+	if (!TryAllocate(index)) {
+		throw std::bad_alloc();
+	}
+	return index;
+}
+
+
+bool ConcurrentSlabAllocatorEngine::TryAllocate(size_t& index) {
+	return TryAllocate(&index, 1) == 1;
+}
+
+
+size_t ConcurrentSlabAllocatorEngine::TryAllocate(size_t* indices, size_t count) {
+	size_t numAllocated = 0;
+	uint64_t head = m_head.load(std::memory_order_acquire);
+	while (numAllocated < count && HeadIndex(head) != InvalidBlock) {
+		uint32_t blockIndex = HeadIndex(head);
+		Block& block = BlockAt(blockIndex);
+
+		// Try to grab as many of the free slots of the first block as needed.
+		uint64_t mask = block.slotOccupancy.load(std::memory_order_relaxed);
+		while (mask != ~uint64_t(0)) {
+			uint64_t freeSlots = ~mask;
+			uint64_t takenSlots = 0;
+			for (size_t i = numAllocated; i < count && freeSlots != 0; ++i) {
+				takenSlots |= freeSlots & (~freeSlots + 1);
+				freeSlots &= freeSlots - 1;
+			}
+			if (block.slotOccupancy.compare_exchange_weak(mask, mask | takenSlots, std::memory_order_acquire)) {
+				for (; takenSlots != 0; takenSlots &= takenSlots - 1) {
+					indices[numAllocated++] = size_t(blockIndex) * SlotsPerBlock + CountTrailingZeros(takenSlots);
+				}
+				break;
+			}
+		}
+		if (numAllocated == count) {
+			return numAllocated;
+		}
+
+		// The block is full, pop it from the free-list.
+		uint64_t next = MakeHead(block.nextBlockIndex.load(), HeadTag(head) + 1);
+		if (m_head.compare_exchange_weak(head, next)) {
+			block.inFreeList = false;
+			// Slots freed while the block was still in the list did not push it back, so check again.
+			if (block.slotOccupancy.load() != ~uint64_t(0) && !block.inFreeList.exchange(true)) {
+				PushFree(blockIndex);
+			}
+			head = m_head.load(std::memory_order_acquire);
+		}
+	}
+	return numAllocated;
+}
+
+
+void ConcurrentSlabAllocatorEngine::Deallocate(size_t index) {
+	uint32_t blockIndex = uint32_t(index / SlotsPerBlock);
+	unsigned slot = unsigned(index - size_t(blockIndex) * SlotsPerBlock);
+	assert(blockIndex < m_numBlocks);
+
+	uint64_t slotMask = uint64_t(1) << slot;
+	uint64_t prevMask = BlockAt(blockIndex).slotOccupancy.fetch_and(~slotMask, std::memory_order_release);
+	assert(prevMask & slotMask); // Double free.
+	OnSlotsFreed(blockIndex, prevMask);
+}
+
+
+void ConcurrentSlabAllocatorEngine::Grow(size_t newPoolSize) {
+	std::lock_guard<std::mutex> lkg(m_growMtx);
+
+	size_t oldPoolSize = m_poolSize.load();
+	if (newPoolSize <= oldPoolSize) {
+		return;
+	}
+	uint32_t newNumBlocks = uint32_t((newPoolSize + SlotsPerBlock - 1) / SlotsPerBlock);
+
+	// Unlock the padding slots of the old last block.
+	unsigned oldLastSlots = unsigned(oldPoolSize % SlotsPerBlock);
+	if (oldLastSlots != 0) {
+		uint32_t lastBlock = m_numBlocks - 1;
+		size_t newLastSlots = std::min(size_t(SlotsPerBlock), newPoolSize - size_t(lastBlock) * SlotsPerBlock);
+		uint64_t validMask = newLastSlots == SlotsPerBlock ? ~uint64_t(0) : ~(~uint64_t(0) << newLastSlots);
+		uint64_t freedMask = validMask & (~uint64_t(0) << oldLastSlots);
+		uint64_t prevMask = BlockAt(lastBlock).slotOccupancy.fetch_and(~freedMask);
+		OnSlotsFreed(lastBlock, prevMask);
+	}
+
+	// Add new blocks.
+	for (uint32_t blockIndex = m_numBlocks; blockIndex < newNumBlocks; ++blockIndex) {
+		unsigned segment;
+		uint32_t inSegmentIndex;
+		SegmentOf(blockIndex, segment, inSegmentIndex);
+		if (!m_segments[segment]) {
+			uint32_t segmentSize = SegmentSize(segment);
+			m_segments[segment] = std::make_unique<Block[]>(segmentSize);
+			for (uint32_t i = 0; i < segmentSize; ++i) {
+				m_segments[segment][i].slotOccupancy = ~uint64_t(0);
+				m_segments[segment][i].nextBlockIndex = InvalidBlock;
+				m_segments[segment][i].inFreeList = false;
+			}
+			m_segmentPtrs[segment].store(m_segments[segment].get(), std::memory_order_release);
+		}
+
+		size_t numSlots = std::min(size_t(SlotsPerBlock), newPoolSize - size_t(blockIndex) * SlotsPerBlock);
+		Block& block = m_segments[segment][inSegmentIndex];
+		block.slotOccupancy = numSlots == SlotsPerBlock ? 0 : (~uint64_t(0) << numSlots);
+		block.inFreeList = true;
+		PushFree(blockIndex);
+	}
+
+	m_numBlocks = std::max(m_numBlocks, newNumBlocks);
+	m_poolSize = newPoolSize;
+}
+
+
+void ConcurrentSlabAllocatorEngine::Reset() {
+	m_head = MakeHead(InvalidBlock, 0);
+	size_t poolSize = m_poolSize.load();
+	for (uint32_t blockIndex = 0; blockIndex < m_numBlocks; ++blockIndex) {
+		size_t numSlots = std::min(size_t(SlotsPerBlock), poolSize - size_t(blockIndex) * SlotsPerBlock);
+		Block& block = BlockAt(blockIndex);
+		block.slotOccupancy = numSlots == SlotsPerBlock ? 0 : (~uint64_t(0) << numSlots);
+		block.inFreeList = true;
+	}
+	// Push in reverse so that allocation starts at the beginning of the pool.
+	for (uint32_t blockIndex = m_numBlocks; blockIndex > 0; --blockIndex) {
+		PushFree(blockIndex - 1);
+	}
+}
+
+
+auto ConcurrentSlabAllocatorEngine::BlockAt(uint32_t blockIndex) const -> Block& {
+	unsigned segment;
+	uint32_t inSegmentIndex;
+	SegmentOf(blockIndex, segment, inSegmentIndex);
+	Block* blocks = m_segmentPtrs[segment].load(std::memory_order_acquire);
+	assert(blocks != nullptr);
+	return blocks[inSegmentIndex];
+}
+
+
+void ConcurrentSlabAllocatorEngine::SegmentOf(uint32_t blockIndex, unsigned& segment, uint32_t& inSegmentIndex) {
+	// Segment N holds blocks [2^N - 1, 2^(N+1) - 1).
+	uint32_t biased = blockIndex + 1;
+	segment = unsigned(31 - CountLeadingZeros(biased));
+	inSegmentIndex = biased - SegmentSize(segment);
+}
+
+
+void ConcurrentSlabAllocatorEngine::PushFree(uint32_t blockIndex) {
+	Block& block = BlockAt(blockIndex);
+	uint64_t head = m_head.load(std::memory_order_relaxed);
+	do {
+		block.nextBlockIndex = HeadIndex(head);
+	} while (!m_head.compare_exchange_weak(head, MakeHead(blockIndex, HeadTag(head) + 1), std::memory_order_release, std::memory_order_relaxed));
+}
+
+
+void ConcurrentSlabAllocatorEngine::OnSlotsFreed(uint32_t blockIndex, uint64_t prevMask) {
+	// Only full blocks can be missing from the free-list.
+	if (prevMask == ~uint64_t(0)) {
+		Block& block = BlockAt(blockIndex);
+		if (!block.inFreeList.exchange(true)) {
+			PushFree(blockIndex);
+		}
+	}
+}
+
+
+} // namespace inl
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+
+namespace inl {
+
+
+/// <summary>
+/// Thread safe counterpart of <see cref="SlabAllocatorEngine"/>.
+/// Allocate and Deallocate are lock-free, and the pool can grow while
+/// other threads are allocating from the existing slots.
+/// The pool cannot shrink.
+/// </summary>
+class ConcurrentSlabAllocatorEngine {
+	// How it works:
+	// Slots are grouped into blocks of 64, each having an atomic occupancy bit mask.
+	// Blocks live in segments of doubling size that are never moved or freed while
+	// the engine lives, so growing only has to publish a new segment.
+	// Blocks that may contain free slots are linked into a lock-free stack. The head
+	// is tagged with a counter to avoid ABA. Full blocks are popped lazily by allocators,
+	// and the deallocation that makes a full block non-full pushes it back.
+private:
+	struct Block {
+		std::atomic_uint64_t slotOccupancy; /// <summary> 0 means the slot if free, 1 is occupied. </summary>
+		std::atomic_uint32_t nextBlockIndex; /// <summary> Index of the next block in the free-list. </summary>
+		std::atomic_bool inFreeList;
+	};
+	static constexpr unsigned SlotsPerBlock = 64;
+	static constexpr unsigned MaxSegments = 32;
+	static constexpr uint32_t InvalidBlock = ~uint32_t(0);
+public:
+	ConcurrentSlabAllocatorEngine();
+	ConcurrentSlabAllocatorEngine(size_t poolSize);
+	ConcurrentSlabAllocatorEngine(const ConcurrentSlabAllocatorEngine&) = delete;
+	ConcurrentSlabAllocatorEngine& operator=(const ConcurrentSlabAllocatorEngine&) = delete;
+	/// <remarks> Moving is not thread safe. </remarks>
+	ConcurrentSlabAllocatorEngine(ConcurrentSlabAllocatorEngine&& rhs) noexcept;
+	ConcurrentSlabAllocatorEngine& operator=(ConcurrentSlabAllocatorEngine&& rhs) noexcept;
+
+	/// <summary> Allocates space from the pool for one item. </summary>
+	/// <returns> The index of the allocated slot. </returns>
+	/// <exception cref="std::bad_alloc"> Thrown if pool is full. </exception>
+	size_t Allocate();
+
+	/// <summary> Allocates space from the pool for one item. </summary>
+	/// <returns> False if the pool is full. </returns>
+	bool TryAllocate(size_t& index);
+
+	/// <summary> Allocates space for up to <paramref name="count"/> items, taking many slots of a block at once. </summary>
+	/// <param name="indices"> Receives the indices of the allocated slots, they are not necessarily consecutive. </param>
+	/// <returns> The number of slots allocated, less than <paramref name="count"/> if the pool got full. </returns>
+	size_t TryAllocate(size_t* indices, size_t count);
+
+	/// <summary> Deallocated the slot specified by the index. </summary>
+	void Deallocate(size_t index);
+
+	/// <summary> Grows the pool to at least the given number of slots. </summary>
+	/// <remarks> Does nothing if the pool is already large enough, so threads racing
+	///		to grow the pool after a failed allocation won't over-allocate.
+	///		Concurrent growths are serialized, allocations are not blocked. </remarks>
+	void Grow(size_t newPoolSize);
+
+	/// <summary> Clears all slots, does not affect pool size. </summary>
+	/// <remarks> Not thread safe, no other thread may use the engine meanwhile. </remarks>
+	void Reset();
+
+	/// <summary> Get the total number of slots (free + taken). </summary>
+	size_t Size() const { return m_poolSize.load(); }
+private:
+	Block& BlockAt(uint32_t blockIndex) const;
+	static void SegmentOf(uint32_t blockIndex, unsigned& segment, uint32_t& inSegmentIndex);
+	static uint32_t SegmentSize(unsigned segment) { return uint32_t(1) << segment; }
+
+	void PushFree(uint32_t blockIndex);
+	void OnSlotsFreed(uint32_t blockIndex, uint64_t prevMask);
+
+	static uint64_t MakeHead(uint32_t blockIndex, uint32_t tag) { return (uint64_t(tag) << 32) | blockIndex; }
+	static uint32_t HeadIndex(uint64_t head) { return uint32_t(head); }
+	static uint32_t HeadTag(uint64_t head) { return uint32_t(head >> 32); }
+private:
+	std::unique_ptr<Block[]> m_segments[MaxSegments];
+	std::atomic<Block*> m_segmentPtrs[MaxSegments];
+	std::atomic_uint64_t m_head;
+	std::atomic_size_t m_poolSize;
+	uint32_t m_numBlocks;
+	std::mutex m_growMtx;
+};
+
+
+} // namespace inl
@@ -0,0 +1,83 @@
+#include "FifoRingAllocationEngine.hpp"
+
+#include "../Exception/Exception.hpp"
+
+#include <new>
+
+
+namespace inl {
+
+
+FifoRingAllocationEngine::FifoRingAllocationEngine(size_t poolSize)
+	: m_poolSize(poolSize)
+{}
+
+
+size_t FifoRingAllocationEngine::Allocate(size_t allocationSize) {
+	if (allocationSize == 0) {
+		throw InvalidArgumentException("Allocation size should be non-zero.");
+	}
+	if (allocationSize > m_poolSize) {
+		throw std::bad_alloc();
+	}
+
+	// Start over at the beginning if the range would run over the end of the pool,
+	// the skipped slots are accounted to this allocation.
+	size_t index = m_head;
+	size_t skipped = 0;
+	if (index + allocationSize > m_poolSize) {
+		skipped = m_poolSize - index;
+		index = 0;
+	}
+
+	size_t span = allocationSize + skipped;
+	if (m_used + span > m_poolSize) {
+		throw std::bad_alloc();
+	}
+
+	m_allocations.push_back({ index, span });
+	m_used += span;
+	m_head = (index + allocationSize) % m_poolSize;
+	return index;
+}
+
+
+void FifoRingAllocationEngine::Deallocate(size_t index) {
+	if (m_allocations.empty() || m_allocations.front().index != index) {
+		throw InvalidArgumentException("Ring allocations must be freed in the order they were made.");
+	}
+	DeallocateOldest();
+}
+
+
+void FifoRingAllocationEngine::DeallocateOldest() {
+	if (m_allocations.empty()) {
+		throw InvalidCallException("Nothing is allocated.");
+	}
+	m_used -= m_allocations.front().span;
+	m_allocations.pop_front();
+
+	// When empty, restart at the beginning to keep the largest possible contiguous range.
+	if (m_allocations.empty()) {
+		m_head = 0;
+	}
+}
+
+
+void FifoRingAllocationEngine::Resize(size_t newPoolSize) {
+	if (!m_allocations.empty()) {
+		throw InvalidCallException("Cannot resize while ranges are allocated.");
+	}
+	m_poolSize = newPoolSize;
+	m_head = 0;
+}
+
+
+void FifoRingAllocationEngine::Reset() {
+	m_allocations.clear();
+	m_used = 0;
+	m_head = 0;
+}
+
+
+} // namespace inl
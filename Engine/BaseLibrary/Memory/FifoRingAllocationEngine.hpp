@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+
+
+namespace inl {
+
+
+/// <summary>
+/// Ring allocator for allocations that are freed in the order they were made,
+/// such as per-frame GPU scratch memory.
+///
+/// Allocation and deallocation are O(1): the engine only keeps a head and a tail
+/// offset plus a small queue of outstanding allocation sizes. Use
+/// <see cref="RingAllocationEngine"/> if allocations can be freed out of order.
+///
+/// This class will not allocate the actual objects, it only
+/// administrates the object positions and sizes.
+/// </summary>
+class FifoRingAllocationEngine {
+	struct Allocation {
+		size_t index;
+		size_t span; // Size plus the slots skipped at the end of the pool when wrapping around.
+	};
+public:
+	/// <summary>
+	/// Initialize an allocator of specified size.
+	/// </summary>
+	/// <param name="poolSize">The number of available slots in the pool.</param>
+	FifoRingAllocationEngine(size_t poolSize);
+
+	/// <summary> Allocates a contiguous range from the pool. </summary>
+	/// <param name="allocationSize"> The size of the range that should be allocated. </param>
+	/// <returns> The starting index of the allocated range. </returns>
+	/// <remarks> Ranges never wrap around the end of the pool. </remarks>
+	/// <exception cref="std::bad_alloc"> Thrown if allocation does not fit.</exception>
+	/// <exception cref="InvalidArgumentException"> If allocation size is zero. </exception>
+	size_t Allocate(size_t allocationSize = 1);
+
+	/// <summary> Deallocates the oldest allocation, which must start at index. </summary>
+	/// <exception cref="InvalidArgumentException"> Thrown if index is not the oldest allocation. </exception>
+	void Deallocate(size_t index);
+
+	/// <summary> Deallocates the oldest allocation. </summary>
+	/// <exception cref="InvalidCallException"> Thrown if there are no allocations. </exception>
+	void DeallocateOldest();
+
+	/// <summary> Resizes the pool. Only allowed when nothing is allocated. </summary>
+	/// <exception cref="InvalidCallException"> Thrown if there are live allocations. </exception>
+	void Resize(size_t newPoolSize);
+
+	/// <summary>
+	/// Clears all slots, does not affect pool size.
+	/// Next allocation will be placed at the begginning.
+	/// </summary>
+	void Reset();
+
+	size_t Size() const { return m_poolSize; }
+	size_t Used() const { return m_used; }
+	size_t NumAllocations() const { return m_allocations.size(); }
+
+private:
+	size_t m_poolSize;
+	size_t m_head = 0;
+	size_t m_used = 0;
+	std::deque<Allocation> m_allocations;
+};
+
+
+} // namespace inl
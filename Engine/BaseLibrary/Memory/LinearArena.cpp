@@ -0,0 +1,79 @@
+#include "LinearArena.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+
+namespace inl {
+
+
+LinearArena::LinearArena(size_t initialSize) {
+	m_chunks.push_back(std::make_unique<Chunk>(std::max(size_t(1), initialSize)));
+	m_current = m_chunks.back().get();
+}
+
+
+void* LinearArena::Allocate(size_t size, size_t alignment) {
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+	// Reserving the worst case padding up front lets a single fetch_add claim the range.
+	const size_t reserved = size + alignment - 1;
+
+	Chunk* chunk = m_current.load(std::memory_order_acquire);
+	do {
+		size_t offset = chunk->offset.fetch_add(reserved, std::memory_order_relaxed);
+		if (offset + reserved <= chunk->size) {
+			uintptr_t address = reinterpret_cast<uintptr_t>(chunk->memory.get()) + offset;
+			address = (address + alignment - 1) & ~uintptr_t(alignment - 1);
+			return reinterpret_cast<void*>(address);
+		}
+		chunk = AddChunk(chunk, reserved);
+	} while (true);
+}
+
+
+void LinearArena::Reset() {
+	if (m_chunks.size() > 1) {
+		size_t capacity = GetCapacity();
+		m_chunks.clear();
+		m_chunks.push_back(std::make_unique<Chunk>(capacity));
+	}
+	m_chunks.back()->offset = 0;
+	m_current = m_chunks.back().get();
+}
+
+
+size_t LinearArena::GetCapacity() const {
+	std::lock_guard<std::mutex> lkg(m_chunkMtx);
+	size_t capacity = 0;
+	for (auto& chunk : m_chunks) {
+		capacity += chunk->size;
+	}
+	return capacity;
+}
+
+
+size_t LinearArena::GetNumChunks() const {
+	std::lock_guard<std::mutex> lkg(m_chunkMtx);
+	return m_chunks.size();
+}
+
+
+auto LinearArena::AddChunk(Chunk* full, size_t minSize) -> Chunk* {
+	std::lock_guard<std::mutex> lkg(m_chunkMtx);
+
+	// Another thread may have already replaced the full chunk.
+	Chunk* current = m_current.load(std::memory_order_relaxed);
+	if (current != full) {
+		return current;
+	}
+
+	// Grow geometrically so a frame that overflows needs only a few chunks.
+	size_t size = std::max(minSize, m_chunks.back()->size * 2);
+	m_chunks.push_back(std::make_unique<Chunk>(size));
+	m_current.store(m_chunks.back().get(), std::memory_order_release);
+	return m_chunks.back().get();
+}
+
+
+} // namespace inl
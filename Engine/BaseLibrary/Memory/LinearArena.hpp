@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+
+namespace inl {
+
+
+/// <summary>
+/// Thread safe bump allocator for short-lived memory.
+/// Allocations are never freed individually, the whole arena is
+/// released at once by <see cref="Reset"/>.
+/// </summary>
+class LinearArena {
+	// How it works:
+	// Allocations bump an atomic offset in the current chunk, which needs no lock.
+	// When the chunk runs out, a new chunk is added under a mutex.
+	// Reset merges all chunks into one large enough for everything that was allocated,
+	// so the arena stops touching the heap after the first few uses.
+private:
+	struct Chunk {
+		Chunk(size_t size) : memory(new std::byte[size]), size(size), offset(0) {}
+		std::unique_ptr<std::byte[]> memory;
+		size_t size;
+		std::atomic_size_t offset;
+	};
+public:
+	LinearArena(size_t initialSize = 64 * 1024);
+	LinearArena(const LinearArena&) = delete;
+	LinearArena& operator=(const LinearArena&) = delete;
+
+	/// <summary> Allocates uninitialized memory that stays valid until the next <see cref="Reset"/>. </summary>
+	/// <param name="alignment"> Must be a power of two. </param>
+	/// <remarks> Thread safe. </remarks>
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	/// <summary> Releases all allocations at once. </summary>
+	/// <remarks> Not thread safe, no other thread may use the arena meanwhile. </remarks>
+	void Reset();
+
+	/// <summary> Total bytes reserved from the heap. </summary>
+	size_t GetCapacity() const;
+
+	/// <summary> Number of heap blocks backing the arena. 1 means the last use fit in the arena. </summary>
+	size_t GetNumChunks() const;
+private:
+	Chunk* AddChunk(Chunk* full, size_t minSize);
+private:
+	std::vector<std::unique_ptr<Chunk>> m_chunks;
+	std::atomic<Chunk*> m_current;
+	mutable std::mutex m_chunkMtx;
+};
+
+
+
+/// <summary>
+/// STL allocator that takes memory from a <see cref="LinearArena"/>.
+/// Deallocation does nothing, memory is reclaimed when the arena is reset.
+/// Without an arena it falls back to the heap, so containers work the same either way.
+/// </summary>
+template <class T>
+class ArenaAllocator {
+public:
+	using value_type = T;
+
+	ArenaAllocator(LinearArena* arena = nullptr) noexcept : m_arena(arena) {}
+	template <class U>
+	ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_arena(other.GetArena()) {}
+
+	T* allocate(size_t count) {
+		if (count > size_t(-1) / sizeof(T)) {
+			throw std::bad_array_new_length();
+		}
+		if (m_arena) {
+			return static_cast<T*>(m_arena->Allocate(count * sizeof(T), alignof(T)));
+		}
+		return std::allocator<T>().allocate(count);
+	}
+	void deallocate(T* ptr, size_t count) noexcept {
+		if (!m_arena) {
+			std::allocator<T>().deallocate(ptr, count);
+		}
+	}
+
+	LinearArena* GetArena() const noexcept { return m_arena; }
+
+	template <class U>
+	bool operator==(const ArenaAllocator<U>& rhs) const noexcept { return m_arena == rhs.GetArena(); }
+	template <class U>
+	bool operator!=(const ArenaAllocator<U>& rhs) const noexcept { return m_arena != rhs.GetArena(); }
+private:
+	LinearArena* m_arena;
+};
+
+
+} // namespace inl
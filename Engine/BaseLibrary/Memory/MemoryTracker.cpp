@@ -0,0 +1,117 @@
+#include "MemoryTracker.hpp"
+
+#include <atomic>
+
+
+namespace inl {
+
+
+namespace {
+
+	// On their own cache line, threads allocating for different tags don't contend.
+	struct alignas(64) TagCounters {
+		std::atomic_int64_t liveBytes;
+		std::atomic_int64_t peakBytes;
+		std::atomic_uint64_t numAllocations;
+		std::atomic_uint64_t numFrees;
+		std::atomic_uint64_t allocatedBytes;
+	};
+
+	// Zero initialized before any dynamic initialization, static constructors may already allocate.
+	TagCounters tagCounters[size_t(eMemoryTag::COUNT)];
+
+	thread_local eMemoryTag threadTag = eMemoryTag::UNTAGGED;
+
+} // namespace
+
+
+bool MemoryTracker::IsEnabled() {
+#ifdef INL_MEMORY_TRACKING
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+eMemoryTag MemoryTracker::GetThreadTag() noexcept {
+	return threadTag;
+}
+
+
+const char* MemoryTracker::GetTagName(eMemoryTag tag) {
+	switch (tag) {
+		case eMemoryTag::UNTAGGED: return "Untagged";
+		case eMemoryTag::GRAPHICS: return "Graphics";
+		case eMemoryTag::PHYSICS: return "Physics";
+		case eMemoryTag::ASSETS: return "Assets";
+		case eMemoryTag::NETWORK: return "Network";
+		case eMemoryTag::GUI: return "GUI";
+		default: return "Unknown";
+	}
+}
+
+
+void MemoryTracker::RecordAllocation(eMemoryTag tag, size_t bytes) noexcept {
+	TagCounters& counters = tagCounters[size_t(tag)];
+	counters.numAllocations.fetch_add(1, std::memory_order_relaxed);
+	counters.allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+	int64_t live = counters.liveBytes.fetch_add(int64_t(bytes), std::memory_order_relaxed) + int64_t(bytes);
+	int64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+	while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+	}
+}
+
+
+void MemoryTracker::RecordFree(eMemoryTag tag, size_t bytes) noexcept {
+	TagCounters& counters = tagCounters[size_t(tag)];
+	counters.numFrees.fetch_add(1, std::memory_order_relaxed);
+	counters.liveBytes.fetch_sub(int64_t(bytes), std::memory_order_relaxed);
+}
+
+
+MemorySnapshot MemoryTracker::GetSnapshot() {
+	MemorySnapshot snapshot;
+	snapshot.time = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < snapshot.tags.size(); ++i) {
+		const TagCounters& counters = tagCounters[i];
+		MemoryTagStatistics& statistics = snapshot.tags[i];
+		statistics.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+		statistics.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+		statistics.numAllocations = counters.numAllocations.load(std::memory_order_relaxed);
+		statistics.numFrees = counters.numFrees.load(std::memory_order_relaxed);
+		statistics.allocatedBytes = counters.allocatedBytes.load(std::memory_order_relaxed);
+	}
+	return snapshot;
+}
+
+
+MemorySnapshot MemoryTracker::GetSnapshot(const MemorySnapshot& previous) {
+	MemorySnapshot snapshot = GetSnapshot();
+	double seconds = std::chrono::duration<double>(snapshot.time - previous.time).count();
+	if (seconds > 0.0) {
+		for (size_t i = 0; i < snapshot.tags.size(); ++i) {
+			MemoryTagStatistics& statistics = snapshot.tags[i];
+			statistics.allocationsPerSecond = double(statistics.numAllocations - previous.tags[i].numAllocations) / seconds;
+			statistics.allocatedBytesPerSecond = double(statistics.allocatedBytes - previous.tags[i].allocatedBytes) / seconds;
+		}
+	}
+	return snapshot;
+}
+
+
+void MemoryTracker::ResetPeaks() {
+	for (TagCounters& counters : tagCounters) {
+		counters.peakBytes.store(counters.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+}
+
+
+eMemoryTag MemoryTracker::SetThreadTag(eMemoryTag tag) noexcept {
+	eMemoryTag previous = threadTag;
+	threadTag = tag;
+	return previous;
+}
+
+
+} // namespace inl
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace inl {
+
+
+/// <summary> The subsystems that allocations are counted for. </summary>
+enum class eMemoryTag : uint8_t {
+	UNTAGGED,
+	GRAPHICS,
+	PHYSICS,
+	ASSETS,
+	NETWORK,
+	GUI,
+	COUNT,
+};
+
+
+/// <summary> Counters of the allocations of one tag. </summary>
+struct MemoryTagStatistics {
+	int64_t liveBytes = 0;
+	int64_t peakBytes = 0; /// <summary> Most live bytes since the start or since <see cref="MemoryTracker::ResetPeaks"/>. </summary>
+	uint64_t numAllocations = 0;
+	uint64_t numFrees = 0;
+	uint64_t allocatedBytes = 0; /// <summary> All bytes ever allocated, whether freed or not. </summary>
+
+	// Since the previous snapshot, zero if there is none.
+	double allocationsPerSecond = 0.0;
+	double allocatedBytesPerSecond = 0.0;
+};
+
+
+/// <summary> The counters of all tags at one point in time. </summary>
+struct MemorySnapshot {
+	std::chrono::steady_clock::time_point time;
+	std::array<MemoryTagStatistics, size_t(eMemoryTag::COUNT)> tags;
+
+	const MemoryTagStatistics& operator[](eMemoryTag tag) const { return tags[size_t(tag)]; }
+};
+
+
+/// <summary>
+/// Counts the allocations of the global allocator by the subsystem that made them.
+/// </summary>
+/// <remarks>
+/// <para> The global allocator reports to the tracker if it is built with INL_MEMORY_TRACKING.
+///		Otherwise nothing is counted, and tag scopes only cost a thread local store. </para>
+/// <para> Tags are set per thread by <see cref="MemoryTagScope"/>. Frees are counted for the tag
+///		of the allocation, whichever thread and tag frees them. </para>
+/// </remarks>
+class MemoryTracker {
+public:
+	/// <summary> True if the global allocator reports to the tracker. </summary>
+	static bool IsEnabled();
+
+	/// <summary> The tag new allocations of the calling thread get. </summary>
+	static eMemoryTag GetThreadTag() noexcept;
+	static const char* GetTagName(eMemoryTag tag);
+
+	/// <summary> Called by the allocator. Must not allocate. </summary>
+	static void RecordAllocation(eMemoryTag tag, size_t bytes) noexcept;
+	/// <summary> Called by the allocator. Must not allocate. </summary>
+	static void RecordFree(eMemoryTag tag, size_t bytes) noexcept;
+
+	/// <summary> Reads the counters of all tags. </summary>
+	static MemorySnapshot GetSnapshot();
+	/// <summary> Reads the counters, and computes the rates since the previous snapshot. </summary>
+	/// <remarks> Call it periodically with the result of the previous call to follow allocation rates. </remarks>
+	static MemorySnapshot GetSnapshot(const MemorySnapshot& previous);
+
+	/// <summary> Peaks start again from the current live bytes. </summary>
+	static void ResetPeaks();
+private:
+	friend class MemoryTagScope;
+	static eMemoryTag SetThreadTag(eMemoryTag tag) noexcept;
+};
+
+
+/// <summary> Allocations of the calling thread are counted for the tag while the scope lives. </summary>
+/// <remarks> Scopes nest, the previous tag is restored when the scope ends. </remarks>
+class MemoryTagScope {
+public:
+	explicit MemoryTagScope(eMemoryTag tag) noexcept : m_previous(MemoryTracker::SetThreadTag(tag)) {}
+	~MemoryTagScope() { MemoryTracker::SetThreadTag(m_previous); }
+	MemoryTagScope(const MemoryTagScope&) = delete;
+	MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+private:
+	eMemoryTag m_previous;
+};
+
+
+} // namespace inl
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace inl {
+
+
+/// <summary>
+/// Free list of reusable objects where each thread pops from its own cache.
+/// Objects are pushed to a shared list, a thread refills its cache from there in batches when it runs dry.
+/// This class does NOT own the objects, it only hands out the pointers.
+/// </summary>
+/// <remarks> Meant for objects that are recycled on a different thread than the one using them,
+///		like GPU resources given back when a fence has passed. </remarks>
+template <class T>
+class ThreadCachedFreeList {
+public:
+	/// <param name="refillCount"> At most this many objects move to a thread cache at once, so that one thread does not take all. </param>
+	explicit ThreadCachedFreeList(size_t refillCount = 8);
+	ThreadCachedFreeList(const ThreadCachedFreeList&) = delete;
+	ThreadCachedFreeList& operator=(const ThreadCachedFreeList&) = delete;
+
+	/// <summary> Takes an object from the cache of the calling thread. Only locks when the cache has to be refilled. </summary>
+	/// <returns> Null if there are no free objects. </returns>
+	T* Pop();
+
+	/// <summary> Makes an object available again. </summary>
+	void Push(T* object);
+
+	/// <summary> Forgets all free objects, including the ones in the thread caches. </summary>
+	/// <remarks> Not safe while other threads pop. </remarks>
+	void Clear();
+
+private:
+	struct ThreadCache {
+		std::thread::id owner;
+		std::vector<T*> objects;
+	};
+	struct ThreadCacheRef {
+		uint64_t listId = 0;
+		ThreadCache* cache = nullptr;
+	};
+
+	ThreadCache& GetThreadCache();
+
+private:
+	inline static thread_local ThreadCacheRef threadCache;
+	inline static std::atomic_uint64_t nextListId = 1;
+
+	const uint64_t m_id; // Tells apart the thread caches of different lists.
+	const size_t m_refillCount;
+
+	std::vector<T*> m_shared;
+	std::vector<std::unique_ptr<ThreadCache>> m_threadCaches;
+	std::mutex m_mtx;
+};
+
+
+
+template <class T>
+ThreadCachedFreeList<T>::ThreadCachedFreeList(size_t refillCount)
+	: m_id(nextListId++), m_refillCount(std::max(refillCount, size_t(1)))
+{}
+
+
+template <class T>
+T* ThreadCachedFreeList<T>::Pop() {
+	ThreadCache& cache = GetThreadCache();
+	if (cache.objects.empty()) {
+		std::lock_guard<std::mutex> lkg(m_mtx);
+		size_t count = std::min(m_shared.size(), m_refillCount);
+		cache.objects.insert(cache.objects.end(), m_shared.end() - count, m_shared.end());
+		m_shared.resize(m_shared.size() - count);
+	}
+	if (cache.objects.empty()) {
+		return nullptr;
+	}
+	T* object = cache.objects.back();
+	cache.objects.pop_back();
+	return object;
+}
+
+
+template <class T>
+void ThreadCachedFreeList<T>::Push(T* object) {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	m_shared.push_back(object);
+}
+
+
+template <class T>
+void ThreadCachedFreeList<T>::Clear() {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	m_shared.clear();
+	for (auto& cache : m_threadCaches) {
+		cache->objects.clear();
+	}
+}
+
+
+template <class T>
+auto ThreadCachedFreeList<T>::GetThreadCache() -> ThreadCache& {
+	if (threadCache.listId == m_id) {
+		return *threadCache.cache;
+	}
+
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	auto id = std::this_thread::get_id();
+	auto it = std::find_if(m_threadCaches.begin(), m_threadCaches.end(), [id](const auto& cache) { return cache->owner == id; });
+	if (it == m_threadCaches.end()) {
+		auto cache = std::make_unique<ThreadCache>();
+		cache->owner = id;
+		m_threadCaches.push_back(std::move(cache));
+		it = m_threadCaches.end() - 1;
+	}
+	threadCache = { m_id, it->get() };
+	return **it;
+}
+
+
+} // namespace inl
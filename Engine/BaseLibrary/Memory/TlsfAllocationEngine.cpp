@@ -0,0 +1,224 @@
+#include "TlsfAllocationEngine.hpp"
+
+#include "../BitOperations.hpp"
+#include "../Exception/Exception.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <string>
+
+
+namespace inl {
+
+
+static bool IsPowerOfTwo(uint64_t value) {
+	return value != 0 && (value & (value - 1)) == 0;
+}
+
+
+TlsfAllocationEngine::TlsfAllocationEngine(uint64_t poolSize, uint64_t granularity)
+	: m_granularity(granularity)
+{
+	if (!IsPowerOfTwo(granularity)) {
+		throw InvalidArgumentException("Granularity must be a power of two.", std::to_string(granularity));
+	}
+	m_poolSize = poolSize / granularity * granularity;
+	m_freeSize = m_poolSize;
+	m_freeHeads.fill(InvalidBlock);
+
+	if (m_poolSize > 0) {
+		uint32_t block = NewBlock(0, m_poolSize);
+		InsertFree(block);
+	}
+}
+
+
+TlsfAllocationEngine::Allocation TlsfAllocationEngine::Allocate(uint64_t size, uint64_t alignment) {
+	if (size == 0) {
+		throw InvalidArgumentException("Allocation size must not be zero.");
+	}
+	if (!IsPowerOfTwo(alignment)) {
+		throw InvalidArgumentException("Alignment must be a power of two.", std::to_string(alignment));
+	}
+	size = (size + m_granularity - 1) / m_granularity * m_granularity;
+	alignment = std::max(alignment, m_granularity);
+
+	// Any block that fits the size plus the worst case padding will do.
+	uint32_t block = FindFree(size + alignment - m_granularity);
+	if (block == InvalidBlock) {
+		throw std::bad_alloc();
+	}
+	RemoveFree(block);
+
+	uint64_t offset = m_blocks[block].offset;
+	uint64_t padding = (offset + alignment - 1) / alignment * alignment - offset;
+	if (padding > 0) {
+		uint32_t front = SplitFront(block, padding);
+		InsertFree(front);
+	}
+
+	uint32_t allocated = block;
+	if (m_blocks[block].size > size) {
+		allocated = SplitFront(block, size);
+		InsertFree(block);
+	}
+	m_blocks[allocated].free = false;
+	m_freeSize -= m_blocks[allocated].size;
+
+	return { m_blocks[allocated].offset, allocated };
+}
+
+
+void TlsfAllocationEngine::Deallocate(Allocation allocation) {
+	uint32_t block = allocation.block;
+	if (block >= m_blocks.size() || m_blocks[block].free || m_blocks[block].offset != allocation.offset) {
+		throw InvalidArgumentException("Allocation does not belong to this allocator or has already been freed.");
+	}
+	m_freeSize += m_blocks[block].size;
+
+	uint32_t next = m_blocks[block].nextPhysical;
+	if (next != InvalidBlock && m_blocks[next].free) {
+		RemoveFree(next);
+		Merge(block, next);
+	}
+	uint32_t prev = m_blocks[block].prevPhysical;
+	if (prev != InvalidBlock && m_blocks[prev].free) {
+		RemoveFree(prev);
+		Merge(prev, block);
+		block = prev;
+	}
+	InsertFree(block);
+}
+
+
+void TlsfAllocationEngine::Mapping(uint64_t size, unsigned& firstLevel, unsigned& secondLevel) {
+	if (size < SecondLevelCount) {
+		firstLevel = 0;
+		secondLevel = unsigned(size);
+	}
+	else {
+		unsigned msb = 63 - unsigned(CountLeadingZeros(size));
+		firstLevel = msb - SecondLevelLog2 + 1;
+		secondLevel = unsigned(size >> (msb - SecondLevelLog2)) - SecondLevelCount;
+	}
+}
+
+
+uint32_t TlsfAllocationEngine::FindFree(uint64_t size) const {
+	uint64_t units = size / m_granularity;
+
+	// Round up to the next class, so that every block of the class found fits.
+	if (units >= SecondLevelCount) {
+		unsigned msb = 63 - unsigned(CountLeadingZeros(units));
+		units += (uint64_t(1) << (msb - SecondLevelLog2)) - 1;
+	}
+	unsigned firstLevel, secondLevel;
+	Mapping(units, firstLevel, secondLevel);
+	if (firstLevel >= FirstLevelCount) {
+		return InvalidBlock;
+	}
+
+	uint32_t secondLevelMap = m_secondLevelBitmaps[firstLevel] & (~uint32_t(0) << secondLevel);
+	if (secondLevelMap == 0) {
+		uint64_t firstLevelMap = m_firstLevelBitmap & (~uint64_t(0) << (firstLevel + 1));
+		if (firstLevelMap == 0) {
+			return InvalidBlock;
+		}
+		firstLevel = unsigned(CountTrailingZeros(firstLevelMap));
+		secondLevelMap = m_secondLevelBitmaps[firstLevel];
+	}
+	secondLevel = unsigned(CountTrailingZeros(secondLevelMap));
+	return m_freeHeads[firstLevel * SecondLevelCount + secondLevel];
+}
+
+
+uint32_t TlsfAllocationEngine::NewBlock(uint64_t offset, uint64_t size) {
+	Block block{ offset, size, InvalidBlock, InvalidBlock, InvalidBlock, InvalidBlock, false };
+	if (!m_unusedBlocks.empty()) {
+		uint32_t index = m_unusedBlocks.back();
+		m_unusedBlocks.pop_back();
+		m_blocks[index] = block;
+		return index;
+	}
+	m_blocks.push_back(block);
+	return uint32_t(m_blocks.size() - 1);
+}
+
+
+void TlsfAllocationEngine::InsertFree(uint32_t block) {
+	unsigned firstLevel, secondLevel;
+	Mapping(m_blocks[block].size / m_granularity, firstLevel, secondLevel);
+	uint32_t& head = m_freeHeads[firstLevel * SecondLevelCount + secondLevel];
+
+	m_blocks[block].free = true;
+	m_blocks[block].prevFree = InvalidBlock;
+	m_blocks[block].nextFree = head;
+	if (head != InvalidBlock) {
+		m_blocks[head].prevFree = block;
+	}
+	head = block;
+
+	m_firstLevelBitmap |= uint64_t(1) << firstLevel;
+	m_secondLevelBitmaps[firstLevel] |= uint32_t(1) << secondLevel;
+}
+
+
+void TlsfAllocationEngine::RemoveFree(uint32_t block) {
+	assert(m_blocks[block].free);
+	unsigned firstLevel, secondLevel;
+	Mapping(m_blocks[block].size / m_granularity, firstLevel, secondLevel);
+	uint32_t& head = m_freeHeads[firstLevel * SecondLevelCount + secondLevel];
+
+	Block& current = m_blocks[block];
+	if (current.prevFree != InvalidBlock) {
+		m_blocks[current.prevFree].nextFree = current.nextFree;
+	}
+	if (current.nextFree != InvalidBlock) {
+		m_blocks[current.nextFree].prevFree = current.prevFree;
+	}
+	if (head == block) {
+		head = current.nextFree;
+		if (head == InvalidBlock) {
+			m_secondLevelBitmaps[firstLevel] &= ~(uint32_t(1) << secondLevel);
+			if (m_secondLevelBitmaps[firstLevel] == 0) {
+				m_firstLevelBitmap &= ~(uint64_t(1) << firstLevel);
+			}
+		}
+	}
+	current.free = false;
+	current.prevFree = InvalidBlock;
+	current.nextFree = InvalidBlock;
+}
+
+
+uint32_t TlsfAllocationEngine::SplitFront(uint32_t block, uint64_t size) {
+	assert(size < m_blocks[block].size);
+	uint32_t front = NewBlock(m_blocks[block].offset, size);
+
+	Block& back = m_blocks[block];
+	m_blocks[front].prevPhysical = back.prevPhysical;
+	m_blocks[front].nextPhysical = block;
+	if (back.prevPhysical != InvalidBlock) {
+		m_blocks[back.prevPhysical].nextPhysical = front;
+	}
+	back.prevPhysical = front;
+	back.offset += size;
+	back.size -= size;
+	return front;
+}
+
+
+void TlsfAllocationEngine::Merge(uint32_t block, uint32_t next) {
+	assert(m_blocks[block].nextPhysical == next);
+	m_blocks[block].size += m_blocks[next].size;
+	m_blocks[block].nextPhysical = m_blocks[next].nextPhysical;
+	if (m_blocks[next].nextPhysical != InvalidBlock) {
+		m_blocks[m_blocks[next].nextPhysical].prevPhysical = block;
+	}
+	m_blocks[next].free = true; // Rejects freeing it again.
+	m_unusedBlocks.push_back(next);
+}
+
+
+} // namespace inl
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+
+namespace inl {
+
+
+/// <summary>
+/// Two-level segregated fit allocator of ranges within a pool of fixed size.
+/// Allocation and deallocation are constant time, freed ranges merge with their free neighbours.
+/// This class does NOT manage the memory itself, only the offsets of the allocated ranges.
+/// </summary>
+class TlsfAllocationEngine {
+	// How it works:
+	// The pool is cut into blocks that are linked in the order of their offsets.
+	// Free blocks are also linked into one list per size class. The first level of classes are the
+	// powers of two, each of them is divided linearly into SecondLevelCount classes.
+	// A bitmap per level tells which lists are not empty, so finding a big enough block takes two bit scans.
+	static constexpr unsigned SecondLevelLog2 = 4;
+	static constexpr unsigned SecondLevelCount = 1u << SecondLevelLog2;
+	static constexpr unsigned FirstLevelCount = 64 - SecondLevelLog2 + 1;
+	static constexpr uint32_t InvalidBlock = std::numeric_limits<uint32_t>::max();
+
+	struct Block {
+		uint64_t offset;
+		uint64_t size;
+		uint32_t prevPhysical;
+		uint32_t nextPhysical;
+		uint32_t prevFree;
+		uint32_t nextFree;
+		bool free;
+	};
+
+public:
+	struct Allocation {
+		uint64_t offset = 0;
+		uint32_t block = InvalidBlock; /// <summary> Identifies the allocation for <see cref="Deallocate"/>. </summary>
+	};
+
+public:
+	/// <param name="poolSize"> The number of units in the pool. </param>
+	/// <param name="granularity"> Sizes and offsets are multiples of this, must be a power of two. </param>
+	/// <exception cref="InvalidArgumentException"> If the granularity is not a power of two. </exception>
+	TlsfAllocationEngine(uint64_t poolSize, uint64_t granularity = 1);
+
+	/// <summary> Allocates a range of at least <paramref name="size"/> units. </summary>
+	/// <param name="alignment"> The offset will be a multiple of this, must be a power of two. </param>
+	/// <exception cref="std::bad_alloc"> If there is no free range large enough. </exception>
+	/// <exception cref="InvalidArgumentException"> If size is zero or alignment is not a power of two. </exception>
+	Allocation Allocate(uint64_t size, uint64_t alignment = 1);
+
+	/// <summary> Frees an allocation returned by <see cref="Allocate"/>. </summary>
+	void Deallocate(Allocation allocation);
+
+	uint64_t Size() const { return m_poolSize; }
+	uint64_t GetFreeSize() const { return m_freeSize; }
+	bool IsEmpty() const { return m_freeSize == m_poolSize; }
+
+private:
+	static void Mapping(uint64_t size, unsigned& firstLevel, unsigned& secondLevel);
+	uint32_t FindFree(uint64_t size) const;
+
+	uint32_t NewBlock(uint64_t offset, uint64_t size);
+	void InsertFree(uint32_t block);
+	void RemoveFree(uint32_t block);
+	/// <summary> Cuts the first <paramref name="size"/> units into a new block, the remainder stays in <paramref name="block"/>. </summary>
+	uint32_t SplitFront(uint32_t block, uint64_t size);
+	/// <summary> Merges <paramref name="next"/> into <paramref name="block"/>, next must follow block. </summary>
+	void Merge(uint32_t block, uint32_t next);
+
+private:
+	uint64_t m_poolSize;
+	uint64_t m_granularity;
+	uint64_t m_freeSize;
+
+	std::vector<Block> m_blocks;
+	std::vector<uint32_t> m_unusedBlocks;
+
+	uint64_t m_firstLevelBitmap = 0;
+	std::array<uint32_t, FirstLevelCount> m_secondLevelBitmaps = {};
+	std::array<uint32_t, FirstLevelCount * SecondLevelCount> m_freeHeads;
+};
+
+
+} // namespace inl
@@ -0,0 +1,8 @@
+#pragma once
+
+
+#ifdef _WIN32
+#include "Win32/MappedFile.hpp"
+#else
+static_assert(false, "Memory mapped files are not implemented on this platform.");
+#endif
@@ -40,6 +40,8 @@ bool Input::CallEvents() {
 	bool eventDropped = m_eventDropped;
 	m_eventDropped = false;
 	std::queue<InputEvent> eventQueue = std::move(m_eventQueue);
+	m_callMouseSamples.clear();
+	std::swap(m_callMouseSamples, m_mouseSamples);
 
 	lk.unlock();
 
@@ -70,6 +72,11 @@ bool Input::CallEvents() {
 }
 
 
+const std::vector<MouseMoveEvent>& Input::GetMouseMoveSamples() const {
+	return m_callMouseSamples;
+}
+
+
 eInputQueueMode Input::GetQueueMode() const {
 	return m_queueMode;
 }
@@ -197,6 +204,7 @@ LRESULT __stdcall Input::RawInputSourceBase::WndProc(HWND hwnd, UINT msg, WPARAM
 
 			RAWINPUT* rawInput = (RAWINPUT*)lpb.data();
 			instance->ProcessInput(*rawInput);
+			instance->ProcessInputBuffer();
 			return DefWindowProc(hwnd, msg, wParam, lParam);
 		}
 		default:
@@ -327,6 +335,33 @@ void Input::RawInputSourceBase::ProcessInput(const RAWINPUT& rawInput) {
 }
 
 
+void Input::RawInputSourceBase::ProcessInputBuffer() {
+	// Fast mice queue up raw input faster than WM_INPUT messages are dispatched,
+	// the input behind the current message is read in blocks instead of one message each.
+	UINT blockSize = 0;
+	if (GetRawInputBuffer(nullptr, &blockSize, sizeof(RAWINPUTHEADER)) != 0 || blockSize == 0) {
+		return;
+	}
+	size_t minBufferSize = 32 * blockSize / sizeof(uint64_t) + 1;
+	if (m_rawInputBuffer.size() < minBufferSize) {
+		m_rawInputBuffer.resize(minBufferSize);
+	}
+
+	for (;;) {
+		UINT bufferSize = UINT(m_rawInputBuffer.size() * sizeof(uint64_t));
+		UINT count = GetRawInputBuffer(reinterpret_cast<RAWINPUT*>(m_rawInputBuffer.data()), &bufferSize, sizeof(RAWINPUTHEADER));
+		if (count == 0 || count == UINT(-1)) {
+			break;
+		}
+		RAWINPUT* rawInput = reinterpret_cast<RAWINPUT*>(m_rawInputBuffer.data());
+		for (UINT i = 0; i < count; ++i) {
+			ProcessInput(*rawInput);
+			rawInput = NEXTRAWINPUTBLOCK(rawInput);
+		}
+	}
+}
+
+
 void Input::RawInputSourceBase::MessageLoopThreadFunc() {
 	// Create a basic invisible window just for the message loop.
 	WNDCLASSA wc;
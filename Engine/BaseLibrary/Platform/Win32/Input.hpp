@@ -8,6 +8,8 @@
 #include <set>
 #include <mutex>
 #include <queue>
+#include <type_traits>
+#include <vector>
 #include "../../Singleton.hpp"
 
 
@@ -31,6 +33,7 @@ enum class eInputSourceType {
 enum class eInputQueueMode {
 	IMMEDIATE,
 	QUEUED,
+	COALESCED,
 };
 
 
@@ -57,7 +60,9 @@ public:
 	/// <summary> Sets event calling mode: in immediate mode, events are called 
 	///		asynchonously from another thread; in queued mode, events are stored
 	///		and you have to call <see cref="CallEvents"> manually to call all queued 
-	///		events on the caller's thread. </summary>
+	///		events on the caller's thread. Coalesced mode is like queued, but consecutive
+	///		mouse moves are merged into one event, the individual moves are kept for
+	///		<see cref="GetMouseMoveSamples"/>. </summary>
 	void SetQueueMode(eInputQueueMode mode);
 
 	/// <summary> Returns the currently set queueing mode. </summary>
@@ -67,6 +72,10 @@ public:
 	/// <returns> False if some events were dropped due to too small queue size. </returns>
 	bool CallEvents();
 
+	/// <summary> The individual mouse moves that were merged into the events of the last <see cref="CallEvents"/>. </summary>
+	/// <remarks> Only filled in coalesced mode. </remarks>
+	const std::vector<MouseMoveEvent>& GetMouseMoveSamples() const;
+
 	/// <summary> Returns the list of available input devices that you can listen to. </summary>
 	static std::vector<InputDevice> GetDeviceList();
 
@@ -89,6 +98,8 @@ private:
 	volatile size_t m_queueSize;
 	volatile bool m_eventDropped;
 	std::queue<InputEvent> m_eventQueue;
+	std::vector<MouseMoveEvent> m_mouseSamples;
+	std::vector<MouseMoveEvent> m_callMouseSamples;
 	std::mutex m_queueMtx;
 
 private:
@@ -111,6 +122,7 @@ private:
 	private:
 		static LRESULT __stdcall WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 		void ProcessInput(const RAWINPUT& rawInput);
+		void ProcessInputBuffer();
 		void MessageLoopThreadFunc();
 
 		template <class EventArg>
@@ -124,6 +136,7 @@ private:
 		std::map<size_t, std::set<Input*>> m_sources;
 
 		std::unordered_map<size_t, JoyState> m_joyStates; // deviceId -> joyState
+		std::vector<uint64_t> m_rawInputBuffer; // RAWINPUT blocks must be 8-byte aligned.
 	};
 	using RawInputSource = Singleton<RawInputSourceBase>;
 };
@@ -143,6 +156,25 @@ void Input::RawInputSourceBase::CallEvents(size_t device, Event<EventArg> Input:
 			else {
 				std::lock_guard<decltype(Input::m_queueMtx)> lkg(input.m_queueMtx);
 				size_t queueSize = input.m_queueSize;
+				if constexpr (std::is_same_v<EventArg, MouseMoveEvent>) {
+					if (queueMode == eInputQueueMode::COALESCED) {
+						if (input.m_mouseSamples.size() < queueSize) {
+							input.m_mouseSamples.push_back(evt);
+						}
+						else {
+							input.m_eventDropped = true;
+						}
+						// Merge with the previous move unless another event came in between.
+						if (!input.m_eventQueue.empty() && input.m_eventQueue.back().type == eInputEventType::MOUSE_MOVE) {
+							MouseMoveEvent& merged = input.m_eventQueue.back().mouseMove;
+							merged.relx += evt.relx;
+							merged.rely += evt.rely;
+							merged.absx = evt.absx;
+							merged.absy = evt.absy;
+							continue;
+						}
+					}
+				}
 				input.m_eventQueue.push(InputEvent(evt));
 				if (input.m_eventQueue.size() > queueSize) {
 					input.m_eventDropped = true;
@@ -0,0 +1,82 @@
+#include "MappedFile.hpp"
+#include "../../Exception/Exception.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+
+#include <utility>
+
+
+namespace inl {
+
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw FileNotFoundException("File cannot be opened.", path.generic_string());
+	}
+	m_file = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		Close();
+		throw FileNotFoundException("Size of file cannot be queried.", path.generic_string());
+	}
+	m_size = (size_t)size.QuadPart;
+	if (m_size == 0) {
+		return; // Empty files cannot be mapped.
+	}
+
+	m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	m_data = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (!m_data) {
+		Close();
+		throw FileNotFoundException("File cannot be mapped into memory.", path.generic_string());
+	}
+}
+
+
+MappedFile::MappedFile(MappedFile&& rhs) noexcept
+	: m_file(std::exchange(rhs.m_file, nullptr)),
+	m_mapping(std::exchange(rhs.m_mapping, nullptr)),
+	m_data(std::exchange(rhs.m_data, nullptr)),
+	m_size(std::exchange(rhs.m_size, 0))
+{}
+
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept {
+	if (this != &rhs) {
+		Close();
+		m_file = std::exchange(rhs.m_file, nullptr);
+		m_mapping = std::exchange(rhs.m_mapping, nullptr);
+		m_data = std::exchange(rhs.m_data, nullptr);
+		m_size = std::exchange(rhs.m_size, 0);
+	}
+	return *this;
+}
+
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+
+void MappedFile::Close() noexcept {
+	if (m_data) {
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mapping) {
+		CloseHandle(m_mapping);
+	}
+	if (m_file) {
+		CloseHandle(m_file);
+	}
+	m_file = m_mapping = nullptr;
+	m_data = nullptr;
+	m_size = 0;
+}
+
+
+
+} // namespace inl
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+
+namespace inl {
+
+
+/// <summary> A whole file mapped read-only into memory. </summary>
+/// <remarks> Pages are read from the disk on first access, so reading a part of a large file is cheap. </remarks>
+class MappedFile {
+public:
+	MappedFile() = default;
+	/// <exception cref="FileNotFoundException"> If the file cannot be opened or mapped. </exception>
+	explicit MappedFile(const std::filesystem::path& path);
+	MappedFile(MappedFile&& rhs) noexcept;
+	MappedFile& operator=(MappedFile&& rhs) noexcept;
+	~MappedFile();
+
+	/// <summary> Null if the file is empty. </summary>
+	const void* GetData() const { return m_data; }
+	size_t GetSize() const { return m_size; }
+private:
+	void Close() noexcept;
+private:
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+	const void* m_data = nullptr;
+	size_t m_size = 0;
+};
+
+
+
+} // namespace inl
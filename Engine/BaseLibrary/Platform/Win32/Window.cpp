@@ -1,6 +1,7 @@
 #include "Window.hpp"
 #include "../../Exception/Exception.hpp"
 #include <future>
+#include <vector>
 #include <Windowsx.h>
 #include "shellapi.h"
 #include <dwmapi.h>
@@ -14,12 +15,51 @@
 namespace inl {
 
 
+namespace impl {
+
+	// Lock-free queue of events, the message thread pushes and the caller of CallEvents pops.
+	class WindowEventQueue {
+	public:
+		explicit WindowEventQueue(size_t capacity) : slots(capacity) {}
+
+		/// <summary> Returns false if the queue is full. </summary>
+		bool Push(std::function<void()>&& call) {
+			size_t currentTail = tail.load(std::memory_order_relaxed);
+			if (currentTail - head.load(std::memory_order_acquire) == slots.size()) {
+				return false;
+			}
+			slots[currentTail % slots.size()] = std::move(call);
+			tail.store(currentTail + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// <summary> Moves all events queued so far to the end of <paramref name="calls"/>. </summary>
+		void PopAll(std::vector<std::function<void()>>& calls) {
+			size_t currentHead = head.load(std::memory_order_relaxed);
+			size_t currentTail = tail.load(std::memory_order_acquire);
+			for (; currentHead != currentTail; ++currentHead) {
+				auto& slot = slots[currentHead % slots.size()];
+				calls.push_back(std::move(slot));
+				slot = nullptr;
+			}
+			head.store(currentHead, std::memory_order_release);
+		}
+	private:
+		std::vector<std::function<void()>> slots;
+		std::atomic_size_t head = 0;
+		std::atomic_size_t tail = 0;
+	};
+
+} // namespace impl
+
+
 
 Window::Window(const std::string& title,
 	Vec2u size,
 	bool borderless,
 	bool resizable,
-	bool hiddenInitially)
+	bool hiddenInitially,
+	bool ownMessageThread)
 {
 	// Lazy-register window class.
 	static bool isWcRegistered = [] {
@@ -51,6 +91,42 @@ Window::Window(const std::string& title,
 	}
 
 
+	if (ownMessageThread) {
+		// Windows get their messages on the thread that created them, so the message thread creates it.
+		m_eventQueue = std::make_unique<impl::WindowEventQueue>(EventQueueCapacity);
+		std::promise<void> created;
+		std::future<void> createdFuture = created.get_future();
+		m_messageThread = std::thread([this, &created, title, size, hiddenInitially] {
+			try {
+				CreateNativeWindow(title, size, hiddenInitially);
+				created.set_value();
+			}
+			catch (...) {
+				created.set_exception(std::current_exception());
+				return;
+			}
+			MessageLoop();
+		});
+		try {
+			createdFuture.get();
+		}
+		catch (...) {
+			m_messageThread.join();
+			throw;
+		}
+	}
+	else {
+		CreateNativeWindow(title, size, hiddenInitially);
+	}
+
+	// Handle borderless and resize properties.
+	SetBorderless(borderless);
+	SetResizable(resizable);
+	SetTitle(title);
+}
+
+
+void Window::CreateNativeWindow(const std::string& title, Vec2u size, bool hiddenInitially) {
 	// Create window on current thread
 	HWND hwnd = NULL;
 	try {
@@ -98,24 +174,18 @@ Window::Window(const std::string& title,
 		ShowWindow(m_handle, SW_SHOW);
 	}
 	UpdateWindow(m_handle);
-
-
-	// Handle borderless and resize properties.
-	SetBorderless(borderless);
-	SetResizable(resizable);
-	SetTitle(title);
 }
 
 
 Window::Window(Window&& rhs) noexcept {
-	m_handle = rhs.m_handle;
+	m_handle = rhs.m_handle.load();
 
 	rhs.m_handle = NULL;
 }
 
 
 Window& Window::operator=(Window&& rhs) noexcept {
-	m_handle = rhs.m_handle;
+	m_handle = rhs.m_handle.load();
 
 	rhs.m_handle = NULL;
 
@@ -124,7 +194,15 @@ Window& Window::operator=(Window&& rhs) noexcept {
 
 
 Window::~Window() {
-	if (m_handle != 0) {
+	if (m_messageThread.joinable()) {
+		// Only the message thread can destroy the window, which then ends the message loop.
+		HWND handle = m_handle;
+		if (handle == NULL || !PostMessage(handle, WM_CLOSE, 0, 0)) {
+			PostThreadMessage(GetThreadId(m_messageThread.native_handle()), WM_QUIT, 0, 0);
+		}
+		m_messageThread.join();
+	}
+	else if (m_handle != 0) {
 		DestroyWindow(m_handle);
 	}
 	if (m_icon) {
@@ -161,7 +239,8 @@ void Window::Hide() {
 
 
 bool Window::IsFocused() const {
-	return GetFocus() == m_handle;
+	// Focus is kept per thread, the caller's thread has none with an own message thread.
+	return (m_messageThread.joinable() ? GetForegroundWindow() : GetFocus()) == m_handle;
 }
 
 
@@ -393,8 +472,39 @@ void Window::SetIcon(const std::string& imageFilePath) {
 
 
 bool Window::CallEvents() {
-	MessageLoopPeek();
-	return false;
+	if (!m_eventQueue) {
+		MessageLoopPeek();
+		return true;
+	}
+
+	std::vector<std::function<void()>> calls;
+	m_eventQueue->PopAll(calls);
+	for (auto& call : calls) {
+		call();
+	}
+
+	std::unique_lock<std::mutex> lk(m_resizeMtx);
+	std::optional<ResizeEvent> resize = m_pendingResize;
+	m_pendingResize.reset();
+	lk.unlock();
+	if (resize) {
+		OnResize(*resize);
+	}
+
+	return !m_eventDropped.exchange(false);
+}
+
+
+void Window::QueueEvent(std::function<void()> call) {
+	if (!m_eventQueue->Push(std::move(call))) {
+		m_eventDropped = true;
+	}
+}
+
+
+void Window::QueueResize(const ResizeEvent& evt) {
+	std::lock_guard<std::mutex> lk(m_resizeMtx);
+	m_pendingResize = evt;
 }
 
 
@@ -607,7 +717,12 @@ LRESULT __stdcall Window::WndProc(WindowHandle hwnd, UINT msg, WPARAM wParam, LP
 			evt.size = instance.GetSize();
 			evt.clientSize = instance.GetClientSize();
 			evt.resizeMode = (eResizeMode)wParam;
-			instance.CallEvent(instance.OnResize, evt);
+			if (instance.m_eventQueue) {
+				instance.QueueResize(evt);
+			}
+			else {
+				instance.CallEvent(instance.OnResize, evt);
+			}
 			return DefWindowProc(hwnd, msg, wParam, lParam);
 		}
 		case WM_NCPAINT:
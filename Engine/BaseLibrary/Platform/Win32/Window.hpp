@@ -6,6 +6,9 @@
 #include <mutex>
 #include <atomic>
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <vector>
 
 #include "../../Event.hpp"
@@ -30,6 +33,11 @@ struct DragDropEvent {
 	std::vector<std::filesystem::path> filePaths;
 };
 
+namespace impl {
+	class WindowEventQueue;
+}
+
+
 enum class eWindowCaptionButton {
 	NONE,
 	BAR,
@@ -41,11 +49,16 @@ enum class eWindowCaptionButton {
 
 class Window : private IDropTarget {
 public:
+	/// <param name="ownMessageThread"> If true, the window's messages are processed by a thread of its own,
+	///		so that moving, resizing and modal loops of the window don't stall the caller's thread.
+	///		The events are then queued and called by <see cref="CallEvents"/>, and the caption button handler
+	///		is called from the message thread. A window with its own message thread must not be moved. </param>
 	Window(const std::string& title = "Untitled",
 		Vec2u size = { 640, 480 },
 		bool borderless = false, 
 		bool resizable = true,
-		bool hiddenInitially = false);
+		bool hiddenInitially = false,
+		bool ownMessageThread = false);
 	Window(const Window&) = delete;
 	Window(Window&& rhs) noexcept;
 	Window& operator=(const Window&) = delete;
@@ -90,6 +103,8 @@ public:
 	void SetIcon(const std::string& imageFilePath);
 
 	/// <summary> Calls all queued events synchronously on the caller's thread. </summary>
+	/// <remarks> With its own message thread, consecutive resizes are merged, and only the last one of them
+	///		is called, after the other events. Call this once per frame to apply resizes at the frame boundary. </remarks>
 	/// <returns> False if some events were dropped due to too small queue size. </returns>
 	bool CallEvents();
 	
@@ -110,10 +125,13 @@ public:
 
 private:
 	static LRESULT __stdcall WndProc(WindowHandle hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+	void CreateNativeWindow(const std::string& title, Vec2u size, bool hiddenInitially);
 	void MessageLoop();
 	void MessageLoopPeek();
 	template <class... EventArgs>
 	void CallEvent(Event<EventArgs...>& evt, EventArgs... args);
+	void QueueEvent(std::function<void()> call);
+	void QueueResize(const ResizeEvent& evt);
 
 	// drag'n'drop
 	HRESULT __stdcall QueryInterface(const IID& riid, void **ppv) override;
@@ -131,9 +149,17 @@ private:
 		
 private:
 	// WinAPI handles
-	WindowHandle m_handle = NULL;
+	std::atomic<WindowHandle> m_handle = NULL;
 	HANDLE m_icon = NULL;
 
+	// Own message thread
+	static constexpr size_t EventQueueCapacity = 4096;
+	std::thread m_messageThread;
+	std::unique_ptr<impl::WindowEventQueue> m_eventQueue; // Message thread to caller, only exists with own message thread.
+	std::atomic_bool m_eventDropped = false;
+	std::mutex m_resizeMtx;
+	std::optional<ResizeEvent> m_pendingResize;
+
 	// Window properties
 	bool m_borderless = false;
 	bool m_resizable = true;
@@ -148,7 +174,12 @@ private:
 
 template <class... EventArgs>
 void Window::CallEvent(Event<EventArgs...>& evt, EventArgs... args) {
-	evt(args...);
+	if (m_eventQueue) {
+		QueueEvent([&evt, args...] { evt(args...); });
+	}
+	else {
+		evt(args...);
+	}
 }
 
 
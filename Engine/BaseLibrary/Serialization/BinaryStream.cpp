@@ -0,0 +1,297 @@
+#include "BinaryStream.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+
+namespace inl {
+
+
+static constexpr size_t ChunkSizeBytes = 8; // Fixed, so that it can be filled in after the contents.
+
+
+//------------------------------------------------------------------------------
+// Writer
+//------------------------------------------------------------------------------
+
+BinaryStreamWriter::BinaryStreamWriter(std::ostream& stream)
+	: m_stream(stream), m_begin(stream.tellp())
+{}
+
+
+void BinaryStreamWriter::WriteVarint(uint64_t value) {
+	uint8_t bytes[10];
+	size_t count = 0;
+	do {
+		bytes[count] = uint8_t(value & 0x7F);
+		value >>= 7;
+		if (value != 0) {
+			bytes[count] |= 0x80;
+		}
+		++count;
+	} while (value != 0);
+	WriteBytes(bytes, count);
+}
+
+
+void BinaryStreamWriter::WriteVarintSigned(int64_t value) {
+	WriteVarint((uint64_t(value) << 1) ^ uint64_t(value >> 63));
+}
+
+
+void BinaryStreamWriter::WriteBool(bool value) {
+	uint8_t byte = value ? 1 : 0;
+	WriteBytes(&byte, 1);
+}
+
+
+void BinaryStreamWriter::WriteFloat(float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	WriteFixed(bits, sizeof(bits));
+}
+
+
+void BinaryStreamWriter::WriteDouble(double value) {
+	uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	WriteFixed(bits, sizeof(bits));
+}
+
+
+void BinaryStreamWriter::WriteString(std::string_view value) {
+	WriteVarint(value.size());
+	WriteBytes(value.data(), value.size());
+}
+
+
+void BinaryStreamWriter::WriteBytes(const void* data, size_t size) {
+	m_stream.write(reinterpret_cast<const char*>(data), std::streamsize(size));
+	if (!m_stream) {
+		throw RuntimeException("Failed to write stream.");
+	}
+	m_position += size;
+}
+
+
+void BinaryStreamWriter::BeginChunk(uint32_t tag) {
+	WriteVarint(tag);
+	m_chunkSizeFields.push_back(m_position);
+	WriteFixed(0, ChunkSizeBytes);
+}
+
+
+void BinaryStreamWriter::EndChunk() {
+	if (m_chunkSizeFields.empty()) {
+		throw InvalidCallException("There is no chunk to end.");
+	}
+	uint64_t sizeField = m_chunkSizeFields.back();
+	m_chunkSizeFields.pop_back();
+
+	uint64_t end = m_position;
+	m_stream.seekp(m_begin + std::streamoff(sizeField));
+	if (!m_stream) {
+		throw RuntimeException("Chunks need a seekable stream.");
+	}
+	m_position = sizeField;
+	WriteFixed(end - sizeField - ChunkSizeBytes, ChunkSizeBytes);
+	m_stream.seekp(m_begin + std::streamoff(end));
+	m_position = end;
+}
+
+
+void BinaryStreamWriter::Align(size_t alignment) {
+	static constexpr uint8_t zeros[64] = {};
+	size_t padding = size_t((alignment - m_position % alignment) % alignment);
+	while (padding > 0) {
+		size_t count = std::min(padding, sizeof(zeros));
+		WriteBytes(zeros, count);
+		padding -= count;
+	}
+}
+
+
+void BinaryStreamWriter::WriteFixed(uint64_t value, size_t size) {
+	uint8_t bytes[8];
+	for (size_t i = 0; i < size; ++i) {
+		bytes[i] = uint8_t(value >> (8 * i));
+	}
+	WriteBytes(bytes, size);
+}
+
+
+//------------------------------------------------------------------------------
+// Reader
+//------------------------------------------------------------------------------
+
+BinaryStreamReader::BinaryStreamReader(std::istream& stream)
+	: m_stream(&stream), m_size(std::numeric_limits<uint64_t>::max())
+{}
+
+
+BinaryStreamReader::BinaryStreamReader(const void* data, size_t size)
+	: m_data(reinterpret_cast<const uint8_t*>(data)), m_size(size)
+{}
+
+
+uint64_t BinaryStreamReader::ReadVarint() {
+	uint64_t value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		uint8_t byte = ReadByte();
+		if (shift == 63 && byte > 1) {
+			throw InvalidArgumentException("Varint does not fit 64 bits.");
+		}
+		value |= uint64_t(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) {
+			return value;
+		}
+	}
+	throw InvalidArgumentException("Varint does not fit 64 bits.");
+}
+
+
+int64_t BinaryStreamReader::ReadVarintSigned() {
+	uint64_t zigzag = ReadVarint();
+	return int64_t(zigzag >> 1) ^ -int64_t(zigzag & 1);
+}
+
+
+bool BinaryStreamReader::ReadBool() {
+	return ReadByte() != 0;
+}
+
+
+float BinaryStreamReader::ReadFloat() {
+	uint32_t bits = uint32_t(ReadFixed(sizeof(bits)));
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+
+double BinaryStreamReader::ReadDouble() {
+	uint64_t bits = ReadFixed(sizeof(bits));
+	double value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+
+std::string BinaryStreamReader::ReadString() {
+	uint64_t size = ReadVarint();
+	Require(size);
+	std::string value(size, '\0');
+	ReadBytes(value.data(), size);
+	return value;
+}
+
+
+void BinaryStreamReader::ReadBytes(void* data, size_t size) {
+	Require(size);
+	if (m_stream) {
+		m_stream->read(reinterpret_cast<char*>(data), std::streamsize(size));
+		if (m_stream->gcount() != std::streamsize(size)) {
+			throw OutOfRangeException("Read past the end of the stream.");
+		}
+	}
+	else if (size > 0) {
+		std::memcpy(data, m_data + m_position, size);
+	}
+	m_position += size;
+}
+
+
+BinaryStreamReader::Chunk BinaryStreamReader::BeginChunk() {
+	Chunk chunk;
+	uint64_t tag = ReadVarint();
+	if (tag > std::numeric_limits<uint32_t>::max()) {
+		throw InvalidArgumentException("Chunk tag does not fit 32 bits.");
+	}
+	chunk.tag = uint32_t(tag);
+	chunk.size = ReadFixed(ChunkSizeBytes);
+	Require(chunk.size);
+	m_chunkEnds.push_back(m_position + chunk.size);
+	return chunk;
+}
+
+
+void BinaryStreamReader::EndChunk() {
+	if (m_chunkEnds.empty()) {
+		throw InvalidCallException("There is no chunk to end.");
+	}
+	uint64_t end = m_chunkEnds.back();
+	Skip(end - m_position);
+	m_chunkEnds.pop_back();
+}
+
+
+BinaryStreamReader::Chunk BinaryStreamReader::SkipChunk() {
+	Chunk chunk = BeginChunk();
+	EndChunk();
+	return chunk;
+}
+
+
+bool BinaryStreamReader::IsEnd() const {
+	if (!m_chunkEnds.empty()) {
+		return m_position == m_chunkEnds.back();
+	}
+	return !m_stream && m_position == m_size;
+}
+
+
+void BinaryStreamReader::Require(uint64_t size) const {
+	uint64_t end = m_chunkEnds.empty() ? m_size : m_chunkEnds.back();
+	if (size > end - m_position) {
+		throw OutOfRangeException(m_chunkEnds.empty() ? "Read past the end of the data." : "Read past the end of the chunk.");
+	}
+}
+
+
+void BinaryStreamReader::Skip(uint64_t size) {
+	Require(size);
+	if (m_stream && size > 0) {
+		// Files seek over the bytes, pipes have to read them.
+		m_stream->seekg(std::streamoff(size), std::ios::cur);
+		if (!*m_stream) {
+			m_stream->clear();
+			char buffer[4096];
+			for (uint64_t left = size; left > 0;) {
+				std::streamsize count = std::streamsize(std::min<uint64_t>(left, sizeof(buffer)));
+				m_stream->read(buffer, count);
+				if (m_stream->gcount() != count) {
+					throw OutOfRangeException("Read past the end of the stream.");
+				}
+				left -= count;
+			}
+		}
+	}
+	m_position += size;
+}
+
+
+void BinaryStreamReader::Align(size_t alignment) {
+	Skip((alignment - m_position % alignment) % alignment);
+}
+
+
+uint64_t BinaryStreamReader::ReadFixed(size_t size) {
+	uint8_t bytes[8];
+	ReadBytes(bytes, size);
+	uint64_t value = 0;
+	for (size_t i = 0; i < size; ++i) {
+		value |= uint64_t(bytes[i]) << (8 * i);
+	}
+	return value;
+}
+
+
+uint8_t BinaryStreamReader::ReadByte() {
+	uint8_t byte;
+	ReadBytes(&byte, 1);
+	return byte;
+}
+
+
+} // namespace inl
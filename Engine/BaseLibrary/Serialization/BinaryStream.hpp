@@ -0,0 +1,178 @@
+#pragma once
+
+#include "../ArrayView.hpp"
+#include "../Exception/Exception.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+
+namespace inl {
+
+
+/// <summary>
+/// Writes values one after the other into a stream, without keeping them in memory.
+/// </summary>
+/// <remarks>
+/// <para> Integers are LEB128 varints, signed ones zigzag encoded first, so small values take a single byte.
+///		Floats are IEEE-754, little-endian. Strings and arrays are prefixed by their length as varint. </para>
+/// <para> Arrays of trivially copyable types are stored as their bytes in memory, aligned to the type from the
+///		beginning of the data, so that <see cref="BinaryStreamReader::ReadArrayView"/> can view them in place. </para>
+/// <para> Chunks are prefixed by a tag and the byte size of their contents, readers can skip the chunks they don't know.
+///		The size is filled in by <see cref="EndChunk"/>, the stream must be seekable if chunks are used. </para>
+/// </remarks>
+class BinaryStreamWriter {
+public:
+	/// <param name="stream"> Writing starts at its current position, which is the beginning of the data. </param>
+	explicit BinaryStreamWriter(std::ostream& stream);
+
+	void WriteVarint(uint64_t value);
+	void WriteVarintSigned(int64_t value);
+	void WriteBool(bool value);
+	void WriteFloat(float value);
+	void WriteDouble(double value);
+	void WriteString(std::string_view value);
+	void WriteBytes(const void* data, size_t size);
+
+	/// <summary> Writes the number of elements then their bytes, aligned to the type. </summary>
+	template <class T>
+	void WriteArray(const T* data, size_t count);
+
+	/// <summary> Starts a chunk, it lasts until the matching <see cref="EndChunk"/>. Chunks may nest. </summary>
+	void BeginChunk(uint32_t tag);
+	/// <summary> Writes the size of the innermost chunk. </summary>
+	/// <exception cref="InvalidCallException"> If there is no open chunk. </exception>
+	/// <exception cref="RuntimeException"> If the stream cannot seek. </exception>
+	void EndChunk();
+
+	/// <summary> Bytes written so far. </summary>
+	uint64_t GetPosition() const { return m_position; }
+private:
+	void Align(size_t alignment);
+	void WriteFixed(uint64_t value, size_t size);
+private:
+	std::ostream& m_stream;
+	std::streampos m_begin;
+	uint64_t m_position = 0;
+	std::vector<uint64_t> m_chunkSizeFields; // Position of the size of each open chunk.
+};
+
+
+/// <summary>
+/// Reads what <see cref="BinaryStreamWriter"/> wrote, either from a stream or from memory, such as a mapped file.
+/// </summary>
+/// <remarks>
+/// Reading past the end of the data or of the current chunk throws <see cref="OutOfRangeException"/>,
+/// so truncated files are detected. The data in memory must be aligned to the arrays in it
+/// for <see cref="ReadArrayView"/>, mapped files always are.
+/// </remarks>
+class BinaryStreamReader {
+public:
+	struct Chunk {
+		uint32_t tag;
+		uint64_t size; // Bytes of contents.
+	};
+
+public:
+	/// <param name="stream"> Reading starts at its current position. </param>
+	explicit BinaryStreamReader(std::istream& stream);
+	/// <param name="data"> Must stay valid while reading, arrays are viewed in place. </param>
+	BinaryStreamReader(const void* data, size_t size);
+
+	/// <exception cref="InvalidArgumentException"> If the varint does not fit 64 bits. </exception>
+	uint64_t ReadVarint();
+	int64_t ReadVarintSigned();
+	bool ReadBool();
+	float ReadFloat();
+	double ReadDouble();
+	std::string ReadString();
+	void ReadBytes(void* data, size_t size);
+
+	/// <summary> Reads an array written by <see cref="BinaryStreamWriter::WriteArray"/> into a copy. </summary>
+	template <class T>
+	std::vector<T> ReadArray();
+	/// <summary> Views an array written by <see cref="BinaryStreamWriter::WriteArray"/> where it is in memory, without copying. </summary>
+	/// <remarks> The view is valid as long as the memory given to the reader. </remarks>
+	/// <exception cref="InvalidCallException"> If reading from a stream. </exception>
+	template <class T>
+	ArrayView<const T> ReadArrayView();
+
+	/// <summary> Enters the next chunk, reads are confined to it until <see cref="EndChunk"/>. </summary>
+	Chunk BeginChunk();
+	/// <summary> Skips what is left of the innermost chunk. </summary>
+	/// <exception cref="InvalidCallException"> If there is no open chunk. </exception>
+	void EndChunk();
+	/// <summary> Skips the next chunk without entering it. </summary>
+	Chunk SkipChunk();
+	/// <summary> True if the innermost chunk, or the data if there is none, has nothing more to read. </summary>
+	/// <remarks> Outside chunks, streams only know their end after a read failed, so this is false for them. </remarks>
+	bool IsEnd() const;
+
+	/// <summary> Bytes read or skipped so far. </summary>
+	uint64_t GetPosition() const { return m_position; }
+	/// <summary> True if reading from memory. </summary>
+	bool IsInMemory() const { return m_stream == nullptr; }
+private:
+	void Require(uint64_t size) const;
+	void Skip(uint64_t size);
+	void Align(size_t alignment);
+	uint64_t ReadFixed(size_t size);
+	uint8_t ReadByte();
+private:
+	std::istream* m_stream = nullptr;
+	const uint8_t* m_data = nullptr;
+	uint64_t m_size = 0; // Unknown for streams.
+	uint64_t m_position = 0;
+	std::vector<uint64_t> m_chunkEnds;
+};
+
+
+
+template <class T>
+void BinaryStreamWriter::WriteArray(const T* data, size_t count) {
+	static_assert(std::is_trivially_copyable_v<T>, "Array elements are written as their bytes in memory.");
+	WriteVarint(count);
+	Align(alignof(T));
+	WriteBytes(data, count * sizeof(T));
+}
+
+
+template <class T>
+std::vector<T> BinaryStreamReader::ReadArray() {
+	static_assert(std::is_trivially_copyable_v<T>, "Array elements are read as their bytes in memory.");
+	uint64_t count = ReadVarint();
+	Align(alignof(T));
+	if (count > UINT64_MAX / sizeof(T)) {
+		throw OutOfRangeException("Array is larger than the data.");
+	}
+	Require(count * sizeof(T));
+	std::vector<T> elements(count);
+	ReadBytes(elements.data(), count * sizeof(T));
+	return elements;
+}
+
+
+template <class T>
+ArrayView<const T> BinaryStreamReader::ReadArrayView() {
+	static_assert(std::is_trivially_copyable_v<T>, "Array elements are viewed as their bytes in memory.");
+	if (!IsInMemory()) {
+		throw InvalidCallException("Only data in memory can be viewed in place.");
+	}
+	uint64_t count = ReadVarint();
+	Align(alignof(T));
+	if (count > UINT64_MAX / sizeof(T)) {
+		throw OutOfRangeException("Array is larger than the data.");
+	}
+	Require(count * sizeof(T));
+	const T* elements = reinterpret_cast<const T*>(m_data + m_position);
+	m_position += count * sizeof(T);
+	return ArrayView<const T>(elements, count, sizeof(T));
+}
+
+
+} // namespace inl
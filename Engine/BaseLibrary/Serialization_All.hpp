@@ -1,4 +1,5 @@
 #pragma once
 
 #include "Serialization/BinarySerializer.hpp"
-#include "Serialization/BinarySerializerExtensions.hpp"
\ No newline at end of file
+#include "Serialization/BinarySerializerExtensions.hpp"
+#include "Serialization/BinaryStream.hpp"
\ No newline at end of file
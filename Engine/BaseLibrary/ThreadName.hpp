@@ -1,5 +1,15 @@
 #pragma once
 
+#include <string>
+
+
+namespace inl::impl {
+inline std::string& CurrentThreadName() {
+	thread_local std::string name;
+	return name;
+}
+} // namespace inl::impl
+
 
 
 #if defined(WIN32) && defined(_MSC_VER)
@@ -37,15 +47,27 @@ inline void SetThreadName(LPCSTR szThreadName, CONST DWORD dwThreadID = -1)
 }
 
 inline void SetCurrentThreadName(const char* name) {
+	impl::CurrentThreadName() = name;
 	impl::SetThreadName(name, GetCurrentThreadId());
 }
 }
 
 #else
 
+namespace inl {
 inline void SetCurrentThreadName(const char* name) {
-	// thread name can only be set on windows, with visual studio
+	// thread name can only be set on windows, with visual studio, but we still remember it
+	impl::CurrentThreadName() = name;
+}
 }
 
 #endif
 
+
+namespace inl {
+/// <summary> Returns the name given by <see cref="SetCurrentThreadName"/>, or empty if not set. </summary>
+inline const std::string& GetCurrentThreadName() {
+	return impl::CurrentThreadName();
+}
+}
+
@@ -3,6 +3,9 @@
 
 #include <InlineMath.hpp>
 
+#include <iterator>
+#include <type_traits>
+
 namespace inl {
 
 
@@ -161,8 +164,8 @@ public:
 ///		The quat-vec3-quat-vec3 representation is used internally for fast setting of these values.
 ///		These fields can be queried individually, too.
 ///		This also results in applying scaling and shear as relative transforms being slow, because
-///		an SVD needs to be performed. Querying the total transform matrix is acceptable,
-///		but still has a cost.
+///		an SVD needs to be performed. The total transform matrix is cached and only recomposed
+///		after the transform changed.
 ///		</remarks>
 template <class T, int Dim, bool EnableMotion>
 class Transformable;
@@ -236,8 +239,17 @@ public:
 	MatLinT GetLinearTransform() const;
 
 	/// <summary> Returns the transformation matrix, including translation. </summary>
+	/// <remarks> Returns the cached matrix, recomposing it first if the transform changed since the last call. </remarks>
 	MatHomT GetTransform() const;
 
+	/// <summary> Recomposes the cached transformation matrix if the transform changed. </summary>
+	/// <remarks> The lazy update in <see cref="GetTransform"/> writes the cache, so objects that are read
+	///		from several threads should be flushed before, see <see cref="FlushTransforms"/>. </remarks>
+	void UpdateTransform() const;
+
+	/// <summary> True if the cached transformation matrix is out of date. </summary>
+	bool IsTransformDirty() const { return m_transformDirty; }
+
 
 	// Relative transforms
 
@@ -320,6 +332,10 @@ protected:
 
 	// Homogeneous transform.
 	VectorT position;
+
+	// Composition of the above.
+	mutable MatHomT m_transform;
+	mutable bool m_transformDirty = true;
 };
 
 
@@ -388,11 +404,13 @@ protected:
 template <class T, int Dim>
 void Transformable23Base<T, Dim>::SetPosition(const VectorT& pos) {
 	position = pos;
+	m_transformDirty = true;
 }
 
 template <class T, int Dim>
 void Transformable23Base<T, Dim>::SetRotation(const RotT& rot) {
 	rotation2 = CombineRotations(InvertRotation(rotation1), rot);
+	m_transformDirty = true;
 }
 
 template <class T, int Dim>
@@ -401,6 +419,7 @@ void Transformable23Base<T, Dim>::SetScale(const VectorT& scale) {
 	// We just change the singular values because that's the fastest.
 	// Optionally we could reset rot1 and set rot2' = rot2*rot1 (quat mul).
 	this->scale = scale;
+	m_transformDirty = true;
 }
 
 
@@ -423,6 +442,7 @@ void Transformable23Base<T, Dim>::SetLinearTransform(const MatLinT& transform) {
 		rotation2 = FromRotationMatrix(U);
 		rotation1 = FromRotationMatrix(V);
 	}
+	m_transformDirty = true;
 }
 
 template <class T, int Dim>
@@ -434,6 +454,7 @@ void Transformable23Base<T, Dim>::SetTransform(const MatHomT& transform) {
 	for (int i = 0; i<Dim; ++i) {
 		position(i) = Indexer(Dim, i);
 	}
+	m_transformDirty = true;
 
 	// Set linear part.
 	SetLinearTransform(transform.Submatrix<Dim, Dim>(0, 0));
@@ -452,10 +473,17 @@ typename Transformable23Base<T, Dim>::MatLinT Transformable23Base<T, Dim>::GetLi
 
 template <class T, int Dim>
 typename Transformable23Base<T, Dim>::MatHomT Transformable23Base<T, Dim>::GetTransform() const {
-	MatLinT linear = GetLinearTransform();
-	MatHomT tr = MatHomT::Translation(position);
-	tr.Submatrix<Dim, Dim>(0, 0) = linear;
-	return tr;
+	UpdateTransform();
+	return m_transform;
+}
+
+template <class T, int Dim>
+void Transformable23Base<T, Dim>::UpdateTransform() const {
+	if (m_transformDirty) {
+		m_transform = MatHomT::Translation(position);
+		m_transform.template Submatrix<Dim, Dim>(0, 0) = GetLinearTransform();
+		m_transformDirty = false;
+	}
 }
 
 
@@ -463,12 +491,14 @@ typename Transformable23Base<T, Dim>::MatHomT Transformable23Base<T, Dim>::GetTr
 template <class T, int Dim>
 void Transformable23Base<T, Dim>::Move(const VectorT& offset) {
 	position += offset;
+	m_transformDirty = true;
 }
 
 template <class T, int Dim>
 void Transformable23Base<T, Dim>::Rotate(const RotT& rot) {
 	rotation2 = CombineRotations(rotation2, rot);
 	position = RotateVector(position, rot);
+	m_transformDirty = true;
 }
 
 template <class T, int Dim>
@@ -524,6 +554,24 @@ typename Transformable23Base<T, Dim>::MatHomT Transformable23Base<T, Dim>::Motio
 
 
 
+/// <summary> Recomposes the cached transformation matrices of a range of transformable objects. </summary>
+/// <remarks> Meant to run once before the objects are read concurrently, so that
+///		<see cref="Transformable23Base::GetTransform"/> only reads the caches.
+///		The range may hold objects or pointers to objects. </remarks>
+template <class Iter>
+void FlushTransforms(Iter first, Iter last) {
+	for (; first != last; ++first) {
+		if constexpr (std::is_pointer_v<typename std::iterator_traits<Iter>::value_type>) {
+			(*first)->UpdateTransform();
+		}
+		else {
+			first->UpdateTransform();
+		}
+	}
+}
+
+
+
 //------------------------------------------------------------------------------
 // Motion methods
 //------------------------------------------------------------------------------
@@ -55,6 +55,31 @@ CapsResourceHeaps CapabilityQuery::QueryResourceHeaps() const {
 }
 
 
+CapsVariableRateShading CapabilityQuery::QueryVariableRateShading() const {
+	// Older SDKs, like that of AppVeyor, don't know about variable rate shading.
+#ifdef __ID3D12GraphicsCommandList5_INTERFACE_DEFINED__
+	D3D12_FEATURE_DATA_D3D12_OPTIONS6 options6 = {};
+	if (FAILED(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS6, &options6, sizeof(options6)))) {
+		return {};
+	}
+
+	CapsVariableRateShading caps;
+	switch (options6.VariableShadingRateTier) {
+		case D3D12_VARIABLE_SHADING_RATE_TIER_1: caps = CapsVariableRateShading::Dx12Tier1(); break;
+		case D3D12_VARIABLE_SHADING_RATE_TIER_2: caps = CapsVariableRateShading::Dx12Tier2(); break;
+		default: return {};
+	}
+	caps.additionalRates = options6.AdditionalShadingRatesSupported == TRUE;
+	if (caps.shadingRateImage) {
+		caps.imageTileSize = options6.ShadingRateImageTileSize;
+	}
+	return caps;
+#else
+	return {};
+#endif
+}
+
+
 CapsAdditional CapabilityQuery::QueryAdditional() const {
 	CapsAdditional caps;
 	
@@ -71,6 +96,13 @@ CapsAdditional CapabilityQuery::QueryAdditional() const {
 	caps.virtualAddressBitsPerProcess = address.MaxGPUVirtualAddressBitsPerProcess;
 	caps.shaderModelMajor = (unsigned)shader.HighestShaderModel >> 4;
 	caps.shaderModelMinor = (unsigned)shader.HighestShaderModel & 0b1111;
+	caps.crossAdapterRowMajorTextures = options.CrossAdapterRowMajorTextureSupported == TRUE;
+	switch (options.CrossNodeSharingTier) {
+		case D3D12_CROSS_NODE_SHARING_TIER_1_EMULATED: caps.crossNodeSharingTier = 1; break;
+		case D3D12_CROSS_NODE_SHARING_TIER_1: caps.crossNodeSharingTier = 1; break;
+		case D3D12_CROSS_NODE_SHARING_TIER_2: caps.crossNodeSharingTier = 2; break;
+		default: caps.crossNodeSharingTier = 0; break;
+	}
 
 	return caps;
 }
@@ -156,6 +188,7 @@ bool CapabilityQuery::SupportsAll(const CapsRequirementSet& requiredFeatures) co
 	CapsTiledResources tiledResources = QueryTiledResources();
 	CapsConservativeRasterization conservativeRasterization = QueryConservativeRasterization();
 	CapsResourceHeaps resourceHeaps = QueryResourceHeaps();
+	CapsVariableRateShading variableRateShading = QueryVariableRateShading();
 	CapsAdditional additional = QueryAdditional();
 	CapsLimits limits = QueryLimits();
 
@@ -164,6 +197,7 @@ bool CapabilityQuery::SupportsAll(const CapsRequirementSet& requiredFeatures) co
 		&& tiledResources >= requiredFeatures.tiledResources
 		&& conservativeRasterization >= requiredFeatures.conservativeRasterization
 		&& resourceHeaps >= requiredFeatures.resourceHeaps
+		&& variableRateShading >= requiredFeatures.variableRateShading
 		&& additional >= requiredFeatures.additional
 		&& limits >= requiredFeatures.limits;
 
@@ -21,6 +21,7 @@ public:
 	gxapi::CapsTiledResources QueryTiledResources() const override;
 	gxapi::CapsConservativeRasterization QueryConservativeRasterization() const override;
 	gxapi::CapsResourceHeaps QueryResourceHeaps() const override;
+	gxapi::CapsVariableRateShading QueryVariableRateShading() const override;
 	gxapi::CapsAdditional QueryAdditional() const override;
 	gxapi::CapsLimits QueryLimits() const override;
 	gxapi::eCapsFormatUsage QueryFormat(gxapi::eFormat format) const override;
@@ -5,6 +5,7 @@
 #include "ExceptionExpansions.hpp"
 
 #include "../GraphicsApi_LL/Common.hpp"
+#include "../GraphicsApi_LL/Exception.hpp"
 
 #include <vector>
 #include <cassert>
@@ -69,6 +70,7 @@ CopyCommandList::CopyCommandList(ComPtr<ID3D12GraphicsCommandList>& native)
 {
 
 	assert(native->GetType() == D3D12_COMMAND_LIST_TYPE_DIRECT ||
+		   native->GetType() == D3D12_COMMAND_LIST_TYPE_BUNDLE ||
 		   native->GetType() == D3D12_COMMAND_LIST_TYPE_COMPUTE ||
 		   native->GetType() == D3D12_COMMAND_LIST_TYPE_COPY);
 }
@@ -147,10 +149,11 @@ void CopyCommandList::CopyTexture(
 // barriers
 // TODO: transition, aliasing and bullshit barriers, i would put them into separate functions
 void CopyCommandList::ResourceBarrier(unsigned numBarriers, gxapi::ResourceBarrier* barriers) {
-	std::vector<D3D12_RESOURCE_BARRIER> nativeBarriers(numBarriers);
-	for (unsigned i = 0; i < numBarriers; i++) {
-		nativeBarriers[i] = native_cast(barriers[i]);
-	}
+	// Thread local to avoid allocations on each call.
+	thread_local std::vector<D3D12_RESOURCE_BARRIER> nativeBarriers;
+	nativeBarriers.resize(numBarriers);
+
+	native_cast(barriers, numBarriers, nativeBarriers.data());
 	m_native->ResourceBarrier(numBarriers, nativeBarriers.data());
 }
 
@@ -183,7 +186,12 @@ D3D12_TEXTURE_COPY_LOCATION CopyCommandList::CreateTextureCopyLocation(gxapi::IR
 				footprint.Format = native_cast(description.format);
 				footprint.Height = description.height;
 				footprint.Width = (UINT)description.width; // narrowing conversion!
-				size_t rowSize = size_t(GetFormatSizeInBytes(description.format)*description.width);
+				if (IsBlockCompressed(description.format)) {
+					// Footprints are made of whole blocks, even for the mips smaller than a block.
+					footprint.Width = (footprint.Width + 3) / 4 * 4;
+					footprint.Height = (footprint.Height + 3) / 4 * 4;
+				}
+				size_t rowSize = size_t(GetFormatRowSizeInBytes(description.format, description.width));
 				size_t alignement = D3D12_TEXTURE_DATA_PITCH_ALIGNMENT;
 				footprint.RowPitch = static_cast<UINT>(rowSize + (alignement - rowSize % alignement) % alignement);
 			}
@@ -219,6 +227,7 @@ ComputeCommandList::ComputeCommandList(ComPtr<ID3D12GraphicsCommandList>& native
 	: CopyCommandList(native)
 {
 	assert(native->GetType() == D3D12_COMMAND_LIST_TYPE_DIRECT ||
+		   native->GetType() == D3D12_COMMAND_LIST_TYPE_BUNDLE ||
 		   native->GetType() == D3D12_COMMAND_LIST_TYPE_COMPUTE);
 }
 
@@ -228,6 +237,21 @@ void ComputeCommandList::Dispatch(size_t numThreadGroupsX, size_t numThreadGroup
 	m_native->Dispatch((UINT)numThreadGroupsX, (UINT)numThreadGroupsY, (UINT)numThreadGroupsZ);
 }
 
+void ComputeCommandList::ExecuteIndirect(gxapi::ICommandSignature* commandSignature,
+										 unsigned maxCommandCount,
+										 gxapi::IResource* argumentBuffer,
+										 size_t argumentOffset,
+										 gxapi::IResource* countBuffer,
+										 size_t countOffset)
+{
+	m_native->ExecuteIndirect(native_cast(commandSignature),
+							  maxCommandCount,
+							  native_cast(argumentBuffer),
+							  argumentOffset,
+							  native_cast(countBuffer),
+							  countOffset);
+}
+
 
 // set graphics root signature stuff
 void ComputeCommandList::SetComputeRootConstant(unsigned parameterIndex, unsigned destOffset, uint32_t value) {
@@ -293,6 +317,24 @@ void ComputeCommandList::SetDescriptorHeaps(gxapi::IDescriptorHeap*const * heaps
 }
 
 
+// queries
+static_assert(sizeof(gxapi::PipelineStatistics) == sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS), "Resolved statistics are read as gxapi structures.");
+
+void ComputeCommandList::BeginQuery(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned index) {
+	m_native->BeginQuery(native_cast(queryHeap), native_cast(type), index);
+}
+
+
+void ComputeCommandList::EndQuery(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned index) {
+	m_native->EndQuery(native_cast(queryHeap), native_cast(type), index);
+}
+
+
+void ComputeCommandList::ResolveQueryData(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned first, unsigned count, gxapi::IResource* destination, size_t destinationOffset) {
+	m_native->ResolveQueryData(native_cast(queryHeap), native_cast(type), first, count, native_cast(destination), destinationOffset);
+}
+
+
 //------------------------------------------------------------------------------
 // Graphics command list
 //------------------------------------------------------------------------------
@@ -302,7 +344,10 @@ void ComputeCommandList::SetDescriptorHeaps(gxapi::IDescriptorHeap*const * heaps
 GraphicsCommandList::GraphicsCommandList(ComPtr<ID3D12GraphicsCommandList>& native)
 	: ComputeCommandList(native)
 {
-	assert(native->GetType() == D3D12_COMMAND_LIST_TYPE_DIRECT);
+	assert(native->GetType() == D3D12_COMMAND_LIST_TYPE_DIRECT || native->GetType() == D3D12_COMMAND_LIST_TYPE_BUNDLE);
+#ifdef __ID3D12GraphicsCommandList5_INTERFACE_DEFINED__
+	native.As(&m_native5);
+#endif
 }
 
 
@@ -459,6 +504,36 @@ void GraphicsCommandList::SetViewports(unsigned numViewports, gxapi::Viewport* v
 }
 
 
+// variable rate shading
+void GraphicsCommandList::SetShadingRate(gxapi::eShadingRate baseRate, const gxapi::eShadingRateCombiner* combiners) {
+#ifdef __ID3D12GraphicsCommandList5_INTERFACE_DEFINED__
+	if (!m_native5) {
+		throw NotSupportedException("Variable rate shading is not supported by the runtime.");
+	}
+	D3D12_SHADING_RATE_COMBINER nativeCombiners[2] = { D3D12_SHADING_RATE_COMBINER_PASSTHROUGH, D3D12_SHADING_RATE_COMBINER_PASSTHROUGH };
+	if (combiners) {
+		nativeCombiners[0] = native_cast(combiners[0]);
+		nativeCombiners[1] = native_cast(combiners[1]);
+	}
+	m_native5->RSSetShadingRate(native_cast(baseRate), nativeCombiners);
+#else
+	throw NotSupportedException("Variable rate shading is not supported by the SDK the engine was built with.");
+#endif
+}
+
+
+void GraphicsCommandList::SetShadingRateImage(gxapi::IResource* image) {
+#ifdef __ID3D12GraphicsCommandList5_INTERFACE_DEFINED__
+	if (!m_native5) {
+		throw NotSupportedException("Variable rate shading is not supported by the runtime.");
+	}
+	m_native5->RSSetShadingRateImage(image ? native_cast(image) : nullptr);
+#else
+	throw NotSupportedException("Variable rate shading is not supported by the SDK the engine was built with.");
+#endif
+}
+
+
 // set graphics root signature stuff
 void GraphicsCommandList::SetGraphicsRootConstant(unsigned parameterIndex, unsigned destOffset, uint32_t value) {
 	m_native->SetGraphicsRoot32BitConstant(parameterIndex, value, destOffset);
@@ -108,6 +108,13 @@ public:
 	// draw
 	void Dispatch(size_t dimx, size_t dimy = 1, size_t dimz = 1) override;
 
+	void ExecuteIndirect(gxapi::ICommandSignature* commandSignature,
+						 unsigned maxCommandCount,
+						 gxapi::IResource* argumentBuffer,
+						 size_t argumentOffset,
+						 gxapi::IResource* countBuffer = nullptr,
+						 size_t countOffset = 0) override;
+
 	// set compute root signature stuff
 	void SetComputeRootConstant(unsigned parameterIndex, unsigned destOffset, uint32_t value) override;
 	void SetComputeRootConstants(unsigned parameterIndex, unsigned destOffset, unsigned numValues, const uint32_t* value) override;
@@ -124,6 +131,11 @@ public:
 
 	// descriptor heaps
 	void SetDescriptorHeaps(gxapi::IDescriptorHeap*const * heaps, uint32_t count) override;
+
+	// queries
+	void BeginQuery(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned index) override;
+	void EndQuery(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned index) override;
+	void ResolveQueryData(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned first, unsigned count, gxapi::IResource* destination, size_t destinationOffset) override;
 };
 
 
@@ -185,6 +197,11 @@ public:
 	void SetViewports(unsigned numViewports, gxapi::Viewport* viewports) override;
 
 
+	// variable rate shading
+	void SetShadingRate(gxapi::eShadingRate baseRate, const gxapi::eShadingRateCombiner* combiners = nullptr) override;
+	void SetShadingRateImage(gxapi::IResource* image) override;
+
+
 	// set graphics root signature stuff
 	void SetGraphicsRootConstant(unsigned parameterIndex, unsigned destOffset, uint32_t value) override;
 	void SetGraphicsRootConstants(unsigned parameterIndex, unsigned destOffset, unsigned numValues, const uint32_t* value) override;
@@ -193,6 +210,11 @@ public:
 	void SetGraphicsRootShaderResource(unsigned parameterIndex, void* gpuVirtualAddress) override;
 
 	void SetGraphicsRootSignature(gxapi::IRootSignature* rootSignature) override;
+
+private:
+#ifdef __ID3D12GraphicsCommandList5_INTERFACE_DEFINED__
+	ComPtr<ID3D12GraphicsCommandList5> m_native5; // Null if the runtime has no variable rate shading.
+#endif
 };
 
 
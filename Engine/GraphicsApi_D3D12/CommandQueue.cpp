@@ -51,10 +51,52 @@ void CommandQueue::Wait(gxapi::IFence* fence, uint64_t value) {
 	ThrowIfFailed(m_native->Wait(native_cast(fence), value));
 }
 
+
+void CommandQueue::UpdateTileMappings(gxapi::IResource* resource,
+									  uint32_t numRegions,
+									  const gxapi::TiledResourceCoordinate* regionCoordinates,
+									  const gxapi::TileRegionSize* regionSizes,
+									  gxapi::IHeap* heap,
+									  uint32_t numRanges,
+									  const gxapi::TileRange* ranges) {
+	std::vector<D3D12_TILED_RESOURCE_COORDINATE> nativeCoordinates(numRegions);
+	std::vector<D3D12_TILE_REGION_SIZE> nativeSizes(numRegions);
+	for (uint32_t i = 0; i < numRegions; ++i) {
+		nativeCoordinates[i] = { regionCoordinates[i].x, regionCoordinates[i].y, regionCoordinates[i].z, regionCoordinates[i].subresource };
+		nativeSizes[i] = { regionSizes[i].numTiles, regionSizes[i].useBox, regionSizes[i].width, regionSizes[i].height, regionSizes[i].depth };
+	}
+
+	std::vector<D3D12_TILE_RANGE_FLAGS> nativeFlags(numRanges);
+	std::vector<UINT> heapOffsets(numRanges);
+	std::vector<UINT> tileCounts(numRanges);
+	for (uint32_t i = 0; i < numRanges; ++i) {
+		nativeFlags[i] = native_cast(ranges[i].flags);
+		heapOffsets[i] = ranges[i].heapTileOffset;
+		tileCounts[i] = ranges[i].numTiles;
+	}
+
+	m_native->UpdateTileMappings(native_cast(resource),
+								 numRegions,
+								 nativeCoordinates.data(),
+								 nativeSizes.data(),
+								 native_cast(heap),
+								 numRanges,
+								 nativeFlags.data(),
+								 heapOffsets.data(),
+								 tileCounts.data(),
+								 D3D12_TILE_MAPPING_FLAG_NONE);
+}
+
 gxapi::CommandQueueDesc CommandQueue::GetDesc() const {
 	return native_cast(m_native->GetDesc());
 }
 
+uint64_t CommandQueue::GetTimestampFrequency() const {
+	UINT64 frequency;
+	ThrowIfFailed(m_native->GetTimestampFrequency(&frequency));
+	return frequency;
+}
+
 
 void CommandQueue::BeginDebuggerEvent(const std::string& name) const {
 	PIXBeginEvent(m_native.Get(), PIX_COLOR_DEFAULT, name.c_str());
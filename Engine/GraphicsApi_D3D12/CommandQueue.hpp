@@ -27,7 +27,16 @@ public:
 	void Signal(gxapi::IFence* fence, uint64_t value) override;
 	void Wait(gxapi::IFence* fence, uint64_t value) override;
 
+	void UpdateTileMappings(gxapi::IResource* resource,
+							uint32_t numRegions,
+							const gxapi::TiledResourceCoordinate* regionCoordinates,
+							const gxapi::TileRegionSize* regionSizes,
+							gxapi::IHeap* heap,
+							uint32_t numRanges,
+							const gxapi::TileRange* ranges) override;
+
 	gxapi::CommandQueueDesc GetDesc() const override;
+	uint64_t GetTimestampFrequency() const override;
 
 	void BeginDebuggerEvent(const std::string& name) const override;
 	void EndDebuggerEvent() const override;
@@ -0,0 +1,17 @@
+#include "CommandSignature.hpp"
+
+namespace inl {
+namespace gxapi_dx12 {
+
+CommandSignature::CommandSignature(ComPtr<ID3D12CommandSignature>& native)
+	: m_native{native} {
+}
+
+
+ID3D12CommandSignature* CommandSignature::GetNative() {
+	return m_native.Get();
+}
+
+
+} // namespace gxapi_dx12
+} // namespace inl
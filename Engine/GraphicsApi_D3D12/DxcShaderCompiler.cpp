@@ -0,0 +1,269 @@
+#include "DxcShaderCompiler.hpp"
+
+#include "../GraphicsApi_LL/Exception.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <wrl.h>
+#include <d3d12.h>
+#if __has_include(<dxcapi.h>)
+#include <dxcapi.h>
+#define INL_HAS_DXC 1
+#endif
+#include "../GraphicsApi_LL/DisableWin32Macros.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+using Microsoft::WRL::ComPtr;
+
+using namespace inl::gxapi;
+
+
+namespace inl {
+namespace gxapi_dx12 {
+
+
+static std::wstring Widen(const std::string& str) {
+	if (str.empty()) {
+		return {};
+	}
+	int length = MultiByteToWideChar(CP_UTF8, 0, str.data(), (int)str.size(), nullptr, 0);
+	std::wstring result(length, L'\0');
+	MultiByteToWideChar(CP_UTF8, 0, str.data(), (int)str.size(), result.data(), length);
+	return result;
+}
+
+
+static std::string Narrow(const wchar_t* str) {
+	int length = WideCharToMultiByte(CP_UTF8, 0, str, -1, nullptr, 0, nullptr, nullptr);
+	if (length <= 1) {
+		return {};
+	}
+	std::string result(length - 1, '\0');
+	WideCharToMultiByte(CP_UTF8, 0, str, -1, result.data(), length, nullptr, nullptr);
+	return result;
+}
+
+
+std::wstring DxcShaderCompiler::GetTarget(gxapi::eShaderType type, gxapi::eShaderModel shaderModel) {
+	std::wstring target;
+	switch (type) {
+		case eShaderType::VERTEX: target = L"vs"; break;
+		case eShaderType::PIXEL: target = L"ps"; break;
+		case eShaderType::DOMAIN: target = L"ds"; break;
+		case eShaderType::HULL: target = L"hs"; break;
+		case eShaderType::GEOMETRY: target = L"gs"; break;
+		case eShaderType::COMPUTE: target = L"cs"; break;
+	}
+	int minor = std::max(0, int(shaderModel) - int(eShaderModel::SM_6_0));
+	return target + L"_6_" + std::to_wstring(minor);
+}
+
+
+#ifdef INL_HAS_DXC
+
+
+static DxcCreateInstanceProc GetDxcCreateInstance() {
+	// Loaded once and kept, the module is thread safe.
+	static DxcCreateInstanceProc createInstance = []() -> DxcCreateInstanceProc {
+		HMODULE module = LoadLibraryW(L"dxcompiler.dll");
+		return module ? (DxcCreateInstanceProc)GetProcAddress(module, "DxcCreateInstance") : nullptr;
+	}();
+	if (!createInstance) {
+		throw ShaderCompilationError("Shader model 6 needs the DirectX Shader Compiler, but dxcompiler.dll was not found.");
+	}
+	return createInstance;
+}
+
+
+class DxcIncludeProvider : public IDxcIncludeHandler {
+public:
+	DxcIncludeProvider(IDxcUtils* utils, IShaderIncludeProvider* userProvider) : utils(utils), userProvider(userProvider) {}
+	virtual ~DxcIncludeProvider() {}
+
+	HRESULT STDMETHODCALLTYPE LoadSource(LPCWSTR pFilename, IDxcBlob** ppIncludeSource) override {
+		*ppIncludeSource = nullptr;
+
+		// DXC makes the names relative to the including file, the user provider looks them up as written.
+		std::string name = Narrow(pFilename);
+		if (name.compare(0, 2, "./") == 0 || name.compare(0, 2, ".\\") == 0) {
+			name = name.substr(2);
+		}
+
+		// search in cache, the blobs point into it
+		auto it = cache.find(name);
+		if (it == cache.end()) {
+			std::string includeData;
+			try {
+				includeData = userProvider->LoadInclude(name.c_str(), false);
+			}
+			catch (...) {
+				return E_FAIL;
+			}
+			it = cache.insert({ name, std::move(includeData) }).first;
+		}
+
+		ComPtr<IDxcBlobEncoding> blob;
+		HRESULT hr = utils->CreateBlobFromPinned(it->second.data(), (UINT32)it->second.size(), DXC_CP_UTF8, &blob);
+		if (FAILED(hr)) {
+			return hr;
+		}
+		*ppIncludeSource = blob.Detach();
+		return S_OK;
+	}
+
+	// Lives on the stack for a single compilation, it is not reference counted.
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override {
+		if (riid == __uuidof(IDxcIncludeHandler) || riid == __uuidof(IUnknown)) {
+			*ppvObject = static_cast<IDxcIncludeHandler*>(this);
+			return S_OK;
+		}
+		*ppvObject = nullptr;
+		return E_NOINTERFACE;
+	}
+	ULONG STDMETHODCALLTYPE AddRef() override { return 1; }
+	ULONG STDMETHODCALLTYPE Release() override { return 1; }
+
+private:
+	std::unordered_map<std::string, std::string> cache;
+	IDxcUtils* utils;
+	IShaderIncludeProvider* userProvider;
+};
+
+
+gxapi::ShaderProgramBinary DxcShaderCompiler::Compile(const std::string& source,
+													  const std::string& fileName,
+													  const char* mainFunction,
+													  gxapi::eShaderType type,
+													  gxapi::eShaderModel shaderModel,
+													  gxapi::eShaderCompileFlags flags,
+													  gxapi::IShaderIncludeProvider* includeProvider,
+													  const std::vector<gxapi::ShaderMacroDefinition>& macros)
+{
+	DxcCreateInstanceProc createInstance = GetDxcCreateInstance();
+	ComPtr<IDxcUtils> utils;
+	ComPtr<IDxcCompiler3> compiler;
+	if (FAILED(createInstance(CLSID_DxcUtils, IID_PPV_ARGS(&utils))) || FAILED(createInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler)))) {
+		throw ShaderCompilationError("Failed to create the DirectX Shader Compiler.");
+	}
+
+	// The arguments are kept as strings, the compiler takes pointers to them.
+	std::vector<std::wstring> arguments = {
+		Widen(fileName.empty() ? "shader.hlsl" : fileName),
+		L"-E", Widen(mainFunction),
+		L"-T", GetTarget(type, shaderModel),
+		L"-Wno-unknown-pragmas", // Such as the shader model the shader asks for.
+	};
+	for (auto& macro : macros) {
+		arguments.push_back(L"-D");
+		arguments.push_back(Widen(macro.value.empty() ? macro.name : macro.name + "=" + macro.value));
+	}
+	if (flags & eShaderCompileFlags::DEBUG) {
+		arguments.insert(arguments.end(), { L"-Zi", L"-Qstrip_debug" });
+	}
+	if (flags & eShaderCompileFlags::NO_OPTIMIZATION) {
+		arguments.push_back(L"-Od");
+	}
+	else if (flags & eShaderCompileFlags::OPTIMIZATION_LOW) {
+		arguments.push_back(L"-O1");
+	}
+	else if (flags & eShaderCompileFlags::OPTIMIZATION_MEDIUM) {
+		arguments.push_back(L"-O2");
+	}
+	else if (flags & eShaderCompileFlags::OPTIMIZATION_HIGH) {
+		arguments.push_back(L"-O3");
+	}
+	if (flags & eShaderCompileFlags::COLUMN_MAJOR_MATRICES) {
+		arguments.push_back(L"-Zpc");
+	}
+	if (flags & eShaderCompileFlags::ROW_MAJOR_MATRICES) {
+		arguments.push_back(L"-Zpr");
+	}
+	if (flags & eShaderCompileFlags::FORCE_IEEE) {
+		arguments.push_back(L"-Gis");
+	}
+	if (flags & eShaderCompileFlags::WARNINGS_AS_ERRORS) {
+		arguments.push_back(L"-WX");
+	}
+	if ((flags & eShaderCompileFlags::NATIVE_16BIT_TYPES) && shaderModel >= eShaderModel::SM_6_2) {
+		arguments.push_back(L"-enable-16bit-types");
+	}
+
+	std::vector<LPCWSTR> argumentPointers;
+	for (auto& argument : arguments) {
+		argumentPointers.push_back(argument.c_str());
+	}
+
+	DxcBuffer sourceBuffer;
+	sourceBuffer.Ptr = source.data();
+	sourceBuffer.Size = source.size();
+	sourceBuffer.Encoding = DXC_CP_UTF8;
+
+	ComPtr<IDxcIncludeHandler> defaultIncludeHandler;
+	DxcIncludeProvider dxcIncludeProvider(utils.Get(), includeProvider);
+	IDxcIncludeHandler* includeHandler = &dxcIncludeProvider;
+	if (!includeProvider) {
+		utils->CreateDefaultIncludeHandler(&defaultIncludeHandler);
+		includeHandler = defaultIncludeHandler.Get();
+	}
+
+	ComPtr<IDxcResult> result;
+	HRESULT hr = compiler->Compile(&sourceBuffer, argumentPointers.data(), (UINT32)argumentPointers.size(), includeHandler, IID_PPV_ARGS(&result));
+	if (SUCCEEDED(hr)) {
+		result->GetStatus(&hr);
+	}
+	if (FAILED(hr)) {
+		ComPtr<IDxcBlobUtf8> errors;
+		if (result && SUCCEEDED(result->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&errors), nullptr)) && errors && errors->GetStringLength() > 0) {
+			throw ShaderCompilationError("Shader compilation failed.", std::string(errors->GetStringPointer(), errors->GetStringLength()));
+		}
+		throw ShaderCompilationError("Shader compilation failed, but DXC did not give an error message.");
+	}
+
+	ShaderProgramBinary ret;
+	ComPtr<IDxcBlob> object;
+	if (FAILED(result->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&object), nullptr)) || !object) {
+		throw ShaderCompilationError("DXC did not return the binary.");
+	}
+	ret.data.resize(object->GetBufferSize());
+	memcpy(ret.data.data(), object->GetBufferPointer(), ret.data.size());
+
+	if (result->HasOutput(DXC_OUT_PDB)) {
+		ComPtr<IDxcBlob> pdb;
+		ComPtr<IDxcBlobUtf16> pdbName;
+		if (SUCCEEDED(result->GetOutput(DXC_OUT_PDB, IID_PPV_ARGS(&pdb), &pdbName)) && pdb) {
+			ret.debugInfo.resize(pdb->GetBufferSize());
+			memcpy(ret.debugInfo.data(), pdb->GetBufferPointer(), ret.debugInfo.size());
+			if (pdbName) {
+				ret.debugName = Narrow(pdbName->GetStringPointer());
+			}
+		}
+	}
+
+	return ret;
+}
+
+
+#else
+
+
+gxapi::ShaderProgramBinary DxcShaderCompiler::Compile(const std::string&,
+													  const std::string&,
+													  const char*,
+													  gxapi::eShaderType,
+													  gxapi::eShaderModel,
+													  gxapi::eShaderCompileFlags,
+													  gxapi::IShaderIncludeProvider*,
+													  const std::vector<gxapi::ShaderMacroDefinition>&)
+{
+	throw ShaderCompilationError("Shader model 6 needs the DirectX Shader Compiler, but the engine was built without dxcapi.h.");
+}
+
+
+#endif
+
+
+} // namespace gxapi_dx12
+} // namespace inl
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../GraphicsApi_LL/IGxapiManager.hpp"
+
+#include <string>
+#include <vector>
+
+
+namespace inl {
+namespace gxapi_dx12 {
+
+
+/// <summary> Compiles shader model 6 shaders to DXIL with the DirectX Shader Compiler. </summary>
+/// <remarks>
+/// dxcompiler.dll is loaded on first use, so setups that only compile shader model 5.1 don't need it.
+/// Every compilation makes its own compiler, DXC's instances must not be shared between threads.
+/// With <see cref="gxapi::eShaderCompileFlags::DEBUG"/>, the debug info is stripped into a separate PDB,
+/// the binary only refers to it by name. Reflection stays in the binary.
+/// </remarks>
+class DxcShaderCompiler {
+public:
+	/// <param name="fileName"> Shown in compilation errors, includes are resolved relative to it if there is no include provider. </param>
+	/// <exception cref="ShaderCompilationError"> If compilation failed, or DXC is not available. </exception>
+	static gxapi::ShaderProgramBinary Compile(const std::string& source,
+											  const std::string& fileName,
+											  const char* mainFunction,
+											  gxapi::eShaderType type,
+											  gxapi::eShaderModel shaderModel,
+											  gxapi::eShaderCompileFlags flags,
+											  gxapi::IShaderIncludeProvider* includeProvider,
+											  const std::vector<gxapi::ShaderMacroDefinition>& macros);
+
+	/// <summary> The profile, such as cs_6_6. </summary>
+	static std::wstring GetTarget(gxapi::eShaderType type, gxapi::eShaderModel shaderModel);
+};
+
+
+} // namespace gxapi_dx12
+} // namespace inl
@@ -11,8 +11,8 @@ namespace gxapi_dx12 {
 thread_local Fence::EventHelper Fence::threadEvent;
 
 
-Fence::Fence(ComPtr<ID3D12Fence>& native)
-	: m_native(native) {
+Fence::Fence(ComPtr<ID3D12Fence>& native, std::shared_ptr<FenceWatcher> watcher)
+	: m_native(native), m_watcher(std::move(watcher)) {
 }
 
 
@@ -53,6 +53,11 @@ void Fence::WaitAll(const IFence** fences, uint64_t* values, size_t count, uint6
 }
 
 
+void Fence::OnCompletion(uint64_t value, std::function<void()> callback) const {
+	m_watcher->Watch(m_native.Get(), value, std::move(callback));
+}
+
+
 void Fence::WaitMultiple(const IFence** fences, uint64_t* values, size_t count, uint64_t timeoutMillis, bool all) const {
 	HANDLE evt = threadEvent.evt;
 	ComPtr<ID3D12Device1> device;
@@ -3,7 +3,9 @@
 #include "../GraphicsApi_LL/IFence.hpp"
 #include "../GraphicsApi_LL/Exception.hpp"
 #include "ExceptionExpansions.hpp"
+#include "FenceWatcher.hpp"
 
+#include <memory>
 #include <utility>
 
 #define WIN32_LEAN_AND_MEAN
@@ -39,7 +41,7 @@ class Fence : public gxapi::IFence {
 		HANDLE evt;
 	};
 public:
-	Fence(ComPtr<ID3D12Fence>& native);
+	Fence(ComPtr<ID3D12Fence>& native, std::shared_ptr<FenceWatcher> watcher);
 	Fence(const Fence&) = delete;
 	Fence& operator=(Fence&) = delete;
 
@@ -50,10 +52,12 @@ public:
 	void Wait(uint64_t value, uint64_t timeoutMillis = FOREVER) const override;
 	void WaitAny(const IFence** fences, uint64_t* values, size_t count, uint64_t timeoutMillis = FOREVER) const override;
 	void WaitAll(const IFence** fences, uint64_t* values, size_t count, uint64_t timeoutMillis = FOREVER) const override;
+	void OnCompletion(uint64_t value, std::function<void()> callback) const override;
 private:
 	void WaitMultiple(const IFence** fences, uint64_t* values, size_t count, uint64_t timeoutMillis, bool all) const;
 protected:
 	ComPtr<ID3D12Fence> m_native;
+	std::shared_ptr<FenceWatcher> m_watcher;
 	static thread_local EventHelper threadEvent;
 };
 
@@ -0,0 +1,127 @@
+#include "FenceWatcher.hpp"
+
+#include "../GraphicsApi_LL/Exception.hpp"
+#include "ExceptionExpansions.hpp"
+
+#include <algorithm>
+
+
+namespace inl {
+namespace gxapi_dx12 {
+
+
+FenceWatcher::FenceWatcher() {
+	m_wakeEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	if (m_wakeEvent == NULL) {
+		throw RuntimeException("Failed to create internal Win32 event.");
+	}
+	m_thread = std::thread([this] { Run(); });
+}
+
+
+FenceWatcher::~FenceWatcher() {
+	{
+		std::lock_guard lk(m_mtx);
+		m_stop = true;
+	}
+	Wake();
+	m_thread.join();
+
+	for (auto& watched : m_fences) {
+		CloseHandle(watched->event);
+	}
+	CloseHandle(m_wakeEvent);
+}
+
+
+void FenceWatcher::Watch(ID3D12Fence* fence, uint64_t value, std::function<void()> callback) {
+	if (fence->GetCompletedValue() >= value) {
+		callback();
+		return;
+	}
+
+	std::lock_guard lk(m_mtx);
+	auto it = std::find_if(m_fences.begin(), m_fences.end(), [fence](const auto& watched) {
+		return watched->fence.Get() == fence;
+	});
+	if (it == m_fences.end()) {
+		if (m_fences.size() >= MaxFences) {
+			throw NotSupportedException("Too many fences are watched at the same time.");
+		}
+		auto watched = std::make_unique<WatchedFence>();
+		watched->fence = fence;
+		watched->event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+		if (watched->event == NULL) {
+			throw RuntimeException("Failed to create internal Win32 event.");
+		}
+		it = m_fences.insert(m_fences.end(), std::move(watched));
+		Wake(); // The thread has to wait on the new event too.
+	}
+
+	// Each value sets the same event, the thread checks every fence when it wakes anyway.
+	WatchedFence& watched = **it;
+	ThrowIfFailed(watched.fence->SetEventOnCompletion(value, watched.event));
+	watched.callbacks.insert({ value, std::move(callback) });
+}
+
+
+void FenceWatcher::Run() {
+	std::vector<HANDLE> events;
+	std::vector<std::function<void()>> completed;
+
+	while (true) {
+		{
+			std::lock_guard lk(m_mtx);
+			if (m_stop) {
+				return;
+			}
+			CollectCompleted(completed);
+
+			events.clear();
+			events.push_back(m_wakeEvent);
+			for (auto& watched : m_fences) {
+				events.push_back(watched->event);
+			}
+		}
+
+		// Called without the lock so that callbacks may watch fences themselves.
+		for (auto& callback : completed) {
+			callback();
+		}
+		completed.clear();
+
+		WaitForMultipleObjects(DWORD(events.size()), events.data(), FALSE, INFINITE);
+	}
+}
+
+
+void FenceWatcher::CollectCompleted(std::vector<std::function<void()>>& completed) {
+	for (auto& watched : m_fences) {
+		const uint64_t completedValue = watched->fence->GetCompletedValue();
+		auto end = watched->callbacks.upper_bound(completedValue);
+		for (auto it = watched->callbacks.begin(); it != end; ++it) {
+			completed.push_back(std::move(it->second));
+		}
+		watched->callbacks.erase(watched->callbacks.begin(), end);
+	}
+
+	// Fences without callbacks are not waited on, which also releases them.
+	// Only this thread waits on the events, so closing them here is safe.
+	auto last = std::remove_if(m_fences.begin(), m_fences.end(), [](const auto& watched) {
+		if (watched->callbacks.empty()) {
+			CloseHandle(watched->event);
+			return true;
+		}
+		return false;
+	});
+	m_fences.erase(last, m_fences.end());
+}
+
+
+void FenceWatcher::Wake() {
+	SetEvent(m_wakeEvent);
+}
+
+
+} // namespace gxapi_dx12
+} // namespace inl
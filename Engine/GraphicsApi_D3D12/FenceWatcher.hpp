@@ -0,0 +1,66 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <wrl.h>
+#include <d3d12.h>
+#include "../GraphicsApi_LL/DisableWin32Macros.h"
+
+namespace inl {
+namespace gxapi_dx12 {
+
+
+/// <summary>
+/// Calls back when fences reach certain values, without having any thread wait on a single fence.
+/// </summary>
+/// <remarks>
+/// A single thread waits on the events of all watched fences at once via WaitForMultipleObjects.
+/// It only waits on a fence while it has callbacks pending, and at most
+/// <see cref="MaxFences"/> fences can have callbacks pending at the same time.
+/// Callbacks run on the watcher thread, so they must be short and must not throw.
+/// Callbacks still pending when the watcher is destroyed are dropped.
+/// </remarks>
+class FenceWatcher {
+public:
+	static constexpr size_t MaxFences = MAXIMUM_WAIT_OBJECTS - 1;
+
+	FenceWatcher();
+	~FenceWatcher();
+	FenceWatcher(const FenceWatcher&) = delete;
+	FenceWatcher& operator=(const FenceWatcher&) = delete;
+
+	/// <summary> Calls the callback once the fence has reached the value. </summary>
+	/// <remarks> Calls it right away on the calling thread if the fence is already there. </remarks>
+	void Watch(ID3D12Fence* fence, uint64_t value, std::function<void()> callback);
+
+private:
+	struct WatchedFence {
+		Microsoft::WRL::ComPtr<ID3D12Fence> fence;
+		HANDLE event = NULL;
+		std::multimap<uint64_t, std::function<void()>> callbacks; // Keyed by the fence value.
+	};
+
+	void Run();
+	void CollectCompleted(std::vector<std::function<void()>>& completed);
+	void Wake();
+
+private:
+	std::vector<std::unique_ptr<WatchedFence>> m_fences;
+	HANDLE m_wakeEvent = NULL;
+	bool m_stop = false;
+	std::mutex m_mtx;
+	std::thread m_thread;
+};
+
+
+} // namespace gxapi_dx12
+} // namespace inl
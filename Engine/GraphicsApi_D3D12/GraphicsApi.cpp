@@ -3,10 +3,15 @@
 #include "CommandQueue.hpp"
 #include "CommandAllocator.hpp"
 #include "CommandList.hpp"
+#include "CommandSignature.hpp"
 #include "DescriptorHeap.hpp"
 #include "NativeCast.hpp"
 #include "ExceptionExpansions.hpp"
 #include "CapabilityQuery.hpp"
+#include "PipelineStateCache.hpp"
+#include "Heap.hpp"
+#include "QueryHeap.hpp"
+#include "RootSignature.hpp"
 
 #include "../GraphicsApi_LL/Exception.hpp"
 
@@ -22,7 +27,8 @@ namespace inl {
 namespace gxapi_dx12 {
 
 
-GraphicsApi::GraphicsApi(Microsoft::WRL::ComPtr<ID3D12Device> device) : m_device(device) {
+GraphicsApi::GraphicsApi(Microsoft::WRL::ComPtr<ID3D12Device> device, Microsoft::WRL::ComPtr<IDXGIAdapter3> adapter)
+	: m_device(device), m_adapter(adapter), m_pipelineStateCache(device), m_fenceWatcher(std::make_shared<FenceWatcher>()) {
 	m_device->QueryInterface(IID_PPV_ARGS(&m_debugDevice));
 }
 
@@ -99,7 +105,7 @@ gxapi::ICommandList* GraphicsApi::CreateCommandList(gxapi::eCommandListType type
 	case inl::gxapi::eCommandListType::GRAPHICS:
 		return new GraphicsCommandList(native);
 	case inl::gxapi::eCommandListType::BUNDLE:
-		throw InvalidArgumentException("Bundles are not supported.");
+		return new GraphicsCommandList(native); // Bundles record the same commands, the debug layer rejects what they can't.
 	default:
 		assert(false);
 		throw InvalidArgumentException("What memory garbage did you even specify dumbass?", std::to_string((long long)type));
@@ -131,6 +137,66 @@ gxapi::IResource* GraphicsApi::CreateCommittedResource(gxapi::HeapProperties hea
 }
 
 
+gxapi::IHeap* GraphicsApi::CreateHeap(const gxapi::HeapDesc& desc) {
+	ComPtr<ID3D12Heap> native;
+
+	D3D12_HEAP_DESC nativeDesc;
+	nativeDesc.SizeInBytes = desc.size;
+	nativeDesc.Properties = native_cast(desc.properties);
+	nativeDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	nativeDesc.Flags = native_cast(desc.flags);
+
+	ThrowIfFailed(m_device->CreateHeap(&nativeDesc, IID_PPV_ARGS(&native)));
+
+	return new Heap{ native };
+}
+
+
+gxapi::IResource* GraphicsApi::CreatePlacedResource(gxapi::IHeap* heap,
+													uint64_t offset,
+													gxapi::ResourceDesc desc,
+													gxapi::eResourceState initialState,
+													gxapi::ClearValue* clearValue) {
+	ComPtr<ID3D12Resource> native;
+
+	D3D12_RESOURCE_DESC nativeResourceDesc = native_cast(desc);
+
+	D3D12_CLEAR_VALUE* pNativeClearValue = nullptr;
+	D3D12_CLEAR_VALUE nativeClearValue;
+	if (clearValue != nullptr) {
+		nativeClearValue = native_cast(*clearValue);
+		pNativeClearValue = &nativeClearValue;
+	}
+
+	ThrowIfFailed(m_device->CreatePlacedResource(native_cast(heap), offset, &nativeResourceDesc, native_cast(initialState), pNativeClearValue, IID_PPV_ARGS(&native)));
+
+	return new Resource{ native, m_device };
+}
+
+
+gxapi::IResource* GraphicsApi::CreateReservedResource(gxapi::ResourceDesc desc,
+													  gxapi::eResourceState initialState,
+													  gxapi::ClearValue* clearValue) {
+	ComPtr<ID3D12Resource> native;
+
+	D3D12_RESOURCE_DESC nativeResourceDesc = native_cast(desc);
+	if (nativeResourceDesc.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER) {
+		nativeResourceDesc.Layout = D3D12_TEXTURE_LAYOUT_64KB_UNDEFINED_SWIZZLE;
+	}
+
+	D3D12_CLEAR_VALUE* pNativeClearValue = nullptr;
+	D3D12_CLEAR_VALUE nativeClearValue;
+	if (clearValue != nullptr) {
+		nativeClearValue = native_cast(*clearValue);
+		pNativeClearValue = &nativeClearValue;
+	}
+
+	ThrowIfFailed(m_device->CreateReservedResource(&nativeResourceDesc, native_cast(initialState), pNativeClearValue, IID_PPV_ARGS(&native)));
+
+	return new Resource{ native, m_device };
+}
+
+
 gxapi::IRootSignature* GraphicsApi::CreateRootSignature(gxapi::RootSignatureDesc desc) {
 	ComPtr<ID3D12RootSignature> native;
 
@@ -211,7 +277,8 @@ gxapi::IRootSignature* GraphicsApi::CreateRootSignature(gxapi::RootSignatureDesc
 
 	ThrowIfFailed(m_device->CreateRootSignature(0, serializedSignature->GetBufferPointer(), serializedSignature->GetBufferSize(), IID_PPV_ARGS(&native)));
 
-	return new RootSignature{ native };
+	uint64_t hash = PipelineStateCache::Hash(serializedSignature->GetBufferPointer(), serializedSignature->GetBufferSize());
+	return new RootSignature{ native, hash };
 }
 
 
@@ -274,7 +341,7 @@ gxapi::IPipelineState* GraphicsApi::CreateGraphicsPipelineState(const gxapi::Gra
 	nativeDesc.Flags = desc.addDebugInfo ? D3D12_PIPELINE_STATE_FLAG_TOOL_DEBUG : D3D12_PIPELINE_STATE_FLAG_NONE;
 
 
-	ThrowIfFailed(m_device->CreateGraphicsPipelineState(&nativeDesc, IID_PPV_ARGS(&native)), "While creating graphics PSO");
+	native = m_pipelineStateCache.CreateGraphics(nativeDesc, GetRootSignatureHash(desc.rootSignature));
 
 	return new PipelineState{ native };
 }
@@ -290,13 +357,27 @@ gxapi::IPipelineState* GraphicsApi::CreateComputePipelineState(const gxapi::Comp
 	nativeDesc.NodeMask = 0;
 	nativeDesc.pRootSignature = native_cast(desc.rootSignature);
 
-	ComPtr<ID3D12PipelineState> native;
-	ThrowIfFailed(m_device->CreateComputePipelineState(&nativeDesc, IID_PPV_ARGS(&native)), "While creating compute PSO");
+	ComPtr<ID3D12PipelineState> native = m_pipelineStateCache.CreateCompute(nativeDesc, GetRootSignatureHash(desc.rootSignature));
 
 	return new PipelineState{ native };
 }
 
 
+void GraphicsApi::OpenPipelineCache(const std::string& path) {
+	m_pipelineStateCache.Open(path);
+}
+
+
+void GraphicsApi::SavePipelineCache() {
+	m_pipelineStateCache.Save();
+}
+
+
+uint64_t GraphicsApi::GetRootSignatureHash(gxapi::IRootSignature* rootSignature) {
+	return rootSignature ? static_cast<RootSignature*>(rootSignature)->GetHash() : 0;
+}
+
+
 gxapi::IDescriptorHeap* GraphicsApi::CreateDescriptorHeap(gxapi::DescriptorHeapDesc desc) {
 	ComPtr<ID3D12DescriptorHeap> native;
 
@@ -307,6 +388,41 @@ gxapi::IDescriptorHeap* GraphicsApi::CreateDescriptorHeap(gxapi::DescriptorHeapD
 }
 
 
+gxapi::ICommandSignature* GraphicsApi::CreateCommandSignature(const gxapi::CommandSignatureDesc& desc, gxapi::IRootSignature* rootSignature) {
+	ComPtr<ID3D12CommandSignature> native;
+
+	std::vector<D3D12_INDIRECT_ARGUMENT_DESC> nativeArguments;
+	nativeArguments.reserve(desc.arguments.size());
+	for (const auto& argument : desc.arguments) {
+		nativeArguments.push_back(native_cast(argument));
+	}
+
+	D3D12_COMMAND_SIGNATURE_DESC nativeDesc;
+	nativeDesc.ByteStride = desc.byteStride;
+	nativeDesc.NumArgumentDescs = (UINT)nativeArguments.size();
+	nativeDesc.pArgumentDescs = nativeArguments.data();
+	nativeDesc.NodeMask = 0;
+
+	ThrowIfFailed(m_device->CreateCommandSignature(&nativeDesc, native_cast(rootSignature), IID_PPV_ARGS(&native)));
+
+	return new CommandSignature{ native };
+}
+
+
+gxapi::IQueryHeap* GraphicsApi::CreateQueryHeap(const gxapi::QueryHeapDesc& desc) {
+	ComPtr<ID3D12QueryHeap> native;
+
+	D3D12_QUERY_HEAP_DESC nativeDesc;
+	nativeDesc.Type = native_cast(desc.type);
+	nativeDesc.Count = desc.count;
+	nativeDesc.NodeMask = 0;
+
+	ThrowIfFailed(m_device->CreateQueryHeap(&nativeDesc, IID_PPV_ARGS(&native)));
+
+	return new QueryHeap{ native };
+}
+
+
 void GraphicsApi::CreateConstantBufferView(gxapi::ConstantBufferViewDesc desc,
 										   gxapi::DescriptorHandle destination)
 {
@@ -434,14 +550,15 @@ void GraphicsApi::CopyDescriptors(size_t numSrcDescRanges,
 								  uint32_t * rangeCounts,
 								  gxapi::eDescriptorHeapType descHeapsType)
 {
-	std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> nativeDstRangeStarts(numDstDescRanges);
-	for (int i = 0; i < numDstDescRanges; i++) {
-		nativeDstRangeStarts[i].ptr = native_cast_ptr(dstRangeStarts[i].cpuAddress);
-	}
-	std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> nativeSrcRangeStarts(numSrcDescRanges);
-	for (int i = 0; i < numSrcDescRanges; i++) {
-		nativeSrcRangeStarts[i].ptr = native_cast_ptr(srcRangeStarts[i].cpuAddress);
-	}
+	// Thread local to avoid allocations on each call.
+	thread_local std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> nativeDstRangeStarts;
+	thread_local std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> nativeSrcRangeStarts;
+
+	nativeDstRangeStarts.resize(numDstDescRanges);
+	nativeSrcRangeStarts.resize(numSrcDescRanges);
+
+	native_cast(dstRangeStarts, numDstDescRanges, nativeDstRangeStarts.data());
+	native_cast(srcRangeStarts, numSrcDescRanges, nativeSrcRangeStarts.data());
 
 	m_device->CopyDescriptors(
 		(unsigned)nativeDstRangeStarts.size(),
@@ -470,12 +587,8 @@ void GraphicsApi::CopyDescriptors(size_t numSrcDescRanges,
 	nativeDstRangeStarts.resize(numDstDescRanges);
 	nativeSrcRangeStarts.resize(numSrcDescRanges);
 
-	for (int i = 0; i < numDstDescRanges; i++) {
-		nativeDstRangeStarts[i].ptr = native_cast_ptr(dstRangeStarts[i].cpuAddress);
-	}
-	for (int i = 0; i < numSrcDescRanges; i++) {
-		nativeSrcRangeStarts[i].ptr = native_cast_ptr(srcRangeStarts[i].cpuAddress);
-	}
+	native_cast(dstRangeStarts, numDstDescRanges, nativeDstRangeStarts.data());
+	native_cast(srcRangeStarts, numSrcDescRanges, nativeSrcRangeStarts.data());
 
 	m_device->CopyDescriptors(
 		(unsigned)nativeDstRangeStarts.size(),
@@ -509,7 +622,43 @@ gxapi::IFence * GraphicsApi::CreateFence(uint64_t initialValue)
 	ComPtr<ID3D12Fence> native;
 	D3D12_FENCE_FLAGS flags = D3D12_FENCE_FLAG_NONE;
 	ThrowIfFailed(m_device->CreateFence(initialValue, flags, IID_PPV_ARGS(&native)));
-	return new Fence(native);
+	return new Fence(native, m_fenceWatcher);
+}
+
+
+gxapi::IFence* GraphicsApi::CreateSharedFence(uint64_t initialValue) {
+	ComPtr<ID3D12Fence> native;
+	D3D12_FENCE_FLAGS flags = D3D12_FENCE_FLAG_SHARED | D3D12_FENCE_FLAG_SHARED_CROSS_ADAPTER;
+	ThrowIfFailed(m_device->CreateFence(initialValue, flags, IID_PPV_ARGS(&native)));
+	return new Fence(native, m_fenceWatcher);
+}
+
+
+gxapi::IFence* GraphicsApi::OpenSharedFence(gxapi::IFence* fence) {
+	ComPtr<ID3D12Fence> native = OpenShared(native_cast(fence));
+	return new Fence(native, m_fenceWatcher);
+}
+
+
+gxapi::IHeap* GraphicsApi::OpenSharedHeap(gxapi::IHeap* heap) {
+	ComPtr<ID3D12Heap> native = OpenShared(native_cast(heap));
+	return new Heap{ native };
+}
+
+
+template <class NativeT>
+ComPtr<NativeT> GraphicsApi::OpenShared(NativeT* object) {
+	ComPtr<ID3D12Device> owner;
+	ThrowIfFailed(object->GetDevice(IID_PPV_ARGS(&owner)));
+
+	HANDLE handle;
+	ThrowIfFailed(owner->CreateSharedHandle(object, nullptr, GENERIC_ALL, nullptr, &handle));
+	ComPtr<NativeT> opened;
+	HRESULT hr = m_device->OpenSharedHandle(handle, IID_PPV_ARGS(&opened));
+	CloseHandle(handle);
+	ThrowIfFailed(hr);
+
+	return opened;
 }
 
 
@@ -545,6 +694,32 @@ void GraphicsApi::Evict(const std::vector<gxapi::IResource*>& objects) {
 }
 
 
+gxapi::VideoMemoryInfo GraphicsApi::QueryVideoMemoryInfo(gxapi::eMemorySegmentGroup group) const {
+	gxapi::VideoMemoryInfo result = {};
+	DXGI_QUERY_VIDEO_MEMORY_INFO info;
+	DXGI_MEMORY_SEGMENT_GROUP nativeGroup = group == gxapi::eMemorySegmentGroup::LOCAL ? DXGI_MEMORY_SEGMENT_GROUP_LOCAL : DXGI_MEMORY_SEGMENT_GROUP_NON_LOCAL;
+	if (m_adapter && SUCCEEDED(m_adapter->QueryVideoMemoryInfo(0, nativeGroup, &info))) {
+		result.budget = info.Budget;
+		result.currentUsage = info.CurrentUsage;
+		result.availableForReservation = info.AvailableForReservation;
+		result.currentReservation = info.CurrentReservation;
+	}
+	return result;
+}
+
+
+uint64_t GraphicsApi::GetAllocationSize(const gxapi::ResourceDesc& desc) const {
+	return GetAllocationInfo(desc).size;
+}
+
+
+gxapi::ResourceAllocationInfo GraphicsApi::GetAllocationInfo(const gxapi::ResourceDesc& desc) const {
+	D3D12_RESOURCE_DESC nativeDesc = native_cast(desc);
+	D3D12_RESOURCE_ALLOCATION_INFO info = m_device->GetResourceAllocationInfo(0, 1, &nativeDesc);
+	return { info.SizeInBytes, info.Alignment };
+}
+
+
 gxapi::ICapabilityQuery* GraphicsApi::GetCapabilityQuery() const {
 	return new CapabilityQuery(m_device);
 }
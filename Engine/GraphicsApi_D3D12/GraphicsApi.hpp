@@ -1,11 +1,16 @@
 #pragma once
 
 #include "../GraphicsApi_LL/IGraphicsApi.hpp"
+#include "FenceWatcher.hpp"
+#include "PipelineStateCache.hpp"
+
+#include <memory>
 
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #include <wrl.h>
 #include <d3d12.h>
+#include <dxgi1_4.h>
 #include "../GraphicsApi_LL/DisableWin32Macros.h"
 
 namespace inl {
@@ -14,7 +19,8 @@ namespace gxapi_dx12 {
 
 class GraphicsApi : public gxapi::IGraphicsApi {
 public:
-	GraphicsApi(Microsoft::WRL::ComPtr<ID3D12Device> device);
+	/// <param name="adapter"> Used for memory budget queries, may be null if the OS has no IDXGIAdapter3. </param>
+	GraphicsApi(Microsoft::WRL::ComPtr<ID3D12Device> device, Microsoft::WRL::ComPtr<IDXGIAdapter3> adapter = nullptr);
 	~GraphicsApi();
 
 	// Command submission
@@ -33,6 +39,15 @@ public:
 											  gxapi::ResourceDesc desc,
 											  gxapi::eResourceState initialState,
 											  gxapi::ClearValue* clearValue = nullptr) override;
+	gxapi::IHeap* CreateHeap(const gxapi::HeapDesc& desc) override;
+	gxapi::IResource* CreatePlacedResource(gxapi::IHeap* heap,
+										   uint64_t offset,
+										   gxapi::ResourceDesc desc,
+										   gxapi::eResourceState initialState,
+										   gxapi::ClearValue* clearValue = nullptr) override;
+	gxapi::IResource* CreateReservedResource(gxapi::ResourceDesc desc,
+											 gxapi::eResourceState initialState,
+											 gxapi::ClearValue* clearValue = nullptr) override;
 
 
 	// Pipeline and binding
@@ -41,8 +56,15 @@ public:
 	gxapi::IPipelineState* CreateGraphicsPipelineState(const gxapi::GraphicsPipelineStateDesc& desc) override;
 	gxapi::IPipelineState* CreateComputePipelineState(const gxapi::ComputePipelineStateDesc& desc) override;
 
+	void OpenPipelineCache(const std::string& path) override;
+	void SavePipelineCache() override;
+
 	gxapi::IDescriptorHeap* CreateDescriptorHeap(gxapi::DescriptorHeapDesc desc) override;
 
+	gxapi::ICommandSignature* CreateCommandSignature(const gxapi::CommandSignatureDesc& desc, gxapi::IRootSignature* rootSignature = nullptr) override;
+
+	gxapi::IQueryHeap* CreateQueryHeap(const gxapi::QueryHeapDesc& desc) override;
+
 
 	void CreateConstantBufferView(gxapi::ConstantBufferViewDesc desc,
 								  gxapi::DescriptorHandle destination) override;
@@ -100,17 +122,34 @@ public:
 	// Misc
 	gxapi::IFence* CreateFence(uint64_t initialValue) override;
 
+	gxapi::IFence* CreateSharedFence(uint64_t initialValue) override;
+	gxapi::IFence* OpenSharedFence(gxapi::IFence* fence) override;
+	gxapi::IHeap* OpenSharedHeap(gxapi::IHeap* heap) override;
+
 	void MakeResident(const std::vector<gxapi::IResource*>& objects) override;
 	void Evict(const std::vector<gxapi::IResource*>& objects) override;
 
+	gxapi::VideoMemoryInfo QueryVideoMemoryInfo(gxapi::eMemorySegmentGroup group) const override;
+	uint64_t GetAllocationSize(const gxapi::ResourceDesc& desc) const override;
+	gxapi::ResourceAllocationInfo GetAllocationInfo(const gxapi::ResourceDesc& desc) const override;
+
 	// Debug
 	void ReportLiveObjects() const override;
 
 	gxapi::ICapabilityQuery* GetCapabilityQuery() const override;
 
+private:
+	static uint64_t GetRootSignatureHash(gxapi::IRootSignature* rootSignature);
+	/// <summary> Opens the object of another device as an object of this device. </summary>
+	template <class NativeT>
+	Microsoft::WRL::ComPtr<NativeT> OpenShared(NativeT* object);
+
 protected:
 	Microsoft::WRL::ComPtr<ID3D12Device> m_device;
 	Microsoft::WRL::ComPtr<ID3D12DebugDevice1> m_debugDevice;
+	Microsoft::WRL::ComPtr<IDXGIAdapter3> m_adapter;
+	PipelineStateCache m_pipelineStateCache;
+	std::shared_ptr<FenceWatcher> m_fenceWatcher; // Shared with the fences, which may outlive the API.
 };
 
 
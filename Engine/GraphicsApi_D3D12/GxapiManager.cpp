@@ -3,6 +3,7 @@
 #include "SwapChain.hpp"
 #include "GraphicsApi.hpp"
 #include "ExceptionExpansions.hpp"
+#include "DxcShaderCompiler.hpp"
 
 #include "../GraphicsApi_LL/Exception.hpp"
 
@@ -11,6 +12,8 @@
 #include "../GraphicsApi_LL/DisableWin32Macros.h"
 
 #include <string>
+#include <fstream>
+#include <sstream>
 #include <regex>
 #include <cassert>
 
@@ -191,7 +194,11 @@ IGraphicsApi* GxapiManager::CreateGraphicsApi(unsigned adapterId) {
 			throw RuntimeException("Failed to create D3D12 device.");
 	}
 
-	return new GraphicsApi(device);
+	// Budget queries need Windows 10, run without them on older systems.
+	ComPtr<IDXGIAdapter3> adapter3;
+	adapter.As(&adapter3);
+
+	return new GraphicsApi(device, adapter3);
 }
 
 
@@ -332,10 +339,20 @@ gxapi::ShaderProgramBinary GxapiManager::CompileShader(
 	gxapi::eShaderType type,
 	gxapi::eShaderCompileFlags flags,
 	gxapi::IShaderIncludeProvider* includeProvider,
-	const char* macroDefinitions)
+	const char* macroDefinitions,
+	gxapi::eShaderModel shaderModel)
 {
 	std::vector<Macro> parsedMacroDefinitions = ParseMacros(macroDefinitions);
 
+	// FXC stops at 5.1, newer models are compiled to DXIL.
+	if (shaderModel != eShaderModel::SM_5_1) {
+		std::vector<ShaderMacroDefinition> macros;
+		for (auto& m : parsedMacroDefinitions) {
+			macros.push_back({ m.name, m.definition });
+		}
+		return DxcShaderCompiler::Compile(source, "shader.hlsl", mainFunction, type, shaderModel, flags, includeProvider, macros);
+	}
+
 	ComPtr<ID3DBlob> binaryCode;
 	ComPtr<ID3DBlob> errorMessage;
 	std::vector<D3D_SHADER_MACRO> d3dMacrosDefines;
@@ -389,8 +406,19 @@ gxapi::ShaderProgramBinary GxapiManager::CompileShaderFromFile(const std::string
 															   const std::string& mainFunctionName,
 															   gxapi::eShaderType type,
 															   gxapi::eShaderCompileFlags flags,
-															   const std::vector<gxapi::ShaderMacroDefinition>& macros)
+															   const std::vector<gxapi::ShaderMacroDefinition>& macros,
+															   gxapi::eShaderModel shaderModel)
 {
+	if (shaderModel != eShaderModel::SM_5_1) {
+		std::ifstream file(fileName);
+		if (!file.is_open()) {
+			throw ShaderCompilationError("Could not open shader file.", fileName);
+		}
+		std::stringstream source;
+		source << file.rdbuf();
+		return DxcShaderCompiler::Compile(source.str(), fileName, mainFunctionName.c_str(), type, shaderModel, flags, nullptr, macros);
+	}
+
 	// variables
 	ID3DBlob *code = nullptr;
 	ID3DBlob *error = nullptr;
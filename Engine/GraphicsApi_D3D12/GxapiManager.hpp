@@ -26,13 +26,15 @@ public:
 											 gxapi::eShaderType type,
 											 gxapi::eShaderCompileFlags flags,
 											 gxapi::IShaderIncludeProvider* includeProvider = nullptr,
-											 const char* macroDefinitions = nullptr) override;
+											 const char* macroDefinitions = nullptr,
+											 gxapi::eShaderModel shaderModel = gxapi::eShaderModel::SM_5_1) override;
 
 	gxapi::ShaderProgramBinary CompileShaderFromFile(const std::string& fileName,
 													 const std::string& mainFunctionName,
 													 gxapi::eShaderType type,
 													 gxapi::eShaderCompileFlags flags,
-													 const std::vector<gxapi::ShaderMacroDefinition>& macros) override;
+													 const std::vector<gxapi::ShaderMacroDefinition>& macros,
+													 gxapi::eShaderModel shaderModel = gxapi::eShaderModel::SM_5_1) override;
 
 protected:
 	static const char* GetTarget(gxapi::eShaderType type);
@@ -0,0 +1,22 @@
+#include "Heap.hpp"
+
+namespace inl {
+namespace gxapi_dx12 {
+
+Heap::Heap(ComPtr<ID3D12Heap>& native)
+	: m_native{native} {
+}
+
+
+uint64_t Heap::GetSize() const {
+	return m_native->GetDesc().SizeInBytes;
+}
+
+
+ID3D12Heap* Heap::GetNative() {
+	return m_native.Get();
+}
+
+
+} // namespace gxapi_dx12
+} // namespace inl
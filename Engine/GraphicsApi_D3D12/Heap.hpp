@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../GraphicsApi_LL/IHeap.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <wrl.h>
+#include <d3d12.h>
+#include "../GraphicsApi_LL/DisableWin32Macros.h"
+
+namespace inl {
+namespace gxapi_dx12 {
+
+using Microsoft::WRL::ComPtr;
+
+class Heap : public gxapi::IHeap {
+public:
+	Heap(ComPtr<ID3D12Heap>& native);
+
+	uint64_t GetSize() const override;
+
+	ID3D12Heap* GetNative();
+
+protected:
+	ComPtr<ID3D12Heap> m_native;
+};
+
+
+} // namespace gxapi_dx12
+} // namespace inl
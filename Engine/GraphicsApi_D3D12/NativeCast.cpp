@@ -3,6 +3,7 @@
 #include "../GraphicsApi_LL/Common.hpp"
 
 #include <cassert>
+#include <iterator>
 #include <d3dcompiler.h>
 
 //Dont even think about returning a pointer that points to a locally allocated space
@@ -102,6 +103,33 @@ ID3D12RootSignature* native_cast(gxapi::IRootSignature* source) {
 }
 
 
+ID3D12CommandSignature* native_cast(gxapi::ICommandSignature* source) {
+	if (source == nullptr) {
+		return nullptr;
+	}
+
+	return static_cast<CommandSignature*>(source)->GetNative();
+}
+
+
+ID3D12QueryHeap* native_cast(gxapi::IQueryHeap* source) {
+	if (source == nullptr) {
+		return nullptr;
+	}
+
+	return static_cast<QueryHeap*>(source)->GetNative();
+}
+
+
+ID3D12Heap* native_cast(gxapi::IHeap* source) {
+	if (source == nullptr) {
+		return nullptr;
+	}
+
+	return static_cast<Heap*>(source)->GetNative();
+}
+
+
 ID3D12DescriptorHeap* native_cast(gxapi::IDescriptorHeap* source) {
 	if (source == nullptr) {
 		return nullptr;
@@ -215,6 +243,38 @@ D3D12_DESCRIPTOR_HEAP_TYPE native_cast(gxapi::eDescriptorHeapType source) {
 }
 
 
+D3D12_QUERY_HEAP_TYPE native_cast(gxapi::eQueryHeapType source) {
+	using gxapi::eQueryHeapType;
+	switch (source) {
+	case eQueryHeapType::TIMESTAMP:
+		return D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+	case eQueryHeapType::PIPELINE_STATISTICS:
+		return D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS;
+	default:
+		assert(false);
+		break;
+	}
+
+	return D3D12_QUERY_HEAP_TYPE{};
+}
+
+
+D3D12_QUERY_TYPE native_cast(gxapi::eQueryType source) {
+	using gxapi::eQueryType;
+	switch (source) {
+	case eQueryType::TIMESTAMP:
+		return D3D12_QUERY_TYPE_TIMESTAMP;
+	case eQueryType::PIPELINE_STATISTICS:
+		return D3D12_QUERY_TYPE_PIPELINE_STATISTICS;
+	default:
+		assert(false);
+		break;
+	}
+
+	return D3D12_QUERY_TYPE{};
+}
+
+
 D3D12_ROOT_PARAMETER_TYPE native_cast(gxapi::RootParameterDesc::eType source) {
 	switch (source) {
 	case gxapi::RootParameterDesc::CONSTANT:
@@ -471,183 +531,124 @@ D3D12_STATIC_BORDER_COLOR native_cast(gxapi::eTextureBorderColor source) {
 }
 
 
-DXGI_FORMAT native_cast(gxapi::eFormat source) {
-	switch (source) {
-	case gxapi::eFormat::UNKNOWN:
-		return DXGI_FORMAT_UNKNOWN;
-	case gxapi::eFormat::R32G32B32A32_TYPELESS:
-		return DXGI_FORMAT_R32G32B32A32_TYPELESS;
-	case gxapi::eFormat::R32G32B32A32_FLOAT:
-		return DXGI_FORMAT_R32G32B32A32_FLOAT;
-	case gxapi::eFormat::R32G32B32A32_UINT:
-		return DXGI_FORMAT_R32G32B32A32_UINT;
-	case gxapi::eFormat::R32G32B32A32_SINT:
-		return DXGI_FORMAT_R32G32B32A32_SINT;
-	case gxapi::eFormat::R32G32B32_TYPELESS:
-		return DXGI_FORMAT_R32G32B32_TYPELESS;
-	case gxapi::eFormat::R32G32B32_FLOAT:
-		return DXGI_FORMAT_R32G32B32_FLOAT;
-	case gxapi::eFormat::R32G32B32_UINT:
-		return DXGI_FORMAT_R32G32B32_UINT;
-	case gxapi::eFormat::R32G32B32_SINT:
-		return DXGI_FORMAT_R32G32B32_SINT;
-	case gxapi::eFormat::R16G16B16A16_TYPELESS:
-		return DXGI_FORMAT_R16G16B16A16_TYPELESS;
-	case gxapi::eFormat::R16G16B16A16_FLOAT:
-		return DXGI_FORMAT_R16G16B16A16_FLOAT;
-	case gxapi::eFormat::R16G16B16A16_UNORM:
-		return DXGI_FORMAT_R16G16B16A16_UNORM;
-	case gxapi::eFormat::R16G16B16A16_UINT:
-		return DXGI_FORMAT_R16G16B16A16_UINT;
-	case gxapi::eFormat::R16G16B16A16_SNORM:
-		return DXGI_FORMAT_R16G16B16A16_SNORM;
-	case gxapi::eFormat::R16G16B16A16_SINT:
-		return DXGI_FORMAT_R16G16B16A16_SINT;
-	case gxapi::eFormat::R32G32_TYPELESS:
-		return DXGI_FORMAT_R32G32_TYPELESS;
-	case gxapi::eFormat::R32G32_FLOAT:
-		return DXGI_FORMAT_R32G32_FLOAT;
-	case gxapi::eFormat::R32G32_UINT:
-		return DXGI_FORMAT_R32G32_UINT;
-	case gxapi::eFormat::R32G32_SINT:
-		return DXGI_FORMAT_R32G32_SINT;
-	case gxapi::eFormat::R32G8X24_TYPELESS:
-		return DXGI_FORMAT_R32G8X24_TYPELESS;
-	case gxapi::eFormat::D32_FLOAT_S8X24_UINT:
-		return DXGI_FORMAT_D32_FLOAT_S8X24_UINT;
-	case gxapi::eFormat::R32_FLOAT_X8X24_TYPELESS:
-		return DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS;
-	case gxapi::eFormat::X32_TYPELESS_G8X24_UINT:
-		return DXGI_FORMAT_X32_TYPELESS_G8X24_UINT;
-	case gxapi::eFormat::R10G10B10A2_TYPELESS:
-		return DXGI_FORMAT_R10G10B10A2_TYPELESS;
-	case gxapi::eFormat::R10G10B10A2_UNORM:
-		return DXGI_FORMAT_R10G10B10A2_UNORM;
-	case gxapi::eFormat::R10G10B10A2_UINT:
-		return DXGI_FORMAT_R10G10B10A2_UINT;
-	case gxapi::eFormat::R11G11B10_FLOAT:
-		return DXGI_FORMAT_R11G11B10_FLOAT;
-	case gxapi::eFormat::R8G8B8A8_TYPELESS:
-		return DXGI_FORMAT_R8G8B8A8_TYPELESS;
-	case gxapi::eFormat::R8G8B8A8_UNORM:
-		return DXGI_FORMAT_R8G8B8A8_UNORM;
-	case gxapi::eFormat::R8G8B8A8_UNORM_SRGB:
-		return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
-	case gxapi::eFormat::R8G8B8A8_UINT:
-		return DXGI_FORMAT_R8G8B8A8_UINT;
-	case gxapi::eFormat::R8G8B8A8_SNORM:
-		return DXGI_FORMAT_R8G8B8A8_SNORM;
-	case gxapi::eFormat::R8G8B8A8_SINT:
-		return DXGI_FORMAT_R8G8B8A8_SINT;
-	case gxapi::eFormat::R16G16_TYPELESS:
-		return DXGI_FORMAT_R16G16_TYPELESS;
-	case gxapi::eFormat::R16G16_FLOAT:
-		return DXGI_FORMAT_R16G16_FLOAT;
-	case gxapi::eFormat::R16G16_UNORM:
-		return DXGI_FORMAT_R16G16_UNORM;
-	case gxapi::eFormat::R16G16_UINT:
-		return DXGI_FORMAT_R16G16_UINT;
-	case gxapi::eFormat::R16G16_SNORM:
-		return DXGI_FORMAT_R16G16_SNORM;
-	case gxapi::eFormat::R16G16_SINT:
-		return DXGI_FORMAT_R16G16_SINT;
-	case gxapi::eFormat::R32_TYPELESS:
-		return DXGI_FORMAT_R32_TYPELESS;
-	case gxapi::eFormat::D32_FLOAT:
-		return DXGI_FORMAT_D32_FLOAT;
-	case gxapi::eFormat::R32_FLOAT:
-		return DXGI_FORMAT_R32_FLOAT;
-	case gxapi::eFormat::R32_UINT:
-		return DXGI_FORMAT_R32_UINT;
-	case gxapi::eFormat::R32_SINT:
-		return DXGI_FORMAT_R32_SINT;
-	case gxapi::eFormat::R24G8_TYPELESS:
-		return DXGI_FORMAT_R24G8_TYPELESS;
-	case gxapi::eFormat::D24_UNORM_S8_UINT:
-		return DXGI_FORMAT_D24_UNORM_S8_UINT;
-	case gxapi::eFormat::R24_UNORM_X8_TYPELESS:
-		return DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
-	case gxapi::eFormat::X24_TYPELESS_G8_UINT:
-		return DXGI_FORMAT_X24_TYPELESS_G8_UINT;
-	case gxapi::eFormat::R8G8_TYPELESS:
-		return DXGI_FORMAT_R8G8_TYPELESS;
-	case gxapi::eFormat::R8G8_UNORM:
-		return DXGI_FORMAT_R8G8_UNORM;
-	case gxapi::eFormat::R8G8_UINT:
-		return DXGI_FORMAT_R8G8_UINT;
-	case gxapi::eFormat::R8G8_SNORM:
-		return DXGI_FORMAT_R8G8_SNORM;
-	case gxapi::eFormat::R8G8_SINT:
-		return DXGI_FORMAT_R8G8_SINT;
-	case gxapi::eFormat::R16_TYPELESS:
-		return DXGI_FORMAT_R16_TYPELESS;
-	case gxapi::eFormat::R16_FLOAT:
-		return DXGI_FORMAT_R16_FLOAT;
-	case gxapi::eFormat::D16_UNORM:
-		return DXGI_FORMAT_D16_UNORM;
-	case gxapi::eFormat::R16_UNORM:
-		return DXGI_FORMAT_R16_UNORM;
-	case gxapi::eFormat::R16_UINT:
-		return DXGI_FORMAT_R16_UINT;
-	case gxapi::eFormat::R16_SNORM:
-		return DXGI_FORMAT_R16_SNORM;
-	case gxapi::eFormat::R16_SINT:
-		return DXGI_FORMAT_R16_SINT;
-	case gxapi::eFormat::R8_TYPELESS:
-		return DXGI_FORMAT_R8_TYPELESS;
-	case gxapi::eFormat::R8_UNORM:
-		return DXGI_FORMAT_R8_UNORM;
-	case gxapi::eFormat::R8_UINT:
-		return DXGI_FORMAT_R8_UINT;
-	case gxapi::eFormat::R8_SNORM:
-		return DXGI_FORMAT_R8_SNORM;
-	case gxapi::eFormat::R8_SINT:
-		return DXGI_FORMAT_R8_SINT;
-	case gxapi::eFormat::A8_UNORM:
-		return DXGI_FORMAT_A8_UNORM;
-
-	default:
-		assert(false);
-		break;
-	}
+// eFormat has the values of DXGI_FORMAT.
+static_assert((int)gxapi::eFormat::UNKNOWN == (int)DXGI_FORMAT_UNKNOWN);
+static_assert((int)gxapi::eFormat::R32G32B32A32_TYPELESS == (int)DXGI_FORMAT_R32G32B32A32_TYPELESS);
+static_assert((int)gxapi::eFormat::R32G32B32A32_FLOAT == (int)DXGI_FORMAT_R32G32B32A32_FLOAT);
+static_assert((int)gxapi::eFormat::R32G32B32A32_UINT == (int)DXGI_FORMAT_R32G32B32A32_UINT);
+static_assert((int)gxapi::eFormat::R32G32B32A32_SINT == (int)DXGI_FORMAT_R32G32B32A32_SINT);
+static_assert((int)gxapi::eFormat::R32G32B32_TYPELESS == (int)DXGI_FORMAT_R32G32B32_TYPELESS);
+static_assert((int)gxapi::eFormat::R32G32B32_FLOAT == (int)DXGI_FORMAT_R32G32B32_FLOAT);
+static_assert((int)gxapi::eFormat::R32G32B32_UINT == (int)DXGI_FORMAT_R32G32B32_UINT);
+static_assert((int)gxapi::eFormat::R32G32B32_SINT == (int)DXGI_FORMAT_R32G32B32_SINT);
+static_assert((int)gxapi::eFormat::R16G16B16A16_TYPELESS == (int)DXGI_FORMAT_R16G16B16A16_TYPELESS);
+static_assert((int)gxapi::eFormat::R16G16B16A16_FLOAT == (int)DXGI_FORMAT_R16G16B16A16_FLOAT);
+static_assert((int)gxapi::eFormat::R16G16B16A16_UNORM == (int)DXGI_FORMAT_R16G16B16A16_UNORM);
+static_assert((int)gxapi::eFormat::R16G16B16A16_UINT == (int)DXGI_FORMAT_R16G16B16A16_UINT);
+static_assert((int)gxapi::eFormat::R16G16B16A16_SNORM == (int)DXGI_FORMAT_R16G16B16A16_SNORM);
+static_assert((int)gxapi::eFormat::R16G16B16A16_SINT == (int)DXGI_FORMAT_R16G16B16A16_SINT);
+static_assert((int)gxapi::eFormat::R32G32_TYPELESS == (int)DXGI_FORMAT_R32G32_TYPELESS);
+static_assert((int)gxapi::eFormat::R32G32_FLOAT == (int)DXGI_FORMAT_R32G32_FLOAT);
+static_assert((int)gxapi::eFormat::R32G32_UINT == (int)DXGI_FORMAT_R32G32_UINT);
+static_assert((int)gxapi::eFormat::R32G32_SINT == (int)DXGI_FORMAT_R32G32_SINT);
+static_assert((int)gxapi::eFormat::R32G8X24_TYPELESS == (int)DXGI_FORMAT_R32G8X24_TYPELESS);
+static_assert((int)gxapi::eFormat::D32_FLOAT_S8X24_UINT == (int)DXGI_FORMAT_D32_FLOAT_S8X24_UINT);
+static_assert((int)gxapi::eFormat::R32_FLOAT_X8X24_TYPELESS == (int)DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS);
+static_assert((int)gxapi::eFormat::X32_TYPELESS_G8X24_UINT == (int)DXGI_FORMAT_X32_TYPELESS_G8X24_UINT);
+static_assert((int)gxapi::eFormat::R10G10B10A2_TYPELESS == (int)DXGI_FORMAT_R10G10B10A2_TYPELESS);
+static_assert((int)gxapi::eFormat::R10G10B10A2_UNORM == (int)DXGI_FORMAT_R10G10B10A2_UNORM);
+static_assert((int)gxapi::eFormat::R10G10B10A2_UINT == (int)DXGI_FORMAT_R10G10B10A2_UINT);
+static_assert((int)gxapi::eFormat::R11G11B10_FLOAT == (int)DXGI_FORMAT_R11G11B10_FLOAT);
+static_assert((int)gxapi::eFormat::R8G8B8A8_TYPELESS == (int)DXGI_FORMAT_R8G8B8A8_TYPELESS);
+static_assert((int)gxapi::eFormat::R8G8B8A8_UNORM == (int)DXGI_FORMAT_R8G8B8A8_UNORM);
+static_assert((int)gxapi::eFormat::R8G8B8A8_UNORM_SRGB == (int)DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+static_assert((int)gxapi::eFormat::R8G8B8A8_UINT == (int)DXGI_FORMAT_R8G8B8A8_UINT);
+static_assert((int)gxapi::eFormat::R8G8B8A8_SNORM == (int)DXGI_FORMAT_R8G8B8A8_SNORM);
+static_assert((int)gxapi::eFormat::R8G8B8A8_SINT == (int)DXGI_FORMAT_R8G8B8A8_SINT);
+static_assert((int)gxapi::eFormat::R16G16_TYPELESS == (int)DXGI_FORMAT_R16G16_TYPELESS);
+static_assert((int)gxapi::eFormat::R16G16_FLOAT == (int)DXGI_FORMAT_R16G16_FLOAT);
+static_assert((int)gxapi::eFormat::R16G16_UNORM == (int)DXGI_FORMAT_R16G16_UNORM);
+static_assert((int)gxapi::eFormat::R16G16_UINT == (int)DXGI_FORMAT_R16G16_UINT);
+static_assert((int)gxapi::eFormat::R16G16_SNORM == (int)DXGI_FORMAT_R16G16_SNORM);
+static_assert((int)gxapi::eFormat::R16G16_SINT == (int)DXGI_FORMAT_R16G16_SINT);
+static_assert((int)gxapi::eFormat::R32_TYPELESS == (int)DXGI_FORMAT_R32_TYPELESS);
+static_assert((int)gxapi::eFormat::D32_FLOAT == (int)DXGI_FORMAT_D32_FLOAT);
+static_assert((int)gxapi::eFormat::R32_FLOAT == (int)DXGI_FORMAT_R32_FLOAT);
+static_assert((int)gxapi::eFormat::R32_UINT == (int)DXGI_FORMAT_R32_UINT);
+static_assert((int)gxapi::eFormat::R32_SINT == (int)DXGI_FORMAT_R32_SINT);
+static_assert((int)gxapi::eFormat::R24G8_TYPELESS == (int)DXGI_FORMAT_R24G8_TYPELESS);
+static_assert((int)gxapi::eFormat::D24_UNORM_S8_UINT == (int)DXGI_FORMAT_D24_UNORM_S8_UINT);
+static_assert((int)gxapi::eFormat::R24_UNORM_X8_TYPELESS == (int)DXGI_FORMAT_R24_UNORM_X8_TYPELESS);
+static_assert((int)gxapi::eFormat::X24_TYPELESS_G8_UINT == (int)DXGI_FORMAT_X24_TYPELESS_G8_UINT);
+static_assert((int)gxapi::eFormat::R8G8_TYPELESS == (int)DXGI_FORMAT_R8G8_TYPELESS);
+static_assert((int)gxapi::eFormat::R8G8_UNORM == (int)DXGI_FORMAT_R8G8_UNORM);
+static_assert((int)gxapi::eFormat::R8G8_UINT == (int)DXGI_FORMAT_R8G8_UINT);
+static_assert((int)gxapi::eFormat::R8G8_SNORM == (int)DXGI_FORMAT_R8G8_SNORM);
+static_assert((int)gxapi::eFormat::R8G8_SINT == (int)DXGI_FORMAT_R8G8_SINT);
+static_assert((int)gxapi::eFormat::R16_TYPELESS == (int)DXGI_FORMAT_R16_TYPELESS);
+static_assert((int)gxapi::eFormat::R16_FLOAT == (int)DXGI_FORMAT_R16_FLOAT);
+static_assert((int)gxapi::eFormat::D16_UNORM == (int)DXGI_FORMAT_D16_UNORM);
+static_assert((int)gxapi::eFormat::R16_UNORM == (int)DXGI_FORMAT_R16_UNORM);
+static_assert((int)gxapi::eFormat::R16_UINT == (int)DXGI_FORMAT_R16_UINT);
+static_assert((int)gxapi::eFormat::R16_SNORM == (int)DXGI_FORMAT_R16_SNORM);
+static_assert((int)gxapi::eFormat::R16_SINT == (int)DXGI_FORMAT_R16_SINT);
+static_assert((int)gxapi::eFormat::R8_TYPELESS == (int)DXGI_FORMAT_R8_TYPELESS);
+static_assert((int)gxapi::eFormat::R8_UNORM == (int)DXGI_FORMAT_R8_UNORM);
+static_assert((int)gxapi::eFormat::R8_UINT == (int)DXGI_FORMAT_R8_UINT);
+static_assert((int)gxapi::eFormat::R8_SNORM == (int)DXGI_FORMAT_R8_SNORM);
+static_assert((int)gxapi::eFormat::R8_SINT == (int)DXGI_FORMAT_R8_SINT);
+static_assert((int)gxapi::eFormat::A8_UNORM == (int)DXGI_FORMAT_A8_UNORM);
+static_assert((int)gxapi::eFormat::BC1_TYPELESS == (int)DXGI_FORMAT_BC1_TYPELESS);
+static_assert((int)gxapi::eFormat::BC1_UNORM == (int)DXGI_FORMAT_BC1_UNORM);
+static_assert((int)gxapi::eFormat::BC1_UNORM_SRGB == (int)DXGI_FORMAT_BC1_UNORM_SRGB);
+static_assert((int)gxapi::eFormat::BC2_TYPELESS == (int)DXGI_FORMAT_BC2_TYPELESS);
+static_assert((int)gxapi::eFormat::BC2_UNORM == (int)DXGI_FORMAT_BC2_UNORM);
+static_assert((int)gxapi::eFormat::BC2_UNORM_SRGB == (int)DXGI_FORMAT_BC2_UNORM_SRGB);
+static_assert((int)gxapi::eFormat::BC3_TYPELESS == (int)DXGI_FORMAT_BC3_TYPELESS);
+static_assert((int)gxapi::eFormat::BC3_UNORM == (int)DXGI_FORMAT_BC3_UNORM);
+static_assert((int)gxapi::eFormat::BC3_UNORM_SRGB == (int)DXGI_FORMAT_BC3_UNORM_SRGB);
+static_assert((int)gxapi::eFormat::BC4_TYPELESS == (int)DXGI_FORMAT_BC4_TYPELESS);
+static_assert((int)gxapi::eFormat::BC4_UNORM == (int)DXGI_FORMAT_BC4_UNORM);
+static_assert((int)gxapi::eFormat::BC4_SNORM == (int)DXGI_FORMAT_BC4_SNORM);
+static_assert((int)gxapi::eFormat::BC5_TYPELESS == (int)DXGI_FORMAT_BC5_TYPELESS);
+static_assert((int)gxapi::eFormat::BC5_UNORM == (int)DXGI_FORMAT_BC5_UNORM);
+static_assert((int)gxapi::eFormat::BC5_SNORM == (int)DXGI_FORMAT_BC5_SNORM);
+static_assert((int)gxapi::eFormat::BC6H_TYPELESS == (int)DXGI_FORMAT_BC6H_TYPELESS);
+static_assert((int)gxapi::eFormat::BC6H_UF16 == (int)DXGI_FORMAT_BC6H_UF16);
+static_assert((int)gxapi::eFormat::BC6H_SF16 == (int)DXGI_FORMAT_BC6H_SF16);
+static_assert((int)gxapi::eFormat::BC7_TYPELESS == (int)DXGI_FORMAT_BC7_TYPELESS);
+static_assert((int)gxapi::eFormat::BC7_UNORM == (int)DXGI_FORMAT_BC7_UNORM);
+static_assert((int)gxapi::eFormat::BC7_UNORM_SRGB == (int)DXGI_FORMAT_BC7_UNORM_SRGB);
 
-	return DXGI_FORMAT{};
+DXGI_FORMAT native_cast(gxapi::eFormat source) {
+	return static_cast<DXGI_FORMAT>(source);
 }
 
 
-D3D12_TEXTURE_LAYOUT native_cast(gxapi::eTextureLayout source) {
-	switch (source) {
-	case gxapi::eTextureLayout::UNKNOWN:
-		return D3D12_TEXTURE_LAYOUT_UNKNOWN;
-	case gxapi::eTextureLayout::ROW_MAJOR:
-		return D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-	case gxapi::eTextureLayout::UNDEFINED_SWIZZLE:
-		return D3D12_TEXTURE_LAYOUT_64KB_UNDEFINED_SWIZZLE;
-	case gxapi::eTextureLayout::STANDARD_SWIZZLE:
-		return D3D12_TEXTURE_LAYOUT_64KB_STANDARD_SWIZZLE;
-	default:
-		assert(false);
-		break;
-	}
+static constexpr D3D12_TEXTURE_LAYOUT s_textureLayoutTable[] = {
+	D3D12_TEXTURE_LAYOUT_UNKNOWN, // UNKNOWN
+	D3D12_TEXTURE_LAYOUT_ROW_MAJOR, // ROW_MAJOR
+	D3D12_TEXTURE_LAYOUT_64KB_UNDEFINED_SWIZZLE, // UNDEFINED_SWIZZLE
+	D3D12_TEXTURE_LAYOUT_64KB_STANDARD_SWIZZLE, // STANDARD_SWIZZLE
+};
+static_assert(std::size(s_textureLayoutTable) == (size_t)gxapi::eTextureLayout::STANDARD_SWIZZLE + 1);
 
-	return D3D12_TEXTURE_LAYOUT{};
+D3D12_TEXTURE_LAYOUT native_cast(gxapi::eTextureLayout source) {
+	assert((size_t)source < std::size(s_textureLayoutTable));
+	return s_textureLayoutTable[(size_t)source];
 }
 
 
-D3D12_RESOURCE_DIMENSION native_cast(gxapi::eTextueDimension source) {
-	switch (source) {
-	case gxapi::eTextueDimension::ONE:
-		return D3D12_RESOURCE_DIMENSION_TEXTURE1D;
-	case gxapi::eTextueDimension::TWO:
-		return D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-	case gxapi::eTextueDimension::THREE:
-		return D3D12_RESOURCE_DIMENSION_TEXTURE3D;
-	default:
-		assert(false);
-		break;
-	}
+static constexpr D3D12_RESOURCE_DIMENSION s_textureDimensionTable[] = {
+	D3D12_RESOURCE_DIMENSION_TEXTURE1D, // ONE
+	D3D12_RESOURCE_DIMENSION_TEXTURE2D, // TWO
+	D3D12_RESOURCE_DIMENSION_TEXTURE3D, // THREE
+};
+static_assert(std::size(s_textureDimensionTable) == (size_t)gxapi::eTextueDimension::THREE + 1);
 
-	return D3D12_RESOURCE_DIMENSION{};
+D3D12_RESOURCE_DIMENSION native_cast(gxapi::eTextueDimension source) {
+	assert((size_t)source < std::size(s_textureDimensionTable));
+	return s_textureDimensionTable[(size_t)source];
 }
 
 
@@ -881,208 +882,222 @@ D3D12_INPUT_CLASSIFICATION native_cast(gxapi::eInputClassification source) {
 }
 
 
-D3D12_DSV_DIMENSION native_cast(gxapi::eDsvDimension source) {
-	switch (source) {
-	case gxapi::eDsvDimension::UNKNOWN:
-		return D3D12_DSV_DIMENSION_UNKNOWN;
-	case gxapi::eDsvDimension::TEXTURE1D:
-		return D3D12_DSV_DIMENSION_TEXTURE1D;
-	case gxapi::eDsvDimension::TEXTURE1DARRAY:
-		return D3D12_DSV_DIMENSION_TEXTURE1DARRAY;
-	case gxapi::eDsvDimension::TEXTURE2D:
-		return D3D12_DSV_DIMENSION_TEXTURE2D;
-	case gxapi::eDsvDimension::TEXTURE2DARRAY:
-		return D3D12_DSV_DIMENSION_TEXTURE2DARRAY;
-	case gxapi::eDsvDimension::TEXTURE2DMS:
-		return D3D12_DSV_DIMENSION_TEXTURE2DMS;
-	case gxapi::eDsvDimension::TEXTURE2DMSARRAY:
-		return D3D12_DSV_DIMENSION_TEXTURE2DMSARRAY;
-	default:
-		assert(false);
-		break;
-	}
+// eDsvDimension has the values of D3D12_DSV_DIMENSION.
+static_assert((int)gxapi::eDsvDimension::UNKNOWN == (int)D3D12_DSV_DIMENSION_UNKNOWN);
+static_assert((int)gxapi::eDsvDimension::TEXTURE1D == (int)D3D12_DSV_DIMENSION_TEXTURE1D);
+static_assert((int)gxapi::eDsvDimension::TEXTURE1DARRAY == (int)D3D12_DSV_DIMENSION_TEXTURE1DARRAY);
+static_assert((int)gxapi::eDsvDimension::TEXTURE2D == (int)D3D12_DSV_DIMENSION_TEXTURE2D);
+static_assert((int)gxapi::eDsvDimension::TEXTURE2DARRAY == (int)D3D12_DSV_DIMENSION_TEXTURE2DARRAY);
+static_assert((int)gxapi::eDsvDimension::TEXTURE2DMS == (int)D3D12_DSV_DIMENSION_TEXTURE2DMS);
+static_assert((int)gxapi::eDsvDimension::TEXTURE2DMSARRAY == (int)D3D12_DSV_DIMENSION_TEXTURE2DMSARRAY);
 
-	return D3D12_DSV_DIMENSION{};
+D3D12_DSV_DIMENSION native_cast(gxapi::eDsvDimension source) {
+	return static_cast<D3D12_DSV_DIMENSION>(source);
 }
 
 
-D3D12_RTV_DIMENSION native_cast(gxapi::eRtvDimension source) {
-	switch (source) {
-	case gxapi::eRtvDimension::UNKNOWN:
-		return D3D12_RTV_DIMENSION_UNKNOWN;
-	case gxapi::eRtvDimension::BUFFER:
-		return D3D12_RTV_DIMENSION_BUFFER;
-	case gxapi::eRtvDimension::TEXTURE1D:
-		return D3D12_RTV_DIMENSION_TEXTURE1D;
-	case gxapi::eRtvDimension::TEXTURE1DARRAY:
-		return D3D12_RTV_DIMENSION_TEXTURE1DARRAY;
-	case gxapi::eRtvDimension::TEXTURE2D:
-		return D3D12_RTV_DIMENSION_TEXTURE2D;
-	case gxapi::eRtvDimension::TEXTURE2DARRAY:
-		return D3D12_RTV_DIMENSION_TEXTURE2DARRAY;
-	case gxapi::eRtvDimension::TEXTURE2DMS:
-		return D3D12_RTV_DIMENSION_TEXTURE2DMS;
-	case gxapi::eRtvDimension::TEXTURE2DMSARRAY:
-		return D3D12_RTV_DIMENSION_TEXTURE2DMSARRAY;
-	case gxapi::eRtvDimension::TEXTURE3D:
-		return D3D12_RTV_DIMENSION_TEXTURE3D;
-		break;
-	default:
-		assert(false);
-		break;
-	}
+// eRtvDimension has the values of D3D12_RTV_DIMENSION.
+static_assert((int)gxapi::eRtvDimension::UNKNOWN == (int)D3D12_RTV_DIMENSION_UNKNOWN);
+static_assert((int)gxapi::eRtvDimension::BUFFER == (int)D3D12_RTV_DIMENSION_BUFFER);
+static_assert((int)gxapi::eRtvDimension::TEXTURE1D == (int)D3D12_RTV_DIMENSION_TEXTURE1D);
+static_assert((int)gxapi::eRtvDimension::TEXTURE1DARRAY == (int)D3D12_RTV_DIMENSION_TEXTURE1DARRAY);
+static_assert((int)gxapi::eRtvDimension::TEXTURE2D == (int)D3D12_RTV_DIMENSION_TEXTURE2D);
+static_assert((int)gxapi::eRtvDimension::TEXTURE2DARRAY == (int)D3D12_RTV_DIMENSION_TEXTURE2DARRAY);
+static_assert((int)gxapi::eRtvDimension::TEXTURE2DMS == (int)D3D12_RTV_DIMENSION_TEXTURE2DMS);
+static_assert((int)gxapi::eRtvDimension::TEXTURE2DMSARRAY == (int)D3D12_RTV_DIMENSION_TEXTURE2DMSARRAY);
+static_assert((int)gxapi::eRtvDimension::TEXTURE3D == (int)D3D12_RTV_DIMENSION_TEXTURE3D);
 
-	return D3D12_RTV_DIMENSION{};
+D3D12_RTV_DIMENSION native_cast(gxapi::eRtvDimension source) {
+	return static_cast<D3D12_RTV_DIMENSION>(source);
 }
 
 
-D3D12_SRV_DIMENSION native_cast(gxapi::eSrvDimension source) {
-	switch (source) {
-	case gxapi::eSrvDimension::UNKNOWN:
-		assert(false);
-		break;
-	case gxapi::eSrvDimension::BUFFER:
-		return D3D12_SRV_DIMENSION_BUFFER;
-	case gxapi::eSrvDimension::TEXTURE1D:
-		return D3D12_SRV_DIMENSION_TEXTURE1D;
-	case gxapi::eSrvDimension::TEXTURE1DARRAY:
-		return D3D12_SRV_DIMENSION_TEXTURE1DARRAY;
-	case gxapi::eSrvDimension::TEXTURE2D:
-		return D3D12_SRV_DIMENSION_TEXTURE2D;
-	case gxapi::eSrvDimension::TEXTURE2DARRAY:
-		return D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
-	case gxapi::eSrvDimension::TEXTURE2DMS:
-		return D3D12_SRV_DIMENSION_TEXTURE2DMS;
-	case gxapi::eSrvDimension::TEXTURE2DMSARRAY:
-		return D3D12_SRV_DIMENSION_TEXTURE2DMSARRAY;
-	case gxapi::eSrvDimension::TEXTURE3D:
-		return D3D12_SRV_DIMENSION_TEXTURE3D;
-	case gxapi::eSrvDimension::TEXTURECUBE:
-		return D3D12_SRV_DIMENSION_TEXTURECUBE;
-	case gxapi::eSrvDimension::TEXTURECUBEARRAY:
-		return D3D12_SRV_DIMENSION_TEXTURECUBEARRAY;
-	default:
-		assert(false);
-		break;
-	}
+// eSrvDimension has the values of D3D12_SRV_DIMENSION.
+static_assert((int)gxapi::eSrvDimension::BUFFER == (int)D3D12_SRV_DIMENSION_BUFFER);
+static_assert((int)gxapi::eSrvDimension::TEXTURE1D == (int)D3D12_SRV_DIMENSION_TEXTURE1D);
+static_assert((int)gxapi::eSrvDimension::TEXTURE1DARRAY == (int)D3D12_SRV_DIMENSION_TEXTURE1DARRAY);
+static_assert((int)gxapi::eSrvDimension::TEXTURE2D == (int)D3D12_SRV_DIMENSION_TEXTURE2D);
+static_assert((int)gxapi::eSrvDimension::TEXTURE2DARRAY == (int)D3D12_SRV_DIMENSION_TEXTURE2DARRAY);
+static_assert((int)gxapi::eSrvDimension::TEXTURE2DMS == (int)D3D12_SRV_DIMENSION_TEXTURE2DMS);
+static_assert((int)gxapi::eSrvDimension::TEXTURE2DMSARRAY == (int)D3D12_SRV_DIMENSION_TEXTURE2DMSARRAY);
+static_assert((int)gxapi::eSrvDimension::TEXTURE3D == (int)D3D12_SRV_DIMENSION_TEXTURE3D);
+static_assert((int)gxapi::eSrvDimension::TEXTURECUBE == (int)D3D12_SRV_DIMENSION_TEXTURECUBE);
+static_assert((int)gxapi::eSrvDimension::TEXTURECUBEARRAY == (int)D3D12_SRV_DIMENSION_TEXTURECUBEARRAY);
 
-	return D3D12_SRV_DIMENSION{};
+D3D12_SRV_DIMENSION native_cast(gxapi::eSrvDimension source) {
+	assert(source != gxapi::eSrvDimension::UNKNOWN);
+	return static_cast<D3D12_SRV_DIMENSION>(source);
 }
 
 
-D3D12_UAV_DIMENSION native_cast(gxapi::eUavDimension source) {
-	switch (source) {
-		case gxapi::eUavDimension::UNKNOWN:
-			assert(false);
-			break;
-		case gxapi::eUavDimension::BUFFER:
-			return D3D12_UAV_DIMENSION_BUFFER;
-		case gxapi::eUavDimension::TEXTURE1D:
-			return D3D12_UAV_DIMENSION_TEXTURE1D;
-		case gxapi::eUavDimension::TEXTURE1DARRAY:
-			return D3D12_UAV_DIMENSION_TEXTURE1DARRAY;
-		case gxapi::eUavDimension::TEXTURE2D:
-			return D3D12_UAV_DIMENSION_TEXTURE2D;
-		case gxapi::eUavDimension::TEXTURE2DARRAY:
-			return D3D12_UAV_DIMENSION_TEXTURE2DARRAY;
-		case gxapi::eUavDimension::TEXTURE3D:
-			return D3D12_UAV_DIMENSION_TEXTURE3D;
-		default:
-			assert(false);
-			break;
-	}
+// eUavDimension has the values of D3D12_UAV_DIMENSION.
+static_assert((int)gxapi::eUavDimension::BUFFER == (int)D3D12_UAV_DIMENSION_BUFFER);
+static_assert((int)gxapi::eUavDimension::TEXTURE1D == (int)D3D12_UAV_DIMENSION_TEXTURE1D);
+static_assert((int)gxapi::eUavDimension::TEXTURE1DARRAY == (int)D3D12_UAV_DIMENSION_TEXTURE1DARRAY);
+static_assert((int)gxapi::eUavDimension::TEXTURE2D == (int)D3D12_UAV_DIMENSION_TEXTURE2D);
+static_assert((int)gxapi::eUavDimension::TEXTURE2DARRAY == (int)D3D12_UAV_DIMENSION_TEXTURE2DARRAY);
+static_assert((int)gxapi::eUavDimension::TEXTURE3D == (int)D3D12_UAV_DIMENSION_TEXTURE3D);
 
-	return D3D12_UAV_DIMENSION{};
+D3D12_UAV_DIMENSION native_cast(gxapi::eUavDimension source) {
+	assert(source != gxapi::eUavDimension::UNKNOWN);
+	return static_cast<D3D12_UAV_DIMENSION>(source);
 }
 
 
+static constexpr D3D12_RESOURCE_BARRIER_FLAGS s_resourceBarrierSplitTable[] = {
+	D3D12_RESOURCE_BARRIER_FLAG_NONE, // NORMAL
+	D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY, // BEGIN
+	D3D12_RESOURCE_BARRIER_FLAG_END_ONLY, // END
+};
+static_assert(std::size(s_resourceBarrierSplitTable) == (size_t)gxapi::eResourceBarrierSplit::END + 1);
+
 D3D12_RESOURCE_BARRIER_FLAGS native_cast(gxapi::eResourceBarrierSplit source) {
-	switch (source) {
-		case gxapi::eResourceBarrierSplit::BEGIN:
-			return D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
-		case gxapi::eResourceBarrierSplit::END:
-			return D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
-		case gxapi::eResourceBarrierSplit::NORMAL:
-			return D3D12_RESOURCE_BARRIER_FLAG_NONE;
-		default:
-			return D3D12_RESOURCE_BARRIER_FLAGS(0);
-	}
+	assert((size_t)source < std::size(s_resourceBarrierSplitTable));
+	return s_resourceBarrierSplitTable[(size_t)source];
 }
 
+static constexpr D3D12_RESOURCE_BARRIER_TYPE s_resourceBarrierTypeTable[] = {
+	D3D12_RESOURCE_BARRIER_TYPE_TRANSITION, // TRANSITION
+	D3D12_RESOURCE_BARRIER_TYPE_ALIASING, // ALIASING
+	D3D12_RESOURCE_BARRIER_TYPE_UAV, // UAV
+};
+static_assert(std::size(s_resourceBarrierTypeTable) == (size_t)gxapi::eResourceBarrierType::UAV + 1);
+
 D3D12_RESOURCE_BARRIER_TYPE native_cast(gxapi::eResourceBarrierType source) {
+	assert((size_t)source < std::size(s_resourceBarrierTypeTable));
+	return s_resourceBarrierTypeTable[(size_t)source];
+}
+
+D3D12_INDIRECT_ARGUMENT_TYPE native_cast(gxapi::eIndirectArgumentType source) {
 	switch (source)
 	{
-		case inl::gxapi::eResourceBarrierType::TRANSITION:
-			return D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-		case inl::gxapi::eResourceBarrierType::ALIASING:
-			return D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
-		case inl::gxapi::eResourceBarrierType::UAV:
-			return D3D12_RESOURCE_BARRIER_TYPE_UAV;
+		case gxapi::eIndirectArgumentType::DRAW:
+			return D3D12_INDIRECT_ARGUMENT_TYPE_DRAW;
+		case gxapi::eIndirectArgumentType::DRAW_INDEXED:
+			return D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+		case gxapi::eIndirectArgumentType::DISPATCH:
+			return D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH;
+		case gxapi::eIndirectArgumentType::VERTEX_BUFFER_VIEW:
+			return D3D12_INDIRECT_ARGUMENT_TYPE_VERTEX_BUFFER_VIEW;
+		case gxapi::eIndirectArgumentType::INDEX_BUFFER_VIEW:
+			return D3D12_INDIRECT_ARGUMENT_TYPE_INDEX_BUFFER_VIEW;
+		case gxapi::eIndirectArgumentType::CONSTANT:
+			return D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT;
+		case gxapi::eIndirectArgumentType::CONSTANT_BUFFER_VIEW:
+			return D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT_BUFFER_VIEW;
+		case gxapi::eIndirectArgumentType::SHADER_RESOURCE_VIEW:
+			return D3D12_INDIRECT_ARGUMENT_TYPE_SHADER_RESOURCE_VIEW;
+		case gxapi::eIndirectArgumentType::UNORDERED_ACCESS_VIEW:
+			return D3D12_INDIRECT_ARGUMENT_TYPE_UNORDERED_ACCESS_VIEW;
 		default:
-			return D3D12_RESOURCE_BARRIER_TYPE(0);
+			assert(false);
+			return D3D12_INDIRECT_ARGUMENT_TYPE(0);
 	}
 }
 
 
-//---------------
-//FLAGS
+#ifdef __ID3D12GraphicsCommandList5_INTERFACE_DEFINED__
+static_assert((int)gxapi::eShadingRate::RATE_1X1 == (int)D3D12_SHADING_RATE_1X1);
+static_assert((int)gxapi::eShadingRate::RATE_1X2 == (int)D3D12_SHADING_RATE_1X2);
+static_assert((int)gxapi::eShadingRate::RATE_2X1 == (int)D3D12_SHADING_RATE_2X1);
+static_assert((int)gxapi::eShadingRate::RATE_2X2 == (int)D3D12_SHADING_RATE_2X2);
+static_assert((int)gxapi::eShadingRate::RATE_2X4 == (int)D3D12_SHADING_RATE_2X4);
+static_assert((int)gxapi::eShadingRate::RATE_4X2 == (int)D3D12_SHADING_RATE_4X2);
+static_assert((int)gxapi::eShadingRate::RATE_4X4 == (int)D3D12_SHADING_RATE_4X4);
 
-D3D12_RESOURCE_FLAGS native_cast(gxapi::eResourceFlags source) {
-	D3D12_RESOURCE_FLAGS result = D3D12_RESOURCE_FLAG_NONE;
+D3D12_SHADING_RATE native_cast(gxapi::eShadingRate source) {
+	return static_cast<D3D12_SHADING_RATE>(source);
+}
 
-	result |= D3D12_RESOURCE_FLAGS(bool(source & gxapi::eResourceFlags::ALLOW_RENDER_TARGET) * D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
-	result |= D3D12_RESOURCE_FLAGS(bool(source & gxapi::eResourceFlags::ALLOW_DEPTH_STENCIL) * D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL);
-	result |= D3D12_RESOURCE_FLAGS(bool(source & gxapi::eResourceFlags::ALLOW_UNORDERED_ACCESS) * D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
-	result |= D3D12_RESOURCE_FLAGS(bool(source & gxapi::eResourceFlags::DENY_SHADER_RESOURCE) * D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE);
-	result |= D3D12_RESOURCE_FLAGS(bool(source & gxapi::eResourceFlags::ALLOW_CROSS_ADAPTER) * D3D12_RESOURCE_FLAG_ALLOW_CROSS_ADAPTER);
-	result |= D3D12_RESOURCE_FLAGS(bool(source & gxapi::eResourceFlags::ALLOW_SIMULTANEOUS_ACCESS) * D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS);
 
-	return result;
+static_assert((int)gxapi::eShadingRateCombiner::PASSTHROUGH == (int)D3D12_SHADING_RATE_COMBINER_PASSTHROUGH);
+static_assert((int)gxapi::eShadingRateCombiner::OVERRIDE == (int)D3D12_SHADING_RATE_COMBINER_OVERRIDE);
+static_assert((int)gxapi::eShadingRateCombiner::MIN == (int)D3D12_SHADING_RATE_COMBINER_MIN);
+static_assert((int)gxapi::eShadingRateCombiner::MAX == (int)D3D12_SHADING_RATE_COMBINER_MAX);
+static_assert((int)gxapi::eShadingRateCombiner::SUM == (int)D3D12_SHADING_RATE_COMBINER_SUM);
+
+D3D12_SHADING_RATE_COMBINER native_cast(gxapi::eShadingRateCombiner source) {
+	return static_cast<D3D12_SHADING_RATE_COMBINER>(source);
 }
+#endif
 
 
-D3D12_HEAP_FLAGS native_cast(gxapi::eHeapFlags source) {
-	D3D12_HEAP_FLAGS result = D3D12_HEAP_FLAG_NONE;
-
-	result |= D3D12_HEAP_FLAGS(bool(source & gxapi::eHeapFlags::SHARED) * D3D12_HEAP_FLAG_SHARED);
-	result |= D3D12_HEAP_FLAGS(bool(source & gxapi::eHeapFlags::DENY_BUFFERS) * D3D12_HEAP_FLAG_DENY_BUFFERS);
-	result |= D3D12_HEAP_FLAGS(bool(source & gxapi::eHeapFlags::ALLOW_DISPLAY) * D3D12_HEAP_FLAG_ALLOW_DISPLAY);
-	result |= D3D12_HEAP_FLAGS(bool(source & gxapi::eHeapFlags::SHARED_CROSS_ADAPTER) * D3D12_HEAP_FLAG_SHARED_CROSS_ADAPTER);
-	result |= D3D12_HEAP_FLAGS(bool(source & gxapi::eHeapFlags::DENY_RT_DS_TEXTURES) * D3D12_HEAP_FLAG_DENY_RT_DS_TEXTURES);
-	result |= D3D12_HEAP_FLAGS(bool(source & gxapi::eHeapFlags::DENY_NON_RT_DS_TEXTURES) * D3D12_HEAP_FLAG_DENY_NON_RT_DS_TEXTURES);
-	result |= D3D12_HEAP_FLAGS(bool(source & gxapi::eHeapFlags::ALLOW_ALL_BUFFERS_AND_TEXTURES) * D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES);
-	result |= D3D12_HEAP_FLAGS(bool(source & gxapi::eHeapFlags::ALLOW_ONLY_BUFFERS) * D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS);
-	result |= D3D12_HEAP_FLAGS(bool(source & gxapi::eHeapFlags::ALLOW_ONLY_NON_RT_DS_TEXTURES) * D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES);
-	result |= D3D12_HEAP_FLAGS(bool(source & gxapi::eHeapFlags::ALLOW_ONLY_RT_DS_TEXTURES) * D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES);
+D3D12_TILE_RANGE_FLAGS native_cast(gxapi::eTileRangeFlags source) {
+	switch (source)
+	{
+		case gxapi::eTileRangeFlags::NONE:
+			return D3D12_TILE_RANGE_FLAG_NONE;
+		case gxapi::eTileRangeFlags::NULL_RANGE:
+			return D3D12_TILE_RANGE_FLAG_NULL;
+		case gxapi::eTileRangeFlags::SKIP:
+			return D3D12_TILE_RANGE_FLAG_SKIP;
+		case gxapi::eTileRangeFlags::REUSE_SINGLE_TILE:
+			return D3D12_TILE_RANGE_FLAG_REUSE_SINGLE_TILE;
+		default:
+			assert(false);
+			return D3D12_TILE_RANGE_FLAG_NONE;
+	}
+}
 
-	return result;
+
+//---------------
+//FLAGS
+
+// The bits of eResourceFlags are the bits of D3D12_RESOURCE_FLAGS.
+static_assert((int)gxapi::eResourceFlags::ALLOW_RENDER_TARGET == (int)D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+static_assert((int)gxapi::eResourceFlags::ALLOW_DEPTH_STENCIL == (int)D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL);
+static_assert((int)gxapi::eResourceFlags::ALLOW_UNORDERED_ACCESS == (int)D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+static_assert((int)gxapi::eResourceFlags::DENY_SHADER_RESOURCE == (int)D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE);
+static_assert((int)gxapi::eResourceFlags::ALLOW_CROSS_ADAPTER == (int)D3D12_RESOURCE_FLAG_ALLOW_CROSS_ADAPTER);
+static_assert((int)gxapi::eResourceFlags::ALLOW_SIMULTANEOUS_ACCESS == (int)D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS);
+
+D3D12_RESOURCE_FLAGS native_cast(gxapi::eResourceFlags source) {
+	return static_cast<D3D12_RESOURCE_FLAGS>((gxapi::eResourceFlags::EnumT)source);
 }
 
 
-D3D12_RESOURCE_STATES native_cast(gxapi::eResourceState source) {
-	D3D12_RESOURCE_STATES nativeFlag = static_cast<D3D12_RESOURCE_STATES>(0);
+// The bits of eHeapFlags are the bits of D3D12_HEAP_FLAGS.
+static_assert((int)gxapi::eHeapFlags::SHARED == (int)D3D12_HEAP_FLAG_SHARED);
+static_assert((int)gxapi::eHeapFlags::DENY_BUFFERS == (int)D3D12_HEAP_FLAG_DENY_BUFFERS);
+static_assert((int)gxapi::eHeapFlags::ALLOW_DISPLAY == (int)D3D12_HEAP_FLAG_ALLOW_DISPLAY);
+static_assert((int)gxapi::eHeapFlags::SHARED_CROSS_ADAPTER == (int)D3D12_HEAP_FLAG_SHARED_CROSS_ADAPTER);
+static_assert((int)gxapi::eHeapFlags::DENY_RT_DS_TEXTURES == (int)D3D12_HEAP_FLAG_DENY_RT_DS_TEXTURES);
+static_assert((int)gxapi::eHeapFlags::DENY_NON_RT_DS_TEXTURES == (int)D3D12_HEAP_FLAG_DENY_NON_RT_DS_TEXTURES);
+static_assert((int)gxapi::eHeapFlags::ALLOW_ALL_BUFFERS_AND_TEXTURES == (int)D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES);
+static_assert((int)gxapi::eHeapFlags::ALLOW_ONLY_BUFFERS == (int)D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS);
+static_assert((int)gxapi::eHeapFlags::ALLOW_ONLY_NON_RT_DS_TEXTURES == (int)D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES);
+static_assert((int)gxapi::eHeapFlags::ALLOW_ONLY_RT_DS_TEXTURES == (int)D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES);
 
-	// native  |= (boolean cast -> 1 if true, 0 if false ) * native value;
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::COMMON) * D3D12_RESOURCE_STATE_COMMON);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER) * D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::INDEX_BUFFER) * D3D12_RESOURCE_STATE_INDEX_BUFFER);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::RENDER_TARGET) * D3D12_RESOURCE_STATE_RENDER_TARGET);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::UNORDERED_ACCESS) * D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::DEPTH_WRITE) * D3D12_RESOURCE_STATE_DEPTH_WRITE);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::DEPTH_READ) * D3D12_RESOURCE_STATE_DEPTH_READ);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE) * D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::PIXEL_SHADER_RESOURCE) * D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::STREAM_OUT) * D3D12_RESOURCE_STATE_STREAM_OUT);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::INDIRECT_ARGUMENT) * D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::COPY_DEST) * D3D12_RESOURCE_STATE_COPY_DEST);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::COPY_SOURCE) * D3D12_RESOURCE_STATE_COPY_SOURCE);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::RESOLVE_DEST) * D3D12_RESOURCE_STATE_RESOLVE_DEST);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::RESOLVE_SOURCE) * D3D12_RESOURCE_STATE_RESOLVE_SOURCE);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::GENERIC_READ) * D3D12_RESOURCE_STATE_GENERIC_READ);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::PRESENT) * D3D12_RESOURCE_STATE_PRESENT);
-	nativeFlag |= D3D12_RESOURCE_STATES(bool(source & gxapi::eResourceState::PREDICATION) * D3D12_RESOURCE_STATE_PREDICATION);
+D3D12_HEAP_FLAGS native_cast(gxapi::eHeapFlags source) {
+	return static_cast<D3D12_HEAP_FLAGS>((gxapi::eHeapFlags::EnumT)source);
+}
+
+
+// The bits of eResourceState are the bits of D3D12_RESOURCE_STATES.
+static_assert((int)gxapi::eResourceState::COMMON == (int)D3D12_RESOURCE_STATE_COMMON);
+static_assert((int)gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER == (int)D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+static_assert((int)gxapi::eResourceState::INDEX_BUFFER == (int)D3D12_RESOURCE_STATE_INDEX_BUFFER);
+static_assert((int)gxapi::eResourceState::RENDER_TARGET == (int)D3D12_RESOURCE_STATE_RENDER_TARGET);
+static_assert((int)gxapi::eResourceState::UNORDERED_ACCESS == (int)D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+static_assert((int)gxapi::eResourceState::DEPTH_WRITE == (int)D3D12_RESOURCE_STATE_DEPTH_WRITE);
+static_assert((int)gxapi::eResourceState::DEPTH_READ == (int)D3D12_RESOURCE_STATE_DEPTH_READ);
+static_assert((int)gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE == (int)D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+static_assert((int)gxapi::eResourceState::PIXEL_SHADER_RESOURCE == (int)D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+static_assert((int)gxapi::eResourceState::STREAM_OUT == (int)D3D12_RESOURCE_STATE_STREAM_OUT);
+static_assert((int)gxapi::eResourceState::INDIRECT_ARGUMENT == (int)D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+static_assert((int)gxapi::eResourceState::COPY_DEST == (int)D3D12_RESOURCE_STATE_COPY_DEST);
+static_assert((int)gxapi::eResourceState::COPY_SOURCE == (int)D3D12_RESOURCE_STATE_COPY_SOURCE);
+static_assert((int)gxapi::eResourceState::RESOLVE_DEST == (int)D3D12_RESOURCE_STATE_RESOLVE_DEST);
+static_assert((int)gxapi::eResourceState::RESOLVE_SOURCE == (int)D3D12_RESOURCE_STATE_RESOLVE_SOURCE);
+#ifdef __ID3D12GraphicsCommandList5_INTERFACE_DEFINED__
+static_assert((int)gxapi::eResourceState::SHADING_RATE_SOURCE == (int)D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE);
+#endif
+static_assert((int)gxapi::eResourceState::GENERIC_READ == (int)D3D12_RESOURCE_STATE_GENERIC_READ);
+static_assert((int)gxapi::eResourceState::PRESENT == (int)D3D12_RESOURCE_STATE_PRESENT);
+static_assert((int)gxapi::eResourceState::PREDICATION == (int)D3D12_RESOURCE_STATE_PREDICATION);
 
-	return nativeFlag;
+D3D12_RESOURCE_STATES native_cast(gxapi::eResourceState source) {
+	return static_cast<D3D12_RESOURCE_STATES>((gxapi::eResourceState::EnumT)source);
 }
 
 
@@ -1211,6 +1226,36 @@ D3D12_ROOT_DESCRIPTOR native_cast(gxapi::RootDescriptor source) {
 }
 
 
+D3D12_INDIRECT_ARGUMENT_DESC native_cast(gxapi::IndirectArgumentDesc source) {
+	D3D12_INDIRECT_ARGUMENT_DESC result = {};
+
+	result.Type = native_cast(source.type);
+	switch (source.type) {
+		case gxapi::eIndirectArgumentType::VERTEX_BUFFER_VIEW:
+			result.VertexBuffer.Slot = source.slot;
+			break;
+		case gxapi::eIndirectArgumentType::CONSTANT:
+			result.Constant.RootParameterIndex = source.rootParameterIndex;
+			result.Constant.DestOffsetIn32BitValues = source.destOffset;
+			result.Constant.Num32BitValuesToSet = source.numConstants;
+			break;
+		case gxapi::eIndirectArgumentType::CONSTANT_BUFFER_VIEW:
+			result.ConstantBufferView.RootParameterIndex = source.rootParameterIndex;
+			break;
+		case gxapi::eIndirectArgumentType::SHADER_RESOURCE_VIEW:
+			result.ShaderResourceView.RootParameterIndex = source.rootParameterIndex;
+			break;
+		case gxapi::eIndirectArgumentType::UNORDERED_ACCESS_VIEW:
+			result.UnorderedAccessView.RootParameterIndex = source.rootParameterIndex;
+			break;
+		default:
+			break;
+	}
+
+	return result;
+}
+
+
 D3D12_HEAP_PROPERTIES native_cast(gxapi::HeapProperties source) {
 	D3D12_HEAP_PROPERTIES result;
 	
@@ -1238,7 +1283,7 @@ D3D12_RESOURCE_DESC native_cast(gxapi::ResourceDesc source) {
 		result.SampleDesc.Count = 1;
 		result.SampleDesc.Quality = 0;
 		result.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-		result.Flags = D3D12_RESOURCE_FLAG_NONE; //TODO (?)
+		result.Flags = native_cast(source.bufferDesc.flags);
 	}
 	else if (source.type == gxapi::eResourceType::TEXTURE) {
 		const auto& tex = source.textureDesc;
@@ -1602,7 +1647,7 @@ DXGI_SWAP_CHAIN_DESC native_cast(gxapi::SwapChainDesc source) {
 	result.Windowed = !source.isFullScreen;
 	result.SwapEffect = source.multisampleCount > 1 ? DXGI_SWAP_EFFECT_DISCARD : DXGI_SWAP_EFFECT_FLIP_DISCARD;
 
-	result.Flags = 0;
+	result.Flags = source.frameLatencyWaitable ? DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT : 0;
 
 	return result;
 }
@@ -1933,7 +1978,9 @@ D3D12_DESCRIPTOR_RANGE native_cast(gxapi::DescriptorRange source) {
 	D3D12_DESCRIPTOR_RANGE result;
 
 	result.BaseShaderRegister = source.baseShaderRegister;
-	result.NumDescriptors = source.numDescriptors;
+	result.NumDescriptors =
+		source.numDescriptors == gxapi::DescriptorRange::UNBOUNDED ?
+		UINT_MAX : source.numDescriptors; // D3D12 takes -1 as unbounded.
 	result.OffsetInDescriptorsFromTableStart =
 		source.offsetFromTableStart == gxapi::DescriptorRange::OFFSET_APPEND ?
 		D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND : source.offsetFromTableStart;
@@ -1964,7 +2011,7 @@ D3D12_SHADER_BYTECODE native_cast(gxapi::ShaderByteCodeDesc source) {
 }
 
 
-D3D12_RESOURCE_BARRIER native_cast(gxapi::ResourceBarrier source) {
+D3D12_RESOURCE_BARRIER native_cast(const gxapi::ResourceBarrier& source) {
 	D3D12_RESOURCE_BARRIER native{};
 	native.Type = native_cast(source.type);
 	native.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
@@ -1981,6 +2028,8 @@ D3D12_RESOURCE_BARRIER native_cast(gxapi::ResourceBarrier source) {
 			native.Flags = native_cast(source.transition.splitMode);
 			break;
 		case gxapi::eResourceBarrierType::ALIASING:
+			native.Aliasing.pResourceBefore = native_cast(source.aliasing.resourceBefore);
+			native.Aliasing.pResourceAfter = native_cast(source.aliasing.resourceAfter);
 			break;
 		case gxapi::eResourceBarrierType::UAV:
 			native.UAV.pResource = native_cast(source.uav.resource);
@@ -1992,6 +2041,24 @@ D3D12_RESOURCE_BARRIER native_cast(gxapi::ResourceBarrier source) {
 }
 
 
+////////////////////////////////////////////////////////////
+// ARRAYS
+////////////////////////////////////////////////////////////
+
+void native_cast(const gxapi::ResourceBarrier* source, size_t count, D3D12_RESOURCE_BARRIER* destination) {
+	for (size_t i = 0; i < count; ++i) {
+		destination[i] = native_cast(source[i]);
+	}
+}
+
+
+void native_cast(const gxapi::DescriptorHandle* source, size_t count, D3D12_CPU_DESCRIPTOR_HANDLE* destination) {
+	for (size_t i = 0; i < count; ++i) {
+		destination[i].ptr = native_cast_ptr(source[i].cpuAddress);
+	}
+}
+
+
 
 
 
@@ -2153,6 +2220,48 @@ gxapi::eFormat native_cast(DXGI_FORMAT source) {
 		return gxapi::eFormat::R8_SINT;
 	case DXGI_FORMAT_A8_UNORM:
 		return gxapi::eFormat::A8_UNORM;
+	case DXGI_FORMAT_BC1_TYPELESS:
+		return gxapi::eFormat::BC1_TYPELESS;
+	case DXGI_FORMAT_BC1_UNORM:
+		return gxapi::eFormat::BC1_UNORM;
+	case DXGI_FORMAT_BC1_UNORM_SRGB:
+		return gxapi::eFormat::BC1_UNORM_SRGB;
+	case DXGI_FORMAT_BC2_TYPELESS:
+		return gxapi::eFormat::BC2_TYPELESS;
+	case DXGI_FORMAT_BC2_UNORM:
+		return gxapi::eFormat::BC2_UNORM;
+	case DXGI_FORMAT_BC2_UNORM_SRGB:
+		return gxapi::eFormat::BC2_UNORM_SRGB;
+	case DXGI_FORMAT_BC3_TYPELESS:
+		return gxapi::eFormat::BC3_TYPELESS;
+	case DXGI_FORMAT_BC3_UNORM:
+		return gxapi::eFormat::BC3_UNORM;
+	case DXGI_FORMAT_BC3_UNORM_SRGB:
+		return gxapi::eFormat::BC3_UNORM_SRGB;
+	case DXGI_FORMAT_BC4_TYPELESS:
+		return gxapi::eFormat::BC4_TYPELESS;
+	case DXGI_FORMAT_BC4_UNORM:
+		return gxapi::eFormat::BC4_UNORM;
+	case DXGI_FORMAT_BC4_SNORM:
+		return gxapi::eFormat::BC4_SNORM;
+	case DXGI_FORMAT_BC5_TYPELESS:
+		return gxapi::eFormat::BC5_TYPELESS;
+	case DXGI_FORMAT_BC5_UNORM:
+		return gxapi::eFormat::BC5_UNORM;
+	case DXGI_FORMAT_BC5_SNORM:
+		return gxapi::eFormat::BC5_SNORM;
+	case DXGI_FORMAT_BC6H_TYPELESS:
+		return gxapi::eFormat::BC6H_TYPELESS;
+	case DXGI_FORMAT_BC6H_UF16:
+		return gxapi::eFormat::BC6H_UF16;
+	case DXGI_FORMAT_BC6H_SF16:
+		return gxapi::eFormat::BC6H_SF16;
+	case DXGI_FORMAT_BC7_TYPELESS:
+		return gxapi::eFormat::BC7_TYPELESS;
+	case DXGI_FORMAT_BC7_UNORM:
+		return gxapi::eFormat::BC7_UNORM;
+	case DXGI_FORMAT_BC7_UNORM_SRGB:
+		return gxapi::eFormat::BC7_UNORM_SRGB;
 	default:
 		assert(false);
 		break;
@@ -2182,30 +2291,13 @@ gxapi::eTextureLayout native_cast(D3D12_TEXTURE_LAYOUT source) {
 
 
 gxapi::eResourceFlags native_cast(D3D12_RESOURCE_FLAGS source) {
-	using gxapi::eResourceFlags;
-
-	gxapi::eResourceFlags result = eResourceFlags::NONE;
-
-	if ((source & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) != 0) {
-		result += eResourceFlags::ALLOW_RENDER_TARGET;
-	}
-	if ((source & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) != 0) {
-		result += eResourceFlags::ALLOW_DEPTH_STENCIL;
-	}
-	if ((source & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS) != 0) {
-		result += eResourceFlags::ALLOW_UNORDERED_ACCESS;
-	}
-	if ((source & D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE) != 0) {
-		result += eResourceFlags::DENY_SHADER_RESOURCE;
-	}
-	if ((source & D3D12_RESOURCE_FLAG_ALLOW_CROSS_ADAPTER) != 0) {
-		result += eResourceFlags::ALLOW_CROSS_ADAPTER;
-	}
-	if ((source & D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS) != 0) {
-		result += eResourceFlags::ALLOW_SIMULTANEOUS_ACCESS;
-	}
-
-	return result;
+	const auto knownFlags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET
+		| D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL
+		| D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS
+		| D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE
+		| D3D12_RESOURCE_FLAG_ALLOW_CROSS_ADAPTER
+		| D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS;
+	return static_cast<gxapi::eResourceFlags::EnumT>(source & knownFlags);
 }
 
 
@@ -2292,6 +2384,7 @@ gxapi::ResourceDesc native_cast(D3D12_RESOURCE_DESC source) {
 
 	if (result.type == gxapi::eResourceType::BUFFER) {
 		result.bufferDesc.sizeInBytes = source.Width;
+		result.bufferDesc.flags = native_cast(source.Flags);
 	}
 	else if (result.type == gxapi::eResourceType::TEXTURE) {
 		result.textureDesc = gxapi::TextureDesc{
@@ -2324,6 +2417,7 @@ gxapi::SwapChainDesc native_cast(DXGI_SWAP_CHAIN_DESC source) {
 	result.numBuffers = source.BufferCount;
 	result.targetWindow = source.OutputWindow;
 	result.isFullScreen = !source.Windowed;
+	result.frameLatencyWaitable = (source.Flags & DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT) != 0;
 
 	return result;
 }
@@ -5,6 +5,9 @@
 #include "CommandAllocator.hpp"
 #include "CommandQueue.hpp"
 #include "RootSignature.hpp"
+#include "CommandSignature.hpp"
+#include "QueryHeap.hpp"
+#include "Heap.hpp"
 #include "DescriptorHeap.hpp"
 #include "CommandList.hpp"
 #include "Fence.hpp"
@@ -49,6 +52,12 @@ ID3D12GraphicsCommandList* native_cast(gxapi::IGraphicsCommandList* source);
 
 ID3D12RootSignature* native_cast(gxapi::IRootSignature* source);
 
+ID3D12CommandSignature* native_cast(gxapi::ICommandSignature* source);
+
+ID3D12QueryHeap* native_cast(gxapi::IQueryHeap* source);
+
+ID3D12Heap* native_cast(gxapi::IHeap* source);
+
 ID3D12DescriptorHeap* native_cast(gxapi::IDescriptorHeap* source);
 
 ID3D12Fence* native_cast(gxapi::IFence* source);
@@ -65,6 +74,10 @@ D3D12_COMMAND_LIST_TYPE native_cast(gxapi::eCommandListType source);
 
 D3D12_DESCRIPTOR_HEAP_TYPE native_cast(gxapi::eDescriptorHeapType source);
 
+D3D12_QUERY_HEAP_TYPE native_cast(gxapi::eQueryHeapType source);
+
+D3D12_QUERY_TYPE native_cast(gxapi::eQueryType source);
+
 D3D12_ROOT_PARAMETER_TYPE native_cast(gxapi::RootParameterDesc::eType source);
 
 D3D12_DESCRIPTOR_RANGE_TYPE native_cast(gxapi::DescriptorRange::eType source);
@@ -123,6 +136,16 @@ D3D12_RESOURCE_BARRIER_FLAGS native_cast(gxapi::eResourceBarrierSplit source);
 
 D3D12_RESOURCE_BARRIER_TYPE native_cast(gxapi::eResourceBarrierType source);
 
+D3D12_INDIRECT_ARGUMENT_TYPE native_cast(gxapi::eIndirectArgumentType source);
+
+D3D12_TILE_RANGE_FLAGS native_cast(gxapi::eTileRangeFlags source);
+
+#ifdef __ID3D12GraphicsCommandList5_INTERFACE_DEFINED__
+D3D12_SHADING_RATE native_cast(gxapi::eShadingRate source);
+
+D3D12_SHADING_RATE_COMBINER native_cast(gxapi::eShadingRateCombiner source);
+#endif
+
 //---------------
 //FLAGS
 D3D12_RESOURCE_FLAGS native_cast(gxapi::eResourceFlags source);
@@ -247,7 +270,15 @@ D3D12_TEX2D_ARRAY_UAV native_cast(gxapi::UavTexture2DArray source);
 
 D3D12_TEX3D_UAV native_cast(gxapi::UavTexture3D source);
 
-D3D12_RESOURCE_BARRIER native_cast(gxapi::ResourceBarrier source);
+D3D12_RESOURCE_BARRIER native_cast(const gxapi::ResourceBarrier& source);
+
+
+//---------------
+//ARRAYS
+// They write into preallocated arrays, so that hot paths can reuse their buffers.
+void native_cast(const gxapi::ResourceBarrier* source, size_t count, D3D12_RESOURCE_BARRIER* destination);
+
+void native_cast(const gxapi::DescriptorHandle* source, size_t count, D3D12_CPU_DESCRIPTOR_HANDLE* destination);
 
 
 //---------------
@@ -256,6 +287,8 @@ D3D12_DESCRIPTOR_RANGE native_cast(gxapi::DescriptorRange source);
 
 D3D12_ROOT_CONSTANTS native_cast(gxapi::RootConstant source);
 
+D3D12_INDIRECT_ARGUMENT_DESC native_cast(gxapi::IndirectArgumentDesc source);
+
 D3D12_SHADER_BYTECODE native_cast(gxapi::ShaderByteCodeDesc source);
 
 
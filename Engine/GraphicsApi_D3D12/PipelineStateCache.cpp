@@ -0,0 +1,282 @@
+#include "PipelineStateCache.hpp"
+
+#include "ExceptionExpansions.hpp"
+
+#include "../GraphicsApi_LL/Exception.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+
+namespace inl {
+namespace gxapi_dx12 {
+
+
+namespace {
+
+// 64 bit FNV-1a, structures are hashed member by member to skip padding.
+class Hasher {
+public:
+	void Add(const void* data, size_t size) {
+		auto bytes = reinterpret_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			m_hash ^= bytes[i];
+			m_hash *= 1099511628211ull;
+		}
+	}
+
+	template <class T>
+	void Add(const T& value) {
+		static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "Hash structures member by member.");
+		Add(&value, sizeof(value));
+	}
+
+	void Add(const D3D12_SHADER_BYTECODE& shader) {
+		Add(shader.BytecodeLength);
+		Add(shader.pShaderBytecode, shader.BytecodeLength);
+	}
+
+	void Add(const char* str) {
+		size_t length = str ? std::strlen(str) : 0;
+		Add(length);
+		Add(str, length);
+	}
+
+	uint64_t Get() const { return m_hash; }
+
+private:
+	uint64_t m_hash = 14695981039346656037ull;
+};
+
+
+void AddStencilOp(Hasher& hasher, const D3D12_DEPTH_STENCILOP_DESC& desc) {
+	hasher.Add(desc.StencilFailOp);
+	hasher.Add(desc.StencilDepthFailOp);
+	hasher.Add(desc.StencilPassOp);
+	hasher.Add(desc.StencilFunc);
+}
+
+} // namespace
+
+
+PipelineStateCache::PipelineStateCache(ComPtr<ID3D12Device> device)
+	: m_device(device) {}
+
+
+void PipelineStateCache::Open(const std::string& path) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+
+	ComPtr<ID3D12Device1> device1;
+	if (FAILED(m_device.As(&device1))) {
+		return; // Pipeline libraries need a newer runtime.
+	}
+
+	m_path = path;
+	m_dirty = false;
+	m_library.Reset();
+	m_libraryBlob.clear();
+
+	std::ifstream file(path, std::ios::binary);
+	if (file.is_open()) {
+		m_libraryBlob.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	if (!m_libraryBlob.empty()) {
+		// Fails with a driver or adapter mismatch, or if the file is corrupt, the cache is rebuilt then.
+		if (SUCCEEDED(device1->CreatePipelineLibrary(m_libraryBlob.data(), m_libraryBlob.size(), IID_PPV_ARGS(&m_library)))) {
+			return;
+		}
+		m_libraryBlob.clear();
+	}
+
+	if (FAILED(device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&m_library)))) {
+		m_library.Reset(); // Not supported by the driver.
+	}
+}
+
+
+void PipelineStateCache::Save() {
+	std::lock_guard<std::mutex> lock(m_mtx);
+
+	if (!m_library || !m_dirty) {
+		return;
+	}
+
+	std::vector<char> data(m_library->GetSerializedSize());
+	ThrowIfFailed(m_library->Serialize(data.data(), data.size()), "While serializing pipeline library");
+
+	std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		throw RuntimeException("Failed to open pipeline cache file for writing.", m_path);
+	}
+	file.write(data.data(), data.size());
+	m_dirty = false;
+}
+
+
+ComPtr<ID3D12PipelineState> PipelineStateCache::CreateGraphics(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash) {
+	ComPtr<ID3D12PipelineState> native;
+	std::wstring name;
+
+	if (m_library) {
+		name = GetName(L'G', Hash(desc, rootSignatureHash));
+		std::lock_guard<std::mutex> lock(m_mtx);
+		if (SUCCEEDED(m_library->LoadGraphicsPipeline(name.c_str(), &desc, IID_PPV_ARGS(&native)))) {
+			++m_hitCount;
+			return native;
+		}
+		++m_missCount;
+	}
+
+	// Compiled outside the lock so that nodes can keep creating pipeline states in parallel.
+	ThrowIfFailed(m_device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&native)), "While creating graphics PSO");
+
+	if (m_library) {
+		Store(name, native.Get());
+	}
+	return native;
+}
+
+
+ComPtr<ID3D12PipelineState> PipelineStateCache::CreateCompute(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash) {
+	ComPtr<ID3D12PipelineState> native;
+	std::wstring name;
+
+	if (m_library) {
+		name = GetName(L'C', Hash(desc, rootSignatureHash));
+		std::lock_guard<std::mutex> lock(m_mtx);
+		if (SUCCEEDED(m_library->LoadComputePipeline(name.c_str(), &desc, IID_PPV_ARGS(&native)))) {
+			++m_hitCount;
+			return native;
+		}
+		++m_missCount;
+	}
+
+	ThrowIfFailed(m_device->CreateComputePipelineState(&desc, IID_PPV_ARGS(&native)), "While creating compute PSO");
+
+	if (m_library) {
+		Store(name, native.Get());
+	}
+	return native;
+}
+
+
+uint64_t PipelineStateCache::Hash(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash) {
+	Hasher hasher;
+	hasher.Add(rootSignatureHash);
+	hasher.Add(desc.VS);
+	hasher.Add(desc.PS);
+	hasher.Add(desc.DS);
+	hasher.Add(desc.HS);
+	hasher.Add(desc.GS);
+
+	hasher.Add(desc.StreamOutput.NumEntries);
+	hasher.Add(desc.StreamOutput.NumStrides);
+	hasher.Add(desc.StreamOutput.RasterizedStream);
+
+	hasher.Add(desc.BlendState.AlphaToCoverageEnable);
+	hasher.Add(desc.BlendState.IndependentBlendEnable);
+	for (const auto& target : desc.BlendState.RenderTarget) {
+		hasher.Add(target.BlendEnable);
+		hasher.Add(target.LogicOpEnable);
+		hasher.Add(target.SrcBlend);
+		hasher.Add(target.DestBlend);
+		hasher.Add(target.BlendOp);
+		hasher.Add(target.SrcBlendAlpha);
+		hasher.Add(target.DestBlendAlpha);
+		hasher.Add(target.BlendOpAlpha);
+		hasher.Add(target.LogicOp);
+		hasher.Add(target.RenderTargetWriteMask);
+	}
+	hasher.Add(desc.SampleMask);
+
+	const auto& rasterizer = desc.RasterizerState;
+	hasher.Add(rasterizer.FillMode);
+	hasher.Add(rasterizer.CullMode);
+	hasher.Add(rasterizer.FrontCounterClockwise);
+	hasher.Add(rasterizer.DepthBias);
+	hasher.Add(rasterizer.DepthBiasClamp);
+	hasher.Add(rasterizer.SlopeScaledDepthBias);
+	hasher.Add(rasterizer.DepthClipEnable);
+	hasher.Add(rasterizer.MultisampleEnable);
+	hasher.Add(rasterizer.AntialiasedLineEnable);
+	hasher.Add(rasterizer.ForcedSampleCount);
+	hasher.Add(rasterizer.ConservativeRaster);
+
+	const auto& depthStencil = desc.DepthStencilState;
+	hasher.Add(depthStencil.DepthEnable);
+	hasher.Add(depthStencil.DepthWriteMask);
+	hasher.Add(depthStencil.DepthFunc);
+	hasher.Add(depthStencil.StencilEnable);
+	hasher.Add(depthStencil.StencilReadMask);
+	hasher.Add(depthStencil.StencilWriteMask);
+	AddStencilOp(hasher, depthStencil.FrontFace);
+	AddStencilOp(hasher, depthStencil.BackFace);
+
+	hasher.Add(desc.InputLayout.NumElements);
+	for (UINT i = 0; i < desc.InputLayout.NumElements; ++i) {
+		const auto& element = desc.InputLayout.pInputElementDescs[i];
+		hasher.Add(element.SemanticName);
+		hasher.Add(element.SemanticIndex);
+		hasher.Add(element.Format);
+		hasher.Add(element.InputSlot);
+		hasher.Add(element.AlignedByteOffset);
+		hasher.Add(element.InputSlotClass);
+		hasher.Add(element.InstanceDataStepRate);
+	}
+
+	hasher.Add(desc.IBStripCutValue);
+	hasher.Add(desc.PrimitiveTopologyType);
+	hasher.Add(desc.NumRenderTargets);
+	for (auto format : desc.RTVFormats) {
+		hasher.Add(format);
+	}
+	hasher.Add(desc.DSVFormat);
+	hasher.Add(desc.SampleDesc.Count);
+	hasher.Add(desc.SampleDesc.Quality);
+	hasher.Add(desc.NodeMask);
+	hasher.Add(desc.Flags);
+	return hasher.Get();
+}
+
+
+uint64_t PipelineStateCache::Hash(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash) {
+	Hasher hasher;
+	hasher.Add(rootSignatureHash);
+	hasher.Add(desc.CS);
+	hasher.Add(desc.NodeMask);
+	hasher.Add(desc.Flags);
+	return hasher.Get();
+}
+
+
+uint64_t PipelineStateCache::Hash(const void* data, size_t size) {
+	Hasher hasher;
+	hasher.Add(data, size);
+	return hasher.Get();
+}
+
+
+std::wstring PipelineStateCache::GetName(wchar_t prefix, uint64_t hash) {
+	static constexpr wchar_t digits[] = L"0123456789abcdef";
+	std::wstring name(17, prefix);
+	for (int i = 16; i > 0; --i, hash >>= 4) {
+		name[i] = digits[hash & 0xF];
+	}
+	return name;
+}
+
+
+void PipelineStateCache::Store(const std::wstring& name, ID3D12PipelineState* pipelineState) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	// Fails if another thread has stored the same state meanwhile, or if two
+	// different descriptions collide on the hash. Both are harmless, the state is just not cached.
+	if (SUCCEEDED(m_library->StorePipeline(name.c_str(), pipelineState))) {
+		m_dirty = true;
+	}
+}
+
+
+} // namespace gxapi_dx12
+} // namespace inl
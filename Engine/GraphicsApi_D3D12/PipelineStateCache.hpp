@@ -0,0 +1,65 @@
+#pragma once
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <wrl.h>
+#include <d3d12.h>
+#include "../GraphicsApi_LL/DisableWin32Macros.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace inl {
+namespace gxapi_dx12 {
+
+using Microsoft::WRL::ComPtr;
+
+
+/// <summary>
+/// Keeps compiled pipeline states in an ID3D12PipelineLibrary that is loaded from and saved to a file,
+/// so that pipeline states seen in earlier runs are not compiled again by the driver.
+/// </summary>
+/// <remarks> Pipeline states are keyed by a hash of the full description, including the shader bytecode
+///		and the serialized root signature. The cache is inactive until a file is opened,
+///		or if the device does not support pipeline libraries. </remarks>
+class PipelineStateCache {
+public:
+	PipelineStateCache(ComPtr<ID3D12Device> device);
+
+	/// <summary> Loads the library from the file, or starts an empty one if the file is missing or was made by another driver. </summary>
+	void Open(const std::string& path);
+
+	/// <summary> Writes the library back to the opened file if new pipeline states were added. </summary>
+	void Save();
+
+	/// <param name="rootSignatureHash"> Hash of the serialized root signature referenced by the description. </param>
+	ComPtr<ID3D12PipelineState> CreateGraphics(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash);
+	ComPtr<ID3D12PipelineState> CreateCompute(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash);
+
+	size_t GetHitCount() const { return m_hitCount; }
+	size_t GetMissCount() const { return m_missCount; }
+
+	static uint64_t Hash(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash);
+	static uint64_t Hash(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash);
+	static uint64_t Hash(const void* data, size_t size);
+
+private:
+	static std::wstring GetName(wchar_t prefix, uint64_t hash);
+	void Store(const std::wstring& name, ID3D12PipelineState* pipelineState);
+
+private:
+	ComPtr<ID3D12Device> m_device;
+	ComPtr<ID3D12PipelineLibrary> m_library;
+	std::vector<char> m_libraryBlob; // The library reads from this memory for its whole lifetime.
+	std::string m_path;
+	bool m_dirty = false;
+	size_t m_hitCount = 0;
+	size_t m_missCount = 0;
+	std::mutex m_mtx;
+};
+
+
+} // namespace gxapi_dx12
+} // namespace inl
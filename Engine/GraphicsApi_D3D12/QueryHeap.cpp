@@ -0,0 +1,17 @@
+#include "QueryHeap.hpp"
+
+namespace inl {
+namespace gxapi_dx12 {
+
+QueryHeap::QueryHeap(ComPtr<ID3D12QueryHeap>& native)
+	: m_native{native} {
+}
+
+
+ID3D12QueryHeap* QueryHeap::GetNative() {
+	return m_native.Get();
+}
+
+
+} // namespace gxapi_dx12
+} // namespace inl
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "../GraphicsApi_LL/IQueryHeap.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <wrl.h>
+#include <d3d12.h>
+#include "../GraphicsApi_LL/DisableWin32Macros.h"
+
+namespace inl {
+namespace gxapi_dx12 {
+
+using Microsoft::WRL::ComPtr;
+
+class QueryHeap : public gxapi::IQueryHeap {
+public:
+	QueryHeap(ComPtr<ID3D12QueryHeap>& native);
+
+	ID3D12QueryHeap* GetNative();
+
+protected:
+	ComPtr<ID3D12QueryHeap> m_native;
+};
+
+
+} // namespace gxapi_dx12
+} // namespace inl
@@ -3,8 +3,8 @@
 namespace inl {
 namespace gxapi_dx12 {
 
-RootSignature::RootSignature(ComPtr<ID3D12RootSignature>& native)
-	: m_native{native} {
+RootSignature::RootSignature(ComPtr<ID3D12RootSignature>& native, uint64_t hash)
+	: m_native{native}, m_hash{hash} {
 }
 
 
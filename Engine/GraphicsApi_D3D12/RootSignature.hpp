@@ -15,12 +15,16 @@ using Microsoft::WRL::ComPtr;
 
 class RootSignature : public gxapi::IRootSignature {
 public:
-	RootSignature(ComPtr<ID3D12RootSignature>& native);
+	RootSignature(ComPtr<ID3D12RootSignature>& native, uint64_t hash = 0);
 
 	ID3D12RootSignature* GetNative();
 
+	/// <summary> Hash of the serialized signature, identifies it in the pipeline state cache. </summary>
+	uint64_t GetHash() const { return m_hash; }
+
 protected:
 	ComPtr<ID3D12RootSignature> m_native;
+	uint64_t m_hash;
 };
 
 
@@ -19,6 +19,20 @@ SwapChain::SwapChain(Microsoft::WRL::ComPtr<IDXGISwapChain3> native) {
 		std::unique_ptr<IResource> buf(GetBuffer(i));
 		buf->SetName("BackBuffer");
 	}
+
+	DXGI_SWAP_CHAIN_DESC desc;
+	m_native->GetDesc(&desc);
+	m_flags = desc.Flags;
+	if (m_flags & DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT) {
+		m_frameLatencyWaitable = m_native->GetFrameLatencyWaitableObject();
+	}
+}
+
+
+SwapChain::~SwapChain() {
+	if (m_frameLatencyWaitable) {
+		CloseHandle(m_frameLatencyWaitable);
+	}
 }
 
 
@@ -67,7 +81,7 @@ void SwapChain::SetFullScreen(bool isFullScreen) {
 
 
 void SwapChain::Resize(unsigned width, unsigned height, unsigned bufferCount, eFormat format) {
-	HRESULT err = m_native->ResizeBuffers(bufferCount, width, height, native_cast(format), 0);
+	HRESULT err = m_native->ResizeBuffers(bufferCount, width, height, native_cast(format), m_flags);
 	switch (err) {
 		case S_OK:
 			return;
@@ -84,5 +98,33 @@ void SwapChain::Present() {
 }
 
 
+void SwapChain::SetMaximumFrameLatency(unsigned maxLatency) {
+	if (!m_frameLatencyWaitable) {
+		throw InvalidStateException("Swap chain was not created frame latency waitable.");
+	}
+	if (FAILED(m_native->SetMaximumFrameLatency(maxLatency))) {
+		throw InvalidArgumentException("Maximum frame latency must be between 1 and 16.");
+	}
+}
+
+
+unsigned SwapChain::GetMaximumFrameLatency() const {
+	UINT maxLatency = 0;
+	if (m_frameLatencyWaitable) {
+		m_native->GetMaximumFrameLatency(&maxLatency);
+	}
+	return maxLatency;
+}
+
+
+bool SwapChain::WaitForFrameLatency(uint64_t timeoutMillis) {
+	if (!m_frameLatencyWaitable) {
+		return true;
+	}
+	DWORD result = WaitForSingleObjectEx(m_frameLatencyWaitable, timeoutMillis >= INFINITE ? INFINITE : DWORD(timeoutMillis), TRUE);
+	return result == WAIT_OBJECT_0;
+}
+
+
 } // namespace gxapi_dx12
 } // namespace inl
\ No newline at end of file
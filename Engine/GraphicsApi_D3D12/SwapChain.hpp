@@ -14,6 +14,9 @@ namespace gxapi_dx12 {
 class SwapChain : public gxapi::ISwapChain {
 public:
 	SwapChain(Microsoft::WRL::ComPtr<IDXGISwapChain3> native);
+	SwapChain(const SwapChain&) = delete;
+	SwapChain& operator=(const SwapChain&) = delete;
+	~SwapChain();
 
 	gxapi::IResource* GetBuffer(unsigned index) override;
 	gxapi::SwapChainDesc GetDesc() const override;
@@ -25,8 +28,14 @@ public:
 
 	void Present() override;
 
+	void SetMaximumFrameLatency(unsigned maxLatency) override;
+	unsigned GetMaximumFrameLatency() const override;
+	bool WaitForFrameLatency(uint64_t timeoutMillis = FOREVER) override;
+
 private:
 	Microsoft::WRL::ComPtr<IDXGISwapChain3> m_native;
+	UINT m_flags; // Resizing must keep the flags of creation.
+	HANDLE m_frameLatencyWaitable = nullptr; // Null unless created with the waitable flag.
 };
 
 } //namespace gxapi_dx12
@@ -75,6 +75,20 @@ enum class eShaderType {
 };
 
 
+// Up to 5.1 shaders compile to DXBC, from 6.0 to DXIL, which brings wave intrinsics (6.0),
+// native 16 bit types (6.2) and indexing ResourceDescriptorHeap directly (6.6).
+enum class eShaderModel {
+	SM_5_1,
+	SM_6_0,
+	SM_6_1,
+	SM_6_2,
+	SM_6_3,
+	SM_6_4,
+	SM_6_5,
+	SM_6_6,
+};
+
+
 enum class eFormat {
 	UNKNOWN = 0,
 
@@ -161,21 +175,21 @@ enum class eFormat {
 	//R8G8_B8G8_UNORM = 68,
 	//G8R8_G8B8_UNORM = 69,
 
-	//BC1_TYPELESS = 70,
-	//BC1_UNORM = 71,
-	//BC1_UNORM_SRGB = 72,
-	//BC2_TYPELESS = 73,
-	//BC2_UNORM = 74,
-	//BC2_UNORM_SRGB = 75,
-	//BC3_TYPELESS = 76,
-	//BC3_UNORM = 77,
-	//BC3_UNORM_SRGB = 78,
-	//BC4_TYPELESS = 79,
-	//BC4_UNORM = 80,
-	//BC4_SNORM = 81,
-	//BC5_TYPELESS = 82,
-	//BC5_UNORM = 83,
-	//BC5_SNORM = 84,
+	BC1_TYPELESS = 70,
+	BC1_UNORM = 71,
+	BC1_UNORM_SRGB = 72,
+	BC2_TYPELESS = 73,
+	BC2_UNORM = 74,
+	BC2_UNORM_SRGB = 75,
+	BC3_TYPELESS = 76,
+	BC3_UNORM = 77,
+	BC3_UNORM_SRGB = 78,
+	BC4_TYPELESS = 79,
+	BC4_UNORM = 80,
+	BC4_SNORM = 81,
+	BC5_TYPELESS = 82,
+	BC5_UNORM = 83,
+	BC5_SNORM = 84,
 
 	//B5G6R5_UNORM = 85,
 	//B5G5R5A1_UNORM = 86,
@@ -186,12 +200,12 @@ enum class eFormat {
 	//B8G8R8A8_UNORM_SRGB = 91,
 	//B8G8R8X8_TYPELESS = 92,
 	//B8G8R8X8_UNORM_SRGB = 93,
-	//BC6H_TYPELESS = 94,
-	//BC6H_UF16 = 95,
-	//BC6H_SF16 = 96,
-	//BC7_TYPELESS = 97,
-	//BC7_UNORM = 98,
-	//BC7_UNORM_SRGB = 99,
+	BC6H_TYPELESS = 94,
+	BC6H_UF16 = 95,
+	BC6H_SF16 = 96,
+	BC7_TYPELESS = 97,
+	BC7_UNORM = 98,
+	BC7_UNORM_SRGB = 99,
 	//AYUV = 100,
 	//Y410 = 101,
 	//Y416 = 102,
@@ -229,6 +243,25 @@ enum class ePrimitiveTopologyType {
 	PATCH = 4
 };
 
+// Values are (log2 width << 2) | log2 height of the pixel block shaded at once.
+enum class eShadingRate {
+	RATE_1X1 = 0x0,
+	RATE_1X2 = 0x1,
+	RATE_2X1 = 0x4,
+	RATE_2X2 = 0x5,
+	RATE_2X4 = 0x6,
+	RATE_4X2 = 0x9,
+	RATE_4X4 = 0xA,
+};
+
+enum class eShadingRateCombiner {
+	PASSTHROUGH = 0,
+	OVERRIDE = 1,
+	MIN = 2,
+	MAX = 3,
+	SUM = 4,
+};
+
 enum class eTriangleStripCutIndex {
 	DISABLED = 0,
 	FFFFh = 1,
@@ -508,6 +541,18 @@ enum class eResourceBarrierType {
 	UAV,
 };
 
+enum class eIndirectArgumentType {
+	DRAW,
+	DRAW_INDEXED,
+	DISPATCH,
+	VERTEX_BUFFER_VIEW,
+	INDEX_BUFFER_VIEW,
+	CONSTANT,
+	CONSTANT_BUFFER_VIEW,
+	SHADER_RESOURCE_VIEW,
+	UNORDERED_ACCESS_VIEW,
+};
+
 //------------------------------------------------------------------------------
 // Bitflag enumerations
 //------------------------------------------------------------------------------
@@ -527,6 +572,7 @@ struct eShaderCompileFlags_Base {
 		OPTIMIZATION_LOW = (1 << 6),
 		OPTIMIZATION_MEDIUM = (1 << 7),
 		OPTIMIZATION_HIGH = (1 << 8),
+		NATIVE_16BIT_TYPES = (1 << 9), // half and min16 types are 16 bits wide, shader model 6.2 and up only.
 	};
 };
 
@@ -564,6 +610,7 @@ struct eResourceState_Base {
 		COPY_SOURCE = 0x800,
 		RESOLVE_DEST = 0x1000,
 		RESOLVE_SOURCE = 0x2000,
+		SHADING_RATE_SOURCE = 0x1000000,
 		GENERIC_READ = (((((0x1 | 0x2) | 0x40) | 0x80) | 0x200) | 0x800),
 		PRESENT = 0,
 		PREDICATION = 0x200
@@ -636,11 +683,14 @@ struct SwapChainDesc {
 	unsigned numBuffers;
 	NativeWindowHandle targetWindow;
 	bool isFullScreen;
+	bool frameLatencyWaitable = false; // Enables ISwapChain::SetMaximumFrameLatency and WaitForFrameLatency.
 };
 
 
 struct ShaderProgramBinary {
 	std::vector<uint8_t> data;
+	std::vector<uint8_t> debugInfo; // Separate debug info of the binary, such as a PDB, if the compiler made one.
+	std::string debugName; // File name that debuggers look for the debug info under.
 };
 
 
@@ -717,6 +767,7 @@ struct BufferDesc {
 	BufferDesc() = default;
 
 	uint64_t sizeInBytes;
+	eResourceFlags flags = eResourceFlags::NONE;
 };
 
 struct TextureDesc {
@@ -749,7 +800,7 @@ struct ResourceDesc {
 	BufferDesc bufferDesc;
 	//};
 
-	static inline ResourceDesc Buffer(uint64_t sizeInBytes);
+	static inline ResourceDesc Buffer(uint64_t sizeInBytes, eResourceFlags flags = eResourceFlags::NONE);
 	static inline ResourceDesc Texture1D(uint64_t width, eFormat format, eResourceFlags flags = eResourceFlags::NONE,
 		uint16_t mipLevels = 1, uint32_t multisampleCount = 1, uint32_t multisampleQuality = 0,
 		uint64_t alignment = 0, eTextureLayout layout = eTextureLayout::UNKNOWN);
@@ -1158,6 +1209,7 @@ struct DescriptorRange {
 	unsigned offsetFromTableStart;
 
 	static constexpr auto OFFSET_APPEND = std::numeric_limits<unsigned>::max();
+	static constexpr auto UNBOUNDED = std::numeric_limits<unsigned>::max(); // For numDescriptors, range extends to the end of the heap.
 };
 
 struct RootDescriptorTable {
@@ -1352,6 +1404,164 @@ struct RootSignatureDesc {
 };
 
 
+// indirect execution
+
+struct IndirectArgumentDesc {
+	static inline IndirectArgumentDesc Draw();
+	static inline IndirectArgumentDesc DrawIndexed();
+	static inline IndirectArgumentDesc Dispatch();
+	static inline IndirectArgumentDesc VertexBufferView(unsigned slot);
+	static inline IndirectArgumentDesc IndexBufferView();
+	static inline IndirectArgumentDesc Constant(unsigned rootParameterIndex, unsigned destOffset, unsigned numConstants);
+	static inline IndirectArgumentDesc ConstantBufferView(unsigned rootParameterIndex);
+	static inline IndirectArgumentDesc ShaderResourceView(unsigned rootParameterIndex);
+	static inline IndirectArgumentDesc UnorderedAccessView(unsigned rootParameterIndex);
+
+	eIndirectArgumentType type = eIndirectArgumentType::DRAW;
+	unsigned slot = 0; // VERTEX_BUFFER_VIEW
+	unsigned rootParameterIndex = 0; // CONSTANT and views
+	unsigned destOffset = 0; // CONSTANT, in 32 bit values
+	unsigned numConstants = 0; // CONSTANT
+};
+
+/// <summary> Layout of one command in the argument buffer of an indirect execution. </summary>
+/// <remarks> Only the last argument may be a draw or dispatch, and a command signature
+///		that changes root arguments must be created for a root signature. </remarks>
+struct CommandSignatureDesc {
+	unsigned byteStride;
+	std::vector<IndirectArgumentDesc> arguments;
+};
+
+enum class eQueryHeapType {
+	TIMESTAMP,
+	PIPELINE_STATISTICS,
+};
+
+enum class eQueryType {
+	TIMESTAMP,
+	PIPELINE_STATISTICS,
+};
+
+struct QueryHeapDesc {
+	eQueryHeapType type;
+	unsigned count;
+};
+
+/// <summary> Result of a PIPELINE_STATISTICS query, as resolved into a buffer. </summary>
+struct PipelineStatistics {
+	uint64_t inputVertices;
+	uint64_t inputPrimitives;
+	uint64_t vertexShaderInvocations;
+	uint64_t geometryShaderInvocations;
+	uint64_t geometryShaderPrimitives;
+	uint64_t clipperInvocations; // Primitives sent to the rasterizer.
+	uint64_t clipperPrimitives; // Primitives left after clipping.
+	uint64_t pixelShaderInvocations;
+	uint64_t hullShaderInvocations;
+	uint64_t domainShaderInvocations;
+	uint64_t computeShaderInvocations;
+};
+
+
+enum class eMemorySegmentGroup {
+	LOCAL, // Video memory of discrete adapters, all memory of integrated ones.
+	NON_LOCAL, // System memory the GPU reaches over the bus.
+};
+
+/// <summary> What the OS lets the process use of a memory segment group, in bytes. </summary>
+/// <remarks> The budget changes with the other processes' demand. All zero if the query is not supported. </remarks>
+struct VideoMemoryInfo {
+	uint64_t budget;
+	uint64_t currentUsage;
+	uint64_t availableForReservation;
+	uint64_t currentReservation;
+};
+
+/// <summary> Bytes a resource takes in a heap, and the alignment of its offset. </summary>
+struct ResourceAllocationInfo {
+	uint64_t size;
+	uint64_t alignment;
+};
+
+struct HeapDesc {
+	uint64_t size;
+	HeapProperties properties;
+	eHeapFlags flags;
+};
+
+
+// Tile mappings of reserved resources, see ICommandQueue::UpdateTileMappings.
+
+/// <summary> Size of a tile of reserved resources, in bytes of heap memory. </summary>
+static constexpr uint64_t TILE_SIZE_IN_BYTES = 65536;
+
+enum class eTileRangeFlags {
+	NONE,
+	NULL_RANGE, // Unmaps the tiles, the heap offset is ignored.
+	SKIP, // Leaves the mapping of the tiles unchanged.
+	REUSE_SINGLE_TILE, // Maps all the tiles of the range to the same heap tile.
+};
+
+/// <summary> The first tile of a region, in tiles, not texels. </summary>
+struct TiledResourceCoordinate {
+	unsigned x = 0;
+	unsigned y = 0;
+	unsigned z = 0;
+	unsigned subresource = 0;
+};
+
+/// <summary> Number of tiles of a region, either as a box or as a run of tiles in memory order. </summary>
+struct TileRegionSize {
+	unsigned numTiles = 1; // Must equal width*height*depth if useBox is set.
+	bool useBox = false;
+	unsigned width = 1;
+	unsigned short height = 1;
+	unsigned short depth = 1;
+};
+
+/// <summary> A run of tiles in the heap that the next tiles of the regions are mapped to. </summary>
+struct TileRange {
+	eTileRangeFlags flags = eTileRangeFlags::NONE;
+	unsigned heapTileOffset = 0; // In tiles from the start of the heap.
+	unsigned numTiles = 1;
+};
+
+// Argument buffer layouts, matching what the GPU reads for each argument type.
+
+struct DrawArguments {
+	uint32_t numVertices;
+	uint32_t numInstances;
+	uint32_t startVertex;
+	uint32_t startInstance;
+};
+
+struct DrawIndexedArguments {
+	uint32_t numIndices;
+	uint32_t numInstances;
+	uint32_t startIndex;
+	int32_t vertexOffset;
+	uint32_t startInstance;
+};
+
+struct DispatchArguments {
+	uint32_t dimx;
+	uint32_t dimy;
+	uint32_t dimz;
+};
+
+struct VertexBufferViewArguments {
+	uint64_t gpuVirtualAddress;
+	uint32_t sizeInBytes;
+	uint32_t strideInBytes;
+};
+
+struct IndexBufferViewArguments {
+	uint64_t gpuVirtualAddress;
+	uint32_t sizeInBytes;
+	uint32_t format; // An eFormat value, R16_UINT or R32_UINT.
+};
+
+
 
 // buffer views
 
@@ -1612,11 +1822,21 @@ struct UavBarrier : public ResourceBarrierTag {
 	IResource* resource;
 };
 
+/// <summary> Switches the memory of a heap between the placed or reserved resources that overlap in it. </summary>
+/// <remarks> Null means any resource that overlaps with the other one. </remarks>
+struct AliasingBarrier : public ResourceBarrierTag {
+	AliasingBarrier(IResource* resourceBefore = nullptr, IResource* resourceAfter = nullptr)
+		: resourceBefore(resourceBefore), resourceAfter(resourceAfter) {}
+	IResource* resourceBefore;
+	IResource* resourceAfter;
+};
+
 struct ResourceBarrier {
 	eResourceBarrierType type;
 	union {
 		TransitionBarrier transition;
 		UavBarrier uav;
+		AliasingBarrier aliasing;
 	};
 	ResourceBarrier() {}
 	ResourceBarrier(const ResourceBarrier& rhs) {
@@ -1630,6 +1850,10 @@ struct ResourceBarrier {
 		type = eResourceBarrierType::UAV;
 		uav = rhs;
 	}
+	ResourceBarrier(const AliasingBarrier& rhs) {
+		type = eResourceBarrierType::ALIASING;
+		aliasing = rhs;
+	}
 
 	ResourceBarrier& operator=(const ResourceBarrier& rhs) {
 		memcpy(this, &rhs, sizeof(*this));
@@ -1646,6 +1870,11 @@ struct ResourceBarrier {
 		uav = rhs;
 		return *this;
 	}
+	ResourceBarrier& operator=(const AliasingBarrier& rhs) {
+		type = eResourceBarrierType::ALIASING;
+		aliasing = rhs;
+		return *this;
+	}
 };
 
 
@@ -1653,10 +1882,11 @@ struct ResourceBarrier {
 // User helper functions
 //------------------------------------------------------------------------------
 
-inline ResourceDesc ResourceDesc::Buffer(uint64_t sizeInBytes) {
+inline ResourceDesc ResourceDesc::Buffer(uint64_t sizeInBytes, eResourceFlags flags) {
 	ResourceDesc desc;
 	desc.type = eResourceType::BUFFER;
 	desc.bufferDesc.sizeInBytes = sizeInBytes;
+	desc.bufferDesc.flags = flags;
 	return desc;
 }
 
@@ -1899,6 +2129,60 @@ inline RootParameterDesc RootParameterDesc::DescriptorTable(eShaderVisiblity sha
 }
 
 
+
+inline IndirectArgumentDesc IndirectArgumentDesc::Draw() {
+	IndirectArgumentDesc desc;
+	desc.type = eIndirectArgumentType::DRAW;
+	return desc;
+}
+inline IndirectArgumentDesc IndirectArgumentDesc::DrawIndexed() {
+	IndirectArgumentDesc desc;
+	desc.type = eIndirectArgumentType::DRAW_INDEXED;
+	return desc;
+}
+inline IndirectArgumentDesc IndirectArgumentDesc::Dispatch() {
+	IndirectArgumentDesc desc;
+	desc.type = eIndirectArgumentType::DISPATCH;
+	return desc;
+}
+inline IndirectArgumentDesc IndirectArgumentDesc::VertexBufferView(unsigned slot) {
+	IndirectArgumentDesc desc;
+	desc.type = eIndirectArgumentType::VERTEX_BUFFER_VIEW;
+	desc.slot = slot;
+	return desc;
+}
+inline IndirectArgumentDesc IndirectArgumentDesc::IndexBufferView() {
+	IndirectArgumentDesc desc;
+	desc.type = eIndirectArgumentType::INDEX_BUFFER_VIEW;
+	return desc;
+}
+inline IndirectArgumentDesc IndirectArgumentDesc::Constant(unsigned rootParameterIndex, unsigned destOffset, unsigned numConstants) {
+	IndirectArgumentDesc desc;
+	desc.type = eIndirectArgumentType::CONSTANT;
+	desc.rootParameterIndex = rootParameterIndex;
+	desc.destOffset = destOffset;
+	desc.numConstants = numConstants;
+	return desc;
+}
+inline IndirectArgumentDesc IndirectArgumentDesc::ConstantBufferView(unsigned rootParameterIndex) {
+	IndirectArgumentDesc desc;
+	desc.type = eIndirectArgumentType::CONSTANT_BUFFER_VIEW;
+	desc.rootParameterIndex = rootParameterIndex;
+	return desc;
+}
+inline IndirectArgumentDesc IndirectArgumentDesc::ShaderResourceView(unsigned rootParameterIndex) {
+	IndirectArgumentDesc desc;
+	desc.type = eIndirectArgumentType::SHADER_RESOURCE_VIEW;
+	desc.rootParameterIndex = rootParameterIndex;
+	return desc;
+}
+inline IndirectArgumentDesc IndirectArgumentDesc::UnorderedAccessView(unsigned rootParameterIndex) {
+	IndirectArgumentDesc desc;
+	desc.type = eIndirectArgumentType::UNORDERED_ACCESS_VIEW;
+	desc.rootParameterIndex = rootParameterIndex;
+	return desc;
+}
+
 template <>
 inline const RootConstant& RootParameterDesc::As<RootParameterDesc::eType::CONSTANT>() const {
 	if (m_type != eType::CONSTANT) throw InvalidCastException("Object has different type than requested.");
@@ -2051,6 +2335,44 @@ inline unsigned GetFormatSizeInBytes(eFormat format) {
 }
 
 
+/// <summary> True for the BC formats, which store the pixels in 4x4 blocks. </summary>
+inline bool IsBlockCompressed(eFormat format) {
+	return (eFormat::BC1_TYPELESS <= format && format <= eFormat::BC5_SNORM)
+		|| (eFormat::BC6H_TYPELESS <= format && format <= eFormat::BC7_UNORM_SRGB);
+}
+
+
+/// <summary> Size of one 4x4 block of a block compressed format. Zero for other formats. </summary>
+inline unsigned GetFormatBlockSizeInBytes(eFormat format) {
+	switch (format) {
+		case eFormat::BC1_TYPELESS:
+		case eFormat::BC1_UNORM:
+		case eFormat::BC1_UNORM_SRGB:
+		case eFormat::BC4_TYPELESS:
+		case eFormat::BC4_UNORM:
+		case eFormat::BC4_SNORM:
+			return 8;
+		default:
+			return IsBlockCompressed(format) ? 16 : 0;
+	}
+}
+
+
+/// <summary> Bytes in one row of pixels, or in one row of blocks for block compressed formats. </summary>
+inline uint64_t GetFormatRowSizeInBytes(eFormat format, uint64_t width) {
+	if (IsBlockCompressed(format)) {
+		return (width + 3) / 4 * GetFormatBlockSizeInBytes(format);
+	}
+	return width * GetFormatSizeInBytes(format);
+}
+
+
+/// <summary> Number of rows <paramref name="height"/> pixels take, for block compressed formats a row is 4 pixels high. </summary>
+inline uint32_t GetFormatRowCount(eFormat format, uint32_t height) {
+	return IsBlockCompressed(format) ? (height + 3) / 4 : height;
+}
+
+
 } // namespace gxapi
 } // namespace inl
 
@@ -151,12 +151,44 @@ struct CapsResourceHeaps {
 };
 
 
+struct CapsVariableRateShading {
+	bool perDrawRate = false; // One shading rate for each draw.
+	bool shadingRateImage = false; // Rates also from a screen space image, combined with that of the draw.
+	bool additionalRates = false; // The 2x4, 4x2 and 4x4 rates, without them those act as 2x2.
+	unsigned imageTileSize = 0; // Pixels covered by one texel of the shading rate image in both directions.
+
+	static CapsVariableRateShading Dx12Tier1() { return { true, false, false, 0 }; }
+	static CapsVariableRateShading Dx12Tier2() { return { true, true, false, 8 }; }
+
+	bool operator>=(const CapsVariableRateShading& rhs) const {
+		return perDrawRate >= rhs.perDrawRate
+			&& shadingRateImage >= rhs.shadingRateImage
+			&& additionalRates >= rhs.additionalRates
+			&& imageTileSize >= rhs.imageTileSize;
+	}
+	bool operator<=(const CapsVariableRateShading& rhs) const {
+		return rhs >= *this;
+	}
+
+	int GetDx12Tier() const {
+		if (shadingRateImage)
+			return 2;
+		else if (perDrawRate)
+			return 1;
+		else
+			return 0;
+	}
+};
+
+
 struct CapsAdditional {
 	bool rovsSupported = false;
 	unsigned shaderModelMajor = 5;
 	unsigned shaderModelMinor = 1;
 	unsigned virtualAddressBitsPerResource = 32;
 	unsigned virtualAddressBitsPerProcess = 32;
+	bool crossAdapterRowMajorTextures = false; // Row major textures can be placed in heaps shared with other adapters, not only buffers.
+	unsigned crossNodeSharingTier = 0; // 0 - linked adapter nodes can't share resources, 1-3 - the D3D12 tiers.
 
 	bool operator>=(const CapsAdditional& rhs) const {
 		int shm = shaderModelMajor*100 + shaderModelMinor;
@@ -164,7 +196,9 @@ struct CapsAdditional {
 		return rovsSupported >= rhs.rovsSupported
 			&& shm >= shmrhs
 			&& virtualAddressBitsPerResource >= rhs.virtualAddressBitsPerResource
-			&& virtualAddressBitsPerProcess >= rhs.virtualAddressBitsPerProcess;
+			&& virtualAddressBitsPerProcess >= rhs.virtualAddressBitsPerProcess
+			&& crossAdapterRowMajorTextures >= rhs.crossAdapterRowMajorTextures
+			&& crossNodeSharingTier >= rhs.crossNodeSharingTier;
 	}
 	bool operator<=(const CapsAdditional& rhs) const {
 		return rhs >= *this;
@@ -240,6 +274,7 @@ struct CapsRequirementSet {
 	CapsTiledResources tiledResources;
 	CapsConservativeRasterization conservativeRasterization;
 	CapsResourceHeaps resourceHeaps;
+	CapsVariableRateShading variableRateShading;
 	CapsAdditional additional;
 	CapsLimits limits;
 	std::vector<std::pair<eFormat, eCapsFormatUsage>> formats;
@@ -260,6 +295,7 @@ public:
 	virtual CapsTiledResources QueryTiledResources() const = 0;
 	virtual CapsConservativeRasterization QueryConservativeRasterization() const = 0;
 	virtual CapsResourceHeaps QueryResourceHeaps() const = 0;
+	virtual CapsVariableRateShading QueryVariableRateShading() const = 0;
 	virtual CapsAdditional QueryAdditional() const = 0;
 	virtual CapsLimits QueryLimits() const = 0;
 	virtual eCapsFormatUsage QueryFormat(eFormat format) const = 0;
@@ -8,6 +8,8 @@ namespace inl {
 namespace gxapi {
 
 class IDescriptorHeap;
+class ICommandSignature;
+class IQueryHeap;
 
 class ICommandList {
 public:
@@ -89,6 +91,17 @@ public:
 	// draw
 	virtual void Dispatch(size_t dimx, size_t dimy = 1, size_t dimz = 1) = 0;
 
+	/// <summary> Executes commands whose arguments are read from a GPU buffer. </summary>
+	/// <param name="maxCommandCount"> Number of commands, or the upper limit if <paramref name="countBuffer"/> is given. </param>
+	/// <param name="argumentBuffer"> Commands laid out as described by the signature. Must be in INDIRECT_ARGUMENT state. </param>
+	/// <param name="countBuffer"> Optional, a 32 bit command count is read from it at <paramref name="countOffset"/>. </param>
+	virtual void ExecuteIndirect(ICommandSignature* commandSignature,
+								 unsigned maxCommandCount,
+								 IResource* argumentBuffer,
+								 size_t argumentOffset,
+								 IResource* countBuffer = nullptr,
+								 size_t countOffset = 0) = 0;
+
 	// set compute root signature stuff
 	virtual void SetComputeRootConstant(unsigned parameterIndex, unsigned destOffset, uint32_t value) = 0;
 	virtual void SetComputeRootConstants(unsigned parameterIndex, unsigned destOffset, unsigned numValues, const uint32_t* value) = 0;
@@ -105,6 +118,15 @@ public:
 
 	// descriptor heaps
 	virtual void SetDescriptorHeaps(IDescriptorHeap*const * heaps, uint32_t count) = 0;
+
+	// queries
+	/// <summary> Starts counting for queries that measure a range of commands, not used for timestamps. </summary>
+	virtual void BeginQuery(IQueryHeap* queryHeap, eQueryType type, unsigned index) = 0;
+	/// <summary> Writes the query result to the heap, for timestamps when the GPU gets here. </summary>
+	virtual void EndQuery(IQueryHeap* queryHeap, eQueryType type, unsigned index) = 0;
+	/// <summary> Copies results of queries [first, first+count) to the buffer, which must be in COPY_DEST state. </summary>
+	/// <remarks> Timestamps are 64 bit values, pipeline statistics are <see cref="PipelineStatistics"/> structures. </remarks>
+	virtual void ResolveQueryData(IQueryHeap* queryHeap, eQueryType type, unsigned first, unsigned count, IResource* destination, size_t destinationOffset) = 0;
 };
 
 
@@ -167,6 +189,14 @@ public:
 	virtual void SetViewports(unsigned numViewports, Viewport* viewports) = 0;
 
 
+	// variable rate shading
+	/// <summary> Sets the rate of the following draws and how it's combined with the per-primitive and the screen space rates. </summary>
+	/// <param name="combiners"> Two combiners, the first for the per-primitive rate, the second for the image. Null means passthrough. </param>
+	virtual void SetShadingRate(eShadingRate baseRate, const eShadingRateCombiner* combiners = nullptr) = 0;
+	/// <summary> Sets the screen space rate image, one R8_UINT texel per tile. Null unbinds it. </summary>
+	virtual void SetShadingRateImage(IResource* image) = 0;
+
+
 	// set graphics root signature stuff
 	virtual void SetGraphicsRootConstant(unsigned parameterIndex, unsigned destOffset, uint32_t value) = 0;
 	virtual void SetGraphicsRootConstants(unsigned parameterIndex, unsigned destOffset, unsigned numValues, const uint32_t* value) = 0;
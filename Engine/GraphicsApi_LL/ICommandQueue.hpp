@@ -11,6 +11,8 @@ namespace gxapi {
 
 class ICommandList;
 class IFence;
+class IResource;
+class IHeap;
 
 
 // note: done
@@ -23,7 +25,21 @@ public:
 	virtual void Signal(IFence* fence, uint64_t value) = 0;
 	virtual void Wait(IFence* fence, uint64_t value) = 0;
 
+	/// <summary> Maps tiles of a reserved resource to tiles of the heap, in queue order. </summary>
+	/// <param name="regions"> Regions of the resource, their tiles are mapped to the ranges one after the other. </param>
+	/// <param name="ranges"> Tile runs in the heap, must cover as many tiles as the regions, except the skipped ones. </param>
+	/// <param name="heap"> May be null if all ranges are NULL_RANGE or SKIP. </param>
+	virtual void UpdateTileMappings(IResource* resource,
+									uint32_t numRegions,
+									const TiledResourceCoordinate* regionCoordinates,
+									const TileRegionSize* regionSizes,
+									IHeap* heap,
+									uint32_t numRanges,
+									const TileRange* ranges) = 0;
+
 	virtual CommandQueueDesc GetDesc() const = 0;
+	/// <summary> Ticks per second of timestamp queries executed on this queue. </summary>
+	virtual uint64_t GetTimestampFrequency() const = 0;
 
 	virtual void BeginDebuggerEvent(const std::string& name) const = 0;
 	virtual void EndDebuggerEvent() const = 0;
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace inl {
+namespace gxapi {
+
+
+class ICommandSignature {
+public:
+	virtual ~ICommandSignature() = default;
+
+};
+
+
+}
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <limits>
 
 namespace inl {
@@ -16,6 +17,11 @@ public:
 	virtual void WaitAny(const IFence** fences, uint64_t* values, size_t count, uint64_t timeoutMillis = FOREVER) const = 0;
 	virtual void WaitAll(const IFence** fences, uint64_t* values, size_t count, uint64_t timeoutMillis = FOREVER) const = 0;
 
+	/// <summary> Calls the callback once the fence has reached the value, without blocking. </summary>
+	/// <remarks> The callback runs on a thread of the API, or right away on the calling thread
+	///		if the value has already been reached. It must be short and must not throw. </remarks>
+	virtual void OnCompletion(uint64_t value, std::function<void()> callback) const = 0;
+
 	static constexpr uint64_t FOREVER = std::numeric_limits<uint64_t>::max();
 };
 
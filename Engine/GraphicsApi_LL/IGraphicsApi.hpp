@@ -14,10 +14,13 @@ class ICommandAllocator;
 class IFence;
 
 class IResource;
+class IHeap;
 
 class IRootSignature;
 class IPipelineState;
+class ICommandSignature;
 class IDescriptorHeap;
+class IQueryHeap;
 
 class ICapabilityQuery;
 
@@ -41,12 +44,39 @@ public:
 											   ResourceDesc desc,
 											   eResourceState initialState,
 											   ClearValue* clearValue = nullptr) = 0;
+	/// <summary> Creates a heap to place resources in with <see cref="CreatePlacedResource"/>. </summary>
+	virtual IHeap* CreateHeap(const HeapDesc& desc) = 0;
+	/// <summary> Creates a resource in the memory of the heap. </summary>
+	/// <param name="offset"> Must be aligned as <see cref="GetAllocationInfo"/> tells. </param>
+	/// <remarks> Placed resources are made resident and evicted with their heap, not on their own. </remarks>
+	virtual IResource* CreatePlacedResource(IHeap* heap,
+											uint64_t offset,
+											ResourceDesc desc,
+											eResourceState initialState,
+											ClearValue* clearValue = nullptr) = 0;
+	/// <summary> Creates a resource without memory, its tiles are mapped to heaps
+	///		by <see cref="ICommandQueue::UpdateTileMappings"/>. </summary>
+	/// <remarks> Textures must have the 64KB_UNDEFINED_SWIZZLE layout. Unmapped tiles read zero. </remarks>
+	virtual IResource* CreateReservedResource(ResourceDesc desc,
+											  eResourceState initialState,
+											  ClearValue* clearValue = nullptr) = 0;
 
 	// Pipeline and binding
 	virtual IRootSignature* CreateRootSignature(RootSignatureDesc desc) = 0;
 	virtual IPipelineState* CreateGraphicsPipelineState(const GraphicsPipelineStateDesc& desc) = 0;
 	virtual IPipelineState* CreateComputePipelineState(const ComputePipelineStateDesc& desc) = 0;
+	/// <summary> Loads pipeline states compiled in earlier runs from the file, creating pipeline states
+	///		checks this cache first and adds newly compiled ones to it. </summary>
+	/// <remarks> A missing or outdated file starts an empty cache. </remarks>
+	virtual void OpenPipelineCache(const std::string& path) = 0;
+	/// <summary> Writes the cache back to the file given to <see cref="OpenPipelineCache"/>, if anything was added. </summary>
+	virtual void SavePipelineCache() = 0;
 	virtual IDescriptorHeap* CreateDescriptorHeap(DescriptorHeapDesc) = 0;
+	/// <summary> Creates the command layout for <see cref="IComputeCommandList::ExecuteIndirect"/>. </summary>
+	/// <param name="rootSignature"> Required if the commands change root arguments, must be null otherwise. </param>
+	virtual ICommandSignature* CreateCommandSignature(const CommandSignatureDesc& desc, IRootSignature* rootSignature = nullptr) = 0;
+	/// <summary> Creates a heap for GPU queries, see <see cref="IComputeCommandList::EndQuery"/>. </summary>
+	virtual IQueryHeap* CreateQueryHeap(const QueryHeapDesc& desc) = 0;
 
 	// Views
 	virtual void CreateConstantBufferView(ConstantBufferViewDesc desc,
@@ -107,9 +137,29 @@ public:
 	// Misc
 	virtual IFence* CreateFence(uint64_t initialValue) = 0;
 
+	// Multi-adapter
+	/// <summary> Creates a fence that the graphics APIs of other adapters can open with <see cref="OpenSharedFence"/>. </summary>
+	/// <remarks> Queues of both adapters can signal and wait on it, which orders work across the adapters. </remarks>
+	virtual IFence* CreateSharedFence(uint64_t initialValue) = 0;
+	/// <summary> Opens a fence created by <see cref="CreateSharedFence"/> of another adapter's graphics API. </summary>
+	/// <returns> A fence of this adapter that has the same value as the original. </returns>
+	virtual IFence* OpenSharedFence(IFence* fence) = 0;
+	/// <summary> Opens a heap of another adapter's graphics API on this adapter. </summary>
+	/// <remarks> The heap must be created with SHARED and SHARED_CROSS_ADAPTER flags. Resources placed in it at the
+	///		same offset on both adapters alias each other. They must allow cross adapter use, and textures must be row major,
+	///		see <see cref="CapsAdditional::crossAdapterRowMajorTextures"/>. </remarks>
+	virtual IHeap* OpenSharedHeap(IHeap* heap) = 0;
+
 	virtual void MakeResident(const std::vector<gxapi::IResource*>& objects) = 0;
 	virtual void Evict(const std::vector<gxapi::IResource*>& objects) = 0;
 
+	/// <summary> Current budget and usage of the process. Cheap enough to call every frame. </summary>
+	virtual VideoMemoryInfo QueryVideoMemoryInfo(eMemorySegmentGroup group) const = 0;
+	/// <summary> Bytes a committed resource with the description takes in its heap. </summary>
+	virtual uint64_t GetAllocationSize(const ResourceDesc& desc) const = 0;
+	/// <summary> Size and alignment of the resource when placed in a heap. </summary>
+	virtual ResourceAllocationInfo GetAllocationInfo(const ResourceDesc& desc) const = 0;
+
 	// Debug
 	virtual void ReportLiveObjects() const = 0;
 
@@ -43,14 +43,16 @@ public:
 											  gxapi::eShaderType type,
 											  gxapi::eShaderCompileFlags flags,
 											  gxapi::IShaderIncludeProvider* includeProvider = nullptr,
-											  const char* macroDefinitions = nullptr) = 0;
+											  const char* macroDefinitions = nullptr,
+											  gxapi::eShaderModel shaderModel = gxapi::eShaderModel::SM_5_1) = 0;
 
 
 	virtual ShaderProgramBinary CompileShaderFromFile(const std::string& fileName,
 													  const std::string& mainFunctionName,
 													  gxapi::eShaderType type,
 													  eShaderCompileFlags flags,
-													  const std::vector<ShaderMacroDefinition>& macros) = 0;
+													  const std::vector<ShaderMacroDefinition>& macros,
+													  gxapi::eShaderModel shaderModel = gxapi::eShaderModel::SM_5_1) = 0;
 };
 
 
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace inl {
+namespace gxapi {
+
+
+/// <summary> A block of GPU memory that resources can be placed in. </summary>
+class IHeap {
+public:
+	virtual ~IHeap() = default;
+
+	virtual uint64_t GetSize() const = 0;
+};
+
+
+}
+}
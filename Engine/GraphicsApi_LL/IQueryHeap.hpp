@@ -0,0 +1,15 @@
+#pragma once
+
+namespace inl {
+namespace gxapi {
+
+
+class IQueryHeap {
+public:
+	virtual ~IQueryHeap() = default;
+
+};
+
+
+}
+}
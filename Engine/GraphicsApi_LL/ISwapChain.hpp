@@ -2,6 +2,9 @@
 
 #include "Common.hpp"
 
+#include <cstdint>
+#include <limits>
+
 
 namespace inl {
 namespace gxapi {
@@ -22,6 +25,17 @@ public:
 	virtual void Resize(unsigned width, unsigned height, unsigned bufferCount = 0, eFormat format = eFormat::UNKNOWN) = 0;
 
 	virtual void Present() = 0;
+
+	/// <summary> Sets how many presented frames may wait in the queue, a Present waits for the oldest of them
+	///		to be shown. Throws InvalidStateException unless the swap chain is frame latency waitable. </summary>
+	virtual void SetMaximumFrameLatency(unsigned maxLatency) = 0;
+	/// <summary> Frames that may wait for presentation, 0 if the swap chain is not frame latency waitable. </summary>
+	virtual unsigned GetMaximumFrameLatency() const = 0;
+	/// <summary> Blocks until a Present would not have to wait. Call once per frame before sampling input. </summary>
+	/// <returns> False on timeout. Always true if the swap chain is not frame latency waitable. </returns>
+	virtual bool WaitForFrameLatency(uint64_t timeoutMillis = FOREVER) = 0;
+
+	static constexpr uint64_t FOREVER = std::numeric_limits<uint64_t>::max();
 };
 
 
@@ -0,0 +1,89 @@
+#include "CapabilityQuery.hpp"
+
+
+namespace inl::gxapi_null {
+
+using namespace gxapi;
+
+
+CapsResourceBinding CapabilityQuery::QueryResourceBinding() const {
+	return CapsResourceBinding::Dx12Tier3();
+}
+
+
+CapsTiledResources CapabilityQuery::QueryTiledResources() const {
+	return CapsTiledResources::Dx12Tier3();
+}
+
+
+CapsConservativeRasterization CapabilityQuery::QueryConservativeRasterization() const {
+	return CapsConservativeRasterization::Dx12Tier3();
+}
+
+
+CapsResourceHeaps CapabilityQuery::QueryResourceHeaps() const {
+	return CapsResourceHeaps::Dx12Tier2();
+}
+
+
+CapsVariableRateShading CapabilityQuery::QueryVariableRateShading() const {
+	CapsVariableRateShading caps = CapsVariableRateShading::Dx12Tier2();
+	caps.additionalRates = true;
+	return caps;
+}
+
+
+CapsAdditional CapabilityQuery::QueryAdditional() const {
+	CapsAdditional caps;
+	caps.rovsSupported = true;
+	caps.shaderModelMajor = 6;
+	caps.shaderModelMinor = 5;
+	caps.virtualAddressBitsPerResource = 40;
+	caps.virtualAddressBitsPerProcess = 47;
+	caps.crossAdapterRowMajorTextures = true;
+	caps.crossNodeSharingTier = 0;
+	return caps;
+}
+
+
+CapsLimits CapabilityQuery::QueryLimits() const {
+	CapsLimits limits;
+	limits.texture1DSize = { 16384 };
+	limits.texture2DSize = { 16384, 16384 };
+	limits.texture3DSize = { 16384, 16384, 2048 };
+	limits.textureRepeat = 16384;
+	limits.anisotropy = 16;
+	limits.primitiveCount = (1ull << 32) - 1;
+	limits.vertexCount = (1ull << 32) - 1;
+	limits.inputSlots = 32;
+	limits.multipleRenderTargets = 8;
+
+	return limits;
+}
+
+
+eCapsFormatUsage CapabilityQuery::QueryFormat(eFormat format) const {
+	eCapsFormatUsage usage;
+	for (auto flag : { eCapsFormatUsage::BUFFER, eCapsFormatUsage::VERTEX_BUFFER, eCapsFormatUsage::SO_BUFFER,
+					   eCapsFormatUsage::TEXTURE_1D, eCapsFormatUsage::TEXTURE_2D, eCapsFormatUsage::TEXTURE_3D, eCapsFormatUsage::TEXTURE_CUBE,
+					   eCapsFormatUsage::SAMPLE, eCapsFormatUsage::SAMPLE_LINEAR, eCapsFormatUsage::RENDER_TARGET, eCapsFormatUsage::RENDER_TARGET_BLEND,
+					   eCapsFormatUsage::DEPTH_STENCIL, eCapsFormatUsage::UNORDERED_ACCESS_LOAD, eCapsFormatUsage::UNORDERED_ACCESS_STORE,
+					   eCapsFormatUsage::UNORDERED_ACCESS_ATOMIC }) {
+		usage += flag;
+	}
+	return usage;
+}
+
+
+bool CapabilityQuery::SupportsAll(const CapsRequirementSet& requiredFeatures) const {
+	return QueryResourceBinding() >= requiredFeatures.resourceBinding
+		&& QueryTiledResources() >= requiredFeatures.tiledResources
+		&& QueryConservativeRasterization() >= requiredFeatures.conservativeRasterization
+		&& QueryResourceHeaps() >= requiredFeatures.resourceHeaps
+		&& QueryVariableRateShading() >= requiredFeatures.variableRateShading
+		&& QueryAdditional() >= requiredFeatures.additional
+		&& QueryLimits() >= requiredFeatures.limits;
+}
+
+
+} // namespace inl::gxapi_null
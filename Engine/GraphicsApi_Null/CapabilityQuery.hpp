@@ -0,0 +1,26 @@
+#pragma once
+
+#include "../GraphicsApi_LL/HardwareCapability.hpp"
+
+
+namespace inl::gxapi_null {
+
+
+/// <summary> Reports what a recent D3D12 GPU has, so that the engine takes its usual paths. </summary>
+/// <remarks> Every format is reported to support every usage. </remarks>
+class CapabilityQuery : public gxapi::ICapabilityQuery {
+public:
+	gxapi::CapsResourceBinding QueryResourceBinding() const override;
+	gxapi::CapsTiledResources QueryTiledResources() const override;
+	gxapi::CapsConservativeRasterization QueryConservativeRasterization() const override;
+	gxapi::CapsResourceHeaps QueryResourceHeaps() const override;
+	gxapi::CapsVariableRateShading QueryVariableRateShading() const override;
+	gxapi::CapsAdditional QueryAdditional() const override;
+	gxapi::CapsLimits QueryLimits() const override;
+	gxapi::eCapsFormatUsage QueryFormat(gxapi::eFormat format) const override;
+
+	bool SupportsAll(const gxapi::CapsRequirementSet& requiredFeatures) const override;
+};
+
+
+} // namespace inl::gxapi_null
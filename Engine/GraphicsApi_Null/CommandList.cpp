@@ -0,0 +1,440 @@
+#include "CommandList.hpp"
+
+#include <cstring>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+static uint64_t FloatBits(float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+
+//------------------------------------------------------------------------------
+// Basic command list
+//------------------------------------------------------------------------------
+
+BasicCommandList::BasicCommandList(gxapi::eCommandListType type)
+	: m_type(type), m_stream(std::make_shared<CommandStream>()) {
+}
+
+
+gxapi::eCommandListType BasicCommandList::GetType() const {
+	return m_type;
+}
+
+
+void BasicCommandList::BeginDebuggerEvent(const std::string& name) const {
+	Command& command = Record(eCommand::BEGIN_EVENT);
+	command.values[0] = m_stream->eventNames.size();
+	m_stream->eventNames.push_back(name);
+}
+
+
+void BasicCommandList::EndDebuggerEvent() const {
+	Record(eCommand::END_EVENT);
+}
+
+
+void BasicCommandList::SetName(const char* name) {
+	m_name = name;
+}
+
+
+Command& BasicCommandList::Record(eCommand type) const {
+	m_stream->commands.push_back({ type });
+	return m_stream->commands.back();
+}
+
+
+void BasicCommandList::StartStream() {
+	// A stream nobody else holds can be reused, which keeps its memory.
+	if (m_stream.use_count() == 1) {
+		m_stream->commands.clear();
+		m_stream->eventNames.clear();
+	}
+	else {
+		m_stream = std::make_shared<CommandStream>();
+	}
+}
+
+
+//------------------------------------------------------------------------------
+// Copy command list
+//------------------------------------------------------------------------------
+
+CopyCommandList::CopyCommandList(gxapi::eCommandListType type)
+	: BasicCommandList(type) {
+}
+
+
+void CopyCommandList::Close() {
+	Record(eCommand::CLOSE);
+}
+
+
+void CopyCommandList::Reset(gxapi::ICommandAllocator* allocator, gxapi::IPipelineState* newState) {
+	StartStream();
+	Command& command = Record(eCommand::RESET);
+	command.objects = { allocator, newState };
+}
+
+
+void CopyCommandList::CopyBuffer(gxapi::IResource* dst, size_t dstOffset, gxapi::IResource* src, size_t srcOffset, size_t numBytes) {
+	Command& command = Record(eCommand::COPY_BUFFER);
+	command.objects = { dst, src };
+	command.values = { dstOffset, srcOffset, numBytes };
+}
+
+
+void CopyCommandList::CopyResource(gxapi::IResource* dst, gxapi::IResource* src) {
+	Command& command = Record(eCommand::COPY_RESOURCE);
+	command.objects = { dst, src };
+}
+
+
+void CopyCommandList::CopyTexture(gxapi::IResource* dst,
+								  unsigned dstSubresourceIndex,
+								  int dstX, int dstY, int dstZ,
+								  gxapi::IResource* src,
+								  unsigned srcSubresourceIndex,
+								  gxapi::Cube srcRegion) {
+	Command& command = Record(eCommand::COPY_TEXTURE);
+	command.objects = { dst, src };
+	command.values = { dstSubresourceIndex, srcSubresourceIndex };
+}
+
+
+void CopyCommandList::CopyTexture(gxapi::IResource* dst,
+								  gxapi::TextureCopyDesc dstDesc,
+								  int dstX, int dstY, int dstZ,
+								  gxapi::IResource* src,
+								  gxapi::TextureCopyDesc srcDesc,
+								  gxapi::Cube srcRegion) {
+	Command& command = Record(eCommand::COPY_TEXTURE);
+	command.objects = { dst, src };
+	command.values = { dstDesc.subresourceIndex, srcDesc.subresourceIndex };
+}
+
+
+void CopyCommandList::CopyTexture(gxapi::IResource* dst,
+								  gxapi::TextureCopyDesc dstDesc,
+								  int dstX, int dstY, int dstZ,
+								  gxapi::IResource* src,
+								  gxapi::TextureCopyDesc srcDesc) {
+	Command& command = Record(eCommand::COPY_TEXTURE);
+	command.objects = { dst, src };
+	command.values = { dstDesc.subresourceIndex, srcDesc.subresourceIndex };
+}
+
+
+static uint64_t GetBits(gxapi::eResourceState state) {
+	return uint64_t((gxapi::eResourceState::EnumT)state);
+}
+
+
+void CopyCommandList::ResourceBarrier(unsigned numBarriers, gxapi::ResourceBarrier* barriers) {
+	for (unsigned i = 0; i < numBarriers; ++i) {
+		const gxapi::ResourceBarrier& barrier = barriers[i];
+		Command& command = Record(eCommand::RESOURCE_BARRIER);
+		command.values[0] = uint64_t(barrier.type);
+		switch (barrier.type) {
+			case gxapi::eResourceBarrierType::TRANSITION:
+				command.objects[0] = barrier.transition.resource;
+				command.values[1] = GetBits(barrier.transition.beforeState);
+				command.values[2] = GetBits(barrier.transition.afterState);
+				command.values[3] = barrier.transition.subResource;
+				break;
+			case gxapi::eResourceBarrierType::UAV:
+				command.objects[0] = barrier.uav.resource;
+				break;
+			case gxapi::eResourceBarrierType::ALIASING:
+				command.objects = { barrier.aliasing.resourceBefore, barrier.aliasing.resourceAfter };
+				break;
+		}
+	}
+}
+
+
+//------------------------------------------------------------------------------
+// Compute command list
+//------------------------------------------------------------------------------
+
+ComputeCommandList::ComputeCommandList(gxapi::eCommandListType type)
+	: CopyCommandList(type) {
+}
+
+
+void ComputeCommandList::Dispatch(size_t dimx, size_t dimy, size_t dimz) {
+	Record(eCommand::DISPATCH).values = { dimx, dimy, dimz };
+}
+
+
+void ComputeCommandList::ExecuteIndirect(gxapi::ICommandSignature* commandSignature,
+										 unsigned maxCommandCount,
+										 gxapi::IResource* argumentBuffer,
+										 size_t argumentOffset,
+										 gxapi::IResource* countBuffer,
+										 size_t countOffset) {
+	Command& command = Record(eCommand::EXECUTE_INDIRECT);
+	command.objects = { argumentBuffer, countBuffer };
+	command.values = { maxCommandCount, argumentOffset, countOffset };
+}
+
+
+void ComputeCommandList::SetComputeRootConstant(unsigned parameterIndex, unsigned destOffset, uint32_t value) {
+	SetComputeRootConstants(parameterIndex, destOffset, 1, &value);
+}
+
+
+void ComputeCommandList::SetComputeRootConstants(unsigned parameterIndex, unsigned destOffset, unsigned numValues, const uint32_t* value) {
+	Record(eCommand::SET_ROOT_CONSTANTS).values = { 0, parameterIndex, destOffset, HashRootConstants(value, numValues) };
+}
+
+
+void ComputeCommandList::SetComputeRootConstantBuffer(unsigned parameterIndex, void* gpuVirtualAddress) {
+	Command& command = Record(eCommand::SET_ROOT_CONSTANT_BUFFER);
+	command.objects[0] = gpuVirtualAddress;
+	command.values = { 0, parameterIndex };
+}
+
+
+void ComputeCommandList::SetComputeRootDescriptorTable(unsigned parameterIndex, gxapi::DescriptorHandle baseHandle) {
+	Command& command = Record(eCommand::SET_ROOT_DESCRIPTOR_TABLE);
+	command.objects[0] = baseHandle.cpuAddress;
+	command.values = { 0, parameterIndex };
+}
+
+
+void ComputeCommandList::SetComputeRootShaderResource(unsigned parameterIndex, void* gpuVirtualAddress) {
+	Command& command = Record(eCommand::SET_ROOT_SHADER_RESOURCE);
+	command.objects[0] = gpuVirtualAddress;
+	command.values = { 0, parameterIndex };
+}
+
+
+void ComputeCommandList::SetComputeRootUnorderedResource(unsigned parameterIndex, void* gpuVirtualAddress) {
+	Command& command = Record(eCommand::SET_ROOT_UNORDERED_RESOURCE);
+	command.objects[0] = gpuVirtualAddress;
+	command.values = { 0, parameterIndex };
+}
+
+
+void ComputeCommandList::SetComputeRootSignature(gxapi::IRootSignature* rootSignature) {
+	Record(eCommand::SET_ROOT_SIGNATURE).objects[0] = rootSignature;
+}
+
+
+void ComputeCommandList::SetPipelineState(gxapi::IPipelineState* pipelineState) {
+	Record(eCommand::SET_PIPELINE_STATE).objects[0] = pipelineState;
+}
+
+
+void ComputeCommandList::ResetState(gxapi::IPipelineState* initialPipelineState) {
+	Record(eCommand::SET_PIPELINE_STATE).objects[0] = initialPipelineState;
+}
+
+
+void ComputeCommandList::SetDescriptorHeaps(gxapi::IDescriptorHeap* const* heaps, uint32_t count) {
+	Command& command = Record(eCommand::SET_DESCRIPTOR_HEAPS);
+	command.objects = { count > 0 ? heaps[0] : nullptr, count > 1 ? heaps[1] : nullptr };
+	command.values[0] = count;
+}
+
+
+void ComputeCommandList::BeginQuery(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned index) {
+	Command& command = Record(eCommand::BEGIN_QUERY);
+	command.objects[0] = queryHeap;
+	command.values = { uint64_t(type), index };
+}
+
+
+void ComputeCommandList::EndQuery(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned index) {
+	Command& command = Record(eCommand::END_QUERY);
+	command.objects[0] = queryHeap;
+	command.values = { uint64_t(type), index };
+}
+
+
+void ComputeCommandList::ResolveQueryData(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned first, unsigned count, gxapi::IResource* destination, size_t destinationOffset) {
+	Command& command = Record(eCommand::RESOLVE_QUERY_DATA);
+	command.objects = { queryHeap, destination };
+	command.values = { uint64_t(type), first, count, destinationOffset };
+}
+
+
+//------------------------------------------------------------------------------
+// Graphics command list
+//------------------------------------------------------------------------------
+
+GraphicsCommandList::GraphicsCommandList(gxapi::eCommandListType type)
+	: ComputeCommandList(type) {
+}
+
+
+void GraphicsCommandList::ClearDepthStencil(gxapi::DescriptorHandle dsv,
+											float depth,
+											uint8_t stencil,
+											size_t numRects,
+											gxapi::Rectangle* rects,
+											bool clearDepth,
+											bool clearStencil) {
+	Command& command = Record(eCommand::CLEAR_DEPTH_STENCIL);
+	command.objects[0] = dsv.cpuAddress;
+	command.values = { FloatBits(depth), stencil, clearDepth, clearStencil };
+}
+
+
+void GraphicsCommandList::ClearRenderTarget(gxapi::DescriptorHandle rtv,
+											gxapi::ColorRGBA color,
+											size_t numRects,
+											gxapi::Rectangle* rects) {
+	Command& command = Record(eCommand::CLEAR_RENDER_TARGET);
+	command.objects[0] = rtv.cpuAddress;
+	command.values = { FloatBits(color.r), FloatBits(color.g), FloatBits(color.b), FloatBits(color.a) };
+}
+
+
+void GraphicsCommandList::DrawIndexedInstanced(unsigned numIndices,
+											   unsigned startIndex,
+											   int vertexOffset,
+											   unsigned numInstances,
+											   unsigned startInstance) {
+	Record(eCommand::DRAW_INDEXED_INSTANCED).values = { numIndices, startIndex, uint64_t(int64_t(vertexOffset)), numInstances };
+}
+
+
+void GraphicsCommandList::DrawInstanced(unsigned numVertices,
+										unsigned startVertex,
+										unsigned numInstances,
+										unsigned startInstance) {
+	Record(eCommand::DRAW_INSTANCED).values = { numVertices, startVertex, numInstances, startInstance };
+}
+
+
+void GraphicsCommandList::ExecuteBundle(IGraphicsCommandList* bundle) {
+	Record(eCommand::EXECUTE_BUNDLE).objects[0] = static_cast<const BasicCommandList*>(dynamic_cast<GraphicsCommandList*>(bundle));
+}
+
+
+void GraphicsCommandList::SetIndexBuffer(void* gpuVirtualAddress, size_t sizeInBytes, gxapi::eFormat format) {
+	Command& command = Record(eCommand::SET_INDEX_BUFFER);
+	command.objects[0] = gpuVirtualAddress;
+	command.values = { sizeInBytes, uint64_t(format) };
+}
+
+
+void GraphicsCommandList::SetPrimitiveTopology(gxapi::ePrimitiveTopology topology) {
+	Record(eCommand::SET_PRIMITIVE_TOPOLOGY).values[0] = uint64_t(topology);
+}
+
+
+void GraphicsCommandList::SetVertexBuffers(unsigned startSlot,
+										   unsigned count,
+										   void** gpuVirtualAddress,
+										   unsigned* sizeInBytes,
+										   unsigned* strideInBytes) {
+	for (unsigned i = 0; i < count; ++i) {
+		Command& command = Record(eCommand::SET_VERTEX_BUFFER);
+		command.objects[0] = gpuVirtualAddress[i];
+		command.values = { startSlot + i, sizeInBytes[i], strideInBytes[i] };
+	}
+}
+
+
+void GraphicsCommandList::SetRenderTargets(unsigned numRenderTargets,
+										   gxapi::DescriptorHandle* renderTargets,
+										   gxapi::DescriptorHandle* depthStencil) {
+	Command& command = Record(eCommand::SET_RENDER_TARGETS);
+	command.objects[0] = depthStencil ? depthStencil->cpuAddress : nullptr;
+	command.values[0] = numRenderTargets;
+	for (unsigned i = 0; i < numRenderTargets; ++i) {
+		Command& renderTarget = Record(eCommand::SET_RENDER_TARGET);
+		renderTarget.objects[0] = renderTargets[i].cpuAddress;
+		renderTarget.values[0] = i;
+	}
+}
+
+
+void GraphicsCommandList::SetBlendFactor(float r, float g, float b, float a) {
+	Record(eCommand::SET_BLEND_FACTOR).values = { FloatBits(r), FloatBits(g), FloatBits(b), FloatBits(a) };
+}
+
+
+void GraphicsCommandList::SetStencilRef(unsigned stencilRef) {
+	Record(eCommand::SET_STENCIL_REF).values[0] = stencilRef;
+}
+
+
+void GraphicsCommandList::SetScissorRects(unsigned numRects, gxapi::Rectangle* rects) {
+	for (unsigned i = 0; i < numRects; ++i) {
+		Record(eCommand::SET_SCISSOR_RECT).values = { uint64_t(int64_t(rects[i].top)), uint64_t(int64_t(rects[i].left)),
+													  uint64_t(int64_t(rects[i].bottom)), uint64_t(int64_t(rects[i].right)) };
+	}
+}
+
+
+void GraphicsCommandList::SetViewports(unsigned numViewports, gxapi::Viewport* viewports) {
+	for (unsigned i = 0; i < numViewports; ++i) {
+		Record(eCommand::SET_VIEWPORT).values = { FloatBits(viewports[i].topLeftX), FloatBits(viewports[i].topLeftY),
+												  FloatBits(viewports[i].width), FloatBits(viewports[i].height) };
+	}
+}
+
+
+void GraphicsCommandList::SetShadingRate(gxapi::eShadingRate baseRate, const gxapi::eShadingRateCombiner* combiners) {
+	uint64_t first = combiners ? uint64_t(combiners[0]) : uint64_t(gxapi::eShadingRateCombiner::PASSTHROUGH);
+	uint64_t second = combiners ? uint64_t(combiners[1]) : uint64_t(gxapi::eShadingRateCombiner::PASSTHROUGH);
+	Record(eCommand::SET_SHADING_RATE).values = { uint64_t(baseRate), first, second };
+}
+
+
+void GraphicsCommandList::SetShadingRateImage(gxapi::IResource* image) {
+	Record(eCommand::SET_SHADING_RATE_IMAGE).objects[0] = image;
+}
+
+
+void GraphicsCommandList::SetGraphicsRootConstant(unsigned parameterIndex, unsigned destOffset, uint32_t value) {
+	SetGraphicsRootConstants(parameterIndex, destOffset, 1, &value);
+}
+
+
+void GraphicsCommandList::SetGraphicsRootConstants(unsigned parameterIndex, unsigned destOffset, unsigned numValues, const uint32_t* value) {
+	Record(eCommand::SET_ROOT_CONSTANTS).values = { 1, parameterIndex, destOffset, HashRootConstants(value, numValues) };
+}
+
+
+void GraphicsCommandList::SetGraphicsRootConstantBuffer(unsigned parameterIndex, void* gpuVirtualAddress) {
+	Command& command = Record(eCommand::SET_ROOT_CONSTANT_BUFFER);
+	command.objects[0] = gpuVirtualAddress;
+	command.values = { 1, parameterIndex };
+}
+
+
+void GraphicsCommandList::SetGraphicsRootDescriptorTable(unsigned parameterIndex, gxapi::DescriptorHandle baseHandle) {
+	Command& command = Record(eCommand::SET_ROOT_DESCRIPTOR_TABLE);
+	command.objects[0] = baseHandle.cpuAddress;
+	command.values = { 1, parameterIndex };
+}
+
+
+void GraphicsCommandList::SetGraphicsRootShaderResource(unsigned parameterIndex, void* gpuVirtualAddress) {
+	Command& command = Record(eCommand::SET_ROOT_SHADER_RESOURCE);
+	command.objects[0] = gpuVirtualAddress;
+	command.values = { 1, parameterIndex };
+}
+
+
+void GraphicsCommandList::SetGraphicsRootSignature(gxapi::IRootSignature* rootSignature) {
+	Command& command = Record(eCommand::SET_ROOT_SIGNATURE);
+	command.objects[0] = rootSignature;
+	command.values[0] = 1;
+}
+
+
+} // namespace gxapi_null
+} // namespace inl
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "../GraphicsApi_LL/ICommandList.hpp"
+#include "../GraphicsApi_LL/Common.hpp"
+#include "CommandStream.hpp"
+
+#include <memory>
+#include <string>
+
+#pragma warning(disable: 4250)
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+/// <summary> Command lists that record into a <see cref="CommandStream"/> for the null queue to execute and tests to inspect. </summary>
+/// <remarks> Reset starts a new stream, executed streams are kept by the queue until it's done with them. </remarks>
+class BasicCommandList : virtual public gxapi::ICommandList {
+public:
+	BasicCommandList(gxapi::eCommandListType type);
+
+	virtual ~BasicCommandList() = default;
+
+	gxapi::eCommandListType GetType() const override;
+
+	void BeginDebuggerEvent(const std::string& name) const override;
+	void EndDebuggerEvent() const override;
+
+	void SetName(const char* name) override;
+	const std::string& GetName() const { return m_name; }
+
+	/// <summary> The commands recorded since the last reset. </summary>
+	const CommandStream& GetCommands() const { return *m_stream; }
+	/// <summary> Keeps the commands alive while the queue executes them. </summary>
+	std::shared_ptr<const CommandStream> GetSharedCommands() const { return m_stream; }
+
+protected:
+	Command& Record(eCommand type) const;
+	void StartStream();
+
+protected:
+	gxapi::eCommandListType m_type;
+	std::shared_ptr<CommandStream> m_stream;
+	std::string m_name;
+};
+
+
+
+class CopyCommandList : public BasicCommandList, virtual public gxapi::ICopyCommandList {
+public:
+	// basic
+	CopyCommandList(gxapi::eCommandListType type);
+
+
+	// Command list state
+	void Close() override;
+	void Reset(gxapi::ICommandAllocator* allocator, gxapi::IPipelineState* newState = nullptr) override;
+
+
+	// Resource copy
+	void CopyBuffer(gxapi::IResource* dst,
+					size_t dstOffset,
+					gxapi::IResource* src,
+					size_t srcOffset,
+					size_t numBytes) override;
+
+	void CopyResource(gxapi::IResource* dst, gxapi::IResource* src) override;
+
+	void CopyTexture(gxapi::IResource* dst,
+					 unsigned dstSubresourceIndex,
+					 int dstX, int dstY, int dstZ,
+					 gxapi::IResource* src,
+					 unsigned srcSubresourceIndex,
+					 gxapi::Cube srcRegion) override;
+
+	void CopyTexture(gxapi::IResource* dst,
+					 gxapi::TextureCopyDesc dstDesc,
+					 int dstX, int dstY, int dstZ,
+					 gxapi::IResource* src,
+					 gxapi::TextureCopyDesc srcDesc,
+					 gxapi::Cube srcRegion) override;
+
+	void CopyTexture(gxapi::IResource* dst,
+	                 gxapi::TextureCopyDesc dstDesc,
+	                 int dstX, int dstY, int dstZ,
+	                 gxapi::IResource* src,
+	                 gxapi::TextureCopyDesc srcDesc) override;
+
+	// barriers
+	// TODO: transition, aliasing and bullshit barriers, i would put them into separate functions
+	void ResourceBarrier(unsigned numBarriers, gxapi::ResourceBarrier* barriers) override;
+};
+
+
+
+class ComputeCommandList : public CopyCommandList, virtual public gxapi::IComputeCommandList {	
+public:
+	ComputeCommandList(gxapi::eCommandListType type);
+
+	// draw
+	void Dispatch(size_t dimx, size_t dimy = 1, size_t dimz = 1) override;
+
+	void ExecuteIndirect(gxapi::ICommandSignature* commandSignature,
+						 unsigned maxCommandCount,
+						 gxapi::IResource* argumentBuffer,
+						 size_t argumentOffset,
+						 gxapi::IResource* countBuffer = nullptr,
+						 size_t countOffset = 0) override;
+
+	// set compute root signature stuff
+	void SetComputeRootConstant(unsigned parameterIndex, unsigned destOffset, uint32_t value) override;
+	void SetComputeRootConstants(unsigned parameterIndex, unsigned destOffset, unsigned numValues, const uint32_t* value) override;
+	void SetComputeRootConstantBuffer(unsigned parameterIndex, void* gpuVirtualAddress) override;
+	void SetComputeRootDescriptorTable(unsigned parameterIndex, gxapi::DescriptorHandle baseHandle) override;
+	void SetComputeRootShaderResource(unsigned parameterIndex, void* gpuVirtualAddress) override;
+	void SetComputeRootUnorderedResource(unsigned parameterIndex, void* gpuVirtualAddress) override;
+
+	void SetComputeRootSignature(gxapi::IRootSignature* rootSignature) override;
+
+	// set pipeline state
+	void SetPipelineState(gxapi::IPipelineState* pipelineState) override;
+	void ResetState(gxapi::IPipelineState* initialPipelineState) override;
+
+	// descriptor heaps
+	void SetDescriptorHeaps(gxapi::IDescriptorHeap*const * heaps, uint32_t count) override;
+
+	// queries
+	void BeginQuery(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned index) override;
+	void EndQuery(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned index) override;
+	void ResolveQueryData(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned first, unsigned count, gxapi::IResource* destination, size_t destinationOffset) override;
+};
+
+
+
+class GraphicsCommandList : public ComputeCommandList, virtual public gxapi::IGraphicsCommandList {
+public:
+	GraphicsCommandList(gxapi::eCommandListType type);
+
+	// Clear shit
+	void ClearDepthStencil(gxapi::DescriptorHandle dsv,
+						   float depth,
+						   uint8_t stencil,
+						   size_t numRects = 0,
+						   gxapi::Rectangle* rects = nullptr,
+						   bool clearDepth = true,
+						   bool clearStencil = false) override;
+
+	void ClearRenderTarget(gxapi::DescriptorHandle rtv,
+						   gxapi::ColorRGBA color,
+						   size_t numRects = 0,
+						   gxapi::Rectangle* rects = nullptr) override;
+
+
+	// Draw
+	void DrawIndexedInstanced(unsigned numIndices,
+							  unsigned startIndex = 0,
+							  int vertexOffset = 0,
+							  unsigned numInstances = 1,
+							  unsigned startInstance = 0) override;
+
+	void DrawInstanced(unsigned numVertices,
+					   unsigned startVertex = 0,
+					   unsigned numInstances = 1,
+					   unsigned startInstance = 0) override;
+
+	void ExecuteBundle(IGraphicsCommandList* bundle) override;
+
+	// input assembler
+	void SetIndexBuffer(void* gpuVirtualAddress, size_t sizeInBytes, gxapi::eFormat format) override;
+
+	void SetPrimitiveTopology(gxapi::ePrimitiveTopology topology) override;
+
+	void SetVertexBuffers(unsigned startSlot,
+						  unsigned count,
+						  void** gpuVirtualAddress,
+						  unsigned* sizeInBytes,
+						  unsigned* strideInBytes) override;
+
+	// output merger
+	void SetRenderTargets(unsigned numRenderTargets,
+						  gxapi::DescriptorHandle* renderTargets,
+						  gxapi::DescriptorHandle* depthStencil = nullptr) override;
+	void SetBlendFactor(float r, float g, float b, float a) override;
+	void SetStencilRef(unsigned stencilRef) override;
+
+
+	// rasterizer state
+	void SetScissorRects(unsigned numRects, gxapi::Rectangle* rects) override;
+	void SetViewports(unsigned numViewports, gxapi::Viewport* viewports) override;
+
+
+	// variable rate shading
+	void SetShadingRate(gxapi::eShadingRate baseRate, const gxapi::eShadingRateCombiner* combiners = nullptr) override;
+	void SetShadingRateImage(gxapi::IResource* image) override;
+
+
+	// set graphics root signature stuff
+	void SetGraphicsRootConstant(unsigned parameterIndex, unsigned destOffset, uint32_t value) override;
+	void SetGraphicsRootConstants(unsigned parameterIndex, unsigned destOffset, unsigned numValues, const uint32_t* value) override;
+	void SetGraphicsRootConstantBuffer(unsigned parameterIndex, void* gpuVirtualAddress) override;
+	void SetGraphicsRootDescriptorTable(unsigned parameterIndex, gxapi::DescriptorHandle baseHandle) override;
+	void SetGraphicsRootShaderResource(unsigned parameterIndex, void* gpuVirtualAddress) override;
+
+	void SetGraphicsRootSignature(gxapi::IRootSignature* rootSignature) override;
+
+};
+
+
+#pragma warning(default: 4250)
+
+
+} // namespace gxapi_null
+} // namespace inl
@@ -0,0 +1,253 @@
+#include "CommandQueue.hpp"
+
+#include "CommandList.hpp"
+#include "QueryHeap.hpp"
+#include "Resource.hpp"
+
+#include "../GraphicsApi_LL/IFence.hpp"
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+// Commands hold the interface pointers as void pointers.
+static Resource* GetResource(const void* object) {
+	return static_cast<Resource*>(const_cast<gxapi::IResource*>(static_cast<const gxapi::IResource*>(object)));
+}
+
+
+static QueryHeap* GetQueryHeap(const void* object) {
+	return static_cast<QueryHeap*>(const_cast<gxapi::IQueryHeap*>(static_cast<const gxapi::IQueryHeap*>(object)));
+}
+
+
+CommandQueue::CommandQueue(const gxapi::CommandQueueDesc& desc, const SimulationDesc& simulation)
+	: m_desc(desc), m_simulation(simulation), m_gpuTime(Clock::now()) {
+	m_thread = std::thread([this] { Run(); });
+}
+
+
+CommandQueue::~CommandQueue() {
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+		m_stop = true;
+	}
+	m_cv.notify_all();
+	m_thread.join();
+}
+
+
+void CommandQueue::ExecuteCommandLists(uint32_t numCommandLists, gxapi::ICommandList* const* commandLists) {
+	Operation operation{ eOperation::EXECUTE, Clock::now() };
+	operation.streams.reserve(numCommandLists);
+	for (uint32_t i = 0; i < numCommandLists; ++i) {
+		auto list = dynamic_cast<const BasicCommandList*>(commandLists[i]);
+		if (!list) {
+			throw InvalidArgumentException("Only command lists of the null graphics API can be executed.");
+		}
+		operation.streams.push_back(list->GetSharedCommands());
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+		m_operations.push_back(std::move(operation));
+	}
+	m_cv.notify_all();
+}
+
+
+void CommandQueue::Signal(gxapi::IFence* fence, uint64_t value) {
+	Operation operation{ eOperation::SIGNAL, Clock::now() };
+	operation.fence = fence;
+	operation.value = value;
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+		m_operations.push_back(std::move(operation));
+	}
+	m_cv.notify_all();
+}
+
+
+void CommandQueue::Wait(gxapi::IFence* fence, uint64_t value) {
+	Operation operation{ eOperation::WAIT, Clock::now() };
+	operation.fence = fence;
+	operation.value = value;
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+		m_operations.push_back(std::move(operation));
+	}
+	m_cv.notify_all();
+}
+
+
+void CommandQueue::UpdateTileMappings(gxapi::IResource* resource,
+									  uint32_t numRegions,
+									  const gxapi::TiledResourceCoordinate* regionCoordinates,
+									  const gxapi::TileRegionSize* regionSizes,
+									  gxapi::IHeap* heap,
+									  uint32_t numRanges,
+									  const gxapi::TileRange* ranges) {
+	// Reserved resources have no memory to map.
+}
+
+
+gxapi::CommandQueueDesc CommandQueue::GetDesc() const {
+	return m_desc;
+}
+
+
+uint64_t CommandQueue::GetTimestampFrequency() const {
+	return 1'000'000'000; // Timestamps are steady clock nanoseconds.
+}
+
+
+void CommandQueue::BeginDebuggerEvent(const std::string& name) const {}
+
+
+void CommandQueue::EndDebuggerEvent() const {}
+
+
+void CommandQueue::Flush() {
+	std::unique_lock<std::mutex> lock(m_mtx);
+	m_cv.wait(lock, [this] { return m_operations.empty() && m_numExecuting == 0; });
+}
+
+
+void CommandQueue::Run() {
+	while (true) {
+		Operation operation;
+		{
+			std::unique_lock<std::mutex> lock(m_mtx);
+			m_cv.wait(lock, [this] { return m_stop || !m_operations.empty(); });
+			if (m_operations.empty()) {
+				return;
+			}
+			operation = std::move(m_operations.front());
+			m_operations.pop_front();
+			++m_numExecuting;
+		}
+
+		switch (operation.type) {
+			case eOperation::EXECUTE:
+				// The GPU starts on the lists after the latency, or when done with the previous ones.
+				m_gpuTime = std::max(m_gpuTime, operation.submitted + m_simulation.submitLatency);
+				std::this_thread::sleep_until(m_gpuTime);
+				for (const auto& stream : operation.streams) {
+					Execute(*stream);
+				}
+				break;
+			case eOperation::SIGNAL:
+				std::this_thread::sleep_until(m_gpuTime);
+				operation.fence->Signal(operation.value);
+				break;
+			case eOperation::WAIT:
+				// Polls so that a destroyed queue doesn't wait on a fence nobody signals anymore.
+				while (!m_stop && operation.fence->Fetch() < operation.value) {
+					operation.fence->Wait(operation.value, 10);
+				}
+				m_gpuTime = std::max(m_gpuTime, Clock::now());
+				break;
+		}
+		operation = {};
+
+		{
+			std::lock_guard<std::mutex> lock(m_mtx);
+			--m_numExecuting;
+		}
+		m_cv.notify_all();
+	}
+}
+
+
+void CommandQueue::Execute(const CommandStream& stream) {
+	auto countInOpenQueries = [this](uint64_t vertices, uint64_t instances, uint64_t groups) {
+		for (auto& [key, statistics] : m_openQueries) {
+			statistics.inputVertices += vertices * instances;
+			statistics.vertexShaderInvocations += vertices * instances;
+			statistics.inputPrimitives += vertices / 3 * instances;
+			statistics.computeShaderInvocations += groups;
+		}
+	};
+
+	for (const Command& command : stream.commands) {
+		switch (command.type) {
+			case eCommand::DRAW_INDEXED_INSTANCED:
+			case eCommand::DRAW_INSTANCED:
+				m_gpuTime += m_simulation.drawTime;
+				countInOpenQueries(command.values[0], command.type == eCommand::DRAW_INSTANCED ? command.values[2] : command.values[3], 0);
+				break;
+			case eCommand::DISPATCH:
+				m_gpuTime += m_simulation.drawTime;
+				countInOpenQueries(0, 0, command.values[0] * command.values[1] * command.values[2]);
+				break;
+			case eCommand::EXECUTE_INDIRECT:
+				m_gpuTime += m_simulation.drawTime;
+				break;
+			case eCommand::EXECUTE_BUNDLE:
+				Execute(static_cast<const BasicCommandList*>(command.objects[0])->GetCommands());
+				break;
+			case eCommand::BEGIN_QUERY:
+				if (gxapi::eQueryType(command.values[0]) == gxapi::eQueryType::PIPELINE_STATISTICS) {
+					m_openQueries[{ command.objects[0], command.values[1] }] = gxapi::PipelineStatistics{};
+				}
+				break;
+			case eCommand::END_QUERY: {
+				QueryHeap* heap = GetQueryHeap(command.objects[0]);
+				const unsigned index = unsigned(command.values[1]);
+				if (gxapi::eQueryType(command.values[0]) == gxapi::eQueryType::TIMESTAMP) {
+					heap->SetTimestamp(index, std::chrono::duration_cast<std::chrono::nanoseconds>(m_gpuTime.time_since_epoch()).count());
+				}
+				else {
+					auto it = m_openQueries.find({ command.objects[0], command.values[1] });
+					heap->SetStatistics(index, it != m_openQueries.end() ? it->second : gxapi::PipelineStatistics{});
+					if (it != m_openQueries.end()) {
+						m_openQueries.erase(it);
+					}
+				}
+				break;
+			}
+			case eCommand::RESOLVE_QUERY_DATA: {
+				Resource* destination = GetResource(command.objects[1]);
+				const size_t offset = command.values[3];
+				if (uint8_t* memory = destination->GetMemory(); memory && offset < destination->GetMemorySize()) {
+					GetQueryHeap(command.objects[0])->Resolve(unsigned(command.values[1]), unsigned(command.values[2]), memory + offset, destination->GetMemorySize() - offset);
+				}
+				break;
+			}
+			case eCommand::COPY_BUFFER: {
+				Resource* destination = GetResource(command.objects[0]);
+				Resource* source = GetResource(command.objects[1]);
+				const size_t dstOffset = command.values[0], srcOffset = command.values[1], bytes = command.values[2];
+				uint8_t* dst = destination->GetMemory();
+				uint8_t* src = source->GetMemory();
+				if (dst && src && dstOffset + bytes <= destination->GetMemorySize() && srcOffset + bytes <= source->GetMemorySize()) {
+					std::memcpy(dst + dstOffset, src + srcOffset, bytes);
+				}
+				break;
+			}
+			case eCommand::COPY_RESOURCE: {
+				Resource* destination = GetResource(command.objects[0]);
+				Resource* source = GetResource(command.objects[1]);
+				uint8_t* dst = destination->GetMemory();
+				uint8_t* src = source->GetMemory();
+				if (dst && src) {
+					std::memcpy(dst, src, std::min(destination->GetMemorySize(), source->GetMemorySize()));
+				}
+				break;
+			}
+			default:
+				break;
+		}
+	}
+	m_gpuTime += m_simulation.commandListTime;
+	std::this_thread::sleep_until(m_gpuTime);
+}
+
+
+} // namespace gxapi_null
+} // namespace inl
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "../GraphicsApi_LL/ICommandQueue.hpp"
+#include "CommandStream.hpp"
+#include "SimulationDesc.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+/// <summary> Executes the command streams of null command lists on a thread of its own, in submission order. </summary>
+/// <remarks> Executing a list takes the time the <see cref="SimulationDesc"/> tells, as if a GPU was working on it:
+///		the thread sleeps until the simulated GPU is done, and signals fences only after the work before them.
+///		Executing writes query results, resolves them to CPU visible buffers and copies between CPU visible resources,
+///		everything else is only timed. Destroying the queue finishes the pending work, except for waits on fences
+///		that are not signaled by then. </remarks>
+class CommandQueue : public gxapi::ICommandQueue {
+public:
+	CommandQueue(const gxapi::CommandQueueDesc& desc, const SimulationDesc& simulation);
+	~CommandQueue();
+	CommandQueue(const CommandQueue&) = delete;
+	CommandQueue& operator=(const CommandQueue&) = delete;
+
+	void ExecuteCommandLists(uint32_t numCommandLists, gxapi::ICommandList* const* commandLists) override;
+
+	void Signal(gxapi::IFence* fence, uint64_t value) override;
+	void Wait(gxapi::IFence* fence, uint64_t value) override;
+
+	void UpdateTileMappings(gxapi::IResource* resource,
+							uint32_t numRegions,
+							const gxapi::TiledResourceCoordinate* regionCoordinates,
+							const gxapi::TileRegionSize* regionSizes,
+							gxapi::IHeap* heap,
+							uint32_t numRanges,
+							const gxapi::TileRange* ranges) override;
+
+	gxapi::CommandQueueDesc GetDesc() const override;
+	uint64_t GetTimestampFrequency() const override;
+
+	void BeginDebuggerEvent(const std::string& name) const override;
+	void EndDebuggerEvent() const override;
+
+	/// <summary> Blocks until everything submitted so far has been executed. </summary>
+	void Flush();
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	enum class eOperation {
+		EXECUTE,
+		SIGNAL,
+		WAIT,
+	};
+
+	struct Operation {
+		eOperation type;
+		Clock::time_point submitted;
+		std::vector<std::shared_ptr<const CommandStream>> streams;
+		gxapi::IFence* fence = nullptr;
+		uint64_t value = 0;
+	};
+
+	void Run();
+	void Execute(const CommandStream& stream);
+
+private:
+	gxapi::CommandQueueDesc m_desc;
+	SimulationDesc m_simulation;
+
+	std::deque<Operation> m_operations;
+	size_t m_numExecuting = 0;
+	std::mutex m_mtx;
+	std::condition_variable m_cv;
+	std::atomic<bool> m_stop = false;
+	std::thread m_thread;
+
+	// Used by the thread only.
+	Clock::time_point m_gpuTime; // When the simulated GPU finishes the work executed so far.
+	std::map<std::pair<const void*, uint64_t>, gxapi::PipelineStatistics> m_openQueries; // Keyed by heap and index.
+};
+
+
+} // namespace gxapi_null
+} // namespace inl
@@ -0,0 +1,25 @@
+#include "CommandStream.hpp"
+
+#include <algorithm>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+size_t CommandStream::Count(eCommand type) const {
+	return std::count_if(commands.begin(), commands.end(), [type](const Command& command) { return command.type == type; });
+}
+
+
+uint64_t HashRootConstants(const uint32_t* values, unsigned count) {
+	uint64_t hash = 14695981039346656037ull;
+	for (unsigned i = 0; i < count; ++i) {
+		hash = (hash ^ values[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+
+} // namespace gxapi_null
+} // namespace inl
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+/// <summary> The commands a null command list records, one per call of the command list's interface. </summary>
+/// <remarks> The comments list what goes into <see cref="Command::objects"/> and <see cref="Command::values"/>, in order.
+///		Descriptor handles are recorded by their CPU address, which points to a <see cref="Descriptor"/>.
+///		Calls taking arrays record one command for each element after the command itself, as noted. </remarks>
+enum class eCommand {
+	CLOSE,
+	RESET, // objects: allocator, pipeline state
+	COPY_BUFFER, // objects: destination, source; values: destination offset, source offset, bytes
+	COPY_RESOURCE, // objects: destination, source
+	COPY_TEXTURE, // objects: destination, source; values: destination subresource, source subresource
+	RESOURCE_BARRIER, // objects: resource (before for aliasing), resource after for aliasing; values: eResourceBarrierType, before state, after state, subresource
+	DISPATCH, // values: x, y, z
+	EXECUTE_INDIRECT, // objects: argument buffer, count buffer; values: max command count, argument offset, count offset
+	SET_ROOT_CONSTANTS, // values: graphics, parameter, destination offset, FNV-1a hash of the values, see HashRootConstants
+	SET_ROOT_CONSTANT_BUFFER, // objects: GPU address; values: graphics, parameter
+	SET_ROOT_DESCRIPTOR_TABLE, // objects: base descriptor; values: graphics, parameter
+	SET_ROOT_SHADER_RESOURCE, // objects: GPU address; values: graphics, parameter
+	SET_ROOT_UNORDERED_RESOURCE, // objects: GPU address; values: graphics, parameter
+	SET_ROOT_SIGNATURE, // objects: root signature; values: graphics
+	SET_PIPELINE_STATE, // objects: pipeline state
+	SET_DESCRIPTOR_HEAPS, // objects: first two heaps; values: count
+	BEGIN_QUERY, // objects: query heap; values: eQueryType, index
+	END_QUERY, // objects: query heap; values: eQueryType, index
+	RESOLVE_QUERY_DATA, // objects: query heap, destination; values: eQueryType, first, count, destination offset
+	CLEAR_DEPTH_STENCIL, // objects: DSV; values: depth as float bits, stencil, clear depth, clear stencil
+	CLEAR_RENDER_TARGET, // objects: RTV; values: red, green, blue, alpha as float bits
+	DRAW_INDEXED_INSTANCED, // values: indices, start index, vertex offset, instances
+	DRAW_INSTANCED, // values: vertices, start vertex, instances, start instance
+	EXECUTE_BUNDLE, // objects: bundle, as a BasicCommandList
+	SET_INDEX_BUFFER, // objects: GPU address; values: bytes, eFormat
+	SET_PRIMITIVE_TOPOLOGY, // values: ePrimitiveTopology
+	SET_VERTEX_BUFFER, // objects: GPU address; values: slot, bytes, stride; one per buffer of SetVertexBuffers
+	SET_RENDER_TARGETS, // objects: DSV or null; values: count; followed by a SET_RENDER_TARGET for each
+	SET_RENDER_TARGET, // objects: RTV; values: slot
+	SET_BLEND_FACTOR, // values: red, green, blue, alpha as float bits
+	SET_STENCIL_REF, // values: reference
+	SET_SCISSOR_RECT, // values: top, left, bottom, right; one per rectangle of SetScissorRects
+	SET_VIEWPORT, // values: top left x, top left y, width, height as float bits; one per viewport of SetViewports
+	SET_SHADING_RATE, // values: eShadingRate, first combiner, second combiner
+	SET_SHADING_RATE_IMAGE, // objects: image
+	BEGIN_EVENT, // values: index of the name in CommandStream::eventNames
+	END_EVENT,
+};
+
+
+struct Command {
+	eCommand type;
+	std::array<const void*, 2> objects = {};
+	std::array<uint64_t, 4> values = {};
+};
+
+
+/// <summary> What a command list recorded since its last reset. </summary>
+/// <remarks> Resetting a command list starts a new stream, so executed streams stay valid while the queue works on them. </remarks>
+struct CommandStream {
+	std::vector<Command> commands;
+	std::vector<std::string> eventNames;
+
+	size_t Count(eCommand type) const;
+};
+
+
+/// <summary> The hash recorded for root constants, hash the expected values with it to check them. </summary>
+uint64_t HashRootConstants(const uint32_t* values, unsigned count);
+
+
+} // namespace gxapi_null
+} // namespace inl
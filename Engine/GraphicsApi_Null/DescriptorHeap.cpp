@@ -0,0 +1,39 @@
+#include "DescriptorHeap.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+DescriptorHeap::DescriptorHeap(const gxapi::DescriptorHeapDesc& desc, uint64_t gpuAddress)
+	: m_desc(desc),
+	  m_descriptors(std::make_unique<Descriptor[]>(desc.numDescriptors)),
+	  m_gpuAddress(gpuAddress) {
+}
+
+
+gxapi::DescriptorHandle DescriptorHeap::At(size_t index) const {
+	if (index >= m_desc.numDescriptors) {
+		throw OutOfRangeException("Descriptor heap does not have that many descriptors.");
+	}
+	gxapi::DescriptorHandle handle;
+	handle.cpuAddress = &m_descriptors[index];
+	handle.gpuAddress = m_desc.isShaderVisible ? reinterpret_cast<void*>(m_gpuAddress + index * GetIncrementSize()) : nullptr;
+	return handle;
+}
+
+
+gxapi::DescriptorHeapDesc DescriptorHeap::GetDesc() const {
+	return m_desc;
+}
+
+
+uint32_t DescriptorHeap::GetIncrementSize() const {
+	return sizeof(Descriptor);
+}
+
+
+} // namespace gxapi_null
+} // namespace inl
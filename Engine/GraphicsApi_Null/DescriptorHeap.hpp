@@ -0,0 +1,57 @@
+#pragma once
+
+#include "../GraphicsApi_LL/IDescriptorHeap.hpp"
+
+#include <memory>
+
+
+namespace inl {
+namespace gxapi {
+class IResource;
+}
+}
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+enum class eDescriptorKind {
+	NONE,
+	CBV,
+	SRV,
+	UAV,
+	RTV,
+	DSV,
+};
+
+
+/// <summary> What the views of the null graphics API write at the CPU address of a descriptor handle. </summary>
+struct Descriptor {
+	eDescriptorKind kind = eDescriptorKind::NONE;
+	const gxapi::IResource* resource = nullptr; // Null for views made from a description only.
+	const void* gpuAddress = nullptr; // Of constant buffer views.
+};
+
+
+class DescriptorHeap : public gxapi::IDescriptorHeap {
+public:
+	/// <param name="gpuAddress"> Base of the GPU handles, unused if the heap is not shader visible. </param>
+	DescriptorHeap(const gxapi::DescriptorHeapDesc& desc, uint64_t gpuAddress);
+	DescriptorHeap(const DescriptorHeap&) = delete;
+	DescriptorHeap& operator=(const DescriptorHeap&) = delete;
+
+	gxapi::DescriptorHandle At(size_t index) const override;
+
+	gxapi::DescriptorHeapDesc GetDesc() const override;
+	uint32_t GetIncrementSize() const override;
+
+private:
+	gxapi::DescriptorHeapDesc m_desc;
+	std::unique_ptr<Descriptor[]> m_descriptors;
+	uint64_t m_gpuAddress;
+};
+
+
+} // namespace gxapi_null
+} // namespace inl
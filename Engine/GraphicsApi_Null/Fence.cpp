@@ -0,0 +1,110 @@
+#include "Fence.hpp"
+
+#include <chrono>
+#include <vector>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+// Waits on multiple fences are woken by any signal, there are few of them.
+static std::mutex multiWaitMutex;
+static std::condition_variable multiWaitCv;
+
+
+template <class Predicate>
+static void WaitFor(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, uint64_t timeoutMillis, Predicate predicate) {
+	if (timeoutMillis == gxapi::IFence::FOREVER) {
+		cv.wait(lock, predicate);
+	}
+	else {
+		cv.wait_for(lock, std::chrono::milliseconds(timeoutMillis), predicate);
+	}
+}
+
+
+Fence::Fence(uint64_t initialValue)
+	: m_state(std::make_shared<State>()) {
+	m_state->value = initialValue;
+}
+
+
+Fence::Fence(const Fence& shared, std::nullptr_t)
+	: m_state(shared.m_state) {
+}
+
+
+uint64_t Fence::Fetch() const {
+	std::lock_guard<std::mutex> lock(m_state->mtx);
+	return m_state->value;
+}
+
+
+void Fence::Signal(uint64_t value) {
+	std::vector<std::function<void()>> completed;
+	{
+		std::lock_guard<std::mutex> lock(m_state->mtx);
+		m_state->value = value;
+		auto last = m_state->callbacks.upper_bound(value);
+		for (auto it = m_state->callbacks.begin(); it != last; ++it) {
+			completed.push_back(std::move(it->second));
+		}
+		m_state->callbacks.erase(m_state->callbacks.begin(), last);
+	}
+	m_state->cv.notify_all();
+	{
+		std::lock_guard<std::mutex> lock(multiWaitMutex);
+	}
+	multiWaitCv.notify_all();
+
+	for (auto& callback : completed) {
+		callback();
+	}
+}
+
+
+void Fence::Wait(uint64_t value, uint64_t timeoutMillis) const {
+	std::unique_lock<std::mutex> lock(m_state->mtx);
+	WaitFor(m_state->cv, lock, timeoutMillis, [&] { return m_state->value >= value; });
+}
+
+
+void Fence::WaitAny(const IFence** fences, uint64_t* values, size_t count, uint64_t timeoutMillis) const {
+	WaitMultiple(fences, values, count, timeoutMillis, false);
+}
+
+
+void Fence::WaitAll(const IFence** fences, uint64_t* values, size_t count, uint64_t timeoutMillis) const {
+	WaitMultiple(fences, values, count, timeoutMillis, true);
+}
+
+
+void Fence::OnCompletion(uint64_t value, std::function<void()> callback) const {
+	{
+		std::lock_guard<std::mutex> lock(m_state->mtx);
+		if (m_state->value < value) {
+			m_state->callbacks.insert({ value, std::move(callback) });
+			return;
+		}
+	}
+	callback();
+}
+
+
+void Fence::WaitMultiple(const IFence** fences, uint64_t* values, size_t count, uint64_t timeoutMillis, bool all) const {
+	auto reached = [&] {
+		size_t numReached = 0;
+		for (size_t i = 0; i < count; ++i) {
+			numReached += fences[i]->Fetch() >= values[i];
+		}
+		return all ? numReached == count : numReached > 0;
+	};
+
+	std::unique_lock<std::mutex> lock(multiWaitMutex);
+	WaitFor(multiWaitCv, lock, timeoutMillis, reached);
+}
+
+
+} // namespace gxapi_null
+} // namespace inl
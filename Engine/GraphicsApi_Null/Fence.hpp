@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../GraphicsApi_LL/IFence.hpp"
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+class Fence : public gxapi::IFence {
+	struct State {
+		std::mutex mtx;
+		std::condition_variable cv;
+		uint64_t value;
+		std::multimap<uint64_t, std::function<void()>> callbacks; // Keyed by the fence value.
+	};
+
+public:
+	Fence(uint64_t initialValue);
+	/// <summary> Opens the fence again, like shared fences of other adapters. </summary>
+	Fence(const Fence& shared, std::nullptr_t);
+	Fence(const Fence&) = delete;
+	Fence& operator=(const Fence&) = delete;
+
+	uint64_t Fetch() const override;
+	void Signal(uint64_t value) override;
+	void Wait(uint64_t value, uint64_t timeoutMillis = FOREVER) const override;
+	void WaitAny(const IFence** fences, uint64_t* values, size_t count, uint64_t timeoutMillis = FOREVER) const override;
+	void WaitAll(const IFence** fences, uint64_t* values, size_t count, uint64_t timeoutMillis = FOREVER) const override;
+	void OnCompletion(uint64_t value, std::function<void()> callback) const override;
+
+private:
+	void WaitMultiple(const IFence** fences, uint64_t* values, size_t count, uint64_t timeoutMillis, bool all) const;
+
+private:
+	std::shared_ptr<State> m_state;
+};
+
+
+} // namespace gxapi_null
+} // namespace inl
@@ -0,0 +1,372 @@
+#include "GraphicsApi.hpp"
+
+#include "CapabilityQuery.hpp"
+#include "CommandList.hpp"
+#include "CommandQueue.hpp"
+#include "DescriptorHeap.hpp"
+#include "Fence.hpp"
+#include "Heap.hpp"
+#include "PipelineObjects.hpp"
+#include "QueryHeap.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+static constexpr uint64_t PlacementAlignment = 65536;
+static constexpr uint64_t MultisamplePlacementAlignment = 4194304;
+
+
+static void WriteDescriptor(gxapi::DescriptorHandle destination, eDescriptorKind kind, const gxapi::IResource* resource, const void* gpuAddress = nullptr) {
+	if (destination.cpuAddress == nullptr) {
+		throw InvalidArgumentException("Views need a descriptor to write to.");
+	}
+	Descriptor& descriptor = *static_cast<Descriptor*>(destination.cpuAddress);
+	descriptor.kind = kind;
+	descriptor.resource = resource;
+	descriptor.gpuAddress = gpuAddress;
+}
+
+
+static Descriptor* GetDescriptor(gxapi::DescriptorHandle handle, size_t index) {
+	return static_cast<Descriptor*>(handle.cpuAddress) + index;
+}
+
+
+GraphicsApi::GraphicsApi(const SimulationDesc& simulation, std::shared_ptr<MemoryUsage> usage)
+	: m_simulation(simulation), m_usage(std::move(usage)) {
+	assert(m_usage);
+}
+
+
+void GraphicsApi::ReportLiveObjects() const {
+	// Objects of the null graphics API are plain C++ objects, leak checkers of the platform find them.
+}
+
+
+gxapi::ICommandQueue* GraphicsApi::CreateCommandQueue(gxapi::CommandQueueDesc desc) {
+	return new CommandQueue{ desc, m_simulation };
+}
+
+
+gxapi::ICommandAllocator* GraphicsApi::CreateCommandAllocator(gxapi::eCommandListType type) {
+	return new CommandAllocator{ type };
+}
+
+
+gxapi::IGraphicsCommandList* GraphicsApi::CreateGraphicsCommandList(gxapi::CommandListDesc desc) {
+	return new GraphicsCommandList{ gxapi::eCommandListType::GRAPHICS };
+}
+
+
+gxapi::IComputeCommandList* GraphicsApi::CreateComputeCommandList(gxapi::CommandListDesc desc) {
+	return new ComputeCommandList{ gxapi::eCommandListType::COMPUTE };
+}
+
+
+gxapi::ICopyCommandList* GraphicsApi::CreateCopyCommandList(gxapi::CommandListDesc desc) {
+	return new CopyCommandList{ gxapi::eCommandListType::COPY };
+}
+
+
+gxapi::ICommandList* GraphicsApi::CreateCommandList(gxapi::eCommandListType type, gxapi::CommandListDesc desc) {
+	switch (type) {
+		case gxapi::eCommandListType::COPY:
+			return new CopyCommandList(type);
+		case gxapi::eCommandListType::COMPUTE:
+			return new ComputeCommandList(type);
+		case gxapi::eCommandListType::GRAPHICS:
+		case gxapi::eCommandListType::BUNDLE:
+			return new GraphicsCommandList(type);
+		default:
+			assert(false);
+			throw InvalidArgumentException("Unknown command list type.", std::to_string((long long)type));
+	}
+}
+
+
+gxapi::IResource* GraphicsApi::CreateCommittedResource(gxapi::HeapProperties heapProperties,
+													   gxapi::eHeapFlags heapFlags,
+													   gxapi::ResourceDesc desc,
+													   gxapi::eResourceState initialState,
+													   gxapi::ClearValue* clearValue) {
+	const uint64_t size = GetAllocationSize(desc);
+	return new Resource{ desc, heapProperties.type, m_usage->AllocateAddress(size), m_usage, size };
+}
+
+
+gxapi::IHeap* GraphicsApi::CreateHeap(const gxapi::HeapDesc& desc) {
+	return new Heap{ desc, m_usage->AllocateAddress(desc.size), m_usage, desc.size };
+}
+
+
+gxapi::IResource* GraphicsApi::CreatePlacedResource(gxapi::IHeap* heap,
+													uint64_t offset,
+													gxapi::ResourceDesc desc,
+													gxapi::eResourceState initialState,
+													gxapi::ClearValue* clearValue) {
+	Heap* nullHeap = dynamic_cast<Heap*>(heap);
+	if (!nullHeap) {
+		throw InvalidArgumentException("Resources can only be placed in heaps of the null graphics API.");
+	}
+	if (offset + GetAllocationSize(desc) > nullHeap->GetSize()) {
+		throw OutOfRangeException("The resource does not fit in the heap at the offset.");
+	}
+	// The heap has accounted for the memory already.
+	return new Resource{ desc, nullHeap->GetDesc().properties.type, nullHeap->GetGpuAddress() + offset, m_usage, 0 };
+}
+
+
+gxapi::IResource* GraphicsApi::CreateReservedResource(gxapi::ResourceDesc desc,
+													  gxapi::eResourceState initialState,
+													  gxapi::ClearValue* clearValue) {
+	// Only address space, tiles are mapped from heaps that have accounted for their memory.
+	return new Resource{ desc, gxapi::eHeapType::DEFAULT, m_usage->AllocateAddress(GetAllocationSize(desc)), m_usage, 0 };
+}
+
+
+gxapi::IRootSignature* GraphicsApi::CreateRootSignature(gxapi::RootSignatureDesc desc) {
+	return new RootSignature{ std::move(desc) };
+}
+
+
+gxapi::IPipelineState* GraphicsApi::CreateGraphicsPipelineState(const gxapi::GraphicsPipelineStateDesc& desc) {
+	return new PipelineState{ desc.rootSignature, false };
+}
+
+
+gxapi::IPipelineState* GraphicsApi::CreateComputePipelineState(const gxapi::ComputePipelineStateDesc& desc) {
+	return new PipelineState{ desc.rootSignature, true };
+}
+
+
+void GraphicsApi::OpenPipelineCache(const std::string& path) {
+	// Pipeline states cost nothing to create, there is nothing to cache.
+}
+
+
+void GraphicsApi::SavePipelineCache() {
+}
+
+
+gxapi::IDescriptorHeap* GraphicsApi::CreateDescriptorHeap(gxapi::DescriptorHeapDesc desc) {
+	uint64_t gpuAddress = desc.isShaderVisible ? m_usage->AllocateAddress(desc.numDescriptors * sizeof(Descriptor)) : 0;
+	return new DescriptorHeap{ desc, gpuAddress };
+}
+
+
+gxapi::ICommandSignature* GraphicsApi::CreateCommandSignature(const gxapi::CommandSignatureDesc& desc, gxapi::IRootSignature* rootSignature) {
+	return new CommandSignature{ desc };
+}
+
+
+gxapi::IQueryHeap* GraphicsApi::CreateQueryHeap(const gxapi::QueryHeapDesc& desc) {
+	return new QueryHeap{ desc };
+}
+
+
+void GraphicsApi::CreateConstantBufferView(gxapi::ConstantBufferViewDesc desc,
+										   gxapi::DescriptorHandle destination) {
+	WriteDescriptor(destination, eDescriptorKind::CBV, nullptr, desc.gpuVirtualAddress);
+}
+
+
+void GraphicsApi::CreateDepthStencilView(gxapi::DepthStencilViewDesc desc,
+										 gxapi::DescriptorHandle destination) {
+	WriteDescriptor(destination, eDescriptorKind::DSV, nullptr);
+}
+
+
+void GraphicsApi::CreateDepthStencilView(const gxapi::IResource* resource,
+										 gxapi::DescriptorHandle destination) {
+	WriteDescriptor(destination, eDescriptorKind::DSV, resource);
+}
+
+
+void GraphicsApi::CreateDepthStencilView(const gxapi::IResource* resource,
+										 gxapi::DepthStencilViewDesc desc,
+										 gxapi::DescriptorHandle destination) {
+	WriteDescriptor(destination, eDescriptorKind::DSV, resource);
+}
+
+
+void GraphicsApi::CreateRenderTargetView(const gxapi::IResource* resource,
+										 gxapi::DescriptorHandle destination) {
+	WriteDescriptor(destination, eDescriptorKind::RTV, resource);
+}
+
+
+void GraphicsApi::CreateRenderTargetView(const gxapi::IResource* resource,
+										 gxapi::RenderTargetViewDesc desc,
+										 gxapi::DescriptorHandle destination) {
+	WriteDescriptor(destination, eDescriptorKind::RTV, resource);
+}
+
+
+void GraphicsApi::CreateShaderResourceView(gxapi::ShaderResourceViewDesc desc,
+										   gxapi::DescriptorHandle destination) {
+	WriteDescriptor(destination, eDescriptorKind::SRV, nullptr);
+}
+
+
+void GraphicsApi::CreateShaderResourceView(const gxapi::IResource* resource,
+										   gxapi::DescriptorHandle destination) {
+	WriteDescriptor(destination, eDescriptorKind::SRV, resource);
+}
+
+
+void GraphicsApi::CreateShaderResourceView(const gxapi::IResource* resource,
+										   gxapi::ShaderResourceViewDesc desc,
+										   gxapi::DescriptorHandle destination) {
+	WriteDescriptor(destination, eDescriptorKind::SRV, resource);
+}
+
+
+void GraphicsApi::CreateUnorderedAccessView(gxapi::UnorderedAccessViewDesc descriptor,
+											gxapi::DescriptorHandle destination) {
+	WriteDescriptor(destination, eDescriptorKind::UAV, nullptr);
+}
+
+
+void GraphicsApi::CreateUnorderedAccessView(const gxapi::IResource* resource,
+											gxapi::DescriptorHandle destination) {
+	WriteDescriptor(destination, eDescriptorKind::UAV, resource);
+}
+
+
+void GraphicsApi::CreateUnorderedAccessView(const gxapi::IResource* resource,
+											gxapi::UnorderedAccessViewDesc descriptor,
+											gxapi::DescriptorHandle destination) {
+	WriteDescriptor(destination, eDescriptorKind::UAV, resource);
+}
+
+
+void GraphicsApi::CopyDescriptors(size_t numSrcDescRanges,
+								  gxapi::DescriptorHandle* srcRangeStarts,
+								  size_t numDstDescRanges,
+								  gxapi::DescriptorHandle* dstRangeStarts,
+								  uint32_t* rangeCounts,
+								  gxapi::eDescriptorHeapType descHeapsType) {
+	// Like the D3D12 implementation: the sources are single descriptors, filling the destination ranges in order.
+	CopyDescriptors(numSrcDescRanges, srcRangeStarts, nullptr, numDstDescRanges, dstRangeStarts, rangeCounts, descHeapsType);
+}
+
+
+void GraphicsApi::CopyDescriptors(size_t numSrcDescRanges,
+								  gxapi::DescriptorHandle* srcRangeStarts,
+								  uint32_t* srcRangeLengths,
+								  size_t numDstDescRanges,
+								  gxapi::DescriptorHandle* dstRangeStarts,
+								  uint32_t* dstRangeLengths,
+								  gxapi::eDescriptorHeapType descHeapsType) {
+	// Null lengths mean ranges of one descriptor, as in ID3D12Device::CopyDescriptors.
+	size_t srcRange = 0, srcIndex = 0;
+	for (size_t dstRange = 0; dstRange < numDstDescRanges; ++dstRange) {
+		const size_t dstLength = dstRangeLengths ? dstRangeLengths[dstRange] : 1;
+		for (size_t dstIndex = 0; dstIndex < dstLength; ++dstIndex) {
+			while (srcRange < numSrcDescRanges && srcIndex >= (srcRangeLengths ? srcRangeLengths[srcRange] : 1)) {
+				++srcRange;
+				srcIndex = 0;
+			}
+			if (srcRange == numSrcDescRanges) {
+				throw OutOfRangeException("The destination ranges have more descriptors than the source ranges.");
+			}
+			*GetDescriptor(dstRangeStarts[dstRange], dstIndex) = *GetDescriptor(srcRangeStarts[srcRange], srcIndex);
+			++srcIndex;
+		}
+	}
+}
+
+
+void GraphicsApi::CopyDescriptors(gxapi::DescriptorHandle srcStart,
+								  gxapi::DescriptorHandle dstStart,
+								  size_t rangeCount,
+								  gxapi::eDescriptorHeapType descHeapsType) {
+	const Descriptor* source = GetDescriptor(srcStart, 0);
+	std::copy(source, source + rangeCount, GetDescriptor(dstStart, 0));
+}
+
+
+gxapi::IFence* GraphicsApi::CreateFence(uint64_t initialValue) {
+	return new Fence(initialValue);
+}
+
+
+gxapi::IFence* GraphicsApi::CreateSharedFence(uint64_t initialValue) {
+	return new Fence(initialValue);
+}
+
+
+gxapi::IFence* GraphicsApi::OpenSharedFence(gxapi::IFence* fence) {
+	Fence* nullFence = dynamic_cast<Fence*>(fence);
+	if (!nullFence) {
+		throw InvalidArgumentException("Only fences of the null graphics API can be opened.");
+	}
+	return new Fence(*nullFence, nullptr);
+}
+
+
+gxapi::IHeap* GraphicsApi::OpenSharedHeap(gxapi::IHeap* heap) {
+	Heap* nullHeap = dynamic_cast<Heap*>(heap);
+	if (!nullHeap) {
+		throw InvalidArgumentException("Only heaps of the null graphics API can be opened.");
+	}
+	// Same memory as the original, which has accounted for it.
+	return new Heap{ nullHeap->GetDesc(), nullHeap->GetGpuAddress(), m_usage, 0 };
+}
+
+
+void GraphicsApi::MakeResident(const std::vector<gxapi::IResource*>& objects) {
+	// Eviction is not simulated, resources count towards the usage for all their life.
+}
+
+
+void GraphicsApi::Evict(const std::vector<gxapi::IResource*>& objects) {
+}
+
+
+gxapi::VideoMemoryInfo GraphicsApi::QueryVideoMemoryInfo(gxapi::eMemorySegmentGroup group) const {
+	gxapi::VideoMemoryInfo result = {};
+	if (group == gxapi::eMemorySegmentGroup::LOCAL) {
+		result.budget = m_simulation.videoMemory;
+		result.currentUsage = m_usage->local;
+	}
+	else {
+		result.budget = m_simulation.systemMemory;
+		result.currentUsage = m_usage->nonLocal;
+	}
+	result.availableForReservation = result.budget;
+	return result;
+}
+
+
+uint64_t GraphicsApi::GetAllocationSize(const gxapi::ResourceDesc& desc) const {
+	return GetAllocationInfo(desc).size;
+}
+
+
+gxapi::ResourceAllocationInfo GraphicsApi::GetAllocationInfo(const gxapi::ResourceDesc& desc) const {
+	uint64_t size = Resource::GetByteSize(desc);
+	uint64_t alignment = PlacementAlignment;
+	if (desc.type == gxapi::eResourceType::TEXTURE && desc.textureDesc.multisampleCount > 1) {
+		size *= desc.textureDesc.multisampleCount;
+		alignment = MultisamplePlacementAlignment;
+	}
+	size = (std::max(size, uint64_t(1)) + alignment - 1) / alignment * alignment;
+	return { size, alignment };
+}
+
+
+gxapi::ICapabilityQuery* GraphicsApi::GetCapabilityQuery() const {
+	return new CapabilityQuery();
+}
+
+
+} // namespace gxapi_null
+} // namespace inl
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "../GraphicsApi_LL/IGraphicsApi.hpp"
+#include "Resource.hpp"
+#include "SimulationDesc.hpp"
+
+#include <memory>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+/// <summary> A graphics API without a GPU, for profiling the CPU side of the engine and for testing what it records. </summary>
+/// <remarks> Objects are simulated as the classes of this module describe: command lists record, queues execute the records
+///		with the latency of the <see cref="SimulationDesc"/>, and resources take memory in the budget without having any,
+///		except those the CPU can access. Shaders are not compiled, pipeline states and root signatures only keep their descriptions. </remarks>
+class GraphicsApi : public gxapi::IGraphicsApi {
+public:
+	/// <param name="usage"> Shared by the graphics APIs and swap chains of a manager, so that GPU addresses are unique. </param>
+	GraphicsApi(const SimulationDesc& simulation, std::shared_ptr<MemoryUsage> usage);
+
+	// Command submission
+	gxapi::ICommandQueue* CreateCommandQueue(gxapi::CommandQueueDesc desc) override;
+
+	gxapi::ICommandAllocator* CreateCommandAllocator(gxapi::eCommandListType type) override;
+
+	gxapi::IGraphicsCommandList* CreateGraphicsCommandList(gxapi::CommandListDesc desc) override;
+	gxapi::IComputeCommandList* CreateComputeCommandList(gxapi::CommandListDesc desc) override;
+	gxapi::ICopyCommandList* CreateCopyCommandList(gxapi::CommandListDesc desc) override;
+	gxapi::ICommandList* CreateCommandList(gxapi::eCommandListType type, gxapi::CommandListDesc desc) override;
+
+	// Resources
+	gxapi::IResource* CreateCommittedResource(gxapi::HeapProperties heapProperties,
+											  gxapi::eHeapFlags heapFlags,
+											  gxapi::ResourceDesc desc,
+											  gxapi::eResourceState initialState,
+											  gxapi::ClearValue* clearValue = nullptr) override;
+	gxapi::IHeap* CreateHeap(const gxapi::HeapDesc& desc) override;
+	gxapi::IResource* CreatePlacedResource(gxapi::IHeap* heap,
+										   uint64_t offset,
+										   gxapi::ResourceDesc desc,
+										   gxapi::eResourceState initialState,
+										   gxapi::ClearValue* clearValue = nullptr) override;
+	gxapi::IResource* CreateReservedResource(gxapi::ResourceDesc desc,
+											 gxapi::eResourceState initialState,
+											 gxapi::ClearValue* clearValue = nullptr) override;
+
+
+	// Pipeline and binding
+	gxapi::IRootSignature* CreateRootSignature(gxapi::RootSignatureDesc desc) override;
+
+	gxapi::IPipelineState* CreateGraphicsPipelineState(const gxapi::GraphicsPipelineStateDesc& desc) override;
+	gxapi::IPipelineState* CreateComputePipelineState(const gxapi::ComputePipelineStateDesc& desc) override;
+
+	void OpenPipelineCache(const std::string& path) override;
+	void SavePipelineCache() override;
+
+	gxapi::IDescriptorHeap* CreateDescriptorHeap(gxapi::DescriptorHeapDesc desc) override;
+
+	gxapi::ICommandSignature* CreateCommandSignature(const gxapi::CommandSignatureDesc& desc, gxapi::IRootSignature* rootSignature = nullptr) override;
+
+	gxapi::IQueryHeap* CreateQueryHeap(const gxapi::QueryHeapDesc& desc) override;
+
+
+	void CreateConstantBufferView(gxapi::ConstantBufferViewDesc desc,
+								  gxapi::DescriptorHandle destination) override;
+
+	void CreateDepthStencilView(gxapi::DepthStencilViewDesc desc,
+								gxapi::DescriptorHandle destination) override;
+	void CreateDepthStencilView(const gxapi::IResource* resource,
+								gxapi::DescriptorHandle destination) override;
+	void CreateDepthStencilView(const gxapi::IResource* resource,
+	                            gxapi::DepthStencilViewDesc desc,
+	                            gxapi::DescriptorHandle destination) override;
+
+	void CreateRenderTargetView(const gxapi::IResource* resource,
+								gxapi::DescriptorHandle destination) override;
+	void CreateRenderTargetView(const gxapi::IResource* resource,
+								gxapi::RenderTargetViewDesc desc,
+								gxapi::DescriptorHandle destination) override;
+
+	void CreateShaderResourceView(gxapi::ShaderResourceViewDesc desc,
+								  gxapi::DescriptorHandle destination) override;
+	void CreateShaderResourceView(const gxapi::IResource* resource,
+								  gxapi::DescriptorHandle destination) override;
+	void CreateShaderResourceView(const gxapi::IResource* resource,
+	                              gxapi::ShaderResourceViewDesc desc,
+	                              gxapi::DescriptorHandle destination) override;
+
+	void CreateUnorderedAccessView(gxapi::UnorderedAccessViewDesc descriptor,
+								   gxapi::DescriptorHandle destination) override;
+	void CreateUnorderedAccessView(const gxapi::IResource* resource,
+								   gxapi::DescriptorHandle destination) override;
+	void CreateUnorderedAccessView(const gxapi::IResource* resource,
+								   gxapi::UnorderedAccessViewDesc descriptor,
+								   gxapi::DescriptorHandle destination) override;
+
+	void CopyDescriptors(size_t numSrcDescRanges,
+	                     gxapi::DescriptorHandle* srcRangeStarts,
+	                     size_t numDstDescRanges,
+	                     gxapi::DescriptorHandle* dstRangeStarts,
+	                     uint32_t* rangeCounts,
+	                     gxapi::eDescriptorHeapType descHeapsType) override;
+
+	void CopyDescriptors(size_t numSrcDescRanges,
+						 gxapi::DescriptorHandle* srcRangeStarts,
+						 uint32_t* srcRangeLengths,
+						 size_t numDstDescRanges,
+						 gxapi::DescriptorHandle* dstRangeStarts,
+						 uint32_t* dstRangeLengths,
+						 gxapi::eDescriptorHeapType descHeapsType) override;
+
+	void CopyDescriptors(gxapi::DescriptorHandle srcStart,
+	                     gxapi::DescriptorHandle dstStart,
+	                     size_t rangeCount,
+	                     gxapi::eDescriptorHeapType descHeapsType) override;
+
+	// Misc
+	gxapi::IFence* CreateFence(uint64_t initialValue) override;
+
+	gxapi::IFence* CreateSharedFence(uint64_t initialValue) override;
+	gxapi::IFence* OpenSharedFence(gxapi::IFence* fence) override;
+	gxapi::IHeap* OpenSharedHeap(gxapi::IHeap* heap) override;
+
+	void MakeResident(const std::vector<gxapi::IResource*>& objects) override;
+	void Evict(const std::vector<gxapi::IResource*>& objects) override;
+
+	gxapi::VideoMemoryInfo QueryVideoMemoryInfo(gxapi::eMemorySegmentGroup group) const override;
+	uint64_t GetAllocationSize(const gxapi::ResourceDesc& desc) const override;
+	gxapi::ResourceAllocationInfo GetAllocationInfo(const gxapi::ResourceDesc& desc) const override;
+
+	// Debug
+	void ReportLiveObjects() const override;
+
+	gxapi::ICapabilityQuery* GetCapabilityQuery() const override;
+
+private:
+	SimulationDesc m_simulation;
+	std::shared_ptr<MemoryUsage> m_usage;
+};
+
+
+} // namespace gxapi_null
+} // namespace inl
@@ -0,0 +1,115 @@
+#include "GxapiManager.hpp"
+
+#include "GraphicsApi.hpp"
+#include "SwapChain.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <cstring>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+// FNV-1a over the parts of a shader that select its code.
+class ShaderHash {
+public:
+	void Add(const void* data, size_t size) {
+		for (size_t i = 0; i < size; ++i) {
+			m_hash ^= static_cast<const uint8_t*>(data)[i];
+			m_hash *= 1099511628211ull;
+		}
+	}
+	void Add(const char* str) {
+		if (str) {
+			Add(str, std::strlen(str) + 1);
+		}
+	}
+	void Add(const std::string& str) { Add(str.c_str(), str.size() + 1); }
+
+	gxapi::ShaderProgramBinary GetBinary() const {
+		gxapi::ShaderProgramBinary binary;
+		binary.data.resize(sizeof(m_hash));
+		std::memcpy(binary.data.data(), &m_hash, sizeof(m_hash));
+		return binary;
+	}
+
+private:
+	uint64_t m_hash = 14695981039346656037ull;
+};
+
+
+GxapiManager::GxapiManager(const SimulationDesc& simulation)
+	: m_simulation(simulation), m_usage(std::make_shared<MemoryUsage>()) {
+}
+
+
+std::vector<gxapi::AdapterInfo> GxapiManager::EnumerateAdapters() {
+	gxapi::AdapterInfo info;
+	info.adapterId = 0;
+	info.name = "Null adapter";
+	info.vendorId = 0;
+	info.deviceId = 0;
+	info.dedicatedVideoMemory = size_t(m_simulation.videoMemory);
+	info.dedicatedSystemMemory = 0;
+	info.sharedSystemMemory = size_t(m_simulation.systemMemory);
+	info.isSoftwareAdapter = true;
+	return { info };
+}
+
+
+gxapi::ISwapChain* GxapiManager::CreateSwapChain(gxapi::SwapChainDesc desc, gxapi::ICommandQueue* flushThisQueue) {
+	return new SwapChain(desc, m_simulation.presentInterval, m_usage);
+}
+
+
+gxapi::IGraphicsApi* GxapiManager::CreateGraphicsApi(unsigned adapterId) {
+	if (adapterId != 0) {
+		throw OutOfRangeException("The null graphics API has a single adapter of id 0.", std::to_string(adapterId));
+	}
+	return new GraphicsApi(m_simulation, m_usage);
+}
+
+
+gxapi::ShaderProgramBinary GxapiManager::CompileShader(const char* source,
+													   const char* mainFunction,
+													   gxapi::eShaderType type,
+													   gxapi::eShaderCompileFlags flags,
+													   gxapi::IShaderIncludeProvider* includeProvider,
+													   const char* macroDefinitions,
+													   gxapi::eShaderModel shaderModel) {
+	if (source == nullptr || mainFunction == nullptr) {
+		throw InvalidArgumentException("Shaders need a source and a main function.");
+	}
+	ShaderHash hash;
+	hash.Add(source);
+	hash.Add(mainFunction);
+	hash.Add(&type, sizeof(type));
+	hash.Add(macroDefinitions);
+	hash.Add(&shaderModel, sizeof(shaderModel));
+	return hash.GetBinary();
+}
+
+
+gxapi::ShaderProgramBinary GxapiManager::CompileShaderFromFile(const std::string& fileName,
+															   const std::string& mainFunctionName,
+															   gxapi::eShaderType type,
+															   gxapi::eShaderCompileFlags flags,
+															   const std::vector<gxapi::ShaderMacroDefinition>& macros,
+															   gxapi::eShaderModel shaderModel) {
+	ShaderHash hash;
+	hash.Add(fileName);
+	hash.Add(mainFunctionName);
+	hash.Add(&type, sizeof(type));
+	for (const auto& macro : macros) {
+		hash.Add(macro.name);
+		hash.Add(macro.value);
+	}
+	hash.Add(&shaderModel, sizeof(shaderModel));
+	return hash.GetBinary();
+}
+
+
+} // namespace gxapi_null
+} // namespace inl
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../GraphicsApi_LL/IGxapiManager.hpp"
+#include "Resource.hpp"
+#include "SimulationDesc.hpp"
+
+#include <memory>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+/// <summary> Creates the null graphics API, see <see cref="GraphicsApi"/>. </summary>
+/// <remarks> There is a single software adapter. Its graphics APIs and swap chains share one address space and memory usage.
+///		Shaders are not compiled, the binaries only identify the source, main function, type, macros and shader model. </remarks>
+class GxapiManager : public gxapi::IGxapiManager {
+public:
+	GxapiManager(const SimulationDesc& simulation = {});
+
+	std::vector<gxapi::AdapterInfo> EnumerateAdapters() override;
+
+	gxapi::ISwapChain* CreateSwapChain(gxapi::SwapChainDesc desc, gxapi::ICommandQueue* flushThisQueue) override;
+	gxapi::IGraphicsApi* CreateGraphicsApi(unsigned adapterId) override;
+
+
+	gxapi::ShaderProgramBinary CompileShader(const char* source,
+											 const char* mainFunction,
+											 gxapi::eShaderType type,
+											 gxapi::eShaderCompileFlags flags,
+											 gxapi::IShaderIncludeProvider* includeProvider = nullptr,
+											 const char* macroDefinitions = nullptr,
+											 gxapi::eShaderModel shaderModel = gxapi::eShaderModel::SM_5_1) override;
+
+	gxapi::ShaderProgramBinary CompileShaderFromFile(const std::string& fileName,
+													 const std::string& mainFunctionName,
+													 gxapi::eShaderType type,
+													 gxapi::eShaderCompileFlags flags,
+													 const std::vector<gxapi::ShaderMacroDefinition>& macros,
+													 gxapi::eShaderModel shaderModel = gxapi::eShaderModel::SM_5_1) override;
+
+	const SimulationDesc& GetSimulation() const { return m_simulation; }
+
+private:
+	SimulationDesc m_simulation;
+	std::shared_ptr<MemoryUsage> m_usage;
+};
+
+
+} // namespace gxapi_null
+} // namespace inl
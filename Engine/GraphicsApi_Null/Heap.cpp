@@ -0,0 +1,25 @@
+#include "Heap.hpp"
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+Heap::Heap(const gxapi::HeapDesc& desc, uint64_t gpuAddress, std::shared_ptr<MemoryUsage> usage, uint64_t accountedBytes)
+	: m_desc(desc), m_gpuAddress(gpuAddress), m_usage(std::move(usage)), m_accountedBytes(accountedBytes) {
+	m_usage->GetSegment(m_desc.properties.type) += m_accountedBytes;
+}
+
+
+Heap::~Heap() {
+	m_usage->GetSegment(m_desc.properties.type) -= m_accountedBytes;
+}
+
+
+uint64_t Heap::GetSize() const {
+	return m_desc.size;
+}
+
+
+} // namespace gxapi_null
+} // namespace inl
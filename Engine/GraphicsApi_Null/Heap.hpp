@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../GraphicsApi_LL/IHeap.hpp"
+#include "../GraphicsApi_LL/Common.hpp"
+#include "Resource.hpp"
+
+#include <memory>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+class Heap : public gxapi::IHeap {
+public:
+	/// <param name="accountedBytes"> Added to the usage of the heap type's segment group until the heap is destroyed. </param>
+	Heap(const gxapi::HeapDesc& desc, uint64_t gpuAddress, std::shared_ptr<MemoryUsage> usage, uint64_t accountedBytes);
+	~Heap();
+	Heap(const Heap&) = delete;
+	Heap& operator=(const Heap&) = delete;
+
+	uint64_t GetSize() const override;
+
+	const gxapi::HeapDesc& GetDesc() const { return m_desc; }
+	/// <summary> Placed resources get this plus their offset as GPU address, so overlapping ones alias in address. </summary>
+	uint64_t GetGpuAddress() const { return m_gpuAddress; }
+
+private:
+	gxapi::HeapDesc m_desc;
+	uint64_t m_gpuAddress;
+	std::shared_ptr<MemoryUsage> m_usage;
+	uint64_t m_accountedBytes;
+};
+
+
+} // namespace gxapi_null
+} // namespace inl
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../GraphicsApi_LL/ICommandAllocator.hpp"
+#include "../GraphicsApi_LL/ICommandSignature.hpp"
+#include "../GraphicsApi_LL/IPipelineState.hpp"
+#include "../GraphicsApi_LL/IRootSignature.hpp"
+#include "../GraphicsApi_LL/Common.hpp"
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+// The null objects only keep their descriptions, for inspecting recorded commands.
+
+
+class CommandAllocator : public gxapi::ICommandAllocator {
+public:
+	CommandAllocator(gxapi::eCommandListType type) : m_type(type) {}
+
+	void Reset() override {}
+	gxapi::eCommandListType GetType() const override { return m_type; }
+
+private:
+	gxapi::eCommandListType m_type;
+};
+
+
+class RootSignature : public gxapi::IRootSignature {
+public:
+	RootSignature(gxapi::RootSignatureDesc desc) : m_desc(std::move(desc)) {}
+
+	const gxapi::RootSignatureDesc& GetDesc() const { return m_desc; }
+
+private:
+	gxapi::RootSignatureDesc m_desc;
+};
+
+
+class PipelineState : public gxapi::IPipelineState {
+public:
+	PipelineState(gxapi::IRootSignature* rootSignature, bool isCompute) : m_rootSignature(rootSignature), m_isCompute(isCompute) {}
+
+	gxapi::IRootSignature* GetRootSignature() const { return m_rootSignature; }
+	bool IsCompute() const { return m_isCompute; }
+
+private:
+	gxapi::IRootSignature* m_rootSignature;
+	bool m_isCompute;
+};
+
+
+class CommandSignature : public gxapi::ICommandSignature {
+public:
+	CommandSignature(gxapi::CommandSignatureDesc desc) : m_desc(std::move(desc)) {}
+
+	const gxapi::CommandSignatureDesc& GetDesc() const { return m_desc; }
+
+private:
+	gxapi::CommandSignatureDesc m_desc;
+};
+
+
+} // namespace gxapi_null
+} // namespace inl
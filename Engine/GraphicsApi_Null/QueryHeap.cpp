@@ -0,0 +1,52 @@
+#include "QueryHeap.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+QueryHeap::QueryHeap(const gxapi::QueryHeapDesc& desc) : m_desc(desc) {
+	if (desc.type == gxapi::eQueryHeapType::TIMESTAMP) {
+		m_timestamps.resize(desc.count, 0);
+	}
+	else {
+		m_statistics.resize(desc.count, gxapi::PipelineStatistics{});
+	}
+}
+
+
+void QueryHeap::SetTimestamp(unsigned index, uint64_t ticks) {
+	if (index >= m_timestamps.size()) {
+		throw OutOfRangeException("Query index is out of the heap, or the heap is not for timestamps.");
+	}
+	m_timestamps[index] = ticks;
+}
+
+
+void QueryHeap::SetStatistics(unsigned index, const gxapi::PipelineStatistics& statistics) {
+	if (index >= m_statistics.size()) {
+		throw OutOfRangeException("Query index is out of the heap, or the heap is not for pipeline statistics.");
+	}
+	m_statistics[index] = statistics;
+}
+
+
+size_t QueryHeap::Resolve(unsigned first, unsigned count, void* destination, size_t capacity) const {
+	const bool timestamps = m_desc.type == gxapi::eQueryHeapType::TIMESTAMP;
+	if (size_t(first) + count > m_desc.count) {
+		throw OutOfRangeException("Resolved queries are out of the heap.");
+	}
+	const void* source = timestamps ? (const void*)(m_timestamps.data() + first) : (const void*)(m_statistics.data() + first);
+	size_t bytes = std::min(count * (timestamps ? sizeof(uint64_t) : sizeof(gxapi::PipelineStatistics)), capacity);
+	std::memcpy(destination, source, bytes);
+	return bytes;
+}
+
+
+} // namespace gxapi_null
+} // namespace inl
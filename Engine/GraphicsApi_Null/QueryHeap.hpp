@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../GraphicsApi_LL/IQueryHeap.hpp"
+#include "../GraphicsApi_LL/Common.hpp"
+
+#include <vector>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+/// <summary> Holds the query results the queue writes when it executes EndQuery. </summary>
+/// <remarks> Timestamps are in the ticks of <see cref="CommandQueue::GetTimestampFrequency"/>.
+///		Pipeline statistics count the vertices, instances and compute groups of the draws and dispatches between
+///		BeginQuery and EndQuery, everything else is reported zero. </remarks>
+class QueryHeap : public gxapi::IQueryHeap {
+public:
+	QueryHeap(const gxapi::QueryHeapDesc& desc);
+
+	const gxapi::QueryHeapDesc& GetDesc() const { return m_desc; }
+
+	void SetTimestamp(unsigned index, uint64_t ticks);
+	void SetStatistics(unsigned index, const gxapi::PipelineStatistics& statistics);
+	/// <summary> Copies the results the way they are resolved into a buffer. </summary>
+	/// <returns> The number of bytes copied, which stops at <paramref name="capacity"/>. </returns>
+	size_t Resolve(unsigned first, unsigned count, void* destination, size_t capacity) const;
+
+private:
+	gxapi::QueryHeapDesc m_desc;
+	std::vector<uint64_t> m_timestamps;
+	std::vector<gxapi::PipelineStatistics> m_statistics;
+};
+
+
+} // namespace gxapi_null
+} // namespace inl
@@ -0,0 +1,191 @@
+#include "Resource.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+uint64_t MemoryUsage::AllocateAddress(uint64_t size) {
+	uint64_t alignedSize = (std::max(size, uint64_t(1)) + AddressAlignment - 1) / AddressAlignment * AddressAlignment;
+	return nextAddress.fetch_add(alignedSize);
+}
+
+
+static unsigned GetPlaneCount(gxapi::eFormat format) {
+	switch (format) {
+		case gxapi::eFormat::R24G8_TYPELESS:
+		case gxapi::eFormat::D24_UNORM_S8_UINT:
+		case gxapi::eFormat::R32G8X24_TYPELESS:
+		case gxapi::eFormat::D32_FLOAT_S8X24_UINT:
+			return 2;
+		default:
+			return 1;
+	}
+}
+
+
+Resource::Resource(const gxapi::ResourceDesc& desc, gxapi::eHeapType heapType, uint64_t gpuAddress, std::shared_ptr<MemoryUsage> usage, uint64_t accountedBytes)
+	: m_desc(Complete(desc)),
+	  m_heapType(heapType),
+	  m_gpuAddress(gpuAddress),
+	  m_usage(std::move(usage)),
+	  m_accountedBytes(accountedBytes)
+{
+	if (m_desc.type == gxapi::eResourceType::BUFFER) {
+		m_numMipLevels = 1;
+		m_numTexturePlanes = 1;
+		m_numArrayLevels = 1;
+	}
+	else {
+		m_numMipLevels = m_desc.textureDesc.mipLevels;
+		m_numTexturePlanes = GetPlaneCount(m_desc.textureDesc.format);
+		m_numArrayLevels = m_desc.textureDesc.dimension == gxapi::eTextueDimension::THREE ? 1 : m_desc.textureDesc.depthOrArraySize;
+	}
+	m_usage->GetSegment(m_heapType) += m_accountedBytes;
+}
+
+
+Resource::~Resource() {
+	m_usage->GetSegment(m_heapType) -= m_accountedBytes;
+}
+
+
+gxapi::ResourceDesc Resource::GetDesc() const {
+	return m_desc;
+}
+
+
+void* Resource::Map(unsigned subresourceIndex, const gxapi::MemoryRange* readRange) {
+	if (m_heapType == gxapi::eHeapType::DEFAULT) {
+		throw InvalidCallException("Resources of default heaps can't be mapped.");
+	}
+	if (subresourceIndex >= GetNumSubresources()) {
+		throw OutOfRangeException("Resource does not have that many subresources.");
+	}
+	return GetMemory();
+}
+
+
+void Resource::Unmap(unsigned subresourceIndex, const gxapi::MemoryRange* writtenRange) {
+	// The memory stays, like that of persistently mapped resources.
+}
+
+
+void* Resource::GetGPUAddress() const {
+	return reinterpret_cast<void*>(m_gpuAddress);
+}
+
+
+unsigned Resource::GetNumMipLevels() const {
+	return m_numMipLevels;
+}
+unsigned Resource::GetNumTexturePlanes() const {
+	return m_numTexturePlanes;
+}
+unsigned Resource::GetNumArrayLevels() const {
+	return m_numArrayLevels;
+}
+
+unsigned Resource::GetNumSubresources() const {
+	return m_numMipLevels * m_numTexturePlanes * m_numArrayLevels;
+}
+unsigned Resource::GetSubresourceIndex(unsigned mipIdx, unsigned arrayIdx, unsigned planeIdx) const {
+	// Same order as D3D12CalcSubresource.
+	unsigned index = mipIdx + arrayIdx * m_numMipLevels + planeIdx * m_numMipLevels * m_numArrayLevels;
+	assert(index < GetNumSubresources());
+	return index;
+}
+
+
+Vec3u64 Resource::GetSize(unsigned mipLevel) const {
+	if (mipLevel >= GetNumMipLevels()) {
+		throw OutOfRangeException("Texture does not have that many mip levels.");
+	}
+
+	if (m_desc.type == gxapi::eResourceType::BUFFER) {
+		return { m_desc.bufferDesc.sizeInBytes, 0, 0 };
+	}
+
+	const gxapi::TextureDesc& texture = m_desc.textureDesc;
+	Vec3u64 size = { texture.width, 1, 1 };
+	if (texture.dimension != gxapi::eTextueDimension::ONE) {
+		size.y = texture.height;
+	}
+	if (texture.dimension == gxapi::eTextueDimension::THREE) {
+		size.z = texture.depthOrArraySize;
+	}
+	for (unsigned i = 0; i < mipLevel; ++i) {
+		size = Vec3u64::Max(size / 2, { 1, 1, 1 });
+	}
+	return size;
+}
+
+
+void Resource::SetName(const char* name) {
+	m_name = name;
+}
+
+
+uint8_t* Resource::GetMemory() {
+	if (m_heapType == gxapi::eHeapType::DEFAULT) {
+		return nullptr;
+	}
+	std::call_once(m_memoryAllocated, [this] { m_memory.resize(GetByteSize(m_desc)); });
+	return m_memory.data();
+}
+
+
+size_t Resource::GetMemorySize() {
+	return GetMemory() ? m_memory.size() : 0;
+}
+
+
+gxapi::ResourceDesc Resource::Complete(gxapi::ResourceDesc desc) {
+	gxapi::TextureDesc& texture = desc.textureDesc;
+	if (desc.type == gxapi::eResourceType::TEXTURE && texture.mipLevels == gxapi::TextureDesc::ALL_MIPLEVELS) {
+		uint64_t largest = texture.width;
+		if (texture.dimension != gxapi::eTextueDimension::ONE) {
+			largest = std::max(largest, uint64_t(texture.height));
+		}
+		if (texture.dimension == gxapi::eTextueDimension::THREE) {
+			largest = std::max(largest, uint64_t(texture.depthOrArraySize));
+		}
+		texture.mipLevels = 1;
+		while (largest > 1) {
+			largest /= 2;
+			++texture.mipLevels;
+		}
+	}
+	return desc;
+}
+
+
+uint64_t Resource::GetByteSize(const gxapi::ResourceDesc& desc) {
+	if (desc.type == gxapi::eResourceType::BUFFER) {
+		return desc.bufferDesc.sizeInBytes;
+	}
+
+	const gxapi::TextureDesc texture = Complete(desc).textureDesc;
+	const bool volume = texture.dimension == gxapi::eTextueDimension::THREE;
+	uint64_t width = texture.width;
+	uint32_t height = texture.dimension == gxapi::eTextueDimension::ONE ? 1 : texture.height;
+	uint32_t depth = volume ? texture.depthOrArraySize : 1;
+	uint64_t bytes = 0;
+	for (unsigned mip = 0; mip < texture.mipLevels; ++mip) {
+		bytes += gxapi::GetFormatRowSizeInBytes(texture.format, width) * gxapi::GetFormatRowCount(texture.format, height) * depth;
+		width = std::max(width / 2, uint64_t(1));
+		height = std::max(height / 2, 1u);
+		depth = std::max(depth / 2, 1u);
+	}
+	const unsigned arraySize = volume ? 1 : texture.depthOrArraySize;
+	return bytes * arraySize * std::max(texture.multisampleCount, 1u);
+}
+
+
+} // namespace gxapi_null
+} // namespace inl
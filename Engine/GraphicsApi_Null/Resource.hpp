@@ -0,0 +1,82 @@
+#pragma once
+
+#include "../GraphicsApi_LL/IResource.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+/// <summary> Bytes taken by the committed resources and heaps of a graphics API, and the next free GPU address. </summary>
+/// <remarks> Shared by the API and all its objects, which may outlive it. </remarks>
+struct MemoryUsage {
+	static constexpr uint64_t AddressAlignment = 65536;
+
+	std::atomic<uint64_t> local = 0;
+	std::atomic<uint64_t> nonLocal = 0;
+	std::atomic<uint64_t> nextAddress = AddressAlignment; // Zero stays an invalid address.
+
+	/// <summary> Returns address space for an object of this size, which is never reused. </summary>
+	uint64_t AllocateAddress(uint64_t size);
+	std::atomic<uint64_t>& GetSegment(gxapi::eHeapType type) { return type == gxapi::eHeapType::DEFAULT ? local : nonLocal; }
+};
+
+
+/// <summary> A resource without GPU memory. Resources of upload, readback and custom heaps have CPU memory,
+///		allocated when first needed, that Map returns and that copies and query resolves on the queue write. </summary>
+/// <remarks> Placed resources don't share the memory of their heap, aliasing isn't simulated. </remarks>
+class Resource : public gxapi::IResource {
+public:
+	/// <param name="accountedBytes"> Added to the usage of the heap type's segment group until the resource is destroyed. </param>
+	Resource(const gxapi::ResourceDesc& desc, gxapi::eHeapType heapType, uint64_t gpuAddress, std::shared_ptr<MemoryUsage> usage, uint64_t accountedBytes);
+	~Resource();
+	Resource(const Resource&) = delete;
+	Resource& operator=(const Resource&) = delete;
+
+	gxapi::ResourceDesc GetDesc() const override;
+	void* Map(unsigned subresourceIndex, const gxapi::MemoryRange* readRange = nullptr) override;
+	void Unmap(unsigned subresourceIndex, const gxapi::MemoryRange* writtenRange = nullptr) override;
+	void* GetGPUAddress() const override;
+
+	unsigned GetNumMipLevels() const override;
+	unsigned GetNumTexturePlanes() const override;
+	unsigned GetNumArrayLevels() const override;
+	unsigned GetNumSubresources() const override;
+	unsigned GetSubresourceIndex(unsigned mipLevel, unsigned arrayIdx, unsigned planeIdx) const override;
+	Vec3u64 GetSize(unsigned mipLevel = 0) const override;
+
+	void SetName(const char* name) override;
+	const std::string& GetName() const { return m_name; }
+
+	gxapi::eHeapType GetHeapType() const { return m_heapType; }
+	/// <summary> The CPU memory of the resource, null for resources of default heaps. </summary>
+	uint8_t* GetMemory();
+	size_t GetMemorySize();
+
+	/// <summary> Fills in the mip count of full mip chains, like the description of a created resource. </summary>
+	static gxapi::ResourceDesc Complete(gxapi::ResourceDesc desc);
+	/// <summary> Bytes of all subresources, which is what a resource takes before aligning it in a heap. </summary>
+	static uint64_t GetByteSize(const gxapi::ResourceDesc& desc);
+
+private:
+	gxapi::ResourceDesc m_desc;
+	gxapi::eHeapType m_heapType;
+	uint64_t m_gpuAddress;
+	std::shared_ptr<MemoryUsage> m_usage;
+	uint64_t m_accountedBytes;
+	unsigned m_numMipLevels, m_numTexturePlanes, m_numArrayLevels;
+	std::string m_name;
+
+	std::once_flag m_memoryAllocated;
+	std::vector<uint8_t> m_memory;
+};
+
+
+} // namespace gxapi_null
+} // namespace inl
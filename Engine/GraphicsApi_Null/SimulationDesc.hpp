@@ -0,0 +1,24 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+/// <summary> How the null graphics API pretends to be a GPU. </summary>
+/// <remarks> All zero makes the GPU infinitely fast: submitted work completes as soon as the queue's thread gets to it. </remarks>
+struct SimulationDesc {
+	std::chrono::microseconds submitLatency{ 0 }; // From ExecuteCommandLists until the GPU starts on the lists.
+	std::chrono::microseconds commandListTime{ 0 }; // GPU time of each command list, on top of its commands.
+	std::chrono::nanoseconds drawTime{ 0 }; // GPU time of each draw, dispatch and indirect execution.
+	std::chrono::milliseconds presentInterval{ 0 }; // Present blocks until this much passed since the previous one, 16 is like vsync at 60 Hz.
+	uint64_t videoMemory = 4ull * 1024 * 1024 * 1024; // Budget of the local segment group.
+	uint64_t systemMemory = 8ull * 1024 * 1024 * 1024; // Budget of the non-local segment group.
+};
+
+
+} // namespace gxapi_null
+} // namespace inl
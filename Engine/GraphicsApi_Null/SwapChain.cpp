@@ -0,0 +1,105 @@
+#include "SwapChain.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <thread>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+SwapChain::SwapChain(const gxapi::SwapChainDesc& desc, std::chrono::milliseconds presentInterval, std::shared_ptr<MemoryUsage> usage)
+	: m_desc(desc),
+	  m_presentInterval(presentInterval),
+	  m_usage(std::move(usage)),
+	  m_maxFrameLatency(desc.frameLatencyWaitable ? 1 : 0),
+	  m_lastPresent(std::chrono::steady_clock::now())
+{
+	CreateBuffers();
+}
+
+
+gxapi::IResource* SwapChain::GetBuffer(unsigned index) {
+	if (index >= m_buffers.size()) {
+		throw OutOfRangeException("Swap chain does not have that many buffers.");
+	}
+	return m_buffers[index].get();
+}
+
+
+gxapi::SwapChainDesc SwapChain::GetDesc() const {
+	return m_desc;
+}
+
+
+bool SwapChain::IsFullScreen() const {
+	return m_desc.isFullScreen;
+}
+
+
+unsigned SwapChain::GetCurrentBufferIndex() const {
+	return m_currentBuffer;
+}
+
+
+void SwapChain::SetFullScreen(bool isFullScreen) {
+	m_desc.isFullScreen = isFullScreen;
+}
+
+
+void SwapChain::Resize(unsigned width, unsigned height, unsigned bufferCount, gxapi::eFormat format) {
+	m_desc.width = width;
+	m_desc.height = height;
+	if (bufferCount != 0) {
+		m_desc.numBuffers = bufferCount;
+	}
+	if (format != gxapi::eFormat::UNKNOWN) {
+		m_desc.format = format;
+	}
+	CreateBuffers();
+}
+
+
+void SwapChain::Present() {
+	auto next = m_lastPresent + m_presentInterval;
+	std::this_thread::sleep_until(next);
+	m_lastPresent = std::max(next, std::chrono::steady_clock::now());
+	m_currentBuffer = (m_currentBuffer + 1) % unsigned(m_buffers.size());
+	++m_numPresented;
+}
+
+
+void SwapChain::SetMaximumFrameLatency(unsigned maxLatency) {
+	if (!m_desc.frameLatencyWaitable) {
+		throw InvalidStateException("Swap chain was not created frame latency waitable.");
+	}
+	m_maxFrameLatency = maxLatency;
+}
+
+
+unsigned SwapChain::GetMaximumFrameLatency() const {
+	return m_maxFrameLatency;
+}
+
+
+bool SwapChain::WaitForFrameLatency(uint64_t timeoutMillis) {
+	// Present blocks instead, nothing is ever queued for presentation.
+	return true;
+}
+
+
+void SwapChain::CreateBuffers() {
+	m_buffers.clear();
+	const gxapi::ResourceDesc desc = gxapi::ResourceDesc::Texture2D(m_desc.width, m_desc.height, m_desc.format, gxapi::eResourceFlags::ALLOW_RENDER_TARGET);
+	for (unsigned i = 0; i < std::max(m_desc.numBuffers, 1u); ++i) {
+		const uint64_t size = Resource::GetByteSize(desc);
+		m_buffers.push_back(std::make_unique<Resource>(desc, gxapi::eHeapType::DEFAULT, m_usage->AllocateAddress(size), m_usage, size));
+	}
+	m_currentBuffer = 0;
+}
+
+
+} // namespace gxapi_null
+} // namespace inl
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "../GraphicsApi_LL/ISwapChain.hpp"
+#include "Resource.hpp"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+
+namespace inl {
+namespace gxapi_null {
+
+
+/// <summary> Back buffers that are never shown. </summary>
+/// <remarks> Present only moves on to the next buffer, after waiting for the present interval of the simulation. </remarks>
+class SwapChain : public gxapi::ISwapChain {
+public:
+	SwapChain(const gxapi::SwapChainDesc& desc, std::chrono::milliseconds presentInterval, std::shared_ptr<MemoryUsage> usage);
+
+	gxapi::IResource* GetBuffer(unsigned index) override;
+	gxapi::SwapChainDesc GetDesc() const override;
+	bool IsFullScreen() const override;
+	unsigned GetCurrentBufferIndex() const override;
+
+	void SetFullScreen(bool isFullScreen) override;
+	void Resize(unsigned width, unsigned height, unsigned bufferCount = 0, gxapi::eFormat format = gxapi::eFormat::UNKNOWN) override;
+
+	void Present() override;
+
+	void SetMaximumFrameLatency(unsigned maxLatency) override;
+	unsigned GetMaximumFrameLatency() const override;
+	bool WaitForFrameLatency(uint64_t timeoutMillis = FOREVER) override;
+
+	/// <summary> Number of Present calls since the swap chain was created. </summary>
+	uint64_t GetNumPresented() const { return m_numPresented; }
+
+private:
+	void CreateBuffers();
+
+private:
+	gxapi::SwapChainDesc m_desc;
+	std::chrono::milliseconds m_presentInterval;
+	std::shared_ptr<MemoryUsage> m_usage;
+	std::vector<std::unique_ptr<Resource>> m_buffers;
+	unsigned m_currentBuffer = 0;
+	unsigned m_maxFrameLatency = 0;
+	uint64_t m_numPresented = 0;
+	std::chrono::steady_clock::time_point m_lastPresent;
+};
+
+
+} // namespace gxapi_null
+} // namespace inl
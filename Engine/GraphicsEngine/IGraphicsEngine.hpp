@@ -110,13 +110,19 @@ public:
 	/// <summary> Return the env var with given name or throws <see cref="InvalidArgumentException"/>. </summary>
 	virtual const Any& GetEnvVariable(const std::string& name) = 0;
 
-	/// <summary> Load the pipeline from the JSON node graph description. </summary>
-	/// <remarks> Tears down all the resources associated with the old pipeline, including
-	///		textures, render targets, etc., and builds up the new pipeline.
-	///		Also incurs a pipeline queue flush. Use it only when settings change,
+	/// <summary> Load the pipeline from the JSON node graph description, or its binary form. </summary>
+	/// <remarks> Builds up the new pipeline and replaces the old one. The resources associated with
+	///		the old pipeline, including textures, render targets, etc., are released once the GPU has
+	///		finished the frames that use them. Use it only when settings change,
 	///		use env vars to control pipeline behaviour on the fly.
 	virtual void LoadPipeline(const std::string& nodes) = 0;
 
+	/// <summary> Builds the pipeline in the background while the current one keeps rendering. </summary>
+	/// <remarks> The new pipeline replaces the current one between two frames, once it and its shaders are ready.
+	///		If it fails to build, the error is logged and the current pipeline is kept.
+	///		When called again before the swap, only the last description is loaded. </remarks>
+	virtual void LoadPipelineAsync(const std::string& nodes) = 0;
+
 	/// <summary> The engine will look for shader files in these directories. </summary>
 	/// <remarks> May be absolute, relative, or whatever paths you OS can handle. </remarks>
 	virtual void SetShaderDirectories(const std::vector<std::filesystem::path>& directories) = 0;
@@ -6,6 +6,15 @@
 namespace inl::gxeng {
 
 
+/// <summary> How the GPU computes mip levels of images that don't come with their own. </summary>
+enum class eMipFilter {
+	/// <summary> Averages 2x2 texels, up to four levels are made in one pass. </summary>
+	BOX,
+	/// <summary> Weights 4x4 texels with a tent, less aliasing for detailed images at one pass per level. </summary>
+	TENT,
+};
+
+
 class IImage {
 public:
 	virtual ~IImage() = default;
@@ -31,8 +40,20 @@ public:
 	/// <param name="channelType"> The numeric representation of a pixel channel. See <see cref="ePixelChannelType"/>. </param>
 	/// <param name="channelCount"> Number of channels per pixel. </param>
 	/// <param name="pixelClass"> How pixels are interpreted. See <see cref="ePixelClass"/>. </param>
+	/// <remarks> The full mip chain is allocated if shaders can write the format, the levels below the top are
+	///		generated on the GPU whenever the top level is updated. Otherwise the image has a single level. </remarks>
 	virtual void SetLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, int channelCount, ePixelClass pixelClass) = 0;
 
+	/// <summary> Allocates the texture with the given number of mip levels, for data that comes with its mips, like block compressed textures. </summary>
+	/// <param name="mipLevels"> All of them are visible to shaders, so all must be uploaded. </param>
+	/// <remarks> Mips are never generated for such images, the uploaded ones are used as they are. </remarks>
+	virtual void SetLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, int channelCount, ePixelClass pixelClass, int mipLevels) = 0;
+
+	/// <summary> Sets how mips are generated for the next updates of the top level. </summary>
+	/// <param name="srgb"> The colors (not the alpha) are sRGB encoded, they are filtered in linear space. </param>
+	/// <remarks> Defaults to <see cref="eMipFilter::BOX"/> with linear colors. </remarks>
+	virtual void SetMipGeneration(eMipFilter filter, bool srgb) = 0;
+
 	/// <summary> Upload pixels as byte array to the GPU. </summary>
 	/// <param name="x"> Where to insert the block of uploaded pixels. Top-left corner. </param>
 	/// <param name="y"> Where to insert the block of uploaded pixels. Top-left corner. </param>
@@ -43,6 +64,11 @@ public:
 	/// <param name="reader"> Interprets byte stream. Implement <see cref="IPixelReader"/> or use <see cref="Pixel::Reader"/>. </param>
 	/// <param name="bytesPerRow"> How many bytes to skip in <paramref name="pixels"/> for each row. Leave as 0 for no row padding. </param>
 	virtual void Update(uint64_t x, uint32_t y, uint64_t width, uint32_t height, int mipLevel, const void* pixels, const IPixelReader& reader, size_t bytesPerRow = 0) = 0;
+
+	/// <summary> Uploads a whole mip level of a block compressed image as it is. </summary>
+	/// <param name="blocks"> The 4x4 pixel blocks of the mip level, row by row. </param>
+	/// <param name="bytesPerRow"> How many bytes to skip in <paramref name="blocks"/> for each row of blocks. Leave as 0 for no row padding. </param>
+	virtual void UpdateCompressed(int mipLevel, const void* blocks, size_t bytesPerRow = 0) = 0;
 };
 
 
@@ -15,6 +15,15 @@ enum class ePixelChannelType {
 	INT32,
 	//FLOAT16,
 	FLOAT32,
+
+	// Block compressed formats store 4x4 pixel blocks, images of them are uploaded as they are.
+	BC1, // RGB and 1 bit alpha, 8 bytes per block.
+	BC2, // RGBA with 4 bit alpha, 16 bytes per block.
+	BC3, // RGBA with interpolated alpha, 16 bytes per block.
+	BC4, // Single channel, 8 bytes per block.
+	BC5, // Two channels, 16 bytes per block.
+	BC6H, // Unsigned half float RGB, 16 bytes per block.
+	BC7, // High quality RGBA, 16 bytes per block.
 };
 
 enum class ePixelClass {
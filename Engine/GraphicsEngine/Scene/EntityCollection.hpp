@@ -1,6 +1,7 @@
 #pragma once
 
-#include <set>
+#include <unordered_map>
+#include <vector>
 
 #include <BaseLibrary/Exception/Exception.hpp>
 
@@ -17,11 +18,14 @@ public:
 
 /// <summary> A collection of a certain type of entities. 
 ///		A <see cref="Scene"/> consists of multiple entity collections. </summary>
+/// <remarks> Entities are stored densely so that render nodes walk a contiguous array.
+///		Removal swaps the last entity into the hole, so order is not preserved, and
+///		adding or removing invalidates iterators. </remarks>
 template <class EntityType>
 class EntityCollection : public EntityCollectionBase {
 public:
-	using iterator = typename std::set<const EntityType*>::iterator;
-	using const_iterator = typename std::set<const EntityType*>::const_iterator;
+	using iterator = typename std::vector<const EntityType*>::const_iterator;
+	using const_iterator = typename std::vector<const EntityType*>::const_iterator;
 public:
 	iterator begin();
 	iterator end();
@@ -32,77 +36,112 @@ public:
 
 	bool IsEmpty() const;
 	size_t Size() const;
+	const EntityType* operator[](size_t index) const;
+	/// <summary> Contiguous array of <see cref="Size"/> entities. </summary>
+	const EntityType* const* Data() const;
 
 	void Add(const EntityType* entity);
 	void Remove(const EntityType* entity);
 	bool Contains(const EntityType* entity) const;
 	void Clear();
+	/// <summary> Preallocates storage for <paramref name="capacity"/> entities. </summary>
+	void Reserve(size_t capacity);
 private:
-	std::set<const EntityType*> m_entites;
+	std::vector<const EntityType*> m_entities;
+	std::unordered_map<const EntityType*, size_t> m_indices; // Position of each entity in m_entities.
 };
 
 
 template <class EntityType>
 typename EntityCollection<EntityType>::iterator EntityCollection<EntityType>::begin() {
-	return m_entites.begin();
+	return m_entities.cbegin();
 }
 
 template <class EntityType>
 typename EntityCollection<EntityType>::iterator EntityCollection<EntityType>::end() {
-	return m_entites.end();
+	return m_entities.cend();
 }
 
 template <class EntityType>
 typename EntityCollection<EntityType>::const_iterator EntityCollection<EntityType>::begin() const {
-	return m_entites.begin();
+	return m_entities.cbegin();
 }
 
 template <class EntityType>
 typename EntityCollection<EntityType>::const_iterator EntityCollection<EntityType>::end() const {
-	return m_entites.end();
+	return m_entities.cend();
 }
 
 template <class EntityType>
 typename EntityCollection<EntityType>::const_iterator EntityCollection<EntityType>::cbegin() const {
-	return m_entites.cbegin();
+	return m_entities.cbegin();
 }
 
 template <class EntityType>
 typename EntityCollection<EntityType>::const_iterator EntityCollection<EntityType>::cend() const {
-	return m_entites.cend();
+	return m_entities.cend();
 }
 
 template <class EntityType>
 bool EntityCollection<EntityType>::IsEmpty() const {
-	return m_entites.empty();
+	return m_entities.empty();
 }
 
 template <class EntityType>
 size_t EntityCollection<EntityType>::Size() const {
-	return m_entites.size();
+	return m_entities.size();
+}
+
+template <class EntityType>
+const EntityType* EntityCollection<EntityType>::operator[](size_t index) const {
+	return m_entities[index];
+}
+
+template <class EntityType>
+const EntityType* const* EntityCollection<EntityType>::Data() const {
+	return m_entities.data();
 }
 
 template <class EntityType>
 void EntityCollection<EntityType>::Add(const EntityType* entity) {
-	auto result = m_entites.insert(entity);
+	auto result = m_indices.insert({ entity, m_entities.size() });
 	if (result.second == false) {
 		throw InvalidArgumentException("Entity already member of this collection.");
 	}
+	m_entities.push_back(entity);
 }
 
 template <class EntityType>
 void EntityCollection<EntityType>::Remove(const EntityType* entity) {
-	m_entites.erase(entity);
+	auto it = m_indices.find(entity);
+	if (it == m_indices.end()) {
+		return;
+	}
+
+	// Move the last entity into the hole.
+	size_t index = it->second;
+	const EntityType* last = m_entities.back();
+	m_entities[index] = last;
+	m_indices[last] = index;
+	m_entities.pop_back();
+	m_indices.erase(entity);
 }
 
 template <class EntityType>
 bool EntityCollection<EntityType>::Contains(const EntityType* entity) const {
-	return m_entites.count(entity) > 0;
+	return m_indices.count(entity) > 0;
 }
 
 template <class EntityType>
 void EntityCollection<EntityType>::Clear() {
-	m_entites.clear();
+	m_entities.clear();
+	m_indices.clear();
+}
+
+template <class EntityType>
+void EntityCollection<EntityType>::Reserve(size_t capacity) {
+	m_entities.reserve(capacity);
+	m_indices.reserve(capacity);
 }
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include "BaseLibrary/Rect.hpp"
 #include "BaseLibrary/Transformable.hpp"
 #include <InlineMath.hpp>
 
@@ -32,6 +33,12 @@ public:
 	virtual void SetTexture(IImage* texture) = 0;
 	virtual IImage* GetTexture() const = 0;
 
+	/// <summary> The part of the texture drawn on the object, in texture coordinates. </summary>
+	/// <remarks> Texture coordinate (0,0) of the object maps to (left, bottom), (1,1) to (right, top).
+	///		Defaults to the whole texture. Lets many objects share an image atlas, see <see cref="ImageAtlas"/>. </remarks>
+	virtual void SetTextureRect(RectF rect) = 0;
+	virtual RectF GetTextureRect() const = 0;
+
 	/// <summary> Z-Depth determines which 2D entity lays over the other. </summary>
 	/// <remarks> Number are not limited to [0,1], anything is fine. Don't pass NaN and Inf. </remarks>
 	virtual void SetZDepth(float z) = 0;
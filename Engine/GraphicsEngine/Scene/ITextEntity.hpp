@@ -80,6 +80,11 @@ public:
 	virtual float CalculateTextWidth() const = 0;
 	/// <summary> Return the height of a line of text without top and bottom line spacing. </summary>
 	virtual float CalculateTextHeight() const = 0;
+	/// <summary> Returns the distance of the caret before a character from the left of the text, in camera units. </summary>
+	/// <param name="index"> Index of the character, the size of the text places the caret at the end. </param>
+	virtual float GetCaretPosition(size_t index) const = 0;
+	/// <summary> Returns the index of the character at a distance from the left of the text, same as IFont::FindCharacter. </summary>
+	virtual intptr_t FindCharacter(float coordinate) const = 0;
 
 	/// <summary> Z-Depth determines which 2D entity lays over the other. </summary>
 	/// <remarks> Number are not limited to [0,1], anything is fine. Don't pass NaN and Inf. </remarks>
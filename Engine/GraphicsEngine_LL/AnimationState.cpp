@@ -0,0 +1,294 @@
+#include "AnimationState.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <string>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#define INL_ANIMATION_SSE
+#endif
+
+
+namespace inl::gxeng {
+
+
+
+//------------------------------------------------------------------------------
+// Skeleton
+//------------------------------------------------------------------------------
+
+Skeleton::Skeleton(std::vector<Joint> joints) : m_joints(std::move(joints)) {
+	if (m_joints.size() > MaxJoints) {
+		throw InvalidArgumentException("Skeletons can have at most 256 joints.");
+	}
+	for (size_t i = 0; i < m_joints.size(); ++i) {
+		if (m_joints[i].parent < -1 || m_joints[i].parent >= int(i)) {
+			throw InvalidArgumentException("Parents must come before their children.", std::to_string(i));
+		}
+	}
+}
+
+
+
+//------------------------------------------------------------------------------
+// Animation clip
+//------------------------------------------------------------------------------
+
+AnimationClip::AnimationClip(size_t jointCount, float sampleRate, const std::vector<JointPose>& poses)
+	: m_jointCount(jointCount), m_sampleRate(sampleRate) {
+	if (jointCount == 0 || poses.empty() || poses.size() % jointCount != 0) {
+		throw InvalidArgumentException("Clips must have a pose for every joint of every frame.");
+	}
+	if (!(sampleRate > 0.0f)) {
+		throw InvalidArgumentException("Clips must have a positive sample rate.");
+	}
+
+	m_frameCount = poses.size() / jointCount;
+	m_samples.resize(poses.size());
+	for (size_t i = 0; i < poses.size(); ++i) {
+		const JointPose& pose = poses[i];
+		m_samples[i] = {
+			{ pose.rotation.w, pose.rotation.x, pose.rotation.y, pose.rotation.z },
+			{ pose.translation.x, pose.translation.y, pose.translation.z, 0.0f },
+			{ pose.scale.x, pose.scale.y, pose.scale.z, 0.0f },
+		};
+	}
+}
+
+
+float AnimationClip::GetDuration() const {
+	return m_frameCount > 1 ? float(m_frameCount - 1) / m_sampleRate : 0.0f;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Skin
+//------------------------------------------------------------------------------
+
+Skin::Skin(const std::vector<Influence>& influences, const BoundingBox& poseBounds)
+	: m_poseBounds(poseBounds),
+	  m_positionQuantization(PositionQuantization::FromBounds(poseBounds)) {
+	static std::atomic<uint64_t> nextId = 1;
+	m_id = nextId++;
+
+	m_packed.resize(2 * influences.size());
+	for (size_t i = 0; i < influences.size(); ++i) {
+		const Influence& influence = influences[i];
+		float weights[4] = { std::max(0.0f, influence.weights.x), std::max(0.0f, influence.weights.y), std::max(0.0f, influence.weights.z), std::max(0.0f, influence.weights.w) };
+		const float sum = weights[0] + weights[1] + weights[2] + weights[3];
+
+		// Rounding leftovers go to the largest weight, so that the weights always add up to one.
+		uint32_t quantized[4] = { 255, 0, 0, 0 };
+		if (sum > 0.0f) {
+			int largest = 0;
+			uint32_t total = 0;
+			for (int j = 0; j < 4; ++j) {
+				quantized[j] = uint32_t(weights[j] / sum * 255.0f + 0.5f);
+				total += quantized[j];
+				largest = weights[j] > weights[largest] ? j : largest;
+			}
+			quantized[largest] = uint32_t(int(quantized[largest]) + 255 - int(total));
+		}
+
+		m_packed[2 * i] = influence.joints[0] | (influence.joints[1] << 8) | (influence.joints[2] << 16) | (uint32_t(influence.joints[3]) << 24);
+		m_packed[2 * i + 1] = quantized[0] | (quantized[1] << 8) | (quantized[2] << 16) | (quantized[3] << 24);
+	}
+}
+
+
+
+//------------------------------------------------------------------------------
+// Animation state
+//------------------------------------------------------------------------------
+
+namespace {
+
+// Weighted sums of the samples of one joint, the same layout as the samples.
+struct PoseSum {
+	float rotation[4];
+	float translation[4];
+	float scale[4];
+	float weight;
+};
+
+} // namespace
+
+
+// Adds the sample with the rotation on the sum's side of the quaternion sphere, so that the blend takes the short way.
+static void Accumulate(PoseSum& sum, const float* rotation, const float* translation, const float* scale, float weight) {
+#ifdef INL_ANIMATION_SSE
+	__m128 sumRotation = _mm_loadu_ps(sum.rotation);
+	__m128 sampleRotation = _mm_loadu_ps(rotation);
+	__m128 product = _mm_mul_ps(sumRotation, sampleRotation);
+	product = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)));
+	product = _mm_add_ss(product, _mm_movehl_ps(product, product));
+	const float rotationWeight = _mm_cvtss_f32(product) < 0.0f ? -weight : weight;
+
+	const __m128 weightV = _mm_set1_ps(weight);
+	_mm_storeu_ps(sum.rotation, _mm_add_ps(sumRotation, _mm_mul_ps(sampleRotation, _mm_set1_ps(rotationWeight))));
+	_mm_storeu_ps(sum.translation, _mm_add_ps(_mm_loadu_ps(sum.translation), _mm_mul_ps(_mm_loadu_ps(translation), weightV)));
+	_mm_storeu_ps(sum.scale, _mm_add_ps(_mm_loadu_ps(sum.scale), _mm_mul_ps(_mm_loadu_ps(scale), weightV)));
+#else
+	float dot = 0.0f;
+	for (int i = 0; i < 4; ++i) {
+		dot += sum.rotation[i] * rotation[i];
+	}
+	const float rotationWeight = dot < 0.0f ? -weight : weight;
+	for (int i = 0; i < 4; ++i) {
+		sum.rotation[i] += rotation[i] * rotationWeight;
+		sum.translation[i] += translation[i] * weight;
+		sum.scale[i] += scale[i] * weight;
+	}
+#endif
+	sum.weight += weight;
+}
+
+
+// Local transform of the pose for row vectors: scale, then rotate, then translate.
+static Mat44 ComposeLocal(const PoseSum& sum) {
+	float w = sum.rotation[0], x = sum.rotation[1], y = sum.rotation[2], z = sum.rotation[3];
+	const float length = std::sqrt(w * w + x * x + y * y + z * z);
+	if (length > 0.0f) {
+		w /= length, x /= length, y /= length, z /= length;
+	}
+	else {
+		w = 1.0f, x = y = z = 0.0f;
+	}
+	const float inverseWeight = sum.weight > 0.0f ? 1.0f / sum.weight : 0.0f;
+
+	const float rotation[3][3] = {
+		{ 1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y) },
+		{ 2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x) },
+		{ 2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y) },
+	};
+
+	Mat44 local = Mat44::Identity();
+	for (int row = 0; row < 3; ++row) {
+		const float scale = sum.scale[row] * inverseWeight;
+		for (int column = 0; column < 3; ++column) {
+			local(row, column) = rotation[row][column] * scale;
+		}
+		local(3, row) = sum.translation[row] * inverseWeight;
+	}
+	return local;
+}
+
+
+AnimationState::AnimationState(const Skeleton* skeleton) : m_skeleton(skeleton) {}
+
+
+void AnimationState::SetSkeleton(const Skeleton* skeleton) {
+	m_skeleton = skeleton;
+}
+
+
+size_t AnimationState::AddLayer(const AnimationClip* clip, float weight, bool loop) {
+	if (!clip) {
+		throw InvalidArgumentException("Layers must have a clip.");
+	}
+	if (m_skeleton && clip->GetJointCount() != m_skeleton->GetJointCount()) {
+		throw InvalidArgumentException("The clip is not made for the skeleton, joint counts differ.");
+	}
+	Layer layer;
+	layer.clip = clip;
+	layer.weight = weight;
+	layer.loop = loop;
+	m_layers.push_back(layer);
+	return m_layers.size() - 1;
+}
+
+
+void AnimationState::RemoveLayer(size_t index) {
+	if (index >= m_layers.size()) {
+		throw OutOfRangeException("There is no such layer.");
+	}
+	m_layers.erase(m_layers.begin() + index);
+}
+
+
+void AnimationState::ClearLayers() {
+	m_layers.clear();
+}
+
+
+void AnimationState::Advance(float elapsed) {
+	for (Layer& layer : m_layers) {
+		const float duration = layer.clip->GetDuration();
+		layer.time += elapsed * layer.speed;
+		if (layer.loop && duration > 0.0f) {
+			layer.time = std::fmod(layer.time, duration);
+			layer.time += layer.time < 0.0f ? duration : 0.0f;
+		}
+		else {
+			layer.time = std::clamp(layer.time, 0.0f, duration);
+		}
+	}
+}
+
+
+void AnimationState::EvaluatePalette(SkinningMatrix* palette) const {
+	const size_t jointCount = m_skeleton ? m_skeleton->GetJointCount() : 0;
+
+	// Scratch space of the thread, states are evaluated in parallel on the job system.
+	thread_local std::vector<PoseSum> sums;
+	thread_local std::vector<Mat44> worlds;
+	sums.assign(jointCount, PoseSum{});
+	worlds.resize(jointCount);
+
+	// Each layer adds the two frames around its time, weighed by how close they are.
+	for (const Layer& layer : m_layers) {
+		const AnimationClip& clip = *layer.clip;
+		if (clip.GetJointCount() != jointCount || !(layer.weight > 0.0f)) {
+			continue;
+		}
+		const float duration = clip.GetDuration();
+		float time = layer.loop && duration > 0.0f ? std::fmod(layer.time, duration) : std::clamp(layer.time, 0.0f, duration);
+		time += time < 0.0f ? duration : 0.0f;
+
+		const float position = time * clip.GetSampleRate();
+		const size_t lastFrame = clip.GetFrameCount() - 1;
+		const size_t frame0 = std::min(size_t(position), lastFrame);
+		const size_t frame1 = std::min(frame0 + 1, lastFrame);
+		const float fraction = std::clamp(position - float(frame0), 0.0f, 1.0f);
+
+		const AnimationClip::Sample* samples0 = clip.GetFrame(frame0);
+		const AnimationClip::Sample* samples1 = clip.GetFrame(frame1);
+		const float weight0 = layer.weight * (1.0f - fraction);
+		const float weight1 = layer.weight * fraction;
+		for (size_t i = 0; i < jointCount; ++i) {
+			Accumulate(sums[i], samples0[i].rotation, samples0[i].translation, samples0[i].scale, weight0);
+			Accumulate(sums[i], samples1[i].rotation, samples1[i].translation, samples1[i].scale, weight1);
+		}
+	}
+
+	for (size_t i = 0; i < jointCount; ++i) {
+		const Skeleton::Joint& joint = m_skeleton->GetJoint(i);
+
+		// What the layers leave of a unit weight is the rest pose.
+		PoseSum& sum = sums[i];
+		if (sum.weight < 1.0f) {
+			const JointPose& rest = joint.restPose;
+			const float rotation[4] = { rest.rotation.w, rest.rotation.x, rest.rotation.y, rest.rotation.z };
+			const float translation[4] = { rest.translation.x, rest.translation.y, rest.translation.z, 0.0f };
+			const float scale[4] = { rest.scale.x, rest.scale.y, rest.scale.z, 0.0f };
+			Accumulate(sum, rotation, translation, scale, 1.0f - sum.weight);
+		}
+
+		// Parents come first, so their world transform is ready.
+		const Mat44 local = ComposeLocal(sum);
+		worlds[i] = joint.parent >= 0 ? local * worlds[joint.parent] : local;
+
+		const Mat44 skinning = joint.inverseBind * worlds[i];
+		for (int row = 0; row < 3; ++row) {
+			palette[i].rows[row] = Vec4(skinning(0, row), skinning(1, row), skinning(2, row), skinning(3, row));
+		}
+	}
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "BoundingVolumes.hpp"
+#include "VertexCompressor.hpp"
+
+#include <InlineMath.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary> Transform of a joint relative to its parent. </summary>
+struct JointPose {
+	Quat rotation = { 1.0f, 0.0f, 0.0f, 0.0f };
+	Vec3 translation = { 0.0f, 0.0f, 0.0f };
+	Vec3 scale = { 1.0f, 1.0f, 1.0f };
+};
+
+
+/// <summary> Skinning matrix of one joint, the first three columns of the 4x4 matrix transposed. </summary>
+/// <remarks> Takes object space positions of the bind pose to the current pose, the layout the skinning shader reads. </remarks>
+struct SkinningMatrix {
+	Vec4_Packed rows[3];
+};
+
+
+/// <summary> Hierarchy of joints, shared by all skins and animations made for it. </summary>
+class Skeleton {
+public:
+	static constexpr size_t MaxJoints = 256; // Skins index joints with 8 bits.
+
+	struct Joint {
+		int parent = -1; // Index of the parent joint, -1 for roots.
+		Mat44 inverseBind = Mat44::Identity(); // Takes object space to the joint's space in the bind pose.
+		JointPose restPose; // Used by joints no animation moves.
+	};
+
+public:
+	Skeleton() = default;
+	/// <exception cref="InvalidArgumentException"> If a parent does not come before its children, or there are too many joints. </exception>
+	explicit Skeleton(std::vector<Joint> joints);
+
+	size_t GetJointCount() const { return m_joints.size(); }
+	const Joint& GetJoint(size_t index) const { return m_joints[index]; }
+
+private:
+	std::vector<Joint> m_joints;
+};
+
+
+/// <summary> Poses of all joints of a skeleton sampled at a fixed rate. </summary>
+class AnimationClip {
+public:
+	AnimationClip() = default;
+	/// <param name="poses"> The joints of each frame, one frame after the other. </param>
+	/// <exception cref="InvalidArgumentException"> If the poses are not a whole number of frames, or the rate is not positive. </exception>
+	AnimationClip(size_t jointCount, float sampleRate, const std::vector<JointPose>& poses);
+
+	size_t GetJointCount() const { return m_jointCount; }
+	size_t GetFrameCount() const { return m_frameCount; }
+	float GetSampleRate() const { return m_sampleRate; }
+	/// <summary> Time of the last frame, in seconds. </summary>
+	float GetDuration() const;
+
+private:
+	friend class AnimationState;
+
+	// Rotation, translation and scale of a joint, four floats each so that they load into SIMD registers.
+	struct Sample {
+		float rotation[4]; // w, x, y, z
+		float translation[4];
+		float scale[4];
+	};
+	const Sample* GetFrame(size_t frame) const { return m_samples.data() + frame * m_jointCount; }
+
+private:
+	size_t m_jointCount = 0;
+	size_t m_frameCount = 0;
+	float m_sampleRate = 30.0f;
+	std::vector<Sample> m_samples;
+};
+
+
+/// <summary> Binds the vertices of a mesh to the joints of a skeleton. </summary>
+/// <remarks> The skin does not refer to the mesh, it is the entity that pairs them,
+///		see <see cref="MeshEntity::SetAnimation"/>. Vertices are in the order of the mesh's vertex buffer. </remarks>
+class Skin {
+public:
+	struct Influence {
+		std::array<uint8_t, 4> joints = { 0, 0, 0, 0 };
+		Vec4 weights = { 1.0f, 0.0f, 0.0f, 0.0f }; // Normalized when packed.
+	};
+
+public:
+	Skin() = default;
+	/// <param name="poseBounds"> Box around the vertices in all poses the skin is animated into, in object space. </param>
+	Skin(const std::vector<Influence>& influences, const BoundingBox& poseBounds);
+
+	size_t GetVertexCount() const { return m_packed.size() / 2; }
+	/// <summary> Two words per vertex, 8-bit joint indices and 8-bit normalized weights, the layout of the skinning shader. </summary>
+	const std::vector<uint32_t>& GetPacked() const { return m_packed; }
+
+	/// <summary> Culling uses these bounds for the animated entities. </summary>
+	const BoundingBox& GetPoseBounds() const { return m_poseBounds; }
+	/// <summary> Skinned positions are quantized relative to the pose bounds, and clamped to them. </summary>
+	const PositionQuantization& GetPositionQuantization() const { return m_positionQuantization; }
+	/// <summary> Different for every skin ever created, caches of GPU data key on it. </summary>
+	uint64_t GetId() const { return m_id; }
+
+private:
+	std::vector<uint32_t> m_packed;
+	BoundingBox m_poseBounds;
+	PositionQuantization m_positionQuantization;
+	uint64_t m_id = 0;
+};
+
+
+/// <summary> Clips playing on a skeleton, blended together by weight. </summary>
+/// <remarks> Several entities may share a state to move in step, the palette is evaluated once for them all. </remarks>
+class AnimationState {
+public:
+	struct Layer {
+		const AnimationClip* clip = nullptr;
+		float time = 0.0f; // Seconds.
+		float weight = 1.0f;
+		float speed = 1.0f;
+		bool loop = true; // Clips that don't loop stop on their last frame.
+	};
+
+public:
+	explicit AnimationState(const Skeleton* skeleton = nullptr);
+
+	void SetSkeleton(const Skeleton* skeleton);
+	const Skeleton* GetSkeleton() const { return m_skeleton; }
+
+	/// <summary> Adds a clip to blend in, returns the index of its layer. </summary>
+	/// <exception cref="InvalidArgumentException"> If the clip is not of the skeleton's joint count. </exception>
+	size_t AddLayer(const AnimationClip* clip, float weight = 1.0f, bool loop = true);
+	void RemoveLayer(size_t index);
+	void ClearLayers();
+	size_t GetLayerCount() const { return m_layers.size(); }
+	Layer& GetLayer(size_t index) { return m_layers[index]; }
+	const Layer& GetLayer(size_t index) const { return m_layers[index]; }
+
+	/// <summary> Moves the clips forward by their speed. </summary>
+	void Advance(float elapsed);
+
+	/// <summary> Blends the layers into a pose and converts it to skinning matrices, one for each joint. </summary>
+	/// <remarks> Joints are in the rest pose where the layers weigh nothing.
+	///		Only reads the state, so different threads may evaluate states at the same time. </remarks>
+	void EvaluatePalette(SkinningMatrix* palette) const;
+
+private:
+	const Skeleton* m_skeleton;
+	std::vector<Layer> m_layers;
+};
+
+
+} // namespace inl::gxeng
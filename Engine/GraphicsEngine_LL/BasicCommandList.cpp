@@ -1,6 +1,7 @@
 #include "BasicCommandList.hpp"
+#include <algorithm>
 #include <iterator>
-#include "GraphicsApi_D3D12/CommandList.hpp"
+#include "GraphicsApi_LL/ICommandList.hpp"
 
 namespace inl {
 namespace gxeng {
@@ -10,8 +11,10 @@ BasicCommandList::BasicCommandList(gxapi::IGraphicsApi* gxApi,
 								   CommandListPool& commandListPool,
 								   CommandAllocatorPool& commandAllocatorPool,
 								   ScratchSpacePool& scratchSpacePool,
+								   ResourceIndexRegistry& resourceIndices,
 								   gxapi::eCommandListType type
 ) :
+	m_resourceStates(&resourceIndices),
 	m_scratchSpacePool(&scratchSpacePool)
 {
 	// Set gxapi
@@ -26,7 +29,7 @@ BasicCommandList::BasicCommandList(gxapi::IGraphicsApi* gxApi,
 
 	// Create scratch space
 	if (type == gxapi::eCommandListType::COMPUTE || type == gxapi::eCommandListType::GRAPHICS) {
-		NewScratchSpace(1000);
+		NewScratchSpace(0);
 	}
 	else {
 		m_currentScratchSpace = nullptr;
@@ -53,7 +56,13 @@ void BasicCommandList::NewScratchSpace(size_t sizeHint) {
 	}
 
 	assert(m_scratchSpacePool != nullptr);
-	ScratchSpacePtr newScratchSpace = m_scratchSpacePool->RequestScratchSpace();
+	// The list has outgrown its scratch space, doubling keeps the number of switches low.
+	uint32_t minSize = (uint32_t)sizeHint;
+	if (m_currentScratchSpace) {
+		m_retiredScratchSpaceDescriptors += m_currentScratchSpace->GetUsedCount();
+		minSize = std::max(minSize, 2 * m_currentScratchSpace->GetCapacity());
+	}
+	ScratchSpacePtr newScratchSpace = m_scratchSpacePool->RequestScratchSpace(minSize);
 	m_scratchSpaces.push_back(std::move(newScratchSpace));
 	m_currentScratchSpace = m_scratchSpaces.back().get();
 
@@ -63,44 +72,56 @@ void BasicCommandList::NewScratchSpace(size_t sizeHint) {
 
 
 BasicCommandList::BasicCommandList(BasicCommandList&& rhs)
-	: m_resourceTransitions(std::move(rhs.m_resourceTransitions)),
+	: m_resourceStates(std::move(rhs.m_resourceStates)),
+	m_retainedObjects(std::move(rhs.m_retainedObjects)),
 	m_scratchSpacePool(rhs.m_scratchSpacePool),
 	m_commandAllocator(std::move(rhs.m_commandAllocator)),
 	m_commandList(std::move(rhs.m_commandList)),
 	m_scratchSpaces(std::move(rhs.m_scratchSpaces)),
-	m_currentScratchSpace(rhs.m_currentScratchSpace)
+	m_currentScratchSpace(rhs.m_currentScratchSpace),
+	m_retiredScratchSpaceDescriptors(rhs.m_retiredScratchSpaceDescriptors)
 {}
 
 
 BasicCommandList& BasicCommandList::operator=(BasicCommandList&& rhs) {
-	m_resourceTransitions = std::move(rhs.m_resourceTransitions);
+	m_resourceStates = std::move(rhs.m_resourceStates);
 	m_scratchSpacePool = rhs.m_scratchSpacePool;
 	m_commandAllocator = std::move(rhs.m_commandAllocator);
 	m_commandList = std::move(rhs.m_commandList);
 	m_scratchSpaces = std::move(rhs.m_scratchSpaces);
+	m_retainedObjects = std::move(rhs.m_retainedObjects);
 	m_currentScratchSpace = rhs.m_currentScratchSpace;
+	m_retiredScratchSpaceDescriptors = rhs.m_retiredScratchSpaceDescriptors;
 
 	return *this;
 }
 
 
 BasicCommandList::Decomposition BasicCommandList::Decompose() {
+	if (m_currentScratchSpace) {
+		m_scratchSpacePool->ReportUsage(GetPerformanceCounters().numScratchSpaceDescriptors);
+		m_currentScratchSpace = nullptr;
+	}
+
 	Decomposition decomposition;
 	decomposition.commandAllocator = std::move(m_commandAllocator);
 	decomposition.commandList = std::move(m_commandList);
 	decomposition.scratchSpaces = std::move(m_scratchSpaces);
-	decomposition.usedResources.reserve(m_resourceTransitions.size());
 	decomposition.additionalResources = std::move(m_additionalResources);
-
-	// Copy the elements of state transition map to vector w/ transforming types.
-	for (const auto& v : m_resourceTransitions) {
-		decomposition.usedResources.push_back(ResourceUsage{ std::move(v.first.resource), v.first.subresource, v.second.firstState, v.second.lastState, v.second.multipleStates });
-	}
+	decomposition.retainedObjects = std::move(m_retainedObjects);
+	decomposition.usedResources = m_resourceStates.TakeUsages();
 
 	return decomposition;
 }
 
 
+CommandListCounters BasicCommandList::GetPerformanceCounters() const {
+	CommandListCounters counters = m_performanceCounters;
+	counters.numScratchSpaceDescriptors = m_retiredScratchSpaceDescriptors + (m_currentScratchSpace ? m_currentScratchSpace->GetUsedCount() : 0);
+	return counters;
+}
+
+
 void BasicCommandList::BeginDebuggerEvent(const std::string& name) {
 	m_commandList->BeginDebuggerEvent(name);
 }
@@ -8,43 +8,16 @@
 #include "CommandListPool.hpp"
 #include "ScratchSpacePool.hpp"
 #include "HostDescHeap.hpp"
+#include "ResourceStateTracker.hpp"
 
 #include <vector>
 #include <memory>
-#include <unordered_map>
 
 
 
 namespace inl {
 namespace gxeng {
 
-struct SubresourceId {
-	SubresourceId() = default;
-	SubresourceId(const MemoryObject& resource, unsigned subresource) : resource(resource), subresource(subresource) {}
-
-	bool operator==(const SubresourceId& other) const {
-		return resource == other.resource && subresource == other.subresource;
-	}
-
-	MemoryObject resource;
-	unsigned subresource;
-};
-
-struct SubresourceUsageInfo {
-	gxapi::eResourceState firstState; /// <summary> Holds the target state of the first transition. </summary>
-	gxapi::eResourceState lastState; /// <summary> Holds the target state of the last transition. </summary>
-	bool multipleStates; /// <sumamry> True if resource was used in more than one state. </summary>
-};
-
-struct ResourceUsage {
-	MemoryObject resource;
-	unsigned subresource;
-	gxapi::eResourceState firstState;
-	gxapi::eResourceState lastState;
-	bool multipleStates;
-};
-
-
 struct CommandListCounters {
 	size_t numDrawCalls = 0;
 	size_t numKernels = 0;
@@ -52,28 +25,28 @@ struct CommandListCounters {
 };
 
 
+/// <summary> True if lists on a compute queue may transition resources from and to this state. </summary>
+inline bool IsComputeQueueState(gxapi::eResourceState state) {
+	const gxapi::eResourceState computeStates = {
+		gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER,
+		gxapi::eResourceState::UNORDERED_ACCESS,
+		gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE,
+		gxapi::eResourceState::INDIRECT_ARGUMENT,
+		gxapi::eResourceState::COPY_DEST,
+		gxapi::eResourceState::COPY_SOURCE,
+	};
+	return (state - computeStates).Empty();
+}
+
+/// <summary> True if lists on a copy queue may transition resources from and to this state. </summary>
+inline bool IsCopyQueueState(gxapi::eResourceState state) {
+	const gxapi::eResourceState copyStates = {
+		gxapi::eResourceState::COPY_DEST,
+		gxapi::eResourceState::COPY_SOURCE,
+	};
+	return (state - copyStates).Empty();
+}
 
-} // namespace gxeng
-} // namespace inl
-
-
-namespace std {
-
-using namespace inl;
-
-template<>
-struct hash<gxeng::SubresourceId> {
-	std::size_t operator()(const gxeng::SubresourceId& instance) const {
-		return std::hash<const void*>{}(instance.resource._GetResourcePtr()) ^ std::hash<unsigned>{}(instance.subresource);
-	}
-};
-
-} // namespace std
-
-
-
-namespace inl {
-namespace gxeng {
 
 
 class BasicCommandList {
@@ -85,6 +58,7 @@ public:
 		std::vector<ScratchSpacePtr> scratchSpaces;
 		std::vector<ResourceUsage> usedResources;
 		std::vector<MemoryObject> additionalResources;
+		std::vector<std::shared_ptr<const void>> retainedObjects; // Released once the GPU is done with the list.
 	};
 public:
 	BasicCommandList(const BasicCommandList& rhs) = delete; // could be, but big perf hit, better not allow user
@@ -103,13 +77,14 @@ public:
 	void SetName(const std::string& name);
 	void SetName(const char* name);
 
-	const CommandListCounters& GetPerformanceCounters() const { return m_performanceCounters; }
+	CommandListCounters GetPerformanceCounters() const;
 protected:
 	BasicCommandList(
 		gxapi::IGraphicsApi* gxApi,
 		CommandListPool& commandListPool,
 		CommandAllocatorPool& commandAllocatorPool,
 		ScratchSpacePool& scratchSpacePool,
+		ResourceIndexRegistry& resourceIndices,
 		gxapi::eCommandListType type);
 
 	gxapi::ICommandList* GetCommandList() const { return m_commandList.get(); }
@@ -117,8 +92,9 @@ protected:
 	StackDescHeap* GetCurrentScratchSpace();
 	virtual void NewScratchSpace(size_t sizeHint);
 protected:
-	std::unordered_map<SubresourceId, SubresourceUsageInfo> m_resourceTransitions;
+	ResourceStateTracker m_resourceStates;
 	std::vector<MemoryObject> m_additionalResources;
+	std::vector<std::shared_ptr<const void>> m_retainedObjects;
 	gxapi::IGraphicsApi* m_graphicsApi;
 
 	CommandListCounters m_performanceCounters;
@@ -129,7 +105,8 @@ private:
 	CmdAllocPtr m_commandAllocator;
 	CmdListPtr m_commandList;
 	std::vector<ScratchSpacePtr> m_scratchSpaces;
-	StackDescHeap* m_currentScratchSpace;
+	StackDescHeap* m_currentScratchSpace = nullptr;
+	size_t m_retiredScratchSpaceDescriptors = 0; // Used from scratch spaces the list has switched away from.
 };
 
 
@@ -4,6 +4,7 @@
 
 #include "Binder.hpp"
 #include <algorithm>
+#include <limits>
 
 
 namespace inl {
@@ -27,6 +28,14 @@ void Binder::Translate(BindParameter parameter, int & rootParamIndex, int & root
 }
 
 
+BindSlot Binder::Resolve(BindParameter parameter) const {
+	BindSlot slot;
+	slot.binder = this;
+	Translate(parameter, slot.rootParamIndex, slot.rootTableIndex);
+	return slot;
+}
+
+
 void Binder::CalculateLayout(const std::vector<BindParameterDesc>& parameters) {
 	// copy input parameters to mapping
 	m_parameters.reserve(parameters.size());
@@ -34,9 +43,10 @@ void Binder::CalculateLayout(const std::vector<BindParameterDesc>& parameters) {
 	std::vector<std::vector<BindParameterDesc>> tableParams; // goes into descriptor heap (scratch space)
 	std::vector<BindParameterDesc> samplerParams; // samplers are treated separately
 	std::vector<BindParameterDesc> constantParams; // inline constants and inline CBVs
+	std::vector<BindParameterDesc> bindlessParams; // each gets a table pointing at the bindless part of the scratch space
 
 	// put parameters to the right slot/table in the root signature
-	DistributeParameters(parameters, tableParams, samplerParams, constantParams);
+	DistributeParameters(parameters, tableParams, samplerParams, constantParams, bindlessParams);
 
 	// declare root signature desc
 	gxapi::RootSignatureDesc desc;
@@ -120,6 +130,18 @@ void Binder::CalculateLayout(const std::vector<BindParameterDesc>& parameters) {
 
 		++rootParamIndex;
 	}
+	// bindless tables
+	for (const auto& param : bindlessParams) {
+		RootParameterMapping mapping;
+		mapping.bindParam = param.parameter;
+		mapping.rootParamIndex = rootParamIndex++;
+		mapping.rootTableIndex = 0;
+		m_parameters.push_back(mapping);
+
+		desc.rootParameters.push_back(gxapi::RootParameterDesc::DescriptorTable());
+		auto& rootTable = desc.rootParameters.back().As<gxapi::RootParameterDesc::DESCRIPTOR_TABLE>();
+		rootTable.ranges.push_back(gxapi::DescriptorRange{ gxapi::DescriptorRange::SRV, gxapi::DescriptorRange::UNBOUNDED, param.parameter.reg, param.parameter.space, 0 });
+	}
 
 	// radix sort mapping for easy search
 	std::sort(m_parameters.begin(), m_parameters.end(), [](const RootParameterMapping& lhs, const RootParameterMapping& rhs)
@@ -135,12 +157,19 @@ void Binder::CalculateLayout(const std::vector<BindParameterDesc>& parameters) {
 void Binder::DistributeParameters(const std::vector<BindParameterDesc>& parameters,
 								  std::vector<std::vector<BindParameterDesc>> & tableParams,
 								  std::vector<BindParameterDesc> & samplerParams,
-								  std::vector<BindParameterDesc> & constantParams)
+								  std::vector<BindParameterDesc> & constantParams,
+								  std::vector<BindParameterDesc> & bindlessParams)
 {
 	// put SRV's and UAV's into descriptor table: they have so many limitation that inlining them is basically worthless
 	// put samplers into separate list
 	for (const auto& param : parameters) {
-		if (param.parameter.type == eBindParameterType::TEXTURE || param.parameter.type == eBindParameterType::UNORDERED) {
+		if (param.bindless) {
+			if (param.parameter.type != eBindParameterType::TEXTURE) {
+				throw InvalidArgumentException("Only textures can be bindless.");
+			}
+			bindlessParams.push_back(param);
+		}
+		else if (param.parameter.type == eBindParameterType::TEXTURE || param.parameter.type == eBindParameterType::UNORDERED) {
 			if (tableParams.size() == 0) {
 				tableParams.resize(1);
 			}
@@ -154,68 +183,106 @@ void Binder::DistributeParameters(const std::vector<BindParameterDesc>& paramete
 		}
 	}
 
-	// how to compute required number of bytes in root signature
-	auto usedSpace = [&] {
-		int size = 0;
-		//for (const auto& param : parameters) {
-		//	size += ((param.constantSize + 3) / 4 > 0 ? param.constantSize : 8); break; // inline constant size OR 64 bit virtual address
-		//}
-		//size += tableParams.empty() ? 0 : 4; // 32 bits for each descriptor table
-
-		for (const auto& table : tableParams) {
-			size += 4;
-		}
-		for (const auto& constant : constantParams) {
-			size += constant.constantSize > 0 ? ((constant.constantSize + 3) / 4 * 4) : 8;
-		}
-
-		return size;
+	// Constants are placed by a cost model. Root signature space is counted in DWORDs: a descriptor table takes 1,
+	// a root CBV 2, root constants their size. Root constants are set directly on the command list, root CBVs
+	// need a volatile CB, and CBVs in a table need a scratch descriptor copy on top of that.
+	// Constants start at their cheapest placement to bind, then, until the root signature fits, the demotion
+	// that adds the least binding cost per DWORD freed is taken, weighted by the change frequency.
+	enum class ePlacement { ROOT_CONSTANT, ROOT_CBV, TABLE };
+	constexpr float rootConstantBindCost = 1.0f;
+	constexpr float rootCbvBindCost = 2.0f;
+	constexpr float tableBindCost = 4.0f;
+	constexpr int maxDwords = maxSize / (int)sizeof(uint32_t);
+
+	auto dwordCount = [](const BindParameterDesc& param) {
+		return int(param.constantSize + 3) / 4;
 	};
 
+	std::vector<ePlacement> placements;
+	placements.reserve(constantParams.size());
+	for (const auto& param : constantParams) {
+		placements.push_back(dwordCount(param) > 0 ? ePlacement::ROOT_CONSTANT : ePlacement::ROOT_CBV);
+	}
 
-	// sort constant parametes by size, ascending, 0 is considered biggest
-	std::sort(constantParams.begin(), constantParams.end(), [](const BindParameterDesc& lhs, const BindParameterDesc& rhs)
-	{
-		auto lhscmp = lhs.constantSize <= 0 ? std::numeric_limits<decltype(lhs.constantSize)>::max() : lhs.constantSize;
-		auto rhscmp = rhs.constantSize <= 0 ? std::numeric_limits<decltype(rhs.constantSize)>::max() : rhs.constantSize;
-		return lhscmp < rhscmp;
-	});
+	auto hasTable = [&] {
+		return !tableParams.empty() || std::count(placements.begin(), placements.end(), ePlacement::TABLE) > 0;
+	};
+	auto usedSpace = [&] {
+		int size = (int)tableParams.size() + (int)bindlessParams.size();
+		bool constantTable = tableParams.empty() && hasTable(); // table that only holds demoted constants
+		for (size_t i = 0; i < constantParams.size(); ++i) {
+			switch (placements[i]) {
+				case ePlacement::ROOT_CONSTANT: size += dwordCount(constantParams[i]); break;
+				case ePlacement::ROOT_CBV: size += 2; break;
+				case ePlacement::TABLE: break;
+			}
+		}
+		return size + (constantTable ? 1 : 0);
+	};
 
-	// sort constant parametes by change frequency
-	auto largeBegin = constantParams.begin();
-	while (largeBegin != constantParams.end() && largeBegin->constantSize <= 8) {
-		largeBegin++;
-	}
+	while (maxDwords < usedSpace()) {
+		const int tableCost = hasTable() ? 0 : 1;
+		size_t bestIndex = constantParams.size();
+		ePlacement bestPlacement = ePlacement::TABLE;
+		float bestRatio = std::numeric_limits<float>::infinity();
+		float bestExtraCost = 0.0f;
+		int bestFreed = 0;
+
+		for (size_t i = 0; i < constantParams.size(); ++i) {
+			const float weight = std::max(constantParams[i].relativeChangeFrequency, 0.0f);
+			auto consider = [&](ePlacement placement, float extraCost, int freed) {
+				if (freed <= 0) {
+					return;
+				}
+				const float ratio = weight * extraCost / freed;
+				// With equal ratios, e.g. when frequencies are zero, prefer the cheaper binding, then the bigger saving.
+				if (ratio < bestRatio
+					|| (ratio == bestRatio && (extraCost < bestExtraCost || (extraCost == bestExtraCost && freed > bestFreed))))
+				{
+					bestIndex = i;
+					bestPlacement = placement;
+					bestRatio = ratio;
+					bestExtraCost = extraCost;
+					bestFreed = freed;
+				}
+			};
 
-	std::sort(largeBegin, constantParams.end(), [](const BindParameterDesc& lhs, const BindParameterDesc& rhs)
-	{
-		return lhs.relativeChangeFrequency < rhs.relativeChangeFrequency;
-	});
+			if (placements[i] == ePlacement::ROOT_CONSTANT) {
+				const int size = dwordCount(constantParams[i]);
+				consider(ePlacement::ROOT_CBV, rootCbvBindCost - rootConstantBindCost, size - 2);
+				consider(ePlacement::TABLE, tableBindCost - rootConstantBindCost, size - tableCost);
+			}
+			else if (placements[i] == ePlacement::ROOT_CBV) {
+				consider(ePlacement::TABLE, tableBindCost - rootCbvBindCost, 2 - tableCost);
+			}
+		}
 
-	// convert inline constants to CBVs to save space
-	{
-		auto convertIt = constantParams.rbegin();
-		auto endIt = constantParams.rend();
-		while (maxSize < usedSpace() && convertIt != endIt) {
-			convertIt->constantSize = 0;
-			++convertIt;
+		if (bestIndex == constantParams.size()) {
+			throw InvalidArgumentException("Bind parameters do not fit into the root signature.");
 		}
+		placements[bestIndex] = bestPlacement;
 	}
 
-	// throw CBVs into descriptor table until there's enough space
-	{
-		while (maxSize < usedSpace()) {
-			auto constantIt = constantParams.rbegin();
-			auto endIt = constantParams.rend();
-			if (constantIt != endIt) {
-				if (tableParams.size() == 0) {
-					tableParams.resize(1);
-				}
-				tableParams[0].push_back(*constantIt);
-				constantParams.erase(--constantIt.base());
+	// apply placements, root parameters that change most often go first
+	std::vector<BindParameterDesc> rootParams;
+	for (size_t i = 0; i < constantParams.size(); ++i) {
+		if (placements[i] == ePlacement::TABLE) {
+			if (tableParams.size() == 0) {
+				tableParams.resize(1);
 			}
+			tableParams[0].push_back(constantParams[i]);
+			continue;
+		}
+		rootParams.push_back(constantParams[i]);
+		if (placements[i] == ePlacement::ROOT_CBV) {
+			rootParams.back().constantSize = 0;
 		}
 	}
+	std::stable_sort(rootParams.begin(), rootParams.end(), [](const BindParameterDesc& lhs, const BindParameterDesc& rhs)
+	{
+		return lhs.relativeChangeFrequency > rhs.relativeChangeFrequency;
+	});
+	constantParams = std::move(rootParams);
 }
 
 
@@ -46,25 +46,38 @@ struct BindParameter {
 	unsigned reg; // register
 	unsigned space; // register space
 
-	bool operator==(const BindParameter& rhs) {
+	bool operator==(const BindParameter& rhs) const {
 		return type == rhs.type && reg == rhs.reg && space == rhs.space;
 	}
-	bool operator!=(const BindParameter& rhs) {
+	bool operator!=(const BindParameter& rhs) const {
 		return !(*this == rhs);
 	}
 };
 
 
+/// <summary>
+/// A bind parameter already looked up in the root signature of a <see cref="Binder"/>, see <see cref="Binder::Resolve"/>.
+/// </summary>
+/// <remarks> Binding through slots skips the search of the parameter, resolve them once when the binder is created.
+///		A slot is only valid with the binder that resolved it, and only as long as that binder is not moved. </remarks>
+struct BindSlot {
+	const Binder* binder = nullptr;
+	int rootParamIndex = -1;
+	int rootTableIndex = -1; // -1 if the root parameter is not a descriptor table.
+};
+
+
 /// <summary>
 /// Used to construct a Binder object.
 /// You can (and have to) specify other things besides the register.
 /// </summary>
 struct BindParameterDesc {
 	BindParameter parameter; /// <summary> Target register. </summary>
-	unsigned constantSize = 0; /// <summary> Size of constant in bytes. Set to zero if unknown. </summary>
+	unsigned constantSize = 0; /// <summary> Size of constant in bytes. Set to zero if unknown, such constants can't be root constants. </summary>
 	float relativeAccessFrequency = 1; /// <summary> Not used currently. TODO: Read more about this aspect. </summary>
-	float relativeChangeFrequency = 1; /// <summary> How often will you change this binding relative to others. Absolute value does not matter. </summary>
+	float relativeChangeFrequency = 1; /// <summary> How often will you change this binding relative to others. Absolute value does not matter. Constants that change more often keep the cheaper root placements. </summary>
 	gxapi::eShaderVisiblity shaderVisibility = gxapi::eShaderVisiblity::ALL;
+	bool bindless = false; /// <summary> An unbounded texture array over the bindless heap. Nothing is bound to it, shaders index it with <see cref="Image::GetBindlessIndex"/>. </summary>
 };
 
 
@@ -100,6 +113,10 @@ public:
 	/// <param name="rootTableIndex"> If the above record is a descriptor table, the index in the table. Otherwise undefined. </param>
 	void Translate(BindParameter parameter, int& rootParamIndex, int& rootTableIndex) const;
 
+	/// <summary> Looks up where in the root signature the specified parameter lies, for binding it many times. </summary>
+	/// <exception cref="OutOfRangeException"> If the binder has no such parameter. </exception>
+	BindSlot Resolve(BindParameter parameter) const;
+
 	/// <summary> Return the underlying root signature object. </summary>
 	gxapi::IRootSignature* GetRootSignature() const { return m_rootSignature.get(); }
 
@@ -114,7 +131,8 @@ private:
 	void DistributeParameters(const std::vector<BindParameterDesc>& parameters,
 		std::vector<std::vector<BindParameterDesc>> & tableParams,
 		std::vector<BindParameterDesc> & samplerParams,
-		std::vector<BindParameterDesc> & constantParams);
+		std::vector<BindParameterDesc> & constantParams,
+		std::vector<BindParameterDesc> & bindlessParams);
 	gxapi::DescriptorRange::eType CastRangeType(eBindParameterType source);
 
 	std::pair<std::vector<RootParameterMapping>::const_iterator, bool> FindMapping(BindParameter param) const;
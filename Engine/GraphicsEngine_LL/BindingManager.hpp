@@ -32,20 +32,24 @@ public:
 
 	using RootTableManager<Type>::GetDescriptorCounter;
 
-	void Bind(BindParameter parameter, const TextureView1D& shaderResource);
-	void Bind(BindParameter parameter, const TextureView2D& shaderResource);
-	void Bind(BindParameter parameter, const TextureView3D& shaderResource);
-	void Bind(BindParameter parameter, const TextureViewCube& shaderResource);
-	void Bind(BindParameter parameter, const ConstBufferView& shaderConstant);
+	/// <summary> Looks up the parameter in the current binder. </summary>
+	BindSlot Resolve(BindParameter parameter) const;
+
+	void Bind(BindSlot slot, const TextureView1D& shaderResource);
+	void Bind(BindSlot slot, const TextureView2D& shaderResource);
+	void Bind(BindSlot slot, const TextureView3D& shaderResource);
+	void Bind(BindSlot slot, const TextureViewCube& shaderResource);
+	void Bind(BindSlot slot, const BufferView& shaderResource);
+	void Bind(BindSlot slot, const ConstBufferView& shaderConstant);
 
 	//! Offset was removed because:
 	//! When implicitly creating a CBV to accomodate data, previously set bytes cannot be retrieved, thus bytes before offset cannot be defined.
-	void Bind(BindParameter parameter, const void* shaderConstant, int size/*, int offset*/);
+	void Bind(BindSlot slot, const void* shaderConstant, int size/*, int offset*/);
 
-	void Bind(BindParameter parameter, const RWTextureView1D& rwResource);
-	void Bind(BindParameter parameter, const RWTextureView2D& rwResource);
-	void Bind(BindParameter parameter, const RWTextureView3D& rwResource);
-	void Bind(BindParameter parameter, const RWBufferView& rwResource);
+	void Bind(BindSlot slot, const RWTextureView1D& rwResource);
+	void Bind(BindSlot slot, const RWTextureView2D& rwResource);
+	void Bind(BindSlot slot, const RWTextureView3D& rwResource);
+	void Bind(BindSlot slot, const RWBufferView& rwResource);
 protected:
 	void SetRootConstants(gxapi::IGraphicsCommandList* list, unsigned parameterIndex, unsigned destOffset, unsigned numValues, const uint32_t* value);
 	void SetRootConstants(gxapi::IComputeCommandList* list, unsigned parameterIndex, unsigned destOffset, unsigned numValues, const uint32_t* value);
@@ -53,8 +57,9 @@ protected:
 	void SetRootConstantBuffer(gxapi::IComputeCommandList* list, unsigned parameterIndex, void* gpuVirtualAddress);
 
 private:
-	void BindTexture(BindParameter parameter, gxapi::DescriptorHandle handle);
-	void BindUav(BindParameter parameter, gxapi::DescriptorHandle handle);
+	void CheckSlot(BindSlot slot) const;
+	void BindTexture(BindSlot slot, gxapi::DescriptorHandle handle);
+	void BindUav(BindSlot slot, gxapi::DescriptorHandle handle);
 private:
 	MemoryManager* m_memoryManager;
 	VolatileViewHeap* m_volatileCbvHeap;
@@ -73,39 +78,57 @@ BindingManager<Type>::BindingManager(gxapi::IGraphicsApi* graphicsApi, CommandLi
 
 
 template <gxapi::eCommandListType Type>
-void BindingManager<Type>::Bind(BindParameter parameter, const TextureView1D& shaderResource) {
-	return BindTexture(parameter, shaderResource.GetHandle());
+BindSlot BindingManager<Type>::Resolve(BindParameter parameter) const {
+	assert(m_binder != nullptr);
+	return m_binder->Resolve(parameter); // may throw out of range
 }
 
 
 template <gxapi::eCommandListType Type>
-void BindingManager<Type>::Bind(BindParameter parameter, const TextureView2D& shaderResource) {
-	return BindTexture(parameter, shaderResource.GetHandle());
+void BindingManager<Type>::CheckSlot(BindSlot slot) const {
+	assert(m_binder != nullptr);
+	if (slot.binder != m_binder) {
+		throw InvalidArgumentException("Bind slot was resolved by another binder than the current one.");
+	}
 }
 
 
 template <gxapi::eCommandListType Type>
-void BindingManager<Type>::Bind(BindParameter parameter, const TextureView3D& shaderResource) {
-	return BindTexture(parameter, shaderResource.GetHandle());
+void BindingManager<Type>::Bind(BindSlot slot, const TextureView1D& shaderResource) {
+	return BindTexture(slot, shaderResource.GetHandle());
 }
 
+
 template <gxapi::eCommandListType Type>
-void BindingManager<Type>::Bind(BindParameter parameter, const TextureViewCube& shaderResource) {
-	return BindTexture(parameter, shaderResource.GetHandle());
+void BindingManager<Type>::Bind(BindSlot slot, const TextureView2D& shaderResource) {
+	return BindTexture(slot, shaderResource.GetHandle());
 }
 
 
 template <gxapi::eCommandListType Type>
-void BindingManager<Type>::BindTexture(BindParameter parameter, gxapi::DescriptorHandle handle) {
-	assert(m_binder != nullptr);
+void BindingManager<Type>::Bind(BindSlot slot, const TextureView3D& shaderResource) {
+	return BindTexture(slot, shaderResource.GetHandle());
+}
+
+template <gxapi::eCommandListType Type>
+void BindingManager<Type>::Bind(BindSlot slot, const TextureViewCube& shaderResource) {
+	return BindTexture(slot, shaderResource.GetHandle());
+}
+
+template <gxapi::eCommandListType Type>
+void BindingManager<Type>::Bind(BindSlot slot, const BufferView& shaderResource) {
+	return BindTexture(slot, shaderResource.GetHandle());
+}
+
 
-	int slot, tableIndex;
+template <gxapi::eCommandListType Type>
+void BindingManager<Type>::BindTexture(BindSlot slot, gxapi::DescriptorHandle handle) {
+	CheckSlot(slot);
 	const gxapi::RootSignatureDesc& desc = m_binder->GetRootSignatureDesc();
-	m_binder->Translate(parameter, slot, tableIndex);
-	const auto& rootParam = desc.rootParameters[slot];
+	const auto& rootParam = desc.rootParameters[slot.rootParamIndex];
 
 	if (rootParam.type == gxapi::RootParameterDesc::DESCRIPTOR_TABLE) {
-		UpdateBinding(handle, slot, tableIndex);
+		UpdateBinding(handle, slot.rootParamIndex, slot.rootTableIndex);
 	}
 	else {
 		throw InvalidArgumentException("Parameter is not an SRV.");
@@ -114,19 +137,16 @@ void BindingManager<Type>::BindTexture(BindParameter parameter, gxapi::Descripto
 
 
 template <gxapi::eCommandListType Type>
-void BindingManager<Type>::Bind(BindParameter parameter, const ConstBufferView& shaderConstant) {
-	assert(m_binder != nullptr);
-
-	int slot, tableIndex;
+void BindingManager<Type>::Bind(BindSlot slot, const ConstBufferView& shaderConstant) {
+	CheckSlot(slot);
 	const gxapi::RootSignatureDesc& desc = m_binder->GetRootSignatureDesc();
-	m_binder->Translate(parameter, slot, tableIndex);
-	const auto& rootParam = desc.rootParameters[slot];
+	const auto& rootParam = desc.rootParameters[slot.rootParamIndex];
 
 	if (rootParam.type == gxapi::RootParameterDesc::CBV) {
-		SetRootConstantBuffer(m_commandList, slot, shaderConstant.GetResource().GetVirtualAddress());
+		SetRootConstantBuffer(m_commandList, slot.rootParamIndex, shaderConstant.GetResource().GetVirtualAddress());
 	}
 	else if (rootParam.type == gxapi::RootParameterDesc::DESCRIPTOR_TABLE) {
-		UpdateBinding(shaderConstant.GetHandle(), slot, tableIndex);
+		UpdateBinding(shaderConstant.GetHandle(), slot.rootParamIndex, slot.rootTableIndex);
 	}
 	else {
 		throw InvalidArgumentException("Parameter is not a CBV.");
@@ -135,27 +155,24 @@ void BindingManager<Type>::Bind(BindParameter parameter, const ConstBufferView&
 
 
 template <gxapi::eCommandListType Type>
-void BindingManager<Type>::Bind(BindParameter parameter, const void* shaderConstant, int size /*, int offset*/) {
+void BindingManager<Type>::Bind(BindSlot slot, const void* shaderConstant, int size /*, int offset*/) {
 	if (size % 4 != 0) {
 		throw InvalidArgumentException("Size must be a multiple of 4.");
 	}
-	assert(m_binder != nullptr);
-
-	int slot;
-	int tableIndex;
+	CheckSlot(slot);
 	const gxapi::RootSignatureDesc& desc = m_binder->GetRootSignatureDesc();
-	m_binder->Translate(parameter, slot, tableIndex); // may throw out of range
+	const auto& rootParam = desc.rootParameters[slot.rootParamIndex];
 
-	if (desc.rootParameters[slot].type == gxapi::RootParameterDesc::CONSTANT) {
-		assert(desc.rootParameters[slot].As<gxapi::RootParameterDesc::CONSTANT>().numConstants >= unsigned(size /*+ offset*/) / 4);
-		SetRootConstants(m_commandList, slot, /*offset*/0, size / 4, reinterpret_cast<const uint32_t*>(shaderConstant));
+	if (rootParam.type == gxapi::RootParameterDesc::CONSTANT) {
+		assert(rootParam.As<gxapi::RootParameterDesc::CONSTANT>().numConstants >= unsigned(size /*+ offset*/) / 4);
+		SetRootConstants(m_commandList, slot.rootParamIndex, /*offset*/0, size / 4, reinterpret_cast<const uint32_t*>(shaderConstant));
 	}
-	else if (desc.rootParameters[slot].type == gxapi::RootParameterDesc::CBV) {
+	else if (rootParam.type == gxapi::RootParameterDesc::CBV) {
 		// we have to create a volatile CB right here, to accomodate immediate arguments which don't fit in root signature
 		VolatileConstBuffer cbuffer = m_memoryManager->CreateVolatileConstBuffer(shaderConstant, size);
-		SetRootConstantBuffer(m_commandList, slot, cbuffer.GetVirtualAddress());
+		SetRootConstantBuffer(m_commandList, slot.rootParamIndex, cbuffer.GetVirtualAddress());
 	}
-	else if (desc.rootParameters[slot].type == gxapi::RootParameterDesc::DESCRIPTOR_TABLE) {
+	else if (rootParam.type == gxapi::RootParameterDesc::DESCRIPTOR_TABLE) {
 		// we have to create a CBV, and add it to the descriptor table
 		VolatileConstBuffer cbuffer = m_memoryManager->CreateVolatileConstBuffer(shaderConstant, size);
 		gxapi::DescriptorHandle cbv = m_volatileCbvHeap->Allocate();
@@ -163,6 +180,7 @@ void BindingManager<Type>::Bind(BindParameter parameter, const void* shaderConst
 		desc.gpuVirtualAddress = cbuffer.GetVirtualAddress();
 		desc.sizeInBytes = size;
 		m_graphicsApi->CreateConstantBufferView(desc, cbv);
+		UpdateBinding(cbv, slot.rootParamIndex, slot.rootTableIndex);
 	}
 	else {
 		throw InvalidArgumentException("Parameter is not an inline constant.");
@@ -172,16 +190,13 @@ void BindingManager<Type>::Bind(BindParameter parameter, const void* shaderConst
 
 
 template <gxapi::eCommandListType Type>
-void BindingManager<Type>::BindUav(BindParameter parameter, gxapi::DescriptorHandle handle) {
-	assert(m_binder != nullptr);
-
-	int slot, tableIndex;
+void BindingManager<Type>::BindUav(BindSlot slot, gxapi::DescriptorHandle handle) {
+	CheckSlot(slot);
 	const gxapi::RootSignatureDesc& desc = m_binder->GetRootSignatureDesc();
-	m_binder->Translate(parameter, slot, tableIndex);
-	const auto& rootParam = desc.rootParameters[slot];
+	const auto& rootParam = desc.rootParameters[slot.rootParamIndex];
 
 	if (rootParam.type == gxapi::RootParameterDesc::DESCRIPTOR_TABLE) {
-		UpdateBinding(handle, slot, tableIndex);
+		UpdateBinding(handle, slot.rootParamIndex, slot.rootTableIndex);
 	}
 	else {
 		throw InvalidArgumentException("Parameter is not an UAV.");
@@ -189,23 +204,23 @@ void BindingManager<Type>::BindUav(BindParameter parameter, gxapi::DescriptorHan
 }
 
 template <gxapi::eCommandListType Type>
-void BindingManager<Type>::Bind(BindParameter parameter, const RWTextureView1D& rwResource) {
-	return BindUav(parameter, rwResource.GetHandle());
+void BindingManager<Type>::Bind(BindSlot slot, const RWTextureView1D& rwResource) {
+	return BindUav(slot, rwResource.GetHandle());
 }
 
 template <gxapi::eCommandListType Type>
-void BindingManager<Type>::Bind(BindParameter parameter, const RWTextureView2D& rwResource) {
-	return BindUav(parameter, rwResource.GetHandle());
+void BindingManager<Type>::Bind(BindSlot slot, const RWTextureView2D& rwResource) {
+	return BindUav(slot, rwResource.GetHandle());
 }
 
 template <gxapi::eCommandListType Type>
-void BindingManager<Type>::Bind(BindParameter parameter, const RWTextureView3D& rwResource) {
-	return BindUav(parameter, rwResource.GetHandle());
+void BindingManager<Type>::Bind(BindSlot slot, const RWTextureView3D& rwResource) {
+	return BindUav(slot, rwResource.GetHandle());
 }
 
 template <gxapi::eCommandListType Type>
-void BindingManager<Type>::Bind(BindParameter parameter, const RWBufferView& rwResource) {
-	return BindUav(parameter, rwResource.GetHandle());
+void BindingManager<Type>::Bind(BindSlot slot, const RWBufferView& rwResource) {
+	return BindUav(slot, rwResource.GetHandle());
 }
 
 
@@ -0,0 +1,102 @@
+#include "BindlessHeap.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+
+namespace inl::gxeng {
+
+
+BindlessIndexAllocator::BindlessIndexAllocator(uint32_t capacity)
+	: m_capacity(capacity) {}
+
+
+uint32_t BindlessIndexAllocator::Allocate() {
+	if (!m_free.empty()) {
+		uint32_t index = m_free.back();
+		m_free.pop_back();
+		return index;
+	}
+	if (m_highWaterMark >= m_capacity) {
+		throw OutOfMemoryException("Bindless heap is full.");
+	}
+	return m_highWaterMark++;
+}
+
+
+void BindlessIndexAllocator::Free(uint32_t index) {
+	assert(index < m_highWaterMark);
+	m_retired.push_back({ index, m_frame });
+}
+
+
+void BindlessIndexAllocator::BeginFrame() {
+	++m_frame;
+
+	auto reusable = std::stable_partition(m_retired.begin(), m_retired.end(), [this](const Retired& retired) {
+		return retired.frame + ReuseLatency > m_frame;
+	});
+	if (reusable == m_retired.end()) {
+		return;
+	}
+	for (auto it = reusable; it != m_retired.end(); ++it) {
+		m_free.push_back(it->index);
+	}
+	m_retired.erase(reusable, m_retired.end());
+	std::sort(m_free.begin(), m_free.end(), std::greater<>{});
+}
+
+
+
+BindlessHeap::BindlessHeap(gxapi::IGraphicsApi* graphicsApi, uint32_t capacity)
+	: m_graphicsApi(graphicsApi),
+	  m_heap(graphicsApi->CreateDescriptorHeap({ gxapi::eDescriptorHeapType::CBV_SRV_UAV, capacity, false })),
+	  m_allocator(capacity) {}
+
+
+uint32_t BindlessHeap::Register(gxapi::DescriptorHandle view) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	uint32_t index = m_allocator.Allocate();
+	m_graphicsApi->CopyDescriptors(view, m_heap->At(index), 1, gxapi::eDescriptorHeapType::CBV_SRV_UAV);
+	++m_version;
+	return index;
+}
+
+
+void BindlessHeap::Update(uint32_t index, gxapi::DescriptorHandle view) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	assert(index < m_allocator.GetHighWaterMark());
+	m_graphicsApi->CopyDescriptors(view, m_heap->At(index), 1, gxapi::eDescriptorHeapType::CBV_SRV_UAV);
+	++m_version;
+}
+
+
+void BindlessHeap::Unregister(uint32_t index) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	m_allocator.Free(index); // Descriptor stays in place, mirrors don't have to be updated.
+}
+
+
+void BindlessHeap::BeginFrame() {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	m_allocator.BeginFrame();
+}
+
+
+void BindlessHeap::CopyTo(gxapi::DescriptorHandle destination, uint64_t& version) const {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	if (version == m_version) {
+		return;
+	}
+	uint32_t count = m_allocator.GetHighWaterMark();
+	if (count > 0) {
+		m_graphicsApi->CopyDescriptors(m_heap->At(0), destination, count, gxapi::eDescriptorHeapType::CBV_SRV_UAV);
+	}
+	version = m_version;
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <GraphicsApi_LL/IDescriptorHeap.hpp>
+#include <GraphicsApi_LL/IGraphicsApi.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary>
+/// Hands out indices into a fixed size descriptor table.
+/// Freed indices are reused only a few frames later, when the GPU can no longer use the old descriptor.
+/// </summary>
+class BindlessIndexAllocator {
+public:
+	static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+	static constexpr uint64_t ReuseLatency = 3; // More than the frames in flight.
+
+public:
+	explicit BindlessIndexAllocator(uint32_t capacity);
+
+	/// <summary> Returns the lowest free index. </summary>
+	/// <exception cref="OutOfMemoryException"> If all indices are taken. </exception>
+	uint32_t Allocate();
+
+	/// <summary> Returns the index to the allocator, it is handed out again after <see cref="ReuseLatency"/> frames. </summary>
+	void Free(uint32_t index);
+
+	/// <summary> Advances the frame counter, releasing indices freed long enough ago. </summary>
+	void BeginFrame();
+
+	uint32_t GetCapacity() const { return m_capacity; }
+	/// <summary> One past the largest index ever handed out. </summary>
+	uint32_t GetHighWaterMark() const { return m_highWaterMark; }
+
+private:
+	struct Retired {
+		uint32_t index;
+		uint64_t frame;
+	};
+
+	uint32_t m_capacity;
+	uint32_t m_highWaterMark = 0;
+	uint64_t m_frame = 0;
+	std::vector<uint32_t> m_free; // Sorted descending, lowest index at the back.
+	std::vector<Retired> m_retired;
+};
+
+
+/// <summary>
+/// Keeps a shader resource view of every image at a stable index, so that shaders can
+/// select textures by an index passed in constants instead of binding them one by one.
+/// </summary>
+/// <remarks> Only one shader visible CBV_SRV_UAV heap can be bound at a time, so this heap is not
+///		shader visible. Instead, the first descriptors of each scratch space mirror it,
+///		see <see cref="StackDescHeap::GetBindlessTable"/>. Thread safe. </remarks>
+class BindlessHeap {
+public:
+	BindlessHeap(gxapi::IGraphicsApi* graphicsApi, uint32_t capacity);
+
+	/// <summary> Copies the view to a free index and returns the index. </summary>
+	uint32_t Register(gxapi::DescriptorHandle view);
+
+	/// <summary> Replaces the view at the index, e.g. when the image is reallocated. </summary>
+	void Update(uint32_t index, gxapi::DescriptorHandle view);
+
+	/// <summary> Frees the index, the view must not be used by shaders recorded from now on. </summary>
+	void Unregister(uint32_t index);
+
+	/// <summary> Call once per frame before recording command lists. </summary>
+	void BeginFrame();
+
+	/// <summary> Copies the occupied part of the heap to the destination if it has changed since <paramref name="version"/>. </summary>
+	/// <param name="destination"> Start of at least <see cref="GetCapacity"/> descriptors. </param>
+	/// <param name="version"> The version the destination holds, updated to the current version. </param>
+	void CopyTo(gxapi::DescriptorHandle destination, uint64_t& version) const;
+
+	uint32_t GetCapacity() const { return m_allocator.GetCapacity(); }
+
+private:
+	gxapi::IGraphicsApi* m_graphicsApi;
+	std::unique_ptr<gxapi::IDescriptorHeap> m_heap;
+	BindlessIndexAllocator m_allocator;
+	uint64_t m_version = 1; // Mirrors start from 0, so they are copied first time.
+	mutable std::mutex m_mtx;
+};
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,350 @@
+#pragma once
+
+#include "BoundingVolumes.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary>
+/// Dynamic bounding volume hierarchy over axis aligned boxes.
+/// Each leaf holds a value of type T and a box slightly larger than the one given,
+/// so that small movements don't change the tree.
+/// </summary>
+/// <remarks> Leaves are inserted at the sibling that grows the total surface area the least,
+///		and the tree is kept balanced by rotations, so queries are logarithmic in the number of leaves.
+///		Leaf ids remain valid until the leaf is removed. </remarks>
+template <class T>
+class BoundingVolumeHierarchy {
+	static constexpr int NullNode = -1;
+	static constexpr int MaxQueryDepth = 64;
+
+	struct Node {
+		BoundingBox bounds;
+		int parent = NullNode; // Next free node when the node is unused.
+		int child1 = NullNode;
+		int child2 = NullNode;
+		int height = 0; // Leaves are 0, unused nodes are -1.
+		T value{};
+
+		bool IsLeaf() const { return child1 == NullNode; }
+	};
+public:
+	/// <param name="margin"> Leaf boxes are inflated by this fraction of their size. </param>
+	BoundingVolumeHierarchy(float margin = 0.1f) : m_margin(margin) {}
+
+	/// <summary> Adds a new leaf to the tree. </summary>
+	/// <returns> The id of the new leaf. </returns>
+	int Insert(const BoundingBox& bounds, T value);
+
+	/// <summary> Removes a leaf previously returned by <see cref="Insert"/>. </summary>
+	void Remove(int leaf);
+
+	/// <summary> Updates the box of a leaf. </summary>
+	/// <returns> True if the leaf had to be reinserted, false if the new box still fits in the inflated one. </returns>
+	bool Move(int leaf, const BoundingBox& bounds);
+
+	const T& GetValue(int leaf) const { return m_nodes[leaf].value; }
+	/// <summary> The inflated box of the leaf, which is what queries test against. </summary>
+	const BoundingBox& GetBounds(int leaf) const { return m_nodes[leaf].bounds; }
+
+	/// <summary> Calls <paramref name="func"/> with the value of each leaf whose box overlaps the volume. </summary>
+	/// <param name="volume"> Any type with a <c>Classify(const BoundingBox&amp;)</c> method returning <see cref="eContainment"/>. </param>
+	/// <remarks> Subtrees entirely inside the volume are reported without further tests. </remarks>
+	template <class Volume, class Func>
+	void Query(const Volume& volume, Func&& func) const;
+
+	size_t Size() const { return m_numLeaves; }
+	bool IsEmpty() const { return m_numLeaves == 0; }
+	int GetHeight() const { return m_root == NullNode ? 0 : m_nodes[m_root].height; }
+	void Clear();
+private:
+	int AllocateNode();
+	void FreeNode(int node);
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+	void Refit(int node);
+	int Balance(int node);
+private:
+	std::vector<Node> m_nodes;
+	int m_root = NullNode;
+	int m_freeList = NullNode;
+	size_t m_numLeaves = 0;
+	float m_margin;
+};
+
+
+
+template <class T>
+int BoundingVolumeHierarchy<T>::Insert(const BoundingBox& bounds, T value) {
+	int leaf = AllocateNode();
+	m_nodes[leaf].bounds = bounds.Inflated(bounds.GetExtent() * m_margin);
+	m_nodes[leaf].value = std::move(value);
+	m_nodes[leaf].height = 0;
+	InsertLeaf(leaf);
+	++m_numLeaves;
+	return leaf;
+}
+
+
+template <class T>
+void BoundingVolumeHierarchy<T>::Remove(int leaf) {
+	assert(0 <= leaf && leaf < (int)m_nodes.size() && m_nodes[leaf].IsLeaf() && m_nodes[leaf].height == 0);
+	RemoveLeaf(leaf);
+	FreeNode(leaf);
+	--m_numLeaves;
+}
+
+
+template <class T>
+bool BoundingVolumeHierarchy<T>::Move(int leaf, const BoundingBox& bounds) {
+	assert(0 <= leaf && leaf < (int)m_nodes.size() && m_nodes[leaf].IsLeaf() && m_nodes[leaf].height == 0);
+	if (m_nodes[leaf].bounds.Contains(bounds)) {
+		return false;
+	}
+
+	RemoveLeaf(leaf);
+	m_nodes[leaf].bounds = bounds.Inflated(bounds.GetExtent() * m_margin);
+	InsertLeaf(leaf);
+	return true;
+}
+
+
+template <class T>
+template <class Volume, class Func>
+void BoundingVolumeHierarchy<T>::Query(const Volume& volume, Func&& func) const {
+	if (m_root == NullNode) {
+		return;
+	}
+
+	// Balancing keeps the height well below the stack size for any realistic number of leaves.
+	struct StackEntry {
+		int node;
+		bool inside; // Parent was entirely inside the volume, no need to test.
+	};
+	StackEntry stack[MaxQueryDepth];
+	int stackSize = 0;
+	stack[stackSize++] = { m_root, false };
+	while (stackSize > 0) {
+		StackEntry entry = stack[--stackSize];
+		const Node& node = m_nodes[entry.node];
+		eContainment containment = entry.inside ? eContainment::INSIDE : volume.Classify(node.bounds);
+		if (containment == eContainment::OUTSIDE) {
+			continue;
+		}
+		if (node.IsLeaf()) {
+			func(node.value);
+		}
+		else {
+			assert(stackSize + 2 <= MaxQueryDepth);
+			bool inside = containment == eContainment::INSIDE;
+			stack[stackSize++] = { node.child2, inside };
+			stack[stackSize++] = { node.child1, inside };
+		}
+	}
+}
+
+
+template <class T>
+void BoundingVolumeHierarchy<T>::Clear() {
+	m_nodes.clear();
+	m_root = NullNode;
+	m_freeList = NullNode;
+	m_numLeaves = 0;
+}
+
+
+template <class T>
+int BoundingVolumeHierarchy<T>::AllocateNode() {
+	if (m_freeList == NullNode) {
+		m_nodes.emplace_back();
+		return int(m_nodes.size() - 1);
+	}
+	int node = m_freeList;
+	m_freeList = m_nodes[node].parent;
+	m_nodes[node] = Node{};
+	return node;
+}
+
+
+template <class T>
+void BoundingVolumeHierarchy<T>::FreeNode(int node) {
+	m_nodes[node] = Node{};
+	m_nodes[node].parent = m_freeList;
+	m_nodes[node].height = -1;
+	m_freeList = node;
+}
+
+
+template <class T>
+void BoundingVolumeHierarchy<T>::InsertLeaf(int leaf) {
+	if (m_root == NullNode) {
+		m_root = leaf;
+		m_nodes[leaf].parent = NullNode;
+		return;
+	}
+
+	// Descend towards the sibling that is cheapest to pair with, by surface area.
+	const BoundingBox leafBounds = m_nodes[leaf].bounds;
+	int index = m_root;
+	while (!m_nodes[index].IsLeaf()) {
+		const Node& node = m_nodes[index];
+		float area = node.bounds.GetSurfaceArea();
+		float combinedArea = BoundingBox::Union(node.bounds, leafBounds).GetSurfaceArea();
+
+		// Cost of making a new parent for this node and the leaf, and the cost pushed onto children otherwise.
+		float cost = 2.0f * combinedArea;
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto childCost = [&](int child) {
+			const Node& childNode = m_nodes[child];
+			float childCombinedArea = BoundingBox::Union(childNode.bounds, leafBounds).GetSurfaceArea();
+			return childNode.IsLeaf()
+				? childCombinedArea + inheritanceCost
+				: childCombinedArea - childNode.bounds.GetSurfaceArea() + inheritanceCost;
+		};
+		float cost1 = childCost(node.child1);
+		float cost2 = childCost(node.child2);
+
+		if (cost < cost1 && cost < cost2) {
+			break;
+		}
+		index = cost1 < cost2 ? node.child1 : node.child2;
+	}
+	int sibling = index;
+
+	// Make a new parent for the leaf and its sibling.
+	int oldParent = m_nodes[sibling].parent;
+	int newParent = AllocateNode();
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].bounds = BoundingBox::Union(leafBounds, m_nodes[sibling].bounds);
+	m_nodes[newParent].height = m_nodes[sibling].height + 1;
+	m_nodes[newParent].child1 = sibling;
+	m_nodes[newParent].child2 = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if (oldParent == NullNode) {
+		m_root = newParent;
+	}
+	else if (m_nodes[oldParent].child1 == sibling) {
+		m_nodes[oldParent].child1 = newParent;
+	}
+	else {
+		m_nodes[oldParent].child2 = newParent;
+	}
+
+	Refit(m_nodes[leaf].parent);
+}
+
+
+template <class T>
+void BoundingVolumeHierarchy<T>::RemoveLeaf(int leaf) {
+	if (leaf == m_root) {
+		m_root = NullNode;
+		return;
+	}
+
+	// The parent is removed too, the sibling takes its place.
+	int parent = m_nodes[leaf].parent;
+	int grandParent = m_nodes[parent].parent;
+	int sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+	if (grandParent == NullNode) {
+		m_root = sibling;
+		m_nodes[sibling].parent = NullNode;
+	}
+	else {
+		if (m_nodes[grandParent].child1 == parent) {
+			m_nodes[grandParent].child1 = sibling;
+		}
+		else {
+			m_nodes[grandParent].child2 = sibling;
+		}
+		m_nodes[sibling].parent = grandParent;
+		Refit(grandParent);
+	}
+	FreeNode(parent);
+	m_nodes[leaf].parent = NullNode;
+}
+
+
+template <class T>
+void BoundingVolumeHierarchy<T>::Refit(int node) {
+	while (node != NullNode) {
+		node = Balance(node);
+
+		Node& current = m_nodes[node];
+		const Node& child1 = m_nodes[current.child1];
+		const Node& child2 = m_nodes[current.child2];
+		current.height = 1 + std::max(child1.height, child2.height);
+		current.bounds = BoundingBox::Union(child1.bounds, child2.bounds);
+
+		node = current.parent;
+	}
+}
+
+
+template <class T>
+int BoundingVolumeHierarchy<T>::Balance(int a) {
+	// Rotates the taller child of A up if the children's heights differ by more than one.
+	// Returns the node that took A's place.
+	Node& nodeA = m_nodes[a];
+	if (nodeA.IsLeaf() || nodeA.height < 2) {
+		return a;
+	}
+
+	int b = nodeA.child1;
+	int c = nodeA.child2;
+	int balance = m_nodes[c].height - m_nodes[b].height;
+	if (-1 <= balance && balance <= 1) {
+		return a;
+	}
+
+	// Rotate the taller child (up) above A, the shorter grandchild goes to A.
+	int up = balance > 0 ? c : b;
+	int other = balance > 0 ? b : c;
+	Node& nodeUp = m_nodes[up];
+	int f = nodeUp.child1;
+	int g = nodeUp.child2;
+
+	nodeUp.child1 = a;
+	nodeUp.parent = nodeA.parent;
+	nodeA.parent = up;
+
+	if (nodeUp.parent == NullNode) {
+		m_root = up;
+	}
+	else if (m_nodes[nodeUp.parent].child1 == a) {
+		m_nodes[nodeUp.parent].child1 = up;
+	}
+	else {
+		m_nodes[nodeUp.parent].child2 = up;
+	}
+
+	int taller = m_nodes[f].height > m_nodes[g].height ? f : g;
+	int shorter = taller == f ? g : f;
+	nodeUp.child2 = taller;
+	if (balance > 0) {
+		nodeA.child2 = shorter;
+	}
+	else {
+		nodeA.child1 = shorter;
+	}
+	m_nodes[shorter].parent = a;
+
+	nodeA.bounds = BoundingBox::Union(m_nodes[other].bounds, m_nodes[shorter].bounds);
+	nodeA.height = 1 + std::max(m_nodes[other].height, m_nodes[shorter].height);
+	nodeUp.bounds = BoundingBox::Union(nodeA.bounds, m_nodes[taller].bounds);
+	nodeUp.height = 1 + std::max(nodeA.height, m_nodes[taller].height);
+
+	return up;
+}
+
+
+} // namespace inl::gxeng
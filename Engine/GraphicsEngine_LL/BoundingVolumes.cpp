@@ -0,0 +1,107 @@
+#include "BoundingVolumes.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace inl::gxeng {
+
+
+BoundingBox BoundingBox::Transformed(const Mat44& transform) const {
+	if (IsEmpty()) {
+		return *this;
+	}
+
+	// Transform the center, and project the extent onto the new axes.
+	Vec3 center = GetCenter();
+	Vec3 extent = GetExtent();
+	Vec3 newCenter, newExtent;
+	for (int j = 0; j < 3; ++j) {
+		newCenter(j) = transform(3, j);
+		newExtent(j) = 0.0f;
+		for (int i = 0; i < 3; ++i) {
+			newCenter(j) += center(i) * transform(i, j);
+			newExtent(j) += extent(i) * std::abs(transform(i, j));
+		}
+	}
+	return { newCenter - newExtent, newCenter + newExtent };
+}
+
+
+eContainment BoundingSphere::Classify(const BoundingBox& box) const {
+	// Distance to the closest point of the box.
+	Vec3 closest = Min(Max(center, box.lower), box.upper);
+	if ((closest - center).LengthSquared() > radius * radius) {
+		return eContainment::OUTSIDE;
+	}
+
+	// The box is inside if its farthest corner is.
+	Vec3 farthest;
+	for (int i = 0; i < 3; ++i) {
+		farthest(i) = std::max(std::abs(box.lower(i) - center(i)), std::abs(box.upper(i) - center(i)));
+	}
+	return farthest.LengthSquared() <= radius * radius ? eContainment::INSIDE : eContainment::INTERSECTING;
+}
+
+
+Frustum::Frustum() {
+	m_planes.fill(Vec4(0, 0, 0, 1));
+}
+
+
+Frustum::Frustum(const Mat44& viewProjection) {
+	// Clip coordinates are p*M, so each clip component is the dot product of p with a column.
+	auto column = [&viewProjection](int j) {
+		return Vec4(viewProjection(0, j), viewProjection(1, j), viewProjection(2, j), viewProjection(3, j));
+	};
+	Vec4 x = column(0), y = column(1), z = column(2), w = column(3);
+
+	m_planes = {
+		w + x, // -w <= x
+		w - x, // x <= w
+		w + y, // -w <= y
+		w - y, // y <= w
+		z, // 0 <= z
+		w - z, // z <= w
+	};
+	for (auto& plane : m_planes) {
+		float length = Vec3(plane.x, plane.y, plane.z).Length();
+		plane /= length;
+	}
+}
+
+
+eContainment Frustum::Classify(const BoundingBox& box) const {
+	Vec3 center = box.GetCenter();
+	Vec3 extent = box.GetExtent();
+	eContainment result = eContainment::INSIDE;
+	for (auto& plane : m_planes) {
+		float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+		float radius = std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y + std::abs(plane.z) * extent.z;
+		if (distance + radius < 0.0f) {
+			return eContainment::OUTSIDE;
+		}
+		if (distance - radius < 0.0f) {
+			result = eContainment::INTERSECTING;
+		}
+	}
+	return result;
+}
+
+
+eContainment Frustum::Classify(const BoundingSphere& sphere) const {
+	eContainment result = eContainment::INSIDE;
+	for (auto& plane : m_planes) {
+		float distance = plane.x * sphere.center.x + plane.y * sphere.center.y + plane.z * sphere.center.z + plane.w;
+		if (distance < -sphere.radius) {
+			return eContainment::OUTSIDE;
+		}
+		if (distance < sphere.radius) {
+			result = eContainment::INTERSECTING;
+		}
+	}
+	return result;
+}
+
+
+} // namespace inl::gxeng
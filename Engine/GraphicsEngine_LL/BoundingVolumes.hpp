@@ -0,0 +1,123 @@
+#pragma once
+
+#include <InlineMath.hpp>
+
+#include <array>
+#include <limits>
+
+
+namespace inl::gxeng {
+
+
+/// <summary> Result of testing a bounding box against a query volume. </summary>
+enum class eContainment {
+	OUTSIDE, /// <summary> The box and the volume don't overlap. </summary>
+	INTERSECTING, /// <summary> The box is partially inside the volume. </summary>
+	INSIDE, /// <summary> The box is entirely inside the volume. </summary>
+};
+
+
+
+/// <summary> Axis aligned bounding box in world or local space. </summary>
+/// <remarks> Default constructed boxes are empty, extending them with a point makes them contain that point. </remarks>
+class BoundingBox {
+public:
+	BoundingBox() : lower(std::numeric_limits<float>::max()), upper(std::numeric_limits<float>::lowest()) {}
+	BoundingBox(const Vec3& lower, const Vec3& upper) : lower(lower), upper(upper) {}
+
+	bool IsEmpty() const { return lower.x > upper.x || lower.y > upper.y || lower.z > upper.z; }
+	Vec3 GetCenter() const { return (lower + upper) * 0.5f; }
+	/// <summary> Half of the box's size along each axis. </summary>
+	Vec3 GetExtent() const { return (upper - lower) * 0.5f; }
+	float GetSurfaceArea() const;
+
+	void Extend(const Vec3& point);
+	void Extend(const BoundingBox& box);
+	/// <summary> Grows the box by <paramref name="margin"/> in all directions. </summary>
+	BoundingBox Inflated(const Vec3& margin) const { return { lower - margin, upper + margin }; }
+	/// <summary> Returns the smallest axis aligned box containing this box transformed by an affine matrix. </summary>
+	BoundingBox Transformed(const Mat44& transform) const;
+
+	bool Contains(const BoundingBox& other) const;
+	bool Intersects(const BoundingBox& other) const;
+	eContainment Classify(const BoundingBox& box) const;
+
+	static BoundingBox Union(const BoundingBox& lhs, const BoundingBox& rhs);
+public:
+	Vec3 lower;
+	Vec3 upper;
+};
+
+
+
+class BoundingSphere {
+public:
+	BoundingSphere() : center(0), radius(0) {}
+	BoundingSphere(const Vec3& center, float radius) : center(center), radius(radius) {}
+
+	eContainment Classify(const BoundingBox& box) const;
+public:
+	Vec3 center;
+	float radius;
+};
+
+
+
+/// <summary> Convex volume enclosed by the six clipping planes of a camera. </summary>
+class Frustum {
+public:
+	Frustum();
+	/// <summary> Extracts the clipping planes from a view-projection matrix. </summary>
+	/// <remarks> Uses the engine's conventions: vectors are multiplied from the left and clip space depth is [0, w]. </remarks>
+	explicit Frustum(const Mat44& viewProjection);
+
+	eContainment Classify(const BoundingBox& box) const;
+	eContainment Classify(const BoundingSphere& sphere) const;
+
+	/// <summary> Planes as (normal, offset) such that dot(normal, p) + offset >= 0 for points inside. </summary>
+	/// <remarks> Order is left, right, bottom, top, near, far. Normals have unit length. </remarks>
+	const std::array<Vec4, 6>& GetPlanes() const { return m_planes; }
+private:
+	std::array<Vec4, 6> m_planes;
+};
+
+
+
+inline float BoundingBox::GetSurfaceArea() const {
+	Vec3 size = upper - lower;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+inline void BoundingBox::Extend(const Vec3& point) {
+	lower = Min(lower, point);
+	upper = Max(upper, point);
+}
+
+inline void BoundingBox::Extend(const BoundingBox& box) {
+	lower = Min(lower, box.lower);
+	upper = Max(upper, box.upper);
+}
+
+inline bool BoundingBox::Contains(const BoundingBox& other) const {
+	return lower.x <= other.lower.x && lower.y <= other.lower.y && lower.z <= other.lower.z
+		&& other.upper.x <= upper.x && other.upper.y <= upper.y && other.upper.z <= upper.z;
+}
+
+inline bool BoundingBox::Intersects(const BoundingBox& other) const {
+	return lower.x <= other.upper.x && lower.y <= other.upper.y && lower.z <= other.upper.z
+		&& other.lower.x <= upper.x && other.lower.y <= upper.y && other.lower.z <= upper.z;
+}
+
+inline eContainment BoundingBox::Classify(const BoundingBox& box) const {
+	if (!Intersects(box)) {
+		return eContainment::OUTSIDE;
+	}
+	return Contains(box) ? eContainment::INSIDE : eContainment::INTERSECTING;
+}
+
+inline BoundingBox BoundingBox::Union(const BoundingBox& lhs, const BoundingBox& rhs) {
+	return { Min(lhs.lower, rhs.lower), Max(lhs.upper, rhs.upper) };
+}
+
+
+} // namespace inl::gxeng
@@ -23,6 +23,7 @@ public:
 
 	virtual VolatileConstBuffer CreateVolatileConstBuffer(const void* data, uint32_t size) { throw DefaultEx(); }
 	virtual PersistentConstBuffer CreatePersistentConstBuffer(const void* data, uint32_t size) { throw DefaultEx(); }
+	virtual LinearBuffer CreateBuffer(size_t size, gxapi::eResourceFlags flags = gxapi::eResourceFlags::NONE) { throw DefaultEx(); }
 	virtual VertexBuffer CreateVertexBuffer(size_t size) { throw DefaultEx(); }
 	virtual IndexBuffer CreateIndexBuffer(size_t size, size_t indexCount) { throw DefaultEx(); }
 	virtual Texture1D CreateTexture1D(const Texture1DDesc& desc, gxapi::eResourceFlags flags = gxapi::eResourceFlags::NONE) { throw DefaultEx(); }
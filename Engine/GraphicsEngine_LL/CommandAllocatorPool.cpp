@@ -10,7 +10,7 @@ namespace gxeng {
 
 
 CommandAllocatorPool::CommandAllocatorPool(gxapi::IGraphicsApi* gxApi)
-	: m_gxPool(gxApi), m_cuPool(gxApi), m_cpPool(gxApi)
+	: m_gxPool(gxApi), m_cuPool(gxApi), m_cpPool(gxApi), m_bdPool(gxApi)
 {}
 
 
@@ -24,7 +24,7 @@ auto CommandAllocatorPool::RequestAllocator(gxapi::eCommandListType type) -> Cmd
 		case gxapi::eCommandListType::GRAPHICS:
 			return m_gxPool.RequestAllocator();
 		case gxapi::eCommandListType::BUNDLE:
-			return nullptr;
+			return m_bdPool.RequestAllocator();
 		default:
 			return nullptr;
 	}
@@ -36,10 +36,16 @@ void CommandAllocatorPool::RecycleAllocator(gxapi::ICommandAllocator* allocator)
 	{
 		case gxapi::eCommandListType::COPY:
 			m_cpPool.RecycleAllocator(allocator);
+			break;
 		case gxapi::eCommandListType::COMPUTE:
 			m_cuPool.RecycleAllocator(allocator);
+			break;
 		case gxapi::eCommandListType::GRAPHICS:
 			m_gxPool.RecycleAllocator(allocator);
+			break;
+		case gxapi::eCommandListType::BUNDLE:
+			m_bdPool.RecycleAllocator(allocator);
+			break;
 		default:
 			assert(false); // hlye vagy bazmeg
 	}
@@ -50,6 +56,7 @@ void CommandAllocatorPool::Clear() {
 	m_cpPool.Reset();
 	m_cuPool.Reset();
 	m_gxPool.Reset();
+	m_bdPool.Reset();
 }
 
 
@@ -63,6 +70,7 @@ void CommandAllocatorPool::SetLogStream(LogStream* logStream){
 	m_cpPool.SetLogStream(logStream);
 	m_cuPool.SetLogStream(logStream);
 	m_gxPool.SetLogStream(logStream);
+	m_bdPool.SetLogStream(logStream);
 }
 
 LogStream* CommandAllocatorPool::GetLogStream() const {
@@ -1,16 +1,13 @@
 #pragma once
 
-#include <BaseLibrary/Memory/SlabAllocatorEngine.hpp>
+#include <BaseLibrary/Memory/ThreadCachedFreeList.hpp>
 #include <GraphicsApi_LL/ICommandAllocator.hpp>
 #include <GraphicsApi_LL/IGraphicsApi.hpp>
 
 #include <vector>
 #include <mutex>
-#include <algorithm>
-#include <map>
 #include <cassert>
 
-#include <iostream> // only for debug
 #include <BaseLibrary/Logging/LogStream.hpp>
 
 
@@ -45,21 +42,23 @@ namespace impl {
 	};
 
 
+	/// <summary>
+	/// Recycles command allocators of one type. Each thread takes allocators from its own cache,
+	/// allocators given back after their fence are reset and shared again in batches.
+	/// </summary>
 	template <gxapi::eCommandListType TYPE>
 	class CommandAllocatorPool : public CommandAllocatorPoolBase {
 	public:
 	public:
-		explicit CommandAllocatorPool(gxapi::IGraphicsApi* gxApi, size_t initialSize = 1);
+		explicit CommandAllocatorPool(gxapi::IGraphicsApi* gxApi);
 		CommandAllocatorPool(const CommandAllocatorPool&) = delete;
-		CommandAllocatorPool(CommandAllocatorPool&& rhs);
-
 		CommandAllocatorPool& operator=(const CommandAllocatorPool&) = delete;
-		CommandAllocatorPool& operator=(CommandAllocatorPool&& rhs);
 
 
 		UniquePtr RequestAllocator() override;
 		void RecycleAllocator(gxapi::ICommandAllocator* allocator) override;
-		void Reset(size_t initialSize = 1);
+		/// <summary> Destroys all allocators. None of them may be in use. </summary>
+		void Reset();
 
 		gxapi::IGraphicsApi* GetGraphicsApi() const { return m_gxApi; }
 
@@ -67,84 +66,49 @@ namespace impl {
 		LogStream* GetLogStream() const { return m_logStream; }
 	private:
 		std::vector<std::unique_ptr<gxapi::ICommandAllocator>> m_pool;
-		SlabAllocatorEngine m_allocator;
+		ThreadCachedFreeList<gxapi::ICommandAllocator> m_freeAllocators;
 		gxapi::IGraphicsApi* m_gxApi;
-		std::map<gxapi::ICommandAllocator*, size_t> m_addressToIndex;
 		LogStream* m_logStream = nullptr;
 
-		std::mutex m_mtx;
+		std::mutex m_mtx; // Only taken to add a new allocator.
 	};
 
 
 
 	template <gxapi::eCommandListType TYPE>
-	CommandAllocatorPool<TYPE>::CommandAllocatorPool(gxapi::IGraphicsApi* gxApi, size_t initialSize)
-		: m_pool(initialSize), m_allocator(initialSize), m_gxApi(gxApi)
-	{}
-
-
-	template <gxapi::eCommandListType TYPE>
-	CommandAllocatorPool<TYPE>::CommandAllocatorPool(CommandAllocatorPool&& rhs)
-		: m_pool(std::move(rhs.m_pool)), m_allocator(std::move(rhs.m_allocator)), m_gxApi(rhs.m_gxApi)
+	CommandAllocatorPool<TYPE>::CommandAllocatorPool(gxapi::IGraphicsApi* gxApi)
+		: m_gxApi(gxApi)
 	{}
 
 
-	template <gxapi::eCommandListType TYPE>
-	CommandAllocatorPool<TYPE>& CommandAllocatorPool<TYPE>::operator=(CommandAllocatorPool&& rhs) {
-		m_pool = std::move(rhs.m_pool);
-		m_allocator = std::move(rhs.m_allocator);
-		m_gxApi = rhs.m_gxApi;
-
-		return *this;
-	}
-
-
 	template <gxapi::eCommandListType TYPE>
 	auto CommandAllocatorPool<TYPE>::RequestAllocator() -> UniquePtr {
-		std::lock_guard<std::mutex> lkg(m_mtx);
-
-		size_t index;
-		try {
-			index = m_allocator.Allocate();
+		if (gxapi::ICommandAllocator* existing = m_freeAllocators.Pop()) {
+			return UniquePtr{ existing, Deleter{this} };
 		}
-		catch (std::bad_alloc&) {
-			size_t currentSize = m_pool.size();
-			size_t newSize = std::max(currentSize + 1, size_t(currentSize * 1.25));
-			m_pool.resize(newSize);
-			m_allocator.Resize(newSize);
 
-			index = m_allocator.Allocate();
-		}
+		std::unique_ptr<gxapi::ICommandAllocator> ptr(m_gxApi->CreateCommandAllocator(TYPE));
+		gxapi::ICommandAllocator* created = ptr.get();
 
-		if (m_pool[index] != nullptr) {
-			return UniquePtr{ m_pool[index].get(), Deleter{this} };
-		}
-		else {
-			std::unique_ptr<gxapi::ICommandAllocator> ptr(m_gxApi->CreateCommandAllocator(TYPE));
-			m_addressToIndex[ptr.get()] = index;
-			m_pool[index] = std::move(ptr);
-			return UniquePtr{ m_pool[index].get(), Deleter{this} };
-		}
+		std::lock_guard<std::mutex> lkg(m_mtx);
+		m_pool.push_back(std::move(ptr));
+		return UniquePtr{ created, Deleter{this} };
 	}
 
 
 	template <gxapi::eCommandListType TYPE>
 	void CommandAllocatorPool<TYPE>::RecycleAllocator(gxapi::ICommandAllocator* allocator) {
-		std::lock_guard<std::mutex> lkg(m_mtx);
-
+		// The GPU is done with the commands, so the memory can be reused.
 		allocator->Reset();
-		assert(m_addressToIndex.count(allocator) > 0);
-		size_t index = m_addressToIndex[allocator];
-		m_allocator.Deallocate(index);
+		m_freeAllocators.Push(allocator);
 	}
 
 
 	template <gxapi::eCommandListType TYPE>
-	void CommandAllocatorPool<TYPE>::Reset(size_t initialSize) {
+	void CommandAllocatorPool<TYPE>::Reset() {
+		std::lock_guard<std::mutex> lkg(m_mtx);
+		m_freeAllocators.Clear();
 		m_pool.clear();
-		m_allocator.Reset();
-		m_pool.resize(initialSize);
-		m_allocator.Resize(initialSize);
 	}
 
 } // namespace impl
@@ -157,9 +121,7 @@ public:
 public:
 	explicit CommandAllocatorPool(gxapi::IGraphicsApi* gxApi);
 	CommandAllocatorPool(const CommandAllocatorPool&) = delete;
-	CommandAllocatorPool(CommandAllocatorPool&& rhs) = default;
 	CommandAllocatorPool& operator=(const CommandAllocatorPool&) = delete;
-	CommandAllocatorPool& operator=(CommandAllocatorPool&& rhs) = default;
 
 	CmdAllocPtr RequestAllocator(gxapi::eCommandListType type);
 	void RecycleAllocator(gxapi::ICommandAllocator* allocator);
@@ -173,6 +135,7 @@ private:
 	impl::CommandAllocatorPool<gxapi::eCommandListType::GRAPHICS> m_gxPool;
 	impl::CommandAllocatorPool<gxapi::eCommandListType::COMPUTE> m_cuPool;
 	impl::CommandAllocatorPool<gxapi::eCommandListType::COPY> m_cpPool;
+	impl::CommandAllocatorPool<gxapi::eCommandListType::BUNDLE> m_bdPool;
 };
 
 
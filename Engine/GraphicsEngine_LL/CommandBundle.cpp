@@ -0,0 +1,114 @@
+#include "CommandBundle.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+
+namespace inl::gxeng {
+
+
+CommandBundle::CommandBundle(CommandListPool& commandListPool, CommandAllocatorPool& commandAllocatorPool, uint64_t key)
+	: m_contents(std::make_shared<Contents>())
+{
+	m_contents->commandAllocator = commandAllocatorPool.RequestAllocator(gxapi::eCommandListType::BUNDLE);
+	m_contents->commandList = commandListPool.RequestBundle(m_contents->commandAllocator.get());
+	m_contents->key = key;
+}
+
+
+bool CommandBundle::IsRecordedFor(uint64_t key) const {
+	return m_contents && m_contents->closed && m_contents->key == key;
+}
+
+
+uint64_t CommandBundle::GetKey() const {
+	return m_contents ? m_contents->key : 0;
+}
+
+
+bool CommandBundle::IsClosed() const {
+	return m_contents && m_contents->closed;
+}
+
+
+void CommandBundle::SetPipelineState(gxapi::IPipelineState* pipelineState) {
+	GetRecording().commandList->SetPipelineState(pipelineState);
+}
+
+
+void CommandBundle::SetPrimitiveTopology(gxapi::ePrimitiveTopology topology) {
+	GetRecording().commandList->SetPrimitiveTopology(topology);
+}
+
+
+void CommandBundle::SetVertexBuffers(unsigned startSlot,
+									 unsigned count,
+									 const VertexBuffer* const* resources,
+									 const unsigned* sizeInBytes,
+									 const unsigned* strideInBytes) {
+	Contents& recording = GetRecording();
+
+	std::vector<void*> virtualAddresses(count);
+	std::vector<unsigned> sizes(sizeInBytes, sizeInBytes + count);
+	std::vector<unsigned> strides(strideInBytes, strideInBytes + count);
+	for (unsigned i = 0; i < count; ++i) {
+		recording.resources.push_back({ *resources[i], gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER });
+		virtualAddresses[i] = resources[i]->GetVirtualAddress();
+	}
+
+	recording.commandList->SetVertexBuffers(startSlot, count, virtualAddresses.data(), sizes.data(), strides.data());
+}
+
+
+void CommandBundle::SetIndexBuffer(const IndexBuffer* resource, bool is32Bit) {
+	Contents& recording = GetRecording();
+	recording.resources.push_back({ *resource, gxapi::eResourceState::INDEX_BUFFER });
+	recording.commandList->SetIndexBuffer(resource->GetVirtualAddress(),
+										  resource->GetSize(),
+										  is32Bit ? gxapi::eFormat::R32_UINT : gxapi::eFormat::R16_UINT);
+}
+
+
+void CommandBundle::DrawInstanced(unsigned numVertices, unsigned startVertex, unsigned numInstances, unsigned startInstance) {
+	Contents& recording = GetRecording();
+	recording.commandList->DrawInstanced(numVertices, startVertex, numInstances, startInstance);
+	++recording.numDrawCalls;
+}
+
+
+void CommandBundle::DrawIndexedInstanced(unsigned numIndices, unsigned startIndex, int vertexOffset, unsigned numInstances, unsigned startInstance) {
+	Contents& recording = GetRecording();
+	recording.commandList->DrawIndexedInstanced(numIndices, startIndex, vertexOffset, numInstances, startInstance);
+	++recording.numDrawCalls;
+}
+
+
+void CommandBundle::Close() {
+	Contents& recording = GetRecording();
+	recording.commandList->Close();
+	recording.closed = true;
+}
+
+
+const std::vector<CommandBundle::ResourceUse>& CommandBundle::GetResources() const {
+	static const std::vector<ResourceUse> empty;
+	return m_contents ? m_contents->resources : empty;
+}
+
+
+size_t CommandBundle::GetNumDrawCalls() const {
+	return m_contents ? m_contents->numDrawCalls : 0;
+}
+
+
+CommandBundle::Contents& CommandBundle::GetRecording() {
+	if (!m_contents) {
+		throw InvalidCallException("The bundle has not been started.");
+	}
+	if (m_contents->closed) {
+		throw InvalidCallException("The bundle has been closed, start a new one to record again.");
+	}
+	return *m_contents;
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CommandAllocatorPool.hpp"
+#include "CommandListPool.hpp"
+#include "MemoryObject.hpp"
+
+#include <GraphicsApi_LL/ICommandList.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary>
+/// Draws recorded once and replayed by <see cref="GraphicsCommandList::ExecuteBundle"/> every frame.
+/// </summary>
+/// <remarks>
+/// <para> A bundle cannot transition resources, change descriptor heaps or bind root arguments.
+///		It records the pipeline state, the geometry and the draws. Render targets, the binder and
+///		all bindings are inherited from the list that replays it. </para>
+/// <para> The key tells what has been recorded, such as a hash of the entities and their materials.
+///		When it changes, record a new bundle. Lists that still replay the old one keep it alive
+///		until the GPU is done with them. </para>
+/// </remarks>
+class CommandBundle {
+	friend class GraphicsCommandList;
+public:
+	struct ResourceUse {
+		MemoryObject resource;
+		gxapi::eResourceState state;
+	};
+
+public:
+	CommandBundle() = default;
+	/// <summary> Starts recording a new bundle. </summary>
+	CommandBundle(CommandListPool& commandListPool, CommandAllocatorPool& commandAllocatorPool, uint64_t key);
+
+	/// <summary> True if the bundle has been recorded and closed with the same key. </summary>
+	bool IsRecordedFor(uint64_t key) const;
+	uint64_t GetKey() const;
+	bool IsClosed() const;
+
+	// Recording
+	void SetPipelineState(gxapi::IPipelineState* pipelineState);
+	void SetPrimitiveTopology(gxapi::ePrimitiveTopology topology);
+	void SetVertexBuffers(unsigned startSlot,
+						  unsigned count,
+						  const VertexBuffer* const* resources,
+						  const unsigned* sizeInBytes,
+						  const unsigned* strideInBytes);
+	void SetIndexBuffer(const IndexBuffer* resource, bool is32Bit);
+
+	void DrawInstanced(unsigned numVertices,
+					   unsigned startVertex = 0,
+					   unsigned numInstances = 1,
+					   unsigned startInstance = 0);
+	void DrawIndexedInstanced(unsigned numIndices,
+							  unsigned startIndex = 0,
+							  int vertexOffset = 0,
+							  unsigned numInstances = 1,
+							  unsigned startInstance = 0);
+
+	/// <summary> Ends recording, the bundle can only be replayed afterwards. </summary>
+	void Close();
+
+	/// <summary> The resources the draws read, along with the state they must be in. </summary>
+	const std::vector<ResourceUse>& GetResources() const;
+	size_t GetNumDrawCalls() const;
+
+private:
+	struct Contents {
+		CmdAllocPtr commandAllocator; // Declared first, so that the list is given back before it.
+		GraphicsCmdListPtr commandList;
+		std::vector<ResourceUse> resources;
+		uint64_t key = 0;
+		size_t numDrawCalls = 0;
+		bool closed = false;
+	};
+
+	Contents& GetRecording();
+
+private:
+	std::shared_ptr<Contents> m_contents;
+};
+
+
+} // namespace inl::gxeng
@@ -11,7 +11,7 @@ namespace inl::gxeng {
 
 
 CommandListPool::CommandListPool(gxapi::IGraphicsApi* gxApi)
-	: m_gxPool(gxApi), m_cuPool(gxApi), m_cpPool(gxApi)
+	: m_gxPool(gxApi), m_cuPool(gxApi), m_cpPool(gxApi), m_bdPool(gxApi)
 {}
 
 
@@ -25,7 +25,7 @@ auto CommandListPool::RequestList(gxapi::eCommandListType type, gxapi::ICommandA
 	case gxapi::eCommandListType::GRAPHICS:
 		return m_gxPool.RequestList(allocator);
 	case gxapi::eCommandListType::BUNDLE:
-		return nullptr;
+		return m_bdPool.RequestList(allocator);
 	default:
 		return nullptr;
 	}
@@ -40,20 +40,32 @@ ComputeCmdListPtr CommandListPool::RequestComputeList(gxapi::ICommandAllocator*
 CopyCmdListPtr CommandListPool::RequestCopyList(gxapi::ICommandAllocator* allocator) {
 	return dynamic_pointer_cast<gxapi::ICopyCommandList>(RequestList(gxapi::eCommandListType::COPY, allocator));
 }
+GraphicsCmdListPtr CommandListPool::RequestBundle(gxapi::ICommandAllocator* allocator) {
+	return dynamic_pointer_cast<gxapi::IGraphicsCommandList>(RequestList(gxapi::eCommandListType::BUNDLE, allocator));
+}
 
 
 void CommandListPool::RecycleList(gxapi::ICommandList* list) {
-	if (auto x = dynamic_cast<gxapi::IComputeCommandList*>(list)) {
-		x->ResetState(nullptr);
+	// Bundles cannot clear their state, they start from scratch when reset anyway.
+	if (list->GetType() != gxapi::eCommandListType::BUNDLE) {
+		if (auto x = dynamic_cast<gxapi::IComputeCommandList*>(list)) {
+			x->ResetState(nullptr);
+		}
 	}
 	switch (list->GetType())
 	{
 	case gxapi::eCommandListType::COPY:
 		m_cpPool.RecycleList(list);
+		break;
 	case gxapi::eCommandListType::COMPUTE:
 		m_cuPool.RecycleList(list);
+		break;
 	case gxapi::eCommandListType::GRAPHICS:
 		m_gxPool.RecycleList(list);
+		break;
+	case gxapi::eCommandListType::BUNDLE:
+		m_bdPool.RecycleList(list);
+		break;
 	default:
 		assert(false); // hlye vagy bazmeg
 	}
@@ -64,6 +76,7 @@ void CommandListPool::Clear() {
 	m_cpPool.Reset();
 	m_cuPool.Reset();
 	m_gxPool.Reset();
+	m_bdPool.Reset();
 }
 
 
@@ -77,6 +90,7 @@ void CommandListPool::SetLogStream(LogStream* logStream) {
 	m_cpPool.SetLogStream(logStream);
 	m_cuPool.SetLogStream(logStream);
 	m_gxPool.SetLogStream(logStream);
+	m_bdPool.SetLogStream(logStream);
 }
 
 LogStream* CommandListPool::GetLogStream() const {
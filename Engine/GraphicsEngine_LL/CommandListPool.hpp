@@ -1,13 +1,11 @@
 #pragma once
 
-#include <BaseLibrary/Memory/SlabAllocatorEngine.hpp>
+#include <BaseLibrary/Memory/ThreadCachedFreeList.hpp>
 #include <GraphicsApi_LL/ICommandList.hpp>
 #include <GraphicsApi_LL/IGraphicsApi.hpp>
 
 #include <vector>
 #include <mutex>
-#include <algorithm>
-#include <map>
 #include <cassert>
 
 #include <BaseLibrary/Logging/LogStream.hpp>
@@ -53,21 +51,23 @@ public:
 };
 
 
+/// <summary>
+/// Recycles command lists of one type. Each thread takes lists from its own cache,
+/// lists given back after their fence are shared again in batches.
+/// </summary>
 template <gxapi::eCommandListType TYPE>
 class CommandListPool : public CommandListPoolBase {
 public:
 public:
-	explicit CommandListPool(gxapi::IGraphicsApi* gxApi, size_t initialSize = 1);
+	explicit CommandListPool(gxapi::IGraphicsApi* gxApi);
 	CommandListPool(const CommandListPool&) = delete;
-	CommandListPool(CommandListPool&& rhs);
-
 	CommandListPool& operator=(const CommandListPool&) = delete;
-	CommandListPool& operator=(CommandListPool&& rhs);
 
 
 	UniquePtr RequestList(gxapi::ICommandAllocator* allocator) override;
 	void RecycleList(gxapi::ICommandList* list) override;
-	void Reset(size_t initialSize = 1);
+	/// <summary> Destroys all lists. None of them may be in use. </summary>
+	void Reset();
 
 	gxapi::IGraphicsApi* GetGraphicsApi() const { return m_gxApi; }
 
@@ -75,88 +75,55 @@ public:
 	LogStream* GetLogStream() const { return m_logStream; }
 private:
 	std::vector<std::unique_ptr<gxapi::ICommandList>> m_pool;
-	SlabAllocatorEngine m_allocator;
+	ThreadCachedFreeList<gxapi::ICopyCommandList> m_freeLists; // Kept as copy lists, so they can be reset without a cast.
 	gxapi::IGraphicsApi* m_gxApi;
-	std::map<gxapi::ICommandList*, size_t> m_addressToIndex;
 	LogStream* m_logStream = nullptr;
 
-	std::mutex m_mtx;
+	std::mutex m_mtx; // Only taken to add a new list.
 };
 
 
 
 template <gxapi::eCommandListType TYPE>
-CommandListPool<TYPE>::CommandListPool(gxapi::IGraphicsApi* gxApi, size_t initialSize)
-	: m_pool(initialSize), m_allocator(initialSize), m_gxApi(gxApi)
+CommandListPool<TYPE>::CommandListPool(gxapi::IGraphicsApi* gxApi)
+	: m_gxApi(gxApi)
 {}
 
 
-template <gxapi::eCommandListType TYPE>
-CommandListPool<TYPE>::CommandListPool(CommandListPool&& rhs)
-	: m_pool(std::move(rhs.m_pool)), m_allocator(std::move(rhs.m_allocator)), m_gxApi(rhs.m_gxApi)
-{}
-
-
-template <gxapi::eCommandListType TYPE>
-CommandListPool<TYPE>& CommandListPool<TYPE>::operator=(CommandListPool&& rhs) {
-	m_pool = std::move(rhs.m_pool);
-	m_allocator = std::move(rhs.m_allocator);
-	m_gxApi = rhs.m_gxApi;
-
-	return *this;
-}
-
-
 template <gxapi::eCommandListType TYPE>
 auto CommandListPool<TYPE>::RequestList(gxapi::ICommandAllocator* allocator) -> UniquePtr {
-	std::lock_guard<std::mutex> lkg(m_mtx);
-
-	size_t index;
-	try {
-		index = m_allocator.Allocate();
+	if (gxapi::ICopyCommandList* existing = m_freeLists.Pop()) {
+		existing->Reset(allocator, nullptr);
+		return UniquePtr{ existing, Deleter{ this } };
 	}
-	catch (std::bad_alloc&) {
-		size_t currentSize = m_pool.size();
-		size_t newSize = std::max(currentSize + 1, size_t(currentSize * 1.25));
-		m_pool.resize(newSize);
-		m_allocator.Resize(newSize);
 
-		index = m_allocator.Allocate();
-	}
+	gxapi::CommandListDesc desc;
+	desc.allocator = allocator;
+	desc.initialState = nullptr;
+	std::unique_ptr<gxapi::ICommandList> ptr(m_gxApi->CreateCommandList(TYPE, desc));
+	gxapi::ICommandList* created = ptr.get();
 
-	if (m_pool[index] != nullptr) {
-		dynamic_cast<gxapi::ICopyCommandList*>(m_pool[index].get())->Reset(allocator, nullptr);
-		return UniquePtr{ m_pool[index].get(), Deleter{ this } };
-	}
-	else {
-		gxapi::CommandListDesc desc;
-		desc.allocator = allocator;
-		desc.initialState = nullptr;
-		std::unique_ptr<gxapi::ICommandList> ptr(m_gxApi->CreateCommandList(TYPE, desc));
-		m_addressToIndex[ptr.get()] = index;
-		m_pool[index] = std::move(ptr);
-	
-		return UniquePtr{ m_pool[index].get(), Deleter{ this } };
-	}
+	std::lock_guard<std::mutex> lk(m_mtx);
+	m_pool.push_back(std::move(ptr));
+
+	return UniquePtr{ created, Deleter{ this } };
 }
 
 
 template <gxapi::eCommandListType TYPE>
 void CommandListPool<TYPE>::RecycleList(gxapi::ICommandList* list) {
-	std::lock_guard<std::mutex> lkg(m_mtx);
-
-	assert(m_addressToIndex.count(list) > 0);
-	size_t index = m_addressToIndex[list];
-	m_allocator.Deallocate(index);
+	// Recycling happens once the fence of the list has passed, off the recording threads.
+	auto copyList = dynamic_cast<gxapi::ICopyCommandList*>(list);
+	assert(copyList != nullptr);
+	m_freeLists.Push(copyList);
 }
 
 
 template <gxapi::eCommandListType TYPE>
-void CommandListPool<TYPE>::Reset(size_t initialSize) {
+void CommandListPool<TYPE>::Reset() {
+	std::lock_guard<std::mutex> lk(m_mtx);
+	m_freeLists.Clear();
 	m_pool.clear();
-	m_allocator.Reset();
-	m_pool.resize(initialSize);
-	m_allocator.Resize(initialSize);
 }
 
 
@@ -174,14 +141,14 @@ public:
 public:
 	explicit CommandListPool(gxapi::IGraphicsApi* gxApi);
 	CommandListPool(const CommandListPool&) = delete;
-	CommandListPool(CommandListPool&& rhs) = default;
 	CommandListPool& operator=(const CommandListPool&) = delete;
-	CommandListPool& operator=(CommandListPool&& rhs) = default;
 
 	CmdListPtr RequestList(gxapi::eCommandListType type, gxapi::ICommandAllocator* allocator);
 	GraphicsCmdListPtr RequestGraphicsList(gxapi::ICommandAllocator* allocator);
 	ComputeCmdListPtr RequestComputeList(gxapi::ICommandAllocator* allocator);
 	CopyCmdListPtr RequestCopyList(gxapi::ICommandAllocator* allocator);
+	/// <summary> The allocator must be of BUNDLE type too. </summary>
+	GraphicsCmdListPtr RequestBundle(gxapi::ICommandAllocator* allocator);
 	void RecycleList(gxapi::ICommandList* list);
 	void Clear();
 
@@ -193,6 +160,7 @@ private:
 	impl::CommandListPool<gxapi::eCommandListType::GRAPHICS> m_gxPool;
 	impl::CommandListPool<gxapi::eCommandListType::COMPUTE> m_cuPool;
 	impl::CommandListPool<gxapi::eCommandListType::COPY> m_cpPool;
+	impl::CommandListPool<gxapi::eCommandListType::BUNDLE> m_bdPool;
 };
 
 
@@ -18,7 +18,7 @@ ComputeCommandList::ComputeCommandList(
 	MemoryManager& memoryManager,
 	VolatileViewHeap& volatileCbvHeap
 ) :
-	CopyCommandList(gxApi, commandListPool, commandAllocatorPool, scratchSpacePool, gxapi::eCommandListType::COMPUTE)
+	CopyCommandList(gxApi, commandListPool, commandAllocatorPool, scratchSpacePool, memoryManager.GetResourceIndexRegistry(), gxapi::eCommandListType::COMPUTE)
 {
 	m_commandList = dynamic_cast<gxapi::IComputeCommandList*>(GetCommandList());
 
@@ -35,7 +35,7 @@ ComputeCommandList::ComputeCommandList(
 	VolatileViewHeap& volatileCbvHeap,
 	gxapi::eCommandListType type
 ) :
-	CopyCommandList(gxApi, commandListPool, commandAllocatorPool, scratchSpacePool, type)
+	CopyCommandList(gxApi, commandListPool, commandAllocatorPool, scratchSpacePool, memoryManager.GetResourceIndexRegistry(), type)
 {
 	m_commandList = dynamic_cast<gxapi::IComputeCommandList*>(GetCommandList());
 
@@ -72,6 +72,7 @@ BasicCommandList::Decomposition ComputeCommandList::Decompose() {
 // Draw
 //------------------------------------------------------------------------------
 void ComputeCommandList::Dispatch(size_t numThreadGroupsX, size_t numThreadGroupsY, size_t numThreadGroupsZ) {
+	FlushBarriers();
 	m_commandList->Dispatch(numThreadGroupsX, numThreadGroupsY, numThreadGroupsZ);
 	m_computeBindingManager.CommitDrawCall();
 
@@ -79,6 +80,31 @@ void ComputeCommandList::Dispatch(size_t numThreadGroupsX, size_t numThreadGroup
 }
 
 
+void ComputeCommandList::DispatchIndirect(gxapi::ICommandSignature* commandSignature,
+	unsigned maxCommandCount,
+	const LinearBuffer& argumentBuffer,
+	size_t argumentOffset,
+	const LinearBuffer* countBuffer,
+	size_t countOffset)
+{
+	ExpectResourceState(argumentBuffer, gxapi::eResourceState::INDIRECT_ARGUMENT, { gxapi::ALL_SUBRESOURCES });
+	if (countBuffer) {
+		ExpectResourceState(*countBuffer, gxapi::eResourceState::INDIRECT_ARGUMENT, { gxapi::ALL_SUBRESOURCES });
+	}
+
+	FlushBarriers();
+	m_commandList->ExecuteIndirect(commandSignature,
+		maxCommandCount,
+		argumentBuffer._GetResourcePtr(),
+		argumentOffset,
+		countBuffer ? countBuffer->_GetResourcePtr() : nullptr,
+		countOffset);
+	m_computeBindingManager.CommitDrawCall();
+
+	m_performanceCounters.numKernels++;
+}
+
+
 //------------------------------------------------------------------------------
 // Command list state
 //------------------------------------------------------------------------------
@@ -101,120 +127,195 @@ void ComputeCommandList::SetComputeBinder(const Binder* binder) {
 
 
 void ComputeCommandList::BindCompute(BindParameter parameter, const TextureView1D& shaderResource) {
+	BindCompute(m_computeBindingManager.Resolve(parameter), shaderResource);
+}
+
+void ComputeCommandList::BindCompute(BindParameter parameter, const TextureView2D& shaderResource) {
+	BindCompute(m_computeBindingManager.Resolve(parameter), shaderResource);
+}
+
+void ComputeCommandList::BindCompute(BindParameter parameter, const TextureView3D& shaderResource) {
+	BindCompute(m_computeBindingManager.Resolve(parameter), shaderResource);
+}
+
+void ComputeCommandList::BindCompute(BindParameter parameter, const TextureViewCube& shaderResource) {
+	BindCompute(m_computeBindingManager.Resolve(parameter), shaderResource);
+}
+
+void ComputeCommandList::BindCompute(BindParameter parameter, const BufferView& shaderResource) {
+	BindCompute(m_computeBindingManager.Resolve(parameter), shaderResource);
+}
+
+void ComputeCommandList::BindCompute(BindParameter parameter, const ConstBufferView& shaderConstant) {
+	BindCompute(m_computeBindingManager.Resolve(parameter), shaderConstant);
+}
+
+void ComputeCommandList::BindCompute(BindParameter parameter, const void* shaderConstant, int size/*, int offset*/) {
+	BindCompute(m_computeBindingManager.Resolve(parameter), shaderConstant, size);
+}
+
+void ComputeCommandList::BindCompute(BindParameter parameter, const RWTextureView1D& rwResource) {
+	BindCompute(m_computeBindingManager.Resolve(parameter), rwResource);
+}
+
+void ComputeCommandList::BindCompute(BindParameter parameter, const RWTextureView2D& rwResource) {
+	BindCompute(m_computeBindingManager.Resolve(parameter), rwResource);
+}
+
+void ComputeCommandList::BindCompute(BindParameter parameter, const RWTextureView3D& rwResource) {
+	BindCompute(m_computeBindingManager.Resolve(parameter), rwResource);
+}
+
+void ComputeCommandList::BindCompute(BindParameter parameter, const RWBufferView& rwResource) {
+	BindCompute(m_computeBindingManager.Resolve(parameter), rwResource);
+}
+
+
+void ComputeCommandList::BindCompute(BindSlot slot, const TextureView1D& shaderResource) {
 	ExpectResourceState(
 		shaderResource.GetResource(),
 		gxapi::eResourceState{ gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE },
 		shaderResource.GetSubresourceList());
 
 	try {
-		m_computeBindingManager.Bind(parameter, shaderResource);
+		m_computeBindingManager.Bind(slot, shaderResource);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_computeBindingManager.Bind(parameter, shaderResource);
+		m_computeBindingManager.Bind(slot, shaderResource);
 	}
 }
 
-void ComputeCommandList::BindCompute(BindParameter parameter, const TextureView2D& shaderResource) {
+void ComputeCommandList::BindCompute(BindSlot slot, const TextureView2D& shaderResource) {
 	ExpectResourceState(
 		shaderResource.GetResource(),
 		gxapi::eResourceState{ gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE },
 		shaderResource.GetSubresourceList());
 
 	try {
-		m_computeBindingManager.Bind(parameter, shaderResource);
+		m_computeBindingManager.Bind(slot, shaderResource);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_computeBindingManager.Bind(parameter, shaderResource);
+		m_computeBindingManager.Bind(slot, shaderResource);
 	}
 }
 
-void ComputeCommandList::BindCompute(BindParameter parameter, const TextureView3D& shaderResource) {
+void ComputeCommandList::BindCompute(BindSlot slot, const TextureView3D& shaderResource) {
 	ExpectResourceState(
 		shaderResource.GetResource(),
 		gxapi::eResourceState{ gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE },
 		shaderResource.GetSubresourceList());
 
 	try {
-		m_computeBindingManager.Bind(parameter, shaderResource);
+		m_computeBindingManager.Bind(slot, shaderResource);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_computeBindingManager.Bind(parameter, shaderResource);
+		m_computeBindingManager.Bind(slot, shaderResource);
 	}
 }
 
-void ComputeCommandList::BindCompute(BindParameter parameter, const ConstBufferView& shaderConstant) {
+void ComputeCommandList::BindCompute(BindSlot slot, const TextureViewCube& shaderResource) {
+	ExpectResourceState(
+		shaderResource.GetResource(),
+		gxapi::eResourceState{ gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE },
+		shaderResource.GetSubresourceList());
+
+	try {
+		m_computeBindingManager.Bind(slot, shaderResource);
+	}
+	catch (std::bad_alloc&) {
+		NewScratchSpace(1000);
+		m_computeBindingManager.Bind(slot, shaderResource);
+	}
+}
+
+void ComputeCommandList::BindCompute(BindSlot slot, const BufferView& shaderResource) {
+	ExpectResourceState(
+		shaderResource.GetResource(),
+		gxapi::eResourceState{ gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE },
+		shaderResource.GetSubresourceList());
+
+	try {
+		m_computeBindingManager.Bind(slot, shaderResource);
+	}
+	catch (std::bad_alloc&) {
+		NewScratchSpace(1000);
+		m_computeBindingManager.Bind(slot, shaderResource);
+	}
+}
+
+void ComputeCommandList::BindCompute(BindSlot slot, const ConstBufferView& shaderConstant) {
 	if (dynamic_cast<const PersistentConstBuffer*>(&shaderConstant.GetResource())) {
 		m_additionalResources.push_back(shaderConstant.GetResource());
 	}
 
 	try {
-		m_computeBindingManager.Bind(parameter, shaderConstant);
+		m_computeBindingManager.Bind(slot, shaderConstant);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_computeBindingManager.Bind(parameter, shaderConstant);
+		m_computeBindingManager.Bind(slot, shaderConstant);
 	}
 }
 
-void ComputeCommandList::BindCompute(BindParameter parameter, const void* shaderConstant, int size/*, int offset*/) {
+void ComputeCommandList::BindCompute(BindSlot slot, const void* shaderConstant, int size/*, int offset*/) {
 	try {
-		m_computeBindingManager.Bind(parameter, shaderConstant, size/*, offset*/);
+		m_computeBindingManager.Bind(slot, shaderConstant, size/*, offset*/);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_computeBindingManager.Bind(parameter, shaderConstant, size/*, offset*/);
+		m_computeBindingManager.Bind(slot, shaderConstant, size/*, offset*/);
 	}
 }
 
-void ComputeCommandList::BindCompute(BindParameter parameter, const RWTextureView1D& rwResource) {
+void ComputeCommandList::BindCompute(BindSlot slot, const RWTextureView1D& rwResource) {
 	ExpectResourceState(rwResource.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS, rwResource.GetSubresourceList());
 
 	try {
-		m_computeBindingManager.Bind(parameter, rwResource);
+		m_computeBindingManager.Bind(slot, rwResource);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_computeBindingManager.Bind(parameter, rwResource);
+		m_computeBindingManager.Bind(slot, rwResource);
 	}
 }
 
-void ComputeCommandList::BindCompute(BindParameter parameter, const RWTextureView2D& rwResource) {
+void ComputeCommandList::BindCompute(BindSlot slot, const RWTextureView2D& rwResource) {
 	ExpectResourceState(rwResource.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS, rwResource.GetSubresourceList());
 
 	try {
-		m_computeBindingManager.Bind(parameter, rwResource);
+		m_computeBindingManager.Bind(slot, rwResource);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_computeBindingManager.Bind(parameter, rwResource);
+		m_computeBindingManager.Bind(slot, rwResource);
 	}
 }
 
-void ComputeCommandList::BindCompute(BindParameter parameter, const RWTextureView3D& rwResource) {
+void ComputeCommandList::BindCompute(BindSlot slot, const RWTextureView3D& rwResource) {
 	ExpectResourceState(rwResource.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS, rwResource.GetSubresourceList());
 
 	try {
-		m_computeBindingManager.Bind(parameter, rwResource);
+		m_computeBindingManager.Bind(slot, rwResource);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_computeBindingManager.Bind(parameter, rwResource);
+		m_computeBindingManager.Bind(slot, rwResource);
 	}
 }
 
-void ComputeCommandList::BindCompute(BindParameter parameter, const RWBufferView& rwResource) {
+void ComputeCommandList::BindCompute(BindSlot slot, const RWBufferView& rwResource) {
 	ExpectResourceState(rwResource.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS, rwResource.GetSubresourceList());
 
 	{
 		try {
-			m_computeBindingManager.Bind(parameter, rwResource);
+			m_computeBindingManager.Bind(slot, rwResource);
 		}
 		catch (std::bad_alloc&) {
 			NewScratchSpace(1000);
-			m_computeBindingManager.Bind(parameter, rwResource);
+			m_computeBindingManager.Bind(slot, rwResource);
 		}
 	}
 }
@@ -230,7 +331,26 @@ void ComputeCommandList::NewScratchSpace(size_t hint) {
 // UAV barrier
 //------------------------------------------------------------------------------
 void ComputeCommandList::UAVBarrier(const MemoryObject& memoryObject) {
-	m_commandList->ResourceBarrier(gxapi::UavBarrier(memoryObject._GetResourcePtr()));
+	AddBarrier(gxapi::UavBarrier(memoryObject._GetResourcePtr()));
+}
+
+
+//------------------------------------------------------------------------------
+// Queries
+//------------------------------------------------------------------------------
+void ComputeCommandList::BeginQuery(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned index) {
+	m_commandList->BeginQuery(queryHeap, type, index);
+}
+
+void ComputeCommandList::EndQuery(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned index) {
+	m_commandList->EndQuery(queryHeap, type, index);
+}
+
+void ComputeCommandList::ResolveQueryData(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned first, unsigned count, const LinearBuffer& destination, size_t destinationOffset) {
+	ExpectResourceState(destination, gxapi::eResourceState::COPY_DEST, { gxapi::ALL_SUBRESOURCES });
+
+	FlushBarriers();
+	m_commandList->ResolveQueryData(queryHeap, type, first, count, destination._GetResourcePtr(), destinationOffset);
 }
 
 
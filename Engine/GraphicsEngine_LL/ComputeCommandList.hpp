@@ -34,6 +34,20 @@ public:
 	// Draw
 	void Dispatch(size_t numThreadGroupsX, size_t numThreadGroupsY, size_t numThreadGroupsZ);
 
+	/// <summary> Executes dispatch commands whose arguments are written by the GPU. </summary>
+	/// <param name="maxCommandCount"> Number of commands, or the upper limit if <paramref name="countBuffer"/> is given. </param>
+	/// <param name="argumentBuffer"> Commands laid out as described by <paramref name="commandSignature"/>. </param>
+	/// <param name="countBuffer"> Optional, the actual command count is read from it as a 32 bit integer. </param>
+	/// <remarks> The compute counterpart of <see cref="GraphicsCommandList::ExecuteIndirect"/>, it commits the compute bindings.
+	///		The argument and count buffers must be in INDIRECT_ARGUMENT state.
+	///		Resources referenced by the commands must be in the proper state too, they are not tracked here. </remarks>
+	void DispatchIndirect(gxapi::ICommandSignature* commandSignature,
+						  unsigned maxCommandCount,
+						  const LinearBuffer& argumentBuffer,
+						  size_t argumentOffset = 0,
+						  const LinearBuffer* countBuffer = nullptr,
+						  size_t countOffset = 0);
+
 	// Command list state
 	void ResetState(gxapi::IPipelineState* newState = nullptr);
 	void SetPipelineState(gxapi::IPipelineState* pipelineState);
@@ -41,9 +55,24 @@ public:
 	// set compute root signature stuff
 	void SetComputeBinder(const Binder* binder);
 
+	/// <summary> Binds by the slots the current binder resolved, which skips looking up the parameter, see <see cref="Binder::Resolve"/>. </summary>
+	void BindCompute(BindSlot slot, const TextureView1D& shaderResource);
+	void BindCompute(BindSlot slot, const TextureView2D& shaderResource);
+	void BindCompute(BindSlot slot, const TextureView3D& shaderResource);
+	void BindCompute(BindSlot slot, const TextureViewCube& shaderResource);
+	void BindCompute(BindSlot slot, const BufferView& shaderResource);
+	void BindCompute(BindSlot slot, const ConstBufferView& shaderConstant);
+	void BindCompute(BindSlot slot, const void* shaderConstant, int size/*, int offset*/);
+	void BindCompute(BindSlot slot, const RWTextureView1D& rwResource);
+	void BindCompute(BindSlot slot, const RWTextureView2D& rwResource);
+	void BindCompute(BindSlot slot, const RWTextureView3D& rwResource);
+	void BindCompute(BindSlot slot, const RWBufferView& rwResource);
+
 	void BindCompute(BindParameter parameter, const TextureView1D& shaderResource);
 	void BindCompute(BindParameter parameter, const TextureView2D& shaderResource);
 	void BindCompute(BindParameter parameter, const TextureView3D& shaderResource);
+	void BindCompute(BindParameter parameter, const TextureViewCube& shaderResource);
+	void BindCompute(BindParameter parameter, const BufferView& shaderResource);
 	void BindCompute(BindParameter parameter, const ConstBufferView& shaderConstant);
 	void BindCompute(BindParameter parameter, const void* shaderConstant, int size/*, int offset*/);
 	void BindCompute(BindParameter parameter, const RWTextureView1D& rwResource);
@@ -53,6 +82,12 @@ public:
 
 	// UAV barriers
 	void UAVBarrier(const MemoryObject& memoryObject);
+
+	// Queries
+	void BeginQuery(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned index);
+	void EndQuery(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned index);
+	/// <summary> Copies the results of queries [first, first+count) to the buffer, which must be in COPY_DEST state. </summary>
+	void ResolveQueryData(gxapi::IQueryHeap* queryHeap, gxapi::eQueryType type, unsigned first, unsigned count, const LinearBuffer& destination, size_t destinationOffset);
 protected:
 	virtual Decomposition Decompose() override;
 	virtual void NewScratchSpace(size_t hint) override;
@@ -1,113 +1,65 @@
 #include "ConstBufferHeap.hpp"
 
+#include <algorithm>
 #include <cassert>
 
 namespace inl {
 namespace gxeng {
 
 
-ConstantBufferHeap::ConstantBufferHeap(gxapi::IGraphicsApi* graphicsApi) :
-	m_graphicsApi(graphicsApi)
-{
-	m_pages.PushFront(CreatePage());
-}
+namespace {
 
+struct ThreadCache {
+	uint64_t heapId = 0;
+	void* pages = nullptr;
+};
 
-VolatileConstBuffer ConstantBufferHeap::CreateVolatileConstBuffer(const void* data, uint32_t dataSize) {
-	uint32_t targetSize = (uint32_t)SnapUpward(dataSize, ALIGNEMENT);
+thread_local ThreadCache threadCache;
+std::atomic_uint64_t nextHeapId = 1;
 
-	std::lock_guard<std::mutex> lock(m_mutex);
+} // namespace
 
-	MarkEmptyIfRecycled(m_pages.Front());
 
-	ConstBufferPage* targetPage = nullptr;
-
-	if (m_pages.Front().m_consumedSize + targetSize > m_pages.Front().m_pageSize) {
-		if (targetSize > PAGE_SIZE) {
-			if (m_largePages.Count() == 0) {
-				m_largePages.PushFront(CreateLargePage(targetSize));
-			}
-			else {
-				if (HasBecomeAvailable(m_largePages.Front())) {
-					m_largePages.Front().m_consumedSize = 0;
-				}
-
-				auto roundEnd = m_largePages.End();
-				for (;
-					m_largePages.Begin() != roundEnd;
-					m_largePages.RotateFront())
-				{
-					auto& currPage = m_largePages.Front();
-					MarkEmptyIfRecycled(currPage);
-					if (currPage.m_consumedSize + targetSize <= currPage.m_pageSize) {
-						break; // current front will be selected as the target page, see below
-					}
-				}
-
-				bool noSuitable = roundEnd == m_largePages.Begin();
-				if (noSuitable) {
-					m_largePages.PushFront(CreateLargePage(targetSize));
-				}
-			}
+ConstantBufferHeap::ConstantBufferHeap(gxapi::IGraphicsApi* graphicsApi) :
+	m_graphicsApi(graphicsApi),
+	m_id(nextHeapId++)
+{}
 
-			targetPage = &m_largePages.Front();
-		}
-		else {
-			m_pages.RotateFront();
 
-			if (HasBecomeAvailable(m_pages.Front())) {
-				m_pages.Front().m_consumedSize = 0;
-			}
-			else {
-				m_pages.PushFront(CreatePage());
-			}
+VolatileConstBuffer ConstantBufferHeap::CreateVolatileConstBuffer(const void* data, uint32_t dataSize) {
+	uint32_t targetSize = (uint32_t)SnapUpward(dataSize, ALIGNEMENT);
 
-			targetPage = &m_pages.Front();
-		}
+	if (targetSize > PAGE_SIZE) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return Consume(GetLargePage(targetSize), data, dataSize, targetSize);
 	}
-	else {
-		targetPage = &m_pages.Front();
-	}
-
-	assert(targetPage != nullptr);
-
-	// set owner to mach latest data that is being
-	// used from the page
-	targetPage->m_ownerFrameID = m_currFrameID;
-	size_t offset = targetPage->m_consumedSize;
-	targetPage->m_consumedSize += targetSize;
-
-	void* cpuPtr = ((uint8_t*)targetPage->m_cpuAddress) + offset;
-	void* gpuPtr = ((uint8_t*)targetPage->m_gpuAddress) + offset;
-
-	memcpy(cpuPtr, data, dataSize);
-
-	auto NullDeleter = [](const gxapi::IResource*) {};
-	auto resource = MemoryObject::UniquePtr(targetPage->m_representedMemory.get(), NullDeleter);
-
-	return VolatileConstBuffer(std::move(resource), true, eResourceHeap::CONSTANT, gpuPtr, dataSize, targetSize);
+	return Consume(GetThreadPage(targetSize), data, dataSize, targetSize);
 }
 
 
 PersistentConstBuffer ConstantBufferHeap::CreatePersistentConstBuffer(const void* data, uint32_t dataSize) {
+	// Views of the buffer cover the whole of it, their size must be aligned.
+	uint32_t bufferSize = (uint32_t)SnapUpward(dataSize, ALIGNEMENT);
+
 	MemoryObject::UniquePtr resource{
 		m_graphicsApi->CreateCommittedResource(
 			gxapi::HeapProperties{ gxapi::eHeapType::UPLOAD },
 			gxapi::eHeapFlags::NONE,
-			gxapi::ResourceDesc::Buffer(dataSize),
+			gxapi::ResourceDesc::Buffer(bufferSize),
 			gxapi::eResourceState::GENERIC_READ
 		),
 		std::default_delete<const gxapi::IResource>()
 	};
 
 	gxapi::MemoryRange noReadRange{0, 0};
-	void* dst = resource->Map(0, &noReadRange);
+	uint8_t* dst = reinterpret_cast<uint8_t*>(resource->Map(0, &noReadRange));
 	memcpy(dst, data, dataSize);
+	memset(dst + dataSize, 0, bufferSize - dataSize);
 	resource->Unmap(0, nullptr);
 
 	void* gpuPtr = resource->GetGPUAddress();
 
-	return PersistentConstBuffer(std::move(resource), true, eResourceHeap::CRITICAL, gpuPtr, dataSize, dataSize);
+	return PersistentConstBuffer(std::move(resource), true, eResourceHeap::CRITICAL, gpuPtr, dataSize, bufferSize);
 }
 
 
@@ -153,6 +105,95 @@ size_t ConstantBufferHeap::SnapUpward(size_t value, size_t gridSize) {
 }
 
 
+ConstantBufferHeap::ThreadPages& ConstantBufferHeap::GetThreadPages() {
+	if (threadCache.heapId == m_id) {
+		return *static_cast<ThreadPages*>(threadCache.pages);
+	}
+
+	std::lock_guard<std::mutex> lock(m_threadPagesMutex);
+	auto id = std::this_thread::get_id();
+	auto it = std::find_if(m_threadPages.begin(), m_threadPages.end(), [id](const auto& thread) { return thread->owner == id; });
+	if (it == m_threadPages.end()) {
+		auto pages = std::make_unique<ThreadPages>();
+		pages->owner = id;
+		pages->pages.PushFront(CreatePage());
+		m_threadPages.push_back(std::move(pages));
+		it = m_threadPages.end() - 1;
+	}
+	threadCache = { m_id, it->get() };
+	return **it;
+}
+
+
+ConstantBufferHeap::ConstBufferPage& ConstantBufferHeap::GetThreadPage(size_t targetSize) {
+	assert(targetSize <= PAGE_SIZE);
+	RingBuffer<ConstBufferPage>& pages = GetThreadPages().pages;
+
+	MarkEmptyIfRecycled(pages.Front());
+	if (pages.Front().m_consumedSize + targetSize > pages.Front().m_pageSize) {
+		// The oldest page is next, the newest one may still be in use by the GPU.
+		pages.RotateFront();
+		if (HasBecomeAvailable(pages.Front())) {
+			pages.Front().m_consumedSize = 0;
+		}
+		else {
+			pages.PushFront(CreatePage());
+		}
+	}
+	return pages.Front();
+}
+
+
+ConstantBufferHeap::ConstBufferPage& ConstantBufferHeap::GetLargePage(size_t targetSize) {
+	if (m_largePages.Count() == 0) {
+		m_largePages.PushFront(CreateLargePage(targetSize));
+		return m_largePages.Front();
+	}
+
+	if (HasBecomeAvailable(m_largePages.Front())) {
+		m_largePages.Front().m_consumedSize = 0;
+	}
+
+	auto roundEnd = m_largePages.End();
+	for (;
+		m_largePages.Begin() != roundEnd;
+		m_largePages.RotateFront())
+	{
+		auto& currPage = m_largePages.Front();
+		MarkEmptyIfRecycled(currPage);
+		if (currPage.m_consumedSize + targetSize <= currPage.m_pageSize) {
+			break; // current front will be selected as the target page, see below
+		}
+	}
+
+	bool noSuitable = roundEnd == m_largePages.Begin();
+	if (noSuitable) {
+		m_largePages.PushFront(CreateLargePage(targetSize));
+	}
+
+	return m_largePages.Front();
+}
+
+
+VolatileConstBuffer ConstantBufferHeap::Consume(ConstBufferPage& targetPage, const void* data, uint32_t dataSize, uint32_t targetSize) {
+	// set owner to mach latest data that is being
+	// used from the page
+	targetPage.m_ownerFrameID = m_currFrameID;
+	size_t offset = targetPage.m_consumedSize;
+	targetPage.m_consumedSize += targetSize;
+
+	void* cpuPtr = ((uint8_t*)targetPage.m_cpuAddress) + offset;
+	void* gpuPtr = ((uint8_t*)targetPage.m_gpuAddress) + offset;
+
+	memcpy(cpuPtr, data, dataSize);
+
+	auto NullDeleter = [](const gxapi::IResource*) {};
+	auto resource = MemoryObject::UniquePtr(targetPage.m_representedMemory.get(), NullDeleter);
+
+	return VolatileConstBuffer(std::move(resource), true, eResourceHeap::CONSTANT, gpuPtr, dataSize, targetSize);
+}
+
+
 ConstantBufferHeap::ConstBufferPage ConstantBufferHeap::CreatePage() {
 	return CreateLargePage(PAGE_SIZE);
 }
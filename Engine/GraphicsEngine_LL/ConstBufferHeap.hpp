@@ -9,14 +9,22 @@
 #include "../BaseLibrary/RingBuffer.hpp"
 #include "../BaseLibrary/ScalarLiterals.hpp"
 
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 namespace inl {
 namespace gxeng {
 
 class MemoryManager;
 
+/// <summary>
+/// Suballocates constant buffers from pages of upload heap memory.
+/// Each thread fills its own pages, so volatile buffers are handed out without locking.
+/// Pages are reused once the GPU has finished the last frame that used them.
+/// </summary>
 class ConstantBufferHeap : public PipelineEventListener, public BufferHeap {
 protected:
 	class ConstBufferPage {
@@ -41,6 +49,12 @@ protected:
 		uint64_t m_ownerFrameID;
 	};
 
+	/// <summary> The pages of one thread, only ever touched by that thread. </summary>
+	struct ThreadPages {
+		std::thread::id owner;
+		RingBuffer<ConstBufferPage> pages;
+	};
+
 public:
 	ConstantBufferHeap(gxapi::IGraphicsApi* graphicsApi);
 
@@ -56,12 +70,16 @@ public:
 protected:
 	gxapi::IGraphicsApi* m_graphicsApi;
 
+	const uint64_t m_id; // Tells apart the thread caches of different heaps.
+
 	RingBuffer<ConstBufferPage> m_largePages;
-	RingBuffer<ConstBufferPage> m_pages;
 	std::mutex m_mutex;
 
-	uint64_t m_currFrameID = 1;
-	uint64_t m_lastFinishedFrameID = 0;
+	std::vector<std::unique_ptr<ThreadPages>> m_threadPages;
+	std::mutex m_threadPagesMutex;
+
+	std::atomic_uint64_t m_currFrameID = 1;
+	std::atomic_uint64_t m_lastFinishedFrameID = 0;
 
 protected:
 	// From ( https://msdn.microsoft.com/en-us/library/windows/desktop/dn899216%28v=vs.85%29.aspx )
@@ -73,6 +91,13 @@ protected:
 
 	static size_t SnapUpward(size_t value, size_t gridSize);
 protected:
+	ThreadPages& GetThreadPages();
+	/// <summary> Returns a page of the calling thread with room for the size, which must fit into a page. </summary>
+	ConstBufferPage& GetThreadPage(size_t targetSize);
+	/// <summary> Returns a large page with room for the size, the lock of large pages must be held. </summary>
+	ConstBufferPage& GetLargePage(size_t targetSize);
+	VolatileConstBuffer Consume(ConstBufferPage& page, const void* data, uint32_t dataSize, uint32_t targetSize);
+
 	ConstBufferPage CreatePage();
 	ConstBufferPage CreateLargePage(size_t fittingSize);
 	bool HasBecomeAvailable(const ConstBufferPage& page);
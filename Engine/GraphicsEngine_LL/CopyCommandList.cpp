@@ -1,5 +1,7 @@
 #include "CopyCommandList.hpp"
 
+#include <algorithm>
+
 namespace inl {
 namespace gxeng {
 
@@ -8,9 +10,10 @@ CopyCommandList::CopyCommandList(
 	gxapi::IGraphicsApi* gxApi,
 	CommandListPool& commandListPool,
 	CommandAllocatorPool& commandAllocatorPool,
-	ScratchSpacePool& scratchSpacePool
+	ScratchSpacePool& scratchSpacePool,
+	ResourceIndexRegistry& resourceIndices
 ) :
-	BasicCommandList(gxApi, commandListPool, commandAllocatorPool, scratchSpacePool, gxapi::eCommandListType::COPY)
+	BasicCommandList(gxApi, commandListPool, commandAllocatorPool, scratchSpacePool, resourceIndices, gxapi::eCommandListType::COPY)
 {
 	m_commandList = dynamic_cast<gxapi::ICopyCommandList*>(GetCommandList());
 }
@@ -21,9 +24,10 @@ CopyCommandList::CopyCommandList(
 	CommandListPool& commandListPool,
 	CommandAllocatorPool& commandAllocatorPool,
 	ScratchSpacePool& scratchSpacePool,
+	ResourceIndexRegistry& resourceIndices,
 	gxapi::eCommandListType type
 ) :
-	BasicCommandList(gxApi, commandListPool, commandAllocatorPool, scratchSpacePool, type)
+	BasicCommandList(gxApi, commandListPool, commandAllocatorPool, scratchSpacePool, resourceIndices, type)
 {
 	m_commandList = dynamic_cast<gxapi::ICopyCommandList*>(GetCommandList());
 }
@@ -31,7 +35,8 @@ CopyCommandList::CopyCommandList(
 
 CopyCommandList::CopyCommandList(CopyCommandList&& rhs)
 	: BasicCommandList(std::move(rhs)),
-	m_commandList(rhs.m_commandList)
+	m_commandList(rhs.m_commandList),
+	m_pendingBarriers(std::move(rhs.m_pendingBarriers))
 {
 	rhs.m_commandList = nullptr;
 }
@@ -40,6 +45,7 @@ CopyCommandList::CopyCommandList(CopyCommandList&& rhs)
 CopyCommandList& CopyCommandList::operator=(CopyCommandList&& rhs) {
 	BasicCommandList::operator=(std::move(rhs));
 	m_commandList = rhs.m_commandList;
+	m_pendingBarriers = std::move(rhs.m_pendingBarriers);
 	rhs.m_commandList = nullptr;
 
 	return *this;
@@ -50,42 +56,65 @@ void CopyCommandList::SetResourceState(const MemoryObject& resource, gxapi::eRes
 	if (resource.GetHeap() == eResourceHeap::CONSTANT || resource.GetHeap() == eResourceHeap::UPLOAD) {
 		throw InvalidArgumentException("You must not set resource state of UPLOAD staging buffers and VOLATILE CONSTANT buffers. They are GENERIC_READ.");
 	}
+	if (GetType() == gxapi::eCommandListType::COMPUTE && !IsComputeQueueState(state)) {
+		throw InvalidArgumentException("Lists for the compute queue can only use compute states, such as NON_PIXEL_SHADER_RESOURCE and UNORDERED_ACCESS.");
+	}
+	if (GetType() == gxapi::eCommandListType::COPY && !IsCopyQueueState(state)) {
+		throw InvalidArgumentException("Lists for the copy queue can only use the COPY_DEST and COPY_SOURCE states.");
+	}
+
+	// Suballocations share the states of their buffer, the list keeps them alive as they are not tracked.
+	if (resource._IsSubAllocation()) {
+		m_additionalResources.push_back(resource);
+		SetResourceState(resource._GetStateOwner(), state, subresource);
+		return;
+	}
+
+	// Whole resources take a single entry and barrier, the first use needs no barrier.
+	m_resourceStates.SetState(resource, subresource, state, [&](unsigned transitioned, gxapi::eResourceState prevState) {
+		QueueTransition(resource, transitioned, prevState, state);
+	});
+}
 
-	// Call recursively when ALL subresources are requested.
-	if (subresource == gxapi::ALL_SUBRESOURCES) {
-		for (unsigned s = 0; s < resource._GetResourcePtr()->GetNumSubresources(); ++s) {
-			SetResourceState(resource, state, s);
+
+void CopyCommandList::QueueTransition(const MemoryObject& resource, unsigned subresource, gxapi::eResourceState before, gxapi::eResourceState after) {
+	const gxapi::IResource* resourcePtr = resource._GetResourcePtr();
+	auto findPending = [&](unsigned pendingSubresource) {
+		return std::find_if(m_pendingBarriers.begin(), m_pendingBarriers.end(), [&](const gxapi::ResourceBarrier& barrier) {
+			return barrier.type == gxapi::eResourceBarrierType::TRANSITION
+				   && barrier.transition.resource == resourcePtr
+				   && barrier.transition.subResource == pendingSubresource;
+		});
+	};
+
+	// The resource was whole when its pending transition was queued, it's split into subresources now.
+	if (subresource != gxapi::ALL_SUBRESOURCES) {
+		auto whole = findPending(gxapi::ALL_SUBRESOURCES);
+		if (whole != m_pendingBarriers.end()) {
+			gxapi::TransitionBarrier transition = whole->transition;
+			m_pendingBarriers.erase(whole);
+			for (unsigned s = 0; s < resource.GetNumSubresources(); ++s) {
+				transition.subResource = s;
+				m_pendingBarriers.push_back(transition);
+			}
 		}
 	}
-	// Do a single subresource
-	else {
-		SubresourceId resId{ resource, subresource };
-		auto iter = m_resourceTransitions.find(resId);
-		bool firstTransition = iter == m_resourceTransitions.end();
-		if (firstTransition) {
-			SubresourceUsageInfo info;
-			info.lastState = state;
-			info.firstState = state;
-			info.multipleStates = false;
-			m_resourceTransitions.insert({ std::move(resId), info });
+
+	// Nothing used the resource since a pending transition into the state before, that one is retargeted instead.
+	// It goes away entirely if the resource returns to where it started, such as A->B->A.
+	auto pending = findPending(subresource);
+	if (pending != m_pendingBarriers.end()) {
+		assert(pending->transition.afterState == before);
+		if (pending->transition.beforeState == after) {
+			m_pendingBarriers.erase(pending);
 		}
 		else {
-			const auto& prevState = iter->second.lastState;
-
-			if (prevState != state) {
-				m_commandList->ResourceBarrier(
-					gxapi::TransitionBarrier{
-					resource._GetResourcePtr(),
-					prevState,
-					state,
-					subresource
-				}
-				);
-				iter->second.lastState = state;
-				iter->second.multipleStates = true;
-			}
+			pending->transition.afterState = after;
 		}
 	}
+	else {
+		m_pendingBarriers.push_back(gxapi::TransitionBarrier{ resource._GetResourcePtr(), before, after, subresource });
+	}
 }
 
 // REMOVE THESE IF ONES BELOW WORK
@@ -143,6 +172,10 @@ void CopyCommandList::ExpectResourceState(const MemoryObject& resource, const st
 	if (resource.GetHeap() == eResourceHeap::CONSTANT || resource.GetHeap() == eResourceHeap::UPLOAD) {
 		return; // they are GENERIC_READ, we don't care about them
 	}
+	if (resource._IsSubAllocation()) {
+		ExpectResourceState(resource._GetStateOwner(), anyOfStates, subresources);
+		return;
+	}
 
 	struct SubresourceIterator {
 		SubresourceIterator(const MemoryObject& resource, const std::vector<uint32_t>& subresources) {
@@ -177,14 +210,13 @@ void CopyCommandList::ExpectResourceState(const MemoryObject& resource, const st
 	while (subiter.HasNext()) {
 		uint32_t subres = subiter.Get();
 
-		SubresourceId key{ resource, subres };
-		auto iter = m_resourceTransitions.find(key);
+		std::optional<gxapi::eResourceState> state = m_resourceStates.GetState(resource, subres);
 
-		if (iter == m_resourceTransitions.end()) {
+		if (!state) {
 			throw InvalidStateException("You must SetSubresourceState before binding the resource view to the pipeline.");
 		}
 		else {
-			gxapi::eResourceState currentState = iter->second.lastState;
+			gxapi::eResourceState currentState = *state;
 			bool ok = false;
 			for (auto it = anyOfStates.begin(); it != anyOfStates.end(); ++it) {
 				ok = ok || (currentState & *it);
@@ -200,16 +232,26 @@ void CopyCommandList::ExpectResourceState(const MemoryObject& resource, const st
 
 
 BasicCommandList::Decomposition CopyCommandList::Decompose() {
+	FlushBarriers(); // The scheduler expects resources in their last set state.
 	m_commandList = nullptr;
 	return BasicCommandList::Decompose();
 }
 
 
+void CopyCommandList::FlushBarriers() {
+	if (!m_pendingBarriers.empty()) {
+		m_commandList->ResourceBarrier((unsigned)m_pendingBarriers.size(), m_pendingBarriers.data());
+		m_pendingBarriers.clear();
+	}
+}
+
+
 void CopyCommandList::CopyBuffer(const MemoryObject& dst, size_t dstOffset, const MemoryObject& src, size_t srcOffset, size_t numBytes) {
 	ExpectResourceState(dst, gxapi::eResourceState::COPY_DEST, { gxapi::ALL_SUBRESOURCES });
 	ExpectResourceState(src, gxapi::eResourceState::COPY_SOURCE, { gxapi::ALL_SUBRESOURCES });
 
-	m_commandList->CopyBuffer(dst._GetResourcePtr(), dstOffset, const_cast<gxapi::IResource*>(src._GetResourcePtr()), srcOffset, numBytes);
+	FlushBarriers();
+	m_commandList->CopyBuffer(dst._GetResourcePtr(), dst._GetOffset() + dstOffset, const_cast<gxapi::IResource*>(src._GetResourcePtr()), src._GetOffset() + srcOffset, numBytes);
 }
 
 
@@ -233,6 +275,7 @@ void CopyCommandList::CopyTexture(const Texture2D& dst, const Texture2D& src, Su
 	auto offsetX = std::max(intptr_t(0), dstPlace.corner1.x);
 	auto offsetY = std::max(intptr_t(0), dstPlace.corner1.y);
 
+	FlushBarriers();
 	m_commandList->CopyTexture(
 		dst._GetResourcePtr(),
 		dstDesc,
@@ -256,6 +299,7 @@ void CopyCommandList::CopyTexture(const Texture2D& dst, const Texture2D& src, Su
 	auto offsetX = std::max(intptr_t(0), dstPlace.corner1.x);
 	auto offsetY = std::max(intptr_t(0), dstPlace.corner1.y);
 
+	FlushBarriers();
 	m_commandList->CopyTexture(
 		dst._GetResourcePtr(),
 		dstDesc,
@@ -273,6 +317,7 @@ void CopyCommandList::CopyTexture(const Texture2D& dst, const LinearBuffer& src,
 	gxapi::TextureCopyDesc dstDesc =
 		gxapi::TextureCopyDesc::Texture(dstPlace.subresource);
 
+	FlushBarriers();
 	m_commandList->CopyTexture(
 		dst._GetResourcePtr(),
 		dstDesc,
@@ -282,6 +327,40 @@ void CopyCommandList::CopyTexture(const Texture2D& dst, const LinearBuffer& src,
 	);
 }
 
+void CopyCommandList::CopyTexture(const LinearBuffer& dst, const Texture2D& src, SubTexture2D srcPlace, gxapi::TextureCopyDesc bufferDesc) {
+	ExpectResourceState(dst, gxapi::eResourceState::COPY_DEST, { gxapi::ALL_SUBRESOURCES });
+	ExpectResourceState(src, gxapi::eResourceState::COPY_SOURCE, { srcPlace.subresource });
+
+	gxapi::TextureCopyDesc srcDesc =
+		gxapi::TextureCopyDesc::Texture(srcPlace.subresource);
+
+	FlushBarriers();
+	// Without a second corner the whole subresource is copied.
+	if (srcPlace.corner2.x >= 0 && srcPlace.corner2.y >= 0) {
+		auto top = std::max(intptr_t(0), srcPlace.corner1.y);
+		auto left = std::max(intptr_t(0), srcPlace.corner1.x);
+		gxapi::Cube srcRegion((int)top, (int)srcPlace.corner2.y, (int)left, (int)srcPlace.corner2.x, 0, 1);
+
+		m_commandList->CopyTexture(
+			dst._GetResourcePtr(),
+			bufferDesc,
+			0, 0, 0,
+			const_cast<gxapi::IResource*>(src._GetResourcePtr()),
+			srcDesc,
+			srcRegion
+		);
+	}
+	else {
+		m_commandList->CopyTexture(
+			dst._GetResourcePtr(),
+			bufferDesc,
+			0, 0, 0,
+			const_cast<gxapi::IResource*>(src._GetResourcePtr()),
+			srcDesc
+		);
+	}
+}
+
 
 
 // resource copy
@@ -69,7 +69,8 @@ public:
 		gxapi::IGraphicsApi* gxApi,
 		CommandListPool& commandListPool,
 		CommandAllocatorPool& commandAllocatorPool,
-		ScratchSpacePool& scratchSpacePool);
+		ScratchSpacePool& scratchSpacePool,
+		ResourceIndexRegistry& resourceIndices);
 	CopyCommandList(const CopyCommandList& rhs) = delete;
 	CopyCommandList(CopyCommandList&& rhs);
 	CopyCommandList& operator=(const CopyCommandList& rhs) = delete;
@@ -80,6 +81,7 @@ protected:
 		CommandListPool& commandListPool,
 		CommandAllocatorPool& commandAllocatorPool,
 		ScratchSpacePool& scratchSpacePool,
+		ResourceIndexRegistry& resourceIndices,
 		gxapi::eCommandListType type);
 
 public:
@@ -103,6 +105,10 @@ public:
 					 const LinearBuffer& src,
 					 SubTexture2D dstPlace,
 					 gxapi::TextureCopyDesc bufferDesc);
+	void CopyTexture(const LinearBuffer& dst,
+					 const Texture2D& src,
+					 SubTexture2D srcPlace,
+					 gxapi::TextureCopyDesc bufferDesc);
 	void CopyTexture(const Texture3D* dst,
 					 const Texture3D* src,
 					 SubTexture3D dstPlace = {},
@@ -117,8 +123,17 @@ protected:
 	//void ExpectResourceState(const MemoryObject& resource, gxapi::eResourceState state, unsigned subresource = gxapi::ALL_SUBRESOURCES);
 	//void ExpectResourceState(const MemoryObject& resource, const std::initializer_list<gxapi::eResourceState>& anyOfStates, unsigned subresource = gxapi::ALL_SUBRESOURCES);
 	virtual Decomposition Decompose() override;
+
+	/// <summary> Records the barriers collected since the last GPU command in a single call. </summary>
+	/// <remarks> Call before recording anything that executes on the GPU. </remarks>
+	void FlushBarriers();
+	void AddBarrier(const gxapi::ResourceBarrier& barrier) { m_pendingBarriers.push_back(barrier); }
 private:
+	/// <summary> Adds the transition to the pending barriers, merged with the pending one of the subresource. </summary>
+	void QueueTransition(const MemoryObject& resource, unsigned subresource, gxapi::eResourceState before, gxapi::eResourceState after);
+
 	gxapi::ICopyCommandList* m_commandList;
+	std::vector<gxapi::ResourceBarrier> m_pendingBarriers; // Transitions are deferred and merged until the next GPU command.
 };
 
 
@@ -14,11 +14,28 @@ namespace impl {
 
 
 CriticalBufferHeap::CriticalBufferHeap(gxapi::IGraphicsApi* graphicsApi) :
-	m_graphicsApi(graphicsApi)
+	m_graphicsApi(graphicsApi),
+	m_bufferHeaps(graphicsApi, gxapi::eHeapFlags::ALLOW_ONLY_BUFFERS),
+	m_textureHeaps(graphicsApi, gxapi::eHeapFlags::ALLOW_ONLY_NON_RT_DS_TEXTURES),
+	m_vertexBuffers(graphicsApi),
+	m_indexBuffers(graphicsApi)
 {}
 
 
-CriticalBufferHeap::UniquePtr CriticalBufferHeap::Allocate(gxapi::ResourceDesc desc, gxapi::ClearValue* clearValue) {
+CriticalBufferHeap::UniquePtr CriticalBufferHeap::Allocate(gxapi::ResourceDesc desc, gxapi::ClearValue* clearValue, bool& pageable) {
+	// Placed render targets and depth buffers would have to be cleared or discarded before first use,
+	// they are usually large anyways.
+	bool renderTarget = desc.type == gxapi::eResourceType::TEXTURE
+						&& (desc.textureDesc.flags & (gxapi::eResourceFlags::ALLOW_RENDER_TARGET | gxapi::eResourceFlags::ALLOW_DEPTH_STENCIL));
+	PlacedResourcePool* pool = desc.type == gxapi::eResourceType::BUFFER ? &m_bufferHeaps : renderTarget ? nullptr : &m_textureHeaps;
+	if (pool) {
+		if (UniquePtr resource = pool->Create(desc, gxapi::eResourceState::COMMON, clearValue)) {
+			pageable = false;
+			return resource;
+		}
+	}
+
+	pageable = true;
 	UniquePtr resource{
 		m_graphicsApi->CreateCommittedResource(
 			gxapi::HeapProperties(gxapi::eHeapType::DEFAULT, gxapi::eCpuPageProperty::UNKNOWN, gxapi::eMemoryPool::UNKNOWN),
@@ -72,48 +89,71 @@ gxapi::ClearValue CriticalBufferHeap::DetermineClearValue(const gxapi::ResourceD
 }
 
 
+template <class TextureT>
+TextureT CriticalBufferHeap::CreateTexture(const gxapi::ResourceDesc& apiDesc) {
+	gxapi::ClearValue clearValue = DetermineClearValue(apiDesc);
+	bool pageable;
+	auto resource = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr, pageable);
+
+	TextureT texture(std::move(resource), true, eResourceHeap::CRITICAL);
+	texture._SetPageable(pageable);
+	return texture;
+}
+
+
+LinearBuffer CriticalBufferHeap::CreateBuffer(size_t size, gxapi::eResourceFlags flags) {
+	auto apiDesc = gxapi::ResourceDesc::Buffer(size, flags);
+	bool pageable;
+	auto resource = Allocate(apiDesc, nullptr, pageable);
+
+	LinearBuffer buffer(std::move(resource), true, eResourceHeap::CRITICAL);
+	buffer._SetPageable(pageable);
+	return buffer;
+}
+
+
 VertexBuffer CriticalBufferHeap::CreateVertexBuffer(size_t size) {
+	if (auto range = m_vertexBuffers.Allocate(size)) {
+		return VertexBuffer(range->buffer, range->offset, size, std::move(range->release));
+	}
+
 	auto apiDesc = gxapi::ResourceDesc::Buffer(size);
-	gxapi::ClearValue clearValue = DetermineClearValue(apiDesc);
-	auto resource = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
+	bool pageable;
+	auto resource = Allocate(apiDesc, nullptr, pageable);
 
-	return VertexBuffer(std::move(resource), true, eResourceHeap::CRITICAL);
+	VertexBuffer buffer(std::move(resource), true, eResourceHeap::CRITICAL);
+	buffer._SetPageable(pageable);
+	return buffer;
 }
 
 
 IndexBuffer CriticalBufferHeap::CreateIndexBuffer(size_t size, size_t indexCount) {
+	if (auto range = m_indexBuffers.Allocate(size)) {
+		return IndexBuffer(range->buffer, range->offset, size, std::move(range->release), indexCount);
+	}
+
 	auto apiDesc = gxapi::ResourceDesc::Buffer(size);
-	gxapi::ClearValue clearValue = DetermineClearValue(apiDesc);
-	auto resource = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
+	bool pageable;
+	auto resource = Allocate(apiDesc, nullptr, pageable);
 
-	return IndexBuffer(std::move(resource), true, eResourceHeap::CRITICAL, indexCount);
+	IndexBuffer buffer(std::move(resource), true, eResourceHeap::CRITICAL, indexCount);
+	buffer._SetPageable(pageable);
+	return buffer;
 }
 
 
 Texture1D CriticalBufferHeap::CreateTexture1D(const Texture1DDesc& desc, gxapi::eResourceFlags flags) {
-	auto apiDesc = gxapi::ResourceDesc::Texture1DArray(desc.width, desc.format, desc.arraySize, flags, desc.mipLevels);
-	gxapi::ClearValue clearValue = DetermineClearValue(apiDesc);
-	auto resource = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
-
-	return Texture1D(std::move(resource), true, eResourceHeap::CRITICAL);
+	return CreateTexture<Texture1D>(gxapi::ResourceDesc::Texture1DArray(desc.width, desc.format, desc.arraySize, flags, desc.mipLevels));
 }
 
 
 Texture2D CriticalBufferHeap::CreateTexture2D(const Texture2DDesc& desc, gxapi::eResourceFlags flags) {
-	auto apiDesc = gxapi::ResourceDesc::Texture2DArray(desc.width, desc.height, desc.format, desc.arraySize, flags, desc.mipLevels);
-	gxapi::ClearValue clearValue = DetermineClearValue(apiDesc);
-	auto resource = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
-
-	return Texture2D(std::move(resource), true, eResourceHeap::CRITICAL);
+	return CreateTexture<Texture2D>(gxapi::ResourceDesc::Texture2DArray(desc.width, desc.height, desc.format, desc.arraySize, flags, desc.mipLevels));
 }
 
 
 Texture3D CriticalBufferHeap::CreateTexture3D(const Texture3DDesc& desc, gxapi::eResourceFlags flags) {
-	auto apiDesc = gxapi::ResourceDesc::Texture3D(desc.width, desc.height, desc.depth, desc.format, flags, desc.mipLevels);
-	gxapi::ClearValue clearValue = DetermineClearValue(apiDesc);
-	auto resource = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
-
-	return Texture3D(std::move(resource), true, eResourceHeap::CRITICAL);
+	return CreateTexture<Texture3D>(gxapi::ResourceDesc::Texture3D(desc.width, desc.height, desc.depth, desc.format, flags, desc.mipLevels));
 }
 
 
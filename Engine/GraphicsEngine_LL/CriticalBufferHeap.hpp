@@ -5,16 +5,23 @@
 
 #include "MemoryObject.hpp"
 #include "BufferHeap.hpp"
+#include "HeapSuballocator.hpp"
 
 namespace inl {
 namespace gxeng {
 
 namespace impl {
 
+/// <summary>
+/// Creates GPU-only resources. Small vertex and index buffers are ranges of shared buffers,
+/// other buffers and textures are placed in shared heaps, and only large ones or render targets
+/// get committed resources.
+/// </summary>
 class CriticalBufferHeap : public BufferHeap {
 public:
 	CriticalBufferHeap(gxapi::IGraphicsApi* graphicsApi);
 
+	LinearBuffer CreateBuffer(size_t size, gxapi::eResourceFlags flags = gxapi::eResourceFlags::NONE) override;
 	VertexBuffer CreateVertexBuffer(size_t size) override;
 	IndexBuffer CreateIndexBuffer(size_t size, size_t indexCount) override;
 	Texture1D CreateTexture1D(const Texture1DDesc& desc, gxapi::eResourceFlags flags = gxapi::eResourceFlags::NONE) override;
@@ -23,10 +30,17 @@ public:
 
 protected:
 	using UniquePtr = std::unique_ptr<gxapi::IResource, std::function<void(const gxapi::IResource*)>>;
-	UniquePtr Allocate(gxapi::ResourceDesc desc, gxapi::ClearValue* clearValue = nullptr);
+	/// <param name="pageable"> Set to false if the resource was placed in a heap. </param>
+	UniquePtr Allocate(gxapi::ResourceDesc desc, gxapi::ClearValue* clearValue, bool& pageable);
 	gxapi::ClearValue DetermineClearValue(const gxapi::ResourceDesc& desc);
+	template <class TextureT>
+	TextureT CreateTexture(const gxapi::ResourceDesc& apiDesc);
 private:
 	gxapi::IGraphicsApi* m_graphicsApi;
+	PlacedResourcePool m_bufferHeaps;
+	PlacedResourcePool m_textureHeaps;
+	BufferSuballocator m_vertexBuffers;
+	BufferSuballocator m_indexBuffers;
 };
 
 
@@ -1,5 +1,10 @@
 #include "Cubemap.hpp"
 
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+
+
 namespace inl::gxeng {
 
 
@@ -19,6 +24,74 @@ const TextureViewCube& Cubemap::GetSrv() {
 }
 
 
+void Cubemap::Prefilter(uint64_t specularSize, unsigned specularMips) {
+	const Texture2D& source = GetTexture();
+	if (!source) {
+		throw InvalidStateException("Must create image first.");
+	}
+	MemoryManager& memoryManager = *GetMemoryManager();
+	const gxapi::eFormat format = gxapi::eFormat::R16G16B16A16_FLOAT;
+
+	if (specularSize == 0) {
+		specularSize = source.GetWidth();
+	}
+	if (specularMips == 0) {
+		for (uint64_t size = specularSize; size >= 8; size /= 2) {
+			++specularMips;
+		}
+		specularMips = std::max(specularMips, 1u);
+	}
+
+	if (!m_radiance || m_radiance.GetWidth() != source.GetWidth()) {
+		Texture2DDesc desc(source.GetWidth(), (uint32_t)source.GetWidth(), format, 0, 6);
+		m_radiance = memoryManager.CreateTexture2D(eResourceHeap::CRITICAL, desc, gxapi::eResourceFlags::ALLOW_UNORDERED_ACCESS);
+		m_radiance.SetName("Cubemap prefilter radiance");
+	}
+	if (!m_specular || m_specular.GetWidth() != specularSize || m_specular.GetNumMiplevels() != specularMips) {
+		Texture2DDesc desc(specularSize, (uint32_t)specularSize, format, (uint16_t)specularMips, 6);
+		m_specular = memoryManager.CreateTexture2D(eResourceHeap::CRITICAL, desc, gxapi::eResourceFlags::ALLOW_UNORDERED_ACCESS);
+		m_specular.SetName("Cubemap prefiltered specular");
+
+		gxapi::SrvTextureCubeArray srvdesc;
+		srvdesc.indexOfFirst2DTex = 0;
+		srvdesc.mipLevelClamping = 0;
+		srvdesc.mostDetailedMip = 0;
+		srvdesc.numCubes = 1;
+		srvdesc.numMipLevels = -1;
+		m_specularView = TextureViewCube(m_specular, *m_descriptorHeap, format, srvdesc);
+	}
+	if (!m_irradiance) {
+		m_irradiance = memoryManager.CreateBuffer(eResourceHeap::CRITICAL, 9 * 4 * sizeof(float), gxapi::eResourceFlags::ALLOW_UNORDERED_ACCESS);
+		m_irradiance.SetName("Cubemap irradiance");
+
+		gxapi::SrvBuffer srvdesc;
+		srvdesc.firstElement = 0;
+		srvdesc.numElements = 9;
+		srvdesc.structureStrideInBytes = 4 * sizeof(float);
+		srvdesc.isRaw = false;
+		m_irradianceView = BufferView(m_irradiance, *m_descriptorHeap, gxapi::eFormat::UNKNOWN, srvdesc);
+	}
+
+	m_prefiltered = std::make_shared<std::atomic<bool>>(false);
+	memoryManager.GetUploadManager().PrefilterCubemap({ source, m_radiance, m_specular, m_irradiance, m_prefiltered });
+}
+
+
+bool Cubemap::IsPrefiltered() const {
+	return m_prefiltered && m_prefiltered->load();
+}
+
+
+const TextureViewCube& Cubemap::GetSpecularSrv() const {
+	return m_specularView;
+}
+
+
+const BufferView& Cubemap::GetIrradianceSrv() const {
+	return m_irradianceView;
+}
+
+
 void Cubemap::CreateResourceView(const Texture2D& texture) {
 	assert(texture.GetArrayCount() == 6);
 
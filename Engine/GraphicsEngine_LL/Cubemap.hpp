@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 
 #include "ImageBase.hpp"
@@ -48,12 +49,38 @@ public:
 
 	const TextureViewCube& GetSrv();
 
+	/// <summary> Filters the cubemap for image based lighting on the GPU, from what its top level holds once the next frame's uploads are done. </summary>
+	/// <param name="specularSize"> Width of the top level of the specular chain, 0 for the width of the cubemap. </param>
+	/// <param name="specularMips"> Levels of the specular chain, 0 for all levels down to 8x8 texels. </param>
+	/// <remarks> Level i of <see cref="GetSpecularSrv"/> is the radiance convolved with the GGX lobe of roughness i / (levels - 1).
+	///		<see cref="GetIrradianceSrv"/> holds the irradiance as 9 spherical harmonics coefficients, divide by pi for diffuse lighting.
+	///		The work is spread over the next frames, see <see cref="CubemapPrefilterTask"/>. Calling again, like after re-capturing a probe,
+	///		restarts it, the levels are replaced one by one. </remarks>
+	/// <exception cref="InvalidStateException"> If the layout is not set. </exception>
+	void Prefilter(uint64_t specularSize = 0, unsigned specularMips = 0);
+
+	/// <summary> True once the last prefilter has finished, its results are used by the frames from then on. </summary>
+	bool IsPrefiltered() const;
+
+	/// <summary> The GGX prefiltered levels, empty before the first prefilter. </summary>
+	const TextureViewCube& GetSpecularSrv() const;
+	/// <summary> Structured buffer of 9 float4, the RGB spherical harmonics coefficients of the irradiance, empty before the first prefilter. </summary>
+	const BufferView& GetIrradianceSrv() const;
+
 private:
 	void CreateResourceView(const Texture2D& texture) override;
 	static int GetFaceIndex(eAxis facePosition);
 
 private:
 	TextureViewCube m_resourceView;
+
+	// Prefiltering, the radiance chain is scratch space kept for re-captures.
+	Texture2D m_radiance;
+	Texture2D m_specular;
+	LinearBuffer m_irradiance;
+	TextureViewCube m_specularView;
+	BufferView m_irradianceView;
+	std::shared_ptr<std::atomic<bool>> m_prefiltered;
 };
 
 
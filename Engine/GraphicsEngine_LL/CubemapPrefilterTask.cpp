@@ -0,0 +1,312 @@
+#include "CubemapPrefilterTask.hpp"
+
+#include "ComputeCommandList.hpp"
+
+#include <algorithm>
+
+
+namespace inl::gxeng {
+
+
+static constexpr unsigned GroupSize = 8;
+static constexpr unsigned FaceCount = 6;
+
+
+struct PrefilterUniforms {
+	float roughness;
+	uint32_t sampleCount;
+	float radianceSize;
+	float radianceMips;
+	uint32_t copy; // The radiance level is a copy of the source.
+};
+
+
+static uint64_t MipSize(uint64_t size, unsigned mip) {
+	return std::max(uint64_t(1), size >> mip);
+}
+
+
+static void SetLevelState(ComputeCommandList& commandList, const Texture2D& texture, unsigned mip, gxapi::eResourceState state) {
+	for (unsigned face = 0; face < FaceCount; ++face) {
+		commandList.SetResourceState(texture, state, texture.GetSubresourceIndex(mip, face, 0));
+	}
+}
+
+
+static void SetLevelReadable(ComputeCommandList& commandList, const Texture2D& texture, unsigned mip) {
+	for (unsigned face = 0; face < FaceCount; ++face) {
+		commandList.SetResourceState(texture, { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE }, texture.GetSubresourceIndex(mip, face, 0));
+	}
+}
+
+
+std::vector<CubemapPrefilterTask::Slice> CubemapPrefilterTask::GetSlices(uint64_t radianceSize, uint64_t specularSize, unsigned specularMips) {
+	std::vector<Slice> slices;
+
+	// The whole radiance chain costs a third more than a copy of the top level.
+	const uint64_t radianceTexels = FaceCount * radianceSize * radianceSize;
+	slices.push_back({ Slice::RADIANCE, 0, radianceTexels + radianceTexels / 3 });
+
+	unsigned irradianceMip = 0;
+	while (MipSize(radianceSize, irradianceMip) > IrradianceSize) {
+		++irradianceMip;
+	}
+	const uint64_t irradianceSize = MipSize(radianceSize, irradianceMip);
+	slices.push_back({ Slice::IRRADIANCE, irradianceMip, FaceCount * irradianceSize * irradianceSize });
+
+	for (unsigned mip = 0; mip < specularMips; ++mip) {
+		const uint64_t size = MipSize(specularSize, mip);
+		const uint64_t samples = mip == 0 ? 1 : SampleCount;
+		slices.push_back({ Slice::SPECULAR, mip, FaceCount * size * size * samples });
+	}
+	return slices;
+}
+
+
+size_t CubemapPrefilterTask::TakeSlices(const std::vector<Slice>& slices, size_t first, uint64_t& budget) {
+	size_t count = 0;
+	while (first + count < slices.size()) {
+		const uint64_t cost = slices[first + count].cost;
+		if (cost > budget && count > 0) {
+			break;
+		}
+		budget -= std::min(cost, budget);
+		++count;
+		if (budget == 0) {
+			break;
+		}
+	}
+	return count;
+}
+
+
+float CubemapPrefilterTask::GetRoughness(unsigned mip, unsigned mipCount) {
+	return mipCount > 1 ? float(mip) / float(mipCount - 1) : 0.0f;
+}
+
+
+void CubemapPrefilterTask::AddRequests(const std::vector<UploadManager::PrefilterDescription>* requests) {
+	if (!requests) {
+		return;
+	}
+	for (const auto& request : *requests) {
+		// Re-captures restart the filtering of the probe.
+		auto it = std::find_if(m_jobs.begin(), m_jobs.end(), [&request](const Job& job) {
+			return job.request.specular == request.specular;
+		});
+		Job job;
+		job.request = request;
+		job.slices = GetSlices(request.radiance.GetWidth(), request.specular.GetWidth(), request.specular.GetNumMiplevels());
+		if (it != m_jobs.end()) {
+			*it = std::move(job);
+		}
+		else {
+			m_jobs.push_back(std::move(job));
+		}
+	}
+}
+
+
+bool CubemapPrefilterTask::HasWork() const {
+	return !m_jobs.empty();
+}
+
+
+void CubemapPrefilterTask::Setup(SetupContext& context) {
+	m_passes.clear();
+	if (!HasWork()) {
+		return;
+	}
+
+	if (!m_binder) {
+		BindParameterDesc uniformsBindParamDesc;
+		m_uniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
+		uniformsBindParamDesc.parameter = m_uniformsBindParam;
+		uniformsBindParamDesc.constantSize = sizeof(PrefilterUniforms);
+		uniformsBindParamDesc.relativeAccessFrequency = 0;
+		uniformsBindParamDesc.relativeChangeFrequency = 0;
+		uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc inputBindParamDesc;
+		m_inputBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		inputBindParamDesc.parameter = m_inputBindParam;
+		inputBindParamDesc.constantSize = 0;
+		inputBindParamDesc.relativeAccessFrequency = 0;
+		inputBindParamDesc.relativeChangeFrequency = 0;
+		inputBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc outputBindParamDesc;
+		m_outputBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		outputBindParamDesc.parameter = m_outputBindParam;
+		outputBindParamDesc.constantSize = 0;
+		outputBindParamDesc.relativeAccessFrequency = 0;
+		outputBindParamDesc.relativeChangeFrequency = 0;
+		outputBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		gxapi::StaticSamplerDesc samplerDesc;
+		samplerDesc.shaderRegister = 0;
+		samplerDesc.filter = gxapi::eTextureFilterMode::MIN_MAG_MIP_LINEAR;
+		samplerDesc.addressU = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.addressV = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.addressW = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.mipLevelBias = 0.f;
+		samplerDesc.registerSpace = 0;
+		samplerDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		m_binder = context.CreateBinder({ uniformsBindParamDesc, inputBindParamDesc, outputBindParamDesc }, { samplerDesc });
+
+		static const char* const macros[] = { "RADIANCE=1", "IRRADIANCE=1", "SPECULAR=1" };
+		for (size_t variant = 0; variant < m_shaders.size(); ++variant) {
+			ShaderParts shaderParts;
+			shaderParts.cs = true;
+			m_shaders[variant] = context.CreateShader("PrefilterCubemap", shaderParts, macros[variant]);
+
+			gxapi::ComputePipelineStateDesc csoDesc;
+			csoDesc.rootSignature = m_binder.GetRootSignature();
+			csoDesc.cs = m_shaders[variant].cs;
+			m_CSOs[variant].reset(context.CreatePSO(csoDesc));
+		}
+	}
+
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = FaceCount;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.numMipLevels = 1;
+	srvDesc.planeIndex = 0;
+
+	gxapi::UavTexture2DArray uavDesc;
+	uavDesc.activeArraySize = FaceCount;
+	uavDesc.firstArrayElement = 0;
+	uavDesc.planeIndex = 0;
+
+	uint64_t budget = FrameSampleBudget;
+	for (size_t jobIndex = 0; jobIndex < m_jobs.size() && budget > 0; ++jobIndex) {
+		Job& job = m_jobs[jobIndex];
+		const auto& request = job.request;
+		const size_t count = TakeSlices(job.slices, job.next, budget);
+
+		for (size_t i = job.next; i < job.next + count; ++i) {
+			Pass pass;
+			pass.slice = job.slices[i];
+			pass.job = jobIndex;
+			const Texture2D& radiance = request.radiance;
+			switch (pass.slice.type) {
+				case Slice::RADIANCE:
+					for (unsigned mip = 0; mip < radiance.GetNumMiplevels(); ++mip) {
+						srvDesc.mostDetailedMip = mip == 0 ? 0 : mip - 1;
+						pass.inputs.push_back(context.CreateSrv(mip == 0 ? request.source : radiance, mip == 0 ? request.source.GetFormat() : radiance.GetFormat(), srvDesc));
+						uavDesc.mipLevel = mip;
+						pass.outputs.push_back(context.CreateUav(radiance, radiance.GetFormat(), uavDesc));
+					}
+					break;
+				case Slice::IRRADIANCE: {
+					srvDesc.mostDetailedMip = pass.slice.mip;
+					pass.inputs.push_back(context.CreateSrv(radiance, radiance.GetFormat(), srvDesc));
+
+					gxapi::UavBuffer structuredDesc;
+					structuredDesc.raw = false;
+					structuredDesc.firstElement = 0;
+					structuredDesc.numElements = 9;
+					structuredDesc.elementStride = 4 * sizeof(float);
+					structuredDesc.countOffset = 0;
+					pass.irradiance = context.CreateUav(request.irradiance, gxapi::eFormat::UNKNOWN, structuredDesc);
+					break;
+				}
+				case Slice::SPECULAR: {
+					gxapi::SrvTextureCubeArray cubeDesc;
+					cubeDesc.indexOfFirst2DTex = 0;
+					cubeDesc.mipLevelClamping = 0;
+					cubeDesc.mostDetailedMip = 0;
+					cubeDesc.numCubes = 1;
+					cubeDesc.numMipLevels = -1;
+					pass.radianceCube = context.CreateSrv(radiance, radiance.GetFormat(), cubeDesc);
+					uavDesc.mipLevel = pass.slice.mip;
+					pass.outputs.push_back(context.CreateUav(request.specular, request.specular.GetFormat(), uavDesc));
+					break;
+				}
+			}
+			m_passes.push_back(std::move(pass));
+		}
+		job.next += count;
+	}
+}
+
+
+void CubemapPrefilterTask::Execute(RenderContext& context) {
+	if (m_passes.empty()) {
+		return;
+	}
+
+	auto& commandList = context.AsCompute();
+	commandList.SetComputeBinder(&m_binder);
+	for (const auto& pass : m_passes) {
+		const auto& request = m_jobs[pass.job].request;
+		const Texture2D& radiance = request.radiance;
+		const Texture2D& specular = request.specular;
+
+		PrefilterUniforms uniforms = {};
+		uniforms.radianceSize = float(radiance.GetWidth());
+		uniforms.radianceMips = float(radiance.GetNumMiplevels());
+
+		commandList.SetPipelineState(m_CSOs[pass.slice.type].get());
+		switch (pass.slice.type) {
+			case Slice::RADIANCE:
+				SetLevelReadable(commandList, request.source, 0);
+				for (unsigned mip = 0; mip < (unsigned)pass.outputs.size(); ++mip) {
+					if (mip > 0) {
+						SetLevelReadable(commandList, radiance, mip - 1);
+					}
+					SetLevelState(commandList, radiance, mip, gxapi::eResourceState::UNORDERED_ACCESS);
+					uniforms.copy = mip == 0;
+					commandList.BindCompute(m_uniformsBindParam, &uniforms, sizeof(uniforms));
+					commandList.BindCompute(m_inputBindParam, pass.inputs[mip]);
+					commandList.BindCompute(m_outputBindParam, pass.outputs[mip]);
+
+					const uint64_t size = MipSize(radiance.GetWidth(), mip);
+					commandList.Dispatch(unsigned((size + GroupSize - 1) / GroupSize), unsigned((size + GroupSize - 1) / GroupSize), FaceCount);
+				}
+				SetLevelReadable(commandList, radiance, radiance.GetNumMiplevels() - 1);
+				break;
+			case Slice::IRRADIANCE:
+				commandList.SetResourceState(request.irradiance, gxapi::eResourceState::UNORDERED_ACCESS);
+				commandList.BindCompute(m_uniformsBindParam, &uniforms, sizeof(uniforms));
+				commandList.BindCompute(m_inputBindParam, pass.inputs[0]);
+				commandList.BindCompute(m_outputBindParam, pass.irradiance);
+				// A single group sums all texels of the level.
+				commandList.Dispatch(1, 1, 1);
+				commandList.SetResourceState(request.irradiance, { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+				break;
+			case Slice::SPECULAR: {
+				const unsigned mip = pass.slice.mip;
+				uniforms.roughness = GetRoughness(mip, specular.GetNumMiplevels());
+				uniforms.sampleCount = mip == 0 ? 1 : SampleCount;
+				SetLevelState(commandList, specular, mip, gxapi::eResourceState::UNORDERED_ACCESS);
+				commandList.BindCompute(m_uniformsBindParam, &uniforms, sizeof(uniforms));
+				commandList.BindCompute(m_inputBindParam, pass.radianceCube);
+				commandList.BindCompute(m_outputBindParam, pass.outputs[0]);
+
+				const uint64_t size = MipSize(specular.GetWidth(), mip);
+				commandList.Dispatch(unsigned((size + GroupSize - 1) / GroupSize), unsigned((size + GroupSize - 1) / GroupSize), FaceCount);
+				SetLevelReadable(commandList, specular, mip);
+				break;
+			}
+		}
+	}
+
+	// Finished jobs are dropped, the owners see their results from this frame on.
+	auto finished = std::remove_if(m_jobs.begin(), m_jobs.end(), [](const Job& job) {
+		if (job.next < job.slices.size()) {
+			return false;
+		}
+		if (job.request.done) {
+			job.request.done->store(true);
+		}
+		return true;
+	});
+	m_jobs.erase(finished, m_jobs.end());
+	m_passes.clear();
+}
+
+
+} // namespace inl::gxeng
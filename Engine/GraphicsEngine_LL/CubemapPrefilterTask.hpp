@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Binder.hpp"
+#include "GraphicsNode.hpp"
+#include "ResourceView.hpp"
+#include "ShaderManager.hpp"
+#include "UploadManager.hpp"
+
+#include <GraphicsApi_LL/IPipelineState.hpp>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary>
+/// Prefilters cubemaps for image based lighting on the GPU, run by the scheduler right after the mip generations.
+/// </summary>
+/// <remarks> The source is box filtered into a radiance chain first, which the rough specular levels sample by the density of their
+///		GGX importance samples, so few samples are enough. Irradiance is projected to 3rd order spherical harmonics from a small level of the chain.
+///		The work of a request is split into slices, and slices of a frame stop at <see cref="FrameSampleBudget"/>,
+///		so re-capturing probes every frame only spreads their filtering over more frames. Shaders and pipeline states are kept between frames. </remarks>
+class CubemapPrefilterTask : public GraphicsTask {
+public:
+	/// <summary> Texels times samples filtered per frame at most, unless a single slice is larger. About a millisecond on mid range GPUs. </summary>
+	static constexpr uint64_t FrameSampleBudget = 1u << 22;
+	/// <summary> GGX samples per texel of the rough specular levels, the sharpest level is a copy. </summary>
+	static constexpr unsigned SampleCount = 64;
+	/// <summary> Irradiance is projected from the largest radiance level no larger than this. </summary>
+	static constexpr uint64_t IrradianceSize = 32;
+
+	/// <summary> Work recorded in the same frame. </summary>
+	struct Slice {
+		enum eType {
+			RADIANCE, // Copies the source and box filters the radiance chain.
+			IRRADIANCE, // Projects a radiance level to spherical harmonics.
+			SPECULAR, // Filters a level of the specular texture.
+		};
+		eType type;
+		unsigned mip; // Specular level, or the projected radiance level.
+		uint64_t cost; // Texels times samples.
+	};
+
+	/// <summary> The slices of a prefilter in order: the radiance chain, the irradiance, then the specular levels from the sharpest one. </summary>
+	static std::vector<Slice> GetSlices(uint64_t radianceSize, uint64_t specularSize, unsigned specularMips);
+	/// <summary> Number of slices from <paramref name="first"/> on that fit the budget, at least one. The used samples are taken off the budget. </summary>
+	static size_t TakeSlices(const std::vector<Slice>& slices, size_t first, uint64_t& budget);
+	/// <summary> Roughness the level of the specular chain is filtered with. </summary>
+	static float GetRoughness(unsigned mip, unsigned mipCount);
+
+	/// <summary> Starts prefiltering the requests in the coming frames. </summary>
+	void AddRequests(const std::vector<UploadManager::PrefilterDescription>* requests);
+	bool HasWork() const;
+
+	void Setup(SetupContext& context) override;
+	void Execute(RenderContext& context) override;
+
+private:
+	struct Job {
+		UploadManager::PrefilterDescription request;
+		std::vector<Slice> slices;
+		size_t next = 0;
+	};
+	struct Pass {
+		Slice slice;
+		size_t job;
+		std::vector<TextureView2D> inputs; // The level above each radiance level, or the projected level.
+		std::vector<RWTextureView2D> outputs; // Radiance levels, or the specular level.
+		TextureViewCube radianceCube; // All levels, sampled by the specular slices.
+		RWBufferView irradiance;
+	};
+
+private:
+	std::vector<Job> m_jobs;
+	std::vector<Pass> m_passes; // Views of the current frame.
+
+	Binder m_binder;
+	BindParameter m_uniformsBindParam;
+	BindParameter m_inputBindParam;
+	BindParameter m_outputBindParam;
+	std::array<ShaderProgram, 3> m_shaders; // By slice type.
+	std::array<std::unique_ptr<gxapi::IPipelineState>, 3> m_CSOs;
+};
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,163 @@
+#include "DepthPyramid.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+
+namespace inl::gxeng {
+
+
+void DepthPyramid::Assign(const float* maxDepth, size_t width, size_t height, size_t rowPitch, Vec2 viewportSize, const Mat44& viewProjection) {
+	if (width == 0 || height == 0) {
+		throw InvalidArgumentException("Depth pyramid must have at least one texel.");
+	}
+	if (rowPitch < width) {
+		throw InvalidArgumentException("Row pitch must be at least the width.", "rowPitch");
+	}
+
+	m_viewportSize = viewportSize;
+	m_viewProjection = viewProjection;
+
+	// Count levels down to 1x1.
+	size_t levelCount = 1;
+	for (size_t w = width, h = height; w > 1 || h > 1; w = (w + 1) / 2, h = (h + 1) / 2) {
+		++levelCount;
+	}
+	if (m_levels.size() < levelCount) {
+		m_levels.resize(levelCount);
+	}
+	m_levelCount = levelCount;
+
+	Level& base = m_levels[0];
+	base.width = width;
+	base.height = height;
+	base.depth.resize(width * height);
+	for (size_t y = 0; y < height; ++y) {
+		std::copy(maxDepth + y * rowPitch, maxDepth + y * rowPitch + width, base.depth.begin() + y * width);
+	}
+
+	for (size_t l = 1; l < levelCount; ++l) {
+		const Level& fine = m_levels[l - 1];
+		Level& coarse = m_levels[l];
+		coarse.width = (fine.width + 1) / 2;
+		coarse.height = (fine.height + 1) / 2;
+		coarse.depth.resize(coarse.width * coarse.height);
+		for (size_t y = 0; y < coarse.height; ++y) {
+			size_t y0 = 2 * y, y1 = std::min(2 * y + 1, fine.height - 1);
+			for (size_t x = 0; x < coarse.width; ++x) {
+				size_t x0 = 2 * x, x1 = std::min(2 * x + 1, fine.width - 1);
+				coarse.depth[y * coarse.width + x] = std::max(
+					std::max(fine.depth[y0 * fine.width + x0], fine.depth[y0 * fine.width + x1]),
+					std::max(fine.depth[y1 * fine.width + x0], fine.depth[y1 * fine.width + x1]));
+			}
+		}
+	}
+}
+
+
+void DepthPyramid::Clear() {
+	m_levelCount = 0;
+}
+
+
+bool DepthPyramid::IsEmpty() const {
+	return m_levelCount == 0;
+}
+
+
+size_t DepthPyramid::GetLevelCount() const {
+	return m_levelCount;
+}
+
+
+size_t DepthPyramid::GetWidth(size_t level) const {
+	return level < m_levelCount ? m_levels[level].width : 0;
+}
+
+
+size_t DepthPyramid::GetHeight(size_t level) const {
+	return level < m_levelCount ? m_levels[level].height : 0;
+}
+
+
+float DepthPyramid::GetDepth(size_t level, size_t x, size_t y) const {
+	assert(level < m_levelCount);
+	const Level& l = m_levels[level];
+	assert(x < l.width && y < l.height);
+	return l.depth[y * l.width + x];
+}
+
+
+const Mat44& DepthPyramid::GetViewProjection() const {
+	return m_viewProjection;
+}
+
+
+bool DepthPyramid::IsOccluded(const BoundingBox& worldBounds) const {
+	if (IsEmpty() || worldBounds.IsEmpty()) {
+		return false;
+	}
+
+	// Screen space rectangle and nearest depth of the box.
+	Vec2 lower = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+	Vec2 upper = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+	float nearestDepth = std::numeric_limits<float>::max();
+	for (int i = 0; i < 8; ++i) {
+		Vec3 corner = {
+			(i & 1) ? worldBounds.upper.x : worldBounds.lower.x,
+			(i & 2) ? worldBounds.upper.y : worldBounds.lower.y,
+			(i & 4) ? worldBounds.upper.z : worldBounds.lower.z,
+		};
+		Vec4 clip = Vec4(corner, 1.0f) * m_viewProjection;
+		if (clip.w <= std::numeric_limits<float>::epsilon()) {
+			return false; // Behind the camera, the projection is meaningless.
+		}
+		Vec3 ndc = Vec3(clip.x, clip.y, clip.z) / clip.w;
+		lower = Min(lower, Vec2(ndc.x, ndc.y));
+		upper = Max(upper, Vec2(ndc.x, ndc.y));
+		nearestDepth = std::min(nearestDepth, ndc.z);
+	}
+	if (nearestDepth < 0.0f) {
+		return false;
+	}
+
+	// Normalized device coordinates to base level texels, Y points down in textures.
+	float left = (lower.x * 0.5f + 0.5f) * m_viewportSize.x;
+	float right = (upper.x * 0.5f + 0.5f) * m_viewportSize.x;
+	float top = (0.5f - upper.y * 0.5f) * m_viewportSize.y;
+	float bottom = (0.5f - lower.y * 0.5f) * m_viewportSize.y;
+	if (right <= 0.0f || bottom <= 0.0f || left >= m_viewportSize.x || top >= m_viewportSize.y) {
+		return false;
+	}
+	left = std::max(left, 0.0f);
+	top = std::max(top, 0.0f);
+	right = std::min(right, m_viewportSize.x);
+	bottom = std::min(bottom, m_viewportSize.y);
+
+	// A span no longer than the texel size touches at most two texels per axis.
+	float size = std::max(right - left, bottom - top);
+	size_t level = size > 1.0f ? size_t(std::ceil(std::log2(size))) : 0;
+	level = std::min(level, m_levelCount - 1);
+
+	const Level& l = m_levels[level];
+	float scale = 1.0f / float(size_t(1) << level);
+	size_t x0 = std::min(size_t(left * scale), l.width - 1);
+	size_t y0 = std::min(size_t(top * scale), l.height - 1);
+	size_t x1 = std::max(x0, std::min(size_t(std::max(std::ceil(right * scale) - 1.0f, 0.0f)), l.width - 1));
+	size_t y1 = std::max(y0, std::min(size_t(std::max(std::ceil(bottom * scale) - 1.0f, 0.0f)), l.height - 1));
+
+	float occluderDepth = 0.0f;
+	for (size_t y = y0; y <= y1; ++y) {
+		for (size_t x = x0; x <= x1; ++x) {
+			occluderDepth = std::max(occluderDepth, l.depth[y * l.width + x]);
+		}
+	}
+	return nearestDepth > occluderDepth;
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "BoundingVolumes.hpp"
+
+#include <InlineMath.hpp>
+
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary>
+/// CPU side copy of a depth buffer as a pyramid of maximum depths, for conservative occlusion tests.
+/// </summary>
+/// <remarks> Uses the engine's depth conventions: cleared to 1, closer surfaces have smaller depth.
+///		Each level stores the maximum of the 2x2 texels below it, odd sizes are rounded up.
+///		The pyramid is usually a few frames old, so only static occluders hide objects reliably. </remarks>
+class DepthPyramid {
+	struct Level {
+		size_t width;
+		size_t height;
+		std::vector<float> depth;
+	};
+public:
+	/// <summary> Replaces the contents with a new base level and builds the coarser levels. </summary>
+	/// <param name="maxDepth"> Row-major maximum depths of the base level. </param>
+	/// <param name="rowPitch"> Distance between rows of <paramref name="maxDepth"/> in floats. </param>
+	/// <param name="viewportSize"> Size of the rendered image measured in base level texels.
+	///		Rounding up while reducing may leave partial texels at the right and bottom, so it can be less than the base size. </param>
+	/// <param name="viewProjection"> The camera the depth was rendered with. </param>
+	void Assign(const float* maxDepth, size_t width, size_t height, size_t rowPitch, Vec2 viewportSize, const Mat44& viewProjection);
+	void Clear();
+
+	bool IsEmpty() const;
+	size_t GetLevelCount() const;
+	size_t GetWidth(size_t level = 0) const;
+	size_t GetHeight(size_t level = 0) const;
+	float GetDepth(size_t level, size_t x, size_t y) const;
+	const Mat44& GetViewProjection() const;
+
+	/// <summary> True if the box is certainly behind the stored depth, as seen from the stored camera. </summary>
+	/// <remarks> Boxes that are off screen or cross the near plane are never occluded, nor is anything if the pyramid is empty. </remarks>
+	bool IsOccluded(const BoundingBox& worldBounds) const;
+private:
+	std::vector<Level> m_levels;
+	size_t m_levelCount = 0; // Levels beyond this are kept allocated for reuse.
+	Vec2 m_viewportSize = { 0.0f, 0.0f };
+	Mat44 m_viewProjection = Mat44::Identity();
+};
+
+
+} // namespace inl::gxeng
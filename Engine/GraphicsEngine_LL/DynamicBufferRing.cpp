@@ -0,0 +1,128 @@
+#include "DynamicBufferRing.hpp"
+
+#include "../GraphicsApi_LL/IResource.hpp"
+#include "../BaseLibrary/Exception/Exception.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace inl::gxeng {
+
+
+DynamicBufferRing::DynamicBufferRing(gxapi::IGraphicsApi* graphicsApi) : m_graphicsApi(graphicsApi) {}
+
+
+TransientVertexBuffer DynamicBufferRing::AllocateVertices(size_t size) {
+	if (size == 0) {
+		throw InvalidArgumentException("Vertex buffers cannot be empty.");
+	}
+	Allocation allocation = Allocate(size);
+
+	// The ring keeps the page until the GPU is done with the frame, the range has nothing to free.
+	TransientVertexBuffer result;
+	result.buffer = VertexBuffer(allocation.buffer, allocation.offset, size, [] {});
+	result.data = allocation.cpuAddress;
+	return result;
+}
+
+
+TransientIndexBuffer DynamicBufferRing::AllocateIndices(size_t indexCount, bool is32Bit) {
+	if (indexCount == 0) {
+		throw InvalidArgumentException("Index buffers cannot be empty.");
+	}
+	const size_t size = indexCount * (is32Bit ? sizeof(uint32_t) : sizeof(uint16_t));
+	Allocation allocation = Allocate(size);
+
+	TransientIndexBuffer result;
+	result.buffer = IndexBuffer(allocation.buffer, allocation.offset, size, [] {}, indexCount);
+	result.data = allocation.cpuAddress;
+	result.is32Bit = is32Bit;
+	return result;
+}
+
+
+void DynamicBufferRing::OnFrameBeginHost(uint64_t frameId) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_currentFrameId = frameId;
+	m_frameUsage = 0;
+}
+
+
+void DynamicBufferRing::OnFrameCompleteDevice(uint64_t frameId) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_firstUnfinishedFrameId = std::max(m_firstUnfinishedFrameId, frameId + 1);
+}
+
+
+size_t DynamicBufferRing::GetFrameUsage() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_frameUsage;
+}
+
+
+size_t DynamicBufferRing::GetCapacity() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size_t capacity = 0;
+	for (const Page& page : m_pages) {
+		capacity += page.size;
+	}
+	return capacity;
+}
+
+
+DynamicBufferRing::Allocation DynamicBufferRing::Allocate(size_t size) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto isFree = [this](const Page& page) { return page.lastFrameId < m_firstUnfinishedFrameId; };
+	auto snap = [](size_t value) { return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1); };
+
+	// Try the current page first, then move on to the next one the GPU is done with.
+	// If all of them are in flight, a new page is inserted into the rotation, large enough for the allocation.
+	Page* page = m_pages.empty() ? nullptr : &m_pages[m_currentPage];
+	if (page && isFree(*page)) {
+		page->consumedSize = 0;
+	}
+	if (!page || snap(page->consumedSize) + size > page->size) {
+		page = nullptr;
+		for (size_t i = 1; i < m_pages.size() && !page; ++i) {
+			size_t index = (m_currentPage + i) % m_pages.size();
+			if (isFree(m_pages[index]) && size <= m_pages[index].size) {
+				m_currentPage = index;
+				page = &m_pages[index];
+				page->consumedSize = 0;
+			}
+		}
+		if (!page) {
+			m_currentPage = m_pages.empty() ? 0 : m_currentPage + 1;
+			m_pages.insert(m_pages.begin() + m_currentPage, CreatePage(std::max(size, PAGE_SIZE)));
+			page = &m_pages[m_currentPage];
+		}
+	}
+
+	size_t offset = snap(page->consumedSize);
+	page->consumedSize = offset + size;
+	page->lastFrameId = m_currentFrameId;
+	m_frameUsage += size;
+	return { page->buffer, offset, page->cpuAddress + offset };
+}
+
+
+DynamicBufferRing::Page DynamicBufferRing::CreatePage(size_t size) const {
+	auto resource = MemoryObject::UniquePtr(
+		m_graphicsApi->CreateCommittedResource(
+			gxapi::HeapProperties(gxapi::eHeapType::UPLOAD),
+			gxapi::eHeapFlags::NONE,
+			gxapi::ResourceDesc::Buffer(size),
+			gxapi::eResourceState::GENERIC_READ),
+		std::default_delete<const gxapi::IResource>());
+	resource->SetName("Dynamic geometry page");
+
+	// Upload heaps may stay mapped, the CPU only writes them.
+	gxapi::MemoryRange noReadRange{ 0, 0 };
+	auto cpuAddress = reinterpret_cast<uint8_t*>(resource->Map(0, &noReadRange));
+
+	return { LinearBuffer(std::move(resource), true, eResourceHeap::UPLOAD), cpuAddress, size, 0, 0 };
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "MemoryObject.hpp"
+#include "PipelineEventListener.hpp"
+
+#include "../GraphicsApi_LL/IGraphicsApi.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary> Vertices written by the CPU for the current frame only. </summary>
+struct TransientVertexBuffer {
+	VertexBuffer buffer; // A range of a ring page, bind it like any vertex buffer.
+	void* data = nullptr; // Write the vertices here before the GPU executes the frame.
+};
+
+
+/// <summary> Indices written by the CPU for the current frame only. </summary>
+struct TransientIndexBuffer {
+	IndexBuffer buffer;
+	void* data = nullptr;
+	bool is32Bit = false;
+};
+
+
+/// <summary>
+/// Hands out ranges of persistently mapped upload heap buffers for geometry that lives for a single frame,
+/// such as debug lines, particle billboards or GUI quads.
+/// </summary>
+/// <remarks>
+/// Ranges are carved out of pages linearly, and a page is reused once the GPU finished the last frame that used it.
+/// The GPU reads the ranges straight from the upload heap, they need no copy and no state transitions.
+/// Allocations are thread safe.
+/// </remarks>
+class DynamicBufferRing : public PipelineEventListener {
+	struct Page {
+		LinearBuffer buffer;
+		uint8_t* cpuAddress;
+		size_t size;
+		size_t consumedSize;
+		uint64_t lastFrameId; // Last frame that allocated from the page.
+	};
+
+	struct Allocation {
+		LinearBuffer buffer; // The page's buffer.
+		size_t offset;
+		uint8_t* cpuAddress;
+	};
+
+public:
+	DynamicBufferRing(gxapi::IGraphicsApi* graphicsApi);
+
+	/// <summary> Returns room for <paramref name="size"/> bytes of vertices, valid until the end of the current frame. </summary>
+	TransientVertexBuffer AllocateVertices(size_t size);
+	/// <summary> Returns room for <paramref name="indexCount"/> 16 or 32 bit indices, valid until the end of the current frame. </summary>
+	TransientIndexBuffer AllocateIndices(size_t indexCount, bool is32Bit);
+
+	void OnFrameBeginDevice(uint64_t frameId) override {}
+	void OnFrameBeginHost(uint64_t frameId) override;
+	void OnFrameBeginAwait(uint64_t frameId) override {}
+	void OnFrameCompleteDevice(uint64_t frameId) override;
+	void OnFrameCompleteHost(uint64_t frameId) override {}
+
+	/// <summary> Bytes allocated in the current frame. </summary>
+	size_t GetFrameUsage() const;
+	/// <summary> Total size of the pages, in flight or not. </summary>
+	size_t GetCapacity() const;
+
+private:
+	Allocation Allocate(size_t size);
+	Page CreatePage(size_t size) const;
+
+private:
+	gxapi::IGraphicsApi* m_graphicsApi;
+
+	std::vector<Page> m_pages; // Used round-robin, grows when all pages are in flight.
+	size_t m_currentPage = 0;
+	uint64_t m_currentFrameId = 0;
+	uint64_t m_firstUnfinishedFrameId = 0;
+	size_t m_frameUsage = 0;
+	mutable std::mutex m_mutex;
+
+	static constexpr size_t PAGE_SIZE = 1024 * 1024;
+	static constexpr size_t ALIGNMENT = 16;
+};
+
+
+} // namespace inl::gxeng
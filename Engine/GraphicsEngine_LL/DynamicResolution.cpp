@@ -0,0 +1,82 @@
+#include "DynamicResolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace inl::gxeng {
+
+
+DynamicResolution::DynamicResolution(const DynamicResolutionDesc& desc) {
+	SetDesc(desc);
+}
+
+
+void DynamicResolution::SetDesc(const DynamicResolutionDesc& desc) {
+	m_desc = desc;
+	m_desc.minScale = std::clamp(m_desc.minScale, 0.01f, 1.0f);
+	m_desc.maxScale = std::clamp(m_desc.maxScale, m_desc.minScale, 1.0f);
+	m_desc.step = std::max(m_desc.step, 0.01f);
+	m_scale = m_desc.enabled ? Quantize(m_desc.maxScale) : 1.0f;
+	m_framesWithRoom = 0;
+	m_anyMeasured = false;
+}
+
+
+float DynamicResolution::Update(uint64_t measuredFrame, double gpuMilliseconds, uint64_t currentFrame) {
+	if (!m_desc.enabled) {
+		m_scale = 1.0f;
+		return m_scale;
+	}
+
+	bool isNew = !m_anyMeasured || measuredFrame > m_lastMeasuredFrame;
+	if (!isNew || measuredFrame < m_changeFrame || gpuMilliseconds <= 0.0) {
+		return m_scale;
+	}
+	m_anyMeasured = true;
+	m_lastMeasuredFrame = measuredFrame;
+
+	float scale = m_scale;
+	double budget = m_desc.budgetMilliseconds;
+	if (gpuMilliseconds > budget) {
+		// Drop at least a step, and far enough that the estimate is under the budget.
+		float estimate = m_scale * (float)std::sqrt(budget * DropMargin / gpuMilliseconds);
+		scale = Quantize(std::min(estimate, m_scale - m_desc.step));
+		m_framesWithRoom = 0;
+	}
+	else {
+		float next = m_scale + m_desc.step;
+		double nextMilliseconds = gpuMilliseconds * (next * next) / (m_scale * m_scale);
+		if (nextMilliseconds < budget * Headroom) {
+			++m_framesWithRoom;
+		}
+		else {
+			m_framesWithRoom = 0;
+		}
+		if (m_framesWithRoom >= RaiseDelay) {
+			scale = Quantize(next);
+			m_framesWithRoom = 0;
+		}
+	}
+
+	if (scale != m_scale) {
+		m_scale = scale;
+		m_changeFrame = currentFrame;
+	}
+	return m_scale;
+}
+
+
+unsigned DynamicResolution::ScaleSize(unsigned size, float scale) {
+	return std::max(1u, unsigned(std::lround(size * scale)));
+}
+
+
+float DynamicResolution::Quantize(float scale) const {
+	// The small bias keeps exact multiples from rounding down a step.
+	float steps = std::floor(scale / m_desc.step + 1e-4f);
+	return std::clamp(steps * m_desc.step, m_desc.minScale, m_desc.maxScale);
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+
+
+namespace inl::gxeng {
+
+
+struct DynamicResolutionDesc {
+	bool enabled = false;
+	double budgetMilliseconds = 16.0; // GPU time of a frame to stay within.
+	float minScale = 0.5f;
+	float maxScale = 1.0f;
+	float step = 0.05f; // Scales are multiples of it, so targets are not recreated for every small change.
+};
+
+
+/// <summary>
+/// Picks the scale of the render resolution from the measured GPU time of the frames.
+/// </summary>
+/// <remarks> GPU time is assumed to grow with the number of pixels, the square of the scale.
+///		A frame over the budget lowers the scale at once, as far as the estimate says is needed.
+///		The scale is raised one step at a time, and only after <see cref="RaiseDelay"/> measurements
+///		that leave room for the next step. Measurements of frames recorded before the last change are ignored,
+///		since the timings lag behind by a few frames. </remarks>
+class DynamicResolution {
+public:
+	static constexpr double Headroom = 0.85; // Fraction of the budget the next step up must fit in.
+	static constexpr double DropMargin = 0.9; // Fraction of the budget aimed at when lowering the scale.
+	static constexpr unsigned RaiseDelay = 30;
+
+public:
+	DynamicResolution() = default;
+	explicit DynamicResolution(const DynamicResolutionDesc& desc);
+
+	/// <summary> Changes the settings, the scale starts over from the largest one. </summary>
+	void SetDesc(const DynamicResolutionDesc& desc);
+	const DynamicResolutionDesc& GetDesc() const { return m_desc; }
+
+	/// <summary> Updates the scale with the GPU time of a recorded frame. </summary>
+	/// <param name="measuredFrame"> The frame the time was measured on. The same frame may be passed again. </param>
+	/// <param name="currentFrame"> The frame about to be recorded with the returned scale. </param>
+	/// <returns> The scale of the render resolution, 1 if disabled. </returns>
+	float Update(uint64_t measuredFrame, double gpuMilliseconds, uint64_t currentFrame);
+
+	float GetScale() const { return m_scale; }
+
+	/// <summary> The size of a screen sized target at the given scale, at least 1. </summary>
+	static unsigned ScaleSize(unsigned size, float scale);
+
+private:
+	/// <summary> Clamps the scale to the range of the settings, rounded down to a step. </summary>
+	float Quantize(float scale) const;
+
+private:
+	DynamicResolutionDesc m_desc;
+	float m_scale = 1.0f;
+	uint64_t m_changeFrame = 0; // First frame recorded with the current scale.
+	uint64_t m_lastMeasuredFrame = 0;
+	bool m_anyMeasured = false;
+	unsigned m_framesWithRoom = 0;
+};
+
+
+} // namespace inl::gxeng
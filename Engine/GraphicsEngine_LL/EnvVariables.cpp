@@ -0,0 +1,66 @@
+#include "EnvVariables.hpp"
+
+
+namespace inl::gxeng {
+
+
+EnvVariableHandle EnvVariables::Intern(const std::string& name) {
+	auto [it, isNew] = m_indices.insert({ name, uint32_t(m_variables.size()) });
+	if (isNew) {
+		m_variables.push_back({ name, Any{}, 0 });
+	}
+	return { it->second };
+}
+
+
+EnvVariableHandle EnvVariables::Find(const std::string& name) const {
+	auto it = m_indices.find(name);
+	return it != m_indices.end() ? EnvVariableHandle{ it->second } : EnvVariableHandle{};
+}
+
+
+bool EnvVariables::Set(EnvVariableHandle handle, Any value) {
+	if (!handle.IsValid() || handle.index >= m_variables.size()) {
+		throw InvalidArgumentException("Invalid environment variable handle.");
+	}
+	Variable& variable = m_variables[handle.index];
+	const bool isNew = !variable.value.HasValue();
+	variable.value = std::move(value);
+	variable.version = ++m_version;
+	return isNew;
+}
+
+
+bool EnvVariables::HasValue(EnvVariableHandle handle) const {
+	return handle.IsValid() && handle.index < m_variables.size() && m_variables[handle.index].value.HasValue();
+}
+
+
+const Any& EnvVariables::Get(EnvVariableHandle handle) const {
+	const Variable& variable = GetVariable(handle);
+	if (!variable.value.HasValue()) {
+		throw InvalidArgumentException("Environment variable does not exist.", variable.name);
+	}
+	return variable.value;
+}
+
+
+uint64_t EnvVariables::GetVersion(EnvVariableHandle handle) const {
+	return HasValue(handle) ? m_variables[handle.index].version : 0;
+}
+
+
+const std::string& EnvVariables::GetName(EnvVariableHandle handle) const {
+	return GetVariable(handle).name;
+}
+
+
+const EnvVariables::Variable& EnvVariables::GetVariable(EnvVariableHandle handle) const {
+	if (!handle.IsValid() || handle.index >= m_variables.size()) {
+		throw InvalidArgumentException("Invalid environment variable handle.");
+	}
+	return m_variables[handle.index];
+}
+
+
+} // namespace inl::gxeng
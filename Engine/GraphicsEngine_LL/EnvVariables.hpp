@@ -0,0 +1,90 @@
+#pragma once
+
+#include <BaseLibrary/Any.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+
+namespace inl::gxeng {
+
+
+/// <summary> Refers to an environment variable without looking up its name. </summary>
+struct EnvVariableHandle {
+	static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+	uint32_t index = InvalidIndex;
+
+	bool IsValid() const { return index != InvalidIndex; }
+	bool operator==(const EnvVariableHandle& rhs) const { return index == rhs.index; }
+	bool operator!=(const EnvVariableHandle& rhs) const { return index != rhs.index; }
+};
+
+
+/// <summary>
+/// The environment variables of the graphics engine, named values that alter the pipeline from outside.
+/// </summary>
+/// <remarks>
+/// <para> Names are interned once into handles, which index the values directly.
+///		A handle stays valid while the list lives, even if the variable has no value yet. </para>
+/// <para> Every variable has a version that grows when it is set, so that readers can tell
+///		if a value has changed since they last looked at it, without comparing the values. </para>
+/// <para> Not thread safe. The engine sets variables between frames, while the pipeline only reads them. </para>
+/// </remarks>
+class EnvVariables {
+public:
+	/// <summary> Returns the handle of the variable, adding a variable without a value if it's new. </summary>
+	EnvVariableHandle Intern(const std::string& name);
+	/// <summary> Returns the handle of the variable, or an invalid handle if it has never been interned. </summary>
+	EnvVariableHandle Find(const std::string& name) const;
+
+	/// <summary> Sets the value and bumps the version of the variable. </summary>
+	/// <returns> True if the variable had no value before. </returns>
+	bool Set(EnvVariableHandle handle, Any value);
+	bool Set(const std::string& name, Any value) { return Set(Intern(name), std::move(value)); }
+
+	/// <summary> True if the variable exists and has a value. </summary>
+	bool HasValue(EnvVariableHandle handle) const;
+	/// <summary> The value of the variable. </summary>
+	/// <exception cref="InvalidArgumentException"> If the variable has no value. </exception>
+	const Any& Get(EnvVariableHandle handle) const;
+	/// <summary> Null if the variable has no value or a value of another type. </summary>
+	template <class T>
+	const T* GetIf(EnvVariableHandle handle) const;
+
+	/// <summary> Changes whenever the variable is set, 0 if it has no value. </summary>
+	/// <remarks> It's the value of <see cref="GetVersion()"/> right after the last set. </remarks>
+	uint64_t GetVersion(EnvVariableHandle handle) const;
+	/// <summary> Number of times any variable was set. </summary>
+	uint64_t GetVersion() const { return m_version; }
+
+	const std::string& GetName(EnvVariableHandle handle) const;
+	/// <summary> Number of variables interned, the handles are 0 to count-1. </summary>
+	size_t GetCount() const { return m_variables.size(); }
+private:
+	struct Variable {
+		std::string name;
+		Any value;
+		uint64_t version = 0;
+	};
+	const Variable& GetVariable(EnvVariableHandle handle) const;
+
+	std::deque<Variable> m_variables; // Indexed by the handles.
+	std::unordered_map<std::string, uint32_t> m_indices;
+	uint64_t m_version = 0;
+};
+
+
+template <class T>
+const T* EnvVariables::GetIf(EnvVariableHandle handle) const {
+	if (!HasValue(handle)) {
+		return nullptr;
+	}
+	const Any& value = GetVariable(handle).value;
+	return value.Type() == typeid(T) ? &value.Get<T>() : nullptr;
+}
+
+
+} // namespace inl::gxeng
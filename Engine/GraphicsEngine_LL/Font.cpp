@@ -1,7 +1,10 @@
 #include "Font.hpp"
+#include "SignedDistanceField.hpp"
+
 #include <BaseLibrary/Exception/Exception.hpp>
 #include <BaseLibrary/Singleton.hpp>
-#include <BaseLibrary/Range.hpp>
+
+#include <algorithm>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -12,44 +15,12 @@ namespace inl::gxeng {
 // Helper classes.
 //------------------------------------------------------------------------------
 
-// Currently the texture atlas contains rasterized letters of only this size.
-static constexpr int ATLAS_FONT_SIZE = 24;
-
-
-// A small helper class for a resizeable 2D texture so that it's easy to append new
-// rendered glyphs to the atlas.
-class AtlasHelper {
-public:
-	AtlasHelper(int width = 0, int height = 0) : m_width(width), m_height(height), m_pixels(width*height) {}
-
-	void Resize(int width, int height) {
-		AtlasHelper resized(width, height);
-
-		int overlapWidth = std::min(width, m_width);
-		int overlapHeight = std::min(height, m_height);
-
-		for (int y = 0; y<overlapHeight; ++y) {
-			for (int x = 0; x<overlapWidth; ++x) {
-				resized(x, y) = (*this)(x, y);
-			}
-		}
-
-		*this = std::move(resized);
-	}
+// Texels of empty distance field around the glyphs, so the falloff outside the edges is kept.
+static constexpr int GlyphPadding = (int)Font::DistanceSpread;
 
-	uint8_t& operator()(int x, int y) {
-		return m_pixels[y*m_width + x];
-	}
-	uint8_t operator()(int x, int y) const {
-		return m_pixels[y*m_width + x];
-	}
-	const uint8_t* Data() const { return m_pixels.data(); }
-	int Width() const { return m_width; }
-	int Height() const { return m_height; }
-private:
-	int m_width, m_height;
-	std::vector<uint8_t> m_pixels;
-};
+static const IPixelReader& AtlasPixelReader() {
+	return Pixel<ePixelChannelType::INT8_NORM, 1, ePixelClass::LINEAR>::Reader();
+}
 
 
 // Throw an exception in a freetype function failed.
@@ -88,6 +59,11 @@ Font::Font(Image atlas)
 {}
 
 
+Font::~Font() {
+	ReleaseFace();
+}
+
+
 void Font::LoadFile(std::istream& file) {
 	std::vector<char> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 	LoadFile(content.data(), content.size());
@@ -95,78 +71,94 @@ void Font::LoadFile(std::istream& file) {
 
 
 void Font::LoadFile(const void* data, size_t size) {
+	std::lock_guard lock(m_mutex);
+
+	ReleaseFace();
+	for (auto& page : m_bmpGlyphs) {
+		page.reset();
+	}
+	m_otherGlyphs.clear();
+	++m_version;
+	m_fontData.assign((const uint8_t*)data, (const uint8_t*)data + size);
+
 	FT_Library library = Freetype::GetInstance().GetFreetype();
 	FT_Face face;
 
 	// Load font.
-	ThrowIfFailed<InvalidArgumentException>(FT_New_Memory_Face(library, (FT_Byte*)data, (FT_Long)size, 0, &face), "Failed to read font file.");
+	ThrowIfFailed<InvalidArgumentException>(FT_New_Memory_Face(library, (FT_Byte*)m_fontData.data(), (FT_Long)size, 0, &face), "Failed to read font file.");
+	m_face = face;
 	ThrowIfFailed<InvalidArgumentException>(FT_Select_Charmap(face, FT_ENCODING_UNICODE), "Font does not have UNICODE glyph map.");
 
 	// Set font properties.
-	int sizeInPixels = ATLAS_FONT_SIZE;
+	int sizeInPixels = AtlasFontSize * Supersampling;
 	ThrowIfFailed<RuntimeException>(FT_Set_Pixel_Sizes(face, 0, sizeInPixels), "Could not set pixel size with freetype.");
+	m_ascender = float(face->size->metrics.ascender) / 64.f / sizeInPixels;
+	m_lineHeight = float(face->size->metrics.ascender - face->size->metrics.descender) / 64.f / sizeInPixels;
 
-	AtlasHelper atlasPixels;
-	int totalWidth = 0;
-	int maxHeight = 0;
+	// Start with a small atlas, it grows as glyphs are used.
+	m_atlasPixels.assign(size_t(AtlasWidth) * InitialAtlasHeight, 0);
+	m_atlas.SetLayout(AtlasWidth, InitialAtlasHeight, ePixelChannelType::INT8_NORM, 1, ePixelClass::LINEAR, 1);
+	m_atlas.Update(0, 0, AtlasWidth, InitialAtlasHeight, 0, m_atlasPixels.data(), AtlasPixelReader());
+	const_cast<Texture2D&>(m_atlas.GetSrv().GetResource()).SetName("font atlas");
+	m_packer.emplace(&m_atlas, 1);
 
-	// Render 0-255 characters.
-	for (char32_t ch = 0; ch < 256; ++ch) {
-		unsigned glyphIndex = FT_Get_Char_Index(face, ch);
-		if (glyphIndex == 0) {
-			continue;
-		}
+	// Printable ASCII is used by almost every text.
+	for (char32_t ch = 32; ch < 127; ++ch) {
+		FindGlyph(ch);
+	}
+}
 
-		ThrowIfFailed<RuntimeException>(FT_Load_Glyph(face, glyphIndex, FT_LOAD_DEFAULT), "Freetype could not load glyph.", std::to_string(glyphIndex));
-		ThrowIfFailed<RuntimeException>(FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL), "Freetype could not render glyph.", std::to_string(glyphIndex));
-
-		Vec2i position = { totalWidth, 0 };
-		Vec2i size = { 
-			face->glyph->bitmap_left + face->glyph->bitmap.width,
-			face->glyph->bitmap_top + face->glyph->bitmap.rows
-		};
-		totalWidth += size.x + 2;
-		maxHeight = std::max(size.y, maxHeight);
-
-		m_glyphs[ch] = GlyphInfo{
-			float(face->glyph->advance.x)/64.f/sizeInPixels,
-			position,
-			size
-		};
-
-		// Copy rendered glyph to texture atlas.
-		if (maxHeight > atlasPixels.Height() || totalWidth > atlasPixels.Width()) {
-			atlasPixels.Resize(totalWidth, maxHeight);
-		}
-		for (unsigned y = 0; y<face->glyph->bitmap.rows; ++y) {
-			for (unsigned x = 0; x<face->glyph->bitmap.width; ++x) {
-				Vec2i pxPos = position + Vec2i(x, y) + Vec2i(face->glyph->bitmap_left, sizeInPixels-face->glyph->bitmap_top);
-				atlasPixels(pxPos.x, pxPos.y) = face->glyph->bitmap.buffer[y*face->glyph->bitmap.pitch + x];
-			}
-		}
+
+bool Font::IsCharacterSupported(char32_t character) const {
+	std::lock_guard lock(m_mutex);
+	return FindGlyph(character).has_value();
+}
+
+
+void Font::PrepareGlyphs(std::u32string_view text) const {
+	std::lock_guard lock(m_mutex);
+	for (auto character : text) {
+		FindGlyph(character);
 	}
+}
 
-	// Upload atlas to GPU.
-	m_atlas.SetLayout(atlasPixels.Width(), atlasPixels.Height(), ePixelChannelType::INT8_NORM, 1, ePixelClass::LINEAR);
-	const IPixelReader& pixelReader = Pixel<ePixelChannelType::INT8_NORM, 1, ePixelClass::LINEAR>::Reader();
-	m_atlas.Update(0, 0, atlasPixels.Width(), atlasPixels.Height(), 0, atlasPixels.Data(), pixelReader);
-	const_cast<Texture2D&>(m_atlas.GetSrv().GetResource()).SetName("font atlas");
+
+Font::GlyphRun Font::LayoutText(std::u32string_view text) const {
+	GlyphRun run;
+	run.carets.reserve(text.size() + 1);
+	run.glyphs.reserve(text.size());
+	run.glyphPositions.reserve(text.size());
+
+	std::lock_guard lock(m_mutex);
+	run.fontVersion = m_version;
+	float pen = 0.0f;
+	for (auto character : text) {
+		run.carets.push_back(pen);
+		if (std::optional<GlyphInfo> info = FindGlyph(character)) {
+			run.glyphs.push_back(*info);
+			run.glyphPositions.push_back(pen);
+			pen += info->advance;
+		}
+	}
+	run.carets.push_back(pen);
+	return run;
 }
 
 
-bool Font::IsCharacterSupported(char32_t character) const {
-	auto it = m_glyphs.find(character);
-	return it != m_glyphs.end();
+uint64_t Font::GetVersion() const {
+	std::lock_guard lock(m_mutex);
+	return m_version;
 }
 
 
 Font::GlyphInfo Font::GetGlyphInfo(char32_t character) const {
-	auto it = m_glyphs.find(character);
-	if (it == m_glyphs.end()) {
+	std::lock_guard lock(m_mutex);
+	std::optional<GlyphInfo> info = FindGlyph(character);
+	if (!info) {
 		throw OutOfRangeException("Character cannot be rendered.");
 	}
 
-	return it->second;
+	return *info;
 }
 
 
@@ -175,48 +167,139 @@ const Image& Font::GetGlyphAtlas() const {
 }
 
 
+std::optional<Font::GlyphInfo> Font::FindGlyph(char32_t character) const {
+	if (!m_face) {
+		return {};
+	}
+	GlyphSlot& slot = GetGlyphSlot(character);
+	if (!slot.cached) {
+		slot.info = RasterizeGlyph(character);
+		slot.cached = true;
+	}
+	return slot.info;
+}
+
+
+Font::GlyphSlot& Font::GetGlyphSlot(char32_t character) const {
+	if (character >= 0x10000) {
+		return m_otherGlyphs[character];
+	}
+	auto& page = m_bmpGlyphs[character / GlyphPageSize];
+	if (!page) {
+		page = std::make_unique<GlyphPage>();
+	}
+	return (*page)[character % GlyphPageSize];
+}
+
+
+std::optional<Font::GlyphInfo> Font::RasterizeGlyph(char32_t character) const {
+	FT_Face face = m_face;
+	unsigned glyphIndex = FT_Get_Char_Index(face, character);
+	if (glyphIndex == 0) {
+		return {};
+	}
+
+	ThrowIfFailed<RuntimeException>(FT_Load_Glyph(face, glyphIndex, FT_LOAD_DEFAULT), "Freetype could not load glyph.", std::to_string(glyphIndex));
+	ThrowIfFailed<RuntimeException>(FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL), "Freetype could not render glyph.", std::to_string(glyphIndex));
+
+	const FT_Bitmap& bitmap = face->glyph->bitmap;
+	float sizeInPixels = float(AtlasFontSize * Supersampling);
+
+	GlyphInfo info;
+	info.advance = float(face->glyph->advance.x) / 64.f / sizeInPixels;
+	info.atlasPos = { 0, 0 };
+	info.atlasSize = { 0, 0 };
+	info.offset = { 0, 0 };
+	info.size = { 0, 0 };
+	if (bitmap.width == 0 || bitmap.rows == 0) {
+		return info;
+	}
+
+	DistanceField field = ComputeSignedDistanceField(bitmap.buffer, (int)bitmap.width, (int)bitmap.rows, bitmap.pitch, Supersampling, DistanceSpread, GlyphPadding);
+
+	std::optional<RectI> place = m_packer->Allocate(field.width, field.height);
+	while (!place && GrowAtlas()) {
+		place = m_packer->Allocate(field.width, field.height);
+	}
+	if (!place) {
+		return {}; // The atlas is as large as it gets.
+	}
+
+	for (int y = 0; y < field.height; ++y) {
+		std::copy_n(&field.pixels[size_t(y) * field.width], field.width, &m_atlasPixels[size_t(place->bottom + y) * AtlasWidth + place->left]);
+	}
+	m_atlas.Update(place->left, place->bottom, field.width, field.height, 0, field.pixels.data(), AtlasPixelReader());
+
+	// The field starts the padding before the bitmap, one texel covers as many pixels as the supersampling.
+	info.atlasPos = { place->left, place->bottom };
+	info.atlasSize = { field.width, field.height };
+	info.offset = {
+		(float(face->glyph->bitmap_left) / Supersampling - GlyphPadding) / AtlasFontSize,
+		((m_ascender * sizeInPixels - face->glyph->bitmap_top) / Supersampling - GlyphPadding) / AtlasFontSize
+	};
+	info.size = Vec2(float(field.width), float(field.height)) / float(AtlasFontSize);
+	return info;
+}
+
+
+bool Font::GrowAtlas() const {
+	unsigned height = (unsigned)m_atlas.GetHeight();
+	if (height * 2 > MaxAtlasHeight) {
+		return false;
+	}
+
+	// The new texture has nothing in it, the places so far are uploaded again.
+	height *= 2;
+	m_atlasPixels.resize(size_t(AtlasWidth) * height, 0);
+	m_atlas.SetLayout(AtlasWidth, height, ePixelChannelType::INT8_NORM, 1, ePixelClass::LINEAR, 1);
+	m_atlas.Update(0, 0, AtlasWidth, height, 0, m_atlasPixels.data(), AtlasPixelReader());
+	const_cast<Texture2D&>(m_atlas.GetSrv().GetResource()).SetName("font atlas");
+	m_packer->UpdateSize();
+	return true;
+}
+
+
+void Font::ReleaseFace() {
+	if (m_face) {
+		FT_Done_Face(m_face);
+		m_face = nullptr;
+	}
+}
+
+
 float Font::CalculateTextHeight(float fontSize) const {
 	assert(fontSize > 0);
-	return m_atlas.GetHeight() * fontSize / ATLAS_FONT_SIZE;
+	return m_lineHeight * fontSize;
 }
 
 
 float Font::CalculateTextWidth(std::u32string_view text, float fontSize) const {
 	assert(fontSize > 0);
-	float width = 0.0f;
-	for (auto& glyph : text) {
-		if (IsCharacterSupported(glyph)) {
-			const auto& info = GetGlyphInfo(glyph);
-			width += info.advance;
-		}
-	}
-	return width * fontSize;
+	return LayoutText(text).GetWidth() * fontSize;
 }
 
 
 intptr_t Font::FindCharacter(std::u32string_view text, float coordinate, float fontSize) const {
 	assert(fontSize > 0);
-	if (coordinate < 0) {
-		return -1;
-	}
-	float width = 0.0f;
-	for (auto glyphIdx : Range(intptr_t(text.size()))) {
-		const auto& info = GetGlyphInfo(text[glyphIdx]);
-		width += info.advance*fontSize;
-		if (width >= coordinate) {
-			return glyphIdx;
-		}
-	}
-	return (intptr_t)text.size();
+	return FindCharacter(LayoutText(text), coordinate / fontSize);
 }
 
 
 std::pair<float, float> Font::FindCoordinates(std::u32string_view text, size_t index, float fontSize) const {
 	assert(index < text.size());
 	assert(fontSize > 0);
-	float precedingWidth = CalculateTextWidth(text.substr(0, index), fontSize);
-	float glyphWidth = GetGlyphInfo(text[index]).advance*fontSize;
-	return { precedingWidth, precedingWidth + glyphWidth };
+	GlyphRun run = LayoutText(text.substr(0, index + 1));
+	return { run.carets[index] * fontSize, run.carets[index + 1] * fontSize };
+}
+
+
+intptr_t Font::FindCharacter(const GlyphRun& run, float coordinate) {
+	if (coordinate < 0) {
+		return -1;
+	}
+	// The character under the coordinate is the first one that ends after it.
+	auto end = std::lower_bound(run.carets.begin() + 1, run.carets.end(), coordinate);
+	return intptr_t(end - (run.carets.begin() + 1));
 }
 
 
@@ -2,25 +2,66 @@
 
 #include <GraphicsEngine/Resources/IFont.hpp>
 
+#include <array>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "Image.hpp"
+#include "ImageAtlas.hpp"
+
+
+struct FT_FaceRec_;
 
 
 namespace inl::gxeng {
 
 
 
+/// <summary> A TTF font with its glyphs in a texture atlas. </summary>
+/// <remarks>
+/// The atlas stores signed distance fields of the glyphs, so the same atlas renders sharp letters at any font size.
+/// Glyphs are rasterized when they are first used, only printable ASCII is prepared when the file is loaded.
+/// New glyphs are packed to the free space of the atlas and only their rectangle is uploaded,
+/// the atlas grows taller when it is full. Uploads reach the GPU with the next frame, so
+/// <see cref="PrepareGlyphs"/> should be called before the frame that draws a text, as TextEntity does.
+/// </remarks>
 class Font : public IFont {
 public:
 	struct GlyphInfo {
-		float advance;
-		Vec2i atlasPos;
-		Vec2i atlasSize;
+		float advance; // Em units.
+		Vec2i atlasPos; // Top-left of the distance field in the atlas, in texels.
+		Vec2i atlasSize; // Zero for glyphs that draw nothing, like spaces.
+		Vec2 offset; // From the pen on the top of the line to the top-left of the quad, em units, y grows downwards.
+		Vec2 size; // Size of the quad, em units.
+	};
+
+	/// <summary> A line of text laid out once, so drawing and caret queries do not look up the glyphs again. </summary>
+	/// <remarks> Positions are in em units from the left of the line, multiply them by the font size. </remarks>
+	struct GlyphRun {
+		std::vector<GlyphInfo> glyphs; // Characters the font does not have are left out.
+		std::vector<float> glyphPositions; // Pen position of each glyph.
+		std::vector<float> carets; // Pen position before each character, the last one is the end of the line.
+		uint64_t fontVersion = 0; // See <see cref="GetVersion"/>.
+
+		float GetWidth() const { return carets.empty() ? 0.0f : carets.back(); }
 	};
+
+	static constexpr int AtlasFontSize = 32; // Texels per em in the atlas.
+	static constexpr int Supersampling = 4; // Glyphs are rasterized at this many times the atlas size for the distance fields.
+	static constexpr float DistanceSpread = 4.0f; // Texels from the edge where the distance fields reach 0 and 1.
+	static constexpr unsigned AtlasWidth = 1024;
+	static constexpr unsigned InitialAtlasHeight = 256;
+	static constexpr unsigned MaxAtlasHeight = 16384;
+
 public:
 	Font(Image atlas);
+	Font(const Font&) = delete;
+	Font& operator=(const Font&) = delete;
+	~Font();
 
 	void LoadFile(std::istream& file) override;
 	void LoadFile(const void* data, size_t size) override;
@@ -30,18 +71,57 @@ public:
 	intptr_t FindCharacter(std::u32string_view text, float coordinate, float fontSize) const override;
 	std::pair<float, float> FindCoordinates(std::u32string_view text, size_t index, float fontSize) const override;
 
-	/// <summary> Returns the width of the specified character. </summary>
+	/// <summary> Rasterizes the glyphs of the text that are not in the atlas yet. </summary>
+	void PrepareGlyphs(std::u32string_view text) const;
+
+	/// <summary> Rasterizes the missing glyphs and lays out the text on a single line. </summary>
+	GlyphRun LayoutText(std::u32string_view text) const;
+
+	/// <summary> Same as the overload taking the text, on a run laid out earlier, the coordinate is in em units. </summary>
+	static intptr_t FindCharacter(const GlyphRun& run, float coordinate);
+
+	/// <summary> Changes when a new file is loaded, runs laid out with an older version are invalid. </summary>
+	uint64_t GetVersion() const;
+
+	/// <summary> Returns the size and the place in the atlas of the specified character. </summary>
 	/// <param name="character"> UCS-4 code point. </param>
 	/// <exception cref="OutOfRangeException"> If character cannot be rendered. </exception>
 	GlyphInfo GetGlyphInfo(char32_t character) const;
 
-	/// <summary> Returns the texture atlas that contain the rasterized letters. </summary>
+	/// <summary> Returns the texture atlas that contain the distance fields of the letters. </summary>
 	const Image& GetGlyphAtlas() const;
+
+private:
+	struct GlyphSlot {
+		bool cached = false;
+		std::optional<GlyphInfo> info; // Empty for characters the font does not have.
+	};
+	static constexpr size_t GlyphPageSize = 256;
+	using GlyphPage = std::array<GlyphSlot, GlyphPageSize>;
+
+	// These expect the mutex to be locked.
+	std::optional<GlyphInfo> FindGlyph(char32_t character) const;
+	GlyphSlot& GetGlyphSlot(char32_t character) const;
+	std::optional<GlyphInfo> RasterizeGlyph(char32_t character) const;
+	bool GrowAtlas() const;
+	void ReleaseFace();
+
 private:
-	Image m_atlas;
-	std::unordered_map<char32_t, GlyphInfo> m_glyphs;
+	std::vector<uint8_t> m_fontData; // FreeType reads the file from here while the face is open.
+	FT_FaceRec_* m_face = nullptr;
+	float m_ascender = 0.0f; // Em units.
+	float m_lineHeight = 0.0f; // Em units.
+
+	// Glyphs are added by const methods as they are first used.
+	mutable std::mutex m_mutex;
+	mutable Image m_atlas;
+	mutable std::optional<ImageAtlas> m_packer;
+	mutable std::vector<uint8_t> m_atlasPixels; // Copy of the atlas to upload again when it grows.
+	mutable std::array<std::unique_ptr<GlyphPage>, 0x10000 / GlyphPageSize> m_bmpGlyphs; // Flat table of the BMP, pages are allocated on first use.
+	mutable std::unordered_map<char32_t, GlyphSlot> m_otherGlyphs; // Characters past the BMP are rare.
+	uint64_t m_version = 0;
 };
 
 
 
-} // namespace inl::gxeng
\ No newline at end of file
+} // namespace inl::gxeng
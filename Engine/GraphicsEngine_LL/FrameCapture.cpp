@@ -0,0 +1,836 @@
+#include "FrameCapture.hpp"
+
+#include "DirectionalLight.hpp"
+#include "Image.hpp"
+#include "MaterialShader.hpp"
+#include "Mesh.hpp"
+#include "OrthographicCamera.hpp"
+#include "PerspectiveCamera.hpp"
+#include "Pipeline.hpp"
+#include "PointLight.hpp"
+#include "Scene.hpp"
+#include "SpotLight.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <rapidjson/document.h>
+#include <rapidjson/istreamwrapper.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+#include <algorithm>
+#include <iterator>
+#include <istream>
+#include <ostream>
+
+
+namespace inl::gxeng {
+
+
+using Writer = rapidjson::PrettyWriter<rapidjson::OStreamWrapper>;
+
+
+//------------------------------------------------------------------------------
+// Writing
+//------------------------------------------------------------------------------
+
+static void WriteFloats(Writer& writer, const char* key, const float* values, size_t count) {
+	writer.Key(key);
+	writer.StartArray();
+	for (size_t i = 0; i < count; ++i) {
+		writer.Double(values[i]);
+	}
+	writer.EndArray();
+}
+
+static void WriteVec(Writer& writer, const char* key, const Vec2& v) {
+	const float values[] = { v.x, v.y };
+	WriteFloats(writer, key, values, 2);
+}
+
+static void WriteVec(Writer& writer, const char* key, const Vec3& v) {
+	const float values[] = { v.x, v.y, v.z };
+	WriteFloats(writer, key, values, 3);
+}
+
+static void WriteVec(Writer& writer, const char* key, const Vec4& v) {
+	const float values[] = { v.x, v.y, v.z, v.w };
+	WriteFloats(writer, key, values, 4);
+}
+
+static void WriteMatrix(Writer& writer, const char* key, const Mat44& m) {
+	float values[16];
+	for (int row = 0; row < 4; ++row) {
+		for (int col = 0; col < 4; ++col) {
+			values[row * 4 + col] = m(row, col);
+		}
+	}
+	WriteFloats(writer, key, values, 16);
+}
+
+static void WriteString(Writer& writer, const char* key, const std::string& value) {
+	writer.Key(key);
+	writer.String(value.c_str(), rapidjson::SizeType(value.size()));
+}
+
+static std::string ToHex(const std::string& data) {
+	static const char digits[] = "0123456789abcdef";
+	std::string hex;
+	hex.reserve(data.size() * 2);
+	for (unsigned char c : data) {
+		hex.push_back(digits[c >> 4]);
+		hex.push_back(digits[c & 15]);
+	}
+	return hex;
+}
+
+static std::string FromHex(const std::string& hex) {
+	auto digit = [&hex](char c) {
+		if ('0' <= c && c <= '9') {
+			return c - '0';
+		}
+		if ('a' <= c && c <= 'f') {
+			return c - 'a' + 10;
+		}
+		throw InvalidArgumentException("Frame capture has a malformed binary pipeline.");
+	};
+	if (hex.size() % 2 != 0) {
+		throw InvalidArgumentException("Frame capture has a malformed binary pipeline.");
+	}
+	std::string data(hex.size() / 2, '\0');
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = char(digit(hex[2 * i]) * 16 + digit(hex[2 * i + 1]));
+	}
+	return data;
+}
+
+
+static const char* const envTypeNames[] = { "bool", "int", "float", "vec2", "vec3", "vec4", "string", "image" };
+static_assert(std::size(envTypeNames) == std::variant_size_v<FrameCapture::EnvValue>);
+
+
+void FrameCapture::Write(std::ostream& output) const {
+	rapidjson::OStreamWrapper stream(output);
+	Writer writer(stream);
+
+	writer.StartObject();
+	writer.Key("frame");
+	writer.Uint64(frame);
+	writer.Key("elapsed");
+	writer.Double(elapsed);
+	writer.Key("width");
+	writer.Uint(width);
+	writer.Key("height");
+	writer.Uint(height);
+	const bool binaryPipeline = Pipeline::IsBinaryDescription(pipeline);
+	WriteString(writer, "pipelineEncoding", binaryPipeline ? "hex" : "json");
+	WriteString(writer, "pipeline", binaryPipeline ? ToHex(pipeline) : pipeline);
+
+	writer.Key("meshes");
+	writer.StartArray();
+	for (const MeshDesc& mesh : meshes) {
+		writer.StartObject();
+		WriteString(writer, "name", mesh.name);
+		writer.Key("vertexCount");
+		writer.Uint64(mesh.vertexCount);
+		writer.Key("lodIndexCounts");
+		writer.StartArray();
+		for (uint32_t count : mesh.lodIndexCounts) {
+			writer.Uint(count);
+		}
+		writer.EndArray();
+		WriteVec(writer, "boundsLower", mesh.localBounds.lower);
+		WriteVec(writer, "boundsUpper", mesh.localBounds.upper);
+		writer.EndObject();
+	}
+	writer.EndArray();
+
+	writer.Key("images");
+	writer.StartArray();
+	for (const ImageDesc& image : images) {
+		writer.StartObject();
+		WriteString(writer, "name", image.name);
+		writer.Key("width");
+		writer.Uint64(image.width);
+		writer.Key("height");
+		writer.Uint(image.height);
+		writer.Key("channelType");
+		writer.Int(int(image.channelType));
+		writer.Key("channelCount");
+		writer.Int(image.channelCount);
+		writer.Key("pixelClass");
+		writer.Int(int(image.pixelClass));
+		writer.Key("mipLevels");
+		writer.Int(image.mipLevels);
+		writer.EndObject();
+	}
+	writer.EndArray();
+
+	writer.Key("materialShaders");
+	writer.StartArray();
+	for (const MaterialShaderDesc& shader : materialShaders) {
+		writer.StartObject();
+		WriteString(writer, "code", shader.code);
+		writer.EndObject();
+	}
+	writer.EndArray();
+
+	writer.Key("materials");
+	writer.StartArray();
+	for (const MaterialDesc& material : materials) {
+		writer.StartObject();
+		WriteString(writer, "name", material.name);
+		writer.Key("shader");
+		writer.Int(material.shader);
+		writer.Key("parameters");
+		writer.StartArray();
+		for (const ParameterDesc& parameter : material.parameters) {
+			writer.StartObject();
+			WriteString(writer, "name", parameter.name);
+			writer.Key("type");
+			writer.Int(int(parameter.type));
+			writer.Key("set");
+			writer.Bool(parameter.set);
+			WriteVec(writer, "color", parameter.color);
+			writer.Key("value");
+			writer.Double(parameter.value);
+			writer.Key("image");
+			writer.Int(parameter.image);
+			writer.EndObject();
+		}
+		writer.EndArray();
+		writer.EndObject();
+	}
+	writer.EndArray();
+
+	writer.Key("scenes");
+	writer.StartArray();
+	for (const SceneDesc& scene : scenes) {
+		writer.StartObject();
+		WriteString(writer, "name", scene.name);
+		writer.Key("meshEntities");
+		writer.StartArray();
+		for (const MeshEntityDesc& entity : scene.meshEntities) {
+			writer.StartObject();
+			writer.Key("mesh");
+			writer.Int(entity.mesh);
+			writer.Key("material");
+			writer.Int(entity.material);
+			WriteMatrix(writer, "transform", entity.transform);
+			writer.Key("dynamic");
+			writer.Bool(entity.dynamic);
+			writer.Key("occluderHint");
+			writer.Int(int(entity.occluderHint));
+			writer.EndObject();
+		}
+		writer.EndArray();
+		writer.Key("directionalLights");
+		writer.StartArray();
+		for (const DirectionalLightDesc& light : scene.directionalLights) {
+			writer.StartObject();
+			WriteVec(writer, "direction", light.direction);
+			WriteVec(writer, "color", light.color);
+			writer.EndObject();
+		}
+		writer.EndArray();
+		writer.Key("pointLights");
+		writer.StartArray();
+		for (const PointLightDesc& light : scene.pointLights) {
+			writer.StartObject();
+			WriteVec(writer, "position", light.position);
+			WriteVec(writer, "color", light.color);
+			writer.Key("range");
+			writer.Double(light.range);
+			writer.EndObject();
+		}
+		writer.EndArray();
+		writer.Key("spotLights");
+		writer.StartArray();
+		for (const SpotLightDesc& light : scene.spotLights) {
+			writer.StartObject();
+			WriteVec(writer, "position", light.position);
+			WriteVec(writer, "direction", light.direction);
+			WriteVec(writer, "color", light.color);
+			writer.Key("range");
+			writer.Double(light.range);
+			writer.Key("innerAngle");
+			writer.Double(light.innerAngle);
+			writer.Key("outerAngle");
+			writer.Double(light.outerAngle);
+			writer.EndObject();
+		}
+		writer.EndArray();
+		writer.EndObject();
+	}
+	writer.EndArray();
+
+	writer.Key("cameras");
+	writer.StartArray();
+	for (const CameraDesc& camera : cameras) {
+		writer.StartObject();
+		WriteString(writer, "name", camera.name);
+		WriteString(writer, "type", camera.perspective ? "perspective" : "orthographic");
+		WriteVec(writer, "position", camera.position);
+		WriteVec(writer, "lookDirection", camera.lookDirection);
+		WriteVec(writer, "upVector", camera.upVector);
+		const std::pair<const char*, float> fields[] = {
+			{ "nearPlane", camera.nearPlane },
+			{ "farPlane", camera.farPlane },
+			{ "focus", camera.focus },
+			{ "fovHorizontal", camera.fovHorizontal },
+			{ "fovVertical", camera.fovVertical },
+			{ "width", camera.width },
+			{ "height", camera.height },
+		};
+		for (const auto& [field, value] : fields) {
+			writer.Key(field);
+			writer.Double(value);
+		}
+		writer.EndObject();
+	}
+	writer.EndArray();
+
+	writer.Key("envVariables");
+	writer.StartArray();
+	for (const EnvVariableDesc& variable : envVariables) {
+		writer.StartObject();
+		WriteString(writer, "name", variable.name);
+		WriteString(writer, "type", envTypeNames[variable.value.index()]);
+		std::visit([&writer](const auto& value) {
+			using T = std::decay_t<decltype(value)>;
+			if constexpr (std::is_same_v<T, bool>) {
+				writer.Key("value");
+				writer.Bool(value);
+			}
+			else if constexpr (std::is_same_v<T, int>) {
+				writer.Key("value");
+				writer.Int(value);
+			}
+			else if constexpr (std::is_same_v<T, float>) {
+				writer.Key("value");
+				writer.Double(value);
+			}
+			else if constexpr (std::is_same_v<T, std::string>) {
+				WriteString(writer, "value", value);
+			}
+			else if constexpr (std::is_same_v<T, ImageRef>) {
+				writer.Key("value");
+				writer.Int(value.image);
+			}
+			else {
+				WriteVec(writer, "value", value);
+			}
+		},
+				   variable.value);
+		writer.EndObject();
+	}
+	writer.EndArray();
+
+	writer.Key("skippedEnvVariables");
+	writer.StartArray();
+	for (const std::string& name : skippedEnvVariables) {
+		writer.String(name.c_str(), rapidjson::SizeType(name.size()));
+	}
+	writer.EndArray();
+
+	writer.EndObject();
+	output << std::endl;
+}
+
+
+//------------------------------------------------------------------------------
+// Reading
+//------------------------------------------------------------------------------
+
+using Value = rapidjson::Value;
+
+
+static const Value& GetMember(const Value& object, const char* name) {
+	if (!object.IsObject() || !object.HasMember(name)) {
+		throw InvalidArgumentException("Frame capture is missing a member.", name);
+	}
+	return object[name];
+}
+
+static const Value& GetArray(const Value& object, const char* name) {
+	const Value& value = GetMember(object, name);
+	if (!value.IsArray()) {
+		throw InvalidArgumentException("Frame capture member must be an array.", name);
+	}
+	return value;
+}
+
+static float GetFloat(const Value& object, const char* name) {
+	const Value& value = GetMember(object, name);
+	if (!value.IsNumber()) {
+		throw InvalidArgumentException("Frame capture member must be a number.", name);
+	}
+	return value.GetFloat();
+}
+
+static int GetInt(const Value& object, const char* name) {
+	const Value& value = GetMember(object, name);
+	if (!value.IsInt()) {
+		throw InvalidArgumentException("Frame capture member must be an integer.", name);
+	}
+	return value.GetInt();
+}
+
+static uint64_t GetUint64(const Value& object, const char* name) {
+	const Value& value = GetMember(object, name);
+	if (!value.IsUint64()) {
+		throw InvalidArgumentException("Frame capture member must be an unsigned integer.", name);
+	}
+	return value.GetUint64();
+}
+
+static bool GetBool(const Value& object, const char* name) {
+	const Value& value = GetMember(object, name);
+	if (!value.IsBool()) {
+		throw InvalidArgumentException("Frame capture member must be true or false.", name);
+	}
+	return value.GetBool();
+}
+
+static std::string GetString(const Value& object, const char* name) {
+	const Value& value = GetMember(object, name);
+	if (!value.IsString()) {
+		throw InvalidArgumentException("Frame capture member must be a string.", name);
+	}
+	return std::string(value.GetString(), value.GetStringLength());
+}
+
+template <int Dim>
+static Vector<float, Dim, false> ToVec(const Value& value, const char* name) {
+	if (!value.IsArray() || value.Size() != Dim) {
+		throw InvalidArgumentException("Frame capture member must be an array of " + std::to_string(Dim) + " numbers.", name);
+	}
+	Vector<float, Dim, false> result;
+	for (int i = 0; i < Dim; ++i) {
+		if (!value[i].IsNumber()) {
+			throw InvalidArgumentException("Frame capture member must be an array of " + std::to_string(Dim) + " numbers.", name);
+		}
+		result[i] = value[i].GetFloat();
+	}
+	return result;
+}
+
+template <int Dim>
+static Vector<float, Dim, false> GetVec(const Value& object, const char* name) {
+	return ToVec<Dim>(GetMember(object, name), name);
+}
+
+static Mat44 GetMatrix(const Value& object, const char* name) {
+	const Value& value = GetMember(object, name);
+	if (!value.IsArray() || value.Size() != 16) {
+		throw InvalidArgumentException("Frame capture member must be an array of 16 numbers.", name);
+	}
+	Mat44 m;
+	for (int row = 0; row < 4; ++row) {
+		for (int col = 0; col < 4; ++col) {
+			const Value& element = value[row * 4 + col];
+			if (!element.IsNumber()) {
+				throw InvalidArgumentException("Frame capture member must be an array of 16 numbers.", name);
+			}
+			m(row, col) = element.GetFloat();
+		}
+	}
+	return m;
+}
+
+// Ids must refer to an element of the lists read before.
+static int GetId(const Value& object, const char* name, size_t count) {
+	int id = GetInt(object, name);
+	if (id < -1 || id >= int(count)) {
+		throw InvalidArgumentException("Frame capture refers to a resource that does not exist.", name + (": " + std::to_string(id)));
+	}
+	return id;
+}
+
+
+FrameCapture FrameCapture::Read(std::istream& input) {
+	rapidjson::IStreamWrapper stream(input);
+	rapidjson::Document doc;
+	doc.ParseStream(stream);
+	if (doc.HasParseError() || !doc.IsObject()) {
+		throw InvalidArgumentException("Frame capture is not a JSON object.");
+	}
+
+	FrameCapture capture;
+	capture.frame = GetUint64(doc, "frame");
+	capture.elapsed = GetFloat(doc, "elapsed");
+	capture.width = unsigned(GetUint64(doc, "width"));
+	capture.height = unsigned(GetUint64(doc, "height"));
+	if (capture.width == 0 || capture.height == 0) {
+		throw InvalidArgumentException("Frame capture has no back buffer size.");
+	}
+	capture.pipeline = GetString(doc, "pipeline");
+	if (GetString(doc, "pipelineEncoding") == "hex") {
+		capture.pipeline = FromHex(capture.pipeline);
+	}
+
+	for (const Value& value : GetArray(doc, "meshes").GetArray()) {
+		MeshDesc mesh;
+		mesh.name = GetString(value, "name");
+		mesh.vertexCount = GetUint64(value, "vertexCount");
+		for (const Value& count : GetArray(value, "lodIndexCounts").GetArray()) {
+			if (!count.IsUint() || count.GetUint() % 3 != 0) {
+				throw InvalidArgumentException("Frame capture has levels of detail that are not triangles.", mesh.name);
+			}
+			mesh.lodIndexCounts.push_back(count.GetUint());
+		}
+		mesh.localBounds = BoundingBox(GetVec<3>(value, "boundsLower"), GetVec<3>(value, "boundsUpper"));
+		capture.meshes.push_back(std::move(mesh));
+	}
+
+	for (const Value& value : GetArray(doc, "images").GetArray()) {
+		ImageDesc image;
+		image.name = GetString(value, "name");
+		image.width = GetUint64(value, "width");
+		image.height = uint32_t(GetUint64(value, "height"));
+		image.channelType = ePixelChannelType(GetInt(value, "channelType"));
+		image.channelCount = GetInt(value, "channelCount");
+		image.pixelClass = ePixelClass(GetInt(value, "pixelClass"));
+		image.mipLevels = GetInt(value, "mipLevels");
+		if (image.channelType < ePixelChannelType::INT8_NORM || image.channelType > ePixelChannelType::BC7
+			|| image.channelCount < 1 || image.channelCount > 4 || image.mipLevels < 1) {
+			throw InvalidArgumentException("Frame capture has an image of an unknown format.", image.name);
+		}
+		capture.images.push_back(std::move(image));
+	}
+
+	for (const Value& value : GetArray(doc, "materialShaders").GetArray()) {
+		capture.materialShaders.push_back(MaterialShaderDesc{ GetString(value, "code") });
+	}
+
+	for (const Value& value : GetArray(doc, "materials").GetArray()) {
+		MaterialDesc material;
+		material.name = GetString(value, "name");
+		material.shader = GetId(value, "shader", capture.materialShaders.size());
+		for (const Value& parameterValue : GetArray(value, "parameters").GetArray()) {
+			ParameterDesc parameter;
+			parameter.name = GetString(parameterValue, "name");
+			parameter.type = eMaterialShaderParamType(GetInt(parameterValue, "type"));
+			parameter.set = GetBool(parameterValue, "set");
+			parameter.color = GetVec<4>(parameterValue, "color");
+			parameter.value = GetFloat(parameterValue, "value");
+			parameter.image = GetId(parameterValue, "image", capture.images.size());
+			material.parameters.push_back(std::move(parameter));
+		}
+		capture.materials.push_back(std::move(material));
+	}
+
+	for (const Value& value : GetArray(doc, "scenes").GetArray()) {
+		SceneDesc scene;
+		scene.name = GetString(value, "name");
+		for (const Value& entityValue : GetArray(value, "meshEntities").GetArray()) {
+			MeshEntityDesc entity;
+			entity.mesh = GetId(entityValue, "mesh", capture.meshes.size());
+			entity.material = GetId(entityValue, "material", capture.materials.size());
+			entity.transform = GetMatrix(entityValue, "transform");
+			entity.dynamic = GetBool(entityValue, "dynamic");
+			entity.occluderHint = eOccluderHint(std::clamp(GetInt(entityValue, "occluderHint"), int(eOccluderHint::AUTO), int(eOccluderHint::NEVER)));
+			scene.meshEntities.push_back(entity);
+		}
+		for (const Value& lightValue : GetArray(value, "directionalLights").GetArray()) {
+			scene.directionalLights.push_back(DirectionalLightDesc{ GetVec<3>(lightValue, "direction"), GetVec<3>(lightValue, "color") });
+		}
+		for (const Value& lightValue : GetArray(value, "pointLights").GetArray()) {
+			scene.pointLights.push_back(PointLightDesc{ GetVec<3>(lightValue, "position"), GetVec<3>(lightValue, "color"), GetFloat(lightValue, "range") });
+		}
+		for (const Value& lightValue : GetArray(value, "spotLights").GetArray()) {
+			SpotLightDesc light;
+			light.position = GetVec<3>(lightValue, "position");
+			light.direction = GetVec<3>(lightValue, "direction");
+			light.color = GetVec<3>(lightValue, "color");
+			light.range = GetFloat(lightValue, "range");
+			light.innerAngle = GetFloat(lightValue, "innerAngle");
+			light.outerAngle = GetFloat(lightValue, "outerAngle");
+			scene.spotLights.push_back(light);
+		}
+		capture.scenes.push_back(std::move(scene));
+	}
+
+	for (const Value& value : GetArray(doc, "cameras").GetArray()) {
+		CameraDesc camera;
+		camera.name = GetString(value, "name");
+		camera.perspective = GetString(value, "type") == "perspective";
+		camera.position = GetVec<3>(value, "position");
+		camera.lookDirection = GetVec<3>(value, "lookDirection");
+		camera.upVector = GetVec<3>(value, "upVector");
+		camera.nearPlane = GetFloat(value, "nearPlane");
+		camera.farPlane = GetFloat(value, "farPlane");
+		camera.focus = GetFloat(value, "focus");
+		camera.fovHorizontal = GetFloat(value, "fovHorizontal");
+		camera.fovVertical = GetFloat(value, "fovVertical");
+		camera.width = GetFloat(value, "width");
+		camera.height = GetFloat(value, "height");
+		capture.cameras.push_back(std::move(camera));
+	}
+
+	for (const Value& value : GetArray(doc, "envVariables").GetArray()) {
+		EnvVariableDesc variable;
+		variable.name = GetString(value, "name");
+		const std::string type = GetString(value, "type");
+		const char* const name = variable.name.c_str();
+		if (type == "bool") {
+			variable.value = GetBool(value, "value");
+		}
+		else if (type == "int") {
+			variable.value = GetInt(value, "value");
+		}
+		else if (type == "float") {
+			variable.value = GetFloat(value, "value");
+		}
+		else if (type == "vec2") {
+			variable.value = ToVec<2>(GetMember(value, "value"), name);
+		}
+		else if (type == "vec3") {
+			variable.value = ToVec<3>(GetMember(value, "value"), name);
+		}
+		else if (type == "vec4") {
+			variable.value = ToVec<4>(GetMember(value, "value"), name);
+		}
+		else if (type == "string") {
+			variable.value = GetString(value, "value");
+		}
+		else if (type == "image") {
+			variable.value = ImageRef{ GetId(value, "value", capture.images.size()) };
+		}
+		else {
+			throw InvalidArgumentException("Frame capture has an env variable of an unknown type.", type);
+		}
+		capture.envVariables.push_back(std::move(variable));
+	}
+
+	for (const Value& value : GetArray(doc, "skippedEnvVariables").GetArray()) {
+		if (!value.IsString()) {
+			throw InvalidArgumentException("Frame capture member must be a string.", "skippedEnvVariables");
+		}
+		capture.skippedEnvVariables.push_back(value.GetString());
+	}
+
+	return capture;
+}
+
+
+//------------------------------------------------------------------------------
+// Recording
+//------------------------------------------------------------------------------
+
+FrameCaptureRecorder::FrameCaptureRecorder(FrameCaptureNaming naming)
+	: m_naming(std::move(naming)) {}
+
+
+void FrameCaptureRecorder::SetFrame(uint64_t frame, float elapsed, unsigned width, unsigned height) {
+	m_capture.frame = frame;
+	m_capture.elapsed = elapsed;
+	m_capture.width = width;
+	m_capture.height = height;
+}
+
+
+void FrameCaptureRecorder::SetPipeline(std::string description) {
+	m_capture.pipeline = std::move(description);
+}
+
+
+void FrameCaptureRecorder::AddScene(const Scene& scene) {
+	FrameCapture::SceneDesc desc;
+	desc.name = scene.GetName();
+	for (const MeshEntity* entity : scene.GetEntities<MeshEntity>()) {
+		FrameCapture::MeshEntityDesc entityDesc;
+		entityDesc.mesh = GetMeshId(entity->GetMesh());
+		entityDesc.material = GetMaterialId(entity->GetMaterial());
+		entityDesc.transform = entity->GetTransform();
+		entityDesc.dynamic = entity->IsDynamic();
+		entityDesc.occluderHint = entity->GetOccluderHint();
+		desc.meshEntities.push_back(entityDesc);
+	}
+	for (const DirectionalLight* light : scene.GetEntities<DirectionalLight>()) {
+		desc.directionalLights.push_back({ light->GetDirection(), light->GetColor() });
+	}
+	for (const PointLight* light : scene.GetEntities<PointLight>()) {
+		desc.pointLights.push_back({ light->GetPosition(), light->GetColor(), light->GetRange() });
+	}
+	for (const SpotLight* light : scene.GetEntities<SpotLight>()) {
+		FrameCapture::SpotLightDesc lightDesc;
+		lightDesc.position = light->GetPosition();
+		lightDesc.direction = light->GetDirection();
+		lightDesc.color = light->GetColor();
+		lightDesc.range = light->GetRange();
+		lightDesc.innerAngle = light->GetInnerAngle();
+		lightDesc.outerAngle = light->GetOuterAngle();
+		desc.spotLights.push_back(lightDesc);
+	}
+	m_capture.scenes.push_back(std::move(desc));
+}
+
+
+void FrameCaptureRecorder::AddCamera(const BasicCamera& camera) {
+	FrameCapture::CameraDesc desc;
+	desc.name = camera.GetName();
+	desc.position = camera.GetPosition();
+	desc.lookDirection = camera.GetLookDirection();
+	desc.upVector = camera.GetUpVector();
+	desc.nearPlane = camera.GetNearPlane();
+	desc.farPlane = camera.GetFarPlane();
+	desc.focus = camera.GetFocus();
+	if (auto perspective = dynamic_cast<const PerspectiveCamera*>(&camera)) {
+		desc.perspective = true;
+		desc.fovHorizontal = perspective->GetFOVHorizontal();
+		desc.fovVertical = perspective->GetFOVVertical();
+	}
+	else if (auto orthographic = dynamic_cast<const OrthographicCamera*>(&camera)) {
+		desc.perspective = false;
+		desc.width = orthographic->GetWidth();
+		desc.height = orthographic->GetHeight();
+	}
+	m_capture.cameras.push_back(std::move(desc));
+}
+
+
+void FrameCaptureRecorder::AddEnvVariable(const std::string& name, const Any& value) {
+	FrameCapture::EnvValue captured;
+	const std::type_index type = value.Type();
+	if (type == typeid(bool)) {
+		captured = value.Get<bool>();
+	}
+	else if (type == typeid(int)) {
+		captured = value.Get<int>();
+	}
+	else if (type == typeid(float)) {
+		captured = value.Get<float>();
+	}
+	else if (type == typeid(Vec2)) {
+		captured = value.Get<Vec2>();
+	}
+	else if (type == typeid(Vec3)) {
+		captured = value.Get<Vec3>();
+	}
+	else if (type == typeid(Vec4)) {
+		captured = value.Get<Vec4>();
+	}
+	else if (type == typeid(std::string)) {
+		captured = value.Get<std::string>();
+	}
+	else if (type == typeid(Image*)) {
+		captured = FrameCapture::ImageRef{ GetImageId(value.Get<Image*>()) };
+	}
+	else if (type == typeid(const Image*)) {
+		captured = FrameCapture::ImageRef{ GetImageId(value.Get<const Image*>()) };
+	}
+	else {
+		m_capture.skippedEnvVariables.push_back(name);
+		return;
+	}
+	m_capture.envVariables.push_back({ name, std::move(captured) });
+}
+
+
+FrameCapture FrameCaptureRecorder::Finish() {
+	auto byName = [](const auto& lhs, const auto& rhs) { return lhs.name < rhs.name; };
+	std::stable_sort(m_capture.scenes.begin(), m_capture.scenes.end(), byName);
+	std::stable_sort(m_capture.cameras.begin(), m_capture.cameras.end(), byName);
+
+	FrameCapture capture = std::move(m_capture);
+	m_capture = {};
+	m_meshIds.clear();
+	m_imageIds.clear();
+	m_materialShaderIds.clear();
+	m_materialIds.clear();
+	return capture;
+}
+
+
+int FrameCaptureRecorder::GetMeshId(const Mesh* mesh) {
+	if (!mesh) {
+		return -1;
+	}
+	auto [it, isNew] = m_meshIds.insert({ mesh, int(m_capture.meshes.size()) });
+	if (isNew) {
+		FrameCapture::MeshDesc desc;
+		desc.name = m_naming.mesh ? m_naming.mesh(*mesh) : std::string{};
+		if (mesh->GetNumStreams() > 0 && mesh->GetVertexBufferStride(0) > 0) {
+			desc.vertexCount = mesh->GetVertexBuffer(0).GetSize() / mesh->GetVertexBufferStride(0);
+		}
+		for (size_t level = 0; level < mesh->GetLodCount(); ++level) {
+			desc.lodIndexCounts.push_back(mesh->GetLod(level).indexCount);
+		}
+		desc.localBounds = mesh->GetLocalBounds();
+		m_capture.meshes.push_back(std::move(desc));
+	}
+	return it->second;
+}
+
+
+int FrameCaptureRecorder::GetImageId(const Image* image) {
+	if (!image) {
+		return -1;
+	}
+	auto [it, isNew] = m_imageIds.insert({ image, int(m_capture.images.size()) });
+	if (isNew) {
+		FrameCapture::ImageDesc desc;
+		desc.name = m_naming.image ? m_naming.image(*image) : std::string{};
+		desc.width = image->GetWidth();
+		desc.height = uint32_t(image->GetHeight());
+		desc.channelType = image->GetChannelType();
+		desc.channelCount = image->GetChannelCount();
+		desc.pixelClass = image->GetPixelClass();
+		desc.mipLevels = std::max(1, int(image->GetMipLevelCount()));
+		m_capture.images.push_back(std::move(desc));
+	}
+	return it->second;
+}
+
+
+int FrameCaptureRecorder::GetMaterialShaderId(const MaterialShader* shader) {
+	if (!shader) {
+		return -1;
+	}
+	auto [it, isNew] = m_materialShaderIds.insert({ shader, int(m_capture.materialShaders.size()) });
+	if (isNew) {
+		m_capture.materialShaders.push_back({ shader->GetShaderCode() });
+	}
+	return it->second;
+}
+
+
+int FrameCaptureRecorder::GetMaterialId(const Material* material) {
+	if (!material) {
+		return -1;
+	}
+	auto it = m_materialIds.find(material);
+	if (it != m_materialIds.end()) {
+		return it->second;
+	}
+
+	// The images of the parameters get their ids first, the material's own comes after them.
+	FrameCapture::MaterialDesc desc;
+	desc.name = m_naming.material ? m_naming.material(*material) : std::string{};
+	desc.shader = GetMaterialShaderId(material->GetShader());
+	for (size_t i = 0; i < material->GetParameterCount(); ++i) {
+		const Material::Parameter& parameter = (*material)[i];
+		FrameCapture::ParameterDesc parameterDesc;
+		parameterDesc.name = parameter.GetName();
+		parameterDesc.type = parameter.GetType();
+		parameterDesc.set = parameter.IsSet();
+		if (parameter.IsSet()) {
+			switch (parameter.GetType()) {
+				case eMaterialShaderParamType::COLOR: parameterDesc.color = parameter; break;
+				case eMaterialShaderParamType::VALUE: parameterDesc.value = parameter; break;
+				case eMaterialShaderParamType::BITMAP_COLOR_2D: [[fallthrough]];
+				case eMaterialShaderParamType::BITMAP_VALUE_2D: parameterDesc.image = GetImageId(parameter); break;
+				default: break;
+			}
+		}
+		desc.parameters.push_back(std::move(parameterDesc));
+	}
+	const int id = int(m_capture.materials.size());
+	m_materialIds.insert({ material, id });
+	m_capture.materials.push_back(std::move(desc));
+	return id;
+}
+
+
+} // namespace inl::gxeng
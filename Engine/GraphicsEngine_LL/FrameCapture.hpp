@@ -0,0 +1,198 @@
+#pragma once
+
+#include "BoundingVolumes.hpp"
+#include "Material.hpp"
+#include "MeshEntity.hpp"
+
+#include <GraphicsEngine/Resources/Pixel.hpp>
+
+#include <BaseLibrary/Any.hpp>
+
+#include <InlineMath.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+class BasicCamera;
+class Image;
+class Mesh;
+class MaterialShader;
+class Scene;
+
+
+/// <summary> The inputs of one frame of the graphics engine, see <see cref="GraphicsEngine::CaptureFrame"/>. </summary>
+/// <remarks> <para> Resources are referred to by their index in the lists of the capture, their id, -1 is none.
+///		Meshes and images are described by their size and format, not their contents,
+///		a replay draws stand-ins of the same size. Material shaders keep their generated code. </para>
+///		<para> Overlay and text entities and 2D cameras are not captured, neither are env variables of
+///		types other than those of <see cref="EnvValue"/>, their names are listed instead. </para> </remarks>
+struct FrameCapture {
+	struct MeshDesc {
+		std::string name; // Given by the capture's naming, empty if it has none.
+		uint64_t vertexCount = 0;
+		std::vector<uint32_t> lodIndexCounts; // Finest first.
+		BoundingBox localBounds;
+	};
+
+	struct ImageDesc {
+		std::string name;
+		uint64_t width = 0;
+		uint32_t height = 0;
+		ePixelChannelType channelType = ePixelChannelType::INT8_NORM;
+		int channelCount = 4;
+		ePixelClass pixelClass = ePixelClass::LINEAR;
+		int mipLevels = 1;
+	};
+
+	struct MaterialShaderDesc {
+		std::string code; // Of the main function and what it calls, as the material's shader generated it.
+	};
+
+	struct ParameterDesc {
+		std::string name;
+		eMaterialShaderParamType type = eMaterialShaderParamType::UNKNOWN;
+		bool set = false;
+		Vec4 color = { 0, 0, 0, 0 };
+		float value = 0.0f;
+		int image = -1;
+	};
+
+	struct MaterialDesc {
+		std::string name;
+		int shader = -1;
+		std::vector<ParameterDesc> parameters;
+	};
+
+	struct MeshEntityDesc {
+		int mesh = -1;
+		int material = -1;
+		Mat44 transform = Mat44::Identity();
+		bool dynamic = false;
+		eOccluderHint occluderHint = eOccluderHint::AUTO;
+	};
+
+	struct DirectionalLightDesc {
+		Vec3 direction = { 0, 0, -1 };
+		Vec3 color = { 1, 1, 1 };
+	};
+
+	struct PointLightDesc {
+		Vec3 position = { 0, 0, 0 };
+		Vec3 color = { 1, 1, 1 };
+		float range = 1.0f;
+	};
+
+	struct SpotLightDesc : PointLightDesc {
+		Vec3 direction = { 0, 0, -1 };
+		float innerAngle = 0.5f;
+		float outerAngle = 0.6f;
+	};
+
+	struct SceneDesc {
+		std::string name;
+		std::vector<MeshEntityDesc> meshEntities; // In the order of the scene's collection.
+		std::vector<DirectionalLightDesc> directionalLights;
+		std::vector<PointLightDesc> pointLights;
+		std::vector<SpotLightDesc> spotLights;
+	};
+
+	struct CameraDesc {
+		std::string name;
+		bool perspective = true; // Orthographic otherwise.
+		Vec3 position = { 0, 0, 0 };
+		Vec3 lookDirection = { 0, 1, 0 };
+		Vec3 upVector = { 0, 0, 1 };
+		float nearPlane = 0.1f;
+		float farPlane = 1000.0f;
+		float focus = 1.0f;
+		float fovHorizontal = 1.0f; // Perspective cameras only.
+		float fovVertical = 1.0f;
+		float width = 1.0f; // Orthographic cameras only.
+		float height = 1.0f;
+	};
+
+	/// <summary> An env variable value that refers to an image of the capture. </summary>
+	struct ImageRef {
+		int image = -1;
+		bool operator==(const ImageRef& rhs) const { return image == rhs.image; }
+	};
+	using EnvValue = std::variant<bool, int, float, Vec2, Vec3, Vec4, std::string, ImageRef>;
+
+	struct EnvVariableDesc {
+		std::string name;
+		EnvValue value;
+	};
+
+	uint64_t frame = 0; // Frames rendered before the capture.
+	float elapsed = 0.0f; // Seconds, as given to the last update.
+	unsigned width = 0; // Of the back buffer.
+	unsigned height = 0;
+	std::string pipeline; // JSON or binary description, as given to LoadPipeline.
+
+	std::vector<MeshDesc> meshes;
+	std::vector<ImageDesc> images;
+	std::vector<MaterialShaderDesc> materialShaders;
+	std::vector<MaterialDesc> materials;
+	std::vector<SceneDesc> scenes; // Ordered by name.
+	std::vector<CameraDesc> cameras; // Ordered by name.
+	std::vector<EnvVariableDesc> envVariables; // In the order they were first set.
+	std::vector<std::string> skippedEnvVariables; // Set to values of other types.
+
+	/// <summary> Writes the capture as JSON, binary pipeline descriptions are hex encoded. </summary>
+	void Write(std::ostream& output) const;
+	/// <summary> Reads what <see cref="Write"/> wrote. </summary>
+	/// <exception cref="InvalidArgumentException"> If the capture is malformed. </exception>
+	static FrameCapture Read(std::istream& input);
+};
+
+
+/// <summary> Names the resources of a capture, e.g. with the asset they were loaded from. </summary>
+/// <remarks> Names only help telling the resources apart when reading a capture, a replay does not use them.
+///		Resources get an empty name if the function is not set. </remarks>
+struct FrameCaptureNaming {
+	std::function<std::string(const Mesh&)> mesh;
+	std::function<std::string(const Image&)> image;
+	std::function<std::string(const Material&)> material;
+};
+
+
+/// <summary> Collects the scenes, cameras and env variables into a <see cref="FrameCapture"/>, giving ids to the resources they use. </summary>
+class FrameCaptureRecorder {
+public:
+	explicit FrameCaptureRecorder(FrameCaptureNaming naming = {});
+
+	void SetFrame(uint64_t frame, float elapsed, unsigned width, unsigned height);
+	void SetPipeline(std::string description);
+	void AddScene(const Scene& scene);
+	void AddCamera(const BasicCamera& camera);
+	void AddEnvVariable(const std::string& name, const Any& value);
+
+	/// <summary> Sorts the scenes and cameras by name, so that captures of the same state match. </summary>
+	FrameCapture Finish();
+
+private:
+	int GetMeshId(const Mesh* mesh);
+	int GetImageId(const Image* image);
+	int GetMaterialShaderId(const MaterialShader* shader);
+	int GetMaterialId(const Material* material);
+
+private:
+	FrameCaptureNaming m_naming;
+	FrameCapture m_capture;
+	std::unordered_map<const Mesh*, int> m_meshIds;
+	std::unordered_map<const Image*, int> m_imageIds;
+	std::unordered_map<const MaterialShader*, int> m_materialShaderIds;
+	std::unordered_map<const Material*, int> m_materialIds;
+};
+
+
+} // namespace inl::gxeng
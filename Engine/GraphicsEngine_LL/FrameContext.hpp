@@ -6,6 +6,7 @@
 #include "UploadManager.hpp"
 
 #include <BaseLibrary/Logging/LogStream.hpp>
+#include <BaseLibrary/Memory/LinearArena.hpp>
 #include <GraphicsApi_LL/ICommandQueue.hpp>
 #include <GraphicsApi_LL/IGraphicsApi.hpp>
 
@@ -32,6 +33,7 @@ namespace gxeng {
 	class RTVHeap;
 	class DSVHeap;
 	class CommandQueue;
+	class GpuProfiler;
 
 	struct FrameContext {
 		std::chrono::nanoseconds frameTime;
@@ -49,12 +51,19 @@ namespace gxeng {
 		ShaderManager* shaderManager = nullptr;
 
 		CommandQueue* commandQueue = nullptr;
+		CommandQueue* computeQueue = nullptr; // Runs async compute lists next to commandQueue, may be null.
+		CommandQueue* copyQueue = nullptr; // Runs uploads next to commandQueue, may be null.
 		Texture2D backBuffer;
 		const std::set<Scene*>* scenes = nullptr;
 		const std::set<BasicCamera*>* cameras = nullptr;
 		const std::vector<UploadManager::UploadDescription>* uploadRequests = nullptr;
+		const std::vector<UploadManager::MipGenerationDescription>* mipGenerationRequests = nullptr; // Run after the uploads.
+		const std::vector<UploadManager::PrefilterDescription>* prefilterRequests = nullptr; // Start after the mip generations.
 
 		ResourceResidencyQueue* residencyQueue = nullptr;
+		LinearArena* frameArena = nullptr; // Reset at the end of the frame.
+		GpuProfiler* gpuProfiler = nullptr; // Measures GPU time per node if not null.
+		const std::vector<bool>* skippedTasks = nullptr; // Indexed by task graph id, these are neither set up nor executed. May be null.
 
 		uint64_t frame;
 	};
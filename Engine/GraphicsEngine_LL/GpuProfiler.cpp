@@ -0,0 +1,176 @@
+#include "GpuProfiler.hpp"
+
+#include "ComputeCommandList.hpp"
+#include "MemoryManager.hpp"
+
+#include <algorithm>
+
+
+namespace inl::gxeng {
+
+
+GpuProfiler::GpuProfiler(gxapi::IGraphicsApi* graphicsApi, MemoryManager& memoryManager, uint64_t graphicsFrequency, uint64_t computeFrequency)
+	: m_timestampHeap(graphicsApi->CreateQueryHeap({ gxapi::eQueryHeapType::TIMESTAMP, 2 * MaxScopes * FrameLatency })),
+	  m_statisticsHeap(graphicsApi->CreateQueryHeap({ gxapi::eQueryHeapType::PIPELINE_STATISTICS, MaxScopes * FrameLatency })),
+	  m_timestampReadback(memoryManager.CreateReadbackBuffer(2 * MaxScopes * FrameLatency * sizeof(uint64_t))),
+	  m_statisticsReadback(memoryManager.CreateReadbackBuffer(MaxScopes * FrameLatency * sizeof(gxapi::PipelineStatistics))),
+	  m_graphicsFrequency(graphicsFrequency),
+	  m_computeFrequency(computeFrequency),
+	  m_scopes(MaxScopes * FrameLatency) {
+	m_timestampReadback.SetName("GPU profiler timestamp readback");
+	m_statisticsReadback.SetName("GPU profiler statistics readback");
+	for (unsigned slot = 0; slot < FrameLatency; ++slot) {
+		m_slotFrames[slot] = 0;
+		m_slotUsed[slot] = false;
+		m_scopeCounts[slot] = 0;
+	}
+}
+
+
+void GpuProfiler::BeginFrame(uint64_t frame) {
+	unsigned slot = unsigned(frame % FrameLatency);
+	if (m_slotUsed[slot]) {
+		GpuFrameReport report;
+		report.frame = m_slotFrames[slot];
+
+		unsigned count = std::min(m_scopeCounts[slot].load(), MaxScopes);
+		if (count > 0) {
+			const Scope* scopes = m_scopes.data() + MaxScopes * slot;
+			auto timestamps = reinterpret_cast<const uint64_t*>(m_timestampReadback.Map()) + 2 * MaxScopes * slot;
+			bool anyStatistics = std::any_of(scopes, scopes + count, [](const Scope& scope) { return scope.statistics; });
+			auto statistics = anyStatistics ? reinterpret_cast<const gxapi::PipelineStatistics*>(m_statisticsReadback.Map()) + MaxScopes * slot : nullptr;
+
+			uint64_t frameBegin = std::numeric_limits<uint64_t>::max();
+			uint64_t frameEnd = 0;
+			for (unsigned i = 0; i < count; ++i) {
+				if (!scopes[i].compute) {
+					frameBegin = std::min(frameBegin, timestamps[2 * i]);
+					frameEnd = std::max(frameEnd, timestamps[2 * i + 1]);
+				}
+				GpuNodeReport& node = FindOrAdd(report.nodes, scopes[i].name);
+				node.milliseconds += ToMilliseconds(timestamps[2 * i], timestamps[2 * i + 1], scopes[i].compute ? m_computeFrequency : m_graphicsFrequency);
+				Accumulate(node, scopes[i].counters);
+				if (scopes[i].statistics) {
+					Accumulate(node, statistics[i]);
+				}
+			}
+
+			report.frameMilliseconds = ToMilliseconds(frameBegin, frameEnd, m_graphicsFrequency);
+
+			if (anyStatistics) {
+				m_statisticsReadback.Unmap();
+			}
+			m_timestampReadback.Unmap();
+		}
+
+		std::lock_guard<std::mutex> lock(m_reportMtx);
+		m_report = std::move(report);
+	}
+
+	m_slot = slot;
+	m_slotFrames[slot] = frame;
+	m_slotUsed[slot] = true;
+	m_scopeCounts[slot] = 0;
+}
+
+
+unsigned GpuProfiler::Begin(BasicCommandList& list, const std::string& name) {
+	auto computeList = dynamic_cast<ComputeCommandList*>(&list);
+	if (!m_enabled || computeList == nullptr) {
+		return InvalidScope;
+	}
+
+	unsigned index = m_scopeCounts[m_slot].fetch_add(1);
+	if (index >= MaxScopes) {
+		return InvalidScope;
+	}
+
+	unsigned scope = MaxScopes * m_slot + index;
+	bool statistics = m_statisticsEnabled && list.GetType() == gxapi::eCommandListType::GRAPHICS;
+	m_scopes[scope] = { name, list.GetType() == gxapi::eCommandListType::COMPUTE, statistics, list.GetPerformanceCounters() };
+	computeList->EndQuery(m_timestampHeap.get(), gxapi::eQueryType::TIMESTAMP, 2 * scope);
+	if (statistics) {
+		computeList->BeginQuery(m_statisticsHeap.get(), gxapi::eQueryType::PIPELINE_STATISTICS, scope);
+	}
+	return scope;
+}
+
+
+void GpuProfiler::End(BasicCommandList& list, unsigned scope) {
+	if (scope == InvalidScope) {
+		return;
+	}
+
+	Scope& record = m_scopes[scope];
+	const CommandListCounters& counters = list.GetPerformanceCounters();
+	record.counters.numDrawCalls = counters.numDrawCalls - record.counters.numDrawCalls;
+	record.counters.numKernels = counters.numKernels - record.counters.numKernels;
+	record.counters.numScratchSpaceDescriptors = counters.numScratchSpaceDescriptors - record.counters.numScratchSpaceDescriptors;
+
+	auto& computeList = dynamic_cast<ComputeCommandList&>(list);
+	computeList.SetResourceState(m_timestampReadback, gxapi::eResourceState::COPY_DEST);
+	computeList.EndQuery(m_timestampHeap.get(), gxapi::eQueryType::TIMESTAMP, 2 * scope + 1);
+	computeList.ResolveQueryData(m_timestampHeap.get(), gxapi::eQueryType::TIMESTAMP, 2 * scope, 2, m_timestampReadback, 2 * scope * sizeof(uint64_t));
+	if (record.statistics) {
+		computeList.SetResourceState(m_statisticsReadback, gxapi::eResourceState::COPY_DEST);
+		computeList.EndQuery(m_statisticsHeap.get(), gxapi::eQueryType::PIPELINE_STATISTICS, scope);
+		computeList.ResolveQueryData(m_statisticsHeap.get(), gxapi::eQueryType::PIPELINE_STATISTICS, scope, 1, m_statisticsReadback, scope * sizeof(gxapi::PipelineStatistics));
+	}
+}
+
+
+GpuFrameReport GpuProfiler::GetReport() const {
+	std::lock_guard<std::mutex> lock(m_reportMtx);
+	return m_report;
+}
+
+
+double GpuProfiler::GetFrameMilliseconds(uint64_t& frame) const {
+	std::lock_guard<std::mutex> lock(m_reportMtx);
+	frame = m_report.frame;
+	return m_report.frameMilliseconds;
+}
+
+
+GpuNodeReport& GpuProfiler::FindOrAdd(std::vector<GpuNodeReport>& nodes, const std::string& name) {
+	// Nodes are few, a linear search keeps them in the order they were first recorded.
+	auto it = std::find_if(nodes.begin(), nodes.end(), [&name](const GpuNodeReport& node) { return node.name == name; });
+	if (it != nodes.end()) {
+		return *it;
+	}
+	nodes.push_back({ name });
+	return nodes.back();
+}
+
+
+double GpuProfiler::ToMilliseconds(uint64_t begin, uint64_t end, uint64_t frequency) {
+	if (end <= begin || frequency == 0) {
+		return 0.0;
+	}
+	return double(end - begin) * 1000.0 / double(frequency);
+}
+
+
+void GpuProfiler::Accumulate(GpuNodeReport& node, const CommandListCounters& counters) {
+	node.counters.numDrawCalls += counters.numDrawCalls;
+	node.counters.numKernels += counters.numKernels;
+	node.counters.numScratchSpaceDescriptors += counters.numScratchSpaceDescriptors;
+}
+
+
+void GpuProfiler::Accumulate(GpuNodeReport& node, const gxapi::PipelineStatistics& statistics) {
+	node.statistics.inputVertices += statistics.inputVertices;
+	node.statistics.inputPrimitives += statistics.inputPrimitives;
+	node.statistics.vertexShaderInvocations += statistics.vertexShaderInvocations;
+	node.statistics.geometryShaderInvocations += statistics.geometryShaderInvocations;
+	node.statistics.geometryShaderPrimitives += statistics.geometryShaderPrimitives;
+	node.statistics.clipperInvocations += statistics.clipperInvocations;
+	node.statistics.clipperPrimitives += statistics.clipperPrimitives;
+	node.statistics.pixelShaderInvocations += statistics.pixelShaderInvocations;
+	node.statistics.hullShaderInvocations += statistics.hullShaderInvocations;
+	node.statistics.domainShaderInvocations += statistics.domainShaderInvocations;
+	node.statistics.computeShaderInvocations += statistics.computeShaderInvocations;
+}
+
+
+} // namespace inl::gxeng
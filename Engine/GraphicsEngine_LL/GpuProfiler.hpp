@@ -0,0 +1,121 @@
+#pragma once
+
+#include "BasicCommandList.hpp"
+#include "MemoryObject.hpp"
+
+#include <GraphicsApi_LL/IGraphicsApi.hpp>
+#include <GraphicsApi_LL/IQueryHeap.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+class MemoryManager;
+
+
+struct GpuNodeReport {
+	std::string name;
+	double milliseconds = 0.0;
+	CommandListCounters counters; // Commands recorded by the node.
+	gxapi::PipelineStatistics statistics = {}; // Zero unless statistics are enabled.
+};
+
+
+struct GpuFrameReport {
+	uint64_t frame = 0; // The frame the measurements belong to.
+	double frameMilliseconds = 0.0; // From the first to the last timestamp on the master queue.
+	std::vector<GpuNodeReport> nodes; // In the order the nodes were first recorded.
+};
+
+
+/// <summary>
+/// Measures how long the GPU spends on the commands of each pipeline node.
+/// </summary>
+/// <remarks> Timestamps are written around the commands each node records and copied to a readback buffer
+///		by the same list. Results are read when the frame's slot comes around again, so they are
+///		<see cref="FrameLatency"/> frames old. <see cref="Begin"/> and <see cref="End"/> are thread safe.
+///		Lists on the copy queue are not measured, their timestamps need a separate query heap type. </remarks>
+class GpuProfiler {
+public:
+	static constexpr unsigned MaxScopes = 2048; // Per frame, later scopes are not measured.
+	static constexpr unsigned FrameLatency = 3; // More than the frames in flight.
+	static constexpr unsigned InvalidScope = std::numeric_limits<unsigned>::max();
+
+public:
+	/// <param name="graphicsFrequency"> Timestamp ticks per second on the master queue. </param>
+	/// <param name="computeFrequency"> Timestamp ticks per second on the compute queue. </param>
+	GpuProfiler(gxapi::IGraphicsApi* graphicsApi, MemoryManager& memoryManager, uint64_t graphicsFrequency, uint64_t computeFrequency);
+
+	/// <summary> Call once per frame after waiting for the oldest frame in flight, before recording lists. </summary>
+	/// <remarks> Collects the results of the frame that used the same slot. </remarks>
+	void BeginFrame(uint64_t frame);
+
+	/// <summary> Writes the start timestamp of a scope into the list. </summary>
+	/// <returns> The scope to pass to <see cref="End"/>, or <see cref="InvalidScope"/> if the list is not measured. </returns>
+	/// <remarks> Scopes may nest, the outer scope includes the inner ones. </remarks>
+	unsigned Begin(BasicCommandList& list, const std::string& name);
+
+	/// <summary> Writes the end timestamp of the scope and schedules its readback. Ignores <see cref="InvalidScope"/>. </summary>
+	void End(BasicCommandList& list, unsigned scope);
+
+	void SetEnabled(bool enabled) { m_enabled = enabled; }
+	bool IsEnabled() const { return m_enabled; }
+
+	/// <summary> Also collects pipeline statistics on graphics lists, off by default. </summary>
+	/// <remarks> Statistics queries are more expensive than timestamps. Nodes may add sub-scopes
+	///		only while this is on, see <see cref="RenderContext::BeginProfileScope"/>. </remarks>
+	void SetStatisticsEnabled(bool enabled) { m_statisticsEnabled = enabled; }
+	bool IsStatisticsEnabled() const { return m_enabled && m_statisticsEnabled; }
+
+	/// <summary> Measurements of the last collected frame, scopes with the same name are summed. </summary>
+	GpuFrameReport GetReport() const;
+
+	/// <summary> The <see cref="GpuFrameReport::frameMilliseconds"/> of the last collected frame, without copying the report. </summary>
+	/// <param name="frame"> Set to the frame of the measurement. </param>
+	double GetFrameMilliseconds(uint64_t& frame) const;
+
+	/// <summary> Returns the entry of the name, adding it if needed. </summary>
+	static GpuNodeReport& FindOrAdd(std::vector<GpuNodeReport>& nodes, const std::string& name);
+	static double ToMilliseconds(uint64_t begin, uint64_t end, uint64_t frequency);
+	static void Accumulate(GpuNodeReport& node, const CommandListCounters& counters);
+	static void Accumulate(GpuNodeReport& node, const gxapi::PipelineStatistics& statistics);
+
+private:
+	struct Scope {
+		std::string name;
+		bool compute;
+		bool statistics;
+		CommandListCounters counters; // At the beginning, then the difference at the end.
+	};
+
+private:
+	std::unique_ptr<gxapi::IQueryHeap> m_timestampHeap;
+	std::unique_ptr<gxapi::IQueryHeap> m_statisticsHeap;
+	ReadbackBuffer m_timestampReadback;
+	ReadbackBuffer m_statisticsReadback;
+	uint64_t m_graphicsFrequency;
+	uint64_t m_computeFrequency;
+
+	std::atomic_bool m_enabled = true;
+	std::atomic_bool m_statisticsEnabled = false;
+	unsigned m_slot = 0;
+	std::array<uint64_t, FrameLatency> m_slotFrames;
+	std::array<bool, FrameLatency> m_slotUsed;
+	std::array<std::atomic<unsigned>, FrameLatency> m_scopeCounts;
+	std::vector<Scope> m_scopes; // MaxScopes per slot.
+
+	GpuFrameReport m_report;
+	mutable std::mutex m_reportMtx;
+};
+
+
+} // namespace inl::gxeng
@@ -81,6 +81,16 @@ void MaterialEditorGraph::Unlink(IGraphEditorNode* targetNode, int targetPort) {
 }
 
 
+void MaterialEditorGraph::SetDefaultInput(IGraphEditorNode* node, int port, const std::string& value) {
+	MaterialEditorNode* materialNode = dynamic_cast<MaterialEditorNode*>(node);
+
+	assert(materialNode != nullptr);
+	assert(port < materialNode->GetNumInputs());
+
+	materialNode->GetRealNode()->GetInput(port)->SetDefaultValue(value);
+}
+
+
 std::vector<IGraphEditorNode*> MaterialEditorGraph::GetNodes() const {
 	std::vector<IGraphEditorNode*> nodes;
 	for (const auto& pipelineNode : m_nodes) {
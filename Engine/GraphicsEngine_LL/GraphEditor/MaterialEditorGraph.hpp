@@ -21,6 +21,7 @@ public:
 
 	inl::Link Link(IGraphEditorNode* sourceNode, int sourcePort, IGraphEditorNode* targetNode, int targetPort) override;
 	void Unlink(IGraphEditorNode* targetNode, int targetPort) override;
+	void SetDefaultInput(IGraphEditorNode* node, int port, const std::string& value) override;
 
 	std::vector<IGraphEditorNode*> GetNodes() const override;
 	std::vector<inl::Link> GetLinks() const override;
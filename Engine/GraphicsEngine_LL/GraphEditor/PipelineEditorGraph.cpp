@@ -1,4 +1,5 @@
 #include "PipelineEditorGraph.hpp"
+#include "../GraphicsEngine.hpp"
 
 #include <BaseLibrary/GraphEditor/GraphParser.hpp>
 #include <BaseLibrary/Range.hpp>
@@ -8,8 +9,8 @@
 namespace inl::gxeng {
 
 
-PipelineEditorGraph::PipelineEditorGraph(const GraphicsNodeFactory& factory)
-	: m_factory(factory)
+PipelineEditorGraph::PipelineEditorGraph(const GraphicsNodeFactory& factory, const GraphicsEngine* engine)
+	: m_factory(factory), m_engine(engine)
 {}
 
 
@@ -82,6 +83,16 @@ void PipelineEditorGraph::Unlink(IGraphEditorNode* targetNode, int targetPort) {
 }
 
 
+void PipelineEditorGraph::SetDefaultInput(IGraphEditorNode* node, int port, const std::string& value) {
+	PipelineEditorNode* pipelineNode = dynamic_cast<PipelineEditorNode*>(node);
+
+	assert(pipelineNode != nullptr);
+	assert(port < pipelineNode->GetNumInputs());
+
+	pipelineNode->GetRealNode()->GetInput(port)->SetConvert(value);
+}
+
+
 std::vector<IGraphEditorNode*> PipelineEditorGraph::GetNodes() const {
 	std::vector<IGraphEditorNode*> nodes;
 	for (const auto& pipelineNode : m_nodes) {
@@ -243,4 +254,12 @@ void PipelineEditorGraph::Clear() {
 }
 
 
+std::vector<NodeCost> PipelineEditorGraph::GetCostHistory(const IGraphEditorNode* node) const {
+	if (!m_engine || node->GetName().empty()) {
+		return {};
+	}
+	return m_engine->GetNodeCostHistory(node->GetName());
+}
+
+
 } // namespace inl::gxeng
\ No newline at end of file
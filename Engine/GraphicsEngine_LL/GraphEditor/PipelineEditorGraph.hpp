@@ -9,9 +9,12 @@
 namespace inl::gxeng {
 
 
+class GraphicsEngine;
+
 class PipelineEditorGraph : public IEditorGraph {
 public:
-	PipelineEditorGraph(const GraphicsNodeFactory& factory);
+	/// <param name="engine"> Cost histories are read from the pipeline it runs. May be null. </param>
+	PipelineEditorGraph(const GraphicsNodeFactory& factory, const GraphicsEngine* engine = nullptr);
 
 	std::vector<std::string> GetNodeList() const override;
 
@@ -20,6 +23,7 @@ public:
 
 	inl::Link Link(IGraphEditorNode* sourceNode, int sourcePort, IGraphEditorNode* targetNode, int targetPort) override;
 	void Unlink(IGraphEditorNode* targetNode, int targetPort) override;
+	void SetDefaultInput(IGraphEditorNode* node, int port, const std::string& value) override;
 
 	std::vector<IGraphEditorNode*> GetNodes() const override;
 	std::vector<inl::Link> GetLinks() const override;
@@ -31,8 +35,11 @@ public:
 	const std::string& GetContentType() const override;
 	void Clear() override;
 
+	std::vector<NodeCost> GetCostHistory(const IGraphEditorNode* node) const override;
+
 private:
 	const GraphicsNodeFactory& m_factory;
+	const GraphicsEngine* m_engine;
 	std::vector<std::unique_ptr<PipelineEditorNode>> m_nodes;
 };
 
@@ -62,6 +62,7 @@ void GraphicsCommandList::ClearDepthStencil(const DepthStencilView2D& resource,
 	bool clearStencil)
 {
 	//ExpectResourceState(resource.GetResource(), gxapi::eResourceState::DEPTH_WRITE);
+	FlushBarriers();
 	m_commandList->ClearDepthStencil(resource.GetHandle(), depth, stencil, numRects, rects, clearDepth, clearStencil);
 }
 
@@ -71,6 +72,7 @@ void GraphicsCommandList::ClearRenderTarget(const RenderTargetView2D& resource,
 	gxapi::Rectangle* rects)
 {
 	ExpectResourceState(resource.GetResource(), gxapi::eResourceState::RENDER_TARGET, resource.GetSubresourceList());
+	FlushBarriers();
 	m_commandList->ClearRenderTarget(resource.GetHandle(), color, numRects, rects);
 }
 
@@ -85,6 +87,7 @@ void GraphicsCommandList::DrawIndexedInstanced(unsigned numIndices,
 	unsigned numInstances,
 	unsigned startInstance)
 {
+	FlushBarriers();
 	m_commandList->DrawIndexedInstanced(numIndices, startIndex, vertexOffset, numInstances, startInstance);
 	m_graphicsBindingManager.CommitDrawCall();
 
@@ -96,12 +99,53 @@ void GraphicsCommandList::DrawInstanced(unsigned numVertices,
 	unsigned numInstances,
 	unsigned startInstance)
 {
+	FlushBarriers();
 	m_commandList->DrawInstanced(numVertices, startVertex, numInstances, startInstance);
 	m_graphicsBindingManager.CommitDrawCall();
 
 	m_performanceCounters.numDrawCalls++;
 }
 
+void GraphicsCommandList::ExecuteIndirect(gxapi::ICommandSignature* commandSignature,
+	unsigned maxCommandCount,
+	const LinearBuffer& argumentBuffer,
+	size_t argumentOffset,
+	const LinearBuffer* countBuffer,
+	size_t countOffset)
+{
+	ExpectResourceState(argumentBuffer, gxapi::eResourceState::INDIRECT_ARGUMENT, { gxapi::ALL_SUBRESOURCES });
+	if (countBuffer) {
+		ExpectResourceState(*countBuffer, gxapi::eResourceState::INDIRECT_ARGUMENT, { gxapi::ALL_SUBRESOURCES });
+	}
+
+	FlushBarriers();
+	m_commandList->ExecuteIndirect(commandSignature,
+		maxCommandCount,
+		argumentBuffer._GetResourcePtr(),
+		argumentOffset,
+		countBuffer ? countBuffer->_GetResourcePtr() : nullptr,
+		countOffset);
+	m_graphicsBindingManager.CommitDrawCall();
+
+	m_performanceCounters.numDrawCalls++;
+}
+
+void GraphicsCommandList::ExecuteBundle(const CommandBundle& bundle) {
+	if (!bundle.IsClosed()) {
+		throw InvalidArgumentException("Only closed bundles can be executed.");
+	}
+	for (const CommandBundle::ResourceUse& use : bundle.GetResources()) {
+		ExpectResourceState(use.resource, use.state, { gxapi::ALL_SUBRESOURCES });
+	}
+
+	FlushBarriers();
+	m_commandList->ExecuteBundle(bundle.m_contents->commandList.get());
+	m_graphicsBindingManager.CommitDrawCall();
+	m_retainedObjects.push_back(bundle.m_contents);
+
+	m_performanceCounters.numDrawCalls += bundle.GetNumDrawCalls();
+}
+
 
 //------------------------------------------------------------------------------
 // Input assembler
@@ -194,6 +238,24 @@ void GraphicsCommandList::SetViewports(unsigned numViewports, gxapi::Viewport* v
 }
 
 
+//------------------------------------------------------------------------------
+// Variable rate shading
+//------------------------------------------------------------------------------
+
+void GraphicsCommandList::SetShadingRate(gxapi::eShadingRate baseRate, const gxapi::eShadingRateCombiner* combiners) {
+	m_commandList->SetShadingRate(baseRate, combiners);
+}
+
+
+void GraphicsCommandList::SetShadingRateImage(const Texture2D* image) {
+	if (image) {
+		ExpectResourceState(*image, gxapi::eResourceState::SHADING_RATE_SOURCE, { gxapi::ALL_SUBRESOURCES });
+		FlushBarriers();
+	}
+	m_commandList->SetShadingRateImage(image ? image->_GetResourcePtr() : nullptr);
+}
+
+
 //------------------------------------------------------------------------------
 // Set graphics root signature stuff
 //------------------------------------------------------------------------------
@@ -211,86 +273,146 @@ void GraphicsCommandList::SetGraphicsBinder(const Binder* binder) {
 
 
 void GraphicsCommandList::BindGraphics(BindParameter parameter, const TextureView1D& shaderResource) {
+	BindGraphics(m_graphicsBindingManager.Resolve(parameter), shaderResource);
+}
+
+void GraphicsCommandList::BindGraphics(BindParameter parameter, const TextureView2D& shaderResource) {
+	BindGraphics(m_graphicsBindingManager.Resolve(parameter), shaderResource);
+}
+
+void GraphicsCommandList::BindGraphics(BindParameter parameter, const TextureView3D& shaderResource) {
+	BindGraphics(m_graphicsBindingManager.Resolve(parameter), shaderResource);
+}
+
+void GraphicsCommandList::BindGraphics(BindParameter parameter, const TextureViewCube& shaderResource) {
+	BindGraphics(m_graphicsBindingManager.Resolve(parameter), shaderResource);
+}
+
+void GraphicsCommandList::BindGraphics(BindParameter parameter, const BufferView& shaderResource) {
+	BindGraphics(m_graphicsBindingManager.Resolve(parameter), shaderResource);
+}
+
+void GraphicsCommandList::BindGraphics(BindParameter parameter, const ConstBufferView& shaderConstant) {
+	BindGraphics(m_graphicsBindingManager.Resolve(parameter), shaderConstant);
+}
+
+void GraphicsCommandList::BindGraphics(BindParameter parameter, const void* shaderConstant, int size/*, int offset*/) {
+	BindGraphics(m_graphicsBindingManager.Resolve(parameter), shaderConstant, size);
+}
+
+void GraphicsCommandList::BindGraphics(BindParameter parameter, const RWTextureView1D& rwResource) {
+	BindGraphics(m_graphicsBindingManager.Resolve(parameter), rwResource);
+}
+
+void GraphicsCommandList::BindGraphics(BindParameter parameter, const RWTextureView2D& rwResource) {
+	BindGraphics(m_graphicsBindingManager.Resolve(parameter), rwResource);
+}
+
+void GraphicsCommandList::BindGraphics(BindParameter parameter, const RWTextureView3D& rwResource) {
+	BindGraphics(m_graphicsBindingManager.Resolve(parameter), rwResource);
+}
+
+void GraphicsCommandList::BindGraphics(BindParameter parameter, const RWBufferView& rwResource) {
+	BindGraphics(m_graphicsBindingManager.Resolve(parameter), rwResource);
+}
+
+
+void GraphicsCommandList::BindGraphics(BindSlot slot, const TextureView1D& shaderResource) {
 	ExpectResourceState(
 		shaderResource.GetResource(),
 		gxapi::eResourceState{ gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE },
 		shaderResource.GetSubresourceList());
 
 	try {
-		m_graphicsBindingManager.Bind(parameter, shaderResource);
+		m_graphicsBindingManager.Bind(slot, shaderResource);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_graphicsBindingManager.Bind(parameter, shaderResource);
+		m_graphicsBindingManager.Bind(slot, shaderResource);
 	}
 }
 
-void GraphicsCommandList::BindGraphics(BindParameter parameter, const TextureView2D& shaderResource) {
+void GraphicsCommandList::BindGraphics(BindSlot slot, const TextureView2D& shaderResource) {
 	ExpectResourceState(
 		shaderResource.GetResource(),
 		gxapi::eResourceState{ gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE },
 		shaderResource.GetSubresourceList());
 
 	try {
-		m_graphicsBindingManager.Bind(parameter, shaderResource);
+		m_graphicsBindingManager.Bind(slot, shaderResource);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_graphicsBindingManager.Bind(parameter, shaderResource);
+		m_graphicsBindingManager.Bind(slot, shaderResource);
 	}
 }
 
-void GraphicsCommandList::BindGraphics(BindParameter parameter, const TextureView3D& shaderResource) {
+void GraphicsCommandList::BindGraphics(BindSlot slot, const TextureView3D& shaderResource) {
 	ExpectResourceState(
 		shaderResource.GetResource(),
 		gxapi::eResourceState{ gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE },
 		shaderResource.GetSubresourceList());
 
 	try {
-		m_graphicsBindingManager.Bind(parameter, shaderResource);
+		m_graphicsBindingManager.Bind(slot, shaderResource);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_graphicsBindingManager.Bind(parameter, shaderResource);
+		m_graphicsBindingManager.Bind(slot, shaderResource);
 	}
 }
 
-void GraphicsCommandList::BindGraphics(BindParameter parameter, const TextureViewCube& shaderResource) {
+void GraphicsCommandList::BindGraphics(BindSlot slot, const TextureViewCube& shaderResource) {
 	ExpectResourceState(
 		shaderResource.GetResource(),
 		gxapi::eResourceState{ gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE },
 		shaderResource.GetSubresourceList());
 
 	try {
-		m_graphicsBindingManager.Bind(parameter, shaderResource);
+		m_graphicsBindingManager.Bind(slot, shaderResource);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_graphicsBindingManager.Bind(parameter, shaderResource);
+		m_graphicsBindingManager.Bind(slot, shaderResource);
 	}
 }
 
-void GraphicsCommandList::BindGraphics(BindParameter parameter, const ConstBufferView& shaderConstant) {
+void GraphicsCommandList::BindGraphics(BindSlot slot, const BufferView& shaderResource) {
+	ExpectResourceState(
+		shaderResource.GetResource(),
+		gxapi::eResourceState{ gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE },
+		shaderResource.GetSubresourceList());
+
+	try {
+		m_graphicsBindingManager.Bind(slot, shaderResource);
+	}
+	catch (std::bad_alloc&) {
+		NewScratchSpace(1000);
+		m_graphicsBindingManager.Bind(slot, shaderResource);
+	}
+}
+
+void GraphicsCommandList::BindGraphics(BindSlot slot, const ConstBufferView& shaderConstant) {
 	if (dynamic_cast<const PersistentConstBuffer*>(&shaderConstant.GetResource())) {
 		m_additionalResources.push_back(shaderConstant.GetResource());
 	}
 
 	try {
-		m_graphicsBindingManager.Bind(parameter, shaderConstant);
+		m_graphicsBindingManager.Bind(slot, shaderConstant);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_graphicsBindingManager.Bind(parameter, shaderConstant);
+		m_graphicsBindingManager.Bind(slot, shaderConstant);
 	}
 }
 
-void GraphicsCommandList::BindGraphics(BindParameter parameter, const void* shaderConstant, int size/*, int offset*/) {
+void GraphicsCommandList::BindGraphics(BindSlot slot, const void* shaderConstant, int size/*, int offset*/) {
 	try {
-		m_graphicsBindingManager.Bind(parameter, shaderConstant, size/*, offset*/);
+		m_graphicsBindingManager.Bind(slot, shaderConstant, size/*, offset*/);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_graphicsBindingManager.Bind(parameter, shaderConstant, size/*, offset*/);
+		m_graphicsBindingManager.Bind(slot, shaderConstant, size/*, offset*/);
 	}
 }
 
@@ -301,52 +423,52 @@ void GraphicsCommandList::NewScratchSpace(size_t hint) {
 }
 
 
-void GraphicsCommandList::BindGraphics(BindParameter parameter, const RWTextureView1D& rwResource) {
+void GraphicsCommandList::BindGraphics(BindSlot slot, const RWTextureView1D& rwResource) {
 	ExpectResourceState(rwResource.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS, rwResource.GetSubresourceList());
 
 	try {
-		m_graphicsBindingManager.Bind(parameter, rwResource);
+		m_graphicsBindingManager.Bind(slot, rwResource);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_graphicsBindingManager.Bind(parameter, rwResource);
+		m_graphicsBindingManager.Bind(slot, rwResource);
 	}
 }
 
-void GraphicsCommandList::BindGraphics(BindParameter parameter, const RWTextureView2D& rwResource) {
+void GraphicsCommandList::BindGraphics(BindSlot slot, const RWTextureView2D& rwResource) {
 	ExpectResourceState(rwResource.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS, rwResource.GetSubresourceList());
 
 	try {
-		m_graphicsBindingManager.Bind(parameter, rwResource);
+		m_graphicsBindingManager.Bind(slot, rwResource);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_graphicsBindingManager.Bind(parameter, rwResource);
+		m_graphicsBindingManager.Bind(slot, rwResource);
 	}
 }
 
-void GraphicsCommandList::BindGraphics(BindParameter parameter, const RWTextureView3D& rwResource) {
+void GraphicsCommandList::BindGraphics(BindSlot slot, const RWTextureView3D& rwResource) {
 	ExpectResourceState(rwResource.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS, rwResource.GetSubresourceList());
 
 	try {
-		m_graphicsBindingManager.Bind(parameter, rwResource);
+		m_graphicsBindingManager.Bind(slot, rwResource);
 	}
 	catch (std::bad_alloc&) {
 		NewScratchSpace(1000);
-		m_graphicsBindingManager.Bind(parameter, rwResource);
+		m_graphicsBindingManager.Bind(slot, rwResource);
 	}
 }
 
-void GraphicsCommandList::BindGraphics(BindParameter parameter, const RWBufferView& rwResource) {
+void GraphicsCommandList::BindGraphics(BindSlot slot, const RWBufferView& rwResource) {
 	ExpectResourceState(rwResource.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS, rwResource.GetSubresourceList());
 
 	{
 		try {
-			m_graphicsBindingManager.Bind(parameter, rwResource);
+			m_graphicsBindingManager.Bind(slot, rwResource);
 		}
 		catch (std::bad_alloc&) {
 			NewScratchSpace(1000);
-			m_graphicsBindingManager.Bind(parameter, rwResource);
+			m_graphicsBindingManager.Bind(slot, rwResource);
 		}
 	}
 }
@@ -6,6 +6,7 @@
 #include "StackDescHeap.hpp"
 #include "BindingManager.hpp"
 #include "Cubemap.hpp"
+#include "CommandBundle.hpp"
 
 namespace inl {
 namespace gxeng {
@@ -54,7 +55,24 @@ public:
 					   unsigned numInstances = 1,
 					   unsigned startInstance = 0);
 
-	//!!! void ExecuteBundle(IGraphicsCommandList* bundle);
+	/// <summary> Executes draw commands whose arguments are written by the GPU. </summary>
+	/// <param name="maxCommandCount"> Number of commands, or the upper limit if <paramref name="countBuffer"/> is given. </param>
+	/// <param name="argumentBuffer"> Commands laid out as described by <paramref name="commandSignature"/>. </param>
+	/// <param name="countBuffer"> Optional, the actual command count is read from it as a 32 bit integer. </param>
+	/// <remarks> The argument and count buffers must be in INDIRECT_ARGUMENT state.
+	///		Resources referenced by the commands must be in the proper state too, they are not tracked here. </remarks>
+	void ExecuteIndirect(gxapi::ICommandSignature* commandSignature,
+						 unsigned maxCommandCount,
+						 const LinearBuffer& argumentBuffer,
+						 size_t argumentOffset = 0,
+						 const LinearBuffer* countBuffer = nullptr,
+						 size_t countOffset = 0);
+
+	/// <summary> Replays the draws recorded into the bundle. </summary>
+	/// <remarks> The bundle must be closed. Its vertex and index buffers are expected in the proper states,
+	///		and whatever is bound on this list is visible to its draws. The pipeline state and topology
+	///		the bundle has set remain set afterwards. The list keeps the bundle alive until the GPU is done with it. </remarks>
+	void ExecuteBundle(const CommandBundle& bundle);
 
 	// input assembler
 	void SetIndexBuffer(const IndexBuffer* resource, bool is32Bit);
@@ -80,13 +98,34 @@ public:
 	void SetViewports(unsigned numViewports, gxapi::Viewport* viewports);
 
 
+	// variable rate shading
+	/// <summary> Sets the shading rate of the following draws, see <see cref="gxapi::IGraphicsCommandList::SetShadingRate"/>. </summary>
+	void SetShadingRate(gxapi::eShadingRate baseRate, const gxapi::eShadingRateCombiner* combiners = nullptr);
+	/// <summary> Binds an R8_UINT screen space rate image, or unbinds it if null. </summary>
+	void SetShadingRateImage(const Texture2D* image);
+
+
 	// set graphics root signature stuff
 	void SetGraphicsBinder(const Binder* binder);
 
+	/// <summary> Binds by the slots the current binder resolved, which skips looking up the parameter, see <see cref="Binder::Resolve"/>. </summary>
+	void BindGraphics(BindSlot slot, const TextureView1D& shaderResource);
+	void BindGraphics(BindSlot slot, const TextureView2D& shaderResource);
+	void BindGraphics(BindSlot slot, const TextureView3D& shaderResource);
+	void BindGraphics(BindSlot slot, const TextureViewCube& shaderResource);
+	void BindGraphics(BindSlot slot, const BufferView& shaderResource);
+	void BindGraphics(BindSlot slot, const ConstBufferView& shaderConstant);
+	void BindGraphics(BindSlot slot, const void* shaderConstant, int size/*, int offset*/);
+	void BindGraphics(BindSlot slot, const RWTextureView1D& rwResource);
+	void BindGraphics(BindSlot slot, const RWTextureView2D& rwResource);
+	void BindGraphics(BindSlot slot, const RWTextureView3D& rwResource);
+	void BindGraphics(BindSlot slot, const RWBufferView& rwResource);
+
 	void BindGraphics(BindParameter parameter, const TextureView1D& shaderResource);
 	void BindGraphics(BindParameter parameter, const TextureView2D& shaderResource);
 	void BindGraphics(BindParameter parameter, const TextureView3D& shaderResource);
 	void BindGraphics(BindParameter parameter, const TextureViewCube& shaderResource);
+	void BindGraphics(BindParameter parameter, const BufferView& shaderResource);
 	void BindGraphics(BindParameter parameter, const ConstBufferView& shaderConstant);
 	void BindGraphics(BindParameter parameter, const void* shaderConstant, int size/*, int offset*/);
 	void BindGraphics(BindParameter parameter, const RWTextureView1D& rwResource);
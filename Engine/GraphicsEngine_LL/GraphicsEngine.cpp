@@ -2,9 +2,14 @@
 
 #include "GraphEditor/MaterialEditorGraph.hpp"
 #include "GraphEditor/PipelineEditorGraph.hpp"
+#include "TemporalJitter.hpp"
 
+#include <BaseLibrary/FrameProfiler.hpp>
 #include <BaseLibrary/Graph/Node.hpp>
 #include <BaseLibrary/Graph/NodeLibrary.hpp>
+#include <BaseLibrary/JobSystem/InitGraph.hpp>
+#include <BaseLibrary/Memory/MemoryTracker.hpp>
+#include <GraphicsApi_LL/HardwareCapability.hpp>
 
 #include <rapidjson/document.h>
 
@@ -14,17 +19,26 @@
 #include "Nodes/System/GetCamera2DByName.hpp"
 #include "Nodes/System/GetCameraByName.hpp"
 #include "Nodes/System/GetEnvVariable.hpp"
+#include "Nodes/System/GetRenderSize.hpp"
 #include "Nodes/System/GetSceneByName.hpp"
 #include "Nodes/System/GetTime.hpp"
 
 #include "Nodes/System/RegisterSystemNodes.hpp"
 
+#include <sstream>
+
 
 namespace inl::gxeng {
 
 using namespace gxapi;
 
 
+static constexpr const char* ShaderWarmupFile = "WarmupList.bin";
+static constexpr std::chrono::milliseconds ShaderPollInterval{ 250 };
+static constexpr const char* NodeEnabledSuffix = ".enabled";
+static constexpr uint32_t BindlessHeapCapacity = 4096; // Mirrored into each scratch space.
+
+
 GraphicsEngine::GraphicsEngine(GraphicsEngineDesc desc)
 	: m_gxapiManager(desc.gxapiManager),
 	  m_graphicsApi(desc.graphicsApi),
@@ -33,29 +47,78 @@ GraphicsEngine::GraphicsEngine(GraphicsEngineDesc desc)
 	  m_scratchSpacePool(desc.graphicsApi, gxapi::eDescriptorHeapType::CBV_SRV_UAV),
 	  m_textureSpace(desc.graphicsApi),
 	  m_masterCommandQueue(desc.graphicsApi->CreateCommandQueue(CommandQueueDesc{ eCommandListType::GRAPHICS }), desc.graphicsApi->CreateFence(0)),
-	  m_residencyQueue(std::unique_ptr<gxapi::IFence>(desc.graphicsApi->CreateFence(0))),
+	  m_computeCommandQueue(desc.graphicsApi->CreateCommandQueue(CommandQueueDesc{ eCommandListType::COMPUTE }), desc.graphicsApi->CreateFence(0)),
+	  m_copyCommandQueue(desc.graphicsApi->CreateCommandQueue(CommandQueueDesc{ eCommandListType::COPY }), desc.graphicsApi->CreateFence(0)),
+	  m_residencyQueue(std::unique_ptr<gxapi::IFence>(desc.graphicsApi->CreateFence(0)), m_scheduler.GetJobScheduler(), &m_memoryManager.GetResidencyManager()),
 	  m_memoryManager(desc.graphicsApi),
 	  m_dsvHeap(desc.graphicsApi),
 	  m_rtvHeap(desc.graphicsApi),
 	  m_persResViewHeap(desc.graphicsApi),
 	  m_logger(desc.logger),
-	  m_shaderManager(desc.gxapiManager) {
-	// Create swapchain
-	SwapChainDesc swapChainDesc;
-	swapChainDesc.format = eFormat::R8G8B8A8_UNORM;
-	swapChainDesc.width = desc.width;
-	swapChainDesc.height = desc.height;
-	swapChainDesc.numBuffers = 2;
-	swapChainDesc.targetWindow = desc.targetWindow;
-	swapChainDesc.isFullScreen = desc.fullScreen;
-	swapChainDesc.multisampleCount = 1;
-	swapChainDesc.multiSampleQuality = 0;
-	m_swapChain.reset(m_gxapiManager->CreateSwapChain(swapChainDesc, m_masterCommandQueue.GetUnderlyingQueue()));
-
-	m_frameEndFenceValues.resize(m_swapChain->GetDesc().numBuffers, { nullptr, 0 });
-
-	// Init backbuffer heap
-	m_backBufferHeap = std::make_unique<BackBufferManager>(m_graphicsApi, m_swapChain.get());
+	  m_shaderManager(desc.gxapiManager),
+	  m_qualityPreset(desc.qualityPreset),
+	  m_dynamicResolution(desc.dynamicResolution),
+	  m_temporalJitter(desc.temporalJitter) {
+	// Init logger
+	m_logStreamGeneral = m_logger->CreateLogStream("General");
+	m_logStreamPipeline = m_logger->CreateLogStream("Pipeline");
+
+	// Device objects are created here while the caches are read from disk on the job system
+	jobs::InitGraph startup;
+
+	startup.AddOnCaller("Create swap chain", [this, &desc] {
+		SwapChainDesc swapChainDesc;
+		swapChainDesc.format = eFormat::R8G8B8A8_UNORM;
+		swapChainDesc.width = desc.width;
+		swapChainDesc.height = desc.height;
+		swapChainDesc.numBuffers = 2;
+		swapChainDesc.targetWindow = desc.targetWindow;
+		swapChainDesc.isFullScreen = desc.fullScreen;
+		swapChainDesc.multisampleCount = 1;
+		swapChainDesc.multiSampleQuality = 0;
+		swapChainDesc.frameLatencyWaitable = desc.maxFrameLatency > 0;
+		m_swapChain.reset(m_gxapiManager->CreateSwapChain(swapChainDesc, m_masterCommandQueue.GetUnderlyingQueue()));
+		if (desc.maxFrameLatency > 0) {
+			m_swapChain->SetMaximumFrameLatency(desc.maxFrameLatency);
+		}
+
+		SetMaxFramesInFlight(desc.maxFramesInFlight);
+
+		// Init backbuffer heap
+		m_backBufferHeap = std::make_unique<BackBufferManager>(m_graphicsApi, m_swapChain.get());
+	});
+
+	// Unbounded SRV tables need resource binding tier 2
+	startup.AddOnCaller("Create bindless heap", [this] {
+		if (m_graphicsApi->GetCapabilityQuery()->QueryResourceBinding().GetDx12Tier() >= 2) {
+			m_bindlessHeap = std::make_unique<BindlessHeap>(m_graphicsApi, BindlessHeapCapacity);
+			m_scratchSpacePool.SetBindlessHeap(m_bindlessHeap.get());
+		}
+	});
+
+	// GPU timing per node
+	startup.AddOnCaller("Create GPU profiler", [this] {
+		m_gpuProfiler = std::make_unique<GpuProfiler>(m_graphicsApi,
+													  m_memoryManager,
+													  m_masterCommandQueue.GetUnderlyingQueue()->GetTimestampFrequency(),
+													  m_computeCommandQueue.GetUnderlyingQueue()->GetTimestampFrequency());
+	});
+
+	// Compiled pipeline states from earlier runs, before the pipeline creates any
+	if (!desc.pipelineCachePath.empty()) {
+		startup.Add("Open pipeline cache", [this, &desc] {
+			m_graphicsApi->OpenPipelineCache(desc.pipelineCachePath);
+		});
+	}
+
+	// Shaders of the last run, compiled in the background when the first pipeline is loaded
+	if (!desc.shaderCacheDirectory.empty()) {
+		startup.Add("Load shader warm-up list", [this, &desc] {
+			m_startupShaderWarmup = ShaderManager::LoadShaderRequests(desc.shaderCacheDirectory / ShaderWarmupFile);
+		});
+	}
+
+	startup.Start(m_scheduler.GetJobScheduler());
 
 	// Init shader manager before creating the pipeline
 	gxapi::eShaderCompileFlags shaderFlags;
@@ -67,20 +130,28 @@ GraphicsEngine::GraphicsEngine(GraphicsEngineDesc desc)
 	shaderFlags += gxapi::eShaderCompileFlags::DEBUG;
 #endif // NDEBUG
 	m_shaderManager.SetShaderCompileFlags(shaderFlags);
+	m_shaderManager.SetCacheDirectory(desc.shaderCacheDirectory);
 
 	// Register nodes
 	RegisterPipelineClasses();
 
-	// Init logger
-	m_logStreamGeneral = m_logger->CreateLogStream("General");
-	m_logStreamPipeline = m_logger->CreateLogStream("Pipeline");
-
 	// Init misc stuff
 	m_absoluteTime = decltype(m_absoluteTime)(0);
 	m_commandAllocatorPool.SetLogStream(&m_logStreamPipeline);
 
+	startup.Wait();
+	m_startupTimeline = startup.GetTimeline();
+	if (m_logStreamGeneral.IsEnabled(eLogLevel::INFO)) {
+		std::stringstream ss;
+		startup.WriteReport(ss);
+		m_logStreamGeneral.Event(eLogLevel::INFO, LogEvent(ss.str(), eEventType::INFO));
+	}
+
 	m_pipelineEventDispatcher += &m_memoryManager.GetUploadManager();
+	m_pipelineEventDispatcher += &m_memoryManager.GetReadbackManager();
 	m_pipelineEventDispatcher += &m_memoryManager.GetConstBufferHeap();
+	m_pipelineEventDispatcher += &m_memoryManager.GetDynamicBufferRing();
+	m_memoryManager.SetJobScheduler(&m_scheduler.GetJobScheduler());
 
 
 	// Begin awaiting frame #0's Update()
@@ -90,20 +161,164 @@ GraphicsEngine::GraphicsEngine(GraphicsEngineDesc desc)
 
 GraphicsEngine::~GraphicsEngine() {
 	std::cout << "Graphics engine shutting down..." << std::endl;
+	if (m_renderTask.valid()) {
+		m_renderTask.wait();
+	}
+	if (m_renderThread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(m_renderMutex);
+			m_renderThreadStop = true;
+		}
+		m_renderSignal.notify_one();
+		m_renderThread.join();
+	}
+	if (m_pipelineBuild) {
+		m_pipelineBuild->result.wait();
+		m_pipelineBuild.reset();
+	}
 	FlushPipelineQueue();
+	m_retiredPipelines.clear();
+	m_shaderManager.WaitPrecompile();
+	try {
+		m_graphicsApi->SavePipelineCache();
+		if (!m_shaderManager.GetCacheDirectory().empty()) {
+			ShaderManager::SaveShaderRequests(m_shaderManager.GetCacheDirectory() / ShaderWarmupFile, m_shaderManager.GetShaderRequests());
+		}
+	}
+	catch (Exception& ex) {
+		m_logStreamGeneral.Event(LogEvent(std::string("Failed to save pipeline cache: ") + ex.what(), eEventType::WARNING));
+	}
 	std::cout << "Graphics engine deleting..." << std::endl;
 }
 
 
 void GraphicsEngine::Update(float elapsed) {
+	MemoryTagScope memoryTag(eMemoryTag::GRAPHICS);
+	WaitForRender();
+
+	// The overlay edits a scene of the game, it must be done before the scenes are copied.
+	if (m_profilerOverlay && m_frame > 0) {
+		m_profilerOverlay->Update(FrameProfiler::GetGlobal().GetLastFrame(), m_gpuProfiler->GetReport());
+	}
+
 	std::chrono::nanoseconds frameTime(long long(elapsed * 1e9));
 	m_absoluteTime += frameTime;
+	m_lastElapsed = elapsed;
+
+	// Between frames, the pipeline may be rebuilt.
+	if (m_shaderHotReload && std::chrono::steady_clock::now() - m_lastShaderPoll > ShaderPollInterval) {
+		ReloadChangedShaders();
+	}
+	SwapBuiltPipeline();
+	ReleaseRetiredPipelines();
+
+	PrepareFrame();
+	if (m_frameOverlap) {
+		std::packaged_task<void()> job([this, frameTime] { RenderFrame(frameTime); });
+		m_renderTask = job.get_future();
+		{
+			std::lock_guard<std::mutex> lock(m_renderMutex);
+			m_renderJob = std::move(job);
+		}
+		m_renderSignal.notify_one();
+	}
+	else {
+		RenderFrame(frameTime);
+	}
+}
+
+
+void GraphicsEngine::SetFrameOverlap(bool enabled) {
+	WaitForRender();
+	m_frameOverlap = enabled;
+	if (!enabled) {
+		m_snapshot.Clear();
+	}
+	else if (!m_renderThread.joinable()) {
+		m_renderThread = std::thread([this] { RenderThread(); });
+	}
+}
+
+
+void GraphicsEngine::RenderThread() {
+	MemoryTagScope memoryTag(eMemoryTag::GRAPHICS);
+	std::unique_lock<std::mutex> lock(m_renderMutex);
+	while (true) {
+		m_renderSignal.wait(lock, [this] { return m_renderJob.valid() || m_renderThreadStop; });
+		if (m_renderThreadStop) {
+			return;
+		}
+		std::packaged_task<void()> job = std::move(m_renderJob);
+		lock.unlock();
+		job(); // Exceptions are kept in m_renderTask.
+		lock.lock();
+	}
+}
+
+
+void GraphicsEngine::WaitForRender() const {
+	if (m_renderTask.valid()) {
+		m_renderTask.get();
+	}
+}
+
+
+void GraphicsEngine::PrepareFrame() {
+	// Interning a name adds a variable without setting it, the handles of the copy must cover it as well.
+	if (m_renderEnvVariables.GetVersion() != m_envVariables.GetVersion() || m_renderEnvVariables.GetCount() != m_envVariables.GetCount()) {
+		m_renderEnvVariables = m_envVariables;
+	}
 
-	// Wait for previous frame on this BB to complete
+	m_preparedFrame.scenes.clear();
+	m_preparedFrame.cameras.clear();
+	m_preparedFrame.cameras2d.clear();
+	UpdateCameraJitter(); // Before the snapshot, the copies take the jitter.
+	if (m_frameOverlap) {
+		INL_PROFILE_SCOPE("Snapshot scenes");
+		m_snapshot.Update(m_scenes, m_cameras, m_cameras2d);
+		m_preparedFrame.scenes = m_snapshot.GetScenes();
+		m_preparedFrame.cameras = m_snapshot.GetCameras();
+		m_preparedFrame.cameras2d = m_snapshot.GetCameras2D();
+	}
+	else {
+		m_preparedFrame.scenes.assign(m_scenes.begin(), m_scenes.end());
+		m_preparedFrame.cameras.assign(m_cameras.begin(), m_cameras.end());
+		m_preparedFrame.cameras2d.assign(m_cameras2d.begin(), m_cameras2d.end());
+	}
+
+	// Streaming reads the requests of the last frame's pipeline and queues uploads for this one.
+	m_memoryManager.GetTextureStreamer().Update(m_frame);
+	UploadManager& uploadManager = m_memoryManager.GetUploadManager();
+	m_preparedFrame.uploads = &uploadManager.GetQueuedUploads();
+	m_preparedFrame.mipGenerations = &uploadManager.GetQueuedMipGenerations();
+	m_preparedFrame.prefilters = &uploadManager.GetQueuedPrefilters();
+
+	// What the game uploads while this frame renders goes to the next one.
+	if (m_frameOverlap) {
+		m_pipelineEventDispatcher.DispachFrameBeginAwait(m_frame + 1).wait();
+	}
+}
+
+
+void GraphicsEngine::RenderFrame(std::chrono::nanoseconds frameTime) {
+	FrameProfiler& profiler = FrameProfiler::GetGlobal();
+	profiler.BeginFrame(m_frame);
+
+	// Wait for the frame that used this slot to complete
+	size_t frameSlot = WaitForFrameSlot();
+	auto frameBegin = std::chrono::steady_clock::now();
 	int backBufferIndex = m_swapChain->GetCurrentBufferIndex();
-	if (m_frameEndFenceValues[backBufferIndex]) {
-		m_frameEndFenceValues[backBufferIndex].Wait();
+	m_memoryManager.GetResidencyManager().BeginFrame(m_frame);
+	m_scratchSpacePool.BeginFrame();
+	if (m_bindlessHeap) {
+		m_bindlessHeap->BeginFrame();
 	}
+	m_gpuProfiler->BeginFrame(m_frame);
+
+	// The render size of this frame follows the GPU time of a recent one.
+	uint64_t measuredFrame;
+	double gpuMilliseconds = m_gpuProfiler->GetFrameMilliseconds(measuredFrame);
+	m_dynamicResolution.Update(measuredFrame, gpuMilliseconds, m_frame);
 
 	// Set up context
 	FrameContext context;
@@ -123,37 +338,172 @@ void GraphicsEngine::Update(float elapsed) {
 	context.shaderManager = &m_shaderManager;
 
 	context.commandQueue = &m_masterCommandQueue;
+	context.computeQueue = &m_computeCommandQueue;
+	context.copyQueue = &m_copyCommandQueue;
 	context.backBuffer = m_backBufferHeap->GetBackBuffer(backBufferIndex);
-	context.scenes = &m_scenes;
-	context.cameras = &m_cameras;
+	context.scenes = m_frameOverlap ? nullptr : &m_scenes; // The game changes them while the frame renders.
+	context.cameras = m_frameOverlap ? nullptr : &m_cameras;
 
-	const std::vector<UploadManager::UploadDescription>& uploadRequests = m_memoryManager.GetUploadManager().GetQueuedUploads();
-	context.uploadRequests = &uploadRequests;
+	context.uploadRequests = m_preparedFrame.uploads;
+	context.mipGenerationRequests = m_preparedFrame.mipGenerations;
+	context.prefilterRequests = m_preparedFrame.prefilters;
 
 	context.residencyQueue = &m_residencyQueue;
+	context.frameArena = &m_frameArena;
+	context.gpuProfiler = m_gpuProfiler.get();
 
 	// Update special nodes for current frame
-	UpdateSpecialNodes();
+	{
+		INL_PROFILE_SCOPE("UpdateSpecialNodes");
+		UpdateSpecialNodes();
+		UpdateDisabledNodes();
+	}
+	context.skippedTasks = m_skippedTasks.empty() ? nullptr : &m_skippedTasks;
+
+	// Compose this frame's transforms and refit spatial indices to them
+	{
+		INL_PROFILE_SCOPE("Update scenes");
+		for (Scene* scene : m_preparedFrame.scenes) {
+			scene->UpdateTransforms();
+			scene->UpdateMeshEntityIndex();
+		}
+	}
 
 	// Execute the pipeline
-	m_pipelineEventDispatcher.DispatchFrameBegin(m_frame).wait();
-	m_scheduler.Execute(context);
-	m_pipelineEventDispatcher.DispatchFrameEnd(m_frame).wait();
+	{
+		INL_PROFILE_SCOPE("DispatchFrameBegin");
+		m_pipelineEventDispatcher.DispatchFrameBegin(m_frame).wait();
+	}
+	{
+		INL_PROFILE_SCOPE("Scheduler::Execute");
+		m_scheduler.Execute(context);
+	}
+	{
+		INL_PROFILE_SCOPE("DispatchFrameEnd");
+		m_pipelineEventDispatcher.DispatchFrameEnd(m_frame).wait();
+	}
+	ReportTransientMemory();
+	m_frameArena.Reset(); // Pipeline has finished, nothing refers to frame memory anymore.
 
 	// Mark frame completion
 	SyncPoint frameEnd = m_masterCommandQueue.Signal();
-	m_frameEndFenceValues[backBufferIndex] = frameEnd;
+	m_framesInFlight[frameSlot] = { frameEnd, m_frame, frameBegin, false };
 	m_pipelineEventDispatcher.DispatchDeviceFrameEnd(frameEnd, m_frame);
 
 	// Flush log
-	m_logger->Flush();
+	{
+		INL_PROFILE_SCOPE("Logger::Flush");
+		m_logger->Flush();
+	}
 
 	// Present frame
-	m_swapChain->Present();
+	{
+		INL_PROFILE_SCOPE("Present");
+		m_swapChain->Present();
+	}
 	++m_frame;
 
-	// Await next frame
-	m_pipelineEventDispatcher.DispachFrameBeginAwait(m_frame).wait(); // m_frame incremented on previous line
+	// Await next frame, overlapping frames began awaiting it before they started rendering.
+	if (!m_frameOverlap) {
+		INL_PROFILE_SCOPE("DispatchFrameBeginAwait");
+		m_pipelineEventDispatcher.DispachFrameBeginAwait(m_frame).wait(); // m_frame incremented on previous line
+	}
+
+	profiler.EndFrame();
+}
+
+
+GpuFrameReport GraphicsEngine::GetGpuFrameReport() const {
+	WaitForRender();
+	return m_gpuProfiler->GetReport();
+}
+
+
+void GraphicsEngine::SetGpuProfiling(bool enabled) {
+	WaitForRender();
+	m_gpuProfiler->SetEnabled(enabled);
+}
+
+
+void GraphicsEngine::SetGpuStatistics(bool enabled) {
+	WaitForRender();
+	m_gpuProfiler->SetStatisticsEnabled(enabled);
+}
+
+
+MemoryStatistics GraphicsEngine::GetMemoryStatistics() const {
+	WaitForRender();
+	return { m_memoryManager.GetResidencyManager().GetStatistics(), m_scheduler.GetTransientStatistics() };
+}
+
+
+void GraphicsEngine::ShowProfilerOverlay(Scene* scene, const Font* font, Vec2 topLeft, Vec2 lineSize) {
+	WaitForRender();
+	m_profilerOverlay.reset();
+	m_profilerOverlay = std::make_unique<ProfilerOverlay>(*scene, font, topLeft, lineSize);
+}
+
+
+void GraphicsEngine::HideProfilerOverlay() {
+	WaitForRender();
+	m_profilerOverlay.reset();
+}
+
+
+FrameCapture GraphicsEngine::CaptureFrame(const FrameCaptureNaming& naming) const {
+	WaitForRender();
+	FrameCaptureRecorder recorder(naming);
+	const auto desc = m_swapChain->GetDesc();
+	recorder.SetFrame(m_frame, m_lastElapsed, unsigned(desc.width), unsigned(desc.height));
+	recorder.SetPipeline(m_pipelineDescription);
+	for (auto scene : m_scenes) {
+		recorder.AddScene(*scene);
+	}
+	for (auto camera : m_cameras) {
+		recorder.AddCamera(*camera);
+	}
+	for (size_t i = 0; i < m_envVariables.GetCount(); ++i) {
+		const EnvVariableHandle handle{ uint32_t(i) };
+		if (m_envVariables.HasValue(handle)) {
+			recorder.AddEnvVariable(m_envVariables.GetName(handle), m_envVariables.Get(handle));
+		}
+	}
+	return recorder.Finish();
+}
+
+
+void GraphicsEngine::SetMaxFramesInFlight(unsigned count) {
+	WaitForRender();
+	unsigned numBuffers = m_swapChain->GetDesc().numBuffers;
+	count = count == 0 ? numBuffers : std::min(count, numBuffers); // Per frame resources are multiplied by the back buffer count at most.
+
+	for (auto& frame : m_framesInFlight) {
+		if (!frame.measured) {
+			frame.end.Wait();
+		}
+	}
+	m_framesInFlight.assign(count, {});
+}
+
+
+void GraphicsEngine::SetDynamicResolution(const DynamicResolutionDesc& desc) {
+	WaitForRender();
+	m_dynamicResolution.SetDesc(desc);
+}
+
+
+void GraphicsEngine::SetTemporalJitter(bool enabled) {
+	WaitForRender();
+	m_temporalJitter = enabled;
+}
+
+
+FramePacingStatistics GraphicsEngine::GetFramePacing() const {
+	WaitForRender();
+	FramePacingStatistics statistics = m_framePacing;
+	statistics.framesInFlight = (unsigned)m_framesInFlight.size();
+	statistics.maxFrameLatency = m_swapChain->GetMaximumFrameLatency();
+	return statistics;
 }
 
 
@@ -161,8 +511,10 @@ void GraphicsEngine::SetScreenSize(unsigned width, unsigned height) {
 	if (width == 0 || height == 0) {
 		throw InvalidArgumentException("Neither dimension can be zero.");
 	}
+	WaitForRender();
 
 	FlushPipelineQueue();
+	m_retiredPipelines.clear();
 
 	m_backBufferHeap.reset();
 	m_scheduler.ReleaseResources();
@@ -178,6 +530,7 @@ void GraphicsEngine::GetScreenSize(unsigned& width, unsigned& height) {
 
 
 void GraphicsEngine::SetFullScreen(bool enable) {
+	WaitForRender();
 	m_swapChain->SetFullScreen(enable);
 }
 bool GraphicsEngine::GetFullScreen() const {
@@ -187,7 +540,13 @@ bool GraphicsEngine::GetFullScreen() const {
 
 // Graph editor interfaces
 IEditorGraph* GraphicsEngine::QueryPipelineEditor() const {
-	return new PipelineEditorGraph(GraphicsNodeFactory_Singleton::GetInstance());
+	return new PipelineEditorGraph(GraphicsNodeFactory_Singleton::GetInstance(), this);
+}
+
+
+std::vector<NodeCost> GraphicsEngine::GetNodeCostHistory(const std::string& nodeName) const {
+	WaitForRender();
+	return m_scheduler.GetPipeline().GetCostHistory(nodeName);
 }
 
 IEditorGraph* GraphicsEngine::QueryMaterialEditor() const {
@@ -201,7 +560,7 @@ Mesh* GraphicsEngine::CreateMesh() {
 }
 
 Image* GraphicsEngine::CreateImage() {
-	return new Image(&m_memoryManager, &m_textureSpace);
+	return new Image(&m_memoryManager, &m_textureSpace, m_bindlessHeap.get());
 }
 
 Material* GraphicsEngine::CreateMaterial() {
@@ -349,56 +708,240 @@ TextEntity* GraphicsEngine::CreateTextEntity() {
 
 
 bool GraphicsEngine::SetEnvVariable(std::string name, Any obj) {
-	auto res = m_envVariables.insert_or_assign(std::move(name), std::move(obj));
-	return res.second;
+	return m_envVariables.Set(name, std::move(obj));
 }
 
 bool GraphicsEngine::EnvVariableExists(const std::string& name) {
-	return m_envVariables.count(name) > 0;
+	return m_envVariables.HasValue(m_envVariables.Find(name));
 }
 
 const Any& GraphicsEngine::GetEnvVariable(const std::string& name) {
-	auto it = m_envVariables.find(name);
-	if (it != m_envVariables.end()) {
-		return it->second;
+	return m_envVariables.Get(m_envVariables.Find(name));
+}
+
+EnvVariableHandle GraphicsEngine::GetEnvVariableHandle(const std::string& name) {
+	return m_envVariables.Intern(name);
+}
+
+bool GraphicsEngine::SetEnvVariable(EnvVariableHandle handle, Any obj) {
+	return m_envVariables.Set(handle, std::move(obj));
+}
+
+const Any& GraphicsEngine::GetEnvVariable(EnvVariableHandle handle) const {
+	return m_envVariables.Get(handle);
+}
+
+
+void GraphicsEngine::LoadPipeline(const std::string& graphDesc) {
+	WaitForRender();
+	// A pipeline still being built would replace this one later.
+	m_queuedPipelineDescription.reset();
+	if (m_pipelineBuild) {
+		m_pipelineBuild->result.wait();
+		m_pipelineBuild.reset();
+	}
+
+	StartPipelineBuild(graphDesc);
+	InstallPipelineBuild();
+}
+
+
+void GraphicsEngine::LoadPipelineAsync(const std::string& graphDesc) {
+	if (m_pipelineBuild) {
+		m_queuedPipelineDescription = graphDesc;
 	}
 	else {
-		throw InvalidArgumentException("Environment variable does not exist.");
+		StartPipelineBuild(graphDesc);
 	}
 }
 
 
-void GraphicsEngine::LoadPipeline(const std::string& graphDesc) {
-	FlushPipelineQueue();
+void GraphicsEngine::StartPipelineBuild(const std::string& graphDesc) {
+	// Edited shaders are picked up by the new nodes, unchanged ones are not recompiled.
+	// Shaders of the old pipeline, or of the last run when starting up, are compiled in the background
+	// while the nodes are created, the nodes only wait for the ones they need when setting up.
+	std::vector<ShaderRequest> shaderWarmup = m_shaderManager.GetShaderRequests();
+	if (shaderWarmup.empty()) {
+		shaderWarmup = std::move(m_startupShaderWarmup);
+		m_startupShaderWarmup.clear();
+	}
+	if (shaderWarmup.empty() && !m_shaderManager.GetCacheDirectory().empty()) {
+		shaderWarmup = ShaderManager::LoadShaderRequests(m_shaderManager.GetCacheDirectory() / ShaderWarmupFile);
+	}
+	m_shaderManager.ReloadShaders();
+	m_shaderManager.Precompile(m_scheduler.GetJobScheduler(), shaderWarmup);
 
-	Pipeline pipeline;
-	pipeline.CreateFromDescription(graphDesc, GraphicsNodeFactory_Singleton::GetInstance());
+	// Future::get copies the result, hence the shared pointer.
+	auto result = m_scheduler.GetJobScheduler().Enqueue(jobs::JobOptions{ jobs::eJobPriority::BACKGROUND }, &GraphicsEngine::BuildPipeline, graphDesc, m_qualityPreset);
+	m_pipelineBuild = PipelineBuild{ std::move(result), graphDesc, std::chrono::steady_clock::now() };
+}
 
-	EngineContext engineContext(1, 1);
-	for (auto& node : pipeline) {
-		if (auto graphicsNode = dynamic_cast<GraphicsNode*>(&node)) {
-			graphicsNode->Initialize(engineContext);
+
+std::shared_ptr<Pipeline> GraphicsEngine::BuildPipeline(const std::string& graphDesc, eQualityPreset qualityPreset) {
+	auto pipeline = std::make_shared<Pipeline>();
+	pipeline->CreateFromDescription(graphDesc, GraphicsNodeFactory_Singleton::GetInstance(), EngineContext(1, 1, qualityPreset));
+	return pipeline;
+}
+
+
+void GraphicsEngine::InstallPipelineBuild() {
+	PipelineBuild build = std::move(*m_pipelineBuild);
+	m_pipelineBuild.reset();
+
+	std::shared_ptr<Pipeline> pipeline = build.result.get();
+	auto specialNodes = SelectSpecialNodes(*pipeline);
+
+	// Frames in flight still reference the nodes of the old pipeline, it's kept until they finish.
+	RetiredPipeline retired;
+	retired.pipeline = std::make_shared<Pipeline>(m_scheduler.SetPipeline(std::move(*pipeline)));
+	retired.masterEnd = m_masterCommandQueue.Signal();
+	retired.computeEnd = m_computeCommandQueue.Signal();
+	retired.copyEnd = m_copyCommandQueue.Signal();
+	m_retiredPipelines.push_back(std::move(retired));
+
+	m_specialNodes = specialNodes;
+	m_pipelineDescription = build.description;
+
+	const Pipeline& installed = m_scheduler.GetPipeline();
+	m_nodeSwitches.clear();
+	for (const NodeBase& node : installed) {
+		if (!node.GetDisplayName().empty()) {
+			m_nodeSwitches.push_back({ &node, m_envVariables.Intern(node.GetDisplayName() + NodeEnabledSuffix) });
 		}
 	}
+	m_disabledNodes.clear();
+	m_skippedTasks.clear();
+	m_nodeSwitchVersion = 0;
 
-	auto specialNodes = SelectSpecialNodes(pipeline);
+	// Names are resolved once, the nodes only read the values from then on.
+	for (auto node : m_specialNodes) {
+		if (auto* getEnv = dynamic_cast<nodes::GetEnvVariable*>(node)) {
+			getEnv->SetEnvVariableList(&m_renderEnvVariables);
+		}
+	}
 
-	m_specialNodes = specialNodes;
-	m_pipeline = std::move(pipeline);
-	m_scheduler.SetPipeline(std::move(m_pipeline));
+	auto unusedNodes = installed.GetUnusedNodes();
+	if (!unusedNodes.empty()) {
+		std::stringstream ss;
+		ss << unusedNodes.size() << " pipeline nodes are left out and not initialized, their outputs reach no sink:";
+		for (auto node : unusedNodes) {
+			ss << " " << (node->GetDisplayName().empty() ? node->GetClassName(true) : node->GetDisplayName());
+		}
+		m_logStreamPipeline.Event(LogEvent(ss.str(), eEventType::INFO));
+	}
+}
+
+
+void GraphicsEngine::SwapBuiltPipeline() {
+	if (!m_pipelineBuild || !m_pipelineBuild->result.ready() || !m_shaderManager.IsPrecompileDone()) {
+		return;
+	}
+
+	auto buildBegin = m_pipelineBuild->begin;
+	try {
+		InstallPipelineBuild();
+		std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - buildBegin;
+		static const LogFormat format("Pipeline replaced, built in {} ms.");
+		INL_LOG(m_logStreamGeneral, eLogLevel::INFO, format, buildTime.count());
+	}
+	catch (Exception& ex) {
+		m_logStreamGeneral.Event(LogEvent(std::string("Failed to build pipeline, keeping the current one: ") + ex.what(), eEventType::WARNING));
+	}
+
+	if (m_queuedPipelineDescription) {
+		std::string graphDesc = std::move(*m_queuedPipelineDescription);
+		m_queuedPipelineDescription.reset();
+		StartPipelineBuild(graphDesc);
+	}
+}
+
+
+void GraphicsEngine::ReleaseRetiredPipelines() {
+	auto finished = [](const RetiredPipeline& retired) {
+		return retired.masterEnd.IsReady() && retired.computeEnd.IsReady() && retired.copyEnd.IsReady();
+	};
+	m_retiredPipelines.erase(std::remove_if(m_retiredPipelines.begin(), m_retiredPipelines.end(), finished), m_retiredPipelines.end());
 }
 
 
 void GraphicsEngine::SetShaderDirectories(const std::vector<std::filesystem::path>& directories) {
+	WaitForRender();
 	m_shaderManager.ClearSourceDirectories();
+	m_shaderWatcher.ClearDirectories();
 	for (auto directory : directories) {
 		m_shaderManager.AddSourceDirectory(directory);
+		if (m_shaderHotReload) {
+			m_shaderWatcher.AddDirectory(directory);
+		}
+	}
+}
+
+
+void GraphicsEngine::SetShaderHotReload(bool enabled) {
+	m_shaderHotReload = enabled;
+	m_shaderWatcher.ClearDirectories();
+	if (enabled) {
+		auto [first, last] = m_shaderManager.GetSourceDirectories();
+		for (auto it = first; it != last; ++it) {
+			m_shaderWatcher.AddDirectory(*it);
+		}
+	}
+}
+
+
+void GraphicsEngine::PrecompileShaders(const std::filesystem::path& warmupList) {
+	m_shaderManager.Precompile(m_scheduler.GetJobScheduler(), ShaderManager::LoadShaderRequests(warmupList));
+	m_shaderManager.WaitPrecompile();
+}
+
+
+void GraphicsEngine::ReloadChangedShaders() {
+	m_lastShaderPoll = std::chrono::steady_clock::now();
+	if (m_shaderWatcher.Poll().empty()) {
+		return;
+	}
+
+	// Edits to files no shader includes, and edits that change nothing, leave the pipeline alone.
+	std::vector<ShaderRequest> requests = m_shaderManager.GetShaderRequests();
+	if (m_shaderManager.ReloadShaders() == 0 || m_pipelineDescription.empty()) {
+		return;
+	}
+
+	// The dropped shaders are compiled here, so that errors don't take down the new pipeline.
+	// The old pipeline holds its own copy of the binaries and keeps running meanwhile.
+	try {
+		for (const auto& request : requests) {
+			m_shaderManager.CreateShader(request.name, request.parts, request.macros);
+		}
+	}
+	catch (Exception& ex) {
+		m_logStreamGeneral.Event(LogEvent(std::string("Edited shader does not compile: ") + ex.what(), eEventType::WARNING));
+		return;
+	}
+
+	LoadPipelineAsync(m_pipelineDescription);
+}
+
+
+void GraphicsEngine::ReportTransientMemory() {
+	auto stats = m_scheduler.GetTransientStatistics();
+	if (stats.requestedBytes == m_reportedTransientStats.requestedBytes && stats.allocatedBytes == m_reportedTransientStats.allocatedBytes) {
+		return;
 	}
+	m_reportedTransientStats = stats;
+
+	constexpr double MB = 1024.0 * 1024.0;
+	static const LogFormat format("Transient textures: {} requests ({} MB) share {} textures ({} MB).");
+	INL_LOG(m_logStreamPipeline, eLogLevel::DEBUG, format, stats.requestCount, stats.requestedBytes / MB, stats.textureCount, stats.allocatedBytes / MB);
 }
 
 
 void GraphicsEngine::FlushPipelineQueue() {
+	SyncPoint lastCopySync = m_copyCommandQueue.Signal();
+	SyncPoint lastComputeSync = m_computeCommandQueue.Signal();
 	SyncPoint lastSync = m_masterCommandQueue.Signal();
+	lastCopySync.Wait();
+	lastComputeSync.Wait();
 	lastSync.Wait();
 }
 
@@ -427,30 +970,81 @@ std::vector<GraphicsNode*> GraphicsEngine::SelectSpecialNodes(Pipeline& pipeline
 		else if (nodes::GetEnvVariable* ptr = dynamic_cast<nodes::GetEnvVariable*>(&node)) {
 			specialNodes.push_back(ptr);
 		}
+		else if (nodes::GetRenderSize* ptr = dynamic_cast<nodes::GetRenderSize*>(&node)) {
+			specialNodes.push_back(ptr);
+		}
 	}
 
 	return specialNodes;
 }
 
 
-void GraphicsEngine::UpdateSpecialNodes() {
-	std::vector<const Scene*> scenes;
-	for (auto scene : m_scenes) {
-		scenes.push_back(scene);
+size_t GraphicsEngine::WaitForFrameSlot() {
+	auto waitBegin = std::chrono::steady_clock::now();
+	auto measure = [this](InFlightFrame& frame, std::chrono::steady_clock::time_point finished) {
+		if (frame.frame >= m_framePacing.latencyFrame) {
+			m_framePacing.latency = std::chrono::duration<double, std::milli>(finished - frame.begin).count();
+			m_framePacing.latencyFrame = frame.frame;
+		}
+		frame.measured = true;
+	};
+
+	// Frames finished since the last update.
+	for (auto& frame : m_framesInFlight) {
+		if (!frame.measured && frame.end.IsReady()) {
+			measure(frame, waitBegin);
+		}
 	}
 
-	std::vector<const BasicCamera*> cameras;
-	for (auto camera : m_cameras) {
-		cameras.push_back(camera);
+	// The oldest frame in flight must finish before its slot is reused.
+	size_t slot = size_t(m_frame % m_framesInFlight.size());
+	InFlightFrame& oldest = m_framesInFlight[slot];
+	if (!oldest.measured) {
+		INL_PROFILE_SCOPE("Wait for frames in flight");
+		oldest.end.Wait();
+		measure(oldest, std::chrono::steady_clock::now());
+	}
+
+	// Blocks only if the swap chain is waitable; waiting here instead of in Present keeps the frame's input fresh.
+	{
+		INL_PROFILE_SCOPE("Wait for swap chain");
+		m_swapChain->WaitForFrameLatency();
 	}
 
-	std::vector<const Camera2D*> cameras2d;
-	for (auto camera : m_cameras2d) {
-		cameras2d.push_back(camera);
+	m_framePacing.waitTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitBegin).count();
+	return slot;
+}
+
+
+void GraphicsEngine::UpdateDisabledNodes() {
+	if (m_renderEnvVariables.GetVersion() == m_nodeSwitchVersion) {
+		return; // No variable has been set since.
+	}
+	m_nodeSwitchVersion = m_renderEnvVariables.GetVersion();
+
+	std::vector<const NodeBase*> disabledNodes;
+	for (const auto& [node, variable] : m_nodeSwitches) {
+		const bool* enabled = m_renderEnvVariables.GetIf<bool>(variable);
+		if (enabled && !*enabled) {
+			disabledNodes.push_back(node);
+		}
 	}
+	if (disabledNodes != m_disabledNodes) {
+		m_disabledNodes = std::move(disabledNodes);
+		m_skippedTasks = m_disabledNodes.empty() ? std::vector<bool>{} : m_scheduler.GetPipeline().GetSkippedTasks(m_disabledNodes);
+	}
+}
+
+
+void GraphicsEngine::UpdateSpecialNodes() {
+	std::vector<const Scene*> scenes(m_preparedFrame.scenes.begin(), m_preparedFrame.scenes.end());
+	const std::vector<const BasicCamera*>& cameras = m_preparedFrame.cameras;
+	const std::vector<const Camera2D*>& cameras2d = m_preparedFrame.cameras2d;
 
 	int backBufferIndex = m_swapChain->GetCurrentBufferIndex();
 	Texture2D backBuffer = m_backBufferHeap->GetBackBuffer(backBufferIndex);
+	unsigned renderWidth = DynamicResolution::ScaleSize((unsigned)backBuffer.GetWidth(), m_dynamicResolution.GetScale());
+	unsigned renderHeight = DynamicResolution::ScaleSize(backBuffer.GetHeight(), m_dynamicResolution.GetScale());
 
 	for (auto node : m_specialNodes) {
 		if (auto* getScene = dynamic_cast<nodes::GetSceneByName*>(node)) {
@@ -468,10 +1062,36 @@ void GraphicsEngine::UpdateSpecialNodes() {
 		else if (auto* getTime = dynamic_cast<nodes::GetTime*>(node)) {
 			getTime->SetAbsoluteTime(m_absoluteTime.count() / 1e9);
 		}
-		else if (auto* getEnv = dynamic_cast<nodes::GetEnvVariable*>(node)) {
-			getEnv->SetEnvVariableList(&m_envVariables);
+		else if (auto* getRenderSize = dynamic_cast<nodes::GetRenderSize*>(node)) {
+			getRenderSize->SetRenderSize(renderWidth, renderHeight);
+		}
+	}
+}
+
+
+void GraphicsEngine::UpdateCameraJitter() {
+	if (!m_temporalJitter && !m_jitterApplied) {
+		return;
+	}
+
+	Vec2 offset = { 0.0f, 0.0f };
+	if (m_temporalJitter) {
+		// The scale is the one of the last frame, it is updated while rendering. It changes rarely,
+		// and the pipeline reads the offset from the cameras, so it only decides how far the offsets spread for a frame.
+		Texture2D backBuffer = m_backBufferHeap->GetBackBuffer(0);
+		float scale = m_dynamicResolution.GetScale();
+		unsigned renderWidth = DynamicResolution::ScaleSize((unsigned)backBuffer.GetWidth(), scale);
+		unsigned renderHeight = DynamicResolution::ScaleSize(backBuffer.GetHeight(), scale);
+		Vec2 pixelOffset = TemporalJitter::GetPixelOffset(m_frame, TemporalJitter::GetPhaseCount(scale));
+		offset = TemporalJitter::ToClipSpace(pixelOffset, renderWidth, renderHeight);
+	}
+
+	for (BasicCamera* camera : m_cameras) {
+		if (auto* perspectiveCamera = dynamic_cast<PerspectiveCamera*>(camera)) {
+			perspectiveCamera->SetJitter(offset);
 		}
 	}
+	m_jitterApplied = m_temporalJitter;
 }
 
 
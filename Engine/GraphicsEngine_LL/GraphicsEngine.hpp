@@ -6,8 +6,15 @@
 #include "CommandAllocatorPool.hpp"
 #include "CommandListPool.hpp"
 #include "ScratchSpacePool.hpp"
+#include "BindlessHeap.hpp"
+#include "DynamicResolution.hpp"
+#include "EnvVariables.hpp"
+#include "FrameCapture.hpp"
+#include "GpuProfiler.hpp"
+#include "ProfilerOverlay.hpp"
 #include "ResourceResidencyQueue.hpp"
 #include "PipelineEventDispatcher.hpp"
+#include "SceneSnapshot.hpp"
 
 #include "BackBufferManager.hpp"
 #include "MemoryManager.hpp"
@@ -24,9 +31,16 @@
 #include <BaseLibrary/Logging_All.hpp>
 
 #include <BaseLibrary/Any.hpp>
+#include <BaseLibrary/FileWatcher.hpp>
+#include <BaseLibrary/FrameProfiler.hpp>
 #include <BaseLibrary/GraphEditor/IEditorGraph.hpp>
 
+#include <condition_variable>
 #include <filesystem>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 // For the create functions, type covariance.
 #include "Scene.hpp"
@@ -72,6 +86,30 @@ struct GraphicsEngineDesc {
 	int width = 640;
 	int height = 480;
 	Logger* logger = nullptr;
+	std::string pipelineCachePath; // Compiled pipeline states are kept in this file between runs, leave empty to disable.
+	std::string shaderCacheDirectory; // Compiled shaders are kept in this directory between runs, leave empty to disable.
+	unsigned maxFramesInFlight = 0; // Frames the CPU may record ahead of the GPU, at most one per back buffer. 0 means one per back buffer.
+	unsigned maxFrameLatency = 0; // Frames queued for presentation. Not 0 makes Update wait for the swap chain before each frame.
+	eQualityPreset qualityPreset = eQualityPreset::MEDIUM; // Nodes pick the defaults of their settings from it when the pipeline is loaded.
+	DynamicResolutionDesc dynamicResolution; // Off by default.
+	bool temporalJitter = false; // Jitters the perspective cameras for temporal anti-aliasing, see <see cref="GraphicsEngine::SetTemporalJitter"/>.
+};
+
+
+struct FramePacingStatistics {
+	/// <summary> Milliseconds from the end of a frame's waits in Update until its GPU work was seen finished. </summary>
+	/// <remarks> Frames are checked at the beginning of each Update, so this may be late by up to a frame. </remarks>
+	double latency = 0.0;
+	uint64_t latencyFrame = 0; // The frame the latency was measured on.
+	double waitTime = 0.0; // Milliseconds the last Update waited for frames in flight and the swap chain.
+	unsigned framesInFlight = 0;
+	unsigned maxFrameLatency = 0; // 0 if the swap chain is not waited on.
+};
+
+
+struct MemoryStatistics {
+	ResidencyStatistics residency; // Video memory of the adapter, and the engine's resources in it.
+	TransientTexturePool::Statistics transient; // Textures shared by the nodes of the current pipeline.
 };
 
 
@@ -93,9 +131,24 @@ public:
 	/// you are not allowed to concurrently modify these objects while Update() is running.
 	/// This includes but is not limited to adding new entities to a scene and uploading
 	/// data to meshes or images.
+	/// With <see cref="SetFrameOverlap"/> on, Update copies the scenes, entities, cameras and env variables,
+	/// and returns while the frame renders from the copies. The game may change and delete these
+	/// until the next Update, which waits for the frame first. Meshes, images, materials and fonts are not copied,
+	/// they still must not change before the frame finishes, see <see cref="WaitForRender"/>.
 	/// </remarks>
 	void Update(float elapsed) override;
 
+	/// <summary> Renders each frame on a thread of its own, overlapping the game's next update. Off by default. </summary>
+	/// <remarks> Costs a copy of the entities each frame, and the frames are a frame behind the game.
+	///		The LOD and skinned vertices the pipeline writes go to the copies, not to the game's entities. Waits for the frame being rendered. </remarks>
+	void SetFrameOverlap(bool enabled);
+	bool GetFrameOverlap() const { return m_frameOverlap; }
+
+	/// <summary> Waits until the frame started by the last <see cref="Update"/> is recorded and presented. </summary>
+	/// <remarks> Rethrows what rendering the frame threw. Engine calls that change or query the renderer,
+	///		like the pipeline, screen and profiling ones, wait by themselves. </remarks>
+	void WaitForRender() const;
+
 	/// <summary> Rescales the backbuffer. </summary>
 	/// <remarks> Causes a pipeline flush, high overhead. </remarks>
 	void SetScreenSize(unsigned width, unsigned height) override;
@@ -112,6 +165,8 @@ public:
 
 
 	// Graph editor interfaces
+	/// <remarks> The editor graph reads the costs of the nodes from the running pipeline,
+	///		it must not outlive the engine. </remarks>
 	IEditorGraph* QueryPipelineEditor() const override;
 	IEditorGraph* QueryMaterialEditor() const override;
 
@@ -140,7 +195,10 @@ public:
 	/// <returns> True if a new variable was created, false if old was overridden. </returns>
 	/// <remarks> Environment variables can be accessed in the graphics pipeline graph by the special
 	///		<see cref="nodes::GetEnvVariable"/> node. You can use it to slightly 
-	///		alter pipeline behavriour from outside. </remarks>
+	///		alter pipeline behavriour from outside.
+	///		Setting "name.enabled" to false, where name is the display name of a pipeline node,
+	///		skips the node from the next frame, together with the nodes that depend on it and
+	///		the nodes that only feed skipped ones. </remarks>
 	bool SetEnvVariable(std::string name, Any obj) override;
 
 	/// <summary> Returns true if env var with given name exists. </summary>
@@ -149,21 +207,134 @@ public:
 	/// <summary> Return the env var with given name or throws <see cref="InvalidArgumentException"/>. </summary>
 	const Any& GetEnvVariable(const std::string& name) override;
 
-	/// <summary> Load the pipeline from the JSON node graph description. </summary>
-	/// <remarks> Tears down all the resources associated with the old pipeline, including
-	///		textures, render targets, etc., and builds up the new pipeline.
-	///		Also incurs a pipeline queue flush. Use it only when settings change,
+	/// <summary> The handle of the env var with given name, valid even if the variable is not set yet. </summary>
+	/// <remarks> Variables set every frame should be set through their handles, which skip the name lookup. </remarks>
+	EnvVariableHandle GetEnvVariableHandle(const std::string& name);
+	/// <summary> Sets the env var of the handle, see <see cref="SetEnvVariable(std::string, Any)"/>. </summary>
+	bool SetEnvVariable(EnvVariableHandle handle, Any obj);
+	/// <summary> Return the env var of the handle or throws <see cref="InvalidArgumentException"/> if it is not set. </summary>
+	const Any& GetEnvVariable(EnvVariableHandle handle) const;
+
+	/// <summary> Load the pipeline from the JSON node graph description, or the binary one of <see cref="Pipeline::SerializeToBinary"/>. </summary>
+	/// <remarks> Builds up the new pipeline and replaces the old one. The resources associated with
+	///		the old pipeline, including textures, render targets, etc., are released once the GPU has
+	///		finished the frames that use them. Use it only when settings change,
 	///		use env vars to control pipeline behaviour on the fly.
 	void LoadPipeline(const std::string& nodes) override;
 
+	/// <summary> Builds the pipeline on the job system while the current one keeps rendering. </summary>
+	/// <remarks> The nodes are created and initialized in a background job, while the shaders the pipeline
+	///		used before are compiled. The new pipeline replaces the current one at the beginning of
+	///		the first <see cref="Update"/> after both finished. If it fails to build, the error is logged
+	///		and the current pipeline is kept. When called again before the swap, only the last
+	///		description is loaded. </remarks>
+	void LoadPipelineAsync(const std::string& nodes) override;
+
+	/// <summary> CPU and GPU time of the node with the display name in the recent frames, oldest first. </summary>
+	/// <remarks> Empty if the current pipeline has no such node. </remarks>
+	std::vector<NodeCost> GetNodeCostHistory(const std::string& nodeName) const;
+
+	/// <summary> True while a pipeline requested by <see cref="LoadPipelineAsync"/> has not replaced the current one yet. </summary>
+	bool IsPipelineLoading() const { return m_pipelineBuild.has_value(); }
+
 	/// <summary> The engine will look for shader files in these directories. </summary>
 	/// <remarks> May be absolute, relative, or whatever paths you OS can handle. </remarks>
 	void SetShaderDirectories(const std::vector<std::filesystem::path>& directories) override;
+
+	/// <summary> Watches the shader directories, and rebuilds the pipeline between frames when a shader it uses is edited. </summary>
+	/// <remarks> Only the edited shaders are compiled again, the rest and their PSOs come from the caches.
+	///		When an edited shader does not compile, the error is logged and the pipeline is kept as it is. Off by default. </remarks>
+	void SetShaderHotReload(bool enabled);
+
+	/// <summary> Compiles the shaders of a warm-up list and waits for them. </summary>
+	/// <remarks> The engine saves the list of every shader and generated material permutation it used
+	///		into the shader cache directory on exit, and warms up the next run with it.
+	///		Call this on a loading screen, or offline with a list recorded while play-testing, to fill the shader
+	///		cache before the game starts. Pipeline states are kept by the pipeline cache once created. </remarks>
+	void PrecompileShaders(const std::filesystem::path& warmupList);
+
+	/// <summary> The job system the pipeline runs on. Work that is not part of the frame should use the background lane. </summary>
+	jobs::Scheduler& GetJobScheduler() { return m_scheduler.GetJobScheduler(); }
+
+
+	// Profiling
+
+	/// <summary> GPU time, recorded commands and pipeline statistics of each pipeline node, in the order the nodes were recorded. </summary>
+	/// <remarks> Measured a few frames ago, see <see cref="GpuProfiler"/>. Nodes recording only to the copy queue are missing. </remarks>
+	GpuFrameReport GetGpuFrameReport() const;
+
+	/// <summary> Turns per node GPU timing on or off, it is on by default. </summary>
+	void SetGpuProfiling(bool enabled);
+
+	/// <summary> Turns pipeline statistics per node and draw batch on or off, it is off by default. </summary>
+	void SetGpuStatistics(bool enabled);
+
+	/// <summary> Video memory usage as of the last <see cref="Update"/>. </summary>
+	MemoryStatistics GetMemoryStatistics() const;
+
+	/// <summary> When each step of the engine's construction ran, and on which thread. </summary>
+	/// <remarks> Can be exported with <see cref="FrameProfiler::ExportChromeTrace"/>, the report is logged to the general stream. </remarks>
+	const ProfiledFrame& GetStartupTimeline() const { return m_startupTimeline; }
+
+	/// <summary> Shows the last frame's CPU zones and GPU node times as text in the scene, replacing the previous overlay. </summary>
+	/// <remarks> CPU zones are collected by <see cref="FrameProfiler::GetGlobal"/>. The scene must outlive the overlay.
+	///		The text is drawn by the RenderOverlay node that renders the scene. </remarks>
+	void ShowProfilerOverlay(Scene* scene, const Font* font, Vec2 topLeft, Vec2 lineSize);
+	void HideProfilerOverlay();
+
+	/// <summary> Records the scenes, cameras, env variables and pipeline that the next <see cref="Update"/> renders. </summary>
+	/// <remarks> Call it right after a slow frame to capture its inputs for a replay, the elapsed time is that of the last update.
+	///		See <see cref="FrameCapture"/> for what is left out. </remarks>
+	FrameCapture CaptureFrame(const FrameCaptureNaming& naming = {}) const;
+
+
+	// Frame pacing
+
+	/// <summary> Sets how many frames the CPU may record ahead of the GPU. Clamped to [1, back buffer count], 0 means the back buffer count. </summary>
+	/// <remarks> Waits for the frames in flight. Fewer frames lower latency at the cost of less CPU and GPU overlap. </remarks>
+	void SetMaxFramesInFlight(unsigned count);
+	/// <summary> Latency and waiting of the recent frames, suitable for logging every frame. </summary>
+	FramePacingStatistics GetFramePacing() const;
+
+	/// <summary> Scales the render resolution to keep the GPU time of the frames within a budget. </summary>
+	/// <remarks> The time comes from the GPU profiler, the scale is kept while profiling is off.
+	///		Only pipelines that size their targets by <see cref="nodes::GetRenderSize"/> and upscale
+	///		to the back buffer are affected. </remarks>
+	void SetDynamicResolution(const DynamicResolutionDesc& desc);
+	/// <summary> The scale of the render resolution of the current frame, 1 if dynamic resolution is off. </summary>
+	float GetRenderScale() const { return m_dynamicResolution.GetScale(); }
+
+	/// <summary> Shifts the projection of the perspective cameras by a sub-pixel offset every frame. Off by default. </summary>
+	/// <remarks> Pipelines with temporal anti-aliasing need it, without it the jitter shows as shaking.
+	///		The offset is set on the game's cameras, their projection matrix includes it while on.
+	///		More offsets are cycled through at lower render scales, so upscaling covers all output pixels. </remarks>
+	void SetTemporalJitter(bool enabled);
+	bool GetTemporalJitter() const { return m_temporalJitter; }
 private:
+	/// <summary> Fixes the scenes, env variables and uploads the next frame reads. </summary>
+	void PrepareFrame();
+	/// <summary> Records and presents the prepared frame, on the render thread if frames overlap. </summary>
+	void RenderFrame(std::chrono::nanoseconds frameTime);
+	void RenderThread();
 	void FlushPipelineQueue();
+	void StartPipelineBuild(const std::string& graphDesc);
+	/// <summary> Replaces the current pipeline with the one being built, waits for it if it's not ready. </summary>
+	/// <exception> Rethrows what building the pipeline threw, the current pipeline is kept then. </exception>
+	void InstallPipelineBuild();
+	/// <summary> Swaps in the pipeline built in the background if it and the shaders it needs are ready. </summary>
+	void SwapBuiltPipeline();
+	void ReleaseRetiredPipelines();
+	static std::shared_ptr<Pipeline> BuildPipeline(const std::string& graphDesc, eQualityPreset qualityPreset);
+	void ReportTransientMemory();
 	void RegisterPipelineClasses();
 	static std::vector<GraphicsNode*> SelectSpecialNodes(Pipeline& pipeline);
 	void UpdateSpecialNodes();
+	/// <summary> Sets the jitter of the frame on the perspective cameras, or clears it once after it's turned off. </summary>
+	void UpdateCameraJitter();
+	/// <summary> Finds the nodes disabled by env vars, and the tasks to skip because of them. </summary>
+	void UpdateDisabledNodes();
+	void ReloadChangedShaders();
+	size_t WaitForFrameSlot();
 	static void DumpPipelineGraph(const Pipeline& pipeline, std::string file);
 private:
 	// Graphics API things
@@ -181,36 +352,101 @@ private:
 	// Pipeline Facilities
 	CommandAllocatorPool m_commandAllocatorPool;
 	CommandListPool m_commandListPool;
+	std::unique_ptr<BindlessHeap> m_bindlessHeap; // Null if the device can't index descriptor tables.
 	ScratchSpacePool m_scratchSpacePool; // Creates CBV_SRV_UAV type scratch spaces
 	CbvSrvUavHeap m_textureSpace;
-	Pipeline m_pipeline;
 	Scheduler m_scheduler;
+	struct PipelineBuild {
+		jobs::Future<std::shared_ptr<Pipeline>> result;
+		std::string description;
+		std::chrono::steady_clock::time_point begin;
+	};
+	std::optional<PipelineBuild> m_pipelineBuild;
+	std::optional<std::string> m_queuedPipelineDescription; // Requested while another one was being built.
+	struct RetiredPipeline {
+		std::shared_ptr<Pipeline> pipeline;
+		// The last frames that used the pipeline on each queue.
+		SyncPoint masterEnd;
+		SyncPoint computeEnd;
+		SyncPoint copyEnd;
+	};
+	std::vector<RetiredPipeline> m_retiredPipelines;
 	ShaderManager m_shaderManager;
-	std::vector<SyncPoint> m_frameEndFenceValues;
+	std::vector<ShaderRequest> m_startupShaderWarmup; // Loaded while starting up, for the first pipeline build.
+	struct InFlightFrame {
+		SyncPoint end;
+		uint64_t frame = 0;
+		std::chrono::steady_clock::time_point begin;
+		bool measured = true; // Latency is recorded, or there was no frame.
+	};
+	std::vector<InFlightFrame> m_framesInFlight; // Indexed by frame number modulo the count.
+	FramePacingStatistics m_framePacing;
+	DynamicResolution m_dynamicResolution;
+	bool m_temporalJitter = false;
+	bool m_jitterApplied = false; // The cameras may be jittered.
 	std::vector<std::shared_ptr<GraphicsNode>> m_graphicsNodes;
 	std::vector<GraphicsNode*> m_specialNodes;
+	std::vector<std::pair<const NodeBase*, EnvVariableHandle>> m_nodeSwitches; // Named nodes and the env var that enables them.
+	uint64_t m_nodeSwitchVersion = 0; // Version of the env vars when the switches were last read.
+	std::vector<const NodeBase*> m_disabledNodes;
+	std::vector<bool> m_skippedTasks; // Follows m_disabledNodes, empty if none.
 
 	// Pipeline elements
 	CommandQueue m_masterCommandQueue;
+	CommandQueue m_computeCommandQueue; // Async compute, overlaps the master queue.
+	CommandQueue m_copyCommandQueue; // Uploads, overlaps the master queue.
 	ResourceResidencyQueue m_residencyQueue;
+	std::unique_ptr<GpuProfiler> m_gpuProfiler;
+	std::unique_ptr<ProfilerOverlay> m_profilerOverlay;
 	PipelineEventDispatcher m_pipelineEventDispatcher;
+	LinearArena m_frameArena;
 
 	// Logging
 	Logger* m_logger;
 	LogStream m_logStreamGeneral;
 	LogStream m_logStreamPipeline;
+	TransientTexturePool::Statistics m_reportedTransientStats;
 
 	// Misc
 	std::chrono::nanoseconds m_absoluteTime;
+	float m_lastElapsed = 0.0f;
+	ProfiledFrame m_startupTimeline;
 	uint64_t m_frame = 0;
+	std::string m_pipelineDescription;
+	eQualityPreset m_qualityPreset;
+
+	// Hot reload
+	bool m_shaderHotReload = false;
+	FileWatcher m_shaderWatcher;
+	std::chrono::steady_clock::time_point m_lastShaderPoll;
 
 	// Env variables
-	std::unordered_map<std::string, Any> m_envVariables;
+	EnvVariables m_envVariables;
+	EnvVariables m_renderEnvVariables; // Copied between frames, read by the pipeline.
 
 	// Scene
 	std::set<Scene*> m_scenes;
 	std::set<BasicCamera*> m_cameras;
 	std::set<Camera2D*> m_cameras2d;
+
+	// Frame overlap
+	bool m_frameOverlap = false;
+	mutable std::future<void> m_renderTask; // Invalid unless a frame is rendering on its own thread.
+	std::thread m_renderThread; // Started when frames first overlap, kept so that thread local caches stay.
+	std::mutex m_renderMutex;
+	std::condition_variable m_renderSignal;
+	std::packaged_task<void()> m_renderJob;
+	bool m_renderThreadStop = false;
+	SceneSnapshot m_snapshot; // Empty unless frames overlap.
+	struct PreparedFrame {
+		std::vector<Scene*> scenes; // The originals, or the snapshot's copies.
+		std::vector<const BasicCamera*> cameras;
+		std::vector<const Camera2D*> cameras2d;
+		const std::vector<UploadManager::UploadDescription>* uploads = nullptr;
+		const std::vector<UploadManager::MipGenerationDescription>* mipGenerations = nullptr;
+		const std::vector<UploadManager::PrefilterDescription>* prefilters = nullptr;
+	};
+	PreparedFrame m_preparedFrame;
 };
 
 
@@ -151,6 +151,18 @@ std::vector<std::pair<gxapi::eBlendLogicOperation, std::string>> impl::ParseTabl
 }
 
 
+template <>
+std::vector<std::pair<gxeng::eResolutionScale, std::string>> impl::ParseTableGenerator() {
+	std::vector<std::pair<gxeng::eResolutionScale, std::string>> records = {
+		{ gxeng::eResolutionScale::DEFAULT, "DEFAULT" },
+		{ gxeng::eResolutionScale::FULL, "FULL" },
+		{ gxeng::eResolutionScale::HALF, "HALF" },
+		{ gxeng::eResolutionScale::QUARTER, "QUARTER" },
+	};
+	return records;
+}
+
+
 
 
 std::string PortConverter<gxapi::RenderTargetBlendState>::ToString(const gxapi::RenderTargetBlendState& arg) const {
@@ -120,6 +120,9 @@ namespace impl {
 
 	template <>
 	std::vector<std::pair<gxapi::eBlendLogicOperation, std::string>> ParseTableGenerator();
+
+	template <>
+	std::vector<std::pair<gxeng::eResolutionScale, std::string>> ParseTableGenerator();
 	
 }
 
@@ -142,6 +145,24 @@ public:
 
 
 
+// eResolutionScale
+template <>
+class PortConverter<gxeng::eResolutionScale> : public PortConverterCollection<gxeng::eResolutionScale> {
+public:
+	PortConverter() :
+		PortConverterCollection<gxeng::eResolutionScale>(&FromString) {}
+
+	std::string ToString(const gxeng::eResolutionScale& scale) const override {
+		return EnumConverter<gxeng::eResolutionScale, &impl::ParseTableGenerator<gxeng::eResolutionScale>>::ToString(scale);
+	}
+
+	static gxeng::eResolutionScale FromString(const std::string& str) {
+		return EnumConverter<gxeng::eResolutionScale, &impl::ParseTableGenerator<gxeng::eResolutionScale>>::FromString(str);
+	}
+};
+
+
+
 // RenderTargetBlendState
 template <>
 class PortConverter<gxapi::RenderTargetBlendState> : public PortConverterCollection<gxapi::RenderTargetBlendState> {
@@ -183,5 +204,19 @@ protected:
 };
 
 
+// Scene -> MeshEntityIndex
+template <>
+class PortConverter<const gxeng::MeshEntityIndex*> : public PortConverterCollection<const gxeng::MeshEntityIndex*> {
+public:
+	PortConverter() :
+		PortConverterCollection<const gxeng::MeshEntityIndex*>(&FromScene) {}
+
+protected:
+	static const gxeng::MeshEntityIndex* FromScene(const gxeng::Scene* scene) {
+		return &scene->GetMeshEntityIndex();
+	}
+};
+
+
 
 } // namespace inl
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "HeapSuballocator.hpp"
+
+#include <GraphicsApi_LL/IResource.hpp>
+
+#include <new>
+
+
+namespace inl::gxeng::impl {
+
+
+PlacedResourcePool::PlacedResourcePool(gxapi::IGraphicsApi* graphicsApi, gxapi::eHeapFlags flags, uint64_t heapSize)
+	: m_graphicsApi(graphicsApi),
+	  m_flags(flags),
+	  m_heapSize(heapSize) {}
+
+
+MemoryObject::UniquePtr PlacedResourcePool::Create(const gxapi::ResourceDesc& desc, gxapi::eResourceState initialState, gxapi::ClearValue* clearValue) {
+	gxapi::ResourceAllocationInfo info = m_graphicsApi->GetAllocationInfo(desc);
+	if (info.size > m_heapSize / MaxResourceFraction) {
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lkg(m_mtx);
+
+	for (const auto& heap : m_heaps) {
+		std::unique_lock<std::mutex> heapLock(heap->mtx);
+		try {
+			TlsfAllocationEngine::Allocation allocation = heap->allocator.Allocate(info.size, info.alignment);
+			heapLock.unlock();
+			return Place(heap, allocation, desc, initialState, clearValue);
+		}
+		catch (std::bad_alloc&) {
+			// Try the next heap.
+		}
+	}
+
+	gxapi::HeapDesc heapDesc{ m_heapSize, gxapi::HeapProperties(gxapi::eHeapType::DEFAULT), m_flags };
+	auto heap = std::make_shared<Heap>(std::unique_ptr<gxapi::IHeap>(m_graphicsApi->CreateHeap(heapDesc)), m_heapSize);
+	m_heaps.push_back(heap);
+
+	TlsfAllocationEngine::Allocation allocation;
+	{
+		std::lock_guard<std::mutex> heapLock(heap->mtx);
+		allocation = heap->allocator.Allocate(info.size, info.alignment);
+	}
+	return Place(heap, allocation, desc, initialState, clearValue);
+}
+
+
+size_t PlacedResourcePool::GetHeapCount() const {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	return m_heaps.size();
+}
+
+
+MemoryObject::UniquePtr PlacedResourcePool::Place(const std::shared_ptr<Heap>& heap,
+												  TlsfAllocationEngine::Allocation allocation,
+												  const gxapi::ResourceDesc& desc,
+												  gxapi::eResourceState initialState,
+												  gxapi::ClearValue* clearValue) {
+	auto release = [heap, allocation] {
+		std::lock_guard<std::mutex> heapLock(heap->mtx);
+		heap->allocator.Deallocate(allocation);
+	};
+
+	gxapi::IResource* resource;
+	try {
+		resource = m_graphicsApi->CreatePlacedResource(heap->heap.get(), allocation.offset, desc, initialState, clearValue);
+	}
+	catch (...) {
+		release();
+		throw;
+	}
+
+	// The heap lives as long as the resources placed in it.
+	return MemoryObject::UniquePtr{ resource, [release](const gxapi::IResource* resource) {
+		delete resource;
+		release();
+	} };
+}
+
+
+
+BufferSuballocator::BufferSuballocator(gxapi::IGraphicsApi* graphicsApi, uint64_t blockSize)
+	: m_graphicsApi(graphicsApi),
+	  m_blockSize(blockSize) {}
+
+
+std::optional<BufferSuballocator::Range> BufferSuballocator::Allocate(uint64_t size) {
+	if (size > m_blockSize / MaxRangeFraction) {
+		return {};
+	}
+
+	std::lock_guard<std::mutex> lkg(m_mtx);
+
+	for (const auto& block : m_blocks) {
+		std::lock_guard<std::mutex> blockLock(block->mtx);
+		try {
+			return MakeRange(block, block->allocator.Allocate(size));
+		}
+		catch (std::bad_alloc&) {
+			// Try the next block.
+		}
+	}
+
+	MemoryObject::UniquePtr resource{
+		m_graphicsApi->CreateCommittedResource(gxapi::HeapProperties(gxapi::eHeapType::DEFAULT),
+											   gxapi::eHeapFlags::NONE,
+											   gxapi::ResourceDesc::Buffer(m_blockSize),
+											   gxapi::eResourceState::COMMON),
+		std::default_delete<const gxapi::IResource>()
+	};
+	MemoryObject buffer(std::move(resource), true, eResourceHeap::CRITICAL);
+	buffer.SetName("Suballocated buffers");
+	auto block = std::make_shared<Block>(std::move(buffer), m_blockSize);
+	m_blocks.push_back(block);
+
+	std::lock_guard<std::mutex> blockLock(block->mtx);
+	return MakeRange(block, block->allocator.Allocate(size));
+}
+
+
+size_t BufferSuballocator::GetBlockCount() const {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	return m_blocks.size();
+}
+
+
+BufferSuballocator::Range BufferSuballocator::MakeRange(const std::shared_ptr<Block>& block, TlsfAllocationEngine::Allocation allocation) {
+	auto release = [block, allocation] {
+		std::lock_guard<std::mutex> blockLock(block->mtx);
+		block->allocator.Deallocate(allocation);
+	};
+	return Range{ block->buffer, allocation.offset, std::move(release) };
+}
+
+
+} // namespace inl::gxeng::impl
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "MemoryObject.hpp"
+
+#include <BaseLibrary/Memory/TlsfAllocationEngine.hpp>
+#include <GraphicsApi_LL/IGraphicsApi.hpp>
+#include <GraphicsApi_LL/IHeap.hpp>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+
+namespace inl::gxeng::impl {
+
+
+/// <summary>
+/// Places resources of one memory class in large GPU-only heaps instead of giving each of them its own.
+/// A new heap is created when none of the existing ones has room.
+/// </summary>
+/// <remarks> Placed resources are not pageable on their own, the heaps always stay resident.
+///		Heaps are kept when they become empty, to be reused by later allocations. Thread safe. </remarks>
+class PlacedResourcePool {
+public:
+	static constexpr uint64_t DefaultHeapSize = 64ull << 20;
+	/// <summary> Resources larger than this fraction of a heap are better off committed. </summary>
+	static constexpr uint64_t MaxResourceFraction = 8;
+
+public:
+	/// <param name="flags"> Selects the memory class, like <see cref="gxapi::eHeapFlags::ALLOW_ONLY_BUFFERS"/>. </param>
+	PlacedResourcePool(gxapi::IGraphicsApi* graphicsApi, gxapi::eHeapFlags flags, uint64_t heapSize = DefaultHeapSize);
+
+	/// <summary> Places a resource in one of the heaps. The resource gives its range back when deleted. </summary>
+	/// <returns> Null if the resource is too large to share a heap. </returns>
+	MemoryObject::UniquePtr Create(const gxapi::ResourceDesc& desc, gxapi::eResourceState initialState, gxapi::ClearValue* clearValue = nullptr);
+
+	size_t GetHeapCount() const;
+
+private:
+	struct Heap {
+		Heap(std::unique_ptr<gxapi::IHeap> heap, uint64_t size) : heap(std::move(heap)), allocator(size, DefaultAlignment) {}
+		std::mutex mtx;
+		std::unique_ptr<gxapi::IHeap> heap;
+		TlsfAllocationEngine allocator;
+	};
+	static constexpr uint64_t DefaultAlignment = 64 * 1024;
+
+	MemoryObject::UniquePtr Place(const std::shared_ptr<Heap>& heap,
+								  TlsfAllocationEngine::Allocation allocation,
+								  const gxapi::ResourceDesc& desc,
+								  gxapi::eResourceState initialState,
+								  gxapi::ClearValue* clearValue);
+
+private:
+	gxapi::IGraphicsApi* m_graphicsApi;
+	gxapi::eHeapFlags m_flags;
+	uint64_t m_heapSize;
+
+	mutable std::mutex m_mtx;
+	std::vector<std::shared_ptr<Heap>> m_heaps; // Shared with the resources placed in them.
+};
+
+
+/// <summary>
+/// Hands out ranges of large shared buffers, so that small buffers do not each take a 64 KiB aligned allocation.
+/// </summary>
+/// <remarks> Ranges of a buffer share its resource states, so all of them should be used the same way,
+///		like vertex buffers or index buffers only. Thread safe. </remarks>
+class BufferSuballocator {
+public:
+	static constexpr uint64_t DefaultBlockSize = 16ull << 20;
+	/// <summary> Larger buffers are better off on their own. </summary>
+	static constexpr uint64_t MaxRangeFraction = 16;
+	static constexpr uint64_t Alignment = 256;
+
+	struct Range {
+		MemoryObject buffer;
+		uint64_t offset;
+		std::function<void()> release; // Gives the range back.
+	};
+
+public:
+	BufferSuballocator(gxapi::IGraphicsApi* graphicsApi, uint64_t blockSize = DefaultBlockSize);
+
+	/// <summary> Reserves a range in one of the shared buffers, a new buffer is created if none has room. </summary>
+	/// <returns> Empty if the size is too large to share a buffer. </returns>
+	std::optional<Range> Allocate(uint64_t size);
+
+	size_t GetBlockCount() const;
+
+private:
+	struct Block {
+		Block(MemoryObject buffer, uint64_t size) : buffer(std::move(buffer)), allocator(size, Alignment) {}
+		std::mutex mtx;
+		MemoryObject buffer;
+		TlsfAllocationEngine allocator;
+	};
+
+	static Range MakeRange(const std::shared_ptr<Block>& block, TlsfAllocationEngine::Allocation allocation);
+
+private:
+	gxapi::IGraphicsApi* m_graphicsApi;
+	uint64_t m_blockSize;
+
+	mutable std::mutex m_mtx;
+	std::vector<std::shared_ptr<Block>> m_blocks;
+};
+
+
+} // namespace inl::gxeng::impl
@@ -3,12 +3,15 @@
 #include "../GraphicsApi_LL/IGraphicsApi.hpp"
 #include "../GraphicsApi_LL/Exception.hpp"
 #include "../GraphicsApi_LL/IDescriptorHeap.hpp"
-#include "../BaseLibrary/Memory/SlabAllocatorEngine.hpp"
+#include "../BaseLibrary/Memory/ConcurrentSlabAllocatorEngine.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <vector>
 #include <mutex>
 #include <functional>
 #include <cassert>
+#include <thread>
 
 namespace inl {
 namespace gxeng {
@@ -19,7 +22,11 @@ class MemoryObject;
 class IHostDescHeap {
 public:
 	virtual size_t Allocate() = 0;
+	/// <summary> Allocates <paramref name="count"/> descriptors at once, writing their places to <paramref name="positions"/>. </summary>
+	/// <remarks> The places are not consecutive, use them one by one with <see cref="At"/>. </remarks>
+	virtual void AllocateRange(size_t count, size_t* positions) = 0;
 	virtual void Deallocate(size_t pos) = 0;
+	virtual void DeallocateRange(size_t count, const size_t* positions) = 0;
 	virtual gxapi::DescriptorHandle At(size_t pos) = 0;
 };
 
@@ -35,63 +42,156 @@ public:
 /// This object can only represent non-shader visible heaps
 /// due to the fact, that growing is implemented by creating
 /// a new descriptor heap (but only one shader visible heap can be bound at a time).
+/// <para />
+/// Each thread keeps a few free places of its own, so that creating
+/// views one by one does not contend on the shared allocator.
 /// </summary>
 template <gxapi::eDescriptorHeapType HeapType>
 class HostDescHeap : public IHostDescHeap {
 	static constexpr size_t chunkDim = 64;
+	static constexpr size_t threadCacheRefill = 16; // Places a thread takes from the shared allocator at once.
 	struct ChunkListItem {
 		std::unique_ptr<gxapi::IDescriptorHeap> heaps[chunkDim];
 		std::unique_ptr<ChunkListItem> next;
 	};
+	struct ThreadCache {
+		std::thread::id owner;
+		std::vector<size_t> places;
+	};
+	struct ThreadCacheRef {
+		uint64_t heapId = 0;
+		ThreadCache* cache = nullptr;
+	};
 
 public:
 	HostDescHeap(gxapi::IGraphicsApi* graphicsApi, size_t heapSize);
 
 	size_t Allocate() override;
+	void AllocateRange(size_t count, size_t* positions) override;
 	void Deallocate(size_t pos) override;
+	void DeallocateRange(size_t count, const size_t* positions) override;
 	gxapi::DescriptorHandle At(size_t pos) override;
+
+	/// <summary> Copies the source descriptors to the places with a single call to the API. </summary>
+	void Copy(size_t count, const gxapi::DescriptorHandle* sources, const size_t* positions);
 private:
+	void AllocateShared(size_t count, size_t* positions);
+	ThreadCache& GetThreadCache();
 	void Grow();
 
 protected:
 	gxapi::IGraphicsApi* const m_graphicsApi;
 private:
+	inline static thread_local ThreadCacheRef threadCache;
+	inline static std::atomic_uint64_t nextHeapId = 1;
+
 	std::mutex m_listMutex;
 	std::unique_ptr<ChunkListItem> m_first;
 	size_t m_descriptorCount;
 
-	std::mutex m_allocMutex;
-	SlabAllocatorEngine m_allocEngine;
+	ConcurrentSlabAllocatorEngine m_allocEngine;
+	std::vector<std::unique_ptr<ThreadCache>> m_threadCaches; // Guarded by the list mutex.
 
 	const size_t heapDim;
+	const uint64_t m_id; // Tells apart the thread caches of different heaps.
 };
 
 
 template <gxapi::eDescriptorHeapType HeapType>
 HostDescHeap<HeapType>::HostDescHeap(gxapi::IGraphicsApi* graphicsApi, size_t heapSize)
 	: m_graphicsApi(graphicsApi),
+	m_descriptorCount(0),
 	heapDim(heapSize),
-	m_allocEngine(0),
-	m_descriptorCount(0)
+	m_id(nextHeapId++)
 {}
 
 template <gxapi::eDescriptorHeapType HeapType>
 size_t HostDescHeap<HeapType>::Allocate() {
-	try {
-		std::lock_guard<std::mutex> lkg(m_allocMutex);
-		return m_allocEngine.Allocate();
+	ThreadCache& cache = GetThreadCache();
+	if (cache.places.empty()) {
+		cache.places.resize(threadCacheRefill);
+		AllocateShared(threadCacheRefill, cache.places.data());
 	}
-	catch (std::bad_alloc&) {
+	size_t pos = cache.places.back();
+	cache.places.pop_back();
+	return pos;
+}
+
+template <gxapi::eDescriptorHeapType HeapType>
+void HostDescHeap<HeapType>::AllocateRange(size_t count, size_t* positions) {
+	ThreadCache& cache = GetThreadCache();
+	size_t fromCache = std::min(count, cache.places.size());
+	std::copy(cache.places.end() - fromCache, cache.places.end(), positions);
+	cache.places.resize(cache.places.size() - fromCache);
+
+	AllocateShared(count - fromCache, positions + fromCache);
+}
+
+template <gxapi::eDescriptorHeapType HeapType>
+void HostDescHeap<HeapType>::Deallocate(size_t pos) {
+	DeallocateRange(1, &pos);
+}
+
+template <gxapi::eDescriptorHeapType HeapType>
+void HostDescHeap<HeapType>::DeallocateRange(size_t count, const size_t* positions) {
+	ThreadCache& cache = GetThreadCache();
+	size_t toCache = std::min(count, 2 * threadCacheRefill - std::min(cache.places.size(), 2 * threadCacheRefill));
+	cache.places.insert(cache.places.end(), positions, positions + toCache);
+	for (size_t i = toCache; i < count; ++i) {
+		m_allocEngine.Deallocate(positions[i]);
+	}
+}
+
+template <gxapi::eDescriptorHeapType HeapType>
+void HostDescHeap<HeapType>::AllocateShared(size_t count, size_t* positions) {
+	size_t numAllocated = m_allocEngine.TryAllocate(positions, count);
+	while (numAllocated < count) {
 		std::lock_guard<std::mutex> lkg(m_listMutex);
-		Grow();
-		return m_allocEngine.Allocate();
+		// Another thread might have grown the heap while we were waiting for the lock.
+		numAllocated += m_allocEngine.TryAllocate(positions + numAllocated, count - numAllocated);
+		if (numAllocated < count) {
+			Grow();
+		}
 	}
 }
 
 template <gxapi::eDescriptorHeapType HeapType>
-void HostDescHeap<HeapType>::Deallocate(size_t pos) {
-	std::lock_guard<std::mutex> lkg(m_allocMutex);
-	m_allocEngine.Deallocate(pos);
+auto HostDescHeap<HeapType>::GetThreadCache() -> ThreadCache& {
+	if (threadCache.heapId == m_id) {
+		return *threadCache.cache;
+	}
+
+	std::lock_guard<std::mutex> lkg(m_listMutex);
+	auto id = std::this_thread::get_id();
+	auto it = std::find_if(m_threadCaches.begin(), m_threadCaches.end(), [id](const auto& cache) { return cache->owner == id; });
+	if (it == m_threadCaches.end()) {
+		auto cache = std::make_unique<ThreadCache>();
+		cache->owner = id;
+		cache->places.reserve(2 * threadCacheRefill);
+		m_threadCaches.push_back(std::move(cache));
+		it = m_threadCaches.end() - 1;
+	}
+	threadCache = { m_id, it->get() };
+	return **it;
+}
+
+template <gxapi::eDescriptorHeapType HeapType>
+void HostDescHeap<HeapType>::Copy(size_t count, const gxapi::DescriptorHandle* sources, const size_t* positions) {
+	// Thread local to avoid allocations on each call.
+	thread_local std::vector<gxapi::DescriptorHandle> srcStarts;
+	thread_local std::vector<gxapi::DescriptorHandle> dstStarts;
+	thread_local std::vector<uint32_t> rangeLengths;
+
+	srcStarts.assign(sources, sources + count);
+	dstStarts.resize(count);
+	rangeLengths.assign(count, 1);
+	for (size_t i = 0; i < count; ++i) {
+		dstStarts[i] = At(positions[i]);
+	}
+
+	m_graphicsApi->CopyDescriptors(count, srcStarts.data(), rangeLengths.data(),
+								   count, dstStarts.data(), rangeLengths.data(),
+								   HeapType);
 }
 
 template <gxapi::eDescriptorHeapType HeapType>
@@ -99,7 +199,7 @@ gxapi::DescriptorHandle HostDescHeap<HeapType>::At(size_t pos) {
 	assert(pos < m_descriptorCount);
 
 	// structure is like a 3D texture
-	const size_t chunkIdx = pos / (chunkDim*chunkDim); // z = i / (width*height)
+	const size_t chunkIdx = pos / (heapDim*chunkDim); // z = i / (width*height)
 	const size_t heapIdx = (pos - chunkIdx*heapDim*chunkDim) / heapDim; // y = (i - z*width*height) / width
 	const size_t descIdx = (pos - chunkIdx*heapDim*chunkDim - heapIdx*heapDim) / 1; // x = (i - z*width*height - y*width) / 1
 
@@ -144,8 +244,9 @@ void HostDescHeap<HeapType>::Grow() {
 
 	// allocate new heap
 	chunk->heaps[heapIdx].reset(m_graphicsApi->CreateDescriptorHeap({ HeapType, heapDim, false }));
+	// Descriptors must exist before their slots become available to other threads.
 	m_descriptorCount += heapDim;
-	m_allocEngine.Resize(m_descriptorCount);
+	m_allocEngine.Grow(m_descriptorCount);
 }
 
 
@@ -1,17 +1,66 @@
 #include "Image.hpp"
 
+#include <algorithm>
+
 namespace inl {
 namespace gxeng {
 
 
+Image::Image(Image&& rhs)
+	: ImageBase(std::move(rhs)),
+	  m_resourceView(std::move(rhs.m_resourceView)),
+	  m_bindlessHeap(rhs.m_bindlessHeap),
+	  m_bindlessIndex(rhs.m_bindlessIndex) {
+	rhs.m_bindlessIndex = BindlessIndexAllocator::InvalidIndex;
+}
+
+Image& Image::operator=(Image&& rhs) {
+	if (this != &rhs) {
+		if (m_bindlessIndex != BindlessIndexAllocator::InvalidIndex) {
+			m_bindlessHeap->Unregister(m_bindlessIndex);
+		}
+		ImageBase::operator=(std::move(rhs));
+		m_resourceView = std::move(rhs.m_resourceView);
+		m_bindlessHeap = rhs.m_bindlessHeap;
+		m_bindlessIndex = rhs.m_bindlessIndex;
+		rhs.m_bindlessIndex = BindlessIndexAllocator::InvalidIndex;
+	}
+	return *this;
+}
+
+Image::~Image() {
+	if (m_bindlessIndex != BindlessIndexAllocator::InvalidIndex) {
+		m_bindlessHeap->Unregister(m_bindlessIndex);
+	}
+}
+
+
 void Image::SetLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, int channelCount, ePixelClass pixelClass) {
-	ImageBase::SetLayout(width, height, channelType, channelCount, pixelClass, 1);
+	ImageBase::SetLayout(width, height, channelType, channelCount, pixelClass, 1, 1, true);
+}
+
+void Image::SetLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, int channelCount, ePixelClass pixelClass, int mipLevels) {
+	if (mipLevels <= 0) {
+		throw InvalidArgumentException("At least one mip level is needed.");
+	}
+	ImageBase::SetLayout(width, height, channelType, channelCount, pixelClass, 1, mipLevels);
+}
+
+void Image::SetStreamedLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, int channelCount, ePixelClass pixelClass, int mipLevels, std::shared_ptr<const IMipSource> source) {
+	if (mipLevels <= 0) {
+		throw InvalidArgumentException("At least one mip level is needed.");
+	}
+	ImageBase::SetStreamedLayout(width, height, channelType, channelCount, pixelClass, mipLevels, std::move(source));
 }
 
 void Image::Update(uint64_t x, uint32_t y, uint64_t width, uint32_t height, int mipLevel, const void* pixels, const IPixelReader& reader, size_t bytesPerRow) {
 	ImageBase::Update(x, y, width, height, mipLevel, 0, pixels, reader, bytesPerRow);
 }
 
+void Image::UpdateCompressed(int mipLevel, const void* blocks, size_t bytesPerRow) {
+	ImageBase::UpdateCompressed(mipLevel, 0, blocks, bytesPerRow);
+}
+
 const TextureView2D& Image::GetSrv() const {
 	return m_resourceView;
 }
@@ -23,9 +72,18 @@ void Image::CreateResourceView(const Texture2D& texture) {
 	srvdesc.firstArrayElement = 0;
 	srvdesc.mipLevelClamping = 0;
 	srvdesc.mostDetailedMip = 0;
-	srvdesc.numMipLevels = 1; // change this back to -1
+	srvdesc.numMipLevels = std::max(texture.GetMipLevelCount(), 1u);
 	srvdesc.planeIndex = 0;
 	m_resourceView = TextureView2D(texture, *m_descriptorHeap, texture.GetFormat(), srvdesc);
+
+	if (m_bindlessHeap) {
+		if (m_bindlessIndex == BindlessIndexAllocator::InvalidIndex) {
+			m_bindlessIndex = m_bindlessHeap->Register(m_resourceView.GetHandle());
+		}
+		else {
+			m_bindlessHeap->Update(m_bindlessIndex, m_resourceView.GetHandle());
+		}
+	}
 }
 
 
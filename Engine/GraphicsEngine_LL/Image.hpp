@@ -3,6 +3,7 @@
 #include <memory>
 
 #include <GraphicsEngine/Resources/IImage.hpp>
+#include "BindlessHeap.hpp"
 #include "ImageBase.hpp"
 
 
@@ -12,24 +13,45 @@ namespace gxeng {
 
 class Image : public IImage, protected ImageBase {
 public:
-	Image(MemoryManager* memoryManager, CbvSrvUavHeap* descriptorHeap) : ImageBase(memoryManager, descriptorHeap) {}
+	Image(MemoryManager* memoryManager, CbvSrvUavHeap* descriptorHeap, BindlessHeap* bindlessHeap = nullptr)
+		: ImageBase(memoryManager, descriptorHeap), m_bindlessHeap(bindlessHeap) {}
+	Image(Image&& rhs);
+	Image& operator=(Image&& rhs);
+	~Image();
 
 	void SetLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, int channelCount, ePixelClass pixelClass) override;
+	void SetLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, int channelCount, ePixelClass pixelClass, int mipLevels) override;
 	void Update(uint64_t x, uint32_t y, uint64_t width, uint32_t height, int mipLevel, const void* pixels, const IPixelReader& reader, size_t bytesPerRow = 0) override;
+	void UpdateCompressed(int mipLevel, const void* blocks, size_t bytesPerRow = 0) override;
+	void SetMipGeneration(eMipFilter filter, bool srgb) override { ImageBase::SetMipGeneration(filter, srgb); }
+
+	/// <summary> Keeps only the levels in memory that renderers request, see <see cref="ImageBase::SetStreamedLayout"/>. </summary>
+	void SetStreamedLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, int channelCount, ePixelClass pixelClass, int mipLevels, std::shared_ptr<const IMipSource> source);
+	/// <summary> Called by renderers for each image they draw with, see <see cref="ImageBase::RequestMip"/>. </summary>
+	void RequestMip(unsigned mipLevel) const { ImageBase::RequestMip(mipLevel); }
 
 	size_t GetWidth() const override { return ImageBase::GetWidth(); }
 	size_t GetHeight() const override { return ImageBase::GetHeight(); }
 	ePixelChannelType GetChannelType() const override { return ImageBase::GetChannelType(); }
 	int GetChannelCount() const override { return ImageBase::GetChannelCount(); }
 	ePixelClass GetPixelClass() const override { return ImageBase::GetPixelClass(); }
+	unsigned GetMipLevelCount() const { return ImageBase::GetMipLevelCount(); }
+	uint64_t GetMemorySize() const { return ImageBase::GetMemorySize(); }
+	uint64_t GetSourceSize() const { return ImageBase::GetSourceSize(); }
 
 	const TextureView2D& GetSrv() const;
 
+	/// <summary> Index of the SRV in the bindless heap, or <see cref="BindlessIndexAllocator::InvalidIndex"/>
+	///		if the engine has no bindless heap or the layout is not set yet. </summary>
+	uint32_t GetBindlessIndex() const { return m_bindlessIndex; }
+
 private:
 	void CreateResourceView(const Texture2D& texture) override;
 
 private:
 	TextureView2D m_resourceView;
+	BindlessHeap* m_bindlessHeap;
+	uint32_t m_bindlessIndex = BindlessIndexAllocator::InvalidIndex;
 };
 
 
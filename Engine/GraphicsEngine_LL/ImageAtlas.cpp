@@ -0,0 +1,82 @@
+#include "ImageAtlas.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+
+namespace inl::gxeng {
+
+
+ImageAtlas::ImageAtlas(IImage* target, unsigned padding)
+	: m_target(target), m_padding(padding) {
+	if (!target || target->GetWidth() == 0 || target->GetHeight() == 0) {
+		throw InvalidArgumentException("The target image must have its layout set.");
+	}
+	m_width = (unsigned)target->GetWidth();
+	m_height = (unsigned)target->GetHeight();
+}
+
+
+std::optional<RectI> ImageAtlas::Allocate(unsigned width, unsigned height) {
+	if (width == 0 || height == 0) {
+		return {};
+	}
+
+	// The shelf that wastes the least height, the ones much taller are left for taller images.
+	Shelf* best = nullptr;
+	for (auto& shelf : m_shelves) {
+		bool fits = height <= shelf.height && shelf.usedWidth + width + m_padding <= m_width;
+		if (fits && (!best || shelf.height < best->height)) {
+			best = &shelf;
+		}
+	}
+
+	if (!best) {
+		unsigned y = m_shelves.empty() ? m_padding : m_shelves.back().y + m_shelves.back().height + m_padding;
+		if (y + height + m_padding > m_height || m_padding + width + m_padding > m_width) {
+			return {};
+		}
+		m_shelves.push_back({ y, height, m_padding });
+		best = &m_shelves.back();
+	}
+
+	RectI place = RectI::FromSize(best->y, best->usedWidth, width, height);
+	best->usedWidth += width + m_padding;
+	return place;
+}
+
+
+std::optional<RectF> ImageAtlas::Add(unsigned width, unsigned height, const void* pixels, const IPixelReader& reader, size_t bytesPerRow) {
+	std::optional<RectI> place = Allocate(width, height);
+	if (!place) {
+		return {};
+	}
+	m_target->Update(place->left, place->bottom, width, height, 0, pixels, reader, bytesPerRow);
+	return GetTextureRect(*place);
+}
+
+
+RectF ImageAtlas::GetTextureRect(const RectI& place) const {
+	return {
+		float(place.left) / float(m_width),
+		float(place.right) / float(m_width),
+		float(place.bottom) / float(m_height),
+		float(place.top) / float(m_height),
+	};
+}
+
+
+void ImageAtlas::Clear() {
+	m_shelves.clear();
+}
+
+
+void ImageAtlas::UpdateSize() {
+	if (m_target->GetWidth() < m_width || m_target->GetHeight() < m_height) {
+		throw InvalidStateException("The target image must not shrink.");
+	}
+	m_width = (unsigned)m_target->GetWidth();
+	m_height = (unsigned)m_target->GetHeight();
+}
+
+
+} // namespace inl::gxeng
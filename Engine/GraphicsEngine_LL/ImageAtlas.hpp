@@ -0,0 +1,61 @@
+#pragma once
+
+#include <GraphicsEngine/Resources/IImage.hpp>
+#include <BaseLibrary/Rect.hpp>
+
+#include <optional>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary> Packs small images, like the icons of a GUI, into one big image. </summary>
+/// <remarks> Overlays that draw from the same image are batched into a single draw call,
+///		so an atlas lets a whole board of controls render in a few draws.
+///		Images are placed on shelves: rows as tall as their first image, filled left to right.
+///		A <see cref="GetPadding"/> wide gap is left around each image so filtering does not bleed between neighbours.
+///		The gap is not written, clear the target when its layout is set. </remarks>
+class ImageAtlas {
+public:
+	/// <param name="target"> The image to pack to, its layout must already be set. </param>
+	/// <param name="padding"> Texels left empty between images. </param>
+	explicit ImageAtlas(IImage* target, unsigned padding = 1);
+
+	/// <summary> Reserves a place for an image of the given size. </summary>
+	/// <returns> The place in texels, or nothing if the atlas is full. </returns>
+	std::optional<RectI> Allocate(unsigned width, unsigned height);
+
+	/// <summary> Reserves a place and uploads the pixels to it, see <see cref="IImage::Update"/> for the parameters. </summary>
+	/// <returns> The texture rect to set on the overlays that draw the image, or nothing if the atlas is full. </returns>
+	std::optional<RectF> Add(unsigned width, unsigned height, const void* pixels, const IPixelReader& reader, size_t bytesPerRow = 0);
+
+	/// <summary> The texture rect of a place returned by <see cref="Allocate"/>. </summary>
+	RectF GetTextureRect(const RectI& place) const;
+
+	/// <summary> Forgets all places, the contents of the target are kept until overwritten. </summary>
+	void Clear();
+
+	/// <summary> Call after setting a larger layout on the target, the places so far are kept. </summary>
+	/// <remarks> The texture rects of the places change, the places in texels stay. </remarks>
+	void UpdateSize();
+
+	IImage* GetImage() const { return m_target; }
+	unsigned GetPadding() const { return m_padding; }
+
+private:
+	struct Shelf {
+		unsigned y;
+		unsigned height;
+		unsigned usedWidth;
+	};
+
+	IImage* m_target;
+	unsigned m_padding;
+	unsigned m_width;
+	unsigned m_height;
+	std::vector<Shelf> m_shelves;
+};
+
+
+} // namespace inl::gxeng
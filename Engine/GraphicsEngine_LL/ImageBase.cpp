@@ -1,9 +1,47 @@
 #include "ImageBase.hpp"
 
+#include "MipGenerationTask.hpp"
+#include "PixelConversion.hpp"
+
+#include <algorithm>
+
 namespace inl {
 namespace gxeng {
 
 
+static uint64_t MipSize(uint64_t size, unsigned mip) {
+	return std::max(uint64_t(1), size >> mip);
+}
+
+
+static uint64_t TextureSize(const Texture2D& texture) {
+	if (!texture) {
+		return 0;
+	}
+	gxapi::eFormat format = texture.GetFormat();
+	uint64_t size = 0;
+	for (unsigned mip = 0; mip < texture.GetNumMiplevels(); ++mip) {
+		size += gxapi::GetFormatRowSizeInBytes(format, MipSize(texture.GetWidth(), mip)) * gxapi::GetFormatRowCount(format, uint32_t(MipSize(texture.GetHeight(), mip)));
+	}
+	return size * texture.GetArrayCount();
+}
+
+
+static unsigned FullMipCount(uint64_t width, uint64_t height) {
+	unsigned count = 1;
+	while ((std::max(width, height) >> count) > 0) {
+		++count;
+	}
+	return count;
+}
+
+
+static bool IsValidTopMip(gxapi::eFormat format, uint64_t width, uint32_t height, unsigned mip) {
+	// Block compressed textures must be a whole number of blocks, the full chain is taken as it is.
+	return mip == 0 || !gxapi::IsBlockCompressed(format) || (MipSize(width, mip) % 4 == 0 && MipSize(height, mip) % 4 == 0);
+}
+
+
 ImageBase::ImageBase(MemoryManager* memoryManager, CbvSrvUavHeap* descriptorHeap) {
 	assert(memoryManager != nullptr);
 	m_memoryManager = memoryManager;
@@ -13,29 +51,158 @@ ImageBase::ImageBase(MemoryManager* memoryManager, CbvSrvUavHeap* descriptorHeap
 }
 
 
-ImageBase::~ImageBase() {
+ImageBase::ImageBase(ImageBase&& rhs)
+	: m_descriptorHeap(rhs.m_descriptorHeap),
+	  m_resource(std::move(rhs.m_resource)),
+	  m_channelType(rhs.m_channelType),
+	  m_channelCount(rhs.m_channelCount),
+	  m_pixelClass(rhs.m_pixelClass),
+	  m_memoryManager(rhs.m_memoryManager),
+	  m_width(rhs.m_width),
+	  m_height(rhs.m_height),
+	  m_generateMips(rhs.m_generateMips),
+	  m_mipFilter(rhs.m_mipFilter),
+	  m_srgbMips(rhs.m_srgbMips),
+	  m_mipSource(std::move(rhs.m_mipSource)),
+	  m_mipCount(rhs.m_mipCount),
+	  m_residentMip(rhs.m_residentMip),
+	  m_coarsestResidentMip(rhs.m_coarsestResidentMip),
+	  m_requestedMip(rhs.m_requestedMip.load()),
+	  m_memorySize(rhs.m_memorySize.load()) {
+	if (m_mipSource) {
+		m_memoryManager->GetTextureStreamer().Unregister(&rhs);
+		m_memoryManager->GetTextureStreamer().Register(this);
+	}
+}
+
 
+ImageBase& ImageBase::operator=(ImageBase&& rhs) {
+	if (this != &rhs) {
+		StopStreaming();
+		m_descriptorHeap = rhs.m_descriptorHeap;
+		m_resource = std::move(rhs.m_resource);
+		m_channelType = rhs.m_channelType;
+		m_channelCount = rhs.m_channelCount;
+		m_pixelClass = rhs.m_pixelClass;
+		m_memoryManager = rhs.m_memoryManager;
+		m_width = rhs.m_width;
+		m_height = rhs.m_height;
+		m_generateMips = rhs.m_generateMips;
+		m_mipFilter = rhs.m_mipFilter;
+		m_srgbMips = rhs.m_srgbMips;
+		m_mipSource = std::move(rhs.m_mipSource);
+		m_mipCount = rhs.m_mipCount;
+		m_residentMip = rhs.m_residentMip;
+		m_coarsestResidentMip = rhs.m_coarsestResidentMip;
+		m_requestedMip = rhs.m_requestedMip.load();
+		m_memorySize = rhs.m_memorySize.load();
+		if (m_mipSource) {
+			m_memoryManager->GetTextureStreamer().Unregister(&rhs);
+			m_memoryManager->GetTextureStreamer().Register(this);
+		}
+	}
+	return *this;
 }
 
 
-void ImageBase::SetLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, unsigned channelCount, ePixelClass pixelClass, unsigned arraySize) {
+ImageBase::~ImageBase() {
+	StopStreaming();
+}
+
+
+void ImageBase::SetLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, unsigned channelCount, ePixelClass pixelClass, unsigned arraySize, unsigned mipLevels, bool generateMips) {
 	gxapi::eFormat format;
 	int resultChCnt = 0;
 	if (!ConvertFormat(channelType, channelCount, pixelClass, format, resultChCnt)) {
 		throw InvalidArgumentException("Unsupported texture format.");
 	}
 
+	gxapi::eResourceFlags flags;
+	if (generateMips) {
+		if (MipGenerationTask::IsFormatSupported(format)) {
+			mipLevels = 0;
+			flags += gxapi::eResourceFlags::ALLOW_UNORDERED_ACCESS;
+		}
+		else {
+			mipLevels = 1;
+			generateMips = false;
+		}
+	}
+
+	Texture2DDesc resdesc(width, height, format, mipLevels, arraySize);
+	Texture2D texture = m_memoryManager->CreateTexture2D(eResourceHeap::CRITICAL, resdesc, flags);
 
-	Texture2DDesc resdesc(width, height, format, 0, arraySize);
-	Texture2D texture = m_memoryManager->CreateTexture2D(eResourceHeap::CRITICAL, resdesc);
+	// In case this throws an exception changes will be unrolled.
+	CreateResourceView(texture);
+
+	StopStreaming();
+	m_resource = std::move(texture);
+	m_memorySize = TextureSize(m_resource);
+	m_channelCount = channelCount;
+	m_channelType = channelType;
+	m_pixelClass = pixelClass;
+	m_width = width;
+	m_height = height;
+	m_generateMips = generateMips;
+	m_mipCount = m_resource.GetMipLevelCount();
+	m_residentMip = 0;
+	m_coarsestResidentMip = 0;
+}
+
+
+void ImageBase::SetStreamedLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, unsigned channelCount, ePixelClass pixelClass, unsigned mipLevels, std::shared_ptr<const IMipSource> source) {
+	if (!source) {
+		throw InvalidArgumentException("Streamed images need a source for their levels.");
+	}
+	gxapi::eFormat format;
+	int resultChCnt = 0;
+	if (!ConvertFormat(channelType, channelCount, pixelClass, format, resultChCnt)) {
+		throw InvalidArgumentException("Unsupported texture format.");
+	}
+	if (mipLevels == 0 || mipLevels > FullMipCount(width, height)) {
+		throw InvalidArgumentException("Mip level count does not fit the size of the image.", std::to_string(mipLevels));
+	}
+
+	unsigned coarsestMip = 0;
+	while (coarsestMip + 1 < mipLevels && std::max(MipSize(width, coarsestMip), MipSize(height, coarsestMip)) > StreamingTailSize) {
+		++coarsestMip;
+	}
+	while (!IsValidTopMip(format, width, height, coarsestMip)) {
+		--coarsestMip;
+	}
 
 	// In case this throws an exception changes will be unrolled.
+	Texture2D texture = CreateStreamedTexture(*source, width, height, format, mipLevels, coarsestMip);
 	CreateResourceView(texture);
 
+	StopStreaming();
 	m_resource = std::move(texture);
+	m_memorySize = TextureSize(m_resource);
 	m_channelCount = channelCount;
 	m_channelType = channelType;
 	m_pixelClass = pixelClass;
+	m_width = width;
+	m_height = height;
+	m_generateMips = false;
+	m_mipSource = std::move(source);
+	m_mipCount = mipLevels;
+	m_residentMip = coarsestMip;
+	m_coarsestResidentMip = coarsestMip;
+	m_requestedMip = NoRequest;
+	m_memoryManager->GetTextureStreamer().Register(this);
+}
+
+
+void ImageBase::RequestMip(unsigned mipLevel) const {
+	unsigned requested = m_requestedMip.load(std::memory_order_relaxed);
+	while (mipLevel < requested && !m_requestedMip.compare_exchange_weak(requested, mipLevel, std::memory_order_relaxed)) {
+	}
+}
+
+
+void ImageBase::SetMipGeneration(eMipFilter filter, bool srgb) {
+	m_mipFilter = filter;
+	m_srgbMips = srgb;
 }
 
 
@@ -43,48 +210,84 @@ void ImageBase::Update(uint64_t x, uint32_t y, uint64_t width, uint32_t height,
 	if (!m_resource) {
 		throw InvalidStateException("Must create image first.");
 	}
+	if (m_mipSource) {
+		throw InvalidCallException("Levels of streamed images come from their source.");
+	}
 
 	if (x + width > GetWidth() || y + height > GetHeight()) {
 		throw OutOfRangeException("Destination region out of bounds.");
 	}
+	if (gxapi::IsBlockCompressed(m_resource.GetFormat())) {
+		throw InvalidCallException("Block compressed images are uploaded by UpdateCompressed.");
+	}
 
-	if (GetChannelCount() != 4 && reader.GetChannelCount() == 3) {
-		if (reader.GetChannelCount() != GetChannelCount()
-			|| reader.GetPixelClass() != GetPixelClass()
-			|| reader.GetChannelType() != GetChannelType())
-		{
-			throw NotImplementedException("Pixel types mismatch, conversion is not supported yet (but will be).");
+	// The texture may have more channels than the image, e.g. 8 bit RGB is stored as RGBA.
+	gxapi::eFormat format;
+	int storedChannelCount = 0;
+	ConvertFormat(GetChannelType(), GetChannelCount(), GetPixelClass(), format, storedChannelCount);
+	const PixelFormat sourceFormat{ reader.GetChannelType(), reader.GetChannelCount() };
+	const PixelFormat textureFormat{ GetChannelType(), storedChannelCount };
+	const uint32_t subresource = m_resource.GetSubresourceIndex(mipLevel, arrayIndex, 0);
+
+	if (sourceFormat == textureFormat) {
+		m_memoryManager->GetUploadManager().Upload(
+			m_resource,
+			(uint32_t)x,
+			(uint32_t)y,
+			subresource,
+			pixels,
+			width,
+			(uint32_t)height,
+			m_resource.GetFormat(),
+			bytesPerRow);
+	}
+	else {
+		if (!PixelConversion::IsSupported(sourceFormat, textureFormat)) {
+			throw InvalidArgumentException("Pixels can't be converted to the format of the image.");
 		}
+		// Converted straight into the staging memory, rows of large images in parallel.
+		const size_t sourcePitch = bytesPerRow > 0 ? bytesPerRow : width * PixelConversion::PixelSize(sourceFormat);
+		jobs::Scheduler* scheduler = m_memoryManager->GetJobScheduler();
+		m_memoryManager->GetUploadManager().UploadInPlace(
+			m_resource,
+			(uint32_t)x,
+			(uint32_t)y,
+			subresource,
+			width,
+			(uint32_t)height,
+			m_resource.GetFormat(),
+			[&](uint8_t* rows, size_t rowPitch) {
+				PixelConversion::Convert(pixels, sourcePitch, sourceFormat, rows, rowPitch, textureFormat, width, height, PixelConversion::Identity, scheduler);
+			});
 	}
 
-	// Convert 3 channel pixels to 4 channels.
-	std::unique_ptr<uint8_t> pixels4;
-	if (reader.GetChannelCount() == 3) {
-		size_t structureSize = reader.StructureSize();
-		size_t structureSize4 = structureSize * 4 / 3;
-		size_t channelSize = structureSize / 3;
-		pixels4.reset(new uint8_t[structureSize4 * width * height]);
-		size_t dstPitch = width * structureSize4;
-		size_t srcPitch = bytesPerRow > 0 ? bytesPerRow : width * structureSize;
-		for (size_t y = 0; y < height; ++y) {
-			for (size_t x = 0; x < width; ++x) {
-				uint8_t* dst = pixels4.get() + (y * dstPitch + x * structureSize4);
-				memcpy(dst, (uint8_t*)pixels + (y * srcPitch + x * structureSize), structureSize);
-				memset(dst + structureSize, 0, channelSize);
-			}
-		}
-		pixels = pixels4.get();
+	if (m_generateMips && mipLevel == 0) {
+		m_memoryManager->GetUploadManager().GenerateMips(m_resource, m_mipFilter, m_srgbMips);
 	}
+}
 
-	// Upload data to gpu.
+
+void ImageBase::UpdateCompressed(unsigned mipLevel, unsigned arrayIndex, const void* blocks, size_t bytesPerRow) {
+	if (!m_resource) {
+		throw InvalidStateException("Must create image first.");
+	}
+	if (!gxapi::IsBlockCompressed(m_resource.GetFormat())) {
+		throw InvalidCallException("Image is not block compressed, use Update.");
+	}
+	if (m_mipSource) {
+		throw InvalidCallException("Levels of streamed images come from their source.");
+	}
+
+	uint64_t width = std::max(GetWidth() >> mipLevel, size_t(1));
+	uint32_t height = std::max(uint32_t(GetHeight() >> mipLevel), 1u);
 	m_memoryManager->GetUploadManager().Upload(
 		m_resource,
-		(uint32_t)x,
-		(uint32_t)y,
+		0,
+		0,
 		m_resource.GetSubresourceIndex(mipLevel, arrayIndex, 0),
-		pixels,
+		blocks,
 		width,
-		(uint32_t)height,
+		height,
 		m_resource.GetFormat(),
 		bytesPerRow);
 }
@@ -92,7 +295,7 @@ void ImageBase::Update(uint64_t x, uint32_t y, uint64_t width, uint32_t height,
 
 size_t ImageBase::GetWidth() const {
 	if (m_resource) {
-		return m_resource.GetWidth();
+		return m_width;
 	}
 	else {
 		return 0;
@@ -102,7 +305,7 @@ size_t ImageBase::GetWidth() const {
 
 size_t ImageBase::GetHeight() const {
 	if (m_resource) {
-		return m_resource.GetHeight();
+		return m_height;
 	}
 	else {
 		return 0;
@@ -125,6 +328,23 @@ ePixelClass ImageBase::GetPixelClass() const {
 }
 
 
+uint64_t ImageBase::GetMemorySize() const {
+	return m_memorySize.load(std::memory_order_relaxed);
+}
+
+
+uint64_t ImageBase::GetSourceSize() const {
+	if (!m_mipSource) {
+		return 0;
+	}
+	uint64_t size = 0;
+	for (uint64_t levelSize : GetLevelSizes()) {
+		size += levelSize;
+	}
+	return size;
+}
+
+
 bool ImageBase::ConvertFormat(ePixelChannelType channelType, int channelCount, ePixelClass pixelClass, gxapi::eFormat& fmt, int& resultingChannelCount) {
 	using gxapi::eFormat;
 
@@ -157,12 +377,93 @@ bool ImageBase::ConvertFormat(ePixelChannelType channelType, int channelCount, e
 			resultingChannelCount = channelCount;
 			return true;
 		}
+		case ePixelChannelType::BC1: fmt = eFormat::BC1_UNORM; resultingChannelCount = 4; return true;
+		case ePixelChannelType::BC2: fmt = eFormat::BC2_UNORM; resultingChannelCount = 4; return true;
+		case ePixelChannelType::BC3: fmt = eFormat::BC3_UNORM; resultingChannelCount = 4; return true;
+		case ePixelChannelType::BC4: fmt = eFormat::BC4_UNORM; resultingChannelCount = 1; return true;
+		case ePixelChannelType::BC5: fmt = eFormat::BC5_UNORM; resultingChannelCount = 2; return true;
+		case ePixelChannelType::BC6H: fmt = eFormat::BC6H_UF16; resultingChannelCount = 3; return true;
+		case ePixelChannelType::BC7: fmt = eFormat::BC7_UNORM; resultingChannelCount = 4; return true;
 	}
 
 	return false;
 }
 
 
+std::vector<uint64_t> ImageBase::GetLevelSizes() const {
+	gxapi::eFormat format = m_resource.GetFormat();
+	std::vector<uint64_t> sizes(m_mipCount);
+	for (unsigned mip = 0; mip < m_mipCount; ++mip) {
+		sizes[mip] = gxapi::GetFormatRowSizeInBytes(format, MipSize(m_width, mip)) * gxapi::GetFormatRowCount(format, uint32_t(MipSize(m_height, mip)));
+	}
+	return sizes;
+}
+
+
+unsigned ImageBase::GetResidentMip() const {
+	return m_residentMip;
+}
+
+
+unsigned ImageBase::GetCoarsestResidentMip() const {
+	return m_coarsestResidentMip;
+}
+
+
+unsigned ImageBase::TakeRequestedMip() {
+	return m_requestedMip.exchange(NoRequest, std::memory_order_relaxed);
+}
+
+
+void ImageBase::SetResidentMip(unsigned mip) {
+	mip = std::min(mip, m_coarsestResidentMip);
+	gxapi::eFormat format = m_resource.GetFormat();
+	while (!IsValidTopMip(format, m_width, m_height, mip)) {
+		--mip;
+	}
+	if (mip == m_residentMip) {
+		return;
+	}
+
+	// The old texture is kept alive by the frames in flight that use it, the new one is complete before it is first drawn.
+	Texture2D texture = CreateStreamedTexture(*m_mipSource, m_width, m_height, format, m_mipCount, mip);
+	CreateResourceView(texture);
+	m_resource = std::move(texture);
+	m_memorySize = TextureSize(m_resource);
+	m_residentMip = mip;
+}
+
+
+Texture2D ImageBase::CreateStreamedTexture(const IMipSource& source, uint64_t width, uint32_t height, gxapi::eFormat format, unsigned mipCount, unsigned firstMip) const {
+	Texture2DDesc resdesc(MipSize(width, firstMip), uint32_t(MipSize(height, firstMip)), format, uint16_t(mipCount - firstMip), 1);
+	Texture2D texture = m_memoryManager->CreateTexture2D(eResourceHeap::CRITICAL, resdesc);
+
+	for (unsigned mip = firstMip; mip < mipCount; ++mip) {
+		size_t bytesPerRow = 0;
+		const void* data = source.GetMipData(mip, bytesPerRow);
+		m_memoryManager->GetUploadManager().Upload(
+			texture,
+			0,
+			0,
+			texture.GetSubresourceIndex(mip - firstMip, 0, 0),
+			data,
+			MipSize(width, mip),
+			uint32_t(MipSize(height, mip)),
+			format,
+			bytesPerRow);
+	}
+	return texture;
+}
+
+
+void ImageBase::StopStreaming() {
+	if (m_mipSource) {
+		m_memoryManager->GetTextureStreamer().Unregister(this);
+		m_mipSource.reset();
+	}
+}
+
+
 
 } // namespace gxeng
 } // namespace inl
\ No newline at end of file
@@ -1,26 +1,33 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include "MemoryObject.hpp"
+#include <GraphicsEngine/Resources/IImage.hpp>
 #include <GraphicsEngine/Resources/Pixel.hpp>
 #include "MemoryManager.hpp"
 #include "ResourceView.hpp"
+#include "TextureStreamer.hpp"
 
 
 namespace inl::gxeng {
 
 
 
-class ImageBase {
+class ImageBase : public IStreamedImage {
 public:
+	/// <summary> Levels of streamed images no larger than this are always in memory. </summary>
+	static constexpr uint64_t StreamingTailSize = 64;
+
 	ImageBase(MemoryManager* memoryManager, CbvSrvUavHeap* descriptorHeap);
 	ImageBase(const ImageBase&) = delete;
-	ImageBase(ImageBase&&) = default;
+	ImageBase(ImageBase&& rhs);
 	ImageBase& operator=(const ImageBase&) = delete;
-	ImageBase& operator=(ImageBase&&) = default;
+	ImageBase& operator=(ImageBase&& rhs);
 	~ImageBase();
 
 	/// <summary> Returns the width of the image in pixels. </summary>
+	/// <remarks> Of the finest level, even if a streamed image does not have it in memory. </remarks>
 	size_t GetWidth() const;
 
 	/// <summary> Returns the height of the image in pixels. </summary>
@@ -35,6 +42,16 @@ public:
 	/// <summary> Return the way pixels are interpreted. See <see cref="ePixelClass"/>. </summary>
 	ePixelClass GetPixelClass() const;
 
+	/// <summary> Number of levels of the full chain, even if a streamed image does not have all of them in memory. </summary>
+	unsigned GetMipLevelCount() const { return m_mipCount; }
+
+	/// <summary> Bytes of video memory the levels in memory take, without the padding of the allocation. </summary>
+	/// <remarks> Thread safe, streamed images change as levels are streamed in and out. </remarks>
+	uint64_t GetMemorySize() const;
+
+	/// <summary> Bytes of the full chain streamed images keep at hand in their source, zero for other images. </summary>
+	uint64_t GetSourceSize() const;
+
 protected:
 	/// <summary> Allocates the underlying GPU-resident texture. </summary>
 	/// <param name="width"> Width of the texture in pixels. </param>
@@ -43,7 +60,24 @@ protected:
 	/// <param name="channelCount"> Number of channels per pixel. </param>
 	/// <param name="pixelClass"> How pixels are interpreted. See <see cref="ePixelClass"/>. </param>
 	/// <param name="arraySize"> Specify 1 for simple images and 6 for cubemaps. </param>
-	void SetLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, unsigned channelCount, ePixelClass pixelClass, unsigned arraySize);
+	/// <param name="mipLevels"> Zero allocates the full mip chain. </param>
+	/// <param name="generateMips"> Allocates the full mip chain and generates the levels on the GPU whenever the top level is updated.
+	///		<paramref name="mipLevels"/> is ignored. Formats shaders can't write get a single level instead. </param>
+	void SetLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, unsigned channelCount, ePixelClass pixelClass, unsigned arraySize, unsigned mipLevels = 0, bool generateMips = false);
+
+	/// <summary> Allocates only the coarsest levels of the texture and streams the finer ones in from
+	///		<paramref name="source"/> as they are requested, see <see cref="TextureStreamer"/>. </summary>
+	/// <param name="mipLevels"> Levels of the full chain, all of them must be provided by the source. </param>
+	/// <remarks> The texture is replaced whenever levels are streamed in or out, along with the views of it,
+	///		so the levels in flight are never sampled. Streamed images can't be updated. </remarks>
+	void SetStreamedLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, unsigned channelCount, ePixelClass pixelClass, unsigned mipLevels, std::shared_ptr<const IMipSource> source);
+
+	/// <summary> Asks for the level to be in memory by the next frames, the finest request of a frame counts. </summary>
+	/// <remarks> Thread safe, ignored if the image is not streamed. </remarks>
+	void RequestMip(unsigned mipLevel) const;
+
+	/// <summary> Sets how mips are generated, see <see cref="IImage::SetMipGeneration"/>. Affects the next updates of the top level. </summary>
+	void SetMipGeneration(eMipFilter filter, bool srgb);
 
 	/// <summary> Upload pixels as byte array to the GPU. </summary>
 	/// <param name="x"> Where to insert the block of uploaded pixels. Top-left corner. </param>
@@ -58,6 +92,14 @@ protected:
 	/// <remarks> As you can't create multi-planed textures, uploading to specific plane is not supported. </remarks>
 	void Update(uint64_t x, uint32_t y, uint64_t width, uint32_t height, unsigned mipLevel, unsigned arrayIdx, const void* pixels, const IPixelReader& reader, size_t bytesPerRow = 0);
 
+	/// <summary> Upload a whole mip level of a block compressed image, the blocks are copied as they are. </summary>
+	/// <param name="bytesPerRow"> How many bytes to skip in <paramref name="blocks"/> for each row of blocks. Leave as 0 for no row padding. </param>
+	void UpdateCompressed(unsigned mipLevel, unsigned arrayIdx, const void* blocks, size_t bytesPerRow = 0);
+
+	/// <summary> The texture of the levels in memory, empty before the layout is set. </summary>
+	const Texture2D& GetTexture() const { return m_resource; }
+	MemoryManager* GetMemoryManager() const { return m_memoryManager; }
+
 	/// <summary> Converts simplified pixel format to GraphicsAPI format. </summary>
 	static bool ConvertFormat(ePixelChannelType channelType, int channelCount, ePixelClass pixelClass, gxapi::eFormat& fmt, int& resultingChannelCount);
 	
@@ -65,6 +107,17 @@ protected:
 	/// <remarks> This must be implemented until the bottom-most subclass. </remarks>
 	virtual void CreateResourceView(const Texture2D& texture) = 0;
 
+private:
+	std::vector<uint64_t> GetLevelSizes() const override;
+	unsigned GetResidentMip() const override;
+	unsigned GetCoarsestResidentMip() const override;
+	unsigned TakeRequestedMip() override;
+	void SetResidentMip(unsigned mip) override;
+
+	/// <summary> Allocates the levels from <paramref name="firstMip"/> on of the full chain and uploads them from the source. </summary>
+	Texture2D CreateStreamedTexture(const IMipSource& source, uint64_t width, uint32_t height, gxapi::eFormat format, unsigned mipCount, unsigned firstMip) const;
+	void StopStreaming();
+
 protected:
 	CbvSrvUavHeap* m_descriptorHeap;
 private:
@@ -73,6 +126,20 @@ private:
 	int m_channelCount;
 	ePixelClass m_pixelClass;
 	MemoryManager* m_memoryManager;
+	uint64_t m_width = 0;
+	uint32_t m_height = 0;
+
+	bool m_generateMips = false;
+	eMipFilter m_mipFilter = eMipFilter::BOX;
+	bool m_srgbMips = false;
+
+	// Streaming, m_resource holds the levels from m_residentMip on.
+	std::shared_ptr<const IMipSource> m_mipSource;
+	unsigned m_mipCount = 0;
+	unsigned m_residentMip = 0;
+	unsigned m_coarsestResidentMip = 0;
+	mutable std::atomic<unsigned> m_requestedMip = NoRequest;
+	std::atomic<uint64_t> m_memorySize = 0;
 };
 
 
@@ -0,0 +1,30 @@
+#include "InstanceBatcher.hpp"
+
+
+namespace inl::gxeng {
+
+
+void InstanceBatcher::Clear() {
+	m_batches.clear();
+	m_transforms.clear();
+	m_split = false;
+}
+
+
+void InstanceBatcher::Reserve(size_t instanceCount) {
+	m_transforms.reserve(instanceCount);
+}
+
+
+void InstanceBatcher::Add(Mesh* mesh, Material* material, const Mat44& world, uint32_t lod, const VertexBuffer* vertices, uint32_t viewMask) {
+	const bool sameDraw = !m_batches.empty() && m_batches.back().mesh == mesh && m_batches.back().material == material && m_batches.back().lod == lod && m_batches.back().vertices == vertices && m_batches.back().viewMask == viewMask;
+	if (m_split || !sameDraw) {
+		m_batches.push_back({ mesh, material, lod, vertices, uint32_t(m_transforms.size()), 0, viewMask });
+		m_split = false;
+	}
+	++m_batches.back().instanceCount;
+	m_transforms.push_back(world);
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <InlineMath.hpp>
+
+#include <cstdint>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+class Mesh;
+class Material;
+class VertexBuffer;
+
+
+/// <summary>
+/// Merges consecutive draws of the same mesh and material into instanced draws,
+/// and packs the world matrices of all instances into a single array.
+/// </summary>
+/// <remarks> Only neighbours are merged, so draws should come sorted by state,
+///		like the order of a <see cref="RenderQueue"/>. Instances keep the order they were added in. </remarks>
+class InstanceBatcher {
+public:
+	struct Batch {
+		Mesh* mesh;
+		Material* material;
+		uint32_t lod; // Level of detail of the mesh.
+		const VertexBuffer* vertices; // Drawn instead of stream 0 of the mesh if not null, e.g. skinned vertices.
+		uint32_t firstInstance; // Index of the batch's first world matrix in the transform array.
+		uint32_t instanceCount;
+		uint32_t viewMask; // Views of a <see cref="ViewSet"/> that draw the batch.
+	};
+
+	void Clear();
+	void Reserve(size_t instanceCount);
+
+	/// <summary> Adds a draw, extending the last batch if it has the same mesh, level of detail, material, vertices and views. </summary>
+	/// <param name="material"> May be null for passes that ignore materials. </param>
+	/// <param name="vertices"> Replaces stream 0 of the mesh, must stay alive until the batches are drawn. </param>
+	/// <param name="viewMask"> The views that see the instance, all of them by default. </param>
+	void Add(Mesh* mesh, Material* material, const Mat44& world, uint32_t lod = 0, const VertexBuffer* vertices = nullptr, uint32_t viewMask = ~0u);
+	/// <summary> The next draw starts a new batch, for draws that go to another view or render target. </summary>
+	void Split() { m_split = true; }
+
+	const std::vector<Batch>& GetBatches() const { return m_batches; }
+	const std::vector<Mat44_Packed>& GetTransforms() const { return m_transforms; }
+	size_t GetInstanceCount() const { return m_transforms.size(); }
+
+private:
+	std::vector<Batch> m_batches;
+	std::vector<Mat44_Packed> m_transforms;
+	bool m_split = false;
+};
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,49 @@
+#include "InstanceBuffer.hpp"
+
+#include "CopyCommandList.hpp"
+#include "NodeContext.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+
+
+namespace inl::gxeng {
+
+
+static constexpr size_t MinCapacity = 64;
+
+
+void InstanceBuffer::Reserve(SetupContext& context, size_t count) {
+	if (count <= m_capacity) {
+		return;
+	}
+
+	m_capacity = std::max(count, std::max(2 * m_capacity, MinCapacity));
+	m_buffer = context.CreateBuffer(m_capacity * sizeof(Mat44_Packed));
+	m_buffer.SetName("Instance transforms");
+
+	gxapi::SrvBuffer desc;
+	desc.firstElement = 0;
+	desc.numElements = (unsigned)m_capacity;
+	desc.structureStrideInBytes = sizeof(Mat44_Packed);
+	desc.isRaw = false;
+	m_view = context.CreateSrv(m_buffer, gxapi::eFormat::UNKNOWN, desc);
+}
+
+
+void InstanceBuffer::Upload(RenderContext& context, CopyCommandList& commandList, const std::vector<Mat44_Packed>& transforms) {
+	if (transforms.size() > m_capacity) {
+		throw InvalidStateException("Instance buffer was not reserved for this many instances.");
+	}
+	if (transforms.empty()) {
+		return;
+	}
+
+	commandList.SetResourceState(m_buffer, gxapi::eResourceState::COPY_DEST);
+	context.Upload(m_buffer, 0, transforms.data(), transforms.size() * sizeof(Mat44_Packed));
+	commandList.SetResourceState(m_buffer, { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "MemoryObject.hpp"
+#include "ResourceView.hpp"
+
+#include <InlineMath.hpp>
+
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+class SetupContext;
+class RenderContext;
+class CopyCommandList;
+
+
+/// <summary>
+/// GPU array of per-instance world matrices, read by vertex shaders as a StructuredBuffer&lt;float4x4&gt;
+/// indexed by the draw's first instance plus SV_InstanceID.
+/// </summary>
+/// <remarks> The contents are uploaded through the command list every frame,
+///		so the GPU copy of the previous frame is never overwritten while it is being read. </remarks>
+class InstanceBuffer {
+public:
+	/// <summary> Makes room for at least <paramref name="count"/> matrices. Grows geometrically. </summary>
+	void Reserve(SetupContext& context, size_t count);
+
+	/// <summary> Copies the matrices to the GPU and leaves the buffer readable by shaders. </summary>
+	/// <remarks> Call <see cref="Reserve"/> during setup with at least as many matrices. </remarks>
+	void Upload(RenderContext& context, CopyCommandList& commandList, const std::vector<Mat44_Packed>& transforms);
+
+	const BufferView& GetView() const { return m_view; }
+	size_t GetCapacity() const { return m_capacity; }
+
+private:
+	LinearBuffer m_buffer;
+	BufferView m_view;
+	size_t m_capacity = 0;
+};
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,44 @@
+#include "LodSelector.hpp"
+
+#include "BasicCamera.hpp"
+#include "BoundingVolumes.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+namespace inl::gxeng {
+
+
+float LodSelector::ScreenSize(const BoundingSphere& sphere, const BasicCamera& camera) {
+	// The vertical scale of the projection is the cotangent of half the field of view.
+	float distance = (sphere.center - camera.GetPosition()).Length();
+	if (distance <= sphere.radius) {
+		return std::numeric_limits<float>::max();
+	}
+	return sphere.radius * std::abs(camera.GetProjectionMatrix()(1, 1)) / distance;
+}
+
+
+uint32_t LodSelector::Select(float screenSize, uint32_t lodCount, uint32_t previousLod) {
+	if (lodCount <= 1) {
+		return 0;
+	}
+	previousLod = std::min(previousLod, lodCount - 1);
+
+	// Continuous level, the integer part is the level without hysteresis.
+	// Not clamped from above, the coarsest level must also be reached past its boundary.
+	float level = screenSize > 0.0f ? std::max(0.0f, std::log2(FinestScreenSize / screenSize)) : float(lodCount);
+
+	if (level >= float(previousLod + 1) + Hysteresis) {
+		return std::min(uint32_t(level - Hysteresis), lodCount - 1);
+	}
+	if (level <= float(previousLod) - Hysteresis) {
+		return uint32_t(std::max(0.0f, level + Hysteresis));
+	}
+	return previousLod;
+}
+
+
+} // namespace inl::gxeng
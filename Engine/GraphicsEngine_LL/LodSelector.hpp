@@ -0,0 +1,38 @@
+#pragma once
+
+#include <InlineMath.hpp>
+
+#include <cstdint>
+
+
+namespace inl::gxeng {
+
+
+class BasicCamera;
+class BoundingSphere;
+
+
+/// <summary>
+/// Chooses a mesh's level of detail from the size of its bounding sphere on the screen.
+/// </summary>
+/// <remarks> Each level is used for half the screen size of the previous one.
+///		Levels only change once the size is past the boundary by <see cref="Hysteresis"/> levels,
+///		so objects near a boundary don't flicker between two levels. </remarks>
+class LodSelector {
+public:
+	/// <summary> Radius of the sphere relative to half the screen height. </summary>
+	static float ScreenSize(const BoundingSphere& sphere, const BasicCamera& camera);
+
+	/// <summary> Returns the level for the given screen size. </summary>
+	/// <param name="previousLod"> The level the object used last frame. </param>
+	static uint32_t Select(float screenSize, uint32_t lodCount, uint32_t previousLod);
+
+	/// <summary> Objects larger than this on the screen use the finest level. </summary>
+	static constexpr float FinestScreenSize = 0.25f;
+	static constexpr float Hysteresis = 0.2f;
+	/// <summary> Shadow passes draw this many levels coarser than the camera's choice. </summary>
+	static constexpr uint32_t ShadowLodBias = 1;
+};
+
+
+} // namespace inl::gxeng
@@ -4,6 +4,8 @@
 #include <BaseLibrary/Exception/Exception.hpp>
 #include <BaseLibrary/Range.hpp>
 
+#include <atomic>
+
 
 namespace inl::gxeng {
 
@@ -29,10 +31,51 @@ static eMaterialShaderParamType GetParameterType(std::string typeString) {
 
 
 
+static std::atomic_uint64_t s_versionCounter = 0;
+
+
+
 //------------------------------------------------------------------------------
 // Material
 //------------------------------------------------------------------------------
 
+Material::Material()
+	: m_version(++s_versionCounter)
+{}
+
+
+Material::Material(const Material& rhs)
+	: m_parameters(rhs.m_parameters), m_shader(rhs.m_shader), m_paramNameMap(rhs.m_paramNameMap) {
+	Relink();
+}
+
+
+Material::Material(Material&& rhs) noexcept
+	: m_parameters(std::move(rhs.m_parameters)), m_shader(rhs.m_shader), m_paramNameMap(std::move(rhs.m_paramNameMap)) {
+	Relink();
+	rhs.Touch();
+}
+
+
+Material& Material::operator=(const Material& rhs) {
+	m_parameters = rhs.m_parameters;
+	m_shader = rhs.m_shader;
+	m_paramNameMap = rhs.m_paramNameMap;
+	Relink();
+	return *this;
+}
+
+
+Material& Material::operator=(Material&& rhs) noexcept {
+	m_parameters = std::move(rhs.m_parameters);
+	m_shader = rhs.m_shader;
+	m_paramNameMap = std::move(rhs.m_paramNameMap);
+	Relink();
+	rhs.Touch();
+	return *this;
+}
+
+
 
 void Material::SetShader(const MaterialShader* shader) {
 	std::vector<Parameter> parameters;
@@ -63,6 +106,7 @@ void Material::SetShader(const MaterialShader* shader) {
 	m_parameters = std::move(parameters);
 	m_paramNameMap = std::move(paramNameMap);
 	m_shader = shader;
+	Relink();
 }
 
 const MaterialShader* Material::GetShader() const {
@@ -99,6 +143,19 @@ const Material::Parameter& Material::operator[](const std::string& name) const {
 }
 
 
+void Material::Relink() {
+	for (auto& parameter : m_parameters) {
+		parameter.m_material = this;
+	}
+	Touch();
+}
+
+
+void Material::Touch() {
+	m_version = ++s_versionCounter;
+}
+
+
 
 //------------------------------------------------------------------------------
 // Material::Parameter
@@ -117,6 +174,20 @@ Material::Parameter::Parameter(std::string name, eMaterialShaderParamType type,
 }
 
 
+Material::Parameter& Material::Parameter::operator=(const Parameter& rhs) {
+	m_name = rhs.m_name;
+	m_type = rhs.m_type;
+	m_shaderParamIndex = rhs.m_shaderParamIndex;
+	m_data = rhs.m_data;
+	m_set = rhs.m_set;
+	m_optional = rhs.m_optional;
+	if (m_material) {
+		m_material->Touch();
+	}
+	return *this;
+}
+
+
 const std::string& Material::Parameter::GetName() const {
 	return m_name;
 }
@@ -139,6 +210,9 @@ Material::Parameter& Material::Parameter::operator=(Image* image) {
 
 	m_data.image = image;
 	m_set = true;
+	if (m_material) {
+		m_material->Touch();
+	}
 	return *this;
 }
 
@@ -149,6 +223,9 @@ Material::Parameter& Material::Parameter::operator=(Vec4 color) {
 
 	m_data.color = color;
 	m_set = true;
+	if (m_material) {
+		m_material->Touch();
+	}
 	return *this;
 }
 
@@ -159,6 +236,9 @@ Material::Parameter& Material::Parameter::operator=(float value) {
 
 	m_data.value = value;
 	m_set = true;
+	if (m_material) {
+		m_material->Touch();
+	}
 	return *this;
 }
 
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <InlineMath.hpp>
-#include <vector>
+
+#include <cstdint>
+#include <cstring>
 #include <unordered_map>
+#include <vector>
 
 
 namespace inl::gxeng {
@@ -26,6 +29,9 @@ public:
 	public:
 		Parameter();
 		Parameter(std::string name, eMaterialShaderParamType type, int shaderParamIndex, bool optional);
+		Parameter(const Parameter&) = default;
+		/// <summary> Copies the value, the parameter stays part of its own material. </summary>
+		Parameter& operator=(const Parameter& rhs);
 
 		const std::string& GetName() const;
 		eMaterialShaderParamType GetType() const;
@@ -42,6 +48,8 @@ public:
 		bool IsSet() const { return m_set; }
 		bool IsOptional() const { return m_optional; }
 	private:
+		friend class Material;
+		Material* m_material = nullptr; // Its version is bumped on assignment.
 		std::string m_name;
 		eMaterialShaderParamType m_type;
 		int m_shaderParamIndex;
@@ -58,6 +66,12 @@ public:
 	};
 
 public:
+	Material();
+	Material(const Material& rhs);
+	Material(Material&& rhs) noexcept;
+	Material& operator=(const Material& rhs);
+	Material& operator=(Material&& rhs) noexcept;
+
 	void SetShader(const MaterialShader* shader);
 	const MaterialShader* GetShader() const;
 	size_t GetParameterCount() const;
@@ -67,10 +81,19 @@ public:
 
 	Parameter& operator[](const std::string& name);
 	const Parameter& operator[](const std::string& name) const;
+
+	/// <summary> Changes whenever the shader or a parameter is set. </summary>
+	/// <remarks> Versions are unique across all materials, a new material never has the version of a destroyed one,
+	///		so renderers can cache data derived from the parameters by material and version. </remarks>
+	uint64_t GetVersion() const { return m_version; }
+private:
+	void Relink();
+	void Touch();
 private:
 	std::vector<Parameter> m_parameters;
 	const MaterialShader* m_shader = nullptr;
 	std::unordered_map<std::string, size_t> m_paramNameMap; // maps parameter names to indices
+	uint64_t m_version;
 };
 
 
@@ -4,8 +4,10 @@
 #include <BaseLibrary/StringUtil.hpp>
 #include <BaseLibrary/Range.hpp>
 #include <BaseLibrary/GraphEditor/GraphParser.hpp>
+#include <BaseLibrary/Serialization/BinaryStream.hpp>
 
 #include <regex>
+#include <sstream>
 #include <utility>
 #include <lemon/list_graph.h>
 #include <lemon/connectivity.h>
@@ -378,6 +380,12 @@ const std::string& MaterialShaderGraph::GetShaderCode() const {
 void MaterialShaderGraph::SetGraph(std::vector<std::unique_ptr<MaterialShader>> nodes) {
 	using namespace lemon;
 
+	// Materials often share their graphs, those are only generated once.
+	std::string generationInputs = GetGenerationInputs(nodes);
+	if (auto generated = m_shaderManager->FindGeneratedCode(generationInputs); generated && LoadGenerated(*generated)) {
+		return;
+	}
+
 	// Algorithm:
 
 	// 1. create dependency graph of nodes
@@ -521,12 +529,9 @@ void MaterialShaderGraph::SetGraph(std::vector<std::unique_ptr<MaterialShader>>
 	// - code duplication might further be helped by handling nested duplication (graph of shader graphs)
 
 	// Create source code and ports.
-	m_sourceCode = concatCode + mainss.str();
 	CreatePorts(freeInputs, freeOutputs);
-	std::stringstream ss;
-	ss << "graphclass_" << std::hex << std::hash<std::string>()(m_sourceCode);
-	SetClassName(ss.str());
-	RecalcId();
+	SetGeneratedCode(concatCode + mainss.str());
+	m_shaderManager->StoreGeneratedCode(generationInputs, SaveGenerated());
 }
 
 
@@ -537,6 +542,12 @@ void MaterialShaderGraph::SetGraph(std::string jsonDescription) {
 	// Parse JSON.
 	parser.Parse(jsonDescription);
 
+	// Parsing the functions of the nodes is skipped as well when the graph was generated before.
+	std::string generationInputs = GetGenerationInputs(parser);
+	if (auto generated = m_shaderManager->FindGeneratedCode(generationInputs); generated && LoadGenerated(*generated)) {
+		return;
+	}
+
 	// Create nodes with initial values.
 	for (auto& nodeDesc : parser.GetNodes()) {
 		auto nodeObject = std::make_unique<MaterialShaderEquation>(m_shaderManager);
@@ -570,6 +581,136 @@ void MaterialShaderGraph::SetGraph(std::string jsonDescription) {
 	}
 
 	SetGraph(std::move(nodeObjects));
+	m_shaderManager->StoreGeneratedCode(generationInputs, SaveGenerated());
+}
+
+
+std::string MaterialShaderGraph::GetGenerationInputs(const std::vector<std::unique_ptr<MaterialShader>>& nodes) {
+	std::unordered_map<const MaterialShader*, size_t> indices;
+	for (auto i : Range(nodes.size())) {
+		indices[nodes[i].get()] = i;
+	}
+
+	std::stringstream ss;
+	BinaryStreamWriter writer(ss);
+	writer.WriteString("graph");
+	writer.WriteVarint(nodes.size());
+	for (auto& node : nodes) {
+		writer.WriteString(node->GetShaderCode());
+		writer.WriteString(node->GetDisplayName());
+		writer.WriteVarint(node->GetNumInputs());
+		for (auto i : Range(node->GetNumInputs())) {
+			const MaterialShaderInput* input = node->GetInput(i);
+			const MaterialShaderOutput* link = input->GetLink();
+			auto it = link ? indices.find(link->GetParent()) : indices.end();
+			writer.WriteBool(it != indices.end());
+			if (it != indices.end()) {
+				writer.WriteVarint(it->second);
+				writer.WriteString(link->name);
+			}
+			else {
+				writer.WriteString(input->GetDefaultValue());
+			}
+		}
+	}
+	return ss.str();
+}
+
+
+std::string MaterialShaderGraph::GetGenerationInputs(const GraphParser& parser) const {
+	auto WriteOptional = [](BinaryStreamWriter& writer, const auto& value, auto write) {
+		writer.WriteBool(value.has_value());
+		if (value) {
+			write(*value);
+		}
+	};
+
+	// Node ids and editor metadata don't affect the code, nodes are identified by their index.
+	std::stringstream ss;
+	BinaryStreamWriter writer(ss);
+	writer.WriteString("json");
+	writer.WriteVarint(parser.GetNodes().size());
+	for (auto& nodeDesc : parser.GetNodes()) {
+		writer.WriteString(nodeDesc.cl);
+		writer.WriteString(m_shaderManager->LoadShaderSource(nodeDesc.cl));
+		WriteOptional(writer, nodeDesc.name, [&](const std::string& name) { writer.WriteString(name); });
+	}
+	writer.WriteVarint(parser.GetLinks().size());
+	for (auto& info : parser.GetLinks()) {
+		writer.WriteVarint(parser.FindNode(info.srcid, info.srcname));
+		writer.WriteVarint(parser.FindNode(info.dstid, info.dstname));
+		WriteOptional(writer, info.srcpidx, [&](int index) { writer.WriteVarintSigned(index); });
+		WriteOptional(writer, info.srcpname, [&](const std::string& name) { writer.WriteString(name); });
+		WriteOptional(writer, info.dstpidx, [&](int index) { writer.WriteVarintSigned(index); });
+		WriteOptional(writer, info.dstpname, [&](const std::string& name) { writer.WriteString(name); });
+	}
+	return ss.str();
+}
+
+
+std::string MaterialShaderGraph::SaveGenerated() const {
+	std::stringstream ss;
+	BinaryStreamWriter writer(ss);
+	writer.WriteString(m_sourceCode);
+	writer.WriteVarint(m_inputs.size());
+	for (auto& input : m_inputs) {
+		writer.WriteString(input.name);
+		writer.WriteString(input.type);
+		writer.WriteString(input.GetDefaultValue());
+	}
+	writer.WriteVarint(m_outputs.size());
+	for (auto& output : m_outputs) {
+		writer.WriteString(output.name);
+		writer.WriteString(output.type);
+	}
+	return ss.str();
+}
+
+
+bool MaterialShaderGraph::LoadGenerated(const std::string& data) {
+	std::string code;
+	std::vector<MaterialShaderInput> inputs;
+	std::vector<MaterialShaderOutput> outputs;
+
+	// Damaged cache files are generated again.
+	try {
+		BinaryStreamReader reader(data.data(), data.size());
+		code = reader.ReadString();
+		int idx = 0;
+		size_t numInputs = reader.ReadVarint();
+		for (size_t i = 0; i < numInputs; ++i) {
+			std::string name = reader.ReadString();
+			std::string type = reader.ReadString();
+			std::string defaultValue = reader.ReadString();
+			inputs.push_back({ *this, std::move(name), std::move(type), idx++, std::move(defaultValue) });
+		}
+		size_t numOutputs = reader.ReadVarint();
+		for (size_t i = 0; i < numOutputs; ++i) {
+			std::string name = reader.ReadString();
+			std::string type = reader.ReadString();
+			outputs.push_back({ *this, std::move(name), std::move(type), idx++ });
+		}
+		if (!reader.IsEnd()) {
+			return false;
+		}
+	}
+	catch (Exception&) {
+		return false;
+	}
+
+	m_inputs = std::move(inputs);
+	m_outputs = std::move(outputs);
+	SetGeneratedCode(std::move(code));
+	return true;
+}
+
+
+void MaterialShaderGraph::SetGeneratedCode(std::string code) {
+	m_sourceCode = std::move(code);
+	std::stringstream ss;
+	ss << "graphclass_" << std::hex << std::hash<std::string>()(m_sourceCode);
+	SetClassName(ss.str());
+	RecalcId();
 }
 
 
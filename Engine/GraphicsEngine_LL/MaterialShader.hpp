@@ -23,6 +23,11 @@
 #undef GetClassName
 
 
+namespace inl {
+class GraphParser;
+} // namespace inl
+
+
 namespace inl::gxeng {
 
 
@@ -183,11 +188,24 @@ public:
 
 	const std::string& GetShaderCode() const override;
 
+	/// <summary> Generates the code of the graph, or reuses the code generated for an identical graph. </summary>
+	/// <remarks> Graphs are identical if the code and display name of their nodes and their links match.
+	///		Generated code is kept by the shader manager, and in its disk cache if enabled. </remarks>
 	void SetGraph(std::vector<std::unique_ptr<MaterialShader>> nodes);
 
 	/// <summary> Cannot handle nested graphs. </summary>
+	/// <remarks> The nodes are not created if an identical graph was generated before. </remarks>
 	void SetGraph(std::string jsonDescription);
 private:
+	// Everything that the generated code depends on, used as the key of the generated code cache.
+	static std::string GetGenerationInputs(const std::vector<std::unique_ptr<MaterialShader>>& nodes);
+	std::string GetGenerationInputs(const GraphParser& parser) const;
+
+	// Generated code and ports, as stored in the generated code cache.
+	std::string SaveGenerated() const;
+	bool LoadGenerated(const std::string& data);
+	void SetGeneratedCode(std::string code);
+
 	// Creates one graph node per shader node, adds arc in graph for any two shader nodes which have their ports linked together.
 	static void CalculateDependencyGraph(const std::vector<std::unique_ptr<MaterialShader>>& nodes,
 										 lemon::ListDigraph& depGraph,
@@ -19,7 +19,10 @@ MemoryManager::MemoryManager(gxapi::IGraphicsApi* graphicsApi) :
 	m_graphicsApi(graphicsApi),
 	m_criticalHeap(graphicsApi),
 	m_uploadHeap(graphicsApi),
-	m_constBufferHeap(graphicsApi)
+	m_readbackManager(graphicsApi),
+	m_constBufferHeap(graphicsApi),
+	m_dynamicBufferRing(graphicsApi),
+	m_residencyManager(graphicsApi)
 {}
 
 
@@ -36,14 +39,49 @@ void MemoryManager::UnlockResident(const std::vector<MemoryObject>& resources) {
 }
 
 
+ResidencyManager& MemoryManager::GetResidencyManager() {
+	return m_residencyManager;
+}
+
+const ResidencyManager& MemoryManager::GetResidencyManager() const {
+	return m_residencyManager;
+}
+
+
+TextureStreamer& MemoryManager::GetTextureStreamer() {
+	return m_textureStreamer;
+}
+
+
 UploadManager& MemoryManager::GetUploadManager() {
 	return m_uploadHeap;
 }
 
+ReadbackManager& MemoryManager::GetReadbackManager() {
+	return m_readbackManager;
+}
+
+ResourceIndexRegistry& MemoryManager::GetResourceIndexRegistry() {
+	return m_resourceIndexRegistry;
+}
+
 ConstantBufferHeap & MemoryManager::GetConstBufferHeap() {
 	return m_constBufferHeap;
 }
 
+DynamicBufferRing& MemoryManager::GetDynamicBufferRing() {
+	return m_dynamicBufferRing;
+}
+
+
+jobs::Scheduler* MemoryManager::GetJobScheduler() const {
+	return m_jobScheduler;
+}
+
+void MemoryManager::SetJobScheduler(jobs::Scheduler* scheduler) {
+	m_jobScheduler = scheduler;
+}
+
 
 VolatileConstBuffer MemoryManager::CreateVolatileConstBuffer(const void* data, uint32_t size) {
 	return m_constBufferHeap.CreateVolatileConstBuffer(data, size);
@@ -55,6 +93,11 @@ PersistentConstBuffer MemoryManager::CreatePersistentConstBuffer(const void * da
 }
 
 
+LinearBuffer MemoryManager::CreateBuffer(eResourceHeap heap, size_t size, gxapi::eResourceFlags flags) {
+	return GetHeap(heap).CreateBuffer(size, flags);
+}
+
+
 VertexBuffer MemoryManager::CreateVertexBuffer(eResourceHeap heap, size_t size) {
 	return GetHeap(heap).CreateVertexBuffer(size);
 }
@@ -80,6 +123,24 @@ Texture3D MemoryManager::CreateTexture3D(eResourceHeap heap, const Texture3DDesc
 }
 
 
+ReadbackBuffer MemoryManager::CreateReadbackBuffer(size_t size) {
+	MemoryObject::UniquePtr resource{
+		m_graphicsApi->CreateCommittedResource(
+			gxapi::HeapProperties(gxapi::eHeapType::READBACK),
+			gxapi::eHeapFlags::NONE,
+			gxapi::ResourceDesc::Buffer(size),
+			// COPY_DEST is the required state for readback heap resources, they can't be transitioned.
+			gxapi::eResourceState::COPY_DEST
+		),
+		std::default_delete<const gxapi::IResource>()
+	};
+
+	ReadbackBuffer buffer{ std::move(resource), true, eResourceHeap::READBACK };
+	buffer.RecordState(gxapi::eResourceState::COPY_DEST);
+	return buffer;
+}
+
+
 BufferHeap& MemoryManager::GetHeap(eResourceHeap heap) {
 	switch (heap) {
 		case eResourceHeap::UPLOAD: throw NotImplementedException("Memory heap not implemented yet.");
@@ -4,18 +4,27 @@
 #include "MemoryObject.hpp"
 #include "CriticalBufferHeap.hpp"
 #include "UploadManager.hpp"
+#include "ReadbackManager.hpp"
+#include "ResourceStateTracker.hpp"
 #include "ConstBufferHeap.hpp"
+#include "DynamicBufferRing.hpp"
+#include "ResidencyManager.hpp"
+#include "TextureStreamer.hpp"
 
 #include "../GraphicsApi_LL/Common.hpp"
-#include "../GraphicsApi_D3D12/DescriptorHeap.hpp"
-#include "../GraphicsApi_D3D12/GraphicsApi.hpp"
+#include "../GraphicsApi_LL/IDescriptorHeap.hpp"
+#include "../GraphicsApi_LL/IGraphicsApi.hpp"
 
 #include <iostream>
-#include <unordered_set>
 #include <mutex>
 #include <cassert>
 #include <type_traits>
 
+
+namespace inl::jobs {
+class Scheduler;
+} // namespace inl::jobs
+
 namespace inl {
 namespace gxeng {
 
@@ -67,33 +76,48 @@ public:
 	MemoryManager(gxapi::IGraphicsApi* graphicsApi);
 
 	/// <summary>
-	/// Makes given resources resident.
+	/// Makes given resources resident, evicting the least recently used unlocked ones if needed.
 	/// </summary>
 	/// <exception cref="inl::gxapi::OutOfMemoryException">
 	/// If there is not enough free memory in the resource's appropriate
-	/// memory pool for the resource to fit in.
+	/// memory pool for the resource to fit in, even after evicting all unlocked resources.
 	/// </exception>
 	void LockResident(const std::vector<MemoryObject>& resources);
 	template<typename IterT>
 	void LockResident(IterT begin, IterT end);
 
 	/// <summary>
-	/// WRITE A DESCRIPTION
+	/// Allows given resources to be evicted once they are not locked by anyone else.
 	/// </summary>
 	void UnlockResident(const std::vector<MemoryObject>& resources);
 	template<typename IterT>
 	void UnlockResident(IterT begin, IterT end);
 
+	ResidencyManager& GetResidencyManager();
+	const ResidencyManager& GetResidencyManager() const;
+	TextureStreamer& GetTextureStreamer();
 	UploadManager& GetUploadManager();
+	/// <summary> Copies GPU results to the CPU at the end of frames, see <see cref="RenderContext::RequestReadback"/>. </summary>
+	ReadbackManager& GetReadbackManager();
+	/// <summary> Indexes the resources of the frame for the state tracking of command lists. </summary>
+	ResourceIndexRegistry& GetResourceIndexRegistry();
 	ConstantBufferHeap& GetConstBufferHeap();
+	/// <summary> Upload heap ring for vertices and indices that live for one frame, see <see cref="RenderContext::AllocateTransientVertices"/>. </summary>
+	DynamicBufferRing& GetDynamicBufferRing();
+	/// <summary> Helper jobs of resource loading come from here, such as converting the pixels of images. May be null. </summary>
+	jobs::Scheduler* GetJobScheduler() const;
+	void SetJobScheduler(jobs::Scheduler* scheduler);
 	VolatileConstBuffer CreateVolatileConstBuffer(const void* data, uint32_t size);
 	PersistentConstBuffer CreatePersistentConstBuffer(const void* data, uint32_t size);
 
+	LinearBuffer CreateBuffer(eResourceHeap heap, size_t size, gxapi::eResourceFlags flags = gxapi::eResourceFlags::NONE);
 	VertexBuffer CreateVertexBuffer(eResourceHeap heap, size_t size);
 	IndexBuffer CreateIndexBuffer(eResourceHeap heap, size_t size, size_t indexCount);
 	Texture1D CreateTexture1D(eResourceHeap heap, const Texture1DDesc& desc, gxapi::eResourceFlags flags = gxapi::eResourceFlags::NONE);
 	Texture2D CreateTexture2D(eResourceHeap heap, const Texture2DDesc& desc, gxapi::eResourceFlags flags = gxapi::eResourceFlags::NONE);
 	Texture3D CreateTexture3D(eResourceHeap heap, const Texture3DDesc& desc, gxapi::eResourceFlags flags = gxapi::eResourceFlags::NONE);
+	/// <summary> Creates a committed buffer on the readback heap. </summary>
+	ReadbackBuffer CreateReadbackBuffer(size_t size);
 
 private:
 	BufferHeap& GetHeap(eResourceHeap heap);
@@ -104,74 +128,29 @@ private:
 	impl::CriticalBufferHeap m_criticalHeap;
 
 	UploadManager m_uploadHeap;
+	ReadbackManager m_readbackManager;
+	ResourceIndexRegistry m_resourceIndexRegistry;
 	ConstantBufferHeap m_constBufferHeap;
+	DynamicBufferRing m_dynamicBufferRing;
+
+	ResidencyManager m_residencyManager;
+	TextureStreamer m_textureStreamer;
 
-	std::mutex m_evictablesMtx;
-	std::unordered_set<MemoryObject> m_evictables;
+	jobs::Scheduler* m_jobScheduler = nullptr;
 };
 
 
 template<typename IterT>
 void MemoryManager::LockResident(IterT begin, IterT end) {
 	static_assert(std::is_same<typename IterT::value_type, MemoryObject>::value);
-
-	std::vector<gxapi::IResource*> lowLevelTargets;
-	std::vector<MemoryObject> highLevelTargets;
-
-	{
-		std::lock_guard<std::mutex> lock(m_evictablesMtx);
-
-		IterT currIter = begin;
-		while (currIter != end) {
-			auto& curr = *(currIter++);
-			auto currEvictableIter = m_evictables.find(curr);
-			bool evictable = currEvictableIter != m_evictables.end();
-			if (evictable) {
-				assert(curr._GetResident());
-				m_evictables.erase(currEvictableIter);
-			}
-			else {
-				if (curr._GetResident() == false) {
-					lowLevelTargets.push_back(curr._GetResourcePtr());
-					highLevelTargets.push_back(curr);
-				}
-			}
-		}
-
-		try {
-			m_graphicsApi->MakeResident(lowLevelTargets);
-		}
-		catch (OutOfMemoryException&) {
-			std::vector<gxapi::IResource*> toEvict;
-			toEvict.reserve(m_evictables.size());
-			for (auto& curr : m_evictables) {
-				// NOTE I'm not sure why 'curr' is a const reference. I had to add a const cast.
-				toEvict.push_back(const_cast<gxapi::IResource*>(curr._GetResourcePtr()));
-			}
-			m_graphicsApi->Evict(toEvict);
-			m_evictables.clear();
-
-			m_graphicsApi->MakeResident(lowLevelTargets);
-		}
-	}
-
-	assert(lowLevelTargets.size() == highLevelTargets.size());
-	for (size_t i = 0; i < highLevelTargets.size(); i++) {
-		auto currLowlevel = lowLevelTargets[i];
-		auto& currHighLevel = highLevelTargets[i];
-		assert(currHighLevel._GetResourcePtr() == currLowlevel);
-
-		currHighLevel._SetResident(true);
-	}
+	m_residencyManager.Lock(std::vector<MemoryObject>(begin, end));
 }
 
 
 template<typename IterT>
 void MemoryManager::UnlockResident(IterT begin, IterT end) {
 	static_assert(std::is_same<typename IterT::value_type, MemoryObject>::value);
-
-	std::lock_guard<std::mutex> lock(m_evictablesMtx);
-	m_evictables.insert(begin, end);
+	m_residencyManager.Unlock(std::vector<MemoryObject>(begin, end));
 }
 
 } // namespace gxeng
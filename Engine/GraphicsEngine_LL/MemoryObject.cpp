@@ -2,8 +2,7 @@
 
 #include "../GraphicsApi_LL/ICommandList.hpp"
 #include "../GraphicsApi_LL/Exception.hpp"
-#include "../GraphicsApi_D3D12/Resource.hpp"
-#include "../GraphicsApi_D3D12/NativeCast.hpp"
+#include "../GraphicsApi_LL/IResource.hpp"
 
 #include "MemoryManager.hpp"
 #include "CriticalBufferHeap.hpp"
@@ -24,6 +23,20 @@ MemoryObject::MemoryObject(UniquePtr resource, bool resident, eResourceHeap heap
 }
 
 
+MemoryObject::MemoryObject(const MemoryObject& buffer, uint64_t offset, uint64_t size, std::function<void()> release) {
+	assert(buffer.m_contents && !buffer._IsSubAllocation());
+	assert(buffer.GetDescription().type == eResourceType::BUFFER);
+
+	// The range does not own the resource, deleting it only gives the range back.
+	UniquePtr resource{ buffer._GetResourcePtr(), [release = std::move(release)](const gxapi::IResource*) { release(); } };
+	m_contents = std::make_shared<Contents>(std::move(resource), true, buffer.GetHeap());
+	m_contents->pageable = false;
+	m_contents->parent = buffer.m_contents;
+	m_contents->offset = offset;
+	m_contents->size = size;
+}
+
+
 bool MemoryObject::operator==(const MemoryObject& other) const {
 	return PtrEqual(*this, other);
 }
@@ -31,13 +44,17 @@ bool MemoryObject::operator==(const MemoryObject& other) const {
 
 void* MemoryObject::GetVirtualAddress() const {
 	assert(m_contents);
-	return m_contents->resource->GetGPUAddress();
+	return static_cast<uint8_t*>(m_contents->resource->GetGPUAddress()) + m_contents->offset;
 }
 
 
 gxapi::ResourceDesc MemoryObject::GetDescription() const {
 	assert(m_contents);
-	return m_contents->resource->GetDesc();
+	gxapi::ResourceDesc desc = m_contents->resource->GetDesc();
+	if (m_contents->parent) {
+		desc.bufferDesc.sizeInBytes = m_contents->size;
+	}
+	return desc;
 }
 
 
@@ -46,7 +63,10 @@ void MemoryObject::SetName(const std::string& name) {
 }
 void MemoryObject::SetName(const char* name) {
 	if (m_contents) {
-		m_contents->resource->SetName(name);
+		// Suballocations would rename the shared buffer.
+		if (!m_contents->parent) {
+			m_contents->resource->SetName(name);
+		}
 		m_contents->name = name;
 	}
 }
@@ -63,6 +83,23 @@ bool MemoryObject::_GetResident() const noexcept {
 	return m_contents->resident;
 }
 
+void MemoryObject::_SetPageable(bool value) noexcept {
+	assert(m_contents);
+	m_contents->pageable = value;
+}
+
+
+bool MemoryObject::_GetPageable() const noexcept {
+	assert(m_contents);
+	return m_contents->pageable;
+}
+
+
+MemoryObject MemoryObject::_GetStateOwner() const {
+	assert(m_contents);
+	return m_contents->parent ? MemoryObject(m_contents->parent) : *this;
+}
+
 gxapi::IResource * MemoryObject::_GetResourcePtr() const noexcept {
 	assert(m_contents);
 	return m_contents->resource.get();
@@ -71,21 +108,27 @@ gxapi::IResource * MemoryObject::_GetResourcePtr() const noexcept {
 
 void MemoryObject::RecordState(unsigned subresource, gxapi::eResourceState newState) {
 	assert(m_contents);
-	assert(subresource < m_contents->subresourceStates.size());
-	m_contents->subresourceStates[subresource] = newState;
+	auto& states = GetStates();
+	assert(subresource < states.size());
+	states[subresource] = newState;
 }
 
 void MemoryObject::RecordState(gxapi::eResourceState newState) {
 	assert(m_contents);
-	for (auto& state : m_contents->subresourceStates) {
+	for (auto& state : GetStates()) {
 		state = newState;
 	}
 }
 
 gxapi::eResourceState MemoryObject::ReadState(unsigned subresource) const {
 	assert(m_contents);
-	assert(subresource < m_contents->subresourceStates.size());
-	return m_contents->subresourceStates[subresource];
+	const auto& states = m_contents->parent ? m_contents->parent->subresourceStates : m_contents->subresourceStates;
+	assert(subresource < states.size());
+	return states[subresource];
+}
+
+std::vector<gxapi::eResourceState>& MemoryObject::GetStates() {
+	return m_contents->parent ? m_contents->parent->subresourceStates : m_contents->subresourceStates;
 }
 
 void MemoryObject::InitResourceStates(gxapi::eResourceState initialState) {
@@ -113,11 +156,26 @@ uint64_t LinearBuffer::GetSize() const {
 	return GetDescription().bufferDesc.sizeInBytes;
 }
 
+const void* ReadbackBuffer::Map() const {
+	gxapi::MemoryRange readRange{ 0, size_t(GetSize()) };
+	return _GetResourcePtr()->Map(0, &readRange);
+}
+
+void ReadbackBuffer::Unmap() const {
+	gxapi::MemoryRange noWriteRange{ 0, 0 };
+	_GetResourcePtr()->Unmap(0, &noWriteRange);
+}
+
 IndexBuffer::IndexBuffer(UniquePtr resource, bool resident, eResourceHeap heap, size_t indexCount) :
 	LinearBuffer(std::move(resource), resident, heap),
 	m_indexCount(indexCount)
 {}
 
+IndexBuffer::IndexBuffer(const MemoryObject& buffer, uint64_t offset, uint64_t size, std::function<void()> release, size_t indexCount) :
+	LinearBuffer(buffer, offset, size, std::move(release)),
+	m_indexCount(indexCount)
+{}
+
 
 size_t IndexBuffer::GetIndexCount() const {
 	return m_indexCount;
@@ -191,6 +249,10 @@ uint16_t Texture2D::GetArrayCount() const {
 	return m_contents->resource->GetNumArrayLevels();
 }
 
+unsigned Texture2D::GetMipLevelCount() const {
+	return m_contents->resource->GetNumMipLevels();
+}
+
 uint32_t Texture2D::GetSubresourceIndex(uint32_t mipLevel, uint32_t arrayIndex, uint32_t planeIndex) const {
 	return m_contents->resource->GetSubresourceIndex(mipLevel, arrayIndex, planeIndex);
 }
@@ -5,6 +5,7 @@
 #include "../GraphicsApi_LL/IGraphicsApi.hpp"
 #include "../GraphicsApi_LL/IResource.hpp"
 
+#include <atomic>
 #include <functional>
 #include <cassert>
 #include <string>
@@ -23,6 +24,7 @@ enum class eResourceHeap {
 	PIPELINE,
 	CRITICAL,
 	BACKBUFFER,
+	READBACK,
 	INVALID,
 };
 
@@ -30,6 +32,8 @@ enum class eResourceHeap {
 class MemoryObject {
 public:
 	friend struct std::hash<MemoryObject>;
+	friend class ResidencyManager;
+	friend class ResourceIndexRegistry;
 
 	using UniquePtr = std::unique_ptr<gxapi::IResource, std::function<void(const gxapi::IResource*)>>;
 public:
@@ -40,6 +44,9 @@ public:
 public:
 	MemoryObject() = default;
 	MemoryObject(UniquePtr resource, bool resident, eResourceHeap heap);
+	/// <summary> Creates an object for a range of a buffer shared with other objects. </summary>
+	/// <param name="release"> Called when the last copy of this object goes away, should free the range. </param>
+	MemoryObject(const MemoryObject& buffer, uint64_t offset, uint64_t size, std::function<void()> release);
 	virtual ~MemoryObject() = default;
 
 	MemoryObject(const MemoryObject&) = default;
@@ -103,10 +110,24 @@ public:
 	void _SetResident(bool value) noexcept;
 	bool _GetResident() const noexcept;
 
+	/// <summary> False if the resource cannot be made resident or evicted on its own, like placed resources. </summary>
+	void _SetPageable(bool value) noexcept;
+	bool _GetPageable() const noexcept;
+
 	gxapi::IResource* _GetResourcePtr() const noexcept;
 
+	/// <summary> True if this object is a range of a buffer shared with other objects. </summary>
+	bool _IsSubAllocation() const noexcept { return (bool)m_contents->parent; }
+	/// <summary> The offset of this object's range within <see cref="_GetResourcePtr"/>, zero unless suballocated. </summary>
+	uint64_t _GetOffset() const noexcept { return m_contents->offset; }
+	/// <summary> The object whose resource states command lists have to track.
+	///		That's the shared buffer for suballocations, since they share its states, and the object itself otherwise. </summary>
+	MemoryObject _GetStateOwner() const;
+
 protected:
 	void InitResourceStates(gxapi::eResourceState initialState);
+	/// <summary> Suballocations share the states of their buffer. </summary>
+	std::vector<gxapi::eResourceState>& GetStates();
 
 	struct Contents {
 		Contents() = default;
@@ -116,7 +137,14 @@ protected:
 		eResourceHeap heap;
 		std::vector<gxapi::eResourceState> subresourceStates;
 		std::string name;
+		bool pageable = true;
+		std::shared_ptr<Contents> parent; // The shared buffer of suballocations.
+		uint64_t offset = 0;
+		uint64_t size = 0; // Of suballocations only, the others take it from the resource.
+		std::atomic_uint64_t frameIndex{ 0 }; // Frame in the high, index in the low half, see ResourceIndexRegistry.
 	};
+	explicit MemoryObject(std::shared_ptr<Contents> contents) : m_contents(std::move(contents)) {}
+
 	std::shared_ptr<Contents> m_contents;
 };
 
@@ -139,10 +167,23 @@ public:
 };
 
 
+/// <summary> Buffer in CPU readable memory that the GPU copies results into. </summary>
+/// <remarks> Always stays in COPY_DEST state. Only map it after the GPU has finished the copies. </remarks>
+class ReadbackBuffer : public LinearBuffer {
+public:
+	using LinearBuffer::LinearBuffer;
+
+	/// <summary> Returns a pointer to the contents for reading. </summary>
+	const void* Map() const;
+	void Unmap() const;
+};
+
+
 class IndexBuffer : public LinearBuffer {
 public:
 	IndexBuffer() : m_indexCount(0) {}
 	IndexBuffer(UniquePtr resource, bool resident, eResourceHeap heap, size_t indexCount);
+	IndexBuffer(const MemoryObject& buffer, uint64_t offset, uint64_t size, std::function<void()> release, size_t indexCount);
 
 	size_t GetIndexCount() const;
 
@@ -215,6 +256,8 @@ public:
 	uint64_t GetWidth() const;
 	uint32_t GetHeight() const;
 	uint16_t GetArrayCount() const;
+	/// <summary> Zero if the texture was created with a full mip chain. </summary>
+	unsigned GetMipLevelCount() const;
 	uint32_t GetSubresourceIndex(uint32_t mipLevel, uint32_t arrayIndex, uint32_t planeIndex) const;
 	gxapi::eFormat GetFormat() const;
 };
@@ -2,6 +2,10 @@
 //#include "VertexElementCompressor.hpp"
 #include "VertexCompressor.hpp"
 #include <BaseLibrary/ArrayView.hpp>
+#include <BaseLibrary/JobSystem/Parallel.hpp>
+
+#include <algorithm>
+#include <cassert>
 
 
 
@@ -9,16 +13,23 @@ namespace inl {
 namespace gxeng {
 
 
+static constexpr size_t CompressChunkSize = 16384; // Vertices per job when packing.
+
 
 void Mesh::Set(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices, const unsigned* indices, size_t numIndices) {
 	// Create constants
 	auto& elements = vertexReader->GetElements();
 	std::vector<bool> elementMap(elements.size(), true);
 
+	BoundingBox localBounds;
+	ExtendBounds(localBounds, vertices, vertexReader, numVertices);
+	PositionQuantization positionQuantization = PositionQuantization::FromBounds(localBounds);
+
 	// Compress vertices
-	VertexCompressor compressor{ vertexReader, elementMap };
+	VertexCompressor compressor{ vertexReader, elementMap, positionQuantization };
 	std::vector<uint8_t> compressedData = compressor.GetCompressedStream(vertices, numVertices);
 	auto offsets = compressor.GetCompressedOffsets();
+	auto formats = compressor.GetCompressedFormats();
 
 	// Set data
 	VertexStream stream;
@@ -32,33 +43,87 @@ void Mesh::Set(const VertexBase* vertices, const IVertexReader* vertexReader, si
 	layout.clear();
 	std::vector<Element> streamElements;
 	for (size_t i = 0; i < elements.size(); ++i) {
-		streamElements.push_back(Element{ elements[i].semantic, elements[i].index, offsets[i] });
+		streamElements.push_back(Element{ elements[i].semantic, elements[i].index, offsets[i], formats[i] });
 	}
 	layout.push_back(streamElements);
 
 	// Calculate hashes
 	m_layout = Layout(layout);
+
+	m_localBounds = localBounds;
+	m_positionQuantization = positionQuantization;
+	m_compressor = std::move(compressor);
+
+	m_lods = { Lod{ 0, uint32_t(numIndices) } };
+}
+
+
+void Mesh::Set(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices, const std::vector<std::vector<unsigned>>& lodIndices) {
+	std::vector<uint8_t> storage;
+	SetPacked(Pack(vertices, vertexReader, numVertices, lodIndices, storage));
+}
+
+
+void Mesh::SetPacked(const PackedData& data) {
+	MeshBuffer::SetPacked(data.streams.data(), data.streams.data() + data.streams.size(), data.indices, data.numIndices, data.is32BitIndex);
+
+	m_layout = Layout(data.layout);
+	m_localBounds = data.localBounds;
+	m_positionQuantization = data.positionQuantization;
+	m_compressor.reset();
+	m_lods = data.lods;
+	m_meshlets = data.meshlets;
+	if (m_lods.empty()) {
+		m_lods = { Lod{ 0, uint32_t(data.numIndices) } };
+	}
 }
 
 
 void Mesh::Update(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices, size_t offsetInVertices) {
-	// Create constants
-	auto& elements = vertexReader->GetElements();
-	std::vector<bool> elementMap(elements.size(), true);
+	// The compressor is made once, in the range of the positions already there.
+	if (!m_compressor || m_compressor->GetReader() != vertexReader) {
+		std::vector<bool> elementMap(vertexReader->GetElements().size(), true);
+		m_compressor.emplace(vertexReader, elementMap, m_positionQuantization);
+	}
+	if (GetNumStreams() > 0 && size_t(m_compressor->GetCompressedStride()) != GetVertexBufferStride(0)) {
+		throw InvalidArgumentException("Vertices must have the layout the mesh was set with.");
+	}
 
-	// Compress vertices
-	VertexCompressor compressor{ vertexReader, elementMap };
-	std::vector<uint8_t> compressedData = compressor.GetCompressedStream(vertices, numVertices);
-	auto offsets = compressor.GetCompressedOffsets();
+	// Compress vertices straight into the upload memory of the range.
+	void* compressedData = MeshBuffer::UpdateInPlace(0, numVertices, offsetInVertices);
+	m_compressor->Compress(vertices, numVertices, compressedData);
 
-	// Update data
-	MeshBuffer::Update(0, compressedData.data(), numVertices, offsetInVertices);
+	// Overwritten vertices are unknown, the box can only grow.
+	ExtendBounds(m_localBounds, vertices, vertexReader, numVertices);
+
+	// The meshlet bounds can't grow the same way, without them the levels are culled whole.
+	m_meshlets.clear();
+	for (auto& lod : m_lods) {
+		lod.firstMeshlet = 0;
+		lod.meshletCount = 0;
+	}
 }
 
 
 void Mesh::Clear() {
 	MeshBuffer::Clear();
 	m_layout.Clear();
+	m_localBounds = BoundingBox();
+	m_positionQuantization = PositionQuantization{};
+	m_compressor.reset();
+	m_lods.clear();
+	m_meshlets.clear();
+}
+
+
+size_t Mesh::GetLodCount() const {
+	return m_lods.size();
+}
+
+
+const Mesh::Lod& Mesh::GetLod(size_t level) const {
+	assert(!m_lods.empty());
+	return m_lods[std::min(level, m_lods.size() - 1)];
 }
 
 
@@ -67,6 +132,138 @@ const Mesh::Layout& Mesh::GetLayout() const {
 }
 
 
+const std::vector<Meshlet>& Mesh::GetMeshlets() const {
+	return m_meshlets;
+}
+
+
+const BoundingBox& Mesh::GetLocalBounds() const {
+	return m_localBounds;
+}
+
+
+Mat44 Mesh::GetPositionDequantization() const {
+	return m_positionQuantization.GetDequantization();
+}
+
+
+Mesh::PackedData Mesh::Pack(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices, const std::vector<std::vector<unsigned>>& lodIndices, std::vector<uint8_t>& storage, jobs::Scheduler* scheduler) {
+	if (lodIndices.empty()) {
+		throw InvalidArgumentException("At least one level of detail is needed.");
+	}
+
+	PackedData packed;
+	ExtendBounds(packed.localBounds, vertices, vertexReader, numVertices);
+	packed.positionQuantization = PositionQuantization::FromBounds(packed.localBounds);
+
+	// Compress vertices
+	auto& elements = vertexReader->GetElements();
+	std::vector<bool> elementMap(elements.size(), true);
+	VertexCompressor compressor{ vertexReader, elementMap, packed.positionQuantization };
+	const size_t compressedStride = compressor.GetCompressedStride();
+	const uint8_t* source = reinterpret_cast<const uint8_t*>(vertices);
+	storage.resize(numVertices * compressedStride);
+	jobs::CooperativeFor(scheduler, numVertices, CompressChunkSize, [&](size_t first, size_t last) {
+		compressor.Compress(reinterpret_cast<const VertexBase*>(source + first * vertexReader->GetStride()), last - first, storage.data() + first * compressedStride);
+	});
+	auto offsets = compressor.GetCompressedOffsets();
+	auto formats = compressor.GetCompressedFormats();
+
+	std::vector<Element> streamElements;
+	for (size_t i = 0; i < elements.size(); ++i) {
+		streamElements.push_back(Element{ elements[i].semantic, elements[i].index, offsets[i], formats[i] });
+	}
+	packed.layout.push_back(streamElements);
+
+	// Levels of detail go one after the other into the same index buffer, same width rule as MeshBuffer.
+	packed.is32BitIndex = numVertices > 0xFFFFu;
+	for (const auto& level : lodIndices) {
+		if (level.size() % 3 != 0) {
+			throw InvalidArgumentException("Index count not divisible by 3. Must be triangles.");
+		}
+		packed.lods.push_back(Lod{ uint32_t(packed.numIndices), uint32_t(level.size()) });
+		packed.numIndices += level.size();
+	}
+
+	size_t vertexBytes = (storage.size() + 3) / 4 * 4; // Indices are aligned after the vertices.
+	size_t indexStride = packed.is32BitIndex ? sizeof(uint32_t) : sizeof(uint16_t);
+	storage.resize(vertexBytes + packed.numIndices * indexStride);
+	uint8_t* indexData = storage.data() + vertexBytes;
+	size_t i = 0;
+	for (const auto& level : lodIndices) {
+		for (unsigned index : level) {
+			if (index >= numVertices) {
+				throw InvalidArgumentException("Indices over-index the vertex buffers.");
+			}
+			if (packed.is32BitIndex) {
+				reinterpret_cast<uint32_t*>(indexData)[i++] = uint32_t(index);
+			}
+			else {
+				reinterpret_cast<uint16_t*>(indexData)[i++] = uint16_t(index);
+			}
+		}
+	}
+
+	// Meshlets of each level, in the order of the levels.
+	const std::vector<Vec3> positions = ReadPositions(vertices, vertexReader, numVertices);
+	if (!positions.empty()) {
+		std::vector<std::vector<Meshlet>> lodMeshlets(lodIndices.size());
+		jobs::CooperativeFor(scheduler, lodIndices.size(), 1, [&](size_t first, size_t last) {
+			for (size_t level = first; level < last; ++level) {
+				lodMeshlets[level] = MeshOptimizer::BuildMeshlets(lodIndices[level], positions, packed.lods[level].firstIndex);
+			}
+		});
+		for (size_t level = 0; level < lodIndices.size(); ++level) {
+			packed.lods[level].firstMeshlet = uint32_t(packed.meshlets.size());
+			packed.lods[level].meshletCount = uint32_t(lodMeshlets[level].size());
+			packed.meshlets.insert(packed.meshlets.end(), lodMeshlets[level].begin(), lodMeshlets[level].end());
+		}
+	}
+
+	packed.streams.push_back(VertexStream{ storage.data(), uint32_t(compressor.GetCompressedStride()), numVertices });
+	packed.indices = indexData;
+
+	return packed;
+}
+
+
+std::vector<Vec3> Mesh::ReadPositions(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices) {
+	auto& elements = vertexReader->GetElements();
+	bool hasPosition = std::any_of(elements.begin(), elements.end(), [](const IVertexReader::Element& element) {
+		return element.semantic == eVertexElementSemantic::POSITION && element.index == 0;
+	});
+	if (!hasPosition) {
+		return {};
+	}
+
+	std::vector<Vec3> positions;
+	positions.reserve(numVertices);
+	ArrayView<const VertexBase> vertexArray{ vertices, numVertices, (size_t)vertexReader->GetStride() };
+	for (size_t i = 0; i < numVertices; ++i) {
+		auto position = static_cast<const Vec3_Packed*>(vertexReader->GetPointer(vertexArray[i], eVertexElementSemantic::POSITION, 0));
+		positions.push_back(Vec3(position->x, position->y, position->z));
+	}
+	return positions;
+}
+
+
+void Mesh::ExtendBounds(BoundingBox& bounds, const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices) {
+	auto& elements = vertexReader->GetElements();
+	bool hasPosition = std::any_of(elements.begin(), elements.end(), [](const IVertexReader::Element& element) {
+		return element.semantic == eVertexElementSemantic::POSITION && element.index == 0;
+	});
+	if (!hasPosition) {
+		return;
+	}
+
+	ArrayView<const VertexBase> vertexArray{ vertices, numVertices, (size_t)vertexReader->GetStride() };
+	for (size_t i = 0; i < numVertices; ++i) {
+		auto position = static_cast<const Vec3_Packed*>(vertexReader->GetPointer(vertexArray[i], eVertexElementSemantic::POSITION, 0));
+		bounds.Extend(Vec3(position->x, position->y, position->z));
+	}
+}
+
+
 
 bool Mesh::Layout::EqualElements(const Layout& rhs) const {
 	if (m_elementHash != rhs.m_elementHash) {
@@ -84,7 +281,8 @@ bool Mesh::Layout::EqualElements(const Layout& rhs) const {
 	for (size_t i = 0; i < lhsElements.size(); ++i) {
 		if (lhsElements[i].semantic != rhsElements[i].semantic
 			|| lhsElements[i].index != rhsElements[i].index
-			|| lhsElements[i].offset != rhsElements[i].offset)
+			|| lhsElements[i].offset != rhsElements[i].offset
+			|| lhsElements[i].format != rhsElements[i].format)
 		{
 			return false;
 		}
@@ -107,7 +305,8 @@ bool Mesh::Layout::EqualLayout(const Layout& rhs) const {
 	for (size_t i = 0; i < lhsElements.size(); ++i) {
 		if (lhsElements[i].semantic != rhsElements[i].semantic
 			|| lhsElements[i].index != rhsElements[i].index
-			|| lhsElements[i].offset != rhsElements[i].offset)
+			|| lhsElements[i].offset != rhsElements[i].offset
+			|| lhsElements[i].format != rhsElements[i].format)
 		{
 			return false;
 		}
@@ -224,6 +423,7 @@ void Mesh::Layout::CalculateHashes(const std::vector<std::vector<Element>>& layo
 		layoutHash ^= inthash((size_t)e.semantic);
 		layoutHash ^= inthash((size_t)e.index);
 		layoutHash ^= inthash((size_t)e.offset);
+		layoutHash ^= inthash((size_t)e.format);
 	}
 
 	// now we order allElements to remove layout information, and keep only element information
@@ -233,6 +433,7 @@ void Mesh::Layout::CalculateHashes(const std::vector<std::vector<Element>>& layo
 		elementHash ^= inthash((size_t)e.semantic);
 		elementHash ^= inthash((size_t)e.index);
 		elementHash ^= inthash((size_t)e.offset);
+		elementHash ^= inthash((size_t)e.format);
 	}
 }
 
@@ -1,14 +1,23 @@
 #pragma once
 
 #include "MeshBuffer.hpp"
+#include "BoundingVolumes.hpp"
+#include "MeshOptimizer.hpp"
+#include "VertexCompressor.hpp"
 #include <GraphicsEngine/Resources/Vertex.hpp>
 #include <GraphicsEngine/Resources/IMesh.hpp>
 
 #include <type_traits>
 #include <mutex>
+#include <optional>
 #include <BaseLibrary/UniqueIdGenerator.hpp>
 
 
+namespace inl::jobs {
+class Scheduler;
+} // namespace inl::jobs
+
+
 namespace inl {
 namespace gxeng {
 
@@ -19,6 +28,7 @@ public:
 		eVertexElementSemantic semantic; // Semantic of the vertex elements.
 		int index; // Index of the semantic.
 		int offset; // Offset of the element within it's vertex stream, in bytes.
+		gxapi::eFormat format; // Format of the element in the vertex buffer, normals are octahedral when two-component.
 	};
 
 	/// <summary> Describes what vertex elements are contained in the streams of the mesh. </summary>
@@ -84,10 +94,42 @@ public:
 		static UniqueIdGenerator<Layout, HashLayout, EqualToLayout> layoutIdGenerator;
 		static std::mutex idGeneratorMtx;
 	};
+
+	/// <summary> Range of the index buffer that holds one level of detail, and the meshlets that cut it up. </summary>
+	/// <remarks> There are no meshlets if the positions are unknown. </remarks>
+	struct Lod {
+		uint32_t firstIndex;
+		uint32_t indexCount;
+		uint32_t firstMeshlet = 0;
+		uint32_t meshletCount = 0;
+	};
+
+	/// <summary> Vertices and indices in the exact format of the GPU buffers, with everything derived from them. </summary>
+	/// <remarks> Does not own the memory it points to, which may as well be a memory mapped file. </remarks>
+	struct PackedData {
+		std::vector<VertexStream> streams;
+		std::vector<std::vector<Element>> layout; // Elements of each stream.
+		const void* indices = nullptr;
+		size_t numIndices = 0;
+		bool is32BitIndex = false;
+		std::vector<Lod> lods;
+		std::vector<Meshlet> meshlets;
+		BoundingBox localBounds;
+		PositionQuantization positionQuantization;
+	};
 public:
 	Mesh(MemoryManager* memoryManager) : MeshBuffer(memoryManager) {}
 
 	void Set(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices, const unsigned* indices, size_t numIndices) override;
+	/// <summary> Sets the vertices and a chain of levels of detail that index them, finest first. </summary>
+	/// <remarks> The levels are stored one after the other in the same index buffer. </remarks>
+	void Set(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices, const std::vector<std::vector<unsigned>>& lodIndices);
+	/// <summary> Sets data packed beforehand by <see cref="Pack"/>. It is uploaded as is, there is no work per vertex. </summary>
+	void SetPacked(const PackedData& data);
+	/// <summary> Overwrites a range of the vertices, compressing them right into upload memory. </summary>
+	/// <remarks> Updates before the next frame are copied to the GPU together where their ranges touch, so deforming
+	///		a mesh in pieces costs a single copy. </remarks>
+	/// <exception cref="InvalidArgumentException"> If the vertices do not compress into the layout of the mesh. </exception>
 	void Update(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices, size_t offsetInVertices) override;
 	void Clear() override;
 
@@ -98,8 +140,40 @@ public:
 	using MeshBuffer::IsIndexBuffer32Bit;
 
 	const Layout& GetLayout() const;
+
+	/// <summary> Number of levels of detail, at least one unless the mesh is empty. </summary>
+	size_t GetLodCount() const;
+	/// <summary> Index range of the given level of detail, 0 is the finest. </summary>
+	/// <remarks> Levels past the coarsest return the coarsest. </remarks>
+	const Lod& GetLod(size_t level) const;
+
+	/// <summary> Meshlets of all levels of detail, each level has a range of them. </summary>
+	/// <remarks> Only meshes set with levels of detail have meshlets. <see cref="Update"/> drops them as their bounds may no longer hold. </remarks>
+	const std::vector<Meshlet>& GetMeshlets() const;
+
+	/// <summary> Box around the vertex positions in object space. </summary>
+	/// <remarks> Empty if the vertices have no position. <see cref="Update"/> only grows the box. </remarks>
+	const BoundingBox& GetLocalBounds() const;
+
+	/// <summary> Transforms the positions of the vertex buffer back into object space, multiply it before the world matrix. </summary>
+	/// <remarks> Positions are stored quantized relative to the bounds the mesh was set with.
+	///		<see cref="Update"/> keeps that range and clamps vertices that fall outside. </remarks>
+	Mat44 GetPositionDequantization() const;
+
+	/// <summary> Compresses the vertices and converts the levels of detail the way <see cref="Set"/> does. </summary>
+	/// <remarks> The returned data points into <paramref name="storage"/>. Each level is cut into meshlets.
+	///		Vertices are compressed in chunks on <paramref name="scheduler"/>, or on the calling thread if it's null. </remarks>
+	static PackedData Pack(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices, const std::vector<std::vector<unsigned>>& lodIndices, std::vector<uint8_t>& storage, jobs::Scheduler* scheduler = nullptr);
+private:
+	static void ExtendBounds(BoundingBox& bounds, const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices);
+	static std::vector<Vec3> ReadPositions(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices);
 private:
 	Layout m_layout;
+	BoundingBox m_localBounds;
+	PositionQuantization m_positionQuantization;
+	std::vector<Lod> m_lods;
+	std::vector<Meshlet> m_meshlets;
+	std::optional<VertexCompressor> m_compressor; // Made for the layout and position range of the mesh, reused by every update.
 };
 
 
@@ -23,6 +23,44 @@ MeshBuffer::MeshBuffer(MemoryManager* memoryManager)
 
 
 
+void MeshBuffer::SetPacked(const VertexStream* firstStream, const VertexStream* lastStream, const void* indices, size_t numIndices, bool is32BitIndex) {
+	if (firstStream == lastStream) {
+		throw InvalidArgumentException("At least one vertex stream is needed.");
+	}
+	if (numIndices % 3 != 0) {
+		throw InvalidArgumentException("Index count not divisible by 3. Must be triangles.");
+	}
+
+	std::vector<VertexBuffer> newVertexBuffers;
+	for (auto stream = firstStream; stream != lastStream; ++stream) {
+		if (stream->count != firstStream->count) {
+			throw InvalidArgumentException("All streams must have the same number of vertices.");
+		}
+		size_t streamSizeBytes = stream->stride * stream->count;
+		if (streamSizeBytes == 0) {
+			throw InvalidArgumentException("Stream cannot have 0 stride or 0 vertices.");
+		}
+		newVertexBuffers.push_back(m_memoryManager->CreateVertexBuffer(eResourceHeap::CRITICAL, streamSizeBytes));
+	}
+	size_t indexStride = is32BitIndex ? sizeof(uint32_t) : sizeof(uint16_t);
+	IndexBuffer newIndexBuffer = m_memoryManager->CreateIndexBuffer(eResourceHeap::CRITICAL, numIndices * indexStride, numIndices);
+
+	m_vertexBuffers = std::move(newVertexBuffers);
+	m_indexBuffer = std::move(newIndexBuffer);
+	m_vertexStrides.clear();
+	for (auto stream = firstStream; stream != lastStream; ++stream) {
+		m_vertexStrides.push_back(stream->stride);
+	}
+	m_isIndex32Bit = is32BitIndex;
+
+	// The data is copied as is to the staging buffers.
+	for (size_t i = 0; i < m_vertexBuffers.size(); ++i) {
+		m_memoryManager->GetUploadManager().Upload(m_vertexBuffers[i], 0, firstStream[i].data, firstStream[i].count * firstStream[i].stride);
+	}
+	m_memoryManager->GetUploadManager().Upload(m_indexBuffer, 0, indices, numIndices * indexStride);
+}
+
+
 void MeshBuffer::Update(uint32_t streamIndex, const void* vertexData, size_t vertexCount, size_t offsetInVertex) {
 	if (streamIndex > m_vertexBuffers.size()) {
 		throw OutOfRangeException("Stream index is out of range.");
@@ -40,6 +78,19 @@ void MeshBuffer::Update(uint32_t streamIndex, const void* vertexData, size_t ver
 }
 
 
+void* MeshBuffer::UpdateInPlace(uint32_t streamIndex, size_t vertexCount, size_t offsetInVertex) {
+	if (streamIndex >= m_vertexBuffers.size()) {
+		throw OutOfRangeException("Stream index is out of range.");
+	}
+	if (m_vertexStrides[streamIndex] * (vertexCount + offsetInVertex) > m_vertexBuffers[streamIndex].GetSize()) {
+		throw OutOfRangeException("Data doesn't fit in given vertex buffer.");
+	}
+
+	size_t stride = m_vertexStrides[streamIndex];
+	return m_memoryManager->GetUploadManager().UploadInPlace(m_vertexBuffers[streamIndex], offsetInVertex * stride, vertexCount * stride);
+}
+
+
 void MeshBuffer::Clear() {
 	m_vertexBuffers.clear();
 	m_indexBuffer = IndexBuffer();
@@ -17,7 +17,7 @@ class MemoryManager;
 
 
 struct VertexStream {
-	void* data;
+	const void* data;
 	uint32_t stride;
 	size_t count;
 };
@@ -37,7 +37,15 @@ public:
 	template <class StreamIt, class IndexIt>
 	void Set(StreamIt firstStream, StreamIt lastStream, IndexIt firstIndex, IndexIt lastIndex);
 
+	/// <summary> Uploads streams and indices that are already in the format of the buffers, without looking at the contents. </summary>
+	/// <param name="indices"> <paramref name="numIndices"/> 16 or 32 bit integers. </param>
+	void SetPacked(const VertexStream* firstStream, const VertexStream* lastStream, const void* indices, size_t numIndices, bool is32BitIndex);
+
 	void Update(uint32_t streamIndex, const void* vertexData, size_t vertexCount, size_t offsetInVertex);
+	/// <summary> Returns upload memory to write the vertices of the range into, in the format of the stream. </summary>
+	/// <remarks> Updates of the same stream before the next frame are merged into one copy where they touch,
+	///		see <see cref="UploadManager::UploadInPlace"/>. Write the memory before the next update of the stream. </remarks>
+	void* UpdateInPlace(uint32_t streamIndex, size_t vertexCount, size_t offsetInVertex);
 	void Clear();
 
 	size_t GetNumStreams() const;
@@ -1,16 +1,28 @@
 #include "MeshEntity.hpp"
 
+#include "AnimationState.hpp"
+#include "Mesh.hpp"
+
 namespace inl::gxeng {
 
 
 MeshEntity::MeshEntity() :
 	m_mesh(nullptr),
-	m_material(nullptr)
+	m_material(nullptr),
+	m_lod(0),
+	m_dynamic(false),
+	m_occluderHint(eOccluderHint::AUTO),
+	m_skin(nullptr),
+	m_animationState(nullptr),
+	m_poseVersion(0)
 {}
 
 
 
 void MeshEntity::SetMesh(Mesh* mesh) {
+	if (mesh != m_mesh) {
+		m_skinnedVertices = {}; // Made for the vertices of the old mesh.
+	}
 	m_mesh = mesh;
 }
 Mesh* MeshEntity::GetMesh() const {
@@ -24,6 +36,80 @@ Material* MeshEntity::GetMaterial() const {
 	return m_material;
 }
 
+void MeshEntity::SetLod(uint32_t lod) const {
+	m_lod = lod;
+}
+uint32_t MeshEntity::GetLod() const {
+	return m_lod;
+}
+
+void MeshEntity::SetDynamic(bool dynamic) {
+	m_dynamic = dynamic;
+}
+bool MeshEntity::IsDynamic() const {
+	return m_dynamic;
+}
+
+void MeshEntity::SetOccluderHint(eOccluderHint hint) {
+	m_occluderHint = hint;
+}
+eOccluderHint MeshEntity::GetOccluderHint() const {
+	return m_occluderHint;
+}
+
+void MeshEntity::SetAnimation(const Skin* skin, const AnimationState* state) {
+	m_skin = skin;
+	m_animationState = state;
+	if (!IsAnimated()) {
+		m_skinnedVertices = {};
+	}
+}
+const Skin* MeshEntity::GetSkin() const {
+	return m_skin;
+}
+const AnimationState* MeshEntity::GetAnimationState() const {
+	return m_animationState;
+}
+bool MeshEntity::IsAnimated() const {
+	return m_skin != nullptr && m_animationState != nullptr;
+}
+
+void MeshEntity::SetSkinnedVertices(VertexBuffer vertices) const {
+	m_skinnedVertices = std::move(vertices);
+	++m_poseVersion;
+}
+const VertexBuffer& MeshEntity::GetSkinnedVertices() const {
+	return m_skinnedVertices;
+}
+bool MeshEntity::HasSkinnedVertices() const {
+	return IsAnimated() && m_skinnedVertices.HasObject();
+}
+uint64_t MeshEntity::GetPoseVersion() const {
+	return m_poseVersion;
+}
+
+void MeshEntity::CopySceneState(const MeshEntity& other) {
+	static_cast<Transformable3D&>(*this) = other;
+	SetMesh(other.m_mesh);
+	m_material = other.m_material;
+	m_dynamic = other.m_dynamic;
+	m_occluderHint = other.m_occluderHint;
+	SetAnimation(other.m_skin, other.m_animationState);
+}
+
+BoundingBox MeshEntity::GetLocalBounds() const {
+	if (IsAnimated()) {
+		return m_skin->GetPoseBounds();
+	}
+	return m_mesh ? m_mesh->GetLocalBounds() : BoundingBox{};
+}
+Mat44 MeshEntity::GetPositionDequantization() const {
+	return HasSkinnedVertices() ? m_skin->GetPositionQuantization().GetDequantization() : m_mesh->GetPositionDequantization();
+}
+const VertexBuffer& MeshEntity::GetVertexBuffer(size_t streamIndex) const {
+	return streamIndex == 0 && HasSkinnedVertices() ? m_skinnedVertices : m_mesh->GetVertexBuffer(streamIndex);
+}
+
 
 
 
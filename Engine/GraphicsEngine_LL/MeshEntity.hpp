@@ -3,6 +3,10 @@
 
 #include <InlineMath.hpp>
 #include "BaseLibrary/Transformable.hpp"
+#include "BoundingVolumes.hpp"
+#include "MemoryObject.hpp"
+
+#include <cstdint>
 
 namespace inl::gxeng {
 
@@ -10,6 +14,16 @@ namespace inl::gxeng {
 class Mesh;
 class Material;
 class Image;
+class Skin;
+class AnimationState;
+
+
+/// <summary> Whether an entity is drawn in a depth prepass that only draws good occluders. </summary>
+enum class eOccluderHint {
+	AUTO, // Drawn if it covers enough of the screen.
+	ALWAYS,
+	NEVER, // E.g. alpha tested surfaces, which would fill their holes with depth.
+};
 
 
 class MeshEntity : public Transformable3D {
@@ -30,10 +44,66 @@ public:
 	/// <summary> Returns the currently associated material. </summary>
 	Material* GetMaterial() const;
 
+	/// <summary> Level of detail of the mesh to render, see <see cref="Mesh::GetLod"/>. </summary>
+	/// <remarks> Chosen every frame by the visibility pass, which only sees const entities,
+	///		and kept so that the next choice can apply hysteresis. Shadow passes may use coarser levels. </remarks>
+	void SetLod(uint32_t lod) const;
+	uint32_t GetLod() const;
+
+	/// <summary> Marks the entity as changing every frame, so passes caching it redraw it each frame. </summary>
+	/// <remarks> Static entities are only redrawn into caches when their mesh or transform changes. </remarks>
+	void SetDynamic(bool dynamic);
+	bool IsDynamic() const;
+
+	/// <summary> Selects the entity as an occluder for adaptive depth prepasses, or excludes it. </summary>
+	/// <remarks> Alpha tested materials must use <see cref="eOccluderHint::NEVER"/>,
+	///		the prepass writes depth for the whole surface. </remarks>
+	void SetOccluderHint(eOccluderHint hint);
+	eOccluderHint GetOccluderHint() const;
+
+	/// <summary> Deforms the mesh by the skeleton of the animation state. Pass nulls to draw the mesh as is. </summary>
+	/// <remarks> The skin must match the vertices of the mesh. Several entities may share a state to move in step.
+	///		Animated entities are drawn every frame, mark them dynamic so that shadow caches do not hold them.
+	///		Neither the skin nor the state may be deleted while assigned to the entity. </remarks>
+	void SetAnimation(const Skin* skin, const AnimationState* state);
+	const Skin* GetSkin() const;
+	const AnimationState* GetAnimationState() const;
+	bool IsAnimated() const;
+
+	/// <summary> Stream 0 of the mesh deformed into the current pose, replacing the mesh's stream when drawing. </summary>
+	/// <remarks> Written by the skinning pass, which only sees const entities. Entities it does not see this frame,
+	///		e.g. those out of view, keep the pose they were last skinned in. </remarks>
+	void SetSkinnedVertices(VertexBuffer vertices) const;
+	const VertexBuffer& GetSkinnedVertices() const;
+	bool HasSkinnedVertices() const;
+	/// <summary> Changes whenever the skinned vertices are written, so that caches of the entity know to redraw it. </summary>
+	uint64_t GetPoseVersion() const;
+
+	/// <summary> Box around the entity in object space, the pose bounds of the skin for animated entities. </summary>
+	/// <remarks> Empty if it has no mesh or the mesh has no bounds. </remarks>
+	BoundingBox GetLocalBounds() const;
+	/// <summary> Transforms the positions of the vertex buffer drawn back into object space, see <see cref="Mesh::GetPositionDequantization"/>. </summary>
+	Mat44 GetPositionDequantization() const;
+	/// <summary> The vertex stream to draw, the skinned vertices for stream 0 if there are any, the mesh's otherwise. </summary>
+	const VertexBuffer& GetVertexBuffer(size_t streamIndex) const;
+
+	/// <summary> Takes the transform, mesh, material, flags and animation of <paramref name="other"/>. </summary>
+	/// <remarks> What the pipeline writes, the LOD and the skinned vertices, is kept, for render side copies of entities. </remarks>
+	void CopySceneState(const MeshEntity& other);
+
 private:
 	// Physical properties
 	Mesh* m_mesh;
 	Material* m_material;
+	mutable uint32_t m_lod;
+	bool m_dynamic;
+	eOccluderHint m_occluderHint;
+
+	// Animation
+	const Skin* m_skin;
+	const AnimationState* m_animationState;
+	mutable VertexBuffer m_skinnedVertices;
+	mutable uint64_t m_poseVersion;
 };
 
 
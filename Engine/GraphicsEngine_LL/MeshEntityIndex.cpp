@@ -0,0 +1,93 @@
+#include "MeshEntityIndex.hpp"
+
+#include "Mesh.hpp"
+#include "MeshEntity.hpp"
+
+
+namespace inl::gxeng {
+
+
+void MeshEntityIndex::Update(const EntityCollection<MeshEntity>& entities) {
+	++m_generation;
+	m_unbounded.clear();
+
+	// Add new entities and refit the rest.
+	for (const MeshEntity* entity : entities) {
+		BoundingBox bounds = GetWorldBounds(*entity);
+		Entry& entry = m_entries.insert({ entity, Entry{ -1, m_generation } }).first->second;
+		entry.generation = m_generation;
+
+		if (bounds.IsEmpty()) {
+			if (entry.leaf >= 0) {
+				m_hierarchy.Remove(entry.leaf);
+				entry.leaf = -1;
+			}
+			m_unbounded.push_back(entity);
+		}
+		else if (entry.leaf < 0) {
+			entry.leaf = m_hierarchy.Insert(bounds, entity);
+		}
+		else {
+			m_hierarchy.Move(entry.leaf, bounds);
+		}
+	}
+
+	// Drop entities that are no longer in the collection.
+	if (m_entries.size() > entities.Size()) {
+		for (auto it = m_entries.begin(); it != m_entries.end();) {
+			if (it->second.generation != m_generation) {
+				if (it->second.leaf >= 0) {
+					m_hierarchy.Remove(it->second.leaf);
+				}
+				it = m_entries.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+	}
+}
+
+
+void MeshEntityIndex::Query(const Frustum& frustum, std::vector<const MeshEntity*>& result) const {
+	QueryVolume(frustum, result);
+}
+
+void MeshEntityIndex::Query(const BoundingSphere& sphere, std::vector<const MeshEntity*>& result) const {
+	QueryVolume(sphere, result);
+}
+
+void MeshEntityIndex::Query(const BoundingBox& box, std::vector<const MeshEntity*>& result) const {
+	QueryVolume(box, result);
+}
+
+
+size_t MeshEntityIndex::Size() const {
+	return m_entries.size();
+}
+
+
+const BoundingVolumeHierarchy<const MeshEntity*>& MeshEntityIndex::GetHierarchy() const {
+	return m_hierarchy;
+}
+
+
+template <class Volume>
+void MeshEntityIndex::QueryVolume(const Volume& volume, std::vector<const MeshEntity*>& result) const {
+	result.insert(result.end(), m_unbounded.begin(), m_unbounded.end());
+	m_hierarchy.Query(volume, [&result](const MeshEntity* entity) {
+		result.push_back(entity);
+	});
+}
+
+
+BoundingBox MeshEntityIndex::GetWorldBounds(const MeshEntity& entity) {
+	const Mesh* mesh = entity.GetMesh();
+	if (!mesh) {
+		return {};
+	}
+	return entity.GetLocalBounds().Transformed(entity.GetTransform());
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "BoundingVolumeHierarchy.hpp"
+
+#include <GraphicsEngine/Scene/EntityCollection.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+class MeshEntity;
+
+
+/// <summary>
+/// Spatial index over the mesh entities of a <see cref="Scene"/> for visibility queries.
+/// </summary>
+/// <remarks> Entities carry no change notification, so <see cref="Update"/> recomputes the world space box
+///		of every entity. Only those that moved out of their inflated box cause changes to the hierarchy.
+///		Entities without a mesh or mesh bounds can't be culled and are returned by every query. </remarks>
+class MeshEntityIndex {
+	struct Entry {
+		int leaf; // Leaf in the hierarchy, or -1 if the entity is unbounded.
+		uint64_t generation; // Last update that found the entity in the collection.
+	};
+public:
+	/// <summary> Synchronizes the index with the current contents and transforms of the collection. </summary>
+	void Update(const EntityCollection<MeshEntity>& entities);
+
+	/// <summary> Appends the entities that may be visible through the frustum to <paramref name="result"/>. </summary>
+	void Query(const Frustum& frustum, std::vector<const MeshEntity*>& result) const;
+	/// <summary> Appends the entities that may overlap the sphere to <paramref name="result"/>. </summary>
+	void Query(const BoundingSphere& sphere, std::vector<const MeshEntity*>& result) const;
+	/// <summary> Appends the entities that may overlap the box to <paramref name="result"/>. </summary>
+	void Query(const BoundingBox& box, std::vector<const MeshEntity*>& result) const;
+
+	/// <summary> Number of entities in the index, including unbounded ones. </summary>
+	size_t Size() const;
+
+	const BoundingVolumeHierarchy<const MeshEntity*>& GetHierarchy() const;
+private:
+	template <class Volume>
+	void QueryVolume(const Volume& volume, std::vector<const MeshEntity*>& result) const;
+
+	static BoundingBox GetWorldBounds(const MeshEntity& entity);
+private:
+	BoundingVolumeHierarchy<const MeshEntity*> m_hierarchy;
+	std::unordered_map<const MeshEntity*, Entry> m_entries;
+	std::vector<const MeshEntity*> m_unbounded;
+	uint64_t m_generation = 0;
+};
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,402 @@
+#include "MeshOptimizer.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+
+namespace inl::gxeng {
+
+
+// Scoring of Forsyth's algorithm, the values of the original article.
+static constexpr int ModeledCacheSize = 32;
+static constexpr float CacheDecayPower = 1.5f;
+static constexpr float LastTriangleScore = 0.75f;
+static constexpr float ValenceBoostScale = 2.0f;
+static constexpr float ValenceBoostPower = 0.5f;
+
+// Groups smaller than this are not worth moving for overdraw.
+static constexpr size_t MinClusterTriangles = 16;
+
+
+static float VertexScore(int cachePosition, unsigned activeTriangles) {
+	if (activeTriangles == 0) {
+		return -1.0f;
+	}
+
+	float score = 0.0f;
+	if (cachePosition >= 0) {
+		// The vertices of the last triangle get a fixed score, so that the next one does not simply reuse its edge.
+		if (cachePosition < 3) {
+			score = LastTriangleScore;
+		}
+		else {
+			float scaler = 1.0f / float(ModeledCacheSize - 3);
+			score = std::pow(1.0f - float(cachePosition - 3) * scaler, CacheDecayPower);
+		}
+	}
+
+	// Vertices with few triangles left are finished first, so they don't have to be loaded again later.
+	score += ValenceBoostScale * std::pow(float(activeTriangles), -ValenceBoostPower);
+	return score;
+}
+
+
+static void CheckIndices(const std::vector<unsigned>& indices, size_t vertexCount) {
+	if (indices.size() % 3 != 0) {
+		throw InvalidArgumentException("Indices must form a triangle list.");
+	}
+	for (unsigned index : indices) {
+		if (index >= vertexCount) {
+			throw OutOfRangeException("Index points past the vertices.", std::to_string(index));
+		}
+	}
+}
+
+
+std::vector<unsigned> MeshOptimizer::OptimizeVertexCache(const std::vector<unsigned>& indices, size_t vertexCount) {
+	CheckIndices(indices, vertexCount);
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return {};
+	}
+
+	// Triangles of each vertex, with the added ones removed as we go.
+	std::vector<unsigned> activeTriangles(vertexCount, 0);
+	for (unsigned index : indices) {
+		++activeTriangles[index];
+	}
+	std::vector<unsigned> firstTriangle(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; ++v) {
+		firstTriangle[v + 1] = firstTriangle[v] + activeTriangles[v];
+	}
+	std::vector<unsigned> vertexTriangles(indices.size());
+	{
+		std::vector<unsigned> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+		for (size_t i = 0; i < indices.size(); ++i) {
+			vertexTriangles[fill[indices[i]]++] = unsigned(i / 3);
+		}
+	}
+
+	std::vector<int> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v) {
+		vertexScores[v] = VertexScore(-1, activeTriangles[v]);
+	}
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<bool> added(triangleCount, false);
+	for (size_t t = 0; t < triangleCount; ++t) {
+		triangleScores[t] = vertexScores[indices[3 * t]] + vertexScores[indices[3 * t + 1]] + vertexScores[indices[3 * t + 2]];
+	}
+
+	std::vector<unsigned> result;
+	result.reserve(indices.size());
+	std::vector<unsigned> cache, newCache;
+	cache.reserve(ModeledCacheSize + 3);
+	newCache.reserve(ModeledCacheSize + 3);
+
+	size_t bestTriangle = std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin();
+	size_t scanPosition = 0;
+	for (size_t count = 0; count < triangleCount; ++count) {
+		// Nothing in the cache touches a remaining triangle, continue with the next one in the original order.
+		if (bestTriangle == triangleCount) {
+			while (added[scanPosition]) {
+				++scanPosition;
+			}
+			bestTriangle = scanPosition;
+		}
+
+		const unsigned* triangle = &indices[3 * bestTriangle];
+		added[bestTriangle] = true;
+		result.insert(result.end(), triangle, triangle + 3);
+
+		for (int k = 0; k < 3; ++k) {
+			unsigned v = triangle[k];
+			auto begin = vertexTriangles.begin() + firstTriangle[v];
+			auto end = begin + activeTriangles[v];
+			std::iter_swap(std::find(begin, end, unsigned(bestTriangle)), end - 1);
+			--activeTriangles[v];
+		}
+
+		// The triangle's vertices move to the front of the cache, the rest get pushed back.
+		newCache.assign(triangle, triangle + 3);
+		for (unsigned v : cache) {
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+				newCache.push_back(v);
+			}
+		}
+		for (size_t i = ModeledCacheSize; i < newCache.size(); ++i) {
+			cachePositions[newCache[i]] = -1;
+			vertexScores[newCache[i]] = VertexScore(-1, activeTriangles[newCache[i]]);
+		}
+		newCache.resize(std::min(newCache.size(), size_t(ModeledCacheSize)));
+		std::swap(cache, newCache);
+		for (size_t i = 0; i < cache.size(); ++i) {
+			cachePositions[cache[i]] = int(i);
+			vertexScores[cache[i]] = VertexScore(int(i), activeTriangles[cache[i]]);
+		}
+
+		// Only triangles of cached vertices changed score enough to be the next one.
+		bestTriangle = triangleCount;
+		float bestScore = -1.0f;
+		for (unsigned v : cache) {
+			for (unsigned i = firstTriangle[v]; i < firstTriangle[v] + activeTriangles[v]; ++i) {
+				unsigned t = vertexTriangles[i];
+				float score = vertexScores[indices[3 * t]] + vertexScores[indices[3 * t + 1]] + vertexScores[indices[3 * t + 2]];
+				triangleScores[t] = score;
+				if (score > bestScore) {
+					bestScore = score;
+					bestTriangle = t;
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+
+std::vector<unsigned> MeshOptimizer::OptimizeOverdraw(const std::vector<unsigned>& indices, const std::vector<Vec3>& positions, float threshold) {
+	CheckIndices(indices, positions.size());
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return {};
+	}
+
+	// Cut where the cache has nothing of the previous triangles, moving those groups costs nothing.
+	// Then cut those groups further where a cold cache makes them at most threshold times worse.
+	std::vector<size_t> clusterStarts;
+	{
+		std::vector<unsigned> timestamps(positions.size(), 0);
+		unsigned time = SimulatedCacheSize + 1;
+		auto isMiss = [&](unsigned v) {
+			if (time - timestamps[v] > SimulatedCacheSize) {
+				timestamps[v] = time++;
+				return true;
+			}
+			return false;
+		};
+		auto flush = [&] { time += SimulatedCacheSize + 1; };
+
+		std::vector<size_t> hardStarts;
+		for (size_t t = 0; t < triangleCount; ++t) {
+			int misses = isMiss(indices[3 * t]) + isMiss(indices[3 * t + 1]) + isMiss(indices[3 * t + 2]);
+			if (t == 0 || misses == 3) {
+				hardStarts.push_back(t);
+			}
+		}
+		hardStarts.push_back(triangleCount);
+
+		for (size_t c = 0; c + 1 < hardStarts.size(); ++c) {
+			size_t first = hardStarts[c], last = hardStarts[c + 1];
+			flush();
+			unsigned hardMisses = 0;
+			for (size_t t = first; t < last; ++t) {
+				hardMisses += isMiss(indices[3 * t]) + isMiss(indices[3 * t + 1]) + isMiss(indices[3 * t + 2]);
+			}
+			float limit = threshold * float(hardMisses) / float(last - first);
+
+			flush();
+			clusterStarts.push_back(first);
+			unsigned misses = 0;
+			size_t start = first;
+			for (size_t t = first; t < last; ++t) {
+				misses += isMiss(indices[3 * t]) + isMiss(indices[3 * t + 1]) + isMiss(indices[3 * t + 2]);
+				size_t count = t + 1 - start;
+				if (t + 1 < last && count >= MinClusterTriangles && float(misses) <= limit * float(count)) {
+					clusterStarts.push_back(t + 1);
+					start = t + 1;
+					misses = 0;
+					flush();
+				}
+			}
+		}
+		clusterStarts.push_back(triangleCount);
+	}
+
+	// Groups whose area faces away from the center of the mesh go first.
+	Vec3 meshCenter(0.0f);
+	for (unsigned index : indices) {
+		meshCenter += positions[index];
+	}
+	meshCenter /= float(indices.size());
+
+	const size_t clusterCount = clusterStarts.size() - 1;
+	std::vector<float> sortKeys(clusterCount);
+	for (size_t cluster = 0; cluster < clusterCount; ++cluster) {
+		Vec3 center(0.0f);
+		Vec3 normal(0.0f);
+		float area = 0.0f;
+		for (size_t t = clusterStarts[cluster]; t < clusterStarts[cluster + 1]; ++t) {
+			const Vec3& a = positions[indices[3 * t]];
+			const Vec3& b = positions[indices[3 * t + 1]];
+			const Vec3& c = positions[indices[3 * t + 2]];
+			Vec3 cross = Cross(b - a, c - a);
+			float triangleArea = cross.Length();
+			center += (a + b + c) * (triangleArea / 3.0f);
+			normal += cross;
+			area += triangleArea;
+		}
+		float normalLength = normal.Length();
+		if (area > 0.0f && normalLength > 0.0f) {
+			sortKeys[cluster] = Dot(center / area - meshCenter, normal / normalLength);
+		}
+		else {
+			sortKeys[cluster] = 0.0f;
+		}
+	}
+
+	std::vector<size_t> order(clusterCount);
+	std::iota(order.begin(), order.end(), size_t(0));
+	std::stable_sort(order.begin(), order.end(), [&sortKeys](size_t lhs, size_t rhs) {
+		return sortKeys[lhs] > sortKeys[rhs];
+	});
+
+	std::vector<unsigned> result;
+	result.reserve(indices.size());
+	for (size_t c : order) {
+		result.insert(result.end(), indices.begin() + 3 * clusterStarts[c], indices.begin() + 3 * clusterStarts[c + 1]);
+	}
+	return result;
+}
+
+
+std::vector<unsigned> MeshOptimizer::OptimizeVertexFetch(std::vector<std::vector<unsigned>>& lodIndices, size_t vertexCount) {
+	for (const auto& indices : lodIndices) {
+		CheckIndices(indices, vertexCount);
+	}
+
+	constexpr unsigned unused = ~0u;
+	std::vector<unsigned> remap(vertexCount, unused);
+	unsigned next = 0;
+	for (const auto& indices : lodIndices) {
+		for (unsigned index : indices) {
+			if (remap[index] == unused) {
+				remap[index] = next++;
+			}
+		}
+	}
+	for (unsigned& newIndex : remap) {
+		if (newIndex == unused) {
+			newIndex = next++;
+		}
+	}
+
+	for (auto& indices : lodIndices) {
+		for (unsigned& index : indices) {
+			index = remap[index];
+		}
+	}
+	return remap;
+}
+
+
+static Meshlet MeshletBounds(const unsigned* indices, size_t indexCount, const std::vector<Vec3>& positions) {
+	Meshlet meshlet;
+
+	// Sphere around the box of the vertices, nearly as tight as the optimal one for such small patches.
+	Vec3 lower = positions[indices[0]];
+	Vec3 upper = lower;
+	for (size_t i = 1; i < indexCount; ++i) {
+		lower = Min(lower, positions[indices[i]]);
+		upper = Max(upper, positions[indices[i]]);
+	}
+	const Vec3 center = (lower + upper) * 0.5f;
+	float radiusSquared = 0.0f;
+	for (size_t i = 0; i < indexCount; ++i) {
+		radiusSquared = std::max(radiusSquared, (positions[indices[i]] - center).LengthSquared());
+	}
+	meshlet.center = center;
+	meshlet.radius = std::sqrt(radiusSquared);
+
+	// Cone of the face normals, degenerate triangles don't face anywhere.
+	std::vector<Vec3> normals;
+	normals.reserve(indexCount / 3);
+	Vec3 axis = { 0.0f, 0.0f, 0.0f };
+	for (size_t i = 0; i < indexCount; i += 3) {
+		const Vec3& a = positions[indices[i]];
+		Vec3 normal = Cross(positions[indices[i + 1]] - a, positions[indices[i + 2]] - a);
+		float length = normal.Length();
+		if (length > 0.0f) {
+			normals.push_back(normal / length);
+			axis += normals.back();
+		}
+	}
+	float axisLength = axis.Length();
+	meshlet.coneAxis = axisLength > 0.0f ? axis / axisLength : Vec3{ 0.0f, 0.0f, 1.0f };
+	float minCosine = normals.empty() ? -1.0f : 1.0f;
+	for (const Vec3& normal : normals) {
+		minCosine = std::min(minCosine, Dot(normal, Vec3(meshlet.coneAxis)));
+	}
+	// Past about 85 degrees the cone hardly ever faces away, and the rounding errors get large.
+	meshlet.coneCutoff = minCosine <= 0.1f ? 1.0f : std::sqrt(1.0f - minCosine * minCosine);
+
+	return meshlet;
+}
+
+
+std::vector<Meshlet> MeshOptimizer::BuildMeshlets(const std::vector<unsigned>& indices, const std::vector<Vec3>& positions, uint32_t firstIndex, unsigned maxVertices, unsigned maxTriangles) {
+	CheckIndices(indices, positions.size());
+	if (maxVertices < 3 || maxTriangles < 1) {
+		throw InvalidArgumentException("Meshlets must have room for at least one triangle.");
+	}
+
+	std::vector<Meshlet> meshlets;
+	std::vector<unsigned> lastMeshlet(positions.size(), 0); // 1 + the meshlet that last read the vertex.
+	size_t first = 0;
+	unsigned vertexCount = 0;
+	auto finish = [&](size_t last) {
+		Meshlet meshlet = MeshletBounds(indices.data() + first, last - first, positions);
+		meshlet.firstIndex = firstIndex + uint32_t(first);
+		meshlet.indexCount = uint32_t(last - first);
+		meshlets.push_back(meshlet);
+		first = last;
+		vertexCount = 0;
+	};
+
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		unsigned newVertices = 0;
+		for (size_t j = i; j < i + 3; ++j) {
+			newVertices += lastMeshlet[indices[j]] != meshlets.size() + 1;
+		}
+		if (i - first == size_t(maxTriangles) * 3 || vertexCount + newVertices > maxVertices) {
+			finish(i);
+		}
+		for (size_t j = i; j < i + 3; ++j) {
+			if (lastMeshlet[indices[j]] != meshlets.size() + 1) {
+				lastMeshlet[indices[j]] = unsigned(meshlets.size() + 1);
+				++vertexCount;
+			}
+		}
+	}
+	if (first < indices.size()) {
+		finish(indices.size());
+	}
+
+	return meshlets;
+}
+
+
+float MeshOptimizer::AverageCacheMissRatio(const std::vector<unsigned>& indices, size_t vertexCount, unsigned cacheSize) {
+	CheckIndices(indices, vertexCount);
+	if (indices.empty()) {
+		return 0.0f;
+	}
+
+	std::vector<unsigned> timestamps(vertexCount, 0);
+	unsigned time = cacheSize + 1;
+	size_t misses = 0;
+	for (unsigned index : indices) {
+		if (time - timestamps[index] > cacheSize) {
+			timestamps[index] = time++;
+			++misses;
+		}
+	}
+	return float(misses) / float(indices.size() / 3);
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <InlineMath.hpp>
+
+#include <cstdint>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary> A small run of consecutive triangles of the index buffer with bounds to cull it alone. </summary>
+/// <remarks> Laid out as the culling shaders read it. </remarks>
+struct Meshlet {
+	uint32_t firstIndex; // Into the index buffer of the mesh.
+	uint32_t indexCount;
+	Vec3_Packed center; // Bounding sphere in object space.
+	float radius;
+	Vec3_Packed coneAxis; // Average facing of the triangles.
+	float coneCutoff; // Sine of the spread of the normals around the axis, 1 if they face every way.
+};
+
+
+/// <summary>
+/// Reorders triangles and vertices of meshes so that the GPU reads and shades fewer of them.
+/// </summary>
+/// <remarks> Meant for importing, the order of the triangles changes but the mesh looks the same.
+///		Run <see cref="OptimizeVertexCache"/> first, then <see cref="OptimizeOverdraw"/>, and <see cref="OptimizeVertexFetch"/> last. </remarks>
+class MeshOptimizer {
+public:
+	/// <summary> Orders the triangles so that consecutive ones share vertices still in the post-transform cache. </summary>
+	/// <remarks> Uses Forsyth's linear-speed algorithm, which does not depend much on the actual size of the cache. </remarks>
+	static std::vector<unsigned> OptimizeVertexCache(const std::vector<unsigned>& indices, size_t vertexCount);
+
+	/// <summary> Orders groups of triangles so that those facing outward from the center of the mesh are drawn first,
+	///		and occlude the ones behind them in more views. </summary>
+	/// <param name="indices"> Already optimized for the vertex cache, the groups are cut where the order allows. </param>
+	/// <param name="threshold"> How much worse the cache miss ratio of a group may get by being moved, 1.05 is 5%. </param>
+	static std::vector<unsigned> OptimizeOverdraw(const std::vector<unsigned>& indices, const std::vector<Vec3>& positions, float threshold = 1.05f);
+
+	/// <summary> Renumbers the vertices in the order they are first used, so neighbouring vertices are near in memory. </summary>
+	/// <param name="lodIndices"> All levels of detail that share the vertices, the finest first. They are rewritten in place. </param>
+	/// <returns> The new index of each vertex. Vertices used by no level are moved to the end in their original order. </returns>
+	static std::vector<unsigned> OptimizeVertexFetch(std::vector<std::vector<unsigned>>& lodIndices, size_t vertexCount);
+
+	/// <summary> Cuts the triangles into runs of at most <paramref name="maxTriangles"/> triangles
+	///		that read at most <paramref name="maxVertices"/> different vertices. </summary>
+	/// <remarks> The order of the triangles is kept, so run it on indices already optimized for the vertex cache,
+	///		whose neighbouring triangles are also near on the surface. </remarks>
+	/// <param name="firstIndex"> Added to the index ranges, where <paramref name="indices"/> start in the index buffer. </param>
+	static std::vector<Meshlet> BuildMeshlets(const std::vector<unsigned>& indices, const std::vector<Vec3>& positions, uint32_t firstIndex = 0,
+											  unsigned maxVertices = MeshletMaxVertices, unsigned maxTriangles = MeshletMaxTriangles);
+
+	/// <summary> Average number of vertices transformed per triangle with a FIFO cache of the given size. </summary>
+	/// <remarks> 3 is the worst, around 0.5 the best for regular meshes. </remarks>
+	static float AverageCacheMissRatio(const std::vector<unsigned>& indices, size_t vertexCount, unsigned cacheSize = SimulatedCacheSize);
+
+	/// <summary> Post-transform cache size the overdraw optimization expects. </summary>
+	static constexpr unsigned SimulatedCacheSize = 16;
+	/// <summary> Meshlet limits, the size of one thread group of the culling shaders or a wave of most GPUs. </summary>
+	static constexpr unsigned MeshletMaxVertices = 64;
+	static constexpr unsigned MeshletMaxTriangles = 64;
+};
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,155 @@
+#include "MeshSimplifier.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+
+namespace inl::gxeng {
+
+
+static constexpr int CoordinateBits = 21;
+
+
+namespace {
+
+struct Triangle {
+	unsigned a, b, c;
+	bool operator==(const Triangle& rhs) const { return a == rhs.a && b == rhs.b && c == rhs.c; }
+};
+
+struct TriangleHash {
+	size_t operator()(const Triangle& t) const {
+		return size_t((uint64_t(t.a) * 0x9E3779B97F4A7C15ull) ^ (uint64_t(t.b) * 0xC2B2AE3D27D4EB4Full) ^ uint64_t(t.c));
+	}
+};
+
+} // namespace
+
+
+static void GetBounds(const std::vector<Vec3>& positions, Vec3& minimum, Vec3& maximum) {
+	minimum = Vec3(std::numeric_limits<float>::max());
+	maximum = Vec3(std::numeric_limits<float>::lowest());
+	for (const Vec3& p : positions) {
+		minimum = Min(minimum, p);
+		maximum = Max(maximum, p);
+	}
+}
+
+
+std::vector<unsigned> MeshSimplifier::Cluster(const std::vector<Vec3>& positions, const std::vector<unsigned>& indices, float cellSize) {
+	if (!(cellSize > 0.0f)) {
+		throw InvalidArgumentException("Cell size must be positive.");
+	}
+	if (positions.empty()) {
+		return {};
+	}
+
+	Vec3 minimum, maximum;
+	GetBounds(positions, minimum, maximum);
+
+	// Assign vertices to cells.
+	constexpr uint64_t coordinateMask = (uint64_t(1) << CoordinateBits) - 1;
+	std::unordered_map<uint64_t, unsigned> cellIndices;
+	std::vector<unsigned> vertexCells(positions.size());
+	std::vector<Vec3> centroids;
+	std::vector<unsigned> counts;
+	for (size_t i = 0; i < positions.size(); ++i) {
+		Vec3 cell = (positions[i] - minimum) / cellSize;
+		uint64_t key = (uint64_t(cell.x) & coordinateMask)
+					   | (uint64_t(cell.y) & coordinateMask) << CoordinateBits
+					   | (uint64_t(cell.z) & coordinateMask) << (2 * CoordinateBits);
+		auto [it, isNew] = cellIndices.insert({ key, unsigned(centroids.size()) });
+		if (isNew) {
+			centroids.push_back(Vec3(0.0f));
+			counts.push_back(0);
+		}
+		vertexCells[i] = it->second;
+		centroids[it->second] += positions[i];
+		++counts[it->second];
+	}
+
+	// Pick the vertex closest to the centroid as the representative of the cell.
+	std::vector<unsigned> representatives(centroids.size(), ~0u);
+	std::vector<float> bestDistances(centroids.size(), std::numeric_limits<float>::max());
+	for (size_t i = 0; i < centroids.size(); ++i) {
+		centroids[i] /= float(counts[i]);
+	}
+	for (size_t i = 0; i < positions.size(); ++i) {
+		unsigned cell = vertexCells[i];
+		float distance = (positions[i] - centroids[cell]).LengthSquared();
+		if (distance < bestDistances[cell]) {
+			bestDistances[cell] = distance;
+			representatives[cell] = unsigned(i);
+		}
+	}
+
+	// Remap triangles, drop the collapsed and the repeated ones.
+	std::vector<unsigned> result;
+	std::unordered_set<Triangle, TriangleHash> triangles;
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		unsigned a = representatives[vertexCells[indices[i]]];
+		unsigned b = representatives[vertexCells[indices[i + 1]]];
+		unsigned c = representatives[vertexCells[indices[i + 2]]];
+		if (a == b || b == c || c == a) {
+			continue;
+		}
+
+		// Rotate the smallest index first, this keeps the winding.
+		if (b < a && b < c) {
+			std::tie(a, b, c) = std::make_tuple(b, c, a);
+		}
+		else if (c < a && c < b) {
+			std::tie(a, b, c) = std::make_tuple(c, a, b);
+		}
+		if (!triangles.insert({ a, b, c }).second) {
+			continue;
+		}
+		result.push_back(a);
+		result.push_back(b);
+		result.push_back(c);
+	}
+
+	return result;
+}
+
+
+std::vector<std::vector<unsigned>> MeshSimplifier::BuildLodChain(const std::vector<Vec3>& positions, const std::vector<unsigned>& indices, size_t maxLevels) {
+	std::vector<std::vector<unsigned>> levels;
+	levels.push_back(indices);
+	if (positions.empty() || maxLevels <= 1) {
+		return levels;
+	}
+
+	Vec3 minimum, maximum;
+	GetBounds(positions, minimum, maximum);
+	Vec3 size = maximum - minimum;
+	float largestSize = std::max(size.x, std::max(size.y, size.z));
+	if (!(largestSize > 0.0f)) {
+		return levels;
+	}
+
+	// Start fine and coarsen the grid until the triangle count drops enough for a new level.
+	float cellSize = largestSize / 256.0f;
+	while (levels.size() < maxLevels && levels.back().size() / 3 > MinTriangles && cellSize < largestSize) {
+		std::vector<unsigned> simplified = Cluster(positions, indices, cellSize);
+		cellSize *= 1.5f;
+		if (simplified.empty()) {
+			break;
+		}
+		if (float(simplified.size()) <= MaxLevelRatio * float(levels.back().size())) {
+			levels.push_back(std::move(simplified));
+		}
+	}
+
+	return levels;
+}
+
+
+} // namespace inl::gxeng
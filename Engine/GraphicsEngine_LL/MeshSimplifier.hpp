@@ -0,0 +1,35 @@
+#pragma once
+
+#include <InlineMath.hpp>
+
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary>
+/// Generates coarser triangle lists for meshes by vertex clustering.
+/// </summary>
+/// <remarks> Vertices are snapped to a uniform grid, and each cell is collapsed into the original vertex
+///		closest to the cell's centroid. Coarser levels therefore only index a subset of the original vertices,
+///		so all levels of detail can share the vertex buffers of the mesh. </remarks>
+class MeshSimplifier {
+public:
+	/// <summary> Collapses the vertices that fall into the same grid cell. </summary>
+	/// <returns> Indices of the remaining triangles, degenerate and duplicate triangles are removed. </returns>
+	static std::vector<unsigned> Cluster(const std::vector<Vec3>& positions, const std::vector<unsigned>& indices, float cellSize);
+
+	/// <summary> Builds successively coarser versions of the mesh. </summary>
+	/// <returns> The original indices, followed by the coarser levels. </returns>
+	/// <param name="maxLevels"> Maximum number of levels including the original. </param>
+	/// <remarks> Each level has at most <see cref="MaxLevelRatio"/> times the triangles of the previous.
+	///		Stops early when the triangles run out or the grid can't get any coarser. </remarks>
+	static std::vector<std::vector<unsigned>> BuildLodChain(const std::vector<Vec3>& positions, const std::vector<unsigned>& indices, size_t maxLevels = 4);
+
+	static constexpr float MaxLevelRatio = 0.6f;
+	static constexpr size_t MinTriangles = 16;
+};
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,179 @@
+#include "MipGenerationTask.hpp"
+
+#include "ComputeCommandList.hpp"
+
+#include <algorithm>
+
+
+namespace inl::gxeng {
+
+
+static constexpr unsigned GroupSize = 8;
+
+
+static uint64_t MipSize(uint64_t size, unsigned mip) {
+	return std::max(uint64_t(1), size >> mip);
+}
+
+
+void MipGenerationTask::SetRequests(const std::vector<UploadManager::MipGenerationDescription>* requests) {
+	m_requests = requests;
+}
+
+
+bool MipGenerationTask::HasRequests() const {
+	return m_requests && !m_requests->empty();
+}
+
+
+void MipGenerationTask::Setup(SetupContext& context) {
+	m_targets.clear();
+	if (!HasRequests()) {
+		return;
+	}
+
+	if (!m_binder) {
+		BindParameterDesc uniformsBindParamDesc;
+		m_uniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
+		uniformsBindParamDesc.parameter = m_uniformsBindParam;
+		uniformsBindParamDesc.constantSize = sizeof(uint32_t);
+		uniformsBindParamDesc.relativeAccessFrequency = 0;
+		uniformsBindParamDesc.relativeChangeFrequency = 0;
+		uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc inputBindParamDesc;
+		m_inputBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		inputBindParamDesc.parameter = m_inputBindParam;
+		inputBindParamDesc.constantSize = 0;
+		inputBindParamDesc.relativeAccessFrequency = 0;
+		inputBindParamDesc.relativeChangeFrequency = 0;
+		inputBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		std::vector<BindParameterDesc> bindParamDescs = { uniformsBindParamDesc, inputBindParamDesc };
+		for (unsigned i = 0; i < MaxMipsPerDispatch; ++i) {
+			BindParameterDesc outputBindParamDesc;
+			m_outputBindParams[i] = BindParameter(eBindParameterType::UNORDERED, i);
+			outputBindParamDesc.parameter = m_outputBindParams[i];
+			outputBindParamDesc.constantSize = 0;
+			outputBindParamDesc.relativeAccessFrequency = 0;
+			outputBindParamDesc.relativeChangeFrequency = 0;
+			outputBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+			bindParamDescs.push_back(outputBindParamDesc);
+		}
+
+		m_binder = context.CreateBinder(bindParamDescs, {});
+	}
+
+	for (const auto& request : *m_requests) {
+		unsigned variant = GetVariant(request.filter, request.srgb);
+		if (m_CSOs[variant] == nullptr) {
+			ShaderParts shaderParts;
+			shaderParts.cs = true;
+
+			std::string macros = request.filter == eMipFilter::TENT ? "TENT=1" : "";
+			if (request.srgb) {
+				macros += macros.empty() ? "SRGB=1" : " SRGB=1";
+			}
+			m_shaders[variant] = context.CreateShader("GenerateMips", shaderParts, macros);
+
+			gxapi::ComputePipelineStateDesc csoDesc;
+			csoDesc.rootSignature = m_binder.GetRootSignature();
+			csoDesc.cs = m_shaders[variant].cs;
+			m_CSOs[variant].reset(context.CreatePSO(csoDesc));
+		}
+
+		Target target{ request.texture, request.filter, request.srgb };
+		const Texture2D& texture = target.texture;
+		unsigned numMips = texture.GetNumMiplevels();
+
+		gxapi::SrvTexture2DArray srvDesc;
+		srvDesc.activeArraySize = 1;
+		srvDesc.firstArrayElement = 0;
+		srvDesc.mipLevelClamping = 0;
+		srvDesc.numMipLevels = 1;
+		srvDesc.planeIndex = 0;
+
+		gxapi::UavTexture2DArray uavDesc;
+		uavDesc.activeArraySize = 1;
+		uavDesc.firstArrayElement = 0;
+		uavDesc.planeIndex = 0;
+
+		target.srvs.resize(numMips);
+		target.uavs.resize(numMips);
+		for (unsigned mip = 0; mip < numMips; ++mip) {
+			srvDesc.mostDetailedMip = mip;
+			target.srvs[mip] = context.CreateSrv(texture, texture.GetFormat(), srvDesc);
+			if (mip > 0) {
+				uavDesc.mipLevel = mip;
+				target.uavs[mip] = context.CreateUav(texture, texture.GetFormat(), uavDesc);
+			}
+		}
+		m_targets.push_back(std::move(target));
+	}
+}
+
+
+void MipGenerationTask::Execute(RenderContext& context) {
+	if (m_targets.empty()) {
+		return;
+	}
+
+	auto& commandList = context.AsCompute();
+	for (const auto& target : m_targets) {
+		const Texture2D& texture = target.texture;
+		unsigned numMips = (unsigned)target.srvs.size();
+		unsigned mipsPerDispatch = target.filter == eMipFilter::TENT ? 1 : MaxMipsPerDispatch;
+
+		commandList.SetPipelineState(m_CSOs[GetVariant(target.filter, target.srgb)].get());
+		commandList.SetComputeBinder(&m_binder);
+		for (unsigned source = 0; source + 1 < numMips; source += mipsPerDispatch) {
+			uint32_t count = std::min(mipsPerDispatch, numMips - 1 - source);
+
+			commandList.SetResourceState(texture, { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE }, texture.GetSubresourceIndex(source, 0, 0));
+			commandList.BindCompute(m_inputBindParam, target.srvs[source]);
+			for (unsigned i = 0; i < count; ++i) {
+				commandList.SetResourceState(texture, gxapi::eResourceState::UNORDERED_ACCESS, texture.GetSubresourceIndex(source + 1 + i, 0, 0));
+			}
+			// Slots past the last level still need a view, the shader does not write them.
+			for (unsigned i = 0; i < MaxMipsPerDispatch; ++i) {
+				commandList.BindCompute(m_outputBindParams[i], target.uavs[source + 1 + std::min(i, count - 1)]);
+			}
+			commandList.BindCompute(m_uniformsBindParam, &count, sizeof(count));
+
+			uint64_t width = MipSize(texture.GetWidth(), source + 1);
+			uint64_t height = MipSize(texture.GetHeight(), source + 1);
+			commandList.Dispatch(unsigned((width + GroupSize - 1) / GroupSize), unsigned((height + GroupSize - 1) / GroupSize), 1);
+		}
+
+		commandList.SetResourceState(texture, { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	}
+}
+
+
+bool MipGenerationTask::IsFormatSupported(gxapi::eFormat format) {
+	using gxapi::eFormat;
+
+	// Formats with typed unordered access stores on all hardware that are also filterable.
+	switch (format) {
+		case eFormat::R8_UNORM:
+		case eFormat::R8G8_UNORM:
+		case eFormat::R8G8B8A8_UNORM:
+		case eFormat::R16_UNORM:
+		case eFormat::R16G16_UNORM:
+		case eFormat::R16G16B16A16_UNORM:
+		case eFormat::R32_FLOAT:
+		case eFormat::R32G32_FLOAT:
+		case eFormat::R32G32B32A32_FLOAT:
+			return true;
+		default:
+			return false;
+	}
+}
+
+
+unsigned MipGenerationTask::GetVariant(eMipFilter filter, bool srgb) {
+	return (filter == eMipFilter::TENT ? 2 : 0) + (srgb ? 1 : 0);
+}
+
+
+} // namespace inl::gxeng
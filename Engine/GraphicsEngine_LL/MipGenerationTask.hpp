@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Binder.hpp"
+#include "GraphicsNode.hpp"
+#include "ResourceView.hpp"
+#include "ShaderManager.hpp"
+#include "UploadManager.hpp"
+
+#include <GraphicsApi_LL/IPipelineState.hpp>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary>
+/// Fills the mip chains of textures on the GPU from their top level, run by the scheduler right after the uploads.
+/// </summary>
+/// <remarks> The box filter makes up to four levels per dispatch from a single source level through group shared memory,
+///		the tent filter reads a wider footprint and makes one level per dispatch.
+///		Textures end up readable by shaders in all levels. Shaders and pipeline states are kept between frames. </remarks>
+class MipGenerationTask : public GraphicsTask {
+public:
+	/// <summary> Levels written by one box filter dispatch. </summary>
+	static constexpr unsigned MaxMipsPerDispatch = 4;
+
+	void SetRequests(const std::vector<UploadManager::MipGenerationDescription>* requests);
+	bool HasRequests() const;
+
+	void Setup(SetupContext& context) override;
+	void Execute(RenderContext& context) override;
+
+	/// <summary> True if shaders can write the format, so that its mips can be generated. </summary>
+	static bool IsFormatSupported(gxapi::eFormat format);
+
+private:
+	struct Target {
+		Texture2D texture;
+		eMipFilter filter;
+		bool srgb;
+		std::vector<TextureView2D> srvs; // One per level.
+		std::vector<RWTextureView2D> uavs; // One per level, the top one is unused.
+	};
+
+	static unsigned GetVariant(eMipFilter filter, bool srgb);
+
+private:
+	const std::vector<UploadManager::MipGenerationDescription>* m_requests = nullptr;
+	std::vector<Target> m_targets; // Views of the current frame.
+
+	Binder m_binder;
+	BindParameter m_uniformsBindParam;
+	BindParameter m_inputBindParam;
+	std::array<BindParameter, MaxMipsPerDispatch> m_outputBindParams;
+	std::array<ShaderProgram, 4> m_shaders; // By filter and color space, see GetVariant.
+	std::array<std::unique_ptr<gxapi::IPipelineState>, 4> m_CSOs;
+};
+
+
+} // namespace inl::gxeng
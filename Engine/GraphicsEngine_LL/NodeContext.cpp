@@ -4,6 +4,9 @@
 #include "CommandAllocatorPool.hpp"
 #include "ScratchSpacePool.hpp"
 #include "GraphicsCommandList.hpp"
+#include "TransientTexturePool.hpp"
+
+#include <memory>
 
 
 namespace inl::gxeng {
@@ -14,9 +17,10 @@ namespace inl::gxeng {
 // Engine Context
 //------------------------------------------------------------------------------
 
-EngineContext::EngineContext(int cpuCount, int gpuCount) {
+EngineContext::EngineContext(int cpuCount, int gpuCount, eQualityPreset qualityPreset) {
 	m_cpuCount = cpuCount;
 	m_gpuCount = gpuCount;
+	m_qualityPreset = qualityPreset;
 }
 
 
@@ -28,6 +32,10 @@ int EngineContext::GetGraphicsDeviceCount() const {
 	return m_gpuCount;
 }
 
+eQualityPreset EngineContext::GetQualityPreset() const {
+	return m_qualityPreset;
+}
+
 
 
 //------------------------------------------------------------------------------
@@ -39,13 +47,19 @@ SetupContext::SetupContext(MemoryManager* memoryManager,
 						   RTVHeap* rtvHeap,
 						   DSVHeap* dsvHeap,
 						   ShaderManager* shaderManager,
-						   gxapi::IGraphicsApi* graphicsApi)
+						   gxapi::IGraphicsApi* graphicsApi,
+						   jobs::Scheduler* jobScheduler,
+						   TransientTexturePool* transientPool,
+						   size_t taskId)
 	: m_memoryManager(memoryManager),
 	m_srvHeap(srvHeap),
 	m_rtvHeap(rtvHeap),
 	m_dsvHeap(dsvHeap),
 	m_shaderManager(shaderManager),
-	m_graphicsApi(graphicsApi)
+	m_graphicsApi(graphicsApi),
+	m_jobScheduler(jobScheduler),
+	m_transientPool(transientPool),
+	m_taskId(taskId)
 {}
 
 
@@ -61,6 +75,21 @@ Texture2D SetupContext::CreateTexture2D(const Texture2DDesc& desc, const Texture
 	return texture;
 }
 
+Texture2D SetupContext::CreateTransientTexture2D(const Texture2DDesc& desc, const TextureUsage& usage) const {
+	if (!m_transientPool) {
+		return CreateTexture2D(desc, usage);
+	}
+
+	gxapi::eResourceFlags flags;
+
+	if (!usage.shaderResource) flags += gxapi::eResourceFlags::DENY_SHADER_RESOURCE;
+	if (usage.renderTarget) flags += gxapi::eResourceFlags::ALLOW_RENDER_TARGET;
+	if (usage.depthStencil) flags += gxapi::eResourceFlags::ALLOW_DEPTH_STENCIL;
+	if (usage.randomAccess) flags += gxapi::eResourceFlags::ALLOW_UNORDERED_ACCESS;
+
+	return m_transientPool->Acquire(*m_memoryManager, m_taskId, desc, flags);
+}
+
 Texture3D SetupContext::CreateTexture3D(const Texture3DDesc& desc, const TextureUsage& usage) const {
 	gxapi::eResourceFlags flags;
 
@@ -92,6 +121,12 @@ TextureView3D SetupContext::CreateSrv(const Texture3D & texture, gxapi::eFormat
 	return TextureView3D{ texture, *m_srvHeap, format, desc };
 }
 
+BufferView SetupContext::CreateSrv(const LinearBuffer& buffer, gxapi::eFormat format, gxapi::SrvBuffer desc) const {
+	if (m_srvHeap == nullptr) throw InvalidStateException("Cannot create srv without srv/cbv/uav heap.");
+
+	return BufferView{ buffer, *m_srvHeap, format, desc };
+}
+
 RenderTargetView2D SetupContext::CreateRtv(const Texture2D& texture, gxapi::eFormat format, gxapi::RtvTexture2DArray desc) const {
 	if (m_rtvHeap == nullptr) throw InvalidStateException("Cannot create rtv without rtv heap.");
 
@@ -118,6 +153,23 @@ RWTextureView3D SetupContext::CreateUav(const Texture3D& rwTexture, gxapi::eForm
 	return RWTextureView3D{ rwTexture, *m_srvHeap, format, desc };
 }
 
+RWBufferView SetupContext::CreateUav(const LinearBuffer& rwBuffer, gxapi::eFormat format, gxapi::UavBuffer desc) const {
+	if (m_srvHeap == nullptr) throw InvalidStateException("Cannot create uav wihtout srv/cbv/uav heap.");
+
+	return RWBufferView{ rwBuffer, *m_srvHeap, format, desc };
+}
+
+
+LinearBuffer SetupContext::CreateBuffer(size_t size, bool randomAccess) const {
+	gxapi::eResourceFlags flags = randomAccess ? gxapi::eResourceFlags::ALLOW_UNORDERED_ACCESS : gxapi::eResourceFlags::NONE;
+	return m_memoryManager->CreateBuffer(eResourceHeap::CRITICAL, size, flags);
+}
+
+
+ReadbackBuffer SetupContext::CreateReadbackBuffer(size_t size) const {
+	return m_memoryManager->CreateReadbackBuffer(size);
+}
+
 
 VertexBuffer SetupContext::CreateVertexBuffer(size_t size) const {
 	VertexBuffer result = m_memoryManager->CreateVertexBuffer(eResourceHeap::CRITICAL, size);
@@ -160,6 +212,29 @@ Binder SetupContext::CreateBinder(const std::vector<BindParameterDesc>& paramete
 }
 
 
+bool RenderContext::IsBindlessSupported() const {
+	return m_scratchSpacePool != nullptr && m_scratchSpacePool->GetBindlessHeap() != nullptr;
+}
+
+gxapi::ICommandSignature* SetupContext::CreateCommandSignature(const gxapi::CommandSignatureDesc& desc, const Binder* binder) const {
+	return m_graphicsApi->CreateCommandSignature(desc, binder ? binder->GetRootSignature() : nullptr);
+}
+
+
+gxapi::CapsVariableRateShading SetupContext::QueryVariableRateShading() const {
+	if (!m_graphicsApi) {
+		return {};
+	}
+	std::unique_ptr<gxapi::ICapabilityQuery> query(m_graphicsApi->GetCapabilityQuery());
+	return query->QueryVariableRateShading();
+}
+
+
+jobs::Scheduler* SetupContext::GetJobScheduler() const {
+	return m_jobScheduler;
+}
+
+
 
 //------------------------------------------------------------------------------
 // Render Context
@@ -174,7 +249,11 @@ RenderContext::RenderContext(MemoryManager* memoryManager,
 							 CommandAllocatorPool* commandAllocatorPool,
 							 ScratchSpacePool* scratchSpacePool,
 							 std::unique_ptr<BasicCommandList> inheritedList,
-							 std::unique_ptr<VolatileViewHeap> inheritedVheap)
+							 std::unique_ptr<VolatileViewHeap> inheritedVheap,
+							 LinearArena* frameArena,
+							 jobs::Scheduler* jobScheduler,
+							 bool asyncCompute,
+							 bool asyncCopy)
 	: m_memoryManager(memoryManager),
 	m_srvHeap(srvHeap),
 	m_shaderManager(shaderManager),
@@ -183,7 +262,11 @@ RenderContext::RenderContext(MemoryManager* memoryManager,
 	m_commandAllocatorPool(commandAllocatorPool),
 	m_scratchSpacePool(scratchSpacePool),
 	m_inheritedCommandList(std::move(inheritedList)),
-	m_vheap(std::move(inheritedVheap))
+	m_vheap(std::move(inheritedVheap)),
+	m_frameArena(frameArena),
+	m_jobScheduler(jobScheduler),
+	m_asyncCompute(asyncCompute),
+	m_asyncCopy(asyncCopy)
 {}
 
 
@@ -203,6 +286,27 @@ ConstBufferView RenderContext::CreateCbv(VolatileConstBuffer& buffer, size_t off
 	);
 }
 
+TransientVertexBuffer RenderContext::AllocateTransientVertices(size_t size) const {
+	return m_memoryManager->GetDynamicBufferRing().AllocateVertices(size);
+}
+
+TransientIndexBuffer RenderContext::AllocateTransientIndices(size_t indexCount, bool is32Bit) const {
+	return m_memoryManager->GetDynamicBufferRing().AllocateIndices(indexCount, is32Bit);
+}
+
+PersistentConstBuffer RenderContext::CreatePersistentConstBuffer(const void* data, size_t size) const {
+	return m_memoryManager->CreatePersistentConstBuffer(data, (uint32_t)size);
+}
+
+ConstBufferView RenderContext::CreateCbv(PersistentConstBuffer& buffer) const {
+	InitVheap();
+	return ConstBufferView(
+		buffer,
+		m_vheap->Allocate(),
+		m_graphicsApi
+	);
+}
+
 ShaderProgram RenderContext::CreateShader(const std::string& name, ShaderParts stages, const std::string& macros) const {
 	return m_shaderManager->CreateShader(name, stages, macros);
 }
@@ -260,6 +364,14 @@ void RenderContext::Upload(const Texture2D& target,
 	m_memoryManager->GetUploadManager().UploadNow(commandList, target, offsetX, offsetY, subresource, data, width, height, format, bytesPerRow);
 }
 
+jobs::Future<ReadbackData> RenderContext::RequestReadback(const LinearBuffer& source, size_t offset, size_t size) const {
+	return m_memoryManager->GetReadbackManager().RequestReadback(source, offset, size);
+}
+
+jobs::Future<ReadbackData> RenderContext::RequestReadback(const Texture2D& source, const ReadbackRegion& region) const {
+	return m_memoryManager->GetReadbackManager().RequestReadback(source, region);
+}
+
 // Query command list
 GraphicsCommandList& RenderContext::AsGraphics() {
 	InitVheap();
@@ -271,6 +383,7 @@ GraphicsCommandList& RenderContext::AsGraphics() {
 			m_commandList.reset(new GraphicsCommandList(m_graphicsApi, *m_commandListPool, *m_commandAllocatorPool, *m_scratchSpacePool, *m_memoryManager, *m_vheap.get()));
 		}
 		m_commandList->BeginDebuggerEvent(m_TMP_commandListName); // TMP
+		m_gpuScope = BeginGpuScope(*m_commandList);
 		m_commandList->SetName(m_TMP_commandListName);
 		m_type = gxapi::eCommandListType::GRAPHICS;
 		return *dynamic_cast<GraphicsCommandList*>(m_commandList.get());
@@ -285,13 +398,40 @@ GraphicsCommandList& RenderContext::AsGraphics() {
 ComputeCommandList& RenderContext::AsCompute() {
 	InitVheap();
 	if (!m_commandList) {
-		if (m_inheritedCommandList && m_inheritedCommandList->GetType() == gxapi::eCommandListType::COMPUTE) {
+		// Compute on the graphics queue is recorded into graphics lists, lists for the compute queue can't run it.
+		if (m_inheritedCommandList && m_inheritedCommandList->GetType() == gxapi::eCommandListType::GRAPHICS) {
 			m_commandList = std::move(m_inheritedCommandList);
 		}
 		else {
 			m_commandList.reset(new GraphicsCommandList(m_graphicsApi, *m_commandListPool, *m_commandAllocatorPool, *m_scratchSpacePool, *m_memoryManager, *m_vheap.get())); // only graphics queues now
 		}
 		m_commandList->BeginDebuggerEvent(m_TMP_commandListName); // TMP
+		m_gpuScope = BeginGpuScope(*m_commandList);
+		m_type = gxapi::eCommandListType::COMPUTE;
+		return *dynamic_cast<ComputeCommandList*>(m_commandList.get());
+	}
+	else if (m_type == gxapi::eCommandListType::COMPUTE) {
+		return *dynamic_cast<ComputeCommandList*>(m_commandList.get());
+	}
+	else {
+		throw std::logic_error("Your first call to AsType() determines the command list type. You did not choose COMPUTE, thus this call is invalid.");
+	}
+}
+ComputeCommandList& RenderContext::AsAsyncCompute() {
+	if (!m_asyncCompute) {
+		return AsCompute();
+	}
+	InitVheap();
+	if (!m_commandList) {
+		if (m_inheritedCommandList && m_inheritedCommandList->GetType() == gxapi::eCommandListType::COMPUTE) {
+			m_commandList = std::move(m_inheritedCommandList);
+		}
+		else {
+			m_commandList.reset(new ComputeCommandList(m_graphicsApi, *m_commandListPool, *m_commandAllocatorPool, *m_scratchSpacePool, *m_memoryManager, *m_vheap.get()));
+		}
+		m_commandList->BeginDebuggerEvent(m_TMP_commandListName); // TMP
+		m_gpuScope = BeginGpuScope(*m_commandList);
+		m_commandList->SetName(m_TMP_commandListName);
 		m_type = gxapi::eCommandListType::COMPUTE;
 		return *dynamic_cast<ComputeCommandList*>(m_commandList.get());
 	}
@@ -312,6 +452,7 @@ CopyCommandList& RenderContext::AsCopy() {
 			m_commandList.reset(new GraphicsCommandList(m_graphicsApi, *m_commandListPool, *m_commandAllocatorPool, *m_scratchSpacePool, *m_memoryManager, *m_vheap.get())); // only graphics queues now
 		}
 		m_commandList->BeginDebuggerEvent(m_TMP_commandListName); // TMP
+		m_gpuScope = BeginGpuScope(*m_commandList);
 		m_type = gxapi::eCommandListType::COPY;
 		return *dynamic_cast<CopyCommandList*>(m_commandList.get());
 	}
@@ -322,6 +463,73 @@ CopyCommandList& RenderContext::AsCopy() {
 		throw std::logic_error("Your first call to AsType() determines the command list type. You did not choose COPY, thus this call is invalid.");
 	}
 }
+CopyCommandList& RenderContext::AsAsyncCopy() {
+	if (!m_asyncCopy) {
+		return AsCopy();
+	}
+	InitVheap();
+	if (!m_commandList) {
+		if (m_inheritedCommandList && m_inheritedCommandList->GetType() == gxapi::eCommandListType::COPY) {
+			m_commandList = std::move(m_inheritedCommandList);
+		}
+		else {
+			m_commandList.reset(new CopyCommandList(m_graphicsApi, *m_commandListPool, *m_commandAllocatorPool, *m_scratchSpacePool, m_memoryManager->GetResourceIndexRegistry()));
+		}
+		m_commandList->BeginDebuggerEvent(m_TMP_commandListName); // TMP
+		m_gpuScope = BeginGpuScope(*m_commandList);
+		m_commandList->SetName(m_TMP_commandListName);
+		m_type = gxapi::eCommandListType::COPY;
+		return *dynamic_cast<CopyCommandList*>(m_commandList.get());
+	}
+	else if (m_type == gxapi::eCommandListType::COPY) {
+		return *dynamic_cast<CopyCommandList*>(m_commandList.get());
+	}
+	else {
+		throw std::logic_error("Your first call to AsType() determines the command list type. You did not choose COPY, thus this call is invalid.");
+	}
+}
+
+GraphicsCommandList& RenderContext::AddSecondaryGraphics() {
+	auto vheap = std::make_unique<VolatileViewHeap>(m_graphicsApi, m_scratchSpacePool);
+	auto list = std::make_unique<GraphicsCommandList>(m_graphicsApi, *m_commandListPool, *m_commandAllocatorPool, *m_scratchSpacePool, *m_memoryManager, *vheap.get());
+	std::string name = m_TMP_commandListName + " #" + std::to_string(m_secondaryLists.size() + 1);
+	list->BeginDebuggerEvent(name); // TMP
+	list->SetName(name);
+	m_secondaryGpuScopes.push_back(BeginGpuScope(*list));
+
+	GraphicsCommandList& result = *list;
+	m_secondaryLists.push_back(std::move(list));
+	m_secondaryVheaps.push_back(std::move(vheap));
+	return result;
+}
+
+CommandBundle RenderContext::CreateBundle(uint64_t key) const {
+	return CommandBundle(*m_commandListPool, *m_commandAllocatorPool, key);
+}
+
+unsigned RenderContext::BeginProfileScope(BasicCommandList& list, const std::string& name) const {
+	return m_gpuProfiler ? m_gpuProfiler->Begin(list, m_gpuScopeName + "/" + name) : GpuProfiler::InvalidScope;
+}
+
+void RenderContext::EndProfileScope(BasicCommandList& list, unsigned scope) const {
+	if (m_gpuProfiler) {
+		m_gpuProfiler->End(list, scope);
+	}
+}
+
+void RenderContext::EndGpuScopes() {
+	if (!m_gpuProfiler) {
+		return;
+	}
+	if (m_commandList) {
+		m_gpuProfiler->End(*m_commandList, m_gpuScope);
+	}
+	for (size_t i = 0; i < m_secondaryLists.size(); ++i) {
+		m_gpuProfiler->End(*m_secondaryLists[i], m_secondaryGpuScopes[i]);
+	}
+	m_gpuScope = GpuProfiler::InvalidScope;
+	m_secondaryGpuScopes.clear();
+}
 
 void RenderContext::Decompose(std::unique_ptr<BasicCommandList>& inheritedList,
 							  std::unique_ptr<BasicCommandList>& currentList, 
@@ -332,11 +540,24 @@ void RenderContext::Decompose(std::unique_ptr<BasicCommandList>& inheritedList,
 	currentVheap = std::move(m_vheap);
 }
 
+void RenderContext::DecomposeSecondary(std::vector<std::unique_ptr<BasicCommandList>>& lists,
+									   std::vector<std::unique_ptr<VolatileViewHeap>>& vheaps)
+{
+	lists = std::move(m_secondaryLists);
+	vheaps = std::move(m_secondaryVheaps);
+	m_secondaryLists.clear();
+	m_secondaryVheaps.clear();
+}
+
 void RenderContext::InitVheap() const {
 	if (!m_vheap) {
-		m_vheap = std::make_unique<VolatileViewHeap>(m_graphicsApi);
+		m_vheap = std::make_unique<VolatileViewHeap>(m_graphicsApi, m_scratchSpacePool);
 	}
 }
 
+unsigned RenderContext::BeginGpuScope(BasicCommandList& list) {
+	return m_gpuProfiler ? m_gpuProfiler->Begin(list, m_gpuScopeName) : GpuProfiler::InvalidScope;
+}
+
 
 } // namespace inl::gxeng
\ No newline at end of file
@@ -7,9 +7,20 @@
 #include "ShaderManager.hpp"
 #include "VolatileViewHeap.hpp"
 #include "Binder.hpp"
+#include "GpuProfiler.hpp"
+#include "CommandBundle.hpp"
+
+#include <BaseLibrary/Memory/LinearArena.hpp>
+#include <GraphicsApi_LL/HardwareCapability.hpp>
+
 #include <cstdint>
 
 
+namespace inl::jobs {
+class Scheduler;
+} // namespace inl::jobs
+
+
 namespace inl::gxeng {
 
 
@@ -25,6 +36,7 @@ class BasicCommandList;
 
 class ScratchSpacePool;
 class CommandListPool;
+class TransientTexturePool;
 class CommandAllocatorPool;
 
 // Debug draw
@@ -35,9 +47,27 @@ class DebugObject;
 // Engine Context
 //------------------------------------------------------------------------------
 
+/// <summary> Overall rendering quality, nodes derive the defaults of their own settings from it. </summary>
+enum class eQualityPreset {
+	LOW,
+	MEDIUM,
+	HIGH,
+};
+
+
+/// <summary> The resolution an effect is computed at, relative to its inputs. </summary>
+/// <remarks> DEFAULT picks the resolution that the quality preset of the engine suggests. </remarks>
+enum class eResolutionScale {
+	DEFAULT,
+	FULL,
+	HALF,
+	QUARTER,
+};
+
+
 class EngineContext {
 public:
-	EngineContext(int cpuCount = 1, int gpuCount = 1);
+	EngineContext(int cpuCount = 1, int gpuCount = 1, eQualityPreset qualityPreset = eQualityPreset::HIGH);
 	EngineContext(EngineContext&&) = delete;
 	EngineContext& operator=(EngineContext&&) = delete;
 	EngineContext(const EngineContext&) = delete;
@@ -47,9 +77,13 @@ public:
 	// Parallelism
 	int GetProcessorCoreCount() const;
 	int GetGraphicsDeviceCount() const;
+
+	// Settings
+	eQualityPreset GetQualityPreset() const;
 private:
 	int m_cpuCount;
 	int m_gpuCount;
+	eQualityPreset m_qualityPreset;
 };
 
 
@@ -80,7 +114,10 @@ public:
 				 RTVHeap* rtvHeap = nullptr,
 				 DSVHeap* dsvHeap = nullptr,
 				 ShaderManager* shaderManager = nullptr,
-				 gxapi::IGraphicsApi* graphicsApi = nullptr);
+				 gxapi::IGraphicsApi* graphicsApi = nullptr,
+				 jobs::Scheduler* jobScheduler = nullptr,
+				 TransientTexturePool* transientPool = nullptr,
+				 size_t taskId = 0);
 	SetupContext(SetupContext&&) = delete;
 	SetupContext& operator=(SetupContext&&) = delete;
 	SetupContext(const SetupContext&) = delete;
@@ -89,7 +126,18 @@ public:
 
 	// Create resources
 	Texture2D CreateTexture2D(const Texture2DDesc& desc, const TextureUsage& usage) const;
+	/// <summary> Returns a texture for intermediate results that only the current task uses, in the current frame. </summary>
+	/// <remarks> Memory is shared with tasks that run strictly before or after this one, so the contents are undefined
+	///		and the texture must not be passed to other nodes or kept for the next frame. Call it in every Setup,
+	///		the same texture is returned as long as nothing changes. Outside the scheduler it creates a regular texture. </remarks>
+	Texture2D CreateTransientTexture2D(const Texture2DDesc& desc, const TextureUsage& usage) const;
 	Texture3D CreateTexture3D(const Texture3DDesc& desc, const TextureUsage& usage) const;
+	/// <summary> Creates a plain GPU buffer, e.g. for structured data or indirect arguments. </summary>
+	/// <param name="randomAccess"> Allow unordered access, so that shaders can write it. </param>
+	LinearBuffer CreateBuffer(size_t size, bool randomAccess = false) const;
+	/// <summary> Creates a CPU readable buffer to copy GPU results into. </summary>
+	/// <remarks> Contents are only valid after the frame that copied into it has finished on the GPU. </remarks>
+	ReadbackBuffer CreateReadbackBuffer(size_t size) const;
 	VertexBuffer CreateVertexBuffer(size_t size) const;
 	IndexBuffer CreateIndexBuffer(size_t size, size_t indexCount) const;
 
@@ -97,10 +145,12 @@ public:
 	TextureView2D CreateSrv(const Texture2D& texture, gxapi::eFormat format, gxapi::SrvTexture2DArray desc = {}) const;
 	TextureViewCube CreateSrv(const Texture2D& texture, gxapi::eFormat format, gxapi::SrvTextureCubeArray desc) const;
 	TextureView3D CreateSrv(const Texture3D& texture, gxapi::eFormat format, gxapi::SrvTexture3D desc) const;
+	BufferView CreateSrv(const LinearBuffer& buffer, gxapi::eFormat format, gxapi::SrvBuffer desc) const;
 	RenderTargetView2D CreateRtv(const Texture2D& renderTarget, gxapi::eFormat format, gxapi::RtvTexture2DArray desc) const;
 	DepthStencilView2D CreateDsv(const Texture2D& depthStencilView, gxapi::eFormat format, gxapi::DsvTexture2DArray desc) const;
 	RWTextureView2D CreateUav(const Texture2D& rwTexture, gxapi::eFormat format, gxapi::UavTexture2DArray desc) const;
 	RWTextureView3D CreateUav(const Texture3D& rwTexture, gxapi::eFormat format, gxapi::UavTexture3D desc) const;
+	RWBufferView CreateUav(const LinearBuffer& rwBuffer, gxapi::eFormat format, gxapi::UavBuffer desc) const;
 
 	// Shaders and PSOs
 	ShaderProgram CreateShader(const std::string& name, ShaderParts stages, const std::string& macros = {}) const;
@@ -112,6 +162,19 @@ public:
 
 	// Binding
 	Binder CreateBinder(const std::vector<BindParameterDesc>& parameters, const std::vector<gxapi::StaticSamplerDesc>& staticSamplers = {}) const;
+	/// <summary> Creates the command layout for <see cref="GraphicsCommandList::ExecuteIndirect"/>. </summary>
+	/// <param name="binder"> Required if the commands change bindings, root parameter indices come from <see cref="Binder::Translate"/>. </param>
+	gxapi::ICommandSignature* CreateCommandSignature(const gxapi::CommandSignatureDesc& desc, const Binder* binder = nullptr) const;
+
+	// Capabilities
+	/// <summary> What the device can do with variable rate shading, nothing outside the engine. </summary>
+	/// <remarks> Queries the device every time, call it when the node is (re)configured, not every frame. </remarks>
+	gxapi::CapsVariableRateShading QueryVariableRateShading() const;
+
+	// Parallelism
+	/// <summary> The job system running the pipeline, or null if Setup runs outside of it. </summary>
+	/// <remarks> Setup itself runs on a worker, do not block on jobs that may not have started yet. </remarks>
+	jobs::Scheduler* GetJobScheduler() const;
 
 private:
 	// Memory management stuff
@@ -123,6 +186,11 @@ private:
 	// Shaders and PSOs
 	ShaderManager* m_shaderManager;
 	gxapi::IGraphicsApi* m_graphicsApi;
+
+	jobs::Scheduler* m_jobScheduler;
+
+	TransientTexturePool* m_transientPool;
+	size_t m_taskId;
 };
 
 
@@ -141,7 +209,11 @@ public:
 				  CommandAllocatorPool* commandAllocatorPool = nullptr,
 				  ScratchSpacePool* scratchSpacePool = nullptr,
 				  std::unique_ptr<BasicCommandList> inheritedList = nullptr,
-				  std::unique_ptr<VolatileViewHeap> inheritedVheap = nullptr);
+				  std::unique_ptr<VolatileViewHeap> inheritedVheap = nullptr,
+				  LinearArena* frameArena = nullptr,
+				  jobs::Scheduler* jobScheduler = nullptr,
+				  bool asyncCompute = false,
+				  bool asyncCopy = false);
 	RenderContext(RenderContext&&) = delete;
 	RenderContext& operator=(RenderContext&&) = delete;
 	RenderContext(const RenderContext&) = delete;
@@ -151,6 +223,22 @@ public:
 	// Constant buffers
 	VolatileConstBuffer CreateVolatileConstBuffer(const void* data, size_t size) const;
 	ConstBufferView CreateCbv(VolatileConstBuffer& buffer, size_t offset, size_t size) const;
+	/// <summary> Creates a buffer that keeps its contents across frames, for constants that rarely change. </summary>
+	/// <remarks> The contents cannot be changed, create a new buffer instead. Command lists the buffer is bound to
+	///		keep it alive until the GPU is done with them. </remarks>
+	PersistentConstBuffer CreatePersistentConstBuffer(const void* data, size_t size) const;
+	/// <summary> The view is only valid for the current frame, the buffer may be viewed again in later frames. </summary>
+	ConstBufferView CreateCbv(PersistentConstBuffer& buffer) const;
+
+	// Transient geometry
+	/// <summary> Returns vertex memory the GPU reads this frame only, write it and bind the buffer with
+	///		<see cref="GraphicsCommandList::SetVertexBuffers"/>. </summary>
+	/// <remarks> Costs only the copy into <see cref="TransientVertexBuffer::data"/>. The buffer lives in the upload heap,
+	///		do not set its resource state. Thread safe. </remarks>
+	TransientVertexBuffer AllocateTransientVertices(size_t size) const;
+	/// <summary> Returns index memory the GPU reads this frame only, bind it with <see cref="GraphicsCommandList::SetIndexBuffer"/>. </summary>
+	/// <remarks> Same as <see cref="AllocateTransientVertices"/>. </remarks>
+	TransientIndexBuffer AllocateTransientIndices(size_t indexCount, bool is32Bit) const;
 
 	// Shaders and PSOs
 	ShaderProgram CreateShader(const std::string& name, ShaderParts stages, const std::string& macros) const;
@@ -162,6 +250,15 @@ public:
 
 	// Binding
 	Binder CreateBinder(const std::vector<BindParameterDesc>& parameters, const std::vector<gxapi::StaticSamplerDesc>& staticSamplers = {}) const;
+	/// <summary> True if binders may have bindless parameters, and images have bindless indices. </summary>
+	bool IsBindlessSupported() const;
+
+	// Frame memory
+
+	/// <summary> Allocator for temporaries that are thrown away at the end of the frame. </summary>
+	/// <remarks> Thread safe, falls back to the heap when the context has no frame arena. </remarks>
+	template <class T>
+	ArenaAllocator<T> GetFrameAllocator() const { return ArenaAllocator<T>(m_frameArena); }
 
 	// Upload data to graphics card
 
@@ -197,15 +294,54 @@ public:
 				gxapi::eFormat format,
 				size_t bytesPerRow = 0);
 
+	// Download data from graphics card
+
+	/// <summary> Copies a range of the buffer to the CPU at the end of the frame, after all nodes recorded their commands. </summary>
+	/// <returns> Resolves once the GPU has finished the frame, a few frames later. Poll it with ready(),
+	///		waiting on it would stall until the frame is done. </returns>
+	/// <remarks> The data is what the buffer holds at the end of the frame. Don't read back transient textures,
+	///		their memory is reused by other tasks. Needs no command list, thread safe. </remarks>
+	jobs::Future<ReadbackData> RequestReadback(const LinearBuffer& source, size_t offset, size_t size) const;
+	/// <summary> Copies a region of a subresource of the texture to the CPU at the end of the frame, see above. </summary>
+	jobs::Future<ReadbackData> RequestReadback(const Texture2D& source, const ReadbackRegion& region) const;
+
 	// Query command list
 	GraphicsCommandList& AsGraphics();
 	ComputeCommandList& AsCompute();
+	/// <summary> Like <see cref="AsCompute"/>, but the list runs on the compute queue, overlapping graphics work
+	///		that does not touch the same resources. </summary>
+	/// <remarks> Only compute queue states can be set on the list, see <see cref="IsComputeQueueState"/>.
+	///		Behaves like AsCompute if the engine has no compute queue. </remarks>
+	ComputeCommandList& AsAsyncCompute();
 	CopyCommandList& AsCopy();
+	/// <summary> Like <see cref="AsCopy"/>, but the list runs on the copy queue, overlapping graphics work. </summary>
+	/// <remarks> Only COPY_DEST and COPY_SOURCE can be set on the list, resources return to COMMON when it finishes.
+	///		Behaves like AsCopy if the engine has no copy queue. </remarks>
+	CopyCommandList& AsAsyncCopy();
 	gxapi::eCommandListType GetType() const { return m_type; }
 	bool IsListInitialized() const { return (bool)m_commandList; }
 
+	/// <summary> Creates an additional graphics list that is submitted after the main list, in creation order. </summary>
+	/// <remarks> Call from the thread executing the node, only recording into the returned lists may happen in parallel,
+	///		one thread per list. Each list tracks resource states on its own, so it must set the states,
+	///		render targets and other pipeline state it uses. The scheduler merges the states in submission order,
+	///		setting a state the previous list left the resource in costs no barrier. </remarks>
+	GraphicsCommandList& AddSecondaryGraphics();
+	size_t GetSecondaryCount() const { return m_secondaryLists.size(); }
+
+	/// <summary> Starts recording a bundle of draws marked with the key. </summary>
+	/// <remarks> Keep the bundle and replay it with <see cref="GraphicsCommandList::ExecuteBundle"/>
+	///		as long as <see cref="CommandBundle::IsRecordedFor"/> is true for what the node draws. </remarks>
+	CommandBundle CreateBundle(uint64_t key) const;
+
 	// Extract command lists.
 	void Decompose(std::unique_ptr<BasicCommandList>& inheritedList, std::unique_ptr<BasicCommandList>& currentList, std::unique_ptr<VolatileViewHeap>& currentVheap);
+	void DecomposeSecondary(std::vector<std::unique_ptr<BasicCommandList>>& lists, std::vector<std::unique_ptr<VolatileViewHeap>>& vheaps);
+
+	// Parallelism
+	/// <summary> The job system running the pipeline, or null if the node runs outside of it. </summary>
+	/// <remarks> Execute runs on a worker, do not block on jobs that may not have started yet. </remarks>
+	jobs::Scheduler* GetJobScheduler() const { return m_jobScheduler; }
 
 	// Debug draw
 	void AddDebugObject(std::vector<DebugObject*> objects);
@@ -213,8 +349,23 @@ public:
 	// TMP: RenderDoc does not process command queue PIX debug events
 	void SetCommandListName(const std::string& name) { m_TMP_commandListName = name; }
 
+	// GPU profiling
+	/// <summary> True if the profiler collects pipeline statistics, nodes should only add sub-scopes then. </summary>
+	bool IsGpuStatisticsEnabled() const { return m_gpuProfiler && m_gpuProfiler->IsStatisticsEnabled(); }
+	/// <summary> Measures the commands recorded to the list until <see cref="EndProfileScope"/> as "node/name". </summary>
+	/// <remarks> Has to end in the same list. Thread safe. </remarks>
+	unsigned BeginProfileScope(BasicCommandList& list, const std::string& name) const;
+	void EndProfileScope(BasicCommandList& list, unsigned scope) const;
+
+	// GPU timing, set up by the scheduler
+	/// <summary> Lists the node records into are measured as one scope with the given name. </summary>
+	void SetGpuProfiler(GpuProfiler* profiler, const std::string& scopeName) { m_gpuProfiler = profiler; m_gpuScopeName = scopeName; }
+	/// <summary> Closes the scopes of the lists after the node has finished recording. </summary>
+	void EndGpuScopes();
+
 private:
 	void InitVheap() const;
+	unsigned BeginGpuScope(BasicCommandList& list);
 
 private:
 	// Memory management stuff
@@ -233,9 +384,21 @@ private:
 	std::unique_ptr<BasicCommandList> m_commandList;
 	mutable std::unique_ptr<VolatileViewHeap> m_vheap; // Don't want to make CBV creation non-const.
 	gxapi::eCommandListType m_type = static_cast<gxapi::eCommandListType>(0xDEADBEEF);
+	std::vector<std::unique_ptr<BasicCommandList>> m_secondaryLists;
+	std::vector<std::unique_ptr<VolatileViewHeap>> m_secondaryVheaps; // Views are allocated while recording, one heap per list.
+	LinearArena* m_frameArena;
+	jobs::Scheduler* m_jobScheduler;
+	bool m_asyncCompute;
+	bool m_asyncCopy;
 
 	// TMP: command list name
 	std::string m_TMP_commandListName;
+
+	// GPU timing
+	GpuProfiler* m_gpuProfiler = nullptr;
+	std::string m_gpuScopeName;
+	unsigned m_gpuScope = GpuProfiler::InvalidScope;
+	std::vector<unsigned> m_secondaryGpuScopes;
 };
 
 
@@ -1,19 +1,24 @@
 #pragma once
 
 #include <BaseLibrary/Any.hpp>
+#include <GraphicsEngine_LL/EnvVariables.hpp>
 #include <GraphicsEngine_LL/GraphicsNode.hpp>
 
+#include <algorithm>
+
 
 namespace inl::gxeng::nodes {
 
 
 /// <summary>
-/// Get reference to a Scene identified by its name.
+/// Get the value of an environment variable identified by its name.
 /// Inputs: name of the env var.
 /// Outputs: value of the env var
 /// </summary>
 /// <remarks>
 /// Throws an exception if the env var cannot be found, never returns nulls.
+/// The name is resolved to a handle when the pipeline is installed, and the output is only set
+/// when the value has changed, so the nodes linked to it are only notified of changes.
 /// </remarks>
 class GetEnvVariable : virtual public GraphicsNode,
 					   virtual public GraphicsTask,
@@ -30,33 +35,59 @@ public:
 	void Initialize(EngineContext& context) override {
 		GraphicsNode::SetTaskSingle(this);
 	}
-	void Reset() override {}
+	void Reset() override {
+		m_outputVersion = 0;
+	}
 
 	void Setup(SetupContext& context) {
-		std::string varName = this->GetInput<0>().Get();
-
-		if (m_envVariables) {
-			auto it = m_envVariables->find(varName);
-			if (it != m_envVariables->end()) {
-				this->GetOutput<0>().Set(it->second);
-				return;
-			}
+		const std::string& varName = this->GetInput<0>().Get();
+		if (!m_envVariables) {
+			throw InvalidArgumentException("Environment variable does not exist.", varName);
+		}
+
+		// The name only comes from a link if it's computed, it's looked up again when it changes.
+		if (!m_handle.IsValid() || m_envVariables->GetName(m_handle) != varName) {
+			m_handle = m_envVariables->Find(varName);
+			m_outputVersion = 0;
+		}
+
+		uint64_t version = m_envVariables->GetVersion(m_handle);
+		if (version == 0) {
+			throw InvalidArgumentException("Environment variable does not exist.", varName);
+		}
+		if (version != m_outputVersion || !AreLinksSet()) {
+			this->GetOutput<0>().Set(m_envVariables->Get(m_handle));
+			m_outputVersion = version;
 		}
-		throw InvalidArgumentException("Environment variable does not exist.", varName);
 	}
 
 	void Execute(RenderContext& context) {}
 
 
-	void SetEnvVariableList(const std::unordered_map<std::string, Any>* envVars) {
+	/// <summary> Resolves the name of the variable, called once when the pipeline is installed. </summary>
+	void SetEnvVariableList(EnvVariables* envVars) {
 		m_envVariables = envVars;
+		m_handle = {};
+		m_outputVersion = 0;
+		if (envVars && this->GetInput<0>().IsSet()) {
+			m_handle = envVars->Intern(this->GetInput<0>().Get());
+		}
 	}
-	const std::unordered_map<std::string, Any>* SetEnvVariableList() const {
+	const EnvVariables* GetEnvVariableList() const {
 		return m_envVariables;
 	}
 
 private:
-	const std::unordered_map<std::string, Any>* m_envVariables;
+	// Some nodes clear their inputs once they've read them, those get the value again.
+	bool AreLinksSet() {
+		auto& output = this->GetOutput<0>();
+		return std::all_of(output.begin(), output.end(), [](const InputPortBase* input) { return input->IsSet(); });
+	}
+
+private:
+	const EnvVariables* m_envVariables = nullptr;
+	EnvVariableHandle m_handle;
+	uint64_t m_outputVersion = 0; // Version of the value last put on the output.
 };
 
 
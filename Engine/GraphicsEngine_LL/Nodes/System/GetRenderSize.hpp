@@ -0,0 +1,62 @@
+#pragma once
+
+#include <GraphicsEngine_LL/GraphicsNode.hpp>
+
+
+namespace inl::gxeng::nodes {
+
+
+/// <summary>
+/// The size to render the 3D scene at, the back buffer's size scaled by the dynamic resolution.
+/// Outputs: width, height.
+/// </summary>
+/// <remarks>
+/// Screen sized targets created from it change size with the scale,
+/// the result must be upscaled to the back buffer before drawing the overlays.
+/// </remarks>
+class GetRenderSize : virtual public GraphicsNode,
+					  public GraphicsTask,
+					  public InputPortConfig<>,
+					  public OutputPortConfig<unsigned, unsigned> {
+public:
+	static const char* Info_GetName() { return "GetRenderSize"; }
+	GetRenderSize() {}
+
+	void Update() override {}
+	void Notify(InputPortBase* sender) override {}
+	void Initialize(EngineContext& context) override {
+		GraphicsNode::SetTaskSingle(this);
+	}
+	void Reset() override {}
+
+	void Setup(SetupContext& context) override {
+		if (m_width == 0 || m_height == 0) {
+			throw InvalidStateException("You forgot to set the render size to this node.");
+		}
+		this->GetOutput<0>().Set(m_width);
+		this->GetOutput<1>().Set(m_height);
+	}
+
+	void Execute(RenderContext& context) override {}
+
+	const std::string& GetOutputName(size_t index) const override {
+		static const std::vector<std::string> names = {
+			"Width",
+			"Height",
+		};
+		return names[index];
+	}
+
+
+	void SetRenderSize(unsigned width, unsigned height) {
+		m_width = width;
+		m_height = height;
+	}
+
+private:
+	unsigned m_width = 0;
+	unsigned m_height = 0;
+};
+
+
+} // namespace inl::gxeng::nodes
@@ -3,6 +3,7 @@
 #include "GetCamera2DByName.hpp"
 #include "GetCameraByName.hpp"
 #include "GetEnvVariable.hpp"
+#include "GetRenderSize.hpp"
 #include "GetSceneByName.hpp"
 #include "GetTime.hpp"
 
@@ -17,6 +18,7 @@ bool g_autoRegisterSysNodes = [] {
 	GraphicsNodeFactory_Singleton::GetInstance().RegisterNodeClass<nodes::GetCamera2DByName>("");
 	GraphicsNodeFactory_Singleton::GetInstance().RegisterNodeClass<nodes::GetCameraByName>("");
 	GraphicsNodeFactory_Singleton::GetInstance().RegisterNodeClass<nodes::GetEnvVariable>("");
+	GraphicsNodeFactory_Singleton::GetInstance().RegisterNodeClass<nodes::GetRenderSize>("");
 	GraphicsNodeFactory_Singleton::GetInstance().RegisterNodeClass<nodes::GetSceneByName>("");
 	GraphicsNodeFactory_Singleton::GetInstance().RegisterNodeClass<nodes::GetTime>("");
 
@@ -38,6 +38,16 @@ Image* OverlayEntity::GetTexture() const {
 }
 
 
+void OverlayEntity::SetTextureRect(RectF rect) {
+	m_textureRect = rect;
+}
+
+
+RectF OverlayEntity::GetTextureRect() const {
+	return m_textureRect;
+}
+
+
 void OverlayEntity::SetZDepth(float z) {
 	m_zDepth = z;
 }
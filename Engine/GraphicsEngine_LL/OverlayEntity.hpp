@@ -32,6 +32,12 @@ public:
 	void SetTexture(IImage* texture) { SetTexture(static_cast<Image*>(texture)); }
 	void SetTexture(Image* texture);
 	Image* GetTexture() const override;
+
+	/// <summary> The part of the texture drawn on the object, in texture coordinates. </summary>
+	/// <remarks> Texture coordinate (0,0) of the object maps to (left, bottom), (1,1) to (right, top).
+	///		Defaults to the whole texture. </remarks>
+	void SetTextureRect(RectF rect) override;
+	RectF GetTextureRect() const override;
 	
 	/// <summary> Z-Depth determines which 2D entity lays over the other. </summary>
 	/// <remarks> Number are not limited to [0,1], anything is fine. Don't pass NaN and Inf. </remarks>
@@ -40,6 +46,7 @@ public:
 private:
 	Mesh* m_mesh = nullptr;
 	Image* m_texture = nullptr;
+	RectF m_textureRect = { 0.0f, 1.0f, 0.0f, 1.0f };
 	Vec4 m_color;
 	float m_zDepth = 0.0f;
 };
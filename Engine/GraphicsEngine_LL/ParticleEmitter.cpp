@@ -0,0 +1,181 @@
+#include "ParticleEmitter.hpp"
+
+#include <algorithm>
+
+namespace inl::gxeng {
+
+
+ParticleEmitter::ParticleEmitter(Vec3 position, Vec3 direction, float emissionRate, float lifetime
+):
+	m_position(position),
+	m_direction(direction),
+	m_emissionRate(emissionRate),
+	m_lifetime(lifetime)
+{}
+
+
+void ParticleEmitter::SetPosition(const Vec3& position) {
+	m_position = position;
+}
+
+
+void ParticleEmitter::SetRadius(float radius) {
+	m_radius = std::max(0.0f, radius);
+}
+
+
+void ParticleEmitter::SetDirection(const Vec3& direction) {
+	m_direction = direction;
+}
+
+
+void ParticleEmitter::SetSpread(float spread) {
+	m_spread = std::clamp(spread, 0.0f, Constants<float>::Pi);
+}
+
+
+void ParticleEmitter::SetSpeed(float speed, float variation) {
+	m_speed = speed;
+	m_speedVariation = variation;
+}
+
+
+void ParticleEmitter::SetEmissionRate(float emissionRate) {
+	m_emissionRate = std::max(0.0f, emissionRate);
+}
+
+
+void ParticleEmitter::SetLifetime(float lifetime, float variation) {
+	m_lifetime = std::max(0.0f, lifetime);
+	m_lifetimeVariation = std::clamp(variation, 0.0f, 1.0f);
+}
+
+
+void ParticleEmitter::SetSize(float startSize, float endSize) {
+	m_startSize = startSize;
+	m_endSize = endSize;
+}
+
+
+void ParticleEmitter::SetColor(const Vec4& startColor, const Vec4& endColor) {
+	m_startColor = startColor;
+	m_endColor = endColor;
+}
+
+
+void ParticleEmitter::SetAcceleration(const Vec3& acceleration) {
+	m_acceleration = acceleration;
+}
+
+
+void ParticleEmitter::SetDrag(float drag) {
+	m_drag = std::max(0.0f, drag);
+}
+
+
+void ParticleEmitter::SetRestitution(float restitution) {
+	m_restitution = std::min(restitution, 1.0f);
+}
+
+
+void ParticleEmitter::SetAdditive(float additive) {
+	m_additive = std::clamp(additive, 0.0f, 1.0f);
+}
+
+
+void ParticleEmitter::SetEmissive(float emissive) {
+	m_emissive = std::clamp(emissive, 0.0f, 1.0f);
+}
+
+
+Vec3 ParticleEmitter::GetPosition() const {
+	return m_position;
+}
+
+
+float ParticleEmitter::GetRadius() const {
+	return m_radius;
+}
+
+
+Vec3 ParticleEmitter::GetDirection() const {
+	return m_direction;
+}
+
+
+float ParticleEmitter::GetSpread() const {
+	return m_spread;
+}
+
+
+float ParticleEmitter::GetSpeed() const {
+	return m_speed;
+}
+
+
+float ParticleEmitter::GetSpeedVariation() const {
+	return m_speedVariation;
+}
+
+
+float ParticleEmitter::GetEmissionRate() const {
+	return m_emissionRate;
+}
+
+
+float ParticleEmitter::GetLifetime() const {
+	return m_lifetime;
+}
+
+
+float ParticleEmitter::GetLifetimeVariation() const {
+	return m_lifetimeVariation;
+}
+
+
+float ParticleEmitter::GetStartSize() const {
+	return m_startSize;
+}
+
+
+float ParticleEmitter::GetEndSize() const {
+	return m_endSize;
+}
+
+
+Vec4 ParticleEmitter::GetStartColor() const {
+	return m_startColor;
+}
+
+
+Vec4 ParticleEmitter::GetEndColor() const {
+	return m_endColor;
+}
+
+
+Vec3 ParticleEmitter::GetAcceleration() const {
+	return m_acceleration;
+}
+
+
+float ParticleEmitter::GetDrag() const {
+	return m_drag;
+}
+
+
+float ParticleEmitter::GetRestitution() const {
+	return m_restitution;
+}
+
+
+float ParticleEmitter::GetAdditive() const {
+	return m_additive;
+}
+
+
+float ParticleEmitter::GetEmissive() const {
+	return m_emissive;
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <InlineMath.hpp>
+
+namespace inl::gxeng {
+
+/// <summary> Spawns particles that the GPU simulates and draws as billboards facing the camera. </summary>
+/// <remarks> The particles live on the GPU alone, the emitter only describes how new ones start and behave.
+///		Changing the emitter affects the particles emitted afterwards. </remarks>
+class ParticleEmitter {
+public:
+	ParticleEmitter() = default;
+	ParticleEmitter(Vec3 position, Vec3 direction, float emissionRate, float lifetime);
+
+	void SetPosition(const Vec3& position);
+	/// <summary> Particles start at random points of a sphere of this radius around the position. </summary>
+	void SetRadius(float radius);
+	/// <summary> Particles start moving along this direction, deviating at most by the spread. </summary>
+	void SetDirection(const Vec3& direction);
+	/// <summary> Half angle of the cone of starting directions in radians, pi emits in all directions. </summary>
+	void SetSpread(float spread);
+	/// <summary> Particles start with a random speed in [speed - variation, speed + variation]. </summary>
+	void SetSpeed(float speed, float variation = 0.0f);
+	/// <summary> New particles per second. </summary>
+	void SetEmissionRate(float emissionRate);
+	/// <summary> Seconds a particle lives for, varied randomly by the given fraction. </summary>
+	void SetLifetime(float lifetime, float variation = 0.0f);
+	/// <summary> Width of a particle at its birth and death, linearly interpolated in between. </summary>
+	void SetSize(float startSize, float endSize);
+	/// <summary> Color and opacity of a particle at its birth and death, linearly interpolated in between. </summary>
+	void SetColor(const Vec4& startColor, const Vec4& endColor);
+	/// <summary> Constant acceleration of the particles, such as gravity or buoyancy. </summary>
+	void SetAcceleration(const Vec3& acceleration);
+	/// <summary> The fraction of their velocity particles lose in a second. </summary>
+	void SetDrag(float drag);
+	/// <summary> The fraction of their speed along the normal particles keep bouncing off the scene, negative to let them pass. </summary>
+	void SetRestitution(float restitution);
+	/// <summary> 0 to blend over what's behind, 1 to add to it, anything in between blends the two. </summary>
+	void SetAdditive(float additive);
+	/// <summary> 0 for a color lit by the lights, 1 for a color that glows on its own. </summary>
+	void SetEmissive(float emissive);
+
+	Vec3 GetPosition() const;
+	float GetRadius() const;
+	Vec3 GetDirection() const;
+	float GetSpread() const;
+	float GetSpeed() const;
+	float GetSpeedVariation() const;
+	float GetEmissionRate() const;
+	float GetLifetime() const;
+	float GetLifetimeVariation() const;
+	float GetStartSize() const;
+	float GetEndSize() const;
+	Vec4 GetStartColor() const;
+	Vec4 GetEndColor() const;
+	Vec3 GetAcceleration() const;
+	float GetDrag() const;
+	float GetRestitution() const;
+	float GetAdditive() const;
+	float GetEmissive() const;
+
+protected:
+	Vec3 m_position = { 0, 0, 0 };
+	float m_radius = 0.0f;
+	Vec3 m_direction = { 0, 0, 1 };
+	float m_spread = 0.25f;
+	float m_speed = 1.0f;
+	float m_speedVariation = 0.0f;
+	float m_emissionRate = 100.0f;
+	float m_lifetime = 2.0f;
+	float m_lifetimeVariation = 0.0f;
+	float m_startSize = 0.1f;
+	float m_endSize = 0.1f;
+	Vec4 m_startColor = { 1, 1, 1, 1 };
+	Vec4 m_endColor = { 1, 1, 1, 0 };
+	Vec3 m_acceleration = { 0, 0, 0 };
+	float m_drag = 0.0f;
+	float m_restitution = 0.5f;
+	float m_additive = 0.0f;
+	float m_emissive = 0.0f;
+};
+
+} // namespace inl::gxeng
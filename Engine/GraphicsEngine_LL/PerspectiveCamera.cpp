@@ -18,6 +18,9 @@ void PerspectiveCamera::SetFOVAxis(float horizontalFov, float verticalFov) {
 	m_fovH = horizontalFov;
 	m_fovV = verticalFov;
 }
+void PerspectiveCamera::SetJitter(Vec2 clipOffset) {
+	m_jitter = clipOffset;
+}
 
 
 // Get rendering properties.
@@ -30,6 +33,9 @@ float PerspectiveCamera::GetFOVHorizontal() const {
 float PerspectiveCamera::GetAspectRatio() const {
 	return m_fovH / m_fovV;
 }
+Vec2 PerspectiveCamera::GetJitter() const {
+	return m_jitter;
+}
 
 
 // Matrices
@@ -37,6 +43,13 @@ Mat44 PerspectiveCamera::GetViewMatrix() const {
 	return Mat44::LookAt(m_position, m_position + m_lookdir, m_upVector, true, false, false);
 }
 Mat44 PerspectiveCamera::GetProjectionMatrix() const {
+	// Adding the offset times w moves the projected points by the offset after the division.
+	Mat44 jitter = Mat44::Identity();
+	jitter(3, 0) = m_jitter.x;
+	jitter(3, 1) = m_jitter.y;
+	return GetUnjitteredProjectionMatrix() * jitter;
+}
+Mat44 PerspectiveCamera::GetUnjitteredProjectionMatrix() const {
 	return Mat44::Perspective(m_fovH, m_fovH / m_fovV, m_nearPlane, m_farPlane, 0, 1);
 }
 Mat44 PerspectiveCamera::GetPrevViewMatrix() const {
@@ -17,21 +17,27 @@ public:
 	// Set rendering properties.
 	void SetFOVAspect(float horizontalFov, float aspectRatio);
 	void SetFOVAxis(float horizontalFov, float verticalFov);
+	/// <summary> Shifts the projection by the given offset in clip space, for temporal anti-aliasing. </summary>
+	/// <remarks> Set by the engine every frame if temporal jitter is on, see <see cref="TemporalJitter"/>. </remarks>
+	void SetJitter(Vec2 clipOffset);
 
 	// Get rendering properties.
 	float GetFOVVertical() const;
 	float GetFOVHorizontal() const;
 
 	float GetAspectRatio() const override;
+	Vec2 GetJitter() const;
 
 	// Matrices
 	Mat44 GetViewMatrix() const override;
-	Mat44 GetProjectionMatrix() const override;
+	Mat44 GetProjectionMatrix() const override; // Includes the jitter.
+	Mat44 GetUnjitteredProjectionMatrix() const;
 	Mat44 GetPrevViewMatrix() const override;
 
 protected:
 	float m_fovH;
 	float m_fovV;
+	Vec2 m_jitter = { 0.0f, 0.0f };
 };
 
 
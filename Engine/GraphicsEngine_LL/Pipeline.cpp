@@ -4,18 +4,122 @@
 #include "Pipeline.hpp"
 #include "GraphicsNodeFactory.hpp"
 #include "GraphicsNode.hpp"
+#include "Nodes/System/GetBackBuffer.hpp"
 
 #include <BaseLibrary/Exception/Exception.hpp>
 #include <BaseLibrary/GraphEditor/GraphParser.hpp>
+#include <BaseLibrary/Serialization/BinaryStream.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <optional>
+#include <sstream>
+#include <tuple>
+#include <typeindex>
 #include <typeinfo>
+#include <unordered_map>
 
 
 namespace inl::gxeng {
 
 
+namespace {
+
+	constexpr char BinaryMagic[8] = { 'I', 'N', 'L', 'P', 'I', 'P', 'E', 'B' };
+	constexpr uint64_t BinaryVersion = 1;
+
+	enum class eBinaryChunk : uint32_t {
+		CLASSES = 1,
+		NODES = 2,
+		LINKS = 3,
+	};
+
+	// Default values are stored as one of these types, kind 0 is the string they convert from.
+	struct DefaultValueType {
+		bool (*matches)(const InputPortBase* port);
+		void (*write)(BinaryStreamWriter& writer, const InputPortBase* port);
+		void (*read)(BinaryStreamReader& reader, InputPortBase* port);
+	};
+
+	template <class T>
+	DefaultValueType MakeDefaultValueType() {
+		// Ports with other converters are stored as strings.
+		auto matches = [](const InputPortBase* port) {
+			return dynamic_cast<const InputPort<T>*>(port) != nullptr;
+		};
+		auto write = [](BinaryStreamWriter& writer, const InputPortBase* port) {
+			T value = static_cast<const InputPort<T>*>(port)->Get();
+			if constexpr (std::is_same_v<T, bool>) {
+				writer.WriteBool(value);
+			}
+			else if constexpr (std::is_same_v<T, float>) {
+				writer.WriteFloat(value);
+			}
+			else if constexpr (std::is_same_v<T, double>) {
+				writer.WriteDouble(value);
+			}
+			else if constexpr (std::is_signed_v<T>) {
+				writer.WriteVarintSigned(int64_t(value));
+			}
+			else {
+				writer.WriteVarint(uint64_t(value));
+			}
+		};
+		auto read = [](BinaryStreamReader& reader, InputPortBase* port) {
+			T value;
+			if constexpr (std::is_same_v<T, bool>) {
+				value = reader.ReadBool();
+			}
+			else if constexpr (std::is_same_v<T, float>) {
+				value = reader.ReadFloat();
+			}
+			else if constexpr (std::is_same_v<T, double>) {
+				value = reader.ReadDouble();
+			}
+			else if constexpr (std::is_signed_v<T>) {
+				value = T(reader.ReadVarintSigned());
+			}
+			else {
+				value = T(reader.ReadVarint());
+			}
+			port->SetConvert(value);
+		};
+		return { matches, write, read };
+	}
+
+	// The order is part of the format, append new types to the end.
+	const std::vector<DefaultValueType>& GetDefaultValueTypes() {
+		static const std::vector<DefaultValueType> types = {
+			MakeDefaultValueType<bool>(),
+			MakeDefaultValueType<char>(),
+			MakeDefaultValueType<signed char>(),
+			MakeDefaultValueType<unsigned char>(),
+			MakeDefaultValueType<short>(),
+			MakeDefaultValueType<unsigned short>(),
+			MakeDefaultValueType<int>(),
+			MakeDefaultValueType<unsigned int>(),
+			MakeDefaultValueType<long>(),
+			MakeDefaultValueType<unsigned long>(),
+			MakeDefaultValueType<long long>(),
+			MakeDefaultValueType<unsigned long long>(),
+			MakeDefaultValueType<float>(),
+			MakeDefaultValueType<double>(),
+		};
+		return types;
+	}
+
+	size_t ReadIndex(BinaryStreamReader& reader, size_t count) {
+		uint64_t index = reader.ReadVarint();
+		if (index >= count) {
+			throw InvalidArgumentException("Binary pipeline description is corrupt, index out of range.");
+		}
+		return size_t(index);
+	}
+
+} // namespace
+
+
 //------------------------------------------------------------------------------
 // Iterator
 //------------------------------------------------------------------------------
@@ -65,6 +169,8 @@ Pipeline::NodeIterator Pipeline::NodeIterator::operator++(int) const {
 
 Pipeline::Pipeline()
 	: m_nodeMap(m_dependencyGraph),
+	m_usedMap(m_dependencyGraph, true),
+	m_costHistory(m_dependencyGraph),
 	m_taskFunctionMap(m_taskGraph),
 	m_taskParentMap(m_taskGraph, lemon::INVALID)
 {}
@@ -75,6 +181,7 @@ Pipeline::Pipeline(Pipeline&& rhs) : Pipeline() {
 	lemon::DigraphCopy<decltype(rhs.m_dependencyGraph), decltype(this->m_dependencyGraph)>
 		depCopy(rhs.m_dependencyGraph, this->m_dependencyGraph);
 	depCopy.nodeMap(rhs.m_nodeMap, this->m_nodeMap);
+	depCopy.nodeMap(rhs.m_usedMap, this->m_usedMap);
 	depCopy.run();
 
 	lemon::DigraphCopy<decltype(rhs.m_taskGraph), decltype(this->m_taskGraph)>
@@ -104,12 +211,17 @@ Pipeline::~Pipeline() {
 }
 
 
-void Pipeline::CreateFromDescription(const std::string& jsonDescription, GraphicsNodeFactory& factory) {
+void Pipeline::CreateFromDescription(const std::string& description, GraphicsNodeFactory& factory, EngineContext engineContext) {
+	if (IsBinaryDescription(description)) {
+		CreateFromBinary(description, factory, engineContext);
+		return;
+	}
+
 	GraphParser parser;
 	std::vector<std::shared_ptr<NodeBase>> nodeObjects;
 
 	// Parse json.
-	parser.Parse(jsonDescription);
+	parser.Parse(description);
 
 	// Create nodes with initial values.
 	for (auto& nodeDesc : parser.GetNodes()) {
@@ -148,19 +260,99 @@ void Pipeline::CreateFromDescription(const std::string& jsonDescription, Graphic
 		srcp->Link(dstp);
 	}
 
-	// Finish by creating the actual pipeline.
-	EngineContext engineContext(1, 1);
-	for (auto& node : nodeObjects) {
-		if (auto graphicsNode = dynamic_cast<GraphicsNode*>(node.get())) {
-			graphicsNode->Initialize(engineContext);
+	CreateGraphs(nodeObjects, &engineContext);
+}
+
+
+void Pipeline::CreateFromBinary(const std::string& description, GraphicsNodeFactory& factory, EngineContext& engineContext) {
+	BinaryStreamReader reader(description.data(), description.size());
+	char magic[sizeof(BinaryMagic)]; // Checked by IsBinaryDescription.
+	reader.ReadBytes(magic, sizeof(magic));
+	if (reader.ReadVarint() > BinaryVersion) {
+		throw InvalidArgumentException("Binary pipeline description is of a newer version.");
+	}
+
+	const auto& valueTypes = GetDefaultValueTypes();
+	std::vector<const std::function<NodeBase*()>*> creators;
+	std::vector<std::shared_ptr<NodeBase>> nodeObjects;
+	bool hasClasses = false, hasNodes = false;
+
+	// Chunks of later versions are skipped.
+	while (!reader.IsEnd()) {
+		auto chunk = reader.BeginChunk();
+		switch (eBinaryChunk(chunk.tag)) {
+			case eBinaryChunk::CLASSES: {
+				// Each class is looked up once, however many nodes it has.
+				size_t numClasses = reader.ReadVarint();
+				creators.clear();
+				for (size_t i = 0; i < numClasses; ++i) {
+					std::string name = reader.ReadString();
+					auto creator = factory.FindCreator(name);
+					if (!creator) {
+						throw InvalidArgumentException("Node with given name not found.", name);
+					}
+					creators.push_back(creator);
+				}
+				hasClasses = true;
+				break;
+			}
+			case eBinaryChunk::NODES: {
+				if (!hasClasses) {
+					throw InvalidArgumentException("Binary pipeline description is corrupt, nodes precede their classes.");
+				}
+				size_t numNodes = reader.ReadVarint();
+				nodeObjects.clear();
+				for (size_t i = 0; i < numNodes; ++i) {
+					std::shared_ptr<NodeBase> nodeObject((*creators[ReadIndex(reader, creators.size())])());
+					std::string name = reader.ReadString();
+					if (!name.empty()) {
+						nodeObject->SetDisplayName(name);
+					}
+					size_t numDefaults = reader.ReadVarint();
+					for (size_t j = 0; j < numDefaults; ++j) {
+						InputPortBase* port = nodeObject->GetInput(ReadIndex(reader, nodeObject->GetNumInputs()));
+						size_t kind = ReadIndex(reader, valueTypes.size() + 1);
+						if (kind == 0) {
+							port->SetConvert(reader.ReadString());
+						}
+						else {
+							valueTypes[kind - 1].read(reader, port);
+						}
+					}
+					nodeObjects.push_back(std::move(nodeObject));
+				}
+				hasNodes = true;
+				break;
+			}
+			case eBinaryChunk::LINKS: {
+				if (!hasNodes) {
+					throw InvalidArgumentException("Binary pipeline description is corrupt, links precede their nodes.");
+				}
+				size_t numLinks = reader.ReadVarint();
+				for (size_t i = 0; i < numLinks; ++i) {
+					NodeBase* src = nodeObjects[ReadIndex(reader, nodeObjects.size())].get();
+					OutputPortBase* srcp = src->GetOutput(ReadIndex(reader, src->GetNumOutputs()));
+					NodeBase* dst = nodeObjects[ReadIndex(reader, nodeObjects.size())].get();
+					InputPortBase* dstp = dst->GetInput(ReadIndex(reader, dst->GetNumInputs()));
+					srcp->Link(dstp);
+				}
+				break;
+			}
+			default: break;
 		}
+		reader.EndChunk();
 	}
 
-	CreateFromNodesList(nodeObjects);
+	CreateGraphs(nodeObjects, &engineContext);
 }
 
 
 void Pipeline::CreateFromNodesList(const std::vector<std::shared_ptr<NodeBase>> nodes) {
+	CreateGraphs(nodes, nullptr);
+}
+
+
+void Pipeline::CreateGraphs(const std::vector<std::shared_ptr<NodeBase>>& nodes, EngineContext* engineContext) {
 	// Assign pipeline nodes to graph nodes.
 	for (auto pipelineNode : nodes) {
 		lemon::ListDigraph::Node graphNode = m_dependencyGraph.addNode();
@@ -168,8 +360,23 @@ void Pipeline::CreateFromNodesList(const std::vector<std::shared_ptr<NodeBase>>
 	}
 
 	try {
-		// Calculate dependency and task graphs.
+		// Calculate dependency and task graphs, unused nodes get no tasks.
 		CalculateDependencyGraph();
+		std::vector<bool> used = FindUsedNodes(std::vector<bool>(m_dependencyGraph.maxNodeId() + 1, false));
+		for (lemon::ListDigraph::NodeIt depNode(m_dependencyGraph); depNode != lemon::INVALID; ++depNode) {
+			m_usedMap[depNode] = used[m_dependencyGraph.id(depNode)];
+		}
+
+		// Unused nodes are not initialized either, effects cut off from the sinks cost nothing.
+		// The rest create their resources in their first setup, so disabled nodes don't allocate until enabled.
+		if (engineContext) {
+			for (lemon::ListDigraph::NodeIt depNode(m_dependencyGraph); depNode != lemon::INVALID; ++depNode) {
+				auto graphicsNode = dynamic_cast<GraphicsNode*>(m_nodeMap[depNode].get());
+				if (graphicsNode && m_usedMap[depNode]) {
+					graphicsNode->Initialize(*engineContext);
+				}
+			}
+		}
 		CalculateTaskGraph();
 
 		// Check if graphs are DAGs.
@@ -207,6 +414,112 @@ std::string Pipeline::SerializeToJSON(const NodeFactory& factory) const {
 }
 
 
+std::string Pipeline::SerializeToBinary(const NodeFactory& factory) const {
+	std::vector<const NodeBase*> nodes;
+	std::unordered_map<const OutputPortBase*, std::pair<size_t, size_t>> outputOwners;
+	for (lemon::ListDigraph::NodeIt it(m_dependencyGraph); it != lemon::INVALID; ++it) {
+		const NodeBase* node = m_nodeMap[it].get();
+		for (size_t i = 0; i < node->GetNumOutputs(); ++i) {
+			outputOwners.insert({ node->GetOutput(i), { nodes.size(), i } });
+		}
+		nodes.push_back(node);
+	}
+
+	std::vector<std::string> classNames;
+	std::unordered_map<std::type_index, size_t> classIndices;
+	std::vector<size_t> nodeClasses;
+	for (auto node : nodes) {
+		auto [it, isNew] = classIndices.insert({ typeid(*node), classNames.size() });
+		if (isNew) {
+			auto [group, className] = factory.GetFullName(typeid(*node));
+			classNames.push_back(group + "/" + className);
+		}
+		nodeClasses.push_back(it->second);
+	}
+
+	std::stringstream stream;
+	BinaryStreamWriter writer(stream);
+	writer.WriteBytes(BinaryMagic, sizeof(BinaryMagic));
+	writer.WriteVarint(BinaryVersion);
+
+	writer.BeginChunk(uint32_t(eBinaryChunk::CLASSES));
+	writer.WriteVarint(classNames.size());
+	for (auto& name : classNames) {
+		writer.WriteString(name);
+	}
+	writer.EndChunk();
+
+	const auto& valueTypes = GetDefaultValueTypes();
+	writer.BeginChunk(uint32_t(eBinaryChunk::NODES));
+	writer.WriteVarint(nodes.size());
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		const NodeBase* node = nodes[i];
+		writer.WriteVarint(nodeClasses[i]);
+		writer.WriteString(node->GetDisplayName());
+
+		// Kind 0 is a string, others index the value types from 1.
+		std::vector<std::tuple<size_t, size_t, std::string>> defaults;
+		for (size_t j = 0; j < node->GetNumInputs(); ++j) {
+			const InputPortBase* port = node->GetInput(j);
+			if (port->GetLink() || !port->IsSet()) {
+				continue;
+			}
+			auto valueType = std::find_if(valueTypes.begin(), valueTypes.end(), [&](const DefaultValueType& type) {
+				return type.matches(port);
+			});
+			if (valueType != valueTypes.end()) {
+				defaults.push_back({ j, size_t(valueType - valueTypes.begin()) + 1, {} });
+				continue;
+			}
+			// Same as the JSON, values that can't be written as strings are left out.
+			try {
+				defaults.push_back({ j, 0, port->ToString() });
+			}
+			catch (...) {
+			}
+		}
+
+		writer.WriteVarint(defaults.size());
+		for (auto& [port, kind, text] : defaults) {
+			writer.WriteVarint(port);
+			writer.WriteVarint(kind);
+			if (kind == 0) {
+				writer.WriteString(text);
+			}
+			else {
+				valueTypes[kind - 1].write(writer, node->GetInput(port));
+			}
+		}
+	}
+	writer.EndChunk();
+
+	std::vector<std::array<size_t, 4>> links;
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		for (size_t j = 0; j < nodes[i]->GetNumInputs(); ++j) {
+			auto it = outputOwners.find(nodes[i]->GetInput(j)->GetLink());
+			if (it != outputOwners.end()) {
+				links.push_back({ it->second.first, it->second.second, i, j });
+			}
+		}
+	}
+	writer.BeginChunk(uint32_t(eBinaryChunk::LINKS));
+	writer.WriteVarint(links.size());
+	for (auto& link : links) {
+		for (size_t index : link) {
+			writer.WriteVarint(index);
+		}
+	}
+	writer.EndChunk();
+
+	return stream.str();
+}
+
+
+bool Pipeline::IsBinaryDescription(const std::string& description) {
+	return description.size() >= sizeof(BinaryMagic) && std::equal(std::begin(BinaryMagic), std::end(BinaryMagic), description.begin());
+}
+
+
 void Pipeline::Clear() {
 	for (lemon::ListDigraph::NodeIt graphNode(m_dependencyGraph); graphNode != lemon::INVALID; ++graphNode) {
 		m_nodeMap[graphNode] = nullptr; // not necessary, but better make sure
@@ -255,6 +568,10 @@ void Pipeline::CalculateTaskGraph() {
 
 	// Iterate over each node in dependency graph
 	for (lemon::ListDigraph::NodeIt depNode(m_dependencyGraph); depNode != lemon::INVALID; ++depNode) {
+		if (!m_usedMap[depNode]) {
+			continue;
+		}
+
 		// Get pipeline node of this graph node
 		NodeBase* pipelineNode = m_nodeMap[depNode].get();
 		assert(pipelineNode != nullptr); // each graph node must have a pipeline node assigned
@@ -355,6 +672,9 @@ void Pipeline::CalculateTaskGraph() {
 
 	// Connect sources and sinks according to dependencyGraph
 	for (lemon::ListDigraph::ArcIt depArc(m_dependencyGraph); depArc != lemon::INVALID; ++depArc) {
+		if (!m_usedMap[m_dependencyGraph.target(depArc)]) {
+			continue; // Sources of used nodes are all used.
+		}
 		auto source = sourceSinkMapping[m_dependencyGraph.source(depArc)].sink;
 		auto target = sourceSinkMapping[m_dependencyGraph.target(depArc)].source;
 		m_taskGraph.addArc(source, target);
@@ -396,6 +716,147 @@ void Pipeline::CalculateDependencyGraph() {
 }
 
 
+std::vector<bool> Pipeline::FindUsedNodes(const std::vector<bool>& blocked) const {
+	size_t nodeCount = (size_t)m_dependencyGraph.maxNodeId() + 1;
+
+	// Everything linked after the back buffer ends up in it.
+	std::vector<bool> drawsToBackBuffer(nodeCount, false);
+	std::vector<lemon::ListDigraph::Node> stack;
+	for (lemon::ListDigraph::NodeIt depNode(m_dependencyGraph); depNode != lemon::INVALID; ++depNode) {
+		if (dynamic_cast<const nodes::GetBackBuffer*>(m_nodeMap[depNode].get())) {
+			stack.push_back(depNode);
+		}
+	}
+	while (!stack.empty()) {
+		auto node = stack.back();
+		stack.pop_back();
+		for (lemon::ListDigraph::OutArcIt outArc(m_dependencyGraph, node); outArc != lemon::INVALID; ++outArc) {
+			auto next = m_dependencyGraph.target(outArc);
+			if (!drawsToBackBuffer[m_dependencyGraph.id(next)]) {
+				drawsToBackBuffer[m_dependencyGraph.id(next)] = true;
+				stack.push_back(next);
+			}
+		}
+	}
+
+	bool hasSinks = false;
+	std::vector<bool> used(nodeCount, false);
+	for (lemon::ListDigraph::NodeIt depNode(m_dependencyGraph); depNode != lemon::INVALID; ++depNode) {
+		int id = m_dependencyGraph.id(depNode);
+		if (m_nodeMap[depNode]->GetNumOutputs() == 0 || drawsToBackBuffer[id]) {
+			hasSinks = true;
+			if (!blocked[id]) {
+				used[id] = true;
+				stack.push_back(depNode);
+			}
+		}
+	}
+	if (!hasSinks) {
+		return std::vector<bool>(nodeCount, true);
+	}
+
+	while (!stack.empty()) {
+		auto node = stack.back();
+		stack.pop_back();
+		for (lemon::ListDigraph::InArcIt inArc(m_dependencyGraph, node); inArc != lemon::INVALID; ++inArc) {
+			auto prev = m_dependencyGraph.source(inArc);
+			int id = m_dependencyGraph.id(prev);
+			if (!used[id] && !blocked[id]) {
+				used[id] = true;
+				stack.push_back(prev);
+			}
+		}
+	}
+	return used;
+}
+
+
+bool Pipeline::IsNodeUsed(const NodeBase* node) const {
+	for (lemon::ListDigraph::NodeIt depNode(m_dependencyGraph); depNode != lemon::INVALID; ++depNode) {
+		if (m_nodeMap[depNode].get() == node) {
+			return m_usedMap[depNode];
+		}
+	}
+	throw InvalidArgumentException("Node is not part of the pipeline.");
+}
+
+
+std::vector<const NodeBase*> Pipeline::GetUnusedNodes() const {
+	std::vector<const NodeBase*> unused;
+	for (lemon::ListDigraph::NodeIt depNode(m_dependencyGraph); depNode != lemon::INVALID; ++depNode) {
+		if (!m_usedMap[depNode]) {
+			unused.push_back(m_nodeMap[depNode].get());
+		}
+	}
+	return unused;
+}
+
+
+std::vector<bool> Pipeline::GetSkippedTasks(const std::vector<const NodeBase*>& disabledNodes) const {
+	// Disabled nodes block everything that depends on them.
+	std::vector<bool> blocked(m_dependencyGraph.maxNodeId() + 1, false);
+	std::vector<lemon::ListDigraph::Node> stack;
+	for (lemon::ListDigraph::NodeIt depNode(m_dependencyGraph); depNode != lemon::INVALID; ++depNode) {
+		if (std::find(disabledNodes.begin(), disabledNodes.end(), m_nodeMap[depNode].get()) != disabledNodes.end()) {
+			blocked[m_dependencyGraph.id(depNode)] = true;
+			stack.push_back(depNode);
+		}
+	}
+	while (!stack.empty()) {
+		auto node = stack.back();
+		stack.pop_back();
+		for (lemon::ListDigraph::OutArcIt outArc(m_dependencyGraph, node); outArc != lemon::INVALID; ++outArc) {
+			auto next = m_dependencyGraph.target(outArc);
+			if (!blocked[m_dependencyGraph.id(next)]) {
+				blocked[m_dependencyGraph.id(next)] = true;
+				stack.push_back(next);
+			}
+		}
+	}
+
+	std::vector<bool> used = FindUsedNodes(blocked);
+	std::vector<bool> skipped(m_taskGraph.maxNodeId() + 1, false);
+	for (lemon::ListDigraph::NodeIt task(m_taskGraph); task != lemon::INVALID; ++task) {
+		lemon::ListDigraph::Node parent = m_taskParentMap[task];
+		// Tasks without a parent only join other tasks, they do nothing themselves.
+		skipped[m_taskGraph.id(task)] = parent != lemon::INVALID && !used[m_dependencyGraph.id(parent)];
+	}
+	return skipped;
+}
+
+
+void Pipeline::RecordNodeCosts(const std::vector<NodeCost>& costs) {
+	std::lock_guard lkg(m_costMutex);
+	size_t slot = m_costFrames % CostHistoryLength;
+	for (lemon::ListDigraph::NodeIt depNode(m_dependencyGraph); depNode != lemon::INVALID; ++depNode) {
+		std::vector<NodeCost>& history = m_costHistory[depNode];
+		history.resize(CostHistoryLength);
+		history[slot] = costs[m_dependencyGraph.id(depNode)];
+	}
+	++m_costFrames;
+}
+
+
+std::vector<NodeCost> Pipeline::GetCostHistory(const std::string& displayName) const {
+	std::lock_guard lkg(m_costMutex);
+	for (lemon::ListDigraph::NodeIt depNode(m_dependencyGraph); depNode != lemon::INVALID; ++depNode) {
+		if (m_nodeMap[depNode]->GetDisplayName() != displayName) {
+			continue;
+		}
+		const std::vector<NodeCost>& history = m_costHistory[depNode];
+		if (m_costFrames < CostHistoryLength) {
+			return { history.begin(), history.begin() + m_costFrames };
+		}
+		// The oldest entry is the next one to be overwritten.
+		size_t oldest = m_costFrames % CostHistoryLength;
+		std::vector<NodeCost> ordered(history.begin() + oldest, history.end());
+		ordered.insert(ordered.end(), history.begin(), history.begin() + oldest);
+		return ordered;
+	}
+	return {};
+}
+
+
 bool Pipeline::IsLinked(NodeBase* srcNode, NodeBase* dstNode) {
 	for (size_t dstIn = 0; dstIn < dstNode->GetNumInputs(); dstIn++) {
 		OutputPortBase* linked = dstNode->GetInput(dstIn)->GetLink();
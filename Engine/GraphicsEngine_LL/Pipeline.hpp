@@ -5,6 +5,8 @@
 #include <iterator>
 #include <BaseLibrary/Graph/Node.hpp>
 #include <BaseLibrary/Graph/NodeFactory.hpp>
+#include <BaseLibrary/GraphEditor/IEditorGraph.hpp>
+#include <mutex>
 
 #include "GraphicsNode.hpp"
 
@@ -81,9 +83,19 @@ public:
 	Pipeline& operator=(Pipeline&&);
 	~Pipeline();
 
-	void CreateFromDescription(const std::string& jsonDescription, GraphicsNodeFactory& factory);
+	/// <summary> Creates the nodes from a JSON description or the binary one of <see cref="SerializeToBinary"/>. </summary>
+	/// <remarks> Only the nodes whose outputs reach a sink are initialized, with <paramref name="engineContext"/>.
+	///		The rest never get tasks, so they are left as created. </remarks>
+	void CreateFromDescription(const std::string& description, GraphicsNodeFactory& factory, EngineContext engineContext = {});
+	/// <summary> Creates the graphs of nodes that are already initialized. </summary>
 	void CreateFromNodesList(const std::vector<std::shared_ptr<NodeBase>> nodes);
 	std::string SerializeToJSON(const NodeFactory& factory) const;
+	/// <summary> Same contents as <see cref="SerializeToJSON"/> in a compact format that loads without parsing. </summary>
+	/// <remarks> Node classes are stored once in a table, nodes refer to them by index. Defaults of arithmetic
+	///		ports are stored as their values, other defaults as the strings that they convert from. </remarks>
+	std::string SerializeToBinary(const NodeFactory& factory) const;
+	/// <summary> True if the description was written by <see cref="SerializeToBinary"/>. </summary>
+	static bool IsBinaryDescription(const std::string& description);
 	void Clear();
 
 	NodeIterator begin();
@@ -99,25 +111,59 @@ public:
 	const lemon::ListDigraph::NodeMap<GraphicsTask*>& GetTaskFunctionMap() const;
 	const lemon::ListDigraph::NodeMap<lemon::ListDigraph::NodeIt>& GetTaskParentMap() const;
 
+	/// <summary> True if the outputs of the node reach a sink. Only these nodes have tasks in the task graph. </summary>
+	/// <remarks> Sinks are the nodes without outputs, and the nodes that draw into the back buffer,
+	///		that is, everything linked after a <see cref="nodes::GetBackBuffer"/> node.
+	///		If the pipeline has no sinks, all nodes are used. </remarks>
+	bool IsNodeUsed(const NodeBase* node) const;
+	/// <summary> The nodes that are left out of the task graph because their outputs reach no sink. </summary>
+	std::vector<const NodeBase*> GetUnusedNodes() const;
+	/// <summary> Finds the tasks to skip in a frame where some of the nodes are disabled. </summary>
+	/// <remarks> The tasks of a disabled node and of every node that depends on it are skipped.
+	///		Nodes whose outputs then only reach skipped nodes are skipped as well. </remarks>
+	/// <returns> A flag for each task, indexed by the ids of the task graph. </returns>
+	std::vector<bool> GetSkippedTasks(const std::vector<const NodeBase*>& disabledNodes) const;
+
+	/// <summary> Number of frames the cost history of the nodes goes back. </summary>
+	static constexpr size_t CostHistoryLength = 120;
+	/// <summary> Appends the costs measured in a frame to the history of each node. Thread safe. </summary>
+	/// <param name="costs"> Indexed by the ids of the dependency graph. </param>
+	void RecordNodeCosts(const std::vector<NodeCost>& costs);
+	/// <summary> Costs of the node with the display name in the recent frames, oldest first. Thread safe. </summary>
+	/// <returns> Empty if no node has the name. </returns>
+	std::vector<NodeCost> GetCostHistory(const std::string& displayName) const;
+
 	template <class T>
 	void AddNodeMetaData() = delete;
 	template <class T>
 	void AddArcMetaData() = delete;
 
 private:
+	void CreateFromBinary(const std::string& description, GraphicsNodeFactory& factory, EngineContext& engineContext);
+	/// <summary> Builds the dependency and task graphs. </summary>
+	/// <param name="engineContext"> If not null, the used nodes are initialized with it before their tasks are collected. </param>
+	void CreateGraphs(const std::vector<std::shared_ptr<NodeBase>>& nodes, EngineContext* engineContext);
 	void CalculateTaskGraph();
 	void CalculateDependencyGraph();
+	/// <summary> Marks the nodes that are ancestors of a sink, not going through blocked nodes. </summary>
+	/// <param name="blocked"> Indexed by the ids of the dependency graph. </param>
+	std::vector<bool> FindUsedNodes(const std::vector<bool>& blocked) const;
 	bool IsLinked(NodeBase* srcNode, NodeBase* dstNode);
 	static void TransitiveReduction(lemon::ListDigraph& graph);
 
 
 	lemon::ListDigraph m_dependencyGraph;
 	lemon::ListDigraph::NodeMap<std::shared_ptr<NodeBase>> m_nodeMap;
+	lemon::ListDigraph::NodeMap<bool> m_usedMap;
 	lemon::ListDigraph m_taskGraph;
 	lemon::ListDigraph::NodeMap<GraphicsTask*> m_taskFunctionMap;
 	lemon::ListDigraph::NodeMap<lemon::ListDigraph::NodeIt> m_taskParentMap;
 
 	std::vector<std::unique_ptr<SimpleNodeTask>> m_taskWrappers;
+
+	lemon::ListDigraph::NodeMap<std::vector<NodeCost>> m_costHistory; // Ring buffer of each node.
+	size_t m_costFrames = 0; // Frames recorded so far.
+	mutable std::mutex m_costMutex;
 };
 
 
@@ -9,16 +9,13 @@ namespace gxeng {
 
 PipelineEventDispatcher::PipelineEventDispatcher() {
 	state.reset(new State());
-	state->m_runDeviceThread = true;
 	state->m_runEventThread = true;
-	m_deviceSyncThread = std::thread(&PipelineEventDispatcher::DeviceSyncThread, state);
 	m_eventThread = std::thread(&PipelineEventDispatcher::DispatchThread, state);
 }
 
 PipelineEventDispatcher::PipelineEventDispatcher(PipelineEventDispatcher&& rhs) {
 	state = std::move(rhs.state);
 	m_eventThread = std::move(rhs.m_eventThread);
-	m_deviceSyncThread = std::move(rhs.m_deviceSyncThread);
 }
 
 PipelineEventDispatcher& PipelineEventDispatcher::operator=(PipelineEventDispatcher&& rhs) {
@@ -26,7 +23,6 @@ PipelineEventDispatcher& PipelineEventDispatcher::operator=(PipelineEventDispatc
 
 	state = std::move(rhs.state);
 	m_eventThread = std::move(rhs.m_eventThread);
-	m_deviceSyncThread = std::move(rhs.m_deviceSyncThread);
 
 	return *this;
 }
@@ -37,12 +33,6 @@ PipelineEventDispatcher::~PipelineEventDispatcher() noexcept {
 
 
 void PipelineEventDispatcher::Shutdown() {
-	if (m_deviceSyncThread.joinable()) {
-		state->m_runDeviceThread = false;
-		state->m_deviceCv.notify_all();
-		m_deviceSyncThread.join();
-	}
-
 	if (m_eventThread.joinable()) {
 		state->m_runEventThread = false;
 		state->m_eventCv.notify_all();
@@ -83,11 +73,7 @@ std::future<void> PipelineEventDispatcher::DispatchDeviceFrameBegin(SyncPoint de
 	action.premise = deviceEvent;
 
 	std::future<void> ret = action.signal.get_future();
-
-	std::unique_lock<std::mutex>  lkg(state->m_deviceEventMutex);
-	state->m_deviceEventActions.push(std::move(action));
-	state->m_deviceCv.notify_all();
-
+	PushDeviceEventAction(state, std::move(action));
 	return ret;
 }
 
@@ -97,11 +83,7 @@ std::future<void> PipelineEventDispatcher::DispatchDeviceFrameEnd(SyncPoint devi
 	action.premise = deviceEvent;
 
 	std::future<void> ret = action.signal.get_future();
-
-	std::unique_lock<std::mutex>  lkg(state->m_deviceEventMutex);
-	state->m_deviceEventActions.push(std::move(action));
-	state->m_deviceCv.notify_all();
-
+	PushDeviceEventAction(state, std::move(action));
 	return ret;
 }
 
@@ -166,25 +148,30 @@ void PipelineEventDispatcher::DispatchThread(std::shared_ptr<State> state) {
 	// 8. profit
 }
 
-void PipelineEventDispatcher::DeviceSyncThread(std::shared_ptr<State> state) {
-	SetCurrentThreadName("Event Dispatcher: Device Sync Thread");
-
-	while (state->m_runDeviceThread) {
-		std::unique_lock<std::mutex> lk(state->m_deviceEventMutex);
-		state->m_deviceCv.wait(lk, [&state] { return !state->m_deviceEventActions.empty() || !state->m_runDeviceThread; });
+void PipelineEventDispatcher::PushDeviceEventAction(std::shared_ptr<State> state, DeviceEventAction deviceEventAction) {
+	SyncPoint premise = deviceEventAction.premise;
+	uint64_t id;
+	{
+		std::lock_guard<std::mutex> lkg(state->m_deviceEventMutex);
+		id = state->m_firstDeviceEventId + state->m_deviceEventActions.size();
+		state->m_deviceEventActions.push_back(std::move(deviceEventAction));
+	}
 
-		std::vector<DeviceEventAction> events;
-		while (!state->m_deviceEventActions.empty()) {
-			events.push_back(std::move(state->m_deviceEventActions.front()));
-			state->m_deviceEventActions.pop();
-		}
+	// The callback keeps the state alive, the dispatcher may be gone by the time the GPU gets there.
+	premise.OnCompletion([state = std::move(state), id] {
+		OnDeviceEventReached(state.get(), id);
+	});
+}
 
-		lk.unlock();
+void PipelineEventDispatcher::OnDeviceEventReached(State* state, uint64_t id) {
+	std::lock_guard<std::mutex> lkg(state->m_deviceEventMutex);
+	state->m_deviceEventActions[id - state->m_firstDeviceEventId].isReached = true;
 
-		for (auto& event : events) {
-			event.premise.Wait();
-			PushEventAction(state.get(), EventAction{ std::move(event.action), std::move(event.signal) });
-		}
+	while (!state->m_deviceEventActions.empty() && state->m_deviceEventActions.front().isReached) {
+		DeviceEventAction& event = state->m_deviceEventActions.front();
+		PushEventAction(state, EventAction{ std::move(event.action), std::move(event.signal) });
+		state->m_deviceEventActions.pop_front();
+		++state->m_firstDeviceEventId;
 	}
 }
 
@@ -5,6 +5,7 @@
 
 #include <future>
 #include <cstdint>
+#include <deque>
 #include <set>
 #include <queue>
 #include <mutex>
@@ -22,6 +23,7 @@ class PipelineEventDispatcher {
 	};
 	struct DeviceEventAction : EventAction {
 		SyncPoint premise; // NOT prOmise
+		bool isReached = false;
 	};
 	enum eReasonForAwake {
 		CANCEL = 0,
@@ -34,10 +36,10 @@ class PipelineEventDispatcher {
 		std::condition_variable m_eventCv;
 		std::atomic_bool m_runEventThread;
 
-		std::queue<DeviceEventAction> m_deviceEventActions;
+		// Device events are dispatched in order, each waits for the ones before it even if its premise is reached.
+		std::deque<DeviceEventAction> m_deviceEventActions;
+		uint64_t m_firstDeviceEventId = 0; // Id of the front of the queue.
 		std::mutex m_deviceEventMutex;
-		std::condition_variable m_deviceCv;
-		std::atomic_bool m_runDeviceThread;
 
 		std::mutex m_listenerMutex;
 		std::set<PipelineEventListener*> m_listeners;
@@ -62,14 +64,14 @@ public:
 	void operator-=(PipelineEventListener* listener);
 private:
 	static void DispatchThread(std::shared_ptr<State> state);
-	static void DeviceSyncThread(std::shared_ptr<State> state);
+	static void PushDeviceEventAction(std::shared_ptr<State> state, DeviceEventAction deviceEventAction);
+	static void OnDeviceEventReached(State* state, uint64_t id);
 	static void PushEventAction(State* state, EventAction eventAction);
 	void Shutdown();
 private:
 	std::shared_ptr<State> state;
 
 	std::thread m_eventThread;
-	std::thread m_deviceSyncThread;
 };
 
 
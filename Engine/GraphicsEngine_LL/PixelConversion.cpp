@@ -0,0 +1,381 @@
+#include "PixelConversion.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+#include <BaseLibrary/JobSystem/Parallel.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define INL_PIXEL_CONVERSION_SSE2
+#endif
+#if defined(_M_X64) || defined(__SSSE3__)
+#include <tmmintrin.h>
+#define INL_PIXEL_CONVERSION_SSSE3
+#endif
+
+
+namespace inl::gxeng {
+
+
+static size_t ChannelSize(ePixelChannelType type) {
+	switch (type) {
+		case ePixelChannelType::INT8_NORM: return 1;
+		case ePixelChannelType::INT16_NORM: return 2;
+		case ePixelChannelType::INT32: return 4;
+		case ePixelChannelType::FLOAT32: return 4;
+		default: return 0;
+	}
+}
+
+
+static bool IsIdentity(const PixelConversion::Swizzle& swizzle, int channelCount) {
+	for (int i = 0; i < channelCount; ++i) {
+		if (swizzle[i] != i) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+static const float* SrgbTable8() {
+	static const auto table = [] {
+		std::array<float, 256> values;
+		for (int i = 0; i < 256; ++i) {
+			values[i] = PixelConversion::SrgbToLinear(float(i) / 255.0f);
+		}
+		return values;
+	}();
+	return table.data();
+}
+
+
+//------------------------------------------------------------------------------
+// Same channel type, channels are moved around but values are not converted.
+//------------------------------------------------------------------------------
+
+template <class T>
+static void CopyChannels(const T* source, int sourceCount, T* destination, int destinationCount, size_t width, const PixelConversion::Swizzle& swizzle, T one) {
+	for (size_t x = 0; x < width; ++x) {
+		for (int c = 0; c < destinationCount; ++c) {
+			int sourceChannel = swizzle[c];
+			destination[c] = sourceChannel >= 0 && sourceChannel < sourceCount ? source[sourceChannel] : (c == 3 ? one : T(0));
+		}
+		source += sourceCount;
+		destination += destinationCount;
+	}
+}
+
+
+static void ExpandRgb8(const uint8_t* source, uint8_t* destination, size_t width) {
+	size_t x = 0;
+#ifdef INL_PIXEL_CONVERSION_SSSE3
+	// Four pixels per iteration, the load reads 4 bytes past them, which the loop bound leaves room for.
+	const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	const __m128i alpha = _mm_set1_epi32(int(0xFF000000));
+	for (; x + 6 <= width; x += 4) {
+		__m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 3 * x));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + 4 * x), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+	}
+#endif
+	CopyChannels<uint8_t>(source + 3 * x, 3, destination + 4 * x, 4, width - x, PixelConversion::Identity, 255);
+}
+
+
+//------------------------------------------------------------------------------
+// Same channel layout, every value is converted on its own.
+//------------------------------------------------------------------------------
+
+template <class T>
+static T Quantize(float value) {
+	constexpr float maxValue = float(std::numeric_limits<T>::max());
+	value = value > 0.0f ? value : 0.0f; // NaN becomes 0 as well.
+	return T(std::min(value, 1.0f) * maxValue + 0.5f);
+}
+
+
+static void Uint8ToFloat(const uint8_t* source, float* destination, size_t count) {
+	constexpr float scale = 1.0f / 255.0f;
+	size_t i = 0;
+#ifdef INL_PIXEL_CONVERSION_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scaleVec = _mm_set1_ps(scale);
+	for (; i + 16 <= count; i += 16) {
+		__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+		__m128i low = _mm_unpacklo_epi8(bytes, zero);
+		__m128i high = _mm_unpackhi_epi8(bytes, zero);
+		_mm_storeu_ps(destination + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), scaleVec));
+		_mm_storeu_ps(destination + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), scaleVec));
+		_mm_storeu_ps(destination + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), scaleVec));
+		_mm_storeu_ps(destination + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), scaleVec));
+	}
+#endif
+	for (; i < count; ++i) {
+		destination[i] = float(source[i]) * scale;
+	}
+}
+
+
+static void Uint16ToFloat(const uint16_t* source, float* destination, size_t count) {
+	constexpr float scale = 1.0f / 65535.0f;
+	size_t i = 0;
+#ifdef INL_PIXEL_CONVERSION_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scaleVec = _mm_set1_ps(scale);
+	for (; i + 8 <= count; i += 8) {
+		__m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+		_mm_storeu_ps(destination + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero)), scaleVec));
+		_mm_storeu_ps(destination + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(words, zero)), scaleVec));
+	}
+#endif
+	for (; i < count; ++i) {
+		destination[i] = float(source[i]) * scale;
+	}
+}
+
+
+#ifdef INL_PIXEL_CONVERSION_SSE2
+static __m128i QuantizeVec(const float* source, __m128 maxValue) {
+	__m128 value = _mm_max_ps(_mm_loadu_ps(source), _mm_setzero_ps());
+	value = _mm_min_ps(value, _mm_set1_ps(1.0f));
+	return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, maxValue), _mm_set1_ps(0.5f)));
+}
+#endif
+
+
+static void FloatToUint8(const float* source, uint8_t* destination, size_t count) {
+	size_t i = 0;
+#ifdef INL_PIXEL_CONVERSION_SSE2
+	const __m128 maxValue = _mm_set1_ps(255.0f);
+	for (; i + 16 <= count; i += 16) {
+		__m128i low = _mm_packs_epi32(QuantizeVec(source + i, maxValue), QuantizeVec(source + i + 4, maxValue));
+		__m128i high = _mm_packs_epi32(QuantizeVec(source + i + 8, maxValue), QuantizeVec(source + i + 12, maxValue));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(low, high));
+	}
+#endif
+	for (; i < count; ++i) {
+		destination[i] = Quantize<uint8_t>(source[i]);
+	}
+}
+
+
+static void FloatToUint16(const float* source, uint16_t* destination, size_t count) {
+	size_t i = 0;
+#ifdef INL_PIXEL_CONVERSION_SSE2
+	// SSE2 only packs to signed words, the values are shifted into their range and the sign bit flipped back.
+	const __m128 maxValue = _mm_set1_ps(65535.0f);
+	const __m128i bias = _mm_set1_epi32(32768);
+	const __m128i signBit = _mm_set1_epi16(int16_t(0x8000));
+	for (; i + 8 <= count; i += 8) {
+		__m128i low = _mm_sub_epi32(QuantizeVec(source + i, maxValue), bias);
+		__m128i high = _mm_sub_epi32(QuantizeVec(source + i + 4, maxValue), bias);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_xor_si128(_mm_packs_epi32(low, high), signBit));
+	}
+#endif
+	for (; i < count; ++i) {
+		destination[i] = Quantize<uint16_t>(source[i]);
+	}
+}
+
+
+static bool ConvertValues(const void* source, ePixelChannelType sourceType, void* destination, ePixelChannelType destinationType, size_t count) {
+	using T = ePixelChannelType;
+	if (sourceType == T::INT8_NORM && destinationType == T::FLOAT32) {
+		Uint8ToFloat(static_cast<const uint8_t*>(source), static_cast<float*>(destination), count);
+	}
+	else if (sourceType == T::INT16_NORM && destinationType == T::FLOAT32) {
+		Uint16ToFloat(static_cast<const uint16_t*>(source), static_cast<float*>(destination), count);
+	}
+	else if (sourceType == T::FLOAT32 && destinationType == T::INT8_NORM) {
+		FloatToUint8(static_cast<const float*>(source), static_cast<uint8_t*>(destination), count);
+	}
+	else if (sourceType == T::FLOAT32 && destinationType == T::INT16_NORM) {
+		FloatToUint16(static_cast<const float*>(source), static_cast<uint16_t*>(destination), count);
+	}
+	else {
+		return false;
+	}
+	return true;
+}
+
+
+//------------------------------------------------------------------------------
+// Anything else goes through linear floats, a pixel at a time.
+//------------------------------------------------------------------------------
+
+static float LoadChannel(const uint8_t* pixel, ePixelChannelType type, int channel) {
+	switch (type) {
+		case ePixelChannelType::INT8_NORM: return float(pixel[channel]) * (1.0f / 255.0f);
+		case ePixelChannelType::INT16_NORM: {
+			uint16_t value;
+			std::memcpy(&value, pixel + 2 * channel, sizeof(value));
+			return float(value) * (1.0f / 65535.0f);
+		}
+		default: {
+			float value;
+			std::memcpy(&value, pixel + 4 * channel, sizeof(value));
+			return value;
+		}
+	}
+}
+
+
+static void StoreChannel(uint8_t* pixel, ePixelChannelType type, int channel, float value) {
+	switch (type) {
+		case ePixelChannelType::INT8_NORM: pixel[channel] = Quantize<uint8_t>(value); break;
+		case ePixelChannelType::INT16_NORM: {
+			uint16_t quantized = Quantize<uint16_t>(value);
+			std::memcpy(pixel + 2 * channel, &quantized, sizeof(quantized));
+			break;
+		}
+		default: std::memcpy(pixel + 4 * channel, &value, sizeof(value)); break;
+	}
+}
+
+
+static void ConvertPixels(const uint8_t* source, const PixelFormat& sourceFormat, uint8_t* destination, const PixelFormat& destinationFormat, size_t width, const PixelConversion::Swizzle& swizzle) {
+	const size_t sourceSize = PixelConversion::PixelSize(sourceFormat);
+	const size_t destinationSize = PixelConversion::PixelSize(destinationFormat);
+	const bool tableDecode = sourceFormat.srgb && sourceFormat.channelType == ePixelChannelType::INT8_NORM;
+	const float* srgbTable = tableDecode ? SrgbTable8() : nullptr;
+	for (size_t x = 0; x < width; ++x) {
+		for (int c = 0; c < destinationFormat.channelCount; ++c) {
+			const int sourceChannel = swizzle[c];
+			float value = c == 3 ? 1.0f : 0.0f;
+			if (sourceChannel >= 0 && sourceChannel < sourceFormat.channelCount) {
+				const bool isColor = sourceChannel < 3;
+				if (tableDecode && isColor) {
+					value = srgbTable[source[sourceChannel]];
+				}
+				else {
+					value = LoadChannel(source, sourceFormat.channelType, sourceChannel);
+					value = sourceFormat.srgb && isColor ? PixelConversion::SrgbToLinear(value) : value;
+				}
+			}
+			if (destinationFormat.srgb && c < 3) {
+				value = PixelConversion::LinearToSrgb(value);
+			}
+			StoreChannel(destination, destinationFormat.channelType, c, value);
+		}
+		source += sourceSize;
+		destination += destinationSize;
+	}
+}
+
+
+static void ConvertRowUnchecked(const void* source, const PixelFormat& sourceFormat, void* destination, const PixelFormat& destinationFormat, size_t width, const PixelConversion::Swizzle& swizzle) {
+	const bool sameLayout = sourceFormat.channelCount == destinationFormat.channelCount && IsIdentity(swizzle, destinationFormat.channelCount);
+	const bool sameEncoding = sourceFormat.srgb == destinationFormat.srgb;
+
+	if (sourceFormat.channelType == destinationFormat.channelType && sameEncoding) {
+		if (sameLayout) {
+			std::memcpy(destination, source, width * PixelConversion::PixelSize(sourceFormat));
+			return;
+		}
+		const int sourceCount = sourceFormat.channelCount;
+		const int destinationCount = destinationFormat.channelCount;
+		switch (sourceFormat.channelType) {
+			case ePixelChannelType::INT8_NORM:
+				if (sourceCount == 3 && destinationCount == 4 && IsIdentity(swizzle, 4)) {
+					ExpandRgb8(static_cast<const uint8_t*>(source), static_cast<uint8_t*>(destination), width);
+				}
+				else {
+					CopyChannels(static_cast<const uint8_t*>(source), sourceCount, static_cast<uint8_t*>(destination), destinationCount, width, swizzle, uint8_t(0xFF));
+				}
+				return;
+			case ePixelChannelType::INT16_NORM:
+				CopyChannels(static_cast<const uint16_t*>(source), sourceCount, static_cast<uint16_t*>(destination), destinationCount, width, swizzle, uint16_t(0xFFFF));
+				return;
+			case ePixelChannelType::INT32:
+				CopyChannels(static_cast<const uint32_t*>(source), sourceCount, static_cast<uint32_t*>(destination), destinationCount, width, swizzle, 1u);
+				return;
+			default:
+				CopyChannels(static_cast<const float*>(source), sourceCount, static_cast<float*>(destination), destinationCount, width, swizzle, 1.0f);
+				return;
+		}
+	}
+
+	if (sameLayout && sameEncoding && ConvertValues(source, sourceFormat.channelType, destination, destinationFormat.channelType, width * sourceFormat.channelCount)) {
+		return;
+	}
+
+	ConvertPixels(static_cast<const uint8_t*>(source), sourceFormat, static_cast<uint8_t*>(destination), destinationFormat, width, swizzle);
+}
+
+
+//------------------------------------------------------------------------------
+// Public interface.
+//------------------------------------------------------------------------------
+
+bool PixelConversion::IsSupported(const PixelFormat& source, const PixelFormat& destination) {
+	auto isValid = [](const PixelFormat& format) {
+		return ChannelSize(format.channelType) > 0 && format.channelCount >= 1 && format.channelCount <= 4;
+	};
+	if (!isValid(source) || !isValid(destination)) {
+		return false;
+	}
+	// Integers are not normalized, they only keep their values going to integers.
+	if (source.channelType == ePixelChannelType::INT32 || destination.channelType == ePixelChannelType::INT32) {
+		return source.channelType == destination.channelType && !source.srgb && !destination.srgb;
+	}
+	return true;
+}
+
+
+size_t PixelConversion::PixelSize(const PixelFormat& format) {
+	return ChannelSize(format.channelType) * format.channelCount;
+}
+
+
+void PixelConversion::ConvertRow(const void* source, const PixelFormat& sourceFormat, void* destination, const PixelFormat& destinationFormat, size_t width, const Swizzle& swizzle) {
+	if (!IsSupported(sourceFormat, destinationFormat)) {
+		throw InvalidArgumentException("Pixel formats can't be converted into each other.");
+	}
+	ConvertRowUnchecked(source, sourceFormat, destination, destinationFormat, width, swizzle);
+}
+
+
+void PixelConversion::Convert(const void* source,
+							  size_t sourcePitch,
+							  const PixelFormat& sourceFormat,
+							  void* destination,
+							  size_t destinationPitch,
+							  const PixelFormat& destinationFormat,
+							  size_t width,
+							  size_t height,
+							  const Swizzle& swizzle,
+							  jobs::Scheduler* scheduler) {
+	if (!IsSupported(sourceFormat, destinationFormat)) {
+		throw InvalidArgumentException("Pixel formats can't be converted into each other.");
+	}
+	if (width == 0) {
+		return;
+	}
+
+	const uint8_t* sourceBytes = static_cast<const uint8_t*>(source);
+	uint8_t* destinationBytes = static_cast<uint8_t*>(destination);
+	const size_t rowsPerChunk = std::max(size_t(1), ChunkPixelCount / width);
+	jobs::CooperativeFor(scheduler, height, rowsPerChunk, [&](size_t first, size_t last) {
+		for (size_t y = first; y < last; ++y) {
+			ConvertRowUnchecked(sourceBytes + y * sourcePitch, sourceFormat, destinationBytes + y * destinationPitch, destinationFormat, width, swizzle);
+		}
+	});
+}
+
+
+float PixelConversion::SrgbToLinear(float value) {
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+
+float PixelConversion::LinearToSrgb(float value) {
+	return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <GraphicsEngine/Resources/Pixel.hpp>
+
+
+namespace inl::jobs {
+class Scheduler;
+} // namespace inl::jobs
+
+
+namespace inl::gxeng {
+
+
+/// <summary> How the channels of a pixel are laid out in memory. </summary>
+struct PixelFormat {
+	ePixelChannelType channelType;
+	int channelCount;
+	bool srgb = false; // The color channels are sRGB encoded, alpha is always linear.
+
+	bool operator==(const PixelFormat& rhs) const { return channelType == rhs.channelType && channelCount == rhs.channelCount && srgb == rhs.srgb; }
+	bool operator!=(const PixelFormat& rhs) const { return !(*this == rhs); }
+};
+
+
+/// <summary>
+/// Converts pixels between channel types, channel counts and color encodings, for uploading them as the texture stores them.
+/// </summary>
+/// <remarks>
+/// Supported channel types are 8 and 16 bit normalized integers and 32 bit floats, 1 to 4 channels each.
+/// 32 bit integer pixels can only be converted to 32 bit integers.
+/// Integers are normalized to [0, 1] when converted to floats, floats are clamped to [0, 1] and rounded when converted to integers.
+/// Channels the destination has but the source does not are 0 for color, and fully opaque for alpha.
+/// Expanding 8 bit RGB to RGBA and converting integers to floats or back use SSE, sRGB decoding from 8 bits uses a table.
+/// </remarks>
+class PixelConversion {
+public:
+	/// <summary> The source channel of each destination channel, -1 for the default value. </summary>
+	using Swizzle = std::array<int, 4>;
+	/// <summary> Channels stay in place. </summary>
+	static constexpr Swizzle Identity = { 0, 1, 2, 3 };
+	/// <summary> Swaps red and blue, for BGRA pixels. </summary>
+	static constexpr Swizzle SwapRedBlue = { 2, 1, 0, 3 };
+
+	static bool IsSupported(const PixelFormat& source, const PixelFormat& destination);
+	/// <summary> Bytes of a pixel in the given format. </summary>
+	static size_t PixelSize(const PixelFormat& format);
+
+	/// <summary> Converts <paramref name="width"/> pixels. </summary>
+	/// <exception cref="InvalidArgumentException"> If the conversion is not supported. </exception>
+	static void ConvertRow(const void* source, const PixelFormat& sourceFormat, void* destination, const PixelFormat& destinationFormat, size_t width, const Swizzle& swizzle = Identity);
+
+	/// <summary> Converts a block of pixels row by row. </summary>
+	/// <param name="sourcePitch"> Bytes from the start of one source row to the next. </param>
+	/// <param name="destinationPitch"> Bytes from the start of one destination row to the next. </param>
+	/// <param name="scheduler"> Rows of large blocks are split across helper jobs from this, null converts on the calling thread. </param>
+	/// <exception cref="InvalidArgumentException"> If the conversion is not supported. </exception>
+	static void Convert(const void* source,
+						size_t sourcePitch,
+						const PixelFormat& sourceFormat,
+						void* destination,
+						size_t destinationPitch,
+						const PixelFormat& destinationFormat,
+						size_t width,
+						size_t height,
+						const Swizzle& swizzle = Identity,
+						jobs::Scheduler* scheduler = nullptr);
+
+	static float SrgbToLinear(float value);
+	static float LinearToSrgb(float value);
+
+	/// <summary> Pixels converted by a job at least, smaller blocks are not worth splitting. </summary>
+	static constexpr size_t ChunkPixelCount = 64 * 1024;
+};
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,44 @@
+#include "PointLight.hpp"
+
+namespace inl::gxeng {
+
+
+PointLight::PointLight(Vec3 position, Vec3 color, float range
+):
+	m_position(position),
+	m_color(color),
+	m_range(range)
+{}
+
+
+void PointLight::SetPosition(const Vec3& position) {
+	m_position = position;
+}
+
+
+void PointLight::SetColor(const Vec3& color) {
+	m_color = color;
+}
+
+
+void PointLight::SetRange(float range) {
+	m_range = range;
+}
+
+
+Vec3 PointLight::GetPosition() const {
+	return m_position;
+}
+
+
+Vec3 PointLight::GetColor() const {
+	return m_color;
+}
+
+
+float PointLight::GetRange() const {
+	return m_range;
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <InlineMath.hpp>
+
+namespace inl::gxeng {
+
+/// <summary> Light radiating equally in all directions from a point, fading out linearly until its range. </summary>
+class PointLight {
+public:
+	PointLight() = default;
+	PointLight(Vec3 position, Vec3 color, float range);
+
+	void SetPosition(const Vec3& position);
+	void SetColor(const Vec3& color);
+	/// <summary> Distance where the light fades out completely. </summary>
+	void SetRange(float range);
+
+	Vec3 GetPosition() const;
+	Vec3 GetColor() const;
+	float GetRange() const;
+
+protected:
+	Vec3 m_position = { 0, 0, 0 };
+	Vec3 m_color = { 1, 1, 1 };
+	float m_range = 1.0f;
+};
+
+} // namespace inl::gxeng
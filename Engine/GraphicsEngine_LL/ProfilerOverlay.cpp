@@ -0,0 +1,105 @@
+#include "ProfilerOverlay.hpp"
+
+#include "Scene.hpp"
+
+#include <BaseLibrary/StringUtil.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+
+namespace inl::gxeng {
+
+
+namespace {
+
+std::string FormatLine(uint32_t depth, const char* name, double milliseconds) {
+	char time[32];
+	std::snprintf(time, sizeof(time), "%.2f ms", milliseconds);
+	return std::string(2 * depth, ' ') + name + "  " + time;
+}
+
+} // namespace
+
+
+ProfilerOverlay::ProfilerOverlay(Scene& scene, const Font* font, Vec2 topLeft, Vec2 lineSize)
+	: m_scene(scene), m_font(font), m_topLeft(topLeft), m_lineSize(lineSize) {}
+
+
+ProfilerOverlay::~ProfilerOverlay() {
+	auto& texts = m_scene.GetEntities<ITextEntity>();
+	for (auto& line : m_lines) {
+		texts.Remove(line.get());
+	}
+}
+
+
+void ProfilerOverlay::Update(const ProfiledFrame& cpuFrame, const GpuFrameReport& gpuFrame) {
+	std::vector<std::string> lines = FormatLines(cpuFrame, gpuFrame);
+	auto& texts = m_scene.GetEntities<ITextEntity>();
+
+	while (m_lines.size() > lines.size()) {
+		texts.Remove(m_lines.back().get());
+		m_lines.pop_back();
+	}
+	while (m_lines.size() < lines.size()) {
+		auto line = std::make_unique<TextEntity>();
+		line->SetFont(m_font);
+		line->SetFontSize(m_lineSize.y);
+		line->SetSize(m_lineSize);
+		line->SetColor({ 1, 1, 1, 1 });
+		line->SetHorizontalAlignment(TextEntity::ALIGN_LEFT);
+		line->SetZDepth(1000.0f);
+		float row = float(m_lines.size()) + 0.5f;
+		line->SetPosition({ m_topLeft.x + 0.5f * m_lineSize.x, m_topLeft.y - row * m_lineSize.y }); // Position is the center of the box.
+		texts.Add(line.get());
+		m_lines.push_back(std::move(line));
+	}
+
+	for (size_t i = 0; i < lines.size(); ++i) {
+		m_lines[i]->SetText(EncodeString<char32_t>(lines[i]));
+	}
+}
+
+
+std::vector<std::string> ProfilerOverlay::FormatLines(const ProfiledFrame& cpuFrame, const GpuFrameReport& gpuFrame) {
+	struct Total {
+		const char* name;
+		uint32_t depth;
+		double milliseconds;
+	};
+	std::vector<Total> totals;
+	for (const auto& zone : cpuFrame.zones) {
+		auto it = std::find_if(totals.begin(), totals.end(), [&zone](const Total& total) { return std::strcmp(total.name, zone.name) == 0; });
+		if (it == totals.end()) {
+			totals.push_back({ zone.name, zone.depth, 0.0 });
+			it = totals.end() - 1;
+		}
+		it->depth = std::min(it->depth, zone.depth);
+		it->milliseconds += (zone.end - zone.begin) * 1000.0;
+	}
+
+	std::vector<std::string> lines;
+	lines.push_back(FormatLine(0, ("CPU frame " + std::to_string(cpuFrame.index)).c_str(), (cpuFrame.end - cpuFrame.begin) * 1000.0));
+	for (const auto& total : totals) {
+		lines.push_back(FormatLine(total.depth + 1, total.name, total.milliseconds));
+	}
+
+	double gpuTotal = 0.0;
+	for (const auto& node : gpuFrame.nodes) {
+		gpuTotal += node.name.find('/') == std::string::npos ? node.milliseconds : 0.0; // Sub-scopes are inside their node.
+	}
+	lines.push_back(FormatLine(0, ("GPU frame " + std::to_string(gpuFrame.frame)).c_str(), gpuTotal));
+	for (const auto& node : gpuFrame.nodes) {
+		lines.push_back(FormatLine(1, node.name.c_str(), node.milliseconds));
+	}
+
+	if (lines.size() > MaxLines) {
+		lines.resize(MaxLines);
+	}
+	return lines;
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "GpuProfiler.hpp"
+#include "TextEntity.hpp"
+
+#include <BaseLibrary/FrameProfiler.hpp>
+
+#include <InlineMath.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+class Scene;
+class Font;
+
+
+/// <summary>
+/// Shows the CPU zones and GPU node times of a frame as text in a scene.
+/// </summary>
+/// <remarks> Each line is a text entity in the scene's text collection, they are drawn by the
+///		RenderOverlay node that renders the scene. The lines are removed from the scene on destruction. </remarks>
+class ProfilerOverlay {
+public:
+	static constexpr size_t MaxLines = 64;
+
+public:
+	/// <param name="topLeft"> Top left corner of the first line, in 2D camera units. </param>
+	/// <param name="lineSize"> Width and height of a line, the font size is the line height. </param>
+	ProfilerOverlay(Scene& scene, const Font* font, Vec2 topLeft, Vec2 lineSize);
+	~ProfilerOverlay();
+	ProfilerOverlay(const ProfilerOverlay&) = delete;
+	ProfilerOverlay& operator=(const ProfilerOverlay&) = delete;
+
+	/// <summary> Replaces the displayed text with the measurements. </summary>
+	void Update(const ProfiledFrame& cpuFrame, const GpuFrameReport& gpuFrame);
+
+	/// <summary> The displayed lines, CPU zones with the same name are summed and indented by depth. </summary>
+	static std::vector<std::string> FormatLines(const ProfiledFrame& cpuFrame, const GpuFrameReport& gpuFrame);
+
+private:
+	Scene& m_scene;
+	const Font* m_font;
+	Vec2 m_topLeft;
+	Vec2 m_lineSize;
+	std::vector<std::unique_ptr<TextEntity>> m_lines;
+};
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,209 @@
+#include "ReadbackManager.hpp"
+
+#include "../GraphicsApi_LL/IResource.hpp"
+#include "../BaseLibrary/Exception/Exception.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+
+namespace inl::gxeng {
+
+
+ReadbackManager::ReadbackManager(gxapi::IGraphicsApi* graphicsApi) : m_graphicsApi(graphicsApi) {}
+
+
+jobs::Future<ReadbackData> ReadbackManager::RequestReadback(const LinearBuffer& source, size_t offset, size_t size) {
+	if (size == 0) {
+		throw InvalidArgumentException("Readback range cannot be empty.");
+	}
+	if (offset + size > source.GetSize()) {
+		throw OutOfRangeException("Readback range is not within the buffer.");
+	}
+
+	Request request;
+	request.description.source = source;
+	request.description.sourceType = SourceType::BUFFER;
+	request.description.sourceOffset = offset;
+	request.description.size = size;
+	request.rowSize = size;
+	request.rowPitch = size;
+	request.rowCount = 1;
+	auto future = request.promise.get_future();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_queued.push_back(std::move(request));
+	return future;
+}
+
+
+jobs::Future<ReadbackData> ReadbackManager::RequestReadback(const Texture2D& source, const ReadbackRegion& region) {
+	if (region.width == 0 || region.height == 0) {
+		throw InvalidArgumentException("Readback region cannot be empty.");
+	}
+
+	Request request;
+	request.description.source = source;
+	request.description.sourceType = SourceType::TEXTURE_2D;
+	request.description.region = region;
+	request.rowSize = region.width * gxapi::GetFormatSizeInBytes(source.GetFormat());
+	request.rowPitch = (request.rowSize + DUP_D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1) / DUP_D3D12_TEXTURE_DATA_PITCH_ALIGNMENT * DUP_D3D12_TEXTURE_DATA_PITCH_ALIGNMENT;
+	request.rowCount = region.height;
+	request.description.size = request.rowPitch * region.height;
+	request.description.textureBufferDesc = gxapi::TextureCopyDesc::Buffer(source.GetFormat(), region.width, region.height, 1, 0);
+	auto future = request.promise.get_future();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_queued.push_back(std::move(request));
+	return future;
+}
+
+
+std::vector<ReadbackManager::ReadbackDescription> ReadbackManager::PrepareReadbacks() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::vector<ReadbackDescription> descriptions;
+	if (m_queued.empty()) {
+		return descriptions;
+	}
+
+	// Memory is only taken now, so that requests of a frame that failed before recording them don't hold pages.
+	descriptions.reserve(m_queued.size());
+	for (Request& request : m_queued) {
+		ReadbackDescription& description = request.description;
+		if (description.sourceType == SourceType::BUFFER) {
+			AllocateDestination(request, BUFFER_ALIGNMENT);
+		}
+		else {
+			AllocateDestination(request, DUP_D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+			description.textureBufferDesc.byteOffset = description.destinationOffset;
+		}
+		descriptions.push_back(description);
+	}
+
+	if (m_inFlight.empty() || m_inFlight.back().frameId != m_currentFrameId) {
+		m_inFlight.push_back({ m_currentFrameId, {} });
+	}
+	std::vector<Request>& frameRequests = m_inFlight.back().requests;
+	std::move(m_queued.begin(), m_queued.end(), std::back_inserter(frameRequests));
+	m_queued.clear();
+
+	return descriptions;
+}
+
+
+void ReadbackManager::OnFrameBeginHost(uint64_t frameId) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_currentFrameId = frameId;
+}
+
+
+void ReadbackManager::OnFrameCompleteDevice(uint64_t frameId) {
+	std::vector<std::pair<jobs::Promise<ReadbackData>, ReadbackData>> results;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// The data is copied out before the pages of the frame can be handed out again.
+		while (!m_inFlight.empty() && m_inFlight.front().frameId <= frameId) {
+			FrameRequests& frame = m_inFlight.front();
+			for (Request& request : frame.requests) {
+				ReadbackData data;
+				data.frame = frame.frameId;
+				data.bytes.resize(request.rowSize * request.rowCount);
+				for (uint32_t row = 0; row < request.rowCount; ++row) {
+					std::memcpy(data.bytes.data() + row * request.rowSize, request.cpuAddress + row * request.rowPitch, request.rowSize);
+				}
+				results.push_back({ std::move(request.promise), std::move(data) });
+			}
+			m_inFlight.pop_front();
+		}
+
+		m_firstUnfinishedFrameId = std::max(m_firstUnfinishedFrameId, frameId + 1);
+	}
+
+	// Continuations may request new readbacks.
+	for (auto& [promise, data] : results) {
+		promise.set_value(std::move(data));
+	}
+}
+
+
+size_t ReadbackManager::GetPendingCount() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size_t count = m_queued.size();
+	for (const FrameRequests& frame : m_inFlight) {
+		count += frame.requests.size();
+	}
+	return count;
+}
+
+
+size_t ReadbackManager::GetCapacity() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size_t capacity = 0;
+	for (const Page& page : m_pages) {
+		capacity += page.size;
+	}
+	return capacity;
+}
+
+
+void ReadbackManager::AllocateDestination(Request& request, size_t alignment) {
+	auto isFree = [this](const Page& page) { return page.lastFrameId < m_firstUnfinishedFrameId; };
+	auto snap = [alignment](size_t value) { return (value + alignment - 1) / alignment * alignment; };
+	const size_t size = request.description.size;
+
+	// Same rotation as the dynamic buffer ring: the current page, then the next one the GPU is done with,
+	// then a new page inserted into the rotation.
+	Page* page = m_pages.empty() ? nullptr : &m_pages[m_currentPage];
+	if (page && isFree(*page)) {
+		page->consumedSize = 0;
+	}
+	if (!page || snap(page->consumedSize) + size > page->size) {
+		page = nullptr;
+		for (size_t i = 1; i < m_pages.size() && !page; ++i) {
+			size_t index = (m_currentPage + i) % m_pages.size();
+			if (isFree(m_pages[index]) && size <= m_pages[index].size) {
+				m_currentPage = index;
+				page = &m_pages[index];
+				page->consumedSize = 0;
+			}
+		}
+		if (!page) {
+			m_currentPage = m_pages.empty() ? 0 : m_currentPage + 1;
+			m_pages.insert(m_pages.begin() + m_currentPage, CreatePage(std::max(size, PAGE_SIZE)));
+			page = &m_pages[m_currentPage];
+		}
+	}
+
+	size_t offset = snap(page->consumedSize);
+	page->consumedSize = offset + size;
+	page->lastFrameId = m_currentFrameId;
+	request.description.destination = page->buffer;
+	request.description.destinationOffset = offset;
+	request.cpuAddress = page->cpuAddress + offset;
+}
+
+
+ReadbackManager::Page ReadbackManager::CreatePage(size_t size) const {
+	auto resource = MemoryObject::UniquePtr(
+		m_graphicsApi->CreateCommittedResource(
+			gxapi::HeapProperties(gxapi::eHeapType::READBACK),
+			gxapi::eHeapFlags::NONE,
+			gxapi::ResourceDesc::Buffer(size),
+			// COPY_DEST is the required state for readback heap resources, they can't be transitioned.
+			gxapi::eResourceState::COPY_DEST),
+		std::default_delete<const gxapi::IResource>());
+	resource->SetName("Readback page");
+
+	// Readback heaps may stay mapped, the CPU only reads what finished frames copied.
+	auto cpuAddress = reinterpret_cast<const uint8_t*>(resource->Map(0, nullptr));
+
+	ReadbackBuffer buffer{ std::move(resource), true, eResourceHeap::READBACK };
+	buffer.RecordState(gxapi::eResourceState::COPY_DEST);
+	return { std::move(buffer), cpuAddress, size, 0, 0 };
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "MemoryObject.hpp"
+#include "PipelineEventListener.hpp"
+
+#include "../GraphicsApi_LL/IGraphicsApi.hpp"
+#include <BaseLibrary/JobSystem/Future.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary> Part of a texture subresource to copy to the CPU, in pixels. </summary>
+struct ReadbackRegion {
+	uint32_t subresource = 0;
+	uint32_t x = 0;
+	uint32_t y = 0;
+	uint32_t width = 0;
+	uint32_t height = 0;
+};
+
+
+/// <summary> What the GPU copied out of a resource, see <see cref="RenderContext::RequestReadback"/>. </summary>
+struct ReadbackData {
+	std::vector<uint8_t> bytes; // The rows of textures are tightly packed.
+	uint64_t frame = 0; // The frame at the end of which the data was copied.
+};
+
+
+/// <summary>
+/// Copies GPU results to the CPU without stalling, for example exposure values, picking results or culling statistics.
+/// </summary>
+/// <remarks>
+/// Requests of a frame are batched and copied into persistently mapped readback heap pages at the end of the frame.
+/// The futures resolve once the GPU has finished that frame, usually a few frames later, so poll them instead of
+/// waiting on them while rendering. Pages are linearly sub-allocated, and reused once the frame that copied into them finished.
+/// Requests are thread safe.
+/// </remarks>
+class ReadbackManager : public PipelineEventListener {
+public:
+	enum class SourceType { BUFFER, TEXTURE_2D };
+	/// <summary> A copy to record at the end of the frame. </summary>
+	struct ReadbackDescription {
+		MemoryObject source;
+		SourceType sourceType;
+		size_t sourceOffset = 0; // For buffers.
+		size_t size = 0; // Bytes the copy writes into the destination.
+		ReadbackRegion region; // For textures.
+		gxapi::TextureCopyDesc textureBufferDesc; // Layout of the texture rows in the destination, rows are aligned like for uploads.
+
+		ReadbackBuffer destination; // A page of the ring.
+		size_t destinationOffset = 0;
+	};
+
+private:
+	struct Request {
+		ReadbackDescription description;
+		size_t rowSize; // Bytes of a row of the result, the size of the data for buffers.
+		size_t rowPitch; // Bytes between rows in the destination.
+		uint32_t rowCount;
+		const uint8_t* cpuAddress = nullptr; // The destination in the mapped page, once recorded.
+		jobs::Promise<ReadbackData> promise;
+	};
+
+	struct FrameRequests {
+		uint64_t frameId;
+		std::vector<Request> requests;
+	};
+
+	struct Page {
+		ReadbackBuffer buffer;
+		const uint8_t* cpuAddress;
+		size_t size;
+		size_t consumedSize;
+		uint64_t lastFrameId; // Last frame that copied into the page.
+	};
+
+public:
+	ReadbackManager(gxapi::IGraphicsApi* graphicsApi);
+
+	/// <summary> Copies a range of the buffer to the CPU at the end of the current frame. </summary>
+	/// <exception cref="InvalidArgumentException"> If the range is empty. </exception>
+	/// <exception cref="OutOfRangeException"> If the range is not within the buffer. </exception>
+	jobs::Future<ReadbackData> RequestReadback(const LinearBuffer& source, size_t offset, size_t size);
+	/// <summary> Copies a region of a subresource of the texture to the CPU at the end of the current frame. </summary>
+	/// <exception cref="InvalidArgumentException"> If the region is empty. </exception>
+	jobs::Future<ReadbackData> RequestReadback(const Texture2D& source, const ReadbackRegion& region);
+
+	/// <summary> Returns the copies of the requests so far, which have to be recorded at the end of the current frame. </summary>
+	/// <remarks> Requests made after this are copied at the end of the next frame. </remarks>
+	std::vector<ReadbackDescription> PrepareReadbacks();
+
+	void OnFrameBeginDevice(uint64_t frameId) override {}
+	void OnFrameBeginHost(uint64_t frameId) override;
+	void OnFrameBeginAwait(uint64_t frameId) override {}
+	void OnFrameCompleteDevice(uint64_t frameId) override;
+	void OnFrameCompleteHost(uint64_t frameId) override {}
+
+	/// <summary> Requests that have not resolved yet. </summary>
+	size_t GetPendingCount() const;
+	/// <summary> Total size of the pages, in flight or not. </summary>
+	size_t GetCapacity() const;
+
+private:
+	void AllocateDestination(Request& request, size_t alignment);
+	Page CreatePage(size_t size) const;
+
+private:
+	gxapi::IGraphicsApi* m_graphicsApi;
+
+	std::vector<Request> m_queued; // Not yet recorded.
+	std::deque<FrameRequests> m_inFlight; // Recorded, waiting for their frame to finish.
+
+	std::vector<Page> m_pages; // Used round-robin, grows when all pages are in flight.
+	size_t m_currentPage = 0;
+	uint64_t m_currentFrameId = 0;
+	uint64_t m_firstUnfinishedFrameId = 0;
+	mutable std::mutex m_mutex;
+
+	static constexpr size_t PAGE_SIZE = 256 * 1024;
+	static constexpr size_t BUFFER_ALIGNMENT = 16;
+	static constexpr size_t DUP_D3D12_TEXTURE_DATA_PITCH_ALIGNMENT = 256;
+	static constexpr size_t DUP_D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT = 512;
+};
+
+
+} // namespace inl::gxeng
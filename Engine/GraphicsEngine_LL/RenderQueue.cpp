@@ -0,0 +1,129 @@
+#include "RenderQueue.hpp"
+
+#include <BaseLibrary/JobSystem/Parallel.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+
+namespace inl::gxeng {
+
+
+static constexpr int PipelineBits = 16;
+static constexpr int MaterialBits = 16;
+static constexpr int MeshBits = 12;
+static constexpr int DepthBits = 20;
+static_assert(PipelineBits + MaterialBits + MeshBits + DepthBits == 64);
+
+static constexpr int RadixBits = 8;
+static constexpr size_t RadixSize = size_t(1) << RadixBits;
+static constexpr size_t MinChunkSize = 1024;
+
+
+static uint64_t LowBits(uint64_t value, int bits) {
+	return value & ((uint64_t(1) << bits) - 1);
+}
+
+
+uint64_t RenderQueue::MakeKey(uint64_t pipelineId, uint64_t materialId, uint64_t meshId, float depth) {
+	// The bit pattern of non-negative floats increases with the value, drop the sign and the low mantissa.
+	depth = std::max(depth, 0.0f);
+	uint32_t depthBits;
+	std::memcpy(&depthBits, &depth, sizeof(depthBits));
+	uint64_t depthKey = depthBits >> (31 - DepthBits);
+
+	return LowBits(pipelineId, PipelineBits) << (MaterialBits + MeshBits + DepthBits)
+		   | LowBits(materialId, MaterialBits) << (MeshBits + DepthBits)
+		   | LowBits(meshId, MeshBits) << DepthBits
+		   | LowBits(depthKey, DepthBits);
+}
+
+
+uint64_t RenderQueue::PointerId(const void* ptr) {
+	// Allocations are aligned and close to each other, mix so that the low bits differ.
+	uint64_t x = uint64_t(reinterpret_cast<uintptr_t>(ptr));
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	return x;
+}
+
+
+void RenderQueue::Clear() {
+	m_items.clear();
+}
+
+
+void RenderQueue::Reserve(size_t count) {
+	m_items.reserve(count);
+}
+
+
+void RenderQueue::Add(uint64_t key, uint32_t index) {
+	m_items.push_back({ key, index });
+}
+
+
+void RenderQueue::Sort(jobs::Scheduler* scheduler) {
+	const size_t count = m_items.size();
+	if (count < 2) {
+		return;
+	}
+
+	size_t chunkSize = count;
+	if (scheduler && count >= ParallelThreshold) {
+		size_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+		chunkSize = std::max(MinChunkSize, (count + 2 * numThreads - 1) / (2 * numThreads));
+	}
+	const size_t numChunks = (count + chunkSize - 1) / chunkSize;
+
+	// Digits where all keys agree need no pass.
+	uint64_t allOnes = ~uint64_t(0), anyOnes = 0;
+	for (const Item& item : m_items) {
+		allOnes &= item.key;
+		anyOnes |= item.key;
+	}
+	const uint64_t differentBits = allOnes ^ anyOnes;
+
+	m_scratch.resize(count);
+	m_histograms.resize(numChunks * RadixSize);
+
+	for (int shift = 0; shift < 64; shift += RadixBits) {
+		if (((differentBits >> shift) & (RadixSize - 1)) == 0) {
+			continue;
+		}
+
+		// Count digits per chunk.
+		std::fill(m_histograms.begin(), m_histograms.end(), 0u);
+		jobs::CooperativeFor(scheduler, count, chunkSize, [this, shift, chunkSize](size_t first, size_t last) {
+			uint32_t* histogram = m_histograms.data() + first / chunkSize * RadixSize;
+			for (size_t i = first; i < last; ++i) {
+				++histogram[(m_items[i].key >> shift) & (RadixSize - 1)];
+			}
+		});
+
+		// Turn counts into output positions, earlier chunks go first within a digit to keep it stable.
+		uint32_t position = 0;
+		for (size_t digit = 0; digit < RadixSize; ++digit) {
+			for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+				uint32_t& counter = m_histograms[chunk * RadixSize + digit];
+				uint32_t digitCount = counter;
+				counter = position;
+				position += digitCount;
+			}
+		}
+
+		jobs::CooperativeFor(scheduler, count, chunkSize, [this, shift, chunkSize](size_t first, size_t last) {
+			uint32_t* positions = m_histograms.data() + first / chunkSize * RadixSize;
+			for (size_t i = first; i < last; ++i) {
+				m_scratch[positions[(m_items[i].key >> shift) & (RadixSize - 1)]++] = m_items[i];
+			}
+		});
+
+		std::swap(m_items, m_scratch);
+	}
+}
+
+
+} // namespace inl::gxeng
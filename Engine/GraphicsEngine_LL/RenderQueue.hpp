@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace inl::jobs {
+class Scheduler;
+} // namespace inl::jobs
+
+
+namespace inl::gxeng {
+
+
+/// <summary>
+/// List of draws ordered by 64-bit sort keys, so that draws sharing pipeline state,
+/// material and mesh end up next to each other, and the rest are front to back.
+/// </summary>
+/// <remarks> Keys are laid out from most to least significant as
+///		[16 bits pipeline | 16 bits material | 12 bits mesh | 20 bits depth].
+///		Identifiers are folded down to fit, so different states may share a key segment.
+///		This only makes the grouping less effective, the draw loop still has to compare the actual state. </remarks>
+class RenderQueue {
+public:
+	struct Item {
+		uint64_t key;
+		uint32_t index; // Index of the draw in the caller's list.
+	};
+
+	/// <summary> Combines the state identifiers and the view space depth into a sort key. </summary>
+	/// <param name="depth"> Distance along the view direction, negative values are treated as zero. </param>
+	static uint64_t MakeKey(uint64_t pipelineId, uint64_t materialId, uint64_t meshId, float depth);
+
+	/// <summary> Folds a pointer into a well distributed identifier for <see cref="MakeKey"/>. </summary>
+	static uint64_t PointerId(const void* ptr);
+
+	void Clear();
+	void Reserve(size_t count);
+	void Add(uint64_t key, uint32_t index);
+
+	/// <summary> Stable sort of the items by key. </summary>
+	/// <param name="scheduler"> Large queues are sorted using helper jobs from this, null sorts on the calling thread. </param>
+	/// <remarks> Least significant digit first radix sort, passes whose digit is the same everywhere are skipped.
+	///		Blocks until finished, it is meant to be called from a node's setup. </remarks>
+	void Sort(jobs::Scheduler* scheduler = nullptr);
+
+	size_t Size() const { return m_items.size(); }
+	bool Empty() const { return m_items.empty(); }
+	const Item& operator[](size_t index) const { return m_items[index]; }
+	auto begin() const { return m_items.begin(); }
+	auto end() const { return m_items.end(); }
+
+	/// <summary> Queues smaller than this are sorted by a single thread. </summary>
+	static constexpr size_t ParallelThreshold = 4096;
+
+private:
+	std::vector<Item> m_items;
+	std::vector<Item> m_scratch;
+	std::vector<uint32_t> m_histograms; // 256 counters per chunk.
+};
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,213 @@
+#include "ResidencyManager.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+#include <BaseLibrary/FrameProfiler.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+
+namespace inl::gxeng {
+
+
+ResidencyManager::ResidencyManager(gxapi::IGraphicsApi* graphicsApi)
+	: m_graphicsApi(graphicsApi) {}
+
+
+void ResidencyManager::BeginFrame(uint64_t frame) {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+
+	m_frame = frame;
+	m_statistics.evictedBytes = 0;
+	m_statistics.madeResidentBytes = 0;
+
+	gxapi::VideoMemoryInfo info = m_graphicsApi->QueryVideoMemoryInfo(gxapi::eMemorySegmentGroup::LOCAL);
+	m_statistics.budget = info.budget;
+	m_statistics.currentUsage = info.currentUsage;
+
+	// Resources of the last frame are likely needed in this one too, evicting them would only page them back in.
+	uint64_t targetUsage = GetTargetUsage(info);
+	if (targetUsage != 0 && info.currentUsage > targetUsage) {
+		INL_PROFILE_SCOPE("Trim residency");
+		EvictLeastRecentlyUsed(info.currentUsage - targetUsage, frame > 0 ? frame - 1 : 0);
+	}
+}
+
+
+void ResidencyManager::Lock(const std::vector<MemoryObject>& resources) {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+
+	std::vector<std::shared_ptr<MemoryObject::Contents>> incoming;
+	std::vector<gxapi::IResource*> incomingResources;
+	uint64_t incomingBytes = 0;
+	for (const MemoryObject& resource : resources) {
+		if (!resource || !IsEvictable(resource)) {
+			continue;
+		}
+		Entry& entry = GetEntry(resource);
+		entry.lastUsedFrame = m_frame;
+		++entry.lockCount;
+
+		if (!resource.m_contents->resident && std::find(incoming.begin(), incoming.end(), resource.m_contents) == incoming.end()) {
+			incoming.push_back(resource.m_contents);
+			incomingResources.push_back(resource._GetResourcePtr());
+			incomingBytes += entry.size;
+		}
+	}
+	if (incoming.empty()) {
+		return;
+	}
+
+	// Make room ahead so that the driver does not have to page out on its own.
+	gxapi::VideoMemoryInfo info = m_graphicsApi->QueryVideoMemoryInfo(gxapi::eMemorySegmentGroup::LOCAL);
+	uint64_t targetUsage = GetTargetUsage(info);
+	if (targetUsage != 0 && info.currentUsage + incomingBytes > targetUsage) {
+		EvictLeastRecentlyUsed(info.currentUsage + incomingBytes - targetUsage, m_frame + 1);
+	}
+
+	// The budget is only an estimate, when it is off, free the same amount again until it fits or nothing is left.
+	try {
+		m_graphicsApi->MakeResident(incomingResources);
+	}
+	catch (OutOfMemoryException&) {
+		for (;;) {
+			uint64_t evictedBytes = EvictLeastRecentlyUsed(incomingBytes, m_frame + 1);
+			try {
+				m_graphicsApi->MakeResident(incomingResources);
+				break;
+			}
+			catch (OutOfMemoryException&) {
+				if (evictedBytes == 0) {
+					throw;
+				}
+			}
+		}
+	}
+
+	for (auto& contents : incoming) {
+		contents->resident = true;
+	}
+	m_statistics.madeResidentBytes += incomingBytes;
+}
+
+
+void ResidencyManager::Unlock(const std::vector<MemoryObject>& resources) {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+
+	for (const MemoryObject& resource : resources) {
+		if (!resource || !IsEvictable(resource)) {
+			continue;
+		}
+		auto it = m_entries.find(resource._GetResourcePtr());
+		if (it != m_entries.end() && it->second.lockCount > 0) {
+			--it->second.lockCount;
+		}
+	}
+}
+
+
+void ResidencyManager::SetBudgetFraction(double fraction) {
+	if (!(0.0 < fraction && fraction <= 1.0)) {
+		throw InvalidArgumentException("Budget fraction must be in (0, 1].", std::to_string(fraction));
+	}
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	m_budgetFraction = fraction;
+}
+
+
+double ResidencyManager::GetBudgetFraction() const {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	return m_budgetFraction;
+}
+
+
+ResidencyStatistics ResidencyManager::GetStatistics() const {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+
+	ResidencyStatistics statistics = m_statistics;
+	statistics.trackedBytes = 0;
+	statistics.residentBytes = 0;
+	for (const auto& [resource, entry] : m_entries) {
+		if (auto contents = entry.contents.lock()) {
+			statistics.trackedBytes += entry.size;
+			statistics.residentBytes += contents->resident ? entry.size : 0;
+		}
+	}
+	return statistics;
+}
+
+
+std::vector<size_t> ResidencyManager::SelectEvictions(const std::vector<Candidate>& candidates, uint64_t bytesToFree) {
+	std::vector<size_t> order(candidates.size());
+	std::iota(order.begin(), order.end(), size_t(0));
+	std::sort(order.begin(), order.end(), [&candidates](size_t lhs, size_t rhs) {
+		const Candidate& l = candidates[lhs];
+		const Candidate& r = candidates[rhs];
+		return l.lastUsedFrame < r.lastUsedFrame || (l.lastUsedFrame == r.lastUsedFrame && l.size > r.size);
+	});
+
+	uint64_t selectedBytes = 0;
+	size_t count = 0;
+	while (count < order.size() && selectedBytes < bytesToFree) {
+		selectedBytes += candidates[order[count]].size;
+		++count;
+	}
+	order.resize(count);
+	return order;
+}
+
+
+bool ResidencyManager::IsEvictable(const MemoryObject& resource) {
+	return resource.GetHeap() == eResourceHeap::CRITICAL && resource.m_contents->pageable;
+}
+
+
+ResidencyManager::Entry& ResidencyManager::GetEntry(const MemoryObject& resource) {
+	Entry& entry = m_entries[resource._GetResourcePtr()];
+	// A new resource may have been created at the address of a released one.
+	if (entry.contents.lock() != resource.m_contents) {
+		entry = Entry{};
+		entry.contents = resource.m_contents;
+		entry.size = m_graphicsApi->GetAllocationSize(resource.GetDescription());
+	}
+	return entry;
+}
+
+
+uint64_t ResidencyManager::EvictLeastRecentlyUsed(uint64_t bytesToFree, uint64_t usedBefore) {
+	std::vector<Candidate> candidates;
+	std::vector<std::shared_ptr<MemoryObject::Contents>> candidateContents;
+	for (auto it = m_entries.begin(); it != m_entries.end();) {
+		auto contents = it->second.contents.lock();
+		if (!contents) {
+			it = m_entries.erase(it);
+			continue;
+		}
+		if (contents->resident && it->second.lockCount == 0 && it->second.lastUsedFrame < usedBefore) {
+			candidates.push_back({ it->second.lastUsedFrame, it->second.size });
+			candidateContents.push_back(std::move(contents));
+		}
+		++it;
+	}
+
+	std::vector<gxapi::IResource*> toEvict;
+	uint64_t evictedBytes = 0;
+	for (size_t index : SelectEvictions(candidates, bytesToFree)) {
+		toEvict.push_back(candidateContents[index]->resource.get());
+		candidateContents[index]->resident = false;
+		evictedBytes += candidates[index].size;
+	}
+	if (!toEvict.empty()) {
+		m_graphicsApi->Evict(toEvict);
+	}
+	m_statistics.evictedBytes += evictedBytes;
+	return evictedBytes;
+}
+
+
+uint64_t ResidencyManager::GetTargetUsage(const gxapi::VideoMemoryInfo& info) const {
+	return uint64_t(double(info.budget) * m_budgetFraction);
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "MemoryObject.hpp"
+
+#include <GraphicsApi_LL/Common.hpp>
+#include <GraphicsApi_LL/IGraphicsApi.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+struct ResidencyStatistics {
+	uint64_t budget = 0; // Zero if the adapter does not report one.
+	uint64_t currentUsage = 0;
+	uint64_t trackedBytes = 0;
+	uint64_t residentBytes = 0;
+	uint64_t evictedBytes = 0; // Since the last BeginFrame.
+	uint64_t madeResidentBytes = 0; // Since the last BeginFrame.
+};
+
+
+/// <summary>
+/// Keeps GPU-only resources within the video memory budget of the adapter by evicting the least recently used ones.
+/// </summary>
+/// <remarks> Only committed resources of the critical heap are ever evicted, mapped and presented resources stay resident,
+///		placed resources and suballocations stay with their heap or buffer.
+///		Locked resources are in use by command lists in flight and are never evicted. All methods are thread safe. </remarks>
+class ResidencyManager {
+public:
+	struct Candidate {
+		uint64_t lastUsedFrame;
+		uint64_t size;
+	};
+
+	/// <summary> Fraction of the budget usage is kept under, leaves room for other processes and allocations. </summary>
+	static constexpr double DefaultBudgetFraction = 0.9;
+
+public:
+	explicit ResidencyManager(gxapi::IGraphicsApi* graphicsApi);
+
+	/// <summary> Sets the frame following locks count as used in, and evicts resources not used
+	///		in this or the previous frame while usage is over budget. </summary>
+	void BeginFrame(uint64_t frame);
+
+	/// <summary> Makes the resources resident and keeps them so until unlocked.
+	///		Evicts least recently used resources to make room for them. </summary>
+	/// <remarks> Each lock must be matched by an <see cref="Unlock"/>, even if it threw. </remarks>
+	/// <exception cref="inl::OutOfMemoryException"> If the resources do not fit even after evicting every unlocked resource. </exception>
+	void Lock(const std::vector<MemoryObject>& resources);
+
+	/// <summary> Allows the resources to be evicted once no other lock holds them. </summary>
+	void Unlock(const std::vector<MemoryObject>& resources);
+
+	/// <summary> Sets the fraction of the reported budget usage is kept under. </summary>
+	void SetBudgetFraction(double fraction);
+	double GetBudgetFraction() const;
+
+	ResidencyStatistics GetStatistics() const;
+
+	/// <summary> Selects the least recently used candidates whose total size is at least <paramref name="bytesToFree"/>,
+	///		or all of them if they are not enough. Of equally old ones, the larger are selected first. </summary>
+	/// <returns> Indices into <paramref name="candidates"/>. </returns>
+	static std::vector<size_t> SelectEvictions(const std::vector<Candidate>& candidates, uint64_t bytesToFree);
+
+private:
+	struct Entry {
+		std::weak_ptr<MemoryObject::Contents> contents;
+		uint64_t size = 0;
+		uint64_t lastUsedFrame = 0;
+		unsigned lockCount = 0;
+	};
+
+	static bool IsEvictable(const MemoryObject& resource);
+	Entry& GetEntry(const MemoryObject& resource);
+
+	/// <summary> Evicts unlocked resources last used before <paramref name="usedBefore"/>. </summary>
+	/// <returns> Number of bytes evicted. </returns>
+	uint64_t EvictLeastRecentlyUsed(uint64_t bytesToFree, uint64_t usedBefore);
+	uint64_t GetTargetUsage(const gxapi::VideoMemoryInfo& info) const;
+
+private:
+	gxapi::IGraphicsApi* m_graphicsApi;
+	mutable std::mutex m_mtx;
+	std::unordered_map<const gxapi::IResource*, Entry> m_entries;
+	uint64_t m_frame = 0;
+	double m_budgetFraction = DefaultBudgetFraction;
+	ResidencyStatistics m_statistics;
+};
+
+
+} // namespace inl::gxeng
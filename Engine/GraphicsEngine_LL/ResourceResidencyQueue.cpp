@@ -1,27 +1,33 @@
 #include "ResourceResidencyQueue.hpp"
-#include <BaseLibrary/ThreadName.hpp>
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <utility>
 
 namespace inl {
 namespace gxeng {
 
 
-ResourceResidencyQueue::ResourceResidencyQueue(std::unique_ptr<gxapi::IFence> fence) 
-	: m_fence(std::move(fence)),
+ResourceResidencyQueue::ResourceResidencyQueue(std::unique_ptr<gxapi::IFence> fence, jobs::Scheduler& scheduler, ResidencyManager* residencyManager)
+	: m_scheduler(scheduler),
+	m_residencyManager(residencyManager),
+	m_fence(std::move(fence)),
 	m_fenceValue(0)
 {
 	m_fence->Signal(0);
-	m_runThreads = true;
-	m_initThread = std::thread(std::bind(&ResourceResidencyQueue::InitThreadFunc, this));
-	m_cleanThread = std::thread(std::bind(&ResourceResidencyQueue::CleanThreadFunc, this));
 }
 
 
 ResourceResidencyQueue::~ResourceResidencyQueue() {
-	m_runThreads = false;
-	m_initCv.notify_all();
-	m_cleanCv.notify_all();
-	m_initThread.join();
-	m_cleanThread.join();
+	// The completion callbacks and the jobs refer to the queue.
+	{
+		std::unique_lock<std::mutex> lk(m_initMutex);
+		m_initIdleCv.wait(lk, [this] { return !m_initRunning; });
+	}
+	{
+		std::unique_lock<std::mutex> lk(m_cleanMutex);
+		m_cleanIdleCv.wait(lk, [this] { return m_numPendingClean == 0 && !m_cleanRunning; });
+	}
 }
 
 
@@ -36,70 +42,122 @@ const std::function<void()>& ResourceResidencyQueue::GetFailureHandler() const {
 
 
 SyncPoint ResourceResidencyQueue::EnqueueInit(std::vector<MemoryObject> resources) {
-	++m_fenceValue;
-	SyncPoint syncPoint(m_fence, m_fenceValue);
+	Task* task = AcquireTask<Task>();
+	task->resources = std::move(resources);
+
+	bool startJob;
+	SyncPoint syncPoint;
+	{
+		std::lock_guard<std::mutex> lkg(m_initMutex);
+		syncPoint = SyncPoint(m_fence, ++m_fenceValue);
+		task->syncPoint = syncPoint;
+		m_initQueue.push_back(task);
+		startJob = !std::exchange(m_initRunning, true);
+	}
 
-	std::lock_guard<std::mutex> lkg(m_initMutex);
-	m_initQueue.push(std::make_unique<Task>(std::move(resources), syncPoint));
-	m_initCv.notify_one();
+	// The job may run inline, so it's enqueued without holding the lock.
+	if (startJob) {
+		// The GPU is held up until the resources are resident.
+		m_scheduler.Enqueue(jobs::JobOptions{ jobs::eJobPriority::CRITICAL }, [this] { InitJob(); });
+	}
 
 	return syncPoint;
 }
 
 
-void ResourceResidencyQueue::InitThreadFunc() {
-	SetCurrentThreadName("CommandList Init Thread");
-
-	std::vector<std::unique_ptr<Task>> workingSet;
-	while (m_runThreads) {
-		std::unique_lock<std::mutex> lk(m_initMutex);
-		m_initCv.wait(lk, [this] {return !m_runThreads || !m_initQueue.empty(); });
-
-		while (!m_initQueue.empty()) {
-			std::unique_ptr<Task> task = std::move(m_initQueue.front());
-			workingSet.push_back(std::move(task));
-			m_initQueue.pop();
+void ResourceResidencyQueue::InitJob() {
+	std::vector<Task*> workingSet;
+	std::vector<MemoryObject> resources;
+	while (true) {
+		{
+			std::lock_guard<std::mutex> lkg(m_initMutex);
+			workingSet.swap(m_initQueue);
+			if (workingSet.empty()) {
+				m_initRunning = false;
+				m_initIdleCv.notify_all();
+				return;
+			}
 		}
-		lk.unlock();
 
-		for (auto& task : workingSet) {
-			for (const MemoryObject& res : task->resources) {
-				// TODO...
+		// The GPU waits for the signal, so it must come even if paging in failed.
+		if (m_residencyManager) {
+			resources.clear();
+			for (Task* task : workingSet) {
+				resources.insert(resources.end(), task->resources.begin(), task->resources.end());
+			}
+			try {
+				m_residencyManager->Lock(resources);
+			}
+			catch (OutOfMemoryException&) {
+				if (m_failureHandler) {
+					m_failureHandler();
+				}
 			}
-			task->syncPoint.m_fence->Signal(task->syncPoint.m_value);
 		}
+		// Values were handed out in queue order, the last one releases them all.
+		m_fence->Signal(workingSet.back()->syncPoint.m_value);
 
+		ReleaseTasks(workingSet);
 		workingSet.clear();
 	}
 }
 
 
-void ResourceResidencyQueue::CleanThreadFunc() {
-	SetCurrentThreadName("CommandList Clean Thread");
-
-	std::vector<std::unique_ptr<Task>> workingSet;
-	while (m_runThreads) {
-		std::unique_lock<std::mutex> lk(m_cleanMutex);
-		m_cleanCv.wait(lk, [this] {return !m_runThreads || !m_cleanQueue.empty(); });
-
-		while (!m_cleanQueue.empty()) {
-			std::unique_ptr<Task> task = std::move(m_cleanQueue.front());
-			workingSet.push_back(std::move(task));
-			m_cleanQueue.pop();
+void ResourceResidencyQueue::CleanJob() {
+	std::vector<Task*> workingSet;
+	std::vector<MemoryObject> resources;
+	while (true) {
+		{
+			std::lock_guard<std::mutex> lkg(m_cleanMutex);
+			workingSet.swap(m_cleanQueue);
+			if (workingSet.empty()) {
+				m_cleanRunning = false;
+				m_cleanIdleCv.notify_all();
+				return;
+			}
 		}
-		lk.unlock();
 
-		for (auto& task : workingSet) {
-			task->syncPoint.m_fence->Wait(task->syncPoint.m_value);
-			for (const MemoryObject& res : task->resources) {
-				// TODO...
+		if (m_residencyManager) {
+			resources.clear();
+			for (Task* task : workingSet) {
+				resources.insert(resources.end(), task->resources.begin(), task->resources.end());
 			}
+			m_residencyManager->Unlock(resources);
 		}
 
+		// Destroys the clean objects here rather than on the fence watcher.
+		ReleaseTasks(workingSet);
 		workingSet.clear();
 	}
 }
 
 
+void ResourceResidencyQueue::EnqueueCompleted(Task* task) {
+	// Called by the fence watcher, it only hands the task to a job.
+	bool startJob;
+	{
+		std::lock_guard<std::mutex> lkg(m_cleanMutex);
+		m_cleanQueue.push_back(task);
+		startJob = !std::exchange(m_cleanRunning, true);
+		--m_numPendingClean;
+		m_cleanIdleCv.notify_all();
+	}
+	if (startJob) {
+		m_scheduler.Enqueue(jobs::JobOptions{ jobs::eJobPriority::BACKGROUND }, [this] { CleanJob(); });
+	}
+}
+
+
+void ResourceResidencyQueue::ReleaseTasks(const std::vector<Task*>& tasks) {
+	for (Task* task : tasks) {
+		task->Reset();
+	}
+	std::lock_guard<std::mutex> lkg(m_poolMutex);
+	for (Task* task : tasks) {
+		m_freeTasks[typeid(*task)].push_back(task);
+	}
+}
+
+
 } // namespace gxeng
-} // namespace inl
\ No newline at end of file
+} // namespace inl
@@ -1,30 +1,44 @@
 #pragma once
 
 #include <mutex>
-#include <queue>
+#include <condition_variable>
 #include <functional>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
 
 #include "SyncPoint.hpp"
 #include "CriticalBufferHeap.hpp"
 #include "CommandAllocatorPool.hpp"
-#include <atomic>
+#include "ResidencyManager.hpp"
+#include <BaseLibrary/JobSystem/Scheduler.hpp>
 
 
 namespace inl {
 namespace gxeng {
 
 /// <summary> Manages initializing and cleanup of command lists. </summary>
+/// <remarks> Has no threads of its own, the work is done by jobs on the scheduler.
+///		Whatever piled up since the last job ran is paged in or released with a single call. </remarks>
 class ResourceResidencyQueue {
 	struct Task {
-		Task() = default;
-		Task(std::vector<MemoryObject> resources, SyncPoint syncPoint)
-			: resources(std::move(resources)), syncPoint(syncPoint) {}
 		virtual ~Task() {};
-		std::vector<MemoryObject> resources;
+		/// <summary> Releases what the task holds so that the node can be reused. </summary>
+		virtual void Reset() {
+			resources.clear();
+			syncPoint = {};
+		}
+		std::vector<MemoryObject> resources; // Keeps its capacity while pooled.
 		SyncPoint syncPoint;
 	};
 public:
-	ResourceResidencyQueue(std::unique_ptr<gxapi::IFence> fence);
+	/// <param name="scheduler"> Runs the init and clean jobs, must outlive the queue. </param>
+	/// <param name="residencyManager"> Pages the resources in and out. If null, resources are only kept alive. </param>
+	ResourceResidencyQueue(std::unique_ptr<gxapi::IFence> fence, jobs::Scheduler& scheduler, ResidencyManager* residencyManager = nullptr);
+	/// <summary> Waits for the GPU to pass every enqueued clean. </summary>
 	~ResourceResidencyQueue();
 
 
@@ -50,53 +64,90 @@ public:
 	/// <param name="cleanObjects"> Object that should live until 'waitFor' is signaled. The destructor of given objects
 	///								will be called afterwards. </param>
 	/// <remarks> The cleanObjects list could be used to free up command lists and command allocators associated 
-	///			  with the resources. </remarks>
+	///			  with the resources. 
+	///			  No thread waits for the GPU, the task is only queued for cleaning once the SyncPoint is signaled. </remarks>
 	template <class... CleanObjectT>
 	void EnqueueClean(SyncPoint waitFor, std::vector<MemoryObject> resources, CleanObjectT&&... cleanObjects);
 
 private:
-	void InitThreadFunc();
-	void CleanThreadFunc();
+	template <class TaskT>
+	TaskT* AcquireTask();
+	void ReleaseTasks(const std::vector<Task*>& tasks);
+
+	void InitJob();
+	void CleanJob();
+	void EnqueueCompleted(Task* task);
 	
 private:
+	jobs::Scheduler& m_scheduler;
+
 	// Init
 	std::mutex m_initMutex;
-	std::thread m_initThread;
-	std::condition_variable m_initCv;
-	std::queue<std::unique_ptr<Task>> m_initQueue;
+	std::vector<Task*> m_initQueue;
+	bool m_initRunning = false; // An init job is draining the queue.
+	std::condition_variable m_initIdleCv;
 
 	// Clean
 	std::mutex m_cleanMutex;
-	std::thread m_cleanThread;
-	std::condition_variable m_cleanCv;
-	std::queue<std::unique_ptr<Task>> m_cleanQueue;
+	std::vector<Task*> m_cleanQueue; // Tasks whose SyncPoint has been signaled.
+	bool m_cleanRunning = false; // A clean job is draining the queue.
+	size_t m_numPendingClean = 0; // Tasks still waiting for their SyncPoint.
+	std::condition_variable m_cleanIdleCv; // Shutdown waits for the jobs and the callbacks.
 
-	// Thread run flag
-	std::atomic_bool m_runThreads;
+	// Task nodes, recycled by their dynamic type
+	std::mutex m_poolMutex;
+	std::vector<std::unique_ptr<Task>> m_tasks;
+	std::unordered_map<std::type_index, std::vector<Task*>> m_freeTasks;
 
 	// Failure avoidance and handling
-	std::condition_variable m_retryCv;
 	std::function<void()> m_failureHandler;
 
+	ResidencyManager* m_residencyManager;
+
 	// Event tracking
 	std::shared_ptr<gxapi::IFence> m_fence;
 	uint64_t m_fenceValue;
 };
 
 
+template <class TaskT>
+TaskT* ResourceResidencyQueue::AcquireTask() {
+	std::lock_guard<std::mutex> lkg(m_poolMutex);
+	auto& freeTasks = m_freeTasks[typeid(TaskT)];
+	if (!freeTasks.empty()) {
+		Task* task = freeTasks.back();
+		freeTasks.pop_back();
+		return static_cast<TaskT*>(task);
+	}
+	auto task = std::make_unique<TaskT>();
+	TaskT* ptr = task.get();
+	m_tasks.push_back(std::move(task));
+	return ptr;
+}
+
+
 template<class... CleanObjectT>
 inline void ResourceResidencyQueue::EnqueueClean(SyncPoint waitFor, std::vector<MemoryObject> resources, CleanObjectT&&... cleanObjects) {
 	struct SpecialTask : Task {
-		SpecialTask() = default;
-		SpecialTask(std::vector<MemoryObject> resources, SyncPoint syncPoint, CleanObjectT&&... cleanObjects)
-			: Task(std::move(resources), std::move(syncPoint)), data(std::forward<CleanObjectT>(cleanObjects)...) {}
-		std::tuple<CleanObjectT...> data;
+		void Reset() override {
+			Task::Reset();
+			data.reset();
+		}
+		std::optional<std::tuple<std::decay_t<CleanObjectT>...>> data;
  	};
 
-	std::lock_guard<std::mutex> lkg(m_cleanMutex);
-	m_cleanQueue.push(std::make_unique<SpecialTask>(std::move(resources), std::move(waitFor), std::forward<CleanObjectT>(cleanObjects)...));
-	m_cleanCv.notify_one();
+	SpecialTask* task = AcquireTask<SpecialTask>();
+	task->resources = std::move(resources);
+	task->syncPoint = waitFor;
+	task->data.emplace(std::forward<CleanObjectT>(cleanObjects)...);
+	{
+		std::lock_guard<std::mutex> lkg(m_cleanMutex);
+		++m_numPendingClean;
+	}
+	waitFor.OnCompletion([this, task] {
+		EnqueueCompleted(task);
+	});
 }
 
 } // namespace gxeng
-} // namespace inl
\ No newline at end of file
+} // namespace inl
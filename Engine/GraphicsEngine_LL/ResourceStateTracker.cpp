@@ -0,0 +1,113 @@
+#include "ResourceStateTracker.hpp"
+
+#include <algorithm>
+
+
+namespace inl::gxeng {
+
+
+void ResourceIndexRegistry::BeginFrame() {
+	m_frame.fetch_add(1, std::memory_order_relaxed);
+	m_count.store(0, std::memory_order_relaxed);
+}
+
+
+uint32_t ResourceIndexRegistry::GetIndex(const MemoryObject& resource) {
+	assert(resource.m_contents);
+	std::atomic_uint64_t& frameIndex = resource.m_contents->frameIndex;
+	const uint64_t frame = m_frame.load(std::memory_order_relaxed);
+
+	uint64_t current = frameIndex.load(std::memory_order_acquire);
+	while ((current >> 32) != frame) {
+		// Lists racing for the same resource agree on the winner, the loser's index is left unused.
+		const uint64_t claimed = (frame << 32) | m_count.fetch_add(1, std::memory_order_relaxed);
+		if (frameIndex.compare_exchange_strong(current, claimed, std::memory_order_acq_rel)) {
+			return uint32_t(claimed);
+		}
+	}
+	return uint32_t(current);
+}
+
+
+std::optional<gxapi::eResourceState> ResourceStateTracker::GetState(const MemoryObject& resource, unsigned subresource) const {
+	const TrackedResource* tracked = Find(resource);
+	if (!tracked) {
+		return {};
+	}
+	if (tracked->firstSubresource == InvalidIndex) {
+		return tracked->whole.lastState;
+	}
+	assert(subresource < tracked->numSubresources);
+	const SubresourceEntry& entry = m_subresources[tracked->firstSubresource + subresource];
+	if (!entry.used) {
+		return {};
+	}
+	return entry.lastState;
+}
+
+
+std::vector<ResourceUsage> ResourceStateTracker::TakeUsages() {
+	std::vector<ResourceUsage> usages;
+	usages.reserve(m_resources.size());
+
+	for (TrackedResource& tracked : m_resources) {
+		if (tracked.firstSubresource == InvalidIndex) {
+			const SubresourceUsageInfo& info = tracked.whole;
+			usages.push_back(ResourceUsage{ std::move(tracked.resource), gxapi::ALL_SUBRESOURCES, info.firstState, info.lastState, info.multipleStates });
+			continue;
+		}
+		for (uint32_t s = 0; s < tracked.numSubresources; ++s) {
+			const SubresourceEntry& entry = m_subresources[tracked.firstSubresource + s];
+			if (entry.used) {
+				usages.push_back(ResourceUsage{ tracked.resource, s, entry.firstState, entry.lastState, entry.multipleStates });
+			}
+		}
+	}
+
+	m_entryOfIndex.clear();
+	m_resources.clear();
+	m_subresources.clear();
+	return usages;
+}
+
+
+auto ResourceStateTracker::Find(const MemoryObject& resource) const -> const TrackedResource* {
+	assert(m_registry);
+	const uint32_t index = m_registry->GetIndex(resource);
+	if (index >= m_entryOfIndex.size() || m_entryOfIndex[index] == InvalidIndex) {
+		return nullptr;
+	}
+	return &m_resources[m_entryOfIndex[index]];
+}
+
+
+auto ResourceStateTracker::FindOrInsert(const MemoryObject& resource, bool& inserted) -> TrackedResource& {
+	assert(m_registry);
+	const uint32_t index = m_registry->GetIndex(resource);
+	if (index >= m_entryOfIndex.size()) {
+		// Other lists may have claimed indices meanwhile, grow for them too.
+		m_entryOfIndex.resize(std::max(size_t(index) + 1, size_t(m_registry->GetCount())), InvalidIndex);
+	}
+
+	uint32_t& entry = m_entryOfIndex[index];
+	inserted = entry == InvalidIndex;
+	if (inserted) {
+		entry = (uint32_t)m_resources.size();
+		m_resources.push_back(TrackedResource{ resource, { gxapi::eResourceState::COMMON, gxapi::eResourceState::COMMON, false }, InvalidIndex, resource.GetNumSubresources() });
+	}
+	return m_resources[entry];
+}
+
+
+void ResourceStateTracker::Split(TrackedResource& tracked, bool used) {
+	assert(tracked.firstSubresource == InvalidIndex);
+	tracked.firstSubresource = (uint32_t)m_subresources.size();
+
+	SubresourceEntry entry;
+	static_cast<SubresourceUsageInfo&>(entry) = tracked.whole;
+	entry.used = used;
+	m_subresources.insert(m_subresources.end(), tracked.numSubresources, entry);
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "MemoryObject.hpp"
+
+#include <GraphicsApi_LL/Common.hpp>
+
+#include <atomic>
+#include <optional>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+struct SubresourceUsageInfo {
+	gxapi::eResourceState firstState; /// <summary> Holds the target state of the first transition. </summary>
+	gxapi::eResourceState lastState; /// <summary> Holds the target state of the last transition. </summary>
+	bool multipleStates; /// <sumamry> True if resource was used in more than one state. </summary>
+};
+
+/// <summary> How a command list used a subresource, or all subresources of a resource if
+///		<see cref="subresource"/> is ALL_SUBRESOURCES. </summary>
+struct ResourceUsage {
+	MemoryObject resource;
+	unsigned subresource;
+	gxapi::eResourceState firstState;
+	gxapi::eResourceState lastState;
+	bool multipleStates;
+};
+
+
+/// <summary> Gives the resources used in a frame small, dense indices, so that command lists
+///		can keep their states in flat arrays instead of hash maps. </summary>
+/// <remarks> An index is handed out on the first lookup of a resource in the frame and stored with the resource,
+///		so the lookups of all lists are lock-free and agree with each other.
+///		<see cref="BeginFrame"/> invalidates all indices at once, it must not run while lists are recorded. </remarks>
+class ResourceIndexRegistry {
+public:
+	void BeginFrame();
+
+	/// <summary> Returns the index of the resource in the current frame. </summary>
+	/// <remarks> Pass the state owner of suballocations. </remarks>
+	uint32_t GetIndex(const MemoryObject& resource);
+
+	/// <summary> An upper bound on the indices handed out in the current frame. </summary>
+	uint32_t GetCount() const { return m_count.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic_uint32_t m_frame{ 1 }; // The resources start from frame 0, they have no index yet.
+	std::atomic_uint32_t m_count{ 0 };
+};
+
+
+/// <summary> Tracks the states a command list moves the resources through. </summary>
+/// <remarks> Resources are found by their index in the <see cref="ResourceIndexRegistry"/>.
+///		As long as all subresources of a resource are set together, the resource takes a single entry
+///		and a single barrier, it is only split into subresources when one of them is set on its own. </remarks>
+class ResourceStateTracker {
+public:
+	explicit ResourceStateTracker(ResourceIndexRegistry* registry = nullptr) : m_registry(registry) {}
+
+	/// <summary> Records that the list moves the subresource into the state. </summary>
+	/// <param name="onTransition"> Called with the subresource and its state before for each subresource that the list
+	///		has already used in another state, and so needs a barrier. The subresource is ALL_SUBRESOURCES if all of them
+	///		are in the same state. </param>
+	template <class TransitionFunc>
+	void SetState(const MemoryObject& resource, unsigned subresource, gxapi::eResourceState state, TransitionFunc&& onTransition);
+
+	/// <summary> The state the list has moved the subresource into, nothing if the list has not used it. </summary>
+	std::optional<gxapi::eResourceState> GetState(const MemoryObject& resource, unsigned subresource) const;
+
+	/// <summary> The number of resources the list has used. </summary>
+	size_t GetResourceCount() const { return m_resources.size(); }
+
+	/// <summary> Lists the usages of the resources in a single pass, and forgets them. </summary>
+	std::vector<ResourceUsage> TakeUsages();
+
+private:
+	static constexpr uint32_t InvalidIndex = ~uint32_t(0);
+
+	struct SubresourceEntry : SubresourceUsageInfo {
+		bool used;
+	};
+
+	struct TrackedResource {
+		MemoryObject resource;
+		SubresourceUsageInfo whole; // While all subresources are in the same state.
+		uint32_t firstSubresource; // In m_subresources once split, InvalidIndex until.
+		uint32_t numSubresources;
+	};
+
+	const TrackedResource* Find(const MemoryObject& resource) const;
+	TrackedResource& FindOrInsert(const MemoryObject& resource, bool& inserted);
+	/// <summary> Gives the subresources their own entries, in the state of the whole resource. </summary>
+	void Split(TrackedResource& tracked, bool used);
+
+	ResourceIndexRegistry* m_registry;
+	std::vector<uint32_t> m_entryOfIndex; // Registry index -> m_resources.
+	std::vector<TrackedResource> m_resources;
+	std::vector<SubresourceEntry> m_subresources;
+};
+
+
+template <class TransitionFunc>
+void ResourceStateTracker::SetState(const MemoryObject& resource, unsigned subresource, gxapi::eResourceState state, TransitionFunc&& onTransition) {
+	bool inserted;
+	TrackedResource& tracked = FindOrInsert(resource, inserted);
+
+	if (inserted) {
+		if (subresource == gxapi::ALL_SUBRESOURCES || tracked.numSubresources == 1) {
+			tracked.whole = { state, state, false };
+			return;
+		}
+		Split(tracked, false);
+	}
+
+	// Whole resource, it stays whole.
+	if (tracked.firstSubresource == InvalidIndex && (subresource == gxapi::ALL_SUBRESOURCES || tracked.numSubresources == 1)) {
+		if (tracked.whole.lastState != state) {
+			onTransition(gxapi::ALL_SUBRESOURCES, tracked.whole.lastState);
+			tracked.whole.lastState = state;
+			tracked.whole.multipleStates = true;
+		}
+		return;
+	}
+
+	if (tracked.firstSubresource == InvalidIndex) {
+		Split(tracked, true);
+	}
+
+	auto setSubresource = [&](unsigned s) {
+		SubresourceEntry& entry = m_subresources[tracked.firstSubresource + s];
+		if (!entry.used) {
+			static_cast<SubresourceUsageInfo&>(entry) = { state, state, false };
+			entry.used = true;
+		}
+		else if (entry.lastState != state) {
+			onTransition(s, entry.lastState);
+			entry.lastState = state;
+			entry.multipleStates = true;
+		}
+	};
+	if (subresource == gxapi::ALL_SUBRESOURCES) {
+		for (unsigned s = 0; s < tracked.numSubresources; ++s) {
+			setSubresource(s);
+		}
+	}
+	else {
+		assert(subresource < tracked.numSubresources);
+		setSubresource(subresource);
+	}
+}
+
+
+} // namespace inl::gxeng
@@ -19,6 +19,7 @@ static std::vector<uint32_t> CalcSubresourceList(const Texture2D&, const gxapi::
 static std::vector<uint32_t> CalcSubresourceList(const Texture1D&, const gxapi::UavTexture1DArray&);
 static std::vector<uint32_t> CalcSubresourceList(const Texture2D&, const gxapi::UavTexture2DArray&);
 static std::vector<uint32_t> CalcSubresourceList(const Texture3D&, const gxapi::UavTexture3D&);
+static void ThrowIfSubAllocation(const LinearBuffer& resource);
 
 
 
@@ -188,6 +189,7 @@ BufferView::BufferView(
 	fullSrvDesc.format = format;
 	fullSrvDesc.dimension = gxapi::eSrvDimension::BUFFER;
 	fullSrvDesc.buffer = desc;
+	ThrowIfSubAllocation(resource);
 
 	heap.CreateSRV(GetResource(), fullSrvDesc, GetHandle());
 
@@ -209,6 +211,7 @@ BufferView::BufferView(
 	fullSrvDesc.format = format;
 	fullSrvDesc.dimension = gxapi::eSrvDimension::BUFFER;
 	fullSrvDesc.buffer = desc;
+	ThrowIfSubAllocation(resource);
 
 	gxapi->CreateShaderResourceView(GetResource()._GetResourcePtr(), fullSrvDesc, GetHandle());
 
@@ -461,8 +464,11 @@ RWBufferView::RWBufferView(const LinearBuffer& resource,
 	fullUavDesc.format = format;
 	fullUavDesc.dimension = gxapi::eUavDimension::BUFFER;
 	fullUavDesc.buffer = desc;
+	ThrowIfSubAllocation(resource);
 
 	heap.CreateUAV(GetResource(), fullUavDesc, GetHandle());
+
+	SetSubresourceList({ gxapi::ALL_SUBRESOURCES });
 }
 
 RWBufferView::RWBufferView(const LinearBuffer& resource,
@@ -478,6 +484,7 @@ RWBufferView::RWBufferView(const LinearBuffer& resource,
 	fullUavDesc.format = format;
 	fullUavDesc.dimension = gxapi::eUavDimension::BUFFER;
 	fullUavDesc.buffer = desc;
+	ThrowIfSubAllocation(resource);
 
 	gxapi->CreateUnorderedAccessView(GetResource()._GetResourcePtr(), fullUavDesc, GetHandle());
 
@@ -756,6 +763,14 @@ static std::vector<uint32_t> CalcSubresourceList(const Texture3D& obj, const gxa
 }
 
 
+
+static void ThrowIfSubAllocation(const LinearBuffer& resource) {
+	// Element indices would be relative to the whole shared buffer.
+	if (resource._IsSubAllocation()) {
+		throw InvalidArgumentException("Suballocated buffers can only be bound as vertex and index buffers.");
+	}
+}
+
+
 } // namespace gxeng
 } // namespace inl
-
@@ -13,14 +13,15 @@ namespace inl::gxeng {
 
 
 struct DescriptorTableState {
-	DescriptorTableState() : slot(0), committed(false) {}
+	DescriptorTableState() : slot(0), committed(false), bindless(false) {}
 	DescriptorTableState(DescriptorArrayRef&& reference, int slot)
-		: reference(std::move(reference)), slot(slot), committed(false)
+		: reference(std::move(reference)), slot(slot), committed(false), bindless(false)
 	{}
 
 	DescriptorArrayRef reference; // current place in scratch space
 	int slot; // which root signature slot it belongs to
 	bool committed; // true if modifying descriptor in sratch space would break previous draw calls
+	bool bindless; // points at the bindless table of the scratch space, has no bindings
 	std::vector<gxapi::DescriptorHandle> bindings; // currently bound descriptor handle, staging heap sources
 };
 
@@ -61,6 +62,9 @@ private:
 	/// <summary> Copies ALL scratch space tables to a fresh range. Used after a new scratch space is bound. </summary>
 	void RenewRootTables();
 
+	/// <summary> Gets the root table's descriptors in scratch space. </summary>
+	gxapi::DescriptorHandle GetTableStart(DescriptorTableState& table);
+
 	void SetRootDescriptorTable(gxapi::IGraphicsCommandList* list, unsigned parameterIndex, gxapi::DescriptorHandle baseHandle);
 	void SetRootDescriptorTable(gxapi::IComputeCommandList* list, unsigned parameterIndex, gxapi::DescriptorHandle baseHandle);
 	void SetRootSignature(gxapi::IGraphicsCommandList* list, gxapi::IRootSignature* sig);
@@ -107,7 +111,7 @@ void RootTableManager<Type>::SetBinder(const Binder* binder) {
 	auto rootTableStates = InitRootTables(binder);
 	SetRootSignature(m_commandList, binder->GetRootSignature());
 	for (auto& state : rootTableStates) {
-		SetRootDescriptorTable(m_commandList, state.slot, state.reference.Get(0));
+		SetRootDescriptorTable(m_commandList, state.slot, GetTableStart(state));
 	}
 	m_rootTableStates = std::move(rootTableStates);
 	m_binder = binder;
@@ -138,6 +142,10 @@ template <gxapi::eCommandListType Type>
 void RootTableManager<Type>::UpdateRootTable(gxapi::DescriptorHandle handle, int rootSignatureSlot, int indexInTable) {
 	DescriptorTableState& table = FindRootTable(rootSignatureSlot);
 
+	if (table.bindless) {
+		throw InvalidArgumentException("Nothing can be bound to a bindless table, index it in the shader instead.");
+	}
+
 	// if table is committed, duplicate it so that recent drawcalls won't be broken
 	if (table.committed) {
 		// update handle in advance so that duplicate will copy it instead and we save time
@@ -232,6 +240,14 @@ std::vector<DescriptorTableState> RootTableManager<Type>::InitRootTables(const B
 				throw NotImplementedException("Dynamic Samplers are not supported yet.");
 			}
 
+			// Unbounded tables are made by the binder for bindless parameters only.
+			if (ranges[0].numDescriptors == gxapi::DescriptorRange::UNBOUNDED) {
+				rootTableStates.emplace_back();
+				rootTableStates.back().slot = (int)slot;
+				rootTableStates.back().bindless = true;
+				continue;
+			}
+
 			// check if ranges are contiguous and not unbounded
 			size_t descriptorCountTotal = 0;
 			size_t appendIndex = 0;
@@ -270,10 +286,19 @@ void RootTableManager<Type>::CommitRootTables() {
 template <gxapi::eCommandListType Type>
 void RootTableManager<Type>::RenewRootTables() {
 	for (auto& table : m_rootTableStates) {
-		DuplicateRootTable(table);
+		if (!table.bindless) {
+			DuplicateRootTable(table);
+		}
+		// Tables of the previous heap are no longer valid.
+		SetRootDescriptorTable(m_commandList, table.slot, GetTableStart(table));
 	}
 }
 
+template <gxapi::eCommandListType Type>
+gxapi::DescriptorHandle RootTableManager<Type>::GetTableStart(DescriptorTableState& table) {
+	return table.bindless ? m_heap->GetBindlessTable() : table.reference.Get(0);
+}
+
 template <gxapi::eCommandListType Type>
 void RootTableManager<Type>::SetRootDescriptorTable(gxapi::IGraphicsCommandList* list, unsigned parameterIndex, gxapi::DescriptorHandle baseHandle) {
 	list->SetGraphicsRootDescriptorTable(parameterIndex, baseHandle);
@@ -1,4 +1,5 @@
 #include "Scene.hpp"
+#include "MeshEntity.hpp"
 #include <cassert>
 
 
@@ -23,6 +24,20 @@ const std::string& Scene::GetName() const {
 }
 
 
+void Scene::UpdateTransforms() {
+	const auto& meshEntities = GetEntities<MeshEntity>();
+	FlushTransforms(meshEntities.begin(), meshEntities.end());
+}
+
+void Scene::UpdateMeshEntityIndex() {
+	m_meshEntityIndex.Update(GetEntities<MeshEntity>());
+}
+
+const MeshEntityIndex& Scene::GetMeshEntityIndex() const {
+	return m_meshEntityIndex;
+}
+
+
 EntityCollectionBase* Scene::GetEntities(const std::type_index& entityType) {
 	auto it = m_entityCollections.find(entityType);
 	if (it != m_entityCollections.end()) {
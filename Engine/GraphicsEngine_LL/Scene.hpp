@@ -5,6 +5,7 @@
 #include <unordered_map>
 
 #include <GraphicsEngine/Scene/IScene.hpp>
+#include "MeshEntityIndex.hpp"
 
 namespace inl {
 namespace gxeng {
@@ -33,6 +34,17 @@ public:
 	const std::string& GetName() const override;
 
 	using IScene::GetEntities;
+
+	/// <summary> Recomposes the cached world matrices of the mesh entities that moved. </summary>
+	/// <remarks> Called by the engine every frame before the pipeline executes,
+	///		so that render nodes running in parallel only read the caches. </remarks>
+	void UpdateTransforms();
+
+	/// <summary> Brings the spatial index of mesh entities up to date with their transforms. </summary>
+	/// <remarks> Called by the engine every frame before the pipeline executes. </remarks>
+	void UpdateMeshEntityIndex();
+	/// <summary> Spatial index of the mesh entities for visibility queries. </summary>
+	const MeshEntityIndex& GetMeshEntityIndex() const;
 protected:
 	EntityCollectionBase* GetEntities(const std::type_index& entityType) override;
 	const EntityCollectionBase* GetEntities(const std::type_index& entityType) const override;
@@ -40,6 +52,7 @@ protected:
 
 private:
 	std::unordered_map<std::type_index, std::unique_ptr<EntityCollectionBase>> m_entityCollections;
+	MeshEntityIndex m_meshEntityIndex;
 
 	std::string m_name;
 };
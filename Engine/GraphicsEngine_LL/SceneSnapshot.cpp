@@ -0,0 +1,173 @@
+#include "SceneSnapshot.hpp"
+
+#include "OrthographicCamera.hpp"
+#include "PerspectiveCamera.hpp"
+
+
+namespace inl::gxeng {
+
+
+namespace {
+
+	void CopyState(MeshEntity& copy, const MeshEntity& original) {
+		copy.CopySceneState(original);
+	}
+
+	template <class EntityType>
+	void CopyState(EntityType& copy, const EntityType& original) {
+		copy = original;
+	}
+
+
+	/// <summary> Copies the camera if it is a <typeparamref name="CameraType"/>, replacing a copy of another type. </summary>
+	template <class CameraType>
+	bool CopyCamera(std::unique_ptr<BasicCamera>& copy, const BasicCamera& original) {
+		const auto* concrete = dynamic_cast<const CameraType*>(&original);
+		if (!concrete) {
+			return false;
+		}
+		if (auto* existing = dynamic_cast<CameraType*>(copy.get())) {
+			*existing = *concrete;
+		}
+		else {
+			copy = std::make_unique<CameraType>(*concrete);
+		}
+		return true;
+	}
+
+} // namespace
+
+
+void SceneSnapshot::Update(const std::set<Scene*>& scenes, const std::set<BasicCamera*>& cameras, const std::set<Camera2D*>& cameras2d) {
+	++m_update;
+
+	m_sceneList.clear();
+	for (Scene* scene : scenes) {
+		Copy<Scene>& record = m_scenes[scene];
+		if (!record.entity) {
+			record.entity = std::make_unique<Scene>(scene->GetName());
+		}
+		else if (record.entity->GetName() != scene->GetName()) {
+			record.entity->SetName(scene->GetName());
+		}
+		record.update = m_update;
+
+		Scene& copy = *record.entity;
+		CopyEntities<MeshEntity, MeshEntity>(*scene, copy, m_meshEntities);
+		CopyEntities<IOverlayEntity, OverlayEntity>(*scene, copy, m_overlayEntities);
+		CopyEntities<ITextEntity, TextEntity>(*scene, copy, m_textEntities);
+		CopyEntities<DirectionalLight, DirectionalLight>(*scene, copy, m_directionalLights);
+		CopyEntities<PointLight, PointLight>(*scene, copy, m_pointLights);
+		CopyEntities<SpotLight, SpotLight>(*scene, copy, m_spotLights);
+		CopyEntities<ParticleEmitter, ParticleEmitter>(*scene, copy, m_particleEmitters);
+		m_sceneList.push_back(&copy);
+	}
+
+	m_cameraList.clear();
+	for (BasicCamera* camera : cameras) {
+		Copy<BasicCamera>& record = m_cameras[camera];
+		if (CopyCamera<PerspectiveCamera>(record.entity, *camera) || CopyCamera<OrthographicCamera>(record.entity, *camera)) {
+			record.update = m_update;
+			m_cameraList.push_back(record.entity.get());
+		}
+		else {
+			m_cameras.erase(camera);
+			m_cameraList.push_back(camera);
+		}
+	}
+
+	m_camera2dList.clear();
+	for (Camera2D* camera : cameras2d) {
+		Copy<Camera2D>& record = m_cameras2d[camera];
+		if (record.entity) {
+			*record.entity = *camera;
+		}
+		else {
+			record.entity = std::make_unique<Camera2D>(*camera);
+		}
+		record.update = m_update;
+		m_camera2dList.push_back(record.entity.get());
+	}
+
+	RemoveUnseen(m_scenes);
+	RemoveUnseen(m_meshEntities);
+	RemoveUnseen(m_overlayEntities);
+	RemoveUnseen(m_textEntities);
+	RemoveUnseen(m_directionalLights);
+	RemoveUnseen(m_pointLights);
+	RemoveUnseen(m_spotLights);
+	RemoveUnseen(m_particleEmitters);
+	RemoveUnseen(m_cameras);
+	RemoveUnseen(m_cameras2d);
+}
+
+
+void SceneSnapshot::Clear() {
+	m_sceneList.clear();
+	m_cameraList.clear();
+	m_camera2dList.clear();
+
+	// Scenes go first, their collections point to the entities.
+	m_scenes.clear();
+	m_meshEntities.clear();
+	m_overlayEntities.clear();
+	m_textEntities.clear();
+	m_directionalLights.clear();
+	m_pointLights.clear();
+	m_spotLights.clear();
+	m_particleEmitters.clear();
+	m_cameras.clear();
+	m_cameras2d.clear();
+}
+
+
+template <class CollectionType, class EntityType>
+void SceneSnapshot::CopyEntities(const Scene& original, Scene& copy, CopyMap<EntityType>& copies) {
+	const EntityCollection<CollectionType>& originals = original.GetEntities<CollectionType>();
+	EntityCollection<CollectionType>& copied = copy.GetEntities<CollectionType>();
+
+	// Entities are added and removed much less often than they change, the collection is only rebuilt if its members did.
+	bool changed = copied.Size() != originals.Size();
+	m_members.clear();
+	for (size_t i = 0; i < originals.Size(); ++i) {
+		const CollectionType* entity = originals[i];
+		const CollectionType* member = entity;
+		if (const auto* concrete = dynamic_cast<const EntityType*>(entity)) {
+			Copy<EntityType>& record = copies[concrete];
+			if (!record.entity) {
+				record.entity = std::make_unique<EntityType>(*concrete);
+			}
+			else if (record.update != m_update) { // Not yet copied for another scene.
+				CopyState(*record.entity, *concrete);
+			}
+			record.update = m_update;
+			member = record.entity.get();
+		}
+		changed = changed || copied[i] != member;
+		m_members.push_back(member);
+	}
+
+	if (changed) {
+		copied.Clear();
+		copied.Reserve(m_members.size());
+		for (const void* member : m_members) {
+			copied.Add(static_cast<const CollectionType*>(member));
+		}
+	}
+}
+
+
+template <class EntityType>
+void SceneSnapshot::RemoveUnseen(CopyMap<EntityType>& copies) {
+	for (auto it = copies.begin(); it != copies.end();) {
+		if (it->second.update != m_update) {
+			it = copies.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "BasicCamera.hpp"
+#include "Camera2D.hpp"
+#include "DirectionalLight.hpp"
+#include "MeshEntity.hpp"
+#include "OverlayEntity.hpp"
+#include "ParticleEmitter.hpp"
+#include "PointLight.hpp"
+#include "Scene.hpp"
+#include "SpotLight.hpp"
+#include "TextEntity.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary>
+/// Render side copies of the scenes and cameras, so that the game can change the originals while a frame renders.
+/// </summary>
+/// <remarks> Entities are copied into scenes of the same name, cameras into cameras of the same type and name.
+///		Copies are kept between frames as long as their originals are in a scene, so the pipeline may keep
+///		referring to them by address, and what it writes into mesh entities, like their LOD and skinned vertices, stays.
+///		Entities of unknown implementations of the overlay and text interfaces are not copied,
+///		the pipeline sees the originals. Meshes, materials and images are shared with the originals. </remarks>
+class SceneSnapshot {
+public:
+	/// <summary> Copies the state of the entities of the scenes and the cameras. </summary>
+	void Update(const std::set<Scene*>& scenes, const std::set<BasicCamera*>& cameras, const std::set<Camera2D*>& cameras2d);
+	/// <summary> Deletes all copies. </summary>
+	void Clear();
+
+	/// <summary> The copies of the scenes, in the order of the originals. </summary>
+	const std::vector<Scene*>& GetScenes() const { return m_sceneList; }
+	const std::vector<const BasicCamera*>& GetCameras() const { return m_cameraList; }
+	const std::vector<const Camera2D*>& GetCameras2D() const { return m_camera2dList; }
+
+	/// <summary> The copy of the entity or camera, null if it was not in a scene or registered at the last update. </summary>
+	const MeshEntity* Find(const MeshEntity* original) const { return Find(m_meshEntities, original); }
+	const OverlayEntity* Find(const OverlayEntity* original) const { return Find(m_overlayEntities, original); }
+	const TextEntity* Find(const TextEntity* original) const { return Find(m_textEntities, original); }
+	const DirectionalLight* Find(const DirectionalLight* original) const { return Find(m_directionalLights, original); }
+	const PointLight* Find(const PointLight* original) const { return Find(m_pointLights, original); }
+	const SpotLight* Find(const SpotLight* original) const { return Find(m_spotLights, original); }
+	const ParticleEmitter* Find(const ParticleEmitter* original) const { return Find(m_particleEmitters, original); }
+	const BasicCamera* Find(const BasicCamera* original) const { return Find(m_cameras, original); }
+	const Camera2D* Find(const Camera2D* original) const { return Find(m_cameras2d, original); }
+
+private:
+	template <class EntityType>
+	struct Copy {
+		std::unique_ptr<EntityType> entity;
+		uint64_t update = 0; // The last update the original was seen in.
+	};
+	template <class EntityType>
+	using CopyMap = std::unordered_map<const void*, Copy<EntityType>>; // By the address of the original.
+
+	/// <summary> Fills the collection of <paramref name="copy"/> with copies of the entities of <paramref name="original"/>. </summary>
+	/// <typeparam name="CollectionType"> The type the scenes collect the entities by. </typeparam>
+	/// <typeparam name="EntityType"> The implementation that is copied. </typeparam>
+	template <class CollectionType, class EntityType>
+	void CopyEntities(const Scene& original, Scene& copy, CopyMap<EntityType>& copies);
+
+	template <class EntityType>
+	void RemoveUnseen(CopyMap<EntityType>& copies);
+
+	template <class EntityType>
+	static const EntityType* Find(const CopyMap<EntityType>& copies, const void* original);
+
+private:
+	uint64_t m_update = 0;
+
+	CopyMap<Scene> m_scenes;
+	CopyMap<MeshEntity> m_meshEntities;
+	CopyMap<OverlayEntity> m_overlayEntities;
+	CopyMap<TextEntity> m_textEntities;
+	CopyMap<DirectionalLight> m_directionalLights;
+	CopyMap<PointLight> m_pointLights;
+	CopyMap<SpotLight> m_spotLights;
+	CopyMap<ParticleEmitter> m_particleEmitters;
+	CopyMap<BasicCamera> m_cameras;
+	CopyMap<Camera2D> m_cameras2d;
+
+	std::vector<Scene*> m_sceneList;
+	std::vector<const BasicCamera*> m_cameraList;
+	std::vector<const Camera2D*> m_camera2dList;
+	std::vector<const void*> m_members; // Scratch space for the copies of a collection.
+};
+
+
+template <class EntityType>
+const EntityType* SceneSnapshot::Find(const CopyMap<EntityType>& copies, const void* original) {
+	auto it = copies.find(original);
+	return it != copies.end() ? it->second.entity.get() : nullptr;
+}
+
+
+} // namespace inl::gxeng
@@ -1,5 +1,7 @@
 #include "Scheduler.hpp"
 
+#include "GpuProfiler.hpp"
+
 #include <cassert>
 
 namespace inl::gxeng {
@@ -12,10 +14,12 @@ Scheduler::Scheduler() {
 	m_gpuScheduler.SetJobScheduler(m_jobScheduler);
 }
 
-void Scheduler::SetPipeline(Pipeline&& pipeline) {
+Pipeline Scheduler::SetPipeline(Pipeline&& pipeline) {
+	Pipeline previous = std::move(m_pipeline);
 	m_pipeline = std::move(pipeline);
 	m_cpuScheduler.SetPipeline(m_pipeline);
 	m_gpuScheduler.SetPipeline(m_pipeline);
+	return previous;
 }
 
 
@@ -35,11 +39,29 @@ void Scheduler::ReleaseResources() {
 			ptr->Reset();
 		}
 	}
+	m_cpuScheduler.ReleaseTransientTextures();
+}
+
+
+void Scheduler::SetTransientAliasing(bool enabled) {
+	m_cpuScheduler.SetTransientAliasing(enabled);
+}
+
+
+TransientTexturePool::Statistics Scheduler::GetTransientStatistics() const {
+	return m_cpuScheduler.GetTransientStatistics();
 }
 
 void Scheduler::Execute(FrameContext context) {
 	try {
 		m_cpuScheduler.RunPipeline(context, m_gpuScheduler);
+
+		GpuFrameReport gpuReport;
+		bool measuredGpu = context.gpuProfiler && context.gpuProfiler->IsEnabled();
+		if (measuredGpu) {
+			gpuReport = context.gpuProfiler->GetReport();
+		}
+		m_pipeline.RecordNodeCosts(m_cpuScheduler.GetNodeCosts(measuredGpu ? &gpuReport : nullptr));
 	}
 	catch (Exception& ex) {
 		std::cout << "=== This frame is fucked ===" << std::endl;
@@ -16,7 +16,8 @@ public:
 
 	/// <summary> Currently active pipeline contains the nodes that are executed each frame. </summary>
 	/// <remarks> The pipeline cannot be modified outside the scheduler, hence the exclusive access. </remarks>
-	void SetPipeline(Pipeline&& pipeline);
+	/// <returns> The pipeline that was active until now. </returns>
+	Pipeline SetPipeline(Pipeline&& pipeline);
 
 	/// <summary> You can read information about currently used pipeline. </summary>
 	const Pipeline& GetPipeline() const;
@@ -33,6 +34,15 @@ public:
 	///		so that old resources won't prevent new ones from being allocated. </remarks>
 	void ReleaseResources();
 
+	/// <summary> Lets nodes that are ordered by the pipeline share transient textures. On by default. </summary>
+	void SetTransientAliasing(bool enabled);
+
+	/// <summary> Memory of transient texture requests in the last frame, and how much the shared textures take. </summary>
+	TransientTexturePool::Statistics GetTransientStatistics() const;
+
+	/// <summary> The job system the pipeline runs on. </summary>
+	jobs::Scheduler& GetJobScheduler() { return m_jobScheduler; }
+
 private:
 	SchedulerCPU m_cpuScheduler;
 	SchedulerGPU m_gpuScheduler;
@@ -2,6 +2,10 @@
 
 #include "SchedulerGPU.hpp"
 #include "GraphicsCommandList.hpp"
+#include "GpuProfiler.hpp"
+
+#include <BaseLibrary/FrameProfiler.hpp>
+#include <BaseLibrary/JobSystem/Wait.hpp>
 
 namespace inl::gxeng {
 
@@ -22,9 +26,14 @@ void UploadTask::Setup(SetupContext& context) {
 	return;
 }
 void UploadTask::Execute(RenderContext& context) {
-	CopyCommandList& commandList = context.AsCopy();
+	CopyCommandList& commandList = context.AsAsyncCopy();
 
 	for (auto& request : *m_uploads) {
+		// Buffer writes merged into a later one are left empty.
+		if (request.destType == UploadManager::DestType::BUFFER && request.sourceSize == 0) {
+			continue;
+		}
+
 		// Init copy parameters
 		auto& source = request.source;
 		auto& destination = request.destination;
@@ -36,7 +45,7 @@ void UploadTask::Execute(RenderContext& context) {
 
 		if (destType == UploadManager::DestType::BUFFER) {
 			auto& dstBuffer = static_cast<const LinearBuffer&>(destination);
-			commandList.CopyBuffer(dstBuffer, request.dstOffsetX, source, 0, source.GetSize());
+			commandList.CopyBuffer(dstBuffer, request.dstOffsetX, source, request.sourceOffset, request.sourceSize);
 		}
 		else if (destType == UploadManager::DestType::TEXTURE_2D) {
 			auto& dstTexture = static_cast<const Texture2D&>(destination);
@@ -61,7 +70,12 @@ static std::tuple<std::unique_ptr<BasicCommandList>, std::unique_ptr<VolatileVie
 		context.commandListPool,
 		context.commandAllocatorPool,
 		context.scratchSpacePool,
-		nullptr);
+		nullptr,
+		nullptr,
+		context.frameArena,
+		nullptr,
+		false,
+		context.copyQueue != nullptr);
 	uploadTask.Setup(setupContext);
 	uploadTask.Execute(renderContext);
 	std::unique_ptr<BasicCommandList> uploadInherit, uploadList;
@@ -71,9 +85,141 @@ static std::tuple<std::unique_ptr<BasicCommandList>, std::unique_ptr<VolatileVie
 }
 
 
+class ReadbackTask : public GraphicsTask {
+public:
+	ReadbackTask(const std::vector<ReadbackManager::ReadbackDescription>* readbacks)
+		: m_readbacks(readbacks) {}
+	void Setup(SetupContext& context) override {}
+	void Execute(RenderContext& context) override;
+
+private:
+	const std::vector<ReadbackManager::ReadbackDescription>* m_readbacks;
+};
+
+
+void ReadbackTask::Execute(RenderContext& context) {
+	// Runs on the graphics queue after all nodes, so the sources hold what the frame left in them.
+	CopyCommandList& commandList = context.AsCopy();
+
+	for (auto& request : *m_readbacks) {
+		auto& source = request.source;
+		auto& destination = request.destination;
+
+		commandList.SetResourceState(destination, gxapi::eResourceState::COPY_DEST);
+
+		if (request.sourceType == ReadbackManager::SourceType::BUFFER) {
+			auto& srcBuffer = static_cast<const LinearBuffer&>(source);
+			commandList.SetResourceState(srcBuffer, gxapi::eResourceState::COPY_SOURCE);
+			commandList.CopyBuffer(destination, request.destinationOffset, srcBuffer, request.sourceOffset, request.size);
+		}
+		else if (request.sourceType == ReadbackManager::SourceType::TEXTURE_2D) {
+			auto& srcTexture = static_cast<const Texture2D&>(source);
+			const ReadbackRegion& region = request.region;
+			commandList.SetResourceState(srcTexture, gxapi::eResourceState::COPY_SOURCE, region.subresource);
+			SubTexture2D srcPlace(region.subresource,
+								  Vector<intptr_t, 2>((intptr_t)region.x, (intptr_t)region.y),
+								  Vector<intptr_t, 2>((intptr_t)(region.x + region.width), (intptr_t)(region.y + region.height)));
+			commandList.CopyTexture(destination, srcTexture, srcPlace, request.textureBufferDesc);
+		}
+	}
+}
+
+static std::tuple<std::unique_ptr<BasicCommandList>, std::unique_ptr<VolatileViewHeap>> ExecuteReadbackTask(const FrameContext& context) {
+	auto readbacks = context.memoryManager->GetReadbackManager().PrepareReadbacks();
+	if (readbacks.empty()) {
+		return {};
+	}
+	ReadbackTask readbackTask(&readbacks);
+	SetupContext setupContext(context.memoryManager,
+		context.textureSpace,
+		context.rtvHeap,
+		context.dsvHeap,
+		context.shaderManager,
+		context.gxApi);
+	RenderContext renderContext(context.memoryManager,
+		context.textureSpace,
+		context.shaderManager,
+		context.gxApi,
+		context.commandListPool,
+		context.commandAllocatorPool,
+		context.scratchSpacePool,
+		nullptr,
+		nullptr,
+		context.frameArena);
+	readbackTask.Setup(setupContext);
+	readbackTask.Execute(renderContext);
+	std::unique_ptr<BasicCommandList> readbackInherit, readbackList;
+	std::unique_ptr<VolatileViewHeap> readbackVheap;
+	renderContext.Decompose(readbackInherit, readbackList, readbackVheap);
+	return { std::move(readbackList), std::move(readbackVheap) };
+}
+
+
+std::tuple<std::unique_ptr<BasicCommandList>, std::unique_ptr<VolatileViewHeap>> SchedulerCPU::ExecuteMipGenerationTask(const FrameContext& context) {
+	m_mipGenerationTask.SetRequests(context.mipGenerationRequests);
+	if (!m_mipGenerationTask.HasRequests()) {
+		return {};
+	}
+	SetupContext setupContext(context.memoryManager,
+		context.textureSpace,
+		context.rtvHeap,
+		context.dsvHeap,
+		context.shaderManager,
+		context.gxApi);
+	RenderContext renderContext(context.memoryManager,
+		context.textureSpace,
+		context.shaderManager,
+		context.gxApi,
+		context.commandListPool,
+		context.commandAllocatorPool,
+		context.scratchSpacePool,
+		nullptr,
+		nullptr,
+		context.frameArena);
+	m_mipGenerationTask.Setup(setupContext);
+	m_mipGenerationTask.Execute(renderContext);
+	std::unique_ptr<BasicCommandList> mipInherit, mipList;
+	std::unique_ptr<VolatileViewHeap> mipVheap;
+	renderContext.Decompose(mipInherit, mipList, mipVheap);
+	return { std::move(mipList), std::move(mipVheap) };
+}
+
+
+std::tuple<std::unique_ptr<BasicCommandList>, std::unique_ptr<VolatileViewHeap>> SchedulerCPU::ExecutePrefilterTask(const FrameContext& context) {
+	m_prefilterTask.AddRequests(context.prefilterRequests);
+	if (!m_prefilterTask.HasWork()) {
+		return {};
+	}
+	SetupContext setupContext(context.memoryManager,
+		context.textureSpace,
+		context.rtvHeap,
+		context.dsvHeap,
+		context.shaderManager,
+		context.gxApi);
+	RenderContext renderContext(context.memoryManager,
+		context.textureSpace,
+		context.shaderManager,
+		context.gxApi,
+		context.commandListPool,
+		context.commandAllocatorPool,
+		context.scratchSpacePool,
+		nullptr,
+		nullptr,
+		context.frameArena);
+	m_prefilterTask.Setup(setupContext);
+	m_prefilterTask.Execute(renderContext);
+	std::unique_ptr<BasicCommandList> prefilterInherit, prefilterList;
+	std::unique_ptr<VolatileViewHeap> prefilterVheap;
+	renderContext.Decompose(prefilterInherit, prefilterList, prefilterVheap);
+	return { std::move(prefilterList), std::move(prefilterVheap) };
+}
+
+
 
 void SchedulerCPU::SetPipeline(const Pipeline& pipeline) {
 	m_pipeline = &pipeline;
+	m_transientPool.SetPrecedence(GetPrecedence(pipeline.GetTaskGraph()));
+	m_taskTimes = std::vector<TaskTime>((size_t)pipeline.GetTaskGraph().maxNodeId() + 1);
 }
 
 void SchedulerCPU::SetJobScheduler(jobs::Scheduler& scheduler) {
@@ -87,6 +233,15 @@ void SchedulerCPU::RunPipeline(const FrameContext& frameContext, SchedulerGPU& s
 	FrameContextEx frameContextEx;
 	static_cast<FrameContext&>(frameContextEx) = frameContext;
 	frameContextEx.schedulerGpu = &schedulerGpu;
+	frameContextEx.jobScheduler = m_scheduler;
+	frameContextEx.transientPool = &m_transientPool;
+	frameContextEx.taskTimes = m_taskTimes.data();
+	m_transientPool.BeginFrame();
+	frameContext.memoryManager->GetResourceIndexRegistry().BeginFrame();
+	for (auto& taskTime : m_taskTimes) {
+		taskTime.setup = 0;
+		taskTime.execute = 0;
+	}
 
 	schedulerGpu.BeginFrame(frameContext);
 	try {
@@ -94,8 +249,20 @@ void SchedulerCPU::RunPipeline(const FrameContext& frameContext, SchedulerGPU& s
 		if (uploadList) {
 			schedulerGpu.Enqueue(std::move(uploadList), std::move(uploadVheap)).get();
 		}
+		auto[mipList, mipVheap] = ExecuteMipGenerationTask(frameContext);
+		if (mipList) {
+			schedulerGpu.Enqueue(std::move(mipList), std::move(mipVheap)).get();
+		}
+		auto[prefilterList, prefilterVheap] = ExecutePrefilterTask(frameContext);
+		if (prefilterList) {
+			schedulerGpu.Enqueue(std::move(prefilterList), std::move(prefilterVheap)).get();
+		}
 		LaunchTasks(frameContextEx, OnSetupNode);
 		LaunchTasks(frameContextEx, OnExecuteNode);
+		auto[readbackList, readbackVheap] = ExecuteReadbackTask(frameContext);
+		if (readbackList) {
+			schedulerGpu.Enqueue(std::move(readbackList), std::move(readbackVheap)).get();
+		}
 		schedulerGpu.EndFrame(true).get();
 	}
 	catch (...) {
@@ -105,6 +272,32 @@ void SchedulerCPU::RunPipeline(const FrameContext& frameContext, SchedulerGPU& s
 }
 
 
+std::vector<std::vector<bool>> SchedulerCPU::GetPrecedence(const lemon::ListDigraph& graph) {
+	size_t nodeCount = (size_t)graph.maxNodeId() + 1;
+	std::vector<std::vector<bool>> precedes(nodeCount, std::vector<bool>(nodeCount, false));
+
+	// Depth first search from every task, graphs are small.
+	std::vector<lemon::ListDigraph::Node> stack;
+	for (lemon::ListDigraph::NodeIt source(graph); source != lemon::INVALID; ++source) {
+		std::vector<bool>& reachable = precedes[graph.id(source)];
+		stack.push_back(source);
+		while (!stack.empty()) {
+			auto node = stack.back();
+			stack.pop_back();
+			for (lemon::ListDigraph::OutArcIt outArc(graph, node); outArc != lemon::INVALID; ++outArc) {
+				auto next = graph.target(outArc);
+				if (!reachable[graph.id(next)]) {
+					reachable[graph.id(next)] = true;
+					stack.push_back(next);
+				}
+			}
+		}
+	}
+
+	return precedes;
+}
+
+
 std::vector<lemon::ListDigraph::Node> SchedulerCPU::GetSourceNodes(const lemon::ListDigraph& graph) {
 	std::vector<lemon::ListDigraph::Node> sources;
 
@@ -160,6 +353,8 @@ void SchedulerCPU::LaunchTasks(const FrameContextEx& context, std::function<jobs
 				}
 			}
 
+			// Single resumption when the last child is done, then collect exceptions without suspending.
+			co_await jobs::WhenAll(childJobs);
 			for (auto& childFuture : childJobs) {
 				co_await childFuture;
 			}
@@ -195,28 +390,34 @@ void SchedulerCPU::LaunchTasks(const FrameContextEx& context, std::function<jobs
 
 jobs::Future<std::any> SchedulerCPU::OnSetupNode(const FrameContextEx& context, const Pipeline& pipeline, lemon::ListDigraph::Node node, std::any) {
 	GraphicsTask* task = pipeline.GetTaskFunctionMap()[node];
-	if (task != nullptr) {
-		SetupNode(*task, context);
+	if (task != nullptr && !IsSkipped(context, pipeline, node)) {
+		ProfileScope zone(GetZoneName("Setup ", pipeline, node));
+		auto begin = std::chrono::steady_clock::now();
+		SetupNode(*task, context, (size_t)pipeline.GetTaskGraph().id(node));
+		context.taskTimes[pipeline.GetTaskGraph().id(node)].setup = (std::chrono::steady_clock::now() - begin).count();
 	}
 	co_return std::any{};
 }
 
 
-void SchedulerCPU::SetupNode(GraphicsTask& task, const FrameContextEx& context) {
+void SchedulerCPU::SetupNode(GraphicsTask& task, const FrameContextEx& context, size_t taskId) {
 	// Setup given node.
 	SetupContext setupContext(context.memoryManager,
 							  context.textureSpace,
 							  context.rtvHeap,
 							  context.dsvHeap,
 							  context.shaderManager,
-							  context.gxApi);
+							  context.gxApi,
+							  context.jobScheduler,
+							  context.transientPool,
+							  taskId);
 	task.Setup(setupContext);
 }
 
 
 jobs::Future<std::any> SchedulerCPU::OnExecuteNode(const FrameContextEx& context, const Pipeline& pipeline, lemon::ListDigraph::Node node, std::any forwarded) {
 	GraphicsTask* task = pipeline.GetTaskFunctionMap()[node];
-	if (task != nullptr) {
+	if (task != nullptr && !IsSkipped(context, pipeline, node)) {
 		// See if we inherited anything.
 		std::optional<ProducedCommands> heritage;
 		if (forwarded.has_value()) {
@@ -225,7 +426,13 @@ jobs::Future<std::any> SchedulerCPU::OnExecuteNode(const FrameContextEx& context
 		}
 
 		// Execute task.
-		ProducedCommands commands = ExecuteNode(*task, heritage, context);
+		ProducedCommands commands;
+		{
+			ProfileScope zone(GetZoneName("Execute ", pipeline, node));
+			auto begin = std::chrono::steady_clock::now();
+			commands = ExecuteNode(*task, context.gpuProfiler ? GetNodeName(pipeline, node) : std::string{}, heritage, context);
+			context.taskTimes[pipeline.GetTaskGraph().id(node)].execute = (std::chrono::steady_clock::now() - begin).count();
+		}
 
 		// Enqueue heritage.
 		if (heritage) {
@@ -235,9 +442,10 @@ jobs::Future<std::any> SchedulerCPU::OnExecuteNode(const FrameContextEx& context
 		}
 
 		// Determine if next node can inherit.
+		// With secondary lists the last list is not the main one, so nothing is passed on.
 		const auto& taskGraph = pipeline.GetTaskGraph();
 		bool canNextInherit = false;
-		if (lemon::countOutArcs(taskGraph, node) == 1) {
+		if (lemon::countOutArcs(taskGraph, node) == 1 && commands.secondaryLists.empty()) {
 			lemon::ListDigraph::OutArcIt theOnlyOutArc(taskGraph, node);
 			lemon::ListDigraph::Node theOnlyNextNode = taskGraph.target(theOnlyOutArc);
 			canNextInherit = lemon::countInArcs(taskGraph, theOnlyNextNode) == 1;
@@ -254,13 +462,79 @@ jobs::Future<std::any> SchedulerCPU::OnExecuteNode(const FrameContextEx& context
 				co_await context.schedulerGpu->Enqueue(std::move(commands.list), std::move(commands.vheap));
 			}
 		}
+
+		// Secondary lists go one after the other, so the enqueuer patches their barriers against the states
+		// the previous list left behind.
+		for (size_t i = 0; i < commands.secondaryLists.size(); ++i) {
+			co_await context.schedulerGpu->Enqueue(std::move(commands.secondaryLists[i]), std::move(commands.secondaryVheaps[i]));
+		}
+	}
+	else if (forwarded.has_value()) {
+		// Commands handed down by the previous task are submitted in its place.
+		ProducedCommands& commands = *std::any_cast<std::shared_ptr<ProducedCommands>&>(forwarded);
+		co_await context.schedulerGpu->Enqueue(std::move(commands.list), std::move(commands.vheap));
 	}
 
 	co_return std::any{};
 }
 
 
-SchedulerCPU::ProducedCommands SchedulerCPU::ExecuteNode(GraphicsTask& task, std::optional<ProducedCommands>& inherited, const FrameContextEx& context) {
+std::vector<NodeCost> SchedulerCPU::GetNodeCosts(const GpuFrameReport* gpuReport) const {
+	assert(m_pipeline);
+	const lemon::ListDigraph& dependencyGraph = m_pipeline->GetDependencyGraph();
+	const lemon::ListDigraph& taskGraph = m_pipeline->GetTaskGraph();
+	std::vector<NodeCost> costs((size_t)dependencyGraph.maxNodeId() + 1);
+
+	for (lemon::ListDigraph::NodeIt task(taskGraph); task != lemon::INVALID; ++task) {
+		lemon::ListDigraph::Node parent = m_pipeline->GetTaskParentMap()[task];
+		if (parent != lemon::INVALID) {
+			const TaskTime& taskTime = m_taskTimes[taskGraph.id(task)];
+			NodeCost& cost = costs[dependencyGraph.id(parent)];
+			cost.setupMilliseconds += float(taskTime.setup.load() / 1e6);
+			cost.executeMilliseconds += float(taskTime.execute.load() / 1e6);
+		}
+	}
+
+	if (gpuReport) {
+		// The profiler names the scopes the same way.
+		for (lemon::ListDigraph::NodeIt depNode(dependencyGraph); depNode != lemon::INVALID; ++depNode) {
+			const NodeBase& node = *m_pipeline->GetNodeMap()[depNode];
+			std::string name = node.GetDisplayName().empty() ? node.GetClassName(true) : node.GetDisplayName();
+			auto it = std::find_if(gpuReport->nodes.begin(), gpuReport->nodes.end(), [&](const GpuNodeReport& report) { return report.name == name; });
+			if (it != gpuReport->nodes.end()) {
+				costs[dependencyGraph.id(depNode)].gpuMilliseconds = float(it->milliseconds);
+			}
+		}
+	}
+	return costs;
+}
+
+
+bool SchedulerCPU::IsSkipped(const FrameContextEx& context, const Pipeline& pipeline, lemon::ListDigraph::Node task) {
+	return context.skippedTasks && (*context.skippedTasks)[pipeline.GetTaskGraph().id(task)];
+}
+
+
+std::string SchedulerCPU::GetNodeName(const Pipeline& pipeline, lemon::ListDigraph::Node task) {
+	lemon::ListDigraph::Node parent = pipeline.GetTaskParentMap()[task];
+	if (parent == lemon::INVALID) {
+		return "Internal";
+	}
+	const NodeBase& node = *pipeline.GetNodeMap()[parent];
+	return node.GetDisplayName().empty() ? node.GetClassName(true) : node.GetDisplayName();
+}
+
+
+const char* SchedulerCPU::GetZoneName(const char* prefix, const Pipeline& pipeline, lemon::ListDigraph::Node task) {
+	FrameProfiler& profiler = FrameProfiler::GetGlobal();
+	if (!profiler.IsEnabled()) {
+		return ""; // Not recorded anyway, skip the name lookup.
+	}
+	return profiler.Intern(prefix + GetNodeName(pipeline, task));
+}
+
+
+SchedulerCPU::ProducedCommands SchedulerCPU::ExecuteNode(GraphicsTask& task, const std::string& name, std::optional<ProducedCommands>& inherited, const FrameContextEx& context) {
 	// Inherit command list, if available.
 	std::unique_ptr<BasicCommandList> inheritedCommandList;
 	std::unique_ptr<VolatileViewHeap> inheritedVheap;
@@ -271,7 +545,7 @@ SchedulerCPU::ProducedCommands SchedulerCPU::ExecuteNode(GraphicsTask& task, std
 	}
 
 	// Execute given node.
-	auto vheap = std::make_unique<VolatileViewHeap>(context.gxApi);
+	auto vheap = std::make_unique<VolatileViewHeap>(context.gxApi, context.scratchSpacePool);
 	RenderContext renderContext(context.memoryManager,
 								context.textureSpace,
 								context.shaderManager,
@@ -280,9 +554,14 @@ SchedulerCPU::ProducedCommands SchedulerCPU::ExecuteNode(GraphicsTask& task, std
 								context.commandAllocatorPool,
 								context.scratchSpacePool,
 								std::move(inheritedCommandList),
-								std::move(inheritedVheap));
+								std::move(inheritedVheap),
+								context.frameArena,
+								context.jobScheduler,
+								context.computeQueue != nullptr);
 	renderContext.SetCommandListName(typeid(task).name());
+	renderContext.SetGpuProfiler(context.gpuProfiler, name);
 	task.Execute(renderContext);
+	renderContext.EndGpuScopes();
 
 	// Get inherited and current list, if any.
 	std::unique_ptr<BasicCommandList> currentCommandList;
@@ -296,7 +575,9 @@ SchedulerCPU::ProducedCommands SchedulerCPU::ExecuteNode(GraphicsTask& task, std
 		inherited.reset();
 	}
 
-	return { std::move(currentCommandList), std::move(currentVheap) };
+	ProducedCommands produced{ std::move(currentCommandList), std::move(currentVheap) };
+	renderContext.DecomposeSecondary(produced.secondaryLists, produced.secondaryVheaps);
+	return produced;
 }
 
 
@@ -1,11 +1,15 @@
 #pragma once
 
+#include "CubemapPrefilterTask.hpp"
 #include "FrameContext.hpp"
+#include "MipGenerationTask.hpp"
 #include "Pipeline.hpp"
+#include "TransientTexturePool.hpp"
 
 #include <BaseLibrary/JobSystem/Scheduler.hpp>
 
 #include <any>
+#include <atomic>
 #include <optional>
 
 
@@ -14,6 +18,7 @@ namespace inl::gxeng {
 
 
 class SchedulerGPU;
+struct GpuFrameReport;
 
 
 class SchedulerCPU {
@@ -23,28 +28,66 @@ public:
 
 	void RunPipeline(const FrameContext& frameContext, SchedulerGPU& schedulerGpu);
 
+	/// <summary> Textures from <see cref="SetupContext::CreateTransientTexture2D"/> are shared between ordered tasks if enabled. </summary>
+	void SetTransientAliasing(bool enabled) { m_transientPool.SetAliasing(enabled); }
+	TransientTexturePool::Statistics GetTransientStatistics() const { return m_transientPool.GetStatistics(); }
+	void ReleaseTransientTextures() { m_transientPool.Clear(); }
+
+	/// <summary> CPU time of the tasks of each pipeline node in the last frame, and the GPU time from the report. </summary>
+	/// <param name="gpuReport"> GPU times are matched to the nodes by name, may be null. </param>
+	/// <returns> Indexed by the ids of the dependency graph. </returns>
+	std::vector<NodeCost> GetNodeCosts(const GpuFrameReport* gpuReport) const;
+
 private:
 	// Refactored way
 	struct ProducedCommands {
 		std::unique_ptr<BasicCommandList> list;
 		std::unique_ptr<VolatileViewHeap> vheap;
+		// Recorded in parallel by the task, submitted after list in this order.
+		std::vector<std::unique_ptr<BasicCommandList>> secondaryLists;
+		std::vector<std::unique_ptr<VolatileViewHeap>> secondaryVheaps;
+	};
+	struct TaskTime {
+		std::atomic<int64_t> setup{ 0 }; // Nanoseconds.
+		std::atomic<int64_t> execute{ 0 };
 	};
 	struct FrameContextEx : public FrameContext {
 		SchedulerGPU* schedulerGpu = nullptr;
+		TaskTime* taskTimes = nullptr; // Indexed by task graph id.
+		jobs::Scheduler* jobScheduler = nullptr;
+		TransientTexturePool* transientPool = nullptr;
 	};
 
+	/// <summary> Records the mip generations queued for the frame, they run after the uploads on the graphics queue. </summary>
+	std::tuple<std::unique_ptr<BasicCommandList>, std::unique_ptr<VolatileViewHeap>> ExecuteMipGenerationTask(const FrameContext& context);
+	/// <summary> Records the frame's slice of the cubemap prefilters in progress, after the mip generations on the graphics queue. </summary>
+	std::tuple<std::unique_ptr<BasicCommandList>, std::unique_ptr<VolatileViewHeap>> ExecutePrefilterTask(const FrameContext& context);
+
 	static std::vector<lemon::ListDigraph::Node> GetSourceNodes(const lemon::ListDigraph& graph);
 	void LaunchTasks(const FrameContextEx& context, std::function<jobs::Future<std::any>(const FrameContextEx&, const Pipeline&, lemon::ListDigraph::Node, std::any)> onNode);
 
 	static jobs::Future<std::any> OnSetupNode(const FrameContextEx& context, const Pipeline& pipeline, lemon::ListDigraph::Node node, std::any);
-	static void SetupNode(GraphicsTask& task, const FrameContextEx& context);
+	static void SetupNode(GraphicsTask& task, const FrameContextEx& context, size_t taskId);
+
+	/// <summary> For each pair of tasks, true if the first one is an ancestor of the second in the task graph. </summary>
+	static std::vector<std::vector<bool>> GetPrecedence(const lemon::ListDigraph& graph);
 
 	static jobs::Future<std::any> OnExecuteNode(const FrameContextEx& context, const Pipeline& pipeline, lemon::ListDigraph::Node node, std::any forwarded);
-	static ProducedCommands ExecuteNode(GraphicsTask& task, std::optional<ProducedCommands>& inherited, const FrameContextEx& context);
+	static ProducedCommands ExecuteNode(GraphicsTask& task, const std::string& name, std::optional<ProducedCommands>& inherited, const FrameContextEx& context);
+	/// <summary> True if the node of the task was disabled for the frame. </summary>
+	static bool IsSkipped(const FrameContextEx& context, const Pipeline& pipeline, lemon::ListDigraph::Node task);
+	/// <summary> Display name of the pipeline node the task belongs to, or its class name if it has none. </summary>
+	static std::string GetNodeName(const Pipeline& pipeline, lemon::ListDigraph::Node task);
+	/// <summary> Name of the task's CPU profiler zone, lives as long as the profiler. </summary>
+	static const char* GetZoneName(const char* prefix, const Pipeline& pipeline, lemon::ListDigraph::Node task);
 
 private:
 	const Pipeline* m_pipeline = nullptr;
 	jobs::Scheduler* m_scheduler = nullptr;
+	TransientTexturePool m_transientPool;
+	std::vector<TaskTime> m_taskTimes;
+	MipGenerationTask m_mipGenerationTask; // Keeps its shaders between frames.
+	CubemapPrefilterTask m_prefilterTask; // Keeps the prefilters in progress between frames.
 };
 
 
@@ -2,6 +2,7 @@
 
 #include "ResourceResidencyQueue.hpp"
 
+#include <algorithm>
 #include <functional>
 
 
@@ -23,7 +24,10 @@ void SchedulerGPU::BeginFrame(const FrameContext& context) {
 		throw InvalidCallException("First finalize previous frame by EndFrame.");
 	}
 	m_currentContext = std::make_shared<FrameContext>(context);
-	m_enqueueCoro = m_scheduler->Enqueue(&SchedulerGPU::EnqueueCoro, this, std::ref(*m_scheduler));
+	// Submission is what the GPU waits on, don't let it queue up behind recording jobs.
+	jobs::JobOptions submitOptions;
+	submitOptions.priority = jobs::eJobPriority::CRITICAL;
+	m_enqueueCoro = m_scheduler->Enqueue(submitOptions, &SchedulerGPU::EnqueueCoro, this, std::ref(*m_scheduler));
 }
 
 
@@ -80,83 +84,193 @@ jobs::Future<void> SchedulerGPU::EnqueueCoro(SchedulerGPU* self, jobs::Scheduler
 
 
 ListEnqueuer::ListEnqueuer(const FrameContext& context)
-	: m_context(context) {}
+	: m_context(context) {
+	GetQueue(eQueue::GRAPHICS).queue = context.commandQueue;
+	GetQueue(eQueue::COMPUTE).queue = context.computeQueue;
+	GetQueue(eQueue::COPY).queue = context.copyQueue;
+
+	// Graphics work of previous frames may still read what this frame's async work overwrites.
+	// The other way around is covered, as the graphics queue waits for compute at the end of each frame,
+	// and copies are only read after waiting for them.
+	for (eQueue asyncQueue : { eQueue::COMPUTE, eQueue::COPY }) {
+		if (GetQueue(asyncQueue).queue) {
+			GetQueue(asyncQueue).queue->Wait(context.commandQueue->Signal());
+		}
+	}
+}
 
 
 void ListEnqueuer::operator()(std::unique_ptr<BasicCommandList> commandList, std::unique_ptr<VolatileViewHeap> currentVheap) {
 	// Process current list.
+	QueueState& target = GetQueue(commandList->GetType());
 	auto currentList = commandList->Decompose();
-	auto barriers = GetTransitionBarriers(currentList.usedResources);
+	auto barriers = GetTransitionBarriers(currentList.usedResources, m_context.frameArena);
+
+	// Resources used on the copy queue decay to the common state when the list finishes.
+	if (&target == &GetQueue(eQueue::COPY)) {
+		for (auto& usage : currentList.usedResources) {
+			usage.lastState = gxapi::eResourceState::COMMON;
+		}
+	}
 	UpdateResourceStates(currentList.usedResources);
 
 	// Submit barriers.
+	// They go at the end of the previous list, unless it runs on an async queue and can't do all of them.
 	if (!barriers.empty()) {
-		if (!m_prevList.commandList) {
-			m_prevList.commandAllocator = m_context.commandAllocatorPool->RequestAllocator(gxapi::eCommandListType::GRAPHICS);
-			m_prevList.commandList = m_context.commandListPool->RequestGraphicsList(m_prevList.commandAllocator.get());
+		if (!m_prevList.commandList || !CanRecordOnQueue(*m_prevQueue, barriers)) {
+			SubmitPrevious();
+			StartBarrierList();
 		}
 		auto* prevCopyList = dynamic_cast<gxapi::ICopyCommandList*>(m_prevList.commandList.get());
 		prevCopyList->ResourceBarrier((unsigned)barriers.size(), barriers.data());
+		for (const auto& barrier : barriers) {
+			m_prevBarrierResources.push_back(barrier.transition.resource);
+		}
 	}
 
 	// Enqueue previous list.
-	if (m_prevList.commandList) {
-		dynamic_cast<gxapi::ICopyCommandList*>(m_prevList.commandList.get())->Close();
-		auto usedResource = GetUsedResources(m_prevList.usedResources, m_prevList.additionalResources);
-
-		SendToQueue(*m_context.commandQueue,
-			m_context,
-			std::move(m_prevList.commandList),
-			std::move(usedResource),
-			std::move(m_prevList.scratchSpaces),
-			std::move(m_prevList.commandAllocator),
-			std::move(m_prevVheap));
-	}
+	SubmitPrevious();
 
 	// Save current list for barrier injection of the next list.
 	m_prevList = std::move(currentList);
 	m_prevVheap = std::move(currentVheap);
+	m_prevQueue = &target;
 }
 
 
 void ListEnqueuer::Present() {
+	QueueState& graphicsQueue = GetQueue(eQueue::GRAPHICS);
+
 	// Set backBuffer to PRESENT state.
 	Texture2D backBuffer = m_context.backBuffer;
 	gxapi::eResourceState backBufferState = backBuffer.ReadState(0);
 	if (backBufferState != gxapi::eResourceState::PRESENT) {
-		if (!m_prevList.commandList) {
-			m_prevList.commandAllocator = m_context.commandAllocatorPool->RequestAllocator(gxapi::eCommandListType::GRAPHICS);
-			m_prevList.commandList = m_context.commandListPool->RequestGraphicsList(m_prevList.commandAllocator.get());
+		if (!m_prevList.commandList || m_prevQueue != &graphicsQueue) {
+			SubmitPrevious();
+			StartBarrierList();
 		}
 
 		gxapi::TransitionBarrier barrier(m_context.backBuffer._GetResourcePtr(), backBufferState, gxapi::eResourceState::PRESENT);
 		dynamic_cast<gxapi::ICopyCommandList*>(m_prevList.commandList.get())->ResourceBarrier(barrier);
+		m_prevBarrierResources.push_back(barrier.resource);
 		backBuffer.RecordState(gxapi::eResourceState::PRESENT);
 	}
 
 	// Enqueue last command list, if exists.
-	if (m_prevList.commandList) {
-		dynamic_cast<gxapi::ICopyCommandList*>(m_prevList.commandList.get())->Close();
+	SubmitPrevious();
+
+	// The frame is finished by a signal on the graphics queue, it has to cover async work as well.
+	// Frame memory, like upload staging pages, is recycled when that signal is reached.
+	for (eQueue asyncQueue : { eQueue::COMPUTE, eQueue::COPY }) {
+		QueueState& queue = GetQueue(asyncQueue);
+		if (queue.queue && queue.submitCount != graphicsQueue.waitedFor[(size_t)asyncQueue]) {
+			graphicsQueue.queue->Wait(queue.lastCompletion);
+			graphicsQueue.waitedFor[(size_t)asyncQueue] = queue.submitCount;
+		}
+	}
+}
 
-		std::vector<MemoryObject> usedResources = GetUsedResources(std::move(m_prevList.usedResources), std::move(m_prevList.additionalResources));
 
-		SendToQueue(*m_context.commandQueue,
-					m_context,
-					std::move(m_prevList.commandList),
-					std::move(usedResources),
-					std::move(m_prevList.scratchSpaces),
-					std::move(m_prevList.commandAllocator),
-					std::move(m_prevVheap));
+ListEnqueuer::QueueState& ListEnqueuer::GetQueue(gxapi::eCommandListType type) {
+	if (type == gxapi::eCommandListType::COMPUTE) {
+		if (!GetQueue(eQueue::COMPUTE).queue) {
+			throw InvalidStateException("Compute command lists need a compute queue.");
+		}
+		return GetQueue(eQueue::COMPUTE);
+	}
+	if (type == gxapi::eCommandListType::COPY) {
+		if (!GetQueue(eQueue::COPY).queue) {
+			throw InvalidStateException("Copy command lists need a copy queue.");
+		}
+		return GetQueue(eQueue::COPY);
 	}
+	return GetQueue(eQueue::GRAPHICS);
 }
 
 
-std::vector<gxapi::ResourceBarrier> ListEnqueuer::GetTransitionBarriers(const std::vector<ResourceUsage>& usages) {
-	std::vector<gxapi::ResourceBarrier> barriers;
+bool ListEnqueuer::CanRecordOnQueue(const QueueState& queue, const std::vector<gxapi::ResourceBarrier, ArenaAllocator<gxapi::ResourceBarrier>>& barriers) const {
+	bool (*isLegal)(gxapi::eResourceState) = nullptr;
+	if (&queue == &m_queues[(size_t)eQueue::COMPUTE]) {
+		isLegal = &IsComputeQueueState;
+	}
+	else if (&queue == &m_queues[(size_t)eQueue::COPY]) {
+		isLegal = &IsCopyQueueState;
+	}
+	else {
+		return true;
+	}
+	return std::all_of(barriers.begin(), barriers.end(), [isLegal](const gxapi::ResourceBarrier& barrier) {
+		return isLegal(barrier.transition.beforeState) && isLegal(barrier.transition.afterState);
+	});
+}
+
+
+void ListEnqueuer::StartBarrierList() {
+	// Graphics lists can do any transition.
+	m_prevList.commandAllocator = m_context.commandAllocatorPool->RequestAllocator(gxapi::eCommandListType::GRAPHICS);
+	m_prevList.commandList = m_context.commandListPool->RequestGraphicsList(m_prevList.commandAllocator.get());
+	m_prevQueue = &GetQueue(eQueue::GRAPHICS);
+}
+
+
+void ListEnqueuer::SubmitPrevious() {
+	if (!m_prevList.commandList) {
+		return;
+	}
+	QueueState& target = *m_prevQueue;
+
+	dynamic_cast<gxapi::ICopyCommandList*>(m_prevList.commandList.get())->Close();
+	std::vector<MemoryObject> usedResources = GetUsedResources(m_prevList.usedResources, std::move(m_prevList.additionalResources));
+
+	std::vector<gxapi::IResource*, ArenaAllocator<gxapi::IResource*>> touched{ ArenaAllocator<gxapi::IResource*>(m_context.frameArena) };
+	touched.reserve(usedResources.size() + m_prevBarrierResources.size());
+	touched.insert(touched.end(), m_prevBarrierResources.begin(), m_prevBarrierResources.end());
+	for (const MemoryObject& resource : usedResources) {
+		touched.push_back(resource._GetResourcePtr());
+	}
+
+	// Wait for other queues that touched any of the resources since we last waited for them.
+	for (size_t otherIdx = 0; otherIdx < m_queues.size(); ++otherIdx) {
+		QueueState& other = m_queues[otherIdx];
+		if (&other == &target || !other.queue || other.submitCount == target.waitedFor[otherIdx]) {
+			continue;
+		}
+		bool dependent = std::any_of(touched.begin(), touched.end(), [&](gxapi::IResource* resource) {
+			auto it = other.lastUse.find(resource);
+			return it != other.lastUse.end() && it->second > target.waitedFor[otherIdx];
+		});
+		if (dependent) {
+			target.queue->Wait(other.lastCompletion);
+			target.waitedFor[otherIdx] = other.submitCount;
+		}
+	}
+
+	target.lastCompletion = SendToQueue(*target.queue,
+										m_context,
+										std::move(m_prevList.commandList),
+										std::move(usedResources),
+										std::move(m_prevList.scratchSpaces),
+										std::move(m_prevList.commandAllocator),
+										std::move(m_prevVheap),
+										std::move(m_prevList.retainedObjects));
+	++target.submitCount;
+	for (gxapi::IResource* resource : touched) {
+		target.lastUse[resource] = target.submitCount;
+	}
+
+	m_prevList = {};
+	m_prevBarrierResources.clear();
+	m_prevQueue = nullptr;
+}
+
+
+std::vector<gxapi::ResourceBarrier, ArenaAllocator<gxapi::ResourceBarrier>> ListEnqueuer::GetTransitionBarriers(const std::vector<ResourceUsage>& usages, LinearArena* arena) {
+	std::vector<gxapi::ResourceBarrier, ArenaAllocator<gxapi::ResourceBarrier>> barriers{ ArenaAllocator<gxapi::ResourceBarrier>(arena) };
+	barriers.reserve(usages.size());
 
 	// Collect all necessary barriers.
-	for (auto usage : usages) {
-		MemoryObject& resource = usage.resource;
+	for (const auto& usage : usages) {
+		const MemoryObject& resource = usage.resource;
 		unsigned subresource = usage.subresource;
 		gxapi::eResourceState targetState = usage.firstState;
 
@@ -165,9 +279,23 @@ std::vector<gxapi::ResourceBarrier> ListEnqueuer::GetTransitionBarriers(const st
 			if (sourceState != targetState) {
 				barriers.push_back(gxapi::TransitionBarrier{ resource._GetResourcePtr(), sourceState, targetState, subresource });
 			}
+			continue;
+		}
+
+		// A single barrier for the whole resource if its subresources are all in the same state.
+		const unsigned numSubresources = resource.GetNumSubresources();
+		const gxapi::eResourceState wholeState = resource.ReadState(0);
+		unsigned numUniform = 1;
+		while (numUniform < numSubresources && resource.ReadState(numUniform) == wholeState) {
+			++numUniform;
+		}
+		if (numUniform == numSubresources) {
+			if (wholeState != targetState) {
+				barriers.push_back(gxapi::TransitionBarrier{ resource._GetResourcePtr(), wholeState, targetState, gxapi::ALL_SUBRESOURCES });
+			}
 		}
 		else {
-			for (unsigned subresourceIdx = 0; subresourceIdx < resource.GetNumSubresources(); ++subresourceIdx) {
+			for (unsigned subresourceIdx = 0; subresourceIdx < numSubresources; ++subresourceIdx) {
 				gxapi::eResourceState sourceState = resource.ReadState(subresourceIdx);
 				if (sourceState != targetState) {
 					barriers.push_back(gxapi::TransitionBarrier{ resource._GetResourcePtr(), sourceState, targetState, subresourceIdx });
@@ -180,12 +308,10 @@ std::vector<gxapi::ResourceBarrier> ListEnqueuer::GetTransitionBarriers(const st
 }
 
 
-void ListEnqueuer::UpdateResourceStates(const std::vector<ResourceUsage>& usages) {
-	for (auto usage : usages) {
+void ListEnqueuer::UpdateResourceStates(std::vector<ResourceUsage>& usages) {
+	for (auto& usage : usages) {
 		if (usage.subresource == gxapi::ALL_SUBRESOURCES) {
-			for (unsigned s = 0; s < usage.resource.GetNumSubresources(); ++s) {
-				usage.resource.RecordState(s, usage.lastState);
-			}
+			usage.resource.RecordState(usage.lastState);
 		}
 		else {
 			usage.resource.RecordState(usage.subresource, usage.lastState);
@@ -195,14 +321,12 @@ void ListEnqueuer::UpdateResourceStates(const std::vector<ResourceUsage>& usages
 
 
 std::vector<MemoryObject> ListEnqueuer::GetUsedResources(const std::vector<ResourceUsage>& usages, std::vector<MemoryObject> additional) {
+	// The list is kept by the residency queue until the GPU is done, so it cannot use the frame arena.
 	std::vector<MemoryObject> usedResourceList = std::move(additional);
 
-	usedResourceList.reserve(usages.size() + additional.size());
+	usedResourceList.reserve(usedResourceList.size() + usages.size());
 	for (auto& v : usages) {
-		usedResourceList.push_back(std::move(v.resource));
-	}
-	for (auto& v : additional) {
-		usedResourceList.push_back(std::move(v));
+		usedResourceList.push_back(v.resource);
 	}
 
 	return usedResourceList;
@@ -210,7 +334,7 @@ std::vector<MemoryObject> ListEnqueuer::GetUsedResources(const std::vector<Resou
 
 
 template <class... Args>
-void ListEnqueuer::SendToQueue(CommandQueue& target,
+SyncPoint ListEnqueuer::SendToQueue(CommandQueue& target,
 							   const FrameContext& context,
 							   CmdListPtr list,
 							   std::vector<MemoryObject> usedResources,
@@ -222,12 +346,13 @@ void ListEnqueuer::SendToQueue(CommandQueue& target,
 	gxapi::ICommandList* execLists[] = {
 		list.get(),
 	};
-	context.commandQueue->Wait(residentPoint);
-	context.commandQueue->ExecuteCommandLists(1, execLists);
-	SyncPoint completionPoint = context.commandQueue->Signal();
+	target.Wait(residentPoint);
+	target.ExecuteCommandLists(1, execLists);
+	SyncPoint completionPoint = target.Signal();
 
 	// Enqueue CPU task to clean up resources after command list finished.
 	context.residencyQueue->EnqueueClean(completionPoint, std::move(usedResources), std::forward<Args>(cleanables)...);
+	return completionPoint;
 }
 
 
@@ -10,7 +10,9 @@
 #include <BaseLibrary/JobSystem/Scheduler.hpp>
 
 #include <memory>
+#include <array>
 #include <queue>
+#include <unordered_map>
 
 
 namespace inl::gxeng {
@@ -18,6 +20,8 @@ namespace inl::gxeng {
 
 // Handles the enqueuing of command lists, including barrier injection, resource state tracking
 // and determining if async mode is possible.
+// Compute and copy type lists go to their own queues. A queue only waits for another one when it uses
+// a resource the other queue touched since it last waited, so independent work overlaps.
 class ListEnqueuer {
 public:
 	ListEnqueuer(const FrameContext& context);
@@ -27,23 +31,49 @@ public:
 	// Command lists (gxeng, not gxapi) do not issue resource barriers for the first time SetResourceState is called.
 	// Instead, these states are recorded, and must be "patched in", that is, issued before said command list
 	// by the scheduler. This function gives the list of barriers to issue.
-	static std::vector<gxapi::ResourceBarrier> GetTransitionBarriers(const std::vector<ResourceUsage>& usages);
+	// The barriers are only needed until recorded, so they may live in the frame arena.
+	static std::vector<gxapi::ResourceBarrier, ArenaAllocator<gxapi::ResourceBarrier>> GetTransitionBarriers(const std::vector<ResourceUsage>& usages, LinearArena* arena = nullptr);
 
 	// Goes over the list of resource usages of a command list and updates CPU-side resource state tracking accordingly.
-	static void UpdateResourceStates(const std::vector<ResourceUsage>& usages);
+	static void UpdateResourceStates(std::vector<ResourceUsage>& usages);
 
 	std::vector<MemoryObject> GetUsedResources(const std::vector<ResourceUsage>& usages, std::vector<MemoryObject> additional);
 
 	// Enqueues a command list in target, manages init and clean jobs for the command list.
+	// Returns the point where the list has finished on the GPU.
 	template <class... Args>
-	void SendToQueue(CommandQueue& target,
+	SyncPoint SendToQueue(CommandQueue& target,
 		const FrameContext& context,
 		CmdListPtr list,
 		std::vector<MemoryObject> usedResources,
 		Args&&... cleanables);
+private:
+	enum class eQueue {
+		GRAPHICS,
+		COMPUTE,
+		COPY,
+		COUNT,
+	};
+	struct QueueState {
+		CommandQueue* queue = nullptr;
+		SyncPoint lastCompletion;
+		uint64_t submitCount = 0;
+		std::unordered_map<gxapi::IResource*, uint64_t> lastUse; // Submit count of the last list touching the resource.
+		std::array<uint64_t, (size_t)eQueue::COUNT> waitedFor = {}; // Submit counts of other queues this queue has waited for.
+	};
+
+	QueueState& GetQueue(gxapi::eCommandListType type);
+	QueueState& GetQueue(eQueue queue) { return m_queues[(size_t)queue]; }
+	bool CanRecordOnQueue(const QueueState& queue, const std::vector<gxapi::ResourceBarrier, ArenaAllocator<gxapi::ResourceBarrier>>& barriers) const;
+	void StartBarrierList();
+	void SubmitPrevious();
+
 private:
 	BasicCommandList::Decomposition m_prevList;
 	std::unique_ptr<VolatileViewHeap> m_prevVheap;
+	std::vector<gxapi::IResource*> m_prevBarrierResources; // Transitioned at the end of the previous list.
+	QueueState* m_prevQueue = nullptr;
+	std::array<QueueState, (size_t)eQueue::COUNT> m_queues;
 	const FrameContext& m_context;
 };
 
@@ -87,7 +117,7 @@ private:
 
 	std::queue<QueueItem> m_queue;
 	jobs::ConditionVariable m_cvar;
-	jobs::Mutex m_mtx;
+	jobs::Mutex m_mtx{ jobs::eMutexMode::ADAPTIVE }; // Critical sections only push or pop the queue.
 	jobs::Future<void> m_enqueueCoro;
 };
 
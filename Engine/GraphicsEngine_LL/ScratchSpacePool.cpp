@@ -1,53 +1,170 @@
 #include "ScratchSpacePool.hpp"
 #include <cassert>
 #include <algorithm>
+#include <iterator>
 
 namespace inl {
 namespace gxeng {
 
-ScratchSpacePool::ScratchSpacePool(gxapi::IGraphicsApi* gxApi, gxapi::eDescriptorHeapType type) 
-	: m_gxApi(gxApi), m_type(type)
+
+namespace {
+
+struct ThreadCacheRef {
+	uint64_t poolId = 0;
+	void* cache = nullptr;
+};
+
+thread_local ThreadCacheRef threadCache;
+std::atomic_uint64_t nextPoolId = 1;
+
+} // namespace
+
+
+ScratchSpacePool::ScratchSpacePool(gxapi::IGraphicsApi* gxApi, gxapi::eDescriptorHeapType type)
+	: m_id(nextPoolId++), m_type(type), m_gxApi(gxApi)
 {}
 
 
-auto ScratchSpacePool::RequestScratchSpace() -> UniquePtr {
-	std::lock_guard<std::mutex> lkg(m_mutex);
+auto ScratchSpacePool::RequestScratchSpace(uint32_t minSize) -> UniquePtr {
+	uint32_t size = std::max(minSize, GetPreferredSize());
+	ThreadCache& cache = GetThreadCache();
 
-	size_t index;
-	try {
-		index = m_allocator.Allocate();
+	if (StackDescHeap* scratchSpace = TakeFitting(cache.scratchSpaces, size)) {
+		return UniquePtr{ scratchSpace, Deleter{this} };
 	}
-	catch (std::bad_alloc&) {
-		size_t currentSize = m_pool.size();
-		size_t newSize = std::max(currentSize + 1, size_t(currentSize * 1.25));
-		m_pool.resize(newSize);
-		m_allocator.Resize(newSize);
 
-		index = m_allocator.Allocate();
+	std::lock_guard<std::mutex> lkg(m_mutex);
+	RefillScratchSpaces(cache);
+	if (StackDescHeap* scratchSpace = TakeFitting(cache.scratchSpaces, size)) {
+		return UniquePtr{ scratchSpace, Deleter{this} };
 	}
 
-	if (m_pool[index] != nullptr) {
-		return UniquePtr{ m_pool[index].get(), Deleter{this} };
+	m_pool.push_back(std::make_unique<StackDescHeap>(m_gxApi, m_type, size, m_bindlessHeap));
+	return UniquePtr{ m_pool.back().get(), Deleter{this} };
+}
+
+
+void ScratchSpacePool::RecycleScratchSpace(StackDescHeap* scratchSpace) {
+	scratchSpace->Reset();
+
+	std::lock_guard<std::mutex> lkg(m_mutex);
+	m_returnedScratchSpaces.push_back(scratchSpace);
+}
+
+
+std::unique_ptr<gxapi::IDescriptorHeap> ScratchSpacePool::RequestViewPage() {
+	ThreadCache& cache = GetThreadCache();
+
+	if (cache.viewPages.empty()) {
+		std::lock_guard<std::mutex> lkg(m_mutex);
+		size_t count = std::min(m_returnedViewPages.size(), REFILL_COUNT);
+		std::move(m_returnedViewPages.end() - count, m_returnedViewPages.end(), std::back_inserter(cache.viewPages));
+		m_returnedViewPages.resize(m_returnedViewPages.size() - count);
 	}
-	else {
-		std::unique_ptr<StackDescHeap> ptr(new StackDescHeap{ m_gxApi, m_type, 1000 });
-		m_addressToIndex[ptr.get()] = index;
-		m_pool[index] = std::move(ptr);
-		return UniquePtr{ m_pool[index].get(), Deleter{this} };
+	if (!cache.viewPages.empty()) {
+		auto page = std::move(cache.viewPages.back());
+		cache.viewPages.pop_back();
+		return page;
 	}
+
+	return std::unique_ptr<gxapi::IDescriptorHeap>(m_gxApi->CreateDescriptorHeap({ gxapi::eDescriptorHeapType::CBV_SRV_UAV, VIEW_PAGE_SIZE, false }));
 }
 
 
-void ScratchSpacePool::RecycleScratchSpace(StackDescHeap* scratchSpace) {
+void ScratchSpacePool::RecycleViewPages(std::vector<std::unique_ptr<gxapi::IDescriptorHeap>> pages) {
 	std::lock_guard<std::mutex> lkg(m_mutex);
+	std::move(pages.begin(), pages.end(), std::back_inserter(m_returnedViewPages));
+}
 
-	scratchSpace->Reset();
-	assert(m_addressToIndex.count(scratchSpace) > 0);
-	size_t index = m_addressToIndex[scratchSpace];
-	m_allocator.Deallocate(index);
+
+void ScratchSpacePool::BeginFrame() {
+	m_previousFrameUsage = m_currentFrameUsage.exchange(0);
+}
+
+
+void ScratchSpacePool::ReportUsage(size_t numDescriptors) {
+	size_t current = m_currentFrameUsage.load(std::memory_order_relaxed);
+	while (current < numDescriptors && !m_currentFrameUsage.compare_exchange_weak(current, numDescriptors, std::memory_order_relaxed)) {
+	}
+}
+
+
+uint32_t ScratchSpacePool::GetPreferredSize() const {
+	// Some headroom so that a slightly busier frame still fits, rounded to avoid a new size for every change.
+	size_t previous = m_previousFrameUsage.load(std::memory_order_relaxed);
+	size_t size = (previous + previous / 4 + 255) / 256 * 256;
+	return (uint32_t)std::max(size, size_t(DEFAULT_SCRATCH_SPACE_SIZE));
+}
+
+
+void ScratchSpacePool::SetBindlessHeap(const BindlessHeap* bindlessHeap) {
+	std::lock_guard<std::mutex> lkg(m_mutex);
+	assert(m_pool.empty());
+	m_bindlessHeap = bindlessHeap;
+}
+
+
+ScratchSpacePool::ThreadCache& ScratchSpacePool::GetThreadCache() {
+	if (threadCache.poolId == m_id) {
+		return *static_cast<ThreadCache*>(threadCache.cache);
+	}
+
+	std::lock_guard<std::mutex> lkg(m_mutex);
+	auto id = std::this_thread::get_id();
+	auto it = std::find_if(m_threadCaches.begin(), m_threadCaches.end(), [id](const auto& cache) { return cache->owner == id; });
+	if (it == m_threadCaches.end()) {
+		auto cache = std::make_unique<ThreadCache>();
+		cache->owner = id;
+		m_threadCaches.push_back(std::move(cache));
+		it = m_threadCaches.end() - 1;
+	}
+	threadCache = { m_id, it->get() };
+	return **it;
+}
+
+
+StackDescHeap* ScratchSpacePool::TakeFitting(std::vector<StackDescHeap*>& scratchSpaces, uint32_t size) {
+	auto it = std::find_if(scratchSpaces.begin(), scratchSpaces.end(), [size](StackDescHeap* scratchSpace) { return scratchSpace->GetCapacity() >= size; });
+	if (it == scratchSpaces.end()) {
+		return nullptr;
+	}
+	StackDescHeap* scratchSpace = *it;
+	*it = scratchSpaces.back();
+	scratchSpaces.pop_back();
+	return scratchSpace;
+}
+
+
+void ScratchSpacePool::RefillScratchSpaces(ThreadCache& cache) {
+	uint32_t preferredSize = GetPreferredSize();
+
+	// Ones in the thread cache that became too small go too.
+	auto isTooSmall = [preferredSize](StackDescHeap* scratchSpace) { return scratchSpace->GetCapacity() < preferredSize; };
+	auto tooSmall = std::partition(cache.scratchSpaces.begin(), cache.scratchSpaces.end(), [&](StackDescHeap* scratchSpace) { return !isTooSmall(scratchSpace); });
+	std::vector<StackDescHeap*> destroyed(tooSmall, cache.scratchSpaces.end());
+	cache.scratchSpaces.erase(tooSmall, cache.scratchSpaces.end());
+
+	size_t moved = 0;
+	while (!m_returnedScratchSpaces.empty() && moved < REFILL_COUNT) {
+		StackDescHeap* scratchSpace = m_returnedScratchSpaces.back();
+		m_returnedScratchSpaces.pop_back();
+		if (isTooSmall(scratchSpace)) {
+			destroyed.push_back(scratchSpace);
+		}
+		else {
+			cache.scratchSpaces.push_back(scratchSpace);
+			++moved;
+		}
+	}
+
+	if (!destroyed.empty()) {
+		m_pool.erase(std::remove_if(m_pool.begin(), m_pool.end(), [&destroyed](const std::unique_ptr<StackDescHeap>& scratchSpace) {
+			return std::find(destroyed.begin(), destroyed.end(), scratchSpace.get()) != destroyed.end();
+		}), m_pool.end());
+	}
 }
 
 
 
 } // namespace gxeng
-} // namespace inl
\ No newline at end of file
+} // namespace inl
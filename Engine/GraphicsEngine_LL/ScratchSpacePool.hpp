@@ -1,18 +1,28 @@
 #pragma once
 
-#include "../BaseLibrary/Memory/SlabAllocatorEngine.hpp"
 #include "../GraphicsApi_LL/IGraphicsApi.hpp"
+#include "../GraphicsApi_LL/IDescriptorHeap.hpp"
 #include "StackDescHeap.hpp"
+#include <atomic>
+#include <memory>
 #include <vector>
-#include <map>
 #include <mutex>
+#include <thread>
 
 
 namespace inl {
 namespace gxeng {
 
 
+class BindlessHeap;
 
+
+/// <summary>
+/// Recycles the shader visible scratch spaces of command lists and the CPU-only pages of <see cref="VolatileViewHeap"/>s.
+/// <para/>
+/// Each thread takes from its own cache, the shared pool is only locked to refill it.
+/// Items are given back once the GPU has finished with them, so they can be reused right away.
+/// </summary>
 class ScratchSpacePool {
 public:
 	struct Deleter {
@@ -27,23 +37,61 @@ public:
 	};
 
 	using UniquePtr = std::unique_ptr<StackDescHeap, Deleter>;
+
+	static constexpr uint32_t DEFAULT_SCRATCH_SPACE_SIZE = 1000;
+	static constexpr uint32_t VIEW_PAGE_SIZE = 128;
 public:
 	ScratchSpacePool(gxapi::IGraphicsApi* gxApi, gxapi::eDescriptorHeapType type);
 	ScratchSpacePool(const ScratchSpacePool&) = delete;
-	ScratchSpacePool(ScratchSpacePool&&) = default;
 	ScratchSpacePool& operator=(const ScratchSpacePool&) = delete;
-	ScratchSpacePool& operator=(ScratchSpacePool&& rhs) = default;;
 
-	UniquePtr RequestScratchSpace();
+	/// <summary> Returns a scratch space with room for at least <paramref name="minSize"/> descriptors. </summary>
+	/// <param name="minSize"> Zero requests the preferred size, see <see cref="GetPreferredSize"/>. </param>
+	UniquePtr RequestScratchSpace(uint32_t minSize = 0);
 	void RecycleScratchSpace(StackDescHeap* scratchSpace);
+
+	/// <summary> Returns a CPU-only CBV_SRV_UAV heap of <see cref="VIEW_PAGE_SIZE"/> descriptors. </summary>
+	std::unique_ptr<gxapi::IDescriptorHeap> RequestViewPage();
+	void RecycleViewPages(std::vector<std::unique_ptr<gxapi::IDescriptorHeap>> pages);
+
+	/// <summary> Starts collecting the usage of a new frame. </summary>
+	void BeginFrame();
+	/// <summary> Records the number of descriptors a list used, the next frame sizes scratch spaces after the largest one. </summary>
+	void ReportUsage(size_t numDescriptors);
+	/// <summary> The size that fit every list of the previous frame. </summary>
+	uint32_t GetPreferredSize() const;
+
+	/// <summary> Scratch spaces created from now on mirror the bindless heap. Set it before requesting any. </summary>
+	void SetBindlessHeap(const BindlessHeap* bindlessHeap);
+	/// <summary> Null if shaders can't index textures. </summary>
+	const BindlessHeap* GetBindlessHeap() const { return m_bindlessHeap; }
 private:
-	std::vector<std::unique_ptr<StackDescHeap>> m_pool;
+	struct ThreadCache {
+		std::thread::id owner;
+		std::vector<StackDescHeap*> scratchSpaces;
+		std::vector<std::unique_ptr<gxapi::IDescriptorHeap>> viewPages;
+	};
+	/// <summary> At most this many items move from the shared pool to a thread cache at once, so that one thread does not take all. </summary>
+	static constexpr size_t REFILL_COUNT = 8;
+
+	ThreadCache& GetThreadCache();
+	static StackDescHeap* TakeFitting(std::vector<StackDescHeap*>& scratchSpaces, uint32_t size);
+	/// <summary> Moves returned scratch spaces to the cache, the ones too small for current lists are destroyed. Lock must be held. </summary>
+	void RefillScratchSpaces(ThreadCache& cache);
+private:
+	const uint64_t m_id; // Tells apart the thread caches of different pools.
 	gxapi::eDescriptorHeapType m_type;
-	SlabAllocatorEngine m_allocator;
 	gxapi::IGraphicsApi* m_gxApi;
-	std::map<StackDescHeap*, size_t> m_addressToIndex;
+	const BindlessHeap* m_bindlessHeap = nullptr;
 
+	std::vector<std::unique_ptr<StackDescHeap>> m_pool;
+	std::vector<StackDescHeap*> m_returnedScratchSpaces;
+	std::vector<std::unique_ptr<gxapi::IDescriptorHeap>> m_returnedViewPages;
+	std::vector<std::unique_ptr<ThreadCache>> m_threadCaches;
 	std::mutex m_mutex;
+
+	std::atomic_size_t m_currentFrameUsage = 0;
+	std::atomic_size_t m_previousFrameUsage = 0;
 };
 
 
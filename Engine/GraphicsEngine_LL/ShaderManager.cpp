@@ -1,14 +1,134 @@
 #include "ShaderManager.hpp"
 
+#include <BaseLibrary/Serialization/BinaryStream.hpp>
+
 #include <thread>
 #include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <unordered_set>
 
 
 namespace inl {
 namespace gxeng {
 
 
+namespace {
+
+// Bump when the layout of the cache key changes.
+constexpr uint32_t ShaderCacheVersion = 2;
+
+// Bump when the layout of the warm-up list changes.
+constexpr uint64_t WarmupListVersion = 1;
+
+constexpr const char* GeneratedShaderPrefix = "generated_";
+
+// 64 bit FNV-1a, stable across runs and platforms.
+class Fnv1aHasher {
+public:
+	void Add(const void* data, size_t size) {
+		auto bytes = reinterpret_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			m_hash ^= bytes[i];
+			m_hash *= 1099511628211ull;
+		}
+	}
+	void Add(const std::string& str) {
+		Add(uint64_t(str.size()));
+		Add(str.data(), str.size());
+	}
+	void Add(uint64_t value) {
+		Add(&value, sizeof(value));
+	}
+	uint64_t Get() const { return m_hash; }
+
+private:
+	uint64_t m_hash = 14695981039346656037ull;
+};
+
+
+uint64_t HashString(const std::string& str) {
+	Fnv1aHasher hasher;
+	hasher.Add(str);
+	return hasher.Get() | 1; // Zero is reserved for missing sources.
+}
+
+
+// Names in #include "name" and #include <name> directives. Conditional includes are listed too,
+// which only makes the cache key more conservative.
+std::vector<std::string> FindIncludeNames(const std::string& sourceCode) {
+	std::vector<std::string> names;
+	size_t pos = 0;
+	while ((pos = sourceCode.find("#", pos)) != sourceCode.npos) {
+		++pos;
+		while (pos < sourceCode.size() && (sourceCode[pos] == ' ' || sourceCode[pos] == '\t')) {
+			++pos;
+		}
+		if (sourceCode.compare(pos, 7, "include") != 0) {
+			continue;
+		}
+		pos += 7;
+		while (pos < sourceCode.size() && (sourceCode[pos] == ' ' || sourceCode[pos] == '\t')) {
+			++pos;
+		}
+		if (pos >= sourceCode.size() || (sourceCode[pos] != '"' && sourceCode[pos] != '<')) {
+			continue;
+		}
+		char closing = sourceCode[pos] == '"' ? '"' : '>';
+		size_t end = sourceCode.find_first_of(std::string{ closing, '\n' }, pos + 1);
+		if (end != sourceCode.npos && sourceCode[end] == closing) {
+			names.push_back(sourceCode.substr(pos + 1, end - pos - 1));
+			pos = end;
+		}
+	}
+	return names;
+}
+
+
+// The model asked for by a #pragma shader_model 6_6 (or 6.6) line of the source, 5.1 without one.
+gxapi::eShaderModel FindShaderModel(const std::string& sourceCode) {
+	static constexpr const char* Directive = "shader_model";
+	size_t pos = 0;
+	while ((pos = sourceCode.find("#pragma", pos)) != sourceCode.npos) {
+		pos += 7;
+		while (pos < sourceCode.size() && (sourceCode[pos] == ' ' || sourceCode[pos] == '\t')) {
+			++pos;
+		}
+		if (sourceCode.compare(pos, std::strlen(Directive), Directive) != 0) {
+			continue;
+		}
+		pos += std::strlen(Directive);
+		while (pos < sourceCode.size() && (sourceCode[pos] == ' ' || sourceCode[pos] == '\t')) {
+			++pos;
+		}
+		size_t end = sourceCode.find_first_of(" \t\r\n", pos);
+		std::string model = sourceCode.substr(pos, end == sourceCode.npos ? end : end - pos);
+		std::replace(model.begin(), model.end(), '.', '_');
+
+		static const std::pair<const char*, gxapi::eShaderModel> models[] = {
+			{ "5_1", gxapi::eShaderModel::SM_5_1 },
+			{ "6_0", gxapi::eShaderModel::SM_6_0 },
+			{ "6_1", gxapi::eShaderModel::SM_6_1 },
+			{ "6_2", gxapi::eShaderModel::SM_6_2 },
+			{ "6_3", gxapi::eShaderModel::SM_6_3 },
+			{ "6_4", gxapi::eShaderModel::SM_6_4 },
+			{ "6_5", gxapi::eShaderModel::SM_6_5 },
+			{ "6_6", gxapi::eShaderModel::SM_6_6 },
+		};
+		for (const auto& [name, value] : models) {
+			if (model == name) {
+				return value;
+			}
+		}
+		throw gxapi::ShaderCompilationError("Unknown shader model.", model);
+	}
+	return gxapi::eShaderModel::SM_5_1;
+}
+
+} // namespace
+
+
 ShaderManager::ShaderManager(gxapi::IGxapiManager* gxapiManager)
 	: m_gxapiManager(gxapiManager)
 {
@@ -20,7 +140,7 @@ ShaderManager::ShaderManager(gxapi::IGxapiManager* gxapiManager)
 }
 
 ShaderManager::~ShaderManager() {
-	// empty
+	WaitPrecompile();
 }
 
 
@@ -87,7 +207,7 @@ const ShaderProgram& ShaderManager::CreateShader(const std::string& name, Shader
 	// shader does not exist
 	else {
 		// insert new entry for shader
-		auto ins = m_shaders.insert({ name, std::make_unique<ShaderStore>() });
+		auto ins = m_shaders.insert({ shaderId, std::make_unique<ShaderStore>() });
 		it = ins.first;
 	}
 	ShaderStore* shader = it->second.get();
@@ -103,24 +223,21 @@ const ShaderProgram& ShaderManager::CreateShader(const std::string& name, Shader
 	std::unique_lock<std::mutex> shaderLock(m_compileMutexes[nameHash % m_numCompileMutexes]);
 
 	// find requested shader code
-	std::string shaderSource;
-	std::string shaderPath;
-	{
-		auto pathSourcePair = FindShaderCode(name.c_str());
-		shaderPath = pathSourcePair.first;
-		shaderSource = pathSourcePair.second;
-	}
+	ShaderSource source = FindShaderSource(name);
+	std::vector<SourceDependency> dependencies;
+	dependencies.push_back(MakeDependency(name, source));
 
 	// determine what parts to compile, and compile them
 	ShaderParts partsToCompile = requestedParts.SetSubtract(shader->parts);
 	ShaderProgram program;
 	try {
-		program = CompileShaderInternal(shaderSource.c_str(), partsToCompile, macros.c_str());
+		program = CompileShaderInternal(source.code, partsToCompile, macros, &dependencies);
 	}
 	catch (gxapi::ShaderCompilationError& ex) {
-		throw gxapi::ShaderCompilationError("Error while compiling shader \"" + shaderPath + "\"", ex.Subject());
+		throw gxapi::ShaderCompilationError("Error while compiling shader \"" + source.name + "\"", ex.Subject());
 	}
 
+	shader->dependencies = std::move(dependencies);
 	shader->parts = shader->parts.SetUnion(partsToCompile);
 	if (partsToCompile.vs) { shader->program.vs = std::move(program.vs); }
 	if (partsToCompile.hs) { shader->program.hs = std::move(program.hs); }
@@ -141,8 +258,160 @@ gxapi::eShaderCompileFlags ShaderManager::GetShaderCompileFlags() const {
 	return m_compileFlags;
 }
 
-void ShaderManager::ReloadShaders() {
-	return;
+void ShaderManager::SetShaderModel(gxapi::eShaderModel shaderModel) {
+	m_shaderModel = shaderModel;
+}
+
+gxapi::eShaderModel ShaderManager::GetShaderModel() const {
+	return m_shaderModel;
+}
+
+void ShaderManager::SetDebugInfoDirectory(std::filesystem::path directory) {
+	m_debugInfoDirectory = std::move(directory);
+	if (!m_debugInfoDirectory.empty()) {
+		std::error_code ec;
+		std::filesystem::create_directories(m_debugInfoDirectory, ec);
+	}
+}
+
+void ShaderManager::SetCacheDirectory(std::filesystem::path directory) {
+	m_cacheDirectory = std::move(directory);
+	if (!m_cacheDirectory.empty()) {
+		std::error_code ec;
+		std::filesystem::create_directories(m_cacheDirectory, ec);
+	}
+}
+
+
+std::vector<ShaderRequest> ShaderManager::GetShaderRequests() const {
+	std::lock_guard<std::mutex> shaderMapLock(m_shaderMutex);
+
+	std::vector<ShaderRequest> requests;
+	requests.reserve(m_shaders.size());
+	std::shared_lock<std::shared_mutex> sourceLock(m_sourceMutex);
+	for (const auto& [id, store] : m_shaders) {
+		requests.push_back({ id.name, ShaderParts{}.SetUnion(store->parts), id.macros });
+		if (IsGeneratedShaderName(id.name)) {
+			auto codeIt = m_codes.find(id.name);
+			requests.back().sourceCode = codeIt != m_codes.end() ? codeIt->second : std::string{};
+		}
+	}
+	return requests;
+}
+
+
+void ShaderManager::SaveShaderRequests(const std::filesystem::path& file, const std::vector<ShaderRequest>& requests) {
+	std::ofstream fs(file, std::ios::binary | std::ios::trunc);
+	if (!fs.is_open()) {
+		throw RuntimeException("Failed to open file for writing.", file.generic_string());
+	}
+	BinaryStreamWriter writer(fs);
+	writer.WriteVarint(WarmupListVersion);
+	writer.WriteVarint(requests.size());
+	for (const auto& request : requests) {
+		const ShaderParts& p = request.parts;
+		writer.WriteVarint(p.vs | p.hs << 1 | p.ds << 2 | p.gs << 3 | p.ps << 4 | p.cs << 5);
+		writer.WriteString(request.name);
+		writer.WriteString(request.macros);
+		writer.WriteString(request.sourceCode);
+	}
+}
+
+
+std::vector<ShaderRequest> ShaderManager::LoadShaderRequests(const std::filesystem::path& file) {
+	std::vector<ShaderRequest> requests;
+	std::ifstream fs(file, std::ios::binary);
+	if (!fs.is_open()) {
+		return requests;
+	}
+	try {
+		BinaryStreamReader reader(fs);
+		if (reader.ReadVarint() != WarmupListVersion) {
+			return requests;
+		}
+		uint64_t count = reader.ReadVarint();
+		for (uint64_t i = 0; i < count; ++i) {
+			ShaderRequest request;
+			uint64_t parts = reader.ReadVarint();
+			request.parts.vs = (parts & 1) != 0;
+			request.parts.hs = (parts & 2) != 0;
+			request.parts.ds = (parts & 4) != 0;
+			request.parts.gs = (parts & 8) != 0;
+			request.parts.ps = (parts & 16) != 0;
+			request.parts.cs = (parts & 32) != 0;
+			request.name = reader.ReadString();
+			request.macros = reader.ReadString();
+			request.sourceCode = reader.ReadString();
+			requests.push_back(std::move(request));
+		}
+	}
+	catch (std::exception&) {
+		// Damaged list, the rest of the shaders are just not warmed up.
+	}
+	return requests;
+}
+
+
+void ShaderManager::Precompile(jobs::Scheduler& scheduler, const std::vector<ShaderRequest>& requests) {
+	std::lock_guard<std::mutex> lkg(m_precompileMutex);
+	for (const auto& request : requests) {
+		m_precompileJobs.push_back(scheduler.Enqueue([this](ShaderRequest request) {
+			try {
+				if (!request.sourceCode.empty()) {
+					CompileShader(request.sourceCode, request.parts, request.macros);
+				}
+				else if (!IsGeneratedShaderName(request.name)) {
+					CreateShader(request.name, request.parts, request.macros);
+				}
+			}
+			catch (...) {
+				// Sources may have changed since the list was saved, the nodes will report real errors.
+			}
+		}, request));
+	}
+}
+
+
+void ShaderManager::WaitPrecompile() {
+	std::vector<jobs::Future<void>> jobs;
+	{
+		std::lock_guard<std::mutex> lkg(m_precompileMutex);
+		jobs = std::move(m_precompileJobs);
+		m_precompileJobs.clear();
+	}
+	for (auto& job : jobs) {
+		job.get();
+	}
+}
+
+
+bool ShaderManager::IsPrecompileDone() const {
+	std::lock_guard<std::mutex> lkg(m_precompileMutex);
+	return std::all_of(m_precompileJobs.begin(), m_precompileJobs.end(), [](const auto& job) { return job.ready(); });
+}
+
+
+size_t ShaderManager::ReloadShaders() {
+	WaitPrecompile();
+
+	std::unique_lock<std::mutex> shaderMapLock(m_shaderMutex);
+	std::shared_lock<std::shared_mutex> sourceLock(m_sourceMutex);
+
+	size_t dropped = 0;
+	for (auto it = m_shaders.begin(); it != m_shaders.end();) {
+		const auto& dependencies = it->second->dependencies;
+		bool changed = std::any_of(dependencies.begin(), dependencies.end(), [this](const SourceDependency& dependency) {
+			return IsChanged(dependency);
+		});
+		if (changed) {
+			it = m_shaders.erase(it);
+			++dropped;
+		}
+		else {
+			++it;
+		}
+	}
+	return dropped;
 }
 
 
@@ -156,21 +425,38 @@ std::string ShaderManager::LoadShaderSource(const std::string& name) const {
 
 
 ShaderProgram ShaderManager::CompileShader(const std::string& sourceCode, ShaderParts parts, const std::string& macros) {
-	// lock source maps (read only lock)
-	std::shared_lock<std::shared_mutex> sourceLock(m_sourceMutex);
-
-	return CompileShaderInternal(sourceCode, parts, macros);
+	std::string name = GetGeneratedShaderName(sourceCode);
+	{
+		std::shared_lock<std::shared_mutex> sourceLock(m_sourceMutex);
+		auto codeIt = m_codes.find(name);
+		if (codeIt != m_codes.end() && codeIt->second != sourceCode) {
+			// Hash collision, the code is compiled without keeping it.
+			return CompileShaderInternal(sourceCode, parts, macros);
+		}
+		if (codeIt == m_codes.end()) {
+			sourceLock.unlock();
+			std::unique_lock<std::shared_mutex> lkg(m_sourceMutex);
+			m_codes.insert({ name, sourceCode });
+		}
+	}
+	return CreateShader(name, parts, macros);
 }
 
 
 std::pair<std::string, std::string> ShaderManager::FindShaderCode(const std::string& name) const {
+	ShaderSource source = FindShaderSource(name);
+	return { std::move(source.name), std::move(source.code) };
+}
+
+
+auto ShaderManager::FindShaderSource(const std::string& name) const -> ShaderSource {
 	std::string keyName = StripShaderName(name);
 	std::string fileName = StripShaderName(name, false);
 
 	// try it in direct source cache
 	auto codeIt = m_codes.find(keyName);
 	if (codeIt != m_codes.end()) {
-		return { keyName, codeIt->second };
+		return { keyName, codeIt->second, {} };
 	}
 
 	// try it in directories
@@ -184,14 +470,14 @@ std::pair<std::string, std::string> ShaderManager::FindShaderCode(const std::str
 			std::unique_ptr<char[]> content = std::make_unique<char[]>(s + 1);
 			fs.read(content.get(), s);
 			content[s] = '\0';
-			return { filepath.generic_string(), content.get() };
+			return { filepath.generic_string(), content.get(), filepath };
 		}
 	}
 
 	throw FileNotFoundException("Shader was not found.", keyName + "(" + name + " as requested)");
 }
 
-ShaderProgram ShaderManager::CompileShaderInternal(const std::string& sourceCode, ShaderParts parts, const std::string& macros) {
+ShaderProgram ShaderManager::CompileShaderInternal(const std::string& sourceCode, ShaderParts parts, const std::string& macros, std::vector<SourceDependency>* dependencies) {
 	class IncludeProvider : public gxapi::IShaderIncludeProvider {
 	public:
 		IncludeProvider(std::function<std::string(const char*)> findShader) : m_findShader(findShader) {}
@@ -234,17 +520,56 @@ ShaderProgram ShaderManager::CompileShaderInternal(const std::string& sourceCode
 		if (parts.cs) { compileIndices[idx] = 5; ++idx; }
 	}
 
+	const gxapi::eShaderModel shaderModel = std::max(m_shaderModel, FindShaderModel(sourceCode));
+
+	// The cache key covers everything that goes into the compiler but the stage.
+	std::vector<SourceDependency> includes;
+	Fnv1aHasher sourceHasher;
+	if (!m_cacheDirectory.empty() || !m_debugInfoDirectory.empty() || dependencies) {
+		CollectIncludes(sourceCode, includes);
+		auto flags = m_compileFlags;
+		sourceHasher.Add(uint64_t(ShaderCacheVersion));
+		sourceHasher.Add(uint64_t((gxapi::eShaderCompileFlags::UnderlyingT)(gxapi::eShaderCompileFlags::EnumT)flags));
+		sourceHasher.Add(uint64_t(shaderModel));
+		sourceHasher.Add(macros);
+		sourceHasher.Add(sourceCode);
+		for (const auto& include : includes) {
+			sourceHasher.Add(include.name);
+			sourceHasher.Add(include.contentHash);
+		}
+	}
+
 	int idx = 0;
 	while (compileIndices[idx] != -1) {
 		const int stageId = compileIndices[idx];
 		const char* mainName = mainNames[stageId];
 		gxapi::eShaderType type = types[stageId];
-		auto binary = m_gxapiManager->CompileShader(sourceCode.c_str(),
-			mainName,
-			type,
-			m_compileFlags,
-			&includeProvider,
-			macros.c_str());
+
+		Fnv1aHasher keyHasher = sourceHasher;
+		keyHasher.Add(uint64_t(stageId));
+		keyHasher.Add(std::string(mainName));
+		const uint64_t key = keyHasher.Get();
+
+		gxapi::ShaderProgramBinary binary;
+		if (!m_cacheDirectory.empty() && LoadCachedBinary(key, binary.data)) {
+			++m_cacheHitCount;
+		}
+		else {
+			++m_compileCount;
+			binary = m_gxapiManager->CompileShader(sourceCode.c_str(),
+				mainName,
+				type,
+				m_compileFlags,
+				&includeProvider,
+				macros.c_str(),
+				shaderModel);
+			if (!m_cacheDirectory.empty()) {
+				StoreCachedBinary(key, binary.data);
+			}
+			if (!m_debugInfoDirectory.empty() && !binary.debugInfo.empty()) {
+				StoreDebugInfo(key, binary);
+			}
+		}
 
 		ShaderStage* dest = nullptr;
 		switch (type) {
@@ -259,10 +584,197 @@ ShaderProgram ShaderManager::CompileShaderInternal(const std::string& sourceCode
 		++idx;
 	}
 
+	if (dependencies) {
+		dependencies->insert(dependencies->end(), includes.begin(), includes.end());
+	}
+
 	return ret;
 }
 
 
+void ShaderManager::CollectIncludes(const std::string& sourceCode, std::vector<SourceDependency>& dependencies) const {
+	std::unordered_set<std::string> visited;
+	std::vector<std::string> pending = FindIncludeNames(sourceCode);
+	std::reverse(pending.begin(), pending.end());
+
+	while (!pending.empty()) {
+		std::string name = std::move(pending.back());
+		pending.pop_back();
+		if (!visited.insert(StripShaderName(name)).second) {
+			continue;
+		}
+
+		ShaderSource source;
+		try {
+			source = FindShaderSource(name);
+		}
+		catch (FileNotFoundException&) {
+			// Left to the compiler to report, unless it is behind a disabled #if.
+			dependencies.push_back({ name, {}, {}, 0 });
+			continue;
+		}
+		dependencies.push_back(MakeDependency(name, source));
+
+		auto nested = FindIncludeNames(source.code);
+		pending.insert(pending.end(), nested.rbegin(), nested.rend());
+	}
+}
+
+
+auto ShaderManager::MakeDependency(const std::string& name, const ShaderSource& source) -> SourceDependency {
+	SourceDependency dependency{ name, source.file, {}, HashString(source.code) };
+	if (!source.file.empty()) {
+		std::error_code ec;
+		dependency.writeTime = std::filesystem::last_write_time(source.file, ec);
+	}
+	return dependency;
+}
+
+
+bool ShaderManager::IsChanged(const SourceDependency& dependency) const {
+	if (!dependency.file.empty()) {
+		std::error_code ec;
+		auto writeTime = std::filesystem::last_write_time(dependency.file, ec);
+		if (!ec && writeTime == dependency.writeTime) {
+			return false;
+		}
+	}
+	try {
+		ShaderSource source = FindShaderSource(dependency.name);
+		return HashString(source.code) != dependency.contentHash;
+	}
+	catch (FileNotFoundException&) {
+		return dependency.contentHash != 0;
+	}
+}
+
+
+bool ShaderManager::LoadCachedBinary(uint64_t key, std::vector<uint8_t>& binary) const {
+	char fileName[32];
+	snprintf(fileName, sizeof(fileName), "%016llx.cso", (unsigned long long)key);
+
+	std::string contents;
+	if (!LoadCacheFile(fileName, contents)) {
+		return false;
+	}
+	binary.assign(contents.begin(), contents.end());
+	return !binary.empty();
+}
+
+
+void ShaderManager::StoreCachedBinary(uint64_t key, const std::vector<uint8_t>& binary) const {
+	char fileName[32];
+	snprintf(fileName, sizeof(fileName), "%016llx.cso", (unsigned long long)key);
+	StoreCacheFile(fileName, binary.data(), binary.size());
+}
+
+
+bool ShaderManager::LoadCacheFile(const std::string& fileName, std::string& contents) const {
+	std::ifstream file(m_cacheDirectory / fileName, std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+	contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return true;
+}
+
+
+void ShaderManager::StoreCacheFile(const std::string& fileName, const void* data, size_t size) const {
+	std::string tempName = fileName + "." + std::to_string(m_cacheFileCounter++) + ".tmp";
+
+	// Written aside and renamed so that concurrent runs never read a partial file.
+	// The cache is best effort, failing to write it is not an error.
+	std::error_code ec;
+	{
+		std::ofstream file(m_cacheDirectory / tempName, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			return;
+		}
+		file.write(reinterpret_cast<const char*>(data), size);
+		if (!file) {
+			file.close();
+			std::filesystem::remove(m_cacheDirectory / tempName, ec);
+			return;
+		}
+	}
+	std::filesystem::rename(m_cacheDirectory / tempName, m_cacheDirectory / fileName, ec);
+	if (ec) {
+		std::filesystem::remove(m_cacheDirectory / tempName, ec);
+	}
+}
+
+
+void ShaderManager::StoreDebugInfo(uint64_t key, const gxapi::ShaderProgramBinary& binary) const {
+	// The binary refers to the file by the name the compiler gave, a path in it is not ours to follow.
+	std::string fileName = std::filesystem::path(binary.debugName).filename().string();
+	if (fileName.empty()) {
+		char keyName[32];
+		snprintf(keyName, sizeof(keyName), "%016llx.pdb", (unsigned long long)key);
+		fileName = keyName;
+	}
+
+	// Only for debugging, failing to write it is not an error.
+	std::ofstream file(m_debugInfoDirectory / fileName, std::ios::binary | std::ios::trunc);
+	if (file.is_open()) {
+		file.write(reinterpret_cast<const char*>(binary.debugInfo.data()), binary.debugInfo.size());
+	}
+}
+
+
+uint64_t ShaderManager::GetGeneratedCodeKey(const std::string& inputs) {
+	Fnv1aHasher hasher;
+	hasher.Add(uint64_t(ShaderCacheVersion));
+	hasher.Add(inputs);
+	return hasher.Get();
+}
+
+
+std::optional<std::string> ShaderManager::FindGeneratedCode(const std::string& inputs) const {
+	const uint64_t key = GetGeneratedCodeKey(inputs);
+	{
+		std::lock_guard<std::mutex> lkg(m_generatedMutex);
+		auto it = m_generatedCodes.find(key);
+		if (it != m_generatedCodes.end()) {
+			return it->second;
+		}
+	}
+
+	char fileName[32];
+	snprintf(fileName, sizeof(fileName), "%016llx.gen", (unsigned long long)key);
+	std::string code;
+	if (m_cacheDirectory.empty() || !LoadCacheFile(fileName, code)) {
+		return {};
+	}
+	std::lock_guard<std::mutex> lkg(m_generatedMutex);
+	m_generatedCodes.insert({ key, code });
+	return code;
+}
+
+
+void ShaderManager::StoreGeneratedCode(const std::string& inputs, std::string code) const {
+	const uint64_t key = GetGeneratedCodeKey(inputs);
+	if (!m_cacheDirectory.empty()) {
+		char fileName[32];
+		snprintf(fileName, sizeof(fileName), "%016llx.gen", (unsigned long long)key);
+		StoreCacheFile(fileName, code.data(), code.size());
+	}
+	std::lock_guard<std::mutex> lkg(m_generatedMutex);
+	m_generatedCodes[key] = std::move(code);
+}
+
+
+std::string ShaderManager::GetGeneratedShaderName(const std::string& sourceCode) {
+	char hash[24];
+	snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)HashString(sourceCode));
+	return GeneratedShaderPrefix + std::string(hash);
+}
+
+
+bool ShaderManager::IsGeneratedShaderName(const std::string& name) {
+	return name.compare(0, std::strlen(GeneratedShaderPrefix), GeneratedShaderPrefix) == 0;
+}
+
+
 std::string ShaderManager::StripShaderName(std::string name, bool lowerCase) {
 	// remove extension from the end, if any
 	size_t extDot = name.find_last_of('.');
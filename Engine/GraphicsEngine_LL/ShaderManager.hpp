@@ -1,14 +1,18 @@
 #pragma once
 
+#include <atomic>
 #include <filesystem>
 #include <unordered_map>
 #include <unordered_set>
 #include <mutex>
+#include <optional>
 #include <shared_mutex>
 
 #include <GraphicsApi_LL/IGxapiManager.hpp>
 #include <GraphicsApi_LL/Common.hpp>
 
+#include <BaseLibrary/JobSystem/Scheduler.hpp>
+
 
 namespace inl {
 namespace gxeng {
@@ -88,6 +92,15 @@ struct ShaderParts {
 #pragma warning(default: 4522)
 #endif
 
+/// <summary> Identifies a shader and the stages requested from it. </summary>
+struct ShaderRequest {
+	std::string name;
+	ShaderParts parts;
+	std::string macros;
+	std::string sourceCode; // Only for shaders compiled from generated code, which cannot be found by name.
+};
+
+
 /// <summary> Contains all binaries associated with a shader program.
 /// It should be added to a PSO and used in the pipeline. </summary>
 class ShaderProgram {
@@ -118,9 +131,21 @@ private:
 		std::string macros;
 		bool operator==(const ShaderId& rhs) const { return name == rhs.name && macros == rhs.macros; }
 	};
+	struct SourceDependency {
+		std::string name; // As requested by the shader or the include directive.
+		std::filesystem::path file; // Empty for runtime-added and missing sources.
+		std::filesystem::file_time_type writeTime;
+		uint64_t contentHash; // Zero for missing sources.
+	};
+	struct ShaderSource {
+		std::string name; // Canonical name, the file path for files.
+		std::string code;
+		std::filesystem::path file;
+	};
 	struct ShaderStore {
 		ShaderProgram program;
 		volatile ShaderParts parts;
+		std::vector<SourceDependency> dependencies; // The shader's source and all its includes.
 	};
 	struct PathHash {
 		size_t operator()(const std::filesystem::path& obj) const {
@@ -184,6 +209,19 @@ public:
 	/// <remarks> This method is NOT thread-safe (you might read garbage, but won't crash or anything). </remarks>
 	gxapi::eShaderCompileFlags GetShaderCompileFlags() const;
 
+	/// <summary> Set the lowest shader model to compile shaders for. Shaders may ask for a higher one
+	///		with a <c>#pragma shader_model 6_6</c> line, from 6.0 they are compiled to DXIL. </summary>
+	/// <remarks> Like the flags, this does not recompile shaders already created. This method is NOT thread-safe. </remarks>
+	void SetShaderModel(gxapi::eShaderModel shaderModel);
+	gxapi::eShaderModel GetShaderModel() const;
+
+	/// <summary> Sets the directory where the debug info (PDB) of the shaders compiled with
+	///		<see cref="gxapi::eShaderCompileFlags::DEBUG"/> is written, if the compiler gives it separately. Empty discards it. </summary>
+	/// <remarks> Graphics debuggers find the files by the name the binary refers to.
+	///		This method is NOT thread-safe. </remarks>
+	void SetDebugInfoDirectory(std::filesystem::path directory);
+	const std::filesystem::path& GetDebugInfoDirectory() const { return m_debugInfoDirectory; }
+
 
 	/// <summary> Compile a shader from source. </summary>
 	/// <param name="name"> Name of the shader (tipically file name), without extension. </param>
@@ -192,14 +230,64 @@ public:
 	const ShaderProgram& CreateShader(const std::string& name, ShaderParts parts, const std::string& macros = {});
 
 
-	/// <summary> It does not do anything, but I guess it will be good for something in the future. </summary>
-	void ReloadShaders();
+	/// <summary> Sets the directory where compiled binaries are kept between runs. Empty disables the disk cache. </summary>
+	/// <remarks> Binaries are keyed by a hash of the source, its includes, the macros,
+	///		the compile flags and the stage, so stale entries are never used, just left on disk.
+	///		This method is NOT thread-safe. </remarks>
+	void SetCacheDirectory(std::filesystem::path directory);
+	const std::filesystem::path& GetCacheDirectory() const { return m_cacheDirectory; }
+
+	/// <summary> Drops the compiled shaders whose source or includes changed since they were compiled.
+	///		They are compiled again, or loaded from the disk cache, when next requested. </summary>
+	/// <remarks> Files are checked by timestamp, runtime-added sources by content.
+	///		Waits for precompilation, must not run concurrently with shader creation otherwise. </remarks>
+	/// <returns> The number of shaders dropped. </returns>
+	size_t ReloadShaders();
+
+	/// <summary> Lists the shaders created so far, with all the stages requested from them. </summary>
+	/// <remarks> Shaders compiled by <see cref="CompileShader"/> are listed with their code. </remarks>
+	std::vector<ShaderRequest> GetShaderRequests() const;
+
+	/// <summary> Saves the requests as a warm-up list for the next run. </summary>
+	/// <remarks> The list of a play-testing session covers each permutation of generated shaders that was used,
+	///		precompiling it before the game starts avoids compiling them when they first appear. </remarks>
+	static void SaveShaderRequests(const std::filesystem::path& file, const std::vector<ShaderRequest>& requests);
+	/// <summary> Reads a list written by <see cref="SaveShaderRequests"/>. A missing file gives an empty list,
+	///		a damaged one the requests before the damage. </summary>
+	static std::vector<ShaderRequest> LoadShaderRequests(const std::filesystem::path& file);
+
+	/// <summary> Starts compiling the shaders on the job system, and returns without waiting. </summary>
+	/// <remarks> A <see cref="CreateShader"/> call for a shader being precompiled waits for it,
+	///		so nodes block only on the shaders they actually need. Compilation errors are left
+	///		for <see cref="CreateShader"/> to report. </remarks>
+	void Precompile(jobs::Scheduler& scheduler, const std::vector<ShaderRequest>& requests);
+
+	/// <summary> Waits for all jobs started by <see cref="Precompile"/>. Call before the job scheduler is destroyed. </summary>
+	void WaitPrecompile();
+
+	/// <summary> True if all jobs started by <see cref="Precompile"/> have finished. </summary>
+	bool IsPrecompileDone() const;
+
+	/// <summary> Number of shader stages passed to the compiler so far. </summary>
+	size_t GetCompileCount() const { return m_compileCount; }
+	/// <summary> Number of shader stages loaded from the disk cache instead of compiling them. </summary>
+	size_t GetCacheHitCount() const { return m_cacheHitCount; }
+
+	/// <summary> Finds the code generated earlier from the same inputs, in this run or, if the disk cache is enabled, in an earlier one. </summary>
+	/// <param name="inputs"> Everything the generated code depends on, such as the structure and sources of a material graph. </param>
+	/// <remarks> This method is thread-safe. </remarks>
+	std::optional<std::string> FindGeneratedCode(const std::string& inputs) const;
+	/// <summary> Keeps generated code for <see cref="FindGeneratedCode"/>, and writes it to the disk cache if it is enabled. </summary>
+	/// <remarks> This method is thread-safe. </remarks>
+	void StoreGeneratedCode(const std::string& inputs, std::string code) const;
 
 	/// <summary> Return the source code of a certain shader. </summary>
 	std::string LoadShaderSource(const std::string& name) const;
 
-	/// <summary> Compile arbitrary source code without adding it to the library. </summary>
-	/// <remarks> Include directives will still work if registered files are referenced. </remarks>
+	/// <summary> Compile arbitrary source code, such as generated shaders. </summary>
+	/// <remarks> Include directives will still work if registered files are referenced.
+	///		The code is kept as a runtime-added source named after its hash, so the binaries of the same code
+	///		are compiled once, and the shader is listed by <see cref="GetShaderRequests"/> for warm-up. </remarks>
 	ShaderProgram CompileShader(const std::string& sourceCode, ShaderParts parts, const std::string& macros = {});
 private:
 	/// <summary> Find a source in dirs, resource and codes by its name. Does not lock anything. </summary>
@@ -208,12 +296,29 @@ private:
 	///		and code is the actual HLSL(/other) shader code. 
 	/// </returns>
 	std::pair<std::string, std::string> FindShaderCode(const std::string& name) const;
+	ShaderSource FindShaderSource(const std::string& name) const;
 
 	/// <summary> Compiles a shader to binary according to parameters. </summary>
-	ShaderProgram CompileShaderInternal(const std::string& sourceCode, ShaderParts parts, const std::string& macros);
+	/// <param name="dependencies"> The includes of the source are appended to it. </param>
+	ShaderProgram CompileShaderInternal(const std::string& sourceCode, ShaderParts parts, const std::string& macros, std::vector<SourceDependency>* dependencies = nullptr);
+
+	/// <summary> Finds all files included by the source, recursively. Does not lock anything. </summary>
+	void CollectIncludes(const std::string& sourceCode, std::vector<SourceDependency>& dependencies) const;
+	static SourceDependency MakeDependency(const std::string& name, const ShaderSource& source);
+	bool IsChanged(const SourceDependency& dependency) const;
+
+	bool LoadCachedBinary(uint64_t key, std::vector<uint8_t>& binary) const;
+	void StoreCachedBinary(uint64_t key, const std::vector<uint8_t>& binary) const;
+	bool LoadCacheFile(const std::string& fileName, std::string& contents) const;
+	void StoreCacheFile(const std::string& fileName, const void* data, size_t size) const;
+	void StoreDebugInfo(uint64_t key, const gxapi::ShaderProgramBinary& binary) const;
+	static uint64_t GetGeneratedCodeKey(const std::string& inputs);
 
 	// Cuts off extension (only .hlsl, .glsl, .cg, .txt), converts to lowercase.
 	static std::string StripShaderName(std::string name, bool lowerCase = true);
+	// Name of the runtime-added source that holds generated code, already stripped.
+	static std::string GetGeneratedShaderName(const std::string& sourceCode);
+	static bool IsGeneratedShaderName(const std::string& name);
 private:
 	gxapi::IGxapiManager* m_gxapiManager;
 
@@ -223,11 +328,24 @@ private:
 	ShaderContainer m_shaders; /// <summary> List of compiled shaders. </summary>
 
 	mutable std::shared_mutex m_sourceMutex; /// <summary> Lock when accessing directory or code maps. </summary>
-	std::mutex m_shaderMutex; /// <summary> Shared: when reading m_shaders; Exclusive: when writing m_shaders. </summary>
+	mutable std::mutex m_shaderMutex; /// <summary> Shared: when reading m_shaders; Exclusive: when writing m_shaders. </summary>
 	std::unique_ptr<std::mutex[]> m_compileMutexes; /// <summary> Hash-modulo select one, lock when accessing hashed shader binary. </summary>
 	size_t m_numCompileMutexes;
 
 	gxapi::eShaderCompileFlags m_compileFlags;
+	gxapi::eShaderModel m_shaderModel = gxapi::eShaderModel::SM_5_1;
+	std::filesystem::path m_debugInfoDirectory;
+
+	std::filesystem::path m_cacheDirectory;
+	std::atomic_size_t m_compileCount{ 0 };
+	std::atomic_size_t m_cacheHitCount{ 0 };
+	mutable std::atomic_size_t m_cacheFileCounter{ 0 }; /// <summary> Makes temporary file names unique. </summary>
+
+	mutable std::unordered_map<uint64_t, std::string> m_generatedCodes; /// <summary> Generated codes by the hash of their inputs. </summary>
+	mutable std::mutex m_generatedMutex;
+
+	std::vector<jobs::Future<void>> m_precompileJobs;
+	mutable std::mutex m_precompileMutex;
 };
 
 
@@ -0,0 +1,239 @@
+#include "ShadowAtlas.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+
+
+namespace inl::gxeng {
+
+
+// A light's coverage has to change by this factor past a mip boundary to move it to another mip,
+// otherwise lights near the boundary would render all faces again each time they cross it.
+static constexpr float MipHysteresis = 1.25f;
+
+
+ShadowAtlas::ShadowAtlas(unsigned numSlots, unsigned numMips) {
+	Resize(numSlots, numMips);
+}
+
+
+void ShadowAtlas::Resize(unsigned numSlots, unsigned numMips) {
+	m_slots.assign(numSlots, Slot{});
+	m_numMips = std::max(1u, numMips);
+	m_updates.clear();
+}
+
+
+void ShadowAtlas::Allocate(const std::vector<Request>& requests) {
+	// The most important lights, in order.
+	std::vector<size_t> order(requests.size());
+	std::iota(order.begin(), order.end(), size_t(0));
+	const size_t numAllocated = std::min(order.size(), m_slots.size());
+	std::partial_sort(order.begin(), order.begin() + numAllocated, order.end(), [&requests](size_t lhs, size_t rhs) {
+		return requests[lhs].importance > requests[rhs].importance;
+	});
+	order.resize(numAllocated);
+
+	// Lights keep their slots if still among the most important, the rest are freed.
+	std::vector<bool> hasSlot(numAllocated, false);
+	for (Slot& slot : m_slots) {
+		if (!slot.light) {
+			continue;
+		}
+		auto it = std::find_if(order.begin(), order.end(), [&](size_t index) { return requests[index].light == slot.light; });
+		if (it == order.end()) {
+			slot = Slot{};
+			continue;
+		}
+
+		const Request& request = requests[*it];
+		unsigned mip = SelectMip(request, &slot);
+		if (request.position != slot.position || request.range != slot.range || mip != slot.mip) {
+			slot.validFaces = 0;
+		}
+		slot.position = request.position;
+		slot.range = request.range;
+		slot.importance = request.importance;
+		slot.mip = mip;
+		slot.faceMask = request.faceMask;
+		hasSlot[it - order.begin()] = true;
+	}
+
+	auto freeSlot = m_slots.begin();
+	for (size_t i = 0; i < numAllocated; ++i) {
+		if (hasSlot[i]) {
+			continue;
+		}
+		freeSlot = std::find_if(freeSlot, m_slots.end(), [](const Slot& slot) { return slot.light == nullptr; });
+		assert(freeSlot != m_slots.end());
+
+		const Request& request = requests[order[i]];
+		freeSlot->light = request.light;
+		freeSlot->position = request.position;
+		freeSlot->range = request.range;
+		freeSlot->importance = request.importance;
+		freeSlot->mip = SelectMip(request, nullptr);
+		freeSlot->faceMask = request.faceMask;
+		freeSlot->validFaces = 0;
+	}
+}
+
+
+const std::vector<ShadowAtlas::FaceUpdate>& ShadowAtlas::ScheduleUpdates(const std::vector<uint64_t>& casterHashes) {
+	if (casterHashes.size() < m_slots.size() * NumFaces) {
+		throw InvalidArgumentException("A caster hash is needed for each face of each slot.");
+	}
+
+	struct Candidate {
+		unsigned slot;
+		unsigned face;
+		bool incomplete;
+		float importance;
+	};
+	std::vector<Candidate> candidates;
+
+	for (unsigned slotIdx = 0; slotIdx < m_slots.size(); ++slotIdx) {
+		Slot& slot = m_slots[slotIdx];
+		if (!slot.light) {
+			continue;
+		}
+		// Changed casters make cached faces stale, but the light still has something to show meanwhile.
+		const bool incomplete = !slot.IsComplete();
+		for (unsigned face = 0; face < NumFaces; ++face) {
+			const uint8_t bit = uint8_t(1u << face);
+			if (!(slot.faceMask & bit)) {
+				continue;
+			}
+			if ((slot.validFaces & bit) && casterHashes[slotIdx * NumFaces + face] != slot.casterHashes[face]) {
+				slot.validFaces &= ~bit;
+			}
+			if (!(slot.validFaces & bit)) {
+				candidates.push_back({ slotIdx, face, incomplete, slot.importance });
+			}
+		}
+	}
+
+	std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+		if (lhs.incomplete != rhs.incomplete) {
+			return lhs.incomplete;
+		}
+		return lhs.importance > rhs.importance;
+	});
+
+	m_updates.clear();
+	const size_t numUpdates = std::min(candidates.size(), size_t(m_updateBudget));
+	for (size_t i = 0; i < numUpdates; ++i) {
+		Slot& slot = m_slots[candidates[i].slot];
+		const unsigned face = candidates[i].face;
+		slot.validFaces |= uint8_t(1u << face);
+		slot.casterHashes[face] = casterHashes[candidates[i].slot * NumFaces + face];
+		m_updates.push_back({ candidates[i].slot, face, slot.mip, slot.position, slot.range });
+	}
+	return m_updates;
+}
+
+
+const ShadowAtlas::Slot* ShadowAtlas::Find(const void* light) const {
+	auto it = std::find_if(m_slots.begin(), m_slots.end(), [light](const Slot& slot) { return slot.light == light; });
+	return light && it != m_slots.end() ? &*it : nullptr;
+}
+
+
+unsigned ShadowAtlas::SelectMip(float screenCoverage, unsigned numMips) {
+	if (numMips <= 1 || screenCoverage >= 0.5f) {
+		return 0;
+	}
+	if (screenCoverage <= 0.0f) {
+		return numMips - 1;
+	}
+	float mip = std::ceil(std::log2(0.5f / screenCoverage));
+	return std::min(unsigned(mip), numMips - 1);
+}
+
+
+unsigned ShadowAtlas::SelectMip(const Request& request, const Slot* current) const {
+	if (current) {
+		unsigned finest = SelectMip(request.screenCoverage * MipHysteresis, m_numMips);
+		unsigned coarsest = SelectMip(request.screenCoverage / MipHysteresis, m_numMips);
+		if (finest <= current->mip && current->mip <= coarsest) {
+			return current->mip;
+		}
+	}
+	return SelectMip(request.screenCoverage, m_numMips);
+}
+
+
+uint8_t ShadowAtlas::GetSpotFaceMask(const Vec3& direction, float outerAngle) {
+	// The corners of a face are this far from its axis.
+	const float cornerAngle = std::atan(std::sqrt(2.0f));
+	const Vec3 dir = direction.Normalized();
+
+	uint8_t mask = 0;
+	for (unsigned face = 0; face < NumFaces; ++face) {
+		float angle = std::acos(std::clamp(Dot(dir, GetFaceAxis(face)), -1.0f, 1.0f));
+		if (angle <= outerAngle + cornerAngle) {
+			mask |= uint8_t(1u << face);
+		}
+	}
+	return mask;
+}
+
+
+Vec3 ShadowAtlas::GetFaceAxis(unsigned face) {
+	static const Vec3 axes[NumFaces] = {
+		{ 1, 0, 0 },
+		{ -1, 0, 0 },
+		{ 0, 1, 0 },
+		{ 0, -1, 0 },
+		{ 0, 0, 1 },
+		{ 0, 0, -1 },
+	};
+	assert(face < NumFaces);
+	return axes[face];
+}
+
+
+Mat44 ShadowAtlas::GetFaceViewProjection(const Vec3& position, float range, unsigned face) {
+	// Same orientation as the faces of a cube texture, each one looks along its axis.
+	static const Mat44 views[NumFaces] = {
+		Mat44(0, 0, 1, 0,
+			  0, 1, 0, 0,
+			  -1, 0, 0, 0,
+			  0, 0, 0, 1),
+		Mat44(0, 0, -1, 0,
+			  0, 1, 0, 0,
+			  -1, 0, 0, 0,
+			  0, 0, 0, 1),
+		Mat44(1, 0, 0, 0,
+			  0, 0, 1, 0,
+			  0, -1, 0, 0,
+			  0, 0, 0, 1),
+		Mat44(-1, 0, 0, 0,
+			  0, 0, -1, 0,
+			  0, -1, 0, 0,
+			  0, 0, 0, 1),
+		Mat44(1, 0, 0, 0,
+			  0, 1, 0, 0,
+			  0, 0, 1, 0,
+			  0, 0, 0, 1),
+		Mat44(-1, 0, 0, 0,
+			  0, 1, 0, 0,
+			  0, 0, -1, 0,
+			  0, 0, 0, 1),
+	};
+	assert(face < NumFaces);
+
+	Mat44 translation = Mat44::Identity();
+	translation(3, 0) = -position.x;
+	translation(3, 1) = -position.y;
+	translation(3, 2) = -position.z;
+	Mat44 projection = Mat44::Perspective(Constants<float>::PiHalf, 1.0f, NearPlane, std::max(range, 2.0f * NearPlane));
+	return translation * views[face] * projection;
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <InlineMath.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary> Assigns shadowed point and spot lights to the cube slots of a shadow texture,
+///		and picks which faces are rendered again each frame. </summary>
+/// <remarks> The texture is a cube array with a mip chain, one cube per slot. Lights covering less of the screen
+///		render into and sample from a smaller mip of their cube, so the resolution follows the coverage.
+///		Faces are cached: a face is only rendered again when its light moved, its resolution changed,
+///		or the casters it sees changed, as told by the hashes passed to <see cref="ScheduleUpdates"/>.
+///		At most <see cref="GetUpdateBudget"/> faces are rendered a frame; lights that have not been rendered
+///		completely since they got their slot go first, then the more important ones. </remarks>
+class ShadowAtlas {
+public:
+	static constexpr unsigned NumFaces = 6;
+	static constexpr uint8_t AllFaces = 0x3F;
+	/// <summary> Near plane of the faces' projection, the far plane is the light's range. </summary>
+	static constexpr float NearPlane = 0.1f;
+
+	struct Request {
+		const void* light = nullptr; // Identifies the light across frames, e.g. its address.
+		Vec3 position = { 0, 0, 0 };
+		float range = 1.0f;
+		float importance = 0.0f; // Higher gets a slot and updates first, e.g. screen coverage times brightness.
+		float screenCoverage = 1.0f; // Part of the screen's height the light's range covers, selects the mip.
+		uint8_t faceMask = AllFaces; // Faces the light can shade, spot lights need only some.
+	};
+
+	struct Slot {
+		const void* light = nullptr; // Null if the slot is free.
+		Vec3 position = { 0, 0, 0 };
+		float range = 0.0f;
+		float importance = 0.0f;
+		unsigned mip = 0;
+		uint8_t faceMask = 0;
+		uint8_t validFaces = 0; // Faces rendered for the current position, range, mip and casters.
+		std::array<uint64_t, NumFaces> casterHashes = {};
+
+		/// <summary> True if all faces the light needs have been rendered, sample the slot only then. </summary>
+		bool IsComplete() const { return light && (validFaces & faceMask) == faceMask; }
+	};
+
+	struct FaceUpdate {
+		unsigned slot;
+		unsigned face;
+		unsigned mip;
+		Vec3 position;
+		float range;
+	};
+
+public:
+	ShadowAtlas() = default;
+	ShadowAtlas(unsigned numSlots, unsigned numMips);
+
+	/// <summary> Sets the number of cubes and mips of the texture, forgets all lights. </summary>
+	void Resize(unsigned numSlots, unsigned numMips);
+	/// <summary> Maximum number of faces rendered in a frame. </summary>
+	void SetUpdateBudget(unsigned facesPerFrame) { m_updateBudget = facesPerFrame; }
+	unsigned GetUpdateBudget() const { return m_updateBudget; }
+
+	/// <summary> Gives slots to the most important lights, lights already having one keep it. </summary>
+	/// <remarks> Lights missing from the requests or pushed out by more important ones lose their slots. </remarks>
+	void Allocate(const std::vector<Request>& requests);
+
+	/// <summary> Compares the caster hashes of the faces to those they were rendered with,
+	///		and returns the faces to render this frame, which are then considered valid. </summary>
+	/// <param name="casterHashes"> <see cref="NumFaces"/> hashes per slot, unused for free slots. </param>
+	const std::vector<FaceUpdate>& ScheduleUpdates(const std::vector<uint64_t>& casterHashes);
+
+	const std::vector<Slot>& GetSlots() const { return m_slots; }
+	/// <summary> The slot of the light, null if it has none. </summary>
+	const Slot* Find(const void* light) const;
+	unsigned GetNumMips() const { return m_numMips; }
+
+	/// <summary> The finest mip for a light covering this much of the screen, halving the coverage moves one mip down. </summary>
+	static unsigned SelectMip(float screenCoverage, unsigned numMips);
+	/// <summary> Faces a spot light can reach, for <see cref="Request::faceMask"/>. </summary>
+	static uint8_t GetSpotFaceMask(const Vec3& direction, float outerAngle);
+	/// <summary> The direction the face looks at, faces are +X, -X, +Y, -Y, +Z, -Z. </summary>
+	static Vec3 GetFaceAxis(unsigned face);
+	/// <summary> Transforms world space to the clip space of a face of the light's cube. </summary>
+	static Mat44 GetFaceViewProjection(const Vec3& position, float range, unsigned face);
+
+private:
+	unsigned SelectMip(const Request& request, const Slot* current) const;
+
+private:
+	std::vector<Slot> m_slots;
+	unsigned m_numMips = 1;
+	unsigned m_updateBudget = 12;
+	std::vector<FaceUpdate> m_updates;
+};
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,113 @@
+#include "SignedDistanceField.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+namespace inl::gxeng {
+
+
+static constexpr float Infinity = 1e20f;
+
+
+// Squared distance transform along one line, f is the cost of the samples, d receives the result.
+// v, z are scratch space of n and n + 1 elements.
+static void DistanceTransform1D(const float* f, float* d, int* v, float* z, int n) {
+	int k = 0;
+	v[0] = 0;
+	z[0] = -Infinity;
+	z[1] = Infinity;
+	for (int q = 1; q < n; ++q) {
+		float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * (q - v[k]));
+		while (s <= z[k]) {
+			--k;
+			s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * (q - v[k]));
+		}
+		++k;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = Infinity;
+	}
+
+	k = 0;
+	for (int q = 0; q < n; ++q) {
+		while (z[k + 1] < q) {
+			++k;
+		}
+		float offset = float(q - v[k]);
+		d[q] = offset * offset + f[v[k]];
+	}
+}
+
+
+// Squared distance of each pixel to the closest pixel where the grid is 0, in place.
+static void DistanceTransform2D(std::vector<float>& grid, int width, int height) {
+	int n = std::max(width, height);
+	std::vector<float> f(n), d(n), z(n + 1);
+	std::vector<int> v(n);
+
+	for (int x = 0; x < width; ++x) {
+		for (int y = 0; y < height; ++y) {
+			f[y] = grid[y * width + x];
+		}
+		DistanceTransform1D(f.data(), d.data(), v.data(), z.data(), height);
+		for (int y = 0; y < height; ++y) {
+			grid[y * width + x] = d[y];
+		}
+	}
+	for (int y = 0; y < height; ++y) {
+		DistanceTransform1D(&grid[y * width], d.data(), v.data(), z.data(), width);
+		std::copy(d.begin(), d.begin() + width, grid.begin() + y * width);
+	}
+}
+
+
+DistanceField ComputeSignedDistanceField(const uint8_t* coverage, int width, int height, ptrdiff_t pitch, int downscale, float spread, int padding) {
+	assert(downscale >= 1);
+	assert(spread > 0.0f);
+
+	// The bitmap with the padding, so distances reach beyond its edges.
+	int border = padding * downscale;
+	int paddedWidth = width + 2 * border;
+	int paddedHeight = height + 2 * border;
+
+	DistanceField field;
+	field.width = (paddedWidth + downscale - 1) / downscale;
+	field.height = (paddedHeight + downscale - 1) / downscale;
+	paddedWidth = field.width * downscale;
+	paddedHeight = field.height * downscale;
+	field.pixels.resize(size_t(field.width) * field.height);
+
+	// Distances to the inside from outside, and to the outside from inside.
+	std::vector<float> toInside(size_t(paddedWidth) * paddedHeight, Infinity);
+	std::vector<float> toOutside(size_t(paddedWidth) * paddedHeight, 0.0f);
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			if (coverage[y * pitch + x] >= 128) {
+				size_t index = size_t(y + border) * paddedWidth + (x + border);
+				toInside[index] = 0.0f;
+				toOutside[index] = Infinity;
+			}
+		}
+	}
+	DistanceTransform2D(toInside, paddedWidth, paddedHeight);
+	DistanceTransform2D(toOutside, paddedWidth, paddedHeight);
+
+	// Each field pixel takes the distance at the bitmap pixel nearest to its center.
+	// Distances are measured between pixel centers, the edge is half a pixel closer.
+	float scale = 0.5f / (spread * downscale);
+	for (int y = 0; y < field.height; ++y) {
+		for (int x = 0; x < field.width; ++x) {
+			size_t index = size_t(y * downscale + downscale / 2) * paddedWidth + (x * downscale + downscale / 2);
+			float distance = toOutside[index] > 0.0f ? std::sqrt(toOutside[index]) - 0.5f : -(std::sqrt(toInside[index]) - 0.5f);
+			float value = std::clamp(0.5f + distance * scale, 0.0f, 1.0f);
+			field.pixels[size_t(y) * field.width + x] = uint8_t(value * 255.0f + 0.5f);
+		}
+	}
+
+	return field;
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary> A single channel signed distance field, row by row. </summary>
+/// <remarks> 128 is on the edge of the shape, larger values are inside. </remarks>
+struct DistanceField {
+	int width = 0;
+	int height = 0;
+	std::vector<uint8_t> pixels;
+};
+
+
+/// <summary> Converts a coverage bitmap to a distance field of a lower resolution. </summary>
+/// <remarks> Uses the exact euclidean distance transform of Felzenszwalb and Huttenlocher, in linear time. </remarks>
+/// <param name="coverage"> 8 bit coverage, pixels over half are inside. </param>
+/// <param name="pitch"> Bytes between the rows of <paramref name="coverage"/>. </param>
+/// <param name="downscale"> Bitmap pixels per field pixel, the bitmap is best rendered at this many times the needed size. </param>
+/// <param name="spread"> The distance in field pixels that is mapped to 0 outside and 255 inside. </param>
+/// <param name="padding"> Field pixels added around the bitmap on every side, at least the spread to keep the falloff. </param>
+DistanceField ComputeSignedDistanceField(const uint8_t* coverage, int width, int height, ptrdiff_t pitch, int downscale, float spread, int padding);
+
+
+} // namespace inl::gxeng
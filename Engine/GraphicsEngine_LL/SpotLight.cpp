@@ -0,0 +1,43 @@
+#include "SpotLight.hpp"
+
+#include <algorithm>
+
+namespace inl::gxeng {
+
+
+SpotLight::SpotLight(Vec3 position, Vec3 direction, Vec3 color, float range, float innerAngle, float outerAngle
+):
+	PointLight(position, color, range)
+{
+	SetDirection(direction);
+	SetAngles(innerAngle, outerAngle);
+}
+
+
+void SpotLight::SetDirection(const Vec3& dir) {
+	m_direction = dir.Normalized();
+}
+
+
+void SpotLight::SetAngles(float innerAngle, float outerAngle) {
+	m_outerAngle = std::clamp(outerAngle, 0.0f, Constants<float>::PiHalf);
+	m_innerAngle = std::clamp(innerAngle, 0.0f, m_outerAngle);
+}
+
+
+Vec3 SpotLight::GetDirection() const {
+	return m_direction;
+}
+
+
+float SpotLight::GetInnerAngle() const {
+	return m_innerAngle;
+}
+
+
+float SpotLight::GetOuterAngle() const {
+	return m_outerAngle;
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "PointLight.hpp"
+
+namespace inl::gxeng {
+
+/// <summary> Point light limited to a cone, the edge of the cone is blended between the inner and outer angles. </summary>
+class SpotLight : public PointLight {
+public:
+	SpotLight() = default;
+	SpotLight(Vec3 position, Vec3 direction, Vec3 color, float range, float innerAngle, float outerAngle);
+
+	void SetDirection(const Vec3& dir);
+	/// <summary> Half angles of the cone in radians, full intensity inside the inner one, none outside the outer one. </summary>
+	void SetAngles(float innerAngle, float outerAngle);
+
+	Vec3 GetDirection() const;
+	float GetInnerAngle() const;
+	float GetOuterAngle() const;
+
+protected:
+	Vec3 m_direction = { 0, 0, -1 };
+	float m_innerAngle = 0.5f;
+	float m_outerAngle = 0.6f;
+};
+
+} // namespace inl::gxeng
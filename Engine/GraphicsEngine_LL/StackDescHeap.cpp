@@ -1,6 +1,8 @@
 
 #include "StackDescHeap.hpp"
 
+#include "BindlessHeap.hpp"
+
 #include <BaseLibrary/Exception/Exception.hpp>
 
 #include <cassert>
@@ -47,12 +49,15 @@ DescriptorArrayRef::DescriptorArrayRef(StackDescHeap* home, uint32_t pos, uint32
 // =======================================================
 
 
-StackDescHeap::StackDescHeap(gxapi::IGraphicsApi* graphicsApi, gxapi::eDescriptorHeapType type, uint32_t size) :
-	m_size(size),
-	m_next(0)
+StackDescHeap::StackDescHeap(gxapi::IGraphicsApi* graphicsApi, gxapi::eDescriptorHeapType type, uint32_t size, const BindlessHeap* bindlessHeap) :
+	m_reserved(bindlessHeap ? bindlessHeap->GetCapacity() : 0),
+	m_bindlessHeap(bindlessHeap)
 {
 	assert(type == gxapi::eDescriptorHeapType::CBV_SRV_UAV || type == gxapi::eDescriptorHeapType::SAMPLER);
-	gxapi::DescriptorHeapDesc desc(type, size, true);
+	assert(bindlessHeap == nullptr || type == gxapi::eDescriptorHeapType::CBV_SRV_UAV);
+	m_size = size + m_reserved;
+	m_next = m_reserved;
+	gxapi::DescriptorHeapDesc desc(type, m_size, true);
 	m_heap.reset(graphicsApi->CreateDescriptorHeap(desc));
 }
 
@@ -68,8 +73,18 @@ DescriptorArrayRef StackDescHeap::Allocate(uint32_t size) {
 }
 
 
+gxapi::DescriptorHandle StackDescHeap::GetBindlessTable() {
+	if (!m_bindlessHeap) {
+		throw InvalidStateException("Scratch space has no bindless table.");
+	}
+	// The list owning the scratch space is still recording, so the GPU does not read the descriptors yet.
+	m_bindlessHeap->CopyTo(m_heap->At(0), m_bindlessVersion);
+	return m_heap->At(0);
+}
+
+
 void StackDescHeap::Reset() {
-	m_next = 0;
+	m_next = m_reserved;
 }
 
 
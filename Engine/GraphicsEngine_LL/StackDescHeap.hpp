@@ -10,6 +10,7 @@ namespace inl {
 namespace gxeng {
 
 class StackDescHeap;
+class BindlessHeap;
 
 class DescriptorArrayRef {
 public:
@@ -49,24 +50,38 @@ protected:
 /// <para />
 /// Each CPU thread that generates command lists should have
 /// exclusive ownership over at least one instance of this class.
+/// <para />
+/// With a bindless heap, the first descriptors mirror the bindless heap
+/// and allocations start after them.
 /// </summary>
 class StackDescHeap {
 	friend class DescriptorArrayRef;
 public:
-	StackDescHeap(gxapi::IGraphicsApi* graphicsApi, gxapi::eDescriptorHeapType type, uint32_t size);
+	StackDescHeap(gxapi::IGraphicsApi* graphicsApi, gxapi::eDescriptorHeapType type, uint32_t size, const BindlessHeap* bindlessHeap = nullptr);
 
 	DescriptorArrayRef Allocate(uint32_t size);
 
+	/// <summary> Brings the mirror of the bindless heap up to date, and returns the start of the bindless table. </summary>
+	/// <exception cref="inl::InvalidStateException"> If the heap was created without a bindless heap. </exception>
+	gxapi::DescriptorHandle GetBindlessTable();
+
 	/// <summary>
 	/// Frees all allocations. Next allocation will be placed at the begginning of the heap.
 	/// </summary>
 	void Reset();
 
 	gxapi::IDescriptorHeap* GetHeap() const { return m_heap.get(); }
+	/// <summary> The number of descriptors that can be allocated, not counting the bindless mirror. </summary>
+	uint32_t GetCapacity() const { return m_size - m_reserved; }
+	/// <summary> The number of descriptors allocated since the last reset. </summary>
+	uint32_t GetUsedCount() const { return m_next - m_reserved; }
 protected:
 	std::unique_ptr<gxapi::IDescriptorHeap> m_heap;
 	uint32_t m_size;
 	uint32_t m_next;
+	uint32_t m_reserved; // Descriptors at the start mirroring the bindless heap.
+	const BindlessHeap* m_bindlessHeap;
+	uint64_t m_bindlessVersion = 0;
 };
 
 
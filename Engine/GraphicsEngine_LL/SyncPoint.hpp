@@ -1,9 +1,16 @@
 #pragma once
 
 #include <GraphicsApi_LL/IFence.hpp>
+#include <BaseLibrary/JobSystem/SchedulablePromiseTag.hpp>
+#include <BaseLibrary/JobSystem/Scheduler.hpp>
+
+#include <experimental/coroutine>
+#include <atomic>
 #include <cstdint>
 #include <cassert>
+#include <functional>
 #include <memory>
+#include <type_traits>
 
 
 namespace inl {
@@ -19,6 +26,27 @@ class SyncPoint {
 	friend class inl::gxeng::CommandQueue;
 	friend class inl::gxeng::ResourceResidencyQueue;
 public:
+	/// <summary> Suspends the awaiting coroutine until the GPU passes the point. </summary>
+	/// <remarks> The coroutine is resumed on the scheduler of its promise, or on the
+	///		fence watcher thread if it has no scheduler. No thread blocks on the GPU meanwhile. </remarks>
+	class SyncPointAwaiter {
+		friend class SyncPoint;
+	public:
+		bool await_ready() const noexcept { return m_syncPoint.IsReady(); }
+		template <class T>
+		bool await_suspend(T awaitingCoroutine);
+		void await_resume() noexcept {}
+	private:
+		SyncPointAwaiter(const SyncPoint& syncPoint) noexcept : m_syncPoint(syncPoint) {}
+		bool await_suspend(std::experimental::coroutine_handle<> awaitingCoroutine, jobs::Scheduler* scheduler, jobs::JobOptions options);
+	private:
+		const SyncPoint& m_syncPoint;
+		std::experimental::coroutine_handle<> m_awaitingHandle;
+		jobs::Scheduler* m_scheduler = nullptr;
+		jobs::JobOptions m_options;
+		std::atomic_bool m_arrived = false; // Set by whichever comes second of the suspension and the GPU.
+	};
+
 	SyncPoint() : m_value(0) {}
 	SyncPoint(std::shared_ptr<gxapi::IFence> fence, uint64_t value)
 		: m_fence(fence), m_value(value)
@@ -29,6 +57,23 @@ public:
 		m_fence->Wait(m_value);		
 	}
 
+	/// <summary> True if the GPU has passed the point, does not block. </summary>
+	bool IsReady() const {
+		assert((bool)m_fence);
+		return m_fence->Fetch() >= m_value;
+	}
+
+	/// <summary> Calls the callback once the GPU has passed the point, does not block. </summary>
+	/// <remarks> See <see cref="gxapi::IFence::OnCompletion"/> for where the callback runs. </remarks>
+	void OnCompletion(std::function<void()> callback) const {
+		assert((bool)m_fence);
+		m_fence->OnCompletion(m_value, std::move(callback));
+	}
+
+	SyncPointAwaiter operator co_await() const {
+		return SyncPointAwaiter{ *this };
+	}
+
 	operator bool() {
 		return (bool)m_fence;
 	}
@@ -38,6 +83,40 @@ private:
 };
 
 
+template <class T>
+bool SyncPoint::SyncPointAwaiter::await_suspend(T awaitingCoroutine) {
+	jobs::Scheduler* scheduler = nullptr;
+	jobs::JobOptions options;
+	if constexpr (std::is_base_of_v<jobs::SchedulablePromiseTag, std::decay_t<decltype(awaitingCoroutine.promise())>>) {
+		scheduler = static_cast<const jobs::SchedulablePromiseTag&>(awaitingCoroutine.promise()).m_scheduler;
+		options = static_cast<const jobs::SchedulablePromiseTag&>(awaitingCoroutine.promise()).m_options;
+	}
+	return await_suspend(std::experimental::coroutine_handle<>(awaitingCoroutine), scheduler, options);
+}
+
+
+inline bool SyncPoint::SyncPointAwaiter::await_suspend(std::experimental::coroutine_handle<> awaitingCoroutine, jobs::Scheduler* scheduler, jobs::JobOptions options) {
+	m_awaitingHandle = awaitingCoroutine;
+	m_scheduler = scheduler;
+	m_options = options;
+
+	m_syncPoint.OnCompletion([this] {
+		// The awaiter lives in the coroutine frame, it must not be touched once resumed.
+		if (m_arrived.exchange(true)) {
+			if (m_scheduler) {
+				m_scheduler->Resume(m_awaitingHandle, m_options);
+			}
+			else {
+				m_awaitingHandle.resume();
+			}
+		}
+	});
+
+	// If the callback has already run, the coroutine simply goes on.
+	return !m_arrived.exchange(true);
+}
+
+
 
 } // namespace gxeng
 } // namespace inl
\ No newline at end of file
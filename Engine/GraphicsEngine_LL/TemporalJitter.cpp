@@ -0,0 +1,43 @@
+#include "TemporalJitter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace inl::gxeng {
+
+
+Vec2 TemporalJitter::GetPixelOffset(uint64_t frame, unsigned phaseCount) {
+	phaseCount = std::max(phaseCount, 1u);
+	// Index 0 of the sequence is the origin of both bases, it is skipped so the offsets are not biased towards a corner.
+	uint32_t index = uint32_t(frame % phaseCount) + 1;
+	return Vec2(Halton(index, 2), Halton(index, 3)) - Vec2(0.5f, 0.5f);
+}
+
+
+unsigned TemporalJitter::GetPhaseCount(float renderScale) {
+	renderScale = std::clamp(renderScale, 0.01f, 1.0f);
+	float count = std::ceil(BasePhaseCount / (renderScale * renderScale));
+	return std::min(unsigned(count), MaxPhaseCount);
+}
+
+
+Vec2 TemporalJitter::ToClipSpace(Vec2 pixelOffset, unsigned width, unsigned height) {
+	return Vec2(2.0f * pixelOffset.x / float(std::max(width, 1u)),
+				-2.0f * pixelOffset.y / float(std::max(height, 1u)));
+}
+
+
+float TemporalJitter::Halton(uint32_t index, uint32_t base) {
+	float f = 1.0f;
+	float r = 0.0f;
+	while (index > 0) {
+		f /= float(base);
+		r += f * float(index % base);
+		index /= base;
+	}
+	return r;
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <InlineMath.hpp>
+
+#include <cstdint>
+
+
+namespace inl::gxeng {
+
+
+/// <summary>
+/// The sub-pixel offsets the projection is shifted by each frame, so that temporal anti-aliasing
+/// accumulates samples from all over the pixels.
+/// </summary>
+/// <remarks> Offsets follow the Halton (2, 3) sequence, which covers a pixel evenly for any number of phases.
+///		When the scene is rendered at a lower resolution and upscaled, a render pixel covers several output pixels,
+///		so more phases are needed to cover each of those. </remarks>
+class TemporalJitter {
+public:
+	static constexpr unsigned BasePhaseCount = 8; // Phases at native resolution.
+	static constexpr unsigned MaxPhaseCount = 64;
+
+public:
+	/// <summary> The offset of the frame in render pixels, within [-0.5, 0.5). </summary>
+	static Vec2 GetPixelOffset(uint64_t frame, unsigned phaseCount);
+
+	/// <summary> The number of phases that covers the output pixels when rendering at the given scale of their resolution. </summary>
+	static unsigned GetPhaseCount(float renderScale);
+
+	/// <summary> The offset in clip space, what <see cref="PerspectiveCamera::SetJitter"/> takes. </summary>
+	/// <remarks> Positive pixel offsets move the image right and down, like pixel coordinates, so the y axis is flipped. </remarks>
+	static Vec2 ToClipSpace(Vec2 pixelOffset, unsigned width, unsigned height);
+
+private:
+	static float Halton(uint32_t index, uint32_t base);
+};
+
+
+} // namespace inl::gxeng
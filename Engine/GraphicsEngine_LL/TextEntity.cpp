@@ -4,6 +4,8 @@
 #include <BaseLibrary/Exception/Exception.hpp>
 #include <BaseLibrary/StringUtil.hpp>
 
+#include <algorithm>
+
 namespace inl::gxeng {
 
 
@@ -11,6 +13,7 @@ TextEntity::TextEntity() {}
 
 void TextEntity::SetFont(const Font* font) {
 	m_font = font;
+	UpdateGlyphRun();
 }
 
 void TextEntity::SetColor(Vec4 color) {
@@ -19,6 +22,7 @@ void TextEntity::SetColor(Vec4 color) {
 
 void TextEntity::SetText(std::u32string text) {
 	m_text = std::move(text);
+	UpdateGlyphRun();
 }
 
 void TextEntity::SetFontSize(float size) {
@@ -78,18 +82,7 @@ float TextEntity::GetVerticalAlignment() const {
 
 float TextEntity::CalculateTextWidth() const {
 	if (m_font) {
-		// Convert string to UCS-4 code-points.
-		std::u32string text = EncodeString<char32_t>(m_text);
-
-		// Accumulate length.
-		float width = 0.0f;
-		for (auto ch : text) {
-			if (!m_font->IsCharacterSupported(ch)) {
-				continue;
-			}
-			width += m_fontSize * m_font->GetGlyphInfo(ch).advance;
-		}
-		return width;
+		return GetGlyphRun().GetWidth() * m_fontSize;
 	}
 	else {
 		throw InvalidCallException("Cannot calculate text metrics because no font is set.");
@@ -105,6 +98,39 @@ float TextEntity::CalculateTextHeight() const {
 	}
 }
 
+float TextEntity::GetCaretPosition(size_t index) const {
+	if (!m_font) {
+		throw InvalidCallException("Cannot calculate text metrics because no font is set.");
+	}
+	const auto& carets = GetGlyphRun().carets;
+	return carets[std::min(index, carets.size() - 1)] * m_fontSize;
+}
+
+intptr_t TextEntity::FindCharacter(float coordinate) const {
+	if (!m_font) {
+		throw InvalidCallException("Cannot calculate text metrics because no font is set.");
+	}
+	return Font::FindCharacter(GetGlyphRun(), coordinate / m_fontSize);
+}
+
+const Font::GlyphRun& TextEntity::GetGlyphRun() const {
+	// Loading a new file into the font moves the glyphs in the atlas.
+	if (m_font && m_glyphRun.fontVersion != m_font->GetVersion()) {
+		UpdateGlyphRun();
+	}
+	return m_glyphRun;
+}
+
+void TextEntity::UpdateGlyphRun() const {
+	if (m_font) {
+		// New glyphs are uploaded with the next frame, before the text is drawn.
+		m_glyphRun = m_font->LayoutText(m_text);
+	}
+	else {
+		m_glyphRun = {};
+	}
+}
+
 const Vec2& TextEntity::GetSize() const {
 	return m_size;
 }
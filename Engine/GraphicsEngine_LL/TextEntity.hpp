@@ -82,12 +82,23 @@ public:
 	float CalculateTextWidth() const override;
 	/// <summary> Return the height of a line of text without top and bottom line spacing. </summary>
 	float CalculateTextHeight() const override;
+	/// <summary> Returns the distance of the caret before a character from the left of the text, in camera units. </summary>
+	float GetCaretPosition(size_t index) const override;
+	/// <summary> Returns the index of the character at a distance from the left of the text, same as IFont::FindCharacter. </summary>
+	intptr_t FindCharacter(float coordinate) const override;
+
+	/// <summary> The text laid out with the font, in em units. </summary>
+	/// <remarks> Kept until the text or the font changes, the font size only scales it. </remarks>
+	const Font::GlyphRun& GetGlyphRun() const;
 
 	/// <summary> Z-Depth determines which 2D entity lays over the other. </summary>
 	/// <remarks> Number are not limited to [0,1], anything is fine. Don't pass NaN and Inf. </remarks>
 	void SetZDepth(float z) override;
 	float GetZDepth() const override;
 
+private:
+	void UpdateGlyphRun() const;
+
 private:
 	Vec4 m_color = { 1,0,0,1 };
 	float m_fontSize = 16;
@@ -100,6 +111,8 @@ private:
 	Mat33 m_clipRectTransform;
 	Vec2 m_alignment = { ALIGN_CENTER, ALIGN_CENTER };
 	bool m_clipEnabled = false;
+
+	mutable Font::GlyphRun m_glyphRun;
 };
 
 
@@ -0,0 +1,188 @@
+#include "TextureStreamer.hpp"
+
+#include <BaseLibrary/FrameProfiler.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+
+namespace inl::gxeng {
+
+
+void TextureStreamer::Register(IStreamedImage* image) {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	m_entries.push_back({ image, image->GetCoarsestResidentMip(), m_frame });
+}
+
+
+void TextureStreamer::Unregister(IStreamedImage* image) {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	auto it = std::find_if(m_entries.begin(), m_entries.end(), [image](const Entry& entry) { return entry.image == image; });
+	if (it != m_entries.end()) {
+		*it = m_entries.back();
+		m_entries.pop_back();
+	}
+}
+
+
+void TextureStreamer::Update(uint64_t frame) {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	INL_PROFILE_SCOPE("Texture streaming");
+	m_frame = frame;
+
+	std::vector<Candidate> candidates;
+	candidates.reserve(m_entries.size());
+	for (Entry& entry : m_entries) {
+		unsigned coarsestMip = entry.image->GetCoarsestResidentMip();
+		unsigned requestedMip = entry.image->TakeRequestedMip();
+		if (requestedMip != IStreamedImage::NoRequest) {
+			entry.wantedMip = std::min(requestedMip, coarsestMip);
+			entry.lastRequestedFrame = frame;
+		}
+		else if (frame - entry.lastRequestedFrame >= UnusedFrames) {
+			entry.wantedMip = coarsestMip;
+		}
+		candidates.push_back({ entry.image->GetLevelSizes(), entry.image->GetResidentMip(), coarsestMip, entry.wantedMip, entry.lastRequestedFrame });
+	}
+
+	std::vector<unsigned> plan = Plan(candidates, m_budget, m_uploadBudget);
+
+	m_statistics.budget = m_budget;
+	m_statistics.residentBytes = 0;
+	m_statistics.wantedBytes = 0;
+	m_statistics.uploadedBytes = 0;
+	m_statistics.imageCount = m_entries.size();
+	for (size_t i = 0; i < m_entries.size(); ++i) {
+		if (plan[i] != candidates[i].residentMip) {
+			m_entries[i].image->SetResidentMip(plan[i]);
+			m_statistics.uploadedBytes += GetResidentSize(candidates[i].levelSizes, m_entries[i].image->GetResidentMip());
+		}
+		m_statistics.residentBytes += GetResidentSize(candidates[i].levelSizes, m_entries[i].image->GetResidentMip());
+		m_statistics.wantedBytes += GetResidentSize(candidates[i].levelSizes, candidates[i].wantedMip);
+	}
+}
+
+
+void TextureStreamer::SetBudget(uint64_t bytes) {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	m_budget = bytes;
+}
+
+
+void TextureStreamer::SetUploadBudget(uint64_t bytes) {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	m_uploadBudget = bytes;
+}
+
+
+TextureStreamingStatistics TextureStreamer::GetStatistics() const {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	return m_statistics;
+}
+
+
+std::vector<unsigned> TextureStreamer::Plan(const std::vector<Candidate>& candidates, uint64_t budget, uint64_t uploadBudget) {
+	std::vector<unsigned> plan(candidates.size());
+	uint64_t totalBytes = 0;
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		plan[i] = candidates[i].residentMip;
+		totalBytes += GetResidentSize(candidates[i].levelSizes, plan[i]);
+	}
+	auto wantedMip = [&candidates](size_t i) {
+		return std::min(candidates[i].wantedMip, candidates[i].coarsestMip);
+	};
+
+	// Detail resident beyond what is wanted, the least recently requested is dropped first.
+	std::vector<size_t> surplus;
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		if (plan[i] < wantedMip(i)) {
+			surplus.push_back(i);
+		}
+	}
+	std::sort(surplus.begin(), surplus.end(), [&candidates](size_t lhs, size_t rhs) {
+		return candidates[lhs].lastRequestedFrame < candidates[rhs].lastRequestedFrame;
+	});
+	size_t nextSurplus = 0;
+	auto freeUntil = [&](uint64_t targetBytes) {
+		while (totalBytes > targetBytes && nextSurplus < surplus.size()) {
+			size_t i = surplus[nextSurplus++];
+			totalBytes -= GetResidentSize(candidates[i].levelSizes, plan[i]) - GetResidentSize(candidates[i].levelSizes, wantedMip(i));
+			plan[i] = wantedMip(i);
+		}
+	};
+
+	// The images furthest from what they want go first, of equal ones the most recently requested.
+	std::vector<size_t> incoming;
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		if (wantedMip(i) < plan[i]) {
+			incoming.push_back(i);
+		}
+	}
+	std::sort(incoming.begin(), incoming.end(), [&](size_t lhs, size_t rhs) {
+		unsigned lhsGap = plan[lhs] - wantedMip(lhs);
+		unsigned rhsGap = plan[rhs] - wantedMip(rhs);
+		return lhsGap > rhsGap || (lhsGap == rhsGap && candidates[lhs].lastRequestedFrame > candidates[rhs].lastRequestedFrame);
+	});
+
+	uint64_t uploadedBytes = 0;
+	for (size_t i : incoming) {
+		unsigned mip = plan[i] - 1;
+		uint64_t newSize = GetResidentSize(candidates[i].levelSizes, mip);
+		uint64_t oldSize = GetResidentSize(candidates[i].levelSizes, plan[i]);
+		if (uploadedBytes > 0 && uploadedBytes + newSize > uploadBudget) {
+			continue;
+		}
+		if (newSize - oldSize > budget) {
+			continue;
+		}
+		freeUntil(budget - (newSize - oldSize));
+		if (totalBytes + newSize - oldSize > budget) {
+			continue;
+		}
+		plan[i] = mip;
+		totalBytes += newSize - oldSize;
+		uploadedBytes += newSize;
+	}
+
+	// The budget may have shrunk below what is resident, then even wanted levels go, one per image and update.
+	freeUntil(budget);
+	if (totalBytes > budget) {
+		std::vector<size_t> byAge(candidates.size());
+		std::iota(byAge.begin(), byAge.end(), size_t(0));
+		std::sort(byAge.begin(), byAge.end(), [&candidates](size_t lhs, size_t rhs) {
+			return candidates[lhs].lastRequestedFrame < candidates[rhs].lastRequestedFrame;
+		});
+		for (size_t i : byAge) {
+			if (totalBytes <= budget) {
+				break;
+			}
+			if (plan[i] < candidates[i].coarsestMip && plan[i] == candidates[i].residentMip) {
+				totalBytes -= GetResidentSize(candidates[i].levelSizes, plan[i]) - GetResidentSize(candidates[i].levelSizes, plan[i] + 1);
+				++plan[i];
+			}
+		}
+	}
+
+	return plan;
+}
+
+
+uint64_t TextureStreamer::GetResidentSize(const std::vector<uint64_t>& levelSizes, unsigned mip) {
+	if (mip >= levelSizes.size()) {
+		return 0;
+	}
+	return std::accumulate(levelSizes.begin() + mip, levelSizes.end(), uint64_t(0));
+}
+
+
+unsigned TextureStreamer::RequiredMip(uint64_t textureSize, float pixelCount) {
+	if (!(pixelCount > 0.0f) || textureSize == 0) {
+		return IStreamedImage::NoRequest;
+	}
+	float level = std::log2(float(textureSize) / pixelCount);
+	return level > 0.0f ? unsigned(level) : 0u;
+}
+
+
+} // namespace inl::gxeng
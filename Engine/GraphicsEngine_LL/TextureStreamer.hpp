@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary> Provides the levels of a streamed image whenever they are uploaded again. </summary>
+class IMipSource {
+public:
+	virtual ~IMipSource() = default;
+
+	/// <summary> Returns the level in the GPU format of the image, blocks row by row for block compressed formats. </summary>
+	/// <param name="bytesPerRow"> Distance between rows, or rows of blocks, zero if there is no padding. </param>
+	/// <remarks> Called from the thread updating the engine, the data is copied before returning. </remarks>
+	virtual const void* GetMipData(unsigned mipLevel, size_t& bytesPerRow) const = 0;
+};
+
+
+/// <summary> An image whose finer levels are only kept in memory while they are needed. </summary>
+class IStreamedImage {
+public:
+	static constexpr unsigned NoRequest = std::numeric_limits<unsigned>::max();
+
+	virtual ~IStreamedImage() = default;
+
+	/// <summary> Bytes of each level of the full chain, finest first. </summary>
+	virtual std::vector<uint64_t> GetLevelSizes() const = 0;
+	/// <summary> The finest level that is in memory. </summary>
+	virtual unsigned GetResidentMip() const = 0;
+	/// <summary> The levels from this one on are always in memory. </summary>
+	virtual unsigned GetCoarsestResidentMip() const = 0;
+	/// <summary> Returns the finest level requested since the last call, or <see cref="NoRequest"/>. </summary>
+	virtual unsigned TakeRequestedMip() = 0;
+	/// <summary> Replaces the texture with one of the levels from <paramref name="mip"/> on and uploads them. </summary>
+	virtual void SetResidentMip(unsigned mip) = 0;
+};
+
+
+struct TextureStreamingStatistics {
+	uint64_t budget = 0;
+	uint64_t residentBytes = 0;
+	uint64_t wantedBytes = 0; // What would be in memory with every image at its wanted level.
+	uint64_t uploadedBytes = 0; // In the last update.
+	size_t imageCount = 0;
+};
+
+
+/// <summary>
+/// Keeps the mip levels of streamed images in memory that the renderer asks for, within a memory budget.
+/// </summary>
+/// <remarks>
+/// Renderers request levels on the images each frame, see <see cref="Image::RequestMip"/>.
+/// Once a frame, images move one level closer to what they were asked for, the ones furthest off first.
+/// Streaming in is limited per frame, dropping levels is not, as it only uploads the coarser levels kept.
+/// Images that were not asked for a while fall back to their coarsest levels.
+/// Detail that is no longer wanted is only dropped when room is needed, an image seen again may still have it.
+/// All methods are thread safe.
+/// </remarks>
+class TextureStreamer {
+public:
+	struct Candidate {
+		std::vector<uint64_t> levelSizes;
+		unsigned residentMip;
+		unsigned coarsestMip;
+		unsigned wantedMip;
+		uint64_t lastRequestedFrame;
+	};
+
+	static constexpr uint64_t DefaultBudget = 512ull * 1024 * 1024;
+	static constexpr uint64_t DefaultUploadBudget = 32ull * 1024 * 1024;
+	/// <summary> Images not requested for this many frames only want their coarsest levels. </summary>
+	static constexpr uint64_t UnusedFrames = 120;
+
+public:
+	void Register(IStreamedImage* image);
+	void Unregister(IStreamedImage* image);
+
+	/// <summary> Collects the requests of the past frame and changes the resident levels of the images accordingly. </summary>
+	void Update(uint64_t frame);
+
+	/// <summary> Bytes the resident levels of all streamed images are kept under. </summary>
+	void SetBudget(uint64_t bytes);
+	/// <summary> Bytes streamed in per update at most, except that one image always moves if any has to. </summary>
+	void SetUploadBudget(uint64_t bytes);
+	TextureStreamingStatistics GetStatistics() const;
+
+	/// <summary> Chooses the new resident level of each candidate. </summary>
+	/// <remarks> Replacing a texture uploads all of its new levels, that is what the upload budget is spent on. </remarks>
+	static std::vector<unsigned> Plan(const std::vector<Candidate>& candidates, uint64_t budget, uint64_t uploadBudget);
+
+	/// <summary> Bytes of the levels from <paramref name="mip"/> on. </summary>
+	static uint64_t GetResidentSize(const std::vector<uint64_t>& levelSizes, unsigned mip);
+
+	/// <summary> The level with about one texel per pixel when <paramref name="textureSize"/> texels
+	///		span <paramref name="pixelCount"/> pixels on the screen. </summary>
+	static unsigned RequiredMip(uint64_t textureSize, float pixelCount);
+
+private:
+	struct Entry {
+		IStreamedImage* image;
+		unsigned wantedMip;
+		uint64_t lastRequestedFrame;
+	};
+
+private:
+	mutable std::mutex m_mtx;
+	std::vector<Entry> m_entries;
+	uint64_t m_frame = 0;
+	uint64_t m_budget = DefaultBudget;
+	uint64_t m_uploadBudget = DefaultUploadBudget;
+	TextureStreamingStatistics m_statistics;
+};
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,157 @@
+#include "TransientTexturePool.hpp"
+
+#include <algorithm>
+
+
+namespace inl::gxeng {
+
+
+void TransientTexturePool::SetPrecedence(std::vector<std::vector<bool>> precedes) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	m_precedes = std::move(precedes);
+	m_slots.clear();
+}
+
+
+void TransientTexturePool::SetAliasing(bool enabled) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	m_aliasing = enabled;
+	m_slots.clear();
+}
+
+
+void TransientTexturePool::BeginFrame() {
+	std::lock_guard<std::mutex> lock(m_mtx);
+
+	Statistics statistics;
+	statistics.requestCount = m_requestCount;
+	statistics.requestedBytes = m_requestedBytes;
+	for (const Slot& slot : m_slots) {
+		if (slot.lastUsedFrame == m_frame) {
+			++statistics.textureCount;
+			statistics.allocatedBytes += slot.size;
+		}
+	}
+	if (m_requestCount > 0) {
+		m_lastStatistics = statistics;
+	}
+
+	// References held by submitted command lists keep released textures alive until the GPU is done.
+	m_slots.erase(std::remove_if(m_slots.begin(), m_slots.end(), [this](const Slot& slot) {
+		return slot.lastUsedFrame + MaxIdleFrames < m_frame;
+	}), m_slots.end());
+	for (Slot& slot : m_slots) {
+		if (!slot.holders.empty()) {
+			slot.previousHolders = std::move(slot.holders);
+			slot.holders.clear();
+		}
+	}
+
+	++m_frame;
+	m_requestCount = 0;
+	m_requestedBytes = 0;
+}
+
+
+Texture2D TransientTexturePool::Acquire(MemoryManager& memoryManager, size_t task, const Texture2DDesc& desc, gxapi::eResourceFlags flags) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	Slot& slot = m_slots[FindSlot(task, desc, flags)];
+	if (!slot.texture) {
+		slot.texture = memoryManager.CreateTexture2D(eResourceHeap::CRITICAL, desc, flags);
+		slot.texture.SetName("Transient texture");
+	}
+	return slot.texture;
+}
+
+
+size_t TransientTexturePool::AcquireSlot(size_t task, const Texture2DDesc& desc, gxapi::eResourceFlags flags) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return FindSlot(task, desc, flags);
+}
+
+
+void TransientTexturePool::Clear() {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	m_slots.clear();
+}
+
+
+TransientTexturePool::Statistics TransientTexturePool::GetStatistics() const {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return m_lastStatistics;
+}
+
+
+uint64_t TransientTexturePool::EstimateSize(const Texture2DDesc& desc) {
+	uint64_t pixelSize = gxapi::GetFormatSizeInBytes(desc.format);
+	uint64_t width = desc.width;
+	uint64_t height = desc.height;
+	unsigned mipCount = desc.mipLevels;
+	if (mipCount == 0) {
+		for (uint64_t extent = std::max(width, height); extent > 0; extent /= 2) {
+			++mipCount;
+		}
+	}
+	uint64_t size = 0;
+	for (unsigned mip = 0; mip < mipCount; ++mip) {
+		size += width * height * pixelSize;
+		width = std::max(uint64_t(1), width / 2);
+		height = std::max(uint64_t(1), height / 2);
+	}
+	return size * std::max(uint16_t(1), desc.arraySize);
+}
+
+
+size_t TransientTexturePool::FindSlot(size_t task, const Texture2DDesc& desc, gxapi::eResourceFlags flags) {
+	++m_requestCount;
+	uint64_t size = EstimateSize(desc);
+	m_requestedBytes += size;
+
+	// Prefer the slot the task had in the last frame, so that nodes can keep their views.
+	size_t chosen = m_slots.size();
+	for (size_t i = 0; i < m_slots.size(); ++i) {
+		const Slot& slot = m_slots[i];
+		if (!IsCompatible(slot, desc, flags) || !CanHold(slot, task)) {
+			continue;
+		}
+		bool heldBefore = std::find(slot.previousHolders.begin(), slot.previousHolders.end(), task) != slot.previousHolders.end();
+		if (heldBefore) {
+			chosen = i;
+			break;
+		}
+		chosen = std::min(chosen, i);
+	}
+
+	if (chosen == m_slots.size()) {
+		m_slots.push_back(Slot{ desc, flags, size, Texture2D{}, {}, {}, 0 });
+	}
+	m_slots[chosen].holders.push_back(task);
+	m_slots[chosen].lastUsedFrame = m_frame;
+	return chosen;
+}
+
+
+bool TransientTexturePool::IsCompatible(const Slot& slot, const Texture2DDesc& desc, gxapi::eResourceFlags flags) const {
+	return slot.desc.width == desc.width
+		   && slot.desc.height == desc.height
+		   && slot.desc.format == desc.format
+		   && slot.desc.mipLevels == desc.mipLevels
+		   && slot.desc.arraySize == desc.arraySize
+		   && slot.flags == flags;
+}
+
+
+bool TransientTexturePool::CanHold(const Slot& slot, size_t task) const {
+	if (slot.holders.empty()) {
+		return true;
+	}
+	if (!m_aliasing) {
+		return false;
+	}
+	// Holders form a chain, the last one coming after all the others.
+	size_t last = slot.holders.back();
+	return last != task && last < m_precedes.size() && task < m_precedes[last].size() && m_precedes[last][task];
+}
+
+
+} // namespace inl::gxeng
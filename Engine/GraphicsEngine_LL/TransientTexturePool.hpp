@@ -0,0 +1,92 @@
+#pragma once
+
+#include "MemoryManager.hpp"
+#include "MemoryObject.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary>
+/// Hands out textures that live only for the duration of one task in a frame,
+/// and lets tasks that are ordered by the task graph share the same physical textures.
+/// </summary>
+/// <remarks> Textures are shared whole between requests with same description and flags.
+///		The tasks holding a texture in a frame always form a chain in the task graph,
+///		each running strictly after the previous, which is what makes the sharing safe
+///		regardless of how the job system interleaves independent tasks.
+///		The resource state tracking and the queue dependency waits of the scheduler
+///		handle the hand-off, the contents are undefined when a task acquires a texture. </remarks>
+class TransientTexturePool {
+public:
+	struct Statistics {
+		size_t requestCount = 0;
+		size_t textureCount = 0;
+		uint64_t requestedBytes = 0; // What the requests would take as separate textures.
+		uint64_t allocatedBytes = 0; // What the pool actually holds.
+	};
+
+public:
+	/// <summary> Sets the task ordering, clears all textures. </summary>
+	/// <param name="precedes"> precedes[a][b] is true if task a finishes before task b starts. </param>
+	void SetPrecedence(std::vector<std::vector<bool>> precedes);
+
+	/// <summary> When disabled, every request gets its own texture. Clears all textures. </summary>
+	void SetAliasing(bool enabled);
+	bool GetAliasing() const { return m_aliasing; }
+
+	/// <summary> Starts a new frame, textures held in the previous frame become available again. </summary>
+	/// <remarks> Textures unused for a few frames are released, e.g. after the screen is resized. </remarks>
+	void BeginFrame();
+
+	/// <summary> Returns a texture for the given task that no unordered task uses in this frame. </summary>
+	/// <remarks> Thread safe, tasks are set up in parallel. </remarks>
+	Texture2D Acquire(MemoryManager& memoryManager, size_t task, const Texture2DDesc& desc, gxapi::eResourceFlags flags);
+
+	/// <summary> Chooses the slot for a request, creating a new empty one if none fits. Acquire builds on this. </summary>
+	size_t AcquireSlot(size_t task, const Texture2DDesc& desc, gxapi::eResourceFlags flags);
+	size_t GetSlotCount() const { return m_slots.size(); }
+
+	/// <summary> Drops all textures. </summary>
+	void Clear();
+
+	/// <summary> Memory of the requests of the last completed setup phase, and the memory actually used. </summary>
+	Statistics GetStatistics() const;
+
+	/// <summary> Size of the texture memory, not accounting for the alignment rules of the device. </summary>
+	static uint64_t EstimateSize(const Texture2DDesc& desc);
+
+private:
+	struct Slot {
+		Texture2DDesc desc;
+		gxapi::eResourceFlags flags;
+		uint64_t size;
+		Texture2D texture;
+		std::vector<size_t> holders; // Tasks holding it this frame, in graph order.
+		std::vector<size_t> previousHolders; // Holders of the last frame, preferred to keep assignments stable.
+		uint64_t lastUsedFrame;
+	};
+
+	size_t FindSlot(size_t task, const Texture2DDesc& desc, gxapi::eResourceFlags flags);
+	bool IsCompatible(const Slot& slot, const Texture2DDesc& desc, gxapi::eResourceFlags flags) const;
+	bool CanHold(const Slot& slot, size_t task) const;
+
+private:
+	std::vector<Slot> m_slots;
+	std::vector<std::vector<bool>> m_precedes;
+	bool m_aliasing = true;
+	uint64_t m_frame = 1;
+	size_t m_requestCount = 0;
+	uint64_t m_requestedBytes = 0;
+	Statistics m_lastStatistics;
+	mutable std::mutex m_mtx;
+
+	static constexpr uint64_t MaxIdleFrames = 4;
+};
+
+
+} // namespace inl::gxeng
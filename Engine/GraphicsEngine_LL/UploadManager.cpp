@@ -4,6 +4,7 @@
 #include <GraphicsApi_LL/Common.hpp>
 #include <BaseLibrary/Exception/Exception.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 #include <atomic>
@@ -23,14 +24,16 @@ void UploadManager::Upload(const LinearBuffer& target, size_t offset, const void
 		throw InvalidArgumentException("Target buffer is not large enough for the uploaded data to fit.", "target");
 	}
 
-	auto resource = CreateStagingResource(data, size);
+	auto staging = CreateStagingResource(data, size);
 
 	// Add upload to queue so that scheduler can enqueue it.
 	std::lock_guard<std::mutex> lock(m_mtx);
 	std::vector<UploadDescription>& currQueue = m_uploadFrames.back().uploads;
 
 	UploadDescription uploadDesc(
-		LinearBuffer(std::move(resource), true, eResourceHeap::UPLOAD),
+		std::move(staging.buffer),
+		staging.offset,
+		size,
 		target,
 		offset
 	);
@@ -38,6 +41,61 @@ void UploadManager::Upload(const LinearBuffer& target, size_t offset, const void
 }
 
 
+uint8_t* UploadManager::UploadInPlace(const LinearBuffer& target, size_t offset, size_t size) {
+	if (target.GetSize() < (offset + size)) {
+		throw InvalidArgumentException("Target buffer is not large enough for the uploaded data to fit.", "target");
+	}
+	if (size == 0) {
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mtx);
+	UploadFrame& frame = m_uploadFrames.back();
+	std::vector<InPlaceUpload>& writes = frame.inPlaceUploads[target];
+
+	// A write inside an earlier one goes to the same memory.
+	for (const InPlaceUpload& write : writes) {
+		const UploadDescription& upload = frame.uploads[write.uploadIndex];
+		if (upload.dstOffsetX <= offset && offset + size <= upload.dstOffsetX + upload.sourceSize) {
+			return write.cpuAddress + (offset - upload.dstOffsetX);
+		}
+	}
+
+	// Otherwise it takes in all that overlap or touch it, and those again.
+	size_t first = offset;
+	size_t last = offset + size;
+	std::vector<InPlaceUpload> merged;
+	for (bool grown = true; grown;) {
+		grown = false;
+		for (auto it = writes.begin(); it != writes.end();) {
+			const UploadDescription& upload = frame.uploads[it->uploadIndex];
+			if (upload.dstOffsetX <= last && first <= upload.dstOffsetX + upload.sourceSize) {
+				first = std::min(first, upload.dstOffsetX);
+				last = std::max(last, upload.dstOffsetX + upload.sourceSize);
+				merged.push_back(*it);
+				it = writes.erase(it);
+				grown = true;
+			}
+			else {
+				++it;
+			}
+		}
+	}
+
+	// The merged writes keep their bytes, their own copies are emptied.
+	StagingAllocation staging = AllocateStagingLocked(last - first, BUFFER_ALIGNMENT);
+	for (const InPlaceUpload& write : merged) {
+		UploadDescription& upload = frame.uploads[write.uploadIndex];
+		memcpy(staging.cpuAddress + (upload.dstOffsetX - first), write.cpuAddress, upload.sourceSize);
+		upload.sourceSize = 0;
+	}
+
+	writes.push_back({ frame.uploads.size(), staging.cpuAddress });
+	frame.uploads.push_back(UploadDescription(std::move(staging.buffer), staging.offset, last - first, target, first));
+	return staging.cpuAddress + (offset - first);
+}
+
+
 void UploadManager::Upload(const Texture2D& target,
 						   uint32_t offsetX,
 						   uint32_t offsetY,
@@ -52,27 +110,104 @@ void UploadManager::Upload(const Texture2D& target,
 		throw InvalidArgumentException("Uploaded data does not fit inside target texture. (Uploaded size or offset is too large)", "target");
 	}
 
-	auto resource = CreateStagingResource(data, width, height, format, bytesPerRow);
+	auto staging = CreateStagingResource(data, width, height, format, bytesPerRow);
 
 	// Push upload description to queue so that the scheduler can enqueue the upload.
 	std::lock_guard<std::mutex> lock(m_mtx);
 	std::vector<UploadDescription>& currQueue = m_uploadFrames.back().uploads;
 
 	UploadDescription uploadDesc(
-		LinearBuffer(std::move(resource), true, eResourceHeap::UPLOAD),
+		std::move(staging.buffer),
+		target,
+		subresource,
+		offsetX,
+		offsetY,
+		0,
+		gxapi::TextureCopyDesc::Buffer(format, width, height, 1, staging.offset)
+	);
+
+	currQueue.push_back(std::move(uploadDesc));
+	currQueue.back().source._SetResident(true);
+
+}
+
+void UploadManager::UploadInPlace(const Texture2D& target,
+								  uint32_t offsetX,
+								  uint32_t offsetY,
+								  uint32_t subresource,
+								  uint64_t width,
+								  uint32_t height,
+								  gxapi::eFormat format,
+								  const std::function<void(uint8_t* rows, size_t rowPitch)>& fill)
+{
+	if (target.GetWidth() < (offsetX + width) || target.GetHeight() < (offsetY + height)) {
+		throw InvalidArgumentException("Uploaded data does not fit inside target texture. (Uploaded size or offset is too large)", "target");
+	}
+
+	// Rows are laid out as a texture copy expects, the same as CreateStagingResource does.
+	size_t rowSize = gxapi::GetFormatRowSizeInBytes(format, width);
+	size_t rowCount = gxapi::GetFormatRowCount(format, height);
+	size_t rowPitch = SnapUpwrads(rowSize, DUP_D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+	StagingAllocation staging = AllocateStaging(rowPitch * rowCount, DUP_D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+	fill(staging.cpuAddress, rowPitch);
+
+	// Queued only once filled, the scheduler may take the queue any time.
+	std::lock_guard<std::mutex> lock(m_mtx);
+	std::vector<UploadDescription>& currQueue = m_uploadFrames.back().uploads;
+
+	UploadDescription uploadDesc(
+		std::move(staging.buffer),
 		target,
 		subresource,
 		offsetX,
 		offsetY,
 		0,
-		gxapi::TextureCopyDesc::Buffer(format, width, height, 1, 0)
+		gxapi::TextureCopyDesc::Buffer(format, width, height, 1, staging.offset)
 	);
 
 	currQueue.push_back(std::move(uploadDesc));
 	currQueue.back().source._SetResident(true);
+}
+
+
+void UploadManager::GenerateMips(const Texture2D& target, eMipFilter filter, bool srgb) {
+	if (target.GetNumMiplevels() <= 1) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mtx);
+	std::vector<MipGenerationDescription>& currQueue = m_uploadFrames.back().mipGenerations;
+
+	// Images updated in several pieces ask for every piece.
+	auto it = std::find_if(currQueue.begin(), currQueue.end(), [&target](const MipGenerationDescription& request) {
+		return request.texture == target;
+	});
+	if (it != currQueue.end()) {
+		it->filter = filter;
+		it->srgb = srgb;
+	}
+	else {
+		currQueue.push_back({ target, filter, srgb });
+	}
+}
+
+
+void UploadManager::PrefilterCubemap(const PrefilterDescription& request) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	std::vector<PrefilterDescription>& currQueue = m_uploadFrames.back().prefilters;
 
+	auto it = std::find_if(currQueue.begin(), currQueue.end(), [&request](const PrefilterDescription& queued) {
+		return queued.specular == request.specular;
+	});
+	if (it != currQueue.end()) {
+		*it = request;
+	}
+	else {
+		currQueue.push_back(request);
+	}
 }
 
+
 void UploadManager::UploadNow(CopyCommandList& commandList,
 							  const LinearBuffer& target,
 							  size_t offset,
@@ -83,11 +218,10 @@ void UploadManager::UploadNow(CopyCommandList& commandList,
 		throw InvalidArgumentException("Target buffer is not large enough for the uploaded data to fit.", "target");
 	}
 
-	auto resource = CreateStagingResource(data, size);
-	LinearBuffer source(std::move(resource), true, eResourceHeap::UPLOAD);
+	auto staging = CreateStagingResource(data, size);
 
 	// Enqueue resource copy.
-	commandList.CopyBuffer(target, offset, source, 0, size);
+	commandList.CopyBuffer(target, offset, staging.buffer, staging.offset, size);
 }
 
 void UploadManager::UploadNow(CopyCommandList& commandList,
@@ -105,13 +239,12 @@ void UploadManager::UploadNow(CopyCommandList& commandList,
 		throw InvalidArgumentException("Uploaded data does not fit inside target texture. (Uploaded size or offset is too large)", "target");
 	}
 
-	auto resource = CreateStagingResource(data, width, height, format, bytesPerRow);
-	LinearBuffer source(std::move(resource), true, eResourceHeap::UPLOAD);
+	auto staging = CreateStagingResource(data, width, height, format, bytesPerRow);
 
 	// Enqueue resource copy.
 	SubTexture2D dstPlace(subresource, Vector<intptr_t, 2>((intptr_t)offsetX, (intptr_t)offsetY));
-	auto textureBufferDesc = gxapi::TextureCopyDesc::Buffer(format, width, height, 1, 0);
-	commandList.CopyTexture(target, source, dstPlace, textureBufferDesc);
+	auto textureBufferDesc = gxapi::TextureCopyDesc::Buffer(format, width, height, 1, staging.offset);
+	commandList.CopyTexture(target, staging.buffer, dstPlace, textureBufferDesc);
 }
 
 
@@ -134,6 +267,9 @@ void UploadManager::OnFrameCompleteDevice(uint64_t frameId) {
 		++framesPopped;
 	}
 	assert(framesPopped == 1);
+
+	// Staging pages last used by this frame can be overwritten.
+	m_firstUnfinishedFrameId = std::max(m_firstUnfinishedFrameId, frameId + 1);
 }
 
 
@@ -159,6 +295,22 @@ const std::vector<UploadManager::UploadDescription>& UploadManager::GetQueuedUpl
 }
 
 
+const std::vector<UploadManager::MipGenerationDescription>& UploadManager::GetQueuedMipGenerations() const {
+	std::lock_guard<std::mutex> lock(m_mtx);
+
+	assert(m_uploadFrames.size() > 0);
+	return m_uploadFrames.back().mipGenerations;
+}
+
+
+const std::vector<UploadManager::PrefilterDescription>& UploadManager::GetQueuedPrefilters() const {
+	std::lock_guard<std::mutex> lock(m_mtx);
+
+	assert(m_uploadFrames.size() > 0);
+	return m_uploadFrames.back().prefilters;
+}
+
+
 
 size_t UploadManager::SnapUpwrads(size_t value, size_t gridSize) {
 	// alignement should be power of two
@@ -167,47 +319,85 @@ size_t UploadManager::SnapUpwrads(size_t value, size_t gridSize) {
 }
 
 
-MemoryObject::UniquePtr UploadManager::CreateStagingResource(const void* data, size_t size) {
-	auto resource = MemoryObject::UniquePtr(
-		m_graphicsApi->CreateCommittedResource(
-			gxapi::HeapProperties(gxapi::eHeapType::UPLOAD),
-			gxapi::eHeapFlags::NONE,
-			gxapi::ResourceDesc::Buffer(size),
-			//NOTE: GENERIC_READ is the required starting state for upload heap resources according to msdn
-			// (also there is no need for resource state transition)
-			gxapi::eResourceState::GENERIC_READ
-		),
-		std::default_delete<const gxapi::IResource>()
-	);
+UploadManager::StagingAllocation UploadManager::CreateStagingResource(const void* data, size_t size) {
+	StagingAllocation staging = AllocateStaging(size, BUFFER_ALIGNMENT);
+	memcpy(staging.cpuAddress, data, size);
+	return staging;
+}
 
-	// Set resource name for tracking purposes.
-	static std::atomic_uint64_t counter = 0;
-	resource->SetName(("Buffer upload source" + std::to_string(counter++)).c_str());
 
+UploadManager::StagingAllocation UploadManager::CreateStagingResource(const void* data, uint64_t width, uint32_t height, gxapi::eFormat format, size_t bytesPerRow) {
+	// Rows of block compressed formats are rows of 4x4 blocks.
+	size_t rowSize = gxapi::GetFormatRowSizeInBytes(format, width);
+	size_t rowCount = gxapi::GetFormatRowCount(format, height);
+	size_t rowPitch = SnapUpwrads(rowSize, DUP_D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+	auto requiredSize = std::max(bytesPerRow, rowPitch * rowCount);
 
-	// Copy data to buffer.
-	gxapi::MemoryRange noReadRange{ 0, 0 };
-	void* stagePtr = resource->Map(0, &noReadRange);
-	memcpy(stagePtr, data, size);
-	// Theres no need to unmap but leaving a resource mapped has a performance hit while debugging
-	// see https://msdn.microsoft.com/en-us/library/windows/desktop/dn899215(v=vs.85).aspx#mapping_and_unmapping
-	resource->Unmap(0, nullptr);
+	// Copy texture to upload buffer row-by-row.
+	StagingAllocation staging = AllocateStaging(requiredSize, DUP_D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+	auto byteData = reinterpret_cast<const uint8_t*>(data);
+	size_t sourcePitch = bytesPerRow > 0 ? bytesPerRow : rowSize;
+	for (size_t y = 0; y < rowCount; y++) {
+		memcpy(staging.cpuAddress + rowPitch*y, byteData + sourcePitch*y, rowSize);
+	}
 
-	return resource;
+	return staging;
 }
 
 
-MemoryObject::UniquePtr UploadManager::CreateStagingResource(const void* data, uint64_t width, uint32_t height, gxapi::eFormat format, size_t bytesPerRow) {
-	auto pixelSize = gxapi::GetFormatSizeInBytes(format);
-	auto rowSize = width * pixelSize;
-	size_t rowPitch = SnapUpwrads(rowSize, DUP_D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
-	auto requiredSize = bytesPerRow > 0 ? bytesPerRow : rowPitch * height;
+UploadManager::StagingAllocation UploadManager::AllocateStaging(size_t size, size_t alignment) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return AllocateStagingLocked(size, alignment);
+}
+
 
+UploadManager::StagingAllocation UploadManager::AllocateStagingLocked(size_t size, size_t alignment) {
+	// Large uploads would waste most of a page, they get a dedicated resource that dies with the upload.
+	if (size > DEDICATED_THRESHOLD) {
+		StagingPage dedicated = CreateStagingPage(size);
+		return { std::move(dedicated.buffer), 0, dedicated.cpuAddress };
+	}
+
+	assert(!m_uploadFrames.empty());
+	const uint64_t frameId = m_uploadFrames.back().frameId;
+	auto isFree = [this](const StagingPage& page) { return page.lastFrameId < m_firstUnfinishedFrameId; };
+
+	// Try the current page first, then move on to the next one the GPU is done with.
+	// If all of them are in flight, a new page is inserted into the rotation.
+	StagingPage* page = m_stagingPages.empty() ? nullptr : &m_stagingPages[m_currentPage];
+	if (page && isFree(*page)) {
+		page->consumedSize = 0;
+	}
+	if (!page || SnapUpwrads(page->consumedSize, alignment) + size > page->size) {
+		page = nullptr;
+		for (size_t i = 1; i < m_stagingPages.size() && !page; ++i) {
+			size_t index = (m_currentPage + i) % m_stagingPages.size();
+			if (isFree(m_stagingPages[index])) {
+				m_currentPage = index;
+				page = &m_stagingPages[index];
+				page->consumedSize = 0;
+			}
+		}
+		if (!page) {
+			m_currentPage = m_stagingPages.empty() ? 0 : m_currentPage + 1;
+			m_stagingPages.insert(m_stagingPages.begin() + m_currentPage, CreateStagingPage(STAGING_PAGE_SIZE));
+			page = &m_stagingPages[m_currentPage];
+		}
+	}
+
+	size_t offset = SnapUpwrads(page->consumedSize, alignment);
+	page->consumedSize = offset + size;
+	page->lastFrameId = frameId;
+	return { page->buffer, offset, page->cpuAddress + offset };
+}
+
+
+UploadManager::StagingPage UploadManager::CreateStagingPage(size_t size) const {
 	auto resource = MemoryObject::UniquePtr(
 		m_graphicsApi->CreateCommittedResource(
 			gxapi::HeapProperties(gxapi::eHeapType::UPLOAD),
 			gxapi::eHeapFlags::NONE,
-			gxapi::ResourceDesc::Buffer(requiredSize),
+			gxapi::ResourceDesc::Buffer(size),
 			// GENERIC_READ is the required starting state for upload heap resources according to MSDN.
 			// (Also there is no need for resource state transition.)
 			gxapi::eResourceState::GENERIC_READ
@@ -218,19 +408,14 @@ MemoryObject::UniquePtr UploadManager::CreateStagingResource(const void* data, u
 	// Set resource name for tracking purposes.
 #ifdef _DEBUG
 	static std::atomic_uint64_t counter = 0;
-	resource->SetName(("Texture upload source" + std::to_string(counter++)).c_str());
+	resource->SetName(("Upload staging page" + std::to_string(counter++)).c_str());
 #endif
 
-	// Copy texture to upload buffer row-by-row.
+	// Upload heaps may stay mapped, the CPU only writes them.
 	gxapi::MemoryRange noReadRange{ 0, 0 };
-	auto stagePtr = reinterpret_cast<uint8_t*>(resource->Map(0, &noReadRange));
-	auto byteData = reinterpret_cast<const uint8_t*>(data);
-	for (size_t y = 0; y < height; y++) {
-		memcpy(stagePtr + rowPitch*y, byteData + rowSize*y, rowSize);
-	}
-	resource->Unmap(0, nullptr);
+	auto cpuAddress = reinterpret_cast<uint8_t*>(resource->Map(0, &noReadRange));
 
-	return resource;
+	return { LinearBuffer(std::move(resource), true, eResourceHeap::UPLOAD), cpuAddress, size, 0, 0 };
 }
 
 
@@ -3,10 +3,16 @@
 #include "PipelineEventListener.hpp"
 #include "MemoryObject.hpp"
 
+#include <GraphicsEngine/Resources/IImage.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <utility>
 #include <mutex>
 #include <deque>
 #include <list>
+#include <unordered_map>
 
 namespace inl::gxeng {
 
@@ -18,9 +24,13 @@ public:
 	enum class DestType { BUFFER, TEXTURE_2D };
 	struct UploadDescription {
 		UploadDescription(LinearBuffer&& source,
+						  size_t sourceOffset,
+						  size_t sourceSize,
 						  const LinearBuffer& destination,
 						  size_t bufferOffset) :
 			source(std::move(source)),
+			sourceOffset(sourceOffset),
+			sourceSize(sourceSize),
 			destination(destination),
 			destType(DestType::BUFFER),
 			dstOffsetX(bufferOffset) {}
@@ -37,6 +47,8 @@ public:
 			textureBufferDesc(textureBufferDesc) {}
 		
 		LinearBuffer source;
+		size_t sourceOffset = 0; // Start of the data in source, for buffers. Textures have it in textureBufferDesc.
+		size_t sourceSize = 0; // Bytes to copy, for buffers.
 
 		// Destination is a weak pointer because it might get deleted before
 		// the graphics engine starts to process the request.
@@ -50,13 +62,51 @@ public:
 
 		gxapi::TextureCopyDesc textureBufferDesc;
 	};
+	/// <summary> Fills all levels of the texture below the top one from the top one, after the uploads. </summary>
+	struct MipGenerationDescription {
+		Texture2D texture;
+		eMipFilter filter;
+		bool srgb;
+	};
+	/// <summary> Prefilters a cubemap for image based lighting over the next frames, see <see cref="CubemapPrefilterTask"/>. </summary>
+	struct PrefilterDescription {
+		Texture2D source; // Cube, its top level is filtered.
+		Texture2D radiance; // Cube with the full chain, holds the box filtered copies of the source.
+		Texture2D specular; // Cube, level i is convolved with the GGX lobe of roughness i / (levels - 1).
+		LinearBuffer irradiance; // 9 float4, spherical harmonics coefficients of the irradiance.
+		std::shared_ptr<std::atomic<bool>> done; // Set once the last of the work is recorded.
+	};
 private:
+	/// <summary> Staging memory handed out by <see cref="UploadInPlace"/>, the data of one of the frame's uploads. </summary>
+	struct InPlaceUpload {
+		size_t uploadIndex;
+		uint8_t* cpuAddress;
+	};
+
 	struct UploadFrame {
 		std::vector<UploadDescription> uploads;
+		std::vector<MipGenerationDescription> mipGenerations;
+		std::vector<PrefilterDescription> prefilters;
+		std::unordered_map<MemoryObject, std::vector<InPlaceUpload>> inPlaceUploads; // Disjoint ranges of each buffer, merged as they are written.
 		uint64_t frameId;
 		mutable bool wasQueried = false; // Only for debugging. True if the scheduler asked for this batch.
 	};
 
+	/// <summary> Persistently mapped upload buffer, staging memory is sub-allocated from it linearly. </summary>
+	struct StagingPage {
+		LinearBuffer buffer;
+		uint8_t* cpuAddress;
+		size_t size;
+		size_t consumedSize;
+		uint64_t lastFrameId; // Last frame that allocated from the page, the page is reused once it finished.
+	};
+
+	struct StagingAllocation {
+		LinearBuffer buffer;
+		size_t offset;
+		uint8_t* cpuAddress;
+	};
+
 public:
 	UploadManager(gxapi::IGraphicsApi* graphicsApi);
 
@@ -70,6 +120,17 @@ public:
 				const void* data,
 				size_t size);
 
+	/// <summary> Returns staging memory for <paramref name="size"/> bytes, which are uploaded to the buffer at the beginning of the next GPU frame. </summary>
+	/// <param name="target"> Data is uploaded to this buffer. </param>
+	/// <param name="offset"> Where the written bytes go in <paramref name="target"/>. </param>
+	/// <remarks> Saves the copy <see cref="Upload"/> makes when the data can be produced right into the staging memory.
+	///		Writes to the same buffer in the same frame that overlap or touch are merged into a single copy, later writes win where they overlap.
+	///		The memory is only valid until the next in-place write of the same buffer, fill it before that.
+	///		Don't mix it with <see cref="Upload"/> on the same range in the same frame, merged writes may end up after it. </remarks>
+	uint8_t* UploadInPlace(const LinearBuffer& target,
+						   size_t offset,
+						   size_t size);
+
 	// The pixels from the source image must be in row-major order inside memory.
 	/// <summary> Schedules uploading of data at the beginning of the next GPU frame. </summary>
 	/// <param name="target"> Data is uploaded to this texture. </param>
@@ -92,6 +153,29 @@ public:
 				gxapi::eFormat format, 
 				size_t bytesPerRow = 0);
 
+	/// <summary> Schedules uploading pixels that are written right into the staging memory, at the beginning of the next GPU frame. </summary>
+	/// <param name="fill"> Called before this returns, with the staging memory and the distance of its rows in bytes.
+	///		It must write <paramref name="height"/> rows of <paramref name="width"/> pixels of <paramref name="format"/>. </param>
+	/// <remarks> Saves the copy <see cref="Upload"/> makes when the pixels are converted on their way anyway. </remarks>
+	void UploadInPlace(const Texture2D& target,
+					   uint32_t offsetX,
+					   uint32_t offsetY,
+					   uint32_t subresource,
+					   uint64_t width,
+					   uint32_t height,
+					   gxapi::eFormat format,
+					   const std::function<void(uint8_t* rows, size_t rowPitch)>& fill);
+
+	/// <summary> Schedules generating the mip levels of the texture once the uploads of the next GPU frame are done. </summary>
+	/// <param name="target"> Must allow unordered access, every level but the top one is overwritten. </param>
+	/// <param name="srgb"> Colors are filtered in linear space, see <see cref="IImage::SetMipGeneration"/>. </param>
+	/// <remarks> Requests for the same texture in the same frame are merged, the last one's settings win. </remarks>
+	void GenerateMips(const Texture2D& target, eMipFilter filter, bool srgb);
+
+	/// <summary> Schedules prefiltering a cubemap, starting once the uploads and mip generations of the next GPU frame are done. </summary>
+	/// <remarks> A request for the same specular texture replaces the one in progress. </remarks>
+	void PrefilterCubemap(const PrefilterDescription& request);
+
 	/// <summary> Schedules a data copy on the given command list immediately. </summary>
 	/// <param name="commandList"> Data copy will be called on this command list. </param>
 	/// <param name="target"> Data is uploaded to this buffer. </param>
@@ -138,18 +222,34 @@ public:
 	/// <remarks> If this function is called from the <see cref="Scheduler"/> - as it should be -
 	///		the upcoming frame will be the one currently processed by the scheduler. </remarks>
 	const std::vector<UploadDescription>& GetQueuedUploads() const;
+	/// <summary> Returns the mip generations to run after the uploads of the upcoming frame. </summary>
+	const std::vector<MipGenerationDescription>& GetQueuedMipGenerations() const;
+	/// <summary> Returns the cubemap prefilters to start after the mip generations of the upcoming frame. </summary>
+	const std::vector<PrefilterDescription>& GetQueuedPrefilters() const;
 protected:
 	gxapi::IGraphicsApi* m_graphicsApi;
 	std::list<UploadFrame> m_uploadFrames;
 
 	mutable std::mutex m_mtx;
 
-	// Creates and copies uploaded data into a staging GPU buffer (for buffers).
-	MemoryObject::UniquePtr CreateStagingResource(const void* data, size_t size);
-	// Creates and copies uploaded data into a staging GPU buffer (for textures).
-	MemoryObject::UniquePtr CreateStagingResource(const void* data, uint64_t width, uint32_t height, gxapi::eFormat format, size_t bytesPerRow);
+	std::vector<StagingPage> m_stagingPages; // Used round-robin, grows when all pages are in flight.
+	size_t m_currentPage = 0;
+	uint64_t m_firstUnfinishedFrameId = 0;
+
+	// Copies uploaded data into staging memory (for buffers).
+	StagingAllocation CreateStagingResource(const void* data, size_t size);
+	// Copies uploaded data into staging memory, with rows laid out as a texture copy expects (for textures).
+	StagingAllocation CreateStagingResource(const void* data, uint64_t width, uint32_t height, gxapi::eFormat format, size_t bytesPerRow);
+	// Returns staging memory that is free until the frame of the current uploads finishes on the GPU.
+	StagingAllocation AllocateStaging(size_t size, size_t alignment);
+	StagingAllocation AllocateStagingLocked(size_t size, size_t alignment); // The caller holds m_mtx.
+	StagingPage CreateStagingPage(size_t size) const;
 protected:
 	static constexpr int DUP_D3D12_TEXTURE_DATA_PITCH_ALIGNMENT = 256;
+	static constexpr int DUP_D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT = 512;
+	static constexpr size_t BUFFER_ALIGNMENT = 16;
+	static constexpr size_t STAGING_PAGE_SIZE = 4 * 1024 * 1024;
+	static constexpr size_t DEDICATED_THRESHOLD = STAGING_PAGE_SIZE / 2; // Larger uploads get their own resource.
 
 private:
 	static size_t SnapUpwrads(size_t value, size_t gridSize);
@@ -1,8 +1,14 @@
 #include "VertexCompressor.hpp"
-#include <InlineMath.hpp>
-#include <BaseLibrary/ArrayView.hpp>
 
 #include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define INL_VERTEX_COMPRESSOR_SSE
+#endif
 
 
 namespace inl::gxeng {
@@ -10,62 +16,137 @@ namespace inl::gxeng {
 
 
 //------------------------------------------------------------------------------
-// Semantic compressor implementations
+// Position quantization
 //------------------------------------------------------------------------------
 
+PositionQuantization PositionQuantization::FromBounds(const BoundingBox& bounds) {
+	PositionQuantization quantization;
+	if (bounds.IsEmpty()) {
+		return quantization;
+	}
 
-void NormalCompressor::Compress(const void* input, void* output) const {
-	using InputT = VertexPartReader<eVertexElementSemantic::NORMAL>::DataType;
+	Vec3 size = bounds.upper - bounds.lower;
+	float largestSize = std::max(size.x, std::max(size.y, size.z));
+	quantization.offset = bounds.lower;
+	quantization.scale = largestSize > 0.0f ? largestSize : 1.0f;
+	return quantization;
+}
 
-	const InputT* in = reinterpret_cast<const InputT*>(input);
-	Vec3_Packed* out = reinterpret_cast<Vec3_Packed*>(output);
 
-	out->x = in->x;
-	out->y = in->y;
-	out->z = in->z;
-}
-int NormalCompressor::Size() const {
-	return sizeof(Vec3_Packed);
-}
-bool NormalCompressor::IsSupported(eVertexElementSemantic semantic) const {
-	return semantic == eVertexElementSemantic::NORMAL
-		|| semantic == eVertexElementSemantic::TANGENT
-		|| semantic == eVertexElementSemantic::BITANGENT;
+Mat44 PositionQuantization::GetDequantization() const {
+	Mat44 dequantization = Mat44::Identity();
+	dequantization(0, 0) = scale;
+	dequantization(1, 1) = scale;
+	dequantization(2, 2) = scale;
+	dequantization(3, 0) = offset.x;
+	dequantization(3, 1) = offset.y;
+	dequantization(3, 2) = offset.z;
+	return dequantization;
 }
 
 
 
+//------------------------------------------------------------------------------
+// Encoders
+//------------------------------------------------------------------------------
 
-void ColorCompressor::Compress(const void* input, void* output) const {
-	using InputT = VertexPartReader<eVertexElementSemantic::COLOR>::DataType;
+static uint16_t ToUnorm16(float value) {
+	// NaN goes to 0 as well.
+	value = value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+	return uint16_t(value * 65535.0f + 0.5f);
+}
 
-	const InputT* in = reinterpret_cast<const InputT*>(input);
-	Vec3_Packed* out = reinterpret_cast<Vec3_Packed*>(output);
 
-	out->x = in->x;
-	out->y = in->y;
-	out->z = in->z;
+static int16_t ToSnorm16(float value) {
+	value = value > -1.0f ? (value < 1.0f ? value : 1.0f) : -1.0f;
+	return int16_t(std::round(value * 32767.0f));
 }
-int ColorCompressor::Size() const {
-	return sizeof(Vec3_Packed);
-}
-bool ColorCompressor::IsSupported(eVertexElementSemantic semantic) const {
-	return semantic == eVertexElementSemantic::COLOR;
+
+
+static float SignNotZero(float value) {
+	return value >= 0.0f ? 1.0f : -1.0f;
 }
 
 
+uint16_t VertexCompressor::FloatToHalf(float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	uint32_t sign = (bits >> 16) & 0x8000u;
+	uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+	if (magnitude >= 0x7F800000u) {
+		return uint16_t(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x0200u : 0u));
+	}
+	// 65520 and above round past the largest half.
+	if (magnitude >= 0x477FF000u) {
+		return uint16_t(sign | 0x7C00u);
+	}
+	// Below the smallest normal half, the result is denormal or zero.
+	if (magnitude < 0x38800000u) {
+		if (magnitude < 0x33000000u) {
+			return uint16_t(sign);
+		}
+		uint32_t exponent = magnitude >> 23;
+		uint32_t mantissa = (magnitude & 0x007FFFFFu) | 0x00800000u;
+		uint32_t shift = 126 - exponent;
+		uint32_t half = mantissa >> shift;
+		uint32_t remainder = mantissa & ((1u << shift) - 1);
+		uint32_t halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+			++half;
+		}
+		return uint16_t(sign | half);
+	}
 
-void PassthroughCompressor::Setup(eVertexElementSemantic semantic, const IVertexReader* reader) {
-	m_stride = (int)reader->GetSize(semantic);
+	// Rebias the exponent and round the mantissa to nearest even, a carry correctly moves into the exponent.
+	uint32_t rebased = magnitude - 0x38000000u;
+	uint32_t half = rebased >> 13;
+	uint32_t remainder = rebased & 0x1FFFu;
+	if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+		++half;
+	}
+	return uint16_t(sign | half);
 }
-void PassthroughCompressor::Compress(const void* input, void* output) const {
-	memcpy(output, input, m_stride);
+
+
+float VertexCompressor::HalfToFloat(uint16_t value) {
+	uint32_t sign = uint32_t(value & 0x8000u) << 16;
+	uint32_t exponent = (value >> 10) & 0x1Fu;
+	uint32_t mantissa = value & 0x03FFu;
+
+	if (exponent == 0) {
+		float magnitude = std::ldexp(float(mantissa), -24);
+		return sign ? -magnitude : magnitude;
+	}
+	uint32_t bits = exponent == 0x1Fu
+						? sign | 0x7F800000u | (mantissa << 13)
+						: sign | ((exponent + 112) << 23) | (mantissa << 13);
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return result;
 }
-int PassthroughCompressor::Size() const {
-	return m_stride;
+
+
+Vec2 VertexCompressor::EncodeOctahedral(const Vec3& direction) {
+	float length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+	if (!(length > 0.0f)) {
+		return { 0.0f, 0.0f };
+	}
+	Vec2 projected = { direction.x / length, direction.y / length };
+	if (direction.z < 0.0f) {
+		projected = { (1.0f - std::abs(projected.y)) * SignNotZero(projected.x),
+					  (1.0f - std::abs(projected.x)) * SignNotZero(projected.y) };
+	}
+	return projected;
 }
-bool PassthroughCompressor::IsSupported(eVertexElementSemantic semantic) const {
-	return true;
+
+
+Vec3 VertexCompressor::DecodeOctahedral(const Vec2& encoded) {
+	Vec3 direction = { encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y) };
+	float fold = std::max(-direction.z, 0.0f);
+	direction.x += direction.x >= 0.0f ? -fold : fold;
+	direction.y += direction.y >= 0.0f ? -fold : fold;
+	return direction.Normalized();
 }
 
 
@@ -75,159 +156,198 @@ bool PassthroughCompressor::IsSupported(eVertexElementSemantic semantic) const {
 //------------------------------------------------------------------------------
 
 VertexCompressor::VertexCompressor(
-	const IVertexReader* reader, 
-	const std::vector<bool>& elementMap) 
+	const IVertexReader* reader,
+	const std::vector<bool>& elementMap,
+	const PositionQuantization& positionQuantization)
+	: m_positionQuantization(positionQuantization)
 {
 	assert(reader != nullptr);
 	m_reader = reader;
 
-	// Default compressors.
-	CreateDefaultCompressorList();
-
 	// Create a filtered list that only has those elements that should be written to output.
 	const std::vector<IVertexReader::Element>& elements = reader->GetElements();
 	assert(elements.size() == elementMap.size());
+	m_elementCount = elements.size();
 
-	std::vector<IVertexReader::Element> chosenElements;
-	for (int i = 0; i < elements.size(); ++i) {
+	for (int i = 0; i < (int)elements.size(); ++i) {
 		if (elementMap[i]) {
-			chosenElements.push_back(elements[i]);
+			m_operations.push_back({ eOperation::COPY, elements[i], i, 0, 0, gxapi::eFormat::UNKNOWN });
 		}
 	}
 
 	// Sort filtered list by semantic, and by index within same semantic.
-	// Sorts are seemingly reversed, that's how it works.
-	std::stable_sort(
-		chosenElements.begin(),
-		chosenElements.end(),
-		[](const IVertexReader::Element& lhs, const IVertexReader::Element& rhs) {
-		return lhs.index < rhs.index;
-	});
-
-	std::stable_sort(
-		chosenElements.begin(),
-		chosenElements.end(),
-		[](const IVertexReader::Element& lhs, const IVertexReader::Element& rhs) {
-		return lhs.semantic < rhs.semantic;
+	std::stable_sort(m_operations.begin(), m_operations.end(), [](const Operation& lhs, const Operation& rhs) {
+		return lhs.sourceElement.semantic < rhs.sourceElement.semantic
+			   || (lhs.sourceElement.semantic == rhs.sourceElement.semantic && lhs.sourceElement.index < rhs.sourceElement.index);
 	});
 
-
-	// Fill elements.
-	for (auto& v : chosenElements) {
-		auto* compressor = AssignCompressor(v);
-
-		if (compressor != nullptr) {
-			m_elementsToCompress.push_back({
-				v,
-				compressor
-			});
+	// The element types are fixed by the semantic, so is the encoding.
+	for (auto& operation : m_operations) {
+		switch (operation.sourceElement.semantic) {
+			case eVertexElementSemantic::POSITION:
+				if (operation.sourceElement.index == 0) {
+					operation.operation = eOperation::QUANTIZE_POSITION;
+					operation.size = 4 * sizeof(uint16_t);
+					operation.format = gxapi::eFormat::R16G16B16A16_UNORM;
+				}
+				break;
+			case eVertexElementSemantic::NORMAL:
+			case eVertexElementSemantic::TANGENT:
+			case eVertexElementSemantic::BITANGENT:
+				operation.operation = eOperation::OCTAHEDRAL;
+				operation.size = 2 * sizeof(int16_t);
+				operation.format = gxapi::eFormat::R16G16_SNORM;
+				break;
+			case eVertexElementSemantic::TEX_COORD:
+				operation.operation = eOperation::HALF2;
+				operation.size = 2 * sizeof(uint16_t);
+				operation.format = gxapi::eFormat::R16G16_FLOAT;
+				break;
+			default:
+				break;
 		}
-		else {
-			m_passThroughCompressors.push_back(std::make_unique<PassthroughCompressor>());
-			m_passThroughCompressors.back()->Setup(v.semantic, reader);
-			compressor = m_passThroughCompressors.back().get();
-			m_elementsToCompress.push_back({
-				v,
-				compressor
-			});
+		if (operation.operation == eOperation::COPY) {
+			operation.size = (int)reader->GetSize(operation.sourceElement.semantic);
+			switch (operation.size) {
+				case 8: operation.format = gxapi::eFormat::R32G32_FLOAT; break;
+				case 12: operation.format = gxapi::eFormat::R32G32B32_FLOAT; break;
+				case 16: operation.format = gxapi::eFormat::R32G32B32A32_FLOAT; break;
+				default: operation.format = gxapi::eFormat::UNKNOWN;
+			}
 		}
+		operation.offset = m_stride;
+		m_stride += operation.size;
 	}
 }
 
 
 std::vector<uint8_t> VertexCompressor::GetCompressedStream(const VertexBase* vertices, size_t vertexCount) const {
-	int stride = 0;
-	std::vector<int> sizes;
-	for (auto& v : m_elementsToCompress) {
-		int s = v.assignedCompressor->Size();
-		stride += s;
-		sizes.push_back(s);
-	}
-
-	std::vector<uint8_t> data;
-	data.resize(vertexCount * stride);
-
-	size_t offset = 0;
-	size_t numElements = m_elementsToCompress.size();
-	ArrayView<const VertexBase> inputArray{ vertices, vertexCount, (size_t)m_reader->GetStride() };
-	for (size_t vertex = 0; vertex < vertexCount; ++vertex) {
-		for (size_t element = 0; element < numElements; ++element) {
-			eVertexElementSemantic semantic = m_elementsToCompress[element].sourceElement.semantic;
-			int index = m_elementsToCompress[element].sourceElement.index;
-			const void* input = m_reader->GetPointer(inputArray[vertex], semantic, index);
+	std::vector<uint8_t> data(vertexCount * m_stride);
+	Compress(vertices, vertexCount, data.data());
+	return data;
+}
 
-			void* output = data.data() + offset;
 
-			m_elementsToCompress[element].assignedCompressor->Compress(input, output);
+void VertexCompressor::Compress(const VertexBase* vertices, size_t vertexCount, void* output) const {
+	if (vertexCount == 0) {
+		return;
+	}
 
-			offset += sizes[element];
+	// Elements are at the same place in every vertex, the first one tells where.
+	const size_t sourceStride = (size_t)m_reader->GetStride();
+	uint8_t* destinationBase = static_cast<uint8_t*>(output);
+	for (const auto& operation : m_operations) {
+		const uint8_t* source = static_cast<const uint8_t*>(m_reader->GetPointer(*vertices, operation.sourceElement.semantic, operation.sourceElement.index));
+		uint8_t* destination = destinationBase + operation.offset;
+
+		switch (operation.operation) {
+			case eOperation::QUANTIZE_POSITION:
+				QuantizePositions(source, sourceStride, destination, m_stride, vertexCount);
+				break;
+			case eOperation::OCTAHEDRAL:
+				EncodeOctahedrals(source, sourceStride, destination, m_stride, vertexCount);
+				break;
+			case eOperation::HALF2:
+				EncodeHalves(source, sourceStride, destination, m_stride, vertexCount);
+				break;
+			case eOperation::COPY:
+				Copy(source, sourceStride, destination, m_stride, operation.size, vertexCount);
+				break;
 		}
 	}
-
-	return data;
 }
 
+
 int VertexCompressor::GetCompressedStride() const {
-	int stride = 0;
-	for (auto& v : m_elementsToCompress) {
-		stride += v.assignedCompressor->Size();
-	}
-	return stride;
+	return m_stride;
 }
 
+
 std::vector<int> VertexCompressor::GetCompressedOffsets() const {
-	int stride = 0;
+	std::vector<int> offsets(m_elementCount, -1);
+	for (const auto& operation : m_operations) {
+		offsets[operation.readerIndex] = operation.offset;
+	}
+	return offsets;
+}
 
-	auto& elements = m_reader->GetElements();
-	std::vector<int> offsets(elements.size(), -1);
 
-	for (auto& v : m_elementsToCompress) {
-		int s = v.assignedCompressor->Size();
+std::vector<gxapi::eFormat> VertexCompressor::GetCompressedFormats() const {
+	std::vector<gxapi::eFormat> formats(m_elementCount, gxapi::eFormat::UNKNOWN);
+	for (const auto& operation : m_operations) {
+		formats[operation.readerIndex] = operation.format;
+	}
+	return formats;
+}
 
-		for (size_t i = 0; i < elements.size(); ++i) {
-			if (v.sourceElement.semantic == elements[i].semantic
-				&& v.sourceElement.index == elements[i].index)
-			{
-				offsets[i] = stride;
-			}
-		}
 
-		stride += s;
+void VertexCompressor::QuantizePositions(const uint8_t* source, size_t sourceStride, uint8_t* destination, size_t destinationStride, size_t vertexCount) const {
+	const Vec3 offset = m_positionQuantization.offset;
+	const float inverseScale = 1.0f / m_positionQuantization.scale;
+	const float multiplier = 65535.0f * inverseScale;
+	size_t i = 0;
+
+#ifdef INL_VERTEX_COMPRESSOR_SSE
+	// The fourth component is always 1, so the shaders can use the position as is.
+	const __m128 offsetV = _mm_setr_ps(offset.x, offset.y, offset.z, 0.0f);
+	const __m128 multiplierV = _mm_set1_ps(multiplier);
+	const __m128 maxV = _mm_set1_ps(65535.0f);
+	const __m128 xyzMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	const __m128 wOne = _mm_setr_ps(0.0f, 0.0f, 0.0f, 65535.0f);
+	const __m128i bias = _mm_set1_epi32(32768);
+	const __m128i flip = _mm_set1_epi16(int16_t(0x8000));
+
+	// Four floats are loaded for three, the last vertex is done below so as not to read past the end.
+	for (; i + 1 < vertexCount; ++i) {
+		__m128 position = _mm_loadu_ps(reinterpret_cast<const float*>(source + i * sourceStride));
+		__m128 quantized = _mm_mul_ps(_mm_sub_ps(position, offsetV), multiplierV);
+		quantized = _mm_min_ps(_mm_max_ps(quantized, _mm_setzero_ps()), maxV);
+		quantized = _mm_or_ps(_mm_and_ps(quantized, xyzMask), wOne);
+		// There is no unsigned saturating pack in SSE2, shift into the signed range and back.
+		__m128i integers = _mm_sub_epi32(_mm_cvtps_epi32(quantized), bias);
+		__m128i packed = _mm_xor_si128(_mm_packs_epi32(integers, integers), flip);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(destination + i * destinationStride), packed);
+	}
+#endif
+
+	for (; i < vertexCount; ++i) {
+		const float* position = reinterpret_cast<const float*>(source + i * sourceStride);
+		uint16_t quantized[4] = {
+			ToUnorm16((position[0] - offset.x) * inverseScale),
+			ToUnorm16((position[1] - offset.y) * inverseScale),
+			ToUnorm16((position[2] - offset.z) * inverseScale),
+			0xFFFFu,
+		};
+		std::memcpy(destination + i * destinationStride, quantized, sizeof(quantized));
 	}
-	return offsets;
 }
 
 
+void VertexCompressor::EncodeOctahedrals(const uint8_t* source, size_t sourceStride, uint8_t* destination, size_t destinationStride, size_t vertexCount) {
+	for (size_t i = 0; i < vertexCount; ++i) {
+		const float* direction = reinterpret_cast<const float*>(source + i * sourceStride);
+		Vec2 encoded = EncodeOctahedral({ direction[0], direction[1], direction[2] });
+		int16_t packed[2] = { ToSnorm16(encoded.x), ToSnorm16(encoded.y) };
+		std::memcpy(destination + i * destinationStride, packed, sizeof(packed));
+	}
+}
 
 
-SemanticCompressor* VertexCompressor::AssignCompressor(const IVertexReader::Element& element) {
-	auto it = m_availableCompressors.begin();
-	while (it != m_availableCompressors.end()) {
-		if ((*it)->IsSupported(element.semantic)) {
-			return it->get();
-		}
-		++it;
+void VertexCompressor::EncodeHalves(const uint8_t* source, size_t sourceStride, uint8_t* destination, size_t destinationStride, size_t vertexCount) {
+	for (size_t i = 0; i < vertexCount; ++i) {
+		const float* value = reinterpret_cast<const float*>(source + i * sourceStride);
+		uint16_t packed[2] = { FloatToHalf(value[0]), FloatToHalf(value[1]) };
+		std::memcpy(destination + i * destinationStride, packed, sizeof(packed));
 	}
-	auto passit = m_passThroughCompressors.begin();
-	while (passit != m_passThroughCompressors.end()) {
-		if ((*passit)->IsSupported(element.semantic)) {
-			return passit->get();
-		}
-		++passit;
-	}
-	return nullptr;
 }
 
 
-void VertexCompressor::CreateDefaultCompressorList() {
-	// Compressors are checked in order.
-	// They shouldn't have overlapping capabilities.
-	
-	m_availableCompressors.push_back(std::make_unique<NormalCompressor>());
-	m_availableCompressors.push_back(std::make_unique<ColorCompressor>());	
+void VertexCompressor::Copy(const uint8_t* source, size_t sourceStride, uint8_t* destination, size_t destinationStride, size_t size, size_t vertexCount) {
+	for (size_t i = 0; i < vertexCount; ++i) {
+		std::memcpy(destination + i * destinationStride, source + i * sourceStride, size);
+	}
 }
 
 
 
-
-} // namespace inl::gxeng
\ No newline at end of file
+} // namespace inl::gxeng
@@ -1,77 +1,93 @@
 #pragma once
 
-#include <GraphicsEngine/Resources/Vertex.hpp>
-#include <memory>
-
-
-namespace inl::gxeng {
-
-
-class SemanticCompressor {
-public:
-	virtual ~SemanticCompressor() {}
+#include "BoundingVolumes.hpp"
 
-	virtual void Compress(const void* input, void* output) const = 0;
-	virtual int Size() const = 0;
-	virtual bool IsSupported(eVertexElementSemantic semantic) const = 0;
-};
+#include <GraphicsApi_LL/Common.hpp>
+#include <GraphicsEngine/Resources/Vertex.hpp>
 
+#include <cstdint>
+#include <vector>
 
-class NormalCompressor : public SemanticCompressor {
-public:
-	void Compress(const void* input, void* output) const override;
-	int Size() const override;
-	bool IsSupported(eVertexElementSemantic semantic) const override;
-};
 
+namespace inl::gxeng {
 
-class ColorCompressor : public SemanticCompressor {
-public:
-	void Compress(const void* input, void* output) const override;
-	int Size() const override;
-	bool IsSupported(eVertexElementSemantic semantic) const override;
-};
 
+/// <summary> Maps positions into the unit cube for 16-bit storage. </summary>
+/// <remarks> The scale is the same along each axis, so the dequantization can be folded into the world matrix
+///		without bending normals. </remarks>
+struct PositionQuantization {
+	Vec3 offset = { 0.0f, 0.0f, 0.0f };
+	float scale = 1.0f;
 
-class PassthroughCompressor : public SemanticCompressor {
-public:
-	void Setup(eVertexElementSemantic semantic, const IVertexReader* reader);
+	/// <summary> Covers the box, with its lower corner at 0. </summary>
+	static PositionQuantization FromBounds(const BoundingBox& bounds);
 
-	void Compress(const void* input, void* output) const override;
-	int Size() const override;
-	bool IsSupported(eVertexElementSemantic semantic) const override;
-private:
-	int m_stride = 0;
+	/// <summary> Transforms quantized positions back into object space. Multiply it before the world matrix. </summary>
+	Mat44 GetDequantization() const;
 };
 
 
-
-
-
+/// <summary> Converts vertices into the compact format of the GPU buffers. </summary>
+/// <remarks>
+/// Positions are 16-bit unsigned normalized relative to a <see cref="PositionQuantization"/>,
+/// normals, tangents and bitangents are octahedral 16-bit signed normalized, texture coordinates are half floats.
+/// The rest is copied as is. <para/>
+/// How each element is converted is decided once for the layout, then the elements are converted one after the other
+/// for all vertices at once.
+/// </remarks>
 class VertexCompressor {
 public:
-	VertexCompressor(const IVertexReader* reader, const std::vector<bool>& elementMap);
+	VertexCompressor(const IVertexReader* reader, const std::vector<bool>& elementMap, const PositionQuantization& positionQuantization = {});
 
 	std::vector<uint8_t> GetCompressedStream(const VertexBase* vertices, size_t vertexCount) const;
+	/// <summary> Writes the compressed vertices to <paramref name="output"/>, which must hold vertexCount times the stride. </summary>
+	void Compress(const VertexBase* vertices, size_t vertexCount, void* output) const;
 	int GetCompressedStride() const;
+	/// <summary> The reader the compressor was made for, it only takes vertices of that layout. </summary>
+	const IVertexReader* GetReader() const { return m_reader; }
+	/// <summary> Offsets within the compressed vertex for each element of the reader, -1 for those left out. </summary>
 	std::vector<int> GetCompressedOffsets() const;
+	/// <summary> Format of each element of the reader in the compressed vertex, UNKNOWN for those left out. </summary>
+	std::vector<gxapi::eFormat> GetCompressedFormats() const;
 
-private:
-	SemanticCompressor* AssignCompressor(const IVertexReader::Element& element);
-	void CreateDefaultCompressorList();
+	/// <summary> Rounds to the nearest half float, out of range values become infinity. </summary>
+	static uint16_t FloatToHalf(float value);
+	static float HalfToFloat(uint16_t value);
+	/// <summary> Folds a unit vector onto the [-1, 1] square. </summary>
+	static Vec2 EncodeOctahedral(const Vec3& direction);
+	/// <summary> Same as the shaders, the result is normalized. </summary>
+	static Vec3 DecodeOctahedral(const Vec2& encoded);
 
 private:
-	struct CompressionElement {
+	enum class eOperation {
+		QUANTIZE_POSITION,
+		OCTAHEDRAL,
+		HALF2,
+		COPY,
+	};
+
+	struct Operation {
+		eOperation operation;
 		IVertexReader::Element sourceElement;
-		SemanticCompressor* assignedCompressor;
+		int readerIndex; // Index of the element in the reader's list.
+		int size; // Output size in bytes.
+		int offset; // Offset in the output vertex.
+		gxapi::eFormat format;
 	};
 
+	void QuantizePositions(const uint8_t* source, size_t sourceStride, uint8_t* destination, size_t destinationStride, size_t vertexCount) const;
+	static void EncodeOctahedrals(const uint8_t* source, size_t sourceStride, uint8_t* destination, size_t destinationStride, size_t vertexCount);
+	static void EncodeHalves(const uint8_t* source, size_t sourceStride, uint8_t* destination, size_t destinationStride, size_t vertexCount);
+	static void Copy(const uint8_t* source, size_t sourceStride, uint8_t* destination, size_t destinationStride, size_t size, size_t vertexCount);
+
+private:
 	const IVertexReader* m_reader;
-	std::vector<CompressionElement> m_elementsToCompress;
-	std::vector<std::unique_ptr<SemanticCompressor>> m_availableCompressors;
-	std::vector<std::unique_ptr<PassthroughCompressor>> m_passThroughCompressors;
+	size_t m_elementCount;
+	std::vector<Operation> m_operations;
+	int m_stride = 0;
+	PositionQuantization m_positionQuantization;
 };
 
 
 
-} // namespace inl::gxeng
\ No newline at end of file
+} // namespace inl::gxeng
@@ -0,0 +1,55 @@
+#include "ViewSet.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+
+namespace inl::gxeng {
+
+
+void ViewSet::Clear() {
+	m_views.clear();
+	m_masks.clear();
+}
+
+
+void ViewSet::AddView(const BasicCamera* camera, float left, float top, float width, float height) {
+	if (m_views.size() >= MaxViews) {
+		throw InvalidArgumentException("Too many views.", std::to_string(MaxViews) + " are supported.");
+	}
+	m_views.push_back({ camera, left, top, width, height });
+}
+
+
+void ViewSet::AddSplitScreen(const BasicCamera* const* cameras, size_t count) {
+	switch (count) {
+		case 0: break;
+		case 1: AddView(cameras[0], 0.0f, 0.0f, 1.0f, 1.0f); break;
+		case 2:
+			AddView(cameras[0], 0.0f, 0.0f, 0.5f, 1.0f);
+			AddView(cameras[1], 0.5f, 0.0f, 0.5f, 1.0f);
+			break;
+		default:
+			for (size_t i = 0; i < count; ++i) {
+				AddView(cameras[i], 0.5f * float(i % 2), 0.5f * float(i / 2), 0.5f, 0.5f);
+			}
+	}
+}
+
+
+void ViewSet::ReserveMasks(size_t entityCount) {
+	m_masks.reserve(entityCount);
+}
+
+
+void ViewSet::SetMask(const MeshEntity* entity, uint32_t mask) {
+	m_masks[entity] = mask;
+}
+
+
+uint32_t ViewSet::GetMask(const MeshEntity* entity) const {
+	auto it = m_masks.find(entity);
+	return it != m_masks.end() ? it->second : AllViews;
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+class BasicCamera;
+class MeshEntity;
+
+
+/// <summary>
+/// Cameras rendered by the same pass into different regions of one target, like split screen players
+/// or a picture-in-picture mirror, and which of the cameras see each entity.
+/// </summary>
+/// <remarks> Culling tests every entity against all views at once and fills in the masks.
+///		Drawing nodes then sort and batch the entities once, and draw each batch for the views in its mask. </remarks>
+class ViewSet {
+public:
+	struct View {
+		const BasicCamera* camera;
+		// Region of the target as fractions of its size.
+		float left, top, width, height;
+	};
+
+	static constexpr size_t MaxViews = 4;
+	/// <summary> Bit i of a mask stands for view i. </summary>
+	static constexpr uint32_t AllViews = (1u << MaxViews) - 1;
+
+	void Clear();
+	/// <summary> Adds a view drawn into the given region of the target. </summary>
+	/// <exception cref="InvalidArgumentException"> If there are <see cref="MaxViews"/> views already. </exception>
+	void AddView(const BasicCamera* camera, float left, float top, float width, float height);
+	/// <summary> Adds the cameras as split screen views. One fills the target, two are side by side, three or four share its quarters. </summary>
+	void AddSplitScreen(const BasicCamera* const* cameras, size_t count);
+
+	size_t GetViewCount() const { return m_views.size(); }
+	const View& operator[](size_t index) const { return m_views[index]; }
+
+	void ReserveMasks(size_t entityCount);
+	void SetMask(const MeshEntity* entity, uint32_t mask);
+	/// <summary> The views that see the entity. Entities the set was not culled for are in all views. </summary>
+	uint32_t GetMask(const MeshEntity* entity) const;
+
+private:
+	std::vector<View> m_views;
+	std::unordered_map<const MeshEntity*, uint32_t> m_masks;
+};
+
+
+} // namespace inl::gxeng
@@ -5,21 +5,34 @@ namespace inl {
 namespace gxeng {
 
 
-VolatileViewHeap::VolatileViewHeap(gxapi::IGraphicsApi* graphicsApi) :
+VolatileViewHeap::VolatileViewHeap(gxapi::IGraphicsApi* graphicsApi, ScratchSpacePool* pool) :
 	m_graphicsApi(graphicsApi),
+	m_pool(pool),
 	m_nextPos(0)
 {}
 
 
+VolatileViewHeap::~VolatileViewHeap() {
+	if (m_pool) {
+		m_pool->RecycleViewPages(std::move(m_heaps));
+	}
+}
+
+
 gxapi::DescriptorHandle VolatileViewHeap::Allocate() {
 	size_t heapId = m_nextPos / HEAP_SIZE;
 	size_t descriptorIndex = m_nextPos % HEAP_SIZE;
 	if (heapId >= m_heaps.size()) {
-		m_heaps.push_back(
-			std::unique_ptr<gxapi::IDescriptorHeap>(
-				m_graphicsApi->CreateDescriptorHeap({ gxapi::eDescriptorHeapType::CBV_SRV_UAV, HEAP_SIZE, false })
-			)
-		);
+		if (m_pool) {
+			m_heaps.push_back(m_pool->RequestViewPage());
+		}
+		else {
+			m_heaps.push_back(
+				std::unique_ptr<gxapi::IDescriptorHeap>(
+					m_graphicsApi->CreateDescriptorHeap({ gxapi::eDescriptorHeapType::CBV_SRV_UAV, HEAP_SIZE, false })
+				)
+			);
+		}
 	}
 	m_nextPos += 1;
 	return m_heaps[heapId]->At(descriptorIndex);
@@ -4,6 +4,7 @@
 #include "../BaseLibrary/Memory/SlabAllocatorEngine.hpp"
 #include "../GraphicsApi_LL/IGraphicsApi.hpp"
 #include "../GraphicsApi_LL/IDescriptorHeap.hpp"
+#include "ScratchSpacePool.hpp"
 
 namespace inl {
 namespace gxeng {
@@ -14,18 +15,25 @@ namespace gxeng {
 /// allow a pipeline node to easily create views for volatile resources
 /// like a volatile constant buffer.
 /// <para/>
+/// With a pool, descriptor heaps are taken from and given back to it instead of being created and destroyed.
+/// The heap must only be destroyed when the GPU has finished with the descriptors.
+/// <para/>
 /// This class is NOT thread safe.
 /// </summary>
 class VolatileViewHeap {
 public:
-	VolatileViewHeap(gxapi::IGraphicsApi* graphicsApi);
+	VolatileViewHeap(gxapi::IGraphicsApi* graphicsApi, ScratchSpacePool* pool = nullptr);
+	VolatileViewHeap(const VolatileViewHeap&) = delete;
+	VolatileViewHeap& operator=(const VolatileViewHeap&) = delete;
+	~VolatileViewHeap();
 
 	gxapi::DescriptorHandle Allocate();
 
 private:
-	static constexpr size_t HEAP_SIZE = 128;
+	static constexpr size_t HEAP_SIZE = ScratchSpacePool::VIEW_PAGE_SIZE;
 
 	gxapi::IGraphicsApi* m_graphicsApi;
+	ScratchSpacePool* m_pool;
 	size_t m_nextPos;
 	std::vector<std::unique_ptr<gxapi::IDescriptorHeap>> m_heaps;
 };
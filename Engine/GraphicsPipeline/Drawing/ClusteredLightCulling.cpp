@@ -0,0 +1,311 @@
+#include "ClusteredLightCulling.hpp"
+
+#include <GraphicsEngine_LL/Nodes/NodeUtility.hpp>
+
+#include <GraphicsEngine_LL/AutoRegisterNode.hpp>
+#include <GraphicsEngine_LL/ComputeCommandList.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace inl::gxeng::nodes {
+
+
+INL_REGISTER_GRAPHICS_NODE(ClusteredLightCulling)
+
+
+namespace {
+
+// Layout must match ClusteredLightCulling.hlsl.
+struct Uniforms {
+	uint32_t countX, countY, countZ, tileSize;
+	Vec2_Packed screenSize;
+	Vec2_Packed projectionScale;
+	float nearPlane;
+	float sliceLogStep; // log2 of the ratio of the far and near depth of a slice.
+	uint32_t numLights;
+	uint32_t indexCapacity;
+};
+
+} // namespace
+
+static_assert(sizeof(ClusteredLightCulling::LightData) == 64, "Must match shaders.");
+
+static constexpr unsigned CullGroupSize = 64;
+static constexpr uint32_t TileSize = 64;
+static constexpr uint32_t SliceCount = 24;
+static constexpr uint32_t AverageLightsPerCluster = 32; // Sizes the index lists, longer lists are cut short.
+static constexpr size_t MinLightCapacity = 64;
+
+
+/// <summary> Smallest sphere around the cone of a spot light. </summary>
+static Vec4 GetConeBounds(const Vec3& apex, const Vec3& direction, float range, float cosOuter) {
+	// Wide cones are bounded by their cap, narrow ones by the sphere through the apex and the rim of the cap.
+	if (cosOuter < Constants<float>::SqrtHalf) {
+		float sinOuter = std::sqrt(std::max(0.0f, 1.0f - cosOuter * cosOuter));
+		return Vec4(apex + direction * (range * cosOuter), range * sinOuter);
+	}
+	float radius = range / (2.0f * cosOuter);
+	return Vec4(apex + direction * radius, radius);
+}
+
+
+ClusteredLightCulling::ClusteredLightCulling() {
+	this->GetInput<0>().Set({});
+}
+
+
+void ClusteredLightCulling::Initialize(EngineContext& context) {
+	GraphicsNode::SetTaskSingle(this);
+}
+
+
+void ClusteredLightCulling::Reset() {
+	m_camera = nullptr;
+	m_lights.clear();
+
+	GetInput<0>().Clear();
+	GetInput<1>().Clear();
+	GetInput<2>().Clear();
+	GetInput<3>().Clear();
+}
+
+
+const std::string& ClusteredLightCulling::GetInputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"depthTex",
+		"camera",
+		"pointLights",
+		"spotLights",
+	};
+	return names[index];
+}
+
+
+const std::string& ClusteredLightCulling::GetOutputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"lightClusters"
+	};
+	return names[index];
+}
+
+
+void ClusteredLightCulling::Setup(SetupContext& context) {
+	Texture2D depthTex = this->GetInput<0>().Get();
+	m_camera = this->GetInput<1>().Get();
+	if (!m_camera) {
+		throw InvalidArgumentException("Lights cannot be culled without a valid camera.");
+	}
+
+	if (depthTex.GetWidth() != m_width || depthTex.GetHeight() != m_height) {
+		m_width = depthTex.GetWidth();
+		m_height = depthTex.GetHeight();
+		InitClusters(context, m_width, m_height);
+	}
+
+	// The slicing follows the camera.
+	const float nearPlane = m_camera->GetNearPlane();
+	const float sliceLogStep = std::log2(m_camera->GetFarPlane() / nearPlane) / SliceCount;
+	m_clusters.depthScale = 1.0f / sliceLogStep;
+	m_clusters.depthBias = -std::log2(nearPlane) / sliceLogStep;
+
+	CollectLights(*m_camera, this->GetInput<2>().Get(), this->GetInput<3>().Get());
+	ReserveLights(context, m_lights.size());
+
+	if (!m_binder) {
+		BindParameterDesc uniformsBindParamDesc;
+		m_uniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
+		uniformsBindParamDesc.parameter = m_uniformsBindParam;
+		uniformsBindParamDesc.constantSize = sizeof(Uniforms);
+		uniformsBindParamDesc.relativeAccessFrequency = 0;
+		uniformsBindParamDesc.relativeChangeFrequency = 0;
+		uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc lightsBindParamDesc;
+		m_lightsBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		lightsBindParamDesc.parameter = m_lightsBindParam;
+		lightsBindParamDesc.constantSize = 0;
+		lightsBindParamDesc.relativeAccessFrequency = 0;
+		lightsBindParamDesc.relativeChangeFrequency = 0;
+		lightsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc clustersBindParamDesc = lightsBindParamDesc;
+		m_clustersBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		clustersBindParamDesc.parameter = m_clustersBindParam;
+
+		BindParameterDesc lightIndicesBindParamDesc = lightsBindParamDesc;
+		m_lightIndicesBindParam = BindParameter(eBindParameterType::UNORDERED, 1);
+		lightIndicesBindParamDesc.parameter = m_lightIndicesBindParam;
+
+		BindParameterDesc indexCountBindParamDesc = lightsBindParamDesc;
+		m_indexCountBindParam = BindParameter(eBindParameterType::UNORDERED, 2);
+		indexCountBindParamDesc.parameter = m_indexCountBindParam;
+
+		m_binder = context.CreateBinder({ uniformsBindParamDesc, lightsBindParamDesc, clustersBindParamDesc, lightIndicesBindParamDesc, indexCountBindParamDesc });
+	}
+
+	if (!m_CSO) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_shader = context.CreateShader("ClusteredLightCulling", shaderParts, "");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_binder.GetRootSignature();
+		csoDesc.cs = m_shader.cs;
+
+		m_CSO.reset(context.CreatePSO(csoDesc));
+	}
+
+	this->GetOutput<0>().Set(m_clusters);
+}
+
+
+void ClusteredLightCulling::Execute(RenderContext& context) {
+	ComputeCommandList& commandList = context.AsCompute();
+
+	const Mat44 projection = m_camera->GetProjectionMatrix();
+
+	Uniforms uniforms;
+	uniforms.countX = m_clusters.countX;
+	uniforms.countY = m_clusters.countY;
+	uniforms.countZ = m_clusters.countZ;
+	uniforms.tileSize = m_clusters.tileSize;
+	uniforms.screenSize = Vec2((float)m_width, (float)m_height);
+	uniforms.projectionScale = Vec2(projection(0, 0), projection(1, 1));
+	uniforms.nearPlane = m_camera->GetNearPlane();
+	uniforms.sliceLogStep = 1.0f / m_clusters.depthScale;
+	uniforms.numLights = (uint32_t)m_lights.size();
+	uniforms.indexCapacity = m_clusters.indexCapacity;
+	const uint32_t zero = 0;
+
+	if (!m_lights.empty()) {
+		commandList.SetResourceState(m_clusters.lights, gxapi::eResourceState::COPY_DEST);
+		context.Upload(m_clusters.lights, 0, m_lights.data(), m_lights.size() * sizeof(LightData));
+	}
+	commandList.SetResourceState(m_indexCountBuffer, gxapi::eResourceState::COPY_DEST);
+	context.Upload(m_indexCountBuffer, 0, &zero, sizeof(zero));
+
+	commandList.SetResourceState(m_clusters.lights, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
+	commandList.SetResourceState(m_clusters.clusters, gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_clusters.lightIndices, gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_indexCountBuffer, gxapi::eResourceState::UNORDERED_ACCESS);
+
+	commandList.SetPipelineState(m_CSO.get());
+	commandList.SetComputeBinder(&m_binder);
+	commandList.BindCompute(m_uniformsBindParam, &uniforms, sizeof(uniforms));
+	commandList.BindCompute(m_lightsBindParam, m_lightsView);
+	commandList.BindCompute(m_clustersBindParam, m_clustersView);
+	commandList.BindCompute(m_lightIndicesBindParam, m_lightIndicesView);
+	commandList.BindCompute(m_indexCountBindParam, m_indexCountView);
+	commandList.Dispatch((m_clusters.GetClusterCount() + CullGroupSize - 1) / CullGroupSize, 1, 1);
+	commandList.UAVBarrier(m_clusters.clusters);
+	commandList.UAVBarrier(m_clusters.lightIndices);
+}
+
+
+void ClusteredLightCulling::CollectLights(const BasicCamera& camera, const EntityCollection<PointLight>* pointLights, const EntityCollection<SpotLight>* spotLights) {
+	const Mat44 view = camera.GetViewMatrix();
+
+	m_lights.clear();
+	m_lights.reserve((pointLights ? pointLights->Size() : 0) + (spotLights ? spotLights->Size() : 0));
+
+	if (pointLights) {
+		for (const PointLight* light : *pointLights) {
+			LightData data;
+			data.vsPosition = (Vec4(light->GetPosition(), 1.0f) * view).xyz;
+			data.range = light->GetRange();
+			data.color = light->GetColor();
+			data.spotCosOuter = -1.0f;
+			data.vsDirection = Vec3(0.0f, 0.0f, 1.0f);
+			data.spotCosInner = -1.0f;
+			data.boundsCenter = data.vsPosition;
+			data.boundsRadius = data.range;
+			m_lights.push_back(data);
+		}
+	}
+
+	if (spotLights) {
+		for (const SpotLight* light : *spotLights) {
+			LightData data;
+			Vec3 vsPosition = (Vec4(light->GetPosition(), 1.0f) * view).xyz;
+			Vec3 vsDirection = Vec3((Vec4(light->GetDirection(), 0.0f) * view).xyz).Normalized();
+			float cosOuter = std::cos(light->GetOuterAngle());
+			Vec4 bounds = GetConeBounds(vsPosition, vsDirection, light->GetRange(), cosOuter);
+
+			data.vsPosition = vsPosition;
+			data.range = light->GetRange();
+			data.color = light->GetColor();
+			data.spotCosOuter = cosOuter;
+			data.vsDirection = vsDirection;
+			data.spotCosInner = std::max(std::cos(light->GetInnerAngle()), cosOuter + 1e-3f); // No division by zero in the falloff.
+			data.boundsCenter = bounds.xyz;
+			data.boundsRadius = bounds.w;
+			m_lights.push_back(data);
+		}
+	}
+}
+
+
+void ClusteredLightCulling::InitClusters(SetupContext& context, uint64_t width, uint64_t height) {
+	m_clusters.tileSize = TileSize;
+	m_clusters.countX = uint32_t((width + TileSize - 1) / TileSize);
+	m_clusters.countY = uint32_t((height + TileSize - 1) / TileSize);
+	m_clusters.countZ = SliceCount;
+
+	const uint32_t clusterCount = std::max(1u, m_clusters.GetClusterCount());
+	m_clusters.indexCapacity = clusterCount * AverageLightsPerCluster;
+
+	m_clusters.clusters = context.CreateBuffer(clusterCount * 2 * sizeof(uint32_t), true);
+	m_clusters.clusters.SetName("Light clusters");
+	m_clusters.lightIndices = context.CreateBuffer(m_clusters.indexCapacity * sizeof(uint32_t), true);
+	m_clusters.lightIndices.SetName("Light cluster indices");
+
+	gxapi::UavBuffer structuredDesc;
+	structuredDesc.raw = false;
+	structuredDesc.firstElement = 0;
+	structuredDesc.countOffset = 0;
+
+	structuredDesc.numElements = clusterCount;
+	structuredDesc.elementStride = 2 * sizeof(uint32_t);
+	m_clustersView = context.CreateUav(m_clusters.clusters, gxapi::eFormat::UNKNOWN, structuredDesc);
+	structuredDesc.numElements = m_clusters.indexCapacity;
+	structuredDesc.elementStride = sizeof(uint32_t);
+	m_lightIndicesView = context.CreateUav(m_clusters.lightIndices, gxapi::eFormat::UNKNOWN, structuredDesc);
+
+	if (!m_indexCountBuffer) {
+		m_indexCountBuffer = context.CreateBuffer(sizeof(uint32_t), true);
+		m_indexCountBuffer.SetName("Light cluster index count");
+
+		gxapi::UavBuffer countDesc;
+		countDesc.raw = false;
+		countDesc.firstElement = 0;
+		countDesc.numElements = 1;
+		countDesc.elementStride = 0;
+		countDesc.countOffset = 0;
+		m_indexCountView = context.CreateUav(m_indexCountBuffer, gxapi::eFormat::R32_UINT, countDesc);
+	}
+}
+
+
+void ClusteredLightCulling::ReserveLights(SetupContext& context, size_t count) {
+	if (m_clusters.lights && count <= m_clusters.lightCapacity) {
+		return;
+	}
+
+	// Grows geometrically, the lights are uploaded again every frame anyway.
+	m_clusters.lightCapacity = (uint32_t)std::max(count, std::max(2 * size_t(m_clusters.lightCapacity), MinLightCapacity));
+	m_clusters.lights = context.CreateBuffer(m_clusters.lightCapacity * sizeof(LightData));
+	m_clusters.lights.SetName("Clustered lights");
+
+	gxapi::SrvBuffer desc;
+	desc.firstElement = 0;
+	desc.numElements = m_clusters.lightCapacity;
+	desc.structureStrideInBytes = sizeof(LightData);
+	desc.isRaw = false;
+	m_lightsView = context.CreateSrv(m_clusters.lights, gxapi::eFormat::UNKNOWN, desc);
+}
+
+
+} // namespace inl::gxeng::nodes
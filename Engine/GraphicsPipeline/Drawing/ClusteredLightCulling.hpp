@@ -0,0 +1,104 @@
+#pragma once
+
+#include <GraphicsApi_LL/IPipelineState.hpp>
+#include <GraphicsEngine_LL/BasicCamera.hpp>
+#include <GraphicsEngine_LL/GraphicsNode.hpp>
+#include <GraphicsEngine_LL/PointLight.hpp>
+#include <GraphicsEngine_LL/SpotLight.hpp>
+
+#include <vector>
+
+namespace inl::gxeng::nodes {
+
+
+/// <summary> Lights of the view sorted into the cells of a 3D grid over the view frustum. </summary>
+/// <remarks>
+/// Cells are screen tiles of <see cref="tileSize"/> pixels, sliced exponentially along the view depth.
+/// The slice of a view depth z is floor(log2(z) * depthScale + depthBias).
+/// Cells are numbered x first, then y from the top of the screen, then the slice.
+/// </remarks>
+struct LightClusters {
+	LinearBuffer lights; // StructuredBuffer of ClusteredLightCulling::LightData, in view space.
+	LinearBuffer clusters; // StructuredBuffer<uint2> of the first index and the number of lights of each cell.
+	LinearBuffer lightIndices; // StructuredBuffer<uint> of the lists of all cells, one after the other.
+	uint32_t lightCapacity = 0;
+	uint32_t indexCapacity = 0;
+	uint32_t countX = 0, countY = 0, countZ = 0;
+	uint32_t tileSize = 0;
+	float depthScale = 0.0f;
+	float depthBias = 0.0f;
+
+	uint32_t GetClusterCount() const { return countX * countY * countZ; }
+};
+
+
+/// <summary>
+/// Inputs: depth texture, camera, point lights, spot lights
+/// </summary>
+/// <remarks>
+/// Builds the light list of every cell of the view frustum in compute, see <see cref="LightClusters"/>.
+/// Lights are culled by their bounding spheres, so the cost of shading a pixel only depends on the lights near it.
+/// Only the size of the depth texture is used, it decides the number of tiles.
+/// </remarks>
+class ClusteredLightCulling : virtual public GraphicsNode,
+							  virtual public GraphicsTask,
+							  virtual public InputPortConfig<Texture2D, const BasicCamera*, const EntityCollection<PointLight>*, const EntityCollection<SpotLight>*>,
+							  virtual public OutputPortConfig<LightClusters> {
+public:
+	// One light, layout must match ClusteredLightCulling.hlsl and LightingUniforms.hlsl.
+	struct LightData {
+		Vec3_Packed vsPosition;
+		float range;
+		Vec3_Packed color;
+		float spotCosOuter; // -1 for point lights.
+		Vec3_Packed vsDirection;
+		float spotCosInner;
+		Vec3_Packed boundsCenter;
+		float boundsRadius;
+	};
+
+public:
+	static const char* Info_GetName() { return "ClusteredLightCulling"; }
+	const std::string& GetInputName(size_t index) const override;
+	const std::string& GetOutputName(size_t index) const override;
+	ClusteredLightCulling();
+
+	void Update() override {}
+	void Notify(InputPortBase* sender) override {}
+
+	void Initialize(EngineContext& context) override;
+	void Reset() override;
+	void Setup(SetupContext& context) override;
+	void Execute(RenderContext& context) override;
+
+private:
+	void CollectLights(const BasicCamera& camera, const EntityCollection<PointLight>* pointLights, const EntityCollection<SpotLight>* spotLights);
+	void InitClusters(SetupContext& context, uint64_t width, uint64_t height);
+	void ReserveLights(SetupContext& context, size_t count);
+
+private:
+	Binder m_binder;
+	BindParameter m_uniformsBindParam;
+	BindParameter m_lightsBindParam;
+	BindParameter m_clustersBindParam;
+	BindParameter m_lightIndicesBindParam;
+	BindParameter m_indexCountBindParam;
+	ShaderProgram m_shader;
+	std::unique_ptr<gxapi::IPipelineState> m_CSO;
+
+	const BasicCamera* m_camera = nullptr;
+	std::vector<LightData> m_lights;
+
+	LightClusters m_clusters;
+	LinearBuffer m_indexCountBuffer;
+	BufferView m_lightsView;
+	RWBufferView m_clustersView;
+	RWBufferView m_lightIndicesView;
+	RWBufferView m_indexCountView;
+
+	uint64_t m_width = 0;
+	uint64_t m_height = 0;
+};
+
+
+} // namespace inl::gxeng::nodes
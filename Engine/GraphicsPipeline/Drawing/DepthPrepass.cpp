@@ -7,6 +7,7 @@
 #include <GraphicsEngine_LL/Mesh.hpp>
 #include <GraphicsEngine_LL/MeshEntity.hpp>
 
+#include <algorithm>
 
 
 namespace inl::gxeng::nodes {
@@ -20,11 +21,11 @@ static bool CheckMeshFormat(const Mesh& mesh) {
 		auto& elements = mesh.GetLayout()[0];
 		if (elements.size() != 3)
 			return false;
-		if (elements[0].semantic != eVertexElementSemantic::POSITION)
+		if (elements[0].semantic != eVertexElementSemantic::POSITION || elements[0].format != gxapi::eFormat::R16G16B16A16_UNORM)
 			return false;
-		if (elements[1].semantic != eVertexElementSemantic::NORMAL)
+		if (elements[1].semantic != eVertexElementSemantic::NORMAL || elements[1].format != gxapi::eFormat::R16G16_SNORM)
 			return false;
-		if (elements[2].semantic != eVertexElementSemantic::TEX_COORD)
+		if (elements[2].semantic != eVertexElementSemantic::TEX_COORD || elements[2].format != gxapi::eFormat::R16G16_FLOAT)
 			return false;
 	}
 
@@ -32,29 +33,36 @@ static bool CheckMeshFormat(const Mesh& mesh) {
 }
 
 
-static void ConvertToSubmittable(
-	Mesh* mesh,
-	std::vector<const gxeng::VertexBuffer*>& vertexBuffers,
-	std::vector<unsigned>& sizes,
-	std::vector<unsigned>& strides) {
-	vertexBuffers.clear();
-	sizes.clear();
-	strides.clear();
+namespace {
 
-	for (int streamID = 0; streamID < mesh->GetNumStreams(); streamID++) {
-		vertexBuffers.push_back(&mesh->GetVertexBuffer(streamID));
-		sizes.push_back((unsigned)vertexBuffers.back()->GetSize());
-		strides.push_back((unsigned)mesh->GetVertexBufferStride(streamID));
-	}
+// One ExecuteIndirect command, layout must match DepthPrepassCull.hlsl.
+struct DrawCommand {
+	Mat44_Packed MVP; // Root constants of the transform
+	gxapi::VertexBufferViewArguments vertexBuffer;
+	gxapi::IndexBufferViewArguments indexBuffer;
+	gxapi::DrawIndexedArguments draw;
+	uint32_t padding; // Keeps the 64 bit addresses of the next command aligned.
+};
+static_assert(sizeof(DrawCommand) == 120, "Must match command signature.");
 
-	assert(vertexBuffers.size() == sizes.size());
-	assert(sizes.size() == strides.size());
-}
+struct CullUniforms {
+	Mat44_Packed viewProjection;
+	Vec3_Packed cameraPosition;
+	uint32_t numObjects;
+	uint32_t numGroupsX; // Objects past the limit of a dispatch dimension wrap into rows.
+};
+
+} // namespace
+
+static constexpr unsigned CullGroupSize = 64;
+static constexpr unsigned MaxDispatchGroups = 65535;
 
 
 
 DepthPrepass::DepthPrepass() {
 	this->GetInput<0>().Set({});
+	this->GetInput<3>().Set(false);
+	this->GetInput<4>().Set(0.1f);
 }
 
 
@@ -64,6 +72,23 @@ void DepthPrepass::Initialize(EngineContext& context) {
 
 void DepthPrepass::Reset() {
 	m_targetDsv = {};
+	m_objectView = {};
+	m_commandView = {};
+	m_commandCountView = {};
+	m_objectBuffer = {};
+	m_commandBuffer = {};
+	m_commandCountBuffer = {};
+	m_capacity = 0;
+	m_commandCapacity = 0;
+	m_numCommands = 0;
+	m_objects.clear();
+	m_drawnEntities.clear();
+	m_meshletRanges.clear();
+	m_meshlets.clear();
+	m_meshletsDirty = false;
+	m_meshletCapacity = 0;
+	m_meshletBuffer = {};
+	m_meshletView = {};
 	GetInput(0)->Clear();
 	GetInput(1)->Clear();
 	GetInput(2)->Clear();
@@ -85,6 +110,9 @@ void DepthPrepass::Setup(SetupContext& context) {
 
 	this->GetOutput<0>().Set(depthStencil);
 
+	m_adaptive = this->GetInput<3>().Get();
+	m_minOccluderCoverage = this->GetInput<4>().Get();
+
 	if (!m_binder) {
 		BindParameterDesc transformBindParamDesc;
 		m_transformBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
@@ -126,9 +154,9 @@ void DepthPrepass::Setup(SetupContext& context) {
 		m_depthStencilFormat = currDepthStencilFormat;
 
 		std::vector<gxapi::InputElementDesc> inputElementDesc = {
-			gxapi::InputElementDesc("POSITION", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 0),
-			gxapi::InputElementDesc("NORMAL", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 12),
-			gxapi::InputElementDesc("TEX_COORD", 0, gxapi::eFormat::R32G32_FLOAT, 0, 24),
+			gxapi::InputElementDesc("POSITION", 0, gxapi::eFormat::R16G16B16A16_UNORM, 0, 0),
+			gxapi::InputElementDesc("NORMAL", 0, gxapi::eFormat::R16G16_SNORM, 0, 8),
+			gxapi::InputElementDesc("TEX_COORD", 0, gxapi::eFormat::R16G16_FLOAT, 0, 12),
 		};
 
 		gxapi::GraphicsPipelineStateDesc psoDesc;
@@ -147,6 +175,257 @@ void DepthPrepass::Setup(SetupContext& context) {
 
 		m_PSO.reset(context.CreatePSO(psoDesc));
 	}
+
+	SetupCulling(context);
+
+	m_objects.clear();
+	m_drawnEntities.clear();
+	if (auto* entities = this->GetInput<2>().Get()) {
+		UpdateObjects(context, *entities, this->GetInput<1>().Get());
+	}
+}
+
+
+void DepthPrepass::SetupCulling(SetupContext& context) {
+	if (!m_cullBinder) {
+		BindParameterDesc uniformsBindParamDesc;
+		m_cullUniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
+		uniformsBindParamDesc.parameter = m_cullUniformsBindParam;
+		uniformsBindParamDesc.constantSize = sizeof(CullUniforms);
+		uniformsBindParamDesc.relativeAccessFrequency = 0;
+		uniformsBindParamDesc.relativeChangeFrequency = 0;
+		uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc objectsBindParamDesc;
+		m_objectsBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		objectsBindParamDesc.parameter = m_objectsBindParam;
+		objectsBindParamDesc.constantSize = 0;
+		objectsBindParamDesc.relativeAccessFrequency = 0;
+		objectsBindParamDesc.relativeChangeFrequency = 0;
+		objectsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc commandsBindParamDesc = objectsBindParamDesc;
+		m_commandsBindParam = BindParameter(eBindParameterType::UNORDERED, 1);
+		commandsBindParamDesc.parameter = m_commandsBindParam;
+
+		BindParameterDesc commandCountBindParamDesc = objectsBindParamDesc;
+		m_commandCountBindParam = BindParameter(eBindParameterType::UNORDERED, 2);
+		commandCountBindParamDesc.parameter = m_commandCountBindParam;
+
+		BindParameterDesc meshletsBindParamDesc = objectsBindParamDesc;
+		m_meshletsBindParam = BindParameter(eBindParameterType::UNORDERED, 3);
+		meshletsBindParamDesc.parameter = m_meshletsBindParam;
+
+		m_cullBinder = context.CreateBinder({ uniformsBindParamDesc, objectsBindParamDesc, commandsBindParamDesc, commandCountBindParamDesc, meshletsBindParamDesc });
+	}
+
+	if (m_cullCSO == nullptr) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_cullShader = context.CreateShader("DepthPrepassCull", shaderParts, "");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_cullBinder.GetRootSignature();
+		csoDesc.cs = m_cullShader.cs;
+
+		m_cullCSO.reset(context.CreatePSO(csoDesc));
+	}
+
+	if (m_commandSignature == nullptr) {
+		// The transform must be an inline constant for the commands to set it.
+		int rootParamIndex, rootTableIndex;
+		m_binder.Translate(m_transformBindParam, rootParamIndex, rootTableIndex);
+		if (m_binder.GetRootSignatureDesc().rootParameters[rootParamIndex].type != gxapi::RootParameterDesc::CONSTANT) {
+			throw InvalidStateException("Depth prepass transform is not bound as root constants.");
+		}
+
+		gxapi::CommandSignatureDesc signatureDesc;
+		signatureDesc.byteStride = sizeof(DrawCommand);
+		signatureDesc.arguments = {
+			gxapi::IndirectArgumentDesc::Constant((unsigned)rootParamIndex, 0, sizeof(Mat44_Packed) / 4),
+			gxapi::IndirectArgumentDesc::VertexBufferView(0),
+			gxapi::IndirectArgumentDesc::IndexBufferView(),
+			gxapi::IndirectArgumentDesc::DrawIndexed(),
+		};
+		m_commandSignature.reset(context.CreateCommandSignature(signatureDesc, &m_binder));
+	}
+}
+
+
+void DepthPrepass::UpdateObjects(SetupContext& context, const EntityCollection<MeshEntity>& entities, const BasicCamera* camera) {
+	static_assert(sizeof(ObjectData) == 160, "Must match culling shader.");
+	static_assert(sizeof(Meshlet) == 40, "Must match culling shader.");
+
+	// Upload front to back, so that near occluders are drawn first and reject more of what follows.
+	// The culling shader compacts with atomics, so the order of the draws only roughly follows this.
+	m_renderQueue.Clear();
+	m_renderQueue.Reserve(entities.Size());
+	for (size_t i = 0; i < entities.Size(); ++i) {
+		float depth = camera ? Dot(entities[i]->GetPosition() - camera->GetPosition(), camera->GetLookDirection()) : 0.0f;
+		m_renderQueue.Add(RenderQueue::MakeKey(0, 0, 0, depth), uint32_t(i));
+	}
+	m_renderQueue.Sort(context.GetJobScheduler());
+
+	// Meshlets of new meshes are appended to the buffer, the ones no longer drawn are only dropped when it's full.
+	for (const RenderQueue::Item& item : m_renderQueue) {
+		GetMeshletOffset(*entities[item.index]->GetMesh());
+	}
+	if (m_meshlets.size() > m_meshletCapacity) {
+		m_meshletRanges.clear();
+		m_meshlets.clear();
+		for (const RenderQueue::Item& item : m_renderQueue) {
+			GetMeshletOffset(*entities[item.index]->GetMesh());
+		}
+	}
+	UpdateMeshletBuffer(context);
+
+	m_numCommands = 0;
+	m_objects.reserve(entities.Size());
+	m_drawnEntities.reserve(entities.Size());
+	for (const RenderQueue::Item& item : m_renderQueue) {
+		const MeshEntity* entity = entities[item.index];
+		const Mesh* mesh = entity->GetMesh();
+		if (m_adaptive && !IsOccluder(*entity, camera)) {
+			continue;
+		}
+		if (!CheckMeshFormat(*mesh)) {
+			assert(false);
+			continue;
+		}
+
+		const VertexBuffer& vertexBuffer = entity->GetVertexBuffer(0);
+		const IndexBuffer& indexBuffer = mesh->GetIndexBuffer();
+		// Culling happens in the space of the quantized positions, where the world matrix starts.
+		const Mat44 dequantization = entity->GetPositionDequantization();
+		const Mat44 quantization = dequantization.Inverse();
+		const BoundingBox localBounds = entity->GetLocalBounds();
+		const BoundingBox bounds = localBounds.IsEmpty() ? BoundingBox{} : localBounds.Transformed(quantization);
+
+		// The view of the index buffer covers only the selected level of detail.
+		const Mesh::Lod& lod = mesh->GetLod(entity->GetLod());
+		const unsigned indexStride = mesh->IsIndexBuffer32Bit() ? sizeof(uint32_t) : sizeof(uint16_t);
+
+		ObjectData object;
+		object.world = dequantization * entity->GetTransform();
+		object.alwaysVisible = bounds.IsEmpty();
+		object.boundsCenter = object.alwaysVisible ? Vec3(0.0f) : bounds.GetCenter();
+		object.boundsExtent = object.alwaysVisible ? Vec3(0.0f) : bounds.GetExtent();
+		object.numIndices = lod.indexCount;
+		object.vertexBuffer.gpuVirtualAddress = (uint64_t)vertexBuffer.GetVirtualAddress();
+		object.vertexBuffer.sizeInBytes = (uint32_t)vertexBuffer.GetSize();
+		object.vertexBuffer.strideInBytes = (uint32_t)mesh->GetVertexBufferStride(0);
+		object.indexBuffer.gpuVirtualAddress = (uint64_t)indexBuffer.GetVirtualAddress() + uint64_t(lod.firstIndex) * indexStride;
+		object.indexBuffer.sizeInBytes = lod.indexCount * indexStride;
+		object.indexBuffer.format = (uint32_t)(mesh->IsIndexBuffer32Bit() ? gxapi::eFormat::R32_UINT : gxapi::eFormat::R16_UINT);
+		object.quantization = Vec4(quantization(3, 0), quantization(3, 1), quantization(3, 2), quantization(0, 0));
+		// Meshlets index the whole buffer, draws start relative to the view of the level.
+		// Their bounds and cones are of the bind pose, skinned entities are drawn whole.
+		const uint32_t meshletCount = entity->HasSkinnedVertices() ? 0 : lod.meshletCount;
+		object.firstIndex = lod.firstIndex;
+		object.firstMeshlet = GetMeshletOffset(*mesh) + lod.firstMeshlet;
+		object.meshletCount = meshletCount;
+		object.padding = 0;
+		m_objects.push_back(object);
+		m_drawnEntities.push_back(entity);
+		m_numCommands += std::max(meshletCount, 1u);
+	}
+
+	// Grow the GPU buffers geometrically.
+	gxapi::UavBuffer structuredDesc;
+	structuredDesc.raw = false;
+	structuredDesc.firstElement = 0;
+	structuredDesc.countOffset = 0;
+
+	if (m_numCommands > m_commandCapacity) {
+		m_commandCapacity = std::max(m_numCommands, std::max(m_commandCapacity * 2, size_t(CullGroupSize)));
+
+		m_commandBuffer = context.CreateBuffer(m_commandCapacity * sizeof(DrawCommand), true);
+		m_commandBuffer.SetName("Depth prepass draw commands");
+
+		structuredDesc.numElements = (unsigned)m_commandCapacity;
+		structuredDesc.elementStride = sizeof(DrawCommand);
+		m_commandView = context.CreateUav(m_commandBuffer, gxapi::eFormat::UNKNOWN, structuredDesc);
+	}
+
+	if (m_objects.size() > m_capacity) {
+		m_capacity = std::max(m_objects.size(), std::max(m_capacity * 2, size_t(CullGroupSize)));
+
+		m_objectBuffer = context.CreateBuffer(m_capacity * sizeof(ObjectData), true);
+		m_objectBuffer.SetName("Depth prepass objects");
+		m_commandCountBuffer = context.CreateBuffer(sizeof(uint32_t), true);
+		m_commandCountBuffer.SetName("Depth prepass draw count");
+
+		structuredDesc.numElements = (unsigned)m_capacity;
+		structuredDesc.elementStride = sizeof(ObjectData);
+		m_objectView = context.CreateUav(m_objectBuffer, gxapi::eFormat::UNKNOWN, structuredDesc);
+
+		gxapi::UavBuffer countDesc;
+		countDesc.raw = false;
+		countDesc.firstElement = 0;
+		countDesc.numElements = 1;
+		countDesc.elementStride = 0;
+		countDesc.countOffset = 0;
+		m_commandCountView = context.CreateUav(m_commandCountBuffer, gxapi::eFormat::R32_UINT, countDesc);
+	}
+}
+
+
+bool DepthPrepass::IsOccluder(const MeshEntity& entity, const BasicCamera* camera) const {
+	switch (entity.GetOccluderHint()) {
+		case eOccluderHint::ALWAYS: return true;
+		case eOccluderHint::NEVER: return false;
+		default: break;
+	}
+
+	const BoundingBox localBounds = entity.GetLocalBounds();
+	if (!camera || localBounds.IsEmpty()) {
+		return true;
+	}
+
+	// Screen coverage of the bounding sphere, as a part of the screen's height.
+	const BoundingBox bounds = localBounds.Transformed(entity.GetTransform());
+	const float radius = bounds.GetExtent().Length();
+	const float depth = Dot(bounds.GetCenter() - camera->GetPosition(), camera->GetLookDirection());
+	if (depth <= radius) {
+		return true; // The camera is inside or right next to it.
+	}
+	return radius * camera->GetProjectionMatrix()(1, 1) / depth >= m_minOccluderCoverage;
+}
+
+
+uint32_t DepthPrepass::GetMeshletOffset(const Mesh& mesh) {
+	const std::vector<Meshlet>& meshlets = mesh.GetMeshlets();
+	auto it = m_meshletRanges.find(&mesh);
+	if (it != m_meshletRanges.end() && it->second.data == meshlets.data() && it->second.count == meshlets.size()) {
+		return it->second.offset;
+	}
+
+	MeshletRange range{ uint32_t(m_meshlets.size()), meshlets.data(), meshlets.size() };
+	m_meshletRanges[&mesh] = range;
+	m_meshlets.insert(m_meshlets.end(), meshlets.begin(), meshlets.end());
+	m_meshletsDirty = m_meshletsDirty || !meshlets.empty();
+	return range.offset;
+}
+
+
+void DepthPrepass::UpdateMeshletBuffer(SetupContext& context) {
+	if (m_meshlets.size() <= m_meshletCapacity && m_meshletBuffer) {
+		return;
+	}
+
+	m_meshletCapacity = std::max(m_meshlets.size(), std::max(m_meshletCapacity * 2, size_t(CullGroupSize)));
+	m_meshletBuffer = context.CreateBuffer(m_meshletCapacity * sizeof(Meshlet), true);
+	m_meshletBuffer.SetName("Depth prepass meshlets");
+	m_meshletsDirty = true;
+
+	gxapi::UavBuffer structuredDesc;
+	structuredDesc.raw = false;
+	structuredDesc.firstElement = 0;
+	structuredDesc.numElements = (unsigned)m_meshletCapacity;
+	structuredDesc.elementStride = sizeof(Meshlet);
+	structuredDesc.countOffset = 0;
+	m_meshletView = context.CreateUav(m_meshletBuffer, gxapi::eFormat::UNKNOWN, structuredDesc);
 }
 
 
@@ -178,56 +457,67 @@ void DepthPrepass::Execute(RenderContext& context) {
 	commandList.SetResourceState(m_targetDsv.GetResource(), gxapi::eResourceState::DEPTH_WRITE);
 	commandList.ClearDepthStencil(m_targetDsv, 1, 0, 0, nullptr, true, true);
 
+	if (m_objects.empty()) {
+		return;
+	}
+
+	// Cull and generate draw commands.
+	const size_t numGroups = m_objects.size();
+	CullUniforms uniforms;
+	uniforms.viewProjection = camera->GetViewMatrix() * camera->GetProjectionMatrix();
+	uniforms.cameraPosition = camera->GetPosition();
+	uniforms.numObjects = (uint32_t)m_objects.size();
+	uniforms.numGroupsX = (uint32_t)std::min(numGroups, size_t(MaxDispatchGroups));
+	const uint32_t zero = 0;
+
+	commandList.SetResourceState(m_objectBuffer, gxapi::eResourceState::COPY_DEST);
+	commandList.SetResourceState(m_commandCountBuffer, gxapi::eResourceState::COPY_DEST);
+	context.Upload(m_objectBuffer, 0, m_objects.data(), m_objects.size() * sizeof(ObjectData));
+	context.Upload(m_commandCountBuffer, 0, &zero, sizeof(zero));
+	if (m_meshletsDirty && !m_meshlets.empty()) {
+		commandList.SetResourceState(m_meshletBuffer, gxapi::eResourceState::COPY_DEST);
+		context.Upload(m_meshletBuffer, 0, m_meshlets.data(), m_meshlets.size() * sizeof(Meshlet));
+	}
+	m_meshletsDirty = false;
+
+	commandList.SetResourceState(m_objectBuffer, gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_commandBuffer, gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_commandCountBuffer, gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_meshletBuffer, gxapi::eResourceState::UNORDERED_ACCESS);
+
+	commandList.SetPipelineState(m_cullCSO.get());
+	commandList.SetComputeBinder(&m_cullBinder);
+	commandList.BindCompute(m_cullUniformsBindParam, &uniforms, sizeof(uniforms));
+	commandList.BindCompute(m_objectsBindParam, m_objectView);
+	commandList.BindCompute(m_commandsBindParam, m_commandView);
+	commandList.BindCompute(m_commandCountBindParam, m_commandCountView);
+	commandList.BindCompute(m_meshletsBindParam, m_meshletView);
+	// A group for each object, its threads share the meshlets.
+	commandList.Dispatch(uniforms.numGroupsX, (unsigned)((numGroups + MaxDispatchGroups - 1) / MaxDispatchGroups), 1);
+
+	commandList.SetResourceState(m_commandBuffer, gxapi::eResourceState::INDIRECT_ARGUMENT);
+	commandList.SetResourceState(m_commandCountBuffer, gxapi::eResourceState::INDIRECT_ARGUMENT);
+
+	// The commands reference the mesh buffers directly.
+	for (const MeshEntity* entity : m_drawnEntities) {
+		commandList.SetResourceState(entity->GetVertexBuffer(0), gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
+		commandList.SetResourceState(entity->GetMesh()->GetIndexBuffer(), gxapi::eResourceState::INDEX_BUFFER);
+	}
+
+	// Draw the visible ones.
 	commandList.SetPipelineState(m_PSO.get());
 	commandList.SetGraphicsBinder(&m_binder);
 	commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
-
-	Mat44 view = camera->GetViewMatrix();
-	Mat44 projection = camera->GetProjectionMatrix();
-
-	auto viewProjection = view * projection;
-
-	std::vector<const gxeng::VertexBuffer*> vertexBuffers;
-	std::vector<unsigned> sizes;
-	std::vector<unsigned> strides;
-
-	// Iterate over all entities
-	for (const MeshEntity* entity : *entities) {
-		// Get entity parameters
-		Mesh* mesh = entity->GetMesh();
-		auto position = entity->GetPosition();
-
-		// Draw mesh
-		if (!CheckMeshFormat(*mesh)) {
-			assert(false);
-			continue;
-		}
-
-		ConvertToSubmittable(mesh, vertexBuffers, sizes, strides);
-
-		auto MVP = entity->GetTransform() * viewProjection;
-
-		Mat44_Packed transformCBData;
-		transformCBData = MVP;
-
-		commandList.BindGraphics(m_transformBindParam, &transformCBData, sizeof(transformCBData));
-
-		for (auto& vb : vertexBuffers) {
-			commandList.SetResourceState(*vb, gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
-		}
-		commandList.SetResourceState(mesh->GetIndexBuffer(), gxapi::eResourceState::INDEX_BUFFER);
-
-		commandList.SetVertexBuffers(0, (unsigned)vertexBuffers.size(), vertexBuffers.data(), sizes.data(), strides.data());
-		commandList.SetIndexBuffer(&mesh->GetIndexBuffer(), mesh->IsIndexBuffer32Bit());
-		commandList.DrawIndexedInstanced((unsigned)mesh->GetIndexBuffer().GetIndexCount());
-	}
+	commandList.ExecuteIndirect(m_commandSignature.get(), (unsigned)m_numCommands, m_commandBuffer, 0, &m_commandCountBuffer, 0);
 }
 
 const std::string& DepthPrepass::GetInputName(size_t index) const {
 	static const std::vector<std::string> names = {
 		"depthStencilTex",
 		"Camera",
-		"Mesh entities"
+		"Mesh entities",
+		"adaptive",
+		"minOccluderCoverage",
 	};
 	return names[index];
 }
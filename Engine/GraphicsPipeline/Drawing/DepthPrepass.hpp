@@ -1,17 +1,38 @@
 #pragma once
 
+#include <GraphicsApi_LL/ICommandSignature.hpp>
 #include <GraphicsApi_LL/IPipelineState.hpp>
 #include <GraphicsEngine_LL/BasicCamera.hpp>
 #include <GraphicsEngine_LL/GraphicsNode.hpp>
+#include <GraphicsEngine_LL/MeshOptimizer.hpp>
+#include <GraphicsEngine_LL/RenderQueue.hpp>
+
+#include <unordered_map>
+
+namespace inl::gxeng {
+class Mesh;
+} // namespace inl::gxeng
+
 
 namespace inl::gxeng::nodes {
 
 /// <summary>
-/// Inputs: render target, entities, camera
+/// Inputs: render target, camera, entities, adaptive, min occluder coverage
 /// </summary>
+/// <remarks>
+/// Draws are generated on the GPU: a compute pass culls the entities against the view frustum
+/// and writes draw commands for the visible ones, which are then submitted by a single ExecuteIndirect.
+/// Each entity gets a thread group that also culls the meshlets of its level of detail one by one,
+/// against the frustum and by the cone of their normals, and draws only the remaining ones.
+/// Meshes without meshlets are drawn whole.
+/// In adaptive mode only good occluders are drawn: entities whose bounding sphere covers at least
+/// the given part of the screen's height, and those marked by <see cref="MeshEntity::SetOccluderHint"/>.
+/// The rest is left to the depth test of the forward pass, so passes reading the depth in between
+/// only see the occluders.
+/// </remarks>
 class DepthPrepass : virtual public GraphicsNode,
 					 virtual public GraphicsTask,
-					 virtual public InputPortConfig<Texture2D, const BasicCamera*, const EntityCollection<MeshEntity>*>,
+					 virtual public InputPortConfig<Texture2D, const BasicCamera*, const EntityCollection<MeshEntity>*, bool, float>,
 					 virtual public OutputPortConfig<Texture2D> {
 public:
 	static const char* Info_GetName() { return "DepthPrepass"; }
@@ -28,6 +49,36 @@ public:
 	const std::string& GetInputName(size_t index) const override;
 	const std::string& GetOutputName(size_t index) const override;
 
+private:
+	// Per entity input of the culling shader, layout must match DepthPrepassCull.hlsl.
+	struct ObjectData {
+		Mat44_Packed world;
+		Vec3_Packed boundsCenter;
+		uint32_t numIndices;
+		Vec3_Packed boundsExtent;
+		uint32_t alwaysVisible;
+		gxapi::VertexBufferViewArguments vertexBuffer;
+		gxapi::IndexBufferViewArguments indexBuffer;
+		Vec4_Packed quantization; // Object space to the space of the world matrix: position * w + xyz.
+		uint32_t firstIndex;
+		uint32_t firstMeshlet; // Into the meshlet buffer of the node.
+		uint32_t meshletCount;
+		uint32_t padding;
+	};
+
+	// Where the meshlets of a mesh are in the meshlet buffer.
+	struct MeshletRange {
+		uint32_t offset;
+		const Meshlet* data; // Detects meshes that changed their meshlets.
+		size_t count;
+	};
+
+	void SetupCulling(SetupContext& context);
+	void UpdateObjects(SetupContext& context, const EntityCollection<MeshEntity>& entities, const BasicCamera* camera);
+	bool IsOccluder(const MeshEntity& entity, const BasicCamera* camera) const;
+	uint32_t GetMeshletOffset(const Mesh& mesh);
+	void UpdateMeshletBuffer(SetupContext& context);
+
 private:
 	BindParameter m_transformBindParam;
 	gxapi::eFormat m_depthStencilFormat = gxapi::eFormat::UNKNOWN;
@@ -36,6 +87,40 @@ private:
 	std::unique_ptr<gxapi::IPipelineState> m_PSO;
 	ShaderProgram m_shader;
 	DepthStencilView2D m_targetDsv;
+	bool m_adaptive = false;
+	float m_minOccluderCoverage = 0.0f;
+
+	// GPU culling
+	BindParameter m_cullUniformsBindParam;
+	BindParameter m_objectsBindParam;
+	BindParameter m_commandsBindParam;
+	BindParameter m_commandCountBindParam;
+	BindParameter m_meshletsBindParam;
+	Binder m_cullBinder;
+	std::unique_ptr<gxapi::IPipelineState> m_cullCSO;
+	ShaderProgram m_cullShader;
+	std::unique_ptr<gxapi::ICommandSignature> m_commandSignature;
+
+	std::vector<ObjectData> m_objects;
+	std::vector<const MeshEntity*> m_drawnEntities; // Entities of m_objects, their buffers must be transitioned before drawing.
+	RenderQueue m_renderQueue;
+	size_t m_capacity = 0;
+	size_t m_commandCapacity = 0;
+	size_t m_numCommands = 0; // Most draw commands the culling can write this frame.
+	LinearBuffer m_objectBuffer;
+	LinearBuffer m_commandBuffer;
+	LinearBuffer m_commandCountBuffer;
+	RWBufferView m_objectView;
+	RWBufferView m_commandView;
+	RWBufferView m_commandCountView;
+
+	// Meshlets of all meshes drawn recently, uploaded again when a new mesh shows up.
+	std::unordered_map<const Mesh*, MeshletRange> m_meshletRanges;
+	std::vector<Meshlet> m_meshlets;
+	bool m_meshletsDirty = false;
+	size_t m_meshletCapacity = 0;
+	LinearBuffer m_meshletBuffer;
+	RWBufferView m_meshletView;
 };
 
 
@@ -14,6 +14,50 @@ namespace inl::gxeng::nodes {
 INL_REGISTER_GRAPHICS_NODE(DrawSky)
 
 
+// Layout of Atmosphere in AtmosphereCommon.hlsl.
+struct AtmosphereConstants {
+	Vec3_Packed rayleighScattering;
+	float bottomRadius;
+	Vec3_Packed mieScattering;
+	float topRadius;
+	Vec3_Packed mieExtinction;
+	float rayleighScaleHeight;
+	Vec3_Packed absorptionExtinction;
+	float mieScaleHeight;
+	Vec3_Packed groundAlbedo;
+	float miePhaseG;
+	float absorptionCenter;
+	float absorptionWidth;
+	float luminanceScale;
+	float dummy;
+};
+
+// The LUTs are small enough to be resolution independent.
+static constexpr unsigned TransmittanceLutWidth = 256;
+static constexpr unsigned TransmittanceLutHeight = 64;
+static constexpr unsigned MultiScatteringLutSize = 32;
+static constexpr unsigned SkyViewLutWidth = 192;
+static constexpr unsigned SkyViewLutHeight = 108;
+static constexpr unsigned LutGroupSize = 8; // Must match the Atmosphere*Lut.hlsl shaders.
+
+
+bool AtmosphereParameters::operator==(const AtmosphereParameters& rhs) const {
+	return bottomRadius == rhs.bottomRadius
+		   && topRadius == rhs.topRadius
+		   && rayleighScattering == rhs.rayleighScattering
+		   && rayleighScaleHeight == rhs.rayleighScaleHeight
+		   && mieScattering == rhs.mieScattering
+		   && mieExtinction == rhs.mieExtinction
+		   && mieScaleHeight == rhs.mieScaleHeight
+		   && miePhaseG == rhs.miePhaseG
+		   && absorptionExtinction == rhs.absorptionExtinction
+		   && absorptionCenter == rhs.absorptionCenter
+		   && absorptionWidth == rhs.absorptionWidth
+		   && groundAlbedo == rhs.groundAlbedo
+		   && luminanceScale == rhs.luminanceScale;
+}
+
+
 void DrawSky::Initialize(EngineContext& context) {
 	GraphicsNode::SetTaskSingle(this);
 }
@@ -60,6 +104,10 @@ void DrawSky::Setup(SetupContext& context) {
 
 	this->GetOutput<0>().Set(renderTarget);
 
+	InitLuts(context);
+	this->GetOutput<1>().Set(m_transmittanceLutSrv.GetResource());
+	this->GetOutput<2>().Set(m_skyViewLutSrv.GetResource());
+
 	if (!m_binder) {
 		BindParameterDesc sunCbBindParamDesc;
 		m_sunCbBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
@@ -77,12 +125,52 @@ void DrawSky::Setup(SetupContext& context) {
 		camCbBindParamDesc.relativeChangeFrequency = 0;
 		camCbBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
 
+		BindParameterDesc atmosphereCbBindParamDesc;
+		m_atmosphereCbBindParam = BindParameter(eBindParameterType::CONSTANT, 2);
+		atmosphereCbBindParamDesc.parameter = m_atmosphereCbBindParam;
+		atmosphereCbBindParamDesc.constantSize = sizeof(AtmosphereConstants);
+		atmosphereCbBindParamDesc.relativeAccessFrequency = 0;
+		atmosphereCbBindParamDesc.relativeChangeFrequency = 0;
+		atmosphereCbBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc transmittanceLutBindParamDesc;
+		m_transmittanceLutBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		transmittanceLutBindParamDesc.parameter = m_transmittanceLutBindParam;
+		transmittanceLutBindParamDesc.constantSize = 0;
+		transmittanceLutBindParamDesc.relativeAccessFrequency = 0;
+		transmittanceLutBindParamDesc.relativeChangeFrequency = 0;
+		transmittanceLutBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc multiScatteringLutBindParamDesc;
+		m_multiScatteringLutBindParam = BindParameter(eBindParameterType::TEXTURE, 1);
+		multiScatteringLutBindParamDesc.parameter = m_multiScatteringLutBindParam;
+		multiScatteringLutBindParamDesc.constantSize = 0;
+		multiScatteringLutBindParamDesc.relativeAccessFrequency = 0;
+		multiScatteringLutBindParamDesc.relativeChangeFrequency = 0;
+		multiScatteringLutBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc skyViewLutBindParamDesc;
+		m_skyViewLutBindParam = BindParameter(eBindParameterType::TEXTURE, 2);
+		skyViewLutBindParamDesc.parameter = m_skyViewLutBindParam;
+		skyViewLutBindParamDesc.constantSize = 0;
+		skyViewLutBindParamDesc.relativeAccessFrequency = 0;
+		skyViewLutBindParamDesc.relativeChangeFrequency = 0;
+		skyViewLutBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc lutUavBindParamDesc;
+		m_lutUavBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		lutUavBindParamDesc.parameter = m_lutUavBindParam;
+		lutUavBindParamDesc.constantSize = 0;
+		lutUavBindParamDesc.relativeAccessFrequency = 0;
+		lutUavBindParamDesc.relativeChangeFrequency = 0;
+		lutUavBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
 		BindParameterDesc sampBindParamDesc;
 		sampBindParamDesc.parameter = BindParameter(eBindParameterType::SAMPLER, 0);
 		sampBindParamDesc.constantSize = 0;
 		sampBindParamDesc.relativeAccessFrequency = 0;
 		sampBindParamDesc.relativeChangeFrequency = 0;
-		sampBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::PIXEL;
+		sampBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
 
 		gxapi::StaticSamplerDesc samplerDesc;
 		samplerDesc.shaderRegister = 0;
@@ -92,9 +180,17 @@ void DrawSky::Setup(SetupContext& context) {
 		samplerDesc.addressW = gxapi::eTextureAddressMode::CLAMP;
 		samplerDesc.mipLevelBias = 0.f;
 		samplerDesc.registerSpace = 0;
-		samplerDesc.shaderVisibility = gxapi::eShaderVisiblity::PIXEL;
-
-		m_binder = context.CreateBinder({ sunCbBindParamDesc, camCbBindParamDesc, sampBindParamDesc }, { samplerDesc });
+		samplerDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		m_binder = context.CreateBinder({ sunCbBindParamDesc,
+										  camCbBindParamDesc,
+										  atmosphereCbBindParamDesc,
+										  transmittanceLutBindParamDesc,
+										  multiScatteringLutBindParamDesc,
+										  skyViewLutBindParamDesc,
+										  lutUavBindParamDesc,
+										  sampBindParamDesc },
+										{ samplerDesc });
 	}
 
 	//================================================
@@ -109,6 +205,25 @@ void DrawSky::Setup(SetupContext& context) {
 		m_shader = context.CreateShader("DrawSky", shaderParts, "");
 	}
 
+	if (!m_transmittanceLutCSO) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_transmittanceLutShader = context.CreateShader("AtmosphereTransmittanceLut", shaderParts, "");
+		m_multiScatteringLutShader = context.CreateShader("AtmosphereMultiScatteringLut", shaderParts, "");
+		m_skyViewLutShader = context.CreateShader("AtmosphereSkyViewLut", shaderParts, "");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_binder.GetRootSignature();
+
+		csoDesc.cs = m_transmittanceLutShader.cs;
+		m_transmittanceLutCSO.reset(context.CreatePSO(csoDesc));
+		csoDesc.cs = m_multiScatteringLutShader.cs;
+		m_multiScatteringLutCSO.reset(context.CreatePSO(csoDesc));
+		csoDesc.cs = m_skyViewLutShader.cs;
+		m_skyViewLutCSO.reset(context.CreatePSO(csoDesc));
+	}
+
 	if (m_colorFormat != renderTarget.GetFormat() || m_depthStencilFormat != currDepthStencilFormat) {
 		std::vector<gxapi::InputElementDesc> inputElementDesc = {
 			gxapi::InputElementDesc("POSITION", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 0)
@@ -155,28 +270,6 @@ void DrawSky::Execute(RenderContext& context) {
 
 	gxeng::GraphicsCommandList& commandList = context.AsGraphics();
 
-	auto* pRTV = &m_rtv;
-	commandList.SetResourceState(m_rtv.GetResource(), gxapi::eResourceState::RENDER_TARGET);
-	commandList.SetResourceState(m_dsv.GetResource(), gxapi::eResourceState::DEPTH_WRITE);
-	commandList.SetRenderTargets(1, &pRTV, &m_dsv);
-
-	gxapi::Rectangle rect{ 0, (int)pRTV->GetResource().GetHeight(), 0, (int)pRTV->GetResource().GetWidth() };
-	gxapi::Viewport viewport;
-	viewport.width = (float)rect.right;
-	viewport.height = (float)rect.bottom;
-	viewport.topLeftX = 0;
-	viewport.topLeftY = 0;
-	viewport.minDepth = 0.0f;
-	viewport.maxDepth = 1.0f;
-	commandList.SetScissorRects(1, &rect);
-	commandList.SetViewports(1, &viewport);
-
-	commandList.SetPipelineState(m_PSO.get());
-	commandList.SetGraphicsBinder(&m_binder);
-	commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
-	commandList.SetStencilRef(0); // only allow sky to be rendered to background pixels
-
-
 	struct Sun {
 		Vec4_Packed dir;
 		Vec4_Packed color;
@@ -195,8 +288,6 @@ void DrawSky::Execute(RenderContext& context) {
 	// TODO render all the suns using additive blending
 	auto sun = *suns->begin();
 
-	Mat44 viewInv = camera->GetViewMatrix().Inverse();
-	Vec4 sunViewDir = Vec4(sun->GetDirection(), 0.0f) * viewInv;
 	Vec4 sunColor = Vec4(sun->GetColor(), 1.0f);
 	Mat44 invViewProj = (camera->GetViewMatrix() * camera->GetProjectionMatrix()).Inverse();
 
@@ -211,8 +302,86 @@ void DrawSky::Execute(RenderContext& context) {
 
 	camCB.pos = Vec4(perpectiveCamera->GetPosition(), 1);
 
+	AtmosphereConstants atmosphereCB;
+	atmosphereCB.rayleighScattering = m_atmosphere.rayleighScattering;
+	atmosphereCB.bottomRadius = m_atmosphere.bottomRadius;
+	atmosphereCB.mieScattering = m_atmosphere.mieScattering;
+	atmosphereCB.topRadius = m_atmosphere.topRadius;
+	atmosphereCB.mieExtinction = m_atmosphere.mieExtinction;
+	atmosphereCB.rayleighScaleHeight = m_atmosphere.rayleighScaleHeight;
+	atmosphereCB.absorptionExtinction = m_atmosphere.absorptionExtinction;
+	atmosphereCB.mieScaleHeight = m_atmosphere.mieScaleHeight;
+	atmosphereCB.groundAlbedo = m_atmosphere.groundAlbedo;
+	atmosphereCB.miePhaseG = m_atmosphere.miePhaseG;
+	atmosphereCB.absorptionCenter = m_atmosphere.absorptionCenter;
+	atmosphereCB.absorptionWidth = m_atmosphere.absorptionWidth;
+	atmosphereCB.luminanceScale = m_atmosphere.luminanceScale;
+	atmosphereCB.dummy = 0.0f;
+
+	commandList.SetComputeBinder(&m_binder);
+	commandList.BindCompute(m_sunCbBindParam, &sunCB, sizeof(sunCB));
+	commandList.BindCompute(m_camCbBindParam, &camCB, sizeof(camCB));
+	commandList.BindCompute(m_atmosphereCbBindParam, &atmosphereCB, sizeof(atmosphereCB));
+
+	// Transmittance and multiple scattering only depend on the atmosphere.
+	if (!m_lutsValid || m_lutAtmosphere != m_atmosphere) {
+		commandList.SetResourceState(m_transmittanceLutUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+		commandList.SetPipelineState(m_transmittanceLutCSO.get());
+		commandList.BindCompute(m_lutUavBindParam, m_transmittanceLutUav);
+		commandList.Dispatch((TransmittanceLutWidth + LutGroupSize - 1) / LutGroupSize, (TransmittanceLutHeight + LutGroupSize - 1) / LutGroupSize, 1);
+		commandList.UAVBarrier(m_transmittanceLutUav.GetResource());
+
+		commandList.SetResourceState(m_transmittanceLutSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+		commandList.SetResourceState(m_multiScatteringLutUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+		commandList.SetPipelineState(m_multiScatteringLutCSO.get());
+		commandList.BindCompute(m_transmittanceLutBindParam, m_transmittanceLutSrv);
+		commandList.BindCompute(m_lutUavBindParam, m_multiScatteringLutUav);
+		commandList.Dispatch((MultiScatteringLutSize + LutGroupSize - 1) / LutGroupSize, (MultiScatteringLutSize + LutGroupSize - 1) / LutGroupSize, 1);
+		commandList.UAVBarrier(m_multiScatteringLutUav.GetResource());
+
+		m_lutAtmosphere = m_atmosphere;
+		m_lutsValid = true;
+	}
+
+	{ // The sky-view LUT follows the sun and the camera's height.
+		commandList.SetResourceState(m_transmittanceLutSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+		commandList.SetResourceState(m_multiScatteringLutSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+		commandList.SetResourceState(m_skyViewLutUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+		commandList.SetPipelineState(m_skyViewLutCSO.get());
+		commandList.BindCompute(m_transmittanceLutBindParam, m_transmittanceLutSrv);
+		commandList.BindCompute(m_multiScatteringLutBindParam, m_multiScatteringLutSrv);
+		commandList.BindCompute(m_lutUavBindParam, m_skyViewLutUav);
+		commandList.Dispatch((SkyViewLutWidth + LutGroupSize - 1) / LutGroupSize, (SkyViewLutHeight + LutGroupSize - 1) / LutGroupSize, 1);
+		commandList.UAVBarrier(m_skyViewLutUav.GetResource());
+	}
+
+	auto* pRTV = &m_rtv;
+	commandList.SetResourceState(m_rtv.GetResource(), gxapi::eResourceState::RENDER_TARGET);
+	commandList.SetResourceState(m_dsv.GetResource(), gxapi::eResourceState::DEPTH_WRITE);
+	commandList.SetRenderTargets(1, &pRTV, &m_dsv);
+
+	gxapi::Rectangle rect{ 0, (int)pRTV->GetResource().GetHeight(), 0, (int)pRTV->GetResource().GetWidth() };
+	gxapi::Viewport viewport;
+	viewport.width = (float)rect.right;
+	viewport.height = (float)rect.bottom;
+	viewport.topLeftX = 0;
+	viewport.topLeftY = 0;
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	commandList.SetScissorRects(1, &rect);
+	commandList.SetViewports(1, &viewport);
+
+	commandList.SetPipelineState(m_PSO.get());
+	commandList.SetGraphicsBinder(&m_binder);
+	commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
+	commandList.SetStencilRef(0); // only allow sky to be rendered to background pixels
+
+	commandList.SetResourceState(m_skyViewLutSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
 	commandList.BindGraphics(m_sunCbBindParam, &sunCB, sizeof(sunCB));
 	commandList.BindGraphics(m_camCbBindParam, &camCB, sizeof(camCB));
+	commandList.BindGraphics(m_atmosphereCbBindParam, &atmosphereCB, sizeof(atmosphereCB));
+	commandList.BindGraphics(m_transmittanceLutBindParam, m_transmittanceLutSrv);
+	commandList.BindGraphics(m_skyViewLutBindParam, m_skyViewLutSrv);
 	commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLESTRIP);
 	commandList.DrawInstanced(4);
 }
@@ -231,10 +400,54 @@ const std::string& DrawSky::GetInputName(size_t index) const {
 const std::string& DrawSky::GetOutputName(size_t index) const {
 	static const std::vector<std::string> names = {
 		"SkyTex",
+		"TransmittanceLut",
+		"SkyViewLut",
 	};
 	return names[index];
 }
 
 
+void DrawSky::InitLuts(SetupContext& context) {
+	if (m_transmittanceLutUav) {
+		return;
+	}
+
+	using gxapi::eFormat;
+
+	auto format = eFormat::R16G16B16A16_FLOAT;
+
+	gxapi::UavTexture2DArray uavDesc;
+	uavDesc.activeArraySize = 1;
+	uavDesc.firstArrayElement = 0;
+	uavDesc.mipLevel = 0;
+	uavDesc.planeIndex = 0;
+
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.numMipLevels = 1;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.planeIndex = 0;
+
+	Texture2D transmittanceLut = context.CreateTexture2D({ TransmittanceLutWidth, TransmittanceLutHeight, format }, { true, false, false, true });
+	transmittanceLut.SetName("Atmosphere transmittance LUT");
+	m_transmittanceLutUav = context.CreateUav(transmittanceLut, format, uavDesc);
+	m_transmittanceLutSrv = context.CreateSrv(transmittanceLut, format, srvDesc);
+
+	Texture2D multiScatteringLut = context.CreateTexture2D({ MultiScatteringLutSize, MultiScatteringLutSize, format }, { true, false, false, true });
+	multiScatteringLut.SetName("Atmosphere multiple scattering LUT");
+	m_multiScatteringLutUav = context.CreateUav(multiScatteringLut, format, uavDesc);
+	m_multiScatteringLutSrv = context.CreateSrv(multiScatteringLut, format, srvDesc);
+
+	Texture2D skyViewLut = context.CreateTexture2D({ SkyViewLutWidth, SkyViewLutHeight, format }, { true, false, false, true });
+	skyViewLut.SetName("Atmosphere sky-view LUT");
+	m_skyViewLutUav = context.CreateUav(skyViewLut, format, uavDesc);
+	m_skyViewLutSrv = context.CreateSrv(skyViewLut, format, srvDesc);
+
+	m_lutsValid = false;
+}
+
+
 
 } // namespace inl::gxeng::nodes
@@ -7,14 +7,43 @@
 
 namespace inl::gxeng::nodes {
 
+
+/// <summary> Physical description of the atmosphere the sky is rendered from. </summary>
+/// <remarks> Lengths are in kilometers, scattering and extinction coefficients per kilometer.
+///		The defaults describe the Earth's atmosphere. </remarks>
+struct AtmosphereParameters {
+	float bottomRadius = 6360.0f;
+	float topRadius = 6460.0f;
+	Vec3 rayleighScattering = { 0.005802f, 0.013558f, 0.033100f };
+	float rayleighScaleHeight = 8.0f;
+	Vec3 mieScattering = { 0.003996f, 0.003996f, 0.003996f };
+	Vec3 mieExtinction = { 0.004440f, 0.004440f, 0.004440f };
+	float mieScaleHeight = 1.2f;
+	float miePhaseG = 0.8f;
+	Vec3 absorptionExtinction = { 0.000650f, 0.001881f, 0.000085f }; // Ozone, its density peaks at the center and fades out over the width.
+	float absorptionCenter = 25.0f;
+	float absorptionWidth = 30.0f;
+	Vec3 groundAlbedo = { 0.3f, 0.3f, 0.3f };
+	float luminanceScale = 10.0f; // The LUTs are made for a sun of unit illuminance, this brings the sky to the scene's brightness.
+
+	bool operator==(const AtmosphereParameters& rhs) const;
+	bool operator!=(const AtmosphereParameters& rhs) const { return !(*this == rhs); }
+};
+
+
 /// <summary>
 /// Inputs: frame color, frame depth stencil, camera, sun
-/// Output: frame color
+/// Output: frame color, transmittance LUT, sky-view LUT
 /// </summary>
+/// <remarks> The sky is looked up from a low resolution sky-view LUT rendered each frame.
+///		The transmittance and multiple scattering LUTs it is made from only depend on the atmosphere,
+///		they are rendered again when <see cref="SetAtmosphere"/> changes it.
+///		The transmittance LUT is indexed by height and view zenith cosine, the sky-view LUT by direction,
+///		see AtmosphereCommon.hlsl, so that other passes can light with the same atmosphere. </remarks>
 class DrawSky : virtual public GraphicsNode,
 				virtual public GraphicsTask,
 				virtual public InputPortConfig<Texture2D, Texture2D, const BasicCamera*, const EntityCollection<DirectionalLight>*>,
-				virtual public OutputPortConfig<Texture2D> {
+				virtual public OutputPortConfig<Texture2D, Texture2D, Texture2D> {
 public:
 	static const char* Info_GetName() { return "DrawSky"; }
 	void Update() override {}
@@ -28,6 +57,12 @@ public:
 	const std::string& GetInputName(size_t index) const override;
 	const std::string& GetOutputName(size_t index) const override;
 
+	void SetAtmosphere(const AtmosphereParameters& atmosphere) { m_atmosphere = atmosphere; }
+	const AtmosphereParameters& GetAtmosphere() const { return m_atmosphere; }
+
+private:
+	void InitLuts(SetupContext& context);
+
 private: // execution
 	RenderTargetView2D m_rtv;
 	DepthStencilView2D m_dsv;
@@ -36,11 +71,33 @@ protected:
 	Binder m_binder;
 	BindParameter m_sunCbBindParam;
 	BindParameter m_camCbBindParam;
+	BindParameter m_atmosphereCbBindParam;
+	BindParameter m_transmittanceLutBindParam;
+	BindParameter m_multiScatteringLutBindParam;
+	BindParameter m_skyViewLutBindParam;
+	BindParameter m_lutUavBindParam;
 
 	ShaderProgram m_shader;
+	ShaderProgram m_transmittanceLutShader;
+	ShaderProgram m_multiScatteringLutShader;
+	ShaderProgram m_skyViewLutShader;
 	std::unique_ptr<gxapi::IPipelineState> m_PSO;
+	std::unique_ptr<gxapi::IPipelineState> m_transmittanceLutCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_multiScatteringLutCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_skyViewLutCSO;
 	gxapi::eFormat m_colorFormat = gxapi::eFormat::UNKNOWN;
 	gxapi::eFormat m_depthStencilFormat = gxapi::eFormat::UNKNOWN;
+
+	RWTextureView2D m_transmittanceLutUav;
+	TextureView2D m_transmittanceLutSrv;
+	RWTextureView2D m_multiScatteringLutUav;
+	TextureView2D m_multiScatteringLutSrv;
+	RWTextureView2D m_skyViewLutUav;
+	TextureView2D m_skyViewLutSrv;
+
+	AtmosphereParameters m_atmosphere;
+	AtmosphereParameters m_lutAtmosphere; // The atmosphere the transmittance and multiple scattering LUTs hold.
+	bool m_lutsValid = false;
 };
 
 
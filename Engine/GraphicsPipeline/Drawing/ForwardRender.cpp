@@ -4,13 +4,20 @@
 
 #include <BaseLibrary/Range.hpp>
 #include <GraphicsEngine_LL/AutoRegisterNode.hpp>
+#include <GraphicsEngine_LL/BoundingVolumes.hpp>
 #include <GraphicsEngine_LL/GraphicsCommandList.hpp>
 #include <GraphicsEngine_LL/Image.hpp>
+#include <GraphicsEngine_LL/LodSelector.hpp>
 #include <GraphicsEngine_LL/Material.hpp>
 #include <GraphicsEngine_LL/MaterialShader.hpp>
 #include <GraphicsEngine_LL/MeshEntity.hpp>
 
+#include <BaseLibrary/JobSystem/Parallel.hpp>
+
+#include <algorithm>
+#include <limits>
 #include <regex>
+#include <thread>
 
 
 namespace inl::gxeng::nodes {
@@ -21,52 +28,26 @@ INL_REGISTER_GRAPHICS_NODE(ForwardRender)
 
 bool hasSSShadow = false;
 
-struct LightData {
-	Vec4_Packed diffuseColor;
-	Vec4_Packed vsPosition;
-	Vec4_Packed attenuationEnd;
-};
-
 struct Uniforms {
 	Mat44_Packed invV;
-	LightData ld[10];
 	Vec4_Packed screenDimensions;
 	Vec4_Packed vsCamPos;
-	int groupSizeX, groupSizeY;
+	uint32_t clusterCountX, clusterCountY, clusterCountZ, clusterTileSize; // See LightClusters.
+	float clusterDepthScale, clusterDepthBias;
 	float halfExposureFramerate, //0.5 * exposure time (% of time exposure is open -> 0.75?) * frame rate (s? or fps?)
 		maxMotionBlurRadius; //pixels
 };
 
-static void SetWorkgroupSize(unsigned w, unsigned h, unsigned groupSizeW, unsigned groupSizeH, unsigned& dispatchW, unsigned& dispatchH) {
-	//set up work group sizes
-	unsigned gw = 0, gh = 0, count = 1;
-
-	while (gw < w) {
-		gw = groupSizeW * count;
-		count++;
-	}
-
-	count = 1;
-
-	while (gh < h) {
-		gh = groupSizeH * count;
-		count++;
-	}
-
-	dispatchW = unsigned(float(gw) / groupSizeW);
-	dispatchH = unsigned(float(gh) / groupSizeH);
-}
-
 static bool CheckMeshFormat(const Mesh& mesh) {
 	for (size_t i = 0; i < mesh.GetNumStreams(); i++) {
 		auto& elements = mesh.GetLayout()[0];
 		if (elements.size() != 3)
 			return false;
-		if (elements[0].semantic != eVertexElementSemantic::POSITION)
+		if (elements[0].semantic != eVertexElementSemantic::POSITION || elements[0].format != gxapi::eFormat::R16G16B16A16_UNORM)
 			return false;
-		if (elements[1].semantic != eVertexElementSemantic::NORMAL)
+		if (elements[1].semantic != eVertexElementSemantic::NORMAL || elements[1].format != gxapi::eFormat::R16G16_SNORM)
 			return false;
-		if (elements[2].semantic != eVertexElementSemantic::TEX_COORD)
+		if (elements[2].semantic != eVertexElementSemantic::TEX_COORD || elements[2].format != gxapi::eFormat::R16G16_FLOAT)
 			return false;
 	}
 
@@ -111,7 +92,12 @@ void ForwardRender::Reset() {
 	m_targetDSV = DepthStencilView2D();
 	m_entities = nullptr;
 	m_camera = nullptr;
+	m_views = nullptr;
 	m_directionalLights = nullptr;
+	m_lightClusters = {};
+	m_shadingRateTex.reset();
+	m_renderQueue.Clear();
+	m_batcher.Clear();
 
 	GetInput<0>().Clear();
 	GetInput<1>().Clear();
@@ -121,6 +107,8 @@ void ForwardRender::Reset() {
 	GetInput<5>().Clear();
 	GetInput<6>().Clear();
 	GetInput<7>().Clear();
+	GetInput<8>().Clear();
+	GetInput<9>().Clear();
 }
 
 const std::string& ForwardRender::GetInputName(size_t index) const {
@@ -131,8 +119,10 @@ const std::string& ForwardRender::GetInputName(size_t index) const {
 		"camera",
 		"directionalLights",
 		"layeredShadowTex",
-		"lightCullData",
-		"screenSpaceShadowTex"
+		"lightClusters",
+		"screenSpaceShadowTex",
+		"shadingRateTex",
+		"views"
 	};
 	return names[index];
 }
@@ -168,6 +158,10 @@ void ForwardRender::Setup(SetupContext& context) {
 
 	m_camera = this->GetInput<3>().Get();
 
+	// A set with one view is the camera drawn over the whole target, the same as no set.
+	const ViewSet* views = this->GetInput<9>().Get();
+	m_views = views && views->GetViewCount() > 1 ? views : nullptr;
+
 	auto dirLights = this->GetInput<4>().Get();
 	if (dirLights && dirLights->Size() > 0) {
 		m_directionalLights = dirLights;
@@ -186,9 +180,20 @@ void ForwardRender::Setup(SetupContext& context) {
 	m_layeredShadowTexView = context.CreateSrv(layeredShadowTex, layeredShadowTex.GetFormat(), srvDesc);
 
 
-	auto lightCullData = this->GetInput<6>().Get();
+	m_lightClusters = this->GetInput<6>().Get();
 	this->GetInput<6>().Clear();
-	m_lightCullDataView = context.CreateSrv(lightCullData, lightCullData.GetFormat(), srvDesc);
+	gxapi::SrvBuffer bufferDesc;
+	bufferDesc.firstElement = 0;
+	bufferDesc.isRaw = false;
+	bufferDesc.numElements = m_lightClusters.GetClusterCount();
+	bufferDesc.structureStrideInBytes = 2 * sizeof(uint32_t);
+	m_lightCullDataView = context.CreateSrv(m_lightClusters.clusters, gxapi::eFormat::UNKNOWN, bufferDesc);
+	bufferDesc.numElements = m_lightClusters.indexCapacity;
+	bufferDesc.structureStrideInBytes = sizeof(uint32_t);
+	m_lightIndicesView = context.CreateSrv(m_lightClusters.lightIndices, gxapi::eFormat::UNKNOWN, bufferDesc);
+	bufferDesc.numElements = m_lightClusters.lightCapacity;
+	bufferDesc.structureStrideInBytes = sizeof(ClusteredLightCulling::LightData);
+	m_lightsView = context.CreateSrv(m_lightClusters.lights, gxapi::eFormat::UNKNOWN, bufferDesc);
 
 	auto screenSpaceShadowTex = this->GetInput<7>().Get();
 	this->GetInput<7>().Clear();
@@ -197,6 +202,14 @@ void ForwardRender::Setup(SetupContext& context) {
 		hasSSShadow = true;
 	}
 
+	// Empty if the device cannot shade at coarser rates.
+	auto shadingRateTex = this->GetInput<8>().Get();
+	this->GetInput<8>().Clear();
+	m_shadingRateTex.reset();
+	if (shadingRateTex) {
+		m_shadingRateTex = shadingRateTex;
+	}
+
 	if (!m_velocityNormalRTV) {
 		using gxapi::eFormat;
 
@@ -256,9 +269,95 @@ void ForwardRender::Setup(SetupContext& context) {
 	this->GetOutput<0>().Set(target);
 	this->GetOutput<1>().Set(m_velocityNormalRTV.GetResource());
 	this->GetOutput<2>().Set(m_albedoRoughnessMetalnessRTV.GetResource());
+
+	BuildBatches(context);
+	RequestMips(target.GetHeight());
+}
+
+
+void ForwardRender::RequestMips(uint32_t targetHeight) const {
+	if (m_entities == nullptr) {
+		return;
+	}
+
+	// Assumes the textures cover the mesh about once, a texel per pixel across the bounding sphere.
+	for (size_t i = 0; i < m_entities->Size(); ++i) {
+		const MeshEntity* entity = (*m_entities)[i];
+		const Material* material = entity->GetMaterial();
+		BoundingBox bounds = entity->GetLocalBounds();
+		float pixelCount = std::numeric_limits<float>::max();
+		if (!bounds.IsEmpty()) {
+			bounds = bounds.Transformed(entity->GetTransform());
+			pixelCount = LodSelector::ScreenSize(BoundingSphere{ bounds.GetCenter(), bounds.GetExtent().Length() }, *m_camera) * float(targetHeight);
+		}
+		for (size_t paramIdx = 0; paramIdx < material->GetParameterCount(); ++paramIdx) {
+			const Material::Parameter& param = (*material)[paramIdx];
+			if (param.GetType() == eMaterialShaderParamType::BITMAP_COLOR_2D || param.GetType() == eMaterialShaderParamType::BITMAP_VALUE_2D) {
+				const Image* image = (Image*)param;
+				if (image) {
+					image->RequestMip(TextureStreamer::RequiredMip(std::max(image->GetWidth(), image->GetHeight()), pixelCount));
+				}
+			}
+		}
+	}
 }
 
 
+void ForwardRender::BuildBatches(SetupContext& context) {
+	m_renderQueue.Clear();
+	m_batcher.Clear();
+	if (m_entities == nullptr) {
+		return;
+	}
+
+	// Draws sharing a PSO, then a material, then a mesh and its level of detail are adjacent, the rest front to back.
+	const Vec3 cameraPosition = m_camera->GetPosition();
+	const Vec3 cameraDirection = m_camera->GetLookDirection();
+	m_renderQueue.Reserve(m_entities->Size());
+	for (size_t i = 0; i < m_entities->Size(); ++i) {
+		const MeshEntity* entity = (*m_entities)[i];
+		const Mesh* mesh = entity->GetMesh();
+		const Material* material = entity->GetMaterial();
+		assert(mesh != nullptr);
+		assert(material != nullptr);
+
+		uint64_t pipelineId = RenderQueue::PointerId(material->GetShader()) ^ mesh->GetLayout().GetLayoutHash();
+		float depth = Dot(entity->GetPosition() - cameraPosition, cameraDirection);
+		uint32_t viewMask = m_views ? m_views->GetMask(entity) : ViewSet::AllViews;
+		uint64_t meshId = RenderQueue::PointerId(mesh) + entity->GetLod() + (uint64_t(viewMask) << 8);
+		m_renderQueue.Add(RenderQueue::MakeKey(pipelineId, RenderQueue::PointerId(material), meshId, depth), uint32_t(i));
+	}
+	m_renderQueue.Sort(context.GetJobScheduler());
+
+	// Neighbours with the same mesh, level of detail, material and views become one instanced draw, skinned ones have vertices of their own.
+	m_batcher.Reserve(m_renderQueue.Size());
+	for (const RenderQueue::Item& item : m_renderQueue) {
+		const MeshEntity* entity = (*m_entities)[item.index];
+		const VertexBuffer* skinnedVertices = entity->HasSkinnedVertices() ? &entity->GetSkinnedVertices() : nullptr;
+		uint32_t viewMask = m_views ? m_views->GetMask(entity) : ViewSet::AllViews;
+		m_batcher.Add(entity->GetMesh(), entity->GetMaterial(), entity->GetPositionDequantization() * entity->GetTransform(), entity->GetLod(), skinnedVertices, viewMask);
+	}
+	m_instanceBuffer.Reserve(context, m_batcher.GetInstanceCount());
+}
+
+
+// Constants and region of the target of one camera.
+struct ForwardRender::ViewState {
+	VsConstants vsConstants;
+	LightConstants lightConstants;
+	Uniforms uniforms;
+	gxapi::Rectangle scissor;
+	gxapi::Viewport viewport;
+};
+
+
+// Everything the draws of one frame share, set up once and read by every recording list.
+struct ForwardRender::FrameState {
+	ViewState views[ViewSet::MaxViews];
+	size_t viewCount = 1;
+};
+
+
 void ForwardRender::Execute(RenderContext& context) {
 	if (m_entities == nullptr) {
 		return;
@@ -266,185 +365,380 @@ void ForwardRender::Execute(RenderContext& context) {
 
 	GraphicsCommandList& commandList = context.AsGraphics();
 
-	// Set render target
-	RenderTargetView2D* pRTV[] = { &m_targetRTV, &m_velocityNormalRTV, &m_albedoRoughnessMetalnessRTV };
-	commandList.SetResourceState(m_velocityNormalRTV.GetResource(), gxapi::eResourceState::RENDER_TARGET);
-	commandList.SetResourceState(m_albedoRoughnessMetalnessRTV.GetResource(), gxapi::eResourceState::RENDER_TARGET);
-	commandList.SetResourceState(m_targetRTV.GetResource(), gxapi::eResourceState::RENDER_TARGET);
-	commandList.SetResourceState(m_targetDSV.GetResource(), gxapi::eResourceState::DEPTH_WRITE);
-	commandList.SetRenderTargets(3, pRTV, &m_targetDSV);
+	m_instanceBuffer.Upload(context, commandList, m_batcher.GetTransforms());
+
+	// Transitions and clears go into the main list, draws are recorded with the render targets already in place.
+	SetDrawStates(commandList);
 	commandList.ClearRenderTarget(m_targetRTV, gxapi::ColorRGBA(0, 0, 0, 0));
 	commandList.ClearRenderTarget(m_velocityNormalRTV, gxapi::ColorRGBA(0.5, 0.5, 0, 0));
 	commandList.ClearRenderTarget(m_albedoRoughnessMetalnessRTV, gxapi::ColorRGBA(0, 0, 0, 0));
 
-	gxapi::Rectangle rect{ 0, (int)m_targetRTV.GetResource().GetHeight(), 0, (int)m_targetRTV.GetResource().GetWidth() };
-	gxapi::Viewport viewport;
-	viewport.width = (float)rect.right;
-	viewport.height = (float)rect.bottom;
-	viewport.topLeftX = 0;
-	viewport.topLeftY = 0;
-	viewport.minDepth = 0.0f;
-	viewport.maxDepth = 1.0f;
-	commandList.SetScissorRects(1, &rect);
-	commandList.SetViewports(1, &viewport);
+	FrameState frame;
+	if (m_views) {
+		// The prepass drew the primary camera over the whole target, its depth is no use to the views.
+		commandList.ClearDepthStencil(m_targetDSV, 1, 0, 0, nullptr, true, true);
+		frame.viewCount = m_views->GetViewCount();
+		for (size_t i = 0; i < frame.viewCount; ++i) {
+			const ViewSet::View& view = (*m_views)[i];
+			SetupView(frame.views[i], *view.camera, view.left, view.top, view.width, view.height);
+		}
+	}
+	else {
+		SetupView(frame.views[0], *m_camera, 0.0f, 0.0f, 1.0f, 1.0f);
+	}
 
-	commandList.SetStencilRef(1); // background is 0, anything other than that is 1
+	// PSOs are looked up and compiled here, and material constants updated, recording threads only read the results.
+	++m_frameIndex;
+	for (auto it = m_materialConstants.begin(); it != m_materialConstants.end();) {
+		it = m_frameIndex - it->second.lastFrame > MaterialConstantsLifetime ? m_materialConstants.erase(it) : std::next(it);
+	}
 
-	commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
+	const std::vector<InstanceBatcher::Batch>& batches = m_batcher.GetBatches();
+	std::vector<const ScenarioData*, ArenaAllocator<const ScenarioData*>> scenarios(batches.size(), nullptr, context.GetFrameAllocator<const ScenarioData*>());
+	std::vector<const ConstBufferView*, ArenaAllocator<const ConstBufferView*>> materialCbvs(batches.size(), nullptr, context.GetFrameAllocator<const ConstBufferView*>());
+	const MaterialShader* currentShader = nullptr;
+	const Mesh::Layout* currentLayout = nullptr;
+	const ScenarioData* currentScenario = nullptr;
+	const Material* currentMaterial = nullptr;
+	const ConstBufferView* currentCbv = nullptr;
+	for (size_t i = 0; i < batches.size(); ++i) {
+		assert(batches[i].mesh != nullptr);
+		assert(batches[i].material != nullptr);
+
+		const Mesh::Layout& layout = batches[i].mesh->GetLayout();
+		const MaterialShader* materialShader = batches[i].material->GetShader();
+		assert(materialShader != nullptr);
+
+		if (materialShader != currentShader || !currentLayout || (&layout != currentLayout && !layout.EqualLayout(*currentLayout))) {
+			currentScenario = &GetScenario(
+				context, layout, *batches[i].material, m_targetRTV.GetDescription().format, m_targetDSV.GetDescription().format);
+			currentShader = materialShader;
+			currentLayout = &layout;
+		}
+		scenarios[i] = currentScenario;
+
+		if (batches[i].material != currentMaterial) {
+			currentMaterial = batches[i].material;
+			currentCbv = GetMaterialConstants(context, *currentMaterial, *currentScenario);
+		}
+		materialCbvs[i] = currentCbv;
+	}
+
+	// Large scenes are split into contiguous ranges of batches, each recorded into its own list by a helper job.
+	// The lists are submitted in range order, so the draw order is the same as with a single list.
+	size_t numLists = 1;
+	if (context.GetJobScheduler()) {
+		size_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+		numLists = std::clamp(batches.size() / MinBatchesPerList, size_t(1), numThreads);
+	}
+
+	if (numLists == 1) {
+		RecordBatches(context, commandList, frame, 0, batches.size(), scenarios.data(), materialCbvs.data());
+		return;
+	}
 
-	Mat44 view = m_camera->GetViewMatrix();
-	Mat44 projection = m_camera->GetProjectionMatrix();
+	std::vector<GraphicsCommandList*, ArenaAllocator<GraphicsCommandList*>> lists{ context.GetFrameAllocator<GraphicsCommandList*>() };
+	for (size_t i = 0; i < numLists; ++i) {
+		lists.push_back(&context.AddSecondaryGraphics());
+	}
+	const size_t rangeSize = (batches.size() + numLists - 1) / numLists;
+	jobs::CooperativeFor(context.GetJobScheduler(), numLists, 1, [&](size_t first, size_t last) {
+		for (size_t listIdx = first; listIdx < last; ++listIdx) {
+			GraphicsCommandList& list = *lists[listIdx];
+			SetDrawStates(list);
+			RecordBatches(context,
+						  list,
+						  frame,
+						  listIdx * rangeSize,
+						  std::min(batches.size(), (listIdx + 1) * rangeSize),
+						  scenarios.data(),
+						  materialCbvs.data());
+		}
+	});
+}
+
+
+void ForwardRender::SetupView(ViewState& state, const BasicCamera& camera, float left, float top, float width, float height) const {
+	Mat44 view = camera.GetViewMatrix();
+	Mat44 projection = camera.GetProjectionMatrix();
 	auto viewProjection = view * projection;
-	Mat44 prevView = m_camera->GetPrevViewMatrix();
+	Mat44 prevView = camera.GetPrevViewMatrix();
 	auto prevViewProjection = prevView * projection;
 
+	const float targetWidth = (float)m_targetRTV.GetResource().GetWidth();
+	const float targetHeight = (float)m_targetRTV.GetResource().GetHeight();
+	state.scissor = gxapi::Rectangle{ int(top * targetHeight), int((top + height) * targetHeight), int(left * targetWidth), int((left + width) * targetWidth) };
+	state.viewport.width = float(state.scissor.right - state.scissor.left);
+	state.viewport.height = float(state.scissor.bottom - state.scissor.top);
+	state.viewport.topLeftX = float(state.scissor.left);
+	state.viewport.topLeftY = float(state.scissor.top);
+	state.viewport.minDepth = 0.0f;
+	state.viewport.maxDepth = 1.0f;
+
+	const DirectionalLight* sun = m_directionalLights ? *(*m_directionalLights)->begin() : 0;
+	if (sun) {
+		Vec4 vsLightDir = Vec4(sun->GetDirection(), 0.0f) * view;
+		state.lightConstants.direction = Vec3(vsLightDir.xyz).Normalized();
+		state.lightConstants.color = sun->GetColor();
+	}
 
-	std::vector<const gxeng::VertexBuffer*> vertexBuffers;
-	std::vector<unsigned> sizes;
-	std::vector<unsigned> strides;
+	Uniforms& uniformsCBData = state.uniforms;
+	uniformsCBData.screenDimensions = Vec4(targetWidth, targetHeight, 0.f, 0.f);
+	uniformsCBData.vsCamPos = Vec4(camera.GetPosition(), 1.0f) * camera.GetViewMatrix();
+	uniformsCBData.invV = camera.GetViewMatrix().Inverse();
+
+	uniformsCBData.clusterCountX = m_lightClusters.countX;
+	uniformsCBData.clusterCountY = m_lightClusters.countY;
+	uniformsCBData.clusterCountZ = m_lightClusters.countZ;
+	uniformsCBData.clusterTileSize = m_lightClusters.tileSize;
+	uniformsCBData.clusterDepthScale = m_lightClusters.depthScale;
+	uniformsCBData.clusterDepthBias = m_lightClusters.depthBias;
+
+	uniformsCBData.halfExposureFramerate = 0.5 * 0.75 * 150; //TODO add measured FPS (or target)
+	uniformsCBData.maxMotionBlurRadius = 20;
+
+	state.vsConstants.vp = viewProjection;
+	state.vsConstants.prevVP = viewProjection; // prevViewProjection once entities keep their previous transform.
+	state.vsConstants.v = view;
+	state.vsConstants.p = projection;
+}
 
-	// Iterate over all entities
-	for (const MeshEntity* entity : *m_entities) {
-		// Get entity parameters
-		Mesh* mesh = entity->GetMesh();
-		Material* material = entity->GetMaterial();
 
-		assert(mesh != nullptr);
-		assert(material != nullptr);
+void ForwardRender::SetDrawStates(GraphicsCommandList& commandList) {
+	RenderTargetView2D* pRTV[] = { &m_targetRTV, &m_velocityNormalRTV, &m_albedoRoughnessMetalnessRTV };
+	commandList.SetResourceState(m_velocityNormalRTV.GetResource(), gxapi::eResourceState::RENDER_TARGET);
+	commandList.SetResourceState(m_albedoRoughnessMetalnessRTV.GetResource(), gxapi::eResourceState::RENDER_TARGET);
+	commandList.SetResourceState(m_targetRTV.GetResource(), gxapi::eResourceState::RENDER_TARGET);
+	commandList.SetResourceState(m_targetDSV.GetResource(), gxapi::eResourceState::DEPTH_WRITE);
+	commandList.SetRenderTargets(3, pRTV, &m_targetDSV);
 
-		// Set pipeline state & binder
-		const Mesh::Layout& layout = mesh->GetLayout();
-		const MaterialShader* materialShader = material->GetShader();
-		assert(materialShader != nullptr);
+	// State shared by every draw, bound again whenever the binder changes.
+	if (m_batcher.GetInstanceCount() > 0) {
+		commandList.SetResourceState(m_instanceBuffer.GetView().GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	}
+	commandList.SetResourceState(m_layeredShadowTexView.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	if (m_screenSpaceShadowTexView) {
+		commandList.SetResourceState(m_screenSpaceShadowTexView->GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	}
+	commandList.SetResourceState(m_lightCullDataView.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_lightIndicesView.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_lightsView.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+
+	// The image decides the rate, draws and primitives don't have their own.
+	if (m_shadingRateTex) {
+		const gxapi::eShadingRateCombiner combiners[2] = { gxapi::eShadingRateCombiner::PASSTHROUGH, gxapi::eShadingRateCombiner::OVERRIDE };
+		commandList.SetShadingRate(gxapi::eShadingRate::RATE_1X1, combiners);
+		commandList.SetShadingRateImage(&*m_shadingRateTex);
+	}
+}
 
-		ScenarioData& scenario = GetScenario(
-			context, layout, *material, m_targetRTV.GetDescription().format, m_targetDSV.GetDescription().format);
 
-		commandList.SetPipelineState(scenario.pso.get());
-		commandList.SetGraphicsBinder(&scenario.binder);
+void ForwardRender::RecordBatches(const RenderContext& context,
+								  GraphicsCommandList& commandList,
+								  const FrameState& frame,
+								  size_t firstBatch,
+								  size_t lastBatch,
+								  const ScenarioData* const* scenarios,
+								  const ConstBufferView* const* materialCbvs) const {
+	commandList.SetStencilRef(1); // background is 0, anything other than that is 1
 
-		commandList.SetResourceState(m_layeredShadowTexView.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
-		if (m_screenSpaceShadowTexView) {
-			commandList.SetResourceState(m_screenSpaceShadowTexView->GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
-		}
+	commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
 
-		commandList.SetResourceState(m_lightCullDataView.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	// Temporaries come from the frame arena to keep the heap out of the draw loop.
+	std::vector<const gxeng::VertexBuffer*, ArenaAllocator<const gxeng::VertexBuffer*>> vertexBuffers{ context.GetFrameAllocator<const gxeng::VertexBuffer*>() };
+	std::vector<unsigned, ArenaAllocator<unsigned>> sizes{ context.GetFrameAllocator<unsigned>() };
+	std::vector<unsigned, ArenaAllocator<unsigned>> strides{ context.GetFrameAllocator<unsigned>() };
 
-		commandList.BindGraphics(BindParameter(eBindParameterType::TEXTURE, 600), m_lightCullDataView);
+	// Batches come sorted by state, only what differs from the previous batch is set.
+	const ScenarioData* currentScenario = nullptr;
+	const Material* currentMaterial = nullptr;
+	const Mesh* currentMesh = nullptr;
+	const VertexBuffer* currentVertices = nullptr;
+	size_t currentView = ViewSet::MaxViews;
 
-		if (m_screenSpaceShadowTexView) {
-			commandList.BindGraphics(BindParameter(eBindParameterType::TEXTURE, 601), *m_screenSpaceShadowTexView);
-		}
+	// Per batch statistics show which materials are vertex or pixel bound, only measured on request.
+	const bool profileBatches = context.IsGpuStatisticsEnabled();
 
-		commandList.BindGraphics(BindParameter(eBindParameterType::TEXTURE, 602), m_layeredShadowTexView);
+	const std::vector<InstanceBatcher::Batch>& batches = m_batcher.GetBatches();
+	for (size_t batchIdx = firstBatch; batchIdx < lastBatch; ++batchIdx) {
+		const InstanceBatcher::Batch& batch = batches[batchIdx];
+		unsigned profileScope = profileBatches ? context.BeginProfileScope(commandList, "Batch " + std::to_string(batchIdx)) : GpuProfiler::InvalidScope;
 
-		// Set material parameters
-		std::vector<uint8_t> materialConstants(scenario.constantsSize);
-		for (size_t paramIdx = 0; paramIdx < material->GetParameterCount(); ++paramIdx) {
-			const Material::Parameter& param = (*material)[paramIdx];
-			switch (param.GetType()) {
-				case eMaterialShaderParamType::BITMAP_COLOR_2D:
-				case eMaterialShaderParamType::BITMAP_VALUE_2D: {
-					BindParameter bindSlot(eBindParameterType::TEXTURE, scenario.offsets[paramIdx]);
-					commandList.SetResourceState(((Image*)param)->GetSrv().GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
-					commandList.BindGraphics(bindSlot, ((Image*)param)->GetSrv());
-					break;
-				}
-				case eMaterialShaderParamType::COLOR: {
-					*reinterpret_cast<float*>(materialConstants.data() + scenario.offsets[paramIdx] + 0) = ((Vec4)param).x;
-					*reinterpret_cast<float*>(materialConstants.data() + scenario.offsets[paramIdx] + 4) = ((Vec4)param).y;
-					*reinterpret_cast<float*>(materialConstants.data() + scenario.offsets[paramIdx] + 8) = ((Vec4)param).z;
-					*reinterpret_cast<float*>(materialConstants.data() + scenario.offsets[paramIdx] + 12) = ((Vec4)param).w;
-					break;
-				}
-				case eMaterialShaderParamType::VALUE: {
-					*reinterpret_cast<float*>(materialConstants.data() + scenario.offsets[paramIdx]) = ((float)param);
-					break;
-				}
+		// Get entity parameters
+		Mesh* mesh = batch.mesh;
+		Material* material = batch.material;
+
+		// Set pipeline state & binder
+		if (scenarios[batchIdx] != currentScenario) {
+			currentScenario = scenarios[batchIdx];
+			commandList.SetPipelineState(currentScenario->pso.get());
+			commandList.SetGraphicsBinder(&currentScenario->binder);
+			currentMaterial = nullptr;
+
+			// Setting the binder drops all bindings.
+			commandList.BindGraphics(currentScenario->instancesSlot, m_instanceBuffer.GetView());
+			commandList.BindGraphics(currentScenario->lightCullDataSlot, m_lightCullDataView);
+			if (m_screenSpaceShadowTexView) {
+				commandList.BindGraphics(currentScenario->screenSpaceShadowSlot, *m_screenSpaceShadowTexView);
 			}
+			commandList.BindGraphics(currentScenario->layeredShadowSlot, m_layeredShadowTexView);
+			commandList.BindGraphics(currentScenario->lightsSlot, m_lightsView);
+			commandList.BindGraphics(currentScenario->lightIndicesSlot, m_lightIndicesView);
+			currentView = ViewSet::MaxViews;
 		}
-		if (scenario.constantsSize > 0) {
-			commandList.BindGraphics(BindParameter(eBindParameterType::CONSTANT, 200), materialConstants.data(), (int)materialConstants.size());
+		const ScenarioData& scenario = *currentScenario;
+		// Set material parameters, constants are in a buffer that is only updated when the material changes.
+		if (material != currentMaterial) {
+			currentMaterial = material;
+			for (size_t paramIdx = 0; paramIdx < material->GetParameterCount(); ++paramIdx) {
+				const Material::Parameter& param = (*material)[paramIdx];
+				if (param.GetType() == eMaterialShaderParamType::BITMAP_COLOR_2D || param.GetType() == eMaterialShaderParamType::BITMAP_VALUE_2D) {
+					const Image* image = (Image*)param;
+					commandList.SetResourceState(image->GetSrv().GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+					if (!scenario.bindless) {
+						commandList.BindGraphics(scenario.textureSlots[paramIdx], image->GetSrv());
+					}
+				}
+			}
+			if (materialCbvs[batchIdx]) {
+				commandList.BindGraphics(scenario.materialConstantsSlot, *materialCbvs[batchIdx]);
+			}
 		}
 
-		const DirectionalLight* sun = m_directionalLights ? *(*m_directionalLights)->begin() : 0;
-
-		// Set vertex and light constants
-		VsConstants vsConstants;
-		LightConstants lightConstants;
-		vsConstants.m = entity->GetTransform();
-		vsConstants.mvp = entity->GetTransform() * viewProjection;
-		vsConstants.mv = entity->GetTransform() * view;
-		vsConstants.v = view;
-		vsConstants.p = projection;
-		vsConstants.prevMVP = vsConstants.mvp; // entity->GetPrevTransform() * prevViewProjection;
-		if (sun) {
-			Vec4 vsLightDir = Vec4(sun->GetDirection(), 0.0f) * view;
-			lightConstants.direction = Vec3(vsLightDir.xyz).Normalized();
-			lightConstants.color = sun->GetColor();
+		// Set primitives
+		if (mesh != currentMesh || batch.vertices != currentVertices) {
+			currentMesh = mesh;
+			currentVertices = batch.vertices;
+			vertexBuffers.clear();
+			sizes.clear();
+			strides.clear();
+			for (size_t i = 0; i < mesh->GetNumStreams(); ++i) {
+				const VertexBuffer& vertexBuffer = i == 0 && batch.vertices ? *batch.vertices : mesh->GetVertexBuffer(i);
+				vertexBuffers.push_back(&vertexBuffer);
+				sizes.push_back((unsigned)vertexBuffer.GetSize());
+				strides.push_back((unsigned)mesh->GetVertexBufferStride(i));
+
+				commandList.SetResourceState(vertexBuffer, gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
+			}
+			commandList.SetResourceState(mesh->GetIndexBuffer(), gxapi::eResourceState::INDEX_BUFFER);
+			commandList.SetVertexBuffers(0, (unsigned)vertexBuffers.size(), vertexBuffers.data(), sizes.data(), strides.data());
+			commandList.SetIndexBuffer(&mesh->GetIndexBuffer(), mesh->IsIndexBuffer32Bit());
 		}
 
-		commandList.BindGraphics(BindParameter(eBindParameterType::CONSTANT, 0), &vsConstants, sizeof(vsConstants));
-		commandList.BindGraphics(BindParameter(eBindParameterType::CONSTANT, 100), &lightConstants, sizeof(lightConstants));
+		// Drawcall for each view that sees the batch, all other state is shared by the views.
+		const Mesh::Lod& lod = mesh->GetLod(batch.lod);
+		for (size_t viewIdx = 0; viewIdx < frame.viewCount; ++viewIdx) {
+			if ((batch.viewMask & (1u << viewIdx)) == 0) {
+				continue;
+			}
+			const ViewState& view = frame.views[viewIdx];
+			if (viewIdx != currentView) {
+				currentView = viewIdx;
+				gxapi::Rectangle scissor = view.scissor;
+				gxapi::Viewport viewport = view.viewport;
+				commandList.SetScissorRects(1, &scissor);
+				commandList.SetViewports(1, &viewport);
+				commandList.BindGraphics(currentScenario->lightConstantsSlot, &view.lightConstants, sizeof(view.lightConstants));
+				commandList.BindGraphics(currentScenario->uniformsSlot, &view.uniforms, sizeof(view.uniforms));
+			}
 
-		Uniforms uniformsCBData;
-		uniformsCBData.screenDimensions = Vec4((float)m_targetRTV.GetResource().GetWidth(), (float)m_targetRTV.GetResource().GetHeight(), 0.f, 0.f);
-		//uniformsCBData.ld[0].vs_position = Vec4(m_camera->GetPosition() + m_camera->GetLookDirection() * 5.f, 1.0f) * m_camera->GetViewMatrix();
-		uniformsCBData.ld[0].vsPosition = Vec4(Vec3(0, 0, 1), 1.0f) * m_camera->GetViewMatrix();
-		uniformsCBData.ld[0].attenuationEnd = Vec4(5.0f, 0.f, 0.f, 0.f);
-		uniformsCBData.ld[0].diffuseColor = Vec4(1.f, 0.f, 0.f, 1.f);
-		uniformsCBData.vsCamPos = Vec4(m_camera->GetPosition(), 1.0f) * m_camera->GetViewMatrix();
-		uniformsCBData.invV = m_camera->GetViewMatrix().Inverse();
+			// Set vertex constants, transforms are fetched from the instance buffer.
+			VsConstants vsConstants = view.vsConstants;
+			vsConstants.instanceOffset = batch.firstInstance;
+			commandList.BindGraphics(currentScenario->vsConstantsSlot, &vsConstants, sizeof(vsConstants));
+			commandList.DrawIndexedInstanced(lod.indexCount, lod.firstIndex, 0, batch.instanceCount);
+		}
+		context.EndProfileScope(commandList, profileScope);
+	}
 
-		uint32_t dispatchW, dispatchH;
-		SetWorkgroupSize((unsigned)m_targetRTV.GetResource().GetWidth(), (unsigned)m_targetRTV.GetResource().GetHeight(), 16, 16, dispatchW, dispatchH);
+	// Nodes recording into the same list afterwards shade at full rate.
+	if (m_shadingRateTex) {
+		commandList.SetShadingRateImage(nullptr);
+		commandList.SetShadingRate(gxapi::eShadingRate::RATE_1X1);
+	}
+}
 
-		uniformsCBData.groupSizeX = dispatchW;
-		uniformsCBData.groupSizeY = dispatchH;
 
-		uniformsCBData.halfExposureFramerate = 0.5 * 0.75 * 150; //TODO add measured FPS (or target)
-		uniformsCBData.maxMotionBlurRadius = 20;
 
-		commandList.BindGraphics(BindParameter(eBindParameterType::CONSTANT, 600), &uniformsCBData, sizeof(uniformsCBData));
+const ConstBufferView* ForwardRender::GetMaterialConstants(RenderContext& context, const Material& material, const ScenarioData& scenario) {
+	if (scenario.constantsSize == 0) {
+		return nullptr;
+	}
 
-		// Set primitives
-		vertexBuffers.clear();
-		sizes.clear();
-		strides.clear();
-		for (size_t i = 0; i < mesh->GetNumStreams(); ++i) {
-			vertexBuffers.push_back(&mesh->GetVertexBuffer(i));
-			sizes.push_back((unsigned)mesh->GetVertexBuffer(i).GetSize());
-			strides.push_back((unsigned)mesh->GetVertexBufferStride(i));
-
-			commandList.SetResourceState(mesh->GetVertexBuffer(i), gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
+	MaterialConstants& constants = m_materialConstants[&material];
+	if (constants.lastFrame == m_frameIndex) {
+		return &*constants.view;
+	}
+	constants.lastFrame = m_frameIndex;
+
+	// Versions are never reused, a material at the address of a destroyed one is packed again.
+	const bool repack = constants.version != material.GetVersion() || constants.data.size() != scenario.constantsSize;
+	bool changed = repack;
+	if (repack) {
+		constants.version = material.GetVersion();
+		constants.data.assign(scenario.constantsSize, 0);
+	}
+	for (size_t paramIdx = 0; paramIdx < material.GetParameterCount(); ++paramIdx) {
+		const Material::Parameter& param = material[paramIdx];
+		uint8_t* target = constants.data.data() + scenario.offsets[paramIdx];
+		switch (param.GetType()) {
+			case eMaterialShaderParamType::BITMAP_COLOR_2D:
+			case eMaterialShaderParamType::BITMAP_VALUE_2D: {
+				// Images get their bindless index when their layout is set, which does not change the material.
+				if (scenario.bindless) {
+					const Image* image = (Image*)param;
+					assert(image->GetBindlessIndex() != BindlessIndexAllocator::InvalidIndex);
+					if (*reinterpret_cast<uint32_t*>(target) != image->GetBindlessIndex()) {
+						*reinterpret_cast<uint32_t*>(target) = image->GetBindlessIndex();
+						changed = true;
+					}
+				}
+				break;
+			}
+			case eMaterialShaderParamType::COLOR: {
+				if (repack) {
+					*reinterpret_cast<float*>(target + 0) = ((Vec4)param).x;
+					*reinterpret_cast<float*>(target + 4) = ((Vec4)param).y;
+					*reinterpret_cast<float*>(target + 8) = ((Vec4)param).z;
+					*reinterpret_cast<float*>(target + 12) = ((Vec4)param).w;
+				}
+				break;
+			}
+			case eMaterialShaderParamType::VALUE: {
+				if (repack) {
+					*reinterpret_cast<float*>(target) = ((float)param);
+				}
+				break;
+			}
 		}
-		commandList.SetResourceState(mesh->GetIndexBuffer(), gxapi::eResourceState::INDEX_BUFFER);
-		commandList.SetVertexBuffers(0, (unsigned)vertexBuffers.size(), vertexBuffers.data(), sizes.data(), strides.data());
-		commandList.SetIndexBuffer(&mesh->GetIndexBuffer(), mesh->IsIndexBuffer32Bit());
+	}
 
-		// Drawcall
-		commandList.DrawIndexedInstanced((unsigned)mesh->GetIndexBuffer().GetIndexCount());
+	// Lists of earlier frames keep the replaced buffer alive until the GPU is done with it.
+	if (changed || !constants.buffer) {
+		constants.buffer.emplace(context.CreatePersistentConstBuffer(constants.data.data(), constants.data.size()));
 	}
+	constants.view.emplace(context.CreateCbv(*constants.buffer));
+	return &*constants.view;
 }
 
 
-
 ForwardRender::ScenarioData& ForwardRender::GetScenario(
 	RenderContext& context,
 	const Mesh::Layout& layout,
 	const Material& material,
 	gxapi::eFormat renderTargetFormat,
 	gxapi::eFormat depthStencilFormat) {
+	// Shaders with the same code have the same id, materials of identical graphs share their pixel shader.
 	const auto& shader = *material.GetShader();
-	std::string shaderCode = shader.GetShaderCode();
+	const UniqueId shaderId = shader.GetId();
 
-	ScenarioDesc key{ layout, shaderCode };
+	ScenarioDesc key{ layout, shaderId };
 	auto scenarioIt = m_scenarios.find(key);
 
 	// Create scenario PSO if needed
 	if (scenarioIt == m_scenarios.end()) {
 		auto vsIt = m_vertexShaders.find(layout);
-		auto psIt = m_materialShaders.find(shaderCode);
+		auto psIt = m_materialShaders.find(shaderId);
 
 		// Compile vertex shader if needed
 		if (vsIt == m_vertexShaders.end()) {
@@ -455,12 +749,15 @@ ForwardRender::ScenarioData& ForwardRender::GetScenario(
 			vsIt = res.first;
 		}
 
+		// Bindless support does not change while the engine runs, the cached pixel shaders don't depend on it.
+		const bool bindless = context.IsBindlessSupported();
+
 		// Compile pixel shader if needed
 		if (psIt == m_materialShaders.end()) {
-			std::string psCode = GeneratePixelShader(material);
+			std::string psCode = GeneratePixelShader(material, bindless);
 			ShaderParts psParts;
 			psParts.ps = true;
-			auto res = m_materialShaders.insert({ shaderCode, context.CompileShader(psCode, psParts, "") });
+			auto res = m_materialShaders.insert({ shaderId, context.CompileShader(psCode, psParts, "") });
 			psIt = res.first;
 		}
 
@@ -470,7 +767,7 @@ ForwardRender::ScenarioData& ForwardRender::GetScenario(
 		size_t constantsSize;
 		Binder binder;
 
-		binder = GenerateBinder(context, material, offsets, constantsSize);
+		binder = GenerateBinder(context, material, bindless, offsets, constantsSize);
 		pso = CreatePso(context, binder, vsIt->second.vs, psIt->second.ps, renderTargetFormat, depthStencilFormat);
 
 		auto res = m_scenarios.insert({ key, ScenarioData() });
@@ -481,11 +778,13 @@ ForwardRender::ScenarioData& ForwardRender::GetScenario(
 		scenarioIt->second.offsets = std::move(offsets);
 		scenarioIt->second.binder = std::move(binder);
 		scenarioIt->second.constantsSize = constantsSize;
+		scenarioIt->second.bindless = bindless;
+		ResolveSlots(scenarioIt->second, material);
 	}
 	else if (scenarioIt->second.renderTargetFormat != renderTargetFormat
 			 || scenarioIt->second.depthStencilFormat != depthStencilFormat) {
 		auto& vs = m_vertexShaders.at(layout).vs;
-		auto& ps = m_materialShaders.at(shaderCode).ps;
+		auto& ps = m_materialShaders.at(shaderId).ps;
 
 		auto newPso = CreatePso(context, scenarioIt->second.binder, vs, ps, renderTargetFormat, depthStencilFormat);
 
@@ -517,14 +816,14 @@ std::string ForwardRender::GenerateVertexShader(const Mesh::Layout& layout) {
 		"Texture2D<float4> lightMVPTex : register(t503);"
 		"struct VsConstants \n"
 		"{\n"
-		"	float4x4 MVP;\n"
-		"	float4x4 prevMVP;\n"
-		"	float4x4 MV;\n"
-		"	float4x4 M;\n"
+		"	float4x4 VP;\n"
+		"	float4x4 prevVP;\n"
 		"	float4x4 V;\n"
 		"	float4x4 P;\n"
+		"	uint instanceOffset;\n"
 		"};\n"
 		"ConstantBuffer<VsConstants> vsConstants : register(b0);\n"
+		"StructuredBuffer<float4x4> instanceTransforms : register(t400);\n"
 
 		"struct PS_Input\n"
 		"{\n"
@@ -537,11 +836,24 @@ std::string ForwardRender::GenerateVertexShader(const Mesh::Layout& layout) {
 		"	float4 currPosition : TEX_COORD4;\n"
 		"};\n"
 
-		"PS_Input VSMain(float4 position : POSITION, float4 normal : NORMAL, float4 texCoord : TEX_COORD)\n"
+		// Normals are folded onto a square, see VertexCompressor.
+		"float3 DecodeOctahedral(float2 encoded)\n"
+		"{\n"
+		"	float3 direction = float3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));\n"
+		"	float fold = saturate(-direction.z);\n"
+		"	direction.xy += direction.xy >= 0.0 ? -fold : fold;\n"
+		"	return normalize(direction);\n"
+		"}\n"
+
+		"PS_Input VSMain(float4 position : POSITION, float2 encodedNormal : NORMAL, float4 texCoord : TEX_COORD, uint instanceId : SV_InstanceID)\n"
 		"{\n"
 		"	PS_Input result;\n"
+		"	float3 normal = DecodeOctahedral(encodedNormal);\n"
+		// SV_InstanceID does not include the start instance, hence the explicit offset.
+		"	float4x4 M = instanceTransforms[vsConstants.instanceOffset + instanceId];\n"
+		"	float4x4 MV = mul(M, vsConstants.V);\n"
 		//"	normal.xyz = normalize(normal.xyz);\n"
-		"	float3 viewNormal = mul(normal.xyz, (float3x3)vsConstants.MV);\n"
+		"	float3 viewNormal = mul(normal, (float3x3)MV);\n"
 
 		"float4x4 lightMvp;\n"
 		"float cascade = 0;\n"
@@ -550,15 +862,14 @@ std::string ForwardRender::GenerateVertexShader(const Mesh::Layout& layout) {
 		"	lightMvp[d] = lightMVPTex.Load(int3(cascade * 4 + d, 0, 0));\n"
 		"}\n"
 
-		"	result.position = mul(position, vsConstants.MVP);\n"
-		"	result.prevPosition = mul(position, vsConstants.prevMVP);\n"
+		"	float4 worldPosition = mul(position, M);\n"
+		"	result.position = mul(worldPosition, vsConstants.VP);\n"
+		"	result.prevPosition = mul(worldPosition, vsConstants.prevVP);\n"
 		"	result.currPosition = result.position;\n"
-		//"	result.position = mul(mul(light_mvp, vsConstants.MV), position);\n"
-		//"	result.position = mul(mul(vsConstants.P, mul(light_mvp, vsConstants.M)), position);\n"
-		"	result.vsPosition = mul(position, vsConstants.MV);\n"
+		"	result.vsPosition = mul(position, MV);\n"
 		"	result.normal = viewNormal;\n"
 		"	result.texCoord = texCoord.xy;\n"
-		"	result.wsNormal = normal.xyz;\n"
+		"	result.wsNormal = normal;\n"
 
 		"	return result;\n"
 		"}";
@@ -566,7 +877,7 @@ std::string ForwardRender::GenerateVertexShader(const Mesh::Layout& layout) {
 	return vertexShader;
 }
 
-std::string ForwardRender::GeneratePixelShader(const Material& material) {
+std::string ForwardRender::GeneratePixelShader(const Material& material, bool bindless) {
 	// get material shading function's HLSL code
 	const auto& shader = *material.GetShader();
 	std::string shadingFunction = shader.GetShaderCode();
@@ -637,17 +948,34 @@ std::string ForwardRender::GeneratePixelShader(const Material& material) {
 				break;
 			}
 			case eMaterialShaderParamType::BITMAP_COLOR_2D: {
-				textures << "Texture2DArray<float4> tex" << i << " : register(t" << i << "); \n";
+				if (bindless) {
+					mtlConstantBuffer << "    uint param" << i << "; \n";
+					++numMtlConstants;
+				}
+				else {
+					textures << "Texture2DArray<float4> tex" << i << " : register(t" << i << "); \n";
+				}
 				textures << "SamplerState samp" << i << " : register(s" << i << "); \n";
 				break;
 			}
 			case eMaterialShaderParamType::BITMAP_VALUE_2D: {
-				textures << "Texture2DArray<float> tex" << i << " : register(t" << i << "); \n";
+				if (bindless) {
+					mtlConstantBuffer << "    uint param" << i << "; \n";
+					++numMtlConstants;
+				}
+				else {
+					textures << "Texture2DArray<float> tex" << i << " : register(t" << i << "); \n";
+				}
 				textures << "SamplerState samp" << i << " : register(s" << i << "); \n";
 				break;
 			}
 		}
 	}
+	if (bindless) {
+		// Both arrays cover the whole bindless heap, the index in the material constants selects the texture.
+		textures << "Texture2DArray<float4> g_bindlessColor[] : register(t0, space100); \n";
+		textures << "Texture2DArray<float> g_bindlessValue[] : register(t0, space101); \n";
+	}
 	mtlConstantBuffer << "};\n";
 	mtlConstantBuffer << "ConstantBuffer<MtlConstants> mtlCb: register(b200); \n";
 	if (numMtlConstants == 0) {
@@ -684,13 +1012,23 @@ std::string ForwardRender::GeneratePixelShader(const Material& material) {
 			}
 			case eMaterialShaderParamType::BITMAP_COLOR_2D: {
 				PSMain << "    MapColor2D input" << i << "; \n";
-				PSMain << "    input" << i << ".tex = tex" << i << "; \n";
+				if (bindless) {
+					PSMain << "    input" << i << ".tex = g_bindlessColor[mtlCb.param" << i << "]; \n";
+				}
+				else {
+					PSMain << "    input" << i << ".tex = tex" << i << "; \n";
+				}
 				PSMain << "    input" << i << ".samp = samp" << i << "; \n\n";
 				break;
 			}
 			case eMaterialShaderParamType::BITMAP_VALUE_2D: {
 				PSMain << "    MapValue2D input" << i << "; \n";
-				PSMain << "    input" << i << ".tex = tex" << i << "; \n";
+				if (bindless) {
+					PSMain << "    input" << i << ".tex = g_bindlessValue[mtlCb.param" << i << "]; \n";
+				}
+				else {
+					PSMain << "    input" << i << ".tex = tex" << i << "; \n";
+				}
 				PSMain << "    input" << i << ".samp = samp" << i << "; \n\n";
 				break;
 			}
@@ -738,7 +1076,7 @@ std::string ForwardRender::GeneratePixelShader(const Material& material) {
 		   + "\n//-------------------------------------\n\n"
 		   + "#include \"LightingUniforms\"\n"
 		   + "#include \"PbrBrdf\"\n"
-		   + "#include \"TiledLighting\"\n"
+		   + "#include \"ClusteredLighting\"\n"
 		   + "#include \"EncodeDecode\"\n"
 		   + "\n//-------------------------------------\n\n"
 		   + shadingFunction
@@ -746,7 +1084,30 @@ std::string ForwardRender::GeneratePixelShader(const Material& material) {
 		   + PSMain.str();
 }
 
-Binder ForwardRender::GenerateBinder(RenderContext& context, const Material& material, std::vector<int>& offsets, size_t& materialCbSize) {
+void ForwardRender::ResolveSlots(ScenarioData& scenario, const Material& material) {
+	const Binder& binder = scenario.binder;
+	scenario.vsConstantsSlot = binder.Resolve(BindParameter(eBindParameterType::CONSTANT, 0));
+	scenario.instancesSlot = binder.Resolve(BindParameter(eBindParameterType::TEXTURE, 400));
+	scenario.lightConstantsSlot = binder.Resolve(BindParameter(eBindParameterType::CONSTANT, 100));
+	scenario.uniformsSlot = binder.Resolve(BindParameter(eBindParameterType::CONSTANT, 600));
+	scenario.materialConstantsSlot = binder.Resolve(BindParameter(eBindParameterType::CONSTANT, 200));
+	scenario.lightCullDataSlot = binder.Resolve(BindParameter(eBindParameterType::TEXTURE, 600));
+	scenario.screenSpaceShadowSlot = binder.Resolve(BindParameter(eBindParameterType::TEXTURE, 601));
+	scenario.layeredShadowSlot = binder.Resolve(BindParameter(eBindParameterType::TEXTURE, 602));
+	scenario.lightsSlot = binder.Resolve(BindParameter(eBindParameterType::TEXTURE, 603));
+	scenario.lightIndicesSlot = binder.Resolve(BindParameter(eBindParameterType::TEXTURE, 604));
+
+	scenario.textureSlots.assign(material.GetParameterCount(), BindSlot{});
+	for (size_t paramIdx = 0; paramIdx < material.GetParameterCount(); ++paramIdx) {
+		const auto type = material[paramIdx].GetType();
+		if (!scenario.bindless && (type == eMaterialShaderParamType::BITMAP_COLOR_2D || type == eMaterialShaderParamType::BITMAP_VALUE_2D)) {
+			scenario.textureSlots[paramIdx] = binder.Resolve(BindParameter(eBindParameterType::TEXTURE, scenario.offsets[paramIdx]));
+		}
+	}
+}
+
+
+Binder ForwardRender::GenerateBinder(RenderContext& context, const Material& material, bool bindless, std::vector<int>& offsets, size_t& materialCbSize) {
 	int textureRegister = 0;
 	int cbSize = 0;
 	std::vector<BindParameterDesc> descs;
@@ -757,6 +1118,15 @@ Binder ForwardRender::GenerateBinder(RenderContext& context, const Material& mat
 		switch (param.GetType()) {
 			case eMaterialShaderParamType::BITMAP_COLOR_2D: [[fallthrough]];
 			case eMaterialShaderParamType::BITMAP_VALUE_2D: {
+				if (bindless) {
+					// Index into the bindless heap, the sampler is still per texture.
+					cbSize = ((cbSize + 3) / 4) * 4; // correct alignement
+					offsets.push_back(cbSize);
+					cbSize += sizeof(uint32_t);
+					++textureRegister;
+					break;
+				}
+
 				BindParameterDesc desc;
 				desc.parameter = BindParameter(eBindParameterType::TEXTURE, textureRegister);
 				desc.constantSize = 0;
@@ -828,6 +1198,12 @@ Binder ForwardRender::GenerateBinder(RenderContext& context, const Material& mat
 	layeredShadowTexBindParamDesc.relativeChangeFrequency = 0;
 	layeredShadowTexBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
 
+	BindParameterDesc lightsBindParamDesc = lightCullDataBindParamDesc;
+	lightsBindParamDesc.parameter = BindParameter(eBindParameterType::TEXTURE, 603);
+
+	BindParameterDesc lightIndicesBindParamDesc = lightCullDataBindParamDesc;
+	lightIndicesBindParamDesc.parameter = BindParameter(eBindParameterType::TEXTURE, 604);
+
 	BindParameterDesc lightUniformsCbDesc;
 	lightUniformsCbDesc.parameter = BindParameter(eBindParameterType::CONSTANT, 600);
 	lightUniformsCbDesc.constantSize = sizeof(Uniforms);
@@ -842,6 +1218,13 @@ Binder ForwardRender::GenerateBinder(RenderContext& context, const Material& mat
 	vsCbDesc.relativeChangeFrequency = 0;
 	vsCbDesc.shaderVisibility = gxapi::eShaderVisiblity::VERTEX;
 
+	BindParameterDesc instanceTransformsDesc;
+	instanceTransformsDesc.parameter = BindParameter(eBindParameterType::TEXTURE, 400);
+	instanceTransformsDesc.constantSize = 0;
+	instanceTransformsDesc.relativeAccessFrequency = 0;
+	instanceTransformsDesc.relativeChangeFrequency = 0;
+	instanceTransformsDesc.shaderVisibility = gxapi::eShaderVisiblity::VERTEX;
+
 	BindParameterDesc lightCbDesc;
 	lightCbDesc.parameter = BindParameter(eBindParameterType::CONSTANT, 100);
 	lightCbDesc.constantSize = sizeof(LightConstants);
@@ -851,7 +1234,7 @@ Binder ForwardRender::GenerateBinder(RenderContext& context, const Material& mat
 
 	BindParameterDesc mtlCbDesc;
 	mtlCbDesc.parameter = BindParameter(eBindParameterType::CONSTANT, 200);
-	mtlCbDesc.constantSize = cbSize;
+	mtlCbDesc.constantSize = 0; // Bound as a CBV, the constants are kept in a buffer per material.
 	mtlCbDesc.relativeAccessFrequency = 0;
 	mtlCbDesc.relativeChangeFrequency = 0;
 	mtlCbDesc.shaderVisibility = gxapi::eShaderVisiblity::PIXEL;
@@ -874,6 +1257,7 @@ Binder ForwardRender::GenerateBinder(RenderContext& context, const Material& mat
 	samplerParam.shaderVisibility = gxapi::eShaderVisiblity::PIXEL;
 
 	descs.push_back(vsCbDesc);
+	descs.push_back(instanceTransformsDesc);
 	descs.push_back(lightCbDesc);
 	descs.push_back(lightUniformsCbDesc);
 
@@ -881,12 +1265,26 @@ Binder ForwardRender::GenerateBinder(RenderContext& context, const Material& mat
 	descs.push_back(layeredShadowTexBindParamDesc);
 
 	descs.push_back(lightCullDataBindParamDesc);
+	descs.push_back(lightsBindParamDesc);
+	descs.push_back(lightIndicesBindParamDesc);
 	descs.push_back(screenSpaceShadowTexBindParamDesc);
 
 	if (cbSize > 0) {
 		descs.push_back(mtlCbDesc);
 	}
 
+	if (bindless && textureRegister > 0) {
+		BindParameterDesc bindlessDesc;
+		bindlessDesc.parameter = BindParameter(eBindParameterType::TEXTURE, 0, 100);
+		bindlessDesc.relativeAccessFrequency = 0;
+		bindlessDesc.relativeChangeFrequency = 0;
+		bindlessDesc.shaderVisibility = gxapi::eShaderVisiblity::PIXEL;
+		bindlessDesc.bindless = true;
+		descs.push_back(bindlessDesc);
+		bindlessDesc.parameter.space = 101;
+		descs.push_back(bindlessDesc);
+	}
+
 	std::vector<gxapi::StaticSamplerDesc> samplerParams;
 	for (int i = 0; i < textureRegister; ++i) {
 		samplerDesc.parameter.reg = i;
@@ -913,9 +1311,9 @@ std::unique_ptr<gxapi::IPipelineState> ForwardRender::CreatePso(
 	std::unique_ptr<gxapi::IPipelineState> result;
 
 	std::vector<gxapi::InputElementDesc> inputElementDesc = {
-		gxapi::InputElementDesc("POSITION", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 0),
-		gxapi::InputElementDesc("NORMAL", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 12),
-		gxapi::InputElementDesc("TEX_COORD", 0, gxapi::eFormat::R32G32_FLOAT, 0, 24),
+		gxapi::InputElementDesc("POSITION", 0, gxapi::eFormat::R16G16B16A16_UNORM, 0, 0),
+		gxapi::InputElementDesc("NORMAL", 0, gxapi::eFormat::R16G16_SNORM, 0, 8),
+		gxapi::InputElementDesc("TEX_COORD", 0, gxapi::eFormat::R16G16_FLOAT, 0, 12),
 	};
 
 	gxapi::GraphicsPipelineStateDesc psoDesc;
@@ -929,7 +1327,8 @@ std::unique_ptr<gxapi::IPipelineState> ForwardRender::CreatePso(
 
 	//psoDesc.depthStencilState = gxapi::DepthStencilState(false, true);
 	psoDesc.depthStencilState = gxapi::DepthStencilState(true, true);
-	psoDesc.depthStencilState.depthFunc = gxapi::eComparisonFunction::EQUAL;
+	// Equal for what the depth prepass drew, less for what an adaptive prepass left out.
+	psoDesc.depthStencilState.depthFunc = gxapi::eComparisonFunction::LESS_EQUAL;
 	psoDesc.depthStencilState.enableStencilTest = true;
 	psoDesc.depthStencilState.stencilReadMask = 0;
 	psoDesc.depthStencilState.stencilWriteMask = ~uint8_t(0);
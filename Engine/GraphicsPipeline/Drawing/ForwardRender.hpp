@@ -1,19 +1,33 @@
 #pragma once
 
+#include "ClusteredLightCulling.hpp"
+
+#include <BaseLibrary/UniqueIdGenerator.hpp>
 #include <GraphicsApi_LL/IPipelineState.hpp>
 #include <GraphicsEngine_LL/BasicCamera.hpp>
 #include <GraphicsEngine_LL/DirectionalLight.hpp>
 #include <GraphicsEngine_LL/GraphicsNode.hpp>
+#include <GraphicsEngine_LL/InstanceBatcher.hpp>
+#include <GraphicsEngine_LL/InstanceBuffer.hpp>
 #include <GraphicsEngine_LL/Material.hpp>
 #include <GraphicsEngine_LL/Mesh.hpp>
+#include <GraphicsEngine_LL/RenderQueue.hpp>
+#include <GraphicsEngine_LL/ViewSet.hpp>
 
 #include <optional>
 
 namespace inl::gxeng::nodes {
 
 /// <summary>
-/// Inputs: target, depth stencil, entities, camera, directional lights, shadow map, shadowMX, csmSplits, lightMVP, point light shadow map
+/// Inputs: target, depth stencil, entities, camera, directional lights, layered shadow map, light clusters, screen space shadow,
+/// shading rate image (optional), views (optional).
 /// </summary>
+/// <remarks>
+/// When a shading rate image is linked, it overrides the full rate of every draw, see <see cref="ShadingRateImage"/>.
+/// When views are linked, each one is drawn into its region of the target. The entities are sorted and batched once,
+/// and every batch is drawn for the views that see it, in the same pass. The camera input remains the one
+/// the lights and shadows were prepared for, and the depth of the prepass is not used as it only matches that camera.
+/// </remarks>
 class ForwardRender : virtual public GraphicsNode,
 					  virtual public GraphicsTask,
 
@@ -24,13 +38,15 @@ class ForwardRender : virtual public GraphicsNode,
 						  const BasicCamera*,
 						  const EntityCollection<DirectionalLight>*,
 						  Texture2D,
+						  LightClusters,
+						  Texture2D,
 						  Texture2D,
-						  Texture2D>,
+						  const ViewSet*>,
 					  virtual public OutputPortConfig<Texture2D, Texture2D, Texture2D> {
 private:
 	struct ScenarioDesc {
 		Mesh::Layout layout;
-		std::string shader;
+		UniqueId shader;
 	};
 	struct ScenarioData {
 		std::unique_ptr<gxapi::IPipelineState> pso;
@@ -39,19 +55,41 @@ private:
 		Binder binder;
 		std::vector<int> offsets;
 		size_t constantsSize;
+		bool bindless = false; // Textures are indexed from the bindless heap, offsets of texture parameters are for their indices.
+
+		// Resolved once the binder is in place.
+		BindSlot vsConstantsSlot;
+		BindSlot instancesSlot;
+		BindSlot lightConstantsSlot;
+		BindSlot uniformsSlot;
+		BindSlot materialConstantsSlot;
+		BindSlot lightCullDataSlot;
+		BindSlot screenSpaceShadowSlot;
+		BindSlot layeredShadowSlot;
+		BindSlot lightsSlot;
+		BindSlot lightIndicesSlot;
+		std::vector<BindSlot> textureSlots; // By material parameter, only set for textures that are not bindless.
+	};
+	struct MaterialConstants {
+		uint64_t version = 0; // Of the material the constants were packed from.
+		std::vector<uint8_t> data; // As the pixel shader reads them, with the bindless indices of textures.
+		std::optional<PersistentConstBuffer> buffer;
+		std::optional<ConstBufferView> view; // Views are per frame, created when the material is first drawn in one.
+		uint64_t lastFrame = 0;
 	};
 	struct VsConstants {
-		Mat44_Packed mvp;
-		Mat44_Packed prevMVP;
-		Mat44_Packed mv;
-		Mat44_Packed m;
+		Mat44_Packed vp;
+		Mat44_Packed prevVP;
 		Mat44_Packed v;
 		Mat44_Packed p;
+		alignas(16) uint32_t instanceOffset; // First world matrix of the batch in the instance buffer.
 	};
 	struct LightConstants {
 		alignas(16) Vec3_Packed direction;
 		alignas(16) Vec3_Packed color;
 	};
+	struct ViewState;
+	struct FrameState;
 
 public:
 	static const char* Info_GetName() { return "ForwardRender"; }
@@ -68,9 +106,30 @@ public:
 	void Execute(RenderContext& context) override;
 
 private:
+	void BuildBatches(SetupContext& context);
+	/// <summary> Tells streamed material images which levels the visible entities need. </summary>
+	void RequestMips(uint32_t targetHeight) const;
+
+	/// <summary> Sets the resource states and render targets the draws need. </summary>
+	void SetDrawStates(GraphicsCommandList& commandList);
+	/// <summary> Fills in the constants and the region of the target a camera is drawn with. </summary>
+	void SetupView(ViewState& state, const BasicCamera& camera, float left, float top, float width, float height) const;
+	/// <summary> Records the batches in [firstBatch, lastBatch), using the pipeline states resolved in advance. </summary>
+	/// <remarks> Does not modify the node, several lists may be recorded at the same time. </remarks>
+	void RecordBatches(const RenderContext& context,
+					   GraphicsCommandList& commandList,
+					   const FrameState& frame,
+					   size_t firstBatch,
+					   size_t lastBatch,
+					   const ScenarioData* const* scenarios,
+					   const ConstBufferView* const* materialCbvs) const;
+	/// <summary> Returns the constants of the material, they are only packed and uploaded again if the material has changed. </summary>
+	/// <returns> Null if the material has no constants. </returns>
+	const ConstBufferView* GetMaterialConstants(RenderContext& context, const Material& material, const ScenarioData& scenario);
+
 	static std::string GenerateVertexShader(const Mesh::Layout& layout);
-	static std::string GeneratePixelShader(const Material& shader);
-	Binder GenerateBinder(RenderContext& context, const Material& mtlParams, std::vector<int>& offsets, size_t& materialCbSize);
+	static std::string GeneratePixelShader(const Material& shader, bool bindless);
+	Binder GenerateBinder(RenderContext& context, const Material& mtlParams, bool bindless, std::vector<int>& offsets, size_t& materialCbSize);
 	std::unique_ptr<gxapi::IPipelineState> CreatePso(
 		RenderContext& context,
 		Binder& binder,
@@ -79,6 +138,7 @@ private:
 		gxapi::eFormat renderTargetFormat,
 		gxapi::eFormat depthStencilFormat);
 
+	static void ResolveSlots(ScenarioData& scenario, const Material& material);
 	ScenarioData& GetScenario(
 		RenderContext& context,
 		const Mesh::Layout& layout,
@@ -102,11 +162,26 @@ private:
 	DepthStencilView2D m_targetDSV;
 	const EntityCollection<MeshEntity>* m_entities;
 	const BasicCamera* m_camera;
+	const ViewSet* m_views; // Null if a single camera fills the target.
 	std::optional<const EntityCollection<DirectionalLight>*> m_directionalLights;
 
-	TextureView2D m_lightCullDataView;
+	LightClusters m_lightClusters;
+	BufferView m_lightCullDataView; // Offset and count of each cluster's list.
+	BufferView m_lightIndicesView;
+	BufferView m_lightsView;
 	TextureView2D m_layeredShadowTexView;
 	std::optional<TextureView2D> m_screenSpaceShadowTexView;
+	std::optional<Texture2D> m_shadingRateTex;
+
+	RenderQueue m_renderQueue;
+	InstanceBatcher m_batcher;
+	InstanceBuffer m_instanceBuffer;
+
+	// A list records at least this many batches, smaller scenes are not worth splitting.
+	static constexpr size_t MinBatchesPerList = 64;
+
+	// Constants of materials that were not drawn for this many frames are released.
+	static constexpr uint64_t MaterialConstantsLifetime = 240;
 
 private:
 	struct ElementHash {
@@ -114,14 +189,16 @@ private:
 		size_t operator()(const Mesh::Layout& lhs, const Mesh::Layout& rhs) const { return lhs.EqualElements(rhs); }
 	};
 	struct ScenarioHash {
-		size_t operator()(const ScenarioDesc& obj) const { return obj.layout.GetLayoutHash() ^ std::hash<std::string>()(obj.shader); }
+		size_t operator()(const ScenarioDesc& obj) const { return obj.layout.GetLayoutHash() ^ obj.shader.Hash(); }
 		size_t operator()(const ScenarioDesc& lhs, const ScenarioDesc& rhs) const {
 			return lhs.layout.EqualLayout(rhs.layout) && lhs.shader == rhs.shader;
 		}
 	};
-	std::unordered_map<std::string, ShaderProgram> m_materialShaders; // maps MaterialShader codes to pixel shaders
+	std::unordered_map<UniqueId, ShaderProgram> m_materialShaders; // maps MaterialShader code ids to pixel shaders
 	std::unordered_map<Mesh::Layout, ShaderProgram, ElementHash, ElementHash> m_vertexShaders; // maps Mesh layouts to vertex shaders
 	std::unordered_map<ScenarioDesc, ScenarioData, ScenarioHash, ScenarioHash> m_scenarios; // maps mesh-mtlshader pairs to PSOs
+	std::unordered_map<const Material*, MaterialConstants> m_materialConstants;
+	uint64_t m_frameIndex = 0;
 };
 
 } // namespace inl::gxeng::nodes
@@ -0,0 +1,225 @@
+#include "FrustumCull.hpp"
+
+#include <GraphicsEngine_LL/AutoRegisterNode.hpp>
+#include <GraphicsEngine_LL/BoundingVolumes.hpp>
+#include <GraphicsEngine_LL/LodSelector.hpp>
+#include <GraphicsEngine_LL/Mesh.hpp>
+
+#include <BaseLibrary/JobSystem/Parallel.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#define INL_FRUSTUM_CULL_SSE
+#endif
+
+
+namespace inl::gxeng::nodes {
+
+
+INL_REGISTER_GRAPHICS_NODE(FrustumCull)
+
+
+static constexpr size_t ChunkSize = 256; // Must be a multiple of 4.
+
+
+void FrustumCull::Initialize(EngineContext& context) {
+	GraphicsNode::SetTaskSingle(this);
+}
+
+
+void FrustumCull::Reset() {
+	m_entities = nullptr;
+	m_visibleEntities.Clear();
+	m_views.Clear();
+
+	GetInput<0>().Clear();
+	GetInput<1>().Clear();
+	GetInput<2>().Clear();
+	GetInput<3>().Clear();
+	GetInput<4>().Clear();
+}
+
+
+const std::string& FrustumCull::GetInputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"entities",
+		"camera",
+		"camera1",
+		"camera2",
+		"camera3",
+	};
+	return names[index];
+}
+
+
+const std::string& FrustumCull::GetOutputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"visibleEntities",
+		"views",
+	};
+	return names[index];
+}
+
+
+void FrustumCull::Setup(SetupContext& context) {
+	const EntityCollection<MeshEntity>* entities = GetInput<0>().Get();
+	const BasicCamera* camera = GetInput<1>().Get();
+	if (!entities || !camera) {
+		throw InvalidArgumentException("Both entities and camera must be connected.");
+	}
+
+	// The extra cameras are optional, the ones linked share the target as split screen views.
+	const BasicCamera* cameras[ViewSet::MaxViews] = { camera };
+	size_t cameraCount = 1;
+	for (const BasicCamera* extraCamera : { GetInput<2>().Get(), GetInput<3>().Get(), GetInput<4>().Get() }) {
+		if (extraCamera) {
+			cameras[cameraCount++] = extraCamera;
+		}
+	}
+	m_views.Clear();
+	m_views.AddSplitScreen(cameras, cameraCount);
+
+	const size_t count = entities->Size();
+	const size_t paddedCount = (count + 3) / 4 * 4;
+	m_entities = entities->Data();
+	for (auto& component : m_boxes) {
+		component.resize(paddedCount);
+	}
+	m_visible.resize(paddedCount);
+
+	// Padding is never culled.
+	for (size_t i = count; i < paddedCount; ++i) {
+		m_boxes[0][i] = m_boxes[1][i] = m_boxes[2][i] = 0.0f;
+		m_boxes[3][i] = m_boxes[4][i] = m_boxes[5][i] = std::numeric_limits<float>::max();
+	}
+
+	Frustum frustums[ViewSet::MaxViews];
+	for (size_t i = 0; i < cameraCount; ++i) {
+		frustums[i] = Frustum{ cameras[i]->GetViewMatrix() * cameras[i]->GetProjectionMatrix() };
+	}
+	jobs::CooperativeFor(context.GetJobScheduler(), count, ChunkSize, [this, &frustums, cameraCount](size_t first, size_t last) {
+		CullRange(first, last, frustums, cameraCount);
+		SelectLods(first, last);
+	});
+
+	// A single view sees everything that is kept, masks are only needed to tell views apart.
+	m_visibleEntities.Clear();
+	m_visibleEntities.Reserve(count);
+	if (cameraCount > 1) {
+		m_views.ReserveMasks(count);
+	}
+	for (size_t i = 0; i < count; ++i) {
+		if (m_visible[i]) {
+			m_visibleEntities.Add(m_entities[i]);
+			if (cameraCount > 1) {
+				m_views.SetMask(m_entities[i], m_visible[i]);
+			}
+		}
+	}
+
+	GetOutput<0>().Set(&m_visibleEntities);
+	GetOutput<1>().Set(&m_views);
+}
+
+
+void FrustumCull::SelectLods(size_t first, size_t last) {
+	// Uses the boxes gathered by CullRange, only for the visible entities.
+	for (size_t i = first; i < last; ++i) {
+		const Mesh* mesh = m_entities[i]->GetMesh();
+		if (!m_visible[i] || !mesh || mesh->GetLodCount() <= 1) {
+			continue;
+		}
+		Vec3 center = { m_boxes[0][i], m_boxes[1][i], m_boxes[2][i] };
+		Vec3 extent = { m_boxes[3][i], m_boxes[4][i], m_boxes[5][i] };
+		BoundingSphere sphere{ center, extent.Length() };
+		float screenSize = 0.0f;
+		for (size_t view = 0; view < m_views.GetViewCount(); ++view) {
+			if (m_visible[i] & (1u << view)) {
+				// Views cover a part of the target only, their pixels are what the level is chosen for.
+				screenSize = std::max(screenSize, LodSelector::ScreenSize(sphere, *m_views[view].camera) * m_views[view].height);
+			}
+		}
+		m_entities[i]->SetLod(LodSelector::Select(screenSize, uint32_t(mesh->GetLodCount()), m_entities[i]->GetLod()));
+	}
+}
+
+
+void FrustumCull::CullRange(size_t first, size_t last, const Frustum* frustums, size_t frustumCount) {
+	// Gather world space boxes.
+	for (size_t i = first; i < last; ++i) {
+		BoundingBox bounds = m_entities[i]->GetLocalBounds();
+		Vec3 center, extent;
+		if (bounds.IsEmpty()) {
+			center = Vec3(0.0f);
+			extent = Vec3(std::numeric_limits<float>::max());
+		}
+		else {
+			bounds = bounds.Transformed(m_entities[i]->GetTransform());
+			center = bounds.GetCenter();
+			extent = bounds.GetExtent();
+		}
+		m_boxes[0][i] = center.x;
+		m_boxes[1][i] = center.y;
+		m_boxes[2][i] = center.z;
+		m_boxes[3][i] = extent.x;
+		m_boxes[4][i] = extent.y;
+		m_boxes[5][i] = extent.z;
+	}
+
+	// A box is outside if it is entirely behind any of the planes.
+	// Chunks start at multiples of 4, and the arrays are padded, so groups never straddle chunks.
+	// Boxes are loaded once and tested against every view.
+	const float* cx = m_boxes[0].data();
+	const float* cy = m_boxes[1].data();
+	const float* cz = m_boxes[2].data();
+	const float* ex = m_boxes[3].data();
+	const float* ey = m_boxes[4].data();
+	const float* ez = m_boxes[5].data();
+	for (size_t i = first; i < last; i += 4) {
+#ifdef INL_FRUSTUM_CULL_SSE
+		__m128 centerX = _mm_loadu_ps(cx + i), centerY = _mm_loadu_ps(cy + i), centerZ = _mm_loadu_ps(cz + i);
+		__m128 extentX = _mm_loadu_ps(ex + i), extentY = _mm_loadu_ps(ey + i), extentZ = _mm_loadu_ps(ez + i);
+		uint8_t visible[4] = { 0, 0, 0, 0 };
+		for (size_t view = 0; view < frustumCount; ++view) {
+			__m128 outside = _mm_setzero_ps();
+			for (auto& plane : frustums[view].GetPlanes()) {
+				__m128 distance = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), centerX), _mm_mul_ps(_mm_set1_ps(plane.y), centerY)),
+					_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), centerZ), _mm_set1_ps(plane.w)));
+				__m128 radius = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), extentX), _mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), extentY)),
+					_mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), extentZ));
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+			}
+			int outsideMask = _mm_movemask_ps(outside);
+			for (int lane = 0; lane < 4; ++lane) {
+				visible[lane] |= uint8_t(((outsideMask >> lane) & 1) == 0) << view;
+			}
+		}
+		for (int lane = 0; lane < 4; ++lane) {
+			m_visible[i + lane] = visible[lane];
+		}
+#else
+		for (size_t j = i; j < i + 4; ++j) {
+			uint8_t visible = 0;
+			for (size_t view = 0; view < frustumCount; ++view) {
+				bool outside = false;
+				for (auto& plane : frustums[view].GetPlanes()) {
+					float distance = plane.x * cx[j] + plane.y * cy[j] + plane.z * cz[j] + plane.w;
+					float radius = std::abs(plane.x) * ex[j] + std::abs(plane.y) * ey[j] + std::abs(plane.z) * ez[j];
+					outside = outside || distance + radius < 0.0f;
+				}
+				visible |= uint8_t(!outside) << view;
+			}
+			m_visible[j] = visible;
+		}
+#endif
+	}
+}
+
+
+} // namespace inl::gxeng::nodes
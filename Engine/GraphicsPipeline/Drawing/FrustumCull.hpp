@@ -0,0 +1,64 @@
+#pragma once
+
+#include <GraphicsEngine_LL/BasicCamera.hpp>
+#include <GraphicsEngine_LL/GraphicsNode.hpp>
+#include <GraphicsEngine_LL/MeshEntity.hpp>
+#include <GraphicsEngine_LL/ViewSet.hpp>
+
+#include <vector>
+
+namespace inl::gxeng {
+class Frustum;
+} // namespace inl::gxeng
+
+
+namespace inl::gxeng::nodes {
+
+
+/// <summary>
+/// Removes the mesh entities that are outside the camera's view frustum.
+/// Inputs: entities, camera, camera1, camera2, camera3 (the last three optional).
+/// Outputs: entities that may be visible, views.
+/// </summary>
+/// <remarks>
+/// Entities are tested by their world space bounding box, four at a time,
+/// split across the job system. Entities without a mesh or mesh bounds are always kept.
+/// The level of detail of the visible entities is chosen here as well, so that all passes drawing them agree.
+/// When more cameras are linked, the output is the union of what they see, and the views tell which camera sees what.
+/// The boxes are gathered once for all cameras, and levels of detail follow the camera that sees the entity largest.
+/// </remarks>
+class FrustumCull : virtual public GraphicsNode,
+					virtual public GraphicsTask,
+					virtual public InputPortConfig<const EntityCollection<MeshEntity>*, const BasicCamera*, const BasicCamera*, const BasicCamera*, const BasicCamera*>,
+					virtual public OutputPortConfig<const EntityCollection<MeshEntity>*, const ViewSet*> {
+public:
+	static const char* Info_GetName() { return "FrustumCull"; }
+	const std::string& GetInputName(size_t index) const override;
+	const std::string& GetOutputName(size_t index) const override;
+	FrustumCull() = default;
+
+	void Update() override {}
+	void Notify(InputPortBase* sender) override {}
+
+	void Initialize(EngineContext& context) override;
+	void Reset() override;
+	void Setup(SetupContext& context) override;
+	void Execute(RenderContext& context) override {}
+
+private:
+	void CullRange(size_t first, size_t last, const Frustum* frustums, size_t frustumCount);
+	void SelectLods(size_t first, size_t last);
+
+private:
+	const MeshEntity* const* m_entities = nullptr;
+	EntityCollection<MeshEntity> m_visibleEntities;
+	ViewSet m_views;
+
+	// World space boxes of the entities as centers and extents, one array per component.
+	// Padded to a multiple of four.
+	std::vector<float> m_boxes[6];
+	std::vector<uint8_t> m_visible; // Bit i is set if camera i may see the entity.
+};
+
+
+} // namespace inl::gxeng::nodes
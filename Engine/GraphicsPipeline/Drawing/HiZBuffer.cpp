@@ -0,0 +1,260 @@
+#include "HiZBuffer.hpp"
+
+#include <GraphicsEngine_LL/Nodes/NodeUtility.hpp>
+
+#include <GraphicsEngine_LL/AutoRegisterNode.hpp>
+#include <GraphicsEngine_LL/GraphicsCommandList.hpp>
+
+#include <algorithm>
+
+
+namespace inl::gxeng::nodes {
+
+
+INL_REGISTER_GRAPHICS_NODE(HiZBuffer)
+
+
+static constexpr unsigned GroupSize = 8;
+static constexpr gxapi::eFormat PyramidFormat = gxapi::eFormat::R32G32_FLOAT;
+
+
+static uint64_t MipSize(uint64_t size, unsigned mip) {
+	return std::max(uint64_t(1), size >> mip);
+}
+
+
+HiZBuffer::HiZBuffer() {
+	this->GetInput<0>().Set({});
+}
+
+
+void HiZBuffer::Initialize(EngineContext& context) {
+	SetTaskSingle(this);
+}
+
+
+void HiZBuffer::Reset() {
+	m_depthView = {};
+	m_srv = {};
+	m_mipSrvs.clear();
+	m_mipUavs.clear();
+	for (auto& readback : m_readbacks) {
+		readback = {};
+	}
+	m_pyramid.Clear();
+	m_width = 0;
+	m_height = 0;
+
+	GetInput<0>().Clear();
+	GetInput<1>().Clear();
+}
+
+
+const std::string& HiZBuffer::GetInputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"depthTex",
+		"camera",
+	};
+	return names[index];
+}
+
+
+const std::string& HiZBuffer::GetOutputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"hiZTex",
+		"depthPyramid",
+	};
+	return names[index];
+}
+
+
+void HiZBuffer::Setup(SetupContext& context) {
+	auto& inputDepth = this->GetInput<0>().Get();
+	const BasicCamera* camera = this->GetInput<1>().Get();
+	if (!camera) {
+		throw InvalidArgumentException("Camera must be connected.");
+	}
+
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.numMipLevels = 1;
+	srvDesc.planeIndex = 0;
+	m_depthView = context.CreateSrv(inputDepth, FormatDepthToColor(inputDepth.GetFormat()), srvDesc);
+
+	if (inputDepth.GetWidth() != m_width || inputDepth.GetHeight() != m_height) {
+		m_width = inputDepth.GetWidth();
+		m_height = inputDepth.GetHeight();
+		InitRenderTarget(context);
+	}
+
+	// This slot was copied into ReadbackLatency frames ago, so the GPU is done with it.
+	Readback& readback = m_readbacks[m_currentReadback];
+	if (readback.pending) {
+		ReadPyramid(readback);
+		readback.pending = false;
+	}
+	readback.viewProjection = camera->GetViewMatrix() * camera->GetProjectionMatrix();
+
+	this->GetOutput<0>().Set(m_srv.GetResource());
+	this->GetOutput<1>().Set(&m_pyramid);
+
+	if (!m_binder) {
+		BindParameterDesc inputBindParamDesc;
+		m_inputBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		inputBindParamDesc.parameter = m_inputBindParam;
+		inputBindParamDesc.constantSize = 0;
+		inputBindParamDesc.relativeAccessFrequency = 0;
+		inputBindParamDesc.relativeChangeFrequency = 0;
+		inputBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc outputBindParamDesc;
+		m_outputBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		outputBindParamDesc.parameter = m_outputBindParam;
+		outputBindParamDesc.constantSize = 0;
+		outputBindParamDesc.relativeAccessFrequency = 0;
+		outputBindParamDesc.relativeChangeFrequency = 0;
+		outputBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		m_binder = context.CreateBinder({ inputBindParamDesc, outputBindParamDesc }, {});
+	}
+
+	if (m_depthCSO == nullptr) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_depthShader = context.CreateShader("HiZBuffer", shaderParts, "FROM_DEPTH=1");
+		m_mipShader = context.CreateShader("HiZBuffer", shaderParts, "");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_binder.GetRootSignature();
+
+		csoDesc.cs = m_depthShader.cs;
+		m_depthCSO.reset(context.CreatePSO(csoDesc));
+
+		csoDesc.cs = m_mipShader.cs;
+		m_mipCSO.reset(context.CreatePSO(csoDesc));
+	}
+}
+
+
+void HiZBuffer::Execute(RenderContext& context) {
+	auto& commandList = context.AsCompute();
+	const Texture2D& pyramid = m_srv.GetResource();
+
+	commandList.SetResourceState(m_depthView.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+
+	commandList.SetPipelineState(m_depthCSO.get());
+	commandList.SetComputeBinder(&m_binder);
+	for (unsigned mip = 0; mip < m_mipUavs.size(); ++mip) {
+		if (mip == 1) {
+			commandList.SetPipelineState(m_mipCSO.get());
+			commandList.SetComputeBinder(&m_binder);
+		}
+
+		if (mip == 0) {
+			commandList.BindCompute(m_inputBindParam, m_depthView);
+		}
+		else {
+			commandList.SetResourceState(pyramid, { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE }, pyramid.GetSubresourceIndex(mip - 1, 0, 0));
+			commandList.BindCompute(m_inputBindParam, m_mipSrvs[mip - 1]);
+		}
+		commandList.SetResourceState(pyramid, gxapi::eResourceState::UNORDERED_ACCESS, pyramid.GetSubresourceIndex(mip, 0, 0));
+		commandList.BindCompute(m_outputBindParam, m_mipUavs[mip]);
+
+		uint64_t width = MipSize(pyramid.GetWidth(), mip);
+		uint64_t height = MipSize(pyramid.GetHeight(), mip);
+		commandList.Dispatch(unsigned((width + GroupSize - 1) / GroupSize), unsigned((height + GroupSize - 1) / GroupSize), 1);
+		commandList.UAVBarrier(pyramid);
+	}
+
+	// Copy the coarse level for the CPU.
+	Readback& readback = m_readbacks[m_currentReadback];
+	uint32_t readbackSubresource = pyramid.GetSubresourceIndex(m_readbackMip, 0, 0);
+	commandList.SetResourceState(pyramid, gxapi::eResourceState::COPY_SOURCE, readbackSubresource);
+	commandList.SetResourceState(readback.buffer, gxapi::eResourceState::COPY_DEST);
+	commandList.CopyTexture(readback.buffer,
+							pyramid,
+							SubTexture2D(readbackSubresource),
+							gxapi::TextureCopyDesc::Buffer(PyramidFormat, MipSize(pyramid.GetWidth(), m_readbackMip), (uint32_t)MipSize(pyramid.GetHeight(), m_readbackMip), 1, 0));
+	readback.pending = true;
+	m_currentReadback = (m_currentReadback + 1) % ReadbackLatency;
+}
+
+
+void HiZBuffer::InitRenderTarget(SetupContext& context) {
+	Texture2DDesc texDesc{ MipSize(m_width, 1), (uint32_t)MipSize(m_height, 1), PyramidFormat, 0 };
+	Texture2D tex = context.CreateTexture2D(texDesc, { true, false, false, true });
+	tex.SetName("Hierarchical depth buffer");
+	unsigned numMips = tex.GetNumMiplevels();
+
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.numMipLevels = -1;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.planeIndex = 0;
+	m_srv = context.CreateSrv(tex, PyramidFormat, srvDesc);
+
+	gxapi::UavTexture2DArray uavDesc;
+	uavDesc.activeArraySize = 1;
+	uavDesc.firstArrayElement = 0;
+	uavDesc.planeIndex = 0;
+
+	m_mipSrvs.resize(numMips);
+	m_mipUavs.resize(numMips);
+	for (unsigned mip = 0; mip < numMips; ++mip) {
+		srvDesc.mostDetailedMip = mip;
+		srvDesc.numMipLevels = 1;
+		m_mipSrvs[mip] = context.CreateSrv(tex, PyramidFormat, srvDesc);
+
+		uavDesc.mipLevel = mip;
+		m_mipUavs[mip] = context.CreateUav(tex, PyramidFormat, uavDesc);
+	}
+
+	// Readback buffers of the first level small enough, rows are aligned like for uploads.
+	m_readbackMip = 0;
+	while (m_readbackMip + 1 < numMips
+		   && (MipSize(tex.GetWidth(), m_readbackMip) > ReadbackMaxSize || MipSize(tex.GetHeight(), m_readbackMip) > ReadbackMaxSize)) {
+		++m_readbackMip;
+	}
+	uint64_t readbackWidth = MipSize(tex.GetWidth(), m_readbackMip);
+	uint64_t readbackHeight = MipSize(tex.GetHeight(), m_readbackMip);
+	constexpr size_t pitchAlignment = 256;
+	size_t rowSize = size_t(readbackWidth * gxapi::GetFormatSizeInBytes(PyramidFormat));
+	m_readbackRowPitch = (rowSize + pitchAlignment - 1) / pitchAlignment * pitchAlignment;
+	for (auto& readback : m_readbacks) {
+		readback.buffer = context.CreateReadbackBuffer(m_readbackRowPitch * readbackHeight);
+		readback.buffer.SetName("Hierarchical depth readback");
+		readback.pending = false;
+	}
+	m_readbackDepth.resize(readbackWidth * readbackHeight);
+
+	// Previous contents are from another resolution.
+	m_pyramid.Clear();
+}
+
+
+void HiZBuffer::ReadPyramid(Readback& readback) {
+	const Texture2D& pyramid = m_srv.GetResource();
+	size_t width = MipSize(pyramid.GetWidth(), m_readbackMip);
+	size_t height = MipSize(pyramid.GetHeight(), m_readbackMip);
+
+	// Keep the maximums only, they are in the second channel.
+	auto data = reinterpret_cast<const uint8_t*>(readback.buffer.Map());
+	for (size_t y = 0; y < height; ++y) {
+		auto row = reinterpret_cast<const float*>(data + y * m_readbackRowPitch);
+		for (size_t x = 0; x < width; ++x) {
+			m_readbackDepth[y * width + x] = row[2 * x + 1];
+		}
+	}
+	readback.buffer.Unmap();
+
+	m_pyramid.Assign(m_readbackDepth.data(), width, height, width, Vec2(float(width), float(height)), readback.viewProjection);
+}
+
+
+} // namespace inl::gxeng::nodes
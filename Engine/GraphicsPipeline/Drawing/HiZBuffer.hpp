@@ -0,0 +1,86 @@
+#pragma once
+
+#include <GraphicsApi_LL/IPipelineState.hpp>
+#include <GraphicsEngine_LL/BasicCamera.hpp>
+#include <GraphicsEngine_LL/DepthPyramid.hpp>
+#include <GraphicsEngine_LL/GraphicsNode.hpp>
+
+#include <array>
+#include <vector>
+
+
+namespace inl::gxeng::nodes {
+
+
+/// <summary>
+/// Builds a hierarchical min/max depth pyramid from the depth buffer.
+/// Inputs: depth texture, camera the depth was rendered with.
+/// Outputs: pyramid texture, CPU copy of the pyramid.
+/// </summary>
+/// <remarks>
+/// Level 0 of the texture is half the size of the depth buffer, each level stores the minimum
+/// and maximum depth of its footprint in X and Y. Odd sized levels fold the leftover row and column
+/// into the last texels, so the footprints always cover the whole image.
+/// A coarse level is copied to the CPU every frame and becomes available in the CPU pyramid
+/// <see cref="ReadbackLatency"/> frames later, when the GPU has surely finished with it.
+/// </remarks>
+class HiZBuffer : virtual public GraphicsNode,
+				  virtual public GraphicsTask,
+				  virtual public InputPortConfig<Texture2D, const BasicCamera*>,
+				  virtual public OutputPortConfig<Texture2D, const DepthPyramid*> {
+public:
+	static const char* Info_GetName() { return "HiZBuffer"; }
+	const std::string& GetInputName(size_t index) const override;
+	const std::string& GetOutputName(size_t index) const override;
+	HiZBuffer();
+
+	void Update() override {}
+	void Notify(InputPortBase* sender) override {}
+	void Initialize(EngineContext& context) override;
+	void Reset() override;
+	void Setup(SetupContext& context) override;
+	void Execute(RenderContext& context) override;
+
+	/// <summary> Frames between copying a level and reading it on the CPU. </summary>
+	/// <remarks> The engine waits for the previous frame on the same back buffer, so this must exceed the number of back buffers. </remarks>
+	static constexpr size_t ReadbackLatency = 3;
+	/// <summary> The first level at most this large in both directions is copied to the CPU. </summary>
+	static constexpr uint64_t ReadbackMaxSize = 256;
+
+private:
+	struct Readback {
+		ReadbackBuffer buffer;
+		Mat44 viewProjection;
+		bool pending = false;
+	};
+
+	void InitRenderTarget(SetupContext& context);
+	void ReadPyramid(Readback& readback);
+
+private:
+	TextureView2D m_depthView;
+	uint64_t m_width = 0;
+	uint32_t m_height = 0;
+
+	TextureView2D m_srv;
+	std::vector<TextureView2D> m_mipSrvs;
+	std::vector<RWTextureView2D> m_mipUavs;
+
+	std::array<Readback, ReadbackLatency> m_readbacks;
+	size_t m_currentReadback = 0;
+	unsigned m_readbackMip = 0;
+	size_t m_readbackRowPitch = 0; // In bytes.
+	std::vector<float> m_readbackDepth;
+	DepthPyramid m_pyramid;
+
+	Binder m_binder;
+	BindParameter m_inputBindParam;
+	BindParameter m_outputBindParam;
+	ShaderProgram m_depthShader;
+	ShaderProgram m_mipShader;
+	std::unique_ptr<gxapi::IPipelineState> m_depthCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_mipCSO;
+};
+
+
+} // namespace inl::gxeng::nodes
@@ -169,7 +169,7 @@ void LightCulling::Setup(SetupContext& context) {
 
 
 void LightCulling::Execute(RenderContext& context) {
-	ComputeCommandList& commandList = context.AsCompute();
+	ComputeCommandList& commandList = context.AsAsyncCompute();
 
 	Uniforms uniformsCBData;
 
@@ -215,7 +215,7 @@ void LightCulling::Execute(RenderContext& context) {
 
 
 	commandList.SetResourceState(m_lightCullDataUAV.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
-	commandList.SetResourceState(m_depthTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_depthTexSrv.GetResource(), gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
 
 	commandList.SetPipelineState(m_CSO.get());
 	commandList.SetComputeBinder(&m_binder);
@@ -0,0 +1,70 @@
+#include "OcclusionCull.hpp"
+
+#include <GraphicsEngine_LL/AutoRegisterNode.hpp>
+#include <GraphicsEngine_LL/BoundingVolumes.hpp>
+#include <GraphicsEngine_LL/Mesh.hpp>
+
+
+namespace inl::gxeng::nodes {
+
+
+INL_REGISTER_GRAPHICS_NODE(OcclusionCull)
+
+
+void OcclusionCull::Initialize(EngineContext& context) {
+	GraphicsNode::SetTaskSingle(this);
+}
+
+
+void OcclusionCull::Reset() {
+	m_visibleEntities.Clear();
+
+	GetInput<0>().Clear();
+	GetInput<1>().Clear();
+}
+
+
+const std::string& OcclusionCull::GetInputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"entities",
+		"depthPyramid",
+	};
+	return names[index];
+}
+
+
+const std::string& OcclusionCull::GetOutputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"visibleEntities",
+	};
+	return names[index];
+}
+
+
+void OcclusionCull::Setup(SetupContext& context) {
+	const EntityCollection<MeshEntity>* entities = GetInput<0>().Get();
+	const DepthPyramid* pyramid = GetInput<1>().Get();
+	if (!entities) {
+		throw InvalidArgumentException("Entities must be connected.");
+	}
+
+	// Nothing to test against, e.g. in the first frames.
+	if (!pyramid || pyramid->IsEmpty()) {
+		GetOutput<0>().Set(entities);
+		return;
+	}
+
+	m_visibleEntities.Clear();
+	m_visibleEntities.Reserve(entities->Size());
+	for (const MeshEntity* entity : *entities) {
+		BoundingBox bounds = entity->GetLocalBounds();
+		if (bounds.IsEmpty() || !pyramid->IsOccluded(bounds.Transformed(entity->GetTransform()))) {
+			m_visibleEntities.Add(entity);
+		}
+	}
+
+	GetOutput<0>().Set(&m_visibleEntities);
+}
+
+
+} // namespace inl::gxeng::nodes
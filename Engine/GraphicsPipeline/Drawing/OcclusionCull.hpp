@@ -0,0 +1,45 @@
+#pragma once
+
+#include <GraphicsEngine_LL/DepthPyramid.hpp>
+#include <GraphicsEngine_LL/GraphicsNode.hpp>
+#include <GraphicsEngine_LL/MeshEntity.hpp>
+
+
+namespace inl::gxeng::nodes {
+
+
+/// <summary>
+/// Removes the mesh entities that are hidden behind the depth of a previous frame.
+/// Inputs: entities, depth pyramid from <see cref="HiZBuffer"/>.
+/// Outputs: entities that may be visible.
+/// </summary>
+/// <remarks>
+/// The pyramid is a few frames old, so objects coming out from behind an occluder may show up late by as many frames.
+/// Don't feed the output into the pass that renders the depth the pyramid is built from:
+/// entities that are culled would never be drawn into the depth, and could never become occluders.
+/// Entities without a mesh or mesh bounds are always kept.
+/// </remarks>
+class OcclusionCull : virtual public GraphicsNode,
+					  virtual public GraphicsTask,
+					  virtual public InputPortConfig<const EntityCollection<MeshEntity>*, const DepthPyramid*>,
+					  virtual public OutputPortConfig<const EntityCollection<MeshEntity>*> {
+public:
+	static const char* Info_GetName() { return "OcclusionCull"; }
+	const std::string& GetInputName(size_t index) const override;
+	const std::string& GetOutputName(size_t index) const override;
+	OcclusionCull() = default;
+
+	void Update() override {}
+	void Notify(InputPortBase* sender) override {}
+
+	void Initialize(EngineContext& context) override;
+	void Reset() override;
+	void Setup(SetupContext& context) override;
+	void Execute(RenderContext& context) override {}
+
+private:
+	EntityCollection<MeshEntity> m_visibleEntities;
+};
+
+
+} // namespace inl::gxeng::nodes
@@ -45,6 +45,14 @@ auto PipelineStateManager::GetPipelineState(RenderContext& context, const Mesh&
 		StateDesc desc = CreateNewStateDesc(context, mesh, material);
 		auto ins = m_psoCache.insert({ key, std::make_unique<StateDesc>(std::move(desc)) });
 		it = ins.first;
+
+		StateDesc& inserted = *it->second;
+		inserted.vsSlot = inserted.binder.Resolve(vsBindParam);
+		inserted.psSlot = inserted.binder.Resolve(psBindParam);
+		inserted.mtlSlot = inserted.binder.Resolve(mtlBindParam);
+		for (auto i : Range(inserted.materialTex(material).size())) {
+			inserted.textureSlots.push_back(inserted.binder.Resolve({ eBindParameterType::TEXTURE, (unsigned)i, 0 }));
+		}
 	}
 
 	StateDesc& desc = *it->second;
@@ -437,22 +445,22 @@ std::unique_ptr<gxapi::IPipelineState> PipelineStateManager::GeneratePSO(RenderC
 		for (const auto& element : layout[streamIdx]) {
 			switch (element.semantic) {
 				case eVertexElementSemantic::POSITION:
-					inputElements.emplace_back("POSITION", 0, gxapi::eFormat::R32G32B32_FLOAT, streamIdx, element.offset);
+					inputElements.emplace_back("POSITION", 0, element.format, streamIdx, element.offset);
 					break;
 				case eVertexElementSemantic::NORMAL:
-					inputElements.emplace_back("NORMAL", 0, gxapi::eFormat::R32G32B32_FLOAT, streamIdx, element.offset);
+					inputElements.emplace_back("NORMAL", 0, element.format, streamIdx, element.offset);
 					break;
 				case eVertexElementSemantic::COLOR:
-					inputElements.emplace_back("COLOR", 0, gxapi::eFormat::R32G32B32A32_FLOAT, streamIdx, element.offset);
+					inputElements.emplace_back("COLOR", 0, element.format, streamIdx, element.offset);
 					break;
 				case eVertexElementSemantic::TEX_COORD:
-					inputElements.emplace_back("TEX_COORD", 0, gxapi::eFormat::R32G32_FLOAT, streamIdx, element.offset);
+					inputElements.emplace_back("TEX_COORD", 0, element.format, streamIdx, element.offset);
 					break;
 				case eVertexElementSemantic::TANGENT:
-					inputElements.emplace_back("TANGENT", 0, gxapi::eFormat::R32G32B32_FLOAT, streamIdx, element.offset);
+					inputElements.emplace_back("TANGENT", 0, element.format, streamIdx, element.offset);
 					break;
 				case eVertexElementSemantic::BITANGENT:
-					inputElements.emplace_back("BITANGENT", 0, gxapi::eFormat::R32G32B32_FLOAT, streamIdx, element.offset);
+					inputElements.emplace_back("BITANGENT", 0, element.format, streamIdx, element.offset);
 					break;
 			}
 		}
@@ -608,8 +616,8 @@ void RenderForwardSimple::Execute(RenderContext& context) {
 		std::vector<uint8_t> mtlConstants = stateDesc.materialCbuffer(material);
 		std::vector<const Image*> mtlTextures = stateDesc.materialTex(material);
 
-		world = entity->GetTransform();
-		dworld = entity->GetTransformMotion();
+		world = mesh.GetPositionDequantization() * entity->GetTransform();
+		dworld = mesh.GetPositionDequantization() * entity->GetTransformMotion();
 		vsConstants.world = world;
 		vsConstants.worldViewProj = world * view * proj;
 		vsConstants.worldViewProjDer = dworld * view * proj; // Okay, it's actually not this simple to calculate, I just write something.
@@ -617,15 +625,14 @@ void RenderForwardSimple::Execute(RenderContext& context) {
 		commandList.SetGraphicsBinder(&stateDesc.binder);
 		commandList.SetPipelineState(stateDesc.pso.get());
 
-		commandList.BindGraphics(PipelineStateManager::vsBindParam, &vsConstants, sizeof(vsConstants));
-		commandList.BindGraphics(PipelineStateManager::psBindParam, &psConstants, sizeof(psConstants));
-		commandList.BindGraphics(PipelineStateManager::mtlBindParam, mtlConstants.data(), mtlConstants.size());
+		commandList.BindGraphics(stateDesc.vsSlot, &vsConstants, sizeof(vsConstants));
+		commandList.BindGraphics(stateDesc.psSlot, &psConstants, sizeof(psConstants));
+		commandList.BindGraphics(stateDesc.mtlSlot, mtlConstants.data(), mtlConstants.size());
 
 		for (auto i : Range(mtlTextures.size())) {
-			BindParameter texParam{ eBindParameterType::TEXTURE, (unsigned)i, 0 };
 			const Image* image = mtlTextures[i];
 			commandList.SetResourceState(image->GetSrv().GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
-			commandList.BindGraphics(texParam, image->GetSrv());
+			commandList.BindGraphics(stateDesc.textureSlots[i], image->GetSrv());
 		}
 
 		vertexBuffers.clear();
@@ -642,7 +649,7 @@ void RenderForwardSimple::Execute(RenderContext& context) {
 		commandList.SetVertexBuffers(0, mesh.GetNumStreams(), vertexBuffers.data(), vertexBufferSizes.data(), vertexBufferStrides.data());
 		commandList.SetIndexBuffer(&mesh.GetIndexBuffer(), mesh.IsIndexBuffer32Bit());
 
-		commandList.DrawIndexedInstanced(mesh.GetIndexBuffer().GetIndexCount(), 0, 0, 1, 0);
+		commandList.DrawIndexedInstanced(mesh.GetLod(0).indexCount, mesh.GetLod(0).firstIndex, 0, 1, 0);
 	}
 }
 
@@ -45,6 +45,11 @@ public:
 		std::function<std::vector<const Image*>(const Material&)> materialTex;
 		gxapi::eFormat renderTargetFormat = gxapi::eFormat::UNKNOWN;
 		gxapi::eFormat depthStencilFormat = gxapi::eFormat::UNKNOWN;
+		// Resolved once the state is cached, the binder does not move from then on.
+		BindSlot vsSlot;
+		BindSlot psSlot;
+		BindSlot mtlSlot;
+		std::vector<BindSlot> textureSlots;
 	};
 
 private:
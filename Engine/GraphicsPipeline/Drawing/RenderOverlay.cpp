@@ -24,21 +24,28 @@ using namespace gxapi;
 struct CbufferOverlay {
 	Mat34_Packed worldViewProj;
 	Vec4_Packed color;
+	Vec4_Packed textureRect;
 	uint32_t hasTexture;
 	uint32_t hasMesh;
 	float z;
 };
 
-struct CbufferTextTransform {
-	Mat34_Packed worldViewProj;
-	float z;
-};
+// The instance buffers only grow, to the first power of two that fits the letters or sprites.
+static constexpr size_t MinInstanceCapacity = 256;
 
-struct CbufferTextRender {
-	Vec2i_Packed atlasAccessTopleft;
-	Vec2i_Packed atlasAccessSize;
-	Vec4_Packed color;
-};
+
+// The texture of the overlay if it has one to sample.
+static const Image* GetOverlayTexture(const OverlayEntity* entity) {
+	const Image* texture = entity->GetTexture();
+	return texture && texture->GetSrv() ? texture : nullptr;
+}
+
+
+// Texture coordinates (0,0) and (1,1) of the entity in the texture.
+static Vec4 GetTextureRectVector(const OverlayEntity* entity) {
+	RectF rect = entity->GetTextureRect();
+	return { rect.left, rect.bottom, rect.right, rect.top };
+}
 
 
 
@@ -49,6 +56,7 @@ void RenderOverlay::Reset() {
 
 	// Release PSOs.
 	m_overlayPso.reset();
+	m_spritePso.reset();
 	m_textPso.reset();
 
 	// Release binders.
@@ -63,6 +71,7 @@ void RenderOverlay::Setup(SetupContext& context) {
 	CreateRtv(context);
 	CreateBinders(context);
 	CreatePipelineStates(context);
+	ReserveInstances(context);
 
 	GetOutput<0>().Set(GetInput<0>().Get());
 }
@@ -119,7 +128,7 @@ void RenderOverlay::Execute(RenderContext& context) {
 	GraphicsCommandList& commandList = context.AsGraphics();
 	commandList.SetResourceState(m_rtv.GetResource(), gxapi::eResourceState::RENDER_TARGET);
 	//commandList.ClearRenderTarget(m_rtv, ColorRGBA(0, 0, 0, 0));
-	RenderEntities(commandList, overlayList, textList, minZ, maxZ);
+	RenderEntities(context, commandList, overlayList, textList, minZ, maxZ);
 }
 
 
@@ -155,6 +164,7 @@ void RenderOverlay::ValidateInput() {
 	// Redo PSOs if RTV format changed.
 	if (texture.GetFormat() != m_currentFormat) {
 		m_overlayPso.reset();
+		m_spritePso.reset();
 		m_textPso.reset();
 		m_currentFormat = texture.GetFormat();
 	}
@@ -192,7 +202,6 @@ void RenderOverlay::CreateBinders(SetupContext& context) {
 		p.parameter.type = eBindParameterType::CONSTANT;
 		p.constantSize = sizeof(CbufferOverlay);
 		parameters.push_back(p);
-		m_bindOverlayCb = p.parameter;
 
 		// texture
 		p.parameter.reg = 0;
@@ -200,7 +209,6 @@ void RenderOverlay::CreateBinders(SetupContext& context) {
 		p.parameter.type = eBindParameterType::TEXTURE;
 		p.shaderVisibility = eShaderVisiblity::PIXEL;
 		parameters.push_back(p);
-		m_bindOverlayTexture = p.parameter;
 
 		// sampler
 		StaticSamplerDesc samp;
@@ -209,6 +217,8 @@ void RenderOverlay::CreateBinders(SetupContext& context) {
 		samp.shaderRegister = 0;
 
 		m_overlayBinder = context.CreateBinder(parameters, { samp });
+		m_bindOverlayCb = m_overlayBinder.Resolve(parameters[0].parameter);
+		m_bindOverlayTexture = m_overlayBinder.Resolve(parameters[1].parameter);
 	}
 
 	if (!m_textBinder) {
@@ -218,31 +228,12 @@ void RenderOverlay::CreateBinders(SetupContext& context) {
 		p.relativeAccessFrequency = 1;
 		p.relativeChangeFrequency = 1;
 
-		// vs cbuffer
-		p.parameter.reg = 0;
-		p.parameter.space = 0;
-		p.parameter.type = eBindParameterType::CONSTANT;
-		p.constantSize = sizeof(CbufferTextTransform);
-		p.shaderVisibility = eShaderVisiblity::VERTEX;
-		parameters.push_back(p);
-		m_bindTextTransform = p.parameter;
-
-		// ps cbuffer
-		p.parameter.reg = 7;
-		p.parameter.space = 0;
-		p.parameter.type = eBindParameterType::CONSTANT;
-		p.constantSize = sizeof(CbufferTextRender);
-		p.shaderVisibility = eShaderVisiblity::PIXEL;
-		parameters.push_back(p);
-		m_bindTextRender = p.parameter;
-
 		// texture
 		p.parameter.reg = 0;
 		p.parameter.space = 0;
 		p.parameter.type = eBindParameterType::TEXTURE;
 		p.shaderVisibility = eShaderVisiblity::PIXEL;
 		parameters.push_back(p);
-		m_bindTextTexture = p.parameter;
 
 		// sampler
 		StaticSamplerDesc samp;
@@ -251,13 +242,14 @@ void RenderOverlay::CreateBinders(SetupContext& context) {
 		samp.shaderRegister = 0;
 
 		m_textBinder = context.CreateBinder(parameters, { samp });
+		m_bindTextTexture = m_textBinder.Resolve(parameters[0].parameter);
 	}
 }
 
 
 void RenderOverlay::CreatePipelineStates(SetupContext& context) {
 	// Exit early if all good.
-	if (m_overlayPso && m_textPso) {
+	if (m_overlayPso && m_spritePso && m_textPso) {
 		return;
 	}
 
@@ -286,8 +278,8 @@ void RenderOverlay::CreatePipelineStates(SetupContext& context) {
 
 	// Input layout
 	std::array<InputElementDesc, 2> inputElements = {
-		InputElementDesc{ "POSITION", 0, gxapi::eFormat::R32G32_FLOAT, 0, 0 },
-		InputElementDesc{ "TEXCOORD", 0, gxapi::eFormat::R32G32_FLOAT, 0, 0 },
+		InputElementDesc{ "POSITION", 0, gxapi::eFormat::R16G16B16A16_UNORM, 0, 0 },
+		InputElementDesc{ "TEXCOORD", 0, gxapi::eFormat::R16G16_FLOAT, 0, 8 },
 	};
 	desc.inputLayout.elements = inputElements.data();
 	desc.inputLayout.numElements = (unsigned)inputElements.size();
@@ -306,11 +298,47 @@ void RenderOverlay::CreatePipelineStates(SetupContext& context) {
 	}
 
 
-	// Binder
+	// Binder, sprites bind only a texture like texts.
 	desc.rootSignature = m_textBinder.GetRootSignature();
-	desc.inputLayout = { 0, nullptr };
 	desc.primitiveTopologyType = ePrimitiveTopologyType::TRIANGLE;
 
+	// Input layout, one instance per quad
+	std::array<InputElementDesc, 7> spriteInputElements = {
+		InputElementDesc{ "TRANSFORM", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, offsetof(SpriteInstance, transform[0]), eInputClassification::INSTANCE_DATA, 1 },
+		InputElementDesc{ "TRANSFORM", 1, gxapi::eFormat::R32G32B32_FLOAT, 0, offsetof(SpriteInstance, transform[1]), eInputClassification::INSTANCE_DATA, 1 },
+		InputElementDesc{ "TRANSFORM", 2, gxapi::eFormat::R32G32B32_FLOAT, 0, offsetof(SpriteInstance, transform[2]), eInputClassification::INSTANCE_DATA, 1 },
+		InputElementDesc{ "DEPTH", 0, gxapi::eFormat::R32_FLOAT, 0, offsetof(SpriteInstance, z), eInputClassification::INSTANCE_DATA, 1 },
+		InputElementDesc{ "TEXRECT", 0, gxapi::eFormat::R32G32B32A32_FLOAT, 0, offsetof(SpriteInstance, textureRect), eInputClassification::INSTANCE_DATA, 1 },
+		InputElementDesc{ "COLOR", 0, gxapi::eFormat::R32G32B32A32_FLOAT, 0, offsetof(SpriteInstance, color), eInputClassification::INSTANCE_DATA, 1 },
+		InputElementDesc{ "TEXTURED", 0, gxapi::eFormat::R32_FLOAT, 0, offsetof(SpriteInstance, textured), eInputClassification::INSTANCE_DATA, 1 },
+	};
+	desc.inputLayout.elements = spriteInputElements.data();
+	desc.inputLayout.numElements = (unsigned)spriteInputElements.size();
+
+	if (!m_spritePso) {
+		// Shader
+		ShaderParts stages;
+		stages.vs = stages.ps = true;
+		ShaderProgram shader = context.CreateShader("RenderOverlay_Sprite", stages);
+		desc.vs = shader.vs;
+		desc.ps = shader.ps;
+
+		// Create
+		m_spritePso.reset(context.CreatePSO(desc));
+	}
+
+	// Input layout, one instance per letter
+	std::array<InputElementDesc, 6> textInputElements = {
+		InputElementDesc{ "TRANSFORM", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, offsetof(GlyphInstance, transform[0]), eInputClassification::INSTANCE_DATA, 1 },
+		InputElementDesc{ "TRANSFORM", 1, gxapi::eFormat::R32G32B32_FLOAT, 0, offsetof(GlyphInstance, transform[1]), eInputClassification::INSTANCE_DATA, 1 },
+		InputElementDesc{ "TRANSFORM", 2, gxapi::eFormat::R32G32B32_FLOAT, 0, offsetof(GlyphInstance, transform[2]), eInputClassification::INSTANCE_DATA, 1 },
+		InputElementDesc{ "DEPTH", 0, gxapi::eFormat::R32_FLOAT, 0, offsetof(GlyphInstance, z), eInputClassification::INSTANCE_DATA, 1 },
+		InputElementDesc{ "ATLASRECT", 0, gxapi::eFormat::R32G32B32A32_FLOAT, 0, offsetof(GlyphInstance, atlasRect), eInputClassification::INSTANCE_DATA, 1 },
+		InputElementDesc{ "COLOR", 0, gxapi::eFormat::R32G32B32A32_FLOAT, 0, offsetof(GlyphInstance, color), eInputClassification::INSTANCE_DATA, 1 },
+	};
+	desc.inputLayout.elements = textInputElements.data();
+	desc.inputLayout.numElements = (unsigned)textInputElements.size();
+
 
 	if (!m_textPso) {
 		// Shader
@@ -326,7 +354,8 @@ void RenderOverlay::CreatePipelineStates(SetupContext& context) {
 }
 
 
-void RenderOverlay::RenderEntities(GraphicsCommandList& commandList,
+void RenderOverlay::RenderEntities(RenderContext& context,
+								   GraphicsCommandList& commandList,
 								   const std::vector<const OverlayEntity*>& overlayList,
 								   const std::vector<const TextEntity*>& textList,
 								   float minZ,
@@ -364,9 +393,49 @@ void RenderOverlay::RenderEntities(GraphicsCommandList& commandList,
 	Mat33 view = camera->GetViewMatrix();
 	Mat33 proj = camera->GetProjectionMatrix();
 
+	// Letters of all texts are uploaded at once, each text owns a range of the instances.
+	m_glyphs.clear();
+	std::vector<uint32_t> firstGlyphs(textList.size() + 1);
+	for (size_t i = 0; i < textList.size(); ++i) {
+		firstGlyphs[i] = (uint32_t)m_glyphs.size();
+		AppendGlyphs(textList[i], view * proj, RecalcZ(textList[i]->GetZDepth()));
+	}
+	firstGlyphs.back() = (uint32_t)m_glyphs.size();
+	assert(m_glyphs.size() <= m_glyphCapacity);
+
+	if (!m_glyphs.empty()) {
+		commandList.SetResourceState(m_glyphBuffer, eResourceState::COPY_DEST);
+		context.Upload(m_glyphBuffer, 0, m_glyphs.data(), m_glyphs.size() * sizeof(GlyphInstance));
+		commandList.SetResourceState(m_glyphBuffer, eResourceState::VERTEX_AND_CONSTANT_BUFFER);
+	}
+
+	// Overlay i is sprite instance i, the ones with a mesh are drawn on their own and their instance is unused.
+	m_sprites.resize(overlayList.size());
+	for (size_t i = 0; i < overlayList.size(); ++i) {
+		const OverlayEntity* entity = overlayList[i];
+		Mat33 worldViewProj = entity->GetTransform() * view * proj;
+
+		SpriteInstance& sprite = m_sprites[i];
+		for (int row = 0; row < 3; ++row) {
+			sprite.transform[row] = Vec3(worldViewProj(row, 0), worldViewProj(row, 1), worldViewProj(row, 2));
+		}
+		sprite.z = RecalcZ(entity->GetZDepth());
+		sprite.textureRect = GetTextureRectVector(entity);
+		sprite.color = entity->GetColor();
+		sprite.textured = GetOverlayTexture(entity) ? 1.0f : 0.0f;
+	}
+	assert(m_sprites.size() <= m_spriteCapacity);
+
+	if (!m_sprites.empty()) {
+		commandList.SetResourceState(m_spriteBuffer, eResourceState::COPY_DEST);
+		context.Upload(m_spriteBuffer, 0, m_sprites.data(), m_sprites.size() * sizeof(SpriteInstance));
+		commandList.SetResourceState(m_spriteBuffer, eResourceState::VERTEX_AND_CONSTANT_BUFFER);
+	}
+
 	enum {
 		UNKNOWN,
 		OVERLAY,
+		SPRITE,
 		TEXT
 	} lastType = UNKNOWN;
 
@@ -374,8 +443,39 @@ void RenderOverlay::RenderEntities(GraphicsCommandList& commandList,
 		float zOverlay = (itOverlay != overlayList.end() ? (*itOverlay)->GetZDepth() : std::numeric_limits<float>::max());
 		float zText = (itText != textList.end() ? (*itText)->GetZDepth() : std::numeric_limits<float>::max());
 
-		if (zOverlay < zText) {
-			// Render the overlay.
+		if (zOverlay < zText && !(*itOverlay)->GetMesh()) {
+			// Render the quads before the next text that sample the same texture, or none, with one draw.
+			const Image* texture = nullptr;
+			size_t firstSprite = itOverlay - overlayList.begin();
+			for (; itOverlay != overlayList.end() && (*itOverlay)->GetZDepth() < zText && !(*itOverlay)->GetMesh(); ++itOverlay) {
+				const Image* spriteTexture = GetOverlayTexture(*itOverlay);
+				if (spriteTexture && texture && spriteTexture != texture) {
+					break;
+				}
+				texture = spriteTexture ? spriteTexture : texture;
+			}
+			size_t endSprite = itOverlay - overlayList.begin();
+
+			if (lastType != SPRITE) {
+				const VertexBuffer* vbs[] = { &m_spriteBuffer };
+				unsigned vbsizes[] = { (unsigned)m_spriteBuffer.GetSize() };
+				unsigned vbstrides[] = { (unsigned)sizeof(SpriteInstance) };
+				commandList.SetPipelineState(m_spritePso.get());
+				commandList.SetGraphicsBinder(&m_textBinder);
+				commandList.SetPrimitiveTopology(ePrimitiveTopology::TRIANGLESTRIP);
+				commandList.SetVertexBuffers(0, 1, vbs, vbsizes, vbstrides);
+			}
+
+			if (texture) {
+				commandList.SetResourceState(texture->GetSrv().GetResource(), { eResourceState::PIXEL_SHADER_RESOURCE, eResourceState::NON_PIXEL_SHADER_RESOURCE });
+				commandList.BindGraphics(m_bindTextTexture, texture->GetSrv());
+			}
+
+			commandList.DrawInstanced(4, 0, unsigned(endSprite - firstSprite), unsigned(firstSprite));
+			lastType = SPRITE;
+		}
+		else if (zOverlay < zText) {
+			// Render the overlay with a mesh.
 			const OverlayEntity* entity = *itOverlay;
 			const Mesh* mesh = entity->GetMesh();
 			const Image* texture = entity->GetTexture();
@@ -388,11 +488,22 @@ void RenderOverlay::RenderEntities(GraphicsCommandList& commandList,
 			CbufferOverlay cbuffer;
 
 			Mat33 world = entity->GetTransform();
+			if (mesh) {
+				// Only the plane of the quantized positions is used.
+				Mat44 dequantization = mesh->GetPositionDequantization();
+				Mat33 dequantization2D = Mat33::Identity();
+				dequantization2D(0, 0) = dequantization(0, 0);
+				dequantization2D(1, 1) = dequantization(1, 1);
+				dequantization2D(2, 0) = dequantization(3, 0);
+				dequantization2D(2, 1) = dequantization(3, 1);
+				world = dequantization2D * world;
+			}
 
 			cbuffer.worldViewProj.Submatrix<3, 3>(0, 0) = world * view * proj;
 			cbuffer.hasTexture = (uint32_t)(texture != nullptr && texture->GetSrv());
 			cbuffer.hasMesh = mesh != nullptr;
 			cbuffer.color = entity->GetColor();
+			cbuffer.textureRect = GetTextureRectVector(entity);
 			cbuffer.z = RecalcZ(entity->GetZDepth());
 
 			commandList.BindGraphics(m_bindOverlayCb, &cbuffer, sizeof(cbuffer));
@@ -427,65 +538,42 @@ void RenderOverlay::RenderEntities(GraphicsCommandList& commandList,
 			lastType = OVERLAY;
 		}
 		else {
-			// Render the text.
+			// Render the texts before the next overlay that use the same atlas with one draw.
 			const TextEntity* entity = *itText;
 			const Font* font = entity->GetFont();
 			if (!font || !font->GetGlyphAtlas().GetSrv()) {
 				++itText;
 				continue;
 			}
+			const TextureView2D& atlas = font->GetGlyphAtlas().GetSrv();
+
+			size_t firstText = itText - textList.begin();
+			for (++itText; itText != textList.end() && !(zOverlay < (*itText)->GetZDepth()); ++itText) {
+				// Texts without a font have no letters, they do not break the batch.
+				const Font* nextFont = (*itText)->GetFont();
+				if (nextFont && nextFont->GetGlyphAtlas().GetSrv() && nextFont->GetGlyphAtlas().GetSrv().GetResource() != atlas.GetResource()) {
+					break;
+				}
+			}
+			size_t endText = itText - textList.begin();
 
 			if (lastType != TEXT) {
+				const VertexBuffer* vbs[] = { &m_glyphBuffer };
+				unsigned vbsizes[] = { (unsigned)m_glyphBuffer.GetSize() };
+				unsigned vbstrides[] = { (unsigned)sizeof(GlyphInstance) };
 				commandList.SetPipelineState(m_textPso.get());
 				commandList.SetGraphicsBinder(&m_textBinder);
 				commandList.SetPrimitiveTopology(ePrimitiveTopology::TRIANGLESTRIP);
-				commandList.SetResourceState(font->GetGlyphAtlas().GetSrv().GetResource(), { eResourceState::PIXEL_SHADER_RESOURCE, eResourceState::NON_PIXEL_SHADER_RESOURCE });
-				commandList.BindGraphics(m_bindTextTexture, font->GetGlyphAtlas().GetSrv());
+				commandList.SetVertexBuffers(0, 1, vbs, vbsizes, vbstrides);
 			}
 
-			// Set cbuffer constants unchanging over letters.
-			CbufferTextTransform cbufferTransform;
-			CbufferTextRender cbufferRender;
-
-			Mat33 world = entity->GetTransform();
-			Mat33 worldViewProj = world * view * proj;
-			;
-
-			cbufferTransform.z = RecalcZ(entity->GetZDepth());
-			cbufferRender.color = entity->GetColor();
+			commandList.SetResourceState(atlas.GetResource(), { eResourceState::PIXEL_SHADER_RESOURCE, eResourceState::NON_PIXEL_SHADER_RESOURCE });
+			commandList.BindGraphics(m_bindTextTexture, atlas);
 
-			// Position of the first letter.
-			float textHeight = font->CalculateTextHeight(entity->GetFontSize());
-			RectF letterRect = AlignFirstLetter(entity);
-
-			// Letters can be drawn only inside the limits on the X axis.
-			Vec2 limits = Vec2(-0.5f, 0.5f)*entity->GetSize().xx;
-
-
-			// Draw letters one-by-one.
-			for (auto& character : entity->GetText()) {
-				bool supported = font->IsCharacterSupported(character);
-				if (!supported) {
-					continue;
-				}
-				Font::GlyphInfo charInfo = font->GetGlyphInfo(character);
-				letterRect.right = letterRect.left + charInfo.advance * entity->GetFontSize();
-				cbufferRender.atlasAccessTopleft = charInfo.atlasPos;
-				cbufferRender.atlasAccessSize = { charInfo.atlasSize.x, font->GetGlyphAtlas().GetHeight() };
-
-				Mat33 letterTransform = Mat33::Scale(letterRect.GetSize() / 2) * Mat33::Translation(letterRect.GetCenter());
-				cbufferTransform.worldViewProj.Submatrix<3, 3>(0, 0) = letterTransform * worldViewProj;
-
-				if (limits[0] <= letterRect.left && letterRect.right <= limits[1]) {
-					commandList.BindGraphics(m_bindTextTransform, &cbufferTransform, sizeof(cbufferTransform));
-					commandList.BindGraphics(m_bindTextRender, &cbufferRender, sizeof(cbufferRender));
-
-					commandList.DrawInstanced(4);
-				}
-
-				letterRect.left = letterRect.right;
+			uint32_t numGlyphs = firstGlyphs[endText] - firstGlyphs[firstText];
+			if (numGlyphs > 0) {
+				commandList.DrawInstanced(4, 0, numGlyphs, firstGlyphs[firstText]);
 			}
-			++itText;
 			lastType = TEXT;
 		}
 	}
@@ -514,4 +602,82 @@ RectF RenderOverlay::AlignFirstLetter(const TextEntity* entity) {
 }
 
 
+void RenderOverlay::AppendGlyphs(const TextEntity* entity, const Mat33& viewProj, float z) {
+	const Font* font = entity->GetFont();
+	if (!font || !font->GetGlyphAtlas().GetSrv()) {
+		return;
+	}
+
+	Mat33 worldViewProj = entity->GetTransform() * viewProj;
+	float fontSize = entity->GetFontSize();
+
+	// Position of the first letter.
+	RectF letterRect = AlignFirstLetter(entity);
+
+	// Letters can be drawn only inside the limits on the X axis.
+	Vec2 limits = Vec2(-0.5f, 0.5f)*entity->GetSize().xx;
+
+	// The run was laid out when the text was set, the glyphs are not looked up again.
+	const Font::GlyphRun& run = entity->GetGlyphRun();
+	float lineLeft = letterRect.left;
+	for (size_t i = 0; i < run.glyphs.size(); ++i) {
+		const Font::GlyphInfo& charInfo = run.glyphs[i];
+		letterRect.left = lineLeft + run.glyphPositions[i] * fontSize;
+		letterRect.right = letterRect.left + charInfo.advance * fontSize;
+
+		// The quad of the distance field is placed from the pen on the top of the line.
+		bool visible = charInfo.atlasSize.x > 0 && charInfo.atlasSize.y > 0;
+		if (visible && limits[0] <= letterRect.left && letterRect.right <= limits[1]) {
+			RectF quad;
+			quad.left = letterRect.left + charInfo.offset.x * fontSize;
+			quad.right = quad.left + charInfo.size.x * fontSize;
+			quad.top = letterRect.top - charInfo.offset.y * fontSize;
+			quad.bottom = quad.top - charInfo.size.y * fontSize;
+			Mat33 letterTransform = Mat33::Scale(quad.GetSize() / 2) * Mat33::Translation(quad.GetCenter()) * worldViewProj;
+
+			GlyphInstance glyph;
+			for (int row = 0; row < 3; ++row) {
+				glyph.transform[row] = Vec3(letterTransform(row, 0), letterTransform(row, 1), letterTransform(row, 2));
+			}
+			glyph.z = z;
+			glyph.atlasRect = Vec4((float)charInfo.atlasPos.x, (float)charInfo.atlasPos.y, (float)charInfo.atlasSize.x, (float)charInfo.atlasSize.y);
+			glyph.color = entity->GetColor();
+			m_glyphs.push_back(glyph);
+		}
+	}
+}
+
+
+void RenderOverlay::ReserveInstances(SetupContext& context) {
+	const EntityCollection<IOverlayEntity>* overlays = GetInput<2>().Get();
+	const EntityCollection<ITextEntity>* texts = GetInput<3>().Get();
+
+	// Every character is at most one letter.
+	size_t glyphCount = 0;
+	if (texts) {
+		for (auto& entity : *texts) {
+			glyphCount += entity->GetText().size();
+		}
+	}
+	size_t spriteCount = overlays ? overlays->Size() : 0;
+
+	ReserveInstanceBuffer(context, m_glyphBuffer, m_glyphCapacity, glyphCount, sizeof(GlyphInstance), "Overlay glyph instances");
+	ReserveInstanceBuffer(context, m_spriteBuffer, m_spriteCapacity, spriteCount, sizeof(SpriteInstance), "Overlay sprite instances");
+}
+
+
+void RenderOverlay::ReserveInstanceBuffer(SetupContext& context, VertexBuffer& buffer, size_t& capacity, size_t count, size_t stride, const char* name) {
+	if (buffer && count <= capacity) {
+		return;
+	}
+
+	capacity = std::max(capacity, MinInstanceCapacity);
+	while (capacity < count) {
+		capacity *= 2;
+	}
+	buffer = context.CreateVertexBuffer(capacity * stride);
+	buffer.SetName(name);
+}
+
+
 } // namespace inl::gxeng::nodes
\ No newline at end of file
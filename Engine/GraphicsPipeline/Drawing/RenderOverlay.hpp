@@ -9,6 +9,7 @@
 #include <GraphicsEngine_LL/Scene.hpp>
 #include <GraphicsEngine_LL/TextEntity.hpp>
 
+#include <vector>
 
 namespace inl::gxeng::nodes {
 
@@ -20,6 +21,10 @@ namespace inl::gxeng::nodes {
 /// <remarks>
 /// Inputs: Target texture, entities.
 /// Outputs: Finished texture.
+/// The letters of all texts are written to a per-frame instance buffer, and texts that follow each other
+/// in z-order and share a glyph atlas are drawn with a single instanced draw.
+/// Overlays without a mesh are batched the same way: quads that follow each other in z-order and sample
+/// the same image, or none, are one instanced draw. Pack small images with <see cref="ImageAtlas"/> to make runs longer.
 /// </remarks>
 class RenderOverlay : virtual public GraphicsNode,
 					  public GraphicsTask,
@@ -48,7 +53,10 @@ private:
 	void CreateRtv(SetupContext& context);
 	void CreateBinders(SetupContext& context);
 	void CreatePipelineStates(SetupContext& context);
-	void RenderEntities(GraphicsCommandList& commandList,
+	void ReserveInstances(SetupContext& context);
+	static void ReserveInstanceBuffer(SetupContext& context, VertexBuffer& buffer, size_t& capacity, size_t count, size_t stride, const char* name);
+	void RenderEntities(RenderContext& context,
+						GraphicsCommandList& commandList,
 						const std::vector<const OverlayEntity*>& overlayList,
 						const std::vector<const TextEntity*>& textList,
 						float minZ,
@@ -57,17 +65,44 @@ private:
 	// Return the position of the first letter in entity's local space, entity size included.
 	static RectF AlignFirstLetter(const TextEntity*);
 
+	// Appends the visible letters of the entity to m_glyphs.
+	void AppendGlyphs(const TextEntity* entity, const Mat33& viewProj, float z);
+
 private:
+	// One letter, layout must match the instance layout of RenderOverlay_Text.hlsl.
+	struct GlyphInstance {
+		Vec3_Packed transform[3]; // Rows of the letter's quad to clip space transform.
+		float z;
+		Vec4_Packed atlasRect; // Top-left and size in texels.
+		Vec4_Packed color;
+	};
+
+	// One quad overlay, layout must match the instance layout of RenderOverlay_Sprite.hlsl.
+	struct SpriteInstance {
+		Vec3_Packed transform[3]; // Rows of the quad to clip space transform.
+		float z;
+		Vec4_Packed textureRect; // Texture coordinates of the corners (0,0) and (1,1).
+		Vec4_Packed color;
+		float textured; // 1 to sample the texture of the batch, 0 for solid color.
+	};
+
 	Binder m_overlayBinder;
 	Binder m_textBinder;
-	BindParameter m_bindOverlayCb;
-	BindParameter m_bindOverlayTexture;
-	BindParameter m_bindTextTransform;
-	BindParameter m_bindTextRender;
-	BindParameter m_bindTextTexture;
+	BindSlot m_bindOverlayCb; // Resolved when the binders are created.
+	BindSlot m_bindOverlayTexture;
+	BindSlot m_bindTextTexture;
 	std::unique_ptr<gxapi::IPipelineState> m_overlayPso;
+	std::unique_ptr<gxapi::IPipelineState> m_spritePso;
 	std::unique_ptr<gxapi::IPipelineState> m_textPso;
 
+	std::vector<GlyphInstance> m_glyphs;
+	VertexBuffer m_glyphBuffer;
+	size_t m_glyphCapacity = 0;
+
+	std::vector<SpriteInstance> m_sprites;
+	VertexBuffer m_spriteBuffer;
+	size_t m_spriteCapacity = 0;
+
 	RenderTargetView2D m_rtv;
 	gxapi::eFormat m_currentFormat = gxapi::eFormat::UNKNOWN;
 };
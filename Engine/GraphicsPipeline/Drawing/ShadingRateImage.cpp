@@ -0,0 +1,215 @@
+#include "ShadingRateImage.hpp"
+
+#include <GraphicsEngine_LL/Nodes/NodeUtility.hpp>
+
+#include <GraphicsEngine_LL/AutoRegisterNode.hpp>
+#include <GraphicsEngine_LL/GraphicsCommandList.hpp>
+
+
+namespace inl::gxeng::nodes {
+
+
+INL_REGISTER_GRAPHICS_NODE(ShadingRateImage)
+
+
+static constexpr gxapi::eFormat RateFormat = gxapi::eFormat::R8_UINT;
+
+
+struct Uniforms {
+	Mat44_Packed invVP;
+	Mat44_Packed prevVP;
+	uint32_t tileSize;
+	uint32_t additionalRates;
+	uint32_t historyValid;
+	float motionThreshold;
+	float contrastThreshold;
+};
+
+
+ShadingRateImage::ShadingRateImage() {
+	this->GetInput<0>().Set({});
+	this->GetInput<1>().Set({});
+}
+
+
+void ShadingRateImage::Initialize(EngineContext& context) {
+	SetTaskSingle(this);
+}
+
+
+void ShadingRateImage::Reset() {
+	m_colorView = {};
+	m_depthView = {};
+	m_camera = nullptr;
+
+	GetInput<0>().Clear();
+	GetInput<1>().Clear();
+	GetInput<2>().Clear();
+}
+
+
+const std::string& ShadingRateImage::GetInputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"prevColorTex",
+		"depthTex",
+		"camera",
+	};
+	return names[index];
+}
+
+
+const std::string& ShadingRateImage::GetOutputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"shadingRateTex",
+	};
+	return names[index];
+}
+
+
+void ShadingRateImage::Setup(SetupContext& context) {
+	if (!m_capsQueried) {
+		m_caps = context.QueryVariableRateShading();
+		m_capsQueried = true;
+	}
+	if (!m_caps.shadingRateImage || m_caps.imageTileSize == 0) {
+		this->GetOutput<0>().Set({});
+		return;
+	}
+
+	auto& colorTex = this->GetInput<0>().Get();
+	auto& depthTex = this->GetInput<1>().Get();
+	m_camera = this->GetInput<2>().Get();
+	if (!m_camera) {
+		throw InvalidArgumentException("Camera must be connected.");
+	}
+
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.numMipLevels = 1;
+	srvDesc.planeIndex = 0;
+	m_colorView = context.CreateSrv(colorTex, colorTex.GetFormat(), srvDesc);
+	m_depthView = context.CreateSrv(depthTex, FormatDepthToColor(depthTex.GetFormat()), srvDesc);
+
+	if (depthTex.GetWidth() != m_renderWidth || depthTex.GetHeight() != m_renderHeight) {
+		InitRateImage(context, depthTex.GetWidth(), depthTex.GetHeight());
+	}
+
+	this->GetOutput<0>().Set(m_rateUav.GetResource());
+
+	if (!m_binder) {
+		BindParameterDesc uniformsBindParamDesc;
+		m_uniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
+		uniformsBindParamDesc.parameter = m_uniformsBindParam;
+		uniformsBindParamDesc.constantSize = sizeof(Uniforms);
+		uniformsBindParamDesc.relativeAccessFrequency = 0;
+		uniformsBindParamDesc.relativeChangeFrequency = 0;
+		uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc colorBindParamDesc;
+		m_colorBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		colorBindParamDesc.parameter = m_colorBindParam;
+		colorBindParamDesc.constantSize = 0;
+		colorBindParamDesc.relativeAccessFrequency = 0;
+		colorBindParamDesc.relativeChangeFrequency = 0;
+		colorBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc depthBindParamDesc;
+		m_depthBindParam = BindParameter(eBindParameterType::TEXTURE, 1);
+		depthBindParamDesc.parameter = m_depthBindParam;
+		depthBindParamDesc.constantSize = 0;
+		depthBindParamDesc.relativeAccessFrequency = 0;
+		depthBindParamDesc.relativeChangeFrequency = 0;
+		depthBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc rateBindParamDesc;
+		m_rateBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		rateBindParamDesc.parameter = m_rateBindParam;
+		rateBindParamDesc.constantSize = 0;
+		rateBindParamDesc.relativeAccessFrequency = 0;
+		rateBindParamDesc.relativeChangeFrequency = 0;
+		rateBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		m_binder = context.CreateBinder({ uniformsBindParamDesc, colorBindParamDesc, depthBindParamDesc, rateBindParamDesc }, {});
+	}
+
+	if (m_CSO == nullptr) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+		m_shader = context.CreateShader("ShadingRateImage", shaderParts, "");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_binder.GetRootSignature();
+		csoDesc.cs = m_shader.cs;
+		m_CSO.reset(context.CreatePSO(csoDesc));
+	}
+}
+
+
+void ShadingRateImage::Execute(RenderContext& context) {
+	if (!m_rateUav) {
+		return;
+	}
+
+	auto& commandList = context.AsCompute();
+
+	Mat44 VP = m_camera->GetViewMatrix() * m_camera->GetProjectionMatrix();
+
+	Uniforms uniforms;
+	uniforms.invVP = VP.Inverse();
+	uniforms.prevVP = m_historyValid ? m_prevVP : VP;
+	uniforms.tileSize = m_caps.imageTileSize;
+	uniforms.additionalRates = m_caps.additionalRates;
+	uniforms.historyValid = m_historyValid;
+	uniforms.motionThreshold = MotionThreshold;
+	uniforms.contrastThreshold = ContrastThreshold;
+
+	VolatileConstBuffer cb = context.CreateVolatileConstBuffer(&uniforms, sizeof(uniforms));
+	cb.SetName("Shading rate image volatile CB");
+	ConstBufferView cbv = context.CreateCbv(cb, 0, sizeof(uniforms));
+
+	commandList.SetResourceState(m_colorView.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_depthView.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_rateUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+
+	commandList.SetPipelineState(m_CSO.get());
+	commandList.SetComputeBinder(&m_binder);
+	commandList.BindCompute(m_uniformsBindParam, cbv);
+	commandList.BindCompute(m_colorBindParam, m_colorView);
+	commandList.BindCompute(m_depthBindParam, m_depthView);
+	commandList.BindCompute(m_rateBindParam, m_rateUav);
+
+	// One group per tile, each thread covers a square of the tile.
+	const Texture2D& rateTex = m_rateUav.GetResource();
+	commandList.Dispatch(unsigned(rateTex.GetWidth()), rateTex.GetHeight(), 1);
+	commandList.UAVBarrier(rateTex);
+
+	m_prevVP = VP;
+	m_historyValid = true;
+}
+
+
+void ShadingRateImage::InitRateImage(SetupContext& context, uint64_t width, uint32_t height) {
+	m_renderWidth = width;
+	m_renderHeight = height;
+
+	const unsigned tileSize = m_caps.imageTileSize;
+	Texture2DDesc texDesc{ (width + tileSize - 1) / tileSize, (height + tileSize - 1) / tileSize, RateFormat, 1 };
+	Texture2D tex = context.CreateTexture2D(texDesc, { true, false, false, true });
+	tex.SetName("Shading rate image");
+
+	gxapi::UavTexture2DArray uavDesc;
+	uavDesc.activeArraySize = 1;
+	uavDesc.firstArrayElement = 0;
+	uavDesc.mipLevel = 0;
+	uavDesc.planeIndex = 0;
+	m_rateUav = context.CreateUav(tex, RateFormat, uavDesc);
+
+	// The previous frame's color no longer lines up with the depth.
+	m_historyValid = false;
+}
+
+
+} // namespace inl::gxeng::nodes
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <GraphicsApi_LL/HardwareCapability.hpp>
+#include <GraphicsApi_LL/IPipelineState.hpp>
+#include <GraphicsEngine_LL/BasicCamera.hpp>
+#include <GraphicsEngine_LL/GraphicsNode.hpp>
+
+
+namespace inl::gxeng::nodes {
+
+
+/// <summary>
+/// Picks a shading rate for each screen tile from how fast the tile moves and how much contrast it has.
+/// Inputs: color of the previous frame, depth of this frame, camera.
+/// Outputs: shading rate image, empty if the device has no tier 2 variable rate shading.
+/// </summary>
+/// <remarks>
+/// Motion comes from reprojecting this frame's depth with the previous frame's camera, so only camera motion
+/// coarsens the rate, and the slowest pixel of the tile decides. Contrast is measured on the color the render
+/// target kept from the previous frame, which must be linked before something draws into it this frame.
+/// Blocks are coarsened along the direction of motion, and in both directions where the tile is flat.
+/// The first frame and the frame after a resize are shaded at full rate, as there is nothing to reproject.
+/// </remarks>
+class ShadingRateImage : virtual public GraphicsNode,
+						 virtual public GraphicsTask,
+						 virtual public InputPortConfig<Texture2D, Texture2D, const BasicCamera*>,
+						 virtual public OutputPortConfig<Texture2D> {
+public:
+	static const char* Info_GetName() { return "ShadingRateImage"; }
+	const std::string& GetInputName(size_t index) const override;
+	const std::string& GetOutputName(size_t index) const override;
+	ShadingRateImage();
+
+	void Update() override {}
+	void Notify(InputPortBase* sender) override {}
+	void Initialize(EngineContext& context) override;
+	void Reset() override;
+	void Setup(SetupContext& context) override;
+	void Execute(RenderContext& context) override;
+
+	/// <summary> Pixels per frame from which the tile is shaded at half rate along the motion, at quarter rate from twice as fast. </summary>
+	static constexpr float MotionThreshold = 4.0f;
+	/// <summary> Relative luminance contrast below which the tile is shaded at half rate, at quarter rate below half of it. </summary>
+	static constexpr float ContrastThreshold = 0.12f;
+
+private:
+	void InitRateImage(SetupContext& context, uint64_t width, uint32_t height);
+
+private:
+	gxapi::CapsVariableRateShading m_caps;
+	bool m_capsQueried = false;
+
+	TextureView2D m_colorView;
+	TextureView2D m_depthView;
+	RWTextureView2D m_rateUav;
+	const BasicCamera* m_camera = nullptr;
+
+	uint64_t m_renderWidth = 0;
+	uint32_t m_renderHeight = 0;
+	Mat44 m_prevVP;
+	bool m_historyValid = false;
+
+	Binder m_binder;
+	BindParameter m_uniformsBindParam;
+	BindParameter m_colorBindParam;
+	BindParameter m_depthBindParam;
+	BindParameter m_rateBindParam;
+	ShaderProgram m_shader;
+	std::unique_ptr<gxapi::IPipelineState> m_CSO;
+};
+
+
+} // namespace inl::gxeng::nodes
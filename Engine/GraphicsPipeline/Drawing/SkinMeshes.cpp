@@ -0,0 +1,341 @@
+#include "SkinMeshes.hpp"
+
+#include <GraphicsEngine_LL/AutoRegisterNode.hpp>
+#include <GraphicsEngine_LL/ComputeCommandList.hpp>
+#include <GraphicsEngine_LL/Mesh.hpp>
+
+#include <BaseLibrary/JobSystem/Parallel.hpp>
+
+#include <algorithm>
+
+
+namespace inl::gxeng::nodes {
+
+
+INL_REGISTER_GRAPHICS_NODE(SkinMeshes)
+
+
+namespace {
+
+// Layout must match SkinMeshes.hlsl.
+struct Uniforms {
+	Vec4_Packed sourceDequantization; // Offset of the mesh's positions, then their scale.
+	Vec4_Packed targetQuantization; // Offset of the skin's pose bounds, then the inverse of their scale.
+	uint32_t vertexCount;
+	uint32_t paletteOffset; // First joint of the entity's palette.
+	uint32_t jointCount;
+	uint32_t padding;
+};
+
+} // namespace
+
+static_assert(sizeof(SkinningMatrix) == 48, "Must match shaders.");
+
+static constexpr unsigned SkinGroupSize = 64;
+static constexpr size_t MaxVertices = size_t(65535) * SkinGroupSize; // Dispatches are one dimensional.
+static constexpr size_t StatesPerChunk = 8;
+static constexpr size_t MinPaletteCapacity = 1024;
+static constexpr uint64_t ReleaseDelay = 120; // Frames buffers are kept unused, so entities going in and out of view keep theirs.
+
+
+static bool CheckMeshFormat(const Mesh& mesh) {
+	if (mesh.GetNumStreams() != 1 || mesh.GetVertexBufferStride(0) != 16) {
+		return false;
+	}
+	auto& elements = mesh.GetLayout()[0];
+	if (elements.size() != 3)
+		return false;
+	if (elements[0].semantic != eVertexElementSemantic::POSITION || elements[0].format != gxapi::eFormat::R16G16B16A16_UNORM || elements[0].offset != 0)
+		return false;
+	if (elements[1].semantic != eVertexElementSemantic::NORMAL || elements[1].format != gxapi::eFormat::R16G16_SNORM || elements[1].offset != 8)
+		return false;
+	if (elements[2].semantic != eVertexElementSemantic::TEX_COORD || elements[2].format != gxapi::eFormat::R16G16_FLOAT || elements[2].offset != 12)
+		return false;
+
+	return true;
+}
+
+
+static gxapi::SrvBuffer RawSrvDesc(size_t size) {
+	gxapi::SrvBuffer desc;
+	desc.firstElement = 0;
+	desc.numElements = unsigned(size / sizeof(uint32_t));
+	desc.structureStrideInBytes = 0;
+	desc.isRaw = true;
+	return desc;
+}
+
+
+void SkinMeshes::Initialize(EngineContext& context) {
+	GraphicsNode::SetTaskSingle(this);
+}
+
+
+void SkinMeshes::Reset() {
+	m_entities = nullptr;
+	m_dispatches.clear();
+	m_sourceMeshes.clear();
+
+	GetInput<0>().Clear();
+}
+
+
+const std::string& SkinMeshes::GetInputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"entities",
+	};
+	return names[index];
+}
+
+
+const std::string& SkinMeshes::GetOutputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"skinnedEntities",
+	};
+	return names[index];
+}
+
+
+void SkinMeshes::Setup(SetupContext& context) {
+	m_entities = GetInput<0>().Get();
+	if (!m_entities) {
+		throw InvalidArgumentException("Entities must be connected.");
+	}
+	++m_frame;
+
+	if (!m_binder) {
+		BindParameterDesc uniformsBindParamDesc;
+		m_uniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
+		uniformsBindParamDesc.parameter = m_uniformsBindParam;
+		uniformsBindParamDesc.constantSize = sizeof(Uniforms);
+		uniformsBindParamDesc.relativeAccessFrequency = 0;
+		uniformsBindParamDesc.relativeChangeFrequency = 0;
+		uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc sourceBindParamDesc;
+		m_sourceBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		sourceBindParamDesc.parameter = m_sourceBindParam;
+		sourceBindParamDesc.constantSize = 0;
+		sourceBindParamDesc.relativeAccessFrequency = 0;
+		sourceBindParamDesc.relativeChangeFrequency = 0;
+		sourceBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc influencesBindParamDesc = sourceBindParamDesc;
+		m_influencesBindParam = BindParameter(eBindParameterType::TEXTURE, 1);
+		influencesBindParamDesc.parameter = m_influencesBindParam;
+
+		BindParameterDesc paletteBindParamDesc = sourceBindParamDesc;
+		m_paletteBindParam = BindParameter(eBindParameterType::TEXTURE, 2);
+		paletteBindParamDesc.parameter = m_paletteBindParam;
+
+		BindParameterDesc targetBindParamDesc = sourceBindParamDesc;
+		m_targetBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		targetBindParamDesc.parameter = m_targetBindParam;
+
+		m_binder = context.CreateBinder({ uniformsBindParamDesc, sourceBindParamDesc, influencesBindParamDesc, paletteBindParamDesc, targetBindParamDesc });
+	}
+
+	if (!m_CSO) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_shader = context.CreateShader("SkinMeshes", shaderParts, "");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_binder.GetRootSignature();
+		csoDesc.cs = m_shader.cs;
+
+		m_CSO.reset(context.CreatePSO(csoDesc));
+	}
+
+	CollectDispatches(context, *m_entities);
+	EvaluatePalettes(context);
+	ReleaseUnused();
+
+	GetOutput<0>().Set(m_entities);
+}
+
+
+void SkinMeshes::Execute(RenderContext& context) {
+	if (m_dispatches.empty()) {
+		return;
+	}
+	ComputeCommandList& commandList = context.AsCompute();
+
+	// A skin's influences never change, the mesh is copied again in case it was updated.
+	for (const SkinDispatch& dispatch : m_dispatches) {
+		if (!dispatch.influences->uploaded) {
+			const std::vector<uint32_t>& packed = dispatch.skin->GetPacked();
+			commandList.SetResourceState(dispatch.influences->buffer, gxapi::eResourceState::COPY_DEST);
+			context.Upload(dispatch.influences->buffer, 0, packed.data(), packed.size() * sizeof(uint32_t));
+			dispatch.influences->uploaded = true;
+		}
+	}
+	for (const Mesh* mesh : m_sourceMeshes) {
+		const VertexBuffer& vertexBuffer = mesh->GetVertexBuffer(0);
+		const SourceBuffer& source = m_sources[mesh];
+		commandList.SetResourceState(vertexBuffer, gxapi::eResourceState::COPY_SOURCE);
+		commandList.SetResourceState(source.buffer, gxapi::eResourceState::COPY_DEST);
+		commandList.CopyBuffer(source.buffer, 0, vertexBuffer, 0, vertexBuffer.GetSize());
+	}
+	commandList.SetResourceState(m_paletteBuffer, gxapi::eResourceState::COPY_DEST);
+	context.Upload(m_paletteBuffer, 0, m_palettes.data(), m_palettes.size() * sizeof(SkinningMatrix));
+
+	commandList.SetResourceState(m_paletteBuffer, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
+	for (const SkinDispatch& dispatch : m_dispatches) {
+		commandList.SetResourceState(dispatch.source->buffer, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
+		commandList.SetResourceState(dispatch.influences->buffer, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
+		commandList.SetResourceState(dispatch.target->buffer, gxapi::eResourceState::UNORDERED_ACCESS);
+	}
+
+	commandList.SetPipelineState(m_CSO.get());
+	commandList.SetComputeBinder(&m_binder);
+	commandList.BindCompute(m_paletteBindParam, m_paletteView);
+	for (const SkinDispatch& dispatch : m_dispatches) {
+		const Mat44 dequantization = dispatch.mesh->GetPositionDequantization();
+		const PositionQuantization& quantization = dispatch.skin->GetPositionQuantization();
+
+		Uniforms uniforms;
+		uniforms.sourceDequantization = Vec4(dequantization(3, 0), dequantization(3, 1), dequantization(3, 2), dequantization(0, 0));
+		uniforms.targetQuantization = Vec4(quantization.offset, 1.0f / quantization.scale);
+		uniforms.vertexCount = dispatch.vertexCount;
+		uniforms.paletteOffset = dispatch.paletteOffset;
+		uniforms.jointCount = dispatch.jointCount;
+		uniforms.padding = 0;
+
+		commandList.BindCompute(m_uniformsBindParam, &uniforms, sizeof(uniforms));
+		commandList.BindCompute(m_sourceBindParam, dispatch.source->view);
+		commandList.BindCompute(m_influencesBindParam, dispatch.influences->view);
+		commandList.BindCompute(m_targetBindParam, dispatch.target->view);
+		commandList.Dispatch((dispatch.vertexCount + SkinGroupSize - 1) / SkinGroupSize, 1, 1);
+	}
+
+	// The passes drawing the entities read them as vertex buffers.
+	for (const SkinDispatch& dispatch : m_dispatches) {
+		commandList.SetResourceState(dispatch.target->buffer, gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
+	}
+}
+
+
+void SkinMeshes::CollectDispatches(SetupContext& context, const EntityCollection<MeshEntity>& entities) {
+	m_dispatches.clear();
+	m_sourceMeshes.clear();
+	m_states.clear();
+	m_stateOffsets.clear();
+	m_stateIndices.clear();
+
+	uint32_t paletteJoints = 0;
+	for (const MeshEntity* entity : entities) {
+		const Mesh* mesh = entity->GetMesh();
+		if (!entity->IsAnimated() || !mesh || !CheckMeshFormat(*mesh)) {
+			continue;
+		}
+		const Skin* skin = entity->GetSkin();
+		const AnimationState* state = entity->GetAnimationState();
+		const Skeleton* skeleton = state->GetSkeleton();
+		const size_t size = mesh->GetVertexBuffer(0).GetSize();
+		const size_t vertexCount = size / mesh->GetVertexBufferStride(0);
+		if (!skeleton || skeleton->GetJointCount() == 0 || vertexCount == 0 || vertexCount > MaxVertices || skin->GetVertexCount() != vertexCount) {
+			continue;
+		}
+		const uint32_t jointCount = uint32_t(skeleton->GetJointCount());
+
+		// Entities moving in step share their palette.
+		auto [stateIt, isNewState] = m_stateIndices.insert({ state, uint32_t(m_states.size()) });
+		if (isNewState) {
+			m_states.push_back(state);
+			m_stateOffsets.push_back(paletteJoints);
+			paletteJoints += jointCount;
+		}
+
+		SourceBuffer& source = m_sources[mesh];
+		if (!source.buffer || source.buffer.GetSize() != size) {
+			source.buffer = context.CreateBuffer(size);
+			source.buffer.SetName("Skinning source vertices");
+			source.view = context.CreateSrv(source.buffer, gxapi::eFormat::R32_TYPELESS, RawSrvDesc(size));
+		}
+		if (source.lastUsed != m_frame) {
+			source.lastUsed = m_frame;
+			m_sourceMeshes.push_back(mesh);
+		}
+
+		InfluenceBuffer& influences = m_influences[skin->GetId()];
+		if (!influences.buffer) {
+			const size_t influencesSize = skin->GetPacked().size() * sizeof(uint32_t);
+			influences.buffer = context.CreateBuffer(influencesSize);
+			influences.buffer.SetName("Skin influences");
+			influences.view = context.CreateSrv(influences.buffer, gxapi::eFormat::R32_TYPELESS, RawSrvDesc(influencesSize));
+		}
+		influences.lastUsed = m_frame;
+
+		TargetBuffer& target = m_targets[entity];
+		if (!target.buffer || target.buffer.GetSize() != size) {
+			gxapi::UavBuffer desc;
+			desc.raw = true;
+			desc.firstElement = 0;
+			desc.numElements = unsigned(size / sizeof(uint32_t));
+			desc.elementStride = 0;
+			desc.countOffset = 0;
+
+			target.buffer = context.CreateBuffer(size, true);
+			target.buffer.SetName("Skinned vertices");
+			target.view = context.CreateUav(target.buffer, gxapi::eFormat::R32_TYPELESS, desc);
+			target.vertices = VertexBuffer(target.buffer, 0, size, [] {});
+		}
+		target.lastUsed = m_frame;
+		entity->SetSkinnedVertices(target.vertices);
+
+		m_dispatches.push_back({ entity, mesh, skin, &source, &influences, &target, uint32_t(vertexCount), jointCount, m_stateOffsets[stateIt->second] });
+	}
+
+	m_palettes.resize(paletteJoints);
+	ReservePalettes(context, m_palettes.size());
+}
+
+
+void SkinMeshes::EvaluatePalettes(SetupContext& context) {
+	jobs::CooperativeFor(context.GetJobScheduler(), m_states.size(), StatesPerChunk, [this](size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i) {
+			m_states[i]->EvaluatePalette(m_palettes.data() + m_stateOffsets[i]);
+		}
+	});
+}
+
+
+void SkinMeshes::ReservePalettes(SetupContext& context, size_t jointCount) {
+	if (m_paletteBuffer && jointCount <= m_paletteCapacity) {
+		return;
+	}
+
+	// Grows geometrically, the palettes are uploaded again every frame anyway.
+	m_paletteCapacity = std::max(jointCount, std::max(2 * m_paletteCapacity, MinPaletteCapacity));
+	m_paletteBuffer = context.CreateBuffer(m_paletteCapacity * sizeof(SkinningMatrix));
+	m_paletteBuffer.SetName("Skinning palettes");
+
+	gxapi::SrvBuffer desc;
+	desc.firstElement = 0;
+	desc.numElements = unsigned(m_paletteCapacity * 3);
+	desc.structureStrideInBytes = sizeof(Vec4_Packed);
+	desc.isRaw = false;
+	m_paletteView = context.CreateSrv(m_paletteBuffer, gxapi::eFormat::UNKNOWN, desc);
+}
+
+
+void SkinMeshes::ReleaseUnused() {
+	const auto IsUnused = [this](const auto& entry) {
+		return entry.second.lastUsed + ReleaseDelay < m_frame;
+	};
+	for (auto it = m_sources.begin(); it != m_sources.end();) {
+		it = IsUnused(*it) ? m_sources.erase(it) : std::next(it);
+	}
+	for (auto it = m_influences.begin(); it != m_influences.end();) {
+		it = IsUnused(*it) ? m_influences.erase(it) : std::next(it);
+	}
+	// The entity keeps drawing its last pose from its own reference to the buffer.
+	for (auto it = m_targets.begin(); it != m_targets.end();) {
+		it = IsUnused(*it) ? m_targets.erase(it) : std::next(it);
+	}
+}
+
+
+} // namespace inl::gxeng::nodes
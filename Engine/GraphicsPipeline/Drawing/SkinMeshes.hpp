@@ -0,0 +1,122 @@
+#pragma once
+
+#include <GraphicsApi_LL/IPipelineState.hpp>
+#include <GraphicsEngine_LL/AnimationState.hpp>
+#include <GraphicsEngine_LL/GraphicsNode.hpp>
+#include <GraphicsEngine_LL/MeshEntity.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace inl::gxeng {
+class Mesh;
+} // namespace inl::gxeng
+
+
+namespace inl::gxeng::nodes {
+
+
+/// <summary>
+/// Deforms the animated mesh entities into their current pose on the GPU.
+/// Inputs: entities.
+/// Outputs: the same entities, once skinned.
+/// </summary>
+/// <remarks>
+/// Connect it after frustum culling and before the passes that draw the entities, so that only the entities
+/// in view are skinned. The joint palettes are evaluated on the job system, once for each animation state,
+/// then the vertices are skinned in compute into a vertex buffer of each entity, which the depth, shadow and
+/// forward passes draw instead of the mesh's, see <see cref="MeshEntity::GetVertexBuffer"/>.
+/// Only meshes in the standard format are skinned: a single stream of quantized positions,
+/// octahedral normals and half texture coordinates. The rest are drawn as they are.
+/// </remarks>
+class SkinMeshes : virtual public GraphicsNode,
+				   virtual public GraphicsTask,
+				   virtual public InputPortConfig<const EntityCollection<MeshEntity>*>,
+				   virtual public OutputPortConfig<const EntityCollection<MeshEntity>*> {
+public:
+	static const char* Info_GetName() { return "SkinMeshes"; }
+	const std::string& GetInputName(size_t index) const override;
+	const std::string& GetOutputName(size_t index) const override;
+	SkinMeshes() = default;
+
+	void Update() override {}
+	void Notify(InputPortBase* sender) override {}
+
+	void Initialize(EngineContext& context) override;
+	void Reset() override;
+	void Setup(SetupContext& context) override;
+	void Execute(RenderContext& context) override;
+
+private:
+	// Stream 0 of a mesh copied into a buffer of its own, views cannot be made of the shared vertex buffers.
+	struct SourceBuffer {
+		LinearBuffer buffer;
+		BufferView view;
+		uint64_t lastUsed = 0;
+	};
+
+	// Joint indices and weights of a skin.
+	struct InfluenceBuffer {
+		LinearBuffer buffer;
+		BufferView view;
+		uint64_t lastUsed = 0;
+		bool uploaded = false;
+	};
+
+	// Skinned vertices of an entity, kept while in use so that its buffer is reused every frame.
+	struct TargetBuffer {
+		LinearBuffer buffer;
+		RWBufferView view;
+		VertexBuffer vertices; // The whole buffer, given to the entity to draw.
+		uint64_t lastUsed = 0;
+	};
+
+	struct SkinDispatch {
+		const MeshEntity* entity;
+		const Mesh* mesh;
+		const Skin* skin;
+		const SourceBuffer* source;
+		InfluenceBuffer* influences; // Uploaded by the first dispatch using it.
+		const TargetBuffer* target;
+		uint32_t vertexCount;
+		uint32_t jointCount;
+		uint32_t paletteOffset; // In joints.
+	};
+
+private:
+	void CollectDispatches(SetupContext& context, const EntityCollection<MeshEntity>& entities);
+	void EvaluatePalettes(SetupContext& context);
+	void ReservePalettes(SetupContext& context, size_t jointCount);
+	void ReleaseUnused();
+
+private:
+	Binder m_binder;
+	BindParameter m_uniformsBindParam;
+	BindParameter m_sourceBindParam;
+	BindParameter m_influencesBindParam;
+	BindParameter m_paletteBindParam;
+	BindParameter m_targetBindParam;
+	ShaderProgram m_shader;
+	std::unique_ptr<gxapi::IPipelineState> m_CSO;
+
+	std::unordered_map<const Mesh*, SourceBuffer> m_sources;
+	std::unordered_map<uint64_t, InfluenceBuffer> m_influences; // By skin id.
+	std::unordered_map<const MeshEntity*, TargetBuffer> m_targets;
+	uint64_t m_frame = 0;
+
+	std::vector<SkinDispatch> m_dispatches;
+	std::vector<const Mesh*> m_sourceMeshes; // Meshes of the dispatches, copied every frame so that updates to them show.
+	std::vector<const AnimationState*> m_states; // The distinct states of the dispatches.
+	std::vector<uint32_t> m_stateOffsets; // First joint of each state in the palettes.
+	std::unordered_map<const AnimationState*, uint32_t> m_stateIndices;
+
+	std::vector<SkinningMatrix> m_palettes;
+	LinearBuffer m_paletteBuffer;
+	BufferView m_paletteView;
+	size_t m_paletteCapacity = 0; // In joints.
+
+	const EntityCollection<MeshEntity>* m_entities = nullptr;
+};
+
+
+} // namespace inl::gxeng::nodes
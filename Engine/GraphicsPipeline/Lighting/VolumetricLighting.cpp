@@ -28,7 +28,7 @@ struct Uniforms {
 	LightData ld[10]; //480
 	Mat44_Packed v, p; //64
 	Mat44_Packed invVP, oldVP; //128
-	float camNear, camFar, dummy1, dummy2; //16
+	float camNear, camFar, numSteps, historyBlend; //16
 	uint32_t numSdfs, numWorkgroupsX, numWorkgroupsY;
 	float haltonFactor; //16
 	Vec4_Packed sunDirection; //16
@@ -77,6 +77,23 @@ VolumetricLighting::VolumetricLighting() {
 
 void VolumetricLighting::Initialize(EngineContext& context) {
 	GraphicsNode::SetTaskSingle(this);
+
+	// The accumulated result converges to the full solve over a few frames, so a frame marches fewer steps.
+	switch (context.GetQualityPreset()) {
+		case eQualityPreset::LOW:
+			m_temporal = true;
+			m_numSteps = 16;
+			break;
+		case eQualityPreset::MEDIUM:
+			m_temporal = true;
+			m_numSteps = 24;
+			break;
+		default:
+			m_temporal = false;
+			m_numSteps = 64;
+			break;
+	}
+	m_historyValid = false;
 }
 
 void VolumetricLighting::Reset() {
@@ -340,7 +357,7 @@ void VolumetricLighting::Execute(RenderContext& context) {
 
 	ComputeCommandList& commandList = context.AsCompute();
 
-	//swap dest textures
+	//swap dest textures, the last result is the history
 	auto tmp = m_volDstTexUAV[0];
 	m_volDstTexUAV[0] = m_volDstTexUAV[1];
 	m_volDstTexUAV[1] = tmp;
@@ -349,13 +366,17 @@ void VolumetricLighting::Execute(RenderContext& context) {
 
 	uniformsCBData.camNear = m_camera->GetNearPlane();
 	uniformsCBData.camFar = m_camera->GetFarPlane();
+	uniformsCBData.numSteps = (float)m_numSteps;
+	uniformsCBData.historyBlend = m_temporal && m_historyValid ? TemporalBlend : 1.0f;
+	m_historyValid = true;
 	uniformsCBData.numSdfs = 1;
 	uniformsCBData.v = m_camera->GetViewMatrix();
 	uniformsCBData.p = m_camera->GetProjectionMatrix();
 
-	static uint32_t haltonIndex = 0;
+	// Samples move along the ray each frame, the accumulation averages over the jitter sequence.
 	const uint32_t haltonBase = 2;
-	uniformsCBData.haltonFactor = getHalton(haltonIndex++, haltonBase);
+	uniformsCBData.haltonFactor = m_temporal ? getHalton(1 + m_jitterIndex, haltonBase) : 0.0f;
+	m_jitterIndex = (m_jitterIndex + 1) % JitterSequenceLength;
 
 	uniformsCBData.camPos = Vec4(m_camera->GetPosition(), 1);
 
@@ -7,6 +7,12 @@
 namespace inl::gxeng::nodes {
 
 
+/// <summary> Ray marched scattering of the sun and the lights, blended over the lit scene. </summary>
+/// <remarks>
+/// In temporal mode the ray march samples are jittered per frame and the result is accumulated over frames,
+/// reprojected with the previous camera and clamped to the neighborhood of the current result.
+/// The quality preset picks the mode and the steps per frame.
+/// </remarks>
 class VolumetricLighting : virtual public GraphicsNode,
 						   virtual public GraphicsTask,
 						   virtual public InputPortConfig<Texture2D, Texture2D, Texture2D, const BasicCamera*, Texture2D, Texture2D, Texture2D>,
@@ -61,6 +67,13 @@ protected: // render context
 	TextureView2D m_depthTexSrv;
 	const BasicCamera* m_camera;
 	Mat44 m_prevVP;
+
+	static constexpr float TemporalBlend = 0.1f; // Weight of the current frame in the accumulated result.
+	static constexpr uint32_t JitterSequenceLength = 8;
+	bool m_temporal = false;
+	bool m_historyValid = false;
+	unsigned m_numSteps = 64;
+	uint32_t m_jitterIndex = 0;
 	//const EntityCollection<PointLight>* m_lights;
 
 private:
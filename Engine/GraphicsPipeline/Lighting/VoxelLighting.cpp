@@ -6,6 +6,7 @@
 #include <GraphicsEngine_LL/GraphicsCommandList.hpp>
 #include <GraphicsEngine_LL/Mesh.hpp>
 
+#include <cstddef>
 
 
 namespace inl::gxeng::nodes {
@@ -16,7 +17,12 @@ INL_REGISTER_GRAPHICS_NODE(VoxelLighting)
 const int voxelDimension = 256; //units
 const float voxelSize = 0.16f; //meters
 const Vec3 voxelOrigin = Vec3(voxelDimension * voxelSize * -0.5);
-const Vec3 voxelCenter = Vec3(0.0f);
+const int brickSize = 8; //voxels, must match VoxelBrickCompact.hlsl
+const int bricksPerSide = voxelDimension / brickSize;
+const int brickCount = bricksPerSide * bricksPerSide * bricksPerSide;
+const bool visualizeVoxels = false; //draws the occupied voxels into the color target
+
+static_assert(brickCount <= 65535, "The mipmap generation dispatches a group for each brick along a single dimension.");
 
 struct Uniforms {
 	Mat44_Packed model, viewProj, invView;
@@ -30,33 +36,12 @@ struct Uniforms {
 	float nearPlane, farPlane;
 };
 
-static void SetWorkgroupSize(unsigned w, unsigned h, unsigned d, unsigned groupSizeW, unsigned groupSizeH, unsigned groupSizeD, unsigned& dispatchW, unsigned& dispatchH, unsigned& dispatchD) {
-	//set up work group sizes
-	unsigned gw = 0, gh = 0, gd = 0, count = 1;
-
-	while (gw < w) {
-		gw = groupSizeW * count;
-		count++;
-	}
-
-	count = 1;
-
-	while (gh < h) {
-		gh = groupSizeH * count;
-		count++;
-	}
-
-	count = 1;
-
-	while (gd < d) {
-		gd = groupSizeD * count;
-		count++;
-	}
-
-	dispatchW = unsigned(float(gw) / groupSizeW);
-	dispatchH = unsigned(float(gh) / groupSizeH);
-	dispatchD = unsigned(float(gd) / groupSizeD);
-}
+//indirect arguments counted up by VoxelBrickCompact.hlsl
+struct BrickArguments {
+	gxapi::DispatchArguments mipmap; //a group for each occupied brick
+	gxapi::DrawArguments visualizer; //a point for each voxel of the occupied bricks
+};
+static_assert(sizeof(BrickArguments) == 7 * sizeof(uint32_t), "Must match brick compaction shader.");
 
 static bool CheckMeshFormat(const Mesh& mesh) {
 	for (size_t i = 0; i < mesh.GetNumStreams(); i++) {
@@ -102,6 +87,13 @@ VoxelLighting::VoxelLighting() {
 	this->GetInput<2>().Set({});
 	this->GetInput<3>().Set({});
 	this->GetInput<4>().Set({});
+
+	// Without a voxelization that follows the camera, the window is fixed around the world origin.
+	VoxelVolume fixedVolume;
+	fixedVolume.origin = Vec3i(-voxelDimension / 2);
+	fixedVolume.voxelSize = voxelSize;
+	fixedVolume.dimension = voxelDimension;
+	this->GetInput<10>().Set(fixedVolume);
 }
 
 
@@ -133,7 +125,8 @@ const std::string& VoxelLighting::GetInputName(size_t index) const {
 		"shadowCSMExtentsTex",
 		"velocityNormalTex",
 		"albedoRoughnessMetalnessTex",
-		"screenSpaceAmbientOcclusion"
+		"screenSpaceAmbientOcclusion",
+		"volume"
 	};
 	return names[index];
 }
@@ -148,6 +141,7 @@ const std::string& VoxelLighting::GetOutputName(size_t index) const {
 
 void VoxelLighting::Setup(SetupContext& context) {
 	m_camera = this->GetInput<0>().Get();
+	m_volume = this->GetInput<10>().Get();
 
 	auto& voxelColorTex = this->GetInput<1>().Get();
 	auto& voxelAlphaNormalTex = this->GetInput<2>().Get();
@@ -337,14 +331,37 @@ void VoxelLighting::Setup(SetupContext& context) {
 		gxapi::StaticSamplerDesc samplerDesc2;
 		samplerDesc2.shaderRegister = 2;
 		samplerDesc2.filter = gxapi::eTextureFilterMode::MIN_MAG_MIP_LINEAR;
-		samplerDesc2.addressU = gxapi::eTextureAddressMode::CLAMP;
-		samplerDesc2.addressV = gxapi::eTextureAddressMode::CLAMP;
-		samplerDesc2.addressW = gxapi::eTextureAddressMode::CLAMP;
+		// The voxel textures are addressed toroidally.
+		samplerDesc2.addressU = gxapi::eTextureAddressMode::WRAP;
+		samplerDesc2.addressV = gxapi::eTextureAddressMode::WRAP;
+		samplerDesc2.addressW = gxapi::eTextureAddressMode::WRAP;
 		samplerDesc2.mipLevelBias = 0.f;
 		samplerDesc2.registerSpace = 0;
 		samplerDesc2.shaderVisibility = gxapi::eShaderVisiblity::ALL;
 
-		m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc, sampBindParamDesc1, sampBindParamDesc2, voxelTexBindParamDesc, voxelLightTexBindParamDesc, tex0BindParamDesc, tex1BindParamDesc, tex2BindParamDesc, tex3BindParamDesc, tex4BindParamDesc, tex5BindParamDesc, tex6BindParamDesc }, { samplerDesc, samplerDesc1, samplerDesc2 });
+		BindParameterDesc brickListBindParamDesc = voxelTexBindParamDesc;
+		m_brickListBindParam = BindParameter(eBindParameterType::UNORDERED, 2);
+		brickListBindParamDesc.parameter = m_brickListBindParam;
+
+		BindParameterDesc brickOccupancyBindParamDesc = voxelTexBindParamDesc;
+		m_brickOccupancyBindParam = BindParameter(eBindParameterType::UNORDERED, 3);
+		brickOccupancyBindParamDesc.parameter = m_brickOccupancyBindParam;
+
+		BindParameterDesc brickArgumentsBindParamDesc = voxelTexBindParamDesc;
+		m_brickArgumentsBindParam = BindParameter(eBindParameterType::UNORDERED, 4);
+		brickArgumentsBindParamDesc.parameter = m_brickArgumentsBindParam;
+
+		BindParameterDesc brickListSrvBindParamDesc = tex0BindParamDesc;
+		m_brickListSrvBindParam = BindParameter(eBindParameterType::TEXTURE, 7);
+		brickListSrvBindParamDesc.parameter = m_brickListSrvBindParam;
+
+		BindParameterDesc brickOccupancySrvBindParamDesc = tex0BindParamDesc;
+		m_brickOccupancySrvBindParam = BindParameter(eBindParameterType::TEXTURE, 8);
+		brickOccupancySrvBindParamDesc.parameter = m_brickOccupancySrvBindParam;
+
+		m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc, sampBindParamDesc1, sampBindParamDesc2, voxelTexBindParamDesc, voxelLightTexBindParamDesc, tex0BindParamDesc, tex1BindParamDesc, tex2BindParamDesc, tex3BindParamDesc, tex4BindParamDesc, tex5BindParamDesc, tex6BindParamDesc,
+										  brickListBindParamDesc, brickOccupancyBindParamDesc, brickArgumentsBindParamDesc, brickListSrvBindParamDesc, brickOccupancySrvBindParamDesc },
+										{ samplerDesc, samplerDesc1, samplerDesc2 });
 	}
 
 	if (!m_lightInjectionCSMShader.vs || !m_lightInjectionCSMShader.gs || !m_lightInjectionCSMShader.ps) {
@@ -362,7 +379,8 @@ void VoxelLighting::Setup(SetupContext& context) {
 		shaderParts.vs = false;
 		shaderParts.ps = false;
 		shaderParts.gs = false;
-		m_mipmapShader = context.CreateShader("VoxelMipmap", shaderParts, "");
+		m_mipmapShader = context.CreateShader("VoxelMipmap", shaderParts, "VOXEL_BRICKS=1");
+		m_brickCompactShader = context.CreateShader("VoxelBrickCompact", shaderParts, "");
 
 		shaderParts.cs = false;
 		shaderParts.vs = true;
@@ -462,6 +480,24 @@ void VoxelLighting::Setup(SetupContext& context) {
 
 			m_mipmapCSO.reset(context.CreatePSO(csoDesc));
 		}
+
+		{ //occupied brick compaction shader
+			gxapi::ComputePipelineStateDesc csoDesc;
+			csoDesc.rootSignature = m_binder.GetRootSignature();
+			csoDesc.cs = m_brickCompactShader.cs;
+
+			m_brickCompactCSO.reset(context.CreatePSO(csoDesc));
+		}
+	}
+
+	if (m_mipmapCommandSignature == nullptr) {
+		gxapi::CommandSignatureDesc signatureDesc;
+		signatureDesc.byteStride = sizeof(BrickArguments);
+		signatureDesc.arguments = { gxapi::IndirectArgumentDesc::Dispatch() };
+		m_mipmapCommandSignature.reset(context.CreateCommandSignature(signatureDesc));
+
+		signatureDesc.arguments = { gxapi::IndirectArgumentDesc::Draw() };
+		m_visualizerCommandSignature.reset(context.CreateCommandSignature(signatureDesc));
 	}
 
 	this->GetOutput<0>().Set(m_visualizationTexRTV.GetResource());
@@ -477,9 +513,9 @@ void VoxelLighting::Execute(RenderContext& context) {
 
 	Uniforms uniformsCBData;
 
-	uniformsCBData.voxelDimension = voxelDimension;
-	uniformsCBData.voxelCenter = voxelCenter;
-	uniformsCBData.voxelSize = voxelSize;
+	uniformsCBData.voxelDimension = m_volume.dimension;
+	uniformsCBData.voxelCenter = m_volume.GetCenter();
+	uniformsCBData.voxelSize = m_volume.voxelSize;
 
 	uniformsCBData.nearPlane = m_camera->GetNearPlane();
 	uniformsCBData.farPlane = m_camera->GetFarPlane();
@@ -522,6 +558,30 @@ void VoxelLighting::Execute(RenderContext& context) {
 	commandList.SetResourceState(m_voxelLightTexUAV[0].GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
 	commandList.SetResourceState(m_voxelColorTexSRV.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
 
+	{ //occupied brick compaction
+		const BrickArguments initialArguments = { { 0, 1, 1 }, { 0, 1, 0, 0 } };
+		commandList.SetResourceState(m_brickArgumentsBuffer, gxapi::eResourceState::COPY_DEST);
+		context.Upload(m_brickArgumentsBuffer, 0, &initialArguments, sizeof(initialArguments));
+
+		commandList.SetResourceState(m_brickListBuffer, gxapi::eResourceState::UNORDERED_ACCESS);
+		commandList.SetResourceState(m_brickOccupancyBuffer, gxapi::eResourceState::UNORDERED_ACCESS);
+		commandList.SetResourceState(m_brickArgumentsBuffer, gxapi::eResourceState::UNORDERED_ACCESS);
+
+		commandList.SetPipelineState(m_brickCompactCSO.get());
+		commandList.SetComputeBinder(&m_binder);
+
+		commandList.BindCompute(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
+		commandList.BindCompute(m_tex0BindParam, m_voxelColorTexSRV);
+		commandList.BindCompute(m_brickListBindParam, m_brickListUAV);
+		commandList.BindCompute(m_brickOccupancyBindParam, m_brickOccupancyUAV);
+		commandList.BindCompute(m_brickArgumentsBindParam, m_brickArgumentsUAV);
+		commandList.Dispatch(bricksPerSide, bricksPerSide, bricksPerSide); //a group for each brick
+
+		commandList.SetResourceState(m_brickArgumentsBuffer, gxapi::eResourceState::INDIRECT_ARGUMENT);
+		commandList.SetResourceState(m_brickListBuffer, { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+		commandList.SetResourceState(m_brickOccupancyBuffer, { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	}
+
 	{ //light injection
 		gxapi::Rectangle rect{ 0, (int)m_shadowCSMTexSrv.GetResource().GetHeight(), 0, (int)m_shadowCSMTexSrv.GetResource().GetWidth() };
 		gxapi::Viewport viewport;
@@ -543,19 +603,16 @@ void VoxelLighting::Execute(RenderContext& context) {
 		commandList.BindGraphics(m_tex0BindParam, m_voxelColorTexSRV);
 		commandList.BindGraphics(m_tex1BindParam, m_shadowCSMTexSrv);
 		commandList.BindGraphics(m_tex2BindParam, m_shadowCSMExtentsTexSrv);
+		commandList.BindGraphics(m_brickOccupancySrvBindParam, m_brickOccupancySRV);
 
 		commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLESTRIP);
 		commandList.DrawInstanced(4);
 		commandList.UAVBarrier(m_voxelLightTexUAV[0].GetResource());
 	}
 
-	{ //light voxel mipmap generation
+	{ //light voxel mipmap generation, over the occupied bricks only
 		int numMips = m_voxelLightTexSRV.GetResource().GetNumMiplevels();
-		int currDim = voxelDimension / 2;
 		for (int c = 1; c < numMips; ++c) {
-			unsigned dispatchW, dispatchH, dispatchD;
-			SetWorkgroupSize(currDim, currDim, currDim, 8, 8, 8, dispatchW, dispatchH, dispatchD);
-
 			commandList.SetPipelineState(m_mipmapCSO.get());
 			commandList.SetComputeBinder(&m_binder);
 
@@ -569,14 +626,13 @@ void VoxelLighting::Execute(RenderContext& context) {
 
 			commandList.BindCompute(m_voxelColorTexBindParam, m_voxelLightTexUAV[c]);
 			commandList.BindCompute(m_tex0BindParam, m_voxelLightTexMipSRV[c - 1]);
-			commandList.Dispatch(dispatchW, dispatchH, dispatchD);
+			commandList.BindCompute(m_brickListSrvBindParam, m_brickListSRV);
+			commandList.DispatchIndirect(m_mipmapCommandSignature.get(), 1, m_brickArgumentsBuffer, offsetof(BrickArguments, mipmap));
 			commandList.UAVBarrier(m_voxelLightTexUAV[c].GetResource());
-
-			currDim = currDim / 2;
 		}
 	}
 
-	/*{ //visualization
+	if (visualizeVoxels) { //visualization
 		gxapi::Rectangle rect{ 0, (int)m_visualizationTexRTV.GetResource().GetHeight(), 0, (int)m_visualizationTexRTV.GetResource().GetWidth() };
 		gxapi::Viewport viewport;
 		viewport.width = (float)rect.right;
@@ -598,11 +654,13 @@ void VoxelLighting::Execute(RenderContext& context) {
 		commandList.SetGraphicsBinder(&m_binder);
 		commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::POINTLIST);
 
-		commandList.BindGraphics(m_tex0BindParam, m_voxelTexSRV);
+		commandList.BindGraphics(m_tex0BindParam, m_voxelColorTexSRV);
+		commandList.BindGraphics(m_brickListSrvBindParam, m_brickListSRV);
 
 		commandList.BindGraphics(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
-		commandList.DrawInstanced(voxelDimension * voxelDimension * voxelDimension); //draw points, expand in geometry shader
-	}*/
+		//draw points of the occupied bricks, expand in geometry shader
+		commandList.ExecuteIndirect(m_visualizerCommandSignature.get(), 1, m_brickArgumentsBuffer, offsetof(BrickArguments, visualizer));
+	}
 
 	{ //final gather
 		gxapi::Rectangle rect{ 0, (int)m_visualizationTexRTV.GetResource().GetHeight(), 0, (int)m_visualizationTexRTV.GetResource().GetWidth() };
@@ -694,6 +752,38 @@ void VoxelLighting::InitRenderTarget(SetupContext& context) {
 			m_voxelLightTexMipSRV[c] = context.CreateSrv(voxelLightTex, formatVoxel, srvDesc);
 			uavDesc.depthSize = uavDesc.depthSize / 2;
 		}
+
+		m_brickListBuffer = context.CreateBuffer(brickCount * sizeof(uint32_t), true);
+		m_brickListBuffer.SetName("VoxelLighting occupied bricks");
+		m_brickOccupancyBuffer = context.CreateBuffer(brickCount * sizeof(uint32_t), true);
+		m_brickOccupancyBuffer.SetName("VoxelLighting brick occupancy");
+		m_brickArgumentsBuffer = context.CreateBuffer(sizeof(BrickArguments), true);
+		m_brickArgumentsBuffer.SetName("VoxelLighting brick indirect arguments");
+
+		gxapi::UavBuffer structuredDesc;
+		structuredDesc.raw = false;
+		structuredDesc.firstElement = 0;
+		structuredDesc.numElements = brickCount;
+		structuredDesc.elementStride = sizeof(uint32_t);
+		structuredDesc.countOffset = 0;
+		m_brickListUAV = context.CreateUav(m_brickListBuffer, gxapi::eFormat::UNKNOWN, structuredDesc);
+		m_brickOccupancyUAV = context.CreateUav(m_brickOccupancyBuffer, gxapi::eFormat::UNKNOWN, structuredDesc);
+
+		gxapi::UavBuffer argumentsDesc;
+		argumentsDesc.raw = false;
+		argumentsDesc.firstElement = 0;
+		argumentsDesc.numElements = sizeof(BrickArguments) / sizeof(uint32_t);
+		argumentsDesc.elementStride = 0;
+		argumentsDesc.countOffset = 0;
+		m_brickArgumentsUAV = context.CreateUav(m_brickArgumentsBuffer, gxapi::eFormat::R32_UINT, argumentsDesc);
+
+		gxapi::SrvBuffer bufferDesc;
+		bufferDesc.firstElement = 0;
+		bufferDesc.numElements = brickCount;
+		bufferDesc.structureStrideInBytes = sizeof(uint32_t);
+		bufferDesc.isRaw = false;
+		m_brickListSRV = context.CreateSrv(m_brickListBuffer, gxapi::eFormat::UNKNOWN, bufferDesc);
+		m_brickOccupancySRV = context.CreateSrv(m_brickOccupancyBuffer, gxapi::eFormat::UNKNOWN, bufferDesc);
 	}
 }
 
@@ -1,18 +1,25 @@
 #pragma once
 
+#include <GraphicsApi_LL/ICommandSignature.hpp>
 #include <GraphicsApi_LL/IPipelineState.hpp>
 #include <GraphicsEngine_LL/BasicCamera.hpp>
 #include <GraphicsEngine_LL/GraphicsNode.hpp>
 
+#include "Voxelization.hpp"
+
 namespace inl::gxeng::nodes {
 
 /// <summary>
 /// Inputs: entities, camera
 /// Voxelizes scene into a dense 3D texture
 /// </summary>
+/// <remarks>
+/// The bricks of the voxel texture that hold a voxel are listed each frame on the GPU,
+/// the mipmap generation and the visualizer are dispatched indirectly over those only.
+/// </remarks>
 class VoxelLighting : virtual public GraphicsNode,
 					  virtual public GraphicsTask,
-					  virtual public InputPortConfig<const BasicCamera*, Texture3D, Texture3D, Texture2D, Texture2D, Texture2D, Texture2D, Texture2D, Texture2D, Texture2D>,
+					  virtual public InputPortConfig<const BasicCamera*, Texture3D, Texture3D, Texture2D, Texture2D, Texture2D, Texture2D, Texture2D, Texture2D, Texture2D, VoxelVolume>,
 					  virtual public OutputPortConfig<Texture2D, Texture2D> {
 public:
 	static const char* Info_GetName() { return "VoxelLighting"; }
@@ -40,6 +47,12 @@ protected:
 	BindParameter m_tex4BindParam;
 	BindParameter m_tex5BindParam;
 	BindParameter m_tex6BindParam;
+	BindParameter m_brickListBindParam;
+	BindParameter m_brickOccupancyBindParam;
+	BindParameter m_brickArgumentsBindParam;
+	BindParameter m_brickListSrvBindParam;
+	BindParameter m_brickOccupancySrvBindParam;
+	ShaderProgram m_brickCompactShader;
 	ShaderProgram m_visualizerShader;
 	ShaderProgram m_finalGatherShader;
 	ShaderProgram m_lightInjectionCSMShader;
@@ -48,6 +61,9 @@ protected:
 	std::unique_ptr<gxapi::IPipelineState> m_finalGatherPSO;
 	std::unique_ptr<gxapi::IPipelineState> m_lightInjectionCSMPSO;
 	std::unique_ptr<gxapi::IPipelineState> m_mipmapCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_brickCompactCSO;
+	std::unique_ptr<gxapi::ICommandSignature> m_mipmapCommandSignature;
+	std::unique_ptr<gxapi::ICommandSignature> m_visualizerCommandSignature;
 
 	bool m_outputTexturesInited = false;
 	TextureView3D m_voxelColorTexSRV;
@@ -57,6 +73,17 @@ protected:
 	TextureView3D m_voxelLightTexSRV;
 	std::vector<TextureView3D> m_voxelLightTexMipSRV;
 
+	// The occupied bricks of the voxel texture, rebuilt each frame, and the indirect arguments
+	// of the passes that only process them.
+	LinearBuffer m_brickListBuffer;
+	LinearBuffer m_brickOccupancyBuffer;
+	LinearBuffer m_brickArgumentsBuffer;
+	RWBufferView m_brickListUAV;
+	RWBufferView m_brickOccupancyUAV;
+	RWBufferView m_brickArgumentsUAV;
+	BufferView m_brickListSRV;
+	BufferView m_brickOccupancySRV;
+
 	TextureView2D m_shadowCSMTexSrv;
 	TextureView2D m_shadowCSMExtentsTexSrv;
 	TextureView2D m_velocityNormalTexSrv;
@@ -69,6 +96,7 @@ protected:
 
 private: // execution context
 	const BasicCamera* m_camera;
+	VoxelVolume m_volume;
 
 	void InitRenderTarget(SetupContext& context);
 };
@@ -9,6 +9,8 @@
 #include <GraphicsEngine_LL/Mesh.hpp>
 #include <GraphicsEngine_LL/MeshEntity.hpp>
 
+#include <algorithm>
+#include <cmath>
 
 
 namespace inl::gxeng::nodes {
@@ -20,6 +22,15 @@ const int voxelDimension = 256; //units
 const float voxelSize = 0.16f; //meters
 const Vec3 voxelOrigin = Vec3(voxelDimension * voxelSize * -0.5);
 const Vec3 voxelCenter = Vec3(0.0f);
+// The window moves in steps of this many voxels. Mip levels with blocks up to this size
+// never mix voxels from the opposite sides of the window.
+const int windowSnap = 16;
+const int brickShift = 4;
+
+static_assert((voxelDimension & (voxelDimension - 1)) == 0, "Toroidal addressing needs a power of two dimension.");
+static_assert(voxelDimension % windowSnap == 0, "The window must stay aligned to the snap.");
+static_assert(Voxelization::BrickSize == 1 << brickShift, "Bricks are found by shifting voxel coordinates.");
+static_assert(windowSnap % Voxelization::BrickSize == 0, "The window must stay aligned to the bricks.");
 
 struct Uniforms {
 	Mat44_Packed model;
@@ -27,6 +38,13 @@ struct Uniforms {
 	float voxelSize;
 	int voxelDimension;
 	int inputMipLevel;
+	int dummy0, dummy1;
+	Vec3i_Packed windowOrigin;
+	int dummy2;
+	Vec3i_Packed regionMin;
+	int dummy3;
+	Vec3i_Packed regionMax;
+	int dummy4;
 };
 
 static void SetWorkgroupSize(unsigned w, unsigned h, unsigned d, unsigned groupSizeW, unsigned groupSizeH, unsigned groupSizeD, unsigned& dispatchW, unsigned& dispatchH, unsigned& dispatchD) {
@@ -57,16 +75,41 @@ static void SetWorkgroupSize(unsigned w, unsigned h, unsigned d, unsigned groupS
 	dispatchD = unsigned(float(gd) / groupSizeD);
 }
 
+// Shifts right rounding towards negative infinity, which is what HLSL does with ints.
+static int FloorShift(int value, int shift) {
+	return value >= 0 ? value >> shift : -((-value + (1 << shift) - 1) >> shift);
+}
+
+static int CeilShift(int value, int shift) {
+	return -FloorShift(-value, shift);
+}
+
+static bool SameTransform(const Mat44& lhs, const Mat44& rhs) {
+	for (int i = 0; i < 4; ++i) {
+		for (int j = 0; j < 4; ++j) {
+			if (lhs(i, j) != rhs(i, j)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static BoundingBox GetWorldBounds(const MeshEntity& entity) {
+	const BoundingBox& localBounds = entity.GetMesh()->GetLocalBounds();
+	return localBounds.IsEmpty() ? BoundingBox{} : localBounds.Transformed(entity.GetTransform());
+}
+
 static bool CheckMeshFormat(const Mesh& mesh) {
 	for (size_t i = 0; i < mesh.GetNumStreams(); i++) {
 		auto& elements = mesh.GetLayout()[0];
 		if (elements.size() != 3)
 			return false;
-		if (elements[0].semantic != eVertexElementSemantic::POSITION)
+		if (elements[0].semantic != eVertexElementSemantic::POSITION || elements[0].format != gxapi::eFormat::R16G16B16A16_UNORM)
 			return false;
-		if (elements[1].semantic != eVertexElementSemantic::NORMAL)
+		if (elements[1].semantic != eVertexElementSemantic::NORMAL || elements[1].format != gxapi::eFormat::R16G16_SNORM)
 			return false;
-		if (elements[2].semantic != eVertexElementSemantic::TEX_COORD)
+		if (elements[2].semantic != eVertexElementSemantic::TEX_COORD || elements[2].format != gxapi::eFormat::R16G16_FLOAT)
 			return false;
 	}
 
@@ -97,6 +140,7 @@ static void ConvertToSubmittable(
 
 Voxelization::Voxelization() {
 	this->GetInput<0>().Set({});
+	this->GetInput<1>().Set({});
 }
 
 
@@ -122,14 +166,15 @@ const std::string& Voxelization::GetInputName(size_t index) const {
 const std::string& Voxelization::GetOutputName(size_t index) const {
 	static const std::vector<std::string> names = {
 		"voxelColorTex",
-		"voxelAlphaNormalTex"
+		"voxelAlphaNormalTex",
+		"volume"
 	};
 	return names[index];
 }
 
 void Voxelization::Setup(SetupContext& context) {
 	m_entities = this->GetInput<0>().Get();
-
+	m_camera = this->GetInput<1>().Get();
 
 	if (!m_binder) {
 		BindParameterDesc uniformsBindParamDesc;
@@ -213,7 +258,8 @@ void Voxelization::Setup(SetupContext& context) {
 		shaderParts.vs = false;
 		shaderParts.ps = false;
 		shaderParts.gs = false;
-		m_mipmapShader = context.CreateShader("VoxelMipmap", shaderParts, "");
+		m_mipmapShader = context.CreateShader("VoxelMipmap", shaderParts, "VOXEL_REGION=1");
+		m_clearShader = context.CreateShader("VoxelClear", shaderParts, "");
 	}
 
 	if (m_voxelizationPSO == nullptr) {
@@ -221,9 +267,9 @@ void Voxelization::Setup(SetupContext& context) {
 
 		{
 			std::vector<gxapi::InputElementDesc> inputElementDesc = {
-				gxapi::InputElementDesc("POSITION", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 0),
-				gxapi::InputElementDesc("NORMAL", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 12),
-				gxapi::InputElementDesc("TEX_COORD", 0, gxapi::eFormat::R32G32_FLOAT, 0, 24),
+				gxapi::InputElementDesc("POSITION", 0, gxapi::eFormat::R16G16B16A16_UNORM, 0, 0),
+				gxapi::InputElementDesc("NORMAL", 0, gxapi::eFormat::R16G16_SNORM, 0, 8),
+				gxapi::InputElementDesc("TEX_COORD", 0, gxapi::eFormat::R16G16_FLOAT, 0, 12),
 			};
 
 			gxapi::GraphicsPipelineStateDesc psoDesc;
@@ -256,10 +302,158 @@ void Voxelization::Setup(SetupContext& context) {
 
 			m_mipmapCSO.reset(context.CreatePSO(csoDesc));
 		}
+
+		{ //slab clear shader
+			gxapi::ComputePipelineStateDesc csoDesc;
+			csoDesc.rootSignature = m_binder.GetRootSignature();
+			csoDesc.cs = m_clearShader.cs;
+
+			m_clearCSO.reset(context.CreatePSO(csoDesc));
+		}
 	}
 
+	bool wholeWindowDirty = UpdateWindow();
+	FindChangedGeometry(wholeWindowDirty);
+
 	this->GetOutput<0>().Set(m_voxelColorTexUAV[0].GetResource());
 	this->GetOutput<1>().Set(m_voxelAlphaNormalTexUAV[0].GetResource());
+	this->GetOutput<2>().Set(m_volume);
+}
+
+
+bool Voxelization::UpdateWindow() {
+	// The window is centered on the camera, snapped so small movements do not touch it.
+	Vec3 center = m_camera ? m_camera->GetPosition() : voxelCenter;
+	Vec3i origin;
+	for (int axis = 0; axis < 3; ++axis) {
+		int snapped = (int)std::floor(center[axis] / (voxelSize * windowSnap)) * windowSnap;
+		origin[axis] = snapped - voxelDimension / 2;
+	}
+
+	Vec3i previousOrigin = m_volume.origin;
+	m_volume.origin = origin;
+	m_volume.voxelSize = voxelSize;
+	m_volume.dimension = voxelDimension;
+
+	m_dirtyRegions.clear();
+	Vec3i windowMax = origin + Vec3i(voxelDimension);
+
+	bool farMove = false;
+	for (int axis = 0; axis < 3; ++axis) {
+		farMove = farMove || std::abs(origin[axis] - previousOrigin[axis]) >= voxelDimension;
+	}
+	if (!m_voxelized || farMove) {
+		m_dirtyRegions.push_back({ origin, windowMax });
+		return true;
+	}
+
+	// One slab per axis the window moved along, spanning the new window on the other two axes.
+	// Slabs overlap at the edges, those voxels are simply voxelized twice.
+	for (int axis = 0; axis < 3; ++axis) {
+		int delta = origin[axis] - previousOrigin[axis];
+		if (delta == 0) {
+			continue;
+		}
+		Vec3i regionMin = origin;
+		Vec3i regionMax = windowMax;
+		if (delta > 0) {
+			regionMin[axis] = previousOrigin[axis] + voxelDimension;
+		}
+		else {
+			regionMax[axis] = previousOrigin[axis];
+		}
+		m_dirtyRegions.push_back({ regionMin, regionMax });
+	}
+	return false;
+}
+
+
+void Voxelization::FindChangedGeometry(bool wholeWindowDirty) {
+	m_drawList.clear();
+	if (!m_entities) {
+		return;
+	}
+
+	++m_generation;
+	std::vector<BoundingBox> dynamicBounds;
+
+	// Change boxes are still tracked when the whole window is dirty, so the next frame compares to this one.
+	auto addDirtyBox = [this, wholeWindowDirty](const BoundingBox& bounds) {
+		if (!wholeWindowDirty) {
+			AddDirtyBox(bounds);
+		}
+	};
+
+	for (const MeshEntity* entity : *m_entities) {
+		const Mesh* mesh = entity->GetMesh();
+		if (!mesh) {
+			continue;
+		}
+		BoundingBox bounds = GetWorldBounds(*entity);
+		m_drawList.push_back({ entity, bounds });
+
+		if (entity->IsDynamic()) {
+			addDirtyBox(bounds);
+			dynamicBounds.push_back(bounds);
+			continue;
+		}
+
+		auto [it, inserted] = m_staticEntities.insert({ entity, StaticEntry{} });
+		StaticEntry& entry = it->second;
+		Mat44 transform = entity->GetTransform();
+		if (inserted || entry.mesh != mesh || !SameTransform(entry.transform, transform)) {
+			if (!inserted) {
+				addDirtyBox(entry.bounds);
+			}
+			addDirtyBox(bounds);
+			entry.mesh = mesh;
+			entry.transform = transform;
+			entry.bounds = bounds;
+		}
+		entry.generation = m_generation;
+	}
+
+	// Removed entities, and those that became dynamic, leave their old bricks behind.
+	for (auto it = m_staticEntities.begin(); it != m_staticEntities.end();) {
+		if (it->second.generation != m_generation) {
+			addDirtyBox(it->second.bounds);
+			it = m_staticEntities.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+
+	// Dynamic entities are cleared from where they were last frame.
+	for (const BoundingBox& bounds : m_dynamicBounds) {
+		addDirtyBox(bounds);
+	}
+	m_dynamicBounds = std::move(dynamicBounds);
+}
+
+
+void Voxelization::AddDirtyBox(const BoundingBox& bounds) {
+	Vec3i windowMin = m_volume.origin;
+	Vec3i windowMax = m_volume.origin + Vec3i(voxelDimension);
+
+	// Without bounds the entity may be anywhere.
+	if (bounds.IsEmpty()) {
+		m_dirtyRegions.push_back({ windowMin, windowMax });
+		return;
+	}
+
+	// Conservative rasterization may write a voxel beyond the bounds.
+	Vec3i regionMin, regionMax;
+	for (int axis = 0; axis < 3; ++axis) {
+		int lower = (int)std::floor(bounds.lower[axis] / voxelSize) - 1;
+		int upper = (int)std::ceil(bounds.upper[axis] / voxelSize) + 1;
+		regionMin[axis] = std::max(FloorShift(lower, brickShift) * BrickSize, windowMin[axis]);
+		regionMax[axis] = std::min(CeilShift(upper, brickShift) * BrickSize, windowMax[axis]);
+		if (regionMin[axis] >= regionMax[axis]) {
+			return;
+		}
+	}
+	m_dirtyRegions.push_back({ regionMin, regionMax });
 }
 
 
@@ -273,13 +467,56 @@ void Voxelization::Execute(RenderContext& context) {
 		return;
 	}
 
+	if (m_dirtyRegions.empty()) {
+		return;
+	}
+
+	auto& commandList = context.AsGraphics();
+
+	for (const auto& region : m_dirtyRegions) {
+		VoxelizeRegion(commandList, region.first, region.second);
+	}
+
+	for (const auto& region : m_dirtyRegions) {
+		GenerateMips(commandList, region.first, region.second);
+	}
+
+	m_voxelized = true;
+}
+
+
+void Voxelization::VoxelizeRegion(GraphicsCommandList& commandList, const Vec3i& regionMin, const Vec3i& regionMax) {
 	Uniforms uniformsCBData;
 
 	uniformsCBData.voxelDimension = voxelDimension;
-	uniformsCBData.voxelCenter = voxelCenter;
+	uniformsCBData.voxelCenter = m_volume.GetCenter();
 	uniformsCBData.voxelSize = voxelSize;
-
-	auto& commandList = context.AsGraphics();
+	uniformsCBData.inputMipLevel = 0;
+	uniformsCBData.windowOrigin = m_volume.origin;
+	uniformsCBData.regionMin = regionMin;
+	uniformsCBData.regionMax = regionMax;
+
+	commandList.SetResourceState(m_voxelColorTexUAV[0].GetResource(), gxapi::eResourceState::UNORDERED_ACCESS, m_voxelColorTexSRV.GetResource().GetSubresourceIndex(0, 0));
+	commandList.SetResourceState(m_voxelAlphaNormalTexUAV[0].GetResource(), gxapi::eResourceState::UNORDERED_ACCESS, m_voxelAlphaNormalTexSRV.GetResource().GetSubresourceIndex(0, 0));
+
+	{ //clear the voxels the region covered in the previous window
+		Vec3i extent = regionMax - regionMin;
+		unsigned dispatchW, dispatchH, dispatchD;
+		SetWorkgroupSize(extent.x, extent.y, extent.z, 8, 8, 8, dispatchW, dispatchH, dispatchD);
+
+		commandList.SetPipelineState(m_clearCSO.get());
+		//NOTE: must set compute binder before bind* calls
+		commandList.SetComputeBinder(&m_binder);
+		commandList.BindCompute(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
+
+		commandList.BindCompute(m_voxelColorTexBindParam, m_voxelColorTexUAV[0]);
+		commandList.Dispatch(dispatchW, dispatchH, dispatchD);
+		commandList.BindCompute(m_voxelColorTexBindParam, m_voxelAlphaNormalTexUAV[0]);
+		commandList.Dispatch(dispatchW, dispatchH, dispatchD);
+
+		commandList.UAVBarrier(m_voxelColorTexUAV[0].GetResource());
+		commandList.UAVBarrier(m_voxelAlphaNormalTexUAV[0].GetResource());
+	}
 
 	gxapi::Rectangle rect{ 0, (int)m_voxelColorTexUAV[0].GetResource().GetHeight(), 0, (int)m_voxelColorTexUAV[0].GetResource().GetWidth() };
 	gxapi::Viewport viewport;
@@ -300,98 +537,114 @@ void Voxelization::Execute(RenderContext& context) {
 	std::vector<unsigned> sizes;
 	std::vector<unsigned> strides;
 
-	commandList.SetResourceState(m_voxelColorTexUAV[0].GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
-	commandList.SetResourceState(m_voxelAlphaNormalTexUAV[0].GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
 	commandList.BindGraphics(m_voxelColorTexBindParam, m_voxelColorTexUAV[0]);
 	commandList.BindGraphics(m_voxelAlphaNormalTexBindParam, m_voxelAlphaNormalTexUAV[0]);
 
-	static bool sceneVoxelized = false;
+	BoundingBox regionBounds{
+		Vec3(float(regionMin.x), float(regionMin.y), float(regionMin.z)) * voxelSize,
+		Vec3(float(regionMax.x), float(regionMax.y), float(regionMax.z)) * voxelSize
+	};
 
-	if (!sceneVoxelized) {
-		{ // scene voxelization
-			for (const MeshEntity* entity : *m_entities) {
-				// Get entity parameters
-				Mesh* mesh = entity->GetMesh();
-				Material* material = entity->GetMaterial();
-				auto position = entity->GetPosition();
+	{ // scene voxelization, the pixel shader drops the fragments outside the region
+		for (const auto& [entity, bounds] : m_drawList) {
+			if (!bounds.IsEmpty() && !bounds.Intersects(regionBounds)) {
+				continue;
+			}
 
-				if (mesh->GetIndexBuffer().GetIndexCount() == 3600) {
-					continue; //skip quadcopter for visualization purposes (obscures camera...)
-				}
+			// Get entity parameters
+			Mesh* mesh = entity->GetMesh();
+			Material* material = entity->GetMaterial();
 
-				// Draw mesh
-				if (!CheckMeshFormat(*mesh)) {
-					assert(false);
-					continue;
-				}
+			if (mesh->GetLod(0).indexCount == 3600) {
+				continue; //skip quadcopter for visualization purposes (obscures camera...)
+			}
 
-				ConvertToSubmittable(mesh, vertexBuffers, sizes, strides);
+			// Draw mesh
+			if (!CheckMeshFormat(*mesh)) {
+				assert(false);
+				continue;
+			}
 
-				uniformsCBData.model = entity->GetTransform();
+			ConvertToSubmittable(mesh, vertexBuffers, sizes, strides);
 
-				commandList.BindGraphics(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
+			uniformsCBData.model = mesh->GetPositionDequantization() * entity->GetTransform();
 
-				for (size_t paramIdx = 0; paramIdx < material->GetParameterCount(); ++paramIdx) {
-					const Material::Parameter& param = (*material)[paramIdx];
-					if (param.GetType() == eMaterialShaderParamType::BITMAP_COLOR_2D || param.GetType() == eMaterialShaderParamType::BITMAP_VALUE_2D) {
-						commandList.SetResourceState(((Image*)param)->GetSrv().GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
-						commandList.BindGraphics(m_albedoTexBindParam, ((Image*)param)->GetSrv());
-						break;
-					}
-				}
+			commandList.BindGraphics(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
 
-				for (auto& vb : vertexBuffers) {
-					commandList.SetResourceState(*vb, gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
+			for (size_t paramIdx = 0; paramIdx < material->GetParameterCount(); ++paramIdx) {
+				const Material::Parameter& param = (*material)[paramIdx];
+				if (param.GetType() == eMaterialShaderParamType::BITMAP_COLOR_2D || param.GetType() == eMaterialShaderParamType::BITMAP_VALUE_2D) {
+					commandList.SetResourceState(((Image*)param)->GetSrv().GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+					commandList.BindGraphics(m_albedoTexBindParam, ((Image*)param)->GetSrv());
+					break;
 				}
+			}
 
-				commandList.SetResourceState(mesh->GetIndexBuffer(), gxapi::eResourceState::INDEX_BUFFER);
-				commandList.SetVertexBuffers(0, (unsigned)vertexBuffers.size(), vertexBuffers.data(), sizes.data(), strides.data());
-				commandList.SetIndexBuffer(&mesh->GetIndexBuffer(), mesh->IsIndexBuffer32Bit());
-				commandList.DrawIndexedInstanced((unsigned)mesh->GetIndexBuffer().GetIndexCount());
+			for (auto& vb : vertexBuffers) {
+				commandList.SetResourceState(*vb, gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
 			}
 
-			commandList.UAVBarrier(m_voxelColorTexUAV[0].GetResource());
-			commandList.UAVBarrier(m_voxelAlphaNormalTexUAV[0].GetResource());
+			commandList.SetResourceState(mesh->GetIndexBuffer(), gxapi::eResourceState::INDEX_BUFFER);
+			commandList.SetVertexBuffers(0, (unsigned)vertexBuffers.size(), vertexBuffers.data(), sizes.data(), strides.data());
+			commandList.SetIndexBuffer(&mesh->GetIndexBuffer(), mesh->IsIndexBuffer32Bit());
+			commandList.DrawIndexedInstanced(mesh->GetLod(0).indexCount, mesh->GetLod(0).firstIndex);
 		}
 
-		{ //scene mipmap gen
-			int numMips = m_voxelColorTexSRV.GetResource().GetNumMiplevels();
-			int currDim = voxelDimension / 2;
-			for (int c = 1; c < numMips; ++c) {
-				unsigned dispatchW, dispatchH, dispatchD;
-				SetWorkgroupSize(currDim, currDim, currDim, 8, 8, 8, dispatchW, dispatchH, dispatchD);
+		commandList.UAVBarrier(m_voxelColorTexUAV[0].GetResource());
+		commandList.UAVBarrier(m_voxelAlphaNormalTexUAV[0].GetResource());
+	}
+}
+
+
+void Voxelization::GenerateMips(GraphicsCommandList& commandList, const Vec3i& regionMin, const Vec3i& regionMax) {
+	Uniforms uniformsCBData;
+
+	uniformsCBData.voxelDimension = voxelDimension;
+	uniformsCBData.voxelCenter = m_volume.GetCenter();
+	uniformsCBData.voxelSize = voxelSize;
+	uniformsCBData.windowOrigin = m_volume.origin;
+	uniformsCBData.regionMin = regionMin;
+	uniformsCBData.regionMax = regionMax;
+
+	int numMips = m_voxelColorTexSRV.GetResource().GetNumMiplevels();
+	int currDim = voxelDimension / 2;
+	for (int c = 1; c < numMips; ++c) {
+		// Voxels of this level over the region, widened to whole voxels of the level.
+		Vec3i extent;
+		for (int axis = 0; axis < 3; ++axis) {
+			extent[axis] = std::min(CeilShift(regionMax[axis], c) - FloorShift(regionMin[axis], c), currDim);
+		}
 
-				commandList.SetPipelineState(m_mipmapCSO.get());
-				//NOTE: must set compute binder before bind* calls
-				commandList.SetComputeBinder(&m_binder);
+		unsigned dispatchW, dispatchH, dispatchD;
+		SetWorkgroupSize(extent.x, extent.y, extent.z, 8, 8, 8, dispatchW, dispatchH, dispatchD);
 
-				uniformsCBData.inputMipLevel = c - 1;
+		commandList.SetPipelineState(m_mipmapCSO.get());
+		//NOTE: must set compute binder before bind* calls
+		commandList.SetComputeBinder(&m_binder);
 
-				commandList.BindCompute(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
+		uniformsCBData.inputMipLevel = c - 1;
 
-				//gen mipmap for primary voxel tex
-				commandList.SetResourceState(m_voxelColorTexUAV[c].GetResource(), gxapi::eResourceState::UNORDERED_ACCESS, m_voxelColorTexSRV.GetResource().GetSubresourceIndex(c, 0));
-				commandList.SetResourceState(m_voxelColorTexMipSRV[c - 1].GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE }, m_voxelColorTexSRV.GetResource().GetSubresourceIndex(c - 1, 0));
+		commandList.BindCompute(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
 
-				commandList.BindCompute(m_voxelColorTexBindParam, m_voxelColorTexUAV[c]);
-				commandList.BindCompute(m_albedoTexBindParam, m_voxelColorTexMipSRV[c - 1]);
-				commandList.Dispatch(dispatchW, dispatchH, dispatchD);
-				commandList.UAVBarrier(m_voxelColorTexUAV[c].GetResource());
+		//gen mipmap for primary voxel tex
+		commandList.SetResourceState(m_voxelColorTexUAV[c].GetResource(), gxapi::eResourceState::UNORDERED_ACCESS, m_voxelColorTexSRV.GetResource().GetSubresourceIndex(c, 0));
+		commandList.SetResourceState(m_voxelColorTexMipSRV[c - 1].GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE }, m_voxelColorTexSRV.GetResource().GetSubresourceIndex(c - 1, 0));
 
-				//gen mipmap for secondary voxel tex
-				commandList.SetResourceState(m_voxelAlphaNormalTexUAV[c].GetResource(), gxapi::eResourceState::UNORDERED_ACCESS, m_voxelAlphaNormalTexSRV.GetResource().GetSubresourceIndex(c, 0));
-				commandList.SetResourceState(m_voxelAlphaNormalTexMipSRV[c - 1].GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE }, m_voxelAlphaNormalTexSRV.GetResource().GetSubresourceIndex(c - 1, 0));
+		commandList.BindCompute(m_voxelColorTexBindParam, m_voxelColorTexUAV[c]);
+		commandList.BindCompute(m_albedoTexBindParam, m_voxelColorTexMipSRV[c - 1]);
+		commandList.Dispatch(dispatchW, dispatchH, dispatchD);
+		commandList.UAVBarrier(m_voxelColorTexUAV[c].GetResource());
 
-				commandList.BindCompute(m_voxelColorTexBindParam, m_voxelAlphaNormalTexUAV[c]);
-				commandList.BindCompute(m_albedoTexBindParam, m_voxelAlphaNormalTexMipSRV[c - 1]);
-				commandList.Dispatch(dispatchW, dispatchH, dispatchD);
-				commandList.UAVBarrier(m_voxelAlphaNormalTexUAV[c].GetResource());
+		//gen mipmap for secondary voxel tex
+		commandList.SetResourceState(m_voxelAlphaNormalTexUAV[c].GetResource(), gxapi::eResourceState::UNORDERED_ACCESS, m_voxelAlphaNormalTexSRV.GetResource().GetSubresourceIndex(c, 0));
+		commandList.SetResourceState(m_voxelAlphaNormalTexMipSRV[c - 1].GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE }, m_voxelAlphaNormalTexSRV.GetResource().GetSubresourceIndex(c - 1, 0));
 
-				currDim = currDim / 2;
-			}
-		}
+		commandList.BindCompute(m_voxelColorTexBindParam, m_voxelAlphaNormalTexUAV[c]);
+		commandList.BindCompute(m_albedoTexBindParam, m_voxelAlphaNormalTexMipSRV[c - 1]);
+		commandList.Dispatch(dispatchW, dispatchH, dispatchD);
+		commandList.UAVBarrier(m_voxelAlphaNormalTexUAV[c].GetResource());
 
-		sceneVoxelized = true;
+		currDim = currDim / 2;
 	}
 }
 
@@ -1,20 +1,53 @@
 #pragma once
 
 #include <GraphicsApi_LL/IPipelineState.hpp>
+#include <GraphicsEngine_LL/BasicCamera.hpp>
+#include <GraphicsEngine_LL/BoundingVolumes.hpp>
 #include <GraphicsEngine_LL/GraphicsNode.hpp>
+#include <GraphicsEngine_LL/Mesh.hpp>
+
+#include <unordered_map>
+#include <vector>
 
 
 namespace inl::gxeng::nodes {
 
+
+/// <summary> The part of the world the voxel textures of <see cref="Voxelization"/> cover. </summary>
+/// <remarks>
+/// The textures are addressed toroidally: the voxel at integer world voxel coordinates v is stored at v mod dimension.
+/// When the window moves, the voxels it still covers stay where they are, and only the newly covered slabs are written.
+/// The texture coordinates of a world position p are frac(p / (dimension * voxelSize)), sampled with wrapping.
+/// </remarks>
+struct VoxelVolume {
+	Vec3i origin = Vec3i(0); // World voxel coordinates of the lowest corner of the window.
+	float voxelSize = 0.0f;
+	int dimension = 0;
+
+	Vec3 GetCenter() const {
+		return (Vec3(float(origin.x), float(origin.y), float(origin.z)) + Vec3(dimension * 0.5f)) * voxelSize;
+	}
+};
+
+
 /// <summary>
 /// Inputs: entities, camera
 /// Voxelizes scene into a dense 3D texture
 /// </summary>
+/// <remarks>
+/// The textures cover a window that follows the camera, see <see cref="VoxelVolume"/>.
+/// The whole window is voxelized once, after that only the slabs the window moved onto,
+/// and the bricks of <see cref="BrickSize"/> voxels around entities that changed.
+/// Static entities are compared against their state when last voxelized, dynamic ones
+/// (see <see cref="MeshEntity::SetDynamic"/>) dirty their bricks of this and the previous frame.
+/// </remarks>
 class Voxelization : virtual public GraphicsNode,
 					 virtual public GraphicsTask,
-					 virtual public InputPortConfig<const EntityCollection<MeshEntity>*>,
-					 virtual public OutputPortConfig<Texture3D, Texture3D> {
+					 virtual public InputPortConfig<const EntityCollection<MeshEntity>*, const BasicCamera*>,
+					 virtual public OutputPortConfig<Texture3D, Texture3D, VoxelVolume> {
 public:
+	static constexpr int BrickSize = 16;
+
 	static const char* Info_GetName() { return "Voxelization"; }
 	const std::string& GetInputName(size_t index) const override;
 	const std::string& GetOutputName(size_t index) const override;
@@ -37,7 +70,9 @@ protected:
 	ShaderProgram m_voxelizationShader;
 	ShaderProgram m_mipmapShader;
 	std::unique_ptr<gxapi::IPipelineState> m_voxelizationPSO;
+	ShaderProgram m_clearShader;
 	std::unique_ptr<gxapi::IPipelineState> m_mipmapCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_clearCSO;
 
 	bool m_outputTexturesInited = false;
 	std::vector<RWTextureView3D> m_voxelColorTexUAV;
@@ -47,10 +82,34 @@ protected:
 	TextureView3D m_voxelAlphaNormalTexSRV;
 	std::vector<TextureView3D> m_voxelAlphaNormalTexMipSRV;
 
+	VoxelVolume m_volume;
+	bool m_voxelized = false;
+
+	struct StaticEntry {
+		const Mesh* mesh;
+		Mat44 transform;
+		BoundingBox bounds;
+		uint64_t generation; // Last frame that found the entity in the collection.
+	};
+	std::unordered_map<const MeshEntity*, StaticEntry> m_staticEntities; // As they were last voxelized.
+	std::vector<BoundingBox> m_dynamicBounds; // Dynamic entities voxelized in the previous frame.
+	uint64_t m_generation = 0;
+
 private: // execution context
 	const EntityCollection<MeshEntity>* m_entities;
+	const BasicCamera* m_camera;
+
+	// Boxes of world voxel coordinates to voxelize again, min inclusive, max exclusive.
+	std::vector<std::pair<Vec3i, Vec3i>> m_dirtyRegions;
+	// Entities with a mesh and their world bounds, empty if the mesh has none.
+	std::vector<std::pair<const MeshEntity*, BoundingBox>> m_drawList;
 
 	void InitRenderTarget(SetupContext& context);
+	bool UpdateWindow();
+	void FindChangedGeometry(bool wholeWindowDirty);
+	void AddDirtyBox(const BoundingBox& bounds);
+	void VoxelizeRegion(GraphicsCommandList& commandList, const Vec3i& regionMin, const Vec3i& regionMax);
+	void GenerateMips(GraphicsCommandList& commandList, const Vec3i& regionMin, const Vec3i& regionMax);
 };
 
 
@@ -0,0 +1,301 @@
+#include "RenderParticles.hpp"
+
+#include <GraphicsEngine_LL/Nodes/NodeUtility.hpp>
+
+#include <GraphicsEngine_LL/AutoRegisterNode.hpp>
+#include <GraphicsEngine_LL/GraphicsCommandList.hpp>
+
+
+namespace inl::gxeng::nodes {
+
+
+INL_REGISTER_GRAPHICS_NODE(RenderParticles)
+
+
+namespace {
+
+// Layout must match Particles.hlsl.
+struct Uniforms {
+	Mat44_Packed view;
+	Mat44_Packed projection;
+	Mat44_Packed invProjection;
+	Vec4_Packed targetSize; // Width, height and their reciprocals.
+	Vec3_Packed sunColor; // Zero without a sun.
+	float ambientIntensity;
+	Vec2_Packed depthScale; // From target pixels to depth texture pixels.
+	float clusterDepthScale, clusterDepthBias; // See LightClusters.
+	uint32_t clusterCountX, clusterCountY, clusterCountZ, clusterTileSize;
+};
+
+} // namespace
+
+static constexpr float AmbientIntensity = 0.1f; // Of the sky color, the particles get no indirect light otherwise.
+
+
+RenderParticles::RenderParticles() {
+	this->GetInput<0>().Set({});
+	this->GetInput<1>().Set({});
+}
+
+
+void RenderParticles::Initialize(EngineContext& context) {
+	GraphicsNode::SetTaskSingle(this);
+}
+
+
+void RenderParticles::Reset() {
+	m_targetRtv = {};
+	m_depthTexSrv = {};
+	m_camera = nullptr;
+	m_directionalLights = nullptr;
+	m_particles = {};
+	m_lightClusters = {};
+
+	GetInput<0>().Clear();
+	GetInput<1>().Clear();
+	GetInput<2>().Clear();
+	GetInput<3>().Clear();
+	GetInput<4>().Clear();
+	GetInput<5>().Clear();
+}
+
+
+const std::string& RenderParticles::GetInputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"target",
+		"depthTex",
+		"camera",
+		"particles",
+		"lightClusters",
+		"directionalLights",
+	};
+	return names[index];
+}
+
+
+const std::string& RenderParticles::GetOutputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"target"
+	};
+	return names[index];
+}
+
+
+void RenderParticles::Setup(SetupContext& context) {
+	Texture2D target = this->GetInput<0>().Get();
+	Texture2D depthTex = this->GetInput<1>().Get();
+	m_camera = this->GetInput<2>().Get();
+	m_particles = this->GetInput<3>().Get();
+	m_lightClusters = this->GetInput<4>().Get();
+	m_directionalLights = this->GetInput<5>().Get();
+	if (!target) {
+		throw InvalidArgumentException("Render target cannot be null.");
+	}
+	if (!m_camera) {
+		throw InvalidArgumentException("Particles cannot be drawn without a valid camera.");
+	}
+	if (!m_particles.particles) {
+		throw InvalidArgumentException("Particles must come from a particle simulation.");
+	}
+	if (!m_lightClusters.clusters) {
+		throw InvalidArgumentException("Particles are lit by light clusters, link the light culling.");
+	}
+
+	gxapi::RtvTexture2DArray rtvDesc;
+	rtvDesc.activeArraySize = 1;
+	rtvDesc.firstArrayElement = 0;
+	rtvDesc.firstMipLevel = 0;
+	rtvDesc.planeIndex = 0;
+	m_targetRtv = context.CreateRtv(target, target.GetFormat(), rtvDesc);
+
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.numMipLevels = 1;
+	srvDesc.planeIndex = 0;
+	m_depthTexSrv = context.CreateSrv(depthTex, FormatDepthToColor(depthTex.GetFormat()), srvDesc);
+
+	gxapi::SrvBuffer bufferDesc;
+	bufferDesc.firstElement = 0;
+	bufferDesc.isRaw = false;
+	bufferDesc.numElements = m_particles.capacity;
+	bufferDesc.structureStrideInBytes = sizeof(SimulateParticles::ParticleData);
+	m_particlesView = context.CreateSrv(m_particles.particles, gxapi::eFormat::UNKNOWN, bufferDesc);
+	bufferDesc.structureStrideInBytes = 2 * sizeof(uint32_t);
+	m_drawListView = context.CreateSrv(m_particles.drawList, gxapi::eFormat::UNKNOWN, bufferDesc);
+
+	bufferDesc.numElements = m_lightClusters.GetClusterCount();
+	bufferDesc.structureStrideInBytes = 2 * sizeof(uint32_t);
+	m_lightClustersView = context.CreateSrv(m_lightClusters.clusters, gxapi::eFormat::UNKNOWN, bufferDesc);
+	bufferDesc.numElements = m_lightClusters.indexCapacity;
+	bufferDesc.structureStrideInBytes = sizeof(uint32_t);
+	m_lightIndicesView = context.CreateSrv(m_lightClusters.lightIndices, gxapi::eFormat::UNKNOWN, bufferDesc);
+	bufferDesc.numElements = m_lightClusters.lightCapacity;
+	bufferDesc.structureStrideInBytes = sizeof(ClusteredLightCulling::LightData);
+	m_lightsView = context.CreateSrv(m_lightClusters.lights, gxapi::eFormat::UNKNOWN, bufferDesc);
+
+	if (!m_binder) {
+		BindParameterDesc uniformsBindParamDesc;
+		m_uniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
+		uniformsBindParamDesc.parameter = m_uniformsBindParam;
+		uniformsBindParamDesc.constantSize = sizeof(Uniforms);
+		uniformsBindParamDesc.relativeAccessFrequency = 0;
+		uniformsBindParamDesc.relativeChangeFrequency = 0;
+		uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc particlesBindParamDesc;
+		m_particlesBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		particlesBindParamDesc.parameter = m_particlesBindParam;
+		particlesBindParamDesc.constantSize = 0;
+		particlesBindParamDesc.relativeAccessFrequency = 0;
+		particlesBindParamDesc.relativeChangeFrequency = 0;
+		particlesBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc drawListBindParamDesc = particlesBindParamDesc;
+		m_drawListBindParam = BindParameter(eBindParameterType::TEXTURE, 1);
+		drawListBindParamDesc.parameter = m_drawListBindParam;
+
+		BindParameterDesc depthBindParamDesc = particlesBindParamDesc;
+		m_depthBindParam = BindParameter(eBindParameterType::TEXTURE, 2);
+		depthBindParamDesc.parameter = m_depthBindParam;
+
+		BindParameterDesc lightClustersBindParamDesc = particlesBindParamDesc;
+		m_lightClustersBindParam = BindParameter(eBindParameterType::TEXTURE, 3);
+		lightClustersBindParamDesc.parameter = m_lightClustersBindParam;
+
+		BindParameterDesc lightsBindParamDesc = particlesBindParamDesc;
+		m_lightsBindParam = BindParameter(eBindParameterType::TEXTURE, 4);
+		lightsBindParamDesc.parameter = m_lightsBindParam;
+
+		BindParameterDesc lightIndicesBindParamDesc = particlesBindParamDesc;
+		m_lightIndicesBindParam = BindParameter(eBindParameterType::TEXTURE, 5);
+		lightIndicesBindParamDesc.parameter = m_lightIndicesBindParam;
+
+		m_binder = context.CreateBinder({ uniformsBindParamDesc,
+										  particlesBindParamDesc,
+										  drawListBindParamDesc,
+										  depthBindParamDesc,
+										  lightClustersBindParamDesc,
+										  lightsBindParamDesc,
+										  lightIndicesBindParamDesc });
+	}
+
+	if (!m_shader.vs || !m_shader.ps) {
+		ShaderParts shaderParts;
+		shaderParts.vs = true;
+		shaderParts.ps = true;
+
+		m_shader = context.CreateShader("Particles", shaderParts, "");
+	}
+
+	if (m_colorFormat != target.GetFormat()) {
+		m_colorFormat = target.GetFormat();
+
+		gxapi::GraphicsPipelineStateDesc psoDesc;
+		psoDesc.inputLayout.elements = nullptr;
+		psoDesc.inputLayout.numElements = 0;
+		psoDesc.rootSignature = m_binder.GetRootSignature();
+		psoDesc.vs = m_shader.vs;
+		psoDesc.ps = m_shader.ps;
+		psoDesc.rasterization = gxapi::RasterizerState(gxapi::eFillMode::SOLID, gxapi::eCullMode::DRAW_ALL);
+		psoDesc.primitiveTopologyType = gxapi::ePrimitiveTopologyType::TRIANGLE;
+		psoDesc.depthStencilState = gxapi::DepthStencilState(false, false);
+
+		// Premultiplied alpha, the shader zeroes the alpha of additive particles.
+		gxapi::RenderTargetBlendState blending;
+		blending.enableBlending = true;
+		blending.alphaOperation = gxapi::eBlendOperation::ADD;
+		blending.shaderAlphaFactor = gxapi::eBlendOperand::ONE;
+		blending.targetAlphaFactor = gxapi::eBlendOperand::INV_SHADER_ALPHA;
+		blending.colorOperation = gxapi::eBlendOperation::ADD;
+		blending.shaderColorFactor = gxapi::eBlendOperand::ONE;
+		blending.targetColorFactor = gxapi::eBlendOperand::INV_SHADER_ALPHA;
+		blending.enableLogicOp = false;
+		blending.mask = gxapi::eColorMask::ALL;
+		psoDesc.blending.singleTarget = blending;
+
+		psoDesc.numRenderTargets = 1;
+		psoDesc.renderTargetFormats[0] = m_colorFormat;
+
+		m_PSO.reset(context.CreatePSO(psoDesc));
+	}
+
+	if (m_drawCommandSignature == nullptr) {
+		gxapi::CommandSignatureDesc signatureDesc;
+		signatureDesc.byteStride = sizeof(gxapi::DrawArguments);
+		signatureDesc.arguments = { gxapi::IndirectArgumentDesc::Draw() };
+		m_drawCommandSignature.reset(context.CreateCommandSignature(signatureDesc));
+	}
+
+	this->GetOutput<0>().Set(target);
+}
+
+
+void RenderParticles::Execute(RenderContext& context) {
+	GraphicsCommandList& commandList = context.AsGraphics();
+
+	const Texture2D& target = m_targetRtv.GetResource();
+	const Texture2D& depthTex = m_depthTexSrv.GetResource();
+	const Mat44 projection = m_camera->GetProjectionMatrix();
+
+	Uniforms uniforms;
+	uniforms.view = m_camera->GetViewMatrix();
+	uniforms.projection = projection;
+	uniforms.invProjection = projection.Inverse();
+	uniforms.targetSize = Vec4((float)target.GetWidth(), (float)target.GetHeight(), 1.0f / target.GetWidth(), 1.0f / target.GetHeight());
+	uniforms.sunColor = Vec3(0.0f, 0.0f, 0.0f);
+	if (m_directionalLights && m_directionalLights->Size() > 0) {
+		uniforms.sunColor = (*m_directionalLights->begin())->GetColor();
+	}
+	uniforms.ambientIntensity = AmbientIntensity;
+	uniforms.depthScale = Vec2((float)depthTex.GetWidth() / target.GetWidth(), (float)depthTex.GetHeight() / target.GetHeight());
+	uniforms.clusterDepthScale = m_lightClusters.depthScale;
+	uniforms.clusterDepthBias = m_lightClusters.depthBias;
+	uniforms.clusterCountX = m_lightClusters.countX;
+	uniforms.clusterCountY = m_lightClusters.countY;
+	uniforms.clusterCountZ = m_lightClusters.countZ;
+	uniforms.clusterTileSize = m_lightClusters.tileSize;
+
+	gxapi::Rectangle rect{ 0, (int)target.GetHeight(), 0, (int)target.GetWidth() };
+	gxapi::Viewport viewport;
+	viewport.width = (float)rect.right;
+	viewport.height = (float)rect.bottom;
+	viewport.topLeftX = 0;
+	viewport.topLeftY = 0;
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	commandList.SetScissorRects(1, &rect);
+	commandList.SetViewports(1, &viewport);
+
+	commandList.SetResourceState(target, gxapi::eResourceState::RENDER_TARGET);
+	commandList.SetResourceState(depthTex, gxapi::eResourceState::PIXEL_SHADER_RESOURCE);
+	commandList.SetResourceState(m_particles.particles, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
+	commandList.SetResourceState(m_particles.drawList, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
+	commandList.SetResourceState(m_particles.arguments, gxapi::eResourceState::INDIRECT_ARGUMENT);
+	commandList.SetResourceState(m_lightClusters.clusters, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
+	commandList.SetResourceState(m_lightClusters.lights, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
+	commandList.SetResourceState(m_lightClusters.lightIndices, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
+
+	RenderTargetView2D* pRTV = &m_targetRtv;
+	commandList.SetRenderTargets(1, &pRTV, nullptr);
+
+	commandList.SetPipelineState(m_PSO.get());
+	commandList.SetGraphicsBinder(&m_binder);
+	commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLESTRIP);
+
+	commandList.BindGraphics(m_uniformsBindParam, &uniforms, sizeof(uniforms));
+	commandList.BindGraphics(m_particlesBindParam, m_particlesView);
+	commandList.BindGraphics(m_drawListBindParam, m_drawListView);
+	commandList.BindGraphics(m_depthBindParam, m_depthTexSrv);
+	commandList.BindGraphics(m_lightClustersBindParam, m_lightClustersView);
+	commandList.BindGraphics(m_lightsBindParam, m_lightsView);
+	commandList.BindGraphics(m_lightIndicesBindParam, m_lightIndicesView);
+
+	// An instance of a strip quad for each live particle, counted on the GPU.
+	commandList.ExecuteIndirect(m_drawCommandSignature.get(), 1, m_particles.arguments, m_particles.drawArgumentsOffset);
+}
+
+
+} // namespace inl::gxeng::nodes
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../Drawing/ClusteredLightCulling.hpp"
+#include "SimulateParticles.hpp"
+
+#include <GraphicsApi_LL/ICommandSignature.hpp>
+#include <GraphicsApi_LL/IPipelineState.hpp>
+#include <GraphicsEngine_LL/BasicCamera.hpp>
+#include <GraphicsEngine_LL/DirectionalLight.hpp>
+#include <GraphicsEngine_LL/GraphicsNode.hpp>
+
+namespace inl::gxeng::nodes {
+
+
+/// <summary>
+/// Inputs: render target, depth texture, camera, particle buffers, light clusters, directional lights
+/// Outputs: render target
+/// </summary>
+/// <remarks>
+/// Draws the particles simulated by <see cref="SimulateParticles"/> as soft round billboards facing the camera,
+/// with a single indirect draw, so the CPU cost does not depend on the particle count.
+/// Each particle is lit at its center by the lights of its cluster, see <see cref="LightClusters"/>, and the sun, unshadowed.
+/// The colors are premultiplied, so additive and blended particles draw together, in the order of the draw list.
+/// The depth texture is only read: particles fade out near the scene instead of cutting into it.
+/// Connect it after the opaque scene and before <see cref="VolumetricLighting"/>, so that the scattering covers the particles too.
+/// </remarks>
+class RenderParticles : virtual public GraphicsNode,
+						virtual public GraphicsTask,
+						virtual public InputPortConfig<Texture2D, Texture2D, const BasicCamera*, ParticleBuffers, LightClusters, const EntityCollection<DirectionalLight>*>,
+						virtual public OutputPortConfig<Texture2D> {
+public:
+	static const char* Info_GetName() { return "RenderParticles"; }
+	const std::string& GetInputName(size_t index) const override;
+	const std::string& GetOutputName(size_t index) const override;
+	RenderParticles();
+
+	void Update() override {}
+	void Notify(InputPortBase* sender) override {}
+
+	void Initialize(EngineContext& context) override;
+	void Reset() override;
+	void Setup(SetupContext& context) override;
+	void Execute(RenderContext& context) override;
+
+private:
+	Binder m_binder;
+	BindParameter m_uniformsBindParam;
+	BindParameter m_particlesBindParam;
+	BindParameter m_drawListBindParam;
+	BindParameter m_depthBindParam;
+	BindParameter m_lightClustersBindParam;
+	BindParameter m_lightsBindParam;
+	BindParameter m_lightIndicesBindParam;
+	ShaderProgram m_shader;
+	std::unique_ptr<gxapi::IPipelineState> m_PSO;
+	std::unique_ptr<gxapi::ICommandSignature> m_drawCommandSignature;
+	gxapi::eFormat m_colorFormat = gxapi::eFormat::UNKNOWN;
+
+	const BasicCamera* m_camera = nullptr;
+	const EntityCollection<DirectionalLight>* m_directionalLights = nullptr;
+	ParticleBuffers m_particles;
+	LightClusters m_lightClusters;
+
+	RenderTargetView2D m_targetRtv;
+	TextureView2D m_depthTexSrv;
+	BufferView m_particlesView;
+	BufferView m_drawListView;
+	BufferView m_lightClustersView;
+	BufferView m_lightsView;
+	BufferView m_lightIndicesView;
+};
+
+
+} // namespace inl::gxeng::nodes
@@ -0,0 +1,498 @@
+#include "SimulateParticles.hpp"
+
+#include <GraphicsEngine_LL/Nodes/NodeUtility.hpp>
+
+#include <GraphicsEngine_LL/AutoRegisterNode.hpp>
+#include <GraphicsEngine_LL/ComputeCommandList.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+
+namespace inl::gxeng::nodes {
+
+
+INL_REGISTER_GRAPHICS_NODE(SimulateParticles)
+
+
+namespace {
+
+// Layout must match ParticleSimulate.hlsl.
+struct Uniforms {
+	Mat44_Packed viewProj;
+	Mat44_Packed invViewProj;
+	Mat44_Packed view;
+	Vec4_Packed depthSize; // Width, height and their reciprocals.
+	Vec3_Packed cameraPosition;
+	float deltaTime;
+	float collisionThickness;
+	uint32_t capacity;
+	uint32_t numEmitters;
+	uint32_t emitCount;
+	uint32_t source; // The list the live particles are read from, they are compacted into the other one.
+	uint32_t dummy[3];
+};
+
+// One step of the bitonic sort, layout must match ParticleSort.hlsl.
+struct SortUniforms {
+	uint32_t k; // Size of the sorted sequences merged.
+	uint32_t j; // Distance of the compared elements.
+};
+
+// Indirect arguments written by ParticleSimulate.hlsl.
+struct ParticleArguments {
+	gxapi::DispatchArguments simulate; // A thread for each particle alive at the start of the frame.
+	gxapi::DispatchArguments sort; // A group for each chunk of the sorted range.
+	gxapi::DrawArguments draw; // 4 strip vertices for each live particle.
+};
+
+} // namespace
+
+static_assert(sizeof(SimulateParticles::ParticleData) == 72, "Must match shaders.");
+static_assert(sizeof(SimulateParticles::EmitterData) == 128, "Must match ParticleSimulate.hlsl.");
+static_assert(sizeof(ParticleArguments) == 10 * sizeof(uint32_t), "Must match ParticleSimulate.hlsl.");
+
+static constexpr unsigned GroupSize = 256; // Must match ParticleSimulate.hlsl.
+static constexpr uint32_t SortChunkSize = 1024; // Elements sorted by a group in shared memory, must match ParticleSort.hlsl.
+static constexpr uint32_t CounterCount = 4; // Live particles in either list, free particles, sorted range.
+static constexpr uint32_t DefaultCapacity = 1u << 20;
+static constexpr uint32_t MaxCapacity = 1u << 23;
+static constexpr size_t MinEmitterCapacity = 16;
+static constexpr float MaxDeltaTime = 0.1f; // Hitches don't throw the particles through walls.
+static constexpr float CollisionThickness = 0.5f; // How far behind the depth buffer particles still bounce off it.
+
+static_assert(MaxCapacity / GroupSize <= 65535, "A thread for each particle is dispatched along a single dimension.");
+
+
+static uint32_t RoundUpToPowerOfTwo(uint32_t value) {
+	uint32_t result = 1;
+	while (result < value) {
+		result <<= 1;
+	}
+	return result;
+}
+
+
+SimulateParticles::SimulateParticles() {
+	this->GetInput<0>().Set({});
+	this->GetInput<3>().Set(0.0);
+	this->GetInput<4>().Set(true);
+	this->GetInput<5>().Set(DefaultCapacity);
+}
+
+
+void SimulateParticles::Initialize(EngineContext& context) {
+	GraphicsNode::SetTaskSingle(this);
+}
+
+
+void SimulateParticles::Reset() {
+	m_depthTexSrv = TextureView2D();
+	m_camera = nullptr;
+	m_emitters.clear();
+
+	GetInput<0>().Clear();
+	GetInput<1>().Clear();
+	GetInput<2>().Clear();
+}
+
+
+const std::string& SimulateParticles::GetInputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"depthTex",
+		"camera",
+		"emitters",
+		"time",
+		"sort",
+		"maxParticles",
+	};
+	return names[index];
+}
+
+
+const std::string& SimulateParticles::GetOutputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"particles"
+	};
+	return names[index];
+}
+
+
+void SimulateParticles::Setup(SetupContext& context) {
+	Texture2D depthTex = this->GetInput<0>().Get();
+	m_camera = this->GetInput<1>().Get();
+	if (!m_camera) {
+		throw InvalidArgumentException("Particles cannot be simulated without a valid camera.");
+	}
+
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.numMipLevels = 1;
+	srvDesc.planeIndex = 0;
+	m_depthTexSrv = context.CreateSrv(depthTex, FormatDepthToColor(depthTex.GetFormat()), srvDesc);
+
+	// The first frame only emits, the particles start moving in the next.
+	const double time = this->GetInput<3>().Get();
+	m_deltaTime = m_lastTime < 0.0 ? 0.0f : (float)std::clamp(time - m_lastTime, 0.0, (double)MaxDeltaTime);
+	m_lastTime = time;
+
+	m_sort = this->GetInput<4>().Get();
+
+	// The bitonic sort needs a power of two, and at least a chunk.
+	const uint32_t capacity = RoundUpToPowerOfTwo(std::clamp(this->GetInput<5>().Get(), SortChunkSize, MaxCapacity));
+	if (capacity != m_buffers.capacity) {
+		InitParticles(context, capacity);
+	}
+
+	CollectEmitters(this->GetInput<2>().Get(), m_deltaTime);
+	ReserveEmitters(context, m_emitters.size());
+
+	if (!m_binder) {
+		BindParameterDesc uniformsBindParamDesc;
+		m_uniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
+		uniformsBindParamDesc.parameter = m_uniformsBindParam;
+		uniformsBindParamDesc.constantSize = sizeof(Uniforms);
+		uniformsBindParamDesc.relativeAccessFrequency = 0;
+		uniformsBindParamDesc.relativeChangeFrequency = 0;
+		uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc sortUniformsBindParamDesc = uniformsBindParamDesc;
+		m_sortUniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 1);
+		sortUniformsBindParamDesc.parameter = m_sortUniformsBindParam;
+		sortUniformsBindParamDesc.constantSize = sizeof(SortUniforms);
+
+		BindParameterDesc depthBindParamDesc;
+		m_depthBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		depthBindParamDesc.parameter = m_depthBindParam;
+		depthBindParamDesc.constantSize = 0;
+		depthBindParamDesc.relativeAccessFrequency = 0;
+		depthBindParamDesc.relativeChangeFrequency = 0;
+		depthBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc emittersBindParamDesc = depthBindParamDesc;
+		m_emittersBindParam = BindParameter(eBindParameterType::TEXTURE, 1);
+		emittersBindParamDesc.parameter = m_emittersBindParam;
+
+		BindParameterDesc particlesBindParamDesc = depthBindParamDesc;
+		m_particlesBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		particlesBindParamDesc.parameter = m_particlesBindParam;
+
+		BindParameterDesc deadListBindParamDesc = depthBindParamDesc;
+		m_deadListBindParam = BindParameter(eBindParameterType::UNORDERED, 1);
+		deadListBindParamDesc.parameter = m_deadListBindParam;
+
+		BindParameterDesc sourceListBindParamDesc = depthBindParamDesc;
+		m_sourceListBindParam = BindParameter(eBindParameterType::UNORDERED, 2);
+		sourceListBindParamDesc.parameter = m_sourceListBindParam;
+
+		BindParameterDesc targetListBindParamDesc = depthBindParamDesc;
+		m_targetListBindParam = BindParameter(eBindParameterType::UNORDERED, 3);
+		targetListBindParamDesc.parameter = m_targetListBindParam;
+
+		BindParameterDesc countersBindParamDesc = depthBindParamDesc;
+		m_countersBindParam = BindParameter(eBindParameterType::UNORDERED, 4);
+		countersBindParamDesc.parameter = m_countersBindParam;
+
+		BindParameterDesc argumentsBindParamDesc = depthBindParamDesc;
+		m_argumentsBindParam = BindParameter(eBindParameterType::UNORDERED, 5);
+		argumentsBindParamDesc.parameter = m_argumentsBindParam;
+
+		m_binder = context.CreateBinder({ uniformsBindParamDesc,
+										  sortUniformsBindParamDesc,
+										  depthBindParamDesc,
+										  emittersBindParamDesc,
+										  particlesBindParamDesc,
+										  deadListBindParamDesc,
+										  sourceListBindParamDesc,
+										  targetListBindParamDesc,
+										  countersBindParamDesc,
+										  argumentsBindParamDesc });
+	}
+
+	if (!m_resetCSO) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_resetShader = context.CreateShader("ParticleSimulate", shaderParts, "PASS_RESET=1");
+		m_emitShader = context.CreateShader("ParticleSimulate", shaderParts, "PASS_EMIT=1");
+		m_simulateArgumentsShader = context.CreateShader("ParticleSimulate", shaderParts, "PASS_SIMULATE_ARGUMENTS=1");
+		m_simulateShader = context.CreateShader("ParticleSimulate", shaderParts, "PASS_SIMULATE=1");
+		m_drawArgumentsShader = context.CreateShader("ParticleSimulate", shaderParts, "PASS_DRAW_ARGUMENTS=1");
+		m_sortLocalShader = context.CreateShader("ParticleSort", shaderParts, "PASS_LOCAL=1");
+		m_sortGlobalShader = context.CreateShader("ParticleSort", shaderParts, "PASS_GLOBAL=1");
+		m_sortMergeShader = context.CreateShader("ParticleSort", shaderParts, "PASS_MERGE=1");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_binder.GetRootSignature();
+
+		csoDesc.cs = m_resetShader.cs;
+		m_resetCSO.reset(context.CreatePSO(csoDesc));
+		csoDesc.cs = m_emitShader.cs;
+		m_emitCSO.reset(context.CreatePSO(csoDesc));
+		csoDesc.cs = m_simulateArgumentsShader.cs;
+		m_simulateArgumentsCSO.reset(context.CreatePSO(csoDesc));
+		csoDesc.cs = m_simulateShader.cs;
+		m_simulateCSO.reset(context.CreatePSO(csoDesc));
+		csoDesc.cs = m_drawArgumentsShader.cs;
+		m_drawArgumentsCSO.reset(context.CreatePSO(csoDesc));
+		csoDesc.cs = m_sortLocalShader.cs;
+		m_sortLocalCSO.reset(context.CreatePSO(csoDesc));
+		csoDesc.cs = m_sortGlobalShader.cs;
+		m_sortGlobalCSO.reset(context.CreatePSO(csoDesc));
+		csoDesc.cs = m_sortMergeShader.cs;
+		m_sortMergeCSO.reset(context.CreatePSO(csoDesc));
+	}
+
+	if (m_dispatchCommandSignature == nullptr) {
+		gxapi::CommandSignatureDesc signatureDesc;
+		signatureDesc.byteStride = sizeof(ParticleArguments);
+		signatureDesc.arguments = { gxapi::IndirectArgumentDesc::Dispatch() };
+		m_dispatchCommandSignature.reset(context.CreateCommandSignature(signatureDesc));
+	}
+
+	// The lists swap every frame, the one written this frame is drawn.
+	m_source ^= 1;
+	m_buffers.drawList = m_lists[m_source ^ 1];
+	this->GetOutput<0>().Set(m_buffers);
+}
+
+
+void SimulateParticles::Execute(RenderContext& context) {
+	ComputeCommandList& commandList = context.AsAsyncCompute();
+
+	const Mat44 view = m_camera->GetViewMatrix();
+	const Mat44 viewProj = view * m_camera->GetProjectionMatrix();
+	const float depthWidth = (float)m_depthTexSrv.GetResource().GetWidth();
+	const float depthHeight = (float)m_depthTexSrv.GetResource().GetHeight();
+
+	Uniforms uniforms;
+	uniforms.viewProj = viewProj;
+	uniforms.invViewProj = viewProj.Inverse();
+	uniforms.view = view;
+	uniforms.depthSize = Vec4(depthWidth, depthHeight, 1.0f / depthWidth, 1.0f / depthHeight);
+	uniforms.cameraPosition = m_camera->GetPosition();
+	uniforms.deltaTime = m_deltaTime;
+	uniforms.collisionThickness = CollisionThickness;
+	uniforms.capacity = m_buffers.capacity;
+	uniforms.numEmitters = (uint32_t)m_emitters.size();
+	uniforms.emitCount = m_emitCount;
+	uniforms.source = m_source;
+
+	if (!m_emitters.empty()) {
+		commandList.SetResourceState(m_emitterBuffer, gxapi::eResourceState::COPY_DEST);
+		context.Upload(m_emitterBuffer, 0, m_emitters.data(), m_emitters.size() * sizeof(EmitterData));
+	}
+
+	commandList.SetResourceState(m_depthTexSrv.GetResource(), gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
+	commandList.SetResourceState(m_emitterBuffer, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
+	commandList.SetResourceState(m_buffers.particles, gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_deadList, gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_lists[0], gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_lists[1], gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_counters, gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_buffers.arguments, gxapi::eResourceState::UNORDERED_ACCESS);
+
+	// All passes share the bindings.
+	commandList.SetComputeBinder(&m_binder);
+	commandList.BindCompute(m_uniformsBindParam, &uniforms, sizeof(uniforms));
+	commandList.BindCompute(m_depthBindParam, m_depthTexSrv);
+	commandList.BindCompute(m_emittersBindParam, m_emittersView);
+	commandList.BindCompute(m_particlesBindParam, m_particlesView);
+	commandList.BindCompute(m_deadListBindParam, m_deadListView);
+	commandList.BindCompute(m_sourceListBindParam, m_listViews[m_source]);
+	commandList.BindCompute(m_targetListBindParam, m_listViews[m_source ^ 1]);
+	commandList.BindCompute(m_countersBindParam, m_countersView);
+	commandList.BindCompute(m_argumentsBindParam, m_argumentsView);
+
+	if (m_resetParticles) { // all particles free
+		commandList.SetPipelineState(m_resetCSO.get());
+		commandList.Dispatch((m_buffers.capacity + GroupSize - 1) / GroupSize, 1, 1);
+		commandList.UAVBarrier(m_deadList);
+		commandList.UAVBarrier(m_counters);
+		m_resetParticles = false;
+	}
+
+	if (m_emitCount > 0) { // new particles taken from the free ones, appended to the live ones
+		commandList.SetPipelineState(m_emitCSO.get());
+		commandList.Dispatch((m_emitCount + GroupSize - 1) / GroupSize, 1, 1);
+		commandList.UAVBarrier(m_buffers.particles);
+		commandList.UAVBarrier(m_deadList);
+		commandList.UAVBarrier(m_lists[m_source]);
+		commandList.UAVBarrier(m_counters);
+	}
+
+	{ // simulation, a thread for each live particle
+		commandList.SetPipelineState(m_simulateArgumentsCSO.get());
+		commandList.Dispatch(1, 1, 1);
+		commandList.UAVBarrier(m_counters);
+		commandList.SetResourceState(m_buffers.arguments, gxapi::eResourceState::INDIRECT_ARGUMENT);
+
+		commandList.SetPipelineState(m_simulateCSO.get());
+		commandList.DispatchIndirect(m_dispatchCommandSignature.get(), 1, m_buffers.arguments, offsetof(ParticleArguments, simulate));
+		commandList.UAVBarrier(m_buffers.particles);
+		commandList.UAVBarrier(m_deadList);
+		commandList.UAVBarrier(m_lists[m_source ^ 1]);
+		commandList.UAVBarrier(m_counters);
+	}
+
+	{ // draw and sort arguments from the survivors
+		commandList.SetResourceState(m_buffers.arguments, gxapi::eResourceState::UNORDERED_ACCESS);
+		commandList.SetPipelineState(m_drawArgumentsCSO.get());
+		commandList.Dispatch(1, 1, 1);
+		commandList.UAVBarrier(m_counters);
+		commandList.SetResourceState(m_buffers.arguments, gxapi::eResourceState::INDIRECT_ARGUMENT);
+	}
+
+	if (m_sort) { // bitonic sort of the survivors, steps within a chunk run in shared memory
+		const LinearBuffer& list = m_lists[m_source ^ 1];
+		const size_t sortArgumentsOffset = offsetof(ParticleArguments, sort);
+
+		commandList.SetPipelineState(m_sortLocalCSO.get());
+		commandList.DispatchIndirect(m_dispatchCommandSignature.get(), 1, m_buffers.arguments, sortArgumentsOffset);
+		commandList.UAVBarrier(list);
+
+		// Steps beyond the live particles return early, the CPU doesn't know how many there are.
+		for (uint32_t k = 2 * SortChunkSize; k <= m_buffers.capacity; k *= 2) {
+			commandList.SetPipelineState(m_sortGlobalCSO.get());
+			for (uint32_t j = k / 2; j >= SortChunkSize; j /= 2) {
+				const SortUniforms sortUniforms = { k, j };
+				commandList.BindCompute(m_sortUniformsBindParam, &sortUniforms, sizeof(sortUniforms));
+				commandList.DispatchIndirect(m_dispatchCommandSignature.get(), 1, m_buffers.arguments, sortArgumentsOffset);
+				commandList.UAVBarrier(list);
+			}
+
+			const SortUniforms sortUniforms = { k, SortChunkSize / 2 };
+			commandList.SetPipelineState(m_sortMergeCSO.get());
+			commandList.BindCompute(m_sortUniformsBindParam, &sortUniforms, sizeof(sortUniforms));
+			commandList.DispatchIndirect(m_dispatchCommandSignature.get(), 1, m_buffers.arguments, sortArgumentsOffset);
+			commandList.UAVBarrier(list);
+		}
+	}
+}
+
+
+void SimulateParticles::CollectEmitters(const EntityCollection<ParticleEmitter>* emitters, float deltaTime) {
+	m_emitters.clear();
+	m_nextEmissionRemainders.clear();
+	m_emitCount = 0;
+	++m_frame;
+
+	if (!emitters) {
+		m_emissionRemainders.clear();
+		return;
+	}
+
+	for (const ParticleEmitter* emitter : *emitters) {
+		auto remainderIt = m_emissionRemainders.find(emitter);
+		float emission = (remainderIt != m_emissionRemainders.end() ? remainderIt->second : 0.0f) + emitter->GetEmissionRate() * deltaTime;
+		// More than the particles could not be emitted anyway, the GPU drops those it finds no free particle for.
+		uint32_t count = (uint32_t)std::min(std::floor(emission), float(m_buffers.capacity - m_emitCount));
+		m_nextEmissionRemainders[emitter] = std::min(emission - float(count), 1.0f);
+		if (count == 0 || emitter->GetLifetime() <= 0.0f) {
+			continue;
+		}
+
+		Vec3 direction = emitter->GetDirection();
+		direction = direction.LengthSquared() > 1e-12f ? direction.Normalized() : Vec3(0.0f, 0.0f, 1.0f);
+
+		EmitterData data;
+		data.position = emitter->GetPosition();
+		data.radius = emitter->GetRadius();
+		data.direction = direction;
+		data.cosSpread = std::cos(emitter->GetSpread());
+		data.acceleration = emitter->GetAcceleration();
+		data.drag = emitter->GetDrag();
+		data.startColor = emitter->GetStartColor();
+		data.endColor = emitter->GetEndColor();
+		data.speed = emitter->GetSpeed();
+		data.speedVariation = emitter->GetSpeedVariation();
+		data.lifetime = emitter->GetLifetime();
+		data.lifetimeVariation = emitter->GetLifetimeVariation();
+		data.startSize = emitter->GetStartSize();
+		data.endSize = emitter->GetEndSize();
+		data.restitution = emitter->GetRestitution();
+		data.additive = emitter->GetAdditive();
+		data.emissive = emitter->GetEmissive();
+		data.firstParticle = m_emitCount;
+		data.count = count;
+		data.seed = m_frame * 0x9E3779B9u + (uint32_t)m_emitters.size() * 0x85EBCA6Bu;
+		m_emitters.push_back(data);
+		m_emitCount += count;
+	}
+
+	std::swap(m_emissionRemainders, m_nextEmissionRemainders);
+}
+
+
+void SimulateParticles::InitParticles(SetupContext& context, uint32_t capacity) {
+	m_buffers.capacity = capacity;
+	m_resetParticles = true;
+
+	m_buffers.particles = context.CreateBuffer(capacity * sizeof(ParticleData), true);
+	m_buffers.particles.SetName("Particles");
+	m_deadList = context.CreateBuffer(capacity * sizeof(uint32_t), true);
+	m_deadList.SetName("Particle free list");
+	for (int i = 0; i < 2; ++i) {
+		m_lists[i] = context.CreateBuffer(capacity * 2 * sizeof(uint32_t), true);
+		m_lists[i].SetName("Particle draw list");
+	}
+
+	gxapi::UavBuffer structuredDesc;
+	structuredDesc.raw = false;
+	structuredDesc.firstElement = 0;
+	structuredDesc.numElements = capacity;
+	structuredDesc.countOffset = 0;
+
+	structuredDesc.elementStride = sizeof(ParticleData);
+	m_particlesView = context.CreateUav(m_buffers.particles, gxapi::eFormat::UNKNOWN, structuredDesc);
+	structuredDesc.elementStride = sizeof(uint32_t);
+	m_deadListView = context.CreateUav(m_deadList, gxapi::eFormat::UNKNOWN, structuredDesc);
+	structuredDesc.elementStride = 2 * sizeof(uint32_t);
+	m_listViews[0] = context.CreateUav(m_lists[0], gxapi::eFormat::UNKNOWN, structuredDesc);
+	m_listViews[1] = context.CreateUav(m_lists[1], gxapi::eFormat::UNKNOWN, structuredDesc);
+
+	if (!m_counters) {
+		m_counters = context.CreateBuffer(CounterCount * sizeof(uint32_t), true);
+		m_counters.SetName("Particle counters");
+		m_buffers.arguments = context.CreateBuffer(sizeof(ParticleArguments), true);
+		m_buffers.arguments.SetName("Particle indirect arguments");
+		m_buffers.drawArgumentsOffset = offsetof(ParticleArguments, draw);
+
+		gxapi::UavBuffer typedDesc;
+		typedDesc.raw = false;
+		typedDesc.firstElement = 0;
+		typedDesc.elementStride = 0;
+		typedDesc.countOffset = 0;
+
+		typedDesc.numElements = CounterCount;
+		m_countersView = context.CreateUav(m_counters, gxapi::eFormat::R32_UINT, typedDesc);
+		typedDesc.numElements = sizeof(ParticleArguments) / sizeof(uint32_t);
+		m_argumentsView = context.CreateUav(m_buffers.arguments, gxapi::eFormat::R32_UINT, typedDesc);
+	}
+}
+
+
+void SimulateParticles::ReserveEmitters(SetupContext& context, size_t count) {
+	if (m_emitterBuffer && count <= m_emitterCapacity) {
+		return;
+	}
+
+	// Grows geometrically, the emitters are uploaded again every frame anyway.
+	m_emitterCapacity = std::max(count, std::max(2 * m_emitterCapacity, MinEmitterCapacity));
+	m_emitterBuffer = context.CreateBuffer(m_emitterCapacity * sizeof(EmitterData));
+	m_emitterBuffer.SetName("Particle emitters");
+
+	gxapi::SrvBuffer desc;
+	desc.firstElement = 0;
+	desc.numElements = (unsigned)m_emitterCapacity;
+	desc.structureStrideInBytes = sizeof(EmitterData);
+	desc.isRaw = false;
+	m_emittersView = context.CreateSrv(m_emitterBuffer, gxapi::eFormat::UNKNOWN, desc);
+}
+
+
+} // namespace inl::gxeng::nodes
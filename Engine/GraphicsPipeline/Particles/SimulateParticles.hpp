@@ -0,0 +1,155 @@
+#pragma once
+
+#include <GraphicsApi_LL/ICommandSignature.hpp>
+#include <GraphicsApi_LL/IPipelineState.hpp>
+#include <GraphicsEngine_LL/BasicCamera.hpp>
+#include <GraphicsEngine_LL/GraphicsNode.hpp>
+#include <GraphicsEngine_LL/ParticleEmitter.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace inl::gxeng::nodes {
+
+
+/// <summary> The live particles of a frame, and the indirect arguments to draw them. </summary>
+struct ParticleBuffers {
+	LinearBuffer particles; // StructuredBuffer of SimulateParticles::ParticleData.
+	LinearBuffer drawList; // StructuredBuffer<uint2> of a sort key and a particle index, the live particles back to front if sorted.
+	LinearBuffer arguments; // Draw arguments at drawArgumentsOffset, an instance of 4 strip vertices for each live particle.
+	uint32_t capacity = 0;
+	uint64_t drawArgumentsOffset = 0;
+};
+
+
+/// <summary>
+/// Inputs: depth texture, camera, particle emitters, time, sort, max particles
+/// Outputs: particle buffers
+/// </summary>
+/// <remarks>
+/// Emits, ages, moves and collides the particles on the async compute queue, see <see cref="ParticleEmitter"/>.
+/// The particles never leave the GPU: they are allocated from a free list by the emission,
+/// and the simulation compacts the survivors into the draw list, which the later passes dispatch and draw indirectly.
+/// The CPU only uploads how many particles each emitter spawns, so the cost does not depend on the particle count.
+/// Particles bounce off the depth texture where they move behind it, the rest of the scene is not known.
+/// Sorting orders the draw list back to front with a bitonic sort, leave it off for purely additive effects.
+/// </remarks>
+class SimulateParticles : virtual public GraphicsNode,
+						  virtual public GraphicsTask,
+						  virtual public InputPortConfig<Texture2D, const BasicCamera*, const EntityCollection<ParticleEmitter>*, double, bool, unsigned>,
+						  virtual public OutputPortConfig<ParticleBuffers> {
+public:
+	// One particle, layout must match ParticleSimulate.hlsl and Particles.hlsl.
+	struct ParticleData {
+		Vec3_Packed position;
+		float age;
+		Vec3_Packed velocity;
+		float lifetime; // Negative once dead.
+		Vec3_Packed acceleration;
+		float drag;
+		uint32_t startColor[2]; // Half precision RGBA.
+		uint32_t endColor[2];
+		uint32_t size; // Half precision start and end size.
+		uint32_t material; // Unorm8 restitution, additive and emissive, and a bit if it collides.
+	};
+
+	// The spawning of an emitter in a frame, layout must match ParticleSimulate.hlsl.
+	struct EmitterData {
+		Vec3_Packed position;
+		float radius;
+		Vec3_Packed direction;
+		float cosSpread;
+		Vec3_Packed acceleration;
+		float drag;
+		Vec4_Packed startColor;
+		Vec4_Packed endColor;
+		float speed, speedVariation;
+		float lifetime, lifetimeVariation;
+		float startSize, endSize;
+		float restitution, additive;
+		float emissive;
+		uint32_t firstParticle; // Of the particles spawned in this frame.
+		uint32_t count;
+		uint32_t seed;
+	};
+
+public:
+	static const char* Info_GetName() { return "SimulateParticles"; }
+	const std::string& GetInputName(size_t index) const override;
+	const std::string& GetOutputName(size_t index) const override;
+	SimulateParticles();
+
+	void Update() override {}
+	void Notify(InputPortBase* sender) override {}
+
+	void Initialize(EngineContext& context) override;
+	void Reset() override;
+	void Setup(SetupContext& context) override;
+	void Execute(RenderContext& context) override;
+
+private:
+	void CollectEmitters(const EntityCollection<ParticleEmitter>* emitters, float deltaTime);
+	void InitParticles(SetupContext& context, uint32_t capacity);
+	void ReserveEmitters(SetupContext& context, size_t count);
+
+private:
+	Binder m_binder;
+	BindParameter m_uniformsBindParam;
+	BindParameter m_sortUniformsBindParam;
+	BindParameter m_depthBindParam;
+	BindParameter m_emittersBindParam;
+	BindParameter m_particlesBindParam;
+	BindParameter m_deadListBindParam;
+	BindParameter m_sourceListBindParam;
+	BindParameter m_targetListBindParam;
+	BindParameter m_countersBindParam;
+	BindParameter m_argumentsBindParam;
+	ShaderProgram m_resetShader;
+	ShaderProgram m_emitShader;
+	ShaderProgram m_simulateArgumentsShader;
+	ShaderProgram m_simulateShader;
+	ShaderProgram m_drawArgumentsShader;
+	ShaderProgram m_sortLocalShader;
+	ShaderProgram m_sortGlobalShader;
+	ShaderProgram m_sortMergeShader;
+	std::unique_ptr<gxapi::IPipelineState> m_resetCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_emitCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_simulateArgumentsCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_simulateCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_drawArgumentsCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_sortLocalCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_sortGlobalCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_sortMergeCSO;
+	std::unique_ptr<gxapi::ICommandSignature> m_dispatchCommandSignature;
+
+	const BasicCamera* m_camera = nullptr;
+	TextureView2D m_depthTexSrv;
+	bool m_sort = true;
+
+	std::vector<EmitterData> m_emitters;
+	std::unordered_map<const ParticleEmitter*, float> m_emissionRemainders; // Fractions of particles carried to the next frame.
+	std::unordered_map<const ParticleEmitter*, float> m_nextEmissionRemainders;
+	uint32_t m_emitCount = 0;
+	double m_lastTime = -1.0;
+	float m_deltaTime = 0.0f;
+	uint32_t m_frame = 0;
+	uint32_t m_source = 1; // The list the live particles are read from, flipped before the first frame.
+
+	// The live particles are read from one list and compacted into the other, they swap every frame.
+	ParticleBuffers m_buffers;
+	LinearBuffer m_lists[2];
+	LinearBuffer m_deadList;
+	LinearBuffer m_counters;
+	LinearBuffer m_emitterBuffer;
+	RWBufferView m_particlesView;
+	RWBufferView m_listViews[2];
+	RWBufferView m_deadListView;
+	RWBufferView m_countersView;
+	RWBufferView m_argumentsView;
+	BufferView m_emittersView;
+	size_t m_emitterCapacity = 0;
+	bool m_resetParticles = true;
+};
+
+
+} // namespace inl::gxeng::nodes
@@ -26,11 +26,13 @@ static int temporalIndex = 0;
 
 ScreenSpaceAmbientOcclusion::ScreenSpaceAmbientOcclusion() {
 	this->GetInput<0>().Set({});
+	this->GetInput<3>().Set(eResolutionScale::DEFAULT);
 }
 
 
 void ScreenSpaceAmbientOcclusion::Initialize(EngineContext& context) {
 	GraphicsNode::SetTaskSingle(this);
+	m_qualityPreset = context.GetQualityPreset();
 }
 
 void ScreenSpaceAmbientOcclusion::Reset() {
@@ -43,7 +45,8 @@ const std::string& ScreenSpaceAmbientOcclusion::GetInputName(size_t index) const
 	static const std::vector<std::string> names = {
 		"depthTex",
 		"camera",
-		"velocityNormalTex"
+		"velocityNormalTex",
+		"resolution"
 	};
 	return names[index];
 }
@@ -71,6 +74,9 @@ void ScreenSpaceAmbientOcclusion::Setup(SetupContext& context) {
 
 	//TODO input 2 normal tex
 
+	unsigned divisor = ScaledResolution::GetDivisor(this->GetInput<3>().Get(), m_qualityPreset);
+	m_resolution.Setup(context, m_depthTexSrv, divisor, gxapi::eFormat::R8G8B8A8_UNORM);
+
 	if (!m_binder) {
 		BindParameterDesc uniformsBindParamDesc;
 		m_uniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
@@ -142,9 +148,9 @@ void ScreenSpaceAmbientOcclusion::Setup(SetupContext& context) {
 	}
 
 
-	if (!m_PSO) {
-		InitRenderTarget(context);
+	InitRenderTarget(context);
 
+	if (!m_PSO) {
 		ShaderParts shaderParts;
 		shaderParts.vs = true;
 		shaderParts.ps = true;
@@ -227,7 +233,12 @@ void ScreenSpaceAmbientOcclusion::Setup(SetupContext& context) {
 		}
 	}
 
-	this->GetOutput<0>().Set(temporalIndex % 2 ? m_blurVertical0Rtv.GetResource() : m_blurVertical1Rtv.GetResource());
+	if (m_resolution.IsReduced()) {
+		this->GetOutput<0>().Set(m_upsampledRtv.GetResource());
+	}
+	else {
+		this->GetOutput<0>().Set(temporalIndex % 2 ? m_blurVertical0Rtv.GetResource() : m_blurVertical1Rtv.GetResource());
+	}
 	//this->GetOutput<0>().Set(m_ssao_rtv.GetResource());
 	//this->GetOutput<0>().Set(m_blur_horizontal_rtv.GetResource());
 }
@@ -261,7 +272,7 @@ void ScreenSpaceAmbientOcclusion::Execute(RenderContext& context) {
 	uniformsCBData.farPlane = m_camera->GetFarPlane();
 
 	uniformsCBData.wsRadius = 0.5f;
-	uniformsCBData.scaleFactor = 0.5f * (m_depthTexSrv.GetResource().GetHeight() / (2.0f * p(0, 0)));
+	uniformsCBData.scaleFactor = 0.5f * (m_resolution.GetHeight() / (2.0f * p(0, 0)));
 
 	//far ndc corners
 	Vec4 ndcCorners[] =
@@ -279,9 +290,13 @@ void ScreenSpaceAmbientOcclusion::Execute(RenderContext& context) {
 	uniformsCBData.farPlaneData0 = Vec4(ndcCorners[0].xyz, ndcCorners[1].x);
 	uniformsCBData.farPlaneData1 = Vec4(ndcCorners[1].y, ndcCorners[1].z, 0.0f, 0.0f);
 
+	// The occlusion and the blurs read the depth at their own resolution.
+	const TextureView2D& depthSrv = m_resolution.GetDepth();
+	m_resolution.DownsampleDepth(commandList);
+
 	{ //SSAO pass
 		commandList.SetResourceState(m_ssaoRtv.GetResource(), gxapi::eResourceState::RENDER_TARGET);
-		commandList.SetResourceState(m_depthTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+		commandList.SetResourceState(depthSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
 
 		RenderTargetView2D* pRTV = &m_ssaoRtv;
 		commandList.SetRenderTargets(1, &pRTV, 0);
@@ -301,7 +316,7 @@ void ScreenSpaceAmbientOcclusion::Execute(RenderContext& context) {
 		commandList.SetGraphicsBinder(&m_binder);
 		commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
 
-		commandList.BindGraphics(m_depthTexBindParam, m_depthTexSrv);
+		commandList.BindGraphics(m_depthTexBindParam, depthSrv);
 		commandList.BindGraphics(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
 
 		commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLESTRIP);
@@ -312,7 +327,7 @@ void ScreenSpaceAmbientOcclusion::Execute(RenderContext& context) {
 	{ //Bilateral horizontal blur pass
 		commandList.SetResourceState(m_blurHorizontalRtv.GetResource(), gxapi::eResourceState::RENDER_TARGET);
 		commandList.SetResourceState(m_ssaoSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
-		commandList.SetResourceState(m_depthTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+		commandList.SetResourceState(depthSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
 
 		RenderTargetView2D* pRTV = &m_blurHorizontalRtv;
 		commandList.SetRenderTargets(1, &pRTV, 0);
@@ -332,7 +347,7 @@ void ScreenSpaceAmbientOcclusion::Execute(RenderContext& context) {
 		commandList.SetGraphicsBinder(&m_binder);
 		commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
 
-		commandList.BindGraphics(m_depthTexBindParam, m_depthTexSrv);
+		commandList.BindGraphics(m_depthTexBindParam, depthSrv);
 		commandList.BindGraphics(m_inputTexBindParam, m_ssaoSrv);
 		commandList.BindGraphics(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
 
@@ -348,7 +363,7 @@ void ScreenSpaceAmbientOcclusion::Execute(RenderContext& context) {
 		commandList.SetResourceState(writeRtv.GetResource(), gxapi::eResourceState::RENDER_TARGET);
 		commandList.SetResourceState(m_blurHorizontalSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
 		commandList.SetResourceState(readSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
-		commandList.SetResourceState(m_depthTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+		commandList.SetResourceState(depthSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
 
 		RenderTargetView2D* pRTV = &writeRtv;
 		commandList.SetRenderTargets(1, &pRTV, 0);
@@ -368,7 +383,7 @@ void ScreenSpaceAmbientOcclusion::Execute(RenderContext& context) {
 		commandList.SetGraphicsBinder(&m_binder);
 		commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
 
-		commandList.BindGraphics(m_depthTexBindParam, m_depthTexSrv);
+		commandList.BindGraphics(m_depthTexBindParam, depthSrv);
 		commandList.BindGraphics(m_temporalTexBindParam, readSrv);
 		commandList.BindGraphics(m_inputTexBindParam, m_blurHorizontalSrv);
 		commandList.BindGraphics(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
@@ -377,43 +392,52 @@ void ScreenSpaceAmbientOcclusion::Execute(RenderContext& context) {
 		commandList.DrawInstanced(4);
 	}
 
+	if (m_resolution.IsReduced()) {
+		auto resultSrv = temporalIndex % 2 ? m_blurVertical0Srv : m_blurVertical1Srv;
+		m_resolution.Upsample(commandList, resultSrv, m_upsampledRtv, *m_camera);
+	}
+
 	m_prevVP = vp;
 }
 
 
 void ScreenSpaceAmbientOcclusion::InitRenderTarget(SetupContext& context) {
-	if (!m_outputTexturesInited) {
-		m_outputTexturesInited = true;
+	using gxapi::eFormat;
 
-		using gxapi::eFormat;
+	auto formatSSAO = eFormat::R8G8B8A8_UNORM;
 
-		auto formatSSAO = eFormat::R8G8B8A8_UNORM;
+	gxapi::RtvTexture2DArray rtvDesc;
+	rtvDesc.activeArraySize = 1;
+	rtvDesc.firstArrayElement = 0;
+	rtvDesc.firstMipLevel = 0;
+	rtvDesc.planeIndex = 0;
 
-		gxapi::RtvTexture2DArray rtvDesc;
-		rtvDesc.activeArraySize = 1;
-		rtvDesc.firstArrayElement = 0;
-		rtvDesc.firstMipLevel = 0;
-		rtvDesc.planeIndex = 0;
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.numMipLevels = -1;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.planeIndex = 0;
 
-		gxapi::SrvTexture2DArray srvDesc;
-		srvDesc.activeArraySize = 1;
-		srvDesc.firstArrayElement = 0;
-		srvDesc.numMipLevels = -1;
-		srvDesc.mipLevelClamping = 0;
-		srvDesc.mostDetailedMip = 0;
-		srvDesc.planeIndex = 0;
+	Texture2DDesc desc{
+		m_resolution.GetWidth(),
+		m_resolution.GetHeight(),
+		formatSSAO
+	};
 
-		Texture2DDesc desc{
-			m_depthTexSrv.GetResource().GetWidth(),
-			m_depthTexSrv.GetResource().GetHeight(),
-			formatSSAO
-		};
+	// The raw occlusion and the horizontal blur are only used inside this node, they come from the transient pool each frame.
+	Texture2D ssaoTex = context.CreateTransientTexture2D(desc, { true, true, false, false });
+	m_ssaoRtv = context.CreateRtv(ssaoTex, formatSSAO, rtvDesc);
+	m_ssaoSrv = context.CreateSrv(ssaoTex, formatSSAO, srvDesc);
 
-		Texture2D ssaoTex = context.CreateTexture2D(desc, { true, true, false, false });
-		ssaoTex.SetName("Screen space ambient occlusion tex");
-		m_ssaoRtv = context.CreateRtv(ssaoTex, formatSSAO, rtvDesc);
-		m_ssaoSrv = context.CreateSrv(ssaoTex, formatSSAO, srvDesc);
+	Texture2D blurHorizontalTex = context.CreateTransientTexture2D(desc, { true, true, false, false });
+	m_blurHorizontalRtv = context.CreateRtv(blurHorizontalTex, formatSSAO, rtvDesc);
+	m_blurHorizontalSrv = context.CreateSrv(blurHorizontalTex, formatSSAO, srvDesc);
 
+	// The vertical blur results are the temporal history, they have to persist.
+	bool historyChanged = !m_blurVertical0Srv || m_blurVertical0Srv.GetResource().GetWidth() != desc.width || m_blurVertical0Srv.GetResource().GetHeight() != desc.height;
+	if (historyChanged) {
 		Texture2D blurVertical1Tex = context.CreateTexture2D(desc, { true, true, false, false });
 		blurVertical1Tex.SetName("Screen space ambient occlusion vertical blur tex");
 		m_blurVertical1Rtv = context.CreateRtv(blurVertical1Tex, formatSSAO, rtvDesc);
@@ -423,11 +447,21 @@ void ScreenSpaceAmbientOcclusion::InitRenderTarget(SetupContext& context) {
 		blurVertical0Tex.SetName("Screen space ambient occlusion vertical blur tex");
 		m_blurVertical0Rtv = context.CreateRtv(blurVertical0Tex, formatSSAO, rtvDesc);
 		m_blurVertical0Srv = context.CreateSrv(blurVertical0Tex, formatSSAO, srvDesc);
+	}
 
-		Texture2D blurHorizontalTex = context.CreateTexture2D(desc, { true, true, false, false });
-		blurHorizontalTex.SetName("Screen space ambient occlusion horizontal blur tex");
-		m_blurHorizontalRtv = context.CreateRtv(blurHorizontalTex, formatSSAO, rtvDesc);
-		m_blurHorizontalSrv = context.CreateSrv(blurHorizontalTex, formatSSAO, srvDesc);
+	// The output is the upsampled history, it persists as well.
+	if (!m_resolution.IsReduced()) {
+		m_upsampledRtv = RenderTargetView2D();
+	}
+	else if (!m_upsampledRtv || m_upsampledRtv.GetResource().GetWidth() != m_depthTexSrv.GetResource().GetWidth() || m_upsampledRtv.GetResource().GetHeight() != m_depthTexSrv.GetResource().GetHeight()) {
+		Texture2DDesc upsampledDesc{
+			m_depthTexSrv.GetResource().GetWidth(),
+			m_depthTexSrv.GetResource().GetHeight(),
+			formatSSAO
+		};
+		Texture2D upsampledTex = context.CreateTexture2D(upsampledDesc, { true, true, false, false });
+		upsampledTex.SetName("Screen space ambient occlusion upsampled tex");
+		m_upsampledRtv = context.CreateRtv(upsampledTex, formatSSAO, rtvDesc);
 	}
 }
 
@@ -4,13 +4,22 @@
 #include <GraphicsEngine_LL/BasicCamera.hpp>
 #include <GraphicsEngine_LL/GraphicsNode.hpp>
 
+#include "../ScaledResolution.hpp"
+
 
 namespace inl::gxeng::nodes {
 
 
+/// <summary>
+/// Inputs: depth texture, camera, velocity and normal texture, resolution
+/// </summary>
+/// <remarks>
+/// The occlusion and its blur are computed at the given fraction of the depth's resolution,
+/// then upsampled to full resolution, see <see cref="ScaledResolution"/>.
+/// </remarks>
 class ScreenSpaceAmbientOcclusion : virtual public GraphicsNode,
 									virtual public GraphicsTask,
-									virtual public InputPortConfig<Texture2D, const BasicCamera*, Texture2D>,
+									virtual public InputPortConfig<Texture2D, const BasicCamera*, Texture2D, eResolutionScale>,
 									virtual public OutputPortConfig<Texture2D> {
 public:
 	static const char* Info_GetName() { return "ScreenSpaceAmbientOcclusion"; }
@@ -41,7 +50,9 @@ protected:
 	std::unique_ptr<gxapi::IPipelineState> m_vertical1PSO;
 
 protected: // outputs
-	bool m_outputTexturesInited = false;
+	ScaledResolution m_resolution;
+	eQualityPreset m_qualityPreset = eQualityPreset::HIGH;
+	RenderTargetView2D m_upsampledRtv;
 	RenderTargetView2D m_ssaoRtv;
 	RenderTargetView2D m_blurHorizontalRtv;
 	RenderTargetView2D m_blurVertical0Rtv;
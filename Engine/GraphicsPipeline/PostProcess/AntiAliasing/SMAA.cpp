@@ -18,11 +18,15 @@ struct Uniforms {
 	Vec4 pixelSize;
 };
 
+static constexpr unsigned TileSize = 16; // Must match SMAATileClassify.hlsl and SMAANeighborhoodBlendingCompute.hlsl.
+static constexpr gxapi::eFormat EdgeStencilFormat = gxapi::eFormat::D24_UNORM_S8_UINT;
+
 
 SMAA::SMAA() {
 	this->GetInput<0>().Set({});
 	this->GetInput<1>().Set({});
 	this->GetInput<2>().Set({});
+	this->GetInput<4>().Set(false);
 }
 
 
@@ -44,6 +48,7 @@ const std::string& SMAA::GetInputName(size_t index) const {
 		"areaImage",
 		"searchImage",
 		"neighborHoodBlendingRTV",
+		"compute",
 	};
 	return names[index];
 }
@@ -75,6 +80,8 @@ void SMAA::Setup(SetupContext& context) {
 	rtvDesc.planeIndex = 0;
 	m_neighborhoodBlendingRTV = context.CreateRtv(target, target.GetFormat(), rtvDesc);
 
+	m_compute = this->GetInput<4>().Get();
+
 
 	auto areaImage = this->GetInput<1>().Get();
 	auto searchImage = this->GetInput<2>().Get();
@@ -169,12 +176,31 @@ void SMAA::Setup(SetupContext& context) {
 		samplerDesc2.registerSpace = 0;
 		samplerDesc2.shaderVisibility = gxapi::eShaderVisiblity::ALL;
 
-		m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc, sampBindParamDesc2, inputBindParamDesc, areaBindParamDesc, searchBindParamDesc, blendBindParamDesc }, { samplerDesc, samplerDesc2 });
+		BindParameterDesc tileBindParamDesc;
+		m_tileTexBindParam = BindParameter(eBindParameterType::TEXTURE, 4);
+		tileBindParamDesc.parameter = m_tileTexBindParam;
+		tileBindParamDesc.constantSize = 0;
+		tileBindParamDesc.relativeAccessFrequency = 0;
+		tileBindParamDesc.relativeChangeFrequency = 0;
+		tileBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc outputUavBindParamDesc;
+		m_outputUavBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		outputUavBindParamDesc.parameter = m_outputUavBindParam;
+		outputUavBindParamDesc.constantSize = 0;
+		outputUavBindParamDesc.relativeAccessFrequency = 0;
+		outputUavBindParamDesc.relativeChangeFrequency = 0;
+		outputUavBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc, sampBindParamDesc2, inputBindParamDesc, areaBindParamDesc, searchBindParamDesc, blendBindParamDesc, tileBindParamDesc, outputUavBindParamDesc }, { samplerDesc, samplerDesc2 });
 	}
 
-	if (!m_edgeDetectionPSO || !m_blendingWeightsPSO || !m_neighborhoodBlendingPSO) {
-		InitRenderTarget(context);
+	InitRenderTarget(context);
+	if (m_compute) {
+		InitComputeTargets(context);
+	}
 
+	if (!m_edgeDetectionPSO || !m_blendingWeightsPSO || !m_neighborhoodBlendingPSO) {
 		{
 			ShaderParts shaderParts;
 			shaderParts.vs = true;
@@ -196,10 +222,18 @@ void SMAA::Setup(SetupContext& context) {
 			psoDesc.rasterization = gxapi::RasterizerState(gxapi::eFillMode::SOLID, gxapi::eCullMode::DRAW_ALL);
 			psoDesc.primitiveTopologyType = gxapi::ePrimitiveTopologyType::TRIANGLE;
 
+			// Pixels without edges are discarded by the shader, the rest mark the stencil.
 			psoDesc.depthStencilState.enableDepthTest = false;
 			psoDesc.depthStencilState.enableDepthStencilWrite = false;
-			psoDesc.depthStencilState.enableStencilTest = false;
+			psoDesc.depthStencilState.enableStencilTest = true;
+			psoDesc.depthStencilState.stencilReadMask = 0;
+			psoDesc.depthStencilState.stencilWriteMask = ~uint8_t(0);
+			psoDesc.depthStencilState.ccwFace.stencilFunc = gxapi::eComparisonFunction::ALWAYS;
+			psoDesc.depthStencilState.ccwFace.stencilOpOnStencilFail = gxapi::eStencilOp::KEEP;
+			psoDesc.depthStencilState.ccwFace.stencilOpOnDepthFail = gxapi::eStencilOp::KEEP;
+			psoDesc.depthStencilState.ccwFace.stencilOpOnPass = gxapi::eStencilOp::REPLACE;
 			psoDesc.depthStencilState.cwFace = psoDesc.depthStencilState.ccwFace;
+			psoDesc.depthStencilFormat = EdgeStencilFormat;
 
 			psoDesc.numRenderTargets = 1;
 			psoDesc.renderTargetFormats[0] = m_edgeDetectionRTV.GetResource().GetFormat();
@@ -228,10 +262,18 @@ void SMAA::Setup(SetupContext& context) {
 			psoDesc.rasterization = gxapi::RasterizerState(gxapi::eFillMode::SOLID, gxapi::eCullMode::DRAW_ALL);
 			psoDesc.primitiveTopologyType = gxapi::ePrimitiveTopologyType::TRIANGLE;
 
+			// The searches only run on the edge pixels, the cleared weights of the rest stay zero.
 			psoDesc.depthStencilState.enableDepthTest = false;
 			psoDesc.depthStencilState.enableDepthStencilWrite = false;
-			psoDesc.depthStencilState.enableStencilTest = false;
+			psoDesc.depthStencilState.enableStencilTest = true;
+			psoDesc.depthStencilState.stencilReadMask = ~uint8_t(0);
+			psoDesc.depthStencilState.stencilWriteMask = 0;
+			psoDesc.depthStencilState.ccwFace.stencilFunc = gxapi::eComparisonFunction::EQUAL;
+			psoDesc.depthStencilState.ccwFace.stencilOpOnStencilFail = gxapi::eStencilOp::KEEP;
+			psoDesc.depthStencilState.ccwFace.stencilOpOnDepthFail = gxapi::eStencilOp::KEEP;
+			psoDesc.depthStencilState.ccwFace.stencilOpOnPass = gxapi::eStencilOp::KEEP;
 			psoDesc.depthStencilState.cwFace = psoDesc.depthStencilState.ccwFace;
+			psoDesc.depthStencilFormat = EdgeStencilFormat;
 
 			psoDesc.numRenderTargets = 1;
 			psoDesc.renderTargetFormats[0] = m_blendingWeightsRTV.GetResource().GetFormat();
@@ -272,6 +314,22 @@ void SMAA::Setup(SetupContext& context) {
 		}
 	}
 
+	if (m_compute && !m_tileClassifyCSO) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_tileClassifyShader = context.CreateShader("SMAATileClassify", shaderParts, "");
+		m_neighborhoodBlendingComputeShader = context.CreateShader("SMAANeighborhoodBlendingCompute", shaderParts, "");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_binder.GetRootSignature();
+
+		csoDesc.cs = m_tileClassifyShader.cs;
+		m_tileClassifyCSO.reset(context.CreatePSO(csoDesc));
+		csoDesc.cs = m_neighborhoodBlendingComputeShader.cs;
+		m_neighborhoodBlendingCSO.reset(context.CreatePSO(csoDesc));
+	}
+
 	this->GetOutput<0>().Set(m_neighborhoodBlendingRTV.GetResource());
 	//this->GetOutput<0>().Set(m_blendingWeightsRTV.GetResource());
 	//this->GetOutput<0>().Set(m_edgeDetectionRTV.GetResource());
@@ -307,10 +365,13 @@ void SMAA::Execute(RenderContext& context) {
 		commandList.SetResourceState(m_edgeDetectionRTV.GetResource(), gxapi::eResourceState::RENDER_TARGET);
 		commandList.SetResourceState(m_inputTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
 
+		commandList.SetResourceState(m_edgeStencilDSV.GetResource(), gxapi::eResourceState::DEPTH_WRITE);
+
 		RenderTargetView2D* pRTV = &m_edgeDetectionRTV;
-		commandList.SetRenderTargets(1, &pRTV, 0);
+		commandList.SetRenderTargets(1, &pRTV, &m_edgeStencilDSV);
 
 		commandList.ClearRenderTarget(m_edgeDetectionRTV, gxapi::ColorRGBA(0, 0, 0, 0));
+		commandList.ClearDepthStencil(m_edgeStencilDSV, 1, 0, 0, nullptr, false, true);
 
 		commandList.SetScissorRects(1, &rect);
 		commandList.SetViewports(1, &viewport);
@@ -318,6 +379,7 @@ void SMAA::Execute(RenderContext& context) {
 		commandList.SetPipelineState(m_edgeDetectionPSO.get());
 		commandList.SetGraphicsBinder(&m_binder);
 		commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
+		commandList.SetStencilRef(1); // pixels with edges are 1, the rest stays 0
 		commandList.BindGraphics(m_inputTexBindParam, m_inputTexSrv);
 		commandList.BindGraphics(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
 
@@ -335,7 +397,7 @@ void SMAA::Execute(RenderContext& context) {
 		commandList.SetResourceState(searchImage->GetSrv().GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
 
 		RenderTargetView2D* pRTV = &m_blendingWeightsRTV;
-		commandList.SetRenderTargets(1, &pRTV, 0);
+		commandList.SetRenderTargets(1, &pRTV, &m_edgeStencilDSV);
 
 		commandList.ClearRenderTarget(m_blendingWeightsRTV, gxapi::ColorRGBA(0, 0, 0, 0));
 
@@ -345,6 +407,7 @@ void SMAA::Execute(RenderContext& context) {
 		commandList.SetPipelineState(m_blendingWeightsPSO.get());
 		commandList.SetGraphicsBinder(&m_binder);
 		commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
+		commandList.SetStencilRef(1); // only search from pixels with edges
 		commandList.BindGraphics(m_inputTexBindParam, m_edgeDetectionSRV);
 		commandList.BindGraphics(m_areaTexBindParam, areaImage->GetSrv());
 		commandList.BindGraphics(m_searchTexBindParam, searchImage->GetSrv());
@@ -354,7 +417,37 @@ void SMAA::Execute(RenderContext& context) {
 		commandList.DrawInstanced(4);
 	}
 
-	{ //neighborhood blending
+	if (m_compute) { //tile classification and neighborhood blending of the tiles with edges
+		const unsigned width = (unsigned)m_edgeDetectionRTV.GetResource().GetWidth();
+		const unsigned height = m_edgeDetectionRTV.GetResource().GetHeight();
+		const unsigned tilesX = (width + TileSize - 1) / TileSize;
+		const unsigned tilesY = (height + TileSize - 1) / TileSize;
+
+		commandList.SetResourceState(m_tileUAV.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+		commandList.SetResourceState(m_edgeDetectionSRV.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+
+		commandList.SetComputeBinder(&m_binder);
+		commandList.SetPipelineState(m_tileClassifyCSO.get());
+		commandList.BindCompute(m_inputTexBindParam, m_edgeDetectionSRV);
+		commandList.BindCompute(m_outputUavBindParam, m_tileUAV);
+		commandList.BindCompute(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
+		commandList.Dispatch(tilesX, tilesY, 1);
+		commandList.UAVBarrier(m_tileUAV.GetResource());
+
+		commandList.SetResourceState(m_tileSRV.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+		commandList.SetResourceState(m_blendingWeightsSRV.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+		commandList.SetResourceState(m_neighborhoodBlendingUAV.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+
+		commandList.SetPipelineState(m_neighborhoodBlendingCSO.get());
+		commandList.BindCompute(m_inputTexBindParam, m_inputTexSrv);
+		commandList.BindCompute(m_blendTexBindParam, m_blendingWeightsSRV);
+		commandList.BindCompute(m_tileTexBindParam, m_tileSRV);
+		commandList.BindCompute(m_outputUavBindParam, m_neighborhoodBlendingUAV);
+		commandList.BindCompute(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
+		commandList.Dispatch(tilesX, tilesY, 1);
+		commandList.UAVBarrier(m_neighborhoodBlendingUAV.GetResource());
+	}
+	else { //neighborhood blending
 		commandList.SetResourceState(m_neighborhoodBlendingRTV.GetResource(), gxapi::eResourceState::RENDER_TARGET);
 		commandList.SetResourceState(m_blendingWeightsSRV.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
 
@@ -378,56 +471,92 @@ void SMAA::Execute(RenderContext& context) {
 
 
 void SMAA::InitRenderTarget(SetupContext& context) {
-	if (!m_outputTexturesInited) {
-		m_outputTexturesInited = true;
+	// The intermediate textures are only used inside this node, so they come from the transient pool each frame.
+	using gxapi::eFormat;
+
+	auto format = eFormat::R8G8B8A8_UNORM;
+
+	gxapi::RtvTexture2DArray rtvDesc;
+	rtvDesc.activeArraySize = 1;
+	rtvDesc.firstArrayElement = 0;
+	rtvDesc.firstMipLevel = 0;
+	rtvDesc.planeIndex = 0;
 
-		using gxapi::eFormat;
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.numMipLevels = -1;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.planeIndex = 0;
+
+	Texture2DDesc desc{
+		m_inputTexSrv.GetResource().GetWidth(),
+		m_inputTexSrv.GetResource().GetHeight(),
+		format
+	};
+	TextureUsage usage{
+		true, true, false, false
+	};
 
-		auto format = eFormat::R8G8B8A8_UNORM;
+	Texture2D edgeDetectionTex = context.CreateTransientTexture2D(desc, usage);
+	m_edgeDetectionRTV = context.CreateRtv(edgeDetectionTex, format, rtvDesc);
 
-		gxapi::RtvTexture2DArray rtvDesc;
-		rtvDesc.activeArraySize = 1;
-		rtvDesc.firstArrayElement = 0;
-		rtvDesc.firstMipLevel = 0;
-		rtvDesc.planeIndex = 0;
+	m_edgeDetectionSRV = context.CreateSrv(edgeDetectionTex, format, srvDesc);
 
-		gxapi::SrvTexture2DArray srvDesc;
-		srvDesc.activeArraySize = 1;
-		srvDesc.firstArrayElement = 0;
-		srvDesc.numMipLevels = -1;
-		srvDesc.mipLevelClamping = 0;
-		srvDesc.mostDetailedMip = 0;
-		srvDesc.planeIndex = 0;
 
-		Texture2DDesc desc{
-			m_inputTexSrv.GetResource().GetWidth(),
-			m_inputTexSrv.GetResource().GetHeight(),
-			format
-		};
-		TextureUsage usage{
-			true, true, false, false
-		};
+	Texture2D blendingWeightsTex = context.CreateTransientTexture2D(desc, usage);
+	m_blendingWeightsRTV = context.CreateRtv(blendingWeightsTex, format, rtvDesc);
 
-		Texture2D edgeDetectionTex = context.CreateTexture2D(desc, usage);
-		edgeDetectionTex.SetName("SMAA edge detection tex");
-		m_edgeDetectionRTV = context.CreateRtv(edgeDetectionTex, format, rtvDesc);
+	m_blendingWeightsSRV = context.CreateSrv(blendingWeightsTex, format, srvDesc);
 
-		m_edgeDetectionSRV = context.CreateSrv(edgeDetectionTex, format, srvDesc);
 
+	Texture2D edgeStencilTex = context.CreateTransientTexture2D({ desc.width, desc.height, EdgeStencilFormat }, { false, false, true, false });
+	gxapi::DsvTexture2DArray dsvDesc;
+	dsvDesc.activeArraySize = 1;
+	dsvDesc.firstArrayElement = 0;
+	dsvDesc.firstMipLevel = 0;
+	m_edgeStencilDSV = context.CreateDsv(edgeStencilTex, EdgeStencilFormat, dsvDesc);
 
-		Texture2D blendingWeightsTex = context.CreateTexture2D(desc, usage);
-		blendingWeightsTex.SetName("SMAA blending weights tex");
-		m_blendingWeightsRTV = context.CreateRtv(blendingWeightsTex, format, rtvDesc);
 
-		m_blendingWeightsSRV = context.CreateSrv(blendingWeightsTex, format, srvDesc);
+	//Texture2D neighborhoodBlendingTex = context.CreateTexture2D(desc, usage);
+	//neighborhoodBlendingTex.SetName("SMAA neighborhood blending tex");
+	//m_neighborhoodBlendingRTV = context.CreateRtv(neighborhoodBlendingTex, format, rtvDesc);
 
+	//m_neighborhoodBlendingSRV = context.CreateSrv(neighborhoodBlendingTex, format, srvDesc);
+}
 
-		//Texture2D neighborhoodBlendingTex = context.CreateTexture2D(desc, usage);
-		//neighborhoodBlendingTex.SetName("SMAA neighborhood blending tex");
-		//m_neighborhoodBlendingRTV = context.CreateRtv(neighborhoodBlendingTex, format, rtvDesc);
 
-		//m_neighborhoodBlendingSRV = context.CreateSrv(neighborhoodBlendingTex, format, srvDesc);
-	}
+void SMAA::InitComputeTargets(SetupContext& context) {
+	using gxapi::eFormat;
+
+	auto formatTiles = eFormat::R8_UINT;
+
+	gxapi::UavTexture2DArray uavDesc;
+	uavDesc.activeArraySize = 1;
+	uavDesc.firstArrayElement = 0;
+	uavDesc.mipLevel = 0;
+	uavDesc.planeIndex = 0;
+
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.numMipLevels = 1;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.planeIndex = 0;
+
+	const uint64_t width = m_inputTexSrv.GetResource().GetWidth();
+	const uint32_t height = m_inputTexSrv.GetResource().GetHeight();
+
+	Texture2DDesc tilesDesc{ (width + TileSize - 1) / TileSize, (height + TileSize - 1) / TileSize, formatTiles };
+	Texture2D tilesTex = context.CreateTransientTexture2D(tilesDesc, { true, false, false, true });
+	m_tileUAV = context.CreateUav(tilesTex, formatTiles, uavDesc);
+	m_tileSRV = context.CreateSrv(tilesTex, formatTiles, srvDesc);
+
+	// The compute blend writes the target directly, it has to allow random access.
+	const Texture2D& target = m_neighborhoodBlendingRTV.GetResource();
+	m_neighborhoodBlendingUAV = context.CreateUav(target, target.GetFormat(), uavDesc);
 }
 
 
@@ -9,7 +9,7 @@ namespace inl::gxeng::nodes {
 
 class SMAA : virtual public GraphicsNode,
 			 virtual public GraphicsTask,
-			 virtual public InputPortConfig<Texture2D, inl::gxeng::Image*, inl::gxeng::Image*, Texture2D>,
+			 virtual public InputPortConfig<Texture2D, inl::gxeng::Image*, inl::gxeng::Image*, Texture2D, bool>,
 			 virtual public OutputPortConfig<Texture2D> {
 public:
 	static const char* Info_GetName() { return "SMAA"; }
@@ -32,27 +32,38 @@ protected:
 	BindParameter m_searchTexBindParam;
 	BindParameter m_blendTexBindParam;
 	BindParameter m_uniformsBindParam;
+	BindParameter m_tileTexBindParam;
+	BindParameter m_outputUavBindParam;
 	ShaderProgram m_edgeDetectionShader;
 	ShaderProgram m_blendingWeightsShader;
 	ShaderProgram m_neighborhoodBlendingShader;
 	std::unique_ptr<gxapi::IPipelineState> m_edgeDetectionPSO;
 	std::unique_ptr<gxapi::IPipelineState> m_blendingWeightsPSO;
 	std::unique_ptr<gxapi::IPipelineState> m_neighborhoodBlendingPSO;
+	ShaderProgram m_tileClassifyShader;
+	ShaderProgram m_neighborhoodBlendingComputeShader;
+	std::unique_ptr<gxapi::IPipelineState> m_tileClassifyCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_neighborhoodBlendingCSO;
 
 protected: // outputs
-	bool m_outputTexturesInited = false;
 	RenderTargetView2D m_edgeDetectionRTV;
 	RenderTargetView2D m_blendingWeightsRTV;
 	RenderTargetView2D m_neighborhoodBlendingRTV;
 	TextureView2D m_edgeDetectionSRV;
 	TextureView2D m_blendingWeightsSRV;
+	DepthStencilView2D m_edgeStencilDSV;
+	RWTextureView2D m_tileUAV;
+	TextureView2D m_tileSRV;
+	RWTextureView2D m_neighborhoodBlendingUAV;
 	//TextureView2D m_neighborhoodBlendingSRV;
 
 protected: // render context
 	TextureView2D m_inputTexSrv;
+	bool m_compute = false;
 
 private:
 	void InitRenderTarget(SetupContext& context);
+	void InitComputeTargets(SetupContext& context);
 };
 
 
@@ -0,0 +1,277 @@
+#include "TemporalAA.hpp"
+
+#include <GraphicsEngine_LL/Nodes/NodeUtility.hpp>
+
+#include <GraphicsEngine_LL/AutoRegisterNode.hpp>
+#include <GraphicsEngine_LL/GraphicsCommandList.hpp>
+#include <GraphicsEngine_LL/PerspectiveCamera.hpp>
+
+
+namespace inl::gxeng::nodes {
+
+
+INL_REGISTER_GRAPHICS_NODE(TemporalAA)
+
+
+struct Uniforms {
+	Mat44_Packed invVP; // Unjittered, of this frame.
+	Mat44_Packed prevVP; // Unjittered, of the last frame.
+	Vec4_Packed inputSize; // Width, height and their reciprocals.
+	Vec4_Packed outputSize;
+	Vec2_Packed jitter; // How far the image moved, in input pixels, positive is right and down.
+	float blendFactor;
+	float velocityScale;
+	uint32_t historyValid;
+	uint32_t dummy[3];
+};
+
+static constexpr unsigned GroupSize = 8; // Must match TemporalAA.hlsl.
+static constexpr float VelocityScale = 0.5f * 0.75f * 150.0f; // Must match halfExposureFramerate of ForwardRender.
+
+
+TemporalAA::TemporalAA() {
+	this->GetInput<0>().Set({});
+	this->GetInput<1>().Set({});
+	this->GetInput<2>().Set({});
+	this->GetInput<3>().Set(nullptr);
+	this->GetInput<4>().Set(0);
+	this->GetInput<5>().Set(0);
+}
+
+
+void TemporalAA::Initialize(EngineContext& context) {
+	GraphicsNode::SetTaskSingle(this);
+}
+
+void TemporalAA::Reset() {
+	m_colorTexSrv = TextureView2D();
+	m_depthTexSrv = TextureView2D();
+	m_velocityTexSrv = TextureView2D();
+	m_camera = nullptr;
+
+	GetInput<0>().Clear();
+	GetInput<1>().Clear();
+	GetInput<2>().Clear();
+	GetInput<3>().Clear();
+}
+
+const std::string& TemporalAA::GetInputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"colorTex",
+		"depthTex",
+		"velocityNormalTex",
+		"camera",
+		"outputWidth",
+		"outputHeight",
+	};
+	return names[index];
+}
+
+const std::string& TemporalAA::GetOutputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"taaOutput"
+	};
+	return names[index];
+}
+
+void TemporalAA::Setup(SetupContext& context) {
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.numMipLevels = 1;
+	srvDesc.planeIndex = 0;
+
+	Texture2D colorTex = this->GetInput<0>().Get();
+	m_colorTexSrv = context.CreateSrv(colorTex, colorTex.GetFormat(), srvDesc);
+
+	Texture2D depthTex = this->GetInput<1>().Get();
+	m_depthTexSrv = context.CreateSrv(depthTex, FormatDepthToColor(depthTex.GetFormat()), srvDesc);
+
+	Texture2D velocityTex = this->GetInput<2>().Get();
+	m_velocityTexSrv = context.CreateSrv(velocityTex, velocityTex.GetFormat(), srvDesc);
+
+	m_camera = this->GetInput<3>().Get();
+	if (m_camera == nullptr) {
+		throw InvalidArgumentException("Temporal AA needs a camera.");
+	}
+
+	// The history belongs to a view, it's no use for another camera.
+	if (m_camera != m_prevCamera) {
+		m_historyValid = false;
+		m_prevCamera = m_camera;
+	}
+
+	unsigned outputWidth = this->GetInput<4>().Get();
+	unsigned outputHeight = this->GetInput<5>().Get();
+	uint64_t width = outputWidth != 0 ? outputWidth : colorTex.GetWidth();
+	uint32_t height = outputHeight != 0 ? outputHeight : colorTex.GetHeight();
+	if (!m_historyUav[0] || m_historyUav[0].GetResource().GetWidth() != width || m_historyUav[0].GetResource().GetHeight() != height) {
+		InitRenderTargets(context, width, height);
+	}
+	m_current ^= 1;
+
+
+	if (!m_binder) {
+		BindParameterDesc uniformsBindParamDesc;
+		m_uniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
+		uniformsBindParamDesc.parameter = m_uniformsBindParam;
+		uniformsBindParamDesc.constantSize = sizeof(Uniforms);
+		uniformsBindParamDesc.relativeAccessFrequency = 0;
+		uniformsBindParamDesc.relativeChangeFrequency = 0;
+		uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc sampBindParamDesc;
+		sampBindParamDesc.parameter = BindParameter(eBindParameterType::SAMPLER, 0);
+		sampBindParamDesc.constantSize = 0;
+		sampBindParamDesc.relativeAccessFrequency = 0;
+		sampBindParamDesc.relativeChangeFrequency = 0;
+		sampBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc colorBindParamDesc;
+		m_colorTexBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		colorBindParamDesc.parameter = m_colorTexBindParam;
+		colorBindParamDesc.constantSize = 0;
+		colorBindParamDesc.relativeAccessFrequency = 0;
+		colorBindParamDesc.relativeChangeFrequency = 0;
+		colorBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc depthBindParamDesc;
+		m_depthTexBindParam = BindParameter(eBindParameterType::TEXTURE, 1);
+		depthBindParamDesc.parameter = m_depthTexBindParam;
+		depthBindParamDesc.constantSize = 0;
+		depthBindParamDesc.relativeAccessFrequency = 0;
+		depthBindParamDesc.relativeChangeFrequency = 0;
+		depthBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc velocityBindParamDesc;
+		m_velocityTexBindParam = BindParameter(eBindParameterType::TEXTURE, 2);
+		velocityBindParamDesc.parameter = m_velocityTexBindParam;
+		velocityBindParamDesc.constantSize = 0;
+		velocityBindParamDesc.relativeAccessFrequency = 0;
+		velocityBindParamDesc.relativeChangeFrequency = 0;
+		velocityBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc historyBindParamDesc;
+		m_historyTexBindParam = BindParameter(eBindParameterType::TEXTURE, 3);
+		historyBindParamDesc.parameter = m_historyTexBindParam;
+		historyBindParamDesc.constantSize = 0;
+		historyBindParamDesc.relativeAccessFrequency = 0;
+		historyBindParamDesc.relativeChangeFrequency = 0;
+		historyBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc outputBindParamDesc;
+		m_outputBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		outputBindParamDesc.parameter = m_outputBindParam;
+		outputBindParamDesc.constantSize = 0;
+		outputBindParamDesc.relativeAccessFrequency = 0;
+		outputBindParamDesc.relativeChangeFrequency = 0;
+		outputBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		// The reprojected history falls between its pixels.
+		gxapi::StaticSamplerDesc samplerDesc;
+		samplerDesc.shaderRegister = 0;
+		samplerDesc.filter = gxapi::eTextureFilterMode::MIN_MAG_MIP_LINEAR;
+		samplerDesc.addressU = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.addressV = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.addressW = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.mipLevelBias = 0.f;
+		samplerDesc.registerSpace = 0;
+		samplerDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc, colorBindParamDesc, depthBindParamDesc, velocityBindParamDesc, historyBindParamDesc, outputBindParamDesc }, { samplerDesc });
+	}
+
+	if (!m_CSO) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_shader = context.CreateShader("TemporalAA", shaderParts, "");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_binder.GetRootSignature();
+		csoDesc.cs = m_shader.cs;
+
+		m_CSO.reset(context.CreatePSO(csoDesc));
+	}
+
+	this->GetOutput<0>().Set(m_historyUav[m_current].GetResource());
+}
+
+
+void TemporalAA::Execute(RenderContext& context) {
+	ComputeCommandList& commandList = context.AsCompute();
+
+	// The history is kept without the jitter, it's removed from the samples instead.
+	Mat44 projection = m_camera->GetProjectionMatrix();
+	Vec2 jitter = { 0.0f, 0.0f };
+	if (auto perspectiveCamera = dynamic_cast<const PerspectiveCamera*>(m_camera)) {
+		projection = perspectiveCamera->GetUnjitteredProjectionMatrix();
+		jitter = perspectiveCamera->GetJitter();
+	}
+
+	const float inputWidth = (float)m_colorTexSrv.GetResource().GetWidth();
+	const float inputHeight = (float)m_colorTexSrv.GetResource().GetHeight();
+	const Texture2D& output = m_historyUav[m_current].GetResource();
+	const unsigned outputWidth = (unsigned)output.GetWidth();
+	const unsigned outputHeight = output.GetHeight();
+
+	Uniforms uniformsCBData;
+	uniformsCBData.invVP = (m_camera->GetViewMatrix() * projection).Inverse();
+	uniformsCBData.prevVP = m_camera->GetPrevViewMatrix() * projection;
+	uniformsCBData.inputSize = Vec4(inputWidth, inputHeight, 1.0f / inputWidth, 1.0f / inputHeight);
+	uniformsCBData.outputSize = Vec4((float)outputWidth, (float)outputHeight, 1.0f / outputWidth, 1.0f / outputHeight);
+	uniformsCBData.jitter = Vec2(jitter.x * inputWidth * 0.5f, -jitter.y * inputHeight * 0.5f);
+	uniformsCBData.blendFactor = BlendFactor;
+	uniformsCBData.velocityScale = VelocityScale;
+	uniformsCBData.historyValid = m_historyValid ? 1 : 0;
+	m_historyValid = true;
+
+	const unsigned previous = m_current ^ 1;
+	commandList.SetResourceState(m_colorTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_depthTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_velocityTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_historySrv[previous].GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_historyUav[m_current].GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+
+	commandList.SetPipelineState(m_CSO.get());
+	commandList.SetComputeBinder(&m_binder);
+	commandList.BindCompute(m_colorTexBindParam, m_colorTexSrv);
+	commandList.BindCompute(m_depthTexBindParam, m_depthTexSrv);
+	commandList.BindCompute(m_velocityTexBindParam, m_velocityTexSrv);
+	commandList.BindCompute(m_historyTexBindParam, m_historySrv[previous]);
+	commandList.BindCompute(m_outputBindParam, m_historyUav[m_current]);
+	commandList.BindCompute(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
+	commandList.Dispatch((outputWidth + GroupSize - 1) / GroupSize, (outputHeight + GroupSize - 1) / GroupSize, 1);
+	commandList.UAVBarrier(m_historyUav[m_current].GetResource());
+}
+
+
+void TemporalAA::InitRenderTargets(SetupContext& context, uint64_t width, uint32_t height) {
+	gxapi::UavTexture2DArray uavDesc;
+	uavDesc.activeArraySize = 1;
+	uavDesc.firstArrayElement = 0;
+	uavDesc.mipLevel = 0;
+	uavDesc.planeIndex = 0;
+
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.numMipLevels = 1;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.planeIndex = 0;
+
+	// The history has to outlive the frame, it can't come from the transient pool.
+	for (int c = 0; c < 2; ++c) {
+		Texture2D historyTex = context.CreateTexture2D({ width, height, HistoryFormat }, { true, false, false, true });
+		historyTex.SetName((std::string("Temporal AA history ") + std::to_string(c)).c_str());
+		m_historyUav[c] = context.CreateUav(historyTex, HistoryFormat, uavDesc);
+		m_historySrv[c] = context.CreateSrv(historyTex, HistoryFormat, srvDesc);
+	}
+	m_historyValid = false;
+}
+
+
+} // namespace inl::gxeng::nodes
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <GraphicsApi_LL/IPipelineState.hpp>
+#include <GraphicsEngine_LL/BasicCamera.hpp>
+#include <GraphicsEngine_LL/GraphicsNode.hpp>
+
+namespace inl::gxeng::nodes {
+
+
+/// <summary> Temporal anti-aliasing, optionally upscaling the render resolution to the output resolution. </summary>
+/// <remarks>
+/// The scene has to be rendered with the jittered projection of the camera, see <see cref="GraphicsEngine::SetTemporalJitter"/>.
+/// The jittered samples of the frames are accumulated into a history at the output resolution.
+/// The history is reprojected by the velocity of the forward render where it holds a motion, and by the depth
+/// and the previous camera elsewhere, then clamped to the neighborhood of the current samples so that stale
+/// colors don't ghost. When upscaling, a sample weighs in by its distance from the output pixel,
+/// each output pixel gets a close sample every few frames of the jitter sequence.
+/// Inputs: color, depth, velocity and normal texture, camera, output width, output height.
+/// The output size is that of the color if left 0.
+/// </remarks>
+class TemporalAA : virtual public GraphicsNode,
+				   virtual public GraphicsTask,
+				   virtual public InputPortConfig<Texture2D, Texture2D, Texture2D, const BasicCamera*, unsigned, unsigned>,
+				   virtual public OutputPortConfig<Texture2D> {
+public:
+	static const char* Info_GetName() { return "TemporalAA"; }
+	const std::string& GetInputName(size_t index) const override;
+	const std::string& GetOutputName(size_t index) const override;
+	TemporalAA();
+
+	void Update() override {}
+	void Notify(InputPortBase* sender) override {}
+
+	void Initialize(EngineContext& context) override;
+	void Reset() override;
+	void Setup(SetupContext& context) override;
+	void Execute(RenderContext& context) override;
+
+protected:
+	Binder m_binder;
+	BindParameter m_uniformsBindParam;
+	BindParameter m_colorTexBindParam;
+	BindParameter m_depthTexBindParam;
+	BindParameter m_velocityTexBindParam;
+	BindParameter m_historyTexBindParam;
+	BindParameter m_outputBindParam;
+	ShaderProgram m_shader;
+	std::unique_ptr<gxapi::IPipelineState> m_CSO;
+
+protected: // outputs
+	// The result of a frame is the history of the next one.
+	RWTextureView2D m_historyUav[2];
+	TextureView2D m_historySrv[2];
+	unsigned m_current = 0;
+
+protected: // render context
+	TextureView2D m_colorTexSrv;
+	TextureView2D m_depthTexSrv;
+	TextureView2D m_velocityTexSrv;
+	const BasicCamera* m_camera = nullptr;
+	const BasicCamera* m_prevCamera = nullptr;
+	bool m_historyValid = false;
+
+	static constexpr float BlendFactor = 0.1f; // Weight of a current sample that falls on the output pixel.
+	static constexpr gxapi::eFormat HistoryFormat = gxapi::eFormat::R16G16B16A16_FLOAT;
+
+private:
+	void InitRenderTargets(SetupContext& context, uint64_t width, uint32_t height);
+};
+
+
+} // namespace inl::gxeng::nodes
@@ -18,10 +18,21 @@ struct Uniforms {
 };
 
 
+static constexpr int TileSize = 20; // Same as DOFTileMax.
+static constexpr unsigned FusedTilesPerGroup = 8; // Must match DOFPrepareFused.hlsl.
+
+
+struct FusedUniforms {
+	int32_t tileSize;
+	int32_t tileCountX, tileCountY;
+};
+
+
 DOFPrepare::DOFPrepare() {
 	this->GetInput<0>().Set({});
 	this->GetInput<1>().Set({});
 	this->GetInput<2>().Set({});
+	this->GetInput<3>().Set(false);
 }
 
 
@@ -43,7 +54,8 @@ const std::string& DOFPrepare::GetInputName(size_t index) const {
 	static const std::vector<std::string> names = {
 		"colorTex",
 		"depthTex",
-		"camera"
+		"camera",
+		"fused"
 	};
 	return names[index];
 }
@@ -51,7 +63,9 @@ const std::string& DOFPrepare::GetInputName(size_t index) const {
 const std::string& DOFPrepare::GetOutputName(size_t index) const {
 	static const std::vector<std::string> names = {
 		"dofPrepareTex",
-		"depthTex"
+		"depthTex",
+		"tileMaxTex",
+		"neighborMaxTex"
 	};
 	return names[index];
 }
@@ -75,6 +89,16 @@ void DOFPrepare::Setup(SetupContext& context) {
 
 	m_camera = this->GetInput<2>().Get();
 
+	m_fused = this->GetInput<3>().Get();
+	if (m_fused) {
+		InitFused(context);
+		this->GetOutput<0>().Set(m_fusedPrepareUav.GetResource());
+		this->GetOutput<1>().Set(m_fusedDepthUav.GetResource());
+		this->GetOutput<2>().Set(m_fusedTileMaxUav.GetResource());
+		this->GetOutput<3>().Set(m_fusedNeighborMaxUav.GetResource());
+		return;
+	}
+
 	if (!m_binder) {
 		BindParameterDesc uniformsBindParamDesc;
 		m_uniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
@@ -176,10 +200,17 @@ void DOFPrepare::Setup(SetupContext& context) {
 
 	this->GetOutput<0>().Set(m_prepareRTV.GetResource());
 	this->GetOutput<1>().Set(m_depthRTV.GetResource());
+	this->GetOutput<2>().Set({});
+	this->GetOutput<3>().Set({});
 }
 
 
 void DOFPrepare::Execute(RenderContext& context) {
+	if (m_fused) {
+		ExecuteFused(context);
+		return;
+	}
+
 	GraphicsCommandList& commandList = context.AsGraphics();
 
 	Uniforms uniformsCBData;
@@ -275,4 +306,183 @@ void DOFPrepare::InitRenderTarget(SetupContext& context) {
 }
 
 
+void DOFPrepare::InitFused(SetupContext& context) {
+	if (!m_fusedBinder) {
+		BindParameterDesc uniformsBindParamDesc;
+		m_fusedUniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
+		uniformsBindParamDesc.parameter = m_fusedUniformsBindParam;
+		uniformsBindParamDesc.constantSize = sizeof(FusedUniforms);
+		uniformsBindParamDesc.relativeAccessFrequency = 0;
+		uniformsBindParamDesc.relativeChangeFrequency = 0;
+		uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc sampBindParamDesc;
+		sampBindParamDesc.parameter = BindParameter(eBindParameterType::SAMPLER, 0);
+		sampBindParamDesc.constantSize = 0;
+		sampBindParamDesc.relativeAccessFrequency = 0;
+		sampBindParamDesc.relativeChangeFrequency = 0;
+		sampBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc inputBindParamDesc;
+		m_fusedInputTexBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		inputBindParamDesc.parameter = m_fusedInputTexBindParam;
+		inputBindParamDesc.constantSize = 0;
+		inputBindParamDesc.relativeAccessFrequency = 0;
+		inputBindParamDesc.relativeChangeFrequency = 0;
+		inputBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc depthBindParamDesc;
+		m_fusedDepthTexBindParam = BindParameter(eBindParameterType::TEXTURE, 1);
+		depthBindParamDesc.parameter = m_fusedDepthTexBindParam;
+		depthBindParamDesc.constantSize = 0;
+		depthBindParamDesc.relativeAccessFrequency = 0;
+		depthBindParamDesc.relativeChangeFrequency = 0;
+		depthBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc prepareBindParamDesc;
+		m_fusedPrepareBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		prepareBindParamDesc.parameter = m_fusedPrepareBindParam;
+		prepareBindParamDesc.constantSize = 0;
+		prepareBindParamDesc.relativeAccessFrequency = 0;
+		prepareBindParamDesc.relativeChangeFrequency = 0;
+		prepareBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc prepareDepthBindParamDesc;
+		m_fusedDepthBindParam = BindParameter(eBindParameterType::UNORDERED, 1);
+		prepareDepthBindParamDesc.parameter = m_fusedDepthBindParam;
+		prepareDepthBindParamDesc.constantSize = 0;
+		prepareDepthBindParamDesc.relativeAccessFrequency = 0;
+		prepareDepthBindParamDesc.relativeChangeFrequency = 0;
+		prepareDepthBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc tileMaxBindParamDesc;
+		m_fusedTileMaxBindParam = BindParameter(eBindParameterType::UNORDERED, 2);
+		tileMaxBindParamDesc.parameter = m_fusedTileMaxBindParam;
+		tileMaxBindParamDesc.constantSize = 0;
+		tileMaxBindParamDesc.relativeAccessFrequency = 0;
+		tileMaxBindParamDesc.relativeChangeFrequency = 0;
+		tileMaxBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc neighborMaxBindParamDesc;
+		m_fusedNeighborMaxBindParam = BindParameter(eBindParameterType::UNORDERED, 3);
+		neighborMaxBindParamDesc.parameter = m_fusedNeighborMaxBindParam;
+		neighborMaxBindParamDesc.constantSize = 0;
+		neighborMaxBindParamDesc.relativeAccessFrequency = 0;
+		neighborMaxBindParamDesc.relativeChangeFrequency = 0;
+		neighborMaxBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		gxapi::StaticSamplerDesc samplerDesc;
+		samplerDesc.shaderRegister = 0;
+		samplerDesc.filter = gxapi::eTextureFilterMode::MIN_MAG_MIP_POINT;
+		samplerDesc.addressU = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.addressV = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.addressW = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.mipLevelBias = 0.f;
+		samplerDesc.registerSpace = 0;
+		samplerDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		m_fusedBinder = context.CreateBinder({ uniformsBindParamDesc,
+											   sampBindParamDesc,
+											   inputBindParamDesc,
+											   depthBindParamDesc,
+											   prepareBindParamDesc,
+											   prepareDepthBindParamDesc,
+											   tileMaxBindParamDesc,
+											   neighborMaxBindParamDesc },
+											 { samplerDesc });
+	}
+
+	if (!m_fusedCSO) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_fusedShader = context.CreateShader("DOFPrepareFused", shaderParts, "");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_fusedBinder.GetRootSignature();
+		csoDesc.cs = m_fusedShader.cs;
+
+		m_fusedCSO.reset(context.CreatePSO(csoDesc));
+	}
+
+	if (!m_fusedTexturesInited) {
+		m_fusedTexturesInited = true;
+
+		using gxapi::eFormat;
+
+		auto format = eFormat::R16G16B16A16_FLOAT;
+		auto depthFormat = eFormat::R32_FLOAT;
+		auto formatTileMax = eFormat::R16G16_FLOAT;
+
+		gxapi::UavTexture2DArray uavDesc;
+		uavDesc.activeArraySize = 1;
+		uavDesc.firstArrayElement = 0;
+		uavDesc.mipLevel = 0;
+		uavDesc.planeIndex = 0;
+
+		Texture2DDesc desc{
+			m_inputTexSrv.GetResource().GetWidth(),
+			m_inputTexSrv.GetResource().GetHeight(),
+			format
+		};
+
+		Texture2D prepareTex = context.CreateTexture2D(desc, { true, false, false, true });
+		prepareTex.SetName("DOF prepare tex");
+		m_fusedPrepareUav = context.CreateUav(prepareTex, format, uavDesc);
+
+		desc.format = depthFormat;
+		Texture2D depthTex = context.CreateTexture2D(desc, { true, false, false, true });
+		depthTex.SetName("DOF depth tex");
+		m_fusedDepthUav = context.CreateUav(depthTex, depthFormat, uavDesc);
+
+		desc.width = m_inputTexSrv.GetResource().GetWidth() / TileSize;
+		desc.height = m_inputTexSrv.GetResource().GetHeight() / TileSize;
+		desc.format = formatTileMax;
+		Texture2D tilemaxTex = context.CreateTexture2D(desc, { true, false, false, true });
+		tilemaxTex.SetName("DOF tilemax tex");
+		m_fusedTileMaxUav = context.CreateUav(tilemaxTex, formatTileMax, uavDesc);
+
+		Texture2D neighbormaxTex = context.CreateTexture2D(desc, { true, false, false, true });
+		neighbormaxTex.SetName("DOF neighbormax tex");
+		m_fusedNeighborMaxUav = context.CreateUav(neighbormaxTex, formatTileMax, uavDesc);
+	}
+}
+
+
+void DOFPrepare::ExecuteFused(RenderContext& context) {
+	ComputeCommandList& commandList = context.AsCompute();
+
+	const Texture2D& prepareTex = m_fusedPrepareUav.GetResource();
+	const Texture2D& tileMaxTex = m_fusedTileMaxUav.GetResource();
+
+	FusedUniforms uniformsCBData;
+	uniformsCBData.tileSize = TileSize;
+	uniformsCBData.tileCountX = (int32_t)tileMaxTex.GetWidth();
+	uniformsCBData.tileCountY = (int32_t)tileMaxTex.GetHeight();
+
+	commandList.SetResourceState(m_fusedPrepareUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_fusedDepthUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_fusedTileMaxUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_fusedNeighborMaxUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_inputTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_depthTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+
+	commandList.SetPipelineState(m_fusedCSO.get());
+	commandList.SetComputeBinder(&m_fusedBinder);
+	commandList.BindCompute(m_fusedUniformsBindParam, &uniformsCBData, sizeof(uniformsCBData));
+	commandList.BindCompute(m_fusedInputTexBindParam, m_inputTexSrv);
+	commandList.BindCompute(m_fusedDepthTexBindParam, m_depthTexSrv);
+	commandList.BindCompute(m_fusedPrepareBindParam, m_fusedPrepareUav);
+	commandList.BindCompute(m_fusedDepthBindParam, m_fusedDepthUav);
+	commandList.BindCompute(m_fusedTileMaxBindParam, m_fusedTileMaxUav);
+	commandList.BindCompute(m_fusedNeighborMaxBindParam, m_fusedNeighborMaxUav);
+
+	// Each group covers a block of tiles, the groups also cover the pixels right and below the last tiles.
+	const unsigned groupPixels = FusedTilesPerGroup * TileSize;
+	unsigned numGroupsX = ((unsigned)prepareTex.GetWidth() + groupPixels - 1) / groupPixels;
+	unsigned numGroupsY = (prepareTex.GetHeight() + groupPixels - 1) / groupPixels;
+	commandList.Dispatch(numGroupsX, numGroupsY, 1);
+}
+
+
 } // namespace inl::gxeng::nodes
@@ -7,10 +7,18 @@
 namespace inl::gxeng::nodes {
 
 
+/// <summary>
+/// Inputs: color texture, depth texture, camera, fused
+/// Outputs: color and coc, depth, max coc and closest depth of each tile and of the tile neighborhood if fused
+/// </summary>
+/// <remarks>
+/// When fused, a single compute pass also does the work of <see cref="DOFTileMax"/> and <see cref="DOFNeighborMax"/>,
+/// each group reduces a ring of extra tiles into group memory to compare them with their neighbors.
+/// </remarks>
 class DOFPrepare : virtual public GraphicsNode,
 				   virtual public GraphicsTask,
-				   virtual public InputPortConfig<Texture2D, Texture2D, const BasicCamera*>,
-				   virtual public OutputPortConfig<Texture2D, Texture2D> {
+				   virtual public InputPortConfig<Texture2D, Texture2D, const BasicCamera*, bool>,
+				   virtual public OutputPortConfig<Texture2D, Texture2D, Texture2D, Texture2D> {
 public:
 	static const char* Info_GetName() { return "DOSPrepare"; }
 	const std::string& GetInputName(size_t index) const override;
@@ -33,18 +41,37 @@ protected:
 	ShaderProgram m_shader;
 	std::unique_ptr<gxapi::IPipelineState> m_PSO;
 
+	Binder m_fusedBinder;
+	BindParameter m_fusedUniformsBindParam;
+	BindParameter m_fusedInputTexBindParam;
+	BindParameter m_fusedDepthTexBindParam;
+	BindParameter m_fusedPrepareBindParam;
+	BindParameter m_fusedDepthBindParam;
+	BindParameter m_fusedTileMaxBindParam;
+	BindParameter m_fusedNeighborMaxBindParam;
+	ShaderProgram m_fusedShader;
+	std::unique_ptr<gxapi::IPipelineState> m_fusedCSO;
+
 protected: // outputs
 	bool m_outputTexturesInited = false;
 	RenderTargetView2D m_prepareRTV;
 	RenderTargetView2D m_depthRTV;
+	bool m_fusedTexturesInited = false;
+	RWTextureView2D m_fusedPrepareUav;
+	RWTextureView2D m_fusedDepthUav;
+	RWTextureView2D m_fusedTileMaxUav;
+	RWTextureView2D m_fusedNeighborMaxUav;
 
 protected: // render context
 	TextureView2D m_inputTexSrv;
 	TextureView2D m_depthTexSrv;
 	const BasicCamera* m_camera;
+	bool m_fused = false;
 
 private:
 	void InitRenderTarget(SetupContext& context);
+	void InitFused(SetupContext& context);
+	void ExecuteFused(RenderContext& context);
 };
 
 
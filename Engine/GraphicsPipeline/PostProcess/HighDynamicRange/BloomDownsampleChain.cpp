@@ -0,0 +1,177 @@
+#include "BloomDownsampleChain.hpp"
+
+#include <GraphicsEngine_LL/Nodes/NodeUtility.hpp>
+#include <GraphicsEngine_LL/GraphicsCommandList.hpp>
+#include <GraphicsEngine_LL/AutoRegisterNode.hpp>
+
+
+namespace inl::gxeng::nodes {
+
+INL_REGISTER_GRAPHICS_NODE(BloomDownsampleChain)
+
+
+// Texels of the first level one group covers, must match BloomDownsampleChain.hlsl.
+static constexpr unsigned GroupTileSize = 32;
+
+
+BloomDownsampleChain::BloomDownsampleChain() {
+	this->GetInput<0>().Set({});
+}
+
+
+void BloomDownsampleChain::Initialize(EngineContext& context) {
+	GraphicsNode::SetTaskSingle(this);
+}
+
+void BloomDownsampleChain::Reset() {
+	m_inputTexSrv = TextureView2D();
+
+	GetInput<0>().Clear();
+}
+
+const std::string& BloomDownsampleChain::GetInputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"colorTex"
+	};
+	return names[index];
+}
+
+const std::string& BloomDownsampleChain::GetOutputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"downsample2",
+		"downsample4",
+		"downsample8",
+		"downsample16",
+		"downsample32"
+	};
+	return names[index];
+}
+
+void BloomDownsampleChain::Setup(SetupContext& context) {
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.numMipLevels = 1;
+	srvDesc.planeIndex = 0;
+
+	Texture2D inputTex = this->GetInput<0>().Get();
+	m_inputTexSrv = context.CreateSrv(inputTex, inputTex.GetFormat(), srvDesc);
+
+	InitRenderTarget(context);
+
+	if (!m_binder) {
+		BindParameterDesc sampBindParamDesc;
+		sampBindParamDesc.parameter = BindParameter(eBindParameterType::SAMPLER, 0);
+		sampBindParamDesc.constantSize = 0;
+		sampBindParamDesc.relativeAccessFrequency = 0;
+		sampBindParamDesc.relativeChangeFrequency = 0;
+		sampBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc inputBindParamDesc;
+		m_inputTexBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		inputBindParamDesc.parameter = m_inputTexBindParam;
+		inputBindParamDesc.constantSize = 0;
+		inputBindParamDesc.relativeAccessFrequency = 0;
+		inputBindParamDesc.relativeChangeFrequency = 0;
+		inputBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		std::vector<BindParameterDesc> bindParamDescs = { sampBindParamDesc, inputBindParamDesc };
+		for (unsigned level = 0; level < NumLevels; ++level) {
+			BindParameterDesc outputBindParamDesc = inputBindParamDesc;
+			m_outputBindParams[level] = BindParameter(eBindParameterType::UNORDERED, level);
+			outputBindParamDesc.parameter = m_outputBindParams[level];
+			bindParamDescs.push_back(outputBindParamDesc);
+		}
+
+		gxapi::StaticSamplerDesc samplerDesc;
+		samplerDesc.shaderRegister = 0;
+		samplerDesc.filter = gxapi::eTextureFilterMode::MIN_MAG_MIP_LINEAR;
+		samplerDesc.addressU = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.addressV = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.addressW = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.mipLevelBias = 0.f;
+		samplerDesc.registerSpace = 0;
+		samplerDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		m_binder = context.CreateBinder(bindParamDescs, { samplerDesc });
+	}
+
+	if (!m_CSO) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_shader = context.CreateShader("BloomDownsampleChain", shaderParts, "");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_binder.GetRootSignature();
+		csoDesc.cs = m_shader.cs;
+
+		m_CSO.reset(context.CreatePSO(csoDesc));
+	}
+
+	this->GetOutput<0>().Set(m_downsampleUavs[0].GetResource());
+	this->GetOutput<1>().Set(m_downsampleUavs[1].GetResource());
+	this->GetOutput<2>().Set(m_downsampleUavs[2].GetResource());
+	this->GetOutput<3>().Set(m_downsampleUavs[3].GetResource());
+	this->GetOutput<4>().Set(m_downsampleUavs[4].GetResource());
+}
+
+
+void BloomDownsampleChain::Execute(RenderContext& context) {
+	ComputeCommandList& commandList = context.AsCompute();
+
+	for (auto& uav : m_downsampleUavs) {
+		commandList.SetResourceState(uav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+	}
+	commandList.SetResourceState(m_inputTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+
+	commandList.SetPipelineState(m_CSO.get());
+	commandList.SetComputeBinder(&m_binder);
+	commandList.BindCompute(m_inputTexBindParam, m_inputTexSrv);
+	for (unsigned level = 0; level < NumLevels; ++level) {
+		commandList.BindCompute(m_outputBindParams[level], m_downsampleUavs[level]);
+	}
+
+	const Texture2D& firstLevel = m_downsampleUavs[0].GetResource();
+	unsigned numGroupsX = unsigned((firstLevel.GetWidth() + GroupTileSize - 1) / GroupTileSize);
+	unsigned numGroupsY = (firstLevel.GetHeight() + GroupTileSize - 1) / GroupTileSize;
+	commandList.Dispatch(numGroupsX, numGroupsY, 1);
+}
+
+
+void BloomDownsampleChain::InitRenderTarget(SetupContext& context) {
+	if (!m_outputTexturesInited) {
+		m_outputTexturesInited = true;
+
+		using gxapi::eFormat;
+
+		auto formatDownsample = eFormat::R16G16B16A16_FLOAT;
+
+		gxapi::UavTexture2DArray uavDesc;
+		uavDesc.activeArraySize = 1;
+		uavDesc.firstArrayElement = 0;
+		uavDesc.mipLevel = 0;
+		uavDesc.planeIndex = 0;
+
+		Texture2DDesc desc{
+			m_inputTexSrv.GetResource().GetWidth(),
+			m_inputTexSrv.GetResource().GetHeight(),
+			formatDownsample
+		};
+
+		// Same sizes as the chain of downsample passes.
+		for (unsigned level = 0; level < NumLevels; ++level) {
+			desc.width = std::max<uint64_t>(desc.width / 2, 1);
+			desc.height = std::max<uint32_t>(desc.height / 2, 1);
+
+			Texture2D downsampleTex = context.CreateTexture2D(desc, { true, false, false, true });
+			downsampleTex.SetName("Bloom Downsample chain tex");
+			m_downsampleUavs[level] = context.CreateUav(downsampleTex, formatDownsample, uavDesc);
+		}
+	}
+}
+
+
+} // namespace inl::gxeng::nodes
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <GraphicsApi_LL/IPipelineState.hpp>
+#include <GraphicsEngine_LL/GraphicsNode.hpp>
+
+#include <array>
+
+namespace inl::gxeng::nodes {
+
+
+/// <summary>
+/// Inputs: HDR color texture
+/// Outputs: half, quarter, 1/8, 1/16 and 1/32 size textures
+/// </summary>
+/// <remarks>
+/// Makes the same textures as a chain of <see cref="BloomDownsample"/> nodes, but in a single compute dispatch:
+/// every group reduces a 64x64 block of the input through all levels in group memory.
+/// </remarks>
+class BloomDownsampleChain : virtual public GraphicsNode,
+							 virtual public GraphicsTask,
+							 virtual public InputPortConfig<Texture2D>,
+							 virtual public OutputPortConfig<Texture2D, Texture2D, Texture2D, Texture2D, Texture2D> {
+public:
+	static constexpr unsigned NumLevels = 5;
+
+public:
+	static const char* Info_GetName() { return "BloomDownsampleChain"; }
+	const std::string& GetInputName(size_t index) const override;
+	const std::string& GetOutputName(size_t index) const override;
+	BloomDownsampleChain();
+
+	void Update() override {}
+	void Notify(InputPortBase* sender) override {}
+
+	void Initialize(EngineContext& context) override;
+	void Reset() override;
+	void Setup(SetupContext& context) override;
+	void Execute(RenderContext& context) override;
+
+protected:
+	Binder m_binder;
+	BindParameter m_inputTexBindParam;
+	std::array<BindParameter, NumLevels> m_outputBindParams;
+	ShaderProgram m_shader;
+	std::unique_ptr<gxapi::IPipelineState> m_CSO;
+
+protected: // outputs
+	bool m_outputTexturesInited = false;
+	std::array<RWTextureView2D, NumLevels> m_downsampleUavs;
+
+protected: // render context
+	TextureView2D m_inputTexSrv;
+
+private:
+	void InitRenderTarget(SetupContext& context);
+};
+
+
+} // namespace inl::gxeng::nodes
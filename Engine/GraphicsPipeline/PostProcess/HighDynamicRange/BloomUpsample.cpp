@@ -0,0 +1,229 @@
+#include "BloomUpsample.hpp"
+
+#include <GraphicsEngine_LL/Nodes/NodeUtility.hpp>
+#include <GraphicsEngine_LL/GraphicsCommandList.hpp>
+#include <GraphicsEngine_LL/AutoRegisterNode.hpp>
+
+
+namespace inl::gxeng::nodes {
+
+INL_REGISTER_GRAPHICS_NODE(BloomUpsample)
+
+
+struct Uniforms {
+	float filterRadius;
+};
+
+
+// Must match BloomUpsample.hlsl.
+static constexpr unsigned GroupSize = 8;
+
+// Tent radius in texels of the smaller level, the 1-2-1 tent at this radius spreads as much as the 9 tap blur it replaces.
+static constexpr float FilterRadius = 2.0f;
+
+
+BloomUpsample::BloomUpsample() {
+	this->GetInput<0>().Set({});
+	this->GetInput<1>().Set({});
+	this->GetInput<2>().Set({});
+	this->GetInput<3>().Set({});
+	this->GetInput<4>().Set({});
+}
+
+
+void BloomUpsample::Initialize(EngineContext& context) {
+	GraphicsNode::SetTaskSingle(this);
+}
+
+void BloomUpsample::Reset() {
+	m_downsampleSrvs = {};
+
+	GetInput<0>().Clear();
+	GetInput<1>().Clear();
+	GetInput<2>().Clear();
+	GetInput<3>().Clear();
+	GetInput<4>().Clear();
+}
+
+const std::string& BloomUpsample::GetInputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"downsample2",
+		"downsample4",
+		"downsample8",
+		"downsample16",
+		"downsample32"
+	};
+	return names[index];
+}
+
+const std::string& BloomUpsample::GetOutputName(size_t index) const {
+	static const std::vector<std::string> names = {
+		"bloomTex"
+	};
+	return names[index];
+}
+
+void BloomUpsample::Setup(SetupContext& context) {
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.numMipLevels = 1;
+	srvDesc.planeIndex = 0;
+
+	const std::array<Texture2D, NumLevels> downsampleTextures = {
+		this->GetInput<0>().Get(),
+		this->GetInput<1>().Get(),
+		this->GetInput<2>().Get(),
+		this->GetInput<3>().Get(),
+		this->GetInput<4>().Get()
+	};
+	for (unsigned level = 0; level < NumLevels; ++level) {
+		m_downsampleSrvs[level] = context.CreateSrv(downsampleTextures[level], downsampleTextures[level].GetFormat(), srvDesc);
+	}
+
+	InitRenderTarget(context);
+
+	if (!m_binder) {
+		BindParameterDesc uniformsBindParamDesc;
+		m_uniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
+		uniformsBindParamDesc.parameter = m_uniformsBindParam;
+		uniformsBindParamDesc.constantSize = sizeof(Uniforms);
+		uniformsBindParamDesc.relativeAccessFrequency = 0;
+		uniformsBindParamDesc.relativeChangeFrequency = 0;
+		uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc sampBindParamDesc;
+		sampBindParamDesc.parameter = BindParameter(eBindParameterType::SAMPLER, 0);
+		sampBindParamDesc.constantSize = 0;
+		sampBindParamDesc.relativeAccessFrequency = 0;
+		sampBindParamDesc.relativeChangeFrequency = 0;
+		sampBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc input0BindParamDesc;
+		m_input0TexBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		input0BindParamDesc.parameter = m_input0TexBindParam;
+		input0BindParamDesc.constantSize = 0;
+		input0BindParamDesc.relativeAccessFrequency = 0;
+		input0BindParamDesc.relativeChangeFrequency = 0;
+		input0BindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc input1BindParamDesc;
+		m_input1TexBindParam = BindParameter(eBindParameterType::TEXTURE, 1);
+		input1BindParamDesc.parameter = m_input1TexBindParam;
+		input1BindParamDesc.constantSize = 0;
+		input1BindParamDesc.relativeAccessFrequency = 0;
+		input1BindParamDesc.relativeChangeFrequency = 0;
+		input1BindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc outputBindParamDesc;
+		m_outputBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		outputBindParamDesc.parameter = m_outputBindParam;
+		outputBindParamDesc.constantSize = 0;
+		outputBindParamDesc.relativeAccessFrequency = 0;
+		outputBindParamDesc.relativeChangeFrequency = 0;
+		outputBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		gxapi::StaticSamplerDesc samplerDesc;
+		samplerDesc.shaderRegister = 0;
+		samplerDesc.filter = gxapi::eTextureFilterMode::MIN_MAG_MIP_LINEAR;
+		samplerDesc.addressU = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.addressV = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.addressW = gxapi::eTextureAddressMode::CLAMP;
+		samplerDesc.mipLevelBias = 0.f;
+		samplerDesc.registerSpace = 0;
+		samplerDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc, input0BindParamDesc, input1BindParamDesc, outputBindParamDesc }, { samplerDesc });
+	}
+
+	if (!m_CSO) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_shader = context.CreateShader("BloomUpsample", shaderParts, "");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_binder.GetRootSignature();
+		csoDesc.cs = m_shader.cs;
+
+		m_CSO.reset(context.CreatePSO(csoDesc));
+	}
+
+	this->GetOutput<0>().Set(m_upsampleUavs[0].GetResource());
+}
+
+
+void BloomUpsample::Execute(RenderContext& context) {
+	ComputeCommandList& commandList = context.AsCompute();
+
+	Uniforms uniformsCBData;
+	uniformsCBData.filterRadius = FilterRadius;
+
+	for (auto& srv : m_downsampleSrvs) {
+		commandList.SetResourceState(srv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	}
+
+	commandList.SetPipelineState(m_CSO.get());
+	commandList.SetComputeBinder(&m_binder);
+	commandList.BindCompute(m_uniformsBindParam, &uniformsCBData, sizeof(uniformsCBData));
+
+	// From the smallest level up, the first one upsamples the last downsample level itself.
+	for (int level = NumLevels - 2; level >= 0; --level) {
+		const TextureView2D& smaller = level == NumLevels - 2 ? m_downsampleSrvs[level + 1] : m_upsampleSrvs[level + 1];
+		const RWTextureView2D& target = m_upsampleUavs[level];
+
+		commandList.SetResourceState(smaller.GetResource(), gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
+		commandList.SetResourceState(target.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+
+		commandList.BindCompute(m_input0TexBindParam, smaller);
+		commandList.BindCompute(m_input1TexBindParam, m_downsampleSrvs[level]);
+		commandList.BindCompute(m_outputBindParam, target);
+
+		unsigned numGroupsX = unsigned((target.GetResource().GetWidth() + GroupSize - 1) / GroupSize);
+		unsigned numGroupsY = (target.GetResource().GetHeight() + GroupSize - 1) / GroupSize;
+		commandList.Dispatch(numGroupsX, numGroupsY, 1);
+	}
+}
+
+
+void BloomUpsample::InitRenderTarget(SetupContext& context) {
+	if (!m_outputTexturesInited) {
+		m_outputTexturesInited = true;
+
+		using gxapi::eFormat;
+
+		auto formatUpsample = eFormat::R16G16B16A16_FLOAT;
+
+		gxapi::UavTexture2DArray uavDesc;
+		uavDesc.activeArraySize = 1;
+		uavDesc.firstArrayElement = 0;
+		uavDesc.mipLevel = 0;
+		uavDesc.planeIndex = 0;
+
+		gxapi::SrvTexture2DArray srvDesc;
+		srvDesc.activeArraySize = 1;
+		srvDesc.firstArrayElement = 0;
+		srvDesc.numMipLevels = -1;
+		srvDesc.mipLevelClamping = 0;
+		srvDesc.mostDetailedMip = 0;
+		srvDesc.planeIndex = 0;
+
+		for (unsigned level = 0; level < NumLevels - 1; ++level) {
+			Texture2DDesc desc{
+				m_downsampleSrvs[level].GetResource().GetWidth(),
+				m_downsampleSrvs[level].GetResource().GetHeight(),
+				formatUpsample
+			};
+
+			Texture2D upsampleTex = context.CreateTexture2D(desc, { true, false, false, true });
+			upsampleTex.SetName("Bloom Upsample tex");
+			m_upsampleUavs[level] = context.CreateUav(upsampleTex, formatUpsample, uavDesc);
+			m_upsampleSrvs[level] = context.CreateSrv(upsampleTex, formatUpsample, srvDesc);
+		}
+	}
+}
+
+
+} // namespace inl::gxeng::nodes
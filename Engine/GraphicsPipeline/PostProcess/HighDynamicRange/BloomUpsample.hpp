@@ -0,0 +1,62 @@
+#pragma once
+
+#include <GraphicsApi_LL/IPipelineState.hpp>
+#include <GraphicsEngine_LL/GraphicsNode.hpp>
+
+#include <array>
+
+namespace inl::gxeng::nodes {
+
+
+/// <summary>
+/// Inputs: half, quarter, 1/8, 1/16 and 1/32 size textures, see <see cref="BloomDownsampleChain"/>
+/// Outputs: half size bloom texture
+/// </summary>
+/// <remarks>
+/// Does the work of the <see cref="BloomBlur"/> and <see cref="BloomAdd"/> nodes of each level in a single compute pass:
+/// starting from the smallest, each level is upsampled with a tent filter and averaged with the next larger one.
+/// </remarks>
+class BloomUpsample : virtual public GraphicsNode,
+					  virtual public GraphicsTask,
+					  virtual public InputPortConfig<Texture2D, Texture2D, Texture2D, Texture2D, Texture2D>,
+					  virtual public OutputPortConfig<Texture2D> {
+public:
+	static constexpr unsigned NumLevels = 5;
+
+public:
+	static const char* Info_GetName() { return "BloomUpsample"; }
+	const std::string& GetInputName(size_t index) const override;
+	const std::string& GetOutputName(size_t index) const override;
+	BloomUpsample();
+
+	void Update() override {}
+	void Notify(InputPortBase* sender) override {}
+
+	void Initialize(EngineContext& context) override;
+	void Reset() override;
+	void Setup(SetupContext& context) override;
+	void Execute(RenderContext& context) override;
+
+protected:
+	Binder m_binder;
+	BindParameter m_input0TexBindParam;
+	BindParameter m_input1TexBindParam;
+	BindParameter m_outputBindParam;
+	BindParameter m_uniformsBindParam;
+	ShaderProgram m_shader;
+	std::unique_ptr<gxapi::IPipelineState> m_CSO;
+
+protected: // outputs
+	bool m_outputTexturesInited = false;
+	std::array<RWTextureView2D, NumLevels - 1> m_upsampleUavs; // Level i is the size of downsample level i.
+	std::array<TextureView2D, NumLevels - 1> m_upsampleSrvs;
+
+protected: // render context
+	std::array<TextureView2D, NumLevels> m_downsampleSrvs;
+
+private:
+	void InitRenderTarget(SetupContext& context);
+};
+
+
+} // namespace inl::gxeng::nodes
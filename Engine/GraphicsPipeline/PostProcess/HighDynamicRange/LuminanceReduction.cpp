@@ -137,13 +137,13 @@ void LuminanceReduction::Setup(SetupContext& context) {
 
 
 void LuminanceReduction::Execute(RenderContext& context) {
-	auto& commandList = context.AsCompute();
+	auto& commandList = context.AsAsyncCompute();
 
 	unsigned dispatchW, dispatchH;
 	setWorkgroupSize((unsigned)std::ceil(m_width * 0.5f), m_height, 16, 16, dispatchW, dispatchH);
 
 	commandList.SetResourceState(m_uav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
-	commandList.SetResourceState(m_luminanceView.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_luminanceView.GetResource(), gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
 
 	commandList.SetPipelineState(m_CSO.get());
 	commandList.SetComputeBinder(&m_binder);
@@ -17,8 +17,14 @@ struct Uniforms {
 };
 
 
+// Must match the SINGLE_PASS variant of LuminanceReductionFinal.hlsl.
+static constexpr unsigned SinglePassGroupWidth = 32;
+static constexpr unsigned SinglePassGroupHeight = 16;
+
+
 LuminanceReductionFinal::LuminanceReductionFinal() {
 	this->GetInput<0>().Set({});
+	this->GetInput<1>().Set(false);
 }
 
 
@@ -30,11 +36,13 @@ void LuminanceReductionFinal::Reset() {
 	m_reductionTexSrv = TextureView2D();
 
 	GetInput<0>().Clear();
+	GetInput<1>().Clear();
 }
 
 const std::string& LuminanceReductionFinal::GetInputName(size_t index) const {
 	static const std::vector<std::string> names = {
-		"reductionTex"
+		"reductionTex",
+		"singlePass"
 	};
 	return names[index];
 }
@@ -61,6 +69,8 @@ void LuminanceReductionFinal::Setup(SetupContext& context) {
 	srvDesc.planeIndex = 0;
 	m_reductionTexSrv = context.CreateSrv(reductionTex, reductionTex.GetFormat(), srvDesc);
 
+	m_singlePass = this->GetInput<1>().Get();
+
 
 	this->GetOutput<0>().Set(m_avgLumUav.GetResource());
 
@@ -106,7 +116,11 @@ void LuminanceReductionFinal::Setup(SetupContext& context) {
 		samplerDesc.registerSpace = 0;
 		samplerDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
 
-		m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc, reductionBindParamDesc, outputBindParamDesc0 }, { samplerDesc });
+		BindParameterDesc stateBindParamDesc = outputBindParamDesc0;
+		m_stateBindParam = BindParameter(eBindParameterType::UNORDERED, 1);
+		stateBindParamDesc.parameter = m_stateBindParam;
+
+		m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc, reductionBindParamDesc, outputBindParamDesc0, stateBindParamDesc }, { samplerDesc });
 	}
 
 	if (!m_CSO) {
@@ -123,11 +137,24 @@ void LuminanceReductionFinal::Setup(SetupContext& context) {
 
 		m_CSO.reset(context.CreatePSO(csoDesc));
 	}
+
+	if (m_singlePass && !m_singlePassCSO) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_singlePassShader = context.CreateShader("LuminanceReductionFinal", shaderParts, "SINGLE_PASS=1");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_binder.GetRootSignature();
+		csoDesc.cs = m_singlePassShader.cs;
+
+		m_singlePassCSO.reset(context.CreatePSO(csoDesc));
+	}
 }
 
 
 void LuminanceReductionFinal::Execute(RenderContext& context) {
-	ComputeCommandList& commandList = context.AsCompute();
+	ComputeCommandList& commandList = context.AsAsyncCompute();
 
 	Uniforms uniformsCBData;
 
@@ -143,15 +170,30 @@ void LuminanceReductionFinal::Execute(RenderContext& context) {
 	gxeng::ConstBufferView cbv = context.CreateCbv(cb, 0, sizeof(Uniforms));
 	*/
 
+	// The last group of the single pass finds itself by the finished group count.
+	const uint32_t initialState[2] = { 0, 0 };
+	commandList.SetResourceState(m_stateBuffer, gxapi::eResourceState::COPY_DEST);
+	context.Upload(m_stateBuffer, 0, initialState, sizeof(initialState));
+
 	commandList.SetResourceState(m_avgLumUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
-	commandList.SetResourceState(m_reductionTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_stateBuffer, gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_reductionTexSrv.GetResource(), gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
 
-	commandList.SetPipelineState(m_CSO.get());
+	commandList.SetPipelineState(m_singlePass ? m_singlePassCSO.get() : m_CSO.get());
 	commandList.SetComputeBinder(&m_binder);
 	commandList.BindCompute(m_reductionBindParam, m_reductionTexSrv);
 	commandList.BindCompute(m_outputBindParam0, m_avgLumUav);
+	commandList.BindCompute(m_stateBindParam, m_stateView);
 	commandList.BindCompute(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
-	commandList.Dispatch(1, 1, 1);
+	if (m_singlePass) {
+		const Texture2D& luminanceTex = m_reductionTexSrv.GetResource();
+		unsigned numGroupsX = unsigned((luminanceTex.GetWidth() + SinglePassGroupWidth - 1) / SinglePassGroupWidth);
+		unsigned numGroupsY = (luminanceTex.GetHeight() + SinglePassGroupHeight - 1) / SinglePassGroupHeight;
+		commandList.Dispatch(numGroupsX, numGroupsY, 1);
+	}
+	else {
+		commandList.Dispatch(1, 1, 1);
+	}
 	commandList.UAVBarrier(m_avgLumUav.GetResource());
 }
 
@@ -181,6 +223,17 @@ void LuminanceReductionFinal::InitRenderTarget(SetupContext& context) {
 		Texture2D avgLumTex = context.CreateTexture2D({ 1, 1, formatAvgLum }, { true, true, false, true });
 		avgLumTex.SetName("Luminance reduction final tex");
 		m_avgLumUav = context.CreateUav(avgLumTex, formatAvgLum, uavDesc);
+
+		m_stateBuffer = context.CreateBuffer(2 * sizeof(uint32_t), true);
+		m_stateBuffer.SetName("Luminance reduction state");
+
+		gxapi::UavBuffer stateDesc;
+		stateDesc.raw = false;
+		stateDesc.firstElement = 0;
+		stateDesc.numElements = 2;
+		stateDesc.elementStride = 0;
+		stateDesc.countOffset = 0;
+		m_stateView = context.CreateUav(m_stateBuffer, gxapi::eFormat::R32_UINT, stateDesc);
 	}
 }
 
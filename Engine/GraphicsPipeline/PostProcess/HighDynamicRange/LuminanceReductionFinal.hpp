@@ -6,9 +6,17 @@
 namespace inl::gxeng::nodes {
 
 
+/// <summary>
+/// Inputs: reduction texture or luminance texture, single pass
+/// Outputs: adapted average luminance
+/// </summary>
+/// <remarks>
+/// In single pass mode the input is the luminance texture itself and <see cref="LuminanceReduction"/> is not needed,
+/// the last group of the dispatch to finish computes the result from the atomically merged group results.
+/// </remarks>
 class LuminanceReductionFinal : virtual public GraphicsNode,
 								virtual public GraphicsTask,
-								virtual public InputPortConfig<Texture2D>,
+								virtual public InputPortConfig<Texture2D, bool>,
 								virtual public OutputPortConfig<Texture2D> {
 public:
 	static const char* Info_GetName() { return "LuminanceReductionFinal"; }
@@ -29,15 +37,21 @@ protected:
 	BindParameter m_reductionBindParam;
 	BindParameter m_outputBindParam0;
 	BindParameter m_uniformsBindParam;
+	BindParameter m_stateBindParam;
 	ShaderProgram m_shader;
 	std::unique_ptr<gxapi::IPipelineState> m_CSO;
+	ShaderProgram m_singlePassShader;
+	std::unique_ptr<gxapi::IPipelineState> m_singlePassCSO;
 
 protected: // outputs
 	bool m_outputTexturesInited = false;
 	RWTextureView2D m_avgLumUav;
+	LinearBuffer m_stateBuffer;
+	RWBufferView m_stateView;
 
 protected: // render context
 	TextureView2D m_reductionTexSrv;
+	bool m_singlePass = false;
 
 private:
 	void InitRenderTarget(SetupContext& context);
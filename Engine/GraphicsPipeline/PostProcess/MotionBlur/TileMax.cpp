@@ -17,8 +17,19 @@ struct Uniforms {
 };
 
 
+static constexpr int MaxMotionBlurRadius = 20;
+static constexpr unsigned FusedTilesPerGroup = 8; // Must match TileMaxFused.hlsl.
+
+
+struct FusedUniforms {
+	int32_t tileSize;
+	int32_t tileCountX, tileCountY;
+};
+
+
 TileMax::TileMax() {
 	this->GetInput<0>().Set({});
+	this->GetInput<1>().Set(false);
 }
 
 
@@ -34,14 +45,16 @@ void TileMax::Reset() {
 
 const std::string& TileMax::GetInputName(size_t index) const {
 	static const std::vector<std::string> names = {
-		"colorTex"
+		"colorTex",
+		"fused"
 	};
 	return names[index];
 }
 
 const std::string& TileMax::GetOutputName(size_t index) const {
 	static const std::vector<std::string> names = {
-		"tileMaxTex"
+		"tileMaxTex",
+		"neighborMaxTex"
 	};
 	return names[index];
 }
@@ -58,6 +71,13 @@ void TileMax::Setup(SetupContext& context) {
 	Texture2D inputTex = this->GetInput<0>().Get();
 	m_inputTexSrv = context.CreateSrv(inputTex, inputTex.GetFormat(), srvDesc);
 
+	m_fused = this->GetInput<1>().Get();
+	if (m_fused) {
+		InitFused(context);
+		this->GetOutput<0>().Set(m_fusedTileMaxUav.GetResource());
+		this->GetOutput<1>().Set(m_fusedNeighborMaxUav.GetResource());
+		return;
+	}
 
 	if (!m_binder) {
 		BindParameterDesc uniformsBindParamDesc;
@@ -131,10 +151,16 @@ void TileMax::Setup(SetupContext& context) {
 	}
 
 	this->GetOutput<0>().Set(m_tilemaxRtv.GetResource());
+	this->GetOutput<1>().Set({});
 }
 
 
 void TileMax::Execute(RenderContext& context) {
+	if (m_fused) {
+		ExecuteFused(context);
+		return;
+	}
+
 	GraphicsCommandList& commandList = context.AsGraphics();
 
 	Uniforms uniformsCBData;
@@ -188,7 +214,7 @@ void TileMax::InitRenderTarget(SetupContext& context) {
 
 		auto formatTileMax = eFormat::R8G8_UNORM;
 
-		const uint64_t maxMotionBlurRadius = 20;
+		const uint64_t maxMotionBlurRadius = MaxMotionBlurRadius;
 
 		gxapi::RtvTexture2DArray rtvDesc;
 		rtvDesc.activeArraySize = 1;
@@ -217,4 +243,112 @@ void TileMax::InitRenderTarget(SetupContext& context) {
 }
 
 
+void TileMax::InitFused(SetupContext& context) {
+	if (!m_fusedBinder) {
+		BindParameterDesc uniformsBindParamDesc;
+		m_fusedUniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
+		uniformsBindParamDesc.parameter = m_fusedUniformsBindParam;
+		uniformsBindParamDesc.constantSize = sizeof(FusedUniforms);
+		uniformsBindParamDesc.relativeAccessFrequency = 0;
+		uniformsBindParamDesc.relativeChangeFrequency = 0;
+		uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc inputBindParamDesc;
+		m_fusedInputTexBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		inputBindParamDesc.parameter = m_fusedInputTexBindParam;
+		inputBindParamDesc.constantSize = 0;
+		inputBindParamDesc.relativeAccessFrequency = 0;
+		inputBindParamDesc.relativeChangeFrequency = 0;
+		inputBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc tileMaxBindParamDesc;
+		m_fusedTileMaxBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		tileMaxBindParamDesc.parameter = m_fusedTileMaxBindParam;
+		tileMaxBindParamDesc.constantSize = 0;
+		tileMaxBindParamDesc.relativeAccessFrequency = 0;
+		tileMaxBindParamDesc.relativeChangeFrequency = 0;
+		tileMaxBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc neighborMaxBindParamDesc;
+		m_fusedNeighborMaxBindParam = BindParameter(eBindParameterType::UNORDERED, 1);
+		neighborMaxBindParamDesc.parameter = m_fusedNeighborMaxBindParam;
+		neighborMaxBindParamDesc.constantSize = 0;
+		neighborMaxBindParamDesc.relativeAccessFrequency = 0;
+		neighborMaxBindParamDesc.relativeChangeFrequency = 0;
+		neighborMaxBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		m_fusedBinder = context.CreateBinder({ uniformsBindParamDesc, inputBindParamDesc, tileMaxBindParamDesc, neighborMaxBindParamDesc }, {});
+	}
+
+	if (!m_fusedCSO) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_fusedShader = context.CreateShader("TileMaxFused", shaderParts, "");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_fusedBinder.GetRootSignature();
+		csoDesc.cs = m_fusedShader.cs;
+
+		m_fusedCSO.reset(context.CreatePSO(csoDesc));
+	}
+
+	if (!m_fusedTexturesInited) {
+		m_fusedTexturesInited = true;
+
+		using gxapi::eFormat;
+
+		auto formatTileMax = eFormat::R8G8_UNORM;
+
+		gxapi::UavTexture2DArray uavDesc;
+		uavDesc.activeArraySize = 1;
+		uavDesc.firstArrayElement = 0;
+		uavDesc.mipLevel = 0;
+		uavDesc.planeIndex = 0;
+
+		Texture2DDesc desc{
+			m_inputTexSrv.GetResource().GetWidth() / MaxMotionBlurRadius,
+			uint32_t(m_inputTexSrv.GetResource().GetHeight() / MaxMotionBlurRadius),
+			formatTileMax
+		};
+
+		Texture2D tilemaxTex = context.CreateTexture2D(desc, { true, false, false, true });
+		tilemaxTex.SetName("Motion blur tilemax tex");
+		m_fusedTileMaxUav = context.CreateUav(tilemaxTex, formatTileMax, uavDesc);
+
+		Texture2D neighbormaxTex = context.CreateTexture2D(desc, { true, false, false, true });
+		neighbormaxTex.SetName("Motion blur neighbormax tex");
+		m_fusedNeighborMaxUav = context.CreateUav(neighbormaxTex, formatTileMax, uavDesc);
+	}
+}
+
+
+void TileMax::ExecuteFused(RenderContext& context) {
+	ComputeCommandList& commandList = context.AsCompute();
+
+	const Texture2D& tileMaxTex = m_fusedTileMaxUav.GetResource();
+
+	FusedUniforms uniformsCBData;
+	uniformsCBData.tileSize = MaxMotionBlurRadius;
+	uniformsCBData.tileCountX = (int32_t)tileMaxTex.GetWidth();
+	uniformsCBData.tileCountY = (int32_t)tileMaxTex.GetHeight();
+
+	commandList.SetResourceState(m_fusedTileMaxUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_fusedNeighborMaxUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_inputTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+
+	commandList.SetPipelineState(m_fusedCSO.get());
+	commandList.SetComputeBinder(&m_fusedBinder);
+	commandList.BindCompute(m_fusedUniformsBindParam, &uniformsCBData, sizeof(uniformsCBData));
+	commandList.BindCompute(m_fusedInputTexBindParam, m_inputTexSrv);
+	commandList.BindCompute(m_fusedTileMaxBindParam, m_fusedTileMaxUav);
+	commandList.BindCompute(m_fusedNeighborMaxBindParam, m_fusedNeighborMaxUav);
+
+	// Each group writes a block of tiles.
+	unsigned numGroupsX = ((unsigned)tileMaxTex.GetWidth() + FusedTilesPerGroup - 1) / FusedTilesPerGroup;
+	unsigned numGroupsY = (tileMaxTex.GetHeight() + FusedTilesPerGroup - 1) / FusedTilesPerGroup;
+	commandList.Dispatch(numGroupsX, numGroupsY, 1);
+}
+
+
 } // namespace inl::gxeng::nodes
@@ -7,10 +7,18 @@
 namespace inl::gxeng::nodes {
 
 
+/// <summary>
+/// Inputs: motion vector texture, fused
+/// Outputs: max motion vector of each tile, max motion vector of the tile neighborhood if fused
+/// </summary>
+/// <remarks>
+/// When fused, a single compute pass also does the work of <see cref="NeighborMax"/>,
+/// each group reduces a ring of extra tiles into group memory to compare them with their neighbors.
+/// </remarks>
 class TileMax : virtual public GraphicsNode,
 				virtual public GraphicsTask,
-				virtual public InputPortConfig<Texture2D>,
-				virtual public OutputPortConfig<Texture2D> {
+				virtual public InputPortConfig<Texture2D, bool>,
+				virtual public OutputPortConfig<Texture2D, Texture2D> {
 public:
 	static const char* Info_GetName() { return "TileMax"; }
 	const std::string& GetInputName(size_t index) const override;
@@ -32,15 +40,29 @@ protected:
 	ShaderProgram m_shader;
 	std::unique_ptr<gxapi::IPipelineState> m_PSO;
 
+	Binder m_fusedBinder;
+	BindParameter m_fusedUniformsBindParam;
+	BindParameter m_fusedInputTexBindParam;
+	BindParameter m_fusedTileMaxBindParam;
+	BindParameter m_fusedNeighborMaxBindParam;
+	ShaderProgram m_fusedShader;
+	std::unique_ptr<gxapi::IPipelineState> m_fusedCSO;
+
 protected: // outputs
 	bool m_outputTexturesInited = false;
 	RenderTargetView2D m_tilemaxRtv;
+	bool m_fusedTexturesInited = false;
+	RWTextureView2D m_fusedTileMaxUav;
+	RWTextureView2D m_fusedNeighborMaxUav;
 
 protected: // render context
 	TextureView2D m_inputTexSrv;
+	bool m_fused = false;
 
 private:
 	void InitRenderTarget(SetupContext& context);
+	void InitFused(SetupContext& context);
+	void ExecuteFused(RenderContext& context);
 };
 
 
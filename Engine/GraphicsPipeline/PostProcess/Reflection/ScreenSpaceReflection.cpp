@@ -26,11 +26,13 @@ struct Uniforms {
 
 ScreenSpaceReflection::ScreenSpaceReflection() {
 	this->GetInput<0>().Set({});
+	this->GetInput<4>().Set(eResolutionScale::DEFAULT);
 }
 
 
 void ScreenSpaceReflection::Initialize(EngineContext& context) {
 	GraphicsNode::SetTaskSingle(this);
+	m_qualityPreset = context.GetQualityPreset();
 }
 
 void ScreenSpaceReflection::Reset() {
@@ -44,7 +46,8 @@ const std::string& ScreenSpaceReflection::GetInputName(size_t index) const {
 		"colorTex",
 		"depthTex",
 		"camera",
-		"velocityNormalTex"
+		"velocityNormalTex",
+		"resolution"
 	};
 	return names[index];
 }
@@ -237,6 +240,41 @@ void ScreenSpaceReflection::Setup(SetupContext& context) {
 		}
 	}
 
+	// Rays of a reduced resolution read the color from the mip of the same size, so there have to be enough mips.
+	unsigned divisor = ScaledResolution::GetDivisor(this->GetInput<4>().Get(), m_qualityPreset);
+	m_traceMip = 0;
+	while ((1u << m_traceMip) < divisor && m_traceMip + 1 < m_inputSrv.size()) {
+		++m_traceMip;
+	}
+	m_resolution.Setup(context, m_depthTexSrv, 1u << m_traceMip, m_ssrRtv.GetResource().GetFormat());
+
+	if (m_resolution.IsReduced()) {
+		gxapi::RtvTexture2DArray rtvDesc;
+		rtvDesc.activeArraySize = 1;
+		rtvDesc.firstArrayElement = 0;
+		rtvDesc.firstMipLevel = 0;
+		rtvDesc.planeIndex = 0;
+
+		gxapi::SrvTexture2DArray traceSrvDesc;
+		traceSrvDesc.activeArraySize = 1;
+		traceSrvDesc.firstArrayElement = 0;
+		traceSrvDesc.numMipLevels = -1;
+		traceSrvDesc.mipLevelClamping = 0;
+		traceSrvDesc.mostDetailedMip = 0;
+		traceSrvDesc.planeIndex = 0;
+
+		Texture2DDesc desc{
+			m_resolution.GetWidth(),
+			m_resolution.GetHeight(),
+			m_ssrRtv.GetResource().GetFormat()
+		};
+
+		// The reduced reflections are only used inside this node, they come from the transient pool each frame.
+		Texture2D traceTex = context.CreateTransientTexture2D(desc, { true, true, false, false });
+		m_traceRtv = context.CreateRtv(traceTex, desc.format, rtvDesc);
+		m_traceSrv = context.CreateSrv(traceTex, desc.format, traceSrvDesc);
+	}
+
 	this->GetOutput<0>().Set(m_ssrRtv.GetResource());
 }
 
@@ -278,8 +316,8 @@ void ScreenSpaceReflection::Execute(RenderContext& context) {
 		0.5, 0.5, 0, 1
 	};
 	Mat44 mulSS = {
-		m_inputTexSrv.GetResource().GetWidth(), 0, 0, 0,
-		0, m_inputTexSrv.GetResource().GetHeight(), 0, 0,
+		(float)m_resolution.GetWidth(), 0, 0, 0,
+		0, (float)m_resolution.GetHeight(), 0, 0,
 		0, 0, 1, 0,
 		0, 0, 0, 1
 	};
@@ -311,6 +349,8 @@ void ScreenSpaceReflection::Execute(RenderContext& context) {
 	uniformsCBData.farPlaneData0 = Vec4(ndcCorners[0].xyz, ndcCorners[1].x);
 	uniformsCBData.farPlaneData1 = Vec4(ndcCorners[1].y, ndcCorners[1].z, 0.0f, 0.0f);
 
+	m_resolution.DownsampleDepth(commandList);
+
 	{ //fill mip chain
 		unsigned numMips = m_ssrRtv.GetResource().GetNumMiplevels();
 
@@ -351,14 +391,18 @@ void ScreenSpaceReflection::Execute(RenderContext& context) {
 	}
 
 	{ //trace rays
-		commandList.SetResourceState(m_ssrRtv.GetResource(), gxapi::eResourceState::RENDER_TARGET);
-		commandList.SetResourceState(m_inputTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
-		commandList.SetResourceState(m_depthTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+		RenderTargetView2D& traceRtv = m_resolution.IsReduced() ? m_traceRtv : m_ssrRtv;
+		const TextureView2D& colorSrv = m_resolution.IsReduced() ? m_inputSrv[m_traceMip] : m_inputTexSrv;
+		const TextureView2D& depthSrv = m_resolution.GetDepth();
+
+		commandList.SetResourceState(traceRtv.GetResource(), gxapi::eResourceState::RENDER_TARGET);
+		commandList.SetResourceState(colorSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+		commandList.SetResourceState(depthSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
 
-		RenderTargetView2D* pRTV = &m_ssrRtv;
+		RenderTargetView2D* pRTV = &traceRtv;
 		commandList.SetRenderTargets(1, &pRTV, 0);
 
-		gxapi::Rectangle rect{ 0, (int)m_ssrRtv.GetResource().GetHeight(), 0, (int)m_ssrRtv.GetResource().GetWidth() };
+		gxapi::Rectangle rect{ 0, (int)traceRtv.GetResource().GetHeight(), 0, (int)traceRtv.GetResource().GetWidth() };
 		gxapi::Viewport viewport;
 		viewport.width = (float)rect.right;
 		viewport.height = (float)rect.bottom;
@@ -375,13 +419,17 @@ void ScreenSpaceReflection::Execute(RenderContext& context) {
 
 		commandList.SetPipelineState(m_PSO.get());
 		commandList.SetGraphicsBinder(&m_binder);
-		commandList.BindGraphics(m_inputTexBindParam, m_inputTexSrv);
-		commandList.BindGraphics(m_depthTexBindParam, m_depthTexSrv);
+		commandList.BindGraphics(m_inputTexBindParam, colorSrv);
+		commandList.BindGraphics(m_depthTexBindParam, depthSrv);
 		commandList.BindGraphics(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
 
 		commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLESTRIP);
 		commandList.DrawInstanced(4);
 	}
+
+	if (m_resolution.IsReduced()) {
+		m_resolution.Upsample(commandList, m_traceSrv, m_ssrRtv, *m_camera);
+	}
 }
 
 
@@ -4,13 +4,22 @@
 #include <GraphicsEngine_LL/BasicCamera.hpp>
 #include <GraphicsEngine_LL/GraphicsNode.hpp>
 
+#include "../ScaledResolution.hpp"
+
 
 namespace inl::gxeng::nodes {
 
 
+/// <summary>
+/// Inputs: color texture, depth texture, camera, velocity and normal texture, resolution
+/// </summary>
+/// <remarks>
+/// Rays are traced at the given fraction of the depth's resolution against the matching mip of the color,
+/// then the reflections are upsampled to full resolution, see <see cref="ScaledResolution"/>.
+/// </remarks>
 class ScreenSpaceReflection : virtual public GraphicsNode,
 							  virtual public GraphicsTask,
-							  virtual public InputPortConfig<Texture2D, Texture2D, const BasicCamera*, Texture2D>,
+							  virtual public InputPortConfig<Texture2D, Texture2D, const BasicCamera*, Texture2D, eResolutionScale>,
 							  virtual public OutputPortConfig<Texture2D> {
 public:
 	static const char* Info_GetName() { return "ScreenSpaceReflection"; }
@@ -42,6 +51,11 @@ protected:
 protected: // outputs
 	bool m_outputTexturesInited = false;
 	RenderTargetView2D m_ssrRtv;
+	ScaledResolution m_resolution;
+	eQualityPreset m_qualityPreset = eQualityPreset::HIGH;
+	RenderTargetView2D m_traceRtv;
+	TextureView2D m_traceSrv;
+	unsigned m_traceMip = 0;
 
 protected: // render context
 	TextureView2D m_inputTexSrv;
@@ -0,0 +1,249 @@
+#include "ScaledResolution.hpp"
+
+#include <GraphicsEngine_LL/GraphicsCommandList.hpp>
+
+#include <algorithm>
+
+
+namespace inl::gxeng::nodes {
+
+
+struct Uniforms {
+	float nearPlane, farPlane;
+	uint32_t divisor;
+};
+
+
+unsigned ScaledResolution::GetDivisor(eResolutionScale scale, eQualityPreset preset) {
+	if (scale == eResolutionScale::DEFAULT) {
+		switch (preset) {
+			case eQualityPreset::LOW: scale = eResolutionScale::QUARTER; break;
+			case eQualityPreset::MEDIUM: scale = eResolutionScale::HALF; break;
+			default: scale = eResolutionScale::FULL; break;
+		}
+	}
+
+	switch (scale) {
+		case eResolutionScale::HALF: return 2;
+		case eResolutionScale::QUARTER: return 4;
+		default: return 1;
+	}
+}
+
+
+void ScaledResolution::Setup(SetupContext& context, const TextureView2D& depthTex, unsigned divisor, gxapi::eFormat upsampleFormat) {
+	m_depthTexSrv = depthTex;
+	m_divisor = std::max(divisor, 1u);
+
+	if (!IsReduced()) {
+		m_reducedDepthRtv = RenderTargetView2D();
+		m_reducedDepthSrv = TextureView2D();
+		return;
+	}
+
+	InitPipeline(context, upsampleFormat);
+
+	using gxapi::eFormat;
+
+	auto formatDepth = eFormat::R32_FLOAT;
+
+	gxapi::RtvTexture2DArray rtvDesc;
+	rtvDesc.activeArraySize = 1;
+	rtvDesc.firstArrayElement = 0;
+	rtvDesc.firstMipLevel = 0;
+	rtvDesc.planeIndex = 0;
+
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.numMipLevels = -1;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.planeIndex = 0;
+
+	Texture2DDesc desc{
+		GetWidth(),
+		GetHeight(),
+		formatDepth
+	};
+
+	// The reduced depth is only read by the passes of the owner node, in the same frame.
+	Texture2D reducedDepthTex = context.CreateTransientTexture2D(desc, { true, true, false, false });
+	m_reducedDepthRtv = context.CreateRtv(reducedDepthTex, formatDepth, rtvDesc);
+	m_reducedDepthSrv = context.CreateSrv(reducedDepthTex, formatDepth, srvDesc);
+}
+
+
+uint64_t ScaledResolution::GetWidth() const {
+	return std::max<uint64_t>(m_depthTexSrv.GetResource().GetWidth() / m_divisor, 1);
+}
+
+uint32_t ScaledResolution::GetHeight() const {
+	return std::max<uint32_t>(m_depthTexSrv.GetResource().GetHeight() / m_divisor, 1);
+}
+
+
+const TextureView2D& ScaledResolution::GetDepth() const {
+	return IsReduced() ? m_reducedDepthSrv : m_depthTexSrv;
+}
+
+
+void ScaledResolution::DownsampleDepth(GraphicsCommandList& commandList) {
+	if (!IsReduced()) {
+		return;
+	}
+
+	Uniforms uniforms;
+	uniforms.nearPlane = 0.0f;
+	uniforms.farPlane = 0.0f;
+	uniforms.divisor = m_divisor;
+
+	commandList.SetResourceState(m_reducedDepthRtv.GetResource(), gxapi::eResourceState::RENDER_TARGET);
+	commandList.SetResourceState(m_depthTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+
+	commandList.SetPipelineState(m_downsamplePSO.get());
+	commandList.SetGraphicsBinder(&m_binder);
+	commandList.BindGraphics(m_depthTexBindParam, m_depthTexSrv);
+
+	Draw(commandList, m_reducedDepthRtv, &uniforms, sizeof(uniforms));
+}
+
+
+void ScaledResolution::Upsample(GraphicsCommandList& commandList, const TextureView2D& source, RenderTargetView2D& target, const BasicCamera& camera) {
+	Uniforms uniforms;
+	uniforms.nearPlane = camera.GetNearPlane();
+	uniforms.farPlane = camera.GetFarPlane();
+	uniforms.divisor = m_divisor;
+
+	commandList.SetResourceState(target.GetResource(), gxapi::eResourceState::RENDER_TARGET);
+	commandList.SetResourceState(source.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_depthTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_reducedDepthSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+
+	commandList.SetPipelineState(m_upsamplePSO.get());
+	commandList.SetGraphicsBinder(&m_binder);
+	commandList.BindGraphics(m_depthTexBindParam, m_depthTexSrv);
+	commandList.BindGraphics(m_reducedDepthTexBindParam, m_reducedDepthSrv);
+	commandList.BindGraphics(m_inputTexBindParam, source);
+
+	Draw(commandList, target, &uniforms, sizeof(uniforms));
+}
+
+
+void ScaledResolution::Draw(GraphicsCommandList& commandList, RenderTargetView2D& target, const void* uniforms, size_t uniformsSize) {
+	RenderTargetView2D* pRTV = &target;
+	commandList.SetRenderTargets(1, &pRTV, 0);
+
+	gxapi::Rectangle rect{ 0, (int)target.GetResource().GetHeight(), 0, (int)target.GetResource().GetWidth() };
+	gxapi::Viewport viewport;
+	viewport.width = (float)rect.right;
+	viewport.height = (float)rect.bottom;
+	viewport.topLeftX = 0;
+	viewport.topLeftY = 0;
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	commandList.SetScissorRects(1, &rect);
+	commandList.SetViewports(1, &viewport);
+
+	commandList.BindGraphics(m_uniformsBindParam, uniforms, (int)uniformsSize);
+
+	commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLESTRIP);
+	commandList.DrawInstanced(4);
+}
+
+
+void ScaledResolution::InitPipeline(SetupContext& context, gxapi::eFormat upsampleFormat) {
+	if (m_binder) {
+		return;
+	}
+
+	BindParameterDesc uniformsBindParamDesc;
+	m_uniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
+	uniformsBindParamDesc.parameter = m_uniformsBindParam;
+	uniformsBindParamDesc.constantSize = sizeof(Uniforms);
+	uniformsBindParamDesc.relativeAccessFrequency = 0;
+	uniformsBindParamDesc.relativeChangeFrequency = 0;
+	uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+	BindParameterDesc sampBindParamDesc;
+	sampBindParamDesc.parameter = BindParameter(eBindParameterType::SAMPLER, 0);
+	sampBindParamDesc.constantSize = 0;
+	sampBindParamDesc.relativeAccessFrequency = 0;
+	sampBindParamDesc.relativeChangeFrequency = 0;
+	sampBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+	BindParameterDesc depthBindParamDesc;
+	m_depthTexBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+	depthBindParamDesc.parameter = m_depthTexBindParam;
+	depthBindParamDesc.constantSize = 0;
+	depthBindParamDesc.relativeAccessFrequency = 0;
+	depthBindParamDesc.relativeChangeFrequency = 0;
+	depthBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+	BindParameterDesc reducedDepthBindParamDesc;
+	m_reducedDepthTexBindParam = BindParameter(eBindParameterType::TEXTURE, 1);
+	reducedDepthBindParamDesc.parameter = m_reducedDepthTexBindParam;
+	reducedDepthBindParamDesc.constantSize = 0;
+	reducedDepthBindParamDesc.relativeAccessFrequency = 0;
+	reducedDepthBindParamDesc.relativeChangeFrequency = 0;
+	reducedDepthBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+	BindParameterDesc inputBindParamDesc;
+	m_inputTexBindParam = BindParameter(eBindParameterType::TEXTURE, 2);
+	inputBindParamDesc.parameter = m_inputTexBindParam;
+	inputBindParamDesc.constantSize = 0;
+	inputBindParamDesc.relativeAccessFrequency = 0;
+	inputBindParamDesc.relativeChangeFrequency = 0;
+	inputBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+	gxapi::StaticSamplerDesc samplerDesc;
+	samplerDesc.shaderRegister = 0;
+	samplerDesc.filter = gxapi::eTextureFilterMode::MIN_MAG_MIP_POINT;
+	samplerDesc.addressU = gxapi::eTextureAddressMode::CLAMP;
+	samplerDesc.addressV = gxapi::eTextureAddressMode::CLAMP;
+	samplerDesc.addressW = gxapi::eTextureAddressMode::CLAMP;
+	samplerDesc.mipLevelBias = 0.f;
+	samplerDesc.registerSpace = 0;
+	samplerDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+	m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc, depthBindParamDesc, reducedDepthBindParamDesc, inputBindParamDesc }, { samplerDesc });
+
+	ShaderParts shaderParts;
+	shaderParts.vs = true;
+	shaderParts.ps = true;
+
+	std::vector<gxapi::InputElementDesc> inputElementDesc = {
+		gxapi::InputElementDesc("POSITION", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 0),
+		gxapi::InputElementDesc("TEX_COORD", 0, gxapi::eFormat::R32G32_FLOAT, 0, 12)
+	};
+
+	m_downsampleShader = context.CreateShader("DepthDownsample", shaderParts, "");
+	m_upsampleShader = context.CreateShader("BilateralUpsample", shaderParts, "");
+
+	gxapi::GraphicsPipelineStateDesc psoDesc;
+	psoDesc.inputLayout.elements = inputElementDesc.data();
+	psoDesc.inputLayout.numElements = (unsigned)inputElementDesc.size();
+	psoDesc.rootSignature = m_binder.GetRootSignature();
+	psoDesc.rasterization = gxapi::RasterizerState(gxapi::eFillMode::SOLID, gxapi::eCullMode::DRAW_ALL);
+	psoDesc.primitiveTopologyType = gxapi::ePrimitiveTopologyType::TRIANGLE;
+
+	psoDesc.depthStencilState.enableDepthTest = false;
+	psoDesc.depthStencilState.enableDepthStencilWrite = false;
+	psoDesc.depthStencilState.enableStencilTest = false;
+	psoDesc.depthStencilState.cwFace = psoDesc.depthStencilState.ccwFace;
+
+	psoDesc.numRenderTargets = 1;
+
+	psoDesc.vs = m_downsampleShader.vs;
+	psoDesc.ps = m_downsampleShader.ps;
+	psoDesc.renderTargetFormats[0] = gxapi::eFormat::R32_FLOAT;
+	m_downsamplePSO.reset(context.CreatePSO(psoDesc));
+
+	psoDesc.vs = m_upsampleShader.vs;
+	psoDesc.ps = m_upsampleShader.ps;
+	psoDesc.renderTargetFormats[0] = upsampleFormat;
+	m_upsamplePSO.reset(context.CreatePSO(psoDesc));
+}
+
+
+} // namespace inl::gxeng::nodes
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <GraphicsApi_LL/IPipelineState.hpp>
+#include <GraphicsEngine_LL/BasicCamera.hpp>
+#include <GraphicsEngine_LL/GraphicsNode.hpp>
+
+
+namespace inl::gxeng::nodes {
+
+
+/// <summary> Runs the passes of a screen space effect at a fraction of the resolution of its depth input. </summary>
+/// <remarks>
+/// The depth is reduced by keeping the nearest depth of each block, and the effect reads it instead of the original.
+/// Its result is brought back to full resolution by a joint bilateral upsample: of the low resolution samples
+/// around a pixel, the ones at a similar depth weigh more, so the effect does not bleed over depth edges.
+/// At full resolution it does nothing and the original depth is used.
+/// </remarks>
+class ScaledResolution {
+public:
+	/// <summary> The number the resolution of the effect is divided by. </summary>
+	static unsigned GetDivisor(eResolutionScale scale, eQualityPreset preset);
+
+	/// <summary> Creates the reduced depth for the current frame, call it in every Setup of the node. </summary>
+	/// <param name="upsampleFormat"> The format of the targets of <see cref="Upsample"/>. </param>
+	void Setup(SetupContext& context, const TextureView2D& depthTex, unsigned divisor, gxapi::eFormat upsampleFormat);
+
+	bool IsReduced() const { return m_divisor > 1; }
+	unsigned GetDivisor() const { return m_divisor; }
+	uint64_t GetWidth() const;
+	uint32_t GetHeight() const;
+
+	/// <summary> The depth at the reduced resolution, the original at full resolution. </summary>
+	const TextureView2D& GetDepth() const;
+
+	/// <summary> Fills the reduced depth, does nothing at full resolution. </summary>
+	void DownsampleDepth(GraphicsCommandList& commandList);
+
+	/// <summary> Writes the reduced resolution source to the full resolution target. </summary>
+	void Upsample(GraphicsCommandList& commandList, const TextureView2D& source, RenderTargetView2D& target, const BasicCamera& camera);
+
+private:
+	void InitPipeline(SetupContext& context, gxapi::eFormat upsampleFormat);
+	void Draw(GraphicsCommandList& commandList, RenderTargetView2D& target, const void* uniforms, size_t uniformsSize);
+
+private:
+	Binder m_binder;
+	BindParameter m_uniformsBindParam;
+	BindParameter m_depthTexBindParam;
+	BindParameter m_reducedDepthTexBindParam;
+	BindParameter m_inputTexBindParam;
+	ShaderProgram m_downsampleShader;
+	ShaderProgram m_upsampleShader;
+	std::unique_ptr<gxapi::IPipelineState> m_downsamplePSO;
+	std::unique_ptr<gxapi::IPipelineState> m_upsamplePSO;
+
+	unsigned m_divisor = 1;
+	TextureView2D m_depthTexSrv;
+	RenderTargetView2D m_reducedDepthRtv;
+	TextureView2D m_reducedDepthSrv;
+};
+
+
+} // namespace inl::gxeng::nodes
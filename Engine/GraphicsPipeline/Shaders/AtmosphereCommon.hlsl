@@ -0,0 +1,248 @@
+/*
+* Atmosphere model of the precomputed sky LUTs
+* Lengths are in kilometers, the planet's center is the origin and +Z is up
+* Before including, declare samp0 and the LUTs the functions read:
+* transmittanceLut (t0) and, with ATMOSPHERE_MULTI_SCATTERING, multiScatteringLut (t1)
+*/
+
+struct Atmosphere
+{
+	float3 rayleighScattering;
+	float bottomRadius;
+	float3 mieScattering;
+	float topRadius;
+	float3 mieExtinction;
+	float rayleighScaleHeight;
+	float3 absorptionExtinction;
+	float mieScaleHeight;
+	float3 groundAlbedo;
+	float miePhaseG;
+	float absorptionCenter;
+	float absorptionWidth;
+	float luminanceScale;
+	float dummy;
+};
+
+ConstantBuffer<Atmosphere> atmosphere : register(b2);
+
+#define PI 3.14159265359
+
+//world units are meters
+#define WORLD_TO_KM 0.001
+
+//keeps the views at the ground from looking straight into it
+#define MIN_VIEW_HEIGHT 0.001
+
+
+struct Medium
+{
+	float3 rayleighScattering;
+	float3 mieScattering;
+	float3 extinction;
+};
+
+Medium SampleMedium(float3 position)
+{
+	float altitude = max(length(position) - atmosphere.bottomRadius, 0.0);
+	float rayleighDensity = exp(-altitude / atmosphere.rayleighScaleHeight);
+	float mieDensity = exp(-altitude / atmosphere.mieScaleHeight);
+	float absorptionDensity = max(0.0, 1.0 - abs(altitude - atmosphere.absorptionCenter) / (0.5 * atmosphere.absorptionWidth));
+
+	Medium medium;
+	medium.rayleighScattering = atmosphere.rayleighScattering * rayleighDensity;
+	medium.mieScattering = atmosphere.mieScattering * mieDensity;
+	medium.extinction = medium.rayleighScattering + atmosphere.mieExtinction * mieDensity + atmosphere.absorptionExtinction * absorptionDensity;
+	return medium;
+}
+
+//distance to the nearest intersection in front of the origin, -1 if there is none
+float RaySphereIntersectNearest(float3 origin, float3 dir, float radius)
+{
+	float b = dot(origin, dir);
+	float c = dot(origin, origin) - radius * radius;
+	float discriminant = b * b - c;
+	if (discriminant < 0.0)
+	{
+		return -1.0;
+	}
+	float s = sqrt(discriminant);
+	float t0 = -b - s;
+	float t1 = -b + s;
+	if (t1 < 0.0)
+	{
+		return -1.0;
+	}
+	return t0 >= 0.0 ? t0 : t1;
+}
+
+float RayleighPhase(float cosTheta)
+{
+	return 3.0 / (16.0 * PI) * (1.0 + cosTheta * cosTheta);
+}
+
+float MiePhase(float g, float cosTheta)
+{
+	//Cornette-Shanks
+	float g2 = g * g;
+	float k = 3.0 / (8.0 * PI) * (1.0 - g2) / (2.0 + g2);
+	return k * (1.0 + cosTheta * cosTheta) / pow(max(1.0 + g2 - 2.0 * g * cosTheta, 1e-4), 1.5);
+}
+
+float GetViewHeight(float3 worldPos)
+{
+	return atmosphere.bottomRadius + max(worldPos.z * WORLD_TO_KM, MIN_VIEW_HEIGHT);
+}
+
+
+//transmittance LUT: to the top of the atmosphere, by view height and view zenith cosine [Bruneton 2017]
+float2 TransmittanceLutUv(float viewHeight, float viewZenithCos)
+{
+	float horizon = sqrt(atmosphere.topRadius * atmosphere.topRadius - atmosphere.bottomRadius * atmosphere.bottomRadius);
+	float rho = sqrt(max(0.0, viewHeight * viewHeight - atmosphere.bottomRadius * atmosphere.bottomRadius));
+
+	float discriminant = viewHeight * viewHeight * (viewZenithCos * viewZenithCos - 1.0) + atmosphere.topRadius * atmosphere.topRadius;
+	float d = max(0.0, -viewHeight * viewZenithCos + sqrt(max(discriminant, 0.0)));
+
+	float dMin = atmosphere.topRadius - viewHeight;
+	float dMax = rho + horizon;
+	return float2((d - dMin) / (dMax - dMin), rho / horizon);
+}
+
+void TransmittanceLutParameters(float2 uv, out float viewHeight, out float viewZenithCos)
+{
+	float horizon = sqrt(atmosphere.topRadius * atmosphere.topRadius - atmosphere.bottomRadius * atmosphere.bottomRadius);
+	float rho = horizon * uv.y;
+	viewHeight = sqrt(rho * rho + atmosphere.bottomRadius * atmosphere.bottomRadius);
+
+	float dMin = atmosphere.topRadius - viewHeight;
+	float dMax = rho + horizon;
+	float d = dMin + uv.x * (dMax - dMin);
+	viewZenithCos = d == 0.0 ? 1.0 : (horizon * horizon - rho * rho - d * d) / (2.0 * viewHeight * d);
+	viewZenithCos = clamp(viewZenithCos, -1.0, 1.0);
+}
+
+float3 SampleTransmittance(float viewHeight, float viewZenithCos)
+{
+	return transmittanceLut.SampleLevel(samp0, TransmittanceLutUv(viewHeight, viewZenithCos), 0).rgb;
+}
+
+
+//multiple scattering LUT: by sun zenith cosine and height
+float2 MultiScatteringLutUv(float viewHeight, float sunZenithCos)
+{
+	return float2(sunZenithCos * 0.5 + 0.5, saturate((viewHeight - atmosphere.bottomRadius) / (atmosphere.topRadius - atmosphere.bottomRadius)));
+}
+
+#ifdef ATMOSPHERE_MULTI_SCATTERING
+float3 SampleMultiScattering(float viewHeight, float sunZenithCos)
+{
+	return multiScatteringLut.SampleLevel(samp0, MultiScatteringLutUv(viewHeight, sunZenithCos), 0).rgb;
+}
+#endif
+
+
+//sky-view LUT: by azimuth from the sun and view zenith angle,
+//rows are packed towards the horizon, columns towards the sun [Hillaire 2020]
+float2 SkyViewLutUv(bool intersectGround, float viewZenithCos, float lightViewCos, float viewHeight)
+{
+	float horizonDistance = sqrt(max(0.0, viewHeight * viewHeight - atmosphere.bottomRadius * atmosphere.bottomRadius));
+	float beta = acos(horizonDistance / viewHeight);
+	float zenithHorizonAngle = PI - beta;
+
+	float2 uv;
+	if (!intersectGround)
+	{
+		float coord = 1.0 - acos(viewZenithCos) / zenithHorizonAngle;
+		uv.y = (1.0 - sqrt(saturate(coord))) * 0.5;
+	}
+	else
+	{
+		float coord = (acos(viewZenithCos) - zenithHorizonAngle) / beta;
+		uv.y = sqrt(saturate(coord)) * 0.5 + 0.5;
+	}
+	uv.x = sqrt(saturate(-lightViewCos * 0.5 + 0.5));
+	return uv;
+}
+
+void SkyViewLutParameters(float2 uv, float viewHeight, out float viewZenithCos, out float lightViewCos)
+{
+	float horizonDistance = sqrt(max(0.0, viewHeight * viewHeight - atmosphere.bottomRadius * atmosphere.bottomRadius));
+	float beta = acos(horizonDistance / viewHeight);
+	float zenithHorizonAngle = PI - beta;
+
+	if (uv.y < 0.5)
+	{
+		float coord = 1.0 - 2.0 * uv.y;
+		viewZenithCos = cos(zenithHorizonAngle * (1.0 - coord * coord));
+	}
+	else
+	{
+		float coord = 2.0 * uv.y - 1.0;
+		viewZenithCos = cos(zenithHorizonAngle + beta * coord * coord);
+	}
+	lightViewCos = -(uv.x * uv.x * 2.0 - 1.0);
+}
+
+
+struct ScatteringResult
+{
+	float3 luminance;
+	float3 multiScatteringAs1; //scattering of unit luminance coming from all directions
+};
+
+//marches the ray to the ground or the top of the atmosphere, for a sun of unit illuminance
+//uniformPhase and groundBounce are for the multiple scattering LUT, it sums the orders it cannot sample
+ScatteringResult IntegrateScattering(float3 origin, float3 dir, float3 sunDir, int numSteps, bool uniformPhase, bool groundBounce)
+{
+	ScatteringResult result;
+	result.luminance = float3(0.0, 0.0, 0.0);
+	result.multiScatteringAs1 = float3(0.0, 0.0, 0.0);
+
+	float tBottom = RaySphereIntersectNearest(origin, dir, atmosphere.bottomRadius);
+	float tTop = RaySphereIntersectNearest(origin, dir, atmosphere.topRadius);
+	float tMax = tBottom >= 0.0 ? tBottom : tTop;
+	if (tMax <= 0.0)
+	{
+		return result;
+	}
+
+	float cosTheta = dot(sunDir, dir);
+	float rayleighPhase = uniformPhase ? 1.0 / (4.0 * PI) : RayleighPhase(cosTheta);
+	float miePhase = uniformPhase ? 1.0 / (4.0 * PI) : MiePhase(atmosphere.miePhaseG, cosTheta);
+
+	float dt = tMax / numSteps;
+	float3 throughput = float3(1.0, 1.0, 1.0);
+	for (int i = 0; i < numSteps; ++i)
+	{
+		float3 position = origin + ((i + 0.3) * dt) * dir;
+		Medium medium = SampleMedium(position);
+		float height = length(position);
+		float sunZenithCos = dot(sunDir, position / height);
+
+		float3 sunTransmittance = SampleTransmittance(height, sunZenithCos);
+		float planetShadow = RaySphereIntersectNearest(position, sunDir, atmosphere.bottomRadius) >= 0.0 ? 0.0 : 1.0;
+		float3 scattering = medium.rayleighScattering + medium.mieScattering;
+
+		float3 inScattering = planetShadow * sunTransmittance * (medium.rayleighScattering * rayleighPhase + medium.mieScattering * miePhase);
+#ifdef ATMOSPHERE_MULTI_SCATTERING
+		inScattering += SampleMultiScattering(height, sunZenithCos) * scattering;
+#endif
+
+		//integrated analytically over the step, the medium being constant in it
+		float3 extinction = max(medium.extinction, 1e-6);
+		float3 stepTransmittance = exp(-extinction * dt);
+		result.luminance += throughput * (inScattering - inScattering * stepTransmittance) / extinction;
+		result.multiScatteringAs1 += throughput * (scattering - scattering * stepTransmittance) / extinction;
+		throughput *= stepTransmittance;
+	}
+
+	if (groundBounce && tBottom >= 0.0)
+	{
+		float3 position = origin + tBottom * dir;
+		float3 normal = normalize(position);
+		float sunZenithCos = dot(sunDir, normal);
+		result.luminance += throughput * SampleTransmittance(atmosphere.bottomRadius, sunZenithCos) * saturate(sunZenithCos) * atmosphere.groundAlbedo / PI;
+	}
+
+	return result;
+}
@@ -0,0 +1,57 @@
+/*
+* Multiple scattering LUT of the atmosphere
+* Input: transmittance LUT
+* Output: luminance of the second and higher scattering orders, by sun zenith cosine and height [Hillaire 2020]
+*/
+
+Texture2D transmittanceLut : register(t0);
+SamplerState samp0 : register(s0);
+
+RWTexture2D<float4> outputTex : register(u0);
+
+#include "AtmosphereCommon.hlsl"
+
+#define NUM_STEPS 20
+#define SQRT_NUM_DIRECTIONS 8
+
+
+[numthreads(8, 8, 1)]
+void CSMain(uint3 dispatchId : SV_DispatchThreadID)
+{
+	uint2 size;
+	outputTex.GetDimensions(size.x, size.y);
+	if (any(dispatchId.xy >= size))
+	{
+		return;
+	}
+
+	float2 uv = (float2(dispatchId.xy) + 0.5) / float2(size);
+	float sunZenithCos = uv.x * 2.0 - 1.0;
+	float viewHeight = lerp(atmosphere.bottomRadius + MIN_VIEW_HEIGHT, atmosphere.topRadius - MIN_VIEW_HEIGHT, uv.y);
+
+	float3 origin = float3(0.0, 0.0, viewHeight);
+	float3 sunDir = float3(sqrt(saturate(1.0 - sunZenithCos * sunZenithCos)), 0.0, sunZenithCos);
+
+	//second order luminance and the transfer of the higher orders, over evenly spread directions of the sphere
+	float3 secondOrder = float3(0.0, 0.0, 0.0);
+	float3 transfer = float3(0.0, 0.0, 0.0);
+	for (int y = 0; y < SQRT_NUM_DIRECTIONS; ++y)
+	{
+		for (int x = 0; x < SQRT_NUM_DIRECTIONS; ++x)
+		{
+			float cosTheta = 1.0 - 2.0 * (y + 0.5) / SQRT_NUM_DIRECTIONS;
+			float phi = 2.0 * PI * (x + 0.5) / SQRT_NUM_DIRECTIONS;
+			float sinTheta = sqrt(saturate(1.0 - cosTheta * cosTheta));
+			float3 dir = float3(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta);
+
+			ScatteringResult scattering = IntegrateScattering(origin, dir, sunDir, NUM_STEPS, true, true);
+			secondOrder += scattering.luminance;
+			transfer += scattering.multiScatteringAs1;
+		}
+	}
+	secondOrder /= SQRT_NUM_DIRECTIONS * SQRT_NUM_DIRECTIONS;
+	transfer /= SQRT_NUM_DIRECTIONS * SQRT_NUM_DIRECTIONS;
+
+	//the orders form a geometric series
+	outputTex[dispatchId.xy] = float4(secondOrder / (1.0 - min(transfer, 0.99)), 1.0);
+}
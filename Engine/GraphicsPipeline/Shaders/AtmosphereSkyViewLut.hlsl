@@ -0,0 +1,57 @@
+/*
+* Sky-view LUT of the atmosphere, rendered each frame at the camera's height for the sun
+* Input: transmittance LUT, multiple scattering LUT
+* Output: sky luminance for a sun of unit illuminance, by view zenith angle and azimuth from the sun
+*/
+
+struct Sun
+{
+	float4 dir; // world space
+	float4 color;
+};
+
+struct Cam
+{
+	float4x4 invViewProj;
+	float4 position; // world space
+};
+
+ConstantBuffer<Sun> sun : register(b0);
+ConstantBuffer<Cam> cam : register(b1);
+
+Texture2D transmittanceLut : register(t0);
+Texture2D multiScatteringLut : register(t1);
+SamplerState samp0 : register(s0);
+
+RWTexture2D<float4> outputTex : register(u0);
+
+#define ATMOSPHERE_MULTI_SCATTERING
+#include "AtmosphereCommon.hlsl"
+
+#define NUM_STEPS 30
+
+
+[numthreads(8, 8, 1)]
+void CSMain(uint3 dispatchId : SV_DispatchThreadID)
+{
+	uint2 size;
+	outputTex.GetDimensions(size.x, size.y);
+	if (any(dispatchId.xy >= size))
+	{
+		return;
+	}
+
+	float viewHeight = GetViewHeight(cam.position.xyz);
+	float viewZenithCos, lightViewCos;
+	SkyViewLutParameters((float2(dispatchId.xy) + 0.5) / float2(size), viewHeight, viewZenithCos, lightViewCos);
+
+	//the sun is in the XZ plane of the LUT's frame
+	float3 toSun = normalize(-sun.dir.xyz);
+	float3 sunDir = float3(sqrt(saturate(1.0 - toSun.z * toSun.z)), 0.0, toSun.z);
+
+	float viewZenithSin = sqrt(saturate(1.0 - viewZenithCos * viewZenithCos));
+	float3 dir = float3(viewZenithSin * lightViewCos, viewZenithSin * sqrt(saturate(1.0 - lightViewCos * lightViewCos)), viewZenithCos);
+
+	ScatteringResult scattering = IntegrateScattering(float3(0.0, 0.0, viewHeight), dir, sunDir, NUM_STEPS, false, false);
+	outputTex[dispatchId.xy] = float4(scattering.luminance, 1.0);
+}
@@ -0,0 +1,41 @@
+/*
+* Transmittance LUT of the atmosphere
+* Output: transmittance to the top of the atmosphere, by view height and view zenith cosine
+*/
+
+Texture2D transmittanceLut : register(t0);
+SamplerState samp0 : register(s0);
+
+RWTexture2D<float4> outputTex : register(u0);
+
+#include "AtmosphereCommon.hlsl"
+
+#define NUM_STEPS 40
+
+
+[numthreads(8, 8, 1)]
+void CSMain(uint3 dispatchId : SV_DispatchThreadID)
+{
+	uint2 size;
+	outputTex.GetDimensions(size.x, size.y);
+	if (any(dispatchId.xy >= size))
+	{
+		return;
+	}
+
+	float viewHeight, viewZenithCos;
+	TransmittanceLutParameters((float2(dispatchId.xy) + 0.5) / float2(size), viewHeight, viewZenithCos);
+
+	float3 origin = float3(0.0, 0.0, viewHeight);
+	float3 dir = float3(sqrt(saturate(1.0 - viewZenithCos * viewZenithCos)), 0.0, viewZenithCos);
+	float tMax = max(RaySphereIntersectNearest(origin, dir, atmosphere.topRadius), 0.0);
+
+	float dt = tMax / NUM_STEPS;
+	float3 opticalDepth = float3(0.0, 0.0, 0.0);
+	for (int i = 0; i < NUM_STEPS; ++i)
+	{
+		opticalDepth += SampleMedium(origin + ((i + 0.5) * dt) * dir).extinction * dt;
+	}
+
+	outputTex[dispatchId.xy] = float4(exp(-opticalDepth), 1.0);
+}
@@ -0,0 +1,102 @@
+/*
+* Joint bilateral upsample shader
+* Input: full and reduced resolution depth, reduced resolution effect
+* Output: the effect at full resolution
+*/
+
+struct Uniforms
+{
+	float nearPlane, farPlane;
+	uint divisor;
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+
+Texture2D depthTex : register(t0);
+Texture2D reducedDepthTex : register(t1);
+Texture2D inputTex : register(t2);
+SamplerState samp0 : register(s0);
+
+struct PS_Input
+{
+	float4 position : SV_POSITION;
+	float2 texCoord : TEX_COORD0;
+};
+
+
+float LinearizeDepth(float depth, float near, float far)
+{
+	float A = far / (far - near);
+	float B = -far * near / (far - near);
+
+	//view space linear z
+	return B / (depth - A);
+}
+
+PS_Input VSMain(uint vertexId : SV_VertexID)
+{
+	// Triangle strip based on vertex id
+	// 3-----2
+	// |   / |
+	// | /   |
+	// 1-----0
+	// 0: (1, 0)
+	// 1: (0, 0)
+	// 2: (1, 1)
+	// 3: (0, 1)
+    PS_Input output;
+
+    output.texCoord.x = (vertexId & 1) ^ 1; // 1 if bit0 is 0.
+    output.texCoord.y = vertexId >> 1; // 1 if bit1 is 1.
+
+    float2 posL = output.texCoord.xy * 2.0f - float2(1, 1);
+    output.position = float4(posL, 0.5f, 1.0f);
+    output.texCoord.y = 1.f - output.texCoord.y;
+
+    return output;
+}
+
+float4 PSMain(PS_Input input) : SV_TARGET
+{
+	uint2 reducedSize;
+	reducedDepthTex.GetDimensions(reducedSize.x, reducedSize.y);
+
+	float centerDepth = LinearizeDepth(depthTex.Load(int3(input.position.xy, 0)).x, uniforms.nearPlane, uniforms.farPlane);
+
+	// The four reduced pixels around this one, weighted bilinearly and by how close their depth is.
+	float2 reducedPos = input.position.xy / uniforms.divisor - 0.5;
+	int2 base = int2(floor(reducedPos));
+	float2 f = reducedPos - base;
+	float bilinearWeights[4] = { (1 - f.x) * (1 - f.y), f.x * (1 - f.y), (1 - f.x) * f.y, f.x * f.y };
+	int2 offsets[4] = { int2(0, 0), int2(1, 0), int2(0, 1), int2(1, 1) };
+
+	float4 sum = 0;
+	float weightSum = 0;
+	float bestDiff = 1e30;
+	float4 bestSample = 0;
+	for (int c = 0; c < 4; ++c)
+	{
+		int3 pixel = int3(clamp(base + offsets[c], int2(0, 0), int2(reducedSize) - 1), 0);
+		float sampleDepth = LinearizeDepth(reducedDepthTex.Load(pixel).x, uniforms.nearPlane, uniforms.farPlane);
+		float4 value = inputTex.Load(pixel);
+
+		// Relative difference, so the tolerance is the same near and far.
+		float diff = abs(sampleDepth - centerDepth) / max(centerDepth, 1e-4);
+		float weight = bilinearWeights[c] / (diff * 100.0 + 1e-3);
+		sum += value * weight;
+		weightSum += weight;
+
+		if (diff < bestDiff)
+		{
+			bestDiff = diff;
+			bestSample = value;
+		}
+	}
+
+	// None of the samples are on the same surface, the closest in depth is the best guess.
+	if (weightSum < 1e-2)
+	{
+		return bestSample;
+	}
+	return sum / weightSum;
+}
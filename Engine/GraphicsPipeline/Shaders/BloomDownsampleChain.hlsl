@@ -0,0 +1,99 @@
+/*
+ * Bloom downsample chain shader
+ * Input: HDR color texture
+ * Output 0..4: half, quarter, ... 1/32 size textures
+ *
+ * Every group turns a 64x64 block of the input into the matching blocks of all five levels,
+ * the levels after the first are reduced in group memory, so one dispatch makes the whole chain.
+ */
+
+Texture2D inputTex : register(t0); //HDR texture
+SamplerState samp0 : register(s0);
+
+RWTexture2D<float4> outputTex0 : register(u0);
+RWTexture2D<float4> outputTex1 : register(u1);
+RWTexture2D<float4> outputTex2 : register(u2);
+RWTexture2D<float4> outputTex3 : register(u3);
+RWTexture2D<float4> outputTex4 : register(u4);
+
+#define LOCAL_SIZE_X 16
+#define LOCAL_SIZE_Y 16
+
+groupshared float4 localData[LOCAL_SIZE_X * LOCAL_SIZE_Y];
+
+
+// The threads of the top left sizeOfLevel x sizeOfLevel corner average the 2x2 texels of the previous level.
+// Writes past the edge of a texture are discarded.
+float4 ReduceLevel(uint2 groupThreadId, uint sizeOfLevel)
+{
+	float4 result = float4(0, 0, 0, 0);
+	bool active = all(groupThreadId < sizeOfLevel);
+	if (active)
+	{
+		uint2 src = groupThreadId * 2;
+		result = 0.25 * (localData[src.y * LOCAL_SIZE_X + src.x]
+			+ localData[src.y * LOCAL_SIZE_X + src.x + 1]
+			+ localData[(src.y + 1) * LOCAL_SIZE_X + src.x]
+			+ localData[(src.y + 1) * LOCAL_SIZE_X + src.x + 1]);
+	}
+
+	//everyone has to read before the results overwrite the previous level
+	GroupMemoryBarrierWithGroupSync();
+	if (active)
+	{
+		localData[groupThreadId.y * LOCAL_SIZE_X + groupThreadId.x] = result;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	return result;
+}
+
+
+[numthreads(LOCAL_SIZE_X, LOCAL_SIZE_Y, 1)]
+void CSMain(
+	uint3 groupId : SV_GroupID, //WorkGroupId
+	uint3 groupThreadId : SV_GroupThreadID, //LocalInvocationId
+	uint groupIndex : SV_GroupIndex //LocalInvocationIndex
+	)
+{
+	uint2 outputTexSize;
+	outputTex0.GetDimensions(outputTexSize.x, outputTexSize.y);
+
+	//first level: each thread takes 2x2 texels, bilinear sampling between four input texels like the pixel pass
+	float4 sum = float4(0, 0, 0, 0);
+	uint2 basePixel = groupId.xy * (2 * uint2(LOCAL_SIZE_X, LOCAL_SIZE_Y)) + groupThreadId.xy * 2;
+	for (uint y = 0; y < 2; ++y)
+	{
+		for (uint x = 0; x < 2; ++x)
+		{
+			uint2 pixel = basePixel + uint2(x, y);
+			float4 color = inputTex.SampleLevel(samp0, (pixel + 0.5) / float2(outputTexSize), 0);
+			outputTex0[pixel] = color;
+			sum += color;
+		}
+	}
+
+	//second level: the thread's own 2x2 texels
+	float4 level1 = 0.25 * sum;
+	outputTex1[groupId.xy * uint2(LOCAL_SIZE_X, LOCAL_SIZE_Y) + groupThreadId.xy] = level1;
+	localData[groupIndex] = level1;
+	GroupMemoryBarrierWithGroupSync();
+
+	float4 level2 = ReduceLevel(groupThreadId.xy, LOCAL_SIZE_X / 2);
+	if (all(groupThreadId.xy < LOCAL_SIZE_X / 2))
+	{
+		outputTex2[groupId.xy * (LOCAL_SIZE_X / 2) + groupThreadId.xy] = level2;
+	}
+
+	float4 level3 = ReduceLevel(groupThreadId.xy, LOCAL_SIZE_X / 4);
+	if (all(groupThreadId.xy < LOCAL_SIZE_X / 4))
+	{
+		outputTex3[groupId.xy * (LOCAL_SIZE_X / 4) + groupThreadId.xy] = level3;
+	}
+
+	float4 level4 = ReduceLevel(groupThreadId.xy, LOCAL_SIZE_X / 8);
+	if (all(groupThreadId.xy < LOCAL_SIZE_X / 8))
+	{
+		outputTex4[groupId.xy * (LOCAL_SIZE_X / 8) + groupThreadId.xy] = level4;
+	}
+}
@@ -0,0 +1,57 @@
+/*
+ * Bloom upsample shader
+ * Input0: blurred half size HDR color texture
+ * Input1: normal size HDR color texture
+ * Output: the avg of the upsampled and the normal size texture
+ *
+ * The upsampling tent filter blurs the half size texture, so no separate blur passes are needed.
+ */
+
+struct Uniforms
+{
+	float filterRadius; //in texels of the half size texture
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+
+Texture2D input0Tex : register(t0); //half size
+Texture2D input1Tex : register(t1); //normal size
+SamplerState samp0 : register(s0);
+
+RWTexture2D<float4> outputTex : register(u0);
+
+#define LOCAL_SIZE_X 8
+#define LOCAL_SIZE_Y 8
+
+
+float4 SampleTent(float2 texCoord)
+{
+	uint3 input0TexSize;
+	input0Tex.GetDimensions(0, input0TexSize.x, input0TexSize.y, input0TexSize.z);
+	float2 offset = uniforms.filterRadius / float2(input0TexSize.xy);
+
+	//3x3 tent, 1 2 1 weights on both axes
+	float4 result = input0Tex.SampleLevel(samp0, texCoord, 0) * 4.0;
+	result += input0Tex.SampleLevel(samp0, texCoord + float2(-offset.x, 0), 0) * 2.0;
+	result += input0Tex.SampleLevel(samp0, texCoord + float2(offset.x, 0), 0) * 2.0;
+	result += input0Tex.SampleLevel(samp0, texCoord + float2(0, -offset.y), 0) * 2.0;
+	result += input0Tex.SampleLevel(samp0, texCoord + float2(0, offset.y), 0) * 2.0;
+	result += input0Tex.SampleLevel(samp0, texCoord + float2(-offset.x, -offset.y), 0);
+	result += input0Tex.SampleLevel(samp0, texCoord + float2(offset.x, -offset.y), 0);
+	result += input0Tex.SampleLevel(samp0, texCoord + float2(-offset.x, offset.y), 0);
+	result += input0Tex.SampleLevel(samp0, texCoord + float2(offset.x, offset.y), 0);
+	return result * (1.0 / 16.0);
+}
+
+
+[numthreads(LOCAL_SIZE_X, LOCAL_SIZE_Y, 1)]
+void CSMain(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+	uint2 outputTexSize;
+	outputTex.GetDimensions(outputTexSize.x, outputTexSize.y);
+	if (any(dispatchThreadId.xy >= outputTexSize))
+		return;
+
+	float2 texCoord = (dispatchThreadId.xy + 0.5) / float2(outputTexSize);
+	outputTex[dispatchThreadId.xy] = 0.5 * (SampleTent(texCoord) + input1Tex.SampleLevel(samp0, texCoord, 0));
+}
@@ -1,41 +1,91 @@
 /*
 * Cascaded shadow mapping shader
 * Input: lightmvp texture
-* Output: shadow map for the specific cascade
+* Output: shadow maps of all cascades in a single pass, one array slice per cascade
 */
 
 Texture2D inputTex : register(t0); //lightMVP texture
+StructuredBuffer<float4x4> instanceTransforms : register(t1);
+#if CACHED
+StructuredBuffer<uint> cascadeList : register(t2); // Number of cascades to render, then their indices.
+#endif
 
 struct Uniforms
 {
-	float4x4 model;
-	uint cascadeIDX;
+	uint numCascades;
+	uint instanceOffset;
 };
 
 ConstantBuffer<Uniforms> uniforms : register(b0);
 
+struct GS_Input
+{
+	float4 position : SV_POSITION;
+	nointerpolation uint cascadeIDX : CASCADE;
+};
+
 struct PS_Input
 {
 	float4 position : SV_POSITION;
+	uint cascadeIDX : SV_RenderTargetArrayIndex;
 };
 
 
-PS_Input VSMain(float4 position : POSITION)
+GS_Input VSMain(float4 position : POSITION, uint instanceId : SV_InstanceID)
 {
-	PS_Input result;
+	GS_Input result;
+
+	// Each object is instanced once per cascade.
+	// SV_InstanceID does not include the start instance.
+#if CACHED
+	// Static casters are only drawn to the cascades of the cache that are rendered again.
+	uint cascadeIDX = cascadeList[1 + instanceId % uniforms.numCascades];
+#else
+	uint cascadeIDX = instanceId % uniforms.numCascades;
+#endif
+	float4x4 model = instanceTransforms[uniforms.instanceOffset + instanceId / uniforms.numCascades];
 
 	float4x4 lightMvp;
 	for (int d = 0; d < 4; ++d)
 	{
-		lightMvp[d] = inputTex.Load(int3(uniforms.cascadeIDX * 4 + d, 0, 0));
+		lightMvp[d] = inputTex.Load(int3(cascadeIDX * 4 + d, 0, 0));
 	}
 
-    result.position = mul(position, mul(uniforms.model, lightMvp));
+	result.position = mul(position, mul(model, lightMvp));
+	result.cascadeIDX = cascadeIDX;
 
 	return result;
 }
 
 
+[maxvertexcount(3)]
+void GSMain(triangle GS_Input input[3], inout TriangleStream<PS_Input> OutputStream)
+{
+	// Drop triangles entirely outside the cascade's clip volume,
+	// so that each cascade only rasterizes the casters that reach it.
+	float3 below = float3(1, 1, 1);
+	float3 above = float3(1, 1, 1);
+	for (uint i = 0; i < 3; i++)
+	{
+		float4 p = input[i].position;
+		below *= float3(p.x < -p.w, p.y < -p.w, p.z < 0);
+		above *= float3(p.x > p.w, p.y > p.w, p.z > p.w);
+	}
+	if (any(below) || any(above))
+	{
+		return;
+	}
+
+	for (uint j = 0; j < 3; j++)
+	{
+		PS_Input output;
+		output.position = input[j].position;
+		output.cascadeIDX = input[j].cascadeIDX;
+		OutputStream.Append(output);
+	}
+}
+
+
 void PSMain(PS_Input input)
 {
 }
@@ -0,0 +1,77 @@
+/*
+ * Cached shadow cascade validation
+ * Input: lightmvp texture, light MVPs the cache was rendered with, draw commands of the static casters
+ * Output: list of cascades to render again, draw commands instanced for those cascades only
+ */
+
+#define LOCAL_SIZE_X 64
+
+// Must match CSM::CacheDrawCommand.
+struct DrawCommand
+{
+	uint numCascades;
+	uint instanceOffset;
+	uint4 vertexBuffer; // address, size, stride
+	uint4 indexBuffer; // address, size, format
+	uint numIndices;
+	uint numInstances;
+	uint startIndex;
+	int vertexOffset;
+	uint startInstance;
+	uint padding;
+};
+
+struct Uniforms
+{
+	uint numCascades;
+	uint numCommands;
+	float tolerance;
+	uint forceInvalid;
+};
+
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+Texture2D lightMvpTex : register(t0);
+RWStructuredBuffer<float4x4> cachedMvp : register(u0);
+RWStructuredBuffer<uint> cascadeList : register(u1);
+RWStructuredBuffer<DrawCommand> commands : register(u2);
+
+groupshared uint numInvalid;
+
+
+[numthreads(LOCAL_SIZE_X, 1, 1)]
+void CSMain(uint groupIndex : SV_GroupIndex)
+{
+	// There are only a few cascades, a single thread decides them all.
+	if (groupIndex == 0) {
+		uint count = 0;
+		for (uint cascade = 0; cascade < uniforms.numCascades; ++cascade) {
+			float4x4 lightMvp;
+			for (int d = 0; d < 4; ++d) {
+				lightMvp[d] = lightMvpTex.Load(int3(cascade * 4 + d, 0, 0));
+			}
+
+			// The cache stays valid while the cascade moved less than the tolerance in texels.
+			float4x4 difference = abs(lightMvp - cachedMvp[cascade]);
+			float maxDifference = 0;
+			for (int row = 0; row < 4; ++row) {
+				maxDifference = max(maxDifference, max(max(difference[row].x, difference[row].y), max(difference[row].z, difference[row].w)));
+			}
+
+			if (uniforms.forceInvalid != 0 || maxDifference > uniforms.tolerance) {
+				cachedMvp[cascade] = lightMvp;
+				cascadeList[1 + count] = cascade;
+				++count;
+			}
+		}
+		cascadeList[0] = count;
+		numInvalid = count;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	uint count = numInvalid;
+	for (uint i = groupIndex; i < uniforms.numCommands; i += LOCAL_SIZE_X) {
+		commands[i].numCascades = max(count, 1);
+		commands[i].numInstances *= count;
+	}
+}
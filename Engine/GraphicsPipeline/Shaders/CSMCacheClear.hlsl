@@ -0,0 +1,56 @@
+/*
+ * Clears the cascades of the shadow cache that are rendered again
+ * Input: list of cascades to render again
+ * Output: far plane depth on the listed array slices
+ */
+
+StructuredBuffer<uint> cascadeList : register(t2); // Number of cascades to render, then their indices.
+
+struct GS_Input
+{
+	float4 position : SV_POSITION;
+	nointerpolation uint instanceId : INSTANCE;
+};
+
+struct PS_Input
+{
+	float4 position : SV_POSITION;
+	uint cascadeIDX : SV_RenderTargetArrayIndex;
+};
+
+
+GS_Input VSMain(uint vertexId : SV_VertexID, uint instanceId : SV_InstanceID)
+{
+	// Full screen quad as a triangle strip, on the far plane.
+	float2 corner = float2(vertexId & 1, vertexId >> 1);
+
+	GS_Input result;
+	result.position = float4(corner * 2 - 1, 1, 1);
+	result.instanceId = instanceId;
+	return result;
+}
+
+
+[maxvertexcount(3)]
+void GSMain(triangle GS_Input input[3], inout TriangleStream<PS_Input> OutputStream)
+{
+	// One instance per cascade, the ones past the count are dropped.
+	uint instanceId = input[0].instanceId;
+	if (instanceId >= cascadeList[0])
+	{
+		return;
+	}
+
+	for (uint i = 0; i < 3; i++)
+	{
+		PS_Input output;
+		output.position = input[i].position;
+		output.cascadeIDX = cascadeList[1 + instanceId];
+		OutputStream.Append(output);
+	}
+}
+
+
+void PSMain(PS_Input input)
+{
+}
@@ -0,0 +1,132 @@
+/*
+ * Clustered light culling
+ * Input: view space lights and their bounding spheres
+ * Output: the first index and the number of lights of each cell of the view frustum, the lists of light indices
+ */
+
+#define LOCAL_SIZE_X 64
+
+// Must match the layouts in ClusteredLightCulling.cpp.
+struct LightData
+{
+	float3 vsPosition;
+	float range;
+	float3 color;
+	float spotCosOuter;
+	float3 vsDirection;
+	float spotCosInner;
+	float3 boundsCenter;
+	float boundsRadius;
+};
+
+struct Uniforms
+{
+	uint4 clusterCount; // cells along x, y and depth, tile size in pixels
+	float2 screenSize;
+	float2 projectionScale;
+	float nearPlane;
+	float sliceLogStep;
+	uint numLights;
+	uint indexCapacity;
+};
+
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+StructuredBuffer<LightData> lights : register(t0);
+RWStructuredBuffer<uint2> clusters : register(u0);
+RWStructuredBuffer<uint> lightIndices : register(u1);
+RWBuffer<uint> indexCount : register(u2);
+
+groupshared float4 localBounds[LOCAL_SIZE_X];
+
+
+// View space box around the cell, view space looks along +z.
+void GetClusterBox(uint3 cell, out float3 boxMin, out float3 boxMax)
+{
+	float2 pixelMin = float2(cell.xy * uniforms.clusterCount.w);
+	float2 pixelMax = min(pixelMin + uniforms.clusterCount.w, uniforms.screenSize);
+
+	// Pixel rows go downwards, NDC upwards.
+	float2 ndcMin = float2(pixelMin.x, pixelMax.y) / uniforms.screenSize * float2(2, -2) + float2(-1, 1);
+	float2 ndcMax = float2(pixelMax.x, pixelMin.y) / uniforms.screenSize * float2(2, -2) + float2(-1, 1);
+
+	float depthNear = uniforms.nearPlane * exp2(cell.z * uniforms.sliceLogStep);
+	float depthFar = uniforms.nearPlane * exp2((cell.z + 1) * uniforms.sliceLogStep);
+
+	// The cell is a slice of the tile's frustum, so its box spans the corners on both depth planes.
+	float2 corner0 = ndcMin * depthNear / uniforms.projectionScale;
+	float2 corner1 = ndcMax * depthNear / uniforms.projectionScale;
+	float2 corner2 = ndcMin * depthFar / uniforms.projectionScale;
+	float2 corner3 = ndcMax * depthFar / uniforms.projectionScale;
+
+	boxMin = float3(min(min(corner0, corner1), min(corner2, corner3)), depthNear);
+	boxMax = float3(max(max(corner0, corner1), max(corner2, corner3)), depthFar);
+}
+
+
+bool Intersects(float4 sphere, float3 boxMin, float3 boxMax)
+{
+	float3 offset = clamp(sphere.xyz, boxMin, boxMax) - sphere.xyz;
+	return dot(offset, offset) <= sphere.w * sphere.w;
+}
+
+
+// The group tests its cells against a batch of lights at a time, shared through group memory.
+void LoadLightBatch(uint first, uint groupIndex)
+{
+	GroupMemoryBarrierWithGroupSync(); // The previous batch is done.
+	uint index = first + groupIndex;
+	if (index < uniforms.numLights) {
+		localBounds[groupIndex] = float4(lights[index].boundsCenter, lights[index].boundsRadius);
+	}
+	GroupMemoryBarrierWithGroupSync();
+}
+
+
+[numthreads(LOCAL_SIZE_X, 1, 1)]
+void CSMain(uint3 dispatchThreadId : SV_DispatchThreadID, uint groupIndex : SV_GroupIndex)
+{
+	uint3 count = uniforms.clusterCount.xyz;
+	uint clusterIndex = dispatchThreadId.x;
+	bool active = clusterIndex < count.x * count.y * count.z;
+
+	uint3 cell = uint3(clusterIndex % count.x, (clusterIndex / count.x) % count.y, clusterIndex / (count.x * count.y));
+	float3 boxMin, boxMax;
+	GetClusterBox(cell, boxMin, boxMax);
+
+	// Lights are counted first, then written in a second pass to the range allocated for the count,
+	// so the lists are compact without any per thread storage.
+	// Threads past the last cell still load lights for the rest of the group.
+	uint numHits = 0;
+	for (uint first = 0; first < uniforms.numLights; first += LOCAL_SIZE_X) {
+		LoadLightBatch(first, groupIndex);
+		uint batchSize = min(LOCAL_SIZE_X, uniforms.numLights - first);
+		for (uint i = 0; i < batchSize; ++i) {
+			numHits += Intersects(localBounds[i], boxMin, boxMax) ? 1 : 0;
+		}
+	}
+
+	uint offset = 0;
+	if (active && numHits > 0) {
+		InterlockedAdd(indexCount[0], numHits, offset);
+	}
+
+	// Lists past the capacity are cut short.
+	uint available = offset < uniforms.indexCapacity ? uniforms.indexCapacity - offset : 0;
+	numHits = min(numHits, available);
+	if (active) {
+		clusters[clusterIndex] = uint2(offset, numHits);
+	}
+
+	uint numWritten = 0;
+	for (uint first = 0; first < uniforms.numLights; first += LOCAL_SIZE_X) {
+		LoadLightBatch(first, groupIndex);
+		uint batchSize = min(LOCAL_SIZE_X, uniforms.numLights - first);
+		for (uint i = 0; i < batchSize; ++i) {
+			if (numWritten < numHits && Intersects(localBounds[i], boxMin, boxMax)) {
+				lightIndices[offset + numWritten] = first + i;
+				++numWritten;
+			}
+		}
+	}
+}
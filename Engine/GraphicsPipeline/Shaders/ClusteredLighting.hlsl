@@ -1,8 +1,10 @@
-Texture2D<uint> lightCullData : register(t600);
+StructuredBuffer<uint2> lightClusters : register(t600); // First index and count of each cluster's list.
 #ifndef NO_SSShadow
 Texture2D<float> screenSpaceShadowTex : register(t601);
 #endif
 Texture2D<float4> layeredShadowTex : register(t602);
+StructuredBuffer<LightData> lights : register(t603);
+StructuredBuffer<uint> lightIndices : register(t604);
 SamplerState theSampler : register(s500);
 
 //NOTE: actually, just use SRGB, it's got better quality!
@@ -61,68 +63,42 @@ float3 GetLighting(float4 svPosition, //gl_FragCoord
 					float metalness
 						)
 {
-	uint2 globalId = uint2(svPosition.xy);
-	float2 globalSize = uniforms.screenDimensions;
-	uint2 localSize = uint2(16, 16);
-	uint2 groupId = globalId / localSize;
-	float2 texel = globalId / globalSize;
-
-	uint localNumOfLights = lightCullData.Load(int3(groupId.x * uniforms.groupSizeY + groupId.y, 0, 0));
-	//uint local_num_of_lights = lightCullData.Load(int3(global_id, 0));
-	
-	//return float3(asfloat(local_num_of_lights), 0, 0);
-	//return float3(float(local_num_of_lights), 0, 0);
+	float2 globalSize = uniforms.screenDimensions.xy;
+	float2 texel = svPosition.xy / globalSize;
+
+	// Cluster of the pixel, same numbering as ClusteredLightCulling.
+	uint2 tile = min(uint2(svPosition.xy) / uniforms.clusterTileSize, uint2(uniforms.clusterCountX, uniforms.clusterCountY) - 1);
+	float slice = log2(max(vsPos.z, 1e-4)) * uniforms.clusterDepthScale + uniforms.clusterDepthBias;
+	uint clusterIndex = (uint(clamp(slice, 0.0, float(uniforms.clusterCountZ - 1))) * uniforms.clusterCountY + tile.y) * uniforms.clusterCountX + tile.x;
+	uint2 cluster = lightClusters[clusterIndex];
 
 	float3 vsViewDir = normalize(uniforms.vsCamPos.xyz - vsPos.xyz);
 
 	float3 color = float3(0, 0, 0);
-	for (uint c = 0; c < localNumOfLights; ++c)
+	for (uint c = 0; c < cluster.y; ++c)
 	{
-		uint index = lightCullData.Load(int3(groupId.x * uniforms.groupSizeY + groupId.y, c + 1, 0));
-		float3 vsLightPos = uniforms.ld[index].vsPosition.xyz;
-		float attenuationEnd = uniforms.ld[index].attenuationEnd;
-		float4 diffuseColor = uniforms.ld[index].diffuseColor;
+		LightData light = lights[lightIndices[cluster.x + c]];
 
-		float3 lightDir = vsLightPos - vsPos.xyz;
+		float3 lightDir = light.vsPosition - vsPos.xyz;
 		float distance = length(lightDir);
-		lightDir = normalize(lightDir);
+		lightDir /= max(distance, 1e-4);
 
-		float attenuation = (attenuationEnd - distance) / attenuationEnd;
+		float attenuation = (light.range - distance) / light.range;
+		if (light.spotCosOuter > -1.0)
+		{
+			attenuation *= smoothstep(light.spotCosOuter, light.spotCosInner, dot(-lightDir, light.vsDirection));
+		}
 
 		if (attenuation > 0.0)
 		{
-			float nDotL = max(dot(vsNormal, lightDir), 0.0);
-
-			//color += (n_dot_l * attenuation) * (diffuse_color.xyz * 10.0 * albedo.xyz); //TODO: shadow
-
 			color += getCookTorranceBRDF(albedo.xyz,
 										 vsNormal,
 										 vsViewDir,
-									     lightDir,
-										 diffuseColor.xyz * attenuation * 10.0 * GetLayeredShadow(texel, 1),
-										 roughness, 
-										 metalness 
+										 lightDir,
+										 light.color * attenuation,
+										 roughness,
+										 metalness
 										);
-
-			//const float roughness = 1.0;
-			//const float metallic = 0.0;
-			//const float3 dielectricF0 = 0.04;
-			//
-			//float3 L = light_dir;
-			//float3 V = vs_view_dir;
-			//float3 H = normalize(L + V);
-			//float3 N = vs_normal;
-			//
-			//float NoV = max(dot(N, V), 0.0);
-			//float NoL = max(dot(N, L), 0.0);
-			//float NoH = max(dot(N, H), 0.0);
-			//float VoH = max(dot(V, H), 0.0);
-			//
-			//float3 brdfDielectric = StandardBRDF(dielectricF0, NoV, NoL, NoH, VoH, roughness, albedo);
-			//float3 brdfMetal = StandardBRDF(albedo, NoV, NoL, NoH, VoH, roughness, float3(0.0, 0.0, 0.0));
-			//float3 brdf = metallic * brdfMetal + (1 - metallic) * brdfDielectric;
-			//
-			//color += n_dot_l * brdf * attenuation * diffuse_color;
 		}
 	}
 
@@ -0,0 +1,122 @@
+/*
+* DOF Prepare, Tile Max and Neighbor Max in one pass
+* Input0: HDR color texture
+* Input1: depth texture
+* Output: color and coc, depth, max coc and closest depth of each tile and of the tile neighborhood
+*/
+
+#define TILES_PER_GROUP 8 // Along each side, the group also reduces a ring of tiles around them.
+#define APRON_TILES (TILES_PER_GROUP + 2)
+#define LOCAL_SIZE 16
+
+struct Uniforms
+{
+	int tileSize;
+	int2 tileCount;
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+
+Texture2D inputTex : register(t0);
+Texture2D depthTex : register(t1);
+SamplerState samp0 : register(s0);
+RWTexture2D<float4> prepareTex : register(u0);
+RWTexture2D<float> prepareDepthTex : register(u1);
+RWTexture2D<float2> tileMaxTex : register(u2);
+RWTexture2D<float2> neighborMaxTex : register(u3);
+
+// Positive floats compare the same as their bits.
+groupshared uint localMaxCoc[APRON_TILES * APRON_TILES];
+groupshared uint localMinDepth[APRON_TILES * APRON_TILES];
+
+struct Prepared
+{
+	float4 colorCoc;
+	float depth;
+};
+
+// Same as DOFPrepare: the furthest depth of the 2x2 footprint around the pixel.
+Prepared Prepare(int2 pixel, float2 texSize)
+{
+	Prepared result;
+	result.colorCoc = inputTex.Load(int3(pixel, 0));
+	float4 depthGather = depthTex.GatherRed(samp0, (float2(pixel) + 0.5) / texSize);
+	result.depth = max(depthGather.x, max(depthGather.y, max(depthGather.z, depthGather.w)));
+	return result;
+}
+
+[numthreads(LOCAL_SIZE, LOCAL_SIZE, 1)]
+void CSMain(uint3 groupId : SV_GroupID, uint3 groupThreadId : SV_GroupThreadID, uint groupIndex : SV_GroupIndex)
+{
+	const uint numThreads = LOCAL_SIZE * LOCAL_SIZE;
+	int2 firstTile = int2(groupId.xy) * TILES_PER_GROUP - 1;
+
+	for (uint i = groupIndex; i < APRON_TILES * APRON_TILES; i += numThreads)
+	{
+		localMaxCoc[i] = 0;
+		localMinDepth[i] = asuint(1.0);
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	uint3 inputTexSize;
+	inputTex.GetDimensions(0, inputTexSize.x, inputTexSize.y, inputTexSize.z);
+	int2 texSize = int3(inputTexSize).xy - int2(1, 1);
+
+	// Tiles past the edges are the edge tiles again, as the separate passes clamp their loads.
+	// Pixels under the group's own tiles are written as the prepare pass would, including
+	// the ones right and below the last tiles that no tile covers.
+	uint apronPixels = APRON_TILES * uniforms.tileSize;
+	for (uint p = groupIndex; p < apronPixels * apronPixels; p += numThreads)
+	{
+		int2 local = int2(p % apronPixels, p / apronPixels);
+		int2 localTile = local / uniforms.tileSize;
+		int2 rawTile = firstTile + localTile;
+		int2 tile = clamp(rawTile, int2(0, 0), uniforms.tileCount - 1);
+		int2 pixel = clamp(tile * uniforms.tileSize + local % uniforms.tileSize, int2(0, 0), texSize);
+
+		Prepared prepared = Prepare(pixel, float2(inputTexSize.xy));
+		InterlockedMax(localMaxCoc[localTile.y * APRON_TILES + localTile.x], asuint(max(prepared.colorCoc.w, 0.0)));
+		InterlockedMin(localMinDepth[localTile.y * APRON_TILES + localTile.x], asuint(prepared.depth));
+
+		int2 rawPixel = firstTile * uniforms.tileSize + local;
+		bool interior = all(localTile >= 1) && all(localTile <= TILES_PER_GROUP);
+		if (interior && all(rawPixel <= texSize))
+		{
+			if (any(rawTile != tile))
+			{
+				prepared = Prepare(rawPixel, float2(inputTexSize.xy));
+			}
+			prepareTex[rawPixel] = prepared.colorCoc;
+			prepareDepthTex[rawPixel] = prepared.depth;
+		}
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	if (any(groupThreadId.xy >= TILES_PER_GROUP))
+	{
+		return;
+	}
+
+	int2 center = int2(groupThreadId.xy) + 1;
+	int2 tile = firstTile + center;
+	if (any(tile >= uniforms.tileCount))
+	{
+		return;
+	}
+
+	uint centerIndex = center.y * APRON_TILES + center.x;
+	tileMaxTex[tile] = float2(asfloat(localMaxCoc[centerIndex]), asfloat(localMinDepth[centerIndex]));
+
+	float2 result = float2(0.0, 1.0);
+	for (int x = -1; x <= 1; ++x)
+	{
+		for (int y = -1; y <= 1; ++y)
+		{
+			uint neighbor = (center.y + y) * APRON_TILES + center.x + x;
+			result.x = max(result.x, asfloat(localMaxCoc[neighbor]));
+			result.y = min(result.y, asfloat(localMinDepth[neighbor]));
+		}
+	}
+
+	neighborMaxTex[tile] = result;
+}
@@ -0,0 +1,67 @@
+/*
+* Depth downsample shader
+* Input: depth texture
+* Output: the nearest depth of each block of divisor x divisor pixels
+*/
+
+struct Uniforms
+{
+	float nearPlane, farPlane;
+	uint divisor;
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+
+Texture2D depthTex : register(t0);
+SamplerState samp0 : register(s0);
+
+struct PS_Input
+{
+	float4 position : SV_POSITION;
+	float2 texCoord : TEX_COORD0;
+};
+
+
+PS_Input VSMain(uint vertexId : SV_VertexID)
+{
+	// Triangle strip based on vertex id
+	// 3-----2
+	// |   / |
+	// | /   |
+	// 1-----0
+	// 0: (1, 0)
+	// 1: (0, 0)
+	// 2: (1, 1)
+	// 3: (0, 1)
+    PS_Input output;
+
+    output.texCoord.x = (vertexId & 1) ^ 1; // 1 if bit0 is 0.
+    output.texCoord.y = vertexId >> 1; // 1 if bit1 is 1.
+
+    float2 posL = output.texCoord.xy * 2.0f - float2(1, 1);
+    output.position = float4(posL, 0.5f, 1.0f);
+    output.texCoord.y = 1.f - output.texCoord.y;
+
+    return output;
+}
+
+float PSMain(PS_Input input) : SV_TARGET
+{
+	uint2 depthTexSize;
+	depthTex.GetDimensions(depthTexSize.x, depthTexSize.y);
+
+	// The nearest depth keeps thin foreground objects, the sky does not leak into them.
+	int2 first = int2(input.position.xy) * uniforms.divisor;
+	int2 last = int2(depthTexSize) - 1;
+	float result = 1.0;
+	for (uint y = 0; y < uniforms.divisor; ++y)
+	{
+		for (uint x = 0; x < uniforms.divisor; ++x)
+		{
+			int2 pixel = min(first + int2(x, y), last);
+			result = min(result, depthTex.Load(int3(pixel, 0)).x);
+		}
+	}
+
+	return result;
+}
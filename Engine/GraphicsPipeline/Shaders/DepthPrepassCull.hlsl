@@ -0,0 +1,201 @@
+/*
+ * Depth prepass culling
+ * Input: bounds, transform and geometry of each object, meshlets of their meshes
+ * Output: ExecuteIndirect draw commands of the objects and meshlets inside the view frustum
+ *	that don't face away from the camera, and their count
+ * A group culls one object, then its threads take the meshlets of the object one by one.
+ */
+
+#define LOCAL_SIZE_X 64
+
+struct VertexBufferView
+{
+	uint2 address;
+	uint size;
+	uint stride;
+};
+
+struct IndexBufferView
+{
+	uint2 address;
+	uint size;
+	uint format;
+};
+
+// Must match the layouts in DepthPrepass.cpp.
+struct ObjectData
+{
+	float4x4 world;
+	float3 boundsCenter;
+	uint numIndices;
+	float3 boundsExtent;
+	uint alwaysVisible;
+	VertexBufferView vertexBuffer;
+	IndexBufferView indexBuffer;
+	float4 quantization; // object space * w + xyz is the space of world
+	uint firstIndex;
+	uint firstMeshlet;
+	uint meshletCount;
+	uint padding;
+};
+
+struct Meshlet
+{
+	uint firstIndex;
+	uint indexCount;
+	float3 center;
+	float radius;
+	float3 coneAxis;
+	float coneCutoff;
+};
+
+struct DrawCommand
+{
+	float4x4 MVP;
+	VertexBufferView vertexBuffer;
+	IndexBufferView indexBuffer;
+	uint numIndices;
+	uint numInstances;
+	uint startIndex;
+	int vertexOffset;
+	uint startInstance;
+	uint padding;
+};
+
+struct Uniforms
+{
+	float4x4 viewProjection;
+	float3 cameraPosition;
+	uint numObjects;
+	uint numGroupsX;
+};
+
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+RWStructuredBuffer<ObjectData> objects : register(u0);
+RWStructuredBuffer<DrawCommand> commands : register(u1);
+RWBuffer<uint> commandCount : register(u2);
+RWStructuredBuffer<Meshlet> meshlets : register(u3);
+
+
+// Clip planes from the columns of the view-projection matrix, depth range is [0, w].
+void GetFrustumPlanes(out float4 planes[6])
+{
+	float4x4 columns = transpose(uniforms.viewProjection);
+	planes[0] = columns[3] + columns[0];
+	planes[1] = columns[3] - columns[0];
+	planes[2] = columns[3] + columns[1];
+	planes[3] = columns[3] - columns[1];
+	planes[4] = columns[2];
+	planes[5] = columns[3] - columns[2];
+}
+
+
+bool IsInsideFrustum(float3 center, float3 extent)
+{
+	float4 planes[6];
+	GetFrustumPlanes(planes);
+
+	[unroll]
+	for (int i = 0; i < 6; ++i) {
+		float distance = dot(planes[i].xyz, center) + planes[i].w;
+		float radius = dot(abs(planes[i].xyz), extent);
+		if (distance + radius < 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+bool IsSphereInsideFrustum(float3 center, float radius)
+{
+	float4 planes[6];
+	GetFrustumPlanes(planes);
+
+	[unroll]
+	for (int i = 0; i < 6; ++i) {
+		// The planes are not normalized.
+		float distance = dot(planes[i].xyz, center) + planes[i].w;
+		if (distance + radius * length(planes[i].xyz) < 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+// All triangles face away if the camera is outside the cone of their normals, moved back to enclose the sphere.
+bool IsBackfacing(float3 center, float radius, float3 coneAxis, float coneCutoff)
+{
+	float3 view = center - uniforms.cameraPosition;
+	return dot(view, coneAxis) >= coneCutoff * length(view) + radius;
+}
+
+
+void AddDraw(ObjectData object, uint startIndex, uint numIndices)
+{
+	uint slot;
+	InterlockedAdd(commandCount[0], 1, slot);
+
+	DrawCommand command;
+	command.MVP = mul(object.world, uniforms.viewProjection);
+	command.vertexBuffer = object.vertexBuffer;
+	command.indexBuffer = object.indexBuffer;
+	command.numIndices = numIndices;
+	command.numInstances = 1;
+	command.startIndex = startIndex;
+	command.vertexOffset = 0;
+	command.startInstance = 0;
+	command.padding = 0;
+	commands[slot] = command;
+}
+
+
+[numthreads(LOCAL_SIZE_X, 1, 1)]
+void CSMain(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+	uint index = groupId.y * uniforms.numGroupsX + groupId.x;
+	if (index >= uniforms.numObjects) {
+		return;
+	}
+
+	ObjectData object = objects[index];
+
+	// World space box of the object.
+	float3 center = mul(float4(object.boundsCenter, 1.0f), object.world).xyz;
+	float3 extent = mul(object.boundsExtent, abs((float3x3)object.world));
+
+	if (!object.alwaysVisible && !IsInsideFrustum(center, extent)) {
+		return;
+	}
+
+	if (object.meshletCount == 0) {
+		if (groupIndex == 0) {
+			AddDraw(object, 0, object.numIndices);
+		}
+		return;
+	}
+
+	// Spheres stay spheres in the largest scale, cones only survive rotations and uniform scaling.
+	float3x3 linear = (float3x3)object.world;
+	float3 scales = float3(length(linear[0]), length(linear[1]), length(linear[2]));
+	float maxScale = max(scales.x, max(scales.y, scales.z));
+	float minScale = min(scales.x, min(scales.y, scales.z));
+	bool isConformal = minScale >= 0.99f * maxScale && dot(cross(linear[0], linear[1]), linear[2]) > 0.0f;
+
+	for (uint i = groupIndex; i < object.meshletCount; i += LOCAL_SIZE_X) {
+		Meshlet meshlet = meshlets[object.firstMeshlet + i];
+
+		float3 meshletCenter = mul(float4(meshlet.center * object.quantization.w + object.quantization.xyz, 1.0f), object.world).xyz;
+		float meshletRadius = meshlet.radius * object.quantization.w * maxScale;
+		if (!IsSphereInsideFrustum(meshletCenter, meshletRadius)) {
+			continue;
+		}
+		if (isConformal && IsBackfacing(meshletCenter, meshletRadius, normalize(mul(meshlet.coneAxis, linear)), meshlet.coneCutoff)) {
+			continue;
+		}
+
+		AddDraw(object, meshlet.firstIndex - object.firstIndex, meshlet.indexCount);
+	}
+}
@@ -4,6 +4,10 @@
  * Output 0: Light MVP matrices for each cascade
  * Output 1: Shadow matrices for each cascade
  * Output 2: CSM splits for each cascade
+ * Output 3: CSM extents for each cascade
+ *
+ * With SINGLE_PASS, the input is the depth texture and each group reduces a block of it like the first pass.
+ * The group results are merged with atomics, and the last group to finish computes the matrices.
  */
 
 Texture2D inputTex : register(t0);
@@ -27,6 +31,12 @@ ConstantBuffer<Uniforms> uniforms : register(b0);
 
 #define FLT_MAX 3.402823466e+38
 
+#if SINGLE_PASS
+// x: finished groups, y: min depth, z: max depth, reset each frame by the node.
+// Depths are positive, so their bits compare like the floats.
+RWBuffer<uint> reductionState : register(u4);
+#endif
+
 #define LOCAL_SIZE_X 16
 #define LOCAL_SIZE_Y 16
 
@@ -244,6 +254,25 @@ void Init(uint2 dispatchThreadId, uint groupIndex)
 	localData[groupIndex].y = max(data.y, localData[groupIndex].y);
 }
 
+#if SINGLE_PASS
+//same as the first pass
+void InitSinglePass(uint2 dispatchThreadId, uint groupIndex)
+{
+	uint3 inputTexSize;
+	inputTex.GetDimensions(0, inputTexSize.x, inputTexSize.y, inputTexSize.z);
+	if (any(dispatchThreadId.xy >= inputTexSize.xy))
+		return;
+
+	float depth = inputTex.Load(int3(dispatchThreadId.xy, 0)).x;
+
+	if (depth < 1.0f && depth > 0.0f)
+	{
+		localData[groupIndex].x = min(depth, localData[groupIndex].x);
+		localData[groupIndex].y = max(depth, localData[groupIndex].y);
+	}
+}
+#endif
+
 void Reduce(uint groupIndex, uint idx)
 {
 	localData[groupIndex].x = min(localData[groupIndex].x, localData[groupIndex + idx].x);
@@ -258,6 +287,18 @@ void CSMain(
 	uint groupIndex : SV_GroupIndex //LocalInvocationIndex
 )
 {
+#if SINGLE_PASS
+	{ //INIT
+		localData[groupIndex] = float2(1.0f, 0.0f);
+
+		//same blocks as the first pass: every group reads two groups worth of pixels along x
+		uint2 pixel = uint2(groupId.x * 2, groupId.y) * uint2(LOCAL_SIZE_X, LOCAL_SIZE_Y) + groupThreadId.xy;
+		InitSinglePass(pixel, groupIndex);
+		InitSinglePass(uint2(pixel.x + LOCAL_SIZE_X, pixel.y), groupIndex);
+
+		GroupMemoryBarrierWithGroupSync();
+	}
+#else
 	{ //INIT
 		uint3 inputTexSize;
 		inputTex.GetDimensions(0, inputTexSize.x, inputTexSize.y, inputTexSize.z);
@@ -272,6 +313,7 @@ void CSMain(
 
 		GroupMemoryBarrierWithGroupSync();
 	}
+#endif
 
 	{ //REDUCTION
 		const uint reductionSize = LOCAL_SIZE_X * LOCAL_SIZE_Y;
@@ -289,6 +331,27 @@ void CSMain(
 	//CALC FINAL RESULTS
 	if (!bool(groupIndex))
 	{
+#if SINGLE_PASS
+		uint3 inputTexSize;
+		inputTex.GetDimensions(0, inputTexSize.x, inputTexSize.y, inputTexSize.z);
+		uint2 numGroups = (inputTexSize.xy + uint2(2 * LOCAL_SIZE_X - 1, LOCAL_SIZE_Y - 1)) / uint2(2 * LOCAL_SIZE_X, LOCAL_SIZE_Y);
+
+		InterlockedMin(reductionState[1], asuint(localData[0].x));
+		InterlockedMax(reductionState[2], asuint(localData[0].y));
+		DeviceMemoryBarrier();
+
+		uint numFinished;
+		InterlockedAdd(reductionState[0], 1, numFinished);
+		if (numFinished + 1 != numGroups.x * numGroups.y)
+			return;
+
+		//atomic reads see the results of all the other groups
+		uint minBits, maxBits;
+		InterlockedOr(reductionState[1], 0, minBits);
+		InterlockedOr(reductionState[2], 0, maxBits);
+		localData[0] = float2(asfloat(minBits), asfloat(maxBits));
+#endif
+
 		//construct matrix here
 		float near, far;
 
@@ -13,7 +13,14 @@ struct Cam
 
 ConstantBuffer<Sun> sun : register(b0);
 ConstantBuffer<Cam> cam : register(b1);
-SamplerState theSampler : register(s0);
+Texture2D transmittanceLut : register(t0);
+Texture2D skyViewLut : register(t2);
+SamplerState samp0 : register(s0);
+
+#include "AtmosphereCommon.hlsl"
+
+//angular radius of the sun disk, exaggerated for visibility
+#define SUN_DISK_COS 0.9993908270191
 
 
 struct PS_Input
@@ -51,10 +58,24 @@ PS_Input VSMain(uint vertexId : SV_VertexID)
 
 float4 PSMain(PS_Input input) : SV_TARGET
 {
-	//return float4(0.4, .75, 1.0, 1.0)*max(0.05, smoothstep(-0.15, 0.1, sun.dir.y));
-	float3 lookDir = normalize(input.worldPos - cam.position);
-	float horizon = pow(1.f - pow(dot(lookDir, float3(0, 0, 1)), 2), 10);
-	float corona = pow(0.5f + 0.5f*dot(-sun.dir, lookDir), 4);
-	float sundisk = saturate(600 * (dot(-sun.dir, lookDir) - 0.9993908270191));
-	return 0.8*((float4(0.6, 0.86, 1, 1.0)+sun.color)*0.5f*horizon + sun.color*(corona*0.6+sundisk) + float4(0.4, 0.78, 1, 1)*(1-horizon));
+	float3 lookDir = normalize(input.worldPos.xyz - cam.position.xyz);
+	float3 toSun = normalize(-sun.dir.xyz);
+	float viewHeight = GetViewHeight(cam.position.xyz);
+
+	//the LUT's azimuth is measured from the sun
+	float2 lookHorizontal = lookDir.xy;
+	float2 sunHorizontal = toSun.xy;
+	float horizontalLength = length(lookHorizontal) * length(sunHorizontal);
+	float lightViewCos = horizontalLength > 1e-5 ? dot(lookHorizontal, sunHorizontal) / horizontalLength : 1.0;
+
+	bool intersectGround = RaySphereIntersectNearest(float3(0.0, 0.0, viewHeight), lookDir, atmosphere.bottomRadius) >= 0.0;
+	float3 luminance = skyViewLut.SampleLevel(samp0, SkyViewLutUv(intersectGround, lookDir.z, lightViewCos, viewHeight), 0).rgb;
+
+	float sunDisk = saturate(600 * (dot(toSun, lookDir) - SUN_DISK_COS));
+	if (!intersectGround && sunDisk > 0.0)
+	{
+		luminance += sunDisk * SampleTransmittance(viewHeight, lookDir.z);
+	}
+
+	return float4(luminance * sun.color.rgb * atmosphere.luminanceScale, 1.0);
 }
@@ -0,0 +1,135 @@
+/*
+ * Mip chain generation
+ * Input: one level of the texture
+ * Output: up to four levels below it in one dispatch (box filter),
+ *         or the single level below it (TENT)
+ * SRGB: colors are decoded before filtering and encoded again when stored, alpha is left linear
+ */
+
+struct Uniforms
+{
+	uint numMips;
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+
+Texture2D<float4> inputTex : register(t0);
+RWTexture2D<float4> outputMip1 : register(u0);
+RWTexture2D<float4> outputMip2 : register(u1);
+RWTexture2D<float4> outputMip3 : register(u2);
+RWTexture2D<float4> outputMip4 : register(u3);
+
+#define LOCAL_SIZE_X 8
+#define LOCAL_SIZE_Y 8
+
+groupshared float4 localData[LOCAL_SIZE_X * LOCAL_SIZE_Y];
+
+float3 SrgbToLinear(float3 color)
+{
+	return lerp(pow((color + 0.055f) / 1.055f, 2.4f), color / 12.92f, float3(color <= 0.04045f));
+}
+
+float3 LinearToSrgb(float3 color)
+{
+	return lerp(1.055f * pow(color, 1.0f / 2.4f) - 0.055f, color * 12.92f, float3(color <= 0.0031308f));
+}
+
+float4 LoadInput(int2 coord, int2 inputSize)
+{
+	float4 value = inputTex.Load(int3(clamp(coord, int2(0, 0), inputSize - 1), 0));
+#ifdef SRGB
+	value.rgb = SrgbToLinear(value.rgb);
+#endif
+	return value;
+}
+
+void StoreOutput(RWTexture2D<float4> outputTex, uint2 coord, float4 value)
+{
+	uint2 outputSize;
+	outputTex.GetDimensions(outputSize.x, outputSize.y);
+	if (any(coord >= outputSize))
+		return;
+
+#ifdef SRGB
+	value.rgb = LinearToSrgb(value.rgb);
+#endif
+	outputTex[coord] = value;
+}
+
+float4 FilterInput(uint2 coord)
+{
+	uint2 inputSize;
+	inputTex.GetDimensions(inputSize.x, inputSize.y);
+	int2 first = int2(coord * 2);
+
+#ifdef TENT
+	//4x4 texels weighted 1-3-3-1 in both directions, blurs less than a box of the same size and aliases less than a 2x2 box
+	static const float weights[4] = { 0.125f, 0.375f, 0.375f, 0.125f };
+	float4 result = 0.0f;
+	for (int y = 0; y < 4; ++y)
+	{
+		for (int x = 0; x < 4; ++x)
+		{
+			result += weights[x] * weights[y] * LoadInput(first + int2(x - 1, y - 1), inputSize);
+		}
+	}
+	return result;
+#else
+	return 0.25f * (LoadInput(first, inputSize)
+		+ LoadInput(first + int2(1, 0), inputSize)
+		+ LoadInput(first + int2(0, 1), inputSize)
+		+ LoadInput(first + int2(1, 1), inputSize));
+#endif
+}
+
+//averages the 2x2 block of the previous level starting at groupIndex, the block is stride threads apart
+float4 ReduceLocal(uint groupIndex, uint stride)
+{
+	return 0.25f * (localData[groupIndex]
+		+ localData[groupIndex + stride]
+		+ localData[groupIndex + stride * LOCAL_SIZE_X]
+		+ localData[groupIndex + stride * (LOCAL_SIZE_X + 1)]);
+}
+
+[numthreads(LOCAL_SIZE_X, LOCAL_SIZE_Y, 1)]
+void CSMain(
+	uint3 groupThreadId : SV_GroupThreadID,
+	uint3 dispatchThreadId : SV_DispatchThreadID,
+	uint groupIndex : SV_GroupIndex
+	)
+{
+	//out of bounds threads keep going, their edge-clamped values feed the coarser levels
+	float4 value = FilterInput(dispatchThreadId.xy);
+	StoreOutput(outputMip1, dispatchThreadId.xy, value);
+	if (uniforms.numMips == 1)
+		return;
+
+	localData[groupIndex] = value;
+	GroupMemoryBarrierWithGroupSync();
+
+	if (all(groupThreadId.xy % 2 == 0))
+	{
+		value = ReduceLocal(groupIndex, 1);
+		StoreOutput(outputMip2, dispatchThreadId.xy / 2, value);
+		localData[groupIndex] = value;
+	}
+	if (uniforms.numMips == 2)
+		return;
+	GroupMemoryBarrierWithGroupSync();
+
+	if (all(groupThreadId.xy % 4 == 0))
+	{
+		value = ReduceLocal(groupIndex, 2);
+		StoreOutput(outputMip3, dispatchThreadId.xy / 4, value);
+		localData[groupIndex] = value;
+	}
+	if (uniforms.numMips == 3)
+		return;
+	GroupMemoryBarrierWithGroupSync();
+
+	if (groupIndex == 0)
+	{
+		value = ReduceLocal(groupIndex, 4);
+		StoreOutput(outputMip4, dispatchThreadId.xy / 8, value);
+	}
+}
@@ -0,0 +1,56 @@
+/*
+ * Hierarchical depth buffer, one level per dispatch
+ * Input: depth texture (FROM_DEPTH), or the previous level of the pyramid
+ * Output X: min depth of the footprint
+ * Output Y: max depth of the footprint
+ */
+
+Texture2D inputTex : register(t0);
+RWTexture2D<float2> outputTex : register(u0);
+
+#define LOCAL_SIZE_X 8
+#define LOCAL_SIZE_Y 8
+
+float2 LoadInput(int2 coord)
+{
+#ifdef FROM_DEPTH
+	float depth = inputTex.Load(int3(coord, 0)).x;
+	return float2(depth, depth);
+#else
+	return inputTex.Load(int3(coord, 0)).xy;
+#endif
+}
+
+[numthreads(LOCAL_SIZE_X, LOCAL_SIZE_Y, 1)]
+void CSMain(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+	uint2 outputSize;
+	outputTex.GetDimensions(outputSize.x, outputSize.y);
+	if (any(dispatchThreadId.xy >= outputSize))
+		return;
+
+	uint3 inputSize;
+	inputTex.GetDimensions(0, inputSize.x, inputSize.y, inputSize.z);
+
+	//each texel covers 2x2 input texels,
+	//the last row and column also cover the leftover input of odd sizes
+	int2 first = int2(dispatchThreadId.xy * 2);
+	int2 last = min(first + 1, int2(inputSize.xy) - 1);
+	if (dispatchThreadId.x == outputSize.x - 1)
+		last.x = inputSize.x - 1;
+	if (dispatchThreadId.y == outputSize.y - 1)
+		last.y = inputSize.y - 1;
+
+	float2 result = float2(1.0f, 0.0f);
+	for (int y = first.y; y <= last.y; ++y)
+	{
+		for (int x = first.x; x <= last.x; ++x)
+		{
+			float2 value = LoadInput(int2(x, y));
+			result.x = min(result.x, value.x);
+			result.y = max(result.y, value.y);
+		}
+	}
+
+	outputTex[dispatchThreadId.xy] = result;
+}
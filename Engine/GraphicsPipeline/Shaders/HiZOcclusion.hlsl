@@ -0,0 +1,52 @@
+/*
+ * Hierarchical depth occlusion test, the GPU side of DepthPyramid::IsOccluded
+ * hiZTex: full mip chain from the HiZBuffer node, Y holds the max depth of the footprint
+ * Returns true if the world space box is certainly behind the stored depth.
+ * Boxes that are off screen or cross the near plane are never occluded.
+ */
+
+bool IsOccludedHiZ(Texture2D<float2> hiZTex, float4x4 viewProjection, float3 boundsMin, float3 boundsMax)
+{
+	float2 rectMin = float2(1.0f, 1.0f);
+	float2 rectMax = float2(0.0f, 0.0f);
+	float nearestDepth = 1.0f;
+
+	[unroll]
+	for (uint i = 0; i < 8; ++i)
+	{
+		float3 corner = float3((i & 1) ? boundsMax.x : boundsMin.x,
+							   (i & 2) ? boundsMax.y : boundsMin.y,
+							   (i & 4) ? boundsMax.z : boundsMin.z);
+		float4 clip = mul(float4(corner, 1.0f), viewProjection);
+		if (clip.w <= 1e-6f)
+			return false;
+
+		float3 ndc = clip.xyz / clip.w;
+		//texture space, y points down
+		float2 uv = float2(ndc.x * 0.5f + 0.5f, 0.5f - ndc.y * 0.5f);
+		rectMin = min(rectMin, uv);
+		rectMax = max(rectMax, uv);
+		nearestDepth = min(nearestDepth, ndc.z);
+	}
+	if (nearestDepth < 0.0f || any(rectMax <= 0.0f) || any(rectMin >= 1.0f))
+		return false;
+	rectMin = saturate(rectMin);
+	rectMax = saturate(rectMax);
+
+	uint width, height, numLevels;
+	hiZTex.GetDimensions(0, width, height, numLevels);
+
+	//a span no longer than the texel size touches at most 2x2 texels
+	float2 size = (rectMax - rectMin) * float2(width, height);
+	float level = clamp(ceil(log2(max(max(size.x, size.y), 1.0f))), 0.0f, float(numLevels - 1));
+
+	uint levelWidth, levelHeight;
+	hiZTex.GetDimensions(uint(level), levelWidth, levelHeight, numLevels);
+	int2 levelSize = int2(levelWidth, levelHeight);
+	int2 first = min(int2(rectMin * levelSize), levelSize - 1);
+	int2 last = max(first, min(int2(ceil(rectMax * levelSize)) - 1, levelSize - 1));
+
+	float occluderDepth = max(max(hiZTex.Load(int3(first.x, first.y, level)).y, hiZTex.Load(int3(last.x, first.y, level)).y),
+							  max(hiZTex.Load(int3(first.x, last.y, level)).y, hiZTex.Load(int3(last.x, last.y, level)).y));
+	return nearestDepth > occluderDepth;
+}
@@ -1,19 +1,25 @@
+// Must match ClusteredLightCulling.cpp.
 struct LightData
 {
-	float4 diffuseColor;
-	float4 vsPosition;
-	float4 attenuationEnd;
+	float3 vsPosition;
+	float range;
+	float3 color;
+	float spotCosOuter; // -1 for point lights
+	float3 vsDirection;
+	float spotCosInner;
+	float3 boundsCenter;
+	float boundsRadius;
 };
 
 struct Uniforms
 {
 	float4x4 invV;
-	LightData ld[10];
 	float4 screenDimensions;
 	float4 vsCamPos;
-	int groupSizeX, groupSizeY;
+	uint clusterCountX, clusterCountY, clusterCountZ, clusterTileSize;
+	float clusterDepthScale, clusterDepthBias;
 	float halfExposureFramerate, //0.5 * exposure time (% of time exposure is open -> 0.75?) * frame rate (s? or fps?)
 		maxMotionBlurRadius; //pixels
 };
 
-ConstantBuffer<Uniforms> uniforms : register(b600);
\ No newline at end of file
+ConstantBuffer<Uniforms> uniforms : register(b600);
@@ -2,6 +2,9 @@
  * Luminance reduction shader (final pass)
  * Input: reduction texture
  * Output 0: average luminance
+ *
+ * With SINGLE_PASS, the input is the luminance texture and each group reduces a block of it like the first pass.
+ * The group averages are summed with atomics, and the last group to finish computes the result.
  */
 
 Texture2D inputTex : register(t0);
@@ -16,6 +19,14 @@ ConstantBuffer<Uniforms> uniforms : register(b0);
 
 #define FLT_MAX 3.402823466e+38
 
+#if SINGLE_PASS
+// x: finished groups, y: sum of the group averages in fixed point, reset each frame by the node.
+// Log luminance is within +-32, so the sum fits 32 bits for more than 60000 groups.
+RWBuffer<uint> reductionState : register(u1);
+
+#define FIXED_POINT_SCALE 1024.0
+#endif
+
 #define LOCAL_SIZE_X 16
 #define LOCAL_SIZE_Y 16
 
@@ -36,6 +47,18 @@ void Init(uint2 dispatchThreadId, uint groupIndex)
 	localData[groupIndex] = data;
 }
 
+#if SINGLE_PASS
+void InitSinglePass(uint2 dispatchThreadId, uint groupIndex)
+{
+	uint3 inputTexSize;
+	inputTex.GetDimensions(0, inputTexSize.x, inputTexSize.y, inputTexSize.z);
+	if (any(dispatchThreadId.xy >= inputTexSize.xy))
+		return;
+
+	localData[groupIndex] += inputTex.Load(int3(dispatchThreadId.xy, 0)).x;
+}
+#endif
+
 void Reduce(uint groupIndex, uint idx)
 {
 	localData[groupIndex] += localData[groupIndex + idx];
@@ -49,6 +72,18 @@ void CSMain(
 	uint groupIndex : SV_GroupIndex //LocalInvocationIndex
 )
 {
+#if SINGLE_PASS
+	{ //INIT
+		localData[groupIndex] = 0.0;
+
+		//same blocks as the first pass: every group reads two groups worth of pixels along x
+		uint2 pixel = uint2(groupId.x * 2, groupId.y) * uint2(LOCAL_SIZE_X, LOCAL_SIZE_Y) + groupThreadId.xy;
+		InitSinglePass(pixel, groupIndex);
+		InitSinglePass(uint2(pixel.x + LOCAL_SIZE_X, pixel.y), groupIndex);
+
+		GroupMemoryBarrierWithGroupSync();
+	}
+#else
 	{ //INIT
 		uint3 inputTexSize;
 		inputTex.GetDimensions(0, inputTexSize.x, inputTexSize.y, inputTexSize.z);
@@ -63,6 +98,7 @@ void CSMain(
 
 		GroupMemoryBarrierWithGroupSync();
 	}
+#endif
 
 	{ //REDUCTION
 		const uint reductionSize = LOCAL_SIZE_X * LOCAL_SIZE_Y;
@@ -82,6 +118,28 @@ void CSMain(
 	{
 		float avgLum = localData[0] * (1.0 / (LOCAL_SIZE_X * LOCAL_SIZE_Y));
 
+#if SINGLE_PASS
+		uint3 inputTexSize;
+		inputTex.GetDimensions(0, inputTexSize.x, inputTexSize.y, inputTexSize.z);
+		uint2 numGroups = (inputTexSize.xy + uint2(2 * LOCAL_SIZE_X - 1, LOCAL_SIZE_Y - 1)) / uint2(2 * LOCAL_SIZE_X, LOCAL_SIZE_Y);
+		uint numGroupsTotal = numGroups.x * numGroups.y;
+
+		//every thread summed two pixels
+		float groupAvgLum = localData[0] * (1.0 / (2 * LOCAL_SIZE_X * LOCAL_SIZE_Y));
+		InterlockedAdd(reductionState[1], asuint(int(round(groupAvgLum * FIXED_POINT_SCALE))));
+		DeviceMemoryBarrier();
+
+		uint numFinished;
+		InterlockedAdd(reductionState[0], 1, numFinished);
+		if (numFinished + 1 != numGroupsTotal)
+			return;
+
+		//an atomic read sees the sums of all the other groups
+		uint sum;
+		InterlockedOr(reductionState[1], 0, sum);
+		avgLum = float(asint(sum)) / (FIXED_POINT_SCALE * numGroupsTotal);
+#endif
+
 		const float delta = 0.0001;
 
 		float currLum = uniforms.middleGrey / (exp(avgLum) - delta);
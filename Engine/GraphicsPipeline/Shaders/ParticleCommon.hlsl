@@ -0,0 +1,52 @@
+/*
+ * Particle layout shared by the simulation and the drawing
+ */
+
+#define MATERIAL_COLLIDES 0x01000000
+
+// Must match SimulateParticles::ParticleData.
+struct Particle
+{
+	float3 position;
+	float age;
+	float3 velocity;
+	float lifetime;
+	float3 acceleration;
+	float drag;
+	uint2 startColor; //half precision rgba
+	uint2 endColor;
+	uint size; //half precision start and end size
+	uint material; //unorm8 restitution, additive, emissive, and MATERIAL_COLLIDES
+};
+
+uint PackHalf2(float2 v)
+{
+	return f32tof16(v.x) | (f32tof16(v.y) << 16);
+}
+
+float2 UnpackHalf2(uint v)
+{
+	return float2(f16tof32(v), f16tof32(v >> 16));
+}
+
+uint2 PackHalf4(float4 v)
+{
+	return uint2(PackHalf2(v.xy), PackHalf2(v.zw));
+}
+
+float4 UnpackHalf4(uint2 v)
+{
+	return float4(UnpackHalf2(v.x), UnpackHalf2(v.y));
+}
+
+uint PackMaterial(float restitution, float additive, float emissive)
+{
+	uint3 quantized = uint3(saturate(float3(restitution, additive, emissive)) * 255.0 + 0.5);
+	return quantized.x | (quantized.y << 8) | (quantized.z << 16) | (restitution >= 0.0 ? MATERIAL_COLLIDES : 0);
+}
+
+//restitution, additive and emissive
+float3 UnpackMaterial(uint material)
+{
+	return float3(material & 0xFF, (material >> 8) & 0xFF, (material >> 16) & 0xFF) / 255.0;
+}
@@ -0,0 +1,300 @@
+/*
+ * Particle simulation, the pass is picked by a macro
+ * PASS_RESET: frees all particles
+ * PASS_EMIT: spawns the particles of the emitters, a thread each
+ * PASS_SIMULATE_ARGUMENTS: sizes the simulation to the live particles
+ * PASS_SIMULATE: ages, moves and collides the live particles, compacts the survivors into the other list
+ * PASS_DRAW_ARGUMENTS: sizes the draw and the sort to the survivors
+ */
+
+#include "ParticleCommon.hlsl"
+
+#define GROUP_SIZE 256 //must match SimulateParticles.cpp
+#define SORT_CHUNK_SIZE 1024 //must match ParticleSort.hlsl
+
+//counters, must match SimulateParticles.cpp
+#define COUNTER_ALIVE 0 //one for each list
+#define COUNTER_DEAD 2
+#define COUNTER_SORT 3
+
+//indirect arguments, must match ParticleArguments of SimulateParticles.cpp
+#define ARG_SIMULATE 0
+#define ARG_SORT 3
+#define ARG_DRAW 6
+
+#define INVALID_KEY 0xFFFFFFFF
+
+static const float PI = 3.14159265359;
+
+//must match SimulateParticles::EmitterData
+struct Emitter
+{
+	float3 position; float radius;
+	float3 direction; float cosSpread;
+	float3 acceleration; float drag;
+	float4 startColor;
+	float4 endColor;
+	float speed, speedVariation;
+	float lifetime, lifetimeVariation;
+	float startSize, endSize;
+	float restitution, additive;
+	float emissive;
+	uint firstParticle;
+	uint count;
+	uint seed;
+};
+
+struct Uniforms
+{
+	float4x4 viewProj, invViewProj, view;
+	float4 depthSize;
+	float3 cameraPosition; float deltaTime;
+	float collisionThickness;
+	uint capacity;
+	uint numEmitters;
+	uint emitCount;
+	uint source;
+	uint3 dummy;
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+Texture2D<float> depthTex : register(t0);
+StructuredBuffer<Emitter> emitters : register(t1);
+RWStructuredBuffer<Particle> particles : register(u0);
+RWStructuredBuffer<uint> deadList : register(u1);
+RWStructuredBuffer<uint2> sourceList : register(u2); //sort key and particle index
+RWStructuredBuffer<uint2> targetList : register(u3);
+RWBuffer<uint> counters : register(u4);
+RWBuffer<uint> arguments : register(u5);
+
+
+uint Hash(uint x)
+{
+	//pcg
+	uint state = x * 747796405u + 2891336453u;
+	uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+	return (word >> 22u) ^ word;
+}
+
+float Random(inout uint seed)
+{
+	seed = Hash(seed);
+	return float(seed >> 8) * (1.0 / 16777216.0);
+}
+
+//uniform on the cone of the half angle acos(cosSpread) around the axis
+float3 RandomDirection(inout uint seed, float3 axis, float cosSpread)
+{
+	float cosTheta = lerp(1.0, cosSpread, Random(seed));
+	float sinTheta = sqrt(saturate(1.0 - cosTheta * cosTheta));
+	float phi = 2.0 * PI * Random(seed);
+
+	float3 up = abs(axis.z) < 0.999 ? float3(0, 0, 1) : float3(1, 0, 0);
+	float3 tangent = normalize(cross(up, axis));
+	float3 bitangent = cross(axis, tangent);
+	return (tangent * cos(phi) + bitangent * sin(phi)) * sinTheta + axis * cosTheta;
+}
+
+float3 ScreenToWorld(int2 pixel)
+{
+	pixel = clamp(pixel, int2(0, 0), int2(uniforms.depthSize.xy) - 1);
+	float depth = depthTex.Load(int3(pixel, 0));
+	float2 uv = (float2(pixel) + 0.5) * uniforms.depthSize.zw;
+	float4 ndc = float4(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0, depth, 1.0);
+	float4 worldPos = mul(ndc, uniforms.invViewProj);
+	return worldPos.xyz / worldPos.w;
+}
+
+//bounces the particle off the depth buffer if it moved behind it
+void Collide(inout float3 position, inout float3 velocity, float restitution)
+{
+	float4 clip = mul(float4(position, 1.0), uniforms.viewProj);
+	if (clip.w <= 0.0)
+	{
+		return;
+	}
+	float2 ndc = clip.xy / clip.w;
+	float2 uv = float2(ndc.x * 0.5 + 0.5, 0.5 - ndc.y * 0.5);
+	if (any(uv < 0.0) || any(uv >= 1.0))
+	{
+		return;
+	}
+
+	int2 pixel = int2(uv * uniforms.depthSize.xy);
+	if (depthTex.Load(int3(pixel, 0)) >= 1.0)
+	{
+		return; //sky
+	}
+
+	//the normal from the neighbors on the same surface, the closer of the two on each axis
+	float3 surface = ScreenToWorld(pixel);
+	float3 right = ScreenToWorld(pixel + int2(1, 0)) - surface;
+	float3 left = surface - ScreenToWorld(pixel - int2(1, 0));
+	float3 down = ScreenToWorld(pixel + int2(0, 1)) - surface;
+	float3 up = surface - ScreenToWorld(pixel - int2(0, 1));
+	float3 dx = dot(right, right) < dot(left, left) ? right : left;
+	float3 dy = dot(down, down) < dot(up, up) ? down : up;
+	float3 normal = cross(dx, dy);
+	if (dot(normal, normal) < 1e-12)
+	{
+		return;
+	}
+	normal = normalize(normal);
+	if (dot(normal, uniforms.cameraPosition - surface) < 0.0)
+	{
+		normal = -normal;
+	}
+
+	float distance = dot(position - surface, normal);
+	if (distance < 0.0 && distance > -uniforms.collisionThickness)
+	{
+		position -= normal * distance;
+		float normalSpeed = dot(velocity, normal);
+		if (normalSpeed < 0.0)
+		{
+			velocity -= (1.0 + restitution) * normalSpeed * normal;
+		}
+	}
+}
+
+
+[numthreads(GROUP_SIZE, 1, 1)]
+void CSMain(uint3 dispatchId : SV_DispatchThreadID)
+{
+	uint id = dispatchId.x;
+	uint target = uniforms.source ^ 1;
+
+#if PASS_RESET
+	if (id < uniforms.capacity)
+	{
+		deadList[id] = id;
+	}
+	if (id == 0)
+	{
+		counters[COUNTER_ALIVE + 0] = 0;
+		counters[COUNTER_ALIVE + 1] = 0;
+		counters[COUNTER_DEAD] = uniforms.capacity;
+		counters[COUNTER_SORT] = 0;
+	}
+#endif
+
+#if PASS_EMIT
+	if (id >= uniforms.emitCount)
+	{
+		return;
+	}
+
+	//the emitters are ordered by their first particle
+	uint first = 0;
+	uint last = uniforms.numEmitters - 1;
+	while (first < last)
+	{
+		uint middle = (first + last + 1) / 2;
+		if (emitters[middle].firstParticle <= id)
+		{
+			first = middle;
+		}
+		else
+		{
+			last = middle - 1;
+		}
+	}
+	Emitter emitter = emitters[first];
+
+	//take a free particle, give the count back if there was none
+	uint freeCount;
+	InterlockedAdd(counters[COUNTER_DEAD], 0xFFFFFFFF, freeCount);
+	if (freeCount == 0 || freeCount > uniforms.capacity)
+	{
+		InterlockedAdd(counters[COUNTER_DEAD], 1);
+		return;
+	}
+	uint index = deadList[freeCount - 1];
+
+	uint seed = Hash(emitter.seed ^ Hash(id));
+	float3 offset = RandomDirection(seed, float3(0, 0, 1), -1.0) * emitter.radius * pow(Random(seed), 1.0 / 3.0);
+	float speed = emitter.speed + (Random(seed) * 2.0 - 1.0) * emitter.speedVariation;
+
+	Particle p;
+	p.position = emitter.position + offset;
+	p.age = 0.0;
+	p.velocity = RandomDirection(seed, emitter.direction, emitter.cosSpread) * speed;
+	p.lifetime = max(emitter.lifetime * (1.0 + (Random(seed) * 2.0 - 1.0) * emitter.lifetimeVariation), 1e-3);
+	p.acceleration = emitter.acceleration;
+	p.drag = emitter.drag;
+	p.startColor = PackHalf4(emitter.startColor);
+	p.endColor = PackHalf4(emitter.endColor);
+	p.size = PackHalf2(float2(emitter.startSize, emitter.endSize));
+	p.material = PackMaterial(emitter.restitution, emitter.additive, emitter.emissive);
+	particles[index] = p;
+
+	//there is a place for every particle, free or not
+	uint slot;
+	InterlockedAdd(counters[COUNTER_ALIVE + uniforms.source], 1, slot);
+	sourceList[slot] = uint2(INVALID_KEY, index);
+#endif
+
+#if PASS_SIMULATE_ARGUMENTS
+	uint alive = counters[COUNTER_ALIVE + uniforms.source];
+	arguments[ARG_SIMULATE + 0] = (alive + GROUP_SIZE - 1) / GROUP_SIZE;
+	arguments[ARG_SIMULATE + 1] = 1;
+	arguments[ARG_SIMULATE + 2] = 1;
+	counters[COUNTER_ALIVE + target] = 0;
+#endif
+
+#if PASS_SIMULATE
+	if (id >= counters[COUNTER_ALIVE + uniforms.source])
+	{
+		return;
+	}
+
+	uint index = sourceList[id].y;
+	Particle p = particles[index];
+	float dt = uniforms.deltaTime;
+
+	p.age += dt;
+	if (p.age >= p.lifetime)
+	{
+		uint slot;
+		InterlockedAdd(counters[COUNTER_DEAD], 1, slot);
+		deadList[slot] = index;
+		return;
+	}
+
+	p.velocity += p.acceleration * dt;
+	p.velocity *= exp(-p.drag * dt);
+	p.position += p.velocity * dt;
+	if (p.material & MATERIAL_COLLIDES)
+	{
+		Collide(p.position, p.velocity, UnpackMaterial(p.material).x);
+	}
+	particles[index] = p;
+
+	//far ones first when sorted, positive floats order as their bits do
+	float viewDepth = mul(float4(p.position, 1.0), uniforms.view).z;
+	uint key = viewDepth > 0.0 ? ~asuint(viewDepth) : INVALID_KEY;
+
+	uint slot;
+	InterlockedAdd(counters[COUNTER_ALIVE + target], 1, slot);
+	targetList[slot] = uint2(key, index);
+#endif
+
+#if PASS_DRAW_ARGUMENTS
+	uint alive = counters[COUNTER_ALIVE + target];
+	arguments[ARG_DRAW + 0] = 4;
+	arguments[ARG_DRAW + 1] = alive;
+	arguments[ARG_DRAW + 2] = 0;
+	arguments[ARG_DRAW + 3] = 0;
+
+	//the bitonic sort sorts a power of two, the elements past the live ones are taken as the last
+	uint sortCount = SORT_CHUNK_SIZE;
+	while (sortCount < alive)
+	{
+		sortCount <<= 1;
+	}
+	counters[COUNTER_SORT] = sortCount;
+	arguments[ARG_SORT + 0] = sortCount / SORT_CHUNK_SIZE;
+	arguments[ARG_SORT + 1] = 1;
+	arguments[ARG_SORT + 2] = 1;
+#endif
+}
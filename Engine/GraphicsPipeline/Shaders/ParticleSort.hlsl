@@ -0,0 +1,124 @@
+/*
+ * Bitonic sort of the particle draw list by key, ascending, the pass is picked by a macro
+ * PASS_LOCAL: sorts each chunk of SORT_CHUNK_SIZE elements in shared memory
+ * PASS_GLOBAL: one compare and swap step across chunks, from global memory
+ * PASS_MERGE: the steps within a chunk of merging sequences longer than a chunk, in shared memory
+ * A group handles a chunk, or as many elements with the global step.
+ * The counters hold the length sorted, a power of two, the elements past the live ones are taken as the last.
+ */
+
+#define SORT_CHUNK_SIZE 1024 //must match SimulateParticles.cpp
+#define GROUP_SIZE (SORT_CHUNK_SIZE / 2)
+#define COUNTER_ALIVE 0 //must match ParticleSimulate.hlsl
+#define COUNTER_SORT 3
+#define INVALID_KEY 0xFFFFFFFF
+
+struct Uniforms
+{
+	float4x4 viewProj, invViewProj, view;
+	float4 depthSize;
+	float3 cameraPosition; float deltaTime;
+	float collisionThickness;
+	uint capacity;
+	uint numEmitters;
+	uint emitCount;
+	uint source;
+	uint3 dummy;
+};
+
+struct SortUniforms
+{
+	uint k; //length of the sorted sequences merged
+	uint j; //distance of the compared elements
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+ConstantBuffer<SortUniforms> sortUniforms : register(b1);
+RWStructuredBuffer<uint2> targetList : register(u3); //sort key and particle index
+RWBuffer<uint> counters : register(u4);
+
+groupshared uint2 chunk[SORT_CHUNK_SIZE];
+
+
+void CompareAndSwap(inout uint2 a, inout uint2 b, bool ascending)
+{
+	if ((a.x > b.x) == ascending)
+	{
+		uint2 temp = a;
+		a = b;
+		b = temp;
+	}
+}
+
+//the steps of the distances j, j/2, ... 1 of merging sequences of length k, in shared memory
+void SortChunk(uint chunkStart, uint groupThreadId, uint k, uint j)
+{
+	for (; j > 0; j >>= 1)
+	{
+		uint i = 2 * j * (groupThreadId / j) + groupThreadId % j;
+		uint l = i + j;
+		uint2 a = chunk[i];
+		uint2 b = chunk[l];
+		CompareAndSwap(a, b, ((chunkStart + i) & k) == 0);
+		chunk[i] = a;
+		chunk[l] = b;
+		GroupMemoryBarrierWithGroupSync();
+	}
+}
+
+
+[numthreads(GROUP_SIZE, 1, 1)]
+void CSMain(uint3 groupId : SV_GroupID, uint3 groupThreadId : SV_GroupThreadID, uint3 dispatchId : SV_DispatchThreadID)
+{
+	uint sortCount = counters[COUNTER_SORT];
+
+#if PASS_GLOBAL
+	if (sortUniforms.k > sortCount)
+	{
+		return;
+	}
+
+	uint t = dispatchId.x;
+	uint j = sortUniforms.j;
+	uint i = 2 * j * (t / j) + t % j;
+	uint l = i + j;
+	uint2 a = targetList[i];
+	uint2 b = targetList[l];
+	CompareAndSwap(a, b, (i & sortUniforms.k) == 0);
+	targetList[i] = a;
+	targetList[l] = b;
+#else
+	#if PASS_MERGE
+	if (sortUniforms.k > sortCount)
+	{
+		return;
+	}
+	#endif
+
+	uint chunkStart = groupId.x * SORT_CHUNK_SIZE;
+	uint first = groupThreadId.x;
+	uint second = groupThreadId.x + GROUP_SIZE;
+
+	#if PASS_LOCAL
+	//the first pass pads the live particles with keys that go last
+	uint alive = counters[COUNTER_ALIVE + (uniforms.source ^ 1)];
+	chunk[first] = chunkStart + first < alive ? targetList[chunkStart + first] : uint2(INVALID_KEY, 0);
+	chunk[second] = chunkStart + second < alive ? targetList[chunkStart + second] : uint2(INVALID_KEY, 0);
+	GroupMemoryBarrierWithGroupSync();
+
+	for (uint k = 2; k <= SORT_CHUNK_SIZE; k <<= 1)
+	{
+		SortChunk(chunkStart, groupThreadId.x, k, k / 2);
+	}
+	#else
+	chunk[first] = targetList[chunkStart + first];
+	chunk[second] = targetList[chunkStart + second];
+	GroupMemoryBarrierWithGroupSync();
+
+	SortChunk(chunkStart, groupThreadId.x, sortUniforms.k, sortUniforms.j);
+	#endif
+
+	targetList[chunkStart + first] = chunk[first];
+	targetList[chunkStart + second] = chunk[second];
+#endif
+}
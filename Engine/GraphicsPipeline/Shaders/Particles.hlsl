@@ -0,0 +1,139 @@
+/*
+ * Lit camera facing billboards of the simulated particles, an instance each
+ * The vertex shader lights the particle at its center, the pixel shader shapes a soft disc
+ * and fades it out near the scene behind it.
+ */
+
+#include "ParticleCommon.hlsl"
+
+static const float PI = 3.14159265359;
+
+//must match ClusteredLightCulling::LightData
+struct LightData
+{
+	float3 vsPosition;
+	float range;
+	float3 color;
+	float spotCosOuter;
+	float3 vsDirection;
+	float spotCosInner;
+	float3 boundsCenter;
+	float boundsRadius;
+};
+
+struct Uniforms
+{
+	float4x4 view, projection, invProjection;
+	float4 targetSize;
+	float3 sunColor; float ambientIntensity;
+	float2 depthScale;
+	float clusterDepthScale, clusterDepthBias;
+	uint clusterCountX, clusterCountY, clusterCountZ, clusterTileSize;
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+StructuredBuffer<Particle> particles : register(t0);
+StructuredBuffer<uint2> drawList : register(t1); //sort key and particle index
+Texture2D<float> depthTex : register(t2);
+StructuredBuffer<uint2> lightClusters : register(t3);
+StructuredBuffer<LightData> lights : register(t4);
+StructuredBuffer<uint> lightIndices : register(t5);
+
+struct PS_Input
+{
+	float4 position : SV_POSITION;
+	float4 color : COLOR; //premultiplied
+	float2 corner : TEXCOORD0; //-1 to 1 over the quad
+	float vsDepth : TEXCOORD1;
+	float radius : TEXCOORD2;
+};
+
+
+float3 GetSkyColor()
+{
+	return float3(110, 165, 255) / 255.0;
+}
+
+//light reaching the center from all directions, the particle scatters it evenly
+float3 GetLighting(float3 vsPos, float4 ndc)
+{
+	// Cluster of the center, same numbering as ClusteredLightCulling.
+	float2 pixel = float2(ndc.x * 0.5 + 0.5, 0.5 - ndc.y * 0.5) * uniforms.targetSize.xy;
+	uint2 tile = min(uint2(max(pixel, 0.0)) / uniforms.clusterTileSize, uint2(uniforms.clusterCountX, uniforms.clusterCountY) - 1);
+	float slice = log2(max(vsPos.z, 1e-4)) * uniforms.clusterDepthScale + uniforms.clusterDepthBias;
+	uint clusterIndex = (uint(clamp(slice, 0.0, float(uniforms.clusterCountZ - 1))) * uniforms.clusterCountY + tile.y) * uniforms.clusterCountX + tile.x;
+	uint2 cluster = lightClusters[clusterIndex];
+
+	float3 incoming = uniforms.sunColor * 10.0;
+	for (uint c = 0; c < cluster.y; ++c)
+	{
+		LightData light = lights[lightIndices[cluster.x + c]];
+
+		float3 lightDir = light.vsPosition - vsPos;
+		float distance = length(lightDir);
+		lightDir /= max(distance, 1e-4);
+
+		float attenuation = saturate((light.range - distance) / light.range);
+		if (light.spotCosOuter > -1.0)
+		{
+			attenuation *= smoothstep(light.spotCosOuter, light.spotCosInner, dot(-lightDir, light.vsDirection));
+		}
+		incoming += light.color * attenuation;
+	}
+
+	return incoming / PI + GetSkyColor() * uniforms.ambientIntensity;
+}
+
+
+PS_Input VSMain(uint vertexId : SV_VertexID, uint instanceId : SV_InstanceID)
+{
+	Particle p = particles[drawList[instanceId].y];
+	float t = saturate(p.age / p.lifetime);
+	float4 color = lerp(UnpackHalf4(p.startColor), UnpackHalf4(p.endColor), t);
+	float2 sizes = UnpackHalf2(p.size);
+	float radius = 0.5 * lerp(sizes.x, sizes.y, t);
+	float3 material = UnpackMaterial(p.material);
+
+	float3 vsCenter = mul(float4(p.position, 1.0), uniforms.view).xyz;
+	float4 ndcCenter = mul(float4(vsCenter, 1.0), uniforms.projection);
+	ndcCenter /= max(ndcCenter.w, 1e-4);
+
+	color.rgb *= lerp(GetLighting(vsCenter, ndcCenter), 1.0, material.z);
+	color.rgb *= color.a;
+	color.a *= 1.0 - material.y;
+
+	//strip order: 0 (-1,-1), 1 (1,-1), 2 (-1,1), 3 (1,1)
+	float2 corner = float2(vertexId & 1, vertexId >> 1) * 2.0 - 1.0;
+	float3 vsPos = vsCenter + float3(corner * radius, 0.0);
+
+	PS_Input output;
+	output.position = mul(float4(vsPos, 1.0), uniforms.projection);
+	if (vsCenter.z <= 0.0)
+	{
+		output.position = float4(0, 0, 0, 0); //behind the camera, degenerate
+	}
+	output.color = color;
+	output.corner = corner;
+	output.vsDepth = vsCenter.z;
+	output.radius = max(radius, 1e-4);
+	return output;
+}
+
+
+float4 PSMain(PS_Input input) : SV_TARGET
+{
+	float shape = saturate(1.0 - dot(input.corner, input.corner));
+
+	float depth = depthTex.Load(int3(input.position.xy * uniforms.depthScale, 0));
+	float2 ndc = float2(input.position.x * uniforms.targetSize.z * 2.0 - 1.0, 1.0 - input.position.y * uniforms.targetSize.w * 2.0);
+	float4 vsScene = mul(float4(ndc, depth, 1.0), uniforms.invProjection);
+	float sceneDepth = vsScene.z / vsScene.w;
+	float fade = saturate((sceneDepth - input.vsDepth) / input.radius);
+
+	float coverage = shape * shape * fade;
+	if (coverage <= 0.0)
+	{
+		discard;
+	}
+	return input.color * coverage;
+}
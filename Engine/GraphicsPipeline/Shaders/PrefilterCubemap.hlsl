@@ -0,0 +1,221 @@
+/*
+ * Cubemap prefiltering for image based lighting
+ * RADIANCE: copies the source to the top level of the radiance chain (copy), or box filters the level above
+ * IRRADIANCE: projects a radiance level to 3rd order spherical harmonics of the cosine convolved irradiance, in a single group
+ * SPECULAR: convolves the radiance with the GGX lobe of the roughness, importance sampled,
+ *           samples read the radiance level whose texels cover about the solid angle of a sample
+ * Faces are in D3D order: +X, -X, +Y, -Y, +Z, -Z
+ */
+
+struct Uniforms
+{
+	float roughness;
+	uint sampleCount;
+	float radianceSize;
+	float radianceMips;
+	uint copy;
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+
+SamplerState linearSampler : register(s0);
+
+#if defined(SPECULAR)
+TextureCube<float4> inputTex : register(t0);
+RWTexture2DArray<float4> outputTex : register(u0);
+#elif defined(IRRADIANCE)
+Texture2DArray<float4> inputTex : register(t0);
+RWStructuredBuffer<float4> outputSh : register(u0);
+#else
+Texture2DArray<float4> inputTex : register(t0);
+RWTexture2DArray<float4> outputTex : register(u0);
+#endif
+
+static const float PI = 3.14159265f;
+
+#define LOCAL_SIZE_X 8
+#define LOCAL_SIZE_Y 8
+
+//direction through the center of a texel of a face
+float3 FaceDirection(uint face, float2 coord, float size)
+{
+	float2 uv = 2.0f * (coord + 0.5f) / size - 1.0f;
+	float3 dirs[6] = {
+		float3(1.0f, -uv.y, -uv.x),
+		float3(-1.0f, -uv.y, uv.x),
+		float3(uv.x, 1.0f, uv.y),
+		float3(uv.x, -1.0f, -uv.y),
+		float3(uv.x, -uv.y, 1.0f),
+		float3(-uv.x, -uv.y, -1.0f),
+	};
+	return normalize(dirs[face]);
+}
+
+//solid angle of a texel of a face
+float TexelSolidAngle(float2 coord, float size)
+{
+	float2 uv = 2.0f * (coord + 0.5f) / size - 1.0f;
+	float texelArea = 4.0f / (size * size);
+	return texelArea / pow(1.0f + dot(uv, uv), 1.5f);
+}
+
+#if defined(RADIANCE)
+
+[numthreads(LOCAL_SIZE_X, LOCAL_SIZE_Y, 1)]
+void CSMain(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+	uint3 outputSize;
+	outputTex.GetDimensions(outputSize.x, outputSize.y, outputSize.z);
+	if (any(dispatchThreadId.xy >= outputSize.xy))
+		return;
+
+	int face = dispatchThreadId.z;
+	if (uniforms.copy)
+	{
+		outputTex[dispatchThreadId] = float4(inputTex.Load(int4(dispatchThreadId.xy, face, 0)).rgb, 1.0f);
+		return;
+	}
+
+	int2 first = int2(dispatchThreadId.xy * 2);
+	float3 value = 0.25f * (inputTex.Load(int4(first, face, 0)).rgb
+		+ inputTex.Load(int4(first + int2(1, 0), face, 0)).rgb
+		+ inputTex.Load(int4(first + int2(0, 1), face, 0)).rgb
+		+ inputTex.Load(int4(first + int2(1, 1), face, 0)).rgb);
+	outputTex[dispatchThreadId] = float4(value, 1.0f);
+}
+
+#elif defined(IRRADIANCE)
+
+#define GROUP_SIZE (LOCAL_SIZE_X * LOCAL_SIZE_Y * 4)
+
+groupshared float3 localSh[GROUP_SIZE][9];
+
+void ShBasis(float3 n, out float basis[9])
+{
+	basis[0] = 0.282095f;
+	basis[1] = 0.488603f * n.y;
+	basis[2] = 0.488603f * n.z;
+	basis[3] = 0.488603f * n.x;
+	basis[4] = 1.092548f * n.x * n.y;
+	basis[5] = 1.092548f * n.y * n.z;
+	basis[6] = 0.315392f * (3.0f * n.z * n.z - 1.0f);
+	basis[7] = 1.092548f * n.x * n.z;
+	basis[8] = 0.546274f * (n.x * n.x - n.y * n.y);
+}
+
+[numthreads(GROUP_SIZE, 1, 1)]
+void CSMain(uint groupIndex : SV_GroupIndex)
+{
+	uint3 inputSize;
+	inputTex.GetDimensions(inputSize.x, inputSize.y, inputSize.z);
+
+	float3 sh[9];
+	for (uint i = 0; i < 9; ++i)
+		sh[i] = 0.0f;
+
+	uint texelCount = inputSize.x * inputSize.y * 6;
+	for (uint texel = groupIndex; texel < texelCount; texel += GROUP_SIZE)
+	{
+		uint face = texel / (inputSize.x * inputSize.y);
+		uint faceTexel = texel % (inputSize.x * inputSize.y);
+		uint2 coord = uint2(faceTexel % inputSize.x, faceTexel / inputSize.x);
+
+		float3 n = FaceDirection(face, coord, inputSize.x);
+		float3 radiance = inputTex.Load(int4(coord, face, 0)).rgb * TexelSolidAngle(coord, inputSize.x);
+		float basis[9];
+		ShBasis(n, basis);
+		for (uint i = 0; i < 9; ++i)
+			sh[i] += radiance * basis[i];
+	}
+
+	for (uint i = 0; i < 9; ++i)
+		localSh[groupIndex][i] = sh[i];
+	GroupMemoryBarrierWithGroupSync();
+
+	for (uint stride = GROUP_SIZE / 2; stride > 0; stride /= 2)
+	{
+		if (groupIndex < stride)
+		{
+			for (uint i = 0; i < 9; ++i)
+				localSh[groupIndex][i] += localSh[groupIndex + stride][i];
+		}
+		GroupMemoryBarrierWithGroupSync();
+	}
+
+	//cosine lobe convolution per band, evaluating the result gives irradiance
+	if (groupIndex < 9)
+	{
+		static const float bands[9] = { PI, 2.0f * PI / 3.0f, 2.0f * PI / 3.0f, 2.0f * PI / 3.0f, PI / 4.0f, PI / 4.0f, PI / 4.0f, PI / 4.0f, PI / 4.0f };
+		outputSh[groupIndex] = float4(localSh[0][groupIndex] * bands[groupIndex], 0.0f);
+	}
+}
+
+#else // SPECULAR
+
+float RadicalInverse(uint bits)
+{
+	return float(reversebits(bits)) * 2.3283064365386963e-10f;
+}
+
+float3 ImportanceSampleGgx(float2 xi, float alpha, float3 n)
+{
+	float phi = 2.0f * PI * xi.x;
+	float cosTheta = sqrt((1.0f - xi.y) / (1.0f + (alpha * alpha - 1.0f) * xi.y));
+	float sinTheta = sqrt(1.0f - cosTheta * cosTheta);
+	float3 h = float3(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta);
+
+	float3 up = abs(n.z) < 0.999f ? float3(0.0f, 0.0f, 1.0f) : float3(1.0f, 0.0f, 0.0f);
+	float3 tangentX = normalize(cross(up, n));
+	float3 tangentY = cross(n, tangentX);
+	return tangentX * h.x + tangentY * h.y + n * h.z;
+}
+
+float DistributionGgx(float nDotH, float alpha)
+{
+	float alpha2 = alpha * alpha;
+	float denominator = nDotH * nDotH * (alpha2 - 1.0f) + 1.0f;
+	return alpha2 / (PI * denominator * denominator);
+}
+
+[numthreads(LOCAL_SIZE_X, LOCAL_SIZE_Y, 1)]
+void CSMain(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+	uint3 outputSize;
+	outputTex.GetDimensions(outputSize.x, outputSize.y, outputSize.z);
+	if (any(dispatchThreadId.xy >= outputSize.xy))
+		return;
+
+	//the view and reflection directions are the normal, as usual for split sum prefiltering
+	float3 n = FaceDirection(dispatchThreadId.z, dispatchThreadId.xy, outputSize.x);
+	if (uniforms.sampleCount <= 1)
+	{
+		outputTex[dispatchThreadId] = float4(inputTex.SampleLevel(linearSampler, n, 0.0f).rgb, 1.0f);
+		return;
+	}
+
+	float alpha = uniforms.roughness * uniforms.roughness;
+	float radianceTexelSolidAngle = 4.0f * PI / (6.0f * uniforms.radianceSize * uniforms.radianceSize);
+
+	float3 result = 0.0f;
+	float weight = 0.0f;
+	for (uint i = 0; i < uniforms.sampleCount; ++i)
+	{
+		float2 xi = float2(float(i) / float(uniforms.sampleCount), RadicalInverse(i));
+		float3 h = ImportanceSampleGgx(xi, alpha, n);
+		float3 l = 2.0f * dot(n, h) * h - n;
+		float nDotL = dot(n, l);
+		if (nDotL > 0.0f)
+		{
+			//the pdf of the reflected direction is D * nDotH / (4 * vDotH), where v is n
+			float nDotH = saturate(dot(n, h));
+			float pdf = DistributionGgx(nDotH, alpha) / 4.0f;
+			float sampleSolidAngle = 1.0f / (float(uniforms.sampleCount) * pdf + 0.0001f);
+			float lod = clamp(0.5f * log2(sampleSolidAngle / radianceTexelSolidAngle) + 1.0f, 0.0f, uniforms.radianceMips - 1.0f);
+			result += inputTex.SampleLevel(linearSampler, l, lod).rgb * nDotL;
+			weight += nDotL;
+		}
+	}
+	outputTex[dispatchThreadId] = float4(result / max(weight, 0.0001f), 1.0f);
+}
+
+#endif
@@ -26,9 +26,18 @@ struct PsInput {
 };
 
 
+// Directions are stored folded onto a square, see VertexCompressor.
+float3 DecodeOctahedral(float2 encoded) {
+	float3 direction = float3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float fold = saturate(-direction.z);
+	direction.xy += direction.xy >= 0.0 ? -fold : fold;
+	return normalize(direction);
+}
+
+
 PsInput VSMain(float4 lPos : POSITION
 #ifdef HAS_NORMAL
-				,float3 lNormal : NORMAL
+				,float2 lNormal : NORMAL
 #endif
 #ifdef HAS_COLOR
 				,float4 color : COLOR
@@ -37,10 +46,10 @@ PsInput VSMain(float4 lPos : POSITION
 				,float2 texCoord : TEX_COORD
 #endif
 #ifdef HAS_TANGENT
-				,float3 lTangent : TANGENT
+				,float2 lTangent : TANGENT
 #endif
 #ifdef HAS_BITANGENT
-				,float3 lBitangent : BITANGENT
+				,float2 lBitangent : BITANGENT
 #endif
 )
 {
@@ -52,7 +61,7 @@ PsInput VSMain(float4 lPos : POSITION
 
 #ifdef HAS_NORMAL
     float3x3 worldRotation = (float3x3)vsConstants.world;
-    output.wNormal = mul(lNormal, worldRotation);
+    output.wNormal = mul(DecodeOctahedral(lNormal), worldRotation);
 #endif
 #ifdef HAS_COLOR
     output.color = color;
@@ -61,9 +70,9 @@ PsInput VSMain(float4 lPos : POSITION
     output.texCoord = texCoord;
 #endif
 #ifdef HAS_TANGENT
-    output.wTangent = mul(lTangent, worldRotation);
+    output.wTangent = mul(DecodeOctahedral(lTangent), worldRotation);
 	#if HAS_BITANGENT
-		output.wBitangent = mul(lBitangent, worldRotation);
+		output.wBitangent = mul(DecodeOctahedral(lBitangent), worldRotation);
 	#else 
 		output.wBitangent = cross(output.wNormal, output.wBitangent);
 	#endif
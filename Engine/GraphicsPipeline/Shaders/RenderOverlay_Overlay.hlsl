@@ -2,6 +2,7 @@
 struct Constants {
     float3x3 worldViewProj;
     float4 color;
+    float4 textureRect; // Texture coordinates of (0,0) and (1,1).
     bool hasTexture;
 	bool hasMesh;
     float z;
@@ -24,7 +25,7 @@ void VSMain(float2 posL : POSITION,
     if (constants.hasMesh) {
 		float3 posH = mul(float3(posL, 1), constants.worldViewProj);
 		posHOut = float4(posH.xy, constants.z * posH.z, posH.z);
-		texCoordOut = texCoord;
+		texCoordOut = lerp(constants.textureRect.xy, constants.textureRect.zw, texCoord);
     }
     else {
 		// Triangle strip based on vertex id
@@ -44,6 +45,7 @@ void VSMain(float2 posL : POSITION,
 
         float3 posH = mul(float3(posL, 1), constants.worldViewProj);
         posHOut = float4(posH.xy, constants.z * posH.z, posH.z);
+        texCoordOut = lerp(constants.textureRect.xy, constants.textureRect.zw, texCoordOut);
     }
 }
 
@@ -0,0 +1,63 @@
+// Per quad inputs, must match RenderOverlay::SpriteInstance.
+struct SpriteInstance {
+	float3 transform0 : TRANSFORM0;
+	float3 transform1 : TRANSFORM1;
+	float3 transform2 : TRANSFORM2;
+	float z : DEPTH;
+	float4 textureRect : TEXRECT; // Texture coordinates of (0,0) and (1,1).
+	float4 color : COLOR;
+	float textured : TEXTURED;
+};
+
+
+// Texture inputs
+Texture2D colorTexture : register(t0);
+SamplerState linearSampler : register(s0);
+
+
+// Shaders
+void VSMain(uint vertexId : SV_VertexID,
+			SpriteInstance sprite,
+			out float4 posHOut : SV_Position,
+			out float2 texCoordOut : TEXCOORD0,
+			out nointerpolation float4 colorOut : COLOR,
+			out nointerpolation float texturedOut : TEXTURED)
+{
+	// Triangle strip based on vertex id
+	// 3-----2
+	// |   / |
+	// | /   |
+	// 1-----0
+	// 0: (1, 0)
+	// 1: (0, 0)
+	// 2: (1, 1)
+	// 3: (0, 1)
+
+	float2 corner;
+	corner.x = (vertexId & 1) ^ 1; // 1 if bit0 is 0.
+	corner.y = vertexId >> 1; // 1 if bit1 is 1.
+
+	float2 posL = (corner * 2.0f - float2(1, 1)) * 0.5f;
+
+	float3x3 worldViewProj = float3x3(sprite.transform0, sprite.transform1, sprite.transform2);
+	float3 posH = mul(float3(posL, 1), worldViewProj);
+	posHOut = float4(posH.xy, sprite.z * posH.z, posH.z);
+
+	texCoordOut = lerp(sprite.textureRect.xy, sprite.textureRect.zw, corner);
+	colorOut = sprite.color;
+	texturedOut = sprite.textured;
+}
+
+
+float4 PSMain(float4 posS : SV_Position,
+			  float2 texCoord : TEXCOORD0,
+			  nointerpolation float4 color : COLOR,
+			  nointerpolation float textured : TEXTURED) : SV_Target0
+{
+	if (textured > 0.5f) {
+		return colorTexture.Sample(linearSampler, texCoord) * color;
+	}
+	else {
+		return color;
+	}
+}
@@ -1,17 +1,13 @@
-// Shader constants
-struct TransformConstants {
-    float3x3 worldViewProj;
-    float z;
+// Per letter inputs, must match RenderOverlay::GlyphInstance.
+struct GlyphInstance {
+	float3 transform0 : TRANSFORM0;
+	float3 transform1 : TRANSFORM1;
+	float3 transform2 : TRANSFORM2;
+	float z : DEPTH;
+	float4 atlasRect : ATLASRECT; // Top left and size in texels.
+	float4 color : COLOR;
 };
 
-struct RenderConstants {
-	int2 atlasAccessTopleft;
-	int2 atlasAccessSize;
-	float4 color;
-};
-ConstantBuffer<TransformConstants> transformConstants : register(b0);
-ConstantBuffer<RenderConstants> renderConstants : register(b7);
-
 
 // Texture inputs
 Texture2D alphaTexture : register(t0);
@@ -20,8 +16,11 @@ SamplerState linearSampler : register(s0);
 
 // Shaders
 void VSMain(uint vertexId : SV_VertexID,
+			GlyphInstance glyph,
 			out float4 posHOut : SV_Position,
-			out float2 texCoordOut : TEXCOORD0)
+			out float2 texCoordOut : TEXCOORD0,
+			out nointerpolation float4 atlasRectOut : ATLASRECT,
+			out nointerpolation float4 colorOut : COLOR)
 {
 	// Triangle strip based on vertex id
 	// 3-----2
@@ -38,22 +37,32 @@ void VSMain(uint vertexId : SV_VertexID,
 
 	float2 posL = texCoordOut.xy * 2.0f - float2(1,1);
 
-    float3 posH = mul(float3(posL, 1), transformConstants.worldViewProj);
-    posHOut = float4(posH.xy, transformConstants.z * posH.z, posH.z);
+	float3x3 worldViewProj = float3x3(glyph.transform0, glyph.transform1, glyph.transform2);
+    float3 posH = mul(float3(posL, 1), worldViewProj);
+    posHOut = float4(posH.xy, glyph.z * posH.z, posH.z);
+
+	atlasRectOut = glyph.atlasRect;
+	colorOut = glyph.color;
 }
 
 
-float4 PSMain(float4 posS : SV_Position, float2 texCoord : TEXCOORD0) : SV_Target0
+float4 PSMain(float4 posS : SV_Position,
+			  float2 texCoord : TEXCOORD0,
+			  nointerpolation float4 atlasRect : ATLASRECT,
+			  nointerpolation float4 color : COLOR) : SV_Target0
 {
 	uint2 atlasSize;
 	alphaTexture.GetDimensions(atlasSize.x, atlasSize.y);
 
-	float2 topleft = (float2)renderConstants.atlasAccessTopleft / (float2)atlasSize;
-	float2 bottomRight = (float2)(renderConstants.atlasAccessTopleft + renderConstants.atlasAccessSize) / (float2)atlasSize;
+	float2 topleft = atlasRect.xy / (float2)atlasSize;
+	float2 bottomRight = (atlasRect.xy + atlasRect.zw) / (float2)atlasSize;
 
     float2 sampleCoord = float2(topleft.x * (1 - texCoord.x) + bottomRight.x * texCoord.x, topleft.y * texCoord.y + bottomRight.y * (1 - texCoord.y));
 
-	float4 alpha = alphaTexture.Sample(linearSampler, sampleCoord);
+	// The atlas holds distance fields with the edge at 0.5, the edge is smoothed over about a pixel at any scale.
+	float distance = alphaTexture.Sample(linearSampler, sampleCoord).x;
+	float width = max(fwidth(distance) * 0.5f, 1e-4f);
+	float alpha = smoothstep(0.5f - width, 0.5f + width, distance);
 
-    return float4(renderConstants.color.xyz, alpha.x);
+    return float4(color.xyz, alpha);
 }
\ No newline at end of file
@@ -548,12 +548,19 @@
 #define SMAASampleLevelZeroPoint(tex, coord) tex.SampleLevel(samp1, coord, 0)
 //#define SMAASampleLevelZeroOffset(tex, coord, offset) tex.SampleLevel(LinearSampler, coord, 0, offset)
 #define SMAASampleLevelZeroOffset(tex, coord, offset) tex.SampleLevel(samp0, coord, 0, offset)
+#ifdef SMAA_NO_DERIVATIVES
+//compute shaders have no derivatives, sample the top mip explicitly
+#define SMAASample(tex, coord) tex.SampleLevel(samp0, coord, 0)
+#define SMAASamplePoint(tex, coord) tex.SampleLevel(samp1, coord, 0)
+#define SMAASampleOffset(tex, coord, offset) tex.SampleLevel(samp0, coord, 0, offset)
+#else
 //#define SMAASample(tex, coord) tex.Sample(LinearSampler, coord)
 #define SMAASample(tex, coord) tex.Sample(samp0, coord)
 //#define SMAASamplePoint(tex, coord) tex.Sample(PointSampler, coord)
 #define SMAASamplePoint(tex, coord) tex.Sample(samp1, coord)
 //#define SMAASampleOffset(tex, coord, offset) tex.Sample(LinearSampler, coord, offset)
 #define SMAASampleOffset(tex, coord, offset) tex.Sample(samp0, coord, offset)
+#endif
 #define SMAA_FLATTEN [flatten]
 #define SMAA_BRANCH [branch]
 #define SMAATexture2DMS2(tex) Texture2DMS<float4, 2> tex
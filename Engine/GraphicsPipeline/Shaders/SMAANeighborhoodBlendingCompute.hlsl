@@ -0,0 +1,67 @@
+/*
+* SMAA neighborhood blending in compute
+* One group per tile of the screen, tiles without edges around them copy the color through
+* Input0: LDR color texture
+* Input1: Blending weights texture
+* Input2: Tile classification
+* Output: Antialiased texture
+*/
+
+struct Uniforms
+{
+	float4 pixelSize;
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+
+Texture2D inputTex : register(t0); //LDR texture
+Texture2D blendingWeightsTex : register(t3); //Blending weights texture
+Texture2D<uint> tileTex : register(t4); //Tile classification
+SamplerState samp0 : register(s0);
+SamplerState samp1 : register(s1);
+
+RWTexture2D<float4> outputTex : register(u0);
+
+#define SMAA_HLSL_4_1
+#define SMAA_PRESET_ULTRA 1
+#define SMAA_RT_METRICS uniforms.pixelSize
+#define SMAA_NO_DERIVATIVES
+
+#include "SMAA.hlsl"
+
+#define TILE_SIZE 16
+
+
+[numthreads(TILE_SIZE, TILE_SIZE, 1)]
+void CSMain(uint3 dispatchId : SV_DispatchThreadID, uint3 groupId : SV_GroupID)
+{
+	int2 size = int2(uniforms.pixelSize.zw);
+	int2 pixel = int2(dispatchId.xy);
+	if (any(pixel >= size))
+	{
+		return;
+	}
+
+	//a pixel reads the weights of its neighbours too, so the tiles around have to be free of edges as well
+	int2 tileCount = (size + TILE_SIZE - 1) / TILE_SIZE;
+	uint hasEdges = 0;
+	for(int y = -1; y <= 1; ++y)
+	{
+		for(int x = -1; x <= 1; ++x)
+		{
+			hasEdges |= tileTex.Load(int3(clamp(int2(groupId.xy) + int2(x, y), 0, tileCount - 1), 0));
+		}
+	}
+
+	if (hasEdges == 0)
+	{
+		outputTex[pixel] = inputTex.Load(int3(pixel, 0));
+		return;
+	}
+
+	float2 texCoord = (float2(pixel) + 0.5) * uniforms.pixelSize.xy;
+	float4 offset;
+	SMAANeighborhoodBlendingVS(texCoord, offset);
+
+	outputTex[pixel] = SMAANeighborhoodBlendingPS(texCoord, offset, inputTex, blendingWeightsTex);
+}
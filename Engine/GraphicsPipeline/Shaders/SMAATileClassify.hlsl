@@ -0,0 +1,38 @@
+/*
+* SMAA tile classification
+* One group per tile of the screen
+* Input: Edges texture
+* Output: 1 for tiles containing edges, 0 otherwise
+*/
+
+Texture2D edgesTex : register(t0); //Edges texture
+RWTexture2D<uint> tileTex : register(u0);
+
+#define TILE_SIZE 16
+
+groupshared uint gsHasEdges;
+
+
+[numthreads(TILE_SIZE, TILE_SIZE, 1)]
+void CSMain(uint3 dispatchId : SV_DispatchThreadID, uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+	if (groupIndex == 0)
+	{
+		gsHasEdges = 0;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	uint2 edgesSize;
+	edgesTex.GetDimensions(edgesSize.x, edgesSize.y);
+
+	if (all(dispatchId.xy < edgesSize) && any(edgesTex.Load(int3(dispatchId.xy, 0)).rg > 0.0))
+	{
+		InterlockedOr(gsHasEdges, 1);
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	if (groupIndex == 0)
+	{
+		tileTex[groupId.xy] = gsHasEdges;
+	}
+}
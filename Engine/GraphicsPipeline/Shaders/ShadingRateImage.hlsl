@@ -0,0 +1,123 @@
+/*
+ * Shading rate image from camera motion and luminance contrast
+ * One group per tile of the shading rate image
+ * Input: color of the previous frame, depth of this frame
+ * Output: D3D12_SHADING_RATE of the tile, (log2 width << 2) | log2 height
+ */
+
+struct Uniforms
+{
+	float4x4 invVP;
+	float4x4 prevVP;
+	uint tileSize;
+	uint additionalRates;
+	uint historyValid;
+	float motionThreshold;
+	float contrastThreshold;
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+
+Texture2D colorTex : register(t0);
+Texture2D depthTex : register(t1);
+RWTexture2D<uint> rateTex : register(u0);
+
+#define LOCAL_SIZE_X 8
+#define LOCAL_SIZE_Y 8
+#define NUM_THREADS (LOCAL_SIZE_X * LOCAL_SIZE_Y)
+
+//keeps dark tiles from having a huge relative contrast
+#define DARK_BIAS 0.05
+
+groupshared float2 gsMinVelocity[NUM_THREADS];
+groupshared float2 gsLuminance[NUM_THREADS]; //min, max
+
+float2 ScreenVelocity(int2 coord, float2 screenSize)
+{
+	float depth = depthTex.Load(int3(coord, 0)).x;
+	float2 uv = (float2(coord) + 0.5) / screenSize;
+
+	float4 ndcPos = float4(uv.x * 2 - 1, 1 - uv.y * 2, depth, 1);
+	float4 worldPos = mul(ndcPos, uniforms.invVP);
+	worldPos /= worldPos.w;
+	float4 prevNdcPos = mul(worldPos, uniforms.prevVP);
+	prevNdcPos /= prevNdcPos.w;
+
+	return abs(prevNdcPos.xy - ndcPos.xy) * 0.5 * screenSize;
+}
+
+uint CoarsenLevel(float value, float threshold)
+{
+	return value >= 2 * threshold ? 2 : (value >= threshold ? 1 : 0);
+}
+
+[numthreads(LOCAL_SIZE_X, LOCAL_SIZE_Y, 1)]
+void CSMain(uint3 groupId : SV_GroupID, uint3 groupThreadId : SV_GroupThreadID, uint groupIndex : SV_GroupIndex)
+{
+	uint2 screenSize;
+	depthTex.GetDimensions(screenSize.x, screenSize.y);
+
+	//each thread covers a square of the tile
+	uint2 span = max(uniforms.tileSize / uint2(LOCAL_SIZE_X, LOCAL_SIZE_Y), 1);
+	uint2 first = groupId.xy * uniforms.tileSize + groupThreadId.xy * span;
+
+	float2 minVelocity = 1e20;
+	float2 luminance = float2(1e20, 0);
+	for (uint y = 0; y < span.y; ++y)
+	{
+		for (uint x = 0; x < span.x; ++x)
+		{
+			uint2 coord = first + uint2(x, y);
+			if (any(coord >= screenSize))
+				continue;
+
+			minVelocity = min(minVelocity, ScreenVelocity(int2(coord), float2(screenSize)));
+			float lum = dot(colorTex.Load(int3(coord, 0)).rgb, float3(0.2126, 0.7152, 0.0722));
+			luminance = float2(min(luminance.x, lum), max(luminance.y, lum));
+		}
+	}
+
+	gsMinVelocity[groupIndex] = minVelocity;
+	gsLuminance[groupIndex] = luminance;
+	GroupMemoryBarrierWithGroupSync();
+
+	for (uint stride = NUM_THREADS / 2; stride > 0; stride /= 2)
+	{
+		if (groupIndex < stride)
+		{
+			gsMinVelocity[groupIndex] = min(gsMinVelocity[groupIndex], gsMinVelocity[groupIndex + stride]);
+			float2 other = gsLuminance[groupIndex + stride];
+			gsLuminance[groupIndex] = float2(min(gsLuminance[groupIndex].x, other.x), max(gsLuminance[groupIndex].y, other.y));
+		}
+		GroupMemoryBarrierWithGroupSync();
+	}
+
+	if (groupIndex != 0)
+		return;
+
+	if (uniforms.historyValid == 0)
+	{
+		rateTex[groupId.xy] = 0;
+		return;
+	}
+
+	//fast motion smears the tile along the motion
+	float2 velocity = gsMinVelocity[0];
+	uint2 level = uint2(CoarsenLevel(velocity.x, uniforms.motionThreshold), CoarsenLevel(velocity.y, uniforms.motionThreshold));
+
+	//flat tiles look the same at a lower rate in both directions
+	float2 lum = gsLuminance[0];
+	float contrast = (lum.y - lum.x) / (lum.y + DARK_BIAS);
+	uint flatLevel = contrast < 0.5 * uniforms.contrastThreshold ? 2 : (contrast < uniforms.contrastThreshold ? 1 : 0);
+	level = max(level, flatLevel);
+
+	//there are no 1x4 and 4x1 rates, and 4 wide rates need the additional rates
+	if (level.x == 2 && level.y == 0)
+		level.x = 1;
+	if (level.y == 2 && level.x == 0)
+		level.y = 1;
+	if (uniforms.additionalRates == 0)
+		level = min(level, 1);
+
+	rateTex[groupId.xy] = (level.x << 2) | level.y;
+}
@@ -0,0 +1,205 @@
+/*
+* Separable shadow blur in compute, along rows, or along columns with VERTICAL
+* Each group filters a span of a row or column cached in groupshared memory
+* Input: depth texture, layered penumbra texture (full or half resolution),
+* layered shadow texture, tile classification
+* Output: blurred shadows
+*/
+
+#define LOW 1
+#define MEDIUM 2
+#define HIGH 3
+#define ULTRA 4
+
+#define QUALITY ULTRA
+
+struct Uniforms
+{
+	float4x4 invV;
+	float4 farPlaneData0, farPlaneData1;
+	float lightSize, nearPlane, farPlane, dummy;
+	float4 vsLightPos;
+	float2 direction;
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+
+Texture2D inputTex0 : register(t0); //depth texture
+Texture2D inputTex3 : register(t3); //layered penumbra texture
+Texture2D inputTex4 : register(t4); //layered shadow texture
+Texture2D<uint> inputTex5 : register(t5); //tile classification
+SamplerState samp0 : register(s0);
+SamplerState samp1 : register(s1);
+
+RWTexture2D<float4> outputTex : register(u0);
+
+#include "ShadowBlurSample.hlsl"
+
+#define GROUP_SIZE 128
+#define TILE_SIZE 16
+//taps are clamped to this, so a tile's blur only reaches its neighbours
+#define MAX_RADIUS TILE_SIZE
+#define CACHE_SIZE (GROUP_SIZE + 2 * MAX_RADIUS)
+
+#ifdef VERTICAL
+static const int2 axis = int2(0, 1);
+#else
+static const int2 axis = int2(1, 0);
+#endif
+
+groupshared float4 gsShadow[CACHE_SIZE];
+groupshared float gsDepth[CACHE_SIZE];
+
+
+float3 GetViewPosition(int2 pixel, int2 size)
+{
+	float depth = inputTex0.Load(int3(pixel, 0)).x;
+	float linearDepth = LinearizeDepth(depth, uniforms.nearPlane, uniforms.farPlane);
+	float3 farPlaneLL = uniforms.farPlaneData0.xyz;
+	float3 farPlaneUR = float3(uniforms.farPlaneData0.w, uniforms.farPlaneData1.xy);
+
+	float2 texCoord = (float2(pixel) + 0.5) / float2(size);
+	float2 uv = float2(texCoord.x, 1 - texCoord.y);
+	return float3(lerp(farPlaneLL.xy, farPlaneUR.xy, uv) / uniforms.farPlane, 1.0) * linearDepth;
+}
+
+float4 LoadPenumbra(int2 pixel, float depth, int2 size)
+{
+	uint2 penumbraTexSize;
+	inputTex3.GetDimensions(penumbraTexSize.x, penumbraTexSize.y);
+	int2 penumbraSize = int2(penumbraTexSize);
+
+	float4 penumbra = float4(0.0, 0.0, 0.0, 0.0);
+	if (penumbraSize.x == size.x)
+	{
+		//TODO
+		//hacked here to hide cascade transitions
+		for(int y = -1; y <= 1; ++y)
+		{
+			for(int x = -1; x <= 1; ++x)
+			{
+				penumbra += inputTex3.Load(int3(clamp(pixel + int2(x, y) * 3, 0, size - 1), 0)) / 9.0;
+			}
+		}
+		return penumbra;
+	}
+
+	//half resolution: of the four nearest texels, take the one computed at the closest depth
+	int2 first = (pixel - 1) / 2;
+	float bestDepthDiff = 1e20;
+	for(int y = 0; y < 2; ++y)
+	{
+		for(int x = 0; x < 2; ++x)
+		{
+			int2 texel = clamp(first + int2(x, y), 0, penumbraSize - 1);
+			float texelDepth = inputTex0.Load(int3(min(texel * 2, size - 1), 0)).x;
+			float depthDiff = abs(texelDepth - depth);
+			if (depthDiff < bestDepthDiff)
+			{
+				bestDepthDiff = depthDiff;
+				penumbra = inputTex3.Load(int3(texel, 0));
+			}
+		}
+	}
+	return penumbra;
+}
+
+#ifdef VERTICAL
+[numthreads(1, GROUP_SIZE, 1)]
+#else
+[numthreads(GROUP_SIZE, 1, 1)]
+#endif
+void CSMain(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+	uint2 inputTexSize;
+	inputTex4.GetDimensions(inputTexSize.x, inputTexSize.y);
+	int2 size = int2(inputTexSize);
+
+	int2 spanStart = int2(groupId.xy) * (int2(1, 1) + axis * (GROUP_SIZE - 1));
+
+	//cache the span with an apron on both sides
+	for (uint i = groupIndex; i < CACHE_SIZE; i += GROUP_SIZE)
+	{
+		int2 cachePixel = clamp(spanStart + axis * (int(i) - MAX_RADIUS), 0, size - 1);
+		gsShadow[i] = inputTex4.Load(int3(cachePixel, 0));
+		gsDepth[i] = inputTex0.Load(int3(cachePixel, 0)).x;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	int2 pixel = spanStart + axis * int(groupIndex);
+	if (any(pixel >= size))
+	{
+		return;
+	}
+
+	int center = int(groupIndex) + MAX_RADIUS;
+	float4 hardShadow = gsShadow[center];
+	float depth = gsDepth[center];
+
+	//layers lit or shadowed in all the tiles the taps reach come out the same
+	int2 tile = pixel / TILE_SIZE;
+	int2 tileCount = (size + TILE_SIZE - 1) / TILE_SIZE;
+	uint uniformMask = 0xFF;
+	for(int y = -1; y <= 1; ++y)
+	{
+		for(int x = -1; x <= 1; ++x)
+		{
+			uniformMask &= inputTex5.Load(int3(clamp(tile + int2(x, y), 0, tileCount - 1), 0));
+		}
+	}
+	uint skipLayers = (uniformMask | (uniformMask >> 4)) & 0xF;
+
+	if(depth > 0.999 || skipLayers == 0xF)
+	{
+		outputTex[pixel] = hardShadow;
+		return;
+	}
+
+	float linearDepth = LinearizeDepth(depth, uniforms.nearPlane, uniforms.farPlane);
+	float4 penumbra = LoadPenumbra(pixel, depth, size);
+
+	//TODO replace with proper normals
+	int2 stepX = int2(pixel.x + 1 < size.x ? 1 : -1, 0);
+	int2 stepY = int2(0, pixel.y + 1 < size.y ? 1 : -1);
+	float3 vsPos = GetViewPosition(pixel, size);
+	float3 vsDdx = (GetViewPosition(pixel + stepX, size) - vsPos) * stepX.x;
+	float3 vsDdy = (GetViewPosition(pixel + stepY, size) - vsPos) * stepY.y;
+	float3 vsDepthNormal = -normalize(cross(vsDdy, vsDdx));
+
+	//the pixel shader steps in uv, the cache in pixels along the axis
+	const float anisoThreshold = 0.25; //TODO make it uniform
+	float stepSize = GetStepSize( float2(1.0, 1.0), vsDepthNormal, linearDepth, anisoThreshold ).x / uniforms.farPlane * 3.0 * dot(float2(size), float2(axis));
+
+	const float maxDepthDiff = 0.01;
+
+	float4 blurredResultLayers = hardShadow;
+	[unroll]
+	for(int layer = 0; layer < 4; ++layer)
+	{
+		if(((skipLayers >> layer) & 1) != 0 || penumbra[layer] <= 0.001)
+		{
+			continue;
+		}
+
+		float color = hardShadow[layer] * weights[0];
+		float sumWeights = weights[0];
+
+		for(int c = 0; c < numSteps; ++c)
+		{
+			float position = center + clamp(offsets[c] * penumbra[layer] * stepSize, -MAX_RADIUS, MAX_RADIUS);
+			int lower = min(int(position), CACHE_SIZE - 2);
+			float t = position - lower;
+
+			float depthAtSample = gsDepth[t < 0.5 ? lower : lower + 1];
+			if( abs( depth - depthAtSample ) < maxDepthDiff )
+			{
+				color += lerp(gsShadow[lower][layer], gsShadow[lower + 1][layer], t) * weights[c + 1];
+				sumWeights += weights[c + 1];
+			}
+		}
+
+		blurredResultLayers[layer] = color / sumWeights;
+	}
+
+	outputTex[pixel] = blurredResultLayers;
+}
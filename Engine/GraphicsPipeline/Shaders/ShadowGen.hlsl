@@ -1,15 +1,17 @@
 /*
 * Shadow mapping shader
-* Input: light MVP matrix
+* Input: light view-projection matrix, instance transforms
 * Output: shadow map
 */
 
 struct Uniforms
 {
-	float4x4 mvp;
+	float4x4 viewProjection;
+	uint instanceOffset;
 };
 
 ConstantBuffer<Uniforms> uniforms : register(b0);
+StructuredBuffer<float4x4> instanceTransforms : register(t0);
 
 struct PS_Input
 {
@@ -17,11 +19,13 @@ struct PS_Input
 };
 
 
-PS_Input VSMain(float4 position : POSITION)
+PS_Input VSMain(float4 position : POSITION, uint instanceId : SV_InstanceID)
 {
 	PS_Input result;
 
-    result.position = mul(position, uniforms.mvp);
+	// SV_InstanceID does not include the start instance.
+	float4x4 model = instanceTransforms[uniforms.instanceOffset + instanceId];
+    result.position = mul(mul(position, model), uniforms.viewProjection);
 
 	return result;
 }
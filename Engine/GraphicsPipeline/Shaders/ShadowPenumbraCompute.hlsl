@@ -0,0 +1,147 @@
+/*
+* Shadow layers, penumbra and tile classification in compute
+* One group per tile of the screen
+* Input: depth texture, csm and cube minfilter maps, shadow maps
+* Output: layered shadow texture, layered penumbra texture, tiles lit or shadowed in whole per layer
+* HALF_RES_PENUMBRA: writes the shadows and the tiles only
+* PENUMBRA_ONLY: runs at half resolution and writes the penumbra only,
+* each texel is computed at the top left pixel of its 2x2 block
+*/
+
+struct Uniforms
+{
+	float4x4 invV;
+	float4 farPlaneData0, farPlaneData1;
+	float lightSize, nearPlane, farPlane, dummy;
+	float4 vsLightPos;
+	float2 direction;
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+
+#define CSM_EXTENDED_INFO
+#include "CSMSample.hlsl"
+#define POINT_EXTENDED_INFO
+#include "PointLightShadowMapSample.hlsl"
+
+Texture2D inputTex0 : register(t0); //depth texture
+Texture2DArray<float> inputTex1 : register(t1); //csm minfilter map
+TextureCube<float> inputTex2 : register(t2); //cube minfilter map
+SamplerState samp0 : register(s0);
+
+RWTexture2D<float4> shadowLayersTex : register(u0);
+RWTexture2D<float4> penumbraLayersTex : register(u1);
+RWTexture2D<uint> tileTex : register(u2); //bit n: layer n is lit in the whole tile, bit n+4: shadowed
+
+#define TILE_SIZE 16
+
+groupshared uint gsAllLit;
+groupshared uint gsAllShadowed;
+
+
+float EstimatePenumbra( float receiver, float blocker )
+{
+	//need to set min to roughly near plane,
+	//as we render stuff into cascades even when outside cascade
+	//to make sure we have all blockers
+	blocker = max(blocker, 0.1);
+	return clamp(abs(receiver - blocker) / blocker, 0.0, 1.0);
+}
+
+void SampleLayers(float3 vsPos, out float4 shadow, out float4 penumbra)
+{
+	shadow = float4(0.0, 0.0, 0.0, 0.0);
+	penumbra = float4(0.0, 0.0, 0.0, 0.0);
+
+	{ //csm
+		float4 shadowCoord;
+		shadow.x = GetCsmShadow(float4(vsPos, 1.0), shadowCoord).x;
+
+		float blocker = clamp(inputTex1.SampleLevel(samp0, GetShadowUv(shadowCoord.xy, shadowCoord.w), 0.0).x, 0.0, 1.0);
+		float shadowCoordZ = clamp(shadowCoord.z, 0.0, 1.0);
+		penumbra.x = EstimatePenumbra( shadowCoordZ, blocker ) * uniforms.lightSize;
+	}
+
+	{ //point light
+		float4 shadowCoord;
+		float3 lightDir = uniforms.vsLightPos.xyz - vsPos;
+		float distance = length(lightDir);
+		shadow.y = GetPointLightShadow(-lightDir, distance, shadowCoord).x;
+
+		float blocker = inputTex2.SampleLevel(samp0, shadowCoord.xyz, 0.0).x;
+		blocker = LinearizeDepth(blocker, 0.1, 100.0);
+		penumbra.y = EstimatePenumbra( distance, blocker ) * uniforms.lightSize;
+	}
+}
+
+[numthreads(TILE_SIZE, TILE_SIZE, 1)]
+void CSMain(uint3 dispatchId : SV_DispatchThreadID, uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+	uint2 depthSize;
+	inputTex0.GetDimensions(depthSize.x, depthSize.y);
+
+	uint2 outputSize;
+#ifdef PENUMBRA_ONLY
+	penumbraLayersTex.GetDimensions(outputSize.x, outputSize.y);
+	uint2 pixel = min(dispatchId.xy * 2, depthSize - 1);
+#else
+	shadowLayersTex.GetDimensions(outputSize.x, outputSize.y);
+	uint2 pixel = dispatchId.xy;
+
+	if (groupIndex == 0)
+	{
+		gsAllLit = 0xF;
+		gsAllShadowed = 0xF;
+	}
+	GroupMemoryBarrierWithGroupSync();
+#endif
+
+	//no returns before the barrier, threads outside the screen still take part
+	bool inside = all(dispatchId.xy < outputSize);
+	float depth = inside ? inputTex0.Load(int3(pixel, 0)).x : 1.0;
+	bool sky = depth > 0.999;
+
+	float4 shadow = float4(1.0, 1.0, 1.0, 1.0);
+	float4 penumbra = float4(0.0, 0.0, 0.0, 0.0);
+	if (inside && !sky)
+	{
+		float linearDepth = LinearizeDepth(depth, uniforms.nearPlane, uniforms.farPlane);
+		float3 farPlaneLL = uniforms.farPlaneData0.xyz;
+		float3 farPlaneUR = float3(uniforms.farPlaneData0.w, uniforms.farPlaneData1.xy);
+
+		float2 texCoord = (float2(pixel) + 0.5) / float2(depthSize);
+		float2 uv = float2(texCoord.x, 1 - texCoord.y);
+		float3 vsPos = float3(lerp(farPlaneLL.xy, farPlaneUR.xy, uv) / uniforms.farPlane, 1.0) * linearDepth;
+
+		SampleLayers(vsPos, shadow, penumbra);
+	}
+
+#ifndef PENUMBRA_ONLY
+	//the sky takes whatever its tile has
+	if (inside && !sky)
+	{
+		uint lit = (shadow.x > 0.5 ? 1 : 0) | (shadow.y > 0.5 ? 2 : 0) | (shadow.z > 0.5 ? 4 : 0) | (shadow.w > 0.5 ? 8 : 0);
+		InterlockedAnd(gsAllLit, lit);
+		InterlockedAnd(gsAllShadowed, ~lit & 0xF);
+	}
+	if (inside)
+	{
+		shadowLayersTex[dispatchId.xy] = shadow;
+	}
+#endif
+
+#ifndef HALF_RES_PENUMBRA
+	if (inside)
+	{
+		penumbraLayersTex[dispatchId.xy] = penumbra;
+	}
+#endif
+
+#ifndef PENUMBRA_ONLY
+	GroupMemoryBarrierWithGroupSync();
+	if (groupIndex == 0)
+	{
+		tileTex[groupId.xy] = gsAllLit | (gsAllShadowed << 4);
+	}
+#endif
+}
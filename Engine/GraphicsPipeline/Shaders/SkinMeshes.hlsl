@@ -0,0 +1,99 @@
+/*
+ * Mesh skinning
+ * Input: vertices of the bind pose, joint indices and weights, skinning matrices of the joints
+ * Output: vertices of the current pose
+ *
+ * Vertices are 16 bytes: R16G16B16A16_UNORM position, R16G16_SNORM octahedral normal, R16G16_FLOAT texture coordinates.
+ */
+
+#define LOCAL_SIZE_X 64
+
+// Must match the layout in SkinMeshes.cpp.
+struct Uniforms
+{
+	float4 sourceDequantization; // offset of the mesh's positions, then their scale
+	float4 targetQuantization; // offset of the skin's pose bounds, then the inverse of their scale
+	uint vertexCount;
+	uint paletteOffset; // first joint of the entity's palette
+	uint jointCount;
+	uint padding;
+};
+
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+ByteAddressBuffer sourceVertices : register(t0);
+ByteAddressBuffer influences : register(t1); // 8-bit joint indices, then 8-bit normalized weights
+StructuredBuffer<float4> palette : register(t2); // three rows of a float3x4 for each joint
+RWByteAddressBuffer targetVertices : register(u0);
+
+
+// Directions are stored folded onto a square, see VertexCompressor.
+float3 DecodeOctahedral(float2 encoded)
+{
+	float3 direction = float3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float fold = saturate(-direction.z);
+	direction.xy += direction.xy >= 0.0 ? -fold : fold;
+	return normalize(direction);
+}
+
+
+float2 EncodeOctahedral(float3 direction)
+{
+	float2 projected = direction.xy / max(abs(direction.x) + abs(direction.y) + abs(direction.z), 1e-20);
+	if (direction.z < 0.0) {
+		projected = (1.0 - abs(projected.yx)) * (projected.xy >= 0.0 ? 1.0 : -1.0);
+	}
+	return projected;
+}
+
+
+float UnpackSnorm16(uint bits)
+{
+	return max(float(int(bits << 16) >> 16) / 32767.0, -1.0);
+}
+
+
+uint PackSnorm16(float value)
+{
+	return uint(int(round(clamp(value, -1.0, 1.0) * 32767.0))) & 0xFFFF;
+}
+
+
+[numthreads(LOCAL_SIZE_X, 1, 1)]
+void CSMain(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+	uint vertex = dispatchThreadId.x;
+	if (vertex >= uniforms.vertexCount) {
+		return;
+	}
+
+	uint4 packed = sourceVertices.Load4(vertex * 16);
+	float3 position = float3(packed.x & 0xFFFF, packed.x >> 16, packed.y & 0xFFFF) / 65535.0;
+	position = position * uniforms.sourceDequantization.w + uniforms.sourceDequantization.xyz;
+	float3 normal = DecodeOctahedral(float2(UnpackSnorm16(packed.z & 0xFFFF), UnpackSnorm16(packed.z >> 16)));
+
+	uint2 influence = influences.Load2(vertex * 8);
+	float3 skinnedPosition = 0.0;
+	float3 skinnedNormal = 0.0;
+	[unroll]
+	for (uint i = 0; i < 4; ++i) {
+		uint joint = min((influence.x >> (8 * i)) & 0xFF, uniforms.jointCount - 1);
+		float weight = float((influence.y >> (8 * i)) & 0xFF) / 255.0;
+		uint row = (uniforms.paletteOffset + joint) * 3;
+		float3x4 skinning = float3x4(palette[row], palette[row + 1], palette[row + 2]);
+		skinnedPosition += weight * mul(skinning, float4(position, 1.0));
+		skinnedNormal += weight * mul(skinning, float4(normal, 0.0));
+	}
+
+	// Positions outside the pose bounds are clamped to them.
+	float3 quantized = saturate((skinnedPosition - uniforms.targetQuantization.xyz) * uniforms.targetQuantization.w);
+	uint3 positionBits = uint3(round(quantized * 65535.0));
+	float2 encodedNormal = EncodeOctahedral(skinnedNormal);
+
+	uint4 result;
+	result.x = positionBits.x | (positionBits.y << 16);
+	result.y = positionBits.z | (0xFFFFu << 16);
+	result.z = PackSnorm16(encodedNormal.x) | (PackSnorm16(encodedNormal.y) << 16);
+	result.w = packed.w; // Texture coordinates stay.
+	targetVertices.Store4(vertex * 16, result);
+}
@@ -0,0 +1,164 @@
+/*
+* Temporal anti-aliasing and upscaling
+* One thread per output pixel, the history is the output of the last frame
+* Input0: color texture at the render resolution, rendered with the jittered projection
+* Input1: depth texture at the render resolution
+* Input2: velocity and normal texture of the forward render
+* Input3: history at the output resolution
+* Output: anti-aliased color at the output resolution, the history of the next frame
+*/
+
+#include "EncodeDecode.hlsl"
+
+struct Uniforms
+{
+	float4x4 invVP; //unjittered, of this frame
+	float4x4 prevVP; //unjittered, of the last frame
+	float4 inputSize; //width, height and their reciprocals
+	float4 outputSize;
+	float2 jitter; //how far the image moved, in input pixels
+	float blendFactor;
+	float velocityScale;
+	uint historyValid;
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+
+Texture2D colorTex : register(t0);
+Texture2D depthTex : register(t1);
+Texture2D velocityTex : register(t2);
+Texture2D historyTex : register(t3);
+SamplerState samp0 : register(s0);
+
+RWTexture2D<float4> outputTex : register(u0);
+
+#define GROUP_SIZE 8
+
+
+float3 ToYcocg(float3 c)
+{
+	return float3(0.25 * c.r + 0.5 * c.g + 0.25 * c.b,
+		0.5 * c.r - 0.5 * c.b,
+		-0.25 * c.r + 0.5 * c.g - 0.25 * c.b);
+}
+
+float3 FromYcocg(float3 c)
+{
+	return float3(c.x + c.y - c.z, c.x + c.z, c.x - c.y - c.z);
+}
+
+//bright samples weigh less, so that a few of them don't flicker through the average of HDR colors
+float ToneWeight(float3 c)
+{
+	return 1.0 / (1.0 + dot(c, float3(0.299, 0.587, 0.114)));
+}
+
+//moves the color towards the center of the box until it's inside
+float3 ClipToBox(float3 color, float3 boxMin, float3 boxMax)
+{
+	float3 center = 0.5 * (boxMax + boxMin);
+	float3 extents = 0.5 * (boxMax - boxMin) + 0.00001;
+	float3 offset = color - center;
+	float3 ratio = abs(offset / extents);
+	float maxRatio = max(ratio.x, max(ratio.y, ratio.z));
+	return maxRatio > 1.0 ? center + offset / maxRatio : color;
+}
+
+//where the surface seen at the pixel was in the last frame, in texture coordinates
+float2 Reproject(float2 uv, int2 inputPixel, float depth)
+{
+	float2 velocity = UndoVelocityBiasScale(velocityTex.Load(int3(inputPixel, 0)).xy);
+	float lengthVelocity = length(velocity);
+
+	//the encoding lengthens short motions to half, and the texture saturates on long ones,
+	//only the motions in between are exact, the rest is taken for the motion of the camera
+	if (lengthVelocity > 0.5 + 2.0 / 255.0 && max(abs(velocity.x), abs(velocity.y)) < 1.0 - 2.0 / 255.0)
+	{
+		float2 ndcMotion = velocity / uniforms.velocityScale;
+		return uv - float2(ndcMotion.x, -ndcMotion.y) * 0.5;
+	}
+
+	float4 ndc = float4(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0, depth, 1.0);
+	float4 worldPos = mul(ndc, uniforms.invVP);
+	worldPos /= worldPos.w;
+	float4 prevPos = mul(worldPos, uniforms.prevVP);
+	float2 prevNdc = prevPos.xy / prevPos.w;
+	return float2(prevNdc.x * 0.5 + 0.5, 0.5 - prevNdc.y * 0.5);
+}
+
+
+[numthreads(GROUP_SIZE, GROUP_SIZE, 1)]
+void CSMain(uint3 dispatchId : SV_DispatchThreadID)
+{
+	int2 pixel = int2(dispatchId.xy);
+	if (any(pixel >= int2(uniforms.outputSize.xy)))
+	{
+		return;
+	}
+
+	//the sample of an input pixel shows the scene at its center minus the jitter
+	float2 uv = (float2(pixel) + 0.5) * uniforms.outputSize.zw;
+	float2 inputPos = uv * uniforms.inputSize.xy;
+	int2 inputSize = int2(uniforms.inputSize.xy);
+	int2 closestSample = clamp(int2(floor(inputPos + uniforms.jitter)), 0, inputSize - 1);
+
+	float3 colorSum = 0;
+	float weightSum = 0;
+	float maxWeight = 0;
+	float3 moment1 = 0;
+	float3 moment2 = 0;
+	float nearestDepth = 1.0;
+	int2 nearestPixel = closestSample;
+
+	[unroll]
+	for (int y = -1; y <= 1; ++y)
+	{
+		[unroll]
+		for (int x = -1; x <= 1; ++x)
+		{
+			int2 samplePixel = clamp(closestSample + int2(x, y), 0, inputSize - 1);
+			float3 color = colorTex.Load(int3(samplePixel, 0)).rgb;
+
+			//gaussian fit of the Blackman-Harris window, in input pixels
+			float2 offset = float2(samplePixel) + 0.5 - uniforms.jitter - inputPos;
+			float weight = exp(-2.29 * dot(offset, offset));
+			float toneWeight = weight * ToneWeight(color);
+			colorSum += color * toneWeight;
+			weightSum += toneWeight;
+			maxWeight = max(maxWeight, weight);
+
+			float3 ycocg = ToYcocg(color);
+			moment1 += ycocg;
+			moment2 += ycocg * ycocg;
+
+			//the motion of the nearest surface keeps the edges of moving objects sharp
+			float depth = depthTex.Load(int3(samplePixel, 0)).r;
+			if (depth < nearestDepth)
+			{
+				nearestDepth = depth;
+				nearestPixel = samplePixel;
+			}
+		}
+	}
+
+	float3 current = colorSum / max(weightSum, 0.00001);
+	float3 result = current;
+
+	float2 prevUv = Reproject(uv, nearestPixel, nearestDepth);
+	if (uniforms.historyValid != 0 && all(prevUv >= 0.0) && all(prevUv <= 1.0))
+	{
+		//the history is clipped to the spread of the current samples, so that the colors of disoccluded areas don't ghost
+		float3 mean = moment1 / 9.0;
+		float3 sigma = sqrt(abs(moment2 / 9.0 - mean * mean));
+		float3 history = historyTex.SampleLevel(samp0, prevUv, 0).rgb;
+		history = FromYcocg(ClipToBox(ToYcocg(history), mean - sigma, mean + sigma));
+
+		//when upscaling, the samples far from the output pixel only nudge the history
+		float alpha = uniforms.blendFactor * maxWeight;
+		float currentWeight = alpha * ToneWeight(current);
+		float historyWeight = (1.0 - alpha) * ToneWeight(history);
+		result = (current * currentWeight + history * historyWeight) / (currentWeight + historyWeight);
+	}
+
+	outputTex[pixel] = float4(result, 1.0);
+}
@@ -0,0 +1,116 @@
+/*
+* Motion Blur Tile Max and Neighbor Max in one pass
+* Input: RG8 motion vector texture
+* Output: max motion vector of each tile, max motion vector in the tile neighborhood
+*/
+
+#define TILES_PER_GROUP 8 // Along each side, the group also reduces a ring of tiles around them.
+#define APRON_TILES (TILES_PER_GROUP + 2)
+#define LOCAL_SIZE 16
+
+struct Uniforms
+{
+	int tileSize;
+	int2 tileCount;
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+
+Texture2D inputTex : register(t0);
+RWTexture2D<float2> tileMaxTex : register(u0);
+RWTexture2D<float2> neighborMaxTex : register(u1);
+
+// The longest vector of each tile, as the squared length above the biased vector.
+groupshared uint localTileMax[APRON_TILES * APRON_TILES];
+
+float2 UndoVelocityBiasScale(float2 v)
+{
+	return v * 2.0 - 1.0;
+}
+
+uint PackVelocity(float2 biased)
+{
+	float2 velocity = UndoVelocityBiasScale(biased);
+	uint lenSqr = uint(saturate(dot(velocity, velocity) * 0.5) * 65535.0);
+	uint2 quantized = uint2(saturate(biased) * 255.0 + 0.5);
+	return (lenSqr << 16) | (quantized.x << 8) | quantized.y;
+}
+
+float2 UnpackVelocity(uint packed)
+{
+	return float2((packed >> 8) & 0xFF, packed & 0xFF) / 255.0;
+}
+
+[numthreads(LOCAL_SIZE, LOCAL_SIZE, 1)]
+void CSMain(uint3 groupId : SV_GroupID, uint3 groupThreadId : SV_GroupThreadID, uint groupIndex : SV_GroupIndex)
+{
+	const uint numThreads = LOCAL_SIZE * LOCAL_SIZE;
+	int2 firstTile = int2(groupId.xy) * TILES_PER_GROUP - 1;
+
+	for (uint i = groupIndex; i < APRON_TILES * APRON_TILES; i += numThreads)
+	{
+		localTileMax[i] = 0;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	uint3 inputTexSize;
+	inputTex.GetDimensions(0, inputTexSize.x, inputTexSize.y, inputTexSize.z);
+	int2 texSize = int3(inputTexSize).xy - int2(1, 1);
+
+	// Tiles past the edges are the edge tiles again, as the separate passes clamp their loads.
+	uint apronPixels = APRON_TILES * uniforms.tileSize;
+	for (uint p = groupIndex; p < apronPixels * apronPixels; p += numThreads)
+	{
+		int2 local = int2(p % apronPixels, p / apronPixels);
+		int2 localTile = local / uniforms.tileSize;
+		int2 tile = clamp(firstTile + localTile, int2(0, 0), uniforms.tileCount - 1);
+		int2 pixel = clamp(tile * uniforms.tileSize + local % uniforms.tileSize, int2(0, 0), texSize);
+
+		uint packed = PackVelocity(inputTex.Load(int3(pixel, 0)).xy);
+		InterlockedMax(localTileMax[localTile.y * APRON_TILES + localTile.x], packed);
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	if (any(groupThreadId.xy >= TILES_PER_GROUP))
+	{
+		return;
+	}
+
+	int2 center = int2(groupThreadId.xy) + 1;
+	int2 tile = firstTile + center;
+	if (any(tile >= uniforms.tileCount))
+	{
+		return;
+	}
+
+	float2 tileMax = UnpackVelocity(localTileMax[center.y * APRON_TILES + center.x]);
+	tileMaxTex[tile] = tileMax;
+
+	// Neighbors only count if they move towards the center tile.
+	float3 result = float3(0.0, 0.0, 0.0);
+	for (int x = -1; x <= 1; ++x)
+	{
+		for (int y = -1; y <= 1; ++y)
+		{
+			int2 offset = int2(x, y);
+			int2 neighbor = center + offset;
+			float2 velocity = UndoVelocityBiasScale(UnpackVelocity(localTileMax[neighbor.y * APRON_TILES + neighbor.x]));
+			float lenSqr = dot(velocity, velocity);
+
+			if (result.z < lenSqr)
+			{
+				float displacement = abs(float(offset.x)) + abs(float(offset.y));
+				float2 orientation = sign(float2(offset) * velocity);
+				float distance = float(orientation.x + orientation.y);
+
+				if (abs(distance) == displacement)
+				{
+					result.xy = velocity;
+					result.z = lenSqr;
+				}
+			}
+		}
+	}
+
+	neighborMaxTex[tile] = (result.xy + 1.0) * 0.5;
+}
@@ -35,7 +35,7 @@ struct Uniforms
 	LightData ld[10];
 	float4x4 v, p;
 	float4x4 invVP, oldVP;
-	float camNear, camFar, dummy1, dummy2;
+	float camNear, camFar, numSteps, historyBlend;
 	uint numSdfs, numWorkgroupsX, numWorkgroupsY; float haltonFactor;
 	float4 sunDirection;
 	float4 sunColor;
@@ -52,6 +52,8 @@ static const float pi = 3.14159265;
 #define LOCAL_SIZE_X 16
 #define LOCAL_SIZE_Y 16
 
+groupshared float4 localResults[LOCAL_SIZE_Y][LOCAL_SIZE_X];
+
 float LinearizeDepth(float depth, float near, float far)
 {
 	float A = far / (far - near);
@@ -138,7 +140,7 @@ void CSMain(
 	float transmittance = 1.0;
 	float3 scatteredLight = float3(0, 0, 0);
 
-	float maxSteps = 64.0;
+	float maxSteps = uniforms.numSteps;
 	float initialSkip = 0.1;
 	//float stepSize = getNextStepSize(0, maxSteps, initialSkip, initialSkip, maxDist);
 	float stepSize = maxDist / maxSteps;
@@ -239,24 +241,36 @@ void CSMain(
 	//outColor = float4(local_num_of_sdfs, 0, 0, 1);
 	//outColor = float4(linear_depth, linear_depth, linear_depth, linear_depth);
 
-	//blend 5% of current result into accumulated
-	float blendFactor = 0.05;
-	float4 result;
-	//result = lerp(volDstTex1[dispatchThreadId.xy], float4(scatteredLight, transmittance), blendFactor);
+	float4 current = float4(scatteredLight, transmittance);
+
+	// The range of the current results around the pixel, of the ones this group computed.
+	localResults[groupThreadId.y][groupThreadId.x] = current;
+	GroupMemoryBarrierWithGroupSync();
+
+	float4 neighborhoodMin = current;
+	float4 neighborhoodMax = current;
+	for (int y = -1; y <= 1; ++y)
+	{
+		for (int x = -1; x <= 1; ++x)
+		{
+			int2 neighbor = clamp(int2(groupThreadId.xy) + int2(x, y), int2(0, 0), int2(LOCAL_SIZE_X - 1, LOCAL_SIZE_Y - 1));
+			float4 value = localResults[neighbor.y][neighbor.x];
+			neighborhoodMin = min(neighborhoodMin, value);
+			neighborhoodMax = max(neighborhoodMax, value);
+		}
+	}
+
+	//blend the current result into the accumulated one
+	//history outside of the neighborhood is from a different surface or lighting, clamping it avoids ghosting
+	float4 result = current;
 	int2 reprojCoord = (float2(reprojPos.x, -reprojPos.y) * 0.5 + 0.5) * float2(inputTexSize.xy);
-	if (reprojCoord.x >= 0 && reprojCoord.x < inputTexSize.x &&
+	if (uniforms.historyBlend < 1.0 &&
+		reprojCoord.x >= 0 && reprojCoord.x < inputTexSize.x &&
 		reprojCoord.y >= 0 && reprojCoord.y < inputTexSize.y)
 	{
-		float4 prevResult = volDstTex1[reprojCoord];
+		float4 prevResult = clamp(volDstTex1[reprojCoord], neighborhoodMin, neighborhoodMax);
 		//lerp: x*(1-s) + y*s
-		float4 blendedResult = lerp(prevResult, float4(scatteredLight, transmittance), blendFactor);
-		//if there's no history available (because opaque occluded area) then just use current
-		result = lerp(float4(scatteredLight, transmittance), blendedResult, exp(-8.0*prevResult.w));
-		//result = blendedResult;
-	}
-	else
-	{
-		result = float4(scatteredLight, transmittance);
+		result = lerp(prevResult, current, uniforms.historyBlend);
 	}
 	volDstTex0[dispatchThreadId.xy] = result;
 	dstTex[dispatchThreadId.xy] = outColor * result.w + float4(result.xyz, 0.0); //TODO volumetric shadows
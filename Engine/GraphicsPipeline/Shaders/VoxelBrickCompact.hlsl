@@ -0,0 +1,70 @@
+/*
+ * Voxel brick compaction shader
+ * Input: voxelized scene in 3D texture
+ * Output: the bricks of BRICK_SIZE^3 voxels that hold a voxel, the occupancy of every brick,
+ *	and the indirect arguments of the passes that only process the occupied bricks
+ * A group tests one brick.
+ */
+
+// Must match VoxelLighting.cpp.
+#define BRICK_SIZE 8
+#define BRICK_VOXELS (BRICK_SIZE * BRICK_SIZE * BRICK_SIZE)
+
+#define ARG_MIPMAP_GROUPS 0 //dimx of the dispatch of the mipmap generation
+#define ARG_VISUALIZER_VERTICES 3 //numVertices of the draw of the visualizer
+
+struct Uniforms
+{
+	float4x4 model, viewProj, invView;
+	float3 voxelCenter; float voxelSize;
+	float4 farPlaneData0, farPlaneData1;
+	float4 wsCamPos;
+	int voxelDimension; int inputMipLevel; int outputMipLevel; int dummy;
+	float nearPlane, farPlane;
+};
+
+ConstantBuffer<Uniforms> uniforms : register(b0);
+Texture3D<float4> voxelTex : register(t0);
+RWStructuredBuffer<uint> brickList : register(u2);
+RWStructuredBuffer<uint> brickOccupancy : register(u3);
+RWBuffer<uint> brickArguments : register(u4);
+
+groupshared uint occupied;
+
+[numthreads(BRICK_SIZE, BRICK_SIZE, BRICK_SIZE)]
+void CSMain(
+	uint3 groupId : SV_GroupID,
+	uint3 groupThreadId : SV_GroupThreadID,
+	uint groupIndex : SV_GroupIndex
+	)
+{
+	if (groupIndex == 0)
+	{
+		occupied = 0;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	//same threshold as the visualizer uses for empty voxels
+	uint3 voxel = groupId * BRICK_SIZE + groupThreadId;
+	if (voxelTex.Load(int4(voxel, 0)).w >= 0.0001)
+	{
+		InterlockedOr(occupied, 1);
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	if (groupIndex != 0)
+	{
+		return;
+	}
+
+	uint bricksPerSide = uint(uniforms.voxelDimension) / BRICK_SIZE;
+	brickOccupancy[(groupId.z * bricksPerSide + groupId.y) * bricksPerSide + groupId.x] = occupied;
+
+	if (occupied != 0)
+	{
+		uint slot;
+		InterlockedAdd(brickArguments[ARG_MIPMAP_GROUPS], 1, slot);
+		InterlockedAdd(brickArguments[ARG_VISUALIZER_VERTICES], BRICK_VOXELS);
+		brickList[slot] = groupId.x | (groupId.y << 10) | (groupId.z << 20);
+	}
+}
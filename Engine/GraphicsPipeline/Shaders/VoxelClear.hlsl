@@ -0,0 +1,34 @@
+/*
+ * Voxel clear shader
+ * Input: box of world voxel coords
+ * Output: the voxels of the box zeroed in the toroidally addressed 3D texture
+ */
+
+struct Uniforms
+{
+	float4x4 model;
+	float3 voxelCenter; float voxelSize;
+	int voxelDimension; int inputMipLevel; int dummy0; int dummy1;
+	int3 windowOrigin; int dummy2;
+	int3 regionMin; int dummy3;
+	int3 regionMax; int dummy4;
+};
+
+RWTexture3D<float4> outputTex : register(u0);
+ConstantBuffer<Uniforms> uniforms : register(b0);
+
+#define LOCAL_SIZE_X 8
+#define LOCAL_SIZE_Y 8
+#define LOCAL_SIZE_Z 8
+
+[numthreads(LOCAL_SIZE_X, LOCAL_SIZE_Y, LOCAL_SIZE_Z)]
+void CSMain(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+	int3 voxel = uniforms.regionMin + int3(dispatchThreadId);
+	if (any(voxel >= uniforms.regionMax))
+	{
+		return;
+	}
+
+	outputTex[uint3(voxel & (uniforms.voxelDimension - 1))] = float4(0, 0, 0, 0);
+}
@@ -168,6 +168,13 @@ float3 WsPosToVoxelTC(float3 wsPos)
 	return (wsPos - voxelOrigin) * voxelTotalSizeInv;
 }
 
+//the voxel textures are addressed toroidally, sample them with wrapping
+float3 WsPosToToroidalVoxelTC(float3 wsPos)
+{
+	const float voxelTotalSize = uniforms.voxelDimension * uniforms.voxelSize;
+	return frac(wsPos / voxelTotalSize);
+}
+
 //aperture: tan(coneHalfAngle) ???
 float4 ConeTrace(float3 wsPos, float3 wsNormal, float3 traceDir, float coneAperture, float ssao, const bool opacityOnly = false)
 {
@@ -190,9 +197,11 @@ float4 ConeTrace(float3 wsPos, float3 wsNormal, float3 traceDir, float coneApert
 		float mipLevel = log2(diameter * invVoxelSize); //is this correct?
 
 		//get texture coordinate to sample
-		float3 voxelTexCoord = WsPosToVoxelTC(wsStartPos + traceDir * traceDist);
+		float3 samplePos = wsStartPos + traceDir * traceDist;
+		float3 windowTexCoord = WsPosToVoxelTC(samplePos);
+		float3 voxelTexCoord = WsPosToToroidalVoxelTC(samplePos);
 
-		if (any(voxelTexCoord > float3(1,1,1)) || any(voxelTexCoord < float3(0,0,0)) || mipLevel >= maxMipLevel)
+		if (any(windowTexCoord > float3(1,1,1)) || any(windowTexCoord < float3(0,0,0)) || mipLevel >= maxMipLevel)
 		{
 			//we are outsize the voxel texture
 			//TODO: just sample from neighbouring voxel tex
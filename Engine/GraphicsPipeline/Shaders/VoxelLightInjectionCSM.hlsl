@@ -1,6 +1,6 @@
 /*
 * Voxel Light Injection from CSM shader
-* Input: Cascaded shadow maps, voxelized scene in 3D texture
+* Input: Cascaded shadow maps, voxelized scene in 3D texture, occupancy of its bricks
 * Output: voxels injected into light voxel 3D texture
 */
 
@@ -21,6 +21,10 @@ RWTexture3D<uint> voxelLightTex : register(u1);
 Texture3D<float4> voxelTex : register(t0);
 Texture2DArray<float> shadowCSMTex : register(t1);
 Texture2D<float4> shadowCSMExtentsTex : register(t2);
+StructuredBuffer<uint> brickOccupancy : register(t8);
+
+// Must match VoxelBrickCompact.hlsl.
+#define BRICK_SIZE 8
 
 SamplerState samp0 : register(s0);
 SamplerState samp1 : register(s1);
@@ -119,8 +123,22 @@ void PSMain(PS_Input input)
 		//voxel space [-1...1]
 		float3 voxelPos = (wsPos - uniforms.voxelCenter) / (uniforms.voxelSize * uniforms.voxelDimension * 0.5);
 
-		//target voxel coords [0...255]
-		uint3 insertionPos = (voxelPos * 0.5 + 0.5) * uniforms.voxelDimension;
+		if (any(abs(voxelPos) >= 1.0))
+		{
+			//outside the voxel window
+			continue;
+		}
+
+		//target voxel coords [0...255], the textures are addressed toroidally by world voxel coords
+		uint3 insertionPos = uint3(int3(floor(wsPos / uniforms.voxelSize)) & (uniforms.voxelDimension - 1));
+
+		//texels over empty bricks don't touch the voxel texture
+		uint bricksPerSide = uint(uniforms.voxelDimension) / BRICK_SIZE;
+		uint3 brick = insertionPos / BRICK_SIZE;
+		if (brickOccupancy[(brick.z * bricksPerSide + brick.y) * bricksPerSide + brick.x] == 0)
+		{
+			continue;
+		}
 
 		//float4 albedo = decodeColor(voxelTex[insertionPos]);
 		float4 albedo = voxelTex[insertionPos];
@@ -2,14 +2,40 @@
  * Voxel mipmap gen shader
  * Input: 3D texture level N
  * Output: 3D texture level N+1
+ * With VOXEL_REGION, only the voxels over a box of world voxel coords of the toroidally addressed texture
+ * With VOXEL_BRICKS, only the voxels over the occupied bricks listed by VoxelBrickCompact, a group for each brick
  */
 
+#ifdef VOXEL_REGION
+struct Uniforms
+{
+	float4x4 model;
+	float3 voxelCenter; float voxelSize;
+	int voxelDimension; int inputMipLevel; int dummy0; int dummy1;
+	int3 windowOrigin; int dummy2;
+	int3 regionMin; int dummy3;
+	int3 regionMax; int dummy4;
+};
+#elif defined(VOXEL_BRICKS)
+struct Uniforms
+{
+	float4x4 model, viewProj, invView;
+	float3 voxelCenter; float voxelSize;
+	float4 farPlaneData0, farPlaneData1;
+	float4 wsCamPos;
+	int voxelDimension; int inputMipLevel; int outputMipLevel; int dummy;
+	float nearPlane, farPlane;
+};
+
+StructuredBuffer<uint> brickList : register(t7);
+#else
 struct Uniforms
 {
 	float4x4 model;
 	float3 voxelCenter; float voxelSize;
 	int voxelDimension; int inputMipLevel;
 };
+#endif
 
 Texture3D inputTex : register(t0);
 RWTexture3D<float4> outputTex : register(u0); //need to bind specific mip level
@@ -35,9 +61,36 @@ void CSMain(
 	uint3 outputTexSize;
 	outputTex.GetDimensions(outputTexSize.x, outputTexSize.y, outputTexSize.z);
 
-	float3 uvw = (float3(dispatchThreadId.xyz) + float3(0.5, 0.5, 0.5)) / outputTexSize.xyz;
+#ifdef VOXEL_REGION
+	//the region widened to whole voxels of the output level
+	int outputShift = uniforms.inputMipLevel + 1;
+	int3 levelMin = uniforms.regionMin >> outputShift;
+	int3 levelMax = -((-uniforms.regionMax) >> outputShift);
+	int3 voxel = levelMin + int3(dispatchThreadId);
+	if (any(voxel >= levelMax))
+	{
+		return;
+	}
+	uint3 target = uint3(voxel & int3(outputTexSize - 1));
+#elif defined(VOXEL_BRICKS)
+	//a brick is LOCAL_SIZE voxels wide on level 0, it shrinks on each level down to a single voxel,
+	//which the neighboring bricks then write with the same value
+	uint packedBrick = brickList[groupId.x];
+	uint3 brick = uint3(packedBrick & 0x3ff, (packedBrick >> 10) & 0x3ff, packedBrick >> 20);
+	uint outputShift = uint(uniforms.inputMipLevel + 1);
+	uint brickExtent = max(uint(LOCAL_SIZE_X) >> outputShift, 1);
+	if (any(groupThreadId >= brickExtent))
+	{
+		return;
+	}
+	uint3 target = ((brick * LOCAL_SIZE_X) >> outputShift) + groupThreadId;
+#else
+	uint3 target = dispatchThreadId.xyz;
+#endif
+
+	float3 uvw = (float3(target) + float3(0.5, 0.5, 0.5)) / outputTexSize.xyz;
 
 	float4 data = inputTex.SampleLevel(samp1, uvw, uniforms.inputMipLevel);
 
-	outputTex[dispatchThreadId.xyz] = data; 
+	outputTex[target] = data; 
 }
@@ -1,9 +1,14 @@
 /*
 * Voxel Visualizer shader
-* Input: R32U 3D voxel texture
+* Input: R32U 3D voxel texture, occupied bricks of the voxel texture listed by VoxelBrickCompact
 * Output: voxels rendered into render target
+* Drawn indirectly, a point for each voxel of the occupied bricks
 */
 
+// Must match VoxelBrickCompact.hlsl.
+#define BRICK_SIZE 8
+#define BRICK_VOXELS (BRICK_SIZE * BRICK_SIZE * BRICK_SIZE)
+
 struct Uniforms
 {
 	float4x4 model, viewProj, invView;
@@ -19,6 +24,7 @@ struct Uniforms
 ConstantBuffer<Uniforms> uniforms : register(b0);
 //RWTexture3D<uint> voxelTex : register(u0);
 Texture3D<float4> voxelTex : register(t0);
+StructuredBuffer<uint> brickList : register(t7);
 
 struct GS_Input
 {
@@ -57,11 +63,15 @@ GS_Input VSMain(uint id : SV_VertexID)
 	float size = uniforms.voxelSize;
 	float3 center = uniforms.voxelCenter;
 
+	uint packedBrick = brickList[id / BRICK_VOXELS];
+	uint3 brick = uint3(packedBrick & 0x3ff, (packedBrick >> 10) & 0x3ff, packedBrick >> 20);
+	uint local = id % BRICK_VOXELS;
+
 	//[0...255]
 	uint4 pos;
-	pos.x = id % dim;
-	pos.y = id / (dim * dim);
-	pos.z = (id / dim) % dim;
+	pos.x = brick.x * BRICK_SIZE + local % BRICK_SIZE;
+	pos.y = brick.y * BRICK_SIZE + (local / BRICK_SIZE) % BRICK_SIZE;
+	pos.z = brick.z * BRICK_SIZE + local / (BRICK_SIZE * BRICK_SIZE);
 	pos.w = 0;
 
 	//float4 voxel = decodeColor(voxelTex.Load(pos));
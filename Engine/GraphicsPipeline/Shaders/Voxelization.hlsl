@@ -2,13 +2,17 @@
 * Voxelization shader
 * Input: Mesh + model matrix
 * Output: voxels inserted into R32U 3D voxel texture UAV
+* The texture is addressed toroidally, a world voxel v is stored at v mod voxelDimension
 */
 
 struct Uniforms
 {
 	float4x4 model;
-	float3 voxelCenter; float voxelSize;
-	int voxelDimension; int inputMipLevel;
+	float3 voxelCenter; float voxelSize; //center of the window
+	int voxelDimension; int inputMipLevel; int dummy0; int dummy1;
+	int3 windowOrigin; int dummy2; //world voxel coords of the lowest corner of the window
+	int3 regionMin; int dummy3; //world voxel coords of the voxels to write
+	int3 regionMax; int dummy4;
 };
 
 
@@ -171,7 +175,14 @@ void PSMain(PS_Input input)
 	//float4 albedo = float4(input.texCoord, 0.0, 1.0);
 	float4 albedo = albedoTex.Sample(samp0, input.texCoord);
 
-	uint3 target = input.voxelPos;
+	int3 voxel = uniforms.windowOrigin + int3(floor(input.voxelPos));
+	if (any(voxel < uniforms.regionMin) || any(voxel >= uniforms.regionMax))
+	{
+		//not part of the slab updated now
+		return;
+	}
+
+	uint3 target = uint3(voxel & (uniforms.voxelDimension - 1));
 	
 	//TODO flicker for small objects
 
@@ -4,8 +4,12 @@
 
 #include <GraphicsEngine_LL/AutoRegisterNode.hpp>
 #include <GraphicsEngine_LL/GraphicsCommandList.hpp>
+#include <GraphicsEngine_LL/LodSelector.hpp>
 #include <GraphicsEngine_LL/MeshEntity.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 
 
 namespace inl::gxeng::nodes {
@@ -15,20 +19,44 @@ INL_REGISTER_GRAPHICS_NODE(CSM)
 
 
 struct Uniforms {
-	Mat44_Packed model;
-	uint32_t cascadeIDX;
+	uint32_t numCascades;
+	uint32_t instanceOffset;
+};
+
+struct CacheUniforms {
+	uint32_t numCascades;
+	uint32_t numCommands;
+	float tolerance; // Largest difference of the light MVPs that keeps a cascade.
+	uint32_t forceInvalid;
 };
 
+static constexpr unsigned CacheGroupSize = 64;
+
+
+// Hashes the world matrix and mesh of an instance, combined by addition so the order of instances does not matter.
+static uint64_t HashInstance(const Mesh* mesh, uint32_t lod, const Mat44_Packed& transform) {
+	uint64_t hash = 14695981039346656037ull;
+	auto combine = [&hash](const void* data, size_t size) {
+		for (size_t i = 0; i < size; ++i) {
+			hash = (hash ^ static_cast<const uint8_t*>(data)[i]) * 1099511628211ull;
+		}
+	};
+	combine(&mesh, sizeof(mesh));
+	combine(&lod, sizeof(lod));
+	combine(&transform, sizeof(transform));
+	return hash;
+}
+
 static bool CheckMeshFormat(const Mesh& mesh) {
 	for (size_t i = 0; i < mesh.GetNumStreams(); i++) {
 		auto& elements = mesh.GetLayout()[0];
 		if (elements.size() != 3)
 			return false;
-		if (elements[0].semantic != eVertexElementSemantic::POSITION)
+		if (elements[0].semantic != eVertexElementSemantic::POSITION || elements[0].format != gxapi::eFormat::R16G16B16A16_UNORM)
 			return false;
-		if (elements[1].semantic != eVertexElementSemantic::NORMAL)
+		if (elements[1].semantic != eVertexElementSemantic::NORMAL || elements[1].format != gxapi::eFormat::R16G16_SNORM)
 			return false;
-		if (elements[2].semantic != eVertexElementSemantic::TEX_COORD)
+		if (elements[2].semantic != eVertexElementSemantic::TEX_COORD || elements[2].format != gxapi::eFormat::R16G16_FLOAT)
 			return false;
 	}
 
@@ -36,8 +64,9 @@ static bool CheckMeshFormat(const Mesh& mesh) {
 }
 
 
+// Stream 0 is replaced by the batch's vertices if it has any, e.g. skinned ones.
 static void ConvertToSubmittable(
-	Mesh* mesh,
+	const InstanceBatcher::Batch& batch,
 	std::vector<const gxeng::VertexBuffer*>& vertexBuffers,
 	std::vector<unsigned>& sizes,
 	std::vector<unsigned>& strides) {
@@ -45,8 +74,9 @@ static void ConvertToSubmittable(
 	sizes.clear();
 	strides.clear();
 
+	const Mesh* mesh = batch.mesh;
 	for (int streamID = 0; streamID < mesh->GetNumStreams(); streamID++) {
-		vertexBuffers.push_back(&mesh->GetVertexBuffer(streamID));
+		vertexBuffers.push_back(streamID == 0 && batch.vertices ? batch.vertices : &mesh->GetVertexBuffer(streamID));
 		sizes.push_back((unsigned)vertexBuffers.back()->GetSize());
 		strides.push_back((unsigned)mesh->GetVertexBufferStride(streamID));
 	}
@@ -65,8 +95,11 @@ void CSM::Initialize(EngineContext& context) {
 }
 
 void CSM::Reset() {
-	m_dsvs.clear();
+	m_dsv = {};
 	m_lightMVPTexSrv = {};
+	m_staticBatcher.Clear();
+	m_dynamicBatcher.Clear();
+	m_cacheCommands.clear();
 	GetInput(0)->Clear();
 	GetInput(1)->Clear();
 	GetInput(2)->Clear();
@@ -91,18 +124,20 @@ const std::string& CSM::GetOutputName(size_t index) const {
 void CSM::Setup(SetupContext& context) {
 	Texture2D& renderTarget = this->GetInput<0>().Get();
 	const gxapi::eFormat currDepthStencil = FormatAnyToDepthStencil(renderTarget.GetFormat());
+	// A single view over all cascades, the geometry shader selects the slice.
 	gxapi::DsvTexture2DArray dsvDesc;
-	dsvDesc.activeArraySize = 1;
+	dsvDesc.activeArraySize = renderTarget.GetArrayCount();
+	dsvDesc.firstArrayElement = 0;
 	dsvDesc.firstMipLevel = 0;
-	m_dsvs.resize(renderTarget.GetArrayCount());
-	for (int i = 0; i < m_dsvs.size(); i++) {
-		dsvDesc.firstArrayElement = i;
-		m_dsvs[i] = context.CreateDsv(renderTarget, currDepthStencil, dsvDesc);
-		m_dsvs[i].GetResource().SetName((std::string("CSM cascade depth tex view #") + std::to_string(i)).c_str());
-	}
+	m_dsv = context.CreateDsv(renderTarget, currDepthStencil, dsvDesc);
+	m_dsv.GetResource().SetName("CSM cascade depth tex");
+
+	InitCache(context, renderTarget);
 
 	m_entities = this->GetInput<1>().Get();
 	this->GetInput<1>().Clear();
+	BuildBatches(context);
+	BuildCacheCommands(context);
 
 	Texture2D& lightMVPTex = this->GetInput<2>().Get();
 	gxapi::SrvTexture2DArray srvDesc;
@@ -137,6 +172,14 @@ void CSM::Setup(SetupContext& context) {
 		lightMVPBindParamDesc.relativeChangeFrequency = 0;
 		lightMVPBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::VERTEX;
 
+		BindParameterDesc instanceBindParamDesc;
+		m_instanceBindParam = BindParameter(eBindParameterType::TEXTURE, 1);
+		instanceBindParamDesc.parameter = m_instanceBindParam;
+		instanceBindParamDesc.constantSize = 0;
+		instanceBindParamDesc.relativeAccessFrequency = 0;
+		instanceBindParamDesc.relativeChangeFrequency = 0;
+		instanceBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::VERTEX;
+
 		BindParameterDesc sampBindParamDesc;
 		sampBindParamDesc.parameter = BindParameter(eBindParameterType::SAMPLER, 0);
 		sampBindParamDesc.constantSize = 0;
@@ -154,7 +197,73 @@ void CSM::Setup(SetupContext& context) {
 		samplerDesc.registerSpace = 0;
 		samplerDesc.shaderVisibility = gxapi::eShaderVisiblity::PIXEL;
 
-		m_binder = context.CreateBinder({ uniformsBindParamDesc, lightMVPBindParamDesc, sampBindParamDesc }, { samplerDesc });
+		BindParameterDesc cascadeListBindParamDesc;
+		m_cascadeListBindParam = BindParameter(eBindParameterType::TEXTURE, 2);
+		cascadeListBindParamDesc.parameter = m_cascadeListBindParam;
+		cascadeListBindParamDesc.constantSize = 0;
+		cascadeListBindParamDesc.relativeAccessFrequency = 0;
+		cascadeListBindParamDesc.relativeChangeFrequency = 0;
+		cascadeListBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::VERTEX;
+
+		m_binder = context.CreateBinder({ uniformsBindParamDesc, lightMVPBindParamDesc, instanceBindParamDesc, cascadeListBindParamDesc, sampBindParamDesc }, { samplerDesc });
+		m_uniformsSlot = m_binder.Resolve(m_uniformsBindParam);
+	}
+
+	if (!m_cacheBinder) {
+		BindParameterDesc uniformsBindParamDesc;
+		m_cacheUniformsBindParam = BindParameter(eBindParameterType::CONSTANT, 0);
+		uniformsBindParamDesc.parameter = m_cacheUniformsBindParam;
+		uniformsBindParamDesc.constantSize = sizeof(CacheUniforms);
+		uniformsBindParamDesc.relativeAccessFrequency = 0;
+		uniformsBindParamDesc.relativeChangeFrequency = 0;
+		uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc lightMVPBindParamDesc;
+		m_cacheLightMVPBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		lightMVPBindParamDesc.parameter = m_cacheLightMVPBindParam;
+		lightMVPBindParamDesc.constantSize = 0;
+		lightMVPBindParamDesc.relativeAccessFrequency = 0;
+		lightMVPBindParamDesc.relativeChangeFrequency = 0;
+		lightMVPBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc cachedMVPBindParamDesc;
+		m_cachedMVPBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		cachedMVPBindParamDesc.parameter = m_cachedMVPBindParam;
+		cachedMVPBindParamDesc.constantSize = 0;
+		cachedMVPBindParamDesc.relativeAccessFrequency = 0;
+		cachedMVPBindParamDesc.relativeChangeFrequency = 0;
+		cachedMVPBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc listBindParamDesc;
+		m_cacheListBindParam = BindParameter(eBindParameterType::UNORDERED, 1);
+		listBindParamDesc.parameter = m_cacheListBindParam;
+		listBindParamDesc.constantSize = 0;
+		listBindParamDesc.relativeAccessFrequency = 0;
+		listBindParamDesc.relativeChangeFrequency = 0;
+		listBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc commandsBindParamDesc;
+		m_cacheCommandsBindParam = BindParameter(eBindParameterType::UNORDERED, 2);
+		commandsBindParamDesc.parameter = m_cacheCommandsBindParam;
+		commandsBindParamDesc.constantSize = 0;
+		commandsBindParamDesc.relativeAccessFrequency = 0;
+		commandsBindParamDesc.relativeChangeFrequency = 0;
+		commandsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		m_cacheBinder = context.CreateBinder({ uniformsBindParamDesc, lightMVPBindParamDesc, cachedMVPBindParamDesc, listBindParamDesc, commandsBindParamDesc }, {});
+	}
+
+	if (m_cacheCSO == nullptr) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_cacheShader = context.CreateShader("CSMCache", shaderParts, "");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_cacheBinder.GetRootSignature();
+		csoDesc.cs = m_cacheShader.cs;
+
+		m_cacheCSO.reset(context.CreatePSO(csoDesc));
 	}
 
 	if (!m_PSO || currDepthStencil != m_depthStencilFormat) {
@@ -166,14 +275,17 @@ void CSM::Setup(SetupContext& context) {
 
 		ShaderParts shaderParts;
 		shaderParts.vs = true;
+		shaderParts.gs = true;
 		shaderParts.ps = true;
 
 		m_shader = context.CreateShader("CSM", shaderParts, "");
+		m_cachedShader = context.CreateShader("CSM", shaderParts, "CACHED=1");
+		m_clearShader = context.CreateShader("CSMCacheClear", shaderParts, "");
 
 		std::vector<gxapi::InputElementDesc> inputElementDesc = {
-			gxapi::InputElementDesc("POSITION", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 0),
-			gxapi::InputElementDesc("NORMAL", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 12),
-			gxapi::InputElementDesc("TEX_COORD", 0, gxapi::eFormat::R32G32_FLOAT, 0, 24),
+			gxapi::InputElementDesc("POSITION", 0, gxapi::eFormat::R16G16B16A16_UNORM, 0, 0),
+			gxapi::InputElementDesc("NORMAL", 0, gxapi::eFormat::R16G16_SNORM, 0, 8),
+			gxapi::InputElementDesc("TEX_COORD", 0, gxapi::eFormat::R16G16_FLOAT, 0, 12),
 		};
 
 		gxapi::GraphicsPipelineStateDesc psoDesc;
@@ -181,6 +293,7 @@ void CSM::Setup(SetupContext& context) {
 		psoDesc.inputLayout.numElements = (unsigned)inputElementDesc.size();
 		psoDesc.rootSignature = m_binder.GetRootSignature();
 		psoDesc.vs = m_shader.vs;
+		psoDesc.gs = m_shader.gs;
 		psoDesc.ps = m_shader.ps;
 		psoDesc.rasterization = gxapi::RasterizerState(gxapi::eFillMode::SOLID, gxapi::eCullMode::DRAW_CCW);
 		psoDesc.primitiveTopologyType = gxapi::ePrimitiveTopologyType::TRIANGLE;
@@ -191,6 +304,193 @@ void CSM::Setup(SetupContext& context) {
 		psoDesc.numRenderTargets = 0;
 
 		m_PSO.reset(context.CreatePSO(psoDesc));
+
+		psoDesc.vs = m_cachedShader.vs;
+		psoDesc.gs = m_cachedShader.gs;
+		psoDesc.ps = m_cachedShader.ps;
+		m_cachedPSO.reset(context.CreatePSO(psoDesc));
+
+		// Overwrites the depth of the cascades to render again with the far plane.
+		psoDesc.inputLayout.elements = nullptr;
+		psoDesc.inputLayout.numElements = 0;
+		psoDesc.vs = m_clearShader.vs;
+		psoDesc.gs = m_clearShader.gs;
+		psoDesc.ps = m_clearShader.ps;
+		psoDesc.rasterization = gxapi::RasterizerState(gxapi::eFillMode::SOLID, gxapi::eCullMode::DRAW_ALL);
+		psoDesc.depthStencilState.depthFunc = gxapi::eComparisonFunction::ALWAYS;
+		m_clearPSO.reset(context.CreatePSO(psoDesc));
+	}
+
+	if (m_commandSignature == nullptr) {
+		// The draws set the cascade count, it must be an inline constant.
+		int rootParamIndex, rootTableIndex;
+		m_binder.Translate(m_uniformsBindParam, rootParamIndex, rootTableIndex);
+		if (m_binder.GetRootSignatureDesc().rootParameters[rootParamIndex].type != gxapi::RootParameterDesc::CONSTANT) {
+			throw InvalidStateException("Shadow map uniforms are not bound as root constants.");
+		}
+
+		gxapi::CommandSignatureDesc signatureDesc;
+		signatureDesc.byteStride = sizeof(CacheDrawCommand);
+		signatureDesc.arguments = {
+			gxapi::IndirectArgumentDesc::Constant((unsigned)rootParamIndex, 0, sizeof(Uniforms) / 4),
+			gxapi::IndirectArgumentDesc::VertexBufferView(0),
+			gxapi::IndirectArgumentDesc::IndexBufferView(),
+			gxapi::IndirectArgumentDesc::DrawIndexed(),
+		};
+		m_commandSignature.reset(context.CreateCommandSignature(signatureDesc, &m_binder));
+	}
+}
+
+
+void CSM::InitCache(SetupContext& context, const Texture2D& renderTarget) {
+	if (m_cacheTex
+		&& m_cacheTex.GetWidth() == renderTarget.GetWidth()
+		&& m_cacheTex.GetHeight() == renderTarget.GetHeight()
+		&& m_cacheTex.GetArrayCount() == renderTarget.GetArrayCount()
+		&& m_cacheTex.GetFormat() == renderTarget.GetFormat()) {
+		return;
+	}
+
+	const uint32_t numCascades = (uint32_t)renderTarget.GetArrayCount();
+
+	Texture2DDesc desc{ renderTarget.GetWidth(), renderTarget.GetHeight(), renderTarget.GetFormat(), 1, (uint16_t)numCascades };
+	m_cacheTex = context.CreateTexture2D(desc, { false, false, true, false });
+	m_cacheTex.SetName("CSM static caster cache");
+
+	gxapi::DsvTexture2DArray dsvDesc;
+	dsvDesc.activeArraySize = numCascades;
+	dsvDesc.firstArrayElement = 0;
+	dsvDesc.firstMipLevel = 0;
+	m_cacheDsv = context.CreateDsv(m_cacheTex, FormatAnyToDepthStencil(renderTarget.GetFormat()), dsvDesc);
+
+	m_cachedMVPBuffer = context.CreateBuffer(numCascades * sizeof(Mat44_Packed), true);
+	m_cachedMVPBuffer.SetName("CSM cached light MVPs");
+	// The count of cascades to render, then their indices.
+	m_cascadeListBuffer = context.CreateBuffer((numCascades + 1) * sizeof(uint32_t), true);
+	m_cascadeListBuffer.SetName("CSM cascades to render");
+
+	gxapi::UavBuffer structuredDesc;
+	structuredDesc.raw = false;
+	structuredDesc.firstElement = 0;
+	structuredDesc.countOffset = 0;
+
+	structuredDesc.numElements = numCascades;
+	structuredDesc.elementStride = sizeof(Mat44_Packed);
+	m_cachedMVPView = context.CreateUav(m_cachedMVPBuffer, gxapi::eFormat::UNKNOWN, structuredDesc);
+	structuredDesc.numElements = numCascades + 1;
+	structuredDesc.elementStride = sizeof(uint32_t);
+	m_cascadeListView = context.CreateUav(m_cascadeListBuffer, gxapi::eFormat::UNKNOWN, structuredDesc);
+
+	gxapi::SrvBuffer srvDesc;
+	srvDesc.firstElement = 0;
+	srvDesc.numElements = numCascades + 1;
+	srvDesc.structureStrideInBytes = sizeof(uint32_t);
+	srvDesc.isRaw = false;
+	m_cascadeListSrv = context.CreateSrv(m_cascadeListBuffer, gxapi::eFormat::UNKNOWN, srvDesc);
+
+	m_cacheInvalid = true;
+}
+
+
+void CSM::BuildBatches(SetupContext& context) {
+	m_staticBatcher.Clear();
+	m_dynamicBatcher.Clear();
+	if (!m_entities) {
+		return;
+	}
+
+	// Group entities by mesh, materials do not matter for depth only rendering.
+	m_renderQueue.Clear();
+	m_renderQueue.Reserve(m_entities->Size());
+	for (size_t i = 0; i < m_entities->Size(); ++i) {
+		const MeshEntity* entity = (*m_entities)[i];
+		uint64_t meshId = RenderQueue::PointerId(entity->GetMesh()) + entity->GetLod();
+		m_renderQueue.Add(RenderQueue::MakeKey(0, 0, meshId, 0.0f), uint32_t(i));
+	}
+	m_renderQueue.Sort(context.GetJobScheduler());
+
+	uint64_t staticHash = 0;
+	for (const RenderQueue::Item& item : m_renderQueue) {
+		const MeshEntity* entity = (*m_entities)[item.index];
+		Mesh* mesh = entity->GetMesh();
+
+		if (mesh->GetLod(0).indexCount == 3600) {
+			continue; //skip quadcopter for visualization purposes (obscures camera...)
+		}
+		if (!CheckMeshFormat(*mesh)) {
+			assert(false);
+			continue;
+		}
+
+		// Shadows are less detailed than the camera's view.
+		uint32_t lod = std::min(entity->GetLod() + LodSelector::ShadowLodBias, uint32_t(mesh->GetLodCount()) - 1);
+		// Skinned entities change pose every frame, they are never cached.
+		Mat44 world = entity->GetPositionDequantization() * entity->GetTransform();
+		if (entity->HasSkinnedVertices()) {
+			m_dynamicBatcher.Add(mesh, nullptr, world, lod, &entity->GetSkinnedVertices());
+		}
+		else if (entity->IsDynamic()) {
+			m_dynamicBatcher.Add(mesh, nullptr, world, lod);
+		}
+		else {
+			m_staticBatcher.Add(mesh, nullptr, world, lod);
+			staticHash += HashInstance(mesh, lod, world);
+		}
+	}
+	m_staticInstanceBuffer.Reserve(context, m_staticBatcher.GetInstanceCount());
+	m_dynamicInstanceBuffer.Reserve(context, m_dynamicBatcher.GetInstanceCount());
+
+	// Any change to the static casters, including their levels of detail, renders all cascades again.
+	if (staticHash != m_staticHash) {
+		m_staticHash = staticHash;
+		m_cacheInvalid = true;
+	}
+}
+
+
+void CSM::BuildCacheCommands(SetupContext& context) {
+	static_assert(sizeof(CacheDrawCommand) == 64, "Must match command signature and CSMCache.hlsl.");
+
+	m_cacheCommands.clear();
+	for (const InstanceBatcher::Batch& batch : m_staticBatcher.GetBatches()) {
+		const Mesh* mesh = batch.mesh;
+		const VertexBuffer& vertexBuffer = mesh->GetVertexBuffer(0);
+		const IndexBuffer& indexBuffer = mesh->GetIndexBuffer();
+		const Mesh::Lod& lod = mesh->GetLod(batch.lod);
+
+		// Instance counts are of one cascade, the GPU multiplies them by the cascades to render.
+		CacheDrawCommand command;
+		command.numCascades = 0;
+		command.instanceOffset = batch.firstInstance;
+		command.vertexBuffer.gpuVirtualAddress = (uint64_t)vertexBuffer.GetVirtualAddress();
+		command.vertexBuffer.sizeInBytes = (uint32_t)vertexBuffer.GetSize();
+		command.vertexBuffer.strideInBytes = (uint32_t)mesh->GetVertexBufferStride(0);
+		command.indexBuffer.gpuVirtualAddress = (uint64_t)indexBuffer.GetVirtualAddress();
+		command.indexBuffer.sizeInBytes = (uint32_t)indexBuffer.GetSize();
+		command.indexBuffer.format = (uint32_t)(mesh->IsIndexBuffer32Bit() ? gxapi::eFormat::R32_UINT : gxapi::eFormat::R16_UINT);
+		command.draw.numIndices = lod.indexCount;
+		command.draw.numInstances = batch.instanceCount;
+		command.draw.startIndex = lod.firstIndex;
+		command.draw.vertexOffset = 0;
+		command.draw.startInstance = 0;
+		command.padding = 0;
+		m_cacheCommands.push_back(command);
+	}
+
+	// Grow the GPU buffer geometrically.
+	if (m_cacheCommands.size() > m_commandCapacity) {
+		m_commandCapacity = std::max(m_cacheCommands.size(), std::max(m_commandCapacity * 2, size_t(CacheGroupSize)));
+
+		m_commandBuffer = context.CreateBuffer(m_commandCapacity * sizeof(CacheDrawCommand), true);
+		m_commandBuffer.SetName("CSM static caster draw commands");
+
+		gxapi::UavBuffer structuredDesc;
+		structuredDesc.raw = false;
+		structuredDesc.firstElement = 0;
+		structuredDesc.numElements = (unsigned)m_commandCapacity;
+		structuredDesc.elementStride = sizeof(CacheDrawCommand);
+		structuredDesc.countOffset = 0;
+		m_commandView = context.CreateUav(m_commandBuffer, gxapi::eFormat::UNKNOWN, structuredDesc);
 	}
 }
 
@@ -198,78 +498,142 @@ void CSM::Setup(SetupContext& context) {
 void CSM::Execute(RenderContext& context) {
 	GraphicsCommandList& commandList = context.AsGraphics();
 
-	assert(m_dsvs.size() > 0);
+	assert(m_dsv);
+
+	m_staticInstanceBuffer.Upload(context, commandList, m_staticBatcher.GetTransforms());
+	m_dynamicInstanceBuffer.Upload(context, commandList, m_dynamicBatcher.GetTransforms());
 
-	Texture2D cascadeTextures = m_dsvs[0].GetResource();
-	const uint16_t numCascades = (uint16_t)m_dsvs.size();
+	Texture2D cascadeTextures = m_dsv.GetResource();
+	const uint32_t numCascades = (uint32_t)cascadeTextures.GetArrayCount();
 	const uint64_t cascadeWidth = cascadeTextures.GetWidth();
 	const uint32_t cascadeHeight = cascadeTextures.GetHeight();
 
 	gxapi::Rectangle rect{ 0, (int)cascadeTextures.GetHeight(), 0, (int)cascadeTextures.GetWidth() };
 	commandList.SetScissorRects(1, &rect);
 
+	gxapi::Viewport viewport;
+	viewport.height = (float)cascadeHeight;
+	viewport.width = (float)cascadeWidth;
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	viewport.topLeftY = 0;
+	viewport.topLeftX = 0;
+	commandList.SetViewports(1, &viewport);
+
+	commandList.SetResourceState(m_lightMVPTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+
+	RenderCache(context, commandList);
+
+	// Start from the static casters.
+	commandList.SetResourceState(m_cacheTex, gxapi::eResourceState::COPY_SOURCE, gxapi::ALL_SUBRESOURCES);
+	commandList.SetResourceState(cascadeTextures, gxapi::eResourceState::COPY_DEST, gxapi::ALL_SUBRESOURCES);
+	for (uint32_t cascade = 0; cascade < numCascades; ++cascade) {
+		unsigned subresource = cascadeTextures.GetSubresourceIndex(0, cascade, 0);
+		commandList.CopyTexture(cascadeTextures, m_cacheTex, SubTexture2D(subresource), SubTexture2D(subresource));
+	}
+
+	commandList.SetResourceState(cascadeTextures, gxapi::eResourceState::DEPTH_WRITE, gxapi::ALL_SUBRESOURCES);
+	commandList.SetRenderTargets(0, nullptr, &m_dsv);
+
+	if (m_dynamicBatcher.GetInstanceCount() == 0) {
+		return;
+	}
+
 	commandList.SetPipelineState(m_PSO.get());
 	commandList.SetGraphicsBinder(&m_binder);
 	commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
-
-	commandList.SetResourceState(m_lightMVPTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
 	commandList.BindGraphics(m_lightMVPBindParam, m_lightMVPTexSrv);
+	commandList.BindGraphics(m_instanceBindParam, m_dynamicInstanceBuffer.GetView());
 
 	std::vector<const gxeng::VertexBuffer*> vertexBuffers;
 	std::vector<unsigned> sizes;
 	std::vector<unsigned> strides;
 
-	commandList.SetResourceState(cascadeTextures, gxapi::eResourceState::DEPTH_WRITE, gxapi::ALL_SUBRESOURCES);
-	for (int cascadeIdx = 0; cascadeIdx < numCascades; ++cascadeIdx) {
-		commandList.SetRenderTargets(0, nullptr, &m_dsvs[cascadeIdx]);
-		commandList.ClearDepthStencil(m_dsvs[cascadeIdx], 1, 0, 0, nullptr, true, true);
-
-		gxapi::Viewport viewport;
-		viewport.height = (float)cascadeHeight;
-		viewport.width = (float)cascadeWidth;
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
-		viewport.topLeftY = 0;
-		viewport.topLeftX = 0;
-		commandList.SetViewports(1, &viewport);
-
-		// Iterate over all entities
-		for (const MeshEntity* entity : *m_entities) {
-			// Get entity parameters
-			Mesh* mesh = entity->GetMesh();
-			auto position = entity->GetPosition();
-
-			if (mesh->GetIndexBuffer().GetIndexCount() == 3600) {
-				continue; //skip quadcopter for visualization purposes (obscures camera...)
-			}
-
-			// Draw mesh
-			if (!CheckMeshFormat(*mesh)) {
-				assert(false);
-				continue;
-			}
-
-			ConvertToSubmittable(mesh, vertexBuffers, sizes, strides);
-
-			Mat44 model = entity->GetTransform();
-
-			Uniforms uniformsCBData;
-			uniformsCBData.model = model;
-
-			uniformsCBData.cascadeIDX = cascadeIdx;
-
-			commandList.BindGraphics(m_uniformsBindParam, &uniformsCBData, sizeof(uniformsCBData));
-
-			for (auto& vb : vertexBuffers) {
-				commandList.SetResourceState(*vb, gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
-			}
-			commandList.SetResourceState(mesh->GetIndexBuffer(), gxapi::eResourceState::INDEX_BUFFER);
-
-			commandList.SetVertexBuffers(0, (unsigned)vertexBuffers.size(), vertexBuffers.data(), sizes.data(), strides.data());
-			commandList.SetIndexBuffer(&mesh->GetIndexBuffer(), mesh->IsIndexBuffer32Bit());
-			commandList.DrawIndexedInstanced((unsigned)mesh->GetIndexBuffer().GetIndexCount());
+	// One instanced draw per mesh covers all cascades, each object is instanced once per cascade.
+	for (const InstanceBatcher::Batch& batch : m_dynamicBatcher.GetBatches()) {
+		Mesh* mesh = batch.mesh;
+
+		ConvertToSubmittable(batch, vertexBuffers, sizes, strides);
+
+		Uniforms uniformsCBData;
+		uniformsCBData.numCascades = numCascades;
+		uniformsCBData.instanceOffset = batch.firstInstance;
+
+		commandList.BindGraphics(m_uniformsSlot, &uniformsCBData, sizeof(uniformsCBData));
+
+		for (auto& vb : vertexBuffers) {
+			commandList.SetResourceState(*vb, gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
 		}
+		commandList.SetResourceState(mesh->GetIndexBuffer(), gxapi::eResourceState::INDEX_BUFFER);
+
+		commandList.SetVertexBuffers(0, (unsigned)vertexBuffers.size(), vertexBuffers.data(), sizes.data(), strides.data());
+		commandList.SetIndexBuffer(&mesh->GetIndexBuffer(), mesh->IsIndexBuffer32Bit());
+		const Mesh::Lod& lod = mesh->GetLod(batch.lod);
+		commandList.DrawIndexedInstanced(lod.indexCount, lod.firstIndex, 0, batch.instanceCount * numCascades);
+	}
+}
+
+
+void CSM::RenderCache(RenderContext& context, GraphicsCommandList& commandList) {
+	const uint32_t numCascades = (uint32_t)m_cacheTex.GetArrayCount();
+
+	// Find the cascades to render again and patch the draws of the static casters for them.
+	CacheUniforms cacheUniforms;
+	cacheUniforms.numCascades = numCascades;
+	cacheUniforms.numCommands = (uint32_t)m_cacheCommands.size();
+	cacheUniforms.tolerance = CacheTolerance * 2.0f / (float)m_cacheTex.GetWidth(); // Clip space spans 2 over the width.
+	cacheUniforms.forceInvalid = m_cacheInvalid ? 1 : 0;
+	m_cacheInvalid = false;
+
+	if (!m_cacheCommands.empty()) {
+		commandList.SetResourceState(m_commandBuffer, gxapi::eResourceState::COPY_DEST);
+		context.Upload(m_commandBuffer, 0, m_cacheCommands.data(), m_cacheCommands.size() * sizeof(CacheDrawCommand));
+		commandList.SetResourceState(m_commandBuffer, gxapi::eResourceState::UNORDERED_ACCESS);
 	}
+	commandList.SetResourceState(m_cachedMVPBuffer, gxapi::eResourceState::UNORDERED_ACCESS);
+	commandList.SetResourceState(m_cascadeListBuffer, gxapi::eResourceState::UNORDERED_ACCESS);
+
+	commandList.SetPipelineState(m_cacheCSO.get());
+	commandList.SetComputeBinder(&m_cacheBinder);
+	commandList.BindCompute(m_cacheUniformsBindParam, &cacheUniforms, sizeof(cacheUniforms));
+	commandList.BindCompute(m_cacheLightMVPBindParam, m_lightMVPTexSrv);
+	commandList.BindCompute(m_cachedMVPBindParam, m_cachedMVPView);
+	commandList.BindCompute(m_cacheListBindParam, m_cascadeListView);
+	if (!m_cacheCommands.empty()) {
+		commandList.BindCompute(m_cacheCommandsBindParam, m_commandView);
+	}
+	// A single group, so the cascades are decided before any command is patched.
+	commandList.Dispatch(1, 1, 1);
+
+	commandList.SetResourceState(m_cascadeListBuffer, { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+	commandList.SetResourceState(m_cacheTex, gxapi::eResourceState::DEPTH_WRITE, gxapi::ALL_SUBRESOURCES);
+	commandList.SetRenderTargets(0, nullptr, &m_cacheDsv);
+
+	commandList.SetGraphicsBinder(&m_binder);
+	commandList.BindGraphics(m_lightMVPBindParam, m_lightMVPTexSrv);
+	commandList.BindGraphics(m_cascadeListBindParam, m_cascadeListSrv);
+
+	// Clear the cascades to render, instanced once per cascade.
+	commandList.SetPipelineState(m_clearPSO.get());
+	commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLESTRIP);
+	commandList.DrawInstanced(4, 0, numCascades);
+
+	if (m_cacheCommands.empty()) {
+		return;
+	}
+
+	commandList.SetResourceState(m_commandBuffer, gxapi::eResourceState::INDIRECT_ARGUMENT);
+
+	// The commands reference the mesh buffers directly.
+	for (const InstanceBatcher::Batch& batch : m_staticBatcher.GetBatches()) {
+		commandList.SetResourceState(batch.mesh->GetVertexBuffer(0), gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
+		commandList.SetResourceState(batch.mesh->GetIndexBuffer(), gxapi::eResourceState::INDEX_BUFFER);
+	}
+
+	commandList.SetPipelineState(m_cachedPSO.get());
+	commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
+	commandList.BindGraphics(m_instanceBindParam, m_staticInstanceBuffer.GetView());
+	commandList.ExecuteIndirect(m_commandSignature.get(), (unsigned)m_cacheCommands.size(), m_commandBuffer);
 }
 
 
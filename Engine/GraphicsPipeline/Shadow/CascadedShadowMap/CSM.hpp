@@ -1,8 +1,12 @@
 #pragma once
 
+#include <GraphicsApi_LL/ICommandSignature.hpp>
 #include <GraphicsApi_LL/IPipelineState.hpp>
 #include <GraphicsEngine_LL/GraphicsNode.hpp>
+#include <GraphicsEngine_LL/InstanceBatcher.hpp>
+#include <GraphicsEngine_LL/InstanceBuffer.hpp>
 #include <GraphicsEngine_LL/Mesh.hpp>
+#include <GraphicsEngine_LL/RenderQueue.hpp>
 
 
 namespace inl::gxeng::nodes {
@@ -11,6 +15,14 @@ namespace inl::gxeng::nodes {
 /// Inputs: render target, scene objects, light cascade MVP transform matrices in a texture
 /// Output: render target
 /// </summary>
+/// <remarks>
+/// Static casters are rendered into a persistent cache, one slice per cascade. A cascade of the cache is only
+/// rendered again when its light MVP moves more than <see cref="CacheTolerance"/> texels away from the one it was
+/// rendered with, or when the static casters change. The cascade matrices are fitted on the GPU, so the check
+/// runs there too and writes the draws of the static casters as indirect commands.
+/// Every frame the cache is copied to the render target and the dynamic casters
+/// (see <see cref="MeshEntity::SetDynamic"/>) are drawn on top.
+/// </remarks>
 class CSM : virtual public GraphicsNode,
 			virtual public GraphicsTask,
 			virtual public InputPortConfig<Texture2D, const EntityCollection<MeshEntity>*, Texture2D>,
@@ -29,18 +41,73 @@ public:
 	void Setup(SetupContext& context) override;
 	void Execute(RenderContext& context) override;
 
+	static constexpr float CacheTolerance = 0.5f;
+
+private:
+	// One indirect draw of a static batch, layout must match CSMCache.hlsl.
+	struct CacheDrawCommand {
+		uint32_t numCascades; // Root constants, patched on the GPU to the number of cascades to render.
+		uint32_t instanceOffset;
+		gxapi::VertexBufferViewArguments vertexBuffer;
+		gxapi::IndexBufferViewArguments indexBuffer;
+		gxapi::DrawIndexedArguments draw;
+		uint32_t padding; // Keeps the 64 bit addresses of the next command aligned.
+	};
+
+	void BuildBatches(SetupContext& context);
+	void InitCache(SetupContext& context, const Texture2D& renderTarget);
+	void BuildCacheCommands(SetupContext& context);
+	void RenderCache(RenderContext& context, GraphicsCommandList& commandList);
+
 protected:
 	Binder m_binder;
 	BindParameter m_uniformsBindParam;
 	BindParameter m_lightMVPBindParam;
+	BindParameter m_instanceBindParam;
+	BindParameter m_cascadeListBindParam;
+	BindSlot m_uniformsSlot; // Bound for each dynamic batch.
 	ShaderProgram m_shader;
+	ShaderProgram m_cachedShader;
+	ShaderProgram m_clearShader;
 	std::unique_ptr<gxapi::IPipelineState> m_PSO;
+	std::unique_ptr<gxapi::IPipelineState> m_cachedPSO;
+	std::unique_ptr<gxapi::IPipelineState> m_clearPSO;
+	std::unique_ptr<gxapi::ICommandSignature> m_commandSignature;
 	gxapi::eFormat m_depthStencilFormat;
 
+	Binder m_cacheBinder;
+	BindParameter m_cacheUniformsBindParam;
+	BindParameter m_cacheLightMVPBindParam;
+	BindParameter m_cachedMVPBindParam;
+	BindParameter m_cacheListBindParam;
+	BindParameter m_cacheCommandsBindParam;
+	ShaderProgram m_cacheShader;
+	std::unique_ptr<gxapi::IPipelineState> m_cacheCSO;
+
+	// Persistent cache of the static casters.
+	Texture2D m_cacheTex;
+	DepthStencilView2D m_cacheDsv;
+	LinearBuffer m_cachedMVPBuffer;
+	LinearBuffer m_cascadeListBuffer;
+	LinearBuffer m_commandBuffer;
+	RWBufferView m_cachedMVPView;
+	RWBufferView m_cascadeListView;
+	BufferView m_cascadeListSrv;
+	RWBufferView m_commandView;
+	size_t m_commandCapacity = 0;
+	uint64_t m_staticHash = 0;
+	bool m_cacheInvalid = true;
+
 private: // render context
-	std::vector<DepthStencilView2D> m_dsvs;
+	DepthStencilView2D m_dsv;
 	const EntityCollection<MeshEntity>* m_entities;
 	TextureView2D m_lightMVPTexSrv;
+	RenderQueue m_renderQueue;
+	InstanceBatcher m_staticBatcher;
+	InstanceBatcher m_dynamicBatcher;
+	InstanceBuffer m_staticInstanceBuffer;
+	InstanceBuffer m_dynamicInstanceBuffer;
+	std::vector<CacheDrawCommand> m_cacheCommands;
 };
 
 
@@ -24,8 +24,14 @@ struct Uniforms {
 };
 
 
+// Must match the SINGLE_PASS variant of DepthReductionFinal.hlsl.
+static constexpr unsigned SinglePassGroupWidth = 32;
+static constexpr unsigned SinglePassGroupHeight = 16;
+
+
 DepthReductionFinal::DepthReductionFinal() {
 	this->GetInput<0>().Set({});
+	this->GetInput<3>().Set(false);
 }
 
 
@@ -41,13 +47,15 @@ void DepthReductionFinal::Reset() {
 	GetInput<0>().Clear();
 	GetInput<1>().Clear();
 	GetInput<2>().Clear();
+	GetInput<3>().Clear();
 }
 
 const std::string& DepthReductionFinal::GetInputName(size_t index) const {
 	static const std::vector<std::string> names = {
 		"reductionTex",
 		"camera",
-		"directionalLights"
+		"directionalLights",
+		"singlePass"
 	};
 	return names[index];
 }
@@ -67,6 +75,7 @@ void DepthReductionFinal::Setup(SetupContext& context) {
 
 
 	Texture2D reductionTex = this->GetInput<0>().Get();
+	m_singlePass = this->GetInput<3>().Get();
 
 	gxapi::SrvTexture2DArray srvDesc;
 	srvDesc.activeArraySize = 1;
@@ -75,7 +84,8 @@ void DepthReductionFinal::Setup(SetupContext& context) {
 	srvDesc.mostDetailedMip = 0;
 	srvDesc.numMipLevels = 1;
 	srvDesc.planeIndex = 0;
-	m_reductionTexSrv = context.CreateSrv(reductionTex, reductionTex.GetFormat(), srvDesc);
+	auto reductionFormat = m_singlePass ? FormatDepthToColor(reductionTex.GetFormat()) : reductionTex.GetFormat();
+	m_reductionTexSrv = context.CreateSrv(reductionTex, reductionFormat, srvDesc);
 
 
 	m_camera = this->GetInput<1>().Get();
@@ -155,7 +165,11 @@ void DepthReductionFinal::Setup(SetupContext& context) {
 		samplerDesc.registerSpace = 0;
 		samplerDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
 
-		m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc, reductionBindParamDesc, outputBindParamDesc0, outputBindParamDesc1, outputBindParamDesc2, outputBindParamDesc3 }, { samplerDesc });
+		BindParameterDesc stateBindParamDesc = outputBindParamDesc3;
+		m_stateBindParam = BindParameter(eBindParameterType::UNORDERED, 4);
+		stateBindParamDesc.parameter = m_stateBindParam;
+
+		m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc, reductionBindParamDesc, outputBindParamDesc0, outputBindParamDesc1, outputBindParamDesc2, outputBindParamDesc3, stateBindParamDesc }, { samplerDesc });
 	}
 
 	if (!m_CSO) {
@@ -172,6 +186,19 @@ void DepthReductionFinal::Setup(SetupContext& context) {
 
 		m_CSO.reset(context.CreatePSO(csoDesc));
 	}
+
+	if (m_singlePass && !m_singlePassCSO) {
+		ShaderParts shaderParts;
+		shaderParts.cs = true;
+
+		m_singlePassShader = context.CreateShader("DepthReductionFinal", shaderParts, "SINGLE_PASS=1");
+
+		gxapi::ComputePipelineStateDesc csoDesc;
+		csoDesc.rootSignature = m_binder.GetRootSignature();
+		csoDesc.cs = m_singlePassShader.cs;
+
+		m_singlePassCSO.reset(context.CreatePSO(csoDesc));
+	}
 }
 
 
@@ -253,21 +280,36 @@ void DepthReductionFinal::Execute(RenderContext& context) {
 	gxeng::ConstBufferView cbv = context.CreateCbv(cb, 0, sizeof(Uniforms));
 
 
+	// The last group of the single pass finds itself by the finished group count, min depth starts at 1.0f.
+	const uint32_t initialState[3] = { 0, 0x3F800000u, 0 };
+	commandList.SetResourceState(m_stateBuffer, gxapi::eResourceState::COPY_DEST);
+	context.Upload(m_stateBuffer, 0, initialState, sizeof(initialState));
+
+	commandList.SetResourceState(m_stateBuffer, gxapi::eResourceState::UNORDERED_ACCESS);
 	commandList.SetResourceState(m_lightMvpUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
 	commandList.SetResourceState(m_shadowMxUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
 	commandList.SetResourceState(m_csmSplitsUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
 	commandList.SetResourceState(m_csmExtentsUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
 	commandList.SetResourceState(m_reductionTexSrv.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
 
-	commandList.SetPipelineState(m_CSO.get());
+	commandList.SetPipelineState(m_singlePass ? m_singlePassCSO.get() : m_CSO.get());
 	commandList.SetComputeBinder(&m_binder);
 	commandList.BindCompute(m_reductionBindParam, m_reductionTexSrv);
 	commandList.BindCompute(m_outputBindParam0, m_lightMvpUav);
 	commandList.BindCompute(m_outputBindParam1, m_shadowMxUav);
 	commandList.BindCompute(m_outputBindParam2, m_csmSplitsUav);
 	commandList.BindCompute(m_outputBindParam3, m_csmExtentsUav);
+	commandList.BindCompute(m_stateBindParam, m_stateView);
 	commandList.BindCompute(m_uniformsBindParam, cbv);
-	commandList.Dispatch(1, 1, 1);
+	if (m_singlePass) {
+		const Texture2D& depthTex = m_reductionTexSrv.GetResource();
+		unsigned numGroupsX = unsigned((depthTex.GetWidth() + SinglePassGroupWidth - 1) / SinglePassGroupWidth);
+		unsigned numGroupsY = (depthTex.GetHeight() + SinglePassGroupHeight - 1) / SinglePassGroupHeight;
+		commandList.Dispatch(numGroupsX, numGroupsY, 1);
+	}
+	else {
+		commandList.Dispatch(1, 1, 1);
+	}
 	commandList.UAVBarrier(m_lightMvpUav.GetResource());
 	commandList.UAVBarrier(m_shadowMxUav.GetResource());
 	commandList.UAVBarrier(m_csmSplitsUav.GetResource());
@@ -319,6 +361,17 @@ void DepthReductionFinal::InitRenderTarget(SetupContext& context) {
 		Texture2D csmExtentsTex = context.CreateTexture2D({ 3 * 4, 1, formatCSMExtents }, { true, true, false, true });
 		csmExtentsTex.SetName("Depth reduction final csm extents tex");
 		m_csmExtentsUav = context.CreateUav(csmExtentsTex, formatCSMExtents, uavDesc);
+
+		m_stateBuffer = context.CreateBuffer(3 * sizeof(uint32_t), true);
+		m_stateBuffer.SetName("Depth reduction state");
+
+		gxapi::UavBuffer stateDesc;
+		stateDesc.raw = false;
+		stateDesc.firstElement = 0;
+		stateDesc.numElements = 3;
+		stateDesc.elementStride = 0;
+		stateDesc.countOffset = 0;
+		m_stateView = context.CreateUav(m_stateBuffer, gxapi::eFormat::R32_UINT, stateDesc);
 	}
 }
 
@@ -10,9 +10,17 @@
 namespace inl::gxeng::nodes {
 
 
+/// <summary>
+/// Inputs: reduction texture or depth texture, camera, directional lights, single pass
+/// Outputs: light MVP matrices, shadow matrices, CSM splits, CSM extents
+/// </summary>
+/// <remarks>
+/// In single pass mode the input is the depth texture itself and <see cref="DepthReduction"/> is not needed,
+/// the last group of the dispatch to finish fits the cascades to the atomically merged depth range.
+/// </remarks>
 class DepthReductionFinal : virtual public GraphicsNode,
 							virtual public GraphicsTask,
-							virtual public InputPortConfig<Texture2D, const BasicCamera*, const EntityCollection<DirectionalLight>*>,
+							virtual public InputPortConfig<Texture2D, const BasicCamera*, const EntityCollection<DirectionalLight>*, bool>,
 							virtual public OutputPortConfig<Texture2D, Texture2D, Texture2D, Texture2D> {
 public:
 	static const char* Info_GetName() { return "DepthReductionFinal"; }
@@ -46,8 +54,11 @@ protected:
 	BindParameter m_outputBindParam2;
 	BindParameter m_outputBindParam3;
 	BindParameter m_uniformsBindParam;
+	BindParameter m_stateBindParam;
 	ShaderProgram m_shader;
 	std::unique_ptr<gxapi::IPipelineState> m_CSO;
+	ShaderProgram m_singlePassShader;
+	std::unique_ptr<gxapi::IPipelineState> m_singlePassCSO;
 
 protected: // outputs
 	bool m_outputTexturesInited = false;
@@ -55,11 +66,14 @@ protected: // outputs
 	RWTextureView2D m_shadowMxUav;
 	RWTextureView2D m_csmSplitsUav;
 	RWTextureView2D m_csmExtentsUav;
+	LinearBuffer m_stateBuffer;
+	RWBufferView m_stateView;
 
 protected: // render context
 	TextureView2D m_reductionTexSrv;
 	const BasicCamera* m_camera;
 	std::optional<const EntityCollection<DirectionalLight>*> m_suns;
+	bool m_singlePass = false;
 
 private:
 	void InitRenderTarget(SetupContext& context);
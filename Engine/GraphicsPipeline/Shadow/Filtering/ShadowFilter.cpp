@@ -22,8 +22,14 @@ struct Uniforms {
 };
 
 
+static constexpr unsigned ComputeTileSize = 16; // Must match ShadowPenumbraCompute.hlsl and ShadowBlurCompute.hlsl.
+static constexpr unsigned BlurGroupSize = 128; // Must match ShadowBlurCompute.hlsl.
+
+
 ShadowFilter::ShadowFilter() {
 	this->GetInput<0>().Set({});
+	this->GetInput<7>().Set(false);
+	this->GetInput<8>().Set(false);
 }
 
 
@@ -46,7 +52,9 @@ const std::string& ShadowFilter::GetInputName(size_t index) const {
 		"lightMvpTex",
 		"cubeShadowTex",
 		"depthTex",
-		"camera"
+		"camera",
+		"compute",
+		"halfResPenumbra"
 	};
 	return names[index];
 }
@@ -95,6 +103,8 @@ void ShadowFilter::Setup(SetupContext& context) {
 	m_depthTexSrv = context.CreateSrv(depthTex, FormatDepthToColor(depthTex.GetFormat()), srvDesc);
 
 	m_camera = this->GetInput<6>().Get();
+	m_compute = this->GetInput<7>().Get();
+	m_halfResPenumbra = this->GetInput<8>().Get();
 
 	if (!m_binder) {
 		BindParameterDesc uniformsBindParamDesc;
@@ -159,6 +169,38 @@ void ShadowFilter::Setup(SetupContext& context) {
 		shadowLayersBindParamDesc.relativeChangeFrequency = 0;
 		shadowLayersBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
 
+		BindParameterDesc shadowTilesBindParamDesc;
+		m_shadowTilesTexBindParam = BindParameter(eBindParameterType::TEXTURE, 5);
+		shadowTilesBindParamDesc.parameter = m_shadowTilesTexBindParam;
+		shadowTilesBindParamDesc.constantSize = 0;
+		shadowTilesBindParamDesc.relativeAccessFrequency = 0;
+		shadowTilesBindParamDesc.relativeChangeFrequency = 0;
+		shadowTilesBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc outputUavBindParamDesc;
+		m_outputUavBindParam = BindParameter(eBindParameterType::UNORDERED, 0);
+		outputUavBindParamDesc.parameter = m_outputUavBindParam;
+		outputUavBindParamDesc.constantSize = 0;
+		outputUavBindParamDesc.relativeAccessFrequency = 0;
+		outputUavBindParamDesc.relativeChangeFrequency = 0;
+		outputUavBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc penumbraUavBindParamDesc;
+		m_penumbraUavBindParam = BindParameter(eBindParameterType::UNORDERED, 1);
+		penumbraUavBindParamDesc.parameter = m_penumbraUavBindParam;
+		penumbraUavBindParamDesc.constantSize = 0;
+		penumbraUavBindParamDesc.relativeAccessFrequency = 0;
+		penumbraUavBindParamDesc.relativeChangeFrequency = 0;
+		penumbraUavBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
+		BindParameterDesc shadowTilesUavBindParamDesc;
+		m_shadowTilesUavBindParam = BindParameter(eBindParameterType::UNORDERED, 2);
+		shadowTilesUavBindParamDesc.parameter = m_shadowTilesUavBindParam;
+		shadowTilesUavBindParamDesc.constantSize = 0;
+		shadowTilesUavBindParamDesc.relativeAccessFrequency = 0;
+		shadowTilesUavBindParamDesc.relativeChangeFrequency = 0;
+		shadowTilesUavBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
+
 		BindParameterDesc cubeShadowBindParamDesc;
 		m_cubeShadowTexBindParam = BindParameter(eBindParameterType::TEXTURE, 400);
 		cubeShadowBindParamDesc.parameter = m_cubeShadowTexBindParam;
@@ -237,20 +279,18 @@ void ShadowFilter::Setup(SetupContext& context) {
 		csmSamplerDesc.registerSpace = 0;
 		csmSamplerDesc.shaderVisibility = gxapi::eShaderVisiblity::ALL;
 
-		m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc, shadowLayersBindParamDesc, penumbraLayersBindParamDesc, csmSampBindParamDesc, cubeMinfilterBindParamDesc, inputBindParamDesc, cubeShadowBindParamDesc, csmMinfilterBindParamDesc, csmBindParamDesc, shadowMxBindParamDesc, csmSplitsBindParamDesc, lightMvpBindParamDesc }, { samplerDesc, samplerLinearDesc, csmSamplerDesc });
+		m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc, shadowLayersBindParamDesc, penumbraLayersBindParamDesc, csmSampBindParamDesc, cubeMinfilterBindParamDesc, inputBindParamDesc, cubeShadowBindParamDesc, csmMinfilterBindParamDesc, csmBindParamDesc, shadowMxBindParamDesc, csmSplitsBindParamDesc, lightMvpBindParamDesc, shadowTilesBindParamDesc, outputUavBindParamDesc, penumbraUavBindParamDesc, shadowTilesUavBindParamDesc }, { samplerDesc, samplerLinearDesc, csmSamplerDesc });
 	}
 
 
 	if (!m_minfilterPSO) {
-		InitRenderTarget(context);
+		InitMinfilterTargets(context);
 
 		ShaderParts shaderParts;
 		shaderParts.vs = true;
 		shaderParts.ps = true;
 
 		m_minfilterShader = context.CreateShader("ShadowMinfilter", shaderParts, "");
-		m_penumbraShader = context.CreateShader("ShadowPenumbra", shaderParts, "");
-		m_blurShader = context.CreateShader("ShadowBlur", shaderParts, "");
 
 		std::vector<gxapi::InputElementDesc> inputElementDesc = {
 			gxapi::InputElementDesc("POSITION", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 0),
@@ -277,6 +317,54 @@ void ShadowFilter::Setup(SetupContext& context) {
 
 			m_minfilterPSO.reset(context.CreatePSO(psoDesc));
 		}
+	}
+
+	if (m_compute) {
+		InitComputeTargets(context);
+
+		if (!m_penumbraCSO) {
+			ShaderParts shaderParts;
+			shaderParts.cs = true;
+
+			m_penumbraComputeShader = context.CreateShader("ShadowPenumbraCompute", shaderParts, "");
+			m_shadowComputeShader = context.CreateShader("ShadowPenumbraCompute", shaderParts, "HALF_RES_PENUMBRA=1");
+			m_halfResPenumbraComputeShader = context.CreateShader("ShadowPenumbraCompute", shaderParts, "PENUMBRA_ONLY=1");
+			m_blurHorizontalComputeShader = context.CreateShader("ShadowBlurCompute", shaderParts, "");
+			m_blurVerticalComputeShader = context.CreateShader("ShadowBlurCompute", shaderParts, "VERTICAL=1");
+
+			gxapi::ComputePipelineStateDesc csoDesc;
+			csoDesc.rootSignature = m_binder.GetRootSignature();
+
+			csoDesc.cs = m_penumbraComputeShader.cs;
+			m_penumbraCSO.reset(context.CreatePSO(csoDesc));
+			csoDesc.cs = m_shadowComputeShader.cs;
+			m_shadowCSO.reset(context.CreatePSO(csoDesc));
+			csoDesc.cs = m_halfResPenumbraComputeShader.cs;
+			m_halfResPenumbraCSO.reset(context.CreatePSO(csoDesc));
+			csoDesc.cs = m_blurHorizontalComputeShader.cs;
+			m_blurHorizontalCSO.reset(context.CreatePSO(csoDesc));
+			csoDesc.cs = m_blurVerticalComputeShader.cs;
+			m_blurVerticalCSO.reset(context.CreatePSO(csoDesc));
+		}
+
+		this->GetOutput<0>().Set(m_computeBlurSecondPassUav.GetResource());
+		return;
+	}
+
+	if (!m_penumbraPSO) {
+		InitRenderTarget(context);
+
+		ShaderParts shaderParts;
+		shaderParts.vs = true;
+		shaderParts.ps = true;
+
+		m_penumbraShader = context.CreateShader("ShadowPenumbra", shaderParts, "");
+		m_blurShader = context.CreateShader("ShadowBlur", shaderParts, "");
+
+		std::vector<gxapi::InputElementDesc> inputElementDesc = {
+			gxapi::InputElementDesc("POSITION", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 0),
+			gxapi::InputElementDesc("TEX_COORD", 0, gxapi::eFormat::R32G32_FLOAT, 0, 12)
+		};
 
 		{ //penumbra pso
 			gxapi::GraphicsPipelineStateDesc psoDesc;
@@ -437,6 +525,72 @@ void ShadowFilter::Execute(RenderContext& context) {
 		}
 	}
 
+	if (m_compute) {
+		const Texture2D& outputTex = m_computeBlurSecondPassUav.GetResource();
+		const unsigned width = (unsigned)outputTex.GetWidth();
+		const unsigned height = outputTex.GetHeight();
+
+		commandList.SetResourceState(m_csmMinfilterSrv[0].GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+		commandList.SetResourceState(m_cubeMinfilterSrv[0].GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+		commandList.SetResourceState(m_computeShadowLayersUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+		commandList.SetResourceState(m_computePenumbraLayersUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+		commandList.SetResourceState(m_shadowTilesUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+
+		commandList.SetComputeBinder(&m_binder);
+		commandList.BindCompute(m_inputTexBindParam, m_depthTexSrv);
+		commandList.BindCompute(m_cubeShadowTexBindParam, m_cubeShadowTexSrv);
+		commandList.BindCompute(m_csmTexBindParam, m_csmTexSrv);
+		commandList.BindCompute(m_shadowMxTexBindParam, m_shadowMxTexSrv);
+		commandList.BindCompute(m_csmSplitsTexBindParam, m_csmSplitsTexSrv);
+		commandList.BindCompute(m_lightMvpTexBindParam, m_lightMvpTexSrv);
+		commandList.BindCompute(m_csmMinfilterTexBindParam, m_csmMinfilterSrv[0]);
+		commandList.BindCompute(m_cubeMinfilterTexBindParam, m_cubeMinfilterSrv[0]);
+		commandList.BindCompute(m_outputUavBindParam, m_computeShadowLayersUav);
+		commandList.BindCompute(m_penumbraUavBindParam, m_computePenumbraLayersUav);
+		commandList.BindCompute(m_shadowTilesUavBindParam, m_shadowTilesUav);
+		commandList.BindCompute(m_uniformsBindParam, &uniformsCBData, sizeof(Uniforms));
+
+		{ //layers and tiles, one group per tile
+			commandList.SetPipelineState(m_halfResPenumbra ? m_shadowCSO.get() : m_penumbraCSO.get());
+			commandList.Dispatch((width + ComputeTileSize - 1) / ComputeTileSize, (height + ComputeTileSize - 1) / ComputeTileSize, 1);
+
+			if (m_halfResPenumbra) {
+				const Texture2D& penumbraTex = m_computePenumbraLayersUav.GetResource();
+				commandList.SetPipelineState(m_halfResPenumbraCSO.get());
+				commandList.Dispatch(((unsigned)penumbraTex.GetWidth() + ComputeTileSize - 1) / ComputeTileSize, (penumbraTex.GetHeight() + ComputeTileSize - 1) / ComputeTileSize, 1);
+			}
+
+			commandList.UAVBarrier(m_computeShadowLayersUav.GetResource());
+			commandList.UAVBarrier(m_computePenumbraLayersUav.GetResource());
+			commandList.UAVBarrier(m_shadowTilesUav.GetResource());
+		}
+
+		{ //separable blur, each group filters a span of a row, then of a column
+			commandList.SetResourceState(m_computeShadowLayersUav.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+			commandList.SetResourceState(m_computePenumbraLayersUav.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+			commandList.SetResourceState(m_shadowTilesUav.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+			commandList.SetResourceState(m_computeBlurFirstPassUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+
+			commandList.SetPipelineState(m_blurHorizontalCSO.get());
+			commandList.BindCompute(m_shadowLayersTexBindParam, m_computeShadowLayersSrv);
+			commandList.BindCompute(m_penumbraLayersTexBindParam, m_computePenumbraLayersSrv);
+			commandList.BindCompute(m_shadowTilesTexBindParam, m_shadowTilesSrv);
+			commandList.BindCompute(m_outputUavBindParam, m_computeBlurFirstPassUav);
+			commandList.Dispatch((width + BlurGroupSize - 1) / BlurGroupSize, height, 1);
+			commandList.UAVBarrier(m_computeBlurFirstPassUav.GetResource());
+
+			commandList.SetResourceState(m_computeBlurFirstPassUav.GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
+			commandList.SetResourceState(m_computeBlurSecondPassUav.GetResource(), gxapi::eResourceState::UNORDERED_ACCESS);
+
+			commandList.SetPipelineState(m_blurVerticalCSO.get());
+			commandList.BindCompute(m_shadowLayersTexBindParam, m_computeBlurFirstPassSrv);
+			commandList.BindCompute(m_outputUavBindParam, m_computeBlurSecondPassUav);
+			commandList.Dispatch(width, (height + BlurGroupSize - 1) / BlurGroupSize, 1);
+			commandList.UAVBarrier(m_computeBlurSecondPassUav.GetResource());
+		}
+		return;
+	}
+
 	{ //layer generation pass
 		commandList.SetResourceState(m_penumbraLayersRtv.GetResource(), gxapi::eResourceState::RENDER_TARGET);
 		commandList.SetResourceState(m_shadowLayersRtv.GetResource(), gxapi::eResourceState::RENDER_TARGET);
@@ -535,15 +689,13 @@ void ShadowFilter::Execute(RenderContext& context) {
 }
 
 
-void ShadowFilter::InitRenderTarget(SetupContext& context) {
-	if (!m_outputTexturesInited) {
-		m_outputTexturesInited = true;
+void ShadowFilter::InitMinfilterTargets(SetupContext& context) {
+	if (!m_minfilterTexturesInited) {
+		m_minfilterTexturesInited = true;
 
 		using gxapi::eFormat;
 
 		auto formatBlur = eFormat::R16_FLOAT;
-		auto formatShadowLayers = eFormat::R8G8B8A8_UNORM;
-		auto formatPenumbraLayers = eFormat::R16G16B16A16_FLOAT;
 
 		gxapi::RtvTexture2DArray rtvDesc;
 		rtvDesc.activeArraySize = 1;
@@ -646,6 +798,39 @@ void ShadowFilter::InitRenderTarget(SetupContext& context) {
 			cubeSrvDesc.numCubes = 1;
 			m_cubeMinfilterSrv.push_back(context.CreateSrv(cubeMinfilterTex, cubeMinfilterTex.GetFormat(), cubeSrvDesc));
 		}
+	}
+}
+
+
+void ShadowFilter::InitRenderTarget(SetupContext& context) {
+	if (!m_outputTexturesInited) {
+		m_outputTexturesInited = true;
+
+		using gxapi::eFormat;
+
+		auto formatShadowLayers = eFormat::R8G8B8A8_UNORM;
+		auto formatPenumbraLayers = eFormat::R16G16B16A16_FLOAT;
+
+		gxapi::RtvTexture2DArray rtvDesc;
+		rtvDesc.activeArraySize = 1;
+		rtvDesc.firstArrayElement = 0;
+		rtvDesc.firstMipLevel = 0;
+		rtvDesc.planeIndex = 0;
+
+		gxapi::SrvTexture2DArray srvDesc;
+		srvDesc.activeArraySize = 1;
+		srvDesc.firstArrayElement = 0;
+		srvDesc.numMipLevels = -1;
+		srvDesc.mipLevelClamping = 0;
+		srvDesc.mostDetailedMip = 0;
+		srvDesc.planeIndex = 0;
+
+		Texture2DDesc desc{
+			0,
+			0,
+			formatShadowLayers,
+			1
+		};
 
 		//create penumbra rtvs
 		desc.arraySize = 1;
@@ -679,4 +864,66 @@ void ShadowFilter::InitRenderTarget(SetupContext& context) {
 }
 
 
+void ShadowFilter::InitComputeTargets(SetupContext& context) {
+	using gxapi::eFormat;
+
+	auto formatShadowLayers = eFormat::R8G8B8A8_UNORM;
+	auto formatPenumbraLayers = eFormat::R16G16B16A16_FLOAT;
+	auto formatTiles = eFormat::R8_UINT;
+
+	gxapi::UavTexture2DArray uavDesc;
+	uavDesc.activeArraySize = 1;
+	uavDesc.firstArrayElement = 0;
+	uavDesc.mipLevel = 0;
+	uavDesc.planeIndex = 0;
+
+	gxapi::SrvTexture2DArray srvDesc;
+	srvDesc.activeArraySize = 1;
+	srvDesc.firstArrayElement = 0;
+	srvDesc.numMipLevels = 1;
+	srvDesc.mipLevelClamping = 0;
+	srvDesc.mostDetailedMip = 0;
+	srvDesc.planeIndex = 0;
+
+	const uint64_t width = m_depthTexSrv.GetResource().GetWidth();
+	const uint32_t height = m_depthTexSrv.GetResource().GetHeight();
+
+	if (!m_computeTexturesInited) {
+		m_computeTexturesInited = true;
+
+		Texture2DDesc desc{ width, height, formatShadowLayers, 1 };
+		Texture2D shadowLayersTex = context.CreateTexture2D(desc, { true, false, false, true });
+		shadowLayersTex.SetName("Shadow layers compute tex");
+		m_computeShadowLayersUav = context.CreateUav(shadowLayersTex, formatShadowLayers, uavDesc);
+		m_computeShadowLayersSrv = context.CreateSrv(shadowLayersTex, formatShadowLayers, srvDesc);
+
+		Texture2D blurFirstPassTex = context.CreateTexture2D(desc, { true, false, false, true });
+		blurFirstPassTex.SetName("Blur layers compute first pass tex");
+		m_computeBlurFirstPassUav = context.CreateUav(blurFirstPassTex, formatShadowLayers, uavDesc);
+		m_computeBlurFirstPassSrv = context.CreateSrv(blurFirstPassTex, formatShadowLayers, srvDesc);
+
+		Texture2D blurSecondPassTex = context.CreateTexture2D(desc, { true, false, false, true });
+		blurSecondPassTex.SetName("Blur layers compute second pass tex");
+		m_computeBlurSecondPassUav = context.CreateUav(blurSecondPassTex, formatShadowLayers, uavDesc);
+
+		Texture2DDesc tilesDesc{ (width + ComputeTileSize - 1) / ComputeTileSize, (height + ComputeTileSize - 1) / ComputeTileSize, formatTiles, 1 };
+		Texture2D tilesTex = context.CreateTexture2D(tilesDesc, { true, false, false, true });
+		tilesTex.SetName("Shadow tiles tex");
+		m_shadowTilesUav = context.CreateUav(tilesTex, formatTiles, uavDesc);
+		m_shadowTilesSrv = context.CreateSrv(tilesTex, formatTiles, srvDesc);
+	}
+
+	// The penumbra follows the resolution switch.
+	const uint64_t penumbraWidth = m_halfResPenumbra ? (width + 1) / 2 : width;
+	const uint32_t penumbraHeight = m_halfResPenumbra ? (height + 1) / 2 : height;
+	if (!m_computePenumbraLayersUav || m_computePenumbraLayersUav.GetResource().GetWidth() != penumbraWidth) {
+		Texture2DDesc desc{ penumbraWidth, penumbraHeight, formatPenumbraLayers, 1 };
+		Texture2D penumbraLayersTex = context.CreateTexture2D(desc, { true, false, false, true });
+		penumbraLayersTex.SetName("Penumbra layers compute tex");
+		m_computePenumbraLayersUav = context.CreateUav(penumbraLayersTex, formatPenumbraLayers, uavDesc);
+		m_computePenumbraLayersSrv = context.CreateSrv(penumbraLayersTex, formatPenumbraLayers, srvDesc);
+	}
+}
+
+
 } // namespace inl::gxeng::nodes
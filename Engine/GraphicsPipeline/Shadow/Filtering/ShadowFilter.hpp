@@ -8,9 +8,17 @@
 namespace inl::gxeng::nodes {
 
 
+/// <summary>
+/// Soft shadows from the layered hard shadows and their penumbra estimated from minfiltered shadow maps.
+/// </summary>
+/// <remarks>
+/// With the compute input set, the penumbra and blur passes run as compute shaders: the blur is separable through
+/// groupshared memory, and tiles lit or shadowed in whole, along with their neighbours, skip it.
+/// The halfResPenumbra input estimates the penumbra at half resolution, upsampled along the depth.
+/// </remarks>
 class ShadowFilter : virtual public GraphicsNode,
 					 virtual public GraphicsTask,
-					 virtual public InputPortConfig<Texture2D, Texture2D, Texture2D, Texture2D, Texture2D, Texture2D, const BasicCamera*>,
+					 virtual public InputPortConfig<Texture2D, Texture2D, Texture2D, Texture2D, Texture2D, Texture2D, const BasicCamera*, bool, bool>,
 					 virtual public OutputPortConfig<Texture2D> {
 public:
 	static const char* Info_GetName() { return "ShadowFilter"; }
@@ -38,6 +46,10 @@ protected:
 	BindParameter m_cubeMinfilterTexBindParam;
 	BindParameter m_shadowLayersTexBindParam;
 	BindParameter m_penumbraLayersTexBindParam;
+	BindParameter m_shadowTilesTexBindParam;
+	BindParameter m_outputUavBindParam;
+	BindParameter m_penumbraUavBindParam;
+	BindParameter m_shadowTilesUavBindParam;
 	BindParameter m_uniformsBindParam;
 	ShaderProgram m_minfilterShader;
 	ShaderProgram m_penumbraShader;
@@ -45,8 +57,19 @@ protected:
 	std::unique_ptr<gxapi::IPipelineState> m_minfilterPSO;
 	std::unique_ptr<gxapi::IPipelineState> m_penumbraPSO;
 	std::unique_ptr<gxapi::IPipelineState> m_blurPSO;
+	ShaderProgram m_penumbraComputeShader;
+	ShaderProgram m_shadowComputeShader;
+	ShaderProgram m_halfResPenumbraComputeShader;
+	ShaderProgram m_blurHorizontalComputeShader;
+	ShaderProgram m_blurVerticalComputeShader;
+	std::unique_ptr<gxapi::IPipelineState> m_penumbraCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_shadowCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_halfResPenumbraCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_blurHorizontalCSO;
+	std::unique_ptr<gxapi::IPipelineState> m_blurVerticalCSO;
 
 protected: // outputs
+	bool m_minfilterTexturesInited = false;
 	bool m_outputTexturesInited = false;
 	std::vector<TextureView2D> m_inputTexSrv;
 	std::vector<RenderTargetView2D> m_filterHorizontalRtv;
@@ -60,6 +83,17 @@ protected: // outputs
 	RenderTargetView2D m_blurLayersFirstPassRtv;
 	RenderTargetView2D m_blurLayersSecondPassRtv;
 
+	bool m_computeTexturesInited = false;
+	RWTextureView2D m_computeShadowLayersUav;
+	TextureView2D m_computeShadowLayersSrv;
+	RWTextureView2D m_computePenumbraLayersUav;
+	TextureView2D m_computePenumbraLayersSrv;
+	RWTextureView2D m_shadowTilesUav;
+	TextureView2D m_shadowTilesSrv;
+	RWTextureView2D m_computeBlurFirstPassUav;
+	TextureView2D m_computeBlurFirstPassSrv;
+	RWTextureView2D m_computeBlurSecondPassUav;
+
 protected: // render context
 	TextureView2D m_csmTexSrv;
 	TextureView2D m_shadowMxTexSrv;
@@ -72,9 +106,13 @@ protected: // render context
 	TextureView2D m_blurLayersFirstPassSrv;
 
 	const BasicCamera* m_camera;
+	bool m_compute = false;
+	bool m_halfResPenumbra = false;
 
 private:
+	void InitMinfilterTargets(SetupContext& context);
 	void InitRenderTarget(SetupContext& context);
+	void InitComputeTargets(SetupContext& context);
 };
 
 
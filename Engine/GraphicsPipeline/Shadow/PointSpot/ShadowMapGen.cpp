@@ -3,10 +3,15 @@
 #include <GraphicsEngine_LL/Nodes/NodeUtility.hpp>
 
 #include <GraphicsEngine_LL/AutoRegisterNode.hpp>
+#include <GraphicsEngine_LL/BoundingVolumes.hpp>
 #include <GraphicsEngine_LL/GraphicsCommandList.hpp>
+#include <GraphicsEngine_LL/LodSelector.hpp>
 #include <GraphicsEngine_LL/Mesh.hpp>
 #include <GraphicsEngine_LL/MeshEntity.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 
 namespace inl::gxeng::nodes {
 
@@ -15,7 +20,8 @@ INL_REGISTER_GRAPHICS_NODE(ShadowMapGen)
 
 
 struct Uniforms {
-	Mat44_Packed mvp;
+	Mat44_Packed viewProjection;
+	uint32_t instanceOffset;
 };
 
 static bool CheckMeshFormat(const Mesh& mesh) {
@@ -23,11 +29,11 @@ static bool CheckMeshFormat(const Mesh& mesh) {
 		auto& elements = mesh.GetLayout()[0];
 		if (elements.size() != 3)
 			return false;
-		if (elements[0].semantic != eVertexElementSemantic::POSITION)
+		if (elements[0].semantic != eVertexElementSemantic::POSITION || elements[0].format != gxapi::eFormat::R16G16B16A16_UNORM)
 			return false;
-		if (elements[1].semantic != eVertexElementSemantic::NORMAL)
+		if (elements[1].semantic != eVertexElementSemantic::NORMAL || elements[1].format != gxapi::eFormat::R16G16_SNORM)
 			return false;
-		if (elements[2].semantic != eVertexElementSemantic::TEX_COORD)
+		if (elements[2].semantic != eVertexElementSemantic::TEX_COORD || elements[2].format != gxapi::eFormat::R16G16_FLOAT)
 			return false;
 	}
 
@@ -35,8 +41,9 @@ static bool CheckMeshFormat(const Mesh& mesh) {
 }
 
 
+// Stream 0 is replaced by the batch's vertices if it has any, e.g. skinned ones.
 static void ConvertToSubmittable(
-	Mesh* mesh,
+	const InstanceBatcher::Batch& batch,
 	std::vector<const gxeng::VertexBuffer*>& vertexBuffers,
 	std::vector<unsigned>& sizes,
 	std::vector<unsigned>& strides) {
@@ -44,8 +51,9 @@ static void ConvertToSubmittable(
 	sizes.clear();
 	strides.clear();
 
+	const Mesh* mesh = batch.mesh;
 	for (int streamID = 0; streamID < mesh->GetNumStreams(); streamID++) {
-		vertexBuffers.push_back(&mesh->GetVertexBuffer(streamID));
+		vertexBuffers.push_back(streamID == 0 && batch.vertices ? batch.vertices : &mesh->GetVertexBuffer(streamID));
 		sizes.push_back((unsigned)vertexBuffers.back()->GetSize());
 		strides.push_back((unsigned)mesh->GetVertexBufferStride(streamID));
 	}
@@ -55,8 +63,49 @@ static void ConvertToSubmittable(
 }
 
 
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+	}
+	return hash;
+}
 
-ShadowMapGen::ShadowMapGen() {}
+
+// Changes whenever the object moves, switches mesh or level of detail, or is skinned into a new pose.
+static uint64_t HashCaster(uint64_t hash, const MeshEntity& entity, const Mat44& world, uint32_t lod) {
+	const MeshEntity* entityPtr = &entity;
+	const Mesh* mesh = entity.GetMesh();
+	const Mat44_Packed worldPacked = world;
+	const uint64_t poseVersion = entity.HasSkinnedVertices() ? entity.GetPoseVersion() : 0;
+	hash = HashBytes(hash, &entityPtr, sizeof(entityPtr));
+	hash = HashBytes(hash, &mesh, sizeof(mesh));
+	hash = HashBytes(hash, &lod, sizeof(lod));
+	hash = HashBytes(hash, &poseVersion, sizeof(poseVersion));
+	return HashBytes(hash, &worldPacked, sizeof(worldPacked));
+}
+
+
+// Part of the screen's height the light's range covers.
+static float GetScreenCoverage(const BasicCamera* camera, const Vec3& position, float range) {
+	if (!camera) {
+		return 1.0f;
+	}
+	float distance = (position - camera->GetPosition()).Length();
+	if (distance <= range) {
+		return 1.0f;
+	}
+	float tanHalfFovY = 1.0f / camera->GetProjectionMatrix()(1, 1);
+	return std::min(1.0f, range / (distance * tanHalfFovY));
+}
+
+
+
+ShadowMapGen::ShadowMapGen() {
+	this->GetInput<2>().Set({});
+	this->GetInput<3>().Set({});
+	this->GetInput<4>().Set({});
+}
 
 
 void ShadowMapGen::Initialize(EngineContext& context) {
@@ -64,22 +113,30 @@ void ShadowMapGen::Initialize(EngineContext& context) {
 }
 
 void ShadowMapGen::Reset() {
-	m_pointLightDsvs.clear();
+	m_faceDraws.clear();
+	m_batcher.Clear();
 	GetInput(0)->Clear();
 	GetInput(1)->Clear();
+	GetInput(2)->Clear();
+	GetInput(3)->Clear();
+	GetInput(4)->Clear();
 }
 
 const std::string& ShadowMapGen::GetInputName(size_t index) const {
 	static const std::vector<std::string> names = {
 		"cubemapDSVs",
-		"entities"
+		"entities",
+		"pointLights",
+		"spotLights",
+		"camera"
 	};
 	return names[index];
 }
 
 const std::string& ShadowMapGen::GetOutputName(size_t index) const {
 	static const std::vector<std::string> names = {
-		"cubeShadowMaps"
+		"cubeShadowMaps",
+		"shadowAtlas"
 	};
 	return names[index];
 }
@@ -87,20 +144,18 @@ const std::string& ShadowMapGen::GetOutputName(size_t index) const {
 void ShadowMapGen::Setup(SetupContext& context) {
 	Texture2D& pointLightCubemaps = this->GetInput<0>().Get();
 	const gxapi::eFormat pointLightDepthStencilFormat = FormatAnyToDepthStencil(pointLightCubemaps.GetFormat());
-	gxapi::DsvTexture2DArray dsvDesc;
-	dsvDesc.activeArraySize = 1;
-	dsvDesc.firstMipLevel = 0;
-	m_pointLightDsvs.resize(pointLightCubemaps.GetArrayCount());
-	for (int i = 0; i < m_pointLightDsvs.size(); i++) {
-		dsvDesc.firstArrayElement = i;
-		m_pointLightDsvs[i] = context.CreateDsv(pointLightCubemaps, pointLightDepthStencilFormat, dsvDesc);
-		m_pointLightDsvs[i].GetResource().SetName((std::string("Point Light shadow map depth tex view #") + std::to_string(i)).c_str());
-	}
 
 	m_entities = this->GetInput<1>().Get();
 	this->GetInput<1>().Clear();
+	m_pointLights = this->GetInput<2>().Get();
+	m_spotLights = this->GetInput<3>().Get();
+	m_camera = this->GetInput<4>().Get();
+
+	AllocateSlots(pointLightCubemaps);
+	BuildBatches(context, pointLightCubemaps, pointLightDepthStencilFormat);
 
 	this->GetOutput<0>().Set(pointLightCubemaps);
+	this->GetOutput<1>().Set(&m_atlas);
 
 	if (!m_binder) {
 		this->GetInput<0>().Set({});
@@ -113,6 +168,14 @@ void ShadowMapGen::Setup(SetupContext& context) {
 		uniformsBindParamDesc.relativeChangeFrequency = 0;
 		uniformsBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::VERTEX;
 
+		BindParameterDesc instanceBindParamDesc;
+		m_instanceBindParam = BindParameter(eBindParameterType::TEXTURE, 0);
+		instanceBindParamDesc.parameter = m_instanceBindParam;
+		instanceBindParamDesc.constantSize = 0;
+		instanceBindParamDesc.relativeAccessFrequency = 0;
+		instanceBindParamDesc.relativeChangeFrequency = 0;
+		instanceBindParamDesc.shaderVisibility = gxapi::eShaderVisiblity::VERTEX;
+
 		BindParameterDesc sampBindParamDesc;
 		sampBindParamDesc.parameter = BindParameter(eBindParameterType::SAMPLER, 0);
 		sampBindParamDesc.constantSize = 0;
@@ -130,7 +193,7 @@ void ShadowMapGen::Setup(SetupContext& context) {
 		samplerDesc.registerSpace = 0;
 		samplerDesc.shaderVisibility = gxapi::eShaderVisiblity::PIXEL;
 
-		m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc }, { samplerDesc });
+		m_binder = context.CreateBinder({ uniformsBindParamDesc, instanceBindParamDesc, sampBindParamDesc }, { samplerDesc });
 	}
 
 	if (!m_shadowGenPSO || pointLightDepthStencilFormat != m_depthStencilFormat) {
@@ -145,9 +208,9 @@ void ShadowMapGen::Setup(SetupContext& context) {
 		shaderParts.ps = true;
 
 		std::vector<gxapi::InputElementDesc> inputElementDesc = {
-			gxapi::InputElementDesc("POSITION", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 0),
-			gxapi::InputElementDesc("NORMAL", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 12),
-			gxapi::InputElementDesc("TEX_COORD", 0, gxapi::eFormat::R32G32_FLOAT, 0, 24),
+			gxapi::InputElementDesc("POSITION", 0, gxapi::eFormat::R16G16B16A16_UNORM, 0, 0),
+			gxapi::InputElementDesc("NORMAL", 0, gxapi::eFormat::R16G16_SNORM, 0, 8),
+			gxapi::InputElementDesc("TEX_COORD", 0, gxapi::eFormat::R16G16_FLOAT, 0, 12),
 		};
 
 		{
@@ -173,124 +236,209 @@ void ShadowMapGen::Setup(SetupContext& context) {
 }
 
 
-void ShadowMapGen::Execute(RenderContext& context) {
-	GraphicsCommandList& commandList = context.AsGraphics();
+void ShadowMapGen::AllocateSlots(const Texture2D& cubemaps) {
+	unsigned numSlots = cubemaps.GetArrayCount() / ShadowAtlas::NumFaces;
+	unsigned numMips = 1;
+	while (numMips < cubemaps.GetNumMiplevels() && (cubemaps.GetWidth() >> numMips) >= MinFaceSize) {
+		++numMips;
+	}
+	if (numSlots != m_atlas.GetSlots().size() || numMips != m_atlas.GetNumMips()) {
+		m_atlas.Resize(numSlots, numMips);
+		m_atlas.SetUpdateBudget(FaceUpdateBudget);
+	}
 
-	Mat44 pointLightViewMatrices[6];
-
-	//right
-	pointLightViewMatrices[0] = Mat44(0, 0, 1, 0,
-									  0, 1, 0, 0,
-									  -1, 0, 0, 0,
-									  0, 0, 0, 1);
-	//left
-	pointLightViewMatrices[1] = Mat44(0, 0, -1, 0,
-									  0, 1, 0, 0,
-									  -1, 0, 0, 0,
-									  0, 0, 0, 1);
-	//forward
-	pointLightViewMatrices[2] = Mat44(1, 0, 0, 0,
-									  0, 0, 1, 0,
-									  0, -1, 0, 0,
-									  0, 0, 0, 1);
-	//backward
-	pointLightViewMatrices[3] = Mat44(-1, 0, 0, 0,
-									  0, 0, -1, 0,
-									  0, -1, 0, 0,
-									  0, 0, 0, 1);
-	//up
-	pointLightViewMatrices[4] = Mat44(1, 0, 0, 0,
-									  0, 1, 0, 0,
-									  0, 0, 1, 0,
-									  0, 0, 0, 1);
-	//down
-	pointLightViewMatrices[5] = Mat44(-1, 0, 0, 0,
-									  0, 1, 0, 0,
-									  0, 0, -1, 0,
-									  0, 0, 0, 1);
-
-	Mat44 pointLightProjMatrix = Mat44::Perspective(90.0f / 180.f * 3.14159f, 1.0f, 0.1f, 100.0f);
-
-
-	//TODO wtf??????????
-	Mat44 pointLightModelMatrix = Mat44(1, 0, 0, 0,
-										0, 1, 0, 0,
-										0, 0, 1, 0,
-										0, 0, -1, 1);
-
-	Mat44 pointLightMVPs[6];
-	for (int c = 0; c < 6; ++c) {
-		pointLightMVPs[c] = pointLightModelMatrix * pointLightViewMatrices[c] * pointLightProjMatrix;
+	std::vector<ShadowAtlas::Request> requests;
+	if (!m_pointLights && !m_spotLights) {
+		ShadowAtlas::Request request;
+		request.light = this;
+		request.position = { 0, 0, 1 };
+		request.range = 100.0f;
+		request.importance = 1.0f;
+		requests.push_back(request);
 	}
 
+	auto makeRequest = [this](const PointLight& light) {
+		Vec3 color = light.GetColor();
+		ShadowAtlas::Request request;
+		request.light = &light;
+		request.position = light.GetPosition();
+		request.range = light.GetRange();
+		request.screenCoverage = GetScreenCoverage(m_camera, request.position, request.range);
+		request.importance = request.screenCoverage * std::max({ color.x, color.y, color.z });
+		return request;
+	};
+	if (m_pointLights) {
+		for (const PointLight* light : *m_pointLights) {
+			requests.push_back(makeRequest(*light));
+		}
+	}
+	if (m_spotLights) {
+		for (const SpotLight* light : *m_spotLights) {
+			ShadowAtlas::Request request = makeRequest(*light);
+			request.faceMask = ShadowAtlas::GetSpotFaceMask(light->GetDirection(), light->GetOuterAngle());
+			requests.push_back(request);
+		}
+	}
 
-	{ //render point light shadow maps
-		assert(m_pointLightDsvs.size() > 0);
+	m_atlas.Allocate(requests);
+}
 
-		Texture2D pointLightShadowMaps = m_pointLightDsvs[0].GetResource();
-		const uint16_t numShadowMaps = (uint16_t)m_pointLightDsvs.size();
-		const uint64_t shadowMapWidth = pointLightShadowMaps.GetWidth();
-		const uint64_t shadowMapHeight = pointLightShadowMaps.GetHeight();
 
-		gxapi::Rectangle rect{ 0, (int)pointLightShadowMaps.GetHeight(), 0, (int)pointLightShadowMaps.GetWidth() };
-		commandList.SetScissorRects(1, &rect);
+void ShadowMapGen::BuildBatches(SetupContext& context, const Texture2D& cubemaps, gxapi::eFormat depthStencilFormat) {
+	constexpr unsigned NumFaces = ShadowAtlas::NumFaces;
+	const std::vector<ShadowAtlas::Slot>& slots = m_atlas.GetSlots();
 
-		commandList.SetPipelineState(m_shadowGenPSO.get());
-		commandList.SetGraphicsBinder(&m_binder);
-		commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
-
-		std::vector<const gxeng::VertexBuffer*> vertexBuffers;
-		std::vector<unsigned> sizes;
-		std::vector<unsigned> strides;
-
-		commandList.SetResourceState(pointLightShadowMaps, gxapi::eResourceState::DEPTH_WRITE, gxapi::ALL_SUBRESOURCES);
-		for (int shadowMapIdx = 0; shadowMapIdx < numShadowMaps; ++shadowMapIdx) {
-			commandList.SetRenderTargets(0, nullptr, &m_pointLightDsvs[shadowMapIdx]);
-			commandList.ClearDepthStencil(m_pointLightDsvs[shadowMapIdx], 1, 0, 0, nullptr, true, true);
-
-			gxapi::Viewport viewport;
-			viewport.height = (float)shadowMapWidth;
-			viewport.width = (float)shadowMapHeight;
-			viewport.minDepth = 0.0f;
-			viewport.maxDepth = 1.0f;
-			viewport.topLeftY = 0;
-			viewport.topLeftX = 0;
-			commandList.SetViewports(1, &viewport);
-
-			// Iterate over all entities
-			for (const MeshEntity* entity : *m_entities) {
-				// Get entity parameters
-				Mesh* mesh = entity->GetMesh();
-				auto position = entity->GetPosition();
-
-				if (mesh->GetIndexBuffer().GetIndexCount() == 3600) {
-					continue; //skip quadcopter for visualization purposes (obscures camera...)
+	m_batcher.Clear();
+	m_faceDraws.clear();
+	m_faceCasters.resize(slots.size() * NumFaces);
+	for (auto& casters : m_faceCasters) {
+		casters.clear();
+	}
+	std::vector<uint64_t> casterHashes(slots.size() * NumFaces, 14695981039346656037ull);
+
+	if (m_entities) {
+		// Group entities by mesh, materials do not matter for depth only rendering.
+		m_renderQueue.Clear();
+		m_renderQueue.Reserve(m_entities->Size());
+		for (size_t i = 0; i < m_entities->Size(); ++i) {
+			const MeshEntity* entity = (*m_entities)[i];
+			uint64_t meshId = RenderQueue::PointerId(entity->GetMesh()) + entity->GetLod();
+			m_renderQueue.Add(RenderQueue::MakeKey(0, 0, meshId, 0.0f), uint32_t(i));
+		}
+		m_renderQueue.Sort(context.GetJobScheduler());
+
+		std::vector<Frustum> frustums(slots.size() * NumFaces);
+		for (size_t slotIdx = 0; slotIdx < slots.size(); ++slotIdx) {
+			for (unsigned face = 0; face < NumFaces; ++face) {
+				if (slots[slotIdx].light && (slots[slotIdx].faceMask & (1u << face))) {
+					frustums[slotIdx * NumFaces + face] = Frustum(ShadowAtlas::GetFaceViewProjection(slots[slotIdx].position, slots[slotIdx].range, face));
 				}
+			}
+		}
+
+		// Sort the objects into the faces they are seen from, the hashes tell the atlas which cached faces are stale.
+		for (const RenderQueue::Item& item : m_renderQueue) {
+			const MeshEntity* entity = (*m_entities)[item.index];
+			Mesh* mesh = entity->GetMesh();
+
+			if (mesh->GetLod(0).indexCount == 3600) {
+				continue; //skip quadcopter for visualization purposes (obscures camera...)
+			}
+			if (!CheckMeshFormat(*mesh)) {
+				assert(false);
+				continue;
+			}
 
-				// Draw mesh
-				if (!CheckMeshFormat(*mesh)) {
-					assert(false);
+			const Mat44 world = entity->GetTransform();
+			const BoundingBox bounds = entity->GetLocalBounds().Transformed(world);
+			for (size_t slotIdx = 0; slotIdx < slots.size(); ++slotIdx) {
+				const ShadowAtlas::Slot& slot = slots[slotIdx];
+				if (!slot.light || BoundingSphere(slot.position, slot.range).Classify(bounds) == eContainment::OUTSIDE) {
 					continue;
 				}
+				for (unsigned face = 0; face < NumFaces; ++face) {
+					const size_t faceIdx = slotIdx * NumFaces + face;
+					if (!(slot.faceMask & (1u << face)) || frustums[faceIdx].Classify(bounds) == eContainment::OUTSIDE) {
+						continue;
+					}
+					m_faceCasters[faceIdx].push_back(entity);
+					casterHashes[faceIdx] = HashCaster(casterHashes[faceIdx], *entity, world, entity->GetLod());
+				}
+			}
+		}
+	}
 
-				ConvertToSubmittable(mesh, vertexBuffers, sizes, strides);
+	gxapi::DsvTexture2DArray dsvDesc;
+	dsvDesc.activeArraySize = 1;
 
-				Mat44 model = entity->GetTransform();
+	for (const ShadowAtlas::FaceUpdate& update : m_atlas.ScheduleUpdates(casterHashes)) {
+		FaceDraw draw;
+		dsvDesc.firstArrayElement = update.slot * NumFaces + update.face;
+		dsvDesc.firstMipLevel = update.mip;
+		draw.dsv = context.CreateDsv(cubemaps, depthStencilFormat, dsvDesc);
+		draw.viewProjection = ShadowAtlas::GetFaceViewProjection(update.position, update.range, update.face);
+		draw.mip = update.mip;
+		draw.firstBatch = m_batcher.GetBatches().size();
+
+		for (const MeshEntity* entity : m_faceCasters[update.slot * NumFaces + update.face]) {
+			Mesh* mesh = entity->GetMesh();
+			// Shadows are less detailed than the camera's view.
+			uint32_t lod = std::min(entity->GetLod() + LodSelector::ShadowLodBias, uint32_t(mesh->GetLodCount()) - 1);
+			const VertexBuffer* skinnedVertices = entity->HasSkinnedVertices() ? &entity->GetSkinnedVertices() : nullptr;
+			m_batcher.Add(mesh, nullptr, entity->GetPositionDequantization() * entity->GetTransform(), lod, skinnedVertices);
+		}
+		m_batcher.Split();
 
-				Uniforms uniformsCBData;
-				uniformsCBData.mvp = model * pointLightMVPs[shadowMapIdx % 6];
+		draw.numBatches = m_batcher.GetBatches().size() - draw.firstBatch;
+		m_faceDraws.push_back(draw);
+	}
+	m_instanceBuffer.Reserve(context, m_batcher.GetInstanceCount());
+}
 
-				commandList.BindGraphics(m_uniformsBindParam, &uniformsCBData, sizeof(uniformsCBData));
 
-				for (auto& vb : vertexBuffers) {
-					commandList.SetResourceState(*vb, gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
-				}
-				commandList.SetResourceState(mesh->GetIndexBuffer(), gxapi::eResourceState::INDEX_BUFFER);
+void ShadowMapGen::Execute(RenderContext& context) {
+	GraphicsCommandList& commandList = context.AsGraphics();
 
-				commandList.SetVertexBuffers(0, (unsigned)vertexBuffers.size(), vertexBuffers.data(), sizes.data(), strides.data());
-				commandList.SetIndexBuffer(&mesh->GetIndexBuffer(), mesh->IsIndexBuffer32Bit());
-				commandList.DrawIndexedInstanced((unsigned)mesh->GetIndexBuffer().GetIndexCount());
+	m_instanceBuffer.Upload(context, commandList, m_batcher.GetTransforms());
+
+	if (m_faceDraws.empty()) {
+		return;
+	}
+
+	//render the faces scheduled this frame, the others keep what they had
+	Texture2D pointLightShadowMaps = m_faceDraws[0].dsv.GetResource();
+
+	commandList.SetPipelineState(m_shadowGenPSO.get());
+	commandList.SetGraphicsBinder(&m_binder);
+	commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
+	if (m_batcher.GetInstanceCount() > 0) {
+		commandList.BindGraphics(m_instanceBindParam, m_instanceBuffer.GetView());
+	}
+
+	std::vector<const gxeng::VertexBuffer*> vertexBuffers;
+	std::vector<unsigned> sizes;
+	std::vector<unsigned> strides;
+
+	commandList.SetResourceState(pointLightShadowMaps, gxapi::eResourceState::DEPTH_WRITE, gxapi::ALL_SUBRESOURCES);
+	for (const FaceDraw& draw : m_faceDraws) {
+		commandList.SetRenderTargets(0, nullptr, &draw.dsv);
+		commandList.ClearDepthStencil(draw.dsv, 1, 0, 0, nullptr, true, true);
+
+		const uint64_t faceSize = std::max(uint64_t(1), pointLightShadowMaps.GetWidth() >> draw.mip);
+		gxapi::Rectangle rect{ 0, (int)faceSize, 0, (int)faceSize };
+		commandList.SetScissorRects(1, &rect);
+
+		gxapi::Viewport viewport;
+		viewport.height = (float)faceSize;
+		viewport.width = (float)faceSize;
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+		viewport.topLeftY = 0;
+		viewport.topLeftX = 0;
+		commandList.SetViewports(1, &viewport);
+
+		// One instanced draw per mesh
+		for (size_t batchIdx = draw.firstBatch; batchIdx < draw.firstBatch + draw.numBatches; ++batchIdx) {
+			const InstanceBatcher::Batch& batch = m_batcher.GetBatches()[batchIdx];
+			Mesh* mesh = batch.mesh;
+
+			ConvertToSubmittable(batch, vertexBuffers, sizes, strides);
+
+			Uniforms uniformsCBData;
+			uniformsCBData.viewProjection = draw.viewProjection;
+			uniformsCBData.instanceOffset = batch.firstInstance;
+
+			commandList.BindGraphics(m_uniformsBindParam, &uniformsCBData, sizeof(uniformsCBData));
+
+			for (auto& vb : vertexBuffers) {
+				commandList.SetResourceState(*vb, gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
 			}
+			commandList.SetResourceState(mesh->GetIndexBuffer(), gxapi::eResourceState::INDEX_BUFFER);
+
+			commandList.SetVertexBuffers(0, (unsigned)vertexBuffers.size(), vertexBuffers.data(), sizes.data(), strides.data());
+			commandList.SetIndexBuffer(&mesh->GetIndexBuffer(), mesh->IsIndexBuffer32Bit());
+			const Mesh::Lod& lod = mesh->GetLod(batch.lod);
+			commandList.DrawIndexedInstanced(lod.indexCount, lod.firstIndex, 0, batch.instanceCount);
 		}
 	}
 }
@@ -1,20 +1,36 @@
 #pragma once
 
 #include <GraphicsApi_LL/IPipelineState.hpp>
+#include <GraphicsEngine_LL/BasicCamera.hpp>
 #include <GraphicsEngine_LL/GraphicsNode.hpp>
+#include <GraphicsEngine_LL/InstanceBatcher.hpp>
+#include <GraphicsEngine_LL/InstanceBuffer.hpp>
+#include <GraphicsEngine_LL/PointLight.hpp>
+#include <GraphicsEngine_LL/RenderQueue.hpp>
+#include <GraphicsEngine_LL/ShadowAtlas.hpp>
+#include <GraphicsEngine_LL/SpotLight.hpp>
 
 #include <optional>
 
 namespace inl::gxeng::nodes {
 
 /// <summary>
-/// Inputs: render target, scene objects, light cascade MVP transform matrices in a texture
-/// Output: render target
+/// Inputs: cube array with a mip chain, scene objects, point lights, spot lights, camera
+/// Outputs: the cube array, the shadow atlas telling which cube and mip each light uses
 /// </summary>
+/// <remarks>
+/// Each cube is a slot of a <see cref="ShadowAtlas"/>. Faces are cached across frames and only rendered again
+/// when their light moved or the objects they see changed, a limited number of faces per frame.
+/// Without lights linked, a single light at (0, 0, 1) with a range of 100 gets the first cube.
+/// </remarks>
 class ShadowMapGen : virtual public GraphicsNode,
 					 virtual public GraphicsTask,
-					 virtual public InputPortConfig<Texture2D, const EntityCollection<MeshEntity>*>,
-					 virtual public OutputPortConfig<Texture2D> {
+					 virtual public InputPortConfig<Texture2D,
+													const EntityCollection<MeshEntity>*,
+													const EntityCollection<PointLight>*,
+													const EntityCollection<SpotLight>*,
+													const BasicCamera*>,
+					 virtual public OutputPortConfig<Texture2D, const ShadowAtlas*> {
 public:
 	static const char* Info_GetName() { return "ShadowMapGen"; }
 	const std::string& GetInputName(size_t index) const override;
@@ -29,16 +45,42 @@ public:
 	void Setup(SetupContext& context) override;
 	void Execute(RenderContext& context) override;
 
+	/// <summary> Faces rendered in a frame at most. </summary>
+	static constexpr unsigned FaceUpdateBudget = 12;
+	/// <summary> Mips smaller than this are not used for distant lights. </summary>
+	static constexpr unsigned MinFaceSize = 64;
+
+private:
+	void AllocateSlots(const Texture2D& cubemaps);
+	void BuildBatches(SetupContext& context, const Texture2D& cubemaps, gxapi::eFormat depthStencilFormat);
+
 protected:
 	Binder m_binder;
 	BindParameter m_uniformsBindParam;
+	BindParameter m_instanceBindParam;
 	ShaderProgram m_shadowGenShader;
 	std::unique_ptr<gxapi::IPipelineState> m_shadowGenPSO;
 	gxapi::eFormat m_depthStencilFormat;
 
 private: // render context
-	std::vector<DepthStencilView2D> m_pointLightDsvs;
-	const EntityCollection<MeshEntity>* m_entities;
+	struct FaceDraw {
+		DepthStencilView2D dsv;
+		Mat44 viewProjection;
+		unsigned mip;
+		size_t firstBatch;
+		size_t numBatches;
+	};
+
+	const EntityCollection<MeshEntity>* m_entities = nullptr;
+	const EntityCollection<PointLight>* m_pointLights = nullptr;
+	const EntityCollection<SpotLight>* m_spotLights = nullptr;
+	const BasicCamera* m_camera = nullptr;
+	ShadowAtlas m_atlas;
+	std::vector<FaceDraw> m_faceDraws;
+	std::vector<std::vector<const MeshEntity*>> m_faceCasters; // Objects each face of each slot sees, in render queue order.
+	RenderQueue m_renderQueue;
+	InstanceBatcher m_batcher;
+	InstanceBuffer m_instanceBuffer;
 };
 
 
@@ -7,7 +7,7 @@ namespace inl::gui {
 
 
 AbsoluteLayout::Binding& AbsoluteLayout::AddChild(std::shared_ptr<Control> child) {
-	auto insIt = m_children.insert({ child, std::make_unique<Binding>() });
+	auto insIt = m_children.insert({ child, std::make_unique<Binding>(this) });
 	if (insIt.second) {
 		Attach(this, child.get());
 		return *insIt.first->second;
@@ -42,6 +42,10 @@ AbsoluteLayout::Binding& AbsoluteLayout::operator[](const Control* child) {
 
 
 void AbsoluteLayout::SetSize(Vec2u size) {
+	if (size == m_size) {
+		return;
+	}
+	InvalidateArrange();
 	m_size = size;
 }
 
@@ -52,6 +56,10 @@ Vec2u AbsoluteLayout::GetSize() const {
 
 
 void AbsoluteLayout::SetPosition(Vec2i position) {
+	if (position == m_position) {
+		return;
+	}
+	InvalidateArrange();
 	m_position = position;
 }
 
@@ -62,10 +70,13 @@ Vec2i AbsoluteLayout::GetPosition() const {
 
 
 void AbsoluteLayout::Update(float elapsed) {
+	bool arrange = ConsumeArrangeDirty(this);
 	for (auto& childBinding : m_children) {
 		auto& [child, binding] = childBinding;
-		child->SetPosition(CalculateChildPosition(*binding));
-		child->Update(elapsed);
+		if (arrange) {
+			child->SetPosition(CalculateChildPosition(*binding));
+		}
+		UpdateIfDirty(child.get(), elapsed);
 	}
 }
 
@@ -82,12 +93,14 @@ std::vector<const Control*> AbsoluteLayout::GetChildren() const {
 
 void AbsoluteLayout::SetReferencePoint(eRefPoint point) {
 	m_refPoint = point;
+	InvalidateArrange();
 }
 AbsoluteLayout::eRefPoint AbsoluteLayout::GetReferencePoint() const {
 	return m_refPoint;
 }
 void AbsoluteLayout::SetYDown(bool enabled) {
 	m_yDown = enabled;
+	InvalidateArrange();
 }
 bool AbsoluteLayout::GetYDown() const {
 	return m_yDown;
@@ -128,6 +141,7 @@ Vec2i AbsoluteLayout::CalculateChildPosition(const Binding& binding) const {
 
 AbsoluteLayout::Binding& AbsoluteLayout::Binding::SetPosition(Vec2i position) {
 	this->position = position;
+	m_layout->InvalidateArrange();
 	return *this;
 }
 
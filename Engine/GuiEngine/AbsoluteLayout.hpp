@@ -23,9 +23,11 @@ private:
 	class Binding {
 		friend class AbsoluteLayout;
 	public:
+		Binding(AbsoluteLayout* layout) : m_layout(layout) {}
 		Binding& SetPosition(Vec2i position);
 		Vec2i GetPosition() const;
 	private:
+		AbsoluteLayout* m_layout;
 		Vec2i position = {0, 0};
 	};
 public:
@@ -1,5 +1,9 @@
 #include "Board.hpp"
 
+#include <BaseLibrary/Memory/MemoryTracker.hpp>
+
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 
@@ -12,14 +16,16 @@ void Board::AddControl(std::shared_ptr<Control> control) {
 		throw InvalidCallException("Control already added.");
 	}
 	Control::Attach(this, control.get());
+	m_hitIndexStale = true;
 }
 
 
 void Board::RemoveControl(Control* control) {
 	auto it = m_controls.find(control);
 	if (it != m_controls.end()) {
-		m_controls.erase(it);
 		Control::Detach(control);
+		m_controls.erase(it);
+		m_hitIndexStale = true; // Must not hand out the removed control.
 	}
 	else {
 		throw InvalidCallException("Control is not part of this Board.");
@@ -39,11 +45,13 @@ const DrawingContext& Board::GetDrawingContext() const {
 
 void Board::SetStyle(nullptr_t) {
 	m_defaultStyle = {};
+	MarkDirty();
 }
 
 
 void Board::SetStyle(const ControlStyle& style, bool asDefault) {
 	m_defaultStyle = style;
+	MarkDirty();
 }
 
 
@@ -153,35 +161,87 @@ void Board::SetCoordinateMapping(RectF window, RectF gui) {
 
 
 void Board::Update(float elapsed) {
+	MemoryTagScope memoryTag(eMemoryTag::GUI);
+	// Only the subtrees that changed are updated, see Control::MarkDirty.
+	if (!ConsumeDirty(this)) {
+		return;
+	}
 	for (auto& child : m_controls) {
-		child->Update(elapsed);
+		UpdateIfDirty(child.get(), elapsed);
 	}
 	UpdateZOrder();
+	m_hitIndexStale = true; // Layouts may have moved their children.
 }
 
 
-const Control* Board::HitTestRecurse(Vec2 point, const Control* top) {
-	if (HitTest(point, top)) {
-		auto children = top->GetChildren();
-		for (auto child : children) {
-			if (auto finalHit = HitTestRecurse(point, child)) {
-				return finalHit;
-			}
+RectF Board::GetRect(const Control* control) {
+	Vec2i pos = control->GetPosition();
+	Vec2u size = control->GetSize();
+	return RectF{ pos - size / 2, pos + size / 2 };
+}
+
+
+void Board::RebuildHitIndex() const {
+	constexpr float MinCellSize = 32.0f;
+	constexpr float MaxCellsPerAxis = 64.0f;
+
+	m_hitEntries.clear();
+	m_hitCells.clear();
+	m_hitGridCount = { 0, 0 };
+	m_hitIndexStale = false;
+
+	for (auto& child : m_controls) {
+		if (child->IsShown()) {
+			AddHitEntriesRecurse(child.get(), GetRect(child.get()), (uint32_t)m_hitEntries.size());
 		}
-		return top;
 	}
-	else {
-		return nullptr;
+	if (m_hitEntries.empty()) {
+		return;
+	}
+
+	RectF bounds = m_hitEntries[0].rect;
+	for (auto& entry : m_hitEntries) {
+		bounds = RectF::Union(bounds, entry.rect);
+	}
+	Vec2 boundsSize = Max(bounds.GetSize(), Vec2{ 1, 1 });
+
+	// Cells are at least a few pixels, and there are few enough of them to keep rebuilding cheap.
+	m_hitGridOrigin = bounds.GetBottomLeft();
+	m_hitCellSize = Max(boundsSize / MaxCellsPerAxis, Vec2{ MinCellSize, MinCellSize });
+	m_hitGridCount = { (int)std::ceil(boundsSize.x / m_hitCellSize.x), (int)std::ceil(boundsSize.y / m_hitCellSize.y) };
+	m_hitGridCount = Max(m_hitGridCount, Vec2i{ 1, 1 });
+	m_hitCells.resize(size_t(m_hitGridCount.x) * size_t(m_hitGridCount.y));
+
+	for (uint32_t index = 0; index < (uint32_t)m_hitEntries.size(); ++index) {
+		const RectF& rect = m_hitEntries[index].rect;
+		int firstX = std::clamp((int)std::floor((rect.left - m_hitGridOrigin.x) / m_hitCellSize.x), 0, m_hitGridCount.x - 1);
+		int lastX = std::clamp((int)std::floor((rect.right - m_hitGridOrigin.x) / m_hitCellSize.x), 0, m_hitGridCount.x - 1);
+		int firstY = std::clamp((int)std::floor((rect.bottom - m_hitGridOrigin.y) / m_hitCellSize.y), 0, m_hitGridCount.y - 1);
+		int lastY = std::clamp((int)std::floor((rect.top - m_hitGridOrigin.y) / m_hitCellSize.y), 0, m_hitGridCount.y - 1);
+		for (int y = firstY; y <= lastY; ++y) {
+			for (int x = firstX; x <= lastX; ++x) {
+				m_hitCells[size_t(y) * m_hitGridCount.x + x].push_back(index);
+			}
+		}
 	}
 }
 
 
-bool Board::HitTest(Vec2 point, const Control* control) {
-	Vec2i pos = control->GetPosition();
-	Vec2u size = control->GetSize();
-	RectF rc{ pos - size / 2, pos + size / 2 };
+void Board::AddHitEntriesRecurse(const Control* control, RectF clip, uint32_t root) const {
+	uint32_t index = (uint32_t)m_hitEntries.size();
+	m_hitEntries.push_back({ control, clip, index + 1, root });
 
-	return rc.IsPointInside(point);
+	auto children = control->GetChildren();
+	for (auto child : children) {
+		if (!child->IsShown()) {
+			continue;
+		}
+		RectF rect = GetRect(child);
+		if (rect.IsIntersecting(clip)) {
+			AddHitEntriesRecurse(child, RectF::Intersection(rect, clip), root);
+		}
+	}
+	m_hitEntries[index].subtreeEnd = (uint32_t)m_hitEntries.size();
 }
 
 
@@ -207,7 +267,6 @@ void Board::DebugTreeRecurse(const Control* control, int level) const {
 
 const Control* Board::GetTarget(Vec2 point) const {
 	const Control* target = nullptr;
-	float topmostDepth = -1e4f;
 
 #ifdef _WIN32
 	if (m_breakOnTrace && IsDebuggerPresent()) {
@@ -215,11 +274,27 @@ const Control* Board::GetTarget(Vec2 point) const {
 	}
 #endif
 
-	for (auto child : m_controls) {
-		auto* hit = HitTestRecurse(point, child.get());
-		if (hit && 0.0f > topmostDepth) {
-			target = hit;
+	// Controls detached deeper in the tree only mark the Board dirty, the index must not outlive them.
+	if (m_hitIndexStale || IsDirty()) {
+		RebuildHitIndex();
+	}
+
+	Vec2 cellCoord = (point - m_hitGridOrigin) / m_hitCellSize;
+	Vec2i cell = { (int)std::floor(cellCoord.x), (int)std::floor(cellCoord.y) };
+	if (0 <= cell.x && cell.x < m_hitGridCount.x && 0 <= cell.y && cell.y < m_hitGridCount.y) {
+		// Same choice as walking the tree: the last child of the Board that is hit,
+		// then down through the first child hit until a control has no children under the point.
+		const HitEntry* current = nullptr;
+		for (uint32_t index : m_hitCells[size_t(cell.y) * m_hitGridCount.x + cell.x]) {
+			const HitEntry& entry = m_hitEntries[index];
+			if (!entry.rect.IsPointInside(point)) {
+				continue;
+			}
+			if (!current || entry.root != current->root || index < current->subtreeEnd) {
+				current = &entry;
+			}
 		}
+		target = current ? current->control : nullptr;
 	}
 	m_breakOnTrace = false;
 	return target;
@@ -233,6 +308,10 @@ void Board::UpdateZOrder() {
 }
 
 void Board::UpdateZOrderRecurse(Control* control, int rank) {
+	// Subtrees where nothing was attached keep their ranks.
+	if (!ConsumeZOrderDirty(control)) {
+		return;
+	}
 	control->SetZOrder(rank);
 	auto children = control->GetChildren();
 	for (auto child : children) {
@@ -4,6 +4,7 @@
 
 #include <BaseLibrary/Platform/Input.hpp>
 #include <set>
+#include <vector>
 
 
 namespace inl::gui {
@@ -33,8 +34,17 @@ public:
 	void Update(float elapsed) override;
 
 private:
-	static const Control* HitTestRecurse(Vec2 point, const Control* top);
-	static bool HitTest(Vec2 point, const Control* control);
+	// Shown controls in a uniform grid, so finding the control under the cursor does not walk the tree.
+	struct HitEntry {
+		const Control* control;
+		RectF rect; // Clipped to the ancestors, as a control is only hit through its parent.
+		uint32_t subtreeEnd; // Entries are in pre-order, the descendants are up to this index.
+		uint32_t root; // Index of the entry of the Board's child the control belongs to.
+	};
+
+	static RectF GetRect(const Control* control);
+	void RebuildHitIndex() const;
+	void AddHitEntriesRecurse(const Control* control, RectF clip, uint32_t root) const;
 
 	void DebugTree() const;
 	void DebugTreeRecurse(const Control* control, int level) const;
@@ -69,6 +79,13 @@ private:
 
 	Mat33 m_coordinateMapping = Mat33::Identity();
 	mutable bool m_breakOnTrace = false;
+
+	mutable std::vector<HitEntry> m_hitEntries;
+	mutable std::vector<std::vector<uint32_t>> m_hitCells; // Entry indices overlapping each cell, in pre-order.
+	mutable Vec2 m_hitGridOrigin = { 0, 0 };
+	mutable Vec2 m_hitCellSize = { 1, 1 };
+	mutable Vec2i m_hitGridCount = { 0, 0 };
+	mutable bool m_hitIndexStale = true;
 };
 
 
@@ -22,6 +22,10 @@ Button::Button() {
 }
 
 void Button::SetSize(Vec2u size) {
+	if (size == GetSize()) {
+		return;
+	}
+	MarkDirty();
 	m_background->SetScale(size);
 	m_text->SetSize(size);
 }
@@ -31,6 +35,10 @@ Vec2u Button::GetSize() const {
 }
 
 void Button::SetPosition(Vec2i position) {
+	if (position == GetPosition()) {
+		return;
+	}
+	MarkDirty();
 	m_background->SetPosition(position);
 	m_text->SetPosition(position);
 }
@@ -51,8 +59,13 @@ void Button::Update(float elapsed) {
 	m_text->SetColor(GetStyle().text.v);
 }
 
+Vec2u Button::Measure() const {
+	return MeasureText(*m_text) + Vec2u{ 2 * Padding, 2 * Padding };
+}
+
 void Button::SetText(std::u32string text) {
 	m_text->SetText(std::move(text));
+	InvalidateMeasure();
 }
 const std::u32string& Button::GetText() const {
 	return m_text->GetText();
@@ -31,6 +31,8 @@ public:
 	void SetZOrder(int rank) override;
 	
 protected:
+	Vec2u Measure() const override;
+
 	std::vector<std::reference_wrapper<std::unique_ptr<gxeng::ITextEntity>>> GetTextEntities() override;
 	std::vector<std::reference_wrapper<std::unique_ptr<gxeng::IOverlayEntity>>> GetOverlayEntities() override;
 
@@ -38,6 +40,8 @@ private:
 	std::unique_ptr<gxeng::ITextEntity> m_text;
 	std::unique_ptr<gxeng::IOverlayEntity> m_background;
 	const gxeng::IFont* m_font = nullptr;
+
+	static constexpr unsigned Padding = 4; // Around the text when measuring.
 };
 
 
@@ -61,6 +61,20 @@ public:
 
 	virtual void SetZOrder(int rank) {};
 
+	/// <summary> True if the control or one of its descendants changed since it was last updated. </summary>
+	bool IsDirty() const { return m_dirty; }
+
+	/// <summary> The size the content of the control needs, layouts size their automatic cells by it. </summary>
+	/// <remarks> Cached until the content changes, see <see cref="InvalidateMeasure"/>.
+	///		Resizing a control does not measure it again. </remarks>
+	Vec2u GetDesiredSize() const {
+		if (m_measureDirty) {
+			m_desiredSize = Measure();
+			m_measureDirty = false;
+		}
+		return m_desiredSize;
+	}
+
 	// Events
 	Event<> OnEnterArea;
 	Event<Vec2> OnHover;
@@ -80,10 +94,79 @@ public:
 	Event<> OnLoseFocus;
 
 protected:
-	static void Attach(Control* parent, Control* child) { child->OnAttach(parent); }
-	static void Detach(Control* child) { child->OnDetach(); }
+	static void Attach(Control* parent, Control* child) {
+		child->m_attachedTo = parent;
+		child->OnAttach(parent);
+		child->MarkZOrderDirty();
+		child->InvalidateMeasure(); // Styles and fonts are inherited on attach.
+	}
+	static void Detach(Control* child) {
+		child->OnDetach();
+		if (child->m_attachedTo) {
+			child->m_attachedTo->InvalidateMeasure(); // The rest of the children are laid out again.
+		}
+		child->m_attachedTo = nullptr;
+	}
 	static const DrawingContext* GetContext(const Control* layout) { return layout->GetContext(); }
 
+	/// <summary> Schedules an update of the control and its ancestors. </summary>
+	/// <remarks> Call it when anything changes that Update or the entities depend on, like size, position, text or style.
+	///		Parents only update their dirty children, so a control that animates marks itself dirty in its Update. </remarks>
+	void MarkDirty() {
+		m_dirty = true;
+		for (Control* ancestor = m_attachedTo; ancestor && !ancestor->m_dirty; ancestor = ancestor->m_attachedTo) {
+			ancestor->m_dirty = true;
+		}
+	}
+
+	/// <summary> Call when the content changes, like text or font, the control and its ancestors are measured and laid out again. </summary>
+	/// <remarks> Ancestors are always walked to the top, as a parent may hold a cached size without having measured every child. </remarks>
+	void InvalidateMeasure() {
+		for (Control* control = this; control; control = control->m_attachedTo) {
+			control->m_measureDirty = true;
+			control->m_arrangeDirty = true;
+		}
+		MarkDirty();
+	}
+
+	/// <summary> Call when the size or position changes, the children are laid out again but not measured. </summary>
+	void InvalidateArrange() {
+		m_arrangeDirty = true;
+		MarkDirty();
+	}
+
+	/// <summary> Layouts call it in Update, and only place their children if it returns true. </summary>
+	static bool ConsumeArrangeDirty(Control* control) {
+		bool dirty = control->m_arrangeDirty;
+		control->m_arrangeDirty = false;
+		return dirty;
+	}
+
+	/// <summary> Computes the desired size from the content, controls with nothing to fit return zero. </summary>
+	virtual Vec2u Measure() const { return { 0, 0 }; }
+
+	/// <summary> Parents call this instead of Update, so unchanged subtrees are skipped. </summary>
+	static void UpdateIfDirty(Control* child, float elapsed) {
+		if (child->m_dirty) {
+			child->m_dirty = false; // Changes while updating schedule the next update.
+			child->Update(elapsed);
+		}
+	}
+
+	/// <summary> Returns if the control is dirty and clears it, for controls that track changes without calling Update. </summary>
+	static bool ConsumeDirty(Control* control) {
+		bool dirty = control->m_dirty;
+		control->m_dirty = false;
+		return dirty;
+	}
+
+	/// <summary> Returns if the z-order of the control or its descendants has to be set, and clears it. </summary>
+	static bool ConsumeZOrderDirty(Control* control) {
+		bool dirty = control->m_zOrderDirty;
+		control->m_zOrderDirty = false;
+		return dirty;
+	}
+
 	virtual void OnAttach(Control* parent) = 0;
 	virtual void OnDetach() = 0;
 	virtual const DrawingContext* GetContext() const = 0;
@@ -93,6 +176,23 @@ protected:
 	static std::shared_ptr<std::remove_reference_t<T>> MakeBlankShared(T& obj) {
 		return std::shared_ptr<std::remove_reference_t<T>>(&obj, [](auto) {});
 	}
+
+private:
+	// Ranks only change when controls are attached somewhere.
+	void MarkZOrderDirty() {
+		m_zOrderDirty = true;
+		for (Control* ancestor = m_attachedTo; ancestor && !ancestor->m_zOrderDirty; ancestor = ancestor->m_attachedTo) {
+			ancestor->m_zOrderDirty = true;
+		}
+	}
+
+private:
+	Control* m_attachedTo = nullptr;
+	bool m_dirty = true;
+	bool m_zOrderDirty = true;
+	bool m_arrangeDirty = true;
+	mutable bool m_measureDirty = true;
+	mutable Vec2u m_desiredSize = { 0, 0 };
 };
 
 
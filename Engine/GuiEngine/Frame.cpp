@@ -13,6 +13,10 @@ Frame::Frame() {
 
 
 void Frame::SetSize(Vec2u size) {
+	if (size == GetSize()) {
+		return;
+	}
+	MarkDirty();
 	m_background->SetScale(size);
 	if (m_layout) {
 		m_layout->SetSize(size);
@@ -26,6 +30,10 @@ Vec2u Frame::GetSize() const {
 
 
 void Frame::SetPosition(Vec2i position) {
+	if (position == GetPosition()) {
+		return;
+	}
+	MarkDirty();
 	m_background->SetPosition(position);
 	if (m_layout) {
 		m_layout->SetPosition(position);
@@ -40,11 +48,16 @@ Vec2i Frame::GetPosition() const {
 
 void Frame::Update(float elapsed) {
 	if (m_layout) {
-		m_layout->Update(elapsed);
+		UpdateIfDirty(m_layout.get(), elapsed);
 	}
 	m_background->SetColor(GetStyle().background.v);
 }
 
+Vec2u Frame::Measure() const {
+	return m_layout ? m_layout->GetDesiredSize() : Vec2u{ 0, 0 };
+}
+
+
 std::vector<const Control*> Frame::GetChildren() const {
 	if (m_layout) {
 		return { m_layout.get() };
@@ -16,6 +16,10 @@ Label::Label() {
 }
 
 void Label::SetSize(Vec2u size) {
+	if (size == GetSize()) {
+		return;
+	}
+	MarkDirty();
 	m_text->SetSize(size);
 }
 
@@ -24,6 +28,10 @@ Vec2u Label::GetSize() const {
 }
 
 void Label::SetPosition(Vec2i position) {
+	if (position == GetPosition()) {
+		return;
+	}
+	MarkDirty();
 	m_text->SetPosition(position);
 }
 Vec2i Label::GetPosition() const {
@@ -35,6 +43,10 @@ void Label::Update(float elapsed) {
 	m_text->SetColor(GetStyle().text.v);
 }
 
+Vec2u Label::Measure() const {
+	return MeasureText(*m_text);
+}
+
 void Label::SetHorizontalAlignment(float alignment) {
 	m_text->SetHorizontalAlignment(alignment);
 }
@@ -48,6 +60,7 @@ void Label::SetVerticalAlignment(float alignment) {
 
 void Label::SetText(std::u32string text) {
 	m_text->SetText(std::move(text));
+	InvalidateMeasure();
 }
 const std::u32string& Label::GetText() const {
 	return m_text->GetText();
@@ -31,6 +31,8 @@ public:
 
 	void SetZOrder(int rank) override;
 protected:
+	Vec2u Measure() const override;
+
 	std::vector<std::reference_wrapper<std::unique_ptr<gxeng::ITextEntity>>> GetTextEntities() override;
 	std::vector<std::reference_wrapper<std::unique_ptr<gxeng::IOverlayEntity>>> GetOverlayEntities() override;
 
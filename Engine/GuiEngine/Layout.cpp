@@ -28,12 +28,14 @@ void Layout::SetStyle(nullptr_t) {
 	if (m_parent) {
 		m_style = m_parent->GetStyle();
 	}
+	MarkDirty();
 }
 
 
 void Layout::SetStyle(const ControlStyle& style, bool asDefault) {
 	m_style = style;
 	m_isStyleInherited = asDefault;
+	MarkDirty();
 }
 
 
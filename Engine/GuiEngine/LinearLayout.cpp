@@ -39,6 +39,7 @@ void LinearLayout::Change(const_iterator which, std::shared_ptr<Control> control
 void LinearLayout::Change(const_iterator which, CellSize sizing) {
 	auto mutWhich = m_children.begin() + (which - m_children.cbegin());
 	mutWhich->sizing = sizing;
+	InvalidateMeasure();
 }
 
 
@@ -60,6 +61,7 @@ void LinearLayout::Erase(const_iterator which) {
 		Detach(which->control.get());
 	}
 	m_children.erase(which);
+	InvalidateMeasure();
 }
 
 
@@ -74,12 +76,20 @@ void LinearLayout::Clear() {
 
 
 void LinearLayout::SetSize(Vec2u size) {
+	if (size == m_size) {
+		return;
+	}
+	InvalidateArrange();
 	m_size = size;
 }
 Vec2u LinearLayout::GetSize() const {
 	return m_size;
 }
 void LinearLayout::SetPosition(Vec2i position) {
+	if (position == m_position) {
+		return;
+	}
+	InvalidateArrange();
 	m_position = position;
 }
 Vec2i LinearLayout::GetPosition() const {
@@ -88,13 +98,27 @@ Vec2i LinearLayout::GetPosition() const {
 
 
 void LinearLayout::Update(float elapsed) {
+	// Children only updating themselves, like a blinking cursor, do not move the cells.
+	if (ConsumeArrangeDirty(this)) {
+		Arrange();
+	}
+
+	for (const auto& child : m_children) {
+		if (child.control) {
+			UpdateIfDirty(child.control.get(), elapsed);
+		}
+	}
+}
+
+
+void LinearLayout::Arrange() {
 	float sumPercentage = 0.0f;
 	unsigned sumAbsolute = 0;
 	for (const auto& child : m_children) {
 		switch (child.sizing.GetType()) {
 			case eCellType::ABSOLUTE: sumAbsolute += (unsigned)std::max(0.0f, child.sizing.GetValue()); break;
 			case eCellType::WEIGHT: sumPercentage += std::max(0.0f, child.sizing.GetValue()); break;
-			case eCellType::AUTO: sumAbsolute += 80; break; // Use Control::GetPreferred size instead.
+			case eCellType::AUTO: sumAbsolute += GetCellLength(child); break;
 		}
 	}
 
@@ -116,7 +140,7 @@ void LinearLayout::Update(float elapsed) {
 		switch (child.sizing.GetType()) {
 			case eCellType::ABSOLUTE: moving = (int)std::max(0.0f, child.sizing.GetValue()); break;
 			case eCellType::WEIGHT: moving = (int)std::max(0.0f, child.sizing.GetValue())/sumPercentage*weightedLength; break;
-			case eCellType::AUTO: moving = 80; break;
+			case eCellType::AUTO: moving = (int)GetCellLength(child); break;
 		}
 
 		int totalMarginMoving = child.sizing.GetMargin().left + child.sizing.GetMargin().right;
@@ -149,12 +173,32 @@ void LinearLayout::Update(float elapsed) {
 		
 		whereMoving += moving;
 	}
+}
+
 
+Vec2u LinearLayout::Measure() const {
+	unsigned moving = 0;
+	unsigned fix = 0;
 	for (const auto& child : m_children) {
-		if (child.control) {
-			child.control->Update(elapsed);
-		}
+		// Weighted cells need at least what fits their control.
+		moving += child.sizing.GetType() == eCellType::ABSOLUTE ? (unsigned)std::max(0.0f, child.sizing.GetValue()) : GetCellLength(child);
+
+		Vec2u desired = child.control ? child.control->GetDesiredSize() : Vec2u{ 0, 0 };
+		unsigned margins = child.sizing.GetMargin().bottom + child.sizing.GetMargin().top;
+		fix = std::max(fix, (!m_vertical ? desired.y : desired.x) + margins);
+	}
+	return !m_vertical ? Vec2u{ moving, fix } : Vec2u{ fix, moving };
+}
+
+
+unsigned LinearLayout::GetCellLength(const Cell& cell) const {
+	// The margins along the layout are the left and right ones in both directions, see Arrange.
+	unsigned margins = cell.sizing.GetMargin().left + cell.sizing.GetMargin().right;
+	if (!cell.control) {
+		return margins;
 	}
+	Vec2u desired = cell.control->GetDesiredSize();
+	return (!m_vertical ? desired.x : desired.y) + margins;
 }
 
 
@@ -24,6 +24,7 @@ public:
 	public:
 		CellSize& SetWidth(unsigned width) { type = eCellType::ABSOLUTE; value = width; return *this; }
 		CellSize& SetWeight(float weight) { type = eCellType::WEIGHT; value = std::max(0.0f, weight); return *this; }
+		CellSize& SetAuto() { type = eCellType::AUTO; value = 0.0f; return *this; } // Fits the desired size of the control.
 		eCellType GetType() const { return type; }
 		float GetValue() const { return value; }
 		Rect<unsigned, false, false> GetMargin() const { return margin; }
@@ -66,15 +67,21 @@ public:
 
 	std::vector<const Control*> GetChildren() const override;
 
-	void SetVertical(bool vertical) { m_vertical = vertical; }
+	void SetVertical(bool vertical) { m_vertical = vertical; InvalidateMeasure(); }
 	bool IsVertical() const { return m_vertical; }
-	void SetInverted(bool inversion) { m_inverted = inversion; }
+	void SetInverted(bool inversion) { m_inverted = inversion; InvalidateArrange(); }
 	bool IsInverted() const { return m_inverted; }
 
+protected:
+	Vec2u Measure() const override;
+
 private:
 	void OnAttach(Control* parent) override;
 	void OnDetach() override;
 
+	void Arrange();
+	unsigned GetCellLength(const Cell& cell) const;
+
 private:
 	bool m_vertical = false;
 	bool m_inverted = false;
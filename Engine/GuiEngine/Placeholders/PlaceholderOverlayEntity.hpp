@@ -18,6 +18,9 @@ public:
 	void SetTexture(gxeng::IImage* texture) override { m_image = texture; }
 	gxeng::IImage* GetTexture() const override { return m_image; }
 
+	void SetTextureRect(RectF rect) override { m_textureRect = rect; }
+	RectF GetTextureRect() const override { return m_textureRect; }
+
 	void SetZDepth(float z) override { m_depth = z; }
 	float GetZDepth() const override { return m_depth; }
 
@@ -25,6 +28,7 @@ public:
 		target->SetMesh(source->GetMesh());
 		target->SetColor(source->GetColor());
 		target->SetTexture(source->GetTexture());
+		target->SetTextureRect(source->GetTextureRect());
 		target->SetZDepth(source->GetZDepth());
 		target->SetTransform(source->GetTransform());
 	}
@@ -32,6 +36,7 @@ private:
 	gxeng::IMesh* m_mesh = nullptr;
 	Vec4 m_color = { 1, 1, 1, 1 };
 	gxeng::IImage* m_image = nullptr;
+	RectF m_textureRect = { 0.0f, 1.0f, 0.0f, 1.0f };
 	float m_depth = 0.0f;
 };
 
@@ -4,6 +4,8 @@
 #include "Placeholders/PlaceholderOverlayEntity.hpp"
 #include "Placeholders/PlaceholderTextEntity.hpp"
 
+#include <cmath>
+
 
 namespace inl::gui {
 
@@ -15,6 +17,7 @@ StandardControl::StandardControl() {
 
 void StandardControl::SetVisible(bool visible) {
 	m_isVisible = visible;
+	MarkDirty();
 	UpdateVisibility(m_parent && m_parent->IsShown() && m_context && m_isVisible);
 }
 
@@ -34,12 +37,14 @@ void StandardControl::SetStyle(nullptr_t) {
 	if (m_parent) {
 		m_style = m_parent->GetStyle();
 	}
+	InvalidateMeasure();
 }
 
 
 void StandardControl::SetStyle(const ControlStyle& style, bool asDefault) {
 	m_style = style;
 	m_isStyleInherited = asDefault;
+	InvalidateMeasure();
 }
 
 
@@ -150,6 +155,11 @@ void StandardControl::MakePlaceholderEntities() {
 	}
 }
 
+Vec2u StandardControl::MeasureText(const gxeng::ITextEntity& text) {
+	return { (unsigned)std::ceil(text.CalculateTextWidth()), (unsigned)std::ceil(text.CalculateTextHeight()) };
+}
+
+
 eStandardControlState StandardControl::GetState() const {
 	return m_state;
 }
@@ -184,6 +194,7 @@ void StandardControl::AddStateScripts() {
 }
 
 void StandardControl::UpdateState() {
+	MarkDirty(); // Colors follow the state.
 	if (m_pressed > 0) {
 		m_state = eStandardControlState::PRESSED;
 	}
@@ -42,6 +42,9 @@ protected:
 	void MakeRealEntities();
 	void MakePlaceholderEntities();
 
+	/// <summary> The size of the text with the entity's font, zero without a font. </summary>
+	static Vec2u MeasureText(const gxeng::ITextEntity& text);
+
 	eStandardControlState GetState() const;
 private:
 	void AddStateScripts();
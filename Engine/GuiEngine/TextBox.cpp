@@ -22,6 +22,10 @@ TextBox::TextBox() {
 }
 
 void TextBox::SetSize(Vec2u size) {
+	if (size == GetSize()) {
+		return;
+	}
+	MarkDirty();
 	m_frame->SetScale(size);
 	m_background->SetScale(Vec2(size) - Vec2(2, 2));
 	m_text->SetSize(size);
@@ -32,6 +36,10 @@ Vec2u TextBox::GetSize() const {
 }
 
 void TextBox::SetPosition(Vec2i position) {
+	if (position == GetPosition()) {
+		return;
+	}
+	MarkDirty();
 	m_frame->SetPosition(position);
 	m_background->SetPosition(position);
 	m_text->SetPosition(position);
@@ -52,21 +60,28 @@ void TextBox::Update(float elapsed) {
 	float alpha = m_sinceLastCursorBlink < m_blinkTime && m_drawCursor ? 1.0f : 0.0f;
 	auto currentColor = m_cursor->GetColor();
 	m_cursor->SetColor(currentColor.xyz | alpha);
+	if (m_drawCursor) {
+		MarkDirty(); // Keep blinking.
+	}
 
-	// Calculate cursor position.
-	auto font = GetStyle().font;
+	// Calculate cursor position, the text entity keeps its laid out glyphs.
 	auto fontSize = m_text->GetFontSize();
-	if (font) {
-		std::u32string u32text = EncodeString<char32_t>(GetText()) + U"_";
-		auto [left, right] = font->FindCoordinates(u32text, m_cursorPosition, fontSize);
+	if (m_text->GetFont()) {
+		float left = m_text->GetCaretPosition(m_cursorPosition);
 		m_cursor->SetScale({ 2, fontSize });
 		m_cursor->SetPosition({ m_text->GetPosition().x + left - m_text->CalculateTextWidth()/2, m_text->GetPosition().y });
 	}
 }
 
+Vec2u TextBox::Measure() const {
+	// Only the line height, so typing does not lay out the parent again.
+	return { 2 * Padding, MeasureText(*m_text).y + 2 * Padding };
+}
+
 void TextBox::SetText(std::u32string text) {
 	m_cursorPosition = std::min(m_cursorPosition, (intptr_t)text.size());
 	m_text->SetText(std::move(text));
+	MarkDirty();
 }
 const std::u32string& TextBox::GetText() const {
 	return m_text->GetText();
@@ -149,6 +164,7 @@ void TextBox::SetScripts() {
 			m_cursorPosition = text.size();
 		}
 		m_sinceLastCursorBlink = 0.0f;
+		MarkDirty();
 	};
 	OnEnterArea += [] {
 		System::SetCursorVisual(eCursorVisual::IBEAM, nullptr);
@@ -159,9 +175,11 @@ void TextBox::SetScripts() {
 	OnGainFocus += [this] {
 		m_drawCursor = true;
 		m_sinceLastCursorBlink = 0.0f;
+		MarkDirty();
 	};
 	OnLoseFocus += [this] {
 		m_drawCursor = false;
+		MarkDirty();
 	};
 }
 
@@ -31,6 +31,8 @@ public:
 	void SetZOrder(int rank) override;
 
 protected:
+	Vec2u Measure() const override;
+
 	std::vector<std::reference_wrapper<std::unique_ptr<gxeng::ITextEntity>>> GetTextEntities() override;
 	std::vector<std::reference_wrapper<std::unique_ptr<gxeng::IOverlayEntity>>> GetOverlayEntities() override;
 
@@ -47,6 +49,8 @@ private:
 	float m_blinkTime = 0.5f;
 	bool m_drawCursor = false;
 	intptr_t m_cursorPosition = 0;
+
+	static constexpr unsigned Padding = 4; // Around the text when measuring.
 };
 
 
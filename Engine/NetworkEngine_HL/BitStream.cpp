@@ -0,0 +1,124 @@
+#include "BitStream.hpp"
+
+#include <algorithm>
+
+namespace inl::net
+{
+	void BitWriter::Write(uint32_t value, uint32_t bits)
+	{
+		while (bits > 0)
+		{
+			size_t bit_offset = m_bitCount % 8;
+			if (bit_offset == 0)
+				m_bytes.push_back(0);
+
+			uint32_t count = std::min<uint32_t>(bits, uint32_t(8 - bit_offset));
+			uint32_t mask = (1u << count) - 1;
+			m_bytes.back() |= uint8_t((value & mask) << bit_offset);
+
+			value = count < 32 ? value >> count : 0;
+			bits -= count;
+			m_bitCount += count;
+		}
+	}
+
+	void BitWriter::WriteBool(bool value)
+	{
+		Write(value ? 1 : 0, 1);
+	}
+
+	void BitWriter::WriteVarUint(uint32_t value)
+	{
+		do
+		{
+			Write(value & 0x7F, 7);
+			value >>= 7;
+			WriteBool(value != 0);
+		} while (value != 0);
+	}
+
+	void BitWriter::Append(const BitWriter &other)
+	{
+		size_t remaining = other.m_bitCount;
+		for (uint8_t byte : other.m_bytes)
+		{
+			uint32_t count = (uint32_t)std::min<size_t>(remaining, 8);
+			Write(byte, count);
+			remaining -= count;
+		}
+	}
+
+	size_t BitWriter::GetBitCount() const
+	{
+		return m_bitCount;
+	}
+
+	const std::vector<uint8_t> &BitWriter::GetBytes() const
+	{
+		return m_bytes;
+	}
+
+	void BitWriter::Clear()
+	{
+		m_bytes.clear();
+		m_bitCount = 0;
+	}
+
+	BitReader::BitReader(const uint8_t *data, size_t size)
+		: m_data(data)
+		, m_bitCount(size * 8)
+	{
+	}
+
+	uint32_t BitReader::Read(uint32_t bits)
+	{
+		if (m_position + bits > m_bitCount)
+		{
+			m_overflowed = true;
+			m_position = m_bitCount;
+			return 0;
+		}
+
+		uint32_t value = 0;
+		uint32_t written = 0;
+		while (written < bits)
+		{
+			size_t bit_offset = m_position % 8;
+			uint32_t count = std::min<uint32_t>(bits - written, uint32_t(8 - bit_offset));
+			uint32_t mask = (1u << count) - 1;
+			value |= uint32_t((m_data[m_position / 8] >> bit_offset) & mask) << written;
+
+			written += count;
+			m_position += count;
+		}
+		return value;
+	}
+
+	bool BitReader::ReadBool()
+	{
+		return Read(1) != 0;
+	}
+
+	uint32_t BitReader::ReadVarUint()
+	{
+		uint32_t value = 0;
+		for (uint32_t shift = 0; shift < 35; shift += 7)
+		{
+			value |= Read(7) << shift;
+			if (!ReadBool() || m_overflowed)
+				return value;
+		}
+		m_overflowed = true; // Longer than any value that was written.
+		return value;
+	}
+
+	bool BitReader::IsOverflowed() const
+	{
+		return m_overflowed;
+	}
+
+	size_t BitReader::GetRemainingBits() const
+	{
+		return m_bitCount - m_position;
+	}
+}
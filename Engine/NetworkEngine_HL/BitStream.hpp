@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace inl::net
+{
+	/// <summary> Packs values of arbitrary bit widths, least significant bit first. </summary>
+	class BitWriter
+	{
+	public:
+		/// <param name="bits"> 0 to 32. </param>
+		void Write(uint32_t value, uint32_t bits);
+		void WriteBool(bool value);
+		/// <summary> 7 bits at a time, with a continuation bit after each group. </summary>
+		void WriteVarUint(uint32_t value);
+		void Append(const BitWriter &other);
+
+		size_t GetBitCount() const;
+		/// <summary> Whole bytes, the last one padded with zeros. </summary>
+		const std::vector<uint8_t> &GetBytes() const;
+		void Clear();
+
+	private:
+		std::vector<uint8_t> m_bytes;
+		size_t m_bitCount = 0;
+	};
+
+	/// <summary> Reads what <see cref="BitWriter"/> wrote. </summary>
+	/// <remarks> Reading past the end returns zeros and sets the overflow flag, check it once at the end. </remarks>
+	class BitReader
+	{
+	public:
+		BitReader(const uint8_t *data, size_t size);
+
+		uint32_t Read(uint32_t bits);
+		bool ReadBool();
+		uint32_t ReadVarUint();
+
+		bool IsOverflowed() const;
+		size_t GetRemainingBits() const;
+
+	private:
+		const uint8_t *m_data;
+		size_t m_bitCount;
+		size_t m_position = 0;
+		bool m_overflowed = false;
+	};
+}
@@ -14,6 +14,7 @@ namespace inl::net::events
 			DestinationID = msg.GetDestinationID();
 			Tag = msg.GetTag();
 			Data = msg.GetData<void>();
+			Frame = msg.GetFrame();
 		}
 
 	public:
@@ -23,5 +24,6 @@ namespace inl::net::events
 		uint32_t Tag;
 
 		void *Data;
+		MessageSlice Frame; // Keeps the received bytes that Data points into.
 	};
 }
\ No newline at end of file
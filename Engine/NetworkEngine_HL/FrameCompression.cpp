@@ -0,0 +1,227 @@
+#include "FrameCompression.hpp"
+
+#include "NetworkHeader.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace inl::net
+{
+	// Limits of the LZ4 block format, a block that breaks them is not readable by other decoders.
+	static constexpr uint32_t MinMatch = 4;
+	static constexpr uint32_t LastLiterals = 5; // The block ends with at least this many literals.
+	static constexpr uint32_t MatchFindLimit = 12; // The last match starts at least this far from the end.
+	static constexpr uint32_t MaxOffset = 65535;
+	static constexpr uint32_t HashBits = 12;
+
+	static uint32_t Read32(const uint8_t *bytes)
+	{
+		uint32_t value;
+		memcpy(&value, bytes, sizeof(value));
+		return value;
+	}
+
+	static uint32_t Hash(uint32_t sequence)
+	{
+		return (sequence * 2654435761u) >> (32 - HashBits);
+	}
+
+	static uint8_t *WriteLength(uint8_t *out, uint32_t length)
+	{
+		for (; length >= 255; length -= 255)
+			*out++ = 255;
+		*out++ = (uint8_t)length;
+		return out;
+	}
+
+	static bool ReadLength(const uint8_t *&in, const uint8_t *end, uint32_t &length)
+	{
+		uint8_t next;
+		do
+		{
+			if (in == end || length > FrameCompression::MaxDataSize)
+				return false;
+			next = *in++;
+			length += next;
+		} while (next == 255);
+		return true;
+	}
+
+	/// <summary> Greedy compression with a single hash table of the last positions. </summary>
+	/// <returns> The size of the block, or 0 if it does not fit into capacity. </returns>
+	static uint32_t CompressBlock(const uint8_t *src, uint32_t size, uint8_t *dst, uint32_t capacity)
+	{
+		uint32_t table[1 << HashBits] = {};
+
+		const uint8_t *end = src + size;
+		const uint8_t *searchEnd = size > MatchFindLimit ? end - MatchFindLimit : src;
+		const uint8_t *matchEnd = end - std::min(size, LastLiterals);
+		const uint8_t *anchor = src;
+		const uint8_t *in = src;
+		uint8_t *out = dst;
+		uint8_t *outEnd = dst + capacity;
+
+		while (in < searchEnd)
+		{
+			uint32_t sequence = Read32(in);
+			uint32_t &entry = table[Hash(sequence)];
+			const uint8_t *candidate = src + entry;
+			entry = uint32_t(in - src);
+			if (candidate >= in || in - candidate > MaxOffset || Read32(candidate) != sequence)
+			{
+				in++;
+				continue;
+			}
+
+			while (in > anchor && candidate > src && in[-1] == candidate[-1])
+			{
+				in--;
+				candidate--;
+			}
+			uint32_t length = MinMatch;
+			while (in + length < matchEnd && in[length] == candidate[length])
+				length++;
+
+			uint32_t literals = uint32_t(in - anchor);
+			if (uint32_t(outEnd - out) < 1 + literals / 255 + 1 + literals + 2 + (length - MinMatch) / 255 + 1)
+				return 0;
+
+			uint8_t *token = out++;
+			*token = uint8_t(std::min(literals, 15u) << 4 | std::min(length - MinMatch, 15u));
+			if (literals >= 15)
+				out = WriteLength(out, literals - 15);
+			memcpy(out, anchor, literals);
+			out += literals;
+
+			uint32_t offset = uint32_t(in - candidate);
+			*out++ = uint8_t(offset);
+			*out++ = uint8_t(offset >> 8);
+			if (length - MinMatch >= 15)
+				out = WriteLength(out, length - MinMatch - 15);
+
+			in += length;
+			anchor = in;
+			// Most of the ratio on repetitive data comes from remembering a position inside the match too.
+			table[Hash(Read32(in - 2))] = uint32_t(in - 2 - src);
+		}
+
+		uint32_t literals = uint32_t(end - anchor);
+		if (uint32_t(outEnd - out) < 1 + literals / 255 + 1 + literals)
+			return 0;
+
+		*out++ = uint8_t(std::min(literals, 15u) << 4);
+		if (literals >= 15)
+			out = WriteLength(out, literals - 15);
+		memcpy(out, anchor, literals);
+		out += literals;
+		return uint32_t(out - dst);
+	}
+
+	/// <summary> Checks every length and offset, so a malformed block cannot read or write outside the buffers. </summary>
+	/// <returns> False unless the block decodes to exactly size bytes. </returns>
+	static bool DecompressBlock(const uint8_t *src, uint32_t srcSize, uint8_t *dst, uint32_t size)
+	{
+		const uint8_t *in = src;
+		const uint8_t *end = src + srcSize;
+		uint8_t *out = dst;
+		uint8_t *outEnd = dst + size;
+
+		while (in < end)
+		{
+			uint8_t token = *in++;
+			uint32_t literals = token >> 4;
+			if (literals == 15 && !ReadLength(in, end, literals))
+				return false;
+			if (literals > uint32_t(end - in) || literals > uint32_t(outEnd - out))
+				return false;
+			memcpy(out, in, literals);
+			in += literals;
+			out += literals;
+
+			if (in == end)
+				break; // The last sequence has no match.
+
+			if (end - in < 2)
+				return false;
+			uint32_t offset = in[0] | uint32_t(in[1]) << 8;
+			in += 2;
+			if (offset == 0 || offset > uint32_t(out - dst))
+				return false;
+
+			uint32_t length = token & 15;
+			if (length == 15 && !ReadLength(in, end, length))
+				return false;
+			length += MinMatch;
+			if (length > uint32_t(outEnd - out))
+				return false;
+
+			// Matches may overlap what they write, e.g. a run of one byte has an offset of 1.
+			const uint8_t *match = out - offset;
+			if (offset >= length)
+			{
+				memcpy(out, match, length);
+				out += length;
+			}
+			else
+			{
+				for (uint32_t i = 0; i < length; i++)
+					*out++ = match[i];
+			}
+		}
+		return out == outEnd;
+	}
+
+	MessageSlice FrameCompression::Compress(const MessageSlice &frame, MessageBufferPool &pool)
+	{
+		if (frame.Size() < NetworkMessage::FrameOverhead + MinDataSize)
+			return {};
+
+		NetworkHeader header;
+		memcpy(&header, frame.Data(), sizeof(NetworkHeader));
+		if (header.Flags & NetworkHeader::CompressedFlag)
+			return {};
+
+		// Only worth it if the result is smaller than the frame, so that bounds the block too.
+		uint32_t dataSize = frame.Size() - NetworkMessage::FrameOverhead;
+		MessageSlice compressed = pool.Acquire(frame.Size());
+		uint32_t blockSize = CompressBlock(frame.Data() + NetworkMessage::FrameOverhead, dataSize,
+										   compressed.Data() + CompressedOverhead, frame.Size() - CompressedOverhead - 1);
+		if (blockSize == 0)
+			return {};
+
+		header.Size = CompressedOverhead + blockSize;
+		header.Flags |= NetworkHeader::CompressedFlag;
+		memcpy(compressed.Data(), &header, sizeof(NetworkHeader));
+		memcpy(compressed.Data() + sizeof(NetworkHeader), frame.Data() + sizeof(NetworkHeader), NetworkMessage::FrameOverhead - sizeof(NetworkHeader));
+		memcpy(compressed.Data() + NetworkMessage::FrameOverhead, &dataSize, sizeof(uint32_t));
+		return compressed.Slice(0, header.Size);
+	}
+
+	MessageSlice FrameCompression::Decompress(const MessageSlice &frame, MessageBufferPool &pool)
+	{
+		if (frame.Size() < CompressedOverhead)
+			return {};
+
+		NetworkHeader header;
+		memcpy(&header, frame.Data(), sizeof(NetworkHeader));
+		if (!(header.Flags & NetworkHeader::CompressedFlag) || header.Size != frame.Size())
+			return {};
+
+		uint32_t dataSize;
+		memcpy(&dataSize, frame.Data() + NetworkMessage::FrameOverhead, sizeof(uint32_t));
+		// A byte of the block decodes to at most 255, anything claiming more is not worth allocating for.
+		uint32_t blockSize = frame.Size() - CompressedOverhead;
+		if (dataSize > MaxDataSize || dataSize / 256 > blockSize)
+			return {};
+
+		MessageSlice decompressed = pool.Acquire(NetworkMessage::FrameOverhead + dataSize);
+		if (!DecompressBlock(frame.Data() + CompressedOverhead, blockSize, decompressed.Data() + NetworkMessage::FrameOverhead, dataSize))
+			return {};
+
+		header.Size = NetworkMessage::FrameOverhead + dataSize;
+		header.Flags &= ~NetworkHeader::CompressedFlag;
+		memcpy(decompressed.Data(), &header, sizeof(NetworkHeader));
+		memcpy(decompressed.Data() + sizeof(NetworkHeader), frame.Data() + sizeof(NetworkHeader), NetworkMessage::FrameOverhead - sizeof(NetworkHeader));
+		return decompressed;
+	}
+}
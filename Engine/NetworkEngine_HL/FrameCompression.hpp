@@ -0,0 +1,41 @@
+#pragma once
+
+#include "MessageBuffer.hpp"
+#include "NetworkMessage.hpp"
+
+#include <cstdint>
+
+namespace inl::net
+{
+	/// <summary> Bits of the data of an <see cref="InternalTags::Compression"/> message. </summary>
+	enum class CompressionCodecs : uint32_t
+	{
+		None = 0,
+		Lz4 = 1
+	};
+
+	/// <summary> Compresses the data of serialized messages in the LZ4 block format. </summary>
+	/// <remarks>
+	/// A compressed frame has the <see cref="NetworkHeader::CompressedFlag"/> set and the usual sender, mode, destination
+	/// and tag, only the data is replaced by its uncompressed size followed by the LZ4 block. So the frame can be routed
+	/// without decompressing it, and a peer that did not ask for compression never receives one.
+	/// Peers agree on it at connect with <see cref="InternalTags::Compression"/>.
+	/// </remarks>
+	class FrameCompression
+	{
+	public:
+		static constexpr uint32_t MinDataSize = 1024; // Smaller data is sent as it is, it would barely shrink.
+		static constexpr uint32_t MaxDataSize = 64 * 1024 * 1024; // Compressed frames claiming more are rejected before allocating.
+		static constexpr uint32_t CompressedOverhead = NetworkMessage::FrameOverhead + sizeof(uint32_t);
+
+	public:
+		/// <summary> Returns the frame with its data compressed, in a buffer of the pool. </summary>
+		/// <returns> Empty if the data is smaller than <see cref="MinDataSize"/> or would not get smaller. </returns>
+		static MessageSlice Compress(const MessageSlice &frame, MessageBufferPool &pool);
+
+		/// <summary> Decodes a frame written by <see cref="Compress"/> straight into a buffer of the pool,
+		///		the result can be deserialized in place. </summary>
+		/// <returns> Empty if the frame is malformed. </returns>
+		static MessageSlice Decompress(const MessageSlice &frame, MessageBufferPool &pool);
+	};
+}
@@ -6,5 +6,6 @@ enum class InternalTags : uint32_t
 {
 	Disconnect = 0xFFFFFFFF,
 	Connect = 0xFFFFFFFE,
-	AssignID = 0xFFFFFFFD
+	AssignID = 0xFFFFFFFD,
+	Compression = 0xFFFFFFFC // Data is the CompressionCodecs the sender can decompress, the server answers with the ones it accepted.
 };
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "MessageBuffer.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <utility>
+
+namespace inl::net
+{
+	struct MessageBufferPool::FreeList
+	{
+		~FreeList();
+
+		std::mutex mutex;
+		std::vector<MessageSlice::Block*> blocks;
+	};
+
+	struct MessageSlice::Block
+	{
+		std::atomic<uint32_t> refCount;
+		std::vector<uint8_t> bytes;
+		std::shared_ptr<MessageBufferPool::FreeList> owner; // Keeps the free list alive until the block returns.
+	};
+
+	MessageBufferPool::FreeList::~FreeList()
+	{
+		for (auto block : blocks)
+			delete block;
+	}
+
+	//------------------------------------------------------------------------------
+	// MessageSlice.
+	//------------------------------------------------------------------------------
+
+	MessageSlice::MessageSlice(Block *block, uint32_t offset, uint32_t size)
+		: m_block(block)
+		, m_offset(offset)
+		, m_size(size)
+	{
+		m_block->refCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	MessageSlice::MessageSlice(const MessageSlice &other)
+		: m_block(other.m_block)
+		, m_offset(other.m_offset)
+		, m_size(other.m_size)
+	{
+		if (m_block)
+			m_block->refCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	MessageSlice::MessageSlice(MessageSlice &&other) noexcept
+		: m_block(std::exchange(other.m_block, nullptr))
+		, m_offset(std::exchange(other.m_offset, 0))
+		, m_size(std::exchange(other.m_size, 0))
+	{
+	}
+
+	MessageSlice::~MessageSlice()
+	{
+		if (!m_block || m_block->refCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+
+		std::shared_ptr<MessageBufferPool::FreeList> owner = std::move(m_block->owner);
+		if (m_block->bytes.size() <= MessageBufferPool::MaxPooledSize)
+		{
+			std::lock_guard<std::mutex> lock(owner->mutex);
+			if (owner->blocks.size() < MessageBufferPool::MaxPooledCount)
+			{
+				owner->blocks.push_back(m_block);
+				return;
+			}
+		}
+		delete m_block;
+	}
+
+	MessageSlice &MessageSlice::operator=(MessageSlice other) noexcept
+	{
+		std::swap(m_block, other.m_block);
+		std::swap(m_offset, other.m_offset);
+		std::swap(m_size, other.m_size);
+		return *this;
+	}
+
+	uint8_t *MessageSlice::Data() const
+	{
+		return m_block ? m_block->bytes.data() + m_offset : nullptr;
+	}
+
+	uint32_t MessageSlice::Size() const
+	{
+		return m_size;
+	}
+
+	bool MessageSlice::Empty() const
+	{
+		return m_size == 0;
+	}
+
+	MessageSlice MessageSlice::Slice(uint32_t offset, uint32_t size) const
+	{
+		if (offset > m_size || size > m_size - offset)
+			throw OutOfRangeException("Slice is outside the parent slice.");
+		if (!m_block)
+			return {};
+		return MessageSlice(m_block, m_offset + offset, size);
+	}
+
+	//------------------------------------------------------------------------------
+	// MessageBufferPool.
+	//------------------------------------------------------------------------------
+
+	MessageBufferPool::MessageBufferPool()
+		: m_freeList(std::make_shared<FreeList>())
+	{
+	}
+
+	MessageBufferPool::~MessageBufferPool() = default;
+
+	MessageSlice MessageBufferPool::Acquire(uint32_t size)
+	{
+		MessageSlice::Block *block = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(m_freeList->mutex);
+			if (!m_freeList->blocks.empty())
+			{
+				block = m_freeList->blocks.back();
+				m_freeList->blocks.pop_back();
+			}
+		}
+		if (!block)
+		{
+			block = new MessageSlice::Block();
+			block->refCount.store(0, std::memory_order_relaxed);
+		}
+
+		// Recycled buffers keep their capacity, so resizing them does not allocate.
+		block->bytes.resize(size);
+		block->owner = m_freeList;
+		return MessageSlice(block, 0, size);
+	}
+
+	size_t MessageBufferPool::GetFreeCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_freeList->mutex);
+		return m_freeList->blocks.size();
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace inl::net
+{
+	class MessageBufferPool;
+
+	/// <summary> A range of bytes in a pooled buffer. </summary>
+	/// <remarks> Copies share the buffer through an intrusive reference count,
+	///		the buffer goes back to its pool when the last slice of it is destroyed. </remarks>
+	class MessageSlice
+	{
+		friend class MessageBufferPool;
+
+	public:
+		MessageSlice() = default;
+		MessageSlice(const MessageSlice &other);
+		MessageSlice(MessageSlice &&other) noexcept;
+		~MessageSlice();
+		MessageSlice &operator=(MessageSlice other) noexcept;
+
+		uint8_t *Data() const;
+		uint32_t Size() const;
+		bool Empty() const;
+
+		/// <summary> A part of this slice that shares the same buffer. </summary>
+		MessageSlice Slice(uint32_t offset, uint32_t size) const;
+
+	private:
+		struct Block;
+		MessageSlice(Block *block, uint32_t offset, uint32_t size);
+
+		Block *m_block = nullptr;
+		uint32_t m_offset = 0;
+		uint32_t m_size = 0;
+	};
+
+	/// <summary> Recycles the buffers of serialized and received messages. </summary>
+	/// <remarks> Thread safe. Slices may outlive the pool, their buffers are freed instead of recycled then. </remarks>
+	class MessageBufferPool
+	{
+		friend class MessageSlice;
+
+	public:
+		static constexpr uint32_t MaxPooledSize = 64 * 1024; // Bigger buffers are not kept.
+		static constexpr size_t MaxPooledCount = 1024;
+
+	public:
+		MessageBufferPool();
+		~MessageBufferPool();
+
+		MessageBufferPool(const MessageBufferPool&) = delete;
+		MessageBufferPool &operator=(const MessageBufferPool&) = delete;
+
+		/// <summary> Returns a slice of exactly size bytes, the contents are undefined. </summary>
+		MessageSlice Acquire(uint32_t size);
+
+		size_t GetFreeCount() const;
+
+	private:
+		struct FreeList;
+		std::shared_ptr<FreeList> m_freeList;
+	};
+}
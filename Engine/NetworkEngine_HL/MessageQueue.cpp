@@ -1,52 +1,74 @@
 #include "MessageQueue.hpp"
 
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <iterator>
+
 namespace inl::net
 {
+	template <class T>
+	static size_t DequeueAll(moodycamel::ConcurrentQueue<T> &queue, std::vector<T> &items)
+	{
+		size_t total = 0;
+		size_t count;
+		do
+		{
+			count = queue.try_dequeue_bulk(std::back_inserter(items), MessageQueue::BulkSize);
+			total += count;
+		} while (count == MessageQueue::BulkSize);
+		return total;
+	}
+
 	void MessageQueue::EnqueueMessageToSend(const NetworkMessage & msg)
 	{
-		m_sendMutex.lock();
-		m_messagesToSend.emplace_back(msg);
-		m_sendMutex.unlock();
+		m_messagesToSend.enqueue(msg);
 	}
 
 	void MessageQueue::EnqueueMessageReceived(const NetworkMessage & msg)
 	{
-		m_receivedMutex.lock();
-		DataReceivedEvent ev(msg);
-		m_dataReceivedEvents.push_back(ev);
-		m_receivedMutex.unlock();
+		m_dataReceivedEvents.enqueue(DataReceivedEvent(msg));
 	}
 
 	void MessageQueue::EnqueueDisconnection(const NetworkMessage & msg)
 	{
-		m_disconnectMutex.lock();
-		//std::unique_ptr<DisconnectedEvent> ev(((NetworkMessage)msg).GetData<DisconnectedEvent>());
-		//m_disconnectedEvents.push_back(*(ev.get()));
-		m_disconnectMutex.unlock();
+		m_disconnectedEvents.enqueue(DisconnectedEvent(msg.GetSenderID(), "Disconnected", 0));
 	}
 
 	void MessageQueue::EnqueueConnection(const NetworkMessage & msg)
 	{
-		m_connectionMutex.lock();
-		NewConnectionEvent ev(msg.GetSenderID(), msg.GetData<void>());
-		m_connectionEvents.push_back(ev);
-		m_connectionMutex.unlock();
+		m_connectionEvents.enqueue(NewConnectionEvent(msg.GetSenderID(), msg.GetData<void>()));
 	}
 
 	NetworkMessage MessageQueue::DequeueMessageToSend()
 	{
-		m_sendMutex.lock();
-		NetworkMessage msg = m_messagesToSend.front();
-		m_messagesToSend.erase(m_messagesToSend.begin() + 1);
-		m_sendMutex.unlock();
+		NetworkMessage msg;
+		if (!m_messagesToSend.try_dequeue(msg))
+			throw InvalidCallException("There are no messages to send.");
 		return msg;
 	}
 
+	void MessageQueue::DequeueMessagesToSend(std::vector<NetworkMessage> &messages)
+	{
+		DequeueAll(m_messagesToSend, messages);
+	}
+
+	size_t MessageQueue::DequeueMessagesReceived(std::vector<DataReceivedEvent> &events)
+	{
+		return DequeueAll(m_dataReceivedEvents, events);
+	}
+
+	size_t MessageQueue::DequeueDisconnections(std::vector<DisconnectedEvent> &events)
+	{
+		return DequeueAll(m_disconnectedEvents, events);
+	}
+
+	size_t MessageQueue::DequeueConnections(std::vector<NewConnectionEvent> &events)
+	{
+		return DequeueAll(m_connectionEvents, events);
+	}
+
 	uint32_t MessageQueue::SendSize()
 	{
-		m_sendMutex.lock();
-		uint32_t size = m_messagesToSend.size();
-		m_sendMutex.unlock();
-		return size;
+		return (uint32_t)m_messagesToSend.size_approx();
 	}
-}
\ No newline at end of file
+}
@@ -1,7 +1,8 @@
 #pragma once
 
-#include <queue>
-#include <mutex>
+#include <vector>
+
+#include <moodycamel/concurrentqueue.h>
 
 #include "NetworkMessage.hpp"
 
@@ -13,8 +14,18 @@ namespace inl::net
 {
 	using namespace events;
 
+	/// <summary> Passes messages and events between the network threads and the game thread. </summary>
+	/// <remarks>
+	/// The queues are lock-free, any thread can enqueue and dequeue. Messages of one producer thread
+	/// stay in order, there is no order between the ones of different threads.
+	/// The Dequeue methods that take a vector drain in blocks of <see cref="BulkSize"/>,
+	/// so that everything pending can be processed with one call per tick.
+	/// </remarks>
 	class MessageQueue
 	{
+	public:
+		static constexpr size_t BulkSize = 64;
+
 	public:
 		MessageQueue()
 		{
@@ -26,20 +37,25 @@ namespace inl::net
 		void EnqueueDisconnection(const NetworkMessage &msg);
 		void EnqueueConnection(const NetworkMessage &msg);
 
+		/// <exception cref="InvalidCallException"> If there is no message to send. </exception>
 		NetworkMessage DequeueMessageToSend();
+		/// <summary> Moves all messages waiting to be sent to the end of messages. </summary>
+		void DequeueMessagesToSend(std::vector<NetworkMessage> &messages);
 
+		/// <summary> Moves the pending events to the end of events. </summary>
+		/// <returns> The number of events moved. </returns>
+		size_t DequeueMessagesReceived(std::vector<DataReceivedEvent> &events);
+		size_t DequeueDisconnections(std::vector<DisconnectedEvent> &events);
+		size_t DequeueConnections(std::vector<NewConnectionEvent> &events);
+
+		/// <summary> Approximate, other threads may be adding or taking messages. </summary>
 		uint32_t SendSize();
 
 	private:
-		std::deque<NetworkMessage> m_messagesToSend;
-
-		std::deque<NewConnectionEvent> m_connectionEvents;
-		std::deque<DisconnectedEvent> m_disconnectedEvents;
-		std::deque<DataReceivedEvent> m_dataReceivedEvents;
+		moodycamel::ConcurrentQueue<NetworkMessage> m_messagesToSend;
 
-		std::mutex m_sendMutex;
-		std::mutex m_receivedMutex;
-		std::mutex m_disconnectMutex;
-		std::mutex m_connectionMutex;
+		moodycamel::ConcurrentQueue<NewConnectionEvent> m_connectionEvents;
+		moodycamel::ConcurrentQueue<DisconnectedEvent> m_disconnectedEvents;
+		moodycamel::ConcurrentQueue<DataReceivedEvent> m_dataReceivedEvents;
 	};
-}
\ No newline at end of file
+}
@@ -6,7 +6,11 @@ namespace inl::net
 {
 	class NetworkHeader
 	{
+	public:
+		static constexpr uint32_t CompressedFlag = 1; // The data is compressed, see FrameCompression.
+
 	public:
 		uint32_t Size;
+		uint32_t Flags = 0;
 	};
 }
\ No newline at end of file
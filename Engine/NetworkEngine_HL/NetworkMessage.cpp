@@ -1,5 +1,7 @@
 #include "NetworkMessage.hpp"
 
+#include <BaseLibrary/Exception/Exception.hpp>
+
 namespace inl::net
 {
 	uint32_t NetworkMessage::GetSenderID() const
@@ -22,42 +24,74 @@ namespace inl::net
 		return m_tag;
 	}
 
-	uint8_t *NetworkMessage::SerializeData(uint32_t &size)
+	uint32_t NetworkMessage::GetDataSize() const
 	{
-		int32_t sizeOfNetHeader = sizeof(NetworkHeader);
+		return m_dataSize;
+	}
 
-		NetworkHeader header;
-		header.Size = 13 + sizeOfNetHeader + m_dataSize;
+	const MessageSlice &NetworkMessage::GetFrame() const
+	{
+		return m_frame;
+	}
 
-		uint8_t *bytes = new uint8_t[header.Size];
-		memcpy(bytes, &header, sizeOfNetHeader);
+	void NetworkMessage::WriteFrame(uint8_t *bytes, uint32_t dataSize) const
+	{
+		uint32_t sizeOfNetHeader = sizeof(NetworkHeader);
 
-		uint8_t *sender = BitConverter::ToBytes<uint32_t>(m_senderID); // 4
-		uint8_t *destination = BitConverter::ToBytes<uint32_t>(m_destinationID); // 4
-		uint8_t *tag = BitConverter::ToBytes<uint32_t>(m_tag); // 4
+		NetworkHeader header;
+		header.Size = FrameOverhead + dataSize;
 
-		memcpy(bytes + sizeOfNetHeader, sender, 4);
+		memcpy(bytes, &header, sizeOfNetHeader);
+		memcpy(bytes + sizeOfNetHeader, &m_senderID, 4);
 		bytes[sizeOfNetHeader + 4] = (uint8_t)m_distributionMode;
-		memcpy(bytes + sizeOfNetHeader + 5, destination, 4);
-		memcpy(bytes + sizeOfNetHeader + 9, tag, 4);
+		memcpy(bytes + sizeOfNetHeader + 5, &m_destinationID, 4);
+		memcpy(bytes + sizeOfNetHeader + 9, &m_tag, 4);
 
-		memcpy(bytes + 13 + sizeOfNetHeader, m_data, m_dataSize);
+		if (dataSize > 0)
+			memcpy(bytes + FrameOverhead, m_data, dataSize);
+	}
 
-		size = header.Size;
+	uint8_t *NetworkMessage::SerializeData(uint32_t &size)
+	{
+		size = FrameOverhead + m_dataSize;
+		uint8_t *bytes = new uint8_t[size];
+		WriteFrame(bytes, m_dataSize);
 		return bytes;
 	}
 
 	void NetworkMessage::Deserialize(uint8_t *data, uint32_t size)
 	{
-		NetworkHeader buffer;
 		uint32_t sizeOfNetHeader = sizeof(NetworkHeader);
-		memcpy(&(buffer), data, sizeOfNetHeader);
 
-		memcpy(&(m_senderID), data, 4 + sizeOfNetHeader);
+		memcpy(&(m_senderID), data + sizeOfNetHeader, 4);
 		m_distributionMode = (DistributionMode)data[4 + sizeOfNetHeader];
-		memcpy(&(m_destinationID), data + 5 + sizeOfNetHeader, 4 + sizeOfNetHeader);
-		memcpy(&(m_tag), data + 9 + sizeOfNetHeader, 4 + sizeOfNetHeader);
+		memcpy(&(m_destinationID), data + 5 + sizeOfNetHeader, 4);
+		memcpy(&(m_tag), data + 9 + sizeOfNetHeader, 4);
+
+		m_data = data + FrameOverhead;
+		m_dataSize = size > FrameOverhead ? size - FrameOverhead : 0;
+		m_frame = MessageSlice();
+	}
+
+	MessageSlice NetworkMessage::Serialize(MessageBufferPool &pool) const
+	{
+		MessageSlice frame = pool.Acquire(FrameOverhead + m_dataSize);
+		WriteFrame(frame.Data(), m_dataSize);
+		return frame;
+	}
+
+	void NetworkMessage::Deserialize(MessageSlice frame)
+	{
+		NetworkHeader header;
+		if (frame.Size() < FrameOverhead)
+			throw InvalidArgumentException("Frame is shorter than a message header.");
+		memcpy(&header, frame.Data(), sizeof(NetworkHeader));
+		if (header.Size < FrameOverhead || header.Size > frame.Size())
+			throw InvalidArgumentException("Frame is shorter than its header says.");
+		if (header.Flags & NetworkHeader::CompressedFlag)
+			throw InvalidArgumentException("Frame is compressed, it has to be decompressed first.");
 
-		m_data = data + 13 + sizeOfNetHeader;
+		Deserialize(frame.Data(), header.Size);
+		m_frame = std::move(frame);
 	}
-}
\ No newline at end of file
+}
@@ -1,10 +1,11 @@
 #pragma once
 
 #include "NetworkHeader.hpp"
-#include "BitConverter.hpp"
+#include "MessageBuffer.hpp"
 
 #include <cstdint>
 #include <cstring>
+#include <utility>
 
 namespace inl::net
 {
@@ -20,6 +21,10 @@ namespace inl::net
 
 	class NetworkMessage
 	{
+	public:
+		/// <summary> Bytes of a serialized message before its data: header, sender, mode, destination and tag. </summary>
+		static constexpr uint32_t FrameOverhead = sizeof(NetworkHeader) + 13;
+
 	public:
 		NetworkMessage()
 		{
@@ -35,10 +40,29 @@ namespace inl::net
 		{
 		}
 
+		/// <summary> The message keeps the slice, so the data stays valid until the message is sent,
+		///		e.g. the data of a received frame passed on to other clients. </summary>
+		NetworkMessage(uint32_t sender, DistributionMode mode, uint32_t destinationId, uint32_t tag, MessageSlice data)
+			: m_senderID(sender)
+			, m_distributionMode(mode)
+			, m_destinationID(destinationId)
+			, m_tag(tag)
+			, m_data(data.Data())
+			, m_dataSize(data.Size())
+			, m_frame(std::move(data))
+		{
+		}
+
 		uint32_t GetSenderID() const;
 		DistributionMode GetDistributionMode() const;
 		uint32_t GetDestinationID() const;
 		uint32_t GetTag() const;
+		uint32_t GetDataSize() const;
+		/// <summary> The pooled buffer the data points into, empty if the message was neither deserialized from nor made with a slice. </summary>
+		const MessageSlice &GetFrame() const;
+
+	private:
+		void WriteFrame(uint8_t *bytes, uint32_t dataSize) const;
 
 	private:
 		uint32_t m_senderID;
@@ -48,6 +72,8 @@ namespace inl::net
 
 		void *m_data;
 		uint32_t m_dataSize;
+
+		MessageSlice m_frame;
 	
 	public:
 		template<typename T>
@@ -60,32 +86,21 @@ namespace inl::net
 		template<typename T>
 		uint8_t * SerializeData(uint32_t &size)
 		{
-			int32_t sizeOfNetHeader = sizeof(NetworkHeader);
-
-			NetworkHeader header;
-			header.Size = 13 + sizeOfNetHeader + sizeof(T);
-
-			uint8_t *bytes = new uint8_t[header.Size];
-			memcpy(bytes, &header, sizeOfNetHeader);
-
-			uint8_t *sender = BitConverter::ToBytes<uint32_t>(m_senderID); // 4
-			uint8_t *destination = BitConverter::ToBytes<uint32_t>(m_destinationID); // 4
-			uint8_t *tag = BitConverter::ToBytes<uint32_t>(m_tag); // 4
-
-			memcpy(bytes + sizeOfNetHeader, sender, 4);
-			bytes[sizeOfNetHeader + 4] = (uint8_t)m_distributionMode;
-			memcpy(bytes + sizeOfNetHeader + 5, destination, 4);
-			memcpy(bytes + sizeOfNetHeader + 9, tag, 4);
-
-			memcpy(bytes + 13 + sizeOfNetHeader, m_data, sizeof(T));
-
-			size = header.Size;
+			size = FrameOverhead + sizeof(T);
+			uint8_t *bytes = new uint8_t[size];
+			WriteFrame(bytes, sizeof(T));
 			return bytes;
 		}
 
 		uint8_t *SerializeData(uint32_t &size);
 		void Deserialize(uint8_t *data, uint32_t size);
 
+		/// <summary> Writes the message into one buffer taken from the pool. </summary>
+		MessageSlice Serialize(MessageBufferPool &pool) const;
+		/// <summary> Parses a received frame in place, the data keeps pointing into the frame. </summary>
+		/// <exception cref="InvalidArgumentException"> If the frame is shorter than its header says, or still compressed. </exception>
+		void Deserialize(MessageSlice frame);
+
 		template<typename T>
 		T *GetData() const
 		{
@@ -0,0 +1,41 @@
+#include "NetworkStats.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace inl::net
+{
+	std::string ServerStats::Format(const ServerStats *previous) const
+	{
+		ServerStats zero;
+		const ServerStats &base = previous ? *previous : zero;
+		double seconds = previous ? std::chrono::duration<double>(time - previous->time).count() : 0.0;
+		auto rate = [seconds](uint64_t current, uint64_t before) {
+			return seconds > 0.0 ? (current - before) / seconds : 0.0;
+		};
+
+		size_t queued = 0;
+		size_t high_water = 0;
+		float max_rtt = -1.0f;
+		for (const ConnectionStats &c : connections)
+		{
+			queued += c.sendQueueBytes;
+			high_water = std::max(high_water, c.sendQueueHighWater);
+			max_rtt = std::max(max_rtt, c.roundTripTime);
+		}
+
+		uint64_t loops = pollLoops - base.pollLoops;
+		double loop_average = loops > 0 ? double((pollLoopTime - base.pollLoopTime).count()) / loops : 0.0;
+
+		std::stringstream ss;
+		ss << "connections " << connections.size()
+		   << " | in " << bytesIn << " B (" << rate(bytesIn, base.bytesIn) << " B/s), " << messagesIn << " msg"
+		   << " | out " << bytesOut << " B (" << rate(bytesOut, base.bytesOut) << " B/s), " << messagesOut << " msg"
+		   << " | queued " << queued << " B, high water " << high_water << " B, dropped " << droppedFrames
+		   << " | accepted " << accepted << " (" << rate(accepted, base.accepted) << "/s), rejected " << rejected
+		   << " | poll loop avg " << loop_average << " us, max " << pollLoopMax.count() << " us";
+		if (max_rtt >= 0.0f)
+			ss << " | max rtt " << max_rtt << " ms";
+		return ss.str();
+	}
+}
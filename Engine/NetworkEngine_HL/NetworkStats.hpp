@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace inl::net
+{
+	enum class Transport : uint8_t
+	{
+		Tcp,
+		Udp
+	};
+
+	struct ConnectionStats
+	{
+		uint32_t id = 0;
+		Transport transport = Transport::Tcp;
+
+		uint64_t bytesIn = 0;
+		uint64_t bytesOut = 0;
+		uint64_t messagesIn = 0;
+		uint64_t messagesOut = 0;
+
+		size_t sendQueueBytes = 0; // Waiting to be sent, or to be acked for reliable UDP.
+		size_t sendQueueHighWater = 0;
+
+		float roundTripTime = -1.0f; // Milliseconds, negative if the transport does not measure it.
+		float packetLoss = -1.0f;
+	};
+
+	/// <summary> Counters of a server since it was created. Rates come from the difference of two snapshots. </summary>
+	struct ServerStats
+	{
+		std::chrono::steady_clock::time_point time;
+		std::vector<ConnectionStats> connections;
+
+		// Summed over the connections, including the ones that are gone.
+		uint64_t bytesIn = 0;
+		uint64_t bytesOut = 0;
+		uint64_t messagesIn = 0;
+		uint64_t messagesOut = 0;
+
+		uint64_t accepted = 0;
+		uint64_t rejected = 0; // Server was full.
+		uint64_t droppedFrames = 0;
+
+		// Time spent handling ready sockets in the TCP poll loop, without the wait. The max is since creation too.
+		uint64_t pollLoops = 0;
+		std::chrono::microseconds pollLoopTime = std::chrono::microseconds(0);
+		std::chrono::microseconds pollLoopMax = std::chrono::microseconds(0);
+
+		/// <summary> One line of totals and rates since the previous snapshot, or since creation if there is none. </summary>
+		std::string Format(const ServerStats *previous = nullptr) const;
+	};
+
+	/// <summary> Counters updated by the network threads and read by snapshots from any thread. </summary>
+	class ConnectionCounters
+	{
+	public:
+		void Received(size_t bytes)
+		{
+			m_bytesIn.fetch_add(bytes, std::memory_order_relaxed);
+			m_messagesIn.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void Sent(size_t bytes, size_t messages)
+		{
+			m_bytesOut.fetch_add(bytes, std::memory_order_relaxed);
+			m_messagesOut.fetch_add(messages, std::memory_order_relaxed);
+		}
+
+		void SetQueueBytes(size_t bytes)
+		{
+			m_queueBytes.store(bytes, std::memory_order_relaxed);
+			if (bytes > m_queueHighWater.load(std::memory_order_relaxed))
+				m_queueHighWater.store(bytes, std::memory_order_relaxed); // Only the sending thread writes it.
+		}
+
+		void Fill(ConnectionStats &stats) const
+		{
+			stats.bytesIn = m_bytesIn.load(std::memory_order_relaxed);
+			stats.bytesOut = m_bytesOut.load(std::memory_order_relaxed);
+			stats.messagesIn = m_messagesIn.load(std::memory_order_relaxed);
+			stats.messagesOut = m_messagesOut.load(std::memory_order_relaxed);
+			stats.sendQueueBytes = m_queueBytes.load(std::memory_order_relaxed);
+			stats.sendQueueHighWater = m_queueHighWater.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<uint64_t> m_bytesIn = 0;
+		std::atomic<uint64_t> m_bytesOut = 0;
+		std::atomic<uint64_t> m_messagesIn = 0;
+		std::atomic<uint64_t> m_messagesOut = 0;
+		std::atomic<size_t> m_queueBytes = 0;
+		std::atomic<size_t> m_queueHighWater = 0;
+	};
+}
@@ -15,6 +15,9 @@ namespace inl::net::events
 		{
 		}
 
+		inline uint32_t GetID() const { return m_id; }
+		inline void *GetData() const { return m_data; }
+
 	private:
 		uint32_t m_id;
 		void *m_data;
@@ -1,25 +1,84 @@
 #include "Server.hpp"
 
+#include <BaseLibrary/Logging/LogStream.hpp>
+
 #include "MessageQueue.hpp"
+#include "TcpConnectionHandler.hpp"
 #include "TcpServer.hpp"
-//#include "UdpServer.hpp
+#include "UdpServer.hpp"
 
 namespace inl::net
 {
 	Server::Server(uint32_t max_connections, uint16_t port)
+		: m_statsInterval(10)
 	{
 		m_tcpServer = std::make_shared<inl::net::servers::TcpServer>(max_connections, port);
 		m_queue = std::make_shared<MessageQueue>();
-		//m_tcpServer->m_connectionHandler->m_queue = m_queue;
+		m_udpServer = std::make_shared<inl::net::servers::UdpServer>(max_connections, port, m_queue);
+		m_tcpServer->m_connectionHandler->m_queue = m_queue;
+	}
+
+	Server::~Server()
+	{
+		Stop();
 	}
 
 	void Server::Start()
 	{
 		m_tcpServer->Start();
+		m_udpServer->Start();
+
+		if (m_statsLog && !m_statsThread.joinable())
+		{
+			m_statsRun = true;
+			m_statsThread = std::thread(&Server::LogStatsThreaded, this);
+		}
 	}
 
 	void Server::Stop()
 	{
 		m_tcpServer->Stop();
+		m_udpServer->Stop();
+
+		{
+			std::lock_guard<std::mutex> lock(m_statsMutex);
+			m_statsRun = false;
+		}
+		m_statsWake.notify_all();
+		if (m_statsThread.joinable())
+			m_statsThread.join();
+	}
+
+	std::shared_ptr<MessageQueue> Server::GetQueue()
+	{
+		return m_queue;
+	}
+
+	ServerStats Server::GetStats()
+	{
+		ServerStats stats;
+		stats.time = std::chrono::steady_clock::now();
+		m_tcpServer->m_connectionHandler->GetStats(stats);
+		m_udpServer->GetStats(stats);
+		return stats;
+	}
+
+	void Server::SetStatsLog(LogStream *log_stream, std::chrono::seconds interval)
+	{
+		m_statsLog = log_stream;
+		m_statsInterval = interval;
+	}
+
+	void Server::LogStatsThreaded()
+	{
+		ServerStats previous = GetStats();
+
+		std::unique_lock<std::mutex> lock(m_statsMutex);
+		while (!m_statsWake.wait_for(lock, m_statsInterval, [this] { return !m_statsRun; }))
+		{
+			ServerStats current = GetStats();
+			m_statsLog->Event(LogEvent("Network stats: " + current.Format(&previous), eEventType::INFO));
+			previous = std::move(current);
+		}
 	}
-}
\ No newline at end of file
+}
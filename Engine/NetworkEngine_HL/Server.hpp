@@ -2,13 +2,25 @@
 
 #include <NetworkEngine_LL/Net.hpp>
 
+#include "NetworkStats.hpp"
+
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
+
+namespace inl
+{
+	class LogStream;
+}
 
 namespace inl::net
 {
 	namespace servers
 	{
 		class TcpServer;
+		class UdpServer;
 	}
 
 	class MessageQueue;
@@ -17,13 +29,35 @@ namespace inl::net
 	{
 	public:
 		Server(uint32_t max_connections = 20, uint16_t port = DEFAULT_SERVER_PORT);
+		~Server();
 
 		void Start();
 		void Stop();
 
+		/// <summary> Received messages and events of both transports come out of the queue, messages to send go into it. </summary>
+		std::shared_ptr<MessageQueue> GetQueue();
+
+		/// <summary> Counters of both transports since the server was created, safe to call from any thread. </summary>
+		ServerStats GetStats();
+
+		/// <summary> Logs a line of stats every interval while the server runs, or nothing if log_stream is null. </summary>
+		/// <remarks> Takes effect with the next Start. The stream must outlive the server or the next call. </remarks>
+		void SetStatsLog(LogStream *log_stream, std::chrono::seconds interval = std::chrono::seconds(10));
+
+	private:
+		void LogStatsThreaded();
+
 	private:
 		std::shared_ptr<inl::net::servers::TcpServer> m_tcpServer;
+		std::shared_ptr<inl::net::servers::UdpServer> m_udpServer;
 
 		std::shared_ptr<MessageQueue> m_queue;
+
+		LogStream *m_statsLog = nullptr;
+		std::chrono::seconds m_statsInterval;
+		std::thread m_statsThread;
+		std::mutex m_statsMutex;
+		std::condition_variable m_statsWake;
+		bool m_statsRun = false; // Guarded by m_statsMutex.
 	};
-}
\ No newline at end of file
+}
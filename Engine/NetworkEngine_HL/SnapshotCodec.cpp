@@ -0,0 +1,171 @@
+#include "SnapshotCodec.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace inl::net
+{
+	static constexpr float MaxSmallComponent = 0.70710678f; // 1/sqrt(2), the others of a unit quaternion are not bigger.
+	static constexpr uint32_t MaxRotationStep = (1u << SnapshotCodec::RotationComponentBits) - 1;
+	static constexpr int32_t SmallDeltaLimit = 1 << (SnapshotCodec::SmallDeltaBits - 1);
+
+	bool QuantizedTransform::operator==(const QuantizedTransform &other) const
+	{
+		return position[0] == other.position[0] && position[1] == other.position[1] && position[2] == other.position[2] && rotation == other.rotation;
+	}
+
+	bool QuantizedTransform::operator!=(const QuantizedTransform &other) const
+	{
+		return !(*this == other);
+	}
+
+	SnapshotCodec::SnapshotCodec(float world_extent, float position_resolution)
+		: m_worldExtent(world_extent)
+		, m_resolution(position_resolution)
+	{
+		if (world_extent <= 0.0f || position_resolution <= 0.0f)
+			throw InvalidArgumentException("Extent and resolution must be positive.");
+
+		double steps = std::ceil(2.0 * world_extent / position_resolution);
+		m_positionBits = 1;
+		while (m_positionBits < 32 && double(1ull << m_positionBits) <= steps)
+			m_positionBits++;
+		if (m_positionBits > 31)
+			throw InvalidArgumentException("Too many position steps for the world extent.", std::to_string(steps));
+		m_maxPosition = (1u << m_positionBits) - 1;
+	}
+
+	QuantizedTransform SnapshotCodec::Quantize(const EntityTransform &transform) const
+	{
+		QuantizedTransform result;
+		for (int i = 0; i < 3; i++)
+		{
+			float step = std::round((transform.position[i] + m_worldExtent) / m_resolution);
+			result.position[i] = (uint32_t)std::clamp(step, 0.0f, (float)m_maxPosition);
+		}
+
+		float q[4];
+		float length = 0.0f;
+		for (int i = 0; i < 4; i++)
+			length += transform.rotation[i] * transform.rotation[i];
+		length = std::sqrt(length);
+		for (int i = 0; i < 4; i++)
+			q[i] = length > 0.0f ? transform.rotation[i] / length : (i == 3 ? 1.0f : 0.0f);
+
+		uint32_t largest = 0;
+		for (uint32_t i = 1; i < 4; i++)
+		{
+			if (std::abs(q[i]) > std::abs(q[largest]))
+				largest = i;
+		}
+		// q and -q are the same rotation, the dropped component is made positive.
+		float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+		result.rotation = largest;
+		uint32_t shift = 2;
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			if (i == largest)
+				continue;
+			float normalized = (sign * q[i] / MaxSmallComponent + 1.0f) * 0.5f;
+			uint32_t step = (uint32_t)std::clamp(std::round(normalized * MaxRotationStep), 0.0f, (float)MaxRotationStep);
+			result.rotation |= step << shift;
+			shift += RotationComponentBits;
+		}
+		return result;
+	}
+
+	EntityTransform SnapshotCodec::Dequantize(const QuantizedTransform &transform) const
+	{
+		EntityTransform result;
+		for (int i = 0; i < 3; i++)
+			result.position[i] = transform.position[i] * m_resolution - m_worldExtent;
+
+		uint32_t largest = transform.rotation & 3;
+		uint32_t shift = 2;
+		float sum = 0.0f;
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			if (i == largest)
+				continue;
+			uint32_t step = (transform.rotation >> shift) & MaxRotationStep;
+			result.rotation[i] = (step / float(MaxRotationStep) * 2.0f - 1.0f) * MaxSmallComponent;
+			sum += result.rotation[i] * result.rotation[i];
+			shift += RotationComponentBits;
+		}
+		result.rotation[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+		return result;
+	}
+
+	void SnapshotCodec::Write(BitWriter &writer, const QuantizedTransform &value, const QuantizedTransform *baseline) const
+	{
+		if (!baseline)
+		{
+			for (int i = 0; i < 3; i++)
+				writer.Write(value.position[i], m_positionBits);
+			writer.Write(value.rotation, 32);
+			return;
+		}
+
+		for (int i = 0; i < 3; i++)
+		{
+			bool changed = value.position[i] != baseline->position[i];
+			writer.WriteBool(changed);
+			if (!changed)
+				continue;
+
+			int64_t delta = int64_t(value.position[i]) - int64_t(baseline->position[i]);
+			bool small = delta >= -SmallDeltaLimit && delta < SmallDeltaLimit;
+			writer.WriteBool(small);
+			if (small)
+				writer.Write(uint32_t(delta + SmallDeltaLimit), SmallDeltaBits);
+			else
+				writer.Write(value.position[i], m_positionBits);
+		}
+
+		bool rotated = value.rotation != baseline->rotation;
+		writer.WriteBool(rotated);
+		if (rotated)
+			writer.Write(value.rotation, 32);
+	}
+
+	bool SnapshotCodec::Read(BitReader &reader, bool hasBaseline, const QuantizedTransform *baseline, QuantizedTransform &value) const
+	{
+		if (!hasBaseline)
+		{
+			for (int i = 0; i < 3; i++)
+				value.position[i] = reader.Read(m_positionBits);
+			value.rotation = reader.Read(32);
+			return true;
+		}
+
+		QuantizedTransform result = baseline ? *baseline : QuantizedTransform{};
+		for (int i = 0; i < 3; i++)
+		{
+			if (!reader.ReadBool())
+				continue;
+
+			if (reader.ReadBool())
+			{
+				int64_t delta = int64_t(reader.Read(SmallDeltaBits)) - SmallDeltaLimit;
+				result.position[i] = uint32_t(std::clamp<int64_t>(int64_t(result.position[i]) + delta, 0, m_maxPosition));
+			}
+			else
+				result.position[i] = reader.Read(m_positionBits);
+		}
+		if (reader.ReadBool())
+			result.rotation = reader.Read(32);
+
+		if (!baseline)
+			return false;
+		value = result;
+		return true;
+	}
+
+	uint32_t SnapshotCodec::GetPositionBits() const
+	{
+		return m_positionBits;
+	}
+}
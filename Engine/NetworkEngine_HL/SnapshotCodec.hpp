@@ -0,0 +1,60 @@
+#pragma once
+
+#include "BitStream.hpp"
+
+#include <cstdint>
+
+namespace inl::net
+{
+	struct EntityTransform
+	{
+		float position[3] = { 0, 0, 0 };
+		float rotation[4] = { 0, 0, 0, 1 }; // Quaternion as x, y, z, w.
+	};
+
+	/// <summary> A transform on the grid of the codec. Two of them are equal if they look the same to the client. </summary>
+	struct QuantizedTransform
+	{
+		uint32_t position[3] = { 0, 0, 0 };
+		uint32_t rotation = 0; // Smallest three: index of the largest component, then the other three.
+
+		bool operator==(const QuantizedTransform &other) const;
+		bool operator!=(const QuantizedTransform &other) const;
+	};
+
+	/// <summary> Quantizes transforms and writes them as deltas, shared by the two ends of the replication. </summary>
+	/// <remarks>
+	/// Positions are fixed point within [-world_extent, world_extent]. Rotations keep the three smallest components
+	/// of the quaternion with <see cref="RotationComponentBits"/> each.
+	/// Against a baseline, only the changed fields are written, and a position component that moved less than
+	/// half of 2^<see cref="SmallDeltaBits"/> steps is written as the difference.
+	/// </remarks>
+	class SnapshotCodec
+	{
+	public:
+		static constexpr uint32_t RotationComponentBits = 10;
+		static constexpr uint32_t SmallDeltaBits = 8;
+
+	public:
+		/// <exception cref="InvalidArgumentException"> If the extent needs more than 31 bits at the resolution. </exception>
+		SnapshotCodec(float world_extent = 4096.0f, float position_resolution = 1.0f / 256.0f);
+
+		QuantizedTransform Quantize(const EntityTransform &transform) const;
+		EntityTransform Dequantize(const QuantizedTransform &transform) const;
+
+		/// <param name="baseline"> The state the reader has, or null to write every field in full. </param>
+		void Write(BitWriter &writer, const QuantizedTransform &value, const QuantizedTransform *baseline) const;
+		/// <summary> Reads what <see cref="Write"/> wrote. </summary>
+		/// <param name="hasBaseline"> Whether the writer used a baseline, the fields are read even if the reader does not have it. </param>
+		/// <returns> False if the value could not be restored because baseline is null. </returns>
+		bool Read(BitReader &reader, bool hasBaseline, const QuantizedTransform *baseline, QuantizedTransform &value) const;
+
+		uint32_t GetPositionBits() const;
+
+	private:
+		float m_worldExtent;
+		float m_resolution;
+		uint32_t m_positionBits;
+		uint32_t m_maxPosition;
+	};
+}
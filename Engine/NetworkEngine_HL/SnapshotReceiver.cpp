@@ -0,0 +1,104 @@
+#include "SnapshotReceiver.hpp"
+
+#include "UdpConnection.hpp"
+
+#include <algorithm>
+
+namespace inl::net
+{
+	SnapshotReceiver::SnapshotReceiver(SnapshotCodec codec)
+		: m_codec(codec)
+	{
+	}
+
+	bool SnapshotReceiver::ReadPacket(const uint8_t *data, size_t size, uint16_t &sequence)
+	{
+		BitReader reader(data, size);
+		sequence = (uint16_t)reader.Read(16);
+
+		while (reader.ReadBool())
+		{
+			uint32_t entity = reader.ReadVarUint();
+			bool removed = reader.ReadBool();
+			if (reader.IsOverflowed())
+				return false;
+
+			std::vector<State> &history = m_history[entity];
+			if (removed)
+			{
+				Insert(history, State{ sequence, true, {} });
+				continue;
+			}
+
+			bool has_baseline = reader.ReadBool();
+			const State *baseline = nullptr;
+			if (has_baseline)
+			{
+				uint16_t baseline_sequence = uint16_t(sequence - reader.ReadVarUint());
+				baseline = FindState(history, baseline_sequence);
+
+				// The server only moves its baselines forward, older states are not needed.
+				if (baseline)
+				{
+					size_t first = baseline - history.data();
+					history.erase(history.begin(), history.begin() + first);
+					baseline = history.data();
+				}
+			}
+
+			QuantizedTransform value;
+			if (m_codec.Read(reader, has_baseline, baseline ? &baseline->value : nullptr, value))
+				Insert(history, State{ sequence, false, value });
+			else if (history.empty())
+				m_history.erase(entity);
+
+			if (reader.IsOverflowed())
+				return false;
+		}
+		return !reader.IsOverflowed();
+	}
+
+	bool SnapshotReceiver::GetTransform(uint32_t entity, EntityTransform &transform) const
+	{
+		auto it = m_history.find(entity);
+		if (it == m_history.end() || it->second.empty() || it->second.back().removed)
+			return false;
+		transform = m_codec.Dequantize(it->second.back().value);
+		return true;
+	}
+
+	std::vector<uint32_t> SnapshotReceiver::GetEntities() const
+	{
+		std::vector<uint32_t> entities;
+		for (auto &[entity, history] : m_history)
+		{
+			if (!history.empty() && !history.back().removed)
+				entities.push_back(entity);
+		}
+		return entities;
+	}
+
+	void SnapshotReceiver::Insert(std::vector<State> &history, const State &state)
+	{
+		auto it = std::find_if(history.begin(), history.end(), [&](const State &s) { return !UdpConnection::SequenceGreater(state.sequence, s.sequence); });
+		if (it != history.end() && it->sequence == state.sequence)
+			return; // Duplicate packet.
+		it = history.insert(it, state);
+
+		// Nothing is delta encoded against the states before a removal.
+		if (state.removed)
+			history.erase(history.begin(), it);
+		if (history.size() > MaxHistory)
+			history.erase(history.begin());
+	}
+
+	const SnapshotReceiver::State *SnapshotReceiver::FindState(const std::vector<State> &history, uint16_t sequence)
+	{
+		for (const State &state : history)
+		{
+			if (state.sequence == sequence)
+				return state.removed ? nullptr : &state;
+		}
+		return nullptr;
+	}
+}
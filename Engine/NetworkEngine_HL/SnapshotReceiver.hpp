@@ -0,0 +1,49 @@
+#pragma once
+
+#include "SnapshotCodec.hpp"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace inl::net
+{
+	/// <summary> Client side of the transform replication, applies the packets of <see cref="SnapshotReplicator"/>. </summary>
+	/// <remarks>
+	/// The last states received for each entity are kept, as the server writes deltas against the one the client
+	/// acknowledged, which may be older than the newest. The sequence of every applied packet has to be
+	/// passed back to the server's <see cref="SnapshotReplicator::Acknowledge"/>.
+	/// </remarks>
+	class SnapshotReceiver
+	{
+	public:
+		static constexpr size_t MaxHistory = 32; // States kept per entity.
+
+	public:
+		SnapshotReceiver(SnapshotCodec codec = {});
+
+		/// <summary> Applies a packet, packets can arrive in any order. </summary>
+		/// <param name="sequence"> The sequence of the packet, to be acknowledged. </param>
+		/// <returns> False if the packet is malformed. What was applied before the error stays applied. </returns>
+		bool ReadPacket(const uint8_t *data, size_t size, uint16_t &sequence);
+
+		/// <returns> False if the entity does not exist. </returns>
+		bool GetTransform(uint32_t entity, EntityTransform &transform) const;
+		std::vector<uint32_t> GetEntities() const;
+
+	private:
+		struct State
+		{
+			uint16_t sequence;
+			bool removed;
+			QuantizedTransform value;
+		};
+
+		void Insert(std::vector<State> &history, const State &state);
+		static const State *FindState(const std::vector<State> &history, uint16_t sequence);
+
+	private:
+		SnapshotCodec m_codec;
+		std::unordered_map<uint32_t, std::vector<State>> m_history; // Oldest first, the last one is current.
+	};
+}
@@ -0,0 +1,197 @@
+#include "SnapshotReplicator.hpp"
+
+#include "UdpConnection.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+
+namespace inl::net
+{
+	static constexpr uint32_t SequenceBits = 16;
+	static constexpr uint32_t TerminatorBits = 1;
+
+	SnapshotReplicator::SnapshotReplicator(SnapshotCodec codec, uint32_t budget_bytes)
+		: m_codec(codec)
+		, m_budgetBits(budget_bytes * 8)
+	{
+		if (m_budgetBits <= SequenceBits + TerminatorBits)
+			throw InvalidArgumentException("Packet budget is too small.", std::to_string(budget_bytes));
+	}
+
+	void SnapshotReplicator::SetTransform(uint32_t entity, const EntityTransform &transform)
+	{
+		QuantizedTransform state = m_codec.Quantize(transform);
+
+		auto [it, inserted] = m_entities.insert({ entity, Entity{ state } });
+		if (!inserted)
+		{
+			if (it->second.state == state)
+				return; // Moved less than the clients can see.
+			it->second.state = state;
+		}
+
+		for (auto &[id, client] : m_clients)
+			client.candidates.insert({ entity, 0.0f });
+	}
+
+	void SnapshotReplicator::RemoveEntity(uint32_t entity)
+	{
+		if (m_entities.erase(entity) == 0)
+			return;
+
+		// Clients that might have it are told, even if it was not acknowledged yet.
+		for (auto &[id, client] : m_clients)
+			client.candidates.insert({ entity, 0.0f });
+	}
+
+	void SnapshotReplicator::SetPriority(uint32_t entity, float priority)
+	{
+		auto it = m_entities.find(entity);
+		if (it == m_entities.end())
+			throw InvalidArgumentException("Entity is not replicated.", std::to_string(entity));
+		it->second.priority = priority;
+	}
+
+	void SnapshotReplicator::AddClient(uint32_t client)
+	{
+		auto [it, inserted] = m_clients.insert({ client, Client{} });
+		if (!inserted)
+			throw InvalidArgumentException("Client is already added.", std::to_string(client));
+
+		it->second.candidates.reserve(m_entities.size());
+		for (auto &[entity, state] : m_entities)
+			it->second.candidates.insert({ entity, 0.0f });
+	}
+
+	void SnapshotReplicator::RemoveClient(uint32_t client)
+	{
+		m_clients.erase(client);
+	}
+
+	bool SnapshotReplicator::WritePacket(uint32_t client_id, std::vector<uint8_t> &packet)
+	{
+		Client &client = FindClient(client_id);
+
+		// Nothing refers to these any more, a new entity with the same ID is sent in full.
+		while (!client.removals.empty() && uint16_t(client.nextSequence - client.removals.front().first) >= SentPacketWindow)
+		{
+			auto it = client.baselines.find(client.removals.front().second);
+			if (it != client.baselines.end() && it->second.removed && it->second.sequence == client.removals.front().first)
+				client.baselines.erase(it);
+			client.removals.pop_front();
+		}
+
+		if (client.candidates.empty())
+			return false;
+
+		// Entities that waited the longest, weighted by their priority, are written first.
+		m_order.clear();
+		for (auto &[entity, accumulated] : client.candidates)
+		{
+			auto it = m_entities.find(entity);
+			accumulated += it != m_entities.end() ? it->second.priority : 1.0f;
+			m_order.push_back({ accumulated, entity });
+		}
+		std::sort(m_order.begin(), m_order.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+
+		uint16_t sequence = client.nextSequence++;
+		SentPacket &sent = client.sentPackets[sequence % SentPacketWindow];
+		sent.sequence = sequence;
+		sent.valid = true;
+		sent.entities.clear();
+
+		m_packetBits.Clear();
+		m_packetBits.Write(sequence, SequenceBits);
+
+		for (auto &[accumulated, entity] : m_order)
+		{
+			auto current = m_entities.find(entity);
+			bool removed = current == m_entities.end();
+
+			auto baseline = client.baselines.find(entity);
+			bool has_baseline = baseline != client.baselines.end() && !baseline->second.removed
+								&& uint16_t(sequence - baseline->second.sequence) <= MaxBaselineAge;
+
+			m_entityBits.Clear();
+			m_entityBits.WriteBool(true); // One more entity follows.
+			m_entityBits.WriteVarUint(entity);
+			m_entityBits.WriteBool(removed);
+			if (!removed)
+			{
+				m_entityBits.WriteBool(has_baseline);
+				if (has_baseline)
+					m_entityBits.WriteVarUint(uint16_t(sequence - baseline->second.sequence));
+				m_codec.Write(m_entityBits, current->second.state, has_baseline ? &baseline->second.state : nullptr);
+			}
+
+			if (m_packetBits.GetBitCount() + m_entityBits.GetBitCount() + TerminatorBits > m_budgetBits)
+				continue; // A smaller one might still fit.
+
+			m_packetBits.Append(m_entityBits);
+			sent.entities.push_back({ entity, removed, removed ? QuantizedTransform{} : current->second.state });
+			client.candidates[entity] = 0.0f;
+
+			if (m_budgetBits - m_packetBits.GetBitCount() < 32)
+				break;
+		}
+		m_packetBits.WriteBool(false);
+
+		packet = m_packetBits.GetBytes();
+		return true;
+	}
+
+	void SnapshotReplicator::Acknowledge(uint32_t client_id, uint16_t sequence)
+	{
+		auto client_it = m_clients.find(client_id);
+		if (client_it == m_clients.end())
+			return;
+		Client &client = client_it->second;
+
+		SentPacket &sent = client.sentPackets[sequence % SentPacketWindow];
+		if (!sent.valid || sent.sequence != sequence)
+			return; // Duplicate or too old.
+		sent.valid = false;
+
+		for (const SentEntity &entry : sent.entities)
+		{
+			auto [it, inserted] = client.baselines.insert({ entry.entity, Baseline{ sequence, entry.removed, entry.state } });
+			if (!inserted)
+			{
+				// Packets can be acknowledged out of order, the baseline only moves forward.
+				if (!UdpConnection::SequenceGreater(sequence, it->second.sequence))
+					continue;
+				it->second = Baseline{ sequence, entry.removed, entry.state };
+			}
+			if (entry.removed)
+				client.removals.push_back({ sequence, entry.entity });
+
+			if (IsAcknowledged(client, entry.entity))
+				client.candidates.erase(entry.entity);
+		}
+		sent.entities.clear();
+	}
+
+	size_t SnapshotReplicator::GetPendingCount(uint32_t client) const
+	{
+		auto it = m_clients.find(client);
+		return it != m_clients.end() ? it->second.candidates.size() : 0;
+	}
+
+	bool SnapshotReplicator::IsAcknowledged(const Client &client, uint32_t entity) const
+	{
+		auto baseline = client.baselines.find(entity);
+		auto current = m_entities.find(entity);
+		if (current == m_entities.end())
+			return baseline == client.baselines.end() || baseline->second.removed;
+		return baseline != client.baselines.end() && !baseline->second.removed && baseline->second.state == current->second.state;
+	}
+
+	SnapshotReplicator::Client &SnapshotReplicator::FindClient(uint32_t client)
+	{
+		auto it = m_clients.find(client);
+		if (it == m_clients.end())
+			throw InvalidArgumentException("Client is not added.", std::to_string(client));
+		return it->second;
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "BitStream.hpp"
+#include "SnapshotCodec.hpp"
+
+#include <array>
+#include <deque>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace inl::net
+{
+	/// <summary> Server side of the transform replication, writes one packet per client and tick. </summary>
+	/// <remarks>
+	/// Each client has its own baselines: the last state of every entity that the client acknowledged.
+	/// Only entities that differ from their baseline are candidates for a packet, and they are written as
+	/// deltas against it. Candidates accumulate their priority every tick they are not sent, the ones with
+	/// the most go first until the packet is full.
+	/// The packets are unreliable, what a lost one carried stays a candidate.
+	/// </remarks>
+	class SnapshotReplicator
+	{
+	public:
+		static constexpr size_t SentPacketWindow = 256; // Packets that can still be acknowledged.
+		static constexpr uint16_t MaxBaselineAge = 1024; // Older baselines are not referenced, the entity is sent in full.
+
+	public:
+		/// <param name="budget_bytes"> Maximum size of a packet. </param>
+		SnapshotReplicator(SnapshotCodec codec = {}, uint32_t budget_bytes = 1100);
+
+		/// <summary> Adds or moves an entity. Only makes it a candidate if the quantized state changed. </summary>
+		void SetTransform(uint32_t entity, const EntityTransform &transform);
+		void RemoveEntity(uint32_t entity);
+		/// <summary> How fast the entity gets ahead of others when it has changes to send, 1 by default. </summary>
+		void SetPriority(uint32_t entity, float priority);
+
+		/// <summary> The client starts with every entity as a candidate. </summary>
+		void AddClient(uint32_t client);
+		void RemoveClient(uint32_t client);
+
+		/// <summary> Writes the next packet of the client. </summary>
+		/// <returns> False if the client is up to date, nothing was written. </returns>
+		/// <exception cref="InvalidArgumentException"> If the client was not added. </exception>
+		bool WritePacket(uint32_t client, std::vector<uint8_t> &packet);
+		/// <summary> The client received the packet with the sequence, its states become baselines. </summary>
+		void Acknowledge(uint32_t client, uint16_t sequence);
+
+		/// <summary> Entities that are waiting to be sent or acknowledged to the client. </summary>
+		size_t GetPendingCount(uint32_t client) const;
+
+	private:
+		struct Entity
+		{
+			QuantizedTransform state;
+			float priority = 1.0f;
+		};
+		struct Baseline
+		{
+			uint16_t sequence;
+			bool removed;
+			QuantizedTransform state;
+		};
+		struct SentEntity
+		{
+			uint32_t entity;
+			bool removed;
+			QuantizedTransform state;
+		};
+		struct SentPacket
+		{
+			uint16_t sequence = 0;
+			bool valid = false;
+			std::vector<SentEntity> entities;
+		};
+		struct Client
+		{
+			uint16_t nextSequence = 0;
+			std::unordered_map<uint32_t, Baseline> baselines;
+			std::unordered_map<uint32_t, float> candidates; // Accumulated priority of entities that differ from their baseline.
+			std::deque<std::pair<uint16_t, uint32_t>> removals; // Baselines of removed entities, erased when no packet can refer to them.
+			std::vector<SentPacket> sentPackets = std::vector<SentPacket>(SentPacketWindow);
+		};
+
+		bool IsAcknowledged(const Client &client, uint32_t entity) const;
+		Client &FindClient(uint32_t client);
+
+	private:
+		SnapshotCodec m_codec;
+		uint32_t m_budgetBits;
+
+		std::unordered_map<uint32_t, Entity> m_entities;
+		std::unordered_map<uint32_t, Client> m_clients;
+
+		// Reused by WritePacket.
+		std::vector<std::pair<float, uint32_t>> m_order;
+		BitWriter m_packetBits;
+		BitWriter m_entityBits;
+	};
+}
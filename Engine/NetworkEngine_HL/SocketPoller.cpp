@@ -0,0 +1,114 @@
+#include "SocketPoller.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+
+namespace inl::net::servers
+{
+#ifdef __linux__
+	SocketPoller::SocketPoller()
+	{
+		m_epoll = epoll_create1(0);
+		if (m_epoll < 0)
+			throw RuntimeException("Failed to create epoll instance.");
+	}
+
+	SocketPoller::~SocketPoller()
+	{
+		close(m_epoll);
+	}
+
+	void SocketPoller::Add(SOCKET socket)
+	{
+		epoll_event evt{};
+		evt.events = EPOLLIN | EPOLLRDHUP;
+		evt.data.fd = socket;
+		if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, socket, &evt) != 0)
+			throw InvalidArgumentException("Socket cannot be registered.", std::to_string(socket));
+		++m_count;
+	}
+
+	void SocketPoller::Remove(SOCKET socket)
+	{
+		if (epoll_ctl(m_epoll, EPOLL_CTL_DEL, socket, nullptr) == 0)
+			--m_count;
+	}
+
+	size_t SocketPoller::Size() const
+	{
+		return m_count;
+	}
+
+	void SocketPoller::Wait(std::vector<Readiness> &ready_sockets, std::chrono::milliseconds timeout)
+	{
+		ready_sockets.clear();
+		m_events.resize(std::max<size_t>(m_count, 1));
+
+		int count = epoll_wait(m_epoll, m_events.data(), (int)m_events.size(), (int)timeout.count());
+		for (int i = 0; i < count; i++)
+		{
+			const epoll_event &evt = m_events[i];
+			bool closed = (evt.events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) != 0;
+			ready_sockets.push_back({ evt.data.fd, closed });
+		}
+	}
+#else
+	SocketPoller::SocketPoller() = default;
+
+	SocketPoller::~SocketPoller() = default;
+
+	void SocketPoller::Add(SOCKET socket)
+	{
+		if (!m_indices.insert({ socket, m_fds.size() }).second)
+			throw InvalidArgumentException("Socket is already registered.");
+
+		pollfd fd;
+		fd.fd = socket;
+		fd.events = POLLRDNORM;
+		fd.revents = 0;
+		m_fds.push_back(fd);
+	}
+
+	void SocketPoller::Remove(SOCKET socket)
+	{
+		auto it = m_indices.find(socket);
+		if (it == m_indices.end())
+			return;
+
+		// Swap with the last one so the set stays packed.
+		size_t index = it->second;
+		m_indices.erase(it);
+		if (index != m_fds.size() - 1)
+		{
+			m_fds[index] = m_fds.back();
+			m_indices[m_fds[index].fd] = index;
+		}
+		m_fds.pop_back();
+	}
+
+	size_t SocketPoller::Size() const
+	{
+		return m_fds.size();
+	}
+
+	void SocketPoller::Wait(std::vector<Readiness> &ready_sockets, std::chrono::milliseconds timeout)
+	{
+		ready_sockets.clear();
+		if (m_fds.empty())
+			return;
+
+		int count = poll(m_fds.data(), (unsigned long)m_fds.size(), (int)timeout.count());
+		for (size_t i = 0; i < m_fds.size() && count > 0; i++)
+		{
+			if (m_fds[i].revents == 0)
+				continue;
+
+			bool closed = (m_fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) != 0;
+			ready_sockets.push_back({ m_fds[i].fd, closed });
+			m_fds[i].revents = 0;
+			count--;
+		}
+	}
+#endif
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <NetworkEngine_LL/Net.hpp>
+
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+	#include <sys/epoll.h>
+#elif !defined(_MSC_VER)
+	#include <poll.h>
+#endif
+
+namespace inl::net::servers
+{
+	/// <summary> Waits for any of a persistent set of sockets to become readable. </summary>
+	/// <remarks> Sockets stay registered between waits, so the cost of a wait does not grow with
+	///		rebuilding the set. Uses epoll on Linux and WSAPoll over the kept set elsewhere.
+	///		Not thread safe, meant to be owned by a single receive thread. </remarks>
+	class SocketPoller
+	{
+	public:
+		struct Readiness
+		{
+			SOCKET socket;
+			bool closed; // Hung up or failed, the socket should be removed.
+		};
+
+	public:
+		SocketPoller();
+		~SocketPoller();
+
+		SocketPoller(const SocketPoller&) = delete;
+		SocketPoller &operator=(const SocketPoller&) = delete;
+
+		void Add(SOCKET socket);
+		void Remove(SOCKET socket);
+		size_t Size() const;
+
+		/// <summary> Waits until at least one socket is readable or the timeout passes. </summary>
+		/// <param name="ready_sockets"> Cleared, then filled with the sockets that can be read. </param>
+		void Wait(std::vector<Readiness> &ready_sockets, std::chrono::milliseconds timeout);
+
+	private:
+#ifdef __linux__
+		int m_epoll;
+		size_t m_count = 0;
+		std::vector<epoll_event> m_events;
+#else
+		std::vector<pollfd> m_fds;
+		std::unordered_map<SOCKET, size_t> m_indices; // socket -> index in m_fds
+#endif
+	};
+}
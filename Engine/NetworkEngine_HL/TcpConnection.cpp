@@ -24,6 +24,15 @@ namespace inl::net
 		m_id = id;
 	}
 
+	ConnectionStats TcpConnection::GetStats() const
+	{
+		ConnectionStats stats;
+		stats.id = m_id;
+		stats.transport = Transport::Tcp;
+		m_counters.Fill(stats);
+		return stats;
+	}
+
 	bool TcpConnection::sendMessage(NetworkMessage & msg)
 	{
 		uint32_t size;
@@ -3,15 +3,26 @@
 #include "NetworkEngine_LL/TcpClient.hpp"
 
 #include "NetworkMessage.hpp"
+#include "NetworkStats.hpp"
 
 #include "BaseLibrary/Event.hpp"
 
+#include <atomic>
+#include <deque>
+
 namespace inl::net
 {
+	namespace servers
+	{
+		class TcpConnectionHandler;
+	}
+
 	using namespace sockets;
 
 	class TcpConnection
 	{
+		friend class servers::TcpConnectionHandler;
+
 	public:
 		TcpConnection(TcpClient *client);
 
@@ -27,6 +38,9 @@ namespace inl::net
 
 		void ReceiveData();
 
+		/// <summary> Traffic and send queue counters, safe to read from any thread. </summary>
+		ConnectionStats GetStats() const;
+
 		inl::Event<uint32_t, DistributionMode, uint32_t, uint32_t, void*> DataReceivedEvent;
 		inl::Event<uint32_t, std::string, int32_t> DisconnectedEvent;
 		inl::Event<uint32_t, void*> NewConnectionEvent;
@@ -36,5 +50,15 @@ namespace inl::net
 
 		std::shared_ptr<TcpClient> m_client;
 		uint32_t m_id;
+
+		// Outbound frames, only touched by the send thread of the handler.
+		std::deque<MessageSlice> m_sendQueue;
+		size_t m_sendQueueBytes = 0;
+		uint32_t m_sendOffset = 0; // Bytes of the first frame already sent.
+
+		ConnectionCounters m_counters;
+
+		// Negotiated with InternalTags::Compression, set by the receive thread and read by the send thread.
+		std::atomic_bool m_compressFrames = false;
 	};
 }
\ No newline at end of file
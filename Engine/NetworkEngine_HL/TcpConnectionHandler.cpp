@@ -4,26 +4,42 @@
 #include "NewConnectionEvent.hpp"
 #include "InternalTags.hpp"
 
+#include "FrameCompression.hpp"
 #include "NetworkMessage.hpp"
 #include "MessageQueue.hpp"
 #include "TcpConnection.hpp"
 #include "NetworkEngine_LL/TcpListener.hpp"
 
+#include <BaseLibrary/Memory/MemoryTracker.hpp>
+
+#include <algorithm>
 #include <chrono>
 
+#ifndef _MSC_VER
+	#include <sys/uio.h>
+#endif
+
 namespace inl::net::servers
 {
 	using namespace events;
 
+	static constexpr std::chrono::milliseconds PollTimeout(100); // How often m_run is checked while idle.
+
 	TcpConnectionHandler::TcpConnectionHandler(std::shared_ptr<TcpListener> listener_ptr)
-		: m_run(false)
+		: m_maxConnections(0)
+		, m_run(false)
 		, m_listenerPtr(listener_ptr)
 	{
+		m_poller.Add(m_listenerPtr->m_socket->GetNativeSocket());
 	}
 
 	TcpConnectionHandler::~TcpConnectionHandler()
 	{
 		m_run.exchange(false);
+		if (m_receiveThread.joinable())
+			m_receiveThread.join();
+		if (m_sendThread.joinable())
+			m_sendThread.join();
 	}
 
 	void TcpConnectionHandler::Start()
@@ -32,8 +48,8 @@ namespace inl::net::servers
 		std::thread receive_thread(&TcpConnectionHandler::HandleReceiveMsgAndConnsThreaded, this);
 		m_receiveThread.swap(receive_thread);
 
-		//std::thread send_thread(&TcpConnectionHandler::HandleSendThreaded, this);
-		//m_sendThread.swap(send_thread);
+		std::thread send_thread(&TcpConnectionHandler::HandleSendThreaded, this);
+		m_sendThread.swap(send_thread);
 	}
 
 	void TcpConnectionHandler::Stop()
@@ -55,251 +71,406 @@ namespace inl::net::servers
 			int32_t sent = 0;
 			client->Send(buffer, size, sent);*/
 			client->Close();
+			m_rejected++;
+			return;
 		}
 
 		c->SetID(id);
 
 		NetworkMessage msg(id, DistributionMode::ID, id, (uint32_t)InternalTags::AssignID, &id, sizeof(uint32_t));
 
-		std::this_thread::sleep_for(std::chrono::milliseconds(50));
-
-		uint32_t serialized_size;
-		uint8_t *serialized_data = msg.SerializeData<uint32_t>(serialized_size);
+		MessageSlice frame = msg.Serialize(m_bufferPool);
 		int32_t sent;
-		if (!c->GetClient()->Send(serialized_data, serialized_size, sent))
+		if (!c->GetClient()->Send(frame.Data(), frame.Size(), sent))
 		{
 			//couldnt send
+			ReleaseID(id);
+			c->GetClient()->Close();
 			return;
 		}
 
+		c->m_counters.Sent(frame.Size(), 1);
+		m_accepted++;
+
 		m_listMutex.lock();
 		m_list.push_back(c);
 		m_listMutex.unlock();
 
+		SOCKET socket = c->GetClient()->m_socket->GetNativeSocket();
+		m_connections[socket] = c;
+		m_poller.Add(socket);
+
 		m_queue->EnqueueConnection(msg);
 	}
 
-	uint32_t TcpConnectionHandler::GetAvailableID()
+	void TcpConnectionHandler::RemoveClient(std::shared_ptr<TcpConnection> c)
 	{
-		for (int i = 1; i <= m_maxConnections; i++)
-		{
-			bool flag = true;
-			m_listMutex.lock();
-			for (int k = 0; k < m_list.size(); k++)
-			{
-				if (m_list.at(k)->GetID() == i)
-					flag = false;
-			}
-			m_listMutex.unlock();
+		SOCKET socket = c->GetClient()->m_socket->GetNativeSocket();
+		m_poller.Remove(socket);
+		m_connections.erase(socket);
 
-			if (flag)
-				return i;
+		ConnectionStats stats = c->GetStats();
+
+		m_listMutex.lock();
+		auto it = std::find(m_list.begin(), m_list.end(), c);
+		if (it != m_list.end())
+		{
+			std::swap(*it, m_list.back());
+			m_list.pop_back();
 		}
+		m_removedTotals.bytesIn += stats.bytesIn;
+		m_removedTotals.bytesOut += stats.bytesOut;
+		m_removedTotals.messagesIn += stats.messagesIn;
+		m_removedTotals.messagesOut += stats.messagesOut;
+		m_listMutex.unlock();
+
+		uint32_t id = c->GetID();
+		ReleaseID(id);
+		c->GetClient()->Close();
 
-		//throw OutOfRangeException("Out of IDs to allocate - clients = max connections", "NewConnectionEventPool");
-		return -1;
+		NetworkMessage msg(id, DistributionMode::Others, id, (uint32_t)InternalTags::Disconnect, nullptr, 0);
+		m_queue->EnqueueDisconnection(msg);
 	}
 
-	void TcpConnectionHandler::SetMaxConnections(uint32_t max_connections)
+	uint32_t TcpConnectionHandler::GetAvailableID()
 	{
-		m_maxConnections = max_connections;
+		std::lock_guard<inl::SpinMutex> lock(m_listMutex);
+		if (m_freeIDs.empty())
+		{
+			//throw OutOfRangeException("Out of IDs to allocate - clients = max connections", "NewConnectionEventPool");
+			return -1;
+		}
+
+		uint32_t id = m_freeIDs.back();
+		m_freeIDs.pop_back();
+		return id;
 	}
 
-	void TcpConnectionHandler::HandleReceiveMsgAndConns()
+	void TcpConnectionHandler::ReleaseID(uint32_t id)
 	{
-		// https://www.ibm.com/support/knowledgecenter/en/ssw_i5_54/rzab6/poll.htm
-		std::vector<pollfd> poll_fds;
-		pollfd master_fd;
-		master_fd.fd = m_listenerPtr->m_socket->GetNativeSocket();
-		master_fd.events = POLLRDNORM;
-		poll_fds.emplace_back(master_fd);
+		std::lock_guard<inl::SpinMutex> lock(m_listMutex);
+		if (id != -1 && id <= m_maxConnections)
+			m_freeIDs.push_back(id);
+	}
 
-		int res = poll(poll_fds.data(), poll_fds.size(), -1);
+	void TcpConnectionHandler::SetMaxConnections(uint32_t max_connections)
+	{
+		std::lock_guard<inl::SpinMutex> lock(m_listMutex);
 
-		if (res < 0)
+		// IDs are 1 based, the ones taken by current clients stay taken.
+		std::vector<bool> taken(max_connections + 1, false);
+		for (auto &c : m_list)
 		{
-			//poll error
+			if (c->GetID() <= max_connections)
+				taken[c->GetID()] = true;
 		}
 
-		//should never timeout because its infinite (negative)
-		//if (res == 0)
-		//{
-			//timeout
-		//}
-
-		for (int i = 0; i < poll_fds.size(); i++)
+		m_freeIDs.clear();
+		for (uint32_t id = max_connections; id >= 1; id--)
 		{
-			if (poll_fds.at(i).revents == 0)
-				continue;
+			if (!taken[id])
+				m_freeIDs.push_back(id);
+		}
+		m_maxConnections = max_connections;
+	}
 
-			if (poll_fds[i].revents != POLLRDNORM)
-			{
-				printf("  Error! revents = %d\n", poll_fds.at(i).revents);
-				//end_server = TRUE;
-				break;
+	void TcpConnectionHandler::HandleReceiveMsgAndConns()
+	{
+		// The sockets stay registered in the poller, only the ready ones are returned.
+		m_poller.Wait(m_readySockets, PollTimeout);
+		if (m_readySockets.empty())
+			return;
 
-			}
-			if (poll_fds.at(i).fd == m_listenerPtr->m_socket->GetNativeSocket())
+		auto start = std::chrono::steady_clock::now();
+		SOCKET listener = m_listenerPtr->m_socket->GetNativeSocket();
+		for (const SocketPoller::Readiness &ready : m_readySockets)
+		{
+			if (ready.socket == listener)
 			{
 				TcpClient *c = m_listenerPtr->AcceptClient();
 				if (c)
 				{
 					std::shared_ptr<TcpConnection> connection = std::make_shared<TcpConnection>(c);
-
-					pollfd new_client;
-					new_client.fd = connection->GetClient()->m_socket->GetNativeSocket();
-					new_client.events = POLLRDNORM;
-					poll_fds.emplace_back(new_client);
-
 					AddClient(connection);
 				}
+				continue;
+			}
+
+			auto it = m_connections.find(ready.socket);
+			if (it == m_connections.end())
+				continue;
+
+			if (ready.closed)
+			{
+				RemoveClient(it->second);
+				continue;
 			}
-			else // not the listening socket
+
+			SOCKET c = ready.socket;
+			NetworkHeader net_header;
+
+			int32_t read;
+			if ((read = recv(c, (char*)&net_header, sizeof(NetworkHeader), 0)) != sizeof(NetworkHeader))
 			{
-				SOCKET c = poll_fds.at(i).fd;
-				std::unique_ptr<uint8_t> header(new uint8_t[sizeof(NetworkHeader*)]());
+				// Readable with nothing to read means the peer closed the connection.
+				if (read <= 0)
+					RemoveClient(it->second);
+				continue;
+			}
+			if (net_header.Size < NetworkMessage::FrameOverhead)
+				continue; // wrong message
 
-				int32_t read;
-				if ((read = recv(c, (char*)header.get(), sizeof(NetworkHeader*), 0)) != sizeof(NetworkHeader*))
-					continue;
+			// The whole frame is received into one pooled buffer and parsed in place.
+			MessageSlice frame = m_bufferPool.Acquire(net_header.Size);
+			memcpy(frame.Data(), &net_header, sizeof(NetworkHeader));
+			int32_t body_size = net_header.Size - sizeof(NetworkHeader);
 
-				std::unique_ptr<NetworkHeader> net_header((NetworkHeader*)header.get());
-				std::unique_ptr<uint8_t> buffer(new uint8_t[net_header->Size]());
+			if ((read = recv(c, (char*)frame.Data() + sizeof(NetworkHeader), body_size, MSG_WAITALL)) == body_size)
+			{
+				it->second->m_counters.Received(net_header.Size);
 
-				if ((read = recv(c, (char*)buffer.get(), net_header->Size, 0)) == net_header->Size)
+				if (net_header.Flags & NetworkHeader::CompressedFlag)
 				{
-					NetworkMessage msg;
-					msg.Deserialize(buffer.get(), net_header->Size);
-
-					if (msg.GetTag() == (uint32_t)InternalTags::Disconnect)
-						m_queue->EnqueueDisconnection(msg);
-					else if (msg.GetTag() == (uint32_t)InternalTags::Connect)
-						m_queue->EnqueueConnection(msg);
-					else
-						m_queue->EnqueueMessageReceived(msg);
+					frame = FrameCompression::Decompress(frame, m_bufferPool);
+					if (frame.Empty())
+						continue; // wrong message
 				}
+
+				NetworkMessage msg;
+				msg.Deserialize(std::move(frame));
+
+				if (msg.GetTag() == (uint32_t)InternalTags::Disconnect)
+					m_queue->EnqueueDisconnection(msg);
+				else if (msg.GetTag() == (uint32_t)InternalTags::Connect)
+					m_queue->EnqueueConnection(msg);
+				else if (msg.GetTag() == (uint32_t)InternalTags::Compression)
+					NegotiateCompression(*it->second, msg);
 				else
-					continue;
+					m_queue->EnqueueMessageReceived(msg);
 			}
 		}
+
+		// Only this thread writes the loop counters.
+		uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+		m_pollLoops.fetch_add(1, std::memory_order_relaxed);
+		m_pollLoopMicroseconds.fetch_add(elapsed, std::memory_order_relaxed);
+		if (elapsed > m_pollLoopMaxMicroseconds.load(std::memory_order_relaxed))
+			m_pollLoopMaxMicroseconds.store(elapsed, std::memory_order_relaxed);
 	}
 
-	void TcpConnectionHandler::HandleSend()
+	void TcpConnectionHandler::NegotiateCompression(TcpConnection &c, const NetworkMessage &request)
 	{
-		if (m_queue->SendSize() > 0)
+		uint32_t codecs = 0;
+		if (request.GetDataSize() >= sizeof(uint32_t))
+			memcpy(&codecs, request.GetData<void>(), sizeof(uint32_t));
+		codecs &= (uint32_t)CompressionCodecs::Lz4;
+
+		c.m_compressFrames.store(codecs != 0, std::memory_order_relaxed);
+
+		// Goes through the send thread, so it does not interleave with the frames being sent to the client.
+		MessageSlice answer = m_bufferPool.Acquire(sizeof(uint32_t));
+		memcpy(answer.Data(), &codecs, sizeof(uint32_t));
+		m_queue->EnqueueMessageToSend(NetworkMessage(c.GetID(), DistributionMode::ID, c.GetID(), (uint32_t)InternalTags::Compression, std::move(answer)));
+	}
+
+	size_t TcpConnectionHandler::GetDroppedFrames() const
+	{
+		return m_droppedFrames.load();
+	}
+
+	void TcpConnectionHandler::GetStats(ServerStats &stats)
+	{
+		m_listMutex.lock();
+		std::vector<std::shared_ptr<TcpConnection>> connections = m_list;
+		ConnectionStats totals = m_removedTotals;
+		m_listMutex.unlock();
+
+		for (auto &c : connections)
 		{
-			NetworkMessage msg = m_queue->DequeueMessageToSend();
+			ConnectionStats connection = c->GetStats();
+			totals.bytesIn += connection.bytesIn;
+			totals.bytesOut += connection.bytesOut;
+			totals.messagesIn += connection.messagesIn;
+			totals.messagesOut += connection.messagesOut;
+			stats.connections.push_back(connection);
+		}
+
+		stats.bytesIn += totals.bytesIn;
+		stats.bytesOut += totals.bytesOut;
+		stats.messagesIn += totals.messagesIn;
+		stats.messagesOut += totals.messagesOut;
+		stats.accepted += m_accepted.load();
+		stats.rejected += m_rejected.load();
+		stats.droppedFrames += m_droppedFrames.load();
+		stats.pollLoops = m_pollLoops.load();
+		stats.pollLoopTime = std::chrono::microseconds(m_pollLoopMicroseconds.load());
+		stats.pollLoopMax = std::chrono::microseconds(m_pollLoopMaxMicroseconds.load());
+	}
 
-			uint32_t size;
-			std::unique_ptr<uint8_t> data(msg.SerializeData(size));
+	bool TcpConnectionHandler::HandleSend()
+	{
+		m_sendBatch.clear();
+		m_queue->DequeueMessagesToSend(m_sendBatch);
+
+		// Work on a snapshot, sending may block and must not hold the list lock.
+		m_listMutex.lock();
+		m_sendTargets = m_list;
+		m_listMutex.unlock();
 
-			if (msg.GetDistributionMode() == DistributionMode::Others)
+		for (const NetworkMessage &msg : m_sendBatch)
+		{
+			if (msg.GetDistributionMode() == DistributionMode::Server)
+				continue; //handle just in plugins
+
+			// Serialized once, the recipients share the frame. Compressed once too, for the first recipient that wants it.
+			MessageSlice frame = msg.Serialize(m_bufferPool);
+			MessageSlice compressed;
+			bool compress_tried = false;
+			for (auto &c : m_sendTargets)
 			{
-				m_listMutex.lock();
-				for (int i = 0; i < m_list.size(); i++)
+				if (!IsRecipient(msg, *c))
+					continue;
+
+				bool compress = c->m_compressFrames.load(std::memory_order_relaxed);
+				if (compress && !compress_tried)
 				{
-					std::shared_ptr<TcpConnection> c = m_list.at(i);
-					if (c->GetID() != msg.GetSenderID())
-					{
-						int32_t sent;
-						if (!c->GetClient()->Send(data.get(), size, sent))
-						{
-							// it failed - retry? or just disconnect right in the first try
-						}
-					}
+					compressed = FrameCompression::Compress(frame, m_bufferPool);
+					compress_tried = true;
 				}
-				m_listMutex.unlock();
+				if (!QueueFrame(*c, compress && !compressed.Empty() ? compressed : frame))
+					m_droppedFrames++;
 			}
-			else if (msg.GetDistributionMode() == DistributionMode::OthersAndServer)
-			{
-				m_listMutex.lock();
-				for (int i = 0; i < m_list.size(); i++)
-				{
-					std::shared_ptr<TcpConnection> c = m_list.at(i);
-					if (c->GetID() != msg.GetSenderID())
-					{
-						int32_t sent;
-						if (!c->GetClient()->Send(data.get(), size, sent))
-						{
-							// it failed - retry? or just disconnect right in the first try
-						}
-					}
-				}
-				m_listMutex.unlock();
 
-				//handle to plugins too
-			}
-			else if (msg.GetDistributionMode() == DistributionMode::ID)
+			//OthersAndServer and AllAndMe: handle to plugins too
+		}
+
+		bool sent_any = false;
+		for (auto &c : m_sendTargets)
+		{
+			if (c->m_sendQueue.empty())
+				continue;
+
+			sent_any = true;
+			if (!FlushSends(*c))
 			{
-				m_listMutex.lock();
-				for (int i = 0; i < m_list.size(); i++)
-				{
-					std::shared_ptr<TcpConnection> c = m_list.at(i);
-					if (c->GetID() == msg.GetSenderID())
-					{
-						int32_t sent;
-						if (!c->GetClient()->Send(data.get(), size, sent))
-						{
-							// it failed - retry? or just disconnect right in the first try
-						}
-					}
-				}
-				m_listMutex.unlock();
+				// it failed - the receive thread removes the client when its socket reports the error
+				c->m_sendQueue.clear();
+				c->m_sendQueueBytes = 0;
+				c->m_sendOffset = 0;
+				c->m_counters.SetQueueBytes(0);
 			}
-			else if (msg.GetDistributionMode() == DistributionMode::All)
-			{
-				m_listMutex.lock();
-				for (int i = 0; i < m_list.size(); i++)
-				{
-					std::shared_ptr<TcpConnection> c = m_list.at(i);
+		}
 
-					int32_t sent;
-					if (!c->GetClient()->Send(data.get(), size, sent))
-					{
-						// it failed - retry? or just disconnect right in the first try
-					}
-				}
-				m_listMutex.unlock();
+		m_sendTargets.clear();
+		return sent_any || !m_sendBatch.empty();
+	}
+
+	bool TcpConnectionHandler::IsRecipient(const NetworkMessage &msg, TcpConnection &c)
+	{
+		switch (msg.GetDistributionMode())
+		{
+		case DistributionMode::ID:
+			return c.GetID() == msg.GetDestinationID();
+		case DistributionMode::Others:
+		case DistributionMode::OthersAndServer:
+			return c.GetID() != msg.GetSenderID();
+		case DistributionMode::All:
+		case DistributionMode::AllAndMe:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool TcpConnectionHandler::QueueFrame(TcpConnection &c, const MessageSlice &frame)
+	{
+		if (c.m_sendQueueBytes + frame.Size() > MaxQueuedBytes)
+			return false;
+
+		c.m_sendQueue.push_back(frame);
+		c.m_sendQueueBytes += frame.Size();
+		c.m_counters.SetQueueBytes(c.m_sendQueueBytes);
+		return true;
+	}
+
+	bool TcpConnectionHandler::FlushSends(TcpConnection &c)
+	{
+		SOCKET socket = c.GetClient()->m_socket->GetNativeSocket();
+
+		while (!c.m_sendQueue.empty())
+		{
+			// Gather as many queued frames as fit into one call.
+#ifdef _MSC_VER
+			WSABUF buffers[MaxBuffersPerSend];
+#else
+			iovec buffers[MaxBuffersPerSend];
+#endif
+			size_t count = std::min(c.m_sendQueue.size(), MaxBuffersPerSend);
+			for (size_t i = 0; i < count; i++)
+			{
+				const MessageSlice &frame = c.m_sendQueue[i];
+				uint32_t offset = i == 0 ? c.m_sendOffset : 0;
+#ifdef _MSC_VER
+				buffers[i].buf = (char*)frame.Data() + offset;
+				buffers[i].len = frame.Size() - offset;
+#else
+				buffers[i].iov_base = frame.Data() + offset;
+				buffers[i].iov_len = frame.Size() - offset;
+#endif
 			}
-			else if (msg.GetDistributionMode() == DistributionMode::AllAndMe)
+
+#ifdef _MSC_VER
+			DWORD sent = 0;
+			if (WSASend(socket, buffers, (DWORD)count, &sent, 0, nullptr, nullptr) != 0)
+				return false;
+#else
+			ssize_t sent = writev(socket, buffers, (int)count);
+			if (sent < 0)
+				return false;
+#endif
+
+			// Drop the frames that went out completely, remember how far the last one got.
+			size_t remaining = (size_t)sent;
+			size_t completed = 0;
+			while (remaining > 0)
 			{
-				m_listMutex.lock();
-				for (int i = 0; i < m_list.size(); i++)
+				uint32_t left = c.m_sendQueue.front().Size() - c.m_sendOffset;
+				if (remaining < left)
 				{
-					std::shared_ptr<TcpConnection> c = m_list.at(i);
-						
-					int32_t sent;
-					if (!c->GetClient()->Send(data.get(), size, sent))
-					{
-						// it failed - retry? or just disconnect right in the first try
-					}
+					c.m_sendOffset += (uint32_t)remaining;
+					c.m_sendQueueBytes -= remaining;
+					break;
 				}
-				m_listMutex.unlock();
-
-				//handle to plugins too
-			}
-			else if (msg.GetDistributionMode() == DistributionMode::Server)
-			{
-				//handle just in plugins
+				remaining -= left;
+				c.m_sendQueueBytes -= left;
+				c.m_sendOffset = 0;
+				c.m_sendQueue.pop_front();
+				completed++;
 			}
+			c.m_counters.Sent((size_t)sent, completed);
+			c.m_counters.SetQueueBytes(c.m_sendQueueBytes);
 		}
+		return true;
 	}
 
 	void TcpConnectionHandler::HandleReceiveMsgAndConnsThreaded()
 	{
+		MemoryTagScope memoryTag(eMemoryTag::NETWORK);
+		// Blocks in the poller, no need to sleep between iterations.
 		while (m_run.load())
 		{
 			HandleReceiveMsgAndConns();
-			std::this_thread::sleep_for(std::chrono::milliseconds(5));
 		}
 	}
 
 	void TcpConnectionHandler::HandleSendThreaded()
 	{
+		MemoryTagScope memoryTag(eMemoryTag::NETWORK);
 		while (m_run.load())
 		{
-			HandleSend();
-			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			// Only wait for the next batch when idle.
+			if (!HandleSend())
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
 		}
 	}
 }
\ No newline at end of file
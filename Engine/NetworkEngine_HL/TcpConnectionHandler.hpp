@@ -3,8 +3,14 @@
 #include <mutex>
 #include <atomic>
 #include <queue>
+#include <unordered_map>
+#include <vector>
 
 #include <BaseLibrary/SpinMutex.hpp>
+#include "MessageBuffer.hpp"
+#include "NetworkMessage.hpp"
+#include "NetworkStats.hpp"
+#include "SocketPoller.hpp"
 
 namespace inl::net
 {
@@ -24,6 +30,10 @@ namespace inl::net::servers
 	{
 		friend class inl::net::Server;
 
+	public:
+		static constexpr size_t MaxQueuedBytes = 1024 * 1024; // Per client, frames beyond it are dropped.
+		static constexpr size_t MaxBuffersPerSend = 64; // Frames coalesced into one send call.
+
 	public:
 		TcpConnectionHandler(std::shared_ptr<inl::net::sockets::TcpListener> listener_ptr);
 		~TcpConnectionHandler();
@@ -33,11 +43,29 @@ namespace inl::net::servers
 		void AddClient(std::shared_ptr<TcpConnection> &c);
 		void SetMaxConnections(uint32_t max_connections);
 
+		/// <summary> Takes an unused ID, or -1 if there are max connections clients already. </summary>
 		uint32_t GetAvailableID();
+		void ReleaseID(uint32_t id);
+
+		/// <summary> Frames not sent because the queue of their client was full. </summary>
+		size_t GetDroppedFrames() const;
+
+		/// <summary> Fills the TCP part of the stats: the current connections, totals, accepts and poll loop times. </summary>
+		void GetStats(ServerStats &stats);
 
 	private:
+		void RemoveClient(std::shared_ptr<TcpConnection> c);
+
 		void HandleReceiveMsgAndConns();
-		void HandleSend();
+		/// <returns> False if there was nothing to send. </returns>
+		bool HandleSend();
+
+		/// <summary> Answers the codecs of a client with the ones the server accepts, and compresses the client's frames from now on if any. </summary>
+		void NegotiateCompression(TcpConnection &c, const NetworkMessage &request);
+
+		static bool IsRecipient(const NetworkMessage &msg, TcpConnection &c);
+		bool QueueFrame(TcpConnection &c, const MessageSlice &frame);
+		bool FlushSends(TcpConnection &c);
 
 		void HandleReceiveMsgAndConnsThreaded();
 		void HandleSendThreaded();
@@ -47,6 +75,13 @@ namespace inl::net::servers
 		inl::SpinMutex m_listMutex;
 
 		uint32_t m_maxConnections;
+		std::vector<uint32_t> m_freeIDs; // Guarded by m_listMutex, smallest ID at the back.
+		ConnectionStats m_removedTotals; // Traffic of the clients that are gone, guarded by m_listMutex.
+
+		// Only used by the receive thread.
+		SocketPoller m_poller;
+		std::vector<SocketPoller::Readiness> m_readySockets;
+		std::unordered_map<SOCKET, std::shared_ptr<TcpConnection>> m_connections;
 
 		std::thread m_receiveThread;
 		std::thread m_sendThread;
@@ -54,6 +89,19 @@ namespace inl::net::servers
 		std::atomic_bool m_run;
 
 		std::shared_ptr<MessageQueue> m_queue;
+		MessageBufferPool m_bufferPool; // Frames of sent and received messages.
+
+		// Only used by the send thread.
+		std::vector<NetworkMessage> m_sendBatch;
+		std::vector<std::shared_ptr<TcpConnection>> m_sendTargets;
+		std::atomic<size_t> m_droppedFrames = 0;
+
+		// Written by the receive thread.
+		std::atomic<uint64_t> m_accepted = 0;
+		std::atomic<uint64_t> m_rejected = 0;
+		std::atomic<uint64_t> m_pollLoops = 0;
+		std::atomic<uint64_t> m_pollLoopMicroseconds = 0;
+		std::atomic<uint64_t> m_pollLoopMaxMicroseconds = 0;
 
 		std::shared_ptr<inl::net::sockets::TcpListener> m_listenerPtr;
 	};
@@ -0,0 +1,381 @@
+#include "UdpConnection.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace inl::net
+{
+	static constexpr size_t MaxReassemblies = 256;
+
+	static void Write16(std::vector<uint8_t> &bytes, uint16_t value)
+	{
+		bytes.push_back(uint8_t(value));
+		bytes.push_back(uint8_t(value >> 8));
+	}
+
+	static void Write32(std::vector<uint8_t> &bytes, uint32_t value)
+	{
+		for (int i = 0; i < 4; i++)
+			bytes.push_back(uint8_t(value >> (8 * i)));
+	}
+
+	static uint16_t Read16(const uint8_t *data)
+	{
+		return uint16_t(data[0] | (data[1] << 8));
+	}
+
+	static uint32_t Read32(const uint8_t *data)
+	{
+		return uint32_t(data[0]) | (uint32_t(data[1]) << 8) | (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24);
+	}
+
+	static bool IsReliable(ChannelType channel)
+	{
+		return channel == ChannelType::ReliableOrdered || channel == ChannelType::ReliableUnordered;
+	}
+
+	UdpConnection::UdpConnection(Clock::time_point now)
+		: m_lastReceive(now)
+	{
+		m_deliveredUnordered.fill(-1);
+	}
+
+	bool UdpConnection::SequenceGreater(uint16_t a, uint16_t b)
+	{
+		return ((a > b) && (a - b <= 32768)) || ((a < b) && (b - a > 32768));
+	}
+
+	void UdpConnection::Send(ChannelType channel, const uint8_t *data, uint32_t size)
+	{
+		if (channel >= ChannelType::Count)
+			throw InvalidArgumentException("Unknown channel.");
+
+		uint32_t fragment_count = std::max<uint32_t>((size + MaxFragmentSize - 1) / MaxFragmentSize, 1);
+		if (fragment_count > MaxFragmentCount)
+			throw InvalidArgumentException("Message is too big to be sent over UDP.", std::to_string(size));
+
+		uint16_t message_id = m_nextMessageIds[(size_t)channel]++;
+		for (uint32_t i = 0; i < fragment_count; i++)
+		{
+			uint32_t offset = i * MaxFragmentSize;
+			uint32_t length = std::min(size - offset, MaxFragmentSize);
+
+			Fragment fragment;
+			fragment.channel = channel;
+			fragment.messageId = message_id;
+			fragment.fragmentIndex = (uint16_t)i;
+			fragment.fragmentCount = (uint16_t)fragment_count;
+			fragment.payload.assign(data + offset, data + offset + length);
+			if (IsReliable(channel))
+				m_pendingReliableBytes += length;
+			m_unsent.push_back(std::move(fragment));
+		}
+	}
+
+	void UdpConnection::CollectOutgoing(Clock::time_point now, std::vector<std::vector<uint8_t>> &packets)
+	{
+		size_t first_packet = packets.size();
+
+		// Reliable fragments whose packet was not acked in time go out again with a new sequence number.
+		Clock::duration timeout = GetResendTimeout();
+		std::vector<uint16_t> expired;
+		for (auto &[sequence, fragment] : m_inFlight)
+		{
+			if (now - fragment.lastSent >= timeout)
+				expired.push_back(sequence);
+		}
+		std::sort(expired.begin(), expired.end(), [](uint16_t a, uint16_t b) { return SequenceGreater(b, a); });
+		for (uint16_t sequence : expired)
+		{
+			auto it = m_inFlight.find(sequence);
+			Fragment fragment = std::move(it->second);
+			m_inFlight.erase(it);
+			WritePacket(&fragment, now, packets);
+		}
+
+		while (!m_unsent.empty())
+		{
+			Fragment fragment = std::move(m_unsent.front());
+			m_unsent.pop_front();
+			WritePacket(&fragment, now, packets);
+		}
+
+		// Acks ride on the data packets, a bare one is only needed when there was nothing to send.
+		if (m_ackDue && packets.size() == first_packet)
+			WritePacket(nullptr, now, packets);
+	}
+
+	void UdpConnection::WritePacket(const Fragment *fragment, Clock::time_point now, std::vector<std::vector<uint8_t>> &packets)
+	{
+		uint16_t sequence = m_nextSequence++;
+
+		SentPacket &sent = m_sentPackets[sequence % SentPacketWindow];
+		sent.sequence = sequence;
+		sent.time = now;
+		sent.valid = fragment != nullptr; // Bare acks are not acked themselves, they say nothing about loss.
+		sent.acked = false;
+
+		std::vector<uint8_t> bytes;
+		bytes.reserve(HeaderSize + (fragment ? FragmentHeaderSize + fragment->payload.size() : 0));
+		bytes.push_back(uint8_t(fragment ? UdpPacketType::Data : UdpPacketType::Ack));
+		Write16(bytes, sequence);
+		Write16(bytes, m_remoteSequence);
+		Write32(bytes, m_remoteAckBits);
+
+		if (fragment)
+		{
+			bytes.push_back(uint8_t(fragment->channel));
+			Write16(bytes, fragment->messageId);
+			Write16(bytes, fragment->fragmentIndex);
+			Write16(bytes, fragment->fragmentCount);
+			bytes.insert(bytes.end(), fragment->payload.begin(), fragment->payload.end());
+
+			if (IsReliable(fragment->channel))
+			{
+				Fragment &in_flight = m_inFlight[sequence] = *fragment;
+				in_flight.lastSent = now;
+			}
+		}
+
+		m_ackDue = false;
+		packets.push_back(std::move(bytes));
+	}
+
+	bool UdpConnection::Receive(const uint8_t *data, uint32_t size, Clock::time_point now, std::vector<ReceivedMessage> &messages)
+	{
+		if (size < HeaderSize)
+			return false;
+
+		UdpPacketType type = (UdpPacketType)data[0];
+		if (type != UdpPacketType::Data && type != UdpPacketType::Ack)
+			return false;
+		if (type == UdpPacketType::Data && size < HeaderSize + FragmentHeaderSize)
+			return false;
+
+		uint16_t sequence = Read16(data + 1);
+		uint16_t ack = Read16(data + 3);
+		uint32_t ack_bits = Read32(data + 5);
+
+		// Remember the peer's packet for the acks we send back.
+		if (!m_receivedAny || SequenceGreater(sequence, m_remoteSequence))
+		{
+			uint16_t shift = m_receivedAny ? uint16_t(sequence - m_remoteSequence) : 0;
+			if (shift == 0)
+				m_remoteAckBits = 0;
+			else if (shift > 32)
+				m_remoteAckBits = 0;
+			else if (shift == 32)
+				m_remoteAckBits = 1u << 31;
+			else
+				m_remoteAckBits = (m_remoteAckBits << shift) | (1u << (shift - 1));
+			m_remoteSequence = sequence;
+			m_receivedAny = true;
+		}
+		else
+		{
+			uint16_t age = uint16_t(m_remoteSequence - sequence);
+			if (age >= 1 && age <= 32)
+				m_remoteAckBits |= 1u << (age - 1);
+		}
+		m_lastReceive = now;
+
+		ProcessAcks(ack, ack_bits, now);
+		UpdatePacketLoss(ack);
+
+		if (type == UdpPacketType::Data)
+		{
+			m_ackDue = true;
+
+			const uint8_t *fragment = data + HeaderSize;
+			ChannelType channel = (ChannelType)fragment[0];
+			uint16_t message_id = Read16(fragment + 1);
+			uint16_t fragment_index = Read16(fragment + 3);
+			uint16_t fragment_count = Read16(fragment + 5);
+			if (channel >= ChannelType::Count || fragment_count == 0 || fragment_count > MaxFragmentCount || fragment_index >= fragment_count)
+				return false;
+
+			uint32_t payload_offset = HeaderSize + FragmentHeaderSize;
+			ReceiveFragment(channel, message_id, fragment_index, fragment_count, data + payload_offset, size - payload_offset, messages);
+		}
+		return true;
+	}
+
+	void UdpConnection::ProcessAcks(uint16_t ack, uint32_t ack_bits, Clock::time_point now)
+	{
+		for (uint16_t i = 0; i < AckWindow; i++)
+		{
+			if (i > 0 && !((ack_bits >> (i - 1)) & 1))
+				continue;
+
+			uint16_t sequence = uint16_t(ack - i);
+			SentPacket &sent = m_sentPackets[sequence % SentPacketWindow];
+			if (!sent.valid || sent.sequence != sequence || sent.acked)
+				continue;
+			sent.acked = true;
+
+			float sample = std::chrono::duration<float, std::milli>(now - sent.time).count();
+			if (!m_rttSampled)
+			{
+				m_smoothedRtt = sample;
+				m_rttVariance = sample / 2;
+				m_rttSampled = true;
+			}
+			else
+			{
+				m_rttVariance = 0.75f * m_rttVariance + 0.25f * std::abs(m_smoothedRtt - sample);
+				m_smoothedRtt = 0.875f * m_smoothedRtt + 0.125f * sample;
+			}
+
+			auto it = m_inFlight.find(sequence);
+			if (it != m_inFlight.end())
+			{
+				m_pendingReliableBytes -= it->second.payload.size();
+				m_inFlight.erase(it);
+			}
+		}
+	}
+
+	void UdpConnection::UpdatePacketLoss(uint16_t ack)
+	{
+		// Packets that fell out of the ack window without being acked count as lost.
+		uint16_t limit = uint16_t(ack - AckWindow);
+		if (uint16_t(m_nextSequence - m_lossCursor) > SentPacketWindow)
+			m_lossCursor = uint16_t(m_nextSequence - SentPacketWindow);
+
+		while (!SequenceGreater(m_lossCursor, limit) && SequenceGreater(m_nextSequence, m_lossCursor))
+		{
+			const SentPacket &sent = m_sentPackets[m_lossCursor % SentPacketWindow];
+			if (sent.valid && sent.sequence == m_lossCursor)
+				m_packetLoss = 0.95f * m_packetLoss + 0.05f * (sent.acked ? 0.0f : 1.0f);
+			m_lossCursor++;
+		}
+	}
+
+	void UdpConnection::ReceiveFragment(ChannelType channel, uint16_t message_id, uint16_t fragment_index, uint16_t fragment_count,
+										const uint8_t *payload, uint32_t size, std::vector<ReceivedMessage> &messages)
+	{
+		if (IsDelivered(channel, message_id))
+			return;
+		if (channel == ChannelType::UnreliableSequenced && m_sequencedAny && !SequenceGreater(message_id, m_lastSequencedId))
+			return; // Older than what the application already has.
+		if (channel == ChannelType::ReliableOrdered && uint16_t(message_id - m_nextOrderedId) >= DeliveredWindow)
+			return; // Too far ahead to buffer.
+
+		if (fragment_count == 1)
+		{
+			Deliver(channel, message_id, std::vector<uint8_t>(payload, payload + size), messages);
+			return;
+		}
+
+		auto key = std::make_pair(channel, message_id);
+		auto it = m_reassembly.find(key);
+		if (it == m_reassembly.end())
+		{
+			if (m_reassembly.size() >= MaxReassemblies)
+				return;
+			it = m_reassembly.insert({ key, Reassembly{} }).first;
+			it->second.fragments.resize(fragment_count);
+		}
+
+		Reassembly &reassembly = it->second;
+		if (reassembly.fragments.size() != fragment_count || size == 0 || !reassembly.fragments[fragment_index].empty())
+			return; // Inconsistent or duplicate fragment.
+
+		reassembly.fragments[fragment_index].assign(payload, payload + size);
+		if (++reassembly.received < fragment_count)
+			return;
+
+		std::vector<uint8_t> data;
+		for (auto &fragment : reassembly.fragments)
+			data.insert(data.end(), fragment.begin(), fragment.end());
+		m_reassembly.erase(it);
+
+		Deliver(channel, message_id, std::move(data), messages);
+	}
+
+	bool UdpConnection::IsDelivered(ChannelType channel, uint16_t message_id) const
+	{
+		switch (channel)
+		{
+		case ChannelType::ReliableOrdered:
+			return SequenceGreater(m_nextOrderedId, message_id) || m_orderedPending.count(message_id) > 0;
+		case ChannelType::ReliableUnordered:
+			return m_deliveredUnordered[message_id % DeliveredWindow] == message_id;
+		default:
+			return false;
+		}
+	}
+
+	void UdpConnection::Deliver(ChannelType channel, uint16_t message_id, std::vector<uint8_t> data, std::vector<ReceivedMessage> &messages)
+	{
+		switch (channel)
+		{
+		case ChannelType::ReliableOrdered:
+			if (message_id != m_nextOrderedId)
+			{
+				m_orderedPending.insert({ message_id, std::move(data) });
+				return;
+			}
+			messages.push_back({ channel, std::move(data) });
+			m_nextOrderedId++;
+
+			// Release the ones that were waiting for this.
+			for (auto it = m_orderedPending.find(m_nextOrderedId); it != m_orderedPending.end(); it = m_orderedPending.find(m_nextOrderedId))
+			{
+				messages.push_back({ channel, std::move(it->second) });
+				m_orderedPending.erase(it);
+				m_nextOrderedId++;
+			}
+			break;
+		case ChannelType::ReliableUnordered:
+			m_deliveredUnordered[message_id % DeliveredWindow] = message_id;
+			messages.push_back({ channel, std::move(data) });
+			break;
+		case ChannelType::UnreliableSequenced:
+			m_lastSequencedId = message_id;
+			m_sequencedAny = true;
+			messages.push_back({ channel, std::move(data) });
+
+			// Incomplete older messages will never be delivered.
+			for (auto it = m_reassembly.begin(); it != m_reassembly.end();)
+			{
+				if (it->first.first == channel && !SequenceGreater(it->first.second, message_id))
+					it = m_reassembly.erase(it);
+				else
+					++it;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	UdpConnection::Clock::duration UdpConnection::GetResendTimeout() const
+	{
+		float timeout = std::clamp(m_smoothedRtt + 4.0f * m_rttVariance, 20.0f, 1000.0f);
+		return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float, std::milli>(timeout));
+	}
+
+	float UdpConnection::GetRoundTripTime() const
+	{
+		return m_smoothedRtt;
+	}
+
+	float UdpConnection::GetPacketLoss() const
+	{
+		return m_packetLoss;
+	}
+
+	UdpConnection::Clock::time_point UdpConnection::GetLastReceiveTime() const
+	{
+		return m_lastReceive;
+	}
+
+	size_t UdpConnection::GetPendingReliableBytes() const
+	{
+		return m_pendingReliableBytes;
+	}
+}
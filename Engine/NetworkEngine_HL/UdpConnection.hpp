@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace inl::net
+{
+	enum class ChannelType : uint8_t
+	{
+		ReliableOrdered,
+		ReliableUnordered,
+		UnreliableSequenced,
+		Count
+	};
+
+	enum class UdpPacketType : uint8_t
+	{
+		Connect,
+		Accept,
+		Disconnect,
+		Data,
+		Ack
+	};
+
+	/// <summary> Reliability state of one UDP peer, without the socket. </summary>
+	/// <remarks>
+	/// Every data packet carries one message fragment, its own sequence number and
+	/// selective acks for the last 33 packets of the peer. Reliable fragments are sent
+	/// again until a packet carrying them is acked, the resend timeout follows the
+	/// smoothed round trip time. Messages bigger than <see cref="MaxFragmentSize"/> are split
+	/// into fragments and reassembled on the other side.
+	/// </remarks>
+	class UdpConnection
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		static constexpr uint32_t MaxPacketSize = 1200; // Stays below common path MTUs.
+		static constexpr uint32_t HeaderSize = 9; // type, sequence, ack, ack bits
+		static constexpr uint32_t FragmentHeaderSize = 7; // channel, message id, fragment index, fragment count
+		static constexpr uint32_t MaxFragmentSize = MaxPacketSize - HeaderSize - FragmentHeaderSize;
+		static constexpr uint32_t MaxFragmentCount = 256;
+
+		struct ReceivedMessage
+		{
+			ChannelType channel;
+			std::vector<uint8_t> data;
+		};
+
+	public:
+		/// <param name="now"> Counts as the last receive time until the first packet arrives. </param>
+		UdpConnection(Clock::time_point now = Clock::now());
+
+		/// <summary> Queues a message, it goes out with the next <see cref="CollectOutgoing"/>. </summary>
+		/// <exception cref="InvalidArgumentException"> If the message needs more than MaxFragmentCount fragments. </exception>
+		void Send(ChannelType channel, const uint8_t *data, uint32_t size);
+
+		/// <summary> Appends the datagrams to send now: new fragments, resends and a bare ack if one is due. </summary>
+		void CollectOutgoing(Clock::time_point now, std::vector<std::vector<uint8_t>> &packets);
+
+		/// <summary> Processes a Data or Ack datagram of the peer and appends the messages it completed. </summary>
+		/// <returns> False if the datagram is malformed or of another type. </returns>
+		bool Receive(const uint8_t *data, uint32_t size, Clock::time_point now, std::vector<ReceivedMessage> &messages);
+
+		/// <summary> Smoothed round trip time in milliseconds. </summary>
+		float GetRoundTripTime() const;
+		/// <summary> Estimated ratio of packets that were not acked, between 0 and 1. </summary>
+		float GetPacketLoss() const;
+		Clock::time_point GetLastReceiveTime() const;
+		/// <summary> Bytes of reliable fragments that are not acked yet. </summary>
+		size_t GetPendingReliableBytes() const;
+
+		static bool SequenceGreater(uint16_t a, uint16_t b);
+
+	private:
+		struct Fragment
+		{
+			ChannelType channel;
+			uint16_t messageId;
+			uint16_t fragmentIndex;
+			uint16_t fragmentCount;
+			std::vector<uint8_t> payload;
+			Clock::time_point lastSent;
+		};
+
+		struct SentPacket
+		{
+			uint16_t sequence;
+			Clock::time_point time;
+			bool valid = false;
+			bool acked = false;
+		};
+
+		struct Reassembly
+		{
+			std::vector<std::vector<uint8_t>> fragments;
+			uint16_t received = 0;
+		};
+
+		static constexpr size_t SentPacketWindow = 1024;
+		static constexpr size_t DeliveredWindow = 1024;
+		static constexpr uint16_t AckWindow = 33;
+
+		void WritePacket(const Fragment *fragment, Clock::time_point now, std::vector<std::vector<uint8_t>> &packets);
+		void ProcessAcks(uint16_t ack, uint32_t ackBits, Clock::time_point now);
+		void UpdatePacketLoss(uint16_t ack);
+		void ReceiveFragment(ChannelType channel, uint16_t messageId, uint16_t fragmentIndex, uint16_t fragmentCount,
+							 const uint8_t *payload, uint32_t size, std::vector<ReceivedMessage> &messages);
+		bool IsDelivered(ChannelType channel, uint16_t messageId) const;
+		void Deliver(ChannelType channel, uint16_t messageId, std::vector<uint8_t> data, std::vector<ReceivedMessage> &messages);
+		Clock::duration GetResendTimeout() const;
+
+	private:
+		// Sending.
+		uint16_t m_nextSequence = 0;
+		std::array<uint16_t, (size_t)ChannelType::Count> m_nextMessageIds = {};
+		std::deque<Fragment> m_unsent;
+		std::unordered_map<uint16_t, Fragment> m_inFlight; // packet sequence -> reliable fragment in it
+		std::array<SentPacket, SentPacketWindow> m_sentPackets;
+		size_t m_pendingReliableBytes = 0;
+
+		// Acks of the peer's packets.
+		uint16_t m_remoteSequence = 0;
+		uint32_t m_remoteAckBits = 0;
+		bool m_receivedAny = false;
+		bool m_ackDue = false;
+
+		// Receiving.
+		std::map<std::pair<ChannelType, uint16_t>, Reassembly> m_reassembly;
+		uint16_t m_nextOrderedId = 0;
+		std::map<uint16_t, std::vector<uint8_t>> m_orderedPending;
+		std::array<int32_t, DeliveredWindow> m_deliveredUnordered;
+		uint16_t m_lastSequencedId = 0;
+		bool m_sequencedAny = false;
+		Clock::time_point m_lastReceive;
+
+		// Statistics.
+		float m_smoothedRtt = 100.0f;
+		float m_rttVariance = 50.0f;
+		bool m_rttSampled = false;
+		float m_packetLoss = 0.0f;
+		uint16_t m_lossCursor = 0;
+	};
+}
@@ -0,0 +1,317 @@
+#include "UdpServer.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+#include <BaseLibrary/Memory/MemoryTracker.hpp>
+
+#include "InternalTags.hpp"
+#include "MessageQueue.hpp"
+#include "NetworkEngine_LL/UdpSocketBuilder.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace inl::net::servers
+{
+	static constexpr std::chrono::milliseconds IdleSleep(1); // When the socket had nothing to read.
+	static constexpr uint32_t HandshakeSize = 1 + sizeof(uint32_t);
+
+	static void WriteHandshake(uint8_t *bytes, UdpPacketType type)
+	{
+		uint32_t protocol_id = UdpServer::ProtocolId;
+		bytes[0] = uint8_t(type);
+		memcpy(bytes + 1, &protocol_id, sizeof(uint32_t));
+	}
+
+	UdpServer::UdpServer(uint32_t max_connections, uint16_t port, std::shared_ptr<MessageQueue> queue)
+		: m_maxConnections(max_connections)
+		, m_port(port)
+		, m_run(false)
+		, m_queue(queue)
+		, m_receiveBuffer(UdpConnection::MaxPacketSize)
+	{
+		if (max_connections == 0 || port == 0)
+			throw InvalidArgumentException("UdpServer::UdpServer()");
+
+		m_socket = UdpSocketBuilder().AsNonBlocking().AsReusable().BoundToPort(port).Build();
+
+		// IDs are 1 based like the ones of the TCP server.
+		for (uint32_t id = max_connections; id >= 1; id--)
+			m_freeIDs.push_back(id);
+	}
+
+	UdpServer::~UdpServer()
+	{
+		Stop();
+	}
+
+	void UdpServer::Start()
+	{
+		if (m_run.exchange(true))
+			return;
+		m_thread = std::thread(&UdpServer::Run, this);
+	}
+
+	void UdpServer::Stop()
+	{
+		m_run.exchange(false);
+		if (m_thread.joinable())
+			m_thread.join();
+	}
+
+	bool UdpServer::Send(uint32_t client_id, ChannelType channel, const NetworkMessage &msg)
+	{
+		MessageSlice frame = msg.Serialize(m_bufferPool);
+
+		std::lock_guard<std::mutex> lock(m_clientsMutex);
+		Client *client = FindClient(client_id);
+		if (!client)
+			return false;
+		client->connection.Send(channel, frame.Data(), frame.Size());
+		client->stats.messagesOut++;
+		return true;
+	}
+
+	void UdpServer::Broadcast(ChannelType channel, const NetworkMessage &msg)
+	{
+		MessageSlice frame = msg.Serialize(m_bufferPool);
+
+		std::lock_guard<std::mutex> lock(m_clientsMutex);
+		for (auto &[key, client] : m_clients)
+		{
+			client.connection.Send(channel, frame.Data(), frame.Size());
+			client.stats.messagesOut++;
+		}
+	}
+
+	float UdpServer::GetRoundTripTime(uint32_t client_id)
+	{
+		std::lock_guard<std::mutex> lock(m_clientsMutex);
+		Client *client = FindClient(client_id);
+		return client ? client->connection.GetRoundTripTime() : -1.0f;
+	}
+
+	float UdpServer::GetPacketLoss(uint32_t client_id)
+	{
+		std::lock_guard<std::mutex> lock(m_clientsMutex);
+		Client *client = FindClient(client_id);
+		return client ? client->connection.GetPacketLoss() : -1.0f;
+	}
+
+	void UdpServer::GetStats(ServerStats &stats)
+	{
+		std::lock_guard<std::mutex> lock(m_clientsMutex);
+		ConnectionStats totals = m_removedTotals;
+		for (auto &[key, client] : m_clients)
+		{
+			ConnectionStats connection = client.stats;
+			connection.sendQueueBytes = client.connection.GetPendingReliableBytes();
+			connection.roundTripTime = client.connection.GetRoundTripTime();
+			connection.packetLoss = client.connection.GetPacketLoss();
+
+			totals.bytesIn += connection.bytesIn;
+			totals.bytesOut += connection.bytesOut;
+			totals.messagesIn += connection.messagesIn;
+			totals.messagesOut += connection.messagesOut;
+			stats.connections.push_back(connection);
+		}
+
+		stats.bytesIn += totals.bytesIn;
+		stats.bytesOut += totals.bytesOut;
+		stats.messagesIn += totals.messagesIn;
+		stats.messagesOut += totals.messagesOut;
+		stats.accepted += m_accepted;
+		stats.rejected += m_rejected;
+	}
+
+	void UdpServer::Run()
+	{
+		MemoryTagScope memoryTag(eMemoryTag::NETWORK);
+		while (m_run.load())
+		{
+			bool received_any = false;
+
+			// Drain the socket before answering, so that the acks cover everything that arrived.
+			int32_t read = 0;
+			IPAddress address;
+			while (m_socket->RecvFrom(m_receiveBuffer.data(), (int32_t)m_receiveBuffer.size(), read, address) && read > 0)
+			{
+				HandlePacket(address, m_receiveBuffer.data(), read, UdpConnection::Clock::now());
+				received_any = true;
+			}
+
+			FlushClients(UdpConnection::Clock::now());
+
+			if (!received_any)
+				std::this_thread::sleep_for(IdleSleep);
+		}
+	}
+
+	void UdpServer::HandlePacket(const IPAddress &address, const uint8_t *data, uint32_t size, UdpConnection::Clock::time_point now)
+	{
+		UdpPacketType type = (UdpPacketType)data[0];
+		uint64_t key = MakeKey(address);
+
+		if (type == UdpPacketType::Connect || type == UdpPacketType::Disconnect)
+		{
+			uint32_t protocol_id;
+			if (size < HandshakeSize)
+				return;
+			memcpy(&protocol_id, data + 1, sizeof(uint32_t));
+			if (protocol_id != ProtocolId)
+				return;
+
+			if (type == UdpPacketType::Connect)
+				Accept(address, now);
+			else
+				Disconnect(key);
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(m_clientsMutex);
+		auto it = m_clients.find(key);
+		if (it == m_clients.end())
+			return; // Not connected.
+
+		m_received.clear();
+		if (!it->second.connection.Receive(data, size, now, m_received))
+			return;
+		it->second.stats.bytesIn += size;
+		it->second.stats.messagesIn += m_received.size();
+		lock.unlock();
+
+		for (auto &message : m_received)
+		{
+			if (message.data.size() < NetworkMessage::FrameOverhead)
+				continue; // wrong message
+
+			MessageSlice frame = m_bufferPool.Acquire((uint32_t)message.data.size());
+			memcpy(frame.Data(), message.data.data(), message.data.size());
+			try
+			{
+				NetworkMessage msg;
+				msg.Deserialize(std::move(frame));
+				m_queue->EnqueueMessageReceived(msg);
+			}
+			catch (InvalidArgumentException &)
+			{
+				// The frame is shorter than its header says.
+			}
+		}
+	}
+
+	void UdpServer::Accept(const IPAddress &address, UdpConnection::Clock::time_point now)
+	{
+		uint64_t key = MakeKey(address);
+		uint32_t id;
+		bool is_new = false;
+		{
+			std::lock_guard<std::mutex> lock(m_clientsMutex);
+			auto it = m_clients.find(key);
+			if (it != m_clients.end())
+			{
+				// The accept was lost, the client asks again.
+				id = it->second.id;
+			}
+			else
+			{
+				if (m_freeIDs.empty())
+				{
+					m_rejected++;
+					return; // Server full, the client times out.
+				}
+				id = m_freeIDs.back();
+				m_freeIDs.pop_back();
+
+				Client client{ id, address, UdpConnection(now) };
+				client.stats.id = id;
+				client.stats.transport = Transport::Udp;
+				m_clients.insert({ key, std::move(client) });
+				m_accepted++;
+				is_new = true;
+			}
+		}
+
+		uint8_t accept[HandshakeSize + sizeof(uint32_t)];
+		WriteHandshake(accept, UdpPacketType::Accept);
+		memcpy(accept + HandshakeSize, &id, sizeof(uint32_t));
+		SendPacket(address, accept, sizeof(accept));
+
+		if (is_new)
+		{
+			NetworkMessage msg(id, DistributionMode::ID, id, (uint32_t)InternalTags::Connect, nullptr, 0);
+			m_queue->EnqueueConnection(msg);
+		}
+	}
+
+	void UdpServer::Disconnect(uint64_t key)
+	{
+		uint32_t id;
+		{
+			std::lock_guard<std::mutex> lock(m_clientsMutex);
+			auto it = m_clients.find(key);
+			if (it == m_clients.end())
+				return;
+			id = it->second.id;
+			const ConnectionStats &stats = it->second.stats;
+			m_removedTotals.bytesIn += stats.bytesIn;
+			m_removedTotals.bytesOut += stats.bytesOut;
+			m_removedTotals.messagesIn += stats.messagesIn;
+			m_removedTotals.messagesOut += stats.messagesOut;
+			m_clients.erase(it);
+			m_freeIDs.push_back(id);
+		}
+
+		NetworkMessage msg(id, DistributionMode::Others, id, (uint32_t)InternalTags::Disconnect, nullptr, 0);
+		m_queue->EnqueueDisconnection(msg);
+	}
+
+	void UdpServer::FlushClients(UdpConnection::Clock::time_point now)
+	{
+		std::vector<uint64_t> timed_out;
+		{
+			std::lock_guard<std::mutex> lock(m_clientsMutex);
+			for (auto &[key, client] : m_clients)
+			{
+				if (now - client.connection.GetLastReceiveTime() > Timeout)
+				{
+					timed_out.push_back(key);
+					continue;
+				}
+
+				m_outgoing.clear();
+				client.connection.CollectOutgoing(now, m_outgoing);
+				for (auto &packet : m_outgoing)
+				{
+					SendPacket(client.address, packet.data(), (uint32_t)packet.size());
+					client.stats.bytesOut += packet.size();
+				}
+				client.stats.sendQueueHighWater = std::max(client.stats.sendQueueHighWater, client.connection.GetPendingReliableBytes());
+			}
+		}
+
+		for (uint64_t key : timed_out)
+			Disconnect(key);
+	}
+
+	void UdpServer::SendPacket(const IPAddress &address, const uint8_t *data, uint32_t size)
+	{
+		// Lost like any other datagram if the send buffer is full, reliable data is resent.
+		int32_t sent;
+		m_socket->SendTo(data, (int32_t)size, sent, address);
+	}
+
+	UdpServer::Client *UdpServer::FindClient(uint32_t client_id)
+	{
+		for (auto &[key, client] : m_clients)
+		{
+			if (client.id == client_id)
+				return &client;
+		}
+		return nullptr;
+	}
+
+	uint64_t UdpServer::MakeKey(const IPAddress &address)
+	{
+		return (uint64_t(address.ToInteger()) << 16) | address.GetPort();
+	}
+}
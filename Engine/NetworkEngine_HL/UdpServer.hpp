@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "NetworkEngine_LL/UdpSocket.hpp"
+#include "MessageBuffer.hpp"
+#include "NetworkMessage.hpp"
+#include "NetworkStats.hpp"
+#include "UdpConnection.hpp"
+
+namespace inl::net
+{
+	class MessageQueue;
+	class Server;
+}
+
+namespace inl::net::servers
+{
+	using namespace sockets;
+
+	/// <summary> Serves clients over a single UDP socket, with the channels of <see cref="UdpConnection"/>. </summary>
+	/// <remarks>
+	/// A client sends Connect with the protocol ID and is answered with Accept and its ID.
+	/// Received messages go to the queue like the ones of the TCP server.
+	/// Clients that are silent for <see cref="Timeout"/> are disconnected.
+	/// </remarks>
+	class UdpServer
+	{
+		friend class inl::net::Server;
+
+	public:
+		static constexpr uint32_t ProtocolId = 0x494E4C55; // "INLU"
+		static constexpr std::chrono::seconds Timeout = std::chrono::seconds(10);
+
+	public:
+		UdpServer(uint32_t max_connections, uint16_t port, std::shared_ptr<MessageQueue> queue);
+		~UdpServer();
+
+		void Start();
+		void Stop();
+
+		/// <summary> Queues the message for one client, it goes out with the next update of the server thread. </summary>
+		/// <returns> False if there is no such client. </returns>
+		bool Send(uint32_t client_id, ChannelType channel, const NetworkMessage &msg);
+		void Broadcast(ChannelType channel, const NetworkMessage &msg);
+
+		/// <summary> Smoothed round trip time of the client in milliseconds, or a negative value if there is no such client. </summary>
+		float GetRoundTripTime(uint32_t client_id);
+		float GetPacketLoss(uint32_t client_id);
+
+		/// <summary> Adds the clients and the totals of the UDP side to the stats. </summary>
+		void GetStats(ServerStats &stats);
+
+	private:
+		struct Client
+		{
+			uint32_t id;
+			IPAddress address;
+			UdpConnection connection;
+			ConnectionStats stats; // Traffic, guarded by m_clientsMutex like the connection.
+		};
+
+		void Run();
+		void HandlePacket(const IPAddress &address, const uint8_t *data, uint32_t size, UdpConnection::Clock::time_point now);
+		void Accept(const IPAddress &address, UdpConnection::Clock::time_point now);
+		void Disconnect(uint64_t key);
+		void FlushClients(UdpConnection::Clock::time_point now);
+		void SendPacket(const IPAddress &address, const uint8_t *data, uint32_t size);
+		Client *FindClient(uint32_t client_id);
+
+		static uint64_t MakeKey(const IPAddress &address);
+
+	private:
+		std::unique_ptr<UdpSocket> m_socket;
+		uint32_t m_maxConnections;
+		uint16_t m_port;
+
+		std::unordered_map<uint64_t, Client> m_clients;
+		std::vector<uint32_t> m_freeIDs; // Smallest ID at the back.
+		std::mutex m_clientsMutex;
+		ConnectionStats m_removedTotals; // Traffic of the clients that are gone, guarded by m_clientsMutex.
+		uint64_t m_accepted = 0;
+		uint64_t m_rejected = 0;
+
+		std::thread m_thread;
+		std::atomic_bool m_run;
+
+		std::shared_ptr<MessageQueue> m_queue;
+		MessageBufferPool m_bufferPool;
+
+		// Only used by the server thread.
+		std::vector<uint8_t> m_receiveBuffer;
+		std::vector<std::vector<uint8_t>> m_outgoing;
+		std::vector<UdpConnection::ReceivedMessage> m_received;
+	};
+}
@@ -6,8 +6,9 @@
 #include <vector>
 #include <sstream>
 
-#include "Socket.hpp"
-#include "SecureSocket.hpp"
+#include "HttpConnection.hpp"
+
+#include "BaseLibrary/Exception/Exception.hpp"
 
 #undef DELETE
 
@@ -15,49 +16,96 @@ namespace inl::net::http
 {
 	using namespace sockets;
 
+	static HttpConnectionPool connectionPool;
+
 	Response Http::Send(Request const& request) 
+	{
+		return Send(request, {});
+	}
+
+	Response Http::Send(Request const& request, HttpParser::BodyCallback onBody)
 	{
 		// Send an HTTP request.  Auto-fill the content-length headers.
 		std::string string = Str(request);
-		
-		uint16_t port = 0;
-		std::unique_ptr<Socket> socket;
-		std::unique_ptr<SecureSocket> secure_socket;
-		bool secure = false;
-		if (request.GetUri().GetScheme() == "https") 
+		bool head = request.GetMethod() == Method::HEAD;
+
+		bool received_body = false;
+		HttpParser::BodyCallback forward;
+		if (onBody)
 		{
-			secure_socket.reset(new SecureSocket());
-			port = 443;
-			secure = true;
+			forward = [&](std::string_view data)
+			{
+				received_body = true;
+				onBody(data);
+			};
 		}
-		else if (request.GetUri().GetScheme() == "http") 
+
+		// An idle connection may have been closed by the server meanwhile, that is retried on a new one.
+		// Not if a part of the body was passed on already.
+		bool reused = true;
+		while (reused && !received_body)
 		{
-			socket.reset(new Socket(SocketType::Streaming));
-			port = 80;
+			std::unique_ptr<HttpConnection> connection = connectionPool.Acquire(request.GetUri(), reused);
+
+			Response response;
+			bool keep_alive;
+			if (connection->Send(string) && connection->ReadResponse(head, response, keep_alive, forward))
+			{
+				if (keep_alive)
+					connectionPool.Release(std::move(connection));
+				return response;
+			}
 		}
-		else
-			assert(!"unknown http scheme");
+		throw inl::RuntimeException("HTTP connection closed before the response.", request.GetUri().GetHost());
+	}
 
-		if (request.GetUri().GetPort())
-			port = request.GetUri().GetPort();
+	std::vector<Response> Http::Send(std::vector<Request> const& requests)
+	{
+		std::vector<Response> responses;
+		if (requests.empty())
+			return responses;
 
-		secure ? secure_socket->Connect(IPAddress(request.GetUri().GetHost(), port)) : socket->Connect(IPAddress(request.GetUri().GetHost(), port));
-		int32_t sent;
-		secure ? secure_socket->Recv((uint8_t*)string.c_str(), string.size(), sent) : socket->Send((uint8_t*)string.c_str(), string.size(), sent);
+		std::string key = HttpConnection::GetKey(requests[0].GetUri());
+		std::string strings;
+		for (auto& request : requests)
+		{
+			if (HttpConnection::GetKey(request.GetUri()) != key)
+				throw inl::InvalidArgumentException("Pipelined requests must go to the same host.", key);
+			strings += Str(request);
+		}
 
-		std::vector<char> buffer(16384); // 16 KiB
-		std::stringstream ss;
+		bool reused;
+		std::unique_ptr<HttpConnection> connection = connectionPool.Acquire(requests[0].GetUri(), reused);
+		bool keep_alive = connection->Send(strings);
+		while (keep_alive && responses.size() < requests.size())
+		{
+			Response response;
+			if (!connection->ReadResponse(requests[responses.size()].GetMethod() == Method::HEAD, response, keep_alive))
+				break;
+			responses.push_back(std::move(response));
+		}
+
+		if (keep_alive && responses.size() == requests.size())
+			connectionPool.Release(std::move(connection));
 
-		int32_t read;
-		do 
+		// The server closed the connection in the middle, the rest did not get an answer.
+		for (size_t i = responses.size(); i < requests.size(); i++)
+			responses.push_back(Send(requests[i]));
+		return responses;
+	}
+
+	jobs::Future<Response> Http::Send(jobs::Scheduler& scheduler, Request request)
+	{
+		// The sockets are blocking, the request occupies a worker until the response arrives.
+		return scheduler.Enqueue([](Request request)
 		{
-			secure ? secure_socket->Recv((uint8_t*)&buffer[0], buffer.size(), read) : socket->Recv((uint8_t*)&buffer[0], buffer.size(), read);
-			ss.write(&buffer[0], read);
-		} 
-		while (read > 0);
-		secure ? secure_socket->Close() : socket->Close();
+			return Send(request);
+		}, std::move(request));
+	}
 
-		return Response(ss.str());
+	void Http::CloseConnections()
+	{
+		connectionPool.Clear();
 	}
 
 	Response Http::Get(std::string const& path, std::string const& data) 
@@ -108,14 +156,14 @@ namespace inl::net::http
 		// Serialize a request to a string
 		std::stringstream ss;
 		auto path = request.GetPath().empty() ? "/" : request.GetPath();
-		ss << str_impl(request.GetMethod()) << ' ' << path << " HTTP/1.1\n";
-		ss << Headers::HOST << ": " << request.GetUri().GetHost() << "\n";
-		ss << Headers::CONTENT_LENGTH << ": " << request.GetData().size() << "\n";
-		ss << Headers::CONNECTION << ": close\n";
-		ss << Headers::ACCEPT_ENCODING << ": identity\n";
+		ss << str_impl(request.GetMethod()) << ' ' << path << " HTTP/1.1\r\n";
+		ss << Headers::HOST << ": " << request.GetUri().GetHost() << "\r\n";
+		ss << Headers::CONTENT_LENGTH << ": " << request.GetData().size() << "\r\n";
+		ss << Headers::CONNECTION << ": keep-alive\r\n";
+		ss << Headers::ACCEPT_ENCODING << ": identity\r\n";
 		for (auto header : request.GetHeaders())
-			ss << header.first << ": " << header.second << "\n";
-		ss << "\n";
+			ss << header.first << ": " << header.second << "\r\n";
+		ss << "\r\n";
 		ss << request.GetData();
 		return ss.str();
 	}
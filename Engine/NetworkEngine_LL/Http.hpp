@@ -2,9 +2,14 @@
 
 #pragma once
 
+#include "HttpParser.hpp"
 #include "Response.hpp"
 #include "Request.hpp"
 
+#include <BaseLibrary/JobSystem/Scheduler.hpp>
+
+#include <vector>
+
 namespace inl::net::http
 {
 	class Http
@@ -13,8 +18,23 @@ namespace inl::net::http
 		static Response Get(std::string const& path, std::string const& data = "");
 		static Response Post(std::string const& path, std::string const& data = "");
 
-	private:
+		/// <summary> Sends the request on a pooled keep-alive connection to its host. </summary>
+		/// <exception cref="RuntimeException"> If the host cannot be reached or closes before the whole response. </exception>
 		static Response Send(Request const& request);
+		/// <summary> Sends the request and passes the body to the callback as it arrives, without keeping it. </summary>
+		/// <exception cref="RuntimeException"> If the host cannot be reached or closes before the whole response. </exception>
+		static Response Send(Request const& request, HttpParser::BodyCallback onBody);
+		/// <summary> Sends the requests on one connection without waiting for the responses in between. </summary>
+		/// <remarks> Only pipeline requests that can be repeated, the ones after a failure are sent again one by one. </remarks>
+		/// <exception cref="InvalidArgumentException"> If the requests are not to the same host. </exception>
+		static std::vector<Response> Send(std::vector<Request> const& requests);
+		/// <summary> Sends the request from a job of the scheduler. </summary>
+		static jobs::Future<Response> Send(jobs::Scheduler& scheduler, Request request);
+
+		/// <summary> Closes the idle connections. </summary>
+		static void CloseConnections();
+
+	private:
 		static std::string Str(Request const& request);
 	};
 }
\ No newline at end of file
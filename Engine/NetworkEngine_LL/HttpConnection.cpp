@@ -0,0 +1,149 @@
+#include "HttpConnection.hpp"
+
+#include "Socket.hpp"
+#include "SecureSocket.hpp"
+
+#include "BaseLibrary/Exception/Exception.hpp"
+
+
+namespace inl::net::http
+{
+	using namespace sockets;
+
+	static constexpr size_t ReceiveSize = 16384; // 16 KiB
+
+	HttpConnection::HttpConnection(const Uri& uri)
+		: m_key(GetKey(uri))
+		, m_lastUsed(Clock::now())
+	{
+		uint16_t port = uri.GetPort();
+		bool connected;
+		if (uri.GetScheme() == "https")
+		{
+			m_secureSocket.reset(new SecureSocket());
+			connected = m_secureSocket->Connect(IPAddress(uri.GetHost(), port ? port : 443), uri.GetHost());
+		}
+		else if (uri.GetScheme() == "http")
+		{
+			m_socket.reset(new Socket(SocketType::Streaming));
+			connected = m_socket->Connect(IPAddress(uri.GetHost(), port ? port : 80));
+		}
+		else
+			throw inl::InvalidArgumentException("Unknown HTTP scheme.", uri.GetScheme());
+
+		if (!connected)
+			throw inl::RuntimeException("Could not connect to host.", uri.GetHost());
+	}
+
+	HttpConnection::~HttpConnection()
+	{
+		m_secureSocket ? m_secureSocket->Close() : m_socket->Close();
+	}
+
+	std::string HttpConnection::GetKey(const Uri& uri)
+	{
+		return uri.GetScheme() + "://" + uri.GetHost() + ":" + std::to_string(uri.GetPort());
+	}
+
+	const std::string& HttpConnection::GetKey() const
+	{
+		return m_key;
+	}
+
+	bool HttpConnection::Send(const std::string& data)
+	{
+		size_t offset = 0;
+		while (offset < data.size())
+		{
+			int32_t sent = 0;
+			uint8_t* bytes = (uint8_t*)data.data() + offset;
+			int32_t count = int32_t(data.size() - offset);
+			bool ok = m_secureSocket ? m_secureSocket->Send(bytes, count, sent) : m_socket->Send(bytes, count, sent);
+			if (!ok || sent <= 0)
+				return false;
+			offset += sent;
+		}
+		m_lastUsed = Clock::now();
+		return true;
+	}
+
+	bool HttpConnection::ReadResponse(bool head, Response& response, bool& keepAlive, HttpParser::BodyCallback onBody)
+	{
+		HttpParser parser(HttpParser::Mode::Response);
+		parser.SetNoBody(head);
+		if (onBody)
+			parser.SetBodyCallback(std::move(onBody));
+
+		// Left over from the previous response.
+		m_buffer.erase(0, parser.Feed(m_buffer));
+
+		char buffer[ReceiveSize];
+		while (!parser.IsComplete() && !parser.IsError())
+		{
+			int32_t read = 0;
+			bool ok = m_secureSocket ? m_secureSocket->Recv((uint8_t*)buffer, sizeof(buffer), read) : m_socket->Recv((uint8_t*)buffer, sizeof(buffer), read);
+			if (!ok || read <= 0)
+			{
+				parser.FinishInput();
+				break;
+			}
+
+			// The bytes after the response belong to the next pipelined one.
+			size_t consumed = parser.Feed(std::string_view(buffer, read));
+			m_buffer.append(buffer + consumed, read - consumed);
+		}
+
+		if (!parser.IsComplete())
+			return false;
+
+		response = parser.ToResponse();
+		keepAlive = parser.IsKeepAlive();
+		m_lastUsed = Clock::now();
+		return true;
+	}
+
+	HttpConnection::Clock::time_point HttpConnection::GetLastUsed() const
+	{
+		return m_lastUsed;
+	}
+
+	std::unique_ptr<HttpConnection> HttpConnectionPool::Acquire(const Uri& uri, bool& reused)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_idle.find(HttpConnection::GetKey(uri));
+			if (it != m_idle.end())
+			{
+				auto& connections = it->second;
+				HttpConnection::Clock::time_point now = HttpConnection::Clock::now();
+				while (!connections.empty())
+				{
+					std::unique_ptr<HttpConnection> connection = std::move(connections.back());
+					connections.pop_back();
+					if (now - connection->GetLastUsed() < IdleTimeout)
+					{
+						reused = true;
+						return connection;
+					}
+				}
+			}
+		}
+
+		reused = false;
+		return std::make_unique<HttpConnection>(uri);
+	}
+
+	void HttpConnectionPool::Release(std::unique_ptr<HttpConnection> connection)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto& connections = m_idle[connection->GetKey()];
+		if (connections.size() < MaxIdlePerHost)
+			connections.push_back(std::move(connection));
+	}
+
+	void HttpConnectionPool::Clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_idle.clear();
+	}
+}
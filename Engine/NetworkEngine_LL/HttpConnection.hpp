@@ -0,0 +1,79 @@
+#pragma once
+
+#include "HttpParser.hpp"
+#include "Response.hpp"
+#include "Uri.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace inl::net::sockets
+{
+	class Socket;
+	class SecureSocket;
+}
+
+namespace inl::net::http
+{
+	/// <summary> A connection to one host that can carry many requests. </summary>
+	/// <remarks>
+	/// Responses are parsed by <see cref="HttpParser"/> as they arrive, so the connection can be reused after them.
+	/// Bytes received after a response are kept for the next one, which allows pipelining.
+	/// </remarks>
+	class HttpConnection
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+	public:
+		/// <exception cref="RuntimeException"> If the host cannot be reached. </exception>
+		HttpConnection(const Uri& uri);
+		~HttpConnection();
+
+		/// <summary> Identifies the scheme, host and port the connection can serve. </summary>
+		static std::string GetKey(const Uri& uri);
+		const std::string& GetKey() const;
+
+		bool Send(const std::string& data);
+		/// <summary> Reads one whole response. </summary>
+		/// <param name="head"> Whether it answers a HEAD request, and so has no body whatever its headers say. </param>
+		/// <param name="keepAlive"> Whether the connection can be used for another request. </param>
+		/// <param name="onBody"> Receives the body as it arrives instead of the data of the response. </param>
+		/// <returns> False if the connection closed before the response was complete, or it is malformed. </returns>
+		bool ReadResponse(bool head, Response& response, bool& keepAlive, HttpParser::BodyCallback onBody = {});
+
+		Clock::time_point GetLastUsed() const;
+
+	private:
+		std::string m_key;
+		std::unique_ptr<sockets::Socket> m_socket;
+		std::unique_ptr<sockets::SecureSocket> m_secureSocket;
+		std::string m_buffer; // Received but not consumed.
+		Clock::time_point m_lastUsed;
+	};
+
+
+	/// <summary> Keeps idle keep-alive connections per host. Thread safe. </summary>
+	class HttpConnectionPool
+	{
+	public:
+		static constexpr size_t MaxIdlePerHost = 4;
+		static constexpr std::chrono::seconds IdleTimeout = std::chrono::seconds(30);
+
+	public:
+		/// <summary> Takes an idle connection to the host of the uri, or opens a new one. </summary>
+		/// <param name="reused"> Whether an idle connection was taken. The server may have closed it meanwhile. </param>
+		std::unique_ptr<HttpConnection> Acquire(const Uri& uri, bool& reused);
+		/// <summary> Puts a connection that finished its response back to the idle ones. </summary>
+		void Release(std::unique_ptr<HttpConnection> connection);
+		void Clear();
+
+	private:
+		std::unordered_map<std::string, std::vector<std::unique_ptr<HttpConnection>>> m_idle;
+		std::mutex m_mutex;
+	};
+}
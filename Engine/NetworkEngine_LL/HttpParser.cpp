@@ -0,0 +1,443 @@
+#include "HttpParser.hpp"
+
+#include "Cookies.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+#undef DELETE
+
+namespace inl::net::http
+{
+	static constexpr size_t MaxLineSize = 1024; // Chunk sizes and trailers.
+
+	static bool EqualsNoCase(std::string_view a, std::string_view b)
+	{
+		return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y)
+		{
+			return std::tolower((unsigned char)x) == std::tolower((unsigned char)y);
+		});
+	}
+
+	static bool ContainsNoCase(std::string_view text, std::string_view token)
+	{
+		return std::search(text.begin(), text.end(), token.begin(), token.end(), [](char x, char y)
+		{
+			return std::tolower((unsigned char)x) == std::tolower((unsigned char)y);
+		}) != text.end();
+	}
+
+	static std::string_view Trim(std::string_view text)
+	{
+		size_t first = text.find_first_not_of(" \t");
+		if (first == std::string_view::npos)
+			return {};
+		size_t last = text.find_last_not_of(" \t");
+		return text.substr(first, last - first + 1);
+	}
+
+	static bool ParseNumber(std::string_view text, int base, uint64_t& value)
+	{
+		value = 0;
+		if (text.empty() || text.size() > 16)
+			return false;
+		for (char ch : text)
+		{
+			int digit;
+			if (ch >= '0' && ch <= '9')
+				digit = ch - '0';
+			else if (base == 16 && ch >= 'a' && ch <= 'f')
+				digit = ch - 'a' + 10;
+			else if (base == 16 && ch >= 'A' && ch <= 'F')
+				digit = ch - 'A' + 10;
+			else
+				return false;
+			value = value * base + digit;
+		}
+		return true;
+	}
+
+	HttpParser::HttpParser(Mode mode)
+		: m_mode(mode)
+	{
+	}
+
+	void HttpParser::SetHeadersCallback(HeadersCallback callback)
+	{
+		m_headersCallback = std::move(callback);
+	}
+
+	void HttpParser::SetBodyCallback(BodyCallback callback)
+	{
+		m_bodyCallback = std::move(callback);
+	}
+
+	void HttpParser::SetNoBody(bool noBody)
+	{
+		m_noBody = noBody;
+	}
+
+	size_t HttpParser::Feed(std::string_view data)
+	{
+		size_t consumed = 0;
+		while (consumed < data.size() && m_state != State::Complete && m_state != State::Error)
+		{
+			std::string_view rest = data.substr(consumed);
+			size_t count = 0;
+			std::string_view line;
+
+			switch (m_state)
+			{
+				case State::Head:
+					count = FeedHead(rest);
+					break;
+				case State::Body:
+				case State::ChunkData:
+					count = (size_t)std::min<uint64_t>(m_remaining, rest.size());
+					EmitBody(rest.substr(0, count));
+					m_remaining -= count;
+					if (m_remaining == 0)
+						m_state = m_state == State::Body ? State::Complete : State::ChunkEnd;
+					break;
+				case State::UntilClose:
+					count = rest.size();
+					EmitBody(rest);
+					break;
+				case State::ChunkSize:
+					if (FeedLine(rest, count, line))
+					{
+						// Chunk extensions after ';' are ignored.
+						if (!ParseNumber(Trim(line.substr(0, line.find(';'))), 16, m_remaining))
+							Fail();
+						else
+							m_state = m_remaining == 0 ? State::Trailers : State::ChunkData;
+						m_line.clear();
+					}
+					break;
+				case State::ChunkEnd:
+					if (FeedLine(rest, count, line))
+					{
+						if (!line.empty())
+							Fail();
+						else
+							m_state = State::ChunkSize;
+						m_line.clear();
+					}
+					break;
+				case State::Trailers:
+					if (FeedLine(rest, count, line))
+					{
+						if (line.empty())
+							m_state = State::Complete;
+						m_line.clear();
+					}
+					break;
+				default:
+					break;
+			}
+			consumed += count;
+		}
+		return consumed;
+	}
+
+	void HttpParser::FinishInput()
+	{
+		if (m_state == State::UntilClose)
+			m_state = State::Complete;
+		else if (m_state != State::Complete)
+			Fail();
+	}
+
+	void HttpParser::Reset()
+	{
+		m_state = State::Head;
+		m_head.clear();
+		for (auto& part : m_startLine)
+			part = {};
+		m_headers.clear();
+		m_status = HttpStatus::INVALID_CODE;
+		m_keepAlive = true;
+		m_remaining = 0;
+		m_line.clear();
+		m_body.clear();
+	}
+
+	HttpParser::State HttpParser::GetState() const
+	{
+		return m_state;
+	}
+
+	bool HttpParser::IsHeadComplete() const
+	{
+		return m_state != State::Head && m_state != State::Error;
+	}
+
+	bool HttpParser::IsComplete() const
+	{
+		return m_state == State::Complete;
+	}
+
+	bool HttpParser::IsError() const
+	{
+		return m_state == State::Error;
+	}
+
+	bool HttpParser::IsKeepAlive() const
+	{
+		return m_keepAlive;
+	}
+
+	std::string_view HttpParser::GetMethod() const
+	{
+		return m_mode == Mode::Request ? m_startLine[0] : std::string_view{};
+	}
+
+	std::string_view HttpParser::GetTarget() const
+	{
+		return m_mode == Mode::Request ? m_startLine[1] : std::string_view{};
+	}
+
+	HttpStatus HttpParser::GetStatus() const
+	{
+		return m_status;
+	}
+
+	std::string_view HttpParser::GetVersion() const
+	{
+		return m_mode == Mode::Request ? m_startLine[2] : m_startLine[0];
+	}
+
+	std::string_view HttpParser::GetHeader(std::string_view name) const
+	{
+		for (auto& [key, value] : m_headers)
+		{
+			if (EqualsNoCase(key, name))
+				return value;
+		}
+		return {};
+	}
+
+	bool HttpParser::HasHeader(std::string_view name) const
+	{
+		return std::any_of(m_headers.begin(), m_headers.end(), [&](auto& header) { return EqualsNoCase(header.first, name); });
+	}
+
+	const std::vector<std::pair<std::string_view, std::string_view>>& HttpParser::GetHeaders() const
+	{
+		return m_headers;
+	}
+
+	const std::string& HttpParser::GetBody() const
+	{
+		return m_body;
+	}
+
+	Request HttpParser::ToRequest() const
+	{
+		static const std::pair<std::string_view, Method> methods[] = {
+			{ "GET", Method::GET },
+			{ "HEAD", Method::HEAD },
+			{ "POST", Method::POST },
+			{ "PUT", Method::PUT },
+			{ "DELETE", Method::DELETE },
+			{ "TRACE", Method::TRACE },
+			{ "CONNECT", Method::CONNECT },
+		};
+
+		Request request;
+		for (auto& [name, method] : methods)
+		{
+			if (name == GetMethod())
+				request.SetMethod(method);
+		}
+
+		std::string target(GetTarget());
+		if (!target.empty() && target[0] == '/')
+			target = "http://" + std::string(GetHeader("Host")) + target;
+		request.SetUri(Uri(target));
+
+		for (auto& [name, value] : m_headers)
+			request.AddHeader(std::string(name), std::string(value));
+		request.SetData(m_body);
+		return request;
+	}
+
+	Response HttpParser::ToResponse() const
+	{
+		Response response;
+		response.SetStatus(m_status);
+		for (auto& [name, value] : m_headers)
+		{
+			response.SetHeader(std::string(name), std::string(value));
+			if (EqualsNoCase(name, "Set-Cookie"))
+				response.SetCookie(Cookie(std::string(value)));
+		}
+		response.SetData(m_body);
+		return response;
+	}
+
+	size_t HttpParser::FeedHead(std::string_view data)
+	{
+		// Empty lines before a request are ignored.
+		size_t skipped = 0;
+		if (m_head.empty())
+		{
+			while (skipped < data.size() && (data[skipped] == '\r' || data[skipped] == '\n'))
+				skipped++;
+			data = data.substr(skipped);
+		}
+
+		size_t old_size = m_head.size();
+		m_head.append(data);
+
+		size_t end = m_head.find("\r\n\r\n", old_size < 3 ? 0 : old_size - 3);
+		if (end == std::string::npos)
+		{
+			if (m_head.size() > MaxHeadSize)
+				Fail();
+			return skipped + data.size();
+		}
+
+		end += 4;
+		m_head.resize(end);
+		if (!ParseHead())
+			Fail();
+		return skipped + (end - old_size);
+	}
+
+	bool HttpParser::ParseHead()
+	{
+		std::string_view head = m_head;
+		size_t line_end = head.find("\r\n");
+		std::string_view start_line = head.substr(0, line_end);
+
+		// The reason phrase of a response may contain spaces, it is whatever follows the second one.
+		size_t first_space = start_line.find(' ');
+		size_t second_space = first_space == std::string_view::npos ? first_space : start_line.find(' ', first_space + 1);
+		if (first_space == std::string_view::npos || (m_mode == Mode::Request && second_space == std::string_view::npos))
+			return false;
+		m_startLine[0] = start_line.substr(0, first_space);
+		m_startLine[1] = start_line.substr(first_space + 1, second_space == std::string_view::npos ? std::string_view::npos : second_space - first_space - 1);
+		m_startLine[2] = second_space == std::string_view::npos ? std::string_view{} : start_line.substr(second_space + 1);
+
+		std::string_view version = GetVersion();
+		if (version.substr(0, 7) != "HTTP/1.")
+			return false;
+
+		if (m_mode == Mode::Response)
+		{
+			uint64_t status;
+			if (m_startLine[1].size() != 3 || !ParseNumber(m_startLine[1], 10, status))
+				return false;
+			m_status = (HttpStatus)status;
+		}
+
+		m_headers.clear();
+		size_t position = line_end + 2;
+		while (position < head.size())
+		{
+			line_end = head.find("\r\n", position);
+			std::string_view line = head.substr(position, line_end - position);
+			position = line_end + 2;
+			if (line.empty())
+				break;
+
+			size_t colon = line.find(':');
+			if (colon == std::string_view::npos || colon == 0 || line.substr(0, colon).find_first_of(" \t") != std::string_view::npos)
+				return false; // Includes obsolete folded lines.
+			m_headers.push_back({ line.substr(0, colon), Trim(line.substr(colon + 1)) });
+		}
+
+		// Interim responses are skipped, the final one follows on the same connection.
+		if (m_mode == Mode::Response && (int)m_status >= 100 && (int)m_status < 200 && m_status != HttpStatus::SWITCHING_PROTOCOLS)
+		{
+			m_head.clear();
+			m_headers.clear();
+			return true;
+		}
+
+		std::string_view connection = GetHeader("Connection");
+		m_keepAlive = version == "HTTP/1.0" ? ContainsNoCase(connection, "keep-alive") : !ContainsNoCase(connection, "close");
+
+		if (m_headersCallback)
+			m_headersCallback(*this);
+		StartBody();
+		return m_state != State::Error;
+	}
+
+	void HttpParser::StartBody()
+	{
+		int status = (int)m_status;
+		if (m_mode == Mode::Response && (m_noBody || status == 101 || status == 204 || status == 304))
+		{
+			m_state = State::Complete;
+			return;
+		}
+
+		if (ContainsNoCase(GetHeader("Transfer-Encoding"), "chunked"))
+		{
+			m_state = State::ChunkSize;
+			return;
+		}
+
+		if (HasHeader("Content-Length"))
+		{
+			if (!ParseNumber(GetHeader("Content-Length"), 10, m_remaining))
+			{
+				Fail();
+				return;
+			}
+			m_state = m_remaining == 0 ? State::Complete : State::Body;
+			return;
+		}
+
+		if (m_mode == Mode::Response)
+		{
+			// Delimited by the server closing the connection.
+			m_state = State::UntilClose;
+			m_keepAlive = false;
+		}
+		else
+			m_state = State::Complete;
+	}
+
+	bool HttpParser::FeedLine(std::string_view data, size_t& consumed, std::string_view& line)
+	{
+		size_t newline = data.find('\n');
+		if (newline == std::string_view::npos)
+		{
+			m_line.append(data);
+			consumed = data.size();
+			if (m_line.size() > MaxLineSize)
+				Fail();
+			return false;
+		}
+
+		consumed = newline + 1;
+		if (m_line.empty())
+			line = data.substr(0, newline);
+		else
+		{
+			m_line.append(data.substr(0, newline));
+			line = m_line;
+		}
+		if (!line.empty() && line.back() == '\r')
+			line.remove_suffix(1);
+		return true;
+	}
+
+	void HttpParser::EmitBody(std::string_view data)
+	{
+		if (data.empty())
+			return;
+		if (m_bodyCallback)
+			m_bodyCallback(data);
+		else
+			m_body.append(data);
+	}
+
+	void HttpParser::Fail()
+	{
+		m_state = State::Error;
+	}
+}
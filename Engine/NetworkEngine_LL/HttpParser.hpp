@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Request.hpp"
+#include "Response.hpp"
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace inl::net::http
+{
+	/// <summary> Parses an HTTP/1.1 request or response incrementally, as its bytes arrive. </summary>
+	/// <remarks>
+	/// The head is collected until it is complete, then the start line and headers are available as views into it.
+	/// The body is passed to the body callback in the pieces it arrived in, without copying.
+	/// Without a body callback it is collected and available with <see cref="GetBody"/>.
+	/// After a message is complete, <see cref="Feed"/> consumes nothing more, call <see cref="Reset"/> and
+	/// feed the rest for the next message on the same connection.
+	/// </remarks>
+	class HttpParser
+	{
+	public:
+		enum class Mode
+		{
+			Request,
+			Response,
+		};
+
+		enum class State
+		{
+			Head,
+			Body,
+			ChunkSize,
+			ChunkData,
+			ChunkEnd,
+			Trailers,
+			UntilClose,
+			Complete,
+			Error,
+		};
+
+		using HeadersCallback = std::function<void(const HttpParser&)>;
+		using BodyCallback = std::function<void(std::string_view)>;
+
+		static constexpr size_t MaxHeadSize = 64 * 1024;
+
+	public:
+		HttpParser(Mode mode);
+
+		/// <summary> Called once the head is complete, before any of the body. </summary>
+		void SetHeadersCallback(HeadersCallback callback);
+		void SetBodyCallback(BodyCallback callback);
+		/// <summary> The response answers a HEAD request, it has no body whatever its headers say. </summary>
+		void SetNoBody(bool noBody = true);
+
+		/// <summary> Parses the bytes. </summary>
+		/// <returns> How many of them belong to the current message. </returns>
+		size_t Feed(std::string_view data);
+		/// <summary> The peer closed the connection, which ends a body without length. </summary>
+		void FinishInput();
+		/// <summary> Starts over for the next message, the callbacks are kept. </summary>
+		void Reset();
+
+		State GetState() const;
+		bool IsHeadComplete() const;
+		bool IsComplete() const;
+		bool IsError() const;
+		/// <summary> Whether the connection can carry another message after this one. </summary>
+		bool IsKeepAlive() const;
+
+		std::string_view GetMethod() const;
+		std::string_view GetTarget() const;
+		HttpStatus GetStatus() const;
+		std::string_view GetVersion() const;
+		/// <summary> The value of the first header with the name, compared case insensitively. Empty if there is none. </summary>
+		std::string_view GetHeader(std::string_view name) const;
+		bool HasHeader(std::string_view name) const;
+		const std::vector<std::pair<std::string_view, std::string_view>>& GetHeaders() const;
+		/// <summary> The body collected when there is no body callback. </summary>
+		const std::string& GetBody() const;
+
+		/// <summary> Builds a request out of the parsed one. Only valid in request mode once complete. </summary>
+		Request ToRequest() const;
+		/// <summary> Builds a response out of the parsed one. Only valid in response mode once complete. </summary>
+		Response ToResponse() const;
+
+	private:
+		size_t FeedHead(std::string_view data);
+		bool ParseHead();
+		void StartBody();
+		bool FeedLine(std::string_view data, size_t& consumed, std::string_view& line);
+		void EmitBody(std::string_view data);
+		void Fail();
+
+	private:
+		Mode m_mode;
+		State m_state = State::Head;
+		bool m_noBody = false;
+
+		std::string m_head;
+		std::string_view m_startLine[3];
+		std::vector<std::pair<std::string_view, std::string_view>> m_headers;
+		HttpStatus m_status = HttpStatus::INVALID_CODE;
+		bool m_keepAlive = true;
+
+		uint64_t m_remaining = 0; // Of the body or the current chunk.
+		std::string m_line; // Chunk size or trailer line split between feeds.
+		std::string m_body;
+
+		HeadersCallback m_headersCallback;
+		BodyCallback m_bodyCallback;
+	};
+}
@@ -3,36 +3,117 @@
 #include <BaseLibrary/Exception/Exception.hpp>
 
 #include <cassert>
+#include <mutex>
+#include <unordered_map>
 
 namespace inl::net::sockets
 {
+	namespace
+	{
+		// Sessions of finished handshakes by host, offered again to resume.
+		class SessionCache
+		{
+		public:
+			~SessionCache()
+			{
+				Clear();
+			}
+
+			SSL_SESSION* Take(const std::string& key)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				auto it = m_sessions.find(key);
+				if (it == m_sessions.end())
+					return nullptr;
+				SSL_SESSION* session = it->second;
+				m_sessions.erase(it);
+				return session;
+			}
+
+			void Put(const std::string& key, SSL_SESSION* session)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				auto it = m_sessions.find(key);
+				if (it != m_sessions.end())
+				{
+					SSL_SESSION_free(it->second);
+					it->second = session;
+					return;
+				}
+				if (m_sessions.size() >= SecureSocket::MaxCachedSessions)
+				{
+					SSL_SESSION_free(m_sessions.begin()->second);
+					m_sessions.erase(m_sessions.begin());
+				}
+				m_sessions.insert({ key, session });
+			}
+
+			void Clear()
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				for (auto& [key, session] : m_sessions)
+					SSL_SESSION_free(session);
+				m_sessions.clear();
+			}
+
+		private:
+			std::unordered_map<std::string, SSL_SESSION*> m_sessions;
+			std::mutex m_mutex;
+		};
+
+		SessionCache sessionCache;
+	}
+
+	SSL_CTX* SecureSocket::GetContext()
+	{
+		static SSL_CTX* context = []
+		{
+			// Intitialize the SSL client-side library once per process
+			SSL_library_init();
+			SSL_load_error_strings();
+			ERR_load_BIO_strings();
+
+			SSL_CTX* context = SSL_CTX_new(SSLv23_client_method());
+			if (!context)
+				throw inl::RuntimeException("Could not create the TLS context.");
+			SSL_CTX_set_options(context, SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3 | SSL_OP_NO_COMPRESSION);
+			SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_CLIENT);
+			return context;
+		}();
+		return context;
+	}
+
 	SecureSocket::SecureSocket()
-		: m_context(0), m_conn(0), m_eof(false) 
+		: m_conn(0), m_eof(false) 
 	{
 		m_socket = std::make_unique<Socket>(SocketType::Streaming);
 
-		// Intitialize the SSL client-side socket
-		SSL_library_init();
-		SSL_load_error_strings();
-		ERR_load_BIO_strings();
+		m_conn = SSL_new(GetContext());
+		if (!m_conn)
+			throw inl::RuntimeException("Could not create the TLS connection.");
+
+		m_in = BIO_new(BIO_s_mem());
+		m_out = BIO_new(BIO_s_mem());
+		SSL_set_bio(m_conn, m_in, m_out); // The connection owns the BIOs.
+		SSL_set_connect_state(m_conn);
 	}
 
-	bool SecureSocket::Connect(const IPAddress & addrStr)
+	SecureSocket::~SecureSocket()
 	{
-		if (!m_context) 
-		{
-			m_context = SSL_CTX_new(SSLv23_client_method());
-			assert(m_context);
-		}
-		if (!m_conn) 
-		{
-			m_conn = SSL_new(m_context);
-			assert(m_conn);
+		SSL_free(m_conn);
+	}
+
+	bool SecureSocket::Connect(const IPAddress & addrStr, const std::string& hostName)
+	{
+		m_sessionKey = (hostName.empty() ? addrStr.ToString() : hostName) + ":" + std::to_string(addrStr.GetPort());
+		if (!hostName.empty())
+			SSL_set_tlsext_host_name(m_conn, hostName.c_str());
 
-			m_in = BIO_new(BIO_s_mem());
-			m_out = BIO_new(BIO_s_mem());
-			SSL_set_bio(m_conn, m_in, m_out);
-			SSL_set_connect_state(m_conn);
+		// If the server does not accept it anymore, the handshake falls back to a full one.
+		if (SSL_SESSION* session = sessionCache.Take(m_sessionKey))
+		{
+			SSL_set_session(m_conn, session);
+			SSL_SESSION_free(session);
 		}
 
 		return m_socket->Connect(addrStr);
@@ -50,14 +131,25 @@ namespace inl::net::sockets
 
 	bool SecureSocket::Send(uint8_t* data, int32_t count, int32_t &sent, int flags)
 	{
-		sent = SSL_write(m_conn, data, count);
-		SendFromBio(); // Write data if available
-		if (sent < 0) 
+		while (true)
 		{
-			HandleReturn(sent);
-			return true;
+			sent = SSL_write(m_conn, data, count);
+			if (!SendFromBio(flags)) // Write data if available
+			{
+				sent = 0;
+				return false;
+			}
+			if (sent > 0)
+			{
+				StoreSession();
+				return true;
+			}
+			if (!HandleReturn(sent))
+			{
+				sent = 0;
+				return false;
+			}
 		}
-		return sent > 0;
 	}
 
 	bool SecureSocket::SendRaw(uint8_t * buf, size_t len, int flags)
@@ -70,59 +162,61 @@ namespace inl::net::sockets
 	bool SecureSocket::SendFromBio(int flags)
 	{
 		uint8_t buf[4096];
-		size_t pending = BIO_ctrl_pending(m_out);
-		if (!pending) 
-			return true;
-		size_t bytes = BIO_read(m_out, buf, sizeof(buf));
-		if (bytes > 0) 
-			return SendRaw(buf, bytes, flags);
-		else if (bytes == -1 || bytes == 0)
-			return true;
-		return false;
+		while (BIO_ctrl_pending(m_out) > 0)
+		{
+			int bytes = BIO_read(m_out, buf, sizeof(buf));
+			if (bytes <= 0)
+				break;
+			if (!SendRaw(buf, bytes, flags))
+				return false;
+		}
+		return true;
 	}
 
 	bool SecureSocket::RecvToBio(int flags)
 	{
 		uint8_t buf[4096];
-		size_t bytes = m_socket->Recv(buf, sizeof(buf), flags);
-		if (bytes > 0) 
+		int32_t bytes = 0;
+		if (!m_socket->Recv(buf, sizeof(buf), bytes) || bytes == 0)
 		{
-			size_t written = BIO_write(m_in, buf, int(bytes));
-			assert(bytes == written);
-			return true;
-		}
-		else if (bytes == 0) 
-		{
-			// No data
+			// Closed by the peer
 			m_eof = true;
-			return true;
+			return false;
 		}
-		return false;
+
+		int written = BIO_write(m_in, buf, bytes);
+		assert(bytes == written);
+		return true;
 	}
 
-	void SecureSocket::HandleReturn(size_t ret)
+	bool SecureSocket::HandleReturn(int ret)
 	{
 		int32_t err = SSL_get_error(m_conn, ret);
 		if (SSL_ERROR_WANT_WRITE == err)
-			SendFromBio();
+			return SendFromBio();
 		else if (SSL_ERROR_WANT_READ == err)
-			RecvToBio();
+			return SendFromBio() && RecvToBio();
 		else if (SSL_ERROR_SSL == err)
-			throw inl::RuntimeException();
-		else
-			assert(!"unexpected error");
+			throw inl::RuntimeException("TLS error.", ERR_error_string(ERR_get_error(), nullptr));
+		return false; // Closed or failed
 	}
 
 	bool SecureSocket::Recv(uint8_t* data, int32_t count, int32_t &read, int flags)
 	{
-		read = SSL_read(m_conn, data, count);
-		if (read < 0) 
+		while (true)
 		{
-			HandleReturn(read);
-			if (m_eof) 
+			read = SSL_read(m_conn, data, count);
+			if (read > 0)
+			{
+				StoreSession();
+				return true;
+			}
+			if (!HandleReturn(read))
+			{
+				read = 0;
 				return false;
+			}
 		}
-		return read > 0;
 	}
 
 	bool SecureSocket::Wait(SocketWaitConditions cond, std::chrono::milliseconds t) const
@@ -145,21 +239,37 @@ namespace inl::net::sockets
 		return m_socket->GetPort();
 	}
 
+	bool SecureSocket::IsSessionReused() const
+	{
+		return SSL_session_reused(m_conn) != 0;
+	}
+
 	void SecureSocket::UseCertificateFile(std::string const & path)
 	{
-		if (!m_context) 
-			assert(!"not initialized yet");
-		if (SSL_CTX_use_certificate_file(m_context, path.c_str(), SSL_FILETYPE_PEM) <= 0) 
-			throw inl::RuntimeException();
+		if (SSL_use_certificate_file(m_conn, path.c_str(), SSL_FILETYPE_PEM) <= 0) 
+			throw inl::RuntimeException("Could not load the certificate.", path);
 	}
 
 	void SecureSocket::UsePrivateKeyFile(std::string const & path)
 	{
-		if (!m_context)
-			assert(!"not initialized yet");
-		if (SSL_CTX_use_PrivateKey_file(m_context, path.c_str(), SSL_FILETYPE_PEM) <= 0)
-			throw inl::RuntimeException();
-		if (!SSL_CTX_check_private_key(m_context))
-			throw inl::RuntimeException();
+		if (SSL_use_PrivateKey_file(m_conn, path.c_str(), SSL_FILETYPE_PEM) <= 0)
+			throw inl::RuntimeException("Could not load the private key.", path);
+		if (!SSL_check_private_key(m_conn))
+			throw inl::RuntimeException("The private key does not match the certificate.", path);
+	}
+
+	void SecureSocket::ClearSessionCache()
+	{
+		sessionCache.Clear();
+	}
+
+	void SecureSocket::StoreSession()
+	{
+		if (m_sessionStored || m_sessionKey.empty() || !SSL_is_init_finished(m_conn))
+			return;
+
+		if (SSL_SESSION* session = SSL_get1_session(m_conn))
+			sessionCache.Put(m_sessionKey, session);
+		m_sessionStored = true;
 	}
-}
\ No newline at end of file
+}
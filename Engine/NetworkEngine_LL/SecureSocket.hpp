@@ -6,41 +6,63 @@
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 
+#include <string>
+
 namespace inl::net::sockets
 {
 	using namespace enums;
 	using namespace sockets;
 
+	/// <summary> A TLS client connection. </summary>
+	/// <remarks>
+	/// All of them share one SSL_CTX. The session of every finished handshake is cached by host, and the next
+	/// connection to the same host offers it to resume without a full handshake.
+	/// </remarks>
 	class SecureSocket
 	{
+	public:
+		static constexpr size_t MaxCachedSessions = 64;
+
 	public:
 		SecureSocket();
+		~SecureSocket();
 
-		bool Connect(const IPAddress& addr);
+		/// <param name="hostName"> Sent for SNI and names the cached session. The address is used if empty. </param>
+		bool Connect(const IPAddress& addr, const std::string& hostName = "");
 		bool Close() const;
 		bool HasPendingData(uint32_t& pendingDataSize) const;
-		bool Send(uint8_t* data, int32_t count, int32_t &sent, int flags = 0); // Execute 1 write() syscall
-		bool Recv(uint8_t* data, int32_t count, int32_t &read, int flags = 0); // Execte 1 read() syscall
+		bool Send(uint8_t* data, int32_t count, int32_t &sent, int flags = 0); // Runs the handshake first if needed
+		bool Recv(uint8_t* data, int32_t count, int32_t &read, int flags = 0); // Blocks until some data or the end
 		bool Wait(SocketWaitConditions cond, std::chrono::milliseconds t) const;
 		SocketConnectionState GetConnectionState() const;
 		void GetAddress(IPAddress& outAddr) const;
 		int32_t GetPort() const;
+		/// <summary> Whether the handshake resumed a cached session. </summary>
+		bool IsSessionReused() const;
 
+		/// <summary> Applies to this connection only, the context is shared. </summary>
 		void UseCertificateFile(std::string const& path);
 		void UsePrivateKeyFile(std::string const& path);
 
+		static void ClearSessionCache();
+
 	private:
 		bool SendRaw(uint8_t* buf, size_t len, int flags = 0);
 		bool SendFromBio(int flags = 0);
 		bool RecvToBio(int flags = 0);
-		void HandleReturn(size_t ret);
+		/// <returns> False if the connection cannot continue after the error. </returns>
+		bool HandleReturn(int ret);
+		void StoreSession();
+
+		static SSL_CTX* GetContext();
 
 		std::unique_ptr<Socket> m_socket;
 
-		SSL_CTX* m_context;
 		SSL* m_conn;
 		BIO* m_in;
 		BIO* m_out;
 		bool m_eof;
+		std::string m_sessionKey;
+		bool m_sessionStored = false;
 	};
-}
\ No newline at end of file
+}
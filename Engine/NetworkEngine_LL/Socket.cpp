@@ -147,6 +147,8 @@ namespace inl::net::sockets
 			read = 0;
 			return false;
 		}
+		else
+			srcAddr = IPAddress(ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port));
 
 		m_lastActivityTime = std::chrono::system_clock::now().time_since_epoch().count();
 
@@ -320,8 +322,8 @@ namespace inl::net::sockets
 	SocketReturn Socket::HasState(SocketParam state, std::chrono::milliseconds t)
 	{
 		timeval time;
-		time.tv_sec = t.count();
-		time.tv_usec = t.count() * 1000 + t.count();
+		time.tv_sec = long(t.count() / 1000);
+		time.tv_usec = long(t.count() % 1000) * 1000;
 
 		fd_set socketSet;
 
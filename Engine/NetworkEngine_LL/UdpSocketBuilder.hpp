@@ -135,7 +135,7 @@ namespace inl::net::sockets
 
 				if (Error)
 					throw inl::RuntimeException("Couldnt create socket"); // make parameter a string depending on the error
-				return std::make_unique<UdpSocket>();
+				return std::make_unique<UdpSocket>(soc.release());
 			}
 			return std::unique_ptr<UdpSocket>(nullptr);
 		}
@@ -0,0 +1,81 @@
+#include "BulletTaskScheduler.hpp"
+
+#if INL_BULLET_MULTITHREADED
+
+#include <BaseLibrary/JobSystem/Parallel.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace inl::pxeng_bl {
+
+
+BulletTaskScheduler::BulletTaskScheduler(jobs::Scheduler& scheduler)
+	: btITaskScheduler("InlineJobs"), m_scheduler(scheduler) {
+	m_numThreads = getMaxNumThreads();
+}
+
+
+void BulletTaskScheduler::Install(jobs::Scheduler& scheduler) {
+	static std::mutex mtx;
+	static std::unique_ptr<BulletTaskScheduler> installed;
+
+	std::lock_guard<std::mutex> lkg(mtx);
+	if (installed && &installed->m_scheduler == &scheduler) {
+		return;
+	}
+	auto taskScheduler = std::make_unique<BulletTaskScheduler>(scheduler);
+	btSetTaskScheduler(taskScheduler.get());
+	installed = std::move(taskScheduler);
+}
+
+
+int BulletTaskScheduler::getMaxNumThreads() const {
+	// Bullet keeps per thread data for this many threads.
+	return std::min<int>(std::max(1u, std::thread::hardware_concurrency()), BT_MAX_THREAD_COUNT);
+}
+
+
+int BulletTaskScheduler::getNumThreads() const {
+	return m_numThreads;
+}
+
+
+void BulletTaskScheduler::setNumThreads(int numThreads) {
+	m_numThreads = std::clamp(numThreads, 1, getMaxNumThreads());
+}
+
+
+void BulletTaskScheduler::parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) {
+	size_t count = iEnd > iBegin ? size_t(iEnd - iBegin) : 0;
+	jobs::CooperativeFor(&m_scheduler, count, size_t(std::max(1, grainSize)), [iBegin, &body](size_t first, size_t last) {
+		body.forLoop(iBegin + int(first), iBegin + int(last));
+	});
+}
+
+
+btScalar BulletTaskScheduler::parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) {
+	size_t count = iEnd > iBegin ? size_t(iEnd - iBegin) : 0;
+	size_t chunkSize = size_t(std::max(1, grainSize));
+
+	// Partial sums are added in chunk order so that the result does not depend on the threads.
+	std::vector<btScalar> partials((count + chunkSize - 1) / chunkSize, btScalar(0));
+	jobs::CooperativeFor(&m_scheduler, count, chunkSize, [iBegin, chunkSize, &body, &partials](size_t first, size_t last) {
+		partials[first / chunkSize] = body.sumLoop(iBegin + int(first), iBegin + int(last));
+	});
+
+	btScalar sum = btScalar(0);
+	for (btScalar partial : partials) {
+		sum += partial;
+	}
+	return sum;
+}
+
+
+} // namespace inl::pxeng_bl
+
+#endif
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "BulletThreading.hpp"
+
+#if INL_BULLET_MULTITHREADED
+
+#include <LinearMath/btThreads.h>
+
+
+namespace inl::jobs {
+class Scheduler;
+}
+
+
+namespace inl::pxeng_bl {
+
+
+/// <summary> Runs the parallel loops of Bullet as jobs, so that physics shares the thread pool of the engine. </summary>
+/// <remarks> The calling thread works on the loop as well, see <see cref="jobs::CooperativeFor"/>. </remarks>
+class BulletTaskScheduler : public btITaskScheduler {
+public:
+	BulletTaskScheduler(jobs::Scheduler& scheduler);
+
+	/// <summary> Makes the scheduler the one Bullet uses, for all scenes. </summary>
+	/// <remarks> Bullet only has a single global task scheduler, the last installed one wins. </remarks>
+	static void Install(jobs::Scheduler& scheduler);
+
+	int getMaxNumThreads() const override;
+	int getNumThreads() const override;
+	void setNumThreads(int numThreads) override;
+
+	void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override;
+	btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override;
+
+private:
+	jobs::Scheduler& m_scheduler;
+	int m_numThreads;
+};
+
+
+} // namespace inl::pxeng_bl
+
+#endif
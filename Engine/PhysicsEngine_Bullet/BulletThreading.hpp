@@ -0,0 +1,20 @@
+#pragma once
+
+#include <LinearMath/btScalar.h>
+
+
+// The multithreaded world of Bullet needs 2.88 or newer, built with BT_THREADSAFE.
+// Older versions fall back to ParallelCollisionDispatcher.
+#if BT_BULLET_VERSION >= 288 && defined(BT_THREADSAFE) && BT_THREADSAFE
+#define INL_BULLET_MULTITHREADED 1
+#else
+#define INL_BULLET_MULTITHREADED 0
+#endif
+
+
+// Separate worlds can only be stepped at the same time if Bullet's global profiler is thread safe or compiled out.
+#if INL_BULLET_MULTITHREADED || defined(BT_NO_PROFILE)
+#define INL_BULLET_PARALLEL_WORLDS 1
+#else
+#define INL_BULLET_PARALLEL_WORLDS 0
+#endif
@@ -1,4 +1,15 @@
 #include "MeshShape.hpp"
+#include "ScaledConvexShape.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <BulletCollision/CollisionShapes/btConvexHullShape.h>
+#include <BulletCollision/CollisionShapes/btEmptyShape.h>
+#include <BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btShapeHull.h>
+
+#include <cassert>
+#include <limits>
 
 
 namespace inl::pxeng_bl {
@@ -6,35 +17,151 @@ namespace inl::pxeng_bl {
 
 
 MeshShape::MeshShape() {
-	m_meshInterface.reset(new btTriangleMesh(true, false));
-	m_collisionShape.reset(new btGImpactMeshShape(m_meshInterface.get()));
+	m_collisionShape.reset(new btEmptyShape());
+}
+
+
+void MeshShape::SetMesh(const Vec3* vertices, size_t numVertices, const unsigned* indices, size_t numIndices, bool dynamic) {
+	assert(numVertices < (size_t)std::numeric_limits<int>::max());
+	assert(numIndices < (size_t)std::numeric_limits<int>::max());
+
+	Reset();
+
+	m_dynamic = dynamic;
+	if (numVertices == 0 || numIndices < 3) {
+		m_collisionShape.reset(new btEmptyShape());
+	}
+	else if (dynamic) {
+		BuildHull(vertices, numVertices);
+	}
+	else {
+		BuildStaticMesh(vertices, numVertices, indices, numIndices);
+	}
 }
 
 
-void MeshShape::SetMesh(const Vec3* vertices, size_t numVertices, const unsigned* indices, size_t numIndices) {
+void MeshShape::SetCookedMesh(std::vector<btScalar> vertices, std::vector<int> indices, std::shared_ptr<void> bvh, size_t bvhSize) {
+	if (vertices.size() % 3 != 0 || indices.size() % 3 != 0 || indices.empty()) {
+		throw InvalidArgumentException("Mesh must consist of whole vertices and triangles.");
+	}
 
-	btIndexedMesh mesh;
+	Reset();
+	m_dynamic = false;
+	m_vertices = std::move(vertices);
+	m_indices = std::move(indices);
+	m_meshInterface.reset(new btTriangleIndexVertexArray(
+		int(m_indices.size() / 3),
+		m_indices.data(),
+		3 * sizeof(int),
+		int(m_vertices.size() / 3),
+		m_vertices.data(),
+		3 * sizeof(btScalar)));
 
-	assert(numVertices < (size_t)std::numeric_limits<decltype(mesh.m_numVertices)>::max());
-	assert(numIndices / 3 < (size_t)std::numeric_limits<decltype(mesh.m_numTriangles)>::max());
+	btOptimizedBvh* optimizedBvh = btOptimizedBvh::deSerializeInPlace(bvh.get(), unsigned(bvhSize), false);
+	if (!optimizedBvh) {
+		m_collisionShape.reset(new btEmptyShape());
+		throw InvalidArgumentException("BVH cannot be loaded.");
+	}
+	m_bvhData = std::move(bvh);
 
-	mesh.m_numTriangles = int(numIndices / 3);
-	mesh.m_numVertices = int(numVertices);
-	mesh.m_triangleIndexBase = reinterpret_cast<const unsigned char*>(indices);
-	mesh.m_vertexBase = reinterpret_cast<const unsigned char*>(vertices);
-	mesh.m_triangleIndexStride = sizeof(*indices);
-	mesh.m_vertexStride = sizeof(*vertices);
-	mesh.m_vertexType = PHY_FLOAT;
+	// The shape does not own the BVH, it lives in the buffer.
+	auto shape = std::make_unique<btBvhTriangleMeshShape>(m_meshInterface.get(), true, false);
+	shape->setOptimizedBvh(optimizedBvh);
+	m_collisionShape = std::move(shape);
+}
+
+
+size_t MeshShape::GetBvhSize() const {
+	btBvhTriangleMeshShape* shape = GetBvhShape();
+	return shape ? shape->getOptimizedBvh()->calculateSerializeBufferSize() : 0;
+}
 
-	m_meshInterface.reset(new btTriangleMesh(true, false));
-	m_meshInterface->addIndexedMesh(mesh);
 
-	m_collisionShape.reset(new btGImpactMeshShape(m_meshInterface.get()));
+void MeshShape::SerializeBvh(void* buffer) const {
+	btBvhTriangleMeshShape* shape = GetBvhShape();
+	if (!shape) {
+		throw InvalidCallException("Only static meshes have a BVH.");
+	}
+	shape->getOptimizedBvh()->serializeInPlace(buffer, unsigned(GetBvhSize()), false);
 }
 
-btGImpactMeshShape* MeshShape::GetInternalShape() const {
+
+btCollisionShape* MeshShape::GetInternalShape() const {
 	return m_collisionShape.get();
 }
 
 
-} // namespace inl::pxeng_bl
\ No newline at end of file
+std::unique_ptr<btCollisionShape> MeshShape::CreateInstance() const {
+	switch (m_collisionShape->getShapeType()) {
+		case TRIANGLE_MESH_SHAPE_PROXYTYPE:
+			// Shares the BVH, scaling the instance does not rebuild it.
+			return std::make_unique<btScaledBvhTriangleMeshShape>(static_cast<btBvhTriangleMeshShape*>(m_collisionShape.get()), btVector3(1, 1, 1));
+		case CONVEX_HULL_SHAPE_PROXYTYPE:
+			// Shares the points of the hull.
+			return std::make_unique<ScaledConvexShape>(static_cast<const btConvexShape*>(m_collisionShape.get()));
+		default:
+			return nullptr;
+	}
+}
+
+
+void MeshShape::Reset() {
+	// Shapes referencing the old mesh go first.
+	m_collisionShape.reset();
+	m_meshInterface.reset();
+	m_bvhData.reset();
+	m_vertices.clear();
+	m_indices.clear();
+}
+
+
+void MeshShape::BuildStaticMesh(const Vec3* vertices, size_t numVertices, const unsigned* indices, size_t numIndices) {
+	m_vertices.reserve(3 * numVertices);
+	for (size_t i = 0; i < numVertices; ++i) {
+		m_vertices.push_back(vertices[i].x);
+		m_vertices.push_back(vertices[i].y);
+		m_vertices.push_back(vertices[i].z);
+	}
+	m_indices.assign(indices, indices + numIndices / 3 * 3);
+
+	m_meshInterface.reset(new btTriangleIndexVertexArray(
+		int(m_indices.size() / 3),
+		m_indices.data(),
+		3 * sizeof(int),
+		int(numVertices),
+		m_vertices.data(),
+		3 * sizeof(btScalar)));
+
+	// Quantized AABB compression keeps the BVH small enough for large terrains.
+	m_collisionShape.reset(new btBvhTriangleMeshShape(m_meshInterface.get(), true, true));
+}
+
+
+void MeshShape::BuildHull(const Vec3* vertices, size_t numVertices) {
+	btConvexHullShape fullHull;
+	for (size_t i = 0; i < numVertices; ++i) {
+		fullHull.addPoint(btVector3(vertices[i].x, vertices[i].y, vertices[i].z), false);
+	}
+	fullHull.recalcLocalAabb();
+
+	// Collision cost grows with the number of points, keep only what the hull needs.
+	btShapeHull reducer(&fullHull);
+	if (reducer.buildHull(fullHull.getMargin()) && reducer.numVertices() > 0) {
+		m_collisionShape.reset(new btConvexHullShape(&reducer.getVertexPointer()->getX(), reducer.numVertices(), (int)sizeof(btVector3)));
+	}
+	else {
+		m_collisionShape.reset(new btConvexHullShape(&fullHull.getUnscaledPoints()->getX(), fullHull.getNumPoints(), (int)sizeof(btVector3)));
+	}
+}
+
+
+btBvhTriangleMeshShape* MeshShape::GetBvhShape() const {
+	if (m_collisionShape->getShapeType() != TRIANGLE_MESH_SHAPE_PROXYTYPE) {
+		return nullptr;
+	}
+	auto shape = static_cast<btBvhTriangleMeshShape*>(m_collisionShape.get());
+	return shape->getOptimizedBvh() ? shape : nullptr;
+}
+
+
+} // namespace inl::pxeng_bl
@@ -4,27 +4,63 @@
 
 #include <InlineMath.hpp>
 #include <memory>
+#include <vector>
 
-#include <BulletCollision/Gimpact/btGImpactShape.h>
-#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+#include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h>
 
 
 namespace inl::pxeng_bl {
 
 
+/// <summary> Collision shape made from a triangle mesh. </summary>
+/// <remarks>
+/// Static meshes become a triangle mesh with a quantized BVH. Dynamic meshes are approximated by their
+/// convex hull, reduced to a few dozen points. Either way bodies share the shape through scaled instances.
+/// </remarks>
 class MeshShape : public Shape {
 public:
 	MeshShape();
 	
-	void SetMesh(const Vec3* vertices, size_t numVertices, const unsigned* indices, size_t numIndices);
+	/// <summary> Copies the mesh, the arrays can be freed afterwards. </summary>
+	void SetMesh(const Vec3* vertices, size_t numVertices, const unsigned* indices, size_t numIndices, bool dynamic = false);
 
-	bool IsDynamic() const override { return false; }
+	/// <summary> A static mesh with a BVH written by <see cref="SerializeBvh"/> for the same triangles, which is not built again. </summary>
+	/// <param name="vertices"> X, Y and Z of each vertex, like <see cref="GetVertices"/>. </param>
+	/// <param name="bvh"> Aligned to 16 bytes. It is loaded in place and kept alive by the shape. </param>
+	/// <exception cref="InvalidArgumentException"> If the BVH cannot be loaded. </exception>
+	void SetCookedMesh(std::vector<btScalar> vertices, std::vector<int> indices, std::shared_ptr<void> bvh, size_t bvhSize);
 
-	btGImpactMeshShape* GetInternalShape() const override;
+	/// <summary> The triangles of a static mesh, empty for dynamic ones. </summary>
+	const std::vector<btScalar>& GetVertices() const { return m_vertices; }
+	const std::vector<int>& GetIndices() const { return m_indices; }
+
+	/// <summary> Bytes needed by <see cref="SerializeBvh"/>, zero if the mesh is not static. </summary>
+	size_t GetBvhSize() const;
+	/// <summary> Writes the BVH of a static mesh in Bullet's in place format. </summary>
+	/// <param name="buffer"> Aligned to 16 bytes, <see cref="GetBvhSize"/> long. </param>
+	void SerializeBvh(void* buffer) const;
+
+	bool IsDynamic() const override { return m_dynamic; }
+
+	btCollisionShape* GetInternalShape() const override;
+	std::unique_ptr<btCollisionShape> CreateInstance() const override;
 private:
-	std::unique_ptr<btTriangleMesh> m_meshInterface;
-	std::unique_ptr<btGImpactMeshShape> m_collisionShape;
+	void Reset();
+	void BuildStaticMesh(const Vec3* vertices, size_t numVertices, const unsigned* indices, size_t numIndices);
+	void BuildHull(const Vec3* vertices, size_t numVertices);
+	btBvhTriangleMeshShape* GetBvhShape() const;
+
+private:
+	// Referenced by the mesh interface of static meshes.
+	std::vector<btScalar> m_vertices;
+	std::vector<int> m_indices;
+	std::unique_ptr<btTriangleIndexVertexArray> m_meshInterface;
+	std::shared_ptr<void> m_bvhData; // Storage of a BVH loaded in place.
+
+	std::unique_ptr<btCollisionShape> m_collisionShape;
+	bool m_dynamic = false;
 };
 
 
-} // namespace inl::pxeng_bl
\ No newline at end of file
+} // namespace inl::pxeng_bl
@@ -0,0 +1,77 @@
+#include "MotionState.hpp"
+#include "BulletTypes.hpp"
+
+
+namespace inl::pxeng_bl {
+
+
+void TransformUpdateBuffer::Clear() {
+	m_updates.clear();
+	++m_batch;
+}
+
+
+void TransformUpdateBuffer::Record(uint64_t& batch, size_t& index, const TransformUpdate& update) {
+	if (batch == m_batch) {
+		m_updates[index] = update;
+	}
+	else {
+		batch = m_batch;
+		index = m_updates.size();
+		m_updates.push_back(update);
+	}
+}
+
+
+const std::vector<TransformUpdate>& TransformUpdateBuffer::GetUpdates() const {
+	return m_updates;
+}
+
+
+void MotionState::getWorldTransform(btTransform& worldTrans) const {
+	worldTrans = m_current;
+}
+
+
+void MotionState::setWorldTransform(const btTransform& worldTrans) {
+	m_previous = m_current;
+	m_current = worldTrans;
+	if (m_target) {
+		m_target->Record(m_batch, m_index, { m_entityId, Conv(worldTrans.getOrigin()), Conv(worldTrans.getRotation()) });
+	}
+}
+
+
+void MotionState::Reset(const btTransform& transform) {
+	m_previous = transform;
+	m_current = transform;
+}
+
+
+void MotionState::SetTarget(TransformUpdateBuffer* target) {
+	m_target = target;
+	m_batch = 0;
+}
+
+
+void MotionState::SetEntityId(size_t entityId) {
+	m_entityId = entityId;
+}
+
+
+size_t MotionState::GetEntityId() const {
+	return m_entityId;
+}
+
+
+const btTransform& MotionState::GetCurrent() const {
+	return m_current;
+}
+
+
+const btTransform& MotionState::GetPrevious() const {
+	return m_previous;
+}
+
+
+} // namespace inl::pxeng_bl
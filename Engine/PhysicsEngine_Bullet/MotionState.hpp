@@ -0,0 +1,71 @@
+#pragma once
+
+#include <InlineMath.hpp>
+
+#include <LinearMath/btMotionState.h>
+#include <LinearMath/btTransform.h>
+
+#include <cstdint>
+#include <vector>
+
+
+namespace inl::pxeng_bl {
+
+
+/// <summary> New transform of a body that moved during a scene update. </summary>
+struct TransformUpdate {
+	size_t entityId; // See RigidBody::SetEntityId.
+	Vec3 position;
+	Quat rotation;
+};
+
+
+/// <summary> Collects the transforms of the bodies that moved during a scene update, one record per body. </summary>
+class TransformUpdateBuffer {
+public:
+	/// <summary> Starts a new update, previous records are discarded. </summary>
+	void Clear();
+
+	/// <summary> Adds a record, or overwrites the one the body made earlier in the same update. </summary>
+	/// <param name="batch"> Update the body last recorded in, kept by the body. </param>
+	/// <param name="index"> Position of the body's last record, kept by the body. </param>
+	void Record(uint64_t& batch, size_t& index, const TransformUpdate& update);
+
+	const std::vector<TransformUpdate>& GetUpdates() const;
+private:
+	std::vector<TransformUpdate> m_updates;
+	uint64_t m_batch = 1;
+};
+
+
+/// <summary> Keeps the last two simulated transforms of a body and reports them to the scene. </summary>
+/// <remarks> Bullet only writes the motion states of active bodies, so sleeping bodies cost nothing. </remarks>
+ATTRIBUTE_ALIGNED16(class) MotionState : public btMotionState {
+public:
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	void getWorldTransform(btTransform& worldTrans) const override;
+	void setWorldTransform(const btTransform& worldTrans) override;
+
+	/// <summary> Moves the body without a transition from where it was. </summary>
+	void Reset(const btTransform& transform);
+
+	/// <summary> Where the moves of the body are recorded, null to not record them. </summary>
+	void SetTarget(TransformUpdateBuffer* target);
+	void SetEntityId(size_t entityId);
+	size_t GetEntityId() const;
+
+	const btTransform& GetCurrent() const;
+	const btTransform& GetPrevious() const;
+private:
+	btTransform m_current = btTransform::getIdentity();
+	btTransform m_previous = btTransform::getIdentity();
+
+	TransformUpdateBuffer* m_target = nullptr;
+	size_t m_entityId = 0;
+	uint64_t m_batch = 0;
+	size_t m_index = 0;
+};
+
+
+} // namespace inl::pxeng_bl
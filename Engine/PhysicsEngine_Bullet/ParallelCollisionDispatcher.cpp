@@ -0,0 +1,115 @@
+#include "ParallelCollisionDispatcher.hpp"
+
+#include <BaseLibrary/JobSystem/Parallel.hpp>
+
+#include <BulletCollision/BroadphaseCollision/btCollisionAlgorithm.h>
+#include <BulletCollision/BroadphaseCollision/btOverlappingPairCache.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h>
+#include <BulletCollision/CollisionShapes/btCollisionShape.h>
+
+#include <algorithm>
+#include <thread>
+
+
+namespace inl::pxeng_bl {
+
+
+thread_local int ParallelCollisionDispatcher::currentLane = -1;
+
+
+ParallelCollisionDispatcher::ParallelCollisionDispatcher(btCollisionConfiguration* collisionConfiguration, jobs::Scheduler& scheduler, unsigned numLanes)
+	: btCollisionDispatcher(collisionConfiguration), m_scheduler(scheduler) {
+	if (numLanes == 0) {
+		numLanes = 4 * std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// The lanes only provide create functions, the pools of the dispatcher's configuration are used.
+	btDefaultCollisionConstructionInfo constructionInfo;
+	constructionInfo.m_defaultMaxPersistentManifoldPoolSize = 1;
+	constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 1;
+	for (unsigned i = 0; i < numLanes; ++i) {
+		m_laneConfigurations.push_back(std::make_unique<btDefaultCollisionConfiguration>(constructionInfo));
+	}
+	m_lanePairs.resize(numLanes);
+}
+
+
+void ParallelCollisionDispatcher::dispatchAllCollisionPairs(btOverlappingPairCache* pairCache, const btDispatcherInfo& dispatchInfo, btDispatcher* dispatcher) {
+	// Time of impact writes the hit fraction of the objects, which are shared between pairs.
+	if (dispatchInfo.m_dispatchFunc != btDispatcherInfo::DISPATCH_DISCRETE) {
+		btCollisionDispatcher::dispatchAllCollisionPairs(pairCache, dispatchInfo, dispatcher);
+		return;
+	}
+
+	int numPairs = pairCache->getNumOverlappingPairs();
+	btBroadphasePair* pairs = numPairs > 0 ? pairCache->getOverlappingPairArrayPtr() : nullptr;
+
+	for (auto& lanePairs : m_lanePairs) {
+		lanePairs.clear();
+	}
+	for (int i = 0; i < numPairs; ++i) {
+		m_lanePairs[GetLane(pairs[i])].push_back(&pairs[i]);
+	}
+
+	btNearCallback nearCallback = getNearCallback();
+	jobs::Scheduler* scheduler = numPairs >= MinParallelPairs ? &m_scheduler : nullptr;
+	jobs::CooperativeFor(scheduler, m_lanePairs.size(), 1, [this, nearCallback, &dispatchInfo](size_t first, size_t last) {
+		for (size_t lane = first; lane < last; ++lane) {
+			currentLane = int(lane);
+			for (btBroadphasePair* pair : m_lanePairs[lane]) {
+				nearCallback(*pair, *this, dispatchInfo);
+			}
+			currentLane = -1;
+		}
+	});
+}
+
+
+btCollisionAlgorithm* ParallelCollisionDispatcher::findAlgorithm(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, btPersistentManifold* sharedManifold) {
+	// Queries outside of the dispatch, such as contact tests, are on the caller's thread.
+	if (currentLane < 0) {
+		return btCollisionDispatcher::findAlgorithm(body0Wrap, body1Wrap, sharedManifold);
+	}
+
+	btCollisionAlgorithmConstructionInfo ci;
+	ci.m_dispatcher1 = this;
+	ci.m_manifold = sharedManifold;
+	btCollisionAlgorithmCreateFunc* createFunc = m_laneConfigurations[currentLane]->getCollisionAlgorithmCreateFunc(
+		body0Wrap->getCollisionShape()->getShapeType(),
+		body1Wrap->getCollisionShape()->getShapeType());
+	return createFunc->CreateCollisionAlgorithm(ci, body0Wrap, body1Wrap);
+}
+
+
+btPersistentManifold* ParallelCollisionDispatcher::getNewManifold(const btCollisionObject* b0, const btCollisionObject* b1) {
+	std::lock_guard<std::mutex> lkg(m_allocationMutex);
+	return btCollisionDispatcher::getNewManifold(b0, b1);
+}
+
+
+void ParallelCollisionDispatcher::releaseManifold(btPersistentManifold* manifold) {
+	std::lock_guard<std::mutex> lkg(m_allocationMutex);
+	btCollisionDispatcher::releaseManifold(manifold);
+}
+
+
+void* ParallelCollisionDispatcher::allocateCollisionAlgorithm(int size) {
+	std::lock_guard<std::mutex> lkg(m_allocationMutex);
+	return btCollisionDispatcher::allocateCollisionAlgorithm(size);
+}
+
+
+void ParallelCollisionDispatcher::freeCollisionAlgorithm(void* ptr) {
+	std::lock_guard<std::mutex> lkg(m_allocationMutex);
+	btCollisionDispatcher::freeCollisionAlgorithm(ptr);
+}
+
+
+size_t ParallelCollisionDispatcher::GetLane(const btBroadphasePair& pair) const {
+	// Proxy IDs live as long as the pair, so the pair keeps its lane and its algorithm keeps its solver.
+	uint32_t hash = uint32_t(pair.m_pProxy0->m_uniqueId) * 73856093u ^ uint32_t(pair.m_pProxy1->m_uniqueId) * 19349663u;
+	return hash % m_laneConfigurations.size();
+}
+
+
+} // namespace inl::pxeng_bl
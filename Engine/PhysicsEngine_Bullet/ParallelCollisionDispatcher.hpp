@@ -0,0 +1,59 @@
+#pragma once
+
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcher.h>
+#include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace inl::jobs {
+class Scheduler;
+}
+
+
+namespace inl::pxeng_bl {
+
+
+/// <summary> Runs the narrow phase of the overlapping pairs as jobs, for Bullet versions without btCollisionDispatcherMt. </summary>
+/// <remarks>
+/// The convex algorithms of older Bullet versions share the simplex solver of their collision configuration.
+/// Pairs are therefore split into lanes that each have their own configuration, and a pair
+/// goes to the same lane for its whole life, so no two threads ever use the same solver.
+/// Allocating algorithms and manifolds is locked. Continuous dispatch runs on the calling thread.
+/// Create functions registered on the dispatcher are ignored, the ones of the configurations are used.
+/// </remarks>
+class ParallelCollisionDispatcher : public btCollisionDispatcher {
+public:
+	/// <summary> Pairs below this are processed on the calling thread, still in lanes. </summary>
+	static constexpr int MinParallelPairs = 256;
+
+	/// <param name="numLanes"> Number of independent collision configurations, 0 for a few per hardware thread to balance uneven lanes. </param>
+	ParallelCollisionDispatcher(btCollisionConfiguration* collisionConfiguration, jobs::Scheduler& scheduler, unsigned numLanes = 0);
+
+	void dispatchAllCollisionPairs(btOverlappingPairCache* pairCache, const btDispatcherInfo& dispatchInfo, btDispatcher* dispatcher) override;
+
+	btCollisionAlgorithm* findAlgorithm(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, btPersistentManifold* sharedManifold = 0) override;
+
+	btPersistentManifold* getNewManifold(const btCollisionObject* b0, const btCollisionObject* b1) override;
+	void releaseManifold(btPersistentManifold* manifold) override;
+
+	void* allocateCollisionAlgorithm(int size) override;
+	void freeCollisionAlgorithm(void* ptr) override;
+
+private:
+	size_t GetLane(const btBroadphasePair& pair) const;
+
+private:
+	jobs::Scheduler& m_scheduler;
+	std::vector<std::unique_ptr<btDefaultCollisionConfiguration>> m_laneConfigurations;
+	std::vector<std::vector<btBroadphasePair*>> m_lanePairs;
+	std::mutex m_allocationMutex;
+
+	// Lane of the job running on this thread, -1 outside of dispatchAllCollisionPairs.
+	static thread_local int currentLane;
+};
+
+
+} // namespace inl::pxeng_bl
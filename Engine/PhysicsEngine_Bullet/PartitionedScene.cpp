@@ -0,0 +1,373 @@
+#include "PartitionedScene.hpp"
+#include "BulletTypes.hpp"
+#include "BulletThreading.hpp"
+#include "RigidBody.hpp"
+#include "Shape.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+#include <BaseLibrary/JobSystem/Parallel.hpp>
+#include <BaseLibrary/Memory/MemoryTracker.hpp>
+#include <BaseLibrary/FrameProfiler.hpp>
+#include <BaseLibrary/Timer.hpp>
+#include <BulletCollision/CollisionShapes/btConvexShape.h>
+
+#include <algorithm>
+#include <cmath>
+
+#undef GetObject // faszom kivan ezzel a kurva winapival
+
+
+namespace inl::pxeng_bl {
+
+
+// Queries per job, each one may go through several regions.
+static constexpr size_t QueryChunkSize = 32;
+
+
+static void MergeHit(QueryHit& closest, const QueryHit& hit) {
+	if (hit.IsHit() && hit.fraction < closest.fraction) {
+		closest = hit;
+	}
+}
+
+
+PartitionedScene::PartitionedScene(float regionSize, jobs::Scheduler* scheduler) {
+	if (!(regionSize > 0.0f)) {
+		throw InvalidArgumentException("Region size must be positive.");
+	}
+	m_regionSize = regionSize;
+	m_scheduler = scheduler;
+}
+
+
+PartitionedScene::~PartitionedScene() {
+	// Replicas reference the shapes of the bodies, they leave the worlds before the bodies are gone.
+	for (auto& [entity, placement] : m_entities) {
+		for (auto& [region, replica] : placement.replicas) {
+			region->scene->m_world->removeRigidBody(replica.get());
+		}
+	}
+}
+
+
+int PartitionedScene::Update(float elapsed) {
+	MemoryTagScope memoryTag(eMemoryTag::PHYSICS);
+	if (elapsed < 0.0f) {
+		throw InvalidArgumentException("Elapsed time must not be negative.");
+	}
+
+	INL_PROFILE_SCOPE("Physics update");
+
+	m_accumulator += elapsed;
+	int numSteps = 0;
+	while (m_accumulator >= m_timestep && numSteps < m_maxSubsteps) {
+		m_accumulator -= m_timestep;
+		++numSteps;
+	}
+	if (m_accumulator >= m_timestep) {
+		m_accumulator = std::fmod(m_accumulator, m_timestep);
+	}
+
+	Timer timer;
+	timer.Start();
+
+#if INL_BULLET_PARALLEL_WORLDS
+	jobs::CooperativeFor(m_scheduler, m_regions.size(), 1, [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i) {
+			m_regions[i]->scene->Simulate(numSteps);
+		}
+	});
+#else
+	for (Region* region : m_regions) {
+		region->scene->Simulate(numSteps);
+	}
+#endif
+
+	m_lastUpdate = {};
+	m_lastUpdate.numSteps = numSteps;
+	m_lastUpdate.updateTime = timer.Elapsed();
+	for (Region* region : m_regions) {
+		const SceneStats& regionUpdate = region->scene->m_lastUpdate;
+		m_lastUpdate.broadphaseTime += regionUpdate.broadphaseTime;
+		m_lastUpdate.narrowphaseTime += regionUpdate.narrowphaseTime;
+		m_lastUpdate.solverTime += regionUpdate.solverTime;
+	}
+
+	// Updates are collected before migrating, a body that changes regions has its moves in the one it left.
+	m_transformUpdates.clear();
+	for (Region* region : m_regions) {
+		const auto& updates = region->scene->GetTransformUpdates();
+		m_transformUpdates.insert(m_transformUpdates.end(), updates.begin(), updates.end());
+	}
+	MigrateBodies();
+
+	if (m_profilingEnabled && FrameProfiler::GetGlobal().IsEnabled()) {
+		Scene::RecordCounters(GetStats());
+		FrameProfiler::GetGlobal().RecordCounter("Physics regions", (double)m_regions.size());
+	}
+	return numSteps;
+}
+
+
+void PartitionedScene::SetFixedTimestep(float step, int maxSubsteps) {
+	if (!(step > 0.0f)) {
+		throw InvalidArgumentException("Timestep must be positive.");
+	}
+	if (maxSubsteps < 1) {
+		throw InvalidArgumentException("At least one step must be allowed per update.");
+	}
+	m_timestep = step;
+	m_maxSubsteps = maxSubsteps;
+	for (Region* region : m_regions) {
+		region->scene->SetFixedTimestep(step, maxSubsteps);
+	}
+}
+
+
+float PartitionedScene::GetFixedTimestep() const {
+	return m_timestep;
+}
+
+
+int PartitionedScene::GetMaxSubsteps() const {
+	return m_maxSubsteps;
+}
+
+
+float PartitionedScene::GetInterpolationFactor() const {
+	return std::min(m_accumulator / m_timestep, 1.0f);
+}
+
+
+const std::vector<TransformUpdate>& PartitionedScene::GetTransformUpdates() const {
+	return m_transformUpdates;
+}
+
+
+SceneStats PartitionedScene::GetStats() const {
+	SceneStats stats = m_lastUpdate;
+	for (Region* region : m_regions) {
+		SceneStats regionStats = region->scene->GetStats();
+		stats.numOverlappingPairs += regionStats.numOverlappingPairs;
+		stats.numManifolds += regionStats.numManifolds;
+		stats.numActiveBodies += regionStats.numActiveBodies;
+		stats.numSleepingBodies += regionStats.numSleepingBodies;
+		stats.numIslands += regionStats.numIslands;
+	}
+	return stats;
+}
+
+
+void PartitionedScene::SetProfilingEnabled(bool enabled) {
+	m_profilingEnabled = enabled;
+}
+
+
+void PartitionedScene::SetGravity(const Vec3& gravity) {
+	m_gravity = gravity;
+	for (Region* region : m_regions) {
+		region->scene->SetGravity(gravity);
+	}
+}
+
+
+Vec3 PartitionedScene::GetGravity() const {
+	return m_gravity;
+}
+
+
+void PartitionedScene::AddEntity(const RigidBody* entity) {
+	auto [it, isNew] = m_entities.insert({ entity, Placement{} });
+	if (!isNew) {
+		throw InvalidArgumentException("Entity already added to scene.");
+	}
+
+	Placement& placement = it->second;
+	if (entity->IsDynamic()) {
+		placement.home = &GetRegion(GetCell(entity->GetObject()->getWorldTransform().getOrigin()));
+		placement.home->scene->AddEntity(entity);
+	}
+	else {
+		PlaceStatic(entity, placement);
+	}
+}
+
+
+void PartitionedScene::RemoveEntity(const RigidBody* entity) {
+	auto it = m_entities.find(entity);
+	if (it == m_entities.end()) {
+		throw InvalidArgumentException("Entity is not part of scene.");
+	}
+
+	Placement& placement = it->second;
+	placement.home->scene->RemoveEntity(entity);
+	for (auto& [region, replica] : placement.replicas) {
+		region->scene->m_world->removeRigidBody(replica.get());
+	}
+	m_entities.erase(it);
+}
+
+
+void PartitionedScene::RayCast(const Ray* rays, QueryHit* hits, size_t count, const QueryFilter& filter) const {
+	std::vector<btDbvtVolume> bounds = GetRegionBounds();
+
+	jobs::CooperativeFor(m_scheduler, count, QueryChunkSize, [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i) {
+			btVector3 min = Conv(rays[i].from);
+			btVector3 max = min;
+			min.setMin(Conv(rays[i].to));
+			max.setMax(Conv(rays[i].to));
+			btDbvtVolume rayBounds = btDbvtVolume::FromMM(min, max);
+
+			QueryHit closest;
+			for (size_t r = 0; r < m_regions.size(); ++r) {
+				if (Intersect(bounds[r], rayBounds)) {
+					QueryHit hit;
+					m_regions[r]->scene->RayCast(&rays[i], &hit, 1, filter);
+					MergeHit(closest, hit);
+				}
+			}
+			hits[i] = closest;
+		}
+	});
+}
+
+
+void PartitionedScene::ConvexSweep(const Shape& shape, const Sweep* sweeps, QueryHit* hits, size_t count, const QueryFilter& filter) const {
+	const btCollisionShape* internalShape = shape.GetInternalShape();
+	if (!internalShape->isConvex()) {
+		throw InvalidArgumentException("Only convex shapes can be swept.");
+	}
+	std::vector<btDbvtVolume> bounds = GetRegionBounds();
+
+	jobs::CooperativeFor(m_scheduler, count, QueryChunkSize, [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i) {
+			btVector3 min1, max1, min2, max2;
+			internalShape->getAabb(btTransform(Conv(sweeps[i].rotation), Conv(sweeps[i].from)), min1, max1);
+			internalShape->getAabb(btTransform(Conv(sweeps[i].rotation), Conv(sweeps[i].to)), min2, max2);
+			min1.setMin(min2);
+			max1.setMax(max2);
+			btDbvtVolume sweepBounds = btDbvtVolume::FromMM(min1, max1);
+
+			QueryHit closest;
+			for (size_t r = 0; r < m_regions.size(); ++r) {
+				if (Intersect(bounds[r], sweepBounds)) {
+					QueryHit hit;
+					m_regions[r]->scene->ConvexSweep(shape, &sweeps[i], &hit, 1, filter);
+					MergeHit(closest, hit);
+				}
+			}
+			hits[i] = closest;
+		}
+	});
+}
+
+
+size_t PartitionedScene::GetNumRegions() const {
+	return m_regions.size();
+}
+
+
+float PartitionedScene::GetRegionSize() const {
+	return m_regionSize;
+}
+
+
+PartitionedScene::Cell PartitionedScene::GetCell(const btVector3& position) const {
+	return { (int)std::floor(position.x() / m_regionSize), (int)std::floor(position.y() / m_regionSize) };
+}
+
+
+PartitionedScene::Region& PartitionedScene::GetRegion(Cell cell) {
+	auto& region = m_regionMap[cell];
+	if (!region) {
+		region = std::make_unique<Region>();
+		region->cell = cell;
+		// The regions are the parallel work, each world is simulated by one thread.
+		region->scene = std::make_unique<Scene>(nullptr);
+		region->scene->SetFixedTimestep(m_timestep, m_maxSubsteps);
+		region->scene->SetGravity(m_gravity);
+		// Reading Bullet's profiler is only safe when a single world is stepped at a time.
+		region->scene->SetProfilingEnabled(!INL_BULLET_PARALLEL_WORLDS);
+		m_regions.push_back(region.get());
+	}
+	return *region;
+}
+
+
+void PartitionedScene::PlaceStatic(const RigidBody* entity, Placement& placement) {
+	btRigidBody* body = entity->GetObject();
+	btVector3 min, max;
+	body->getCollisionShape()->getAabb(body->getWorldTransform(), min, max);
+	Cell first = GetCell(min);
+	Cell last = GetCell(max);
+
+	placement.home = &GetRegion(GetCell(body->getWorldTransform().getOrigin()));
+	placement.home->scene->AddEntity(entity);
+
+	for (int y = first.y; y <= last.y; ++y) {
+		for (int x = first.x; x <= last.x; ++x) {
+			Region& region = GetRegion({ x, y });
+			if (&region == placement.home) {
+				continue;
+			}
+			auto replica = std::make_unique<btRigidBody>(0.0f, nullptr, body->getCollisionShape());
+			replica->setWorldTransform(body->getWorldTransform());
+			replica->setCollisionFlags(body->getCollisionFlags());
+			replica->setFriction(body->getFriction());
+			replica->setRestitution(body->getRestitution());
+			replica->setUserPointer(const_cast<RigidBody*>(entity)); // Queries report the body itself.
+			region.scene->m_world->addRigidBody(replica.get());
+			placement.replicas.push_back({ &region, std::move(replica) });
+		}
+	}
+}
+
+
+void PartitionedScene::MigrateBodies() {
+	std::vector<std::pair<const RigidBody*, Cell>> migrations;
+	float margin = MigrationMargin * m_regionSize;
+
+	for (Region* region : m_regions) {
+		float minX = region->cell.x * m_regionSize - margin;
+		float minY = region->cell.y * m_regionSize - margin;
+		float maxX = minX + m_regionSize + 2 * margin;
+		float maxY = minY + m_regionSize + 2 * margin;
+		for (const RigidBody* entity : region->scene->m_entities) {
+			const btRigidBody* body = entity->GetObject();
+			if (body->isStaticOrKinematicObject() || !body->isActive()) {
+				continue;
+			}
+			const btVector3& position = body->getWorldTransform().getOrigin();
+			if (position.x() < minX || position.x() > maxX || position.y() < minY || position.y() > maxY) {
+				migrations.push_back({ entity, GetCell(position) });
+			}
+		}
+	}
+
+	for (auto& [entity, cell] : migrations) {
+		Placement& placement = m_entities.at(entity);
+		Region& target = GetRegion(cell);
+		placement.home->scene->RemoveEntity(entity);
+		target.scene->AddEntity(entity);
+		placement.home = &target;
+	}
+}
+
+
+std::vector<btDbvtVolume> PartitionedScene::GetRegionBounds() const {
+	std::vector<btDbvtVolume> bounds;
+	bounds.reserve(m_regions.size());
+	for (Region* region : m_regions) {
+		btVector3 min, max;
+		if (!region->scene->GetBounds(min, max)) {
+			min.setValue(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+			max = -min;
+		}
+		bounds.push_back(btDbvtVolume::FromMM(min, max));
+	}
+	return bounds;
+}
+
+
+} // namespace inl::pxeng_bl
@@ -0,0 +1,121 @@
+#pragma once
+
+
+#include "Scene.hpp"
+
+#include <InlineMath.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+
+namespace inl::pxeng_bl {
+
+class RigidBody;
+class Shape;
+
+
+/// <summary> A large scene split into a grid of regions, each simulated in a world of its own. </summary>
+/// <remarks>
+/// The grid lies in the horizontal X-Y plane, regions are created as bodies enter them.
+/// Moving bodies belong to the region of their center and move to the neighbouring region after
+/// crossing its border by more than <see cref="MigrationMargin"/>. Bodies in different regions
+/// do not collide with each other, so regions should be much larger than the bodies.
+/// Fixed bodies are placed into all regions they overlap, and must not be moved while in the scene.
+/// Regions are stepped at the same time as jobs if Bullet allows stepping worlds in parallel
+/// (see INL_BULLET_PARALLEL_WORLDS), one after the other otherwise.
+/// </remarks>
+class PartitionedScene {
+public:
+	/// <summary> Part of the region size a moving body may leave its region by before changing regions. </summary>
+	static constexpr float MigrationMargin = 0.1f;
+
+	/// <param name="regionSize"> Length of the sides of the square regions. </param>
+	/// <param name="scheduler"> Regions and queries are processed as jobs here. Null processes them on the calling thread. </param>
+	/// <exception cref="InvalidArgumentException"> If the region size is not positive. </exception>
+	PartitionedScene(float regionSize, jobs::Scheduler* scheduler = nullptr);
+	~PartitionedScene();
+
+	/// <summary> Advances all regions in the same fixed steps, see <see cref="Scene::Update"/>. </summary>
+	/// <returns> The number of steps taken. </returns>
+	int Update(float elapsed);
+
+	/// <summary> Sets the step of all regions, see <see cref="Scene::SetFixedTimestep"/>. </summary>
+	void SetFixedTimestep(float step, int maxSubsteps = 4);
+	float GetFixedTimestep() const;
+	int GetMaxSubsteps() const;
+	float GetInterpolationFactor() const;
+
+	/// <summary> Transforms of the bodies that moved during the last update in any region. </summary>
+	/// <remarks> Valid until the next update. </remarks>
+	const std::vector<TransformUpdate>& GetTransformUpdates() const;
+
+	/// <summary> Timings of the last update and the counts of all regions added together. </summary>
+	SceneStats GetStats() const;
+	/// <summary> Whether updates record their timings and counts into the global <see cref="FrameProfiler"/>. </summary>
+	void SetProfilingEnabled(bool enabled);
+
+	void SetGravity(const Vec3& gravity);
+	Vec3 GetGravity() const;
+
+	/// <summary> Adds the body to the regions it belongs to. </summary>
+	/// <remarks> Whether the body is dynamic must not change while it is in the scene. </remarks>
+	void AddEntity(const RigidBody* entity);
+	void RemoveEntity(const RigidBody* entity);
+
+	/// <summary> Finds the first body along each ray in any region, see <see cref="Scene::RayCast"/>. </summary>
+	void RayCast(const Ray* rays, QueryHit* hits, size_t count, const QueryFilter& filter = {}) const;
+	/// <summary> Finds the first body each sweep touches in any region, see <see cref="Scene::ConvexSweep"/>. </summary>
+	/// <exception cref="InvalidArgumentException"> If the shape is not convex. </exception>
+	void ConvexSweep(const Shape& shape, const Sweep* sweeps, QueryHit* hits, size_t count, const QueryFilter& filter = {}) const;
+
+	size_t GetNumRegions() const;
+	float GetRegionSize() const;
+private:
+	struct Cell {
+		int x, y;
+		bool operator==(const Cell& rhs) const { return x == rhs.x && y == rhs.y; }
+	};
+	struct CellHash {
+		size_t operator()(const Cell& cell) const { return std::hash<uint64_t>()(uint64_t(uint32_t(cell.x)) << 32 | uint32_t(cell.y)); }
+	};
+	struct Region {
+		Cell cell;
+		std::unique_ptr<Scene> scene;
+	};
+	struct Placement {
+		Region* home; // The region the body itself is added to.
+		// Stand-ins of fixed bodies in the other regions they overlap, they share the collision shape of the body.
+		std::vector<std::pair<Region*, std::unique_ptr<btRigidBody>>> replicas;
+	};
+
+	Cell GetCell(const btVector3& position) const;
+	Region& GetRegion(Cell cell);
+	void PlaceStatic(const RigidBody* entity, Placement& placement);
+	/// <summary> Moves dynamic bodies that left their region to the one they are in. </summary>
+	void MigrateBodies();
+	/// <summary> Bounds of the bodies of each region, empty regions get inverted bounds that overlap nothing. </summary>
+	std::vector<btDbvtVolume> GetRegionBounds() const;
+
+private:
+	float m_regionSize;
+	jobs::Scheduler* m_scheduler;
+
+	std::unordered_map<Cell, std::unique_ptr<Region>, CellHash> m_regionMap;
+	std::vector<Region*> m_regions;
+	std::unordered_map<const RigidBody*, Placement> m_entities;
+
+	Vec3 m_gravity = { 0, -10, 0 }; // The default of Bullet's worlds.
+	float m_timestep = 1.0f / 60.0f;
+	int m_maxSubsteps = 4;
+	float m_accumulator = 0.0f;
+
+	std::vector<TransformUpdate> m_transformUpdates;
+	SceneStats m_lastUpdate;
+	bool m_profilingEnabled = true;
+};
+
+
+} // namespace inl::pxeng_bl
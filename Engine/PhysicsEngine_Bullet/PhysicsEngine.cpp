@@ -12,8 +12,8 @@ namespace inl::pxeng_bl {
 
 
 
-Scene* PhysicsEngine::CreateScene() const {
-	return new Scene();
+Scene* PhysicsEngine::CreateScene(jobs::Scheduler* scheduler) const {
+	return new Scene(scheduler);
 }
 
 
@@ -1,6 +1,11 @@
 #pragma once
 
 
+namespace inl::jobs {
+class Scheduler;
+}
+
+
 namespace inl::pxeng_bl {
 
 class Scene;
@@ -10,7 +15,8 @@ class MeshShape;
 
 class PhysicsEngine {
 public:
-	Scene* CreateScene() const;
+	/// <summary> Creates a scene that simulates on the given scheduler, or on the calling thread if null. </summary>
+	Scene* CreateScene(jobs::Scheduler* scheduler = nullptr) const;
 
 	RigidBody* CreateRigidBody() const;
 
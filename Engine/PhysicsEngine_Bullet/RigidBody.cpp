@@ -12,9 +12,10 @@ namespace inl::pxeng_bl {
 
 RigidBody::RigidBody()
 {
-	m_motionState = std::make_unique<btDefaultMotionState>();
+	m_motionState = std::make_unique<MotionState>();
 	m_internalShape = std::make_unique<btCompoundShape>();
 	m_rigidBody = std::make_unique<btRigidBody>(1.0f, m_motionState.get(), m_internalShape.get());
+	m_rigidBody->setUserPointer(this); // Scene queries find the body from Bullet's collision object.
 }
 
 
@@ -24,6 +25,7 @@ void RigidBody::SetPosition(const Vec3& pos) {
 	btTransform transform = m_rigidBody->getWorldTransform();
 	transform.setOrigin(Conv(pos));
 	m_rigidBody->setWorldTransform(transform);
+	ResetMotionState(); // Teleports are not blended.
 }
 
 void RigidBody::SetRotation(const Quat& rotation) {
@@ -32,6 +34,7 @@ void RigidBody::SetRotation(const Quat& rotation) {
 	btTransform transform = m_rigidBody->getWorldTransform();
 	transform.setRotation(Conv(m_transform.GetPostRotation()));
 	m_rigidBody->setWorldTransform(transform);
+	ResetMotionState();
 }
 
 void RigidBody::SetScale(const Vec3& scale) {
@@ -63,6 +66,7 @@ void RigidBody::SetShape(const Shape* shape) {
 	if (numChildShapes == 1) {
 		m_internalShape->removeChildShapeByIndex(0);
 	}
+	m_instanceShape = shape->CreateInstance();
 
 
 	// Figure out pre-transform.
@@ -72,9 +76,9 @@ void RigidBody::SetShape(const Shape* shape) {
 	Vec3 p = m_transform.GetPosition();
 	
 	// Add new shape to compound shape with pre-rotation.
-	btTransform transform;
+	btTransform transform = btTransform::getIdentity();
 	transform.setRotation(Conv(r1));
-	m_internalShape->addChildShape(transform, shape->GetInternalShape());
+	m_internalShape->addChildShape(transform, m_instanceShape ? m_instanceShape.get() : shape->GetInternalShape());
 
 	// Set shear scale to compound transform.
 	m_internalShape->setLocalScaling(Conv(s));
@@ -84,6 +88,7 @@ void RigidBody::SetShape(const Shape* shape) {
 	bodyTransform.setRotation(Conv(r2));
 	bodyTransform.setOrigin(Conv(p));
 	m_rigidBody->setWorldTransform(bodyTransform);
+	ResetMotionState();
 
 	// Update inertia.
 	if (m_autoUpdateInertia) {
@@ -113,6 +118,31 @@ void RigidBody::SetInertia(const Mat33& inertiaTensor) {
 	throw NotImplementedException();
 }
 
+void RigidBody::SetEntityId(size_t entityId) {
+	m_motionState->SetEntityId(entityId);
+}
+
+size_t RigidBody::GetEntityId() const {
+	return m_motionState->GetEntityId();
+}
+
+
+// Sleeping and static bodies are not written by the simulation, they stay where they are.
+Vec3 RigidBody::GetInterpolatedPosition(float alpha) const {
+	if (!m_rigidBody->isActive() || m_rigidBody->isStaticOrKinematicObject()) {
+		return Conv(m_rigidBody->getWorldTransform().getOrigin());
+	}
+	return Conv(m_motionState->GetPrevious().getOrigin().lerp(m_motionState->GetCurrent().getOrigin(), alpha));
+}
+
+Quat RigidBody::GetInterpolatedRotation(float alpha) const {
+	if (!m_rigidBody->isActive() || m_rigidBody->isStaticOrKinematicObject()) {
+		return Conv(m_rigidBody->getWorldTransform().getRotation());
+	}
+	return Conv(m_motionState->GetPrevious().getRotation().slerp(m_motionState->GetCurrent().getRotation(), alpha));
+}
+
+
 btRigidBody* RigidBody::GetObject() const {
 	return m_rigidBody.get();
 }
@@ -128,4 +158,9 @@ void RigidBody::CalculateInertia() {
 }
 
 
+void RigidBody::ResetMotionState() {
+	m_motionState->Reset(m_rigidBody->getWorldTransform());
+}
+
+
 } // inl::pxeng_bl
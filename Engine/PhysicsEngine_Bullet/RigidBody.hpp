@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Shape.hpp"
+#include "MotionState.hpp"
 
 #include <optional>
 #include <InlineMath.hpp>
@@ -8,7 +9,6 @@
 
 #include <BulletDynamics/Dynamics/btRigidBody.h>
 #include <BulletCollision/CollisionShapes/btSphereShape.h>
-#include <LinearMath/btDefaultMotionState.h>
 #include <BulletCollision/CollisionShapes/btCompoundShape.h>
 
 #undef GetObject // faszom kivan ezzel a kurva winapival
@@ -20,6 +20,8 @@ namespace inl::pxeng_bl {
 class RigidBody {
 public:
 	RigidBody();
+	RigidBody(const RigidBody&) = delete;
+	RigidBody& operator=(const RigidBody&) = delete;
 
 	void SetPosition(const Vec3& pos);
 	Vec3 GetPosition() const;
@@ -39,9 +41,24 @@ public:
 	void UpdateInertia();
 	void SetInertia(const Mat33& inertiaTensor);
 
+	/// <summary> Identifies the body in the transform updates of the scene, such as the index of its graphics entity. </summary>
+	void SetEntityId(size_t entityId);
+	size_t GetEntityId() const;
+
+	/// <summary> Position of the body between the last two simulation steps, for drawing. </summary>
+	/// <param name="alpha"> 0 is the state before the last step, 1 is the current one.
+	///		Pass <see cref="Scene::GetInterpolationFactor"/>. </param>
+	Vec3 GetInterpolatedPosition(float alpha) const;
+	/// <summary> Rotation of the body between the last two simulation steps, for drawing. </summary>
+	Quat GetInterpolatedRotation(float alpha) const;
+
 	btRigidBody* GetObject() const;
 private:
+	friend class Scene;
+
 	void CalculateInertia();
+	/// <summary> Makes the current transform the one to interpolate from as well. </summary>
+	void ResetMotionState();
 
 private:
 	Transformable3DN m_transform;
@@ -50,8 +67,9 @@ private:
 	bool m_autoUpdateInertia = true;
 
 	const Shape* m_shape = nullptr;
+	std::unique_ptr<btCollisionShape> m_instanceShape; // Child of the compound instead of the shared shape, if the shape makes one.
 
-	std::unique_ptr<btDefaultMotionState> m_motionState;
+	std::unique_ptr<MotionState> m_motionState;
 	std::unique_ptr<btRigidBody> m_rigidBody;
 	std::unique_ptr<btCompoundShape> m_internalShape;
 };
@@ -0,0 +1,40 @@
+#include "ScaledConvexShape.hpp"
+
+
+namespace inl::pxeng_bl {
+
+
+ScaledConvexShape::ScaledConvexShape(const btConvexShape* child)
+	: m_child(child)
+{
+	m_shapeType = CUSTOM_CONVEX_SHAPE_TYPE;
+	m_collisionMargin = child->getMargin();
+}
+
+
+// The support point of the scaled shape is the scaled support point of the child towards the scaled direction.
+btVector3 ScaledConvexShape::localGetSupportingVertexWithoutMargin(const btVector3& vec) const {
+	return m_child->localGetSupportingVertexWithoutMargin(vec * m_localScaling) * m_localScaling;
+}
+
+
+void ScaledConvexShape::batchedUnitVectorGetSupportingVertexWithoutMargin(const btVector3* vectors, btVector3* supportVerticesOut, int numVectors) const {
+	for (int i = 0; i < numVectors; ++i) {
+		supportVerticesOut[i] = localGetSupportingVertexWithoutMargin(vectors[i]);
+	}
+}
+
+
+// Inertia of the bounding box, the same approximation Bullet uses for polyhedra.
+void ScaledConvexShape::calculateLocalInertia(btScalar mass, btVector3& inertia) const {
+	btVector3 aabbMin, aabbMax;
+	getAabb(btTransform::getIdentity(), aabbMin, aabbMax);
+	btVector3 extents = aabbMax - aabbMin;
+	btScalar x2 = extents.x() * extents.x();
+	btScalar y2 = extents.y() * extents.y();
+	btScalar z2 = extents.z() * extents.z();
+	inertia = btVector3(y2 + z2, x2 + z2, x2 + y2) * (mass / btScalar(12));
+}
+
+
+} // namespace inl::pxeng_bl
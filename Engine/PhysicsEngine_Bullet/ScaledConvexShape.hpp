@@ -0,0 +1,32 @@
+#pragma once
+
+#include <BulletCollision/CollisionShapes/btConvexInternalShape.h>
+
+
+namespace inl::pxeng_bl {
+
+
+/// <summary> A shared convex shape seen through a scale of its own, the convex counterpart of btScaledBvhTriangleMeshShape. </summary>
+/// <remarks> Unlike btUniformScalingShape, the scale can differ per axis and setLocalScaling
+///		changes only this shape, so the bodies of a compound can scale it freely. The scale must be positive.
+///		The margin is the one of the child and is not scaled. </remarks>
+ATTRIBUTE_ALIGNED16(class) ScaledConvexShape : public btConvexInternalShape {
+public:
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	/// <param name="child"> Must outlive this shape. </param>
+	explicit ScaledConvexShape(const btConvexShape* child);
+
+	btVector3 localGetSupportingVertexWithoutMargin(const btVector3& vec) const override;
+	void batchedUnitVectorGetSupportingVertexWithoutMargin(const btVector3* vectors, btVector3* supportVerticesOut, int numVectors) const override;
+	void calculateLocalInertia(btScalar mass, btVector3& inertia) const override;
+
+	const char* getName() const override { return "ScaledConvexShape"; }
+
+	const btConvexShape* GetChild() const { return m_child; }
+private:
+	const btConvexShape* m_child;
+};
+
+
+} // namespace inl::pxeng_bl
@@ -1,9 +1,30 @@
 #include "Scene.hpp"
-#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include "BulletTypes.hpp"
+#include "BulletThreading.hpp"
 #include "BaseLibrary/Exception/Exception.hpp"
+#include "BaseLibrary/Memory/MemoryTracker.hpp"
+
+#if INL_BULLET_MULTITHREADED
+#include "BulletTaskScheduler.hpp"
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#else
+#include "ParallelCollisionDispatcher.hpp"
+#endif
 
 #include "RigidBody.hpp"
+#include "Shape.hpp"
+
+#include <BaseLibrary/JobSystem/Parallel.hpp>
+#include <BaseLibrary/FrameProfiler.hpp>
+#include <BaseLibrary/Timer.hpp>
+#include <LinearMath/btQuickprof.h>
+#include <BulletCollision/CollisionShapes/btConvexShape.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string_view>
 
 #undef GetObject // faszom kivan ezzel a kurva winapival
 
@@ -11,23 +32,333 @@
 namespace inl::pxeng_bl {
 
 
-Scene::Scene() {
+// Queries per job, a ray through a crowded scene takes a few microseconds.
+static constexpr size_t QueryChunkSize = 64;
+
+
+// Collects the closest hit of one ray from the leaves of the broadphase tree.
+// btDbvtBroadphase::rayTest shares a traversal stack between callers, the static btDbvt::rayTest does not.
+class RayQueryPolicy : public btDbvt::ICollide {
+public:
+	RayQueryPolicy(const Ray& ray, const QueryFilter& filter)
+		: m_from(btTransform::getIdentity()), m_to(btTransform::getIdentity()), m_callback(Conv(ray.from), Conv(ray.to)), m_filter(filter)
+	{
+		m_from.setOrigin(Conv(ray.from));
+		m_to.setOrigin(Conv(ray.to));
+		m_callback.m_collisionFilterGroup = (short)filter.group;
+		m_callback.m_collisionFilterMask = (short)filter.mask;
+	}
+
+	void Process(const btDbvtNode* leaf) override {
+		auto proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+		auto object = static_cast<btCollisionObject*>(proxy->m_clientObject);
+		if (!m_callback.needsCollision(proxy) || object->getUserPointer() == m_filter.ignore) {
+			return;
+		}
+		btCollisionWorld::rayTestSingle(m_from, m_to, object, object->getCollisionShape(), object->getWorldTransform(), m_callback);
+	}
+
+	QueryHit GetHit() const {
+		QueryHit hit;
+		if (m_callback.hasHit()) {
+			hit.body = static_cast<const RigidBody*>(m_callback.m_collisionObject->getUserPointer());
+			hit.position = Conv(m_callback.m_hitPointWorld);
+			hit.normal = Conv(m_callback.m_hitNormalWorld);
+			hit.fraction = m_callback.m_closestHitFraction;
+		}
+		return hit;
+	}
+
+private:
+	btTransform m_from;
+	btTransform m_to;
+	btCollisionWorld::ClosestRayResultCallback m_callback;
+	const QueryFilter& m_filter;
+};
+
+
+// Collects the closest hit of one sweep from the leaves that overlap the bounds of the whole sweep.
+class SweepQueryPolicy : public btDbvt::ICollide {
+public:
+	SweepQueryPolicy(const btConvexShape* shape, const Sweep& sweep, const QueryFilter& filter)
+		: m_shape(shape), m_from(Conv(sweep.rotation), Conv(sweep.from)), m_to(Conv(sweep.rotation), Conv(sweep.to)), m_callback(Conv(sweep.from), Conv(sweep.to)), m_filter(filter)
+	{
+		m_callback.m_collisionFilterGroup = (short)filter.group;
+		m_callback.m_collisionFilterMask = (short)filter.mask;
+	}
+
+	btDbvtVolume GetBounds() const {
+		btVector3 min1, max1, min2, max2;
+		m_shape->getAabb(m_from, min1, max1);
+		m_shape->getAabb(m_to, min2, max2);
+		min1.setMin(min2);
+		max1.setMax(max2);
+		return btDbvtVolume::FromMM(min1, max1);
+	}
+
+	void Process(const btDbvtNode* leaf) override {
+		auto proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+		auto object = static_cast<btCollisionObject*>(proxy->m_clientObject);
+		if (!m_callback.needsCollision(proxy) || object->getUserPointer() == m_filter.ignore) {
+			return;
+		}
+		btCollisionWorld::objectQuerySingle(m_shape, m_from, m_to, object, object->getCollisionShape(), object->getWorldTransform(), m_callback, 0.0f);
+	}
+
+	QueryHit GetHit() const {
+		QueryHit hit;
+		if (m_callback.hasHit()) {
+			hit.body = static_cast<const RigidBody*>(m_callback.m_hitCollisionObject->getUserPointer());
+			hit.position = Conv(m_callback.m_hitPointWorld);
+			hit.normal = Conv(m_callback.m_hitNormalWorld);
+			hit.fraction = m_callback.m_closestHitFraction;
+		}
+		return hit;
+	}
+
+private:
+	const btConvexShape* m_shape;
+	btTransform m_from;
+	btTransform m_to;
+	btCollisionWorld::ClosestConvexResultCallback m_callback;
+	const QueryFilter& m_filter;
+};
+
+
+#ifndef BT_NO_PROFILE
+// Adds up the time of Bullet's profile zones of the phases, anywhere in the tree.
+// Bullet accumulates milliseconds since the last CProfileManager::Reset.
+static void SumPhaseTimes(CProfileIterator& it, SceneStats& stats) {
+	int numChildren = 0;
+	for (it.First(); !it.Is_Done(); it.Next(), ++numChildren) {
+		std::string_view name = it.Get_Current_Name();
+		double time = it.Get_Current_Total_Time() * 1e-3;
+		if (name == "updateAabbs" || name == "calculateOverlappingPairs") {
+			stats.broadphaseTime += time;
+		}
+		else if (name == "dispatchAllCollisionPairs") {
+			stats.narrowphaseTime += time;
+		}
+		else if (name == "solveConstraints") {
+			stats.solverTime += time;
+		}
+	}
+	// Entering a child restarts the iteration of the parent, so children are visited by index.
+	for (int i = 0; i < numChildren; ++i) {
+		it.Enter_Child(i);
+		SumPhaseTimes(it, stats);
+		it.Enter_Parent();
+	}
+}
+#endif
+
+
+Scene::Scene(jobs::Scheduler* scheduler) {
+	m_scheduler = scheduler;
 	m_broadphase.reset(new btDbvtBroadphase());
-	m_collisionConfiguration.reset(new btDefaultCollisionConfiguration());
-	m_collisionDispatcher.reset(new btCollisionDispatcher(m_collisionConfiguration.get()));
+
+	if (!scheduler) {
+		m_collisionConfiguration.reset(new btDefaultCollisionConfiguration());
+		m_collisionDispatcher.reset(new btCollisionDispatcher(m_collisionConfiguration.get()));
+		m_solver.reset(new btSequentialImpulseConstraintSolver());
+		m_world.reset(new btDiscreteDynamicsWorld(
+			m_collisionDispatcher.get(),
+			m_broadphase.get(),
+			m_solver.get(),
+			m_collisionConfiguration.get()));
+		return;
+	}
+
+	// Large scenes have many more manifolds and algorithms than the default pools hold.
+	btDefaultCollisionConstructionInfo constructionInfo;
+	constructionInfo.m_defaultMaxPersistentManifoldPoolSize = 80000;
+	constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 80000;
+	m_collisionConfiguration.reset(new btDefaultCollisionConfiguration(constructionInfo));
+	m_multithreaded = true;
+
+#if INL_BULLET_MULTITHREADED
+	BulletTaskScheduler::Install(*scheduler);
+	m_collisionDispatcher.reset(new btCollisionDispatcherMt(m_collisionConfiguration.get(), 40));
+	m_solverPool.reset(new btConstraintSolverPoolMt(btGetTaskScheduler()->getNumThreads()));
+	m_solver.reset(new btSequentialImpulseConstraintSolverMt());
+	m_world.reset(new btDiscreteDynamicsWorldMt(
+		m_collisionDispatcher.get(),
+		m_broadphase.get(),
+		static_cast<btConstraintSolverPoolMt*>(m_solverPool.get()),
+		m_solver.get(),
+		m_collisionConfiguration.get()));
+#else
+	// Bullet's solver uses its global profiler, which is not thread safe before 2.88, so only collisions are parallel.
+	m_collisionDispatcher.reset(new ParallelCollisionDispatcher(m_collisionConfiguration.get(), *scheduler));
 	m_solver.reset(new btSequentialImpulseConstraintSolver());
 	m_world.reset(new btDiscreteDynamicsWorld(
 		m_collisionDispatcher.get(),
 		m_broadphase.get(),
 		m_solver.get(),
 		m_collisionConfiguration.get()));
+#endif
+}
+
+
+int Scene::Update(float elapsed) {
+	MemoryTagScope memoryTag(eMemoryTag::PHYSICS);
+	if (elapsed < 0.0f) {
+		throw InvalidArgumentException("Elapsed time must not be negative.");
+	}
+
+	m_accumulator += elapsed;
+	int numSteps = 0;
+	while (m_accumulator >= m_timestep && numSteps < m_maxSubsteps) {
+		m_accumulator -= m_timestep;
+		++numSteps;
+	}
+	if (m_accumulator >= m_timestep) {
+		m_accumulator = std::fmod(m_accumulator, m_timestep);
+	}
+
+	Simulate(numSteps);
+
+	if (m_profilingEnabled && FrameProfiler::GetGlobal().IsEnabled()) {
+		RecordCounters(GetStats());
+	}
+	return numSteps;
+}
+
+
+void Scene::Simulate(int numSteps) {
+	INL_PROFILE_SCOPE("Physics update");
+
+	m_transformUpdates.Clear();
+#ifndef BT_NO_PROFILE
+	if (m_profilingEnabled) {
+		CProfileManager::Reset();
+	}
+#endif
+	Timer timer;
+	timer.Start();
 
-	
+	for (int i = 0; i < numSteps; ++i) {
+		// No substeps: Bullet takes exactly one step of the given length.
+		m_world->stepSimulation(m_timestep, 0);
+	}
+
+	m_lastUpdate = {};
+	m_lastUpdate.numSteps = numSteps;
+	m_lastUpdate.updateTime = timer.Elapsed();
+#ifndef BT_NO_PROFILE
+	if (m_profilingEnabled) {
+		CProfileIterator* it = CProfileManager::Get_Iterator();
+		SumPhaseTimes(*it, m_lastUpdate);
+		CProfileManager::Release_Iterator(it);
+	}
+#endif
+}
+
+
+void Scene::RecordCounters(const SceneStats& stats) {
+	FrameProfiler& profiler = FrameProfiler::GetGlobal();
+	profiler.RecordCounter("Physics steps", stats.numSteps);
+	profiler.RecordCounter("Physics broadphase ms", stats.broadphaseTime * 1e3);
+	profiler.RecordCounter("Physics narrowphase ms", stats.narrowphaseTime * 1e3);
+	profiler.RecordCounter("Physics solver ms", stats.solverTime * 1e3);
+	profiler.RecordCounter("Physics overlapping pairs", stats.numOverlappingPairs);
+	profiler.RecordCounter("Physics manifolds", stats.numManifolds);
+	profiler.RecordCounter("Physics active bodies", stats.numActiveBodies);
+	profiler.RecordCounter("Physics sleeping bodies", stats.numSleepingBodies);
+	profiler.RecordCounter("Physics islands", stats.numIslands);
+}
+
+
+void Scene::SetFixedTimestep(float step, int maxSubsteps) {
+	if (step <= 0.0f) {
+		throw InvalidArgumentException("Time step must be positive.");
+	}
+	if (maxSubsteps < 1) {
+		throw InvalidArgumentException("At least one step must be allowed per update.");
+	}
+	m_timestep = step;
+	m_maxSubsteps = maxSubsteps;
+	m_accumulator = std::min(m_accumulator, step);
+}
+
+
+float Scene::GetFixedTimestep() const {
+	return m_timestep;
+}
+
+
+int Scene::GetMaxSubsteps() const {
+	return m_maxSubsteps;
+}
+
+
+float Scene::GetInterpolationFactor() const {
+	return std::min(m_accumulator / m_timestep, 1.0f);
 }
 
 
-void Scene::Update(float elapsed) {
-	m_world->stepSimulation(elapsed, 10);
+const std::vector<TransformUpdate>& Scene::GetTransformUpdates() const {
+	return m_transformUpdates.GetUpdates();
+}
+
+
+void Scene::RayCast(const Ray* rays, QueryHit* hits, size_t count, const QueryFilter& filter) const {
+	jobs::CooperativeFor(m_scheduler, count, QueryChunkSize, [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i) {
+			RayQueryPolicy policy(rays[i], filter);
+			// Moving and fixed bodies are kept in separate trees.
+			for (const btDbvt& tree : m_broadphase->m_sets) {
+				btDbvt::rayTest(tree.m_root, Conv(rays[i].from), Conv(rays[i].to), policy);
+			}
+			hits[i] = policy.GetHit();
+		}
+	});
+}
+
+
+void Scene::ConvexSweep(const Shape& shape, const Sweep* sweeps, QueryHit* hits, size_t count, const QueryFilter& filter) const {
+	const btCollisionShape* internalShape = shape.GetInternalShape();
+	if (!internalShape->isConvex()) {
+		throw InvalidArgumentException("Only convex shapes can be swept.");
+	}
+	auto convexShape = static_cast<const btConvexShape*>(internalShape);
+
+	jobs::CooperativeFor(m_scheduler, count, QueryChunkSize, [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i) {
+			SweepQueryPolicy policy(convexShape, sweeps[i], filter);
+			btDbvtVolume bounds = policy.GetBounds();
+			for (const btDbvt& tree : m_broadphase->m_sets) {
+				tree.collideTV(tree.m_root, bounds, policy);
+			}
+			hits[i] = policy.GetHit();
+		}
+	});
+}
+
+
+SceneStats Scene::GetStats() const {
+	SceneStats stats = m_lastUpdate;
+	stats.numOverlappingPairs = m_broadphase->getOverlappingPairCache()->getNumOverlappingPairs();
+	stats.numManifolds = m_collisionDispatcher->getNumManifolds();
+
+	// Static bodies are not part of islands, they would each count as one.
+	std::vector<int> islandTags;
+	for (auto entity : m_entities) {
+		const btRigidBody* body = entity->GetObject();
+		if (!body->isStaticOrKinematicObject()) {
+			++(body->isActive() ? stats.numActiveBodies : stats.numSleepingBodies);
+			islandTags.push_back(body->getIslandTag());
+		}
+	}
+	std::sort(islandTags.begin(), islandTags.end());
+	stats.numIslands = int(std::unique(islandTags.begin(), islandTags.end()) - islandTags.begin());
+
+	return stats;
+}
+
+
+void Scene::SetProfilingEnabled(bool enabled) {
+	m_profilingEnabled = enabled;
 }
 
 
@@ -41,10 +372,37 @@ Vec3 Scene::GetGravity() const {
 }
 
 
+bool Scene::GetBounds(btVector3& min, btVector3& max) const {
+	bool empty = true;
+	for (const btDbvt& tree : m_broadphase->m_sets) {
+		if (!tree.m_root) {
+			continue;
+		}
+		const btDbvtVolume& volume = tree.m_root->volume;
+		if (empty) {
+			min = volume.Mins();
+			max = volume.Maxs();
+			empty = false;
+		}
+		else {
+			min.setMin(volume.Mins());
+			max.setMax(volume.Maxs());
+		}
+	}
+	return !empty;
+}
+
+
+bool Scene::IsMultithreaded() const {
+	return m_multithreaded;
+}
+
+
 void Scene::AddEntity(const RigidBody* entity) {
 	auto [it, isNew] = m_entities.insert(entity);
 	if (isNew) {
 		m_world->addRigidBody(entity->GetObject());
+		entity->m_motionState->SetTarget(&m_transformUpdates);
 	}
 	else {
 		throw InvalidArgumentException("Entity already added to scene.");
@@ -55,10 +413,29 @@ void Scene::RemoveEntity(const RigidBody* entity) {
 	auto it = m_entities.find(entity);
 	[[likely]]
 	if (it != m_entities.end()) {
+		m_world->removeRigidBody(entity->GetObject());
+		entity->m_motionState->SetTarget(nullptr);
 		m_entities.erase(it);
+		return;
 	}
 	throw InvalidArgumentException("Entity is not part of scene.");
 }
 
 
+void Scene::AddConstraint(btTypedConstraint* constraint, bool collideConnected) {
+	auto [it, isNew] = m_constraints.insert(constraint);
+	if (!isNew) {
+		throw InvalidArgumentException("Constraint already added to scene.");
+	}
+	m_world->addConstraint(constraint, !collideConnected);
+}
+
+void Scene::RemoveConstraint(btTypedConstraint* constraint) {
+	if (m_constraints.erase(constraint) == 0) {
+		throw InvalidArgumentException("Constraint is not part of scene.");
+	}
+	m_world->removeConstraint(constraint);
+}
+
+
 } // namespace inl::pxeng_bl
\ No newline at end of file
@@ -3,39 +3,133 @@
 
 #include <memory>
 #include <InlineMath.hpp>
+#include "MotionState.hpp"
+#include "SceneQuery.hpp"
 
 #include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
 #include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
 
 #include <unordered_set>
 
 
+namespace inl::jobs {
+class Scheduler;
+}
+
+
 namespace inl::pxeng_bl {
 
 class RigidBody;
+class Shape;
+
+
+/// <summary> What the last <see cref="Scene::Update"/> did and what the scene holds after it. </summary>
+struct SceneStats {
+	int numSteps = 0;
+	double updateTime = 0.0; // Seconds, the wall time of all steps.
+	// Seconds spent in the phases, as measured by Bullet's profiler. Zero if Bullet was built without it.
+	double broadphaseTime = 0.0;
+	double narrowphaseTime = 0.0;
+	double solverTime = 0.0;
+
+	int numOverlappingPairs = 0;
+	int numManifolds = 0;
+	int numActiveBodies = 0; // Moving bodies that are simulated.
+	int numSleepingBodies = 0; // Moving bodies that are deactivated until touched.
+	int numIslands = 0; // Groups of touching bodies solved together.
+};
 
 
 class Scene {
 public:
-	Scene();
+	/// <param name="scheduler"> Collision detection and, with a thread safe Bullet, constraint solving
+	///		run as jobs here. Null simulates on the calling thread only. </param>
+	Scene(jobs::Scheduler* scheduler = nullptr);
 	~Scene() = default;
 
-	void Update(float elapsed);
+	/// <summary> Advances the simulation in fixed steps by the time elapsed since the last call. </summary>
+	/// <remarks> Time left over is carried to the next call. When more than the allowed number of steps
+	///		would be due, the rest is dropped so that a slow frame does not make the next one slower,
+	///		and the simulation falls behind real time instead. </remarks>
+	/// <returns> The number of steps taken. </returns>
+	int Update(float elapsed);
+
+	/// <summary> Sets the length of one simulation step and the most steps a single update may take. </summary>
+	void SetFixedTimestep(float step, int maxSubsteps = 4);
+	float GetFixedTimestep() const;
+	int GetMaxSubsteps() const;
+
+	/// <summary> How far the time carried over is into the next step, between 0 and 1. </summary>
+	/// <remarks> Pass it to <see cref="RigidBody::GetInterpolatedPosition"/> to draw bodies between their
+	///		last two simulated states. </remarks>
+	float GetInterpolationFactor() const;
+
+	/// <summary> Transforms of the bodies that moved during the last update, one record for each. </summary>
+	/// <remarks> Sleeping, static and kinematic bodies are not listed. Valid until the next update. </remarks>
+	const std::vector<TransformUpdate>& GetTransformUpdates() const;
+
+	/// <summary> Timings and counts of the last update. </summary>
+	/// <remarks> Counting bodies and islands walks all bodies of the scene. </remarks>
+	SceneStats GetStats() const;
+
+	/// <summary> Whether updates measure their phases with Bullet's profiler and
+	///		record their timings and counts into the global <see cref="FrameProfiler"/>. </summary>
+	void SetProfilingEnabled(bool enabled);
 
 	void SetGravity(const Vec3& gravity);
 	Vec3 GetGravity() const;
 
 	void AddEntity(const RigidBody* entity);
 	void RemoveEntity(const RigidBody* entity);
+
+	/// <summary> Adds a Bullet constraint between bodies of the scene, such as a joint of a ragdoll. </summary>
+	/// <remarks> The scene does not own the constraint. Remove it before destroying it or its bodies. </remarks>
+	/// <param name="collideConnected"> Whether the two bodies of the constraint still collide with each other. </param>
+	void AddConstraint(btTypedConstraint* constraint, bool collideConnected = false);
+	void RemoveConstraint(btTypedConstraint* constraint);
+
+	/// <summary> Finds the first body along each ray, writes <paramref name="count"/> hits. </summary>
+	/// <remarks> The rays are split among jobs on the scheduler of the scene.
+	///		Queries only read the scene and must not run during an update. </remarks>
+	void RayCast(const Ray* rays, QueryHit* hits, size_t count, const QueryFilter& filter = {}) const;
+
+	/// <summary> Finds the first body each sweep of a convex shape touches, writes <paramref name="count"/> hits. </summary>
+	/// <remarks> Runs as jobs like <see cref="RayCast"/>. </remarks>
+	/// <exception cref="InvalidArgumentException"> If the shape is not convex. </exception>
+	void ConvexSweep(const Shape& shape, const Sweep* sweeps, QueryHit* hits, size_t count, const QueryFilter& filter = {}) const;
+
+	bool IsMultithreaded() const;
 private:
-	std::unique_ptr<btBroadphaseInterface> m_broadphase;
+	friend class PartitionedScene;
+
+	/// <summary> Takes the given number of fixed steps, regardless of the time carried over. </summary>
+	void Simulate(int numSteps);
+	static void RecordCounters(const SceneStats& stats);
+	/// <summary> Bounds of all bodies in the scene, false if it is empty. </summary>
+	bool GetBounds(btVector3& min, btVector3& max) const;
+
+private:
+	std::unique_ptr<btDbvtBroadphase> m_broadphase;
 	std::unique_ptr<btDefaultCollisionConfiguration> m_collisionConfiguration;
 	std::unique_ptr<btCollisionDispatcher> m_collisionDispatcher;
-	std::unique_ptr<btSequentialImpulseConstraintSolver> m_solver;
+	std::unique_ptr<btConstraintSolver> m_solverPool; // Solvers of the islands in the multithreaded world.
+	std::unique_ptr<btConstraintSolver> m_solver;
 	std::unique_ptr<btDiscreteDynamicsWorld> m_world;
+	bool m_multithreaded = false;
+	jobs::Scheduler* m_scheduler = nullptr;
+
+	float m_timestep = 1.0f / 60.0f;
+	int m_maxSubsteps = 4;
+	float m_accumulator = 0.0f; // Elapsed time not yet simulated.
+	TransformUpdateBuffer m_transformUpdates;
+
+	SceneStats m_lastUpdate; // Only the step count and timings, the counts are gathered on request.
+	bool m_profilingEnabled = true;
 
 	std::unordered_set<const RigidBody*> m_entities;
+	std::unordered_set<btTypedConstraint*> m_constraints;
 };
 
 
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <InlineMath.hpp>
+
+#include <BulletCollision/BroadphaseCollision/btBroadphaseProxy.h>
+
+
+namespace inl::pxeng_bl {
+
+class RigidBody;
+
+
+/// <summary> Selects the bodies a query may hit, with Bullet's collision filter groups. </summary>
+/// <remarks> A body is tested if it is in one of the groups of <see cref="mask"/>
+///		and its own mask accepts one of the groups of <see cref="group"/>. </remarks>
+struct QueryFilter {
+	int group = btBroadphaseProxy::DefaultFilter;
+	int mask = btBroadphaseProxy::AllFilter;
+	const RigidBody* ignore = nullptr; // Typically the body the query is made for.
+};
+
+
+struct Ray {
+	Vec3 from;
+	Vec3 to;
+};
+
+
+/// <summary> Moves a shape from one point to another without rotating it. </summary>
+struct Sweep {
+	Vec3 from;
+	Vec3 to;
+	Quat rotation = Quat::Identity();
+};
+
+
+/// <summary> The first hit of a ray or sweep. </summary>
+struct QueryHit {
+	const RigidBody* body = nullptr; // Null if nothing was hit.
+	Vec3 position = { 0, 0, 0 };
+	Vec3 normal = { 0, 0, 0 };
+	float fraction = 1.0f; // Distance of the hit along the query, 0 at the start and 1 at the end.
+
+	bool IsHit() const { return body != nullptr; }
+};
+
+
+} // namespace inl::pxeng_bl
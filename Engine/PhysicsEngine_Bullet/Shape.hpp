@@ -1,6 +1,9 @@
 #pragma once
 
 
+#include <memory>
+
+
 class btCollisionShape;
 
 
@@ -14,6 +17,10 @@ public:
 	virtual bool IsDynamic() const = 0;
 	
 	virtual btCollisionShape* GetInternalShape() const = 0;
+
+	/// <summary> A shape for a single body that refers to the shared one, so that scaling the body leaves the shared shape alone. </summary>
+	/// <returns> Null if bodies can use the internal shape directly. </returns>
+	virtual std::unique_ptr<btCollisionShape> CreateInstance() const { return nullptr; }
 };
 
 
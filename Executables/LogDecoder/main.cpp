@@ -0,0 +1,47 @@
+#include <iostream>
+#include <fstream>
+
+#include <BaseLibrary/Exception/Exception.hpp>
+#include <BaseLibrary/Logging/BinaryLog.hpp>
+
+
+using namespace inl;
+using std::cout;
+using std::cerr;
+using std::endl;
+
+
+// Turns a binary log into text. Usage: LogDecoder <binary log> [text log], text goes to the console if not given.
+int main(int argc, char* argv[]) {
+	if (argc < 2 || argc > 3) {
+		cout << "Usage: LogDecoder <binary log> [text log]" << endl;
+		return 1;
+	}
+
+	std::ifstream input(argv[1], std::ios::in | std::ios::binary);
+	if (!input.is_open()) {
+		cerr << "Cannot open " << argv[1] << endl;
+		return 1;
+	}
+	std::ofstream file;
+	if (argc == 3) {
+		file.open(argv[2], std::ios::out | std::ios::trunc);
+		if (!file.is_open()) {
+			cerr << "Cannot open " << argv[2] << endl;
+			return 1;
+		}
+	}
+	std::ostream& output = argc == 3 ? file : cout;
+
+	try {
+		if (!DecodeBinaryLog(input, output)) {
+			cerr << "The log is truncated, the last entry is missing." << endl;
+			return 2;
+		}
+	}
+	catch (Exception& ex) {
+		cerr << ex.what() << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -71,8 +71,9 @@ int main() {
 	try {
 		PrintHelpText();
 
-		// Create logger.
+		// Create logger, events are written by its own thread so that the engine never waits for them.
 		Logger logger;
+		logger.SetAsync(true);
 
 		// Create graphics API.
 		gxapi_dx12::GxapiManager gxapiManager;
@@ -83,10 +84,8 @@ int main() {
 		}
 		std::unique_ptr<gxapi::IGraphicsApi> graphicsApi(gxapiManager.CreateGraphicsApi(adapters[0].adapterId));
 
-		// Create window.
-		Window window;
-		window.SetTitle("Node editor");
-		window.SetSize({ 1024, 640 });
+		// Create window, its messages are processed on its own thread so that dragging it doesn't stall the editor.
+		Window window{ "Node editor", { 1024, 640 }, false, true, false, true };
 
 		// Create graphics engine.
 		gxeng::GraphicsEngineDesc desc;
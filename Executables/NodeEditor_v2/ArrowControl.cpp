@@ -0,0 +1,112 @@
+#include "ArrowControl.hpp"
+
+#include <GuiEngine/Placeholders/PlaceholderOverlayEntity.hpp>
+
+#include <cmath>
+
+
+namespace inl::tool {
+
+
+ArrowControl::ArrowControl() {
+	m_bezierLine.reset(new gui::PlaceholderOverlayEntity());
+	m_arrowHead.reset(new gui::PlaceholderOverlayEntity());
+	m_holdPoint.reset(new gui::PlaceholderOverlayEntity());
+	m_bezierLine->SetZDepth(0.0f);
+	m_arrowHead->SetZDepth(0.1f);
+	m_holdPoint->SetZDepth(0.1f);
+	UpdateShape();
+}
+
+
+void ArrowControl::SetEndPoints(Vec2 p1, Vec2 p2) {
+	if (p1 == m_p1 && p2 == m_p2) {
+		return;
+	}
+	m_p1 = p1;
+	m_p2 = p2;
+	UpdateShape();
+	MarkDirty();
+}
+
+
+std::pair<Vec2, Vec2> ArrowControl::GetEndPoints() const {
+	return { m_p1, m_p2 };
+}
+
+
+void ArrowControl::SetLineWidth(float width) {
+	m_lineWidth = width;
+	UpdateShape();
+	MarkDirty();
+}
+
+
+float ArrowControl::GetLineWidth() const {
+	return m_lineWidth;
+}
+
+
+Vec2u ArrowControl::GetSize() const {
+	Vec2 extent = { std::abs(m_p2.x - m_p1.x), std::abs(m_p2.y - m_p1.y) };
+	return Vec2u(Max(extent, Vec2{ m_lineWidth, m_lineWidth }));
+}
+
+
+Vec2i ArrowControl::GetPosition() const {
+	Vec2 center = (m_p1 + m_p2) / 2.0f;
+	return { (int)std::round(center.x), (int)std::round(center.y) };
+}
+
+
+void ArrowControl::SetPosition(Vec2i position) {
+	Vec2 offset = Vec2(position) - (m_p1 + m_p2) / 2.0f;
+	SetEndPoints(m_p1 + offset, m_p2 + offset);
+}
+
+
+void ArrowControl::Update(float elapsed) {
+	m_bezierLine->SetColor(GetStyle().accent.v);
+	m_arrowHead->SetColor(GetStyle().accent.v);
+	m_holdPoint->SetColor(GetStyle().foreground.v);
+}
+
+
+void ArrowControl::SetZOrder(int rank) {
+	m_bezierLine->SetZDepth(rank);
+	m_arrowHead->SetZDepth(rank + 0.1f);
+	m_holdPoint->SetZDepth(rank + 0.1f);
+}
+
+
+std::vector<std::reference_wrapper<std::unique_ptr<gxeng::ITextEntity>>> ArrowControl::GetTextEntities() {
+	return {};
+}
+
+
+std::vector<std::reference_wrapper<std::unique_ptr<gxeng::IOverlayEntity>>> ArrowControl::GetOverlayEntities() {
+	return { m_bezierLine, m_arrowHead, m_holdPoint };
+}
+
+
+void ArrowControl::UpdateShape() {
+	Vec2 direction = m_p2 - m_p1;
+	float length = direction.Length();
+	float angle = length > 0.0f ? std::atan2(direction.y, direction.x) : 0.0f;
+	float headSize = 4.0f * m_lineWidth;
+
+	m_bezierLine->SetPosition((m_p1 + m_p2) / 2.0f);
+	m_bezierLine->SetScale({ length, m_lineWidth });
+	m_bezierLine->SetRotation(angle);
+
+	m_arrowHead->SetPosition(m_p2);
+	m_arrowHead->SetScale({ headSize, headSize });
+	m_arrowHead->SetRotation(angle + 0.785398163f); // Stands on its corner.
+
+	m_holdPoint->SetPosition(m_p1);
+	m_holdPoint->SetScale({ headSize / 2, headSize / 2 });
+	m_holdPoint->SetRotation(0.0f);
+}
+
+
+} // namespace inl::tool
@@ -11,22 +11,45 @@
 namespace inl::tool {
 
 
+/// <summary> A straight link between two points, with a head on the second one. </summary>
 class ArrowControl : public gui::StandardControl {
 public:
-    void SetEndPoints(Vec2 p1, Vec2 p2);
-    std::pair<Vec2, Vec2> GetEndPoints();
+	ArrowControl();
 
-    void SetLineWidth(float width);
-    float GetLineWidth(float width);
+	/// <summary> Places the arrow, the position of the control is the midpoint. </summary>
+	void SetEndPoints(Vec2 p1, Vec2 p2);
+	std::pair<Vec2, Vec2> GetEndPoints() const;
+
+	void SetLineWidth(float width);
+	float GetLineWidth() const;
+
+	Vec2u GetSize() const override;
+	Vec2i GetPosition() const override;
+
+	void Update(float elapsed = 0.0f) override;
+
+	void SetZOrder(int rank) override;
 protected:
-    // Use SetEndPoints.
-    void SetPosition(Vec2i position) override;
+	// Use SetEndPoints. Layouts move both end points through it.
+	void SetPosition(Vec2i position) override;
+	// The size follows the end points.
+	void SetSize(Vec2u size) override {}
+
+	std::vector<std::reference_wrapper<std::unique_ptr<gxeng::ITextEntity>>> GetTextEntities() override;
+	std::vector<std::reference_wrapper<std::unique_ptr<gxeng::IOverlayEntity>>> GetOverlayEntities() override;
+
+private:
+	void UpdateShape();
 
 private:
-    std::unique_ptr<gxeng::IOverlayEntity> m_bezierLine;
-    std::unique_ptr<gxeng::IOverlayEntity> m_arrowHead;
-    std::unique_ptr<gxeng::IOverlayEntity> m_holdPoint;
+	std::unique_ptr<gxeng::IOverlayEntity> m_bezierLine;
+	std::unique_ptr<gxeng::IOverlayEntity> m_arrowHead;
+	std::unique_ptr<gxeng::IOverlayEntity> m_holdPoint;
+
+	Vec2 m_p1 = { 0, 0 };
+	Vec2 m_p2 = { 0, 0 };
+	float m_lineWidth = 2.0f;
 };
 
 
-} // namespace inl::tool
\ No newline at end of file
+} // namespace inl::tool
@@ -14,7 +14,7 @@ NodeControl::NodeControl() {
 
 	m_titleLayout.SetVertical(true);
 	m_titleLayout.SetInverted(true);
-	m_titleLayout.PushBack(m_title, gui::LinearLayout::CellSize().SetWidth(32));
+	m_titleLayout.PushBack(m_title, gui::LinearLayout::CellSize().SetWidth(TitleHeight));
 	m_titleLayout.PushBack(m_ioSplitLayout, gui::LinearLayout::CellSize().SetWeight(1.0f));
 
 	m_ioSplitLayout.SetVertical(false);
@@ -33,6 +33,11 @@ NodeControl::NodeControl() {
 	};
 }
 
+unsigned NodeControl::CalculateHeight(size_t numInputPorts, size_t numOutputPorts) {
+	return TitleHeight + PortHeight * (unsigned)std::max(numInputPorts, numOutputPorts);
+}
+
+
 void NodeControl::SetName(std::string name) {
 	m_name = name;
 	UpdateTitle();
@@ -56,7 +61,7 @@ void NodeControl::SetInputPorts(std::vector<std::pair<std::string, std::string>>
 	for (auto& desc : inputPorts) {
 		gui::Button& port = m_inputPorts.emplace_back();
 		port.SetText(EncodeString<char32_t>(desc.first + " : " + desc.second));
-		m_inputPortsLayout.PushBack(port, gui::LinearLayout::CellSize().SetWidth(26));
+		m_inputPortsLayout.PushBack(port, gui::LinearLayout::CellSize().SetWidth(PortHeight));
 	}
 
 	UpdateHeight();
@@ -72,7 +77,7 @@ void NodeControl::SetOutputPorts(std::vector<std::pair<std::string, std::string>
 	for (auto& desc : outputPorts) {
 		gui::Button& port = m_outputPorts.emplace_back();
 		port.SetText(EncodeString<char32_t>(desc.first + " : " + desc.second));
-		m_outputPortsLayout.PushBack(port, gui::LinearLayout::CellSize().SetWidth(26));
+		m_outputPortsLayout.PushBack(port, gui::LinearLayout::CellSize().SetWidth(PortHeight));
 	}
 
 	UpdateHeight();
@@ -84,10 +89,7 @@ void NodeControl::UpdateTitle() {
 }
 
 void NodeControl::UpdateHeight() {
-	float height = 0.0f;
-	height += m_titleLayout.begin()->sizing.GetValue();
-	height += 26 * std::max(m_inputPorts.size(), m_outputPorts.size());
-	SetSize({ GetSize().x, height });
+	SetSize({ GetSize().x, CalculateHeight(m_inputPorts.size(), m_outputPorts.size()) });
 }
 
 
@@ -10,9 +10,16 @@ namespace inl::tool {
 
 
 class NodeControl : public gui::Frame {
+public:
+	static constexpr unsigned TitleHeight = 32;
+	static constexpr unsigned PortHeight = 26;
+
 public:
 	NodeControl();
 
+	/// <summary> The height of a node with this many ports, without creating one. </summary>
+	static unsigned CalculateHeight(size_t numInputPorts, size_t numOutputPorts);
+
 	void SetName(std::string name);
 	void SetType(std::string type);
 	void SetInputPorts(std::vector<std::pair<std::string, std::string>> inputPorts);
@@ -0,0 +1,302 @@
+#include "NodePanel.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <cmath>
+
+
+namespace inl::tool {
+
+
+template <class T>
+static std::shared_ptr<T> TakeFromPool(std::vector<std::shared_ptr<T>>& pool) {
+	if (pool.empty()) {
+		return std::make_shared<T>();
+	}
+	std::shared_ptr<T> control = std::move(pool.back());
+	pool.pop_back();
+	return control;
+}
+
+
+static Vec2i Round(Vec2 v) {
+	return { (int)std::round(v.x), (int)std::round(v.y) };
+}
+
+
+NodePanel::NodePanel() {
+	m_layout.SetReferencePoint(gui::AbsoluteLayout::eRefPoint::CENTER);
+	m_layout.SetYDown(false);
+	SetLayout(m_layout);
+}
+
+
+size_t NodePanel::AddNode(NodeDesc node) {
+	size_t id = m_nextId++;
+	m_nodes.insert({ id, NodeEntry{ std::move(node), nullptr, nullptr } });
+	InvalidateView();
+	return id;
+}
+
+
+void NodePanel::RemoveNode(size_t node) {
+	NodeEntry& entry = FindNode(node);
+	for (auto it = m_links.begin(); it != m_links.end();) {
+		if (it->second.desc.sourceNode == node || it->second.desc.targetNode == node) {
+			HideLink(it->second);
+			it = m_links.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+	HideNode(entry);
+	m_nodes.erase(node);
+	InvalidateView();
+}
+
+
+void NodePanel::SetNodePosition(size_t node, Vec2 position) {
+	FindNode(node).desc.position = position;
+	InvalidateView();
+}
+
+
+const NodePanel::NodeDesc& NodePanel::GetNode(size_t node) const {
+	return FindNode(node).desc;
+}
+
+
+size_t NodePanel::AddLink(LinkDesc link) {
+	const NodeDesc& source = FindNode(link.sourceNode).desc;
+	const NodeDesc& target = FindNode(link.targetNode).desc;
+	if (link.sourcePort >= source.outputPorts.size() || link.targetPort >= target.inputPorts.size()) {
+		throw OutOfRangeException("Link refers to a port the node does not have.");
+	}
+	size_t id = m_nextId++;
+	m_links.insert({ id, LinkEntry{ link, nullptr } });
+	InvalidateView();
+	return id;
+}
+
+
+void NodePanel::RemoveLink(size_t link) {
+	auto it = m_links.find(link);
+	if (it == m_links.end()) {
+		throw InvalidArgumentException("Link is not part of this panel.");
+	}
+	HideLink(it->second);
+	m_links.erase(it);
+	InvalidateView();
+}
+
+
+void NodePanel::Clear() {
+	for (auto& [id, link] : m_links) {
+		HideLink(link);
+	}
+	for (auto& [id, node] : m_nodes) {
+		HideNode(node);
+	}
+	m_links.clear();
+	m_nodes.clear();
+	InvalidateView();
+}
+
+
+void NodePanel::SetViewCenter(Vec2 center) {
+	m_viewCenter = center;
+	InvalidateView();
+}
+
+
+Vec2 NodePanel::GetViewCenter() const {
+	return m_viewCenter;
+}
+
+
+void NodePanel::SetZoom(float zoom) {
+	if (zoom <= 0.0f) {
+		throw InvalidArgumentException("Zoom must be positive.");
+	}
+	m_zoom = zoom;
+	InvalidateView();
+}
+
+
+float NodePanel::GetZoom() const {
+	return m_zoom;
+}
+
+
+void NodePanel::SetSize(Vec2u size) {
+	if (size != GetSize()) {
+		Frame::SetSize(size);
+		InvalidateView();
+	}
+}
+
+
+void NodePanel::Update(float elapsed) {
+	if (m_viewDirty) {
+		m_viewDirty = false;
+		UpdateVisibleControls();
+	}
+	Frame::Update(elapsed);
+}
+
+
+void NodePanel::UpdateVisibleControls() {
+	bool overview = m_zoom < OverviewZoom;
+
+	for (auto& [id, node] : m_nodes) {
+		Vec2 center = ToPanel(node.desc.position);
+		Vec2 size = GetNodeSize(node.desc, overview);
+		if (IsInView(center, size)) {
+			ShowNode(node, center, size, overview);
+		}
+		else {
+			HideNode(node);
+		}
+	}
+
+	for (auto& [id, link] : m_links) {
+		if (overview) {
+			HideLink(link);
+			continue;
+		}
+
+		// From the right side of the output port to the left side of the input port, ports are listed from the top.
+		const NodeDesc& source = FindNode(link.desc.sourceNode).desc;
+		const NodeDesc& target = FindNode(link.desc.targetNode).desc;
+		Vec2 sourceCenter = ToPanel(source.position);
+		Vec2 targetCenter = ToPanel(target.position);
+		Vec2 sourceSize = GetNodeSize(source, false);
+		Vec2 targetSize = GetNodeSize(target, false);
+		Vec2 p1 = {
+			sourceCenter.x + sourceSize.x / 2,
+			sourceCenter.y + sourceSize.y / 2 - NodeControl::TitleHeight - NodeControl::PortHeight * (link.desc.sourcePort + 0.5f)
+		};
+		Vec2 p2 = {
+			targetCenter.x - targetSize.x / 2,
+			targetCenter.y + targetSize.y / 2 - NodeControl::TitleHeight - NodeControl::PortHeight * (link.desc.targetPort + 0.5f)
+		};
+
+		Vec2 extent = { std::abs(p2.x - p1.x), std::abs(p2.y - p1.y) };
+		if (IsInView((p1 + p2) / 2.0f, extent)) {
+			ShowLink(link, p1, p2);
+		}
+		else {
+			HideLink(link);
+		}
+	}
+}
+
+
+void NodePanel::ShowNode(NodeEntry& node, Vec2 center, Vec2 size, bool overview) {
+	// Switching between the overview and the full nodes.
+	if (overview ? bool(node.control) : bool(node.box)) {
+		HideNode(node);
+	}
+
+	gui::Control* control;
+	if (overview) {
+		if (!node.box) {
+			node.box = TakeFromPool(m_boxPool);
+			gui::ControlStyle style = GetStyle();
+			style.background = style.foreground;
+			node.box->SetStyle(style);
+			m_layout.AddChild(node.box);
+		}
+		node.box->SetSize(Vec2u(Max(size, Vec2{ 1, 1 })));
+		control = node.box.get();
+	}
+	else {
+		if (!node.control) {
+			node.control = TakeFromPool(m_nodePool);
+			node.control->SetName(node.desc.name);
+			node.control->SetType(node.desc.type);
+			node.control->SetInputPorts(node.desc.inputPorts);
+			node.control->SetOutputPorts(node.desc.outputPorts);
+			node.control->SetSize(Vec2u(size));
+			m_layout.AddChild(node.control);
+		}
+		control = node.control.get();
+	}
+	m_layout[control].SetPosition(Round(center));
+}
+
+
+void NodePanel::HideNode(NodeEntry& node) {
+	if (node.control) {
+		m_layout.RemoveChild(node.control.get());
+		m_nodePool.push_back(std::move(node.control));
+		node.control = nullptr;
+	}
+	if (node.box) {
+		m_layout.RemoveChild(node.box.get());
+		m_boxPool.push_back(std::move(node.box));
+		node.box = nullptr;
+	}
+}
+
+
+void NodePanel::ShowLink(LinkEntry& link, Vec2 p1, Vec2 p2) {
+	if (!link.control) {
+		link.control = TakeFromPool(m_arrowPool);
+		m_layout.AddChild(link.control);
+	}
+	// The layout places the midpoint, the end points give the direction and length.
+	link.control->SetEndPoints(p1, p2);
+	m_layout[link.control.get()].SetPosition(Round((p1 + p2) / 2.0f));
+}
+
+
+void NodePanel::HideLink(LinkEntry& link) {
+	if (link.control) {
+		m_layout.RemoveChild(link.control.get());
+		m_arrowPool.push_back(std::move(link.control));
+		link.control = nullptr;
+	}
+}
+
+
+NodePanel::NodeEntry& NodePanel::FindNode(size_t node) {
+	return const_cast<NodeEntry&>(static_cast<const NodePanel*>(this)->FindNode(node));
+}
+
+
+const NodePanel::NodeEntry& NodePanel::FindNode(size_t node) const {
+	auto it = m_nodes.find(node);
+	if (it == m_nodes.end()) {
+		throw InvalidArgumentException("Node is not part of this panel.");
+	}
+	return it->second;
+}
+
+
+Vec2 NodePanel::ToPanel(Vec2 graphPosition) const {
+	return (graphPosition - m_viewCenter) * m_zoom;
+}
+
+
+Vec2 NodePanel::GetNodeSize(const NodeDesc& node, bool overview) const {
+	Vec2 size = { (float)NodeWidth, (float)NodeControl::CalculateHeight(node.inputPorts.size(), node.outputPorts.size()) };
+	// Full nodes keep their size so that the text stays readable, only their spacing follows the zoom.
+	return overview ? size * m_zoom : size;
+}
+
+
+bool NodePanel::IsInView(Vec2 center, Vec2 size) const {
+	Vec2 reach = Vec2(GetSize()) / 2.0f + Vec2{ ViewMargin, ViewMargin } + size / 2.0f;
+	return std::abs(center.x) <= reach.x && std::abs(center.y) <= reach.y;
+}
+
+
+void NodePanel::InvalidateView() {
+	m_viewDirty = true;
+	MarkDirty();
+}
+
+
+} // namespace inl::tool
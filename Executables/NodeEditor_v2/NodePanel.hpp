@@ -7,29 +7,107 @@
 #include "ArrowControl.hpp"
 
 #include <memory>
-#include <string_view>
-#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 
 namespace inl::tool {
 
 
-class NodePanel : gui::Frame {
+/// <summary> Shows a graph of nodes and links, with controls only for what is in view. </summary>
+/// <remarks>
+/// Nodes and links are kept as descriptions. Controls exist only for the ones that intersect the panel
+/// with <see cref="ViewMargin"/> around it, and are taken from pools as they scroll into view.
+/// Zoomed out below <see cref="OverviewZoom"/>, nodes are drawn as plain boxes without their ports and links.
+/// </remarks>
+class NodePanel : public gui::Frame {
 public:
-    NodePanel();
+	struct NodeDesc {
+		std::string name;
+		std::string type;
+		std::vector<std::pair<std::string, std::string>> inputPorts;
+		std::vector<std::pair<std::string, std::string>> outputPorts;
+		Vec2 position = { 0, 0 }; // Center of the node in graph space.
+	};
+	struct LinkDesc {
+		size_t sourceNode;
+		size_t sourcePort; // Output port of the source node.
+		size_t targetNode;
+		size_t targetPort; // Input port of the target node.
+	};
 
-    void AddNode(std::shared_ptr<NodeControl> node);
-    void RemoveNode(const NodeControl* node);
-    
+	static constexpr float OverviewZoom = 0.5f;
+	static constexpr float ViewMargin = 100.0f; // Panel pixels.
+	static constexpr unsigned NodeWidth = 240;
+
+public:
+	NodePanel();
+
+	/// <summary> Adds a node, returns its identifier for the other methods. </summary>
+	size_t AddNode(NodeDesc node);
+	/// <summary> Removes the node and the links that use it. </summary>
+	void RemoveNode(size_t node);
+	void SetNodePosition(size_t node, Vec2 position);
+	const NodeDesc& GetNode(size_t node) const;
+
+	/// <summary> Adds a link between two existing nodes, returns its identifier. </summary>
+	size_t AddLink(LinkDesc link);
+	void RemoveLink(size_t link);
+
+	void Clear();
+
+	/// <summary> The point of the graph shown at the center of the panel. </summary>
+	void SetViewCenter(Vec2 center);
+	Vec2 GetViewCenter() const;
+	/// <summary> Panel pixels per graph unit. </summary>
+	void SetZoom(float zoom);
+	float GetZoom() const;
+
+	void SetSize(Vec2u size) override;
+
+	void Update(float elapsed = 0.0f) override;
+
+private:
+	struct NodeEntry {
+		NodeDesc desc;
+		std::shared_ptr<NodeControl> control;
+		std::shared_ptr<gui::Frame> box;
+	};
+	struct LinkEntry {
+		LinkDesc desc;
+		std::shared_ptr<ArrowControl> control;
+	};
+
+	void UpdateVisibleControls();
+	void ShowNode(NodeEntry& node, Vec2 center, Vec2 size, bool overview);
+	void HideNode(NodeEntry& node);
+	void ShowLink(LinkEntry& link, Vec2 p1, Vec2 p2);
+	void HideLink(LinkEntry& link);
+
+	NodeEntry& FindNode(size_t node);
+	const NodeEntry& FindNode(size_t node) const;
+	Vec2 ToPanel(Vec2 graphPosition) const;
+	Vec2 GetNodeSize(const NodeDesc& node, bool overview) const;
+	bool IsInView(Vec2 center, Vec2 size) const;
+	void InvalidateView();
 
 private:
-    gui::AbsoluteLayout m_layout;
+	gui::AbsoluteLayout m_layout;
+
+	std::unordered_map<size_t, NodeEntry> m_nodes;
+	std::unordered_map<size_t, LinkEntry> m_links;
+	size_t m_nextId = 0;
 
-    std::set<std::shared_ptr<NodeControl>> m_nodes;
-    std::set<std::shared_ptr<ArrowControl>> m_arrows;
+	// Controls that left the view, reused for the ones that enter.
+	std::vector<std::shared_ptr<NodeControl>> m_nodePool;
+	std::vector<std::shared_ptr<gui::Frame>> m_boxPool;
+	std::vector<std::shared_ptr<ArrowControl>> m_arrowPool;
 
-    
+	Vec2 m_viewCenter = { 0, 0 };
+	float m_zoom = 1.0f;
+	bool m_viewDirty = true;
 };
 
 
-} // namespace inl::tool
\ No newline at end of file
+} // namespace inl::tool
@@ -4,7 +4,7 @@
 #include <BaseLibrary/Platform/Window.hpp>
 #include <BaseLibrary/Platform/System.hpp>
 #include <BaseLibrary/Logging_All.hpp>
-#include <BaseLibrary/Timer.hpp>
+#include <BaseLibrary/FramePacer.hpp>
 
 #include <GraphicsApi_D3D12/GxapiManager.hpp>
 #include <GraphicsApi_LL/IGraphicsApi.hpp>
@@ -47,8 +47,9 @@ std::vector<std::string> GetMaterialShaders() {
 
 int main() {
 	try {
-		// Create logger.
+		// Create logger, events are written by its own thread so that the engine never waits for them.
 		Logger logger;
+		logger.SetAsync(true);
 
 		// Create graphics API.
 		gxapi_dx12::GxapiManager gxapiManager;
@@ -94,9 +95,9 @@ int main() {
 		// Create NodeEditor.
 		tool::NodeEditor nodeEditor(&graphicsEngine, &window);
 
-		// Run game loop.
-		Timer timer;
-		timer.Start();
+		// Run game loop, an editor has no use for more frames than the display shows.
+		FramePacer pacer;
+		pacer.SetTargetFrameRate(144.0);
 		window.Show();
 		double elapsed = 0.01f;
 		while (!window.IsClosed()) {
@@ -104,8 +105,7 @@ int main() {
 			nodeEditor.Update((float)elapsed);
 			graphicsEngine.Update((float)elapsed);
 
-			elapsed = timer.Elapsed();
-			timer.Reset();
+			elapsed = pacer.Wait();
 			std::stringstream ss;
 			ss << "Node Editor v2 | " << "FrameTime=" << elapsed*1000 << "ms";
 			window.SetTitle(ss.str());
@@ -0,0 +1,86 @@
+#include "AssetManifest.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <rapidjson/document.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+
+using namespace inl;
+
+
+static const std::pair<eAssetType, const char*> typeNames[] = {
+	{ eAssetType::MESH, "mesh" },
+	{ eAssetType::IMAGE, "image" },
+	{ eAssetType::MATERIAL_SHADER, "materialShader" },
+	{ eAssetType::MATERIAL, "material" },
+	{ eAssetType::PHYSICS_MESH, "physicsMesh" },
+};
+
+
+const char* GetTypeName(eAssetType type) {
+	for (const auto& [value, name] : typeNames) {
+		if (value == type) {
+			return name;
+		}
+	}
+	return "unknown";
+}
+
+
+std::vector<ManifestEntry> ReadManifest(const std::filesystem::path& path) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		throw FileNotFoundException("Failed to open asset manifest.", path.string());
+	}
+	std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	rapidjson::Document doc;
+	doc.Parse(text.c_str());
+	if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember("assets") || !doc["assets"].IsArray()) {
+		throw InvalidArgumentException("Asset manifest must be an object with an array of assets.", path.string());
+	}
+
+	std::vector<ManifestEntry> entries;
+	for (const auto& asset : doc["assets"].GetArray()) {
+		if (!asset.IsObject() || !asset.HasMember("type") || !asset["type"].IsString() || !asset.HasMember("path") || !asset["path"].IsString()) {
+			throw InvalidArgumentException("Assets of the manifest must have a type and a path.", path.string());
+		}
+		ManifestEntry entry;
+		std::string type = asset["type"].GetString();
+		auto it = std::find_if(std::begin(typeNames), std::end(typeNames), [&type](const auto& typeName) { return type == typeName.second; });
+		if (it == std::end(typeNames)) {
+			throw InvalidArgumentException("Unknown asset type.", type);
+		}
+		entry.type = it->first;
+		entry.path = asset["path"].GetString();
+		if (asset.HasMember("dynamic")) {
+			if (!asset["dynamic"].IsBool() || entry.type != eAssetType::PHYSICS_MESH) {
+				throw InvalidArgumentException("Only physics meshes can be dynamic, with true or false.", entry.path);
+			}
+			entry.dynamic = asset["dynamic"].GetBool();
+		}
+		entries.push_back(std::move(entry));
+	}
+	return entries;
+}
+
+
+std::vector<std::filesystem::path> GetCookedPaths(const ManifestEntry& entry, const std::filesystem::path& dataDirectory) {
+	std::filesystem::path cooked = dataDirectory / entry.path;
+	switch (entry.type) {
+		case eAssetType::MESH: cooked += ".cooked"; break;
+		case eAssetType::IMAGE: cooked += ".cooked.dds"; break;
+		case eAssetType::PHYSICS_MESH:
+			if (entry.dynamic) {
+				return {};
+			}
+			cooked += ".cookedphysics";
+			break;
+		default: return {};
+	}
+	return { cooked };
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+
+enum class eAssetType {
+	MESH,
+	IMAGE,
+	MATERIAL_SHADER,
+	MATERIAL,
+	PHYSICS_MESH,
+};
+
+
+struct ManifestEntry {
+	eAssetType type;
+	std::string path; // Relative to the data directory, as given to the AssetStore.
+	bool dynamic = false; // Physics meshes only, dynamic ones are convex hulls and have no cooked BVH.
+};
+
+
+/// <summary> The name of the type in manifests and reports. </summary>
+const char* GetTypeName(eAssetType type);
+
+/// <summary> Reads a JSON manifest like { "assets": [ { "type": "mesh", "path": "Models/x.fbx" } ] }. </summary>
+/// <remarks> Types are mesh, image, materialShader, material and physicsMesh, which may have "dynamic": true.
+///		Throws InvalidArgumentException if the manifest is malformed. </remarks>
+std::vector<ManifestEntry> ReadManifest(const std::filesystem::path& path);
+
+/// <summary> The files the AssetStore cooks next to the entry's source, whether they exist or not. </summary>
+std::vector<std::filesystem::path> GetCookedPaths(const ManifestEntry& entry, const std::filesystem::path& dataDirectory);
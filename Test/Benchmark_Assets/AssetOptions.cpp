@@ -0,0 +1,73 @@
+#include "AssetOptions.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <string_view>
+
+
+using namespace inl;
+
+
+static unsigned ParseUnsigned(std::string_view option, const std::string& value, unsigned min, unsigned max) {
+	try {
+		size_t length;
+		unsigned long result = std::stoul(value, &length);
+		if (length != value.size() || !(min <= result && result <= max)) {
+			throw std::invalid_argument(value);
+		}
+		return (unsigned)result;
+	}
+	catch (std::exception&) {
+		throw InvalidArgumentException("Option expects an integer between " + std::to_string(min) + " and " + std::to_string(max) + ".", std::string(option) + " " + value);
+	}
+}
+
+
+AssetOptions ParseOptions(int argc, char* argv[]) {
+	AssetOptions options;
+	for (int i = 1; i < argc; ++i) {
+		std::string_view option = argv[i];
+		if (i + 1 >= argc) {
+			throw InvalidArgumentException("Option has no value.", std::string(option));
+		}
+		std::string value = argv[++i];
+
+		if (option == "--data") {
+			options.data = value;
+		}
+		else if (option == "--manifest") {
+			options.manifest = value;
+		}
+		else if (option == "--api") {
+			if (value != "d3d12" && value != "null") {
+				throw InvalidArgumentException("Graphics API must be d3d12 or null.", value);
+			}
+			options.api = value;
+		}
+		else if (option == "--cold") {
+			if (value != "import" && value != "cooked") {
+				throw InvalidArgumentException("Cold pass must be import or cooked.", value);
+			}
+			options.cold = value;
+		}
+		else if (option == "--warm") {
+			options.warmPasses = ParseUnsigned(option, value, 0, 1000);
+		}
+		else if (option == "--texture-compression") {
+			options.textureCompression = ParseUnsigned(option, value, 0, 1) != 0;
+		}
+		else if (option == "--output") {
+			options.output = value;
+		}
+		else {
+			throw InvalidArgumentException("Unknown option.", std::string(option));
+		}
+	}
+	return options;
+}
+
+
+std::string GetUsage() {
+	return "Benchmark_Assets [--data <game data>] [--manifest Benchmarks/assets.json] [--api d3d12|null]\n"
+		   "                 [--cold import|cooked] [--warm 3] [--texture-compression 0] [--output report.json]\n";
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+
+struct AssetOptions {
+	std::string data; // Directory the manifest's paths are relative to, the game data if empty.
+	std::string manifest; // Benchmarks/assets.json of the data directory if empty.
+	std::string api = "d3d12"; // d3d12, or null to load on any machine without a GPU.
+	std::string cold = "import"; // import removes the cooked files before the cold pass, cooked keeps them.
+	unsigned warmPasses = 3; // Passes after the cold one, each with a new store, the files in the OS cache and cooked.
+	bool textureCompression = false; // Images are compressed to BCn and cooked, see AssetStore::SetTextureCompression.
+	std::string output; // The JSON report goes to this file, or to stdout if empty.
+};
+
+
+/// <summary> Reads options like --warm 5 from the command line, unknown options throw InvalidArgumentException. </summary>
+AssetOptions ParseOptions(int argc, char* argv[]);
+
+/// <summary> Short description of the options. </summary>
+std::string GetUsage();
@@ -0,0 +1,131 @@
+#include "AssetReport.hpp"
+
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+#include <algorithm>
+
+
+namespace {
+
+struct Totals {
+	size_t count = 0;
+	double time = 0.0;
+	std::map<std::string, double> stages;
+
+	void Add(const AssetSample& sample) {
+		++count;
+		time += sample.time;
+		for (const auto& [stage, stageTime] : sample.stages) {
+			stages[stage] += stageTime;
+		}
+	}
+};
+
+
+// Other is the time in none of the stages, looking up the file or waiting for the shared cache.
+// Nested loads are stages of their own, none of them overlap.
+template <class Writer>
+void WriteStages(Writer& writer, double time, const std::map<std::string, double>& stages) {
+	writer.Key("stages");
+	writer.StartObject();
+	double other = time;
+	for (const auto& [stage, stageTime] : stages) {
+		writer.Key(stage.c_str());
+		writer.Double(stageTime);
+		other -= stageTime;
+	}
+	writer.Key("other");
+	writer.Double(std::max(other, 0.0));
+	writer.EndObject();
+}
+
+} // namespace
+
+
+void WriteReport(std::ostream& output, const AssetOptions& options, const std::vector<AssetPass>& passes) {
+	rapidjson::OStreamWrapper stream(output);
+	rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(stream);
+
+	writer.StartObject();
+	writer.Key("manifest");
+	writer.String(options.manifest.c_str());
+	writer.Key("api");
+	writer.String(options.api.c_str());
+	writer.Key("cold");
+	writer.String(options.cold.c_str());
+	writer.Key("textureCompression");
+	writer.Bool(options.textureCompression);
+
+	writer.Key("passes");
+	writer.StartArray();
+	for (const AssetPass& pass : passes) {
+		writer.StartObject();
+		writer.Key("name");
+		writer.String(pass.name.c_str());
+		writer.Key("time");
+		writer.Double(pass.time);
+
+		Totals all;
+		std::map<std::string, Totals> byType;
+		for (const AssetSample& sample : pass.samples) {
+			all.Add(sample);
+			byType[GetTypeName(sample.entry.type)].Add(sample);
+		}
+		WriteStages(writer, all.time, all.stages);
+
+		writer.Key("types");
+		writer.StartObject();
+		for (const auto& [type, totals] : byType) {
+			writer.Key(type.c_str());
+			writer.StartObject();
+			writer.Key("count");
+			writer.Uint64(totals.count);
+			writer.Key("time");
+			writer.Double(totals.time);
+			WriteStages(writer, totals.time, totals.stages);
+			writer.EndObject();
+		}
+		writer.EndObject();
+
+		writer.Key("memory");
+		writer.StartObject();
+		writer.Key("cacheCpuBytes");
+		writer.Uint64(pass.cache.cpuBytes);
+		writer.Key("cacheGpuBytes");
+		writer.Uint64(pass.cache.gpuBytes);
+		writer.Key("tracked");
+		writer.Bool(pass.memoryTracked);
+		if (pass.memoryTracked) {
+			writer.Key("peakAssetBytes");
+			writer.Int64(pass.peakAssetBytes);
+			writer.Key("peakBytes");
+			writer.Int64(pass.peakBytes);
+		}
+		writer.EndObject();
+
+		writer.Key("assets");
+		writer.StartArray();
+		for (const AssetSample& sample : pass.samples) {
+			writer.StartObject();
+			writer.Key("type");
+			writer.String(GetTypeName(sample.entry.type));
+			writer.Key("path");
+			writer.String(sample.entry.path.c_str());
+			if (sample.entry.dynamic) {
+				writer.Key("dynamic");
+				writer.Bool(true);
+			}
+			writer.Key("time");
+			writer.Double(sample.time);
+			WriteStages(writer, sample.time, sample.stages);
+			writer.EndObject();
+		}
+		writer.EndArray();
+
+		writer.EndObject();
+	}
+	writer.EndArray();
+	writer.EndObject();
+	output << std::endl;
+}
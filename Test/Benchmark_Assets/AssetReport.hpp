@@ -0,0 +1,39 @@
+#pragma once
+
+#include "AssetManifest.hpp"
+#include "AssetOptions.hpp"
+
+#include <AssetLibrary/AssetStore.hpp>
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+/// <summary> The load of one asset of the manifest. </summary>
+struct AssetSample {
+	ManifestEntry entry;
+	double time = 0.0; // Milliseconds from the request to the returned asset.
+	std::map<std::string, double> stages; // Milliseconds in the store's "Asset ..." profiler zones, by the rest of the zone's name.
+};
+
+
+/// <summary> Loading the whole manifest with one store. </summary>
+struct AssetPass {
+	std::string name; // cold, or warm followed by its number.
+	std::vector<AssetSample> samples;
+	double time = 0.0; // Milliseconds, all samples and what's between them.
+	inl::asset::AssetCacheStatistics cache; // At the end of the pass, with all the assets still in use.
+
+	// Of the global allocator, only counted in builds with INL_MEMORY_TRACKING.
+	bool memoryTracked = false;
+	int64_t peakAssetBytes = 0; // Allocations made while loading assets.
+	int64_t peakBytes = 0; // All tags together, the sum of their peaks.
+};
+
+
+/// <summary> Writes the passes with each asset's stages, and the totals by asset type and by stage as JSON. </summary>
+/// <remarks> Assets loaded by others, like the images of a material, count for the one that requested them. </remarks>
+void WriteReport(std::ostream& output, const AssetOptions& options, const std::vector<AssetPass>& passes);
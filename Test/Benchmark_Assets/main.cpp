@@ -0,0 +1,186 @@
+#include "AssetManifest.hpp"
+#include "AssetOptions.hpp"
+#include "AssetReport.hpp"
+
+#include <BaseLibrary/FrameProfiler.hpp>
+#include <BaseLibrary/Logging_All.hpp>
+#include <BaseLibrary/Memory/MemoryTracker.hpp>
+#include <BaseLibrary/Platform/Window.hpp>
+#include <BaseLibrary/Timer.hpp>
+#include <GraphicsApi_D3D12/GxapiManager.hpp>
+#include <GraphicsApi_Null/GxapiManager.hpp>
+#include <GraphicsApi_LL/IGraphicsApi.hpp>
+#include <GraphicsApi_LL/IGxapiManager.hpp>
+#include <GraphicsEngine_LL/GraphicsEngine.hpp>
+#include <PhysicsEngine_Bullet/PhysicsEngine.hpp>
+
+// After the platform headers, it undefines the LoadImage macro of windows.h.
+#include <AssetLibrary/AssetStore.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+
+using namespace inl;
+
+
+static std::shared_ptr<const void> Load(asset::AssetStore& store, const ManifestEntry& entry) {
+	switch (entry.type) {
+		case eAssetType::MESH: return store.LoadGraphicsMesh(entry.path);
+		case eAssetType::IMAGE: return store.LoadImage(entry.path);
+		case eAssetType::MATERIAL_SHADER: return store.LoadMaterialShader(entry.path);
+		case eAssetType::MATERIAL: return store.LoadMaterial(entry.path);
+		case eAssetType::PHYSICS_MESH: return store.LoadPhysicsMesh(entry.path, entry.dynamic);
+		default: throw InvalidArgumentException("Unknown asset type.");
+	}
+}
+
+
+// Loads the manifest with a new store, one profiler frame per asset so that the stages can be told apart.
+static AssetPass RunPass(std::string name, const std::vector<ManifestEntry>& manifest, const AssetOptions& options,
+						 gxeng::GraphicsEngine* graphicsEngine, pxeng_bl::PhysicsEngine* physicsEngine, uint64_t& frameIndex) {
+	FrameProfiler& profiler = FrameProfiler::GetGlobal();
+	MemoryTracker::ResetPeaks();
+
+	AssetPass pass;
+	pass.name = std::move(name);
+
+	asset::AssetStore store{ graphicsEngine, physicsEngine };
+	store.AddSourceDirectory(options.data);
+	store.SetTextureCompression(options.textureCompression);
+	std::vector<std::shared_ptr<const void>> loaded; // Kept in use until the end, so that the cache holds all of them.
+
+	Timer passTimer;
+	passTimer.Start();
+	for (const ManifestEntry& entry : manifest) {
+		AssetSample sample;
+		sample.entry = entry;
+
+		profiler.BeginFrame(frameIndex++);
+		Timer timer;
+		timer.Start();
+		loaded.push_back(Load(store, entry));
+		sample.time = timer.Elapsed() * 1000.0;
+		profiler.EndFrame();
+
+		const std::string_view prefix = "Asset ";
+		for (const ProfileZone& zone : profiler.GetLastFrame().zones) {
+			std::string_view zoneName = zone.name;
+			if (zoneName.substr(0, prefix.size()) == prefix) {
+				sample.stages[std::string(zoneName.substr(prefix.size()))] += (zone.end - zone.begin) * 1000.0;
+			}
+		}
+		pass.samples.push_back(std::move(sample));
+	}
+	pass.time = passTimer.Elapsed() * 1000.0;
+	pass.cache = store.GetCacheStatistics();
+
+	pass.memoryTracked = MemoryTracker::IsEnabled();
+	MemorySnapshot memory = MemoryTracker::GetSnapshot();
+	pass.peakAssetBytes = memory[eMemoryTag::ASSETS].peakBytes;
+	for (const MemoryTagStatistics& tag : memory.tags) {
+		pass.peakBytes += tag.peakBytes;
+	}
+
+	loaded.clear();
+	return pass;
+}
+
+
+// Loads a manifest of assets through the AssetStore and prints the time of each load stage as JSON:
+// reading files, decoding them with Assimp or FreeImage, converting and compressing vertices, block compressing
+// images, uploading, and generating material shaders and materials. The cold pass imports the sources, or reads
+// the cooked files with --cold cooked, while the files may not be in the OS cache yet. The warm passes read
+// them again with new stores. The engine needs a swap chain, so it gets a window that is never shown.
+int main(int argc, char* argv[]) {
+	AssetOptions options;
+	try {
+		options = ParseOptions(argc, argv);
+	}
+	catch (InvalidArgumentException& ex) {
+		std::cerr << ex.what() << " " << ex.Subject() << std::endl;
+		std::cerr << GetUsage();
+		return 2;
+	}
+
+	try {
+		if (options.data.empty()) {
+			options.data = INL_GAMEDATA;
+		}
+		if (options.manifest.empty()) {
+			options.manifest = (std::filesystem::path(options.data) / "Benchmarks" / "assets.json").string();
+		}
+		const std::vector<ManifestEntry> manifest = ReadManifest(options.manifest);
+
+		Logger logger;
+		Window window{ "Asset benchmark", { 640, 480 }, false, false, true };
+
+		// Create graphics API.
+		std::unique_ptr<gxapi::IGxapiManager> gxapiManager;
+		if (options.api == "null") {
+			gxapiManager.reset(new gxapi_null::GxapiManager());
+		}
+		else {
+			gxapiManager.reset(new gxapi_dx12::GxapiManager());
+		}
+
+		auto adapters = gxapiManager->EnumerateAdapters();
+		if (adapters.empty()) {
+			throw RuntimeException("No suitable graphics adapter found.");
+		}
+
+		std::unique_ptr<gxapi::IGraphicsApi> graphicsApi(gxapiManager->CreateGraphicsApi(adapters[0].adapterId));
+
+		// Create graphics and physics engines.
+		gxeng::GraphicsEngineDesc graphicsEngineDesc;
+		graphicsEngineDesc.gxapiManager = gxapiManager.get();
+		graphicsEngineDesc.graphicsApi = graphicsApi.get();
+		graphicsEngineDesc.fullScreen = false;
+		graphicsEngineDesc.width = window.GetClientSize().x;
+		graphicsEngineDesc.height = window.GetClientSize().y;
+		graphicsEngineDesc.logger = &logger;
+		graphicsEngineDesc.targetWindow = window.GetNativeHandle();
+		std::unique_ptr<gxeng::GraphicsEngine> graphicsEngine(new gxeng::GraphicsEngine(graphicsEngineDesc));
+		graphicsEngine->SetShaderDirectories({ INL_NODE_SHADER_DIRECTORY, INL_MTL_SHADER_DIRECTORY, "./Shaders", "./Materials" });
+		std::unique_ptr<pxeng_bl::PhysicsEngine> physicsEngine(new pxeng_bl::PhysicsEngine());
+
+		// The cold pass imports the sources if their cooked files are gone.
+		if (options.cold == "import") {
+			for (const ManifestEntry& entry : manifest) {
+				for (const std::filesystem::path& cooked : GetCookedPaths(entry, options.data)) {
+					std::error_code ec;
+					std::filesystem::remove(cooked, ec);
+				}
+			}
+		}
+
+		FrameProfiler::GetGlobal().SetEnabled(true);
+		std::vector<AssetPass> passes;
+		uint64_t frameIndex = 0;
+		passes.push_back(RunPass("cold", manifest, options, graphicsEngine.get(), physicsEngine.get(), frameIndex));
+		for (unsigned i = 0; i < options.warmPasses; ++i) {
+			passes.push_back(RunPass("warm " + std::to_string(i + 1), manifest, options, graphicsEngine.get(), physicsEngine.get(), frameIndex));
+		}
+
+		// Write report.
+		if (options.output.empty()) {
+			WriteReport(std::cout, options, passes);
+		}
+		else {
+			std::ofstream outputFile(options.output);
+			if (!outputFile.is_open()) {
+				throw RuntimeException("Failed to open output file.", options.output);
+			}
+			WriteReport(outputFile, options, passes);
+		}
+		return 0;
+	}
+	catch (Exception& ex) {
+		std::cerr << "Unhandled exception occured." << std::endl;
+		std::cerr << "MESSAGE:" << ex.what() << std::endl;
+		std::cerr << "STACK TRACE:" << std::endl;
+		ex.PrintStackTrace(std::cerr);
+		return 1;
+	}
+}
@@ -0,0 +1,79 @@
+#include <BaseLibrary/Memory/RingAllocationEngine.hpp>
+#include <BaseLibrary/Memory/SlabAllocatorEngine.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <vector>
+
+
+using namespace inl;
+
+
+static constexpr size_t PoolSize = 4096;
+
+
+TEST_CASE("SlabAllocatorEngine", "[Allocators]") {
+	SlabAllocatorEngine engine(PoolSize);
+	std::vector<size_t> indices;
+	indices.reserve(PoolSize);
+	size_t checksum = 0;
+
+	BENCHMARK("Allocate and deallocate one") {
+		size_t index = engine.Allocate();
+		checksum += index;
+		engine.Deallocate(index);
+	}
+
+	BENCHMARK("Fill and empty pool") {
+		for (size_t i = 0; i < PoolSize; ++i) {
+			indices.push_back(engine.Allocate());
+		}
+		for (size_t index : indices) {
+			engine.Deallocate(index);
+		}
+		checksum += indices.back();
+		indices.clear();
+	}
+
+	BENCHMARK("Fill and reset pool") {
+		for (size_t i = 0; i < PoolSize; ++i) {
+			checksum += engine.Allocate();
+		}
+		engine.Reset();
+	}
+
+	REQUIRE(checksum > 0);
+}
+
+
+TEST_CASE("RingAllocationEngine", "[Allocators]") {
+	RingAllocationEngine engine(PoolSize);
+	std::vector<size_t> indices;
+	indices.reserve(PoolSize);
+	size_t checksum = 0;
+
+	BENCHMARK("Allocate and deallocate one") {
+		size_t index = engine.Allocate();
+		checksum += index;
+		engine.Deallocate(index);
+	}
+
+	BENCHMARK("Allocate and deallocate 16 cells") {
+		size_t index = engine.Allocate(16);
+		checksum += index;
+		engine.Deallocate(index);
+	}
+
+	BENCHMARK("Fill and empty pool in order") {
+		for (size_t i = 0; i < PoolSize; ++i) {
+			indices.push_back(engine.Allocate());
+		}
+		for (size_t index : indices) {
+			engine.Deallocate(index);
+		}
+		checksum += indices.back();
+		indices.clear();
+	}
+
+	REQUIRE(checksum > 0);
+}
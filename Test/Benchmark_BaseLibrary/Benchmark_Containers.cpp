@@ -0,0 +1,83 @@
+#include <BaseLibrary/RingBuffer.hpp>
+#include <BaseLibrary/Serialization/BinarySerializer.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <cstdint>
+#include <deque>
+
+
+using namespace inl;
+
+
+TEST_CASE("RingBuffer", "[Containers]") {
+	RingBuffer<int> listBuffer;
+	RingBuffer<int, std::deque<int>> dequeBuffer;
+	for (int i = 0; i < 64; ++i) {
+		listBuffer.PushFront(i);
+		dequeBuffer.PushFront(i);
+	}
+	long long checksum = 0;
+
+	BENCHMARK("Rotate list backed") {
+		listBuffer.RotateFront();
+		checksum += listBuffer.Front();
+	}
+
+	BENCHMARK("Rotate deque backed") {
+		dequeBuffer.RotateFront();
+		checksum += dequeBuffer.Front();
+	}
+
+	BENCHMARK("Push and pop list backed") {
+		listBuffer.PushFront(1);
+		checksum += listBuffer.Back();
+		listBuffer.PopFront();
+	}
+
+	BENCHMARK("Iterate 64 elements") {
+		for (auto it = listBuffer.Begin(); it != listBuffer.End(); ++it) {
+			checksum += *it;
+		}
+	}
+
+	REQUIRE(checksum > 0);
+}
+
+
+TEST_CASE("BinarySerializer", "[Containers]") {
+	BinarySerializer serializer;
+	uint64_t checksum = 0;
+
+	BENCHMARK("Serialize and extract 256 integers") {
+		for (int32_t i = 0; i < 256; ++i) {
+			serializer << i;
+		}
+		for (int i = 0; i < 256; ++i) {
+			int32_t value;
+			serializer >> value;
+			checksum += value;
+		}
+	}
+
+	BENCHMARK("Serialize and extract 256 floats") {
+		for (int i = 0; i < 256; ++i) {
+			serializer << float(i) * 0.5f;
+		}
+		for (int i = 0; i < 256; ++i) {
+			float value;
+			serializer >> value;
+			checksum += uint64_t(value);
+		}
+	}
+
+	BENCHMARK("Serialize 256 integers to the front") {
+		for (int32_t i = 0; i < 256; ++i) {
+			i >> serializer;
+		}
+		checksum += serializer.Size();
+		serializer.Clear();
+	}
+
+	REQUIRE(checksum > 0);
+}
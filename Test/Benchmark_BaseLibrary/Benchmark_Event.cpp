@@ -0,0 +1,77 @@
+#include <BaseLibrary/Delegate.hpp>
+#include <BaseLibrary/Event.hpp>
+
+#include <Catch2/catch.hpp>
+
+
+using namespace inl;
+
+
+namespace {
+
+class Accumulator {
+public:
+	void Add(int value) {
+		m_sum += value;
+	}
+	long long Sum() const {
+		return m_sum;
+	}
+
+private:
+	long long m_sum = 0;
+};
+
+long long g_freeSum = 0;
+
+void AddFree(int value) {
+	g_freeSum += value;
+}
+
+} // namespace
+
+
+TEST_CASE("Delegate", "[Event]") {
+	Accumulator accumulator;
+	Delegate<void(int)> member{ &Accumulator::Add, &accumulator };
+	Delegate<void(int)> free{ AddFree };
+
+	BENCHMARK("Call member delegate") {
+		member(1);
+	}
+
+	BENCHMARK("Call free function delegate") {
+		free(1);
+	}
+
+	REQUIRE(accumulator.Sum() > 0);
+	REQUIRE(g_freeSum > 0);
+}
+
+
+TEST_CASE("Event", "[Event]") {
+	Accumulator accumulators[8];
+	Event<int> single;
+	Event<int> multiple;
+	single += Delegate<void(int)>{ &Accumulator::Add, &accumulators[0] };
+	for (auto& accumulator : accumulators) {
+		multiple += Delegate<void(int)>{ &Accumulator::Add, &accumulator };
+	}
+
+	BENCHMARK("Fire with 1 handler") {
+		single(1);
+	}
+
+	BENCHMARK("Fire with 8 handlers") {
+		multiple(1);
+	}
+
+	BENCHMARK("Add and remove handler") {
+		Delegate<void(int)> handler{ &Accumulator::Add, &accumulators[1] };
+		single += handler;
+		single -= handler;
+	}
+
+	REQUIRE(accumulators[0].Sum() > 0);
+	REQUIRE(accumulators[7].Sum() > 0);
+}
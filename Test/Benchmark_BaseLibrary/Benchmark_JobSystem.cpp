@@ -0,0 +1,233 @@
+#include <BaseLibrary/JobSystem/Future.hpp>
+#include <BaseLibrary/JobSystem/InitGraph.hpp>
+#include <BaseLibrary/JobSystem/Mutex.hpp>
+#include <BaseLibrary/JobSystem/ThreadpoolScheduler.hpp>
+#include <BaseLibrary/JobSystem/Wait.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+using namespace inl::jobs;
+
+
+// Each test case is one curve: its benchmarks are named by the thread count, or the queue mode and
+// the thread count, so the JSON results plot directly as time against the number of workers.
+
+
+namespace {
+
+// 1, 2, 4, ... up to and including the number of hardware threads.
+std::vector<int> GetThreadCounts() {
+	const int hardwareThreads = std::max(1, int(std::thread::hardware_concurrency()));
+	std::vector<int> counts;
+	for (int count = 1; count < hardwareThreads; count *= 2) {
+		counts.push_back(count);
+	}
+	counts.push_back(hardwareThreads);
+	return counts;
+}
+
+
+std::string GetCurvePoint(int threadCount) {
+	return std::to_string(threadCount) + (threadCount == 1 ? " thread" : " threads");
+}
+
+
+std::string GetCurvePoint(eQueueMode mode, int threadCount) {
+	return std::string(mode == eQueueMode::SHARED ? "shared, " : "work stealing, ") + GetCurvePoint(threadCount);
+}
+
+
+// Stands in for the work of a task, about a microsecond.
+int BusyWork(int seed) {
+	volatile int value = seed;
+	for (int i = 0; i < 1000; ++i) {
+		value = value * 1664525 + 1013904223;
+	}
+	return value;
+}
+
+
+Future<int> EmptyJob() {
+	co_return 1;
+}
+
+
+Future<int> Chain(int depth) {
+	if (depth == 0) {
+		co_return 0;
+	}
+	int rest = co_await Chain(depth - 1);
+	co_return rest + 1;
+}
+
+} // namespace
+
+
+TEST_CASE("JobSystem - Throughput, 4096 empty jobs", "[JobSystem]") {
+	constexpr int numJobs = 4096;
+	long long checksum = 0;
+
+	for (eQueueMode mode : { eQueueMode::SHARED, eQueueMode::WORK_STEALING }) {
+		for (int threadCount : GetThreadCounts()) {
+			ThreadpoolScheduler scheduler(threadCount, mode);
+			std::vector<Future<int>> futures;
+			futures.reserve(numJobs);
+
+			BENCHMARK(GetCurvePoint(mode, threadCount)) {
+				for (int i = 0; i < numJobs; ++i) {
+					futures.push_back(scheduler.Enqueue(EmptyJob));
+				}
+				for (auto& future : futures) {
+					checksum += future.get();
+				}
+				futures.clear();
+			}
+		}
+	}
+
+	REQUIRE(checksum > 0);
+}
+
+
+TEST_CASE("JobSystem - Latency, enqueue and wait one job", "[JobSystem]") {
+	long long checksum = 0;
+
+	for (int threadCount : GetThreadCounts()) {
+		ThreadpoolScheduler scheduler(threadCount);
+
+		BENCHMARK(GetCurvePoint(threadCount)) {
+			checksum += scheduler.Enqueue(EmptyJob).get();
+		}
+	}
+
+	REQUIRE(checksum > 0);
+}
+
+
+TEST_CASE("JobSystem - Fan-out and fan-in, 64 children", "[JobSystem]") {
+	constexpr int numChildren = 64;
+	long long checksum = 0;
+
+	for (eQueueMode mode : { eQueueMode::SHARED, eQueueMode::WORK_STEALING }) {
+		for (int threadCount : GetThreadCounts()) {
+			ThreadpoolScheduler scheduler(threadCount, mode);
+
+			auto child = [](int i) -> Future<int> {
+				co_return BusyWork(i) & 1;
+			};
+			auto parent = [&scheduler, &child]() -> Future<int> {
+				std::vector<Future<int>> children;
+				children.reserve(numChildren);
+				for (int i = 0; i < numChildren; ++i) {
+					children.push_back(scheduler.Enqueue(child, i));
+				}
+				co_await WhenAll(children);
+
+				int sum = 1;
+				for (auto& future : children) {
+					sum += co_await future;
+				}
+				co_return sum;
+			};
+
+			BENCHMARK(GetCurvePoint(mode, threadCount)) {
+				checksum += scheduler.Enqueue(parent).get();
+			}
+		}
+	}
+
+	REQUIRE(checksum > 0);
+}
+
+
+TEST_CASE("JobSystem - Mutex contention, 256 locks per job", "[JobSystem]") {
+	constexpr int locksPerJob = 256;
+	long long checksum = 0;
+
+	for (eMutexMode mutexMode : { eMutexMode::PARK, eMutexMode::ADAPTIVE }) {
+		for (int threadCount : GetThreadCounts()) {
+			ThreadpoolScheduler scheduler(threadCount);
+			Mutex mutex(mutexMode);
+			long long counter = 0;
+
+			auto job = [&mutex, &counter]() -> Future<void> {
+				for (int i = 0; i < locksPerJob; ++i) {
+					co_await mutex.Lock();
+					++counter;
+					mutex.Unlock();
+				}
+			};
+
+			// As many jobs as workers, so that every worker contends.
+			const std::string name = std::string(mutexMode == eMutexMode::PARK ? "park, " : "adaptive, ") + GetCurvePoint(threadCount);
+			BENCHMARK(name) {
+				std::vector<Future<void>> futures;
+				for (int i = 0; i < threadCount; ++i) {
+					futures.push_back(scheduler.Enqueue(job));
+				}
+				for (auto& future : futures) {
+					future.get();
+				}
+			}
+			checksum += counter;
+		}
+	}
+
+	REQUIRE(checksum > 0);
+}
+
+
+TEST_CASE("JobSystem - Future chain depth", "[JobSystem]") {
+	ThreadpoolScheduler scheduler(1);
+	long long checksum = 0;
+
+	for (int depth : { 1, 4, 16, 64, 256 }) {
+		BENCHMARK(std::to_string(depth) + " deep") {
+			checksum += scheduler.Enqueue(Chain, depth).get();
+		}
+	}
+
+	REQUIRE(checksum > 0);
+}
+
+
+TEST_CASE("JobSystem - Pipeline DAG, 6 stages of 16 tasks", "[JobSystem]") {
+	constexpr int numStages = 6;
+	constexpr int stageWidth = 16;
+	std::atomic<long long> checksum = 0;
+
+	for (int threadCount : GetThreadCounts()) {
+		ThreadpoolScheduler scheduler(threadCount);
+
+		// Each task of a stage depends on its three neighbours in the previous stage,
+		// so work flows through the stages without a full barrier between them.
+		BENCHMARK(GetCurvePoint(threadCount)) {
+			InitGraph graph;
+			std::vector<InitGraph::TaskId> previous;
+			for (int stage = 0; stage < numStages; ++stage) {
+				std::vector<InitGraph::TaskId> current;
+				for (int i = 0; i < stageWidth; ++i) {
+					auto task = [&checksum, i] { checksum += BusyWork(i) & 1; };
+					if (previous.empty()) {
+						current.push_back(graph.Add("Task", task));
+					}
+					else {
+						current.push_back(graph.Add("Task", task, { previous[(i + stageWidth - 1) % stageWidth], previous[i], previous[(i + 1) % stageWidth] }));
+					}
+				}
+				previous = std::move(current);
+			}
+			graph.Start(scheduler);
+			graph.Wait();
+		}
+	}
+
+	REQUIRE(checksum > 0);
+}
@@ -0,0 +1,34 @@
+#include <BaseLibrary/StringUtil.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <string>
+
+
+using namespace inl;
+
+
+TEST_CASE("StringUtil", "[StringUtil]") {
+	const std::string sentence = "  the quick brown fox jumps over the lazy dog, then it goes to sleep  ";
+	const std::string unicode = u8"árvíztűrő tükörfúrógép, ÁRVÍZTŰRŐ TÜKÖRFÚRÓGÉP";
+	const std::u32string unicode32 = EncodeString<char32_t>(unicode);
+	size_t checksum = 0;
+
+	BENCHMARK("Tokenize") {
+		checksum += Tokenize(sentence, " ,", true).size();
+	}
+
+	BENCHMARK("Trim") {
+		checksum += Trim(sentence, " ").size();
+	}
+
+	BENCHMARK("Encode UTF-8 to UTF-32") {
+		checksum += EncodeString<char32_t>(unicode).size();
+	}
+
+	BENCHMARK("Encode UTF-32 to UTF-8") {
+		checksum += EncodeString<char>(unicode32).size();
+	}
+
+	REQUIRE(checksum > 0);
+}
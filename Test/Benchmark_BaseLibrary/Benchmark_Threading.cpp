@@ -0,0 +1,87 @@
+#include <BaseLibrary/Memory/MultiInstanceTLS.hpp>
+#include <BaseLibrary/SpinMutex.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+using namespace inl;
+
+
+// Each thread takes the lock this many times per iteration.
+static constexpr int LocksPerThread = 1000;
+
+
+template <class MutexT>
+static long long LockFromThreads(MutexT& mutex, int numThreads) {
+	long long counter = 0;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < numThreads; ++t) {
+		threads.emplace_back([&] {
+			for (int i = 0; i < LocksPerThread; ++i) {
+				std::lock_guard<MutexT> lock(mutex);
+				++counter;
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	return counter;
+}
+
+
+TEST_CASE("SpinMutex", "[Threading]") {
+	SpinMutex spinMutex;
+	std::mutex stdMutex;
+	long long checksum = 0;
+
+	BENCHMARK("Uncontended lock and unlock") {
+		spinMutex.lock();
+		++checksum;
+		spinMutex.unlock();
+	}
+
+	BENCHMARK("Uncontended std::mutex for reference") {
+		stdMutex.lock();
+		++checksum;
+		stdMutex.unlock();
+	}
+
+	BENCHMARK("4 threads contending") {
+		checksum += LockFromThreads(spinMutex, 4);
+	}
+
+	BENCHMARK("4 threads contending std::mutex for reference") {
+		checksum += LockFromThreads(stdMutex, 4);
+	}
+
+	REQUIRE(checksum > 0);
+}
+
+
+TEST_CASE("MultiInstanceTLS", "[Threading]") {
+	mi_tls<long long> value(0);
+	thread_local long long nativeValue = 0;
+
+	BENCHMARK("Increment mi_tls") {
+		long long& ref = value;
+		++ref;
+	}
+
+	BENCHMARK("Increment thread_local for reference") {
+		++nativeValue;
+	}
+
+	BENCHMARK("Create and destroy mi_tls") {
+		mi_tls<long long> temporary(1);
+		nativeValue += temporary;
+	}
+
+	REQUIRE((long long)value > 0);
+	REQUIRE(nativeValue > 0);
+}
+
@@ -0,0 +1,37 @@
+#include <BaseLibrary/Transformable.hpp>
+
+#include <Catch2/catch.hpp>
+
+
+using namespace inl;
+
+
+TEST_CASE("Transformable", "[Transformable]") {
+	Transformable3D transformable;
+	transformable.SetPosition({ 1, 2, 3 });
+	transformable.SetRotation(Quat::AxisAngle(Vec3{ 1, 2, 3 }.Normalized(), 0.5f));
+	transformable.SetScale({ 1, 2, 1 });
+	const Quat step = Quat::AxisAngle(Vec3{ 0, 0, 1 }, 0.001f);
+	float checksum = 0.0f;
+
+	BENCHMARK("Compose transform") {
+		checksum += transformable.GetTransform()(3, 0);
+	}
+
+	BENCHMARK("Compose linear transform") {
+		checksum += transformable.GetLinearTransform()(0, 0);
+	}
+
+	BENCHMARK("Rotate and compose transform") {
+		transformable.Rotate(step);
+		checksum += transformable.GetTransform()(0, 0);
+	}
+
+	BENCHMARK("Shear, decompose and compose transform") {
+		transformable.ShearXY(0.001f);
+		transformable.SetTransform(transformable.GetTransform());
+		checksum += transformable.GetScale().x;
+	}
+
+	REQUIRE(checksum != 0.0f);
+}
@@ -0,0 +1,73 @@
+#define CATCH_CONFIG_EXTERNAL_INTERFACES
+#include <Catch2/catch.hpp>
+
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+#include <string>
+#include <vector>
+
+
+// Collects the timings of the benchmarks and writes them as a single JSON document at the end of the run:
+// { "benchmarks": [ { "testCase", "name", "iterations", "totalNanoseconds", "nanosecondsPerIteration" } ], "failedAssertions" }
+class JsonReporter : public Catch::StreamingReporterBase<JsonReporter> {
+	struct Result {
+		std::string testCase;
+		std::string name;
+		size_t iterations;
+		uint64_t totalNanoseconds;
+	};
+
+public:
+	using StreamingReporterBase::StreamingReporterBase;
+
+	static std::string getDescription() {
+		return "Reports benchmark timings as JSON";
+	}
+
+	void assertionStarting(const Catch::AssertionInfo&) override {}
+
+	bool assertionEnded(const Catch::AssertionStats&) override {
+		return true;
+	}
+
+	void benchmarkEnded(const Catch::BenchmarkStats& stats) override {
+		m_results.push_back({ currentTestCaseInfo->name, stats.info.name, stats.iterations, stats.elapsedTimeInNanoseconds });
+	}
+
+	void testRunEnded(const Catch::TestRunStats& stats) override {
+		rapidjson::OStreamWrapper wrapper(stream);
+		rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(wrapper);
+
+		writer.StartObject();
+		writer.Key("benchmarks");
+		writer.StartArray();
+		for (const Result& result : m_results) {
+			writer.StartObject();
+			writer.Key("testCase");
+			writer.String(result.testCase.c_str());
+			writer.Key("name");
+			writer.String(result.name.c_str());
+			writer.Key("iterations");
+			writer.Uint64(result.iterations);
+			writer.Key("totalNanoseconds");
+			writer.Uint64(result.totalNanoseconds);
+			writer.Key("nanosecondsPerIteration");
+			writer.Double(result.iterations > 0 ? double(result.totalNanoseconds) / double(result.iterations) : 0.0);
+			writer.EndObject();
+		}
+		writer.EndArray();
+		writer.Key("failedAssertions");
+		writer.Uint64(stats.totals.assertions.failed);
+		writer.EndObject();
+		stream << std::endl;
+
+		StreamingReporterBase::testRunEnded(stats);
+	}
+
+private:
+	std::vector<Result> m_results;
+};
+
+
+CATCH_REGISTER_REPORTER("json", JsonReporter)
@@ -0,0 +1,24 @@
+#define CATCH_CONFIG_RUNNER
+#include <Catch2/catch.hpp>
+
+
+// Runs the BENCHMARK sections of the test cases and prints their timings as JSON,
+// select a subset the same way as with Test_Unit, e.g. "[Allocators]".
+// Pass -r console to read the results instead, or -o file.json to keep them.
+int main(int argc, char* argv[]) {
+	Catch::Session session;
+
+	// Catch stops timing a benchmark after 100 clock resolutions by default, a few microseconds,
+	// which is too noisy to compare runs. Can still be overridden from the command line.
+	session.configData().benchmarkResolutionMultiple = 10000;
+
+	int result = session.applyCommandLine(argc, argv);
+	if (result != 0) {
+		return result;
+	}
+
+	if (session.configData().reporterNames.empty()) {
+		session.configData().reporterNames.push_back("json");
+	}
+	return session.run();
+}
@@ -0,0 +1,220 @@
+#include "LoadClient.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+#include <NetworkEngine_HL/FrameCompression.hpp>
+#include <NetworkEngine_HL/InternalTags.hpp>
+#include <NetworkEngine_HL/NetworkMessage.hpp>
+#include <NetworkEngine_LL/TcpClient.hpp>
+#include <NetworkEngine_LL/TcpSocketBuilder.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+
+using namespace inl;
+using namespace inl::net;
+using namespace inl::net::sockets;
+
+
+static uint64_t GetTimestamp() {
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+LoadClient::LoadClient(const IPAddress& address, unsigned messageSize, unsigned rate, bool compress, const std::atomic_bool& measuring)
+	: m_rate(rate), m_measuring(measuring), m_payload(std::max(messageSize, MinMessageSize)), m_receiveBuffer(64 * 1024) {
+	// Blocking, so that sends never stop halfway, receives wait for readability first.
+	m_client = TcpSocketBuilder().AsBlocking().BuildClient();
+	if (!m_client || !m_client->Connect(address)) {
+		throw RuntimeException("Failed to connect to the server.", address.ToString());
+	}
+
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (!m_hasId) {
+		if (std::chrono::steady_clock::now() > deadline) {
+			throw RuntimeException("Server did not assign an ID in time.", address.ToString());
+		}
+		if (m_client->Wait(SocketWaitConditions::WaitForRead, std::chrono::milliseconds(100)) && !Receive()) {
+			throw RuntimeException("Server closed the connection, it may be full.", address.ToString());
+		}
+	}
+
+	if (compress) {
+		uint32_t codecs = (uint32_t)CompressionCodecs::Lz4;
+		NetworkMessage request(m_id, DistributionMode::Server, 0, (uint32_t)InternalTags::Compression, &codecs, sizeof(codecs));
+		if (!SendFrame(request.Serialize(m_pool))) {
+			throw RuntimeException("Failed to ask the server for compression.", address.ToString());
+		}
+	}
+}
+
+
+LoadClient::~LoadClient() {
+	Stop();
+	if (m_client) {
+		m_client->Close();
+	}
+}
+
+
+void LoadClient::Start() {
+	m_run = true;
+	m_thread = std::thread(&LoadClient::Run, this);
+}
+
+
+void LoadClient::Stop() {
+	m_run = false;
+	if (m_thread.joinable()) {
+		m_thread.join();
+	}
+}
+
+
+void LoadClient::Run() {
+	using Clock = std::chrono::steady_clock;
+	const Clock::duration interval = m_rate > 0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / m_rate : Clock::duration(0);
+	const std::chrono::milliseconds maxWait(10); // How late the client notices that it should stop.
+
+	Clock::time_point nextSend = Clock::now();
+	while (m_run) {
+		Clock::time_point now = Clock::now();
+		const bool due = m_rate > 0 ? now >= nextSend : m_inFlight == 0;
+		if (due) {
+			if (!SendMessage()) {
+				m_results.failed = true;
+				break;
+			}
+			nextSend += interval;
+			if (nextSend < now - std::chrono::seconds(1)) {
+				nextSend = now; // Fell far behind, e.g. the machine is overloaded, don't try to catch up in a burst.
+			}
+		}
+
+		// Rounded up, a wait of zero would spin until the next send.
+		std::chrono::milliseconds wait = maxWait;
+		if (m_rate > 0) {
+			wait = std::clamp(std::chrono::ceil<std::chrono::milliseconds>(nextSend - Clock::now()), std::chrono::milliseconds(0), maxWait);
+		}
+		if (m_client->Wait(SocketWaitConditions::WaitForRead, wait) && !Receive()) {
+			m_results.failed = true;
+			break;
+		}
+	}
+}
+
+
+bool LoadClient::SendMessage() {
+	const uint64_t timestamp = GetTimestamp();
+	std::memcpy(m_payload.data(), &timestamp, sizeof(timestamp));
+	std::memcpy(m_payload.data() + sizeof(timestamp), &m_sequence, sizeof(m_sequence));
+	++m_sequence;
+
+	NetworkMessage msg(m_id, DistributionMode::Server, 0, Tag, m_payload.data(), (uint32_t)m_payload.size());
+	MessageSlice frame = msg.Serialize(m_pool);
+	if (m_sendCompressed) {
+		MessageSlice compressed = FrameCompression::Compress(frame, m_pool);
+		if (!compressed.Empty()) {
+			frame = std::move(compressed);
+		}
+	}
+	if (!SendFrame(frame)) {
+		return false;
+	}
+
+	++m_inFlight;
+	if (m_measuring) {
+		++m_results.messagesSent;
+		m_results.bytesSent += frame.Size();
+	}
+	return true;
+}
+
+
+bool LoadClient::SendFrame(const MessageSlice& frame) {
+	for (uint32_t offset = 0; offset < frame.Size();) {
+		int32_t sent;
+		if (!m_client->Send(frame.Data() + offset, int32_t(frame.Size() - offset), sent)) {
+			return false;
+		}
+		offset += sent;
+	}
+	return true;
+}
+
+
+bool LoadClient::Receive() {
+	if (m_received == m_receiveBuffer.size()) {
+		m_receiveBuffer.resize(m_receiveBuffer.size() * 2);
+	}
+	int32_t read;
+	if (!m_client->Recv(m_receiveBuffer.data() + m_received, int32_t(m_receiveBuffer.size() - m_received), read)) {
+		return false;
+	}
+	m_received += read;
+
+	// Frames may arrive in pieces or several at once.
+	size_t offset = 0;
+	while (m_received - offset >= sizeof(NetworkHeader)) {
+		NetworkHeader header;
+		std::memcpy(&header, m_receiveBuffer.data() + offset, sizeof(header));
+		if (header.Size < NetworkMessage::FrameOverhead) {
+			return false; // Lost track of the frames.
+		}
+		if (m_received - offset < header.Size) {
+			if (m_receiveBuffer.size() < header.Size) {
+				m_receiveBuffer.resize(header.Size);
+			}
+			break;
+		}
+		HandleFrame(m_receiveBuffer.data() + offset, header.Size);
+		offset += header.Size;
+	}
+	std::memmove(m_receiveBuffer.data(), m_receiveBuffer.data() + offset, m_received - offset);
+	m_received -= offset;
+	return true;
+}
+
+
+void LoadClient::HandleFrame(const uint8_t* frame, uint32_t size) {
+	// Counted as they came over the wire, compressed or not.
+	const uint32_t receivedSize = size;
+	NetworkHeader header;
+	std::memcpy(&header, frame, sizeof(header));
+	MessageSlice decompressed;
+	if (header.Flags & NetworkHeader::CompressedFlag) {
+		MessageSlice received = m_pool.Acquire(size);
+		std::memcpy(received.Data(), frame, size);
+		decompressed = FrameCompression::Decompress(received, m_pool);
+		if (decompressed.Empty()) {
+			return;
+		}
+		frame = decompressed.Data();
+		size = decompressed.Size();
+	}
+
+	NetworkMessage msg;
+	msg.Deserialize(const_cast<uint8_t*>(frame), size);
+
+	if (msg.GetTag() == (uint32_t)InternalTags::AssignID && size >= NetworkMessage::FrameOverhead + sizeof(uint32_t)) {
+		std::memcpy(&m_id, frame + NetworkMessage::FrameOverhead, sizeof(m_id));
+		m_hasId = true;
+	}
+	else if (msg.GetTag() == (uint32_t)InternalTags::Compression && size >= NetworkMessage::FrameOverhead + sizeof(uint32_t)) {
+		uint32_t codecs;
+		std::memcpy(&codecs, frame + NetworkMessage::FrameOverhead, sizeof(codecs));
+		m_sendCompressed = (codecs & (uint32_t)CompressionCodecs::Lz4) != 0;
+	}
+	else if (msg.GetTag() == Tag && size >= NetworkMessage::FrameOverhead + MinMessageSize) {
+		uint64_t timestamp;
+		std::memcpy(&timestamp, frame + NetworkMessage::FrameOverhead, sizeof(timestamp));
+		if (m_inFlight > 0) {
+			--m_inFlight;
+		}
+		if (m_measuring) {
+			++m_results.messagesReceived;
+			m_results.bytesReceived += receivedSize;
+			m_results.roundTrips.push_back(double(GetTimestamp() - timestamp) / 1e6);
+		}
+	}
+}
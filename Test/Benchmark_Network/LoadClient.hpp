@@ -0,0 +1,84 @@
+#pragma once
+
+#include <NetworkEngine_HL/MessageBuffer.hpp>
+#include <NetworkEngine_LL/IPAddress.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+namespace inl::net::sockets {
+class TcpClient;
+}
+
+
+/// <summary> What a client did while measuring. </summary>
+struct LoadClientResults {
+	uint64_t messagesSent = 0;
+	uint64_t messagesReceived = 0;
+	uint64_t bytesSent = 0; // Whole frames, as the server counts them.
+	uint64_t bytesReceived = 0;
+	std::vector<double> roundTrips; // Milliseconds, one per echo of a message sent while measuring.
+	bool failed = false; // The connection broke, the client stopped early.
+};
+
+
+/// <summary> A simulated client that sends messages to the server and times their echoes. </summary>
+/// <remarks> Messages go to the server with <see cref="Tag"/>, their data starts with the send time and a sequence number.
+///		The server must send them back to the sender unchanged, the benchmark's relay loop does that. </remarks>
+class LoadClient {
+public:
+	static constexpr uint32_t Tag = 1;
+	static constexpr unsigned MinMessageSize = 2 * sizeof(uint64_t);
+
+public:
+	/// <summary> Connects and waits until the server assigned an ID to the client. </summary>
+	/// <param name="rate"> Messages per second, or 0 to send the next message when the previous one came back. </param>
+	/// <param name="compress"> Asks the server to compress big frames, and compresses them too once the server accepted. </param>
+	/// <param name="measuring"> Results are collected while it is set, it is shared by all clients. </param>
+	/// <exception cref="RuntimeException"> If the server refused or did not answer in time. </exception>
+	LoadClient(const inl::net::IPAddress& address, unsigned messageSize, unsigned rate, bool compress, const std::atomic_bool& measuring);
+	~LoadClient();
+
+	LoadClient(const LoadClient&) = delete;
+	LoadClient& operator=(const LoadClient&) = delete;
+
+	void Start();
+	/// <summary> Stops sending and joins the client's thread. </summary>
+	void Stop();
+
+	/// <summary> Only valid after <see cref="Stop"/>. </summary>
+	const LoadClientResults& GetResults() const { return m_results; }
+	uint32_t GetId() const { return m_id; }
+
+private:
+	void Run();
+	bool SendMessage();
+	bool SendFrame(const inl::net::MessageSlice& frame);
+	bool Receive();
+	void HandleFrame(const uint8_t* frame, uint32_t size);
+
+private:
+	std::unique_ptr<inl::net::sockets::TcpClient> m_client;
+	uint32_t m_id = 0;
+	bool m_hasId = false;
+	unsigned m_rate;
+	bool m_sendCompressed = false; // The server accepted compressed frames.
+	const std::atomic_bool& m_measuring;
+
+	std::vector<uint8_t> m_payload;
+	uint64_t m_sequence = 0;
+	uint64_t m_inFlight = 0;
+	inl::net::MessageBufferPool m_pool;
+
+	std::vector<uint8_t> m_receiveBuffer;
+	size_t m_received = 0;
+
+	std::thread m_thread;
+	std::atomic_bool m_run = false;
+	LoadClientResults m_results;
+};
@@ -0,0 +1,82 @@
+#include "LoadOptions.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <string_view>
+
+
+using namespace inl;
+
+
+static unsigned ParseUnsigned(std::string_view option, const std::string& value, unsigned min, unsigned max) {
+	try {
+		size_t length;
+		unsigned long result = std::stoul(value, &length);
+		if (length != value.size() || !(min <= result && result <= max)) {
+			throw std::invalid_argument(value);
+		}
+		return (unsigned)result;
+	}
+	catch (std::exception&) {
+		throw InvalidArgumentException("Option expects an integer between " + std::to_string(min) + " and " + std::to_string(max) + ".", std::string(option) + " " + value);
+	}
+}
+
+
+LoadOptions ParseOptions(int argc, char* argv[]) {
+	LoadOptions options;
+	for (int i = 1; i < argc; ++i) {
+		std::string_view option = argv[i];
+		if (i + 1 >= argc) {
+			throw InvalidArgumentException("Option has no value.", std::string(option));
+		}
+		std::string value = argv[++i];
+
+		if (option == "--role") {
+			if (value != "both" && value != "server" && value != "clients") {
+				throw InvalidArgumentException("Role must be both, server or clients.", value);
+			}
+			options.role = value;
+		}
+		else if (option == "--address") {
+			options.address = value;
+		}
+		else if (option == "--port") {
+			options.port = (uint16_t)ParseUnsigned(option, value, 1, 65535);
+		}
+		else if (option == "--clients") {
+			// Clients wait on their sockets with select, which only takes socket numbers below FD_SETSIZE on POSIX.
+			options.clients = ParseUnsigned(option, value, 1, 500);
+		}
+		else if (option == "--size") {
+			options.messageSize = ParseUnsigned(option, value, 16, 1024 * 1024);
+		}
+		else if (option == "--rate") {
+			options.rate = ParseUnsigned(option, value, 0, 1000000);
+		}
+		else if (option == "--duration") {
+			options.duration = ParseUnsigned(option, value, 1, 86400);
+		}
+		else if (option == "--warmup") {
+			options.warmup = ParseUnsigned(option, value, 0, 3600);
+		}
+		else if (option == "--compress") {
+			options.compress = ParseUnsigned(option, value, 0, 1) != 0;
+		}
+		else if (option == "--output") {
+			options.output = value;
+		}
+		else {
+			throw InvalidArgumentException("Unknown option.", std::string(option));
+		}
+	}
+	return options;
+}
+
+
+std::string GetUsage() {
+	return "Benchmark_Network [--role both|server|clients] [--address 127.0.0.1] [--port 61250]\n"
+		   "                  [--clients 16] [--size 64] [--rate 100] [--duration 10] [--warmup 2]\n"
+		   "                  [--compress 0|1] [--output report.json]\n"
+		   "Sizes are bytes of message data, rates are messages per second per client, 0 for one message in flight.\n";
+}
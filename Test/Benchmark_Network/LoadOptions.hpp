@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+
+struct LoadOptions {
+	std::string role = "both"; // both runs the server and the clients in this process, server or clients only one side.
+	std::string address = "127.0.0.1"; // Server the clients connect to.
+	uint16_t port = 61250;
+	unsigned clients = 16; // Each client is a thread with its own connection.
+	unsigned messageSize = 64; // Bytes of message data, at least the 16 bytes of timestamp and sequence number.
+	unsigned rate = 100; // Messages per second per client, 0 sends the next one when the previous one came back.
+	unsigned duration = 10; // Measured seconds.
+	unsigned warmup = 2; // Seconds of load before measuring.
+	bool compress = false; // Clients negotiate compression, messages of at least 1 KiB go over the wire compressed both ways.
+	std::string output; // The JSON report goes to this file, or to stdout if empty.
+};
+
+
+/// <summary> Reads options like --clients 64 from the command line, unknown options throw InvalidArgumentException. </summary>
+LoadOptions ParseOptions(int argc, char* argv[]);
+
+/// <summary> Short description of the options. </summary>
+std::string GetUsage();
@@ -0,0 +1,143 @@
+#include "LoadReport.hpp"
+
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+
+using namespace inl;
+
+
+void LoadReport::SetServerStats(const net::ServerStats& begin, const net::ServerStats& end) {
+	m_hasServer = true;
+	m_serverBegin = begin;
+	m_serverEnd = end;
+}
+
+
+void LoadReport::AddClient(const LoadClientResults& results) {
+	++m_clients;
+	m_failedClients += results.failed ? 1 : 0;
+	m_messagesSent += results.messagesSent;
+	m_messagesReceived += results.messagesReceived;
+	m_bytesSent += results.bytesSent;
+	m_bytesReceived += results.bytesReceived;
+	m_roundTrips.insert(m_roundTrips.end(), results.roundTrips.begin(), results.roundTrips.end());
+}
+
+
+void LoadReport::SetTimes(double wallSeconds, double cpuSeconds) {
+	m_wallSeconds = wallSeconds;
+	m_cpuSeconds = cpuSeconds;
+}
+
+
+void LoadReport::Write(std::ostream& output, const LoadOptions& options) const {
+	rapidjson::OStreamWrapper stream(output);
+	rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(stream);
+
+	auto writeFields = [&writer](std::initializer_list<std::pair<const char*, double>> fields) {
+		for (const auto& [key, value] : fields) {
+			writer.Key(key);
+			writer.Double(value);
+		}
+	};
+
+	writer.StartObject();
+	writer.Key("role");
+	writer.String(options.role.c_str());
+	const std::pair<const char*, unsigned> settings[] = {
+		{ "clients", options.clients },
+		{ "messageSize", options.messageSize },
+		{ "rate", options.rate },
+		{ "duration", options.duration },
+		{ "warmup", options.warmup },
+		{ "compress", unsigned(options.compress) },
+	};
+	for (const auto& [key, value] : settings) {
+		writer.Key(key);
+		writer.Uint(value);
+	}
+	writer.Key("seconds");
+	writer.Double(m_wallSeconds);
+
+	if (m_hasServer) {
+		const double seconds = std::chrono::duration<double>(m_serverEnd.time - m_serverBegin.time).count();
+		const uint64_t pollLoops = m_serverEnd.pollLoops - m_serverBegin.pollLoops;
+		const double pollLoopTime = std::chrono::duration<double, std::milli>(m_serverEnd.pollLoopTime - m_serverBegin.pollLoopTime).count();
+		writer.Key("server");
+		writer.StartObject();
+		writeFields({
+			{ "messagesInPerSecond", (m_serverEnd.messagesIn - m_serverBegin.messagesIn) / seconds },
+			{ "messagesOutPerSecond", (m_serverEnd.messagesOut - m_serverBegin.messagesOut) / seconds },
+			{ "bytesInPerSecond", (m_serverEnd.bytesIn - m_serverBegin.bytesIn) / seconds },
+			{ "bytesOutPerSecond", (m_serverEnd.bytesOut - m_serverBegin.bytesOut) / seconds },
+			{ "pollLoopMeanMs", pollLoops > 0 ? pollLoopTime / pollLoops : 0.0 },
+			{ "pollLoopMaxMs", std::chrono::duration<double, std::milli>(m_serverEnd.pollLoopMax).count() },
+		});
+		writer.Key("accepted");
+		writer.Uint64(m_serverEnd.accepted);
+		writer.Key("rejected");
+		writer.Uint64(m_serverEnd.rejected);
+		writer.Key("droppedFrames");
+		writer.Uint64(m_serverEnd.droppedFrames - m_serverBegin.droppedFrames);
+		writer.EndObject();
+	}
+
+	if (m_clients > 0) {
+		// Nearest rank, like the other benchmarks.
+		std::vector<double> roundTrips = m_roundTrips;
+		std::sort(roundTrips.begin(), roundTrips.end());
+		auto percentile = [&roundTrips](double p) {
+			if (roundTrips.empty()) {
+				return 0.0;
+			}
+			size_t rank = (size_t)std::ceil(p / 100.0 * roundTrips.size());
+			return roundTrips[std::clamp<size_t>(rank, 1, roundTrips.size()) - 1];
+		};
+		const double seconds = std::max(m_wallSeconds, 1e-9);
+
+		writer.Key("clients");
+		writer.StartObject();
+		writer.Key("failed");
+		writer.Uint(m_failedClients);
+		writer.Key("messagesSent");
+		writer.Uint64(m_messagesSent);
+		writer.Key("messagesReceived");
+		writer.Uint64(m_messagesReceived);
+		writeFields({
+			{ "messagesSentPerSecond", m_messagesSent / seconds },
+			{ "messagesReceivedPerSecond", m_messagesReceived / seconds },
+			{ "bytesSentPerSecond", m_bytesSent / seconds },
+			{ "bytesReceivedPerSecond", m_bytesReceived / seconds },
+		});
+		writer.Key("roundTripMs");
+		writer.StartObject();
+		writer.Key("count");
+		writer.Uint64(roundTrips.size());
+		writeFields({
+			{ "p50", percentile(50) },
+			{ "p99", percentile(99) },
+			{ "max", roundTrips.empty() ? 0.0 : roundTrips.back() },
+		});
+		writer.EndObject();
+		writer.EndObject();
+	}
+
+	// Percent of one core, so a process keeping two cores busy shows 200.
+	writer.Key("cpu");
+	writer.StartObject();
+	writeFields({
+		{ "seconds", m_cpuSeconds },
+		{ "percent", m_wallSeconds > 0.0 ? m_cpuSeconds / m_wallSeconds * 100.0 : 0.0 },
+	});
+	writer.Key("cores");
+	writer.Uint(std::thread::hardware_concurrency());
+	writer.EndObject();
+
+	writer.EndObject();
+	output << std::endl;
+}
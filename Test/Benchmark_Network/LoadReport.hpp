@@ -0,0 +1,37 @@
+#pragma once
+
+#include "LoadClient.hpp"
+#include "LoadOptions.hpp"
+
+#include <NetworkEngine_HL/NetworkStats.hpp>
+
+#include <ostream>
+
+
+/// <summary> Collects the results of a run and writes them as JSON. </summary>
+class LoadReport {
+public:
+	/// <summary> Server counters at the start and end of the measured time, omitted from the report if never set. </summary>
+	void SetServerStats(const inl::net::ServerStats& begin, const inl::net::ServerStats& end);
+	void AddClient(const LoadClientResults& results);
+	/// <summary> CPU time of the process over the measured time, from all its threads. </summary>
+	void SetTimes(double wallSeconds, double cpuSeconds);
+
+	void Write(std::ostream& output, const LoadOptions& options) const;
+
+private:
+	bool m_hasServer = false;
+	inl::net::ServerStats m_serverBegin;
+	inl::net::ServerStats m_serverEnd;
+
+	unsigned m_clients = 0;
+	unsigned m_failedClients = 0;
+	uint64_t m_messagesSent = 0;
+	uint64_t m_messagesReceived = 0;
+	uint64_t m_bytesSent = 0;
+	uint64_t m_bytesReceived = 0;
+	std::vector<double> m_roundTrips;
+
+	double m_wallSeconds = 0.0;
+	double m_cpuSeconds = 0.0;
+};
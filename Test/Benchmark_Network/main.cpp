@@ -0,0 +1,166 @@
+#include "LoadClient.hpp"
+#include "LoadOptions.hpp"
+#include "LoadReport.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+#include <NetworkEngine_HL/MessageQueue.hpp>
+#include <NetworkEngine_HL/Server.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <csignal>
+#endif
+
+
+using namespace inl;
+
+
+// CPU seconds used by all threads of the process.
+static double GetProcessCpuSeconds() {
+#ifdef _WIN32
+	FILETIME creation, exit, kernel, user;
+	GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+	auto toSeconds = [](const FILETIME& time) { return ((uint64_t(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 1e-7; };
+	return toSeconds(kernel) + toSeconds(user);
+#else
+	return double(std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+
+// Sends the load clients' messages back to their sender, as a game server would pass on a client's input.
+// The queue has no wait, so the loop sleeps briefly when it is empty, which adds up to about a millisecond to round trips.
+static void RelayMessages(net::MessageQueue& queue, const std::atomic_bool& run) {
+	std::vector<net::DataReceivedEvent> received;
+	std::vector<net::NewConnectionEvent> connections;
+	std::vector<net::DisconnectedEvent> disconnections;
+	while (run) {
+		received.clear();
+		connections.clear();
+		disconnections.clear();
+		queue.DequeueConnections(connections);
+		queue.DequeueDisconnections(disconnections);
+		if (queue.DequeueMessagesReceived(received) == 0) {
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+			continue;
+		}
+		for (const net::DataReceivedEvent& event : received) {
+			if (event.Tag == LoadClient::Tag) {
+				net::MessageSlice data = event.Frame.Slice(net::NetworkMessage::FrameOverhead, event.Frame.Size() - net::NetworkMessage::FrameOverhead);
+				queue.EnqueueMessageToSend(net::NetworkMessage(0, net::DistributionMode::ID, event.SenderID, event.Tag, std::move(data)));
+			}
+		}
+	}
+}
+
+
+// Puts a server under the load of simulated clients and prints throughput, round trip times and CPU usage as JSON.
+// The clients send messages of a fixed size at a fixed rate, the server sends each of them back to its sender.
+// Both sides run in this process by default, and the CPU usage covers both. Run them as separate processes,
+// --role server and --role clients, for the server's CPU usage alone.
+int main(int argc, char* argv[]) {
+	LoadOptions options;
+	try {
+		options = ParseOptions(argc, argv);
+	}
+	catch (InvalidArgumentException& ex) {
+		std::cerr << ex.what() << " " << ex.Subject() << std::endl;
+		std::cerr << GetUsage();
+		return 2;
+	}
+
+#ifndef _WIN32
+	std::signal(SIGPIPE, SIG_IGN); // Sending to a closed connection fails instead of ending the process.
+#endif
+
+	try {
+		const bool runServer = options.role != "clients";
+		const bool runClients = options.role != "server";
+
+		// Start server.
+		std::unique_ptr<net::Server> server;
+		std::atomic_bool relayRun = true;
+		std::thread relayThread;
+		if (runServer) {
+			server.reset(new net::Server(options.clients, options.port));
+			server->Start();
+			relayThread = std::thread(RelayMessages, std::ref(*server->GetQueue()), std::cref(relayRun));
+		}
+
+		// Connect clients.
+		std::atomic_bool measuring = false;
+		std::vector<std::unique_ptr<LoadClient>> clients;
+		if (runClients) {
+			const net::IPAddress address(options.address, options.port);
+			for (unsigned i = 0; i < options.clients; ++i) {
+				clients.push_back(std::make_unique<LoadClient>(address, options.messageSize, options.rate, options.compress, measuring));
+			}
+			for (auto& client : clients) {
+				client->Start();
+			}
+		}
+
+		// Measure.
+		LoadReport report;
+		std::this_thread::sleep_for(std::chrono::seconds(options.warmup));
+
+		net::ServerStats serverBegin = server ? server->GetStats() : net::ServerStats{};
+		const double cpuBegin = GetProcessCpuSeconds();
+		const auto begin = std::chrono::steady_clock::now();
+		measuring = true;
+
+		std::this_thread::sleep_for(std::chrono::seconds(options.duration));
+
+		measuring = false;
+		const auto end = std::chrono::steady_clock::now();
+		const double cpuEnd = GetProcessCpuSeconds();
+		if (server) {
+			report.SetServerStats(serverBegin, server->GetStats());
+		}
+		report.SetTimes(std::chrono::duration<double>(end - begin).count(), cpuEnd - cpuBegin);
+
+		// Stop.
+		for (auto& client : clients) {
+			client->Stop();
+			report.AddClient(client->GetResults());
+		}
+		clients.clear();
+		if (server) {
+			relayRun = false;
+			relayThread.join();
+			server->Stop();
+		}
+
+		// Write report.
+		if (options.output.empty()) {
+			report.Write(std::cout, options);
+		}
+		else {
+			std::ofstream outputFile(options.output);
+			if (!outputFile.is_open()) {
+				throw RuntimeException("Failed to open output file.", options.output);
+			}
+			report.Write(outputFile, options);
+		}
+		return 0;
+	}
+	catch (Exception& ex) {
+		std::cerr << "Unhandled exception occured." << std::endl;
+		std::cerr << "MESSAGE:" << ex.what() << std::endl;
+		std::cerr << "STACK TRACE:" << std::endl;
+		ex.PrintStackTrace(std::cerr);
+		return 1;
+	}
+}
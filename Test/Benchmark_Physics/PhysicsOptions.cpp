@@ -0,0 +1,93 @@
+#include "PhysicsOptions.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <string_view>
+
+
+using namespace inl;
+
+
+static unsigned ParseUnsigned(std::string_view option, const std::string& value, unsigned min, unsigned max) {
+	try {
+		size_t length;
+		unsigned long result = std::stoul(value, &length);
+		if (length != value.size() || !(min <= result && result <= max)) {
+			throw std::invalid_argument(value);
+		}
+		return (unsigned)result;
+	}
+	catch (std::exception&) {
+		throw InvalidArgumentException("Option expects an integer between " + std::to_string(min) + " and " + std::to_string(max) + ".", std::string(option) + " " + value);
+	}
+}
+
+
+const std::vector<std::string>& GetSceneNames() {
+	static const std::vector<std::string> names = { "pyramids", "stacks", "terrain", "chains", "rays" };
+	return names;
+}
+
+
+PhysicsOptions ParseOptions(int argc, char* argv[]) {
+	PhysicsOptions options;
+	for (int i = 1; i < argc; ++i) {
+		std::string_view option = argv[i];
+		if (i + 1 >= argc) {
+			throw InvalidArgumentException("Option has no value.", std::string(option));
+		}
+		std::string value = argv[++i];
+
+		if (option == "--scene") {
+			const auto& names = GetSceneNames();
+			if (value == "all") {
+				options.scenes.clear();
+			}
+			else if (std::find(names.begin(), names.end(), value) != names.end()) {
+				options.scenes = { value };
+			}
+			else {
+				throw InvalidArgumentException("Unknown scene.", value);
+			}
+		}
+		else if (option == "--dispatch") {
+			if (value != "single" && value != "jobs" && value != "both") {
+				throw InvalidArgumentException("Dispatch must be single, jobs or both.", value);
+			}
+			options.dispatch = value;
+		}
+		else if (option == "--threads") {
+			options.threads = ParseUnsigned(option, value, 0, 256);
+		}
+		else if (option == "--bodies") {
+			options.bodies = ParseUnsigned(option, value, 1, 1000000);
+		}
+		else if (option == "--steps") {
+			options.steps = ParseUnsigned(option, value, 1, 1000000);
+		}
+		else if (option == "--warmup") {
+			options.warmupSteps = ParseUnsigned(option, value, 0, 1000000);
+		}
+		else if (option == "--rays") {
+			options.rays = ParseUnsigned(option, value, 1, 10000000);
+		}
+		else if (option == "--seed") {
+			options.seed = ParseUnsigned(option, value, 0, ~0u);
+		}
+		else if (option == "--output") {
+			options.output = value;
+		}
+		else {
+			throw InvalidArgumentException("Unknown option.", std::string(option));
+		}
+	}
+	return options;
+}
+
+
+std::string GetUsage() {
+	return "Benchmark_Physics [--scene all|pyramids|stacks|terrain|chains|rays] [--dispatch both|single|jobs]\n"
+		   "                  [--threads 0] [--bodies 10000] [--steps 600] [--warmup 60] [--rays 10000]\n"
+		   "                  [--seed 1] [--output report.json]\n";
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+struct PhysicsOptions {
+	std::vector<std::string> scenes; // Names from GetSceneNames, empty runs all of them.
+	std::string dispatch = "both"; // single steps on the calling thread, jobs on a thread pool, both compares the two.
+	unsigned threads = 0; // Threads of the pool, 0 for one per core.
+	unsigned bodies = 10000; // Moving bodies of each scene, chains count their links.
+	unsigned steps = 600; // Measured steps of 1/60 s.
+	unsigned warmupSteps = 60; // Stepped before measuring, the first contacts are the most expensive.
+	unsigned rays = 10000; // Rays cast after each step of the rays scene.
+	unsigned seed = 1;
+	std::string output; // The JSON report goes to this file, or to stdout if empty.
+};
+
+
+/// <summary> Names accepted by --scene, besides all. </summary>
+const std::vector<std::string>& GetSceneNames();
+
+/// <summary> Reads options like --bodies 2000 from the command line, unknown options throw InvalidArgumentException. </summary>
+PhysicsOptions ParseOptions(int argc, char* argv[]);
+
+/// <summary> Short description of the options. </summary>
+std::string GetUsage();
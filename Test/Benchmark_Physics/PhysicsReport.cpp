@@ -0,0 +1,171 @@
+#include "PhysicsReport.hpp"
+
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+
+namespace {
+
+struct Statistics {
+	size_t count = 0;
+	double mean = 0.0;
+	double min = 0.0;
+	double p50 = 0.0;
+	double p90 = 0.0;
+	double p99 = 0.0;
+	double max = 0.0;
+};
+
+
+// Nearest rank percentiles, like the other benchmarks.
+Statistics Summarize(std::vector<double> samples) {
+	Statistics statistics;
+	if (samples.empty()) {
+		return statistics;
+	}
+	std::sort(samples.begin(), samples.end());
+
+	auto percentile = [&samples](double p) {
+		size_t rank = (size_t)std::ceil(p / 100.0 * samples.size());
+		return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+	};
+	statistics.count = samples.size();
+	statistics.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+	statistics.min = samples.front();
+	statistics.p50 = percentile(50);
+	statistics.p90 = percentile(90);
+	statistics.p99 = percentile(99);
+	statistics.max = samples.back();
+	return statistics;
+}
+
+} // namespace
+
+
+void WriteReport(std::ostream& output, const PhysicsOptions& options, const std::vector<PhysicsRun>& runs) {
+	rapidjson::OStreamWrapper stream(output);
+	rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(stream);
+
+	auto writeStatistics = [&writer](const char* key, const std::vector<double>& samples) {
+		Statistics statistics = Summarize(samples);
+		writer.Key(key);
+		writer.StartObject();
+		writer.Key("count");
+		writer.Uint64(statistics.count);
+		const std::pair<const char*, double> fields[] = {
+			{ "mean", statistics.mean },
+			{ "min", statistics.min },
+			{ "p50", statistics.p50 },
+			{ "p90", statistics.p90 },
+			{ "p99", statistics.p99 },
+			{ "max", statistics.max },
+		};
+		for (const auto& [field, value] : fields) {
+			writer.Key(field);
+			writer.Double(value);
+		}
+		writer.EndObject();
+	};
+
+	writer.StartObject();
+	const std::pair<const char*, unsigned> settings[] = {
+		{ "bodies", options.bodies },
+		{ "steps", options.steps },
+		{ "warmupSteps", options.warmupSteps },
+		{ "rays", options.rays },
+		{ "seed", options.seed },
+	};
+	for (const auto& [key, value] : settings) {
+		writer.Key(key);
+		writer.Uint(value);
+	}
+
+	writer.Key("runs");
+	writer.StartArray();
+	for (const PhysicsRun& run : runs) {
+		writer.StartObject();
+		writer.Key("scene");
+		writer.String(run.scene.c_str());
+		writer.Key("dispatch");
+		writer.String(run.dispatch.c_str());
+		writer.Key("threads");
+		writer.Uint(run.threads);
+		writer.Key("bodies");
+		writer.Uint64(run.bodies);
+		writer.Key("constraints");
+		writer.Uint64(run.constraints);
+
+		writer.Key("milliseconds");
+		writer.StartObject();
+		writeStatistics("step", run.step);
+		writeStatistics("broadphase", run.broadphase);
+		writeStatistics("narrowphase", run.narrowphase);
+		writeStatistics("solver", run.solver);
+		if (!run.query.empty()) {
+			writeStatistics("query", run.query);
+		}
+		writer.EndObject();
+
+		writer.Key("counts");
+		writer.StartObject();
+		writeStatistics("overlappingPairs", run.overlappingPairs);
+		writeStatistics("manifolds", run.manifolds);
+		writeStatistics("activeBodies", run.activeBodies);
+		writeStatistics("sleepingBodies", run.sleepingBodies);
+		writeStatistics("islands", run.islands);
+		writer.EndObject();
+
+		if (!run.query.empty()) {
+			const double queryTime = std::accumulate(run.query.begin(), run.query.end(), 0.0) / 1000.0;
+			writer.Key("raysPerSecond");
+			writer.Double(queryTime > 0.0 ? run.rays / queryTime : 0.0);
+			writer.Key("rayHitRatio");
+			writer.Double(run.rays > 0 ? double(run.rayHits) / run.rays : 0.0);
+		}
+		if (run.bvhBuild >= 0.0) {
+			writer.Key("bvh");
+			writer.StartObject();
+			writer.Key("buildMs");
+			writer.Double(run.bvhBuild);
+			writer.Key("cookedLoadMs");
+			writer.Double(run.bvhLoad);
+			writer.EndObject();
+		}
+		writer.EndObject();
+	}
+	writer.EndArray();
+
+	// Median single threaded time over median time on jobs, above 1 if jobs are faster.
+	writer.Key("speedups");
+	writer.StartArray();
+	for (const PhysicsRun& single : runs) {
+		auto jobs = std::find_if(runs.begin(), runs.end(), [&single](const PhysicsRun& run) {
+			return run.scene == single.scene && run.dispatch == "jobs";
+		});
+		if (single.dispatch != "single" || jobs == runs.end()) {
+			continue;
+		}
+		writer.StartObject();
+		writer.Key("scene");
+		writer.String(single.scene.c_str());
+		writer.Key("threads");
+		writer.Uint(jobs->threads);
+		const double jobsStep = Summarize(jobs->step).p50;
+		writer.Key("step");
+		writer.Double(jobsStep > 0.0 ? Summarize(single.step).p50 / jobsStep : 0.0);
+		if (!single.query.empty()) {
+			const double jobsQuery = Summarize(jobs->query).p50;
+			writer.Key("query");
+			writer.Double(jobsQuery > 0.0 ? Summarize(single.query).p50 / jobsQuery : 0.0);
+		}
+		writer.EndObject();
+	}
+	writer.EndArray();
+
+	writer.EndObject();
+	output << std::endl;
+}
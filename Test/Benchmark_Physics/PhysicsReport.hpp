@@ -0,0 +1,41 @@
+#pragma once
+
+#include "PhysicsOptions.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+/// <summary> What was measured in one scene with one kind of dispatch, one sample per step. </summary>
+struct PhysicsRun {
+	std::string scene;
+	std::string dispatch; // single or jobs
+	unsigned threads = 1;
+	size_t bodies = 0; // Static ones included.
+	size_t constraints = 0;
+
+	// Milliseconds.
+	std::vector<double> step;
+	std::vector<double> broadphase;
+	std::vector<double> narrowphase;
+	std::vector<double> solver;
+	std::vector<double> query; // Casting all rays of the scene, empty if it has none.
+	uint64_t rays = 0;
+	uint64_t rayHits = 0;
+
+	// Counts of SceneStats after each step.
+	std::vector<double> overlappingPairs;
+	std::vector<double> manifolds;
+	std::vector<double> activeBodies;
+	std::vector<double> sleepingBodies;
+	std::vector<double> islands;
+
+	double bvhBuild = -1.0; // Milliseconds, negative if the scene has no static mesh to build.
+	double bvhLoad = -1.0;
+};
+
+
+/// <summary> Writes the runs as JSON, with the speedup of jobs over single for scenes that ran both ways. </summary>
+void WriteReport(std::ostream& output, const PhysicsOptions& options, const std::vector<PhysicsRun>& runs);
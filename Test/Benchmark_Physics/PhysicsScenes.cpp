@@ -0,0 +1,265 @@
+#include "PhysicsScenes.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+#include <BaseLibrary/Timer.hpp>
+
+#include <BulletDynamics/ConstraintSolver/btConeTwistConstraint.h>
+#include <BulletDynamics/ConstraintSolver/btPoint2PointConstraint.h>
+#include <LinearMath/btAlignedAllocator.h>
+
+#include <cmath>
+#include <random>
+
+#undef GetObject
+
+
+using namespace inl;
+using namespace inl::pxeng_bl;
+
+
+BenchmarkWorld::~BenchmarkWorld() {
+	if (scene) {
+		for (auto& constraint : constraints) {
+			scene->RemoveConstraint(constraint.get());
+		}
+		for (auto& body : bodies) {
+			scene->RemoveEntity(body.get());
+		}
+	}
+}
+
+
+static MeshShape* AddBoxShape(BenchmarkWorld& world, const Vec3& halfExtents, bool dynamic) {
+	const Vec3 vertices[8] = {
+		{ -halfExtents.x, -halfExtents.y, -halfExtents.z },
+		{ halfExtents.x, -halfExtents.y, -halfExtents.z },
+		{ halfExtents.x, halfExtents.y, -halfExtents.z },
+		{ -halfExtents.x, halfExtents.y, -halfExtents.z },
+		{ -halfExtents.x, -halfExtents.y, halfExtents.z },
+		{ halfExtents.x, -halfExtents.y, halfExtents.z },
+		{ halfExtents.x, halfExtents.y, halfExtents.z },
+		{ -halfExtents.x, halfExtents.y, halfExtents.z },
+	};
+	const unsigned indices[36] = {
+		0, 2, 1, 0, 3, 2, // bottom
+		4, 5, 6, 4, 6, 7, // top
+		0, 1, 5, 0, 5, 4,
+		1, 2, 6, 1, 6, 5,
+		2, 3, 7, 2, 7, 6,
+		3, 0, 4, 3, 4, 7,
+	};
+	auto shape = std::make_unique<MeshShape>();
+	shape->SetMesh(vertices, 8, indices, 36, dynamic);
+	world.shapes.push_back(std::move(shape));
+	return world.shapes.back().get();
+}
+
+
+static RigidBody* AddBody(BenchmarkWorld& world, const MeshShape* shape, const Vec3& position, bool dynamic) {
+	auto body = std::make_unique<RigidBody>();
+	body->SetPosition(position);
+	body->SetShape(shape);
+	body->SetDynamic(dynamic);
+	body->SetEntityId(world.bodies.size());
+	world.scene->AddEntity(body.get());
+	world.bodies.push_back(std::move(body));
+	return world.bodies.back().get();
+}
+
+
+// A static square in the plane Z = 0.
+static void AddGround(BenchmarkWorld& world, float halfSize) {
+	const Vec3 vertices[4] = {
+		{ -halfSize, -halfSize, 0.0f },
+		{ halfSize, -halfSize, 0.0f },
+		{ halfSize, halfSize, 0.0f },
+		{ -halfSize, halfSize, 0.0f },
+	};
+	const unsigned indices[6] = { 0, 1, 2, 0, 2, 3 };
+	auto shape = std::make_unique<MeshShape>();
+	shape->SetMesh(vertices, 4, indices, 6, false);
+	world.shapes.push_back(std::move(shape));
+	AddBody(world, world.shapes.back().get(), { 0.0f, 0.0f, 0.0f }, false);
+}
+
+
+// Square pyramids of boxes with 10 boxes along the base, laid out on a grid.
+static void BuildPyramids(BenchmarkWorld& world, const PhysicsOptions& options) {
+	constexpr int base = 10;
+	constexpr int boxesPerPyramid = base * (base + 1) * (2 * base + 1) / 6;
+	constexpr float spacing = base + 4.0f;
+	const int numPyramids = int((options.bodies + boxesPerPyramid - 1) / boxesPerPyramid);
+	const int columns = int(std::ceil(std::sqrt(float(numPyramids))));
+	const float extent = columns * spacing;
+	AddGround(world, extent);
+
+	const MeshShape* box = AddBoxShape(world, { 0.5f, 0.5f, 0.5f }, true);
+	unsigned added = 0;
+	for (int pyramid = 0; pyramid < numPyramids; ++pyramid) {
+		const Vec3 corner = { (pyramid % columns) * spacing - extent / 2, (pyramid / columns) * spacing - extent / 2, 0.0f };
+		for (int level = 0; level < base; ++level) {
+			const int side = base - level;
+			const float offset = level * 0.5f;
+			for (int y = 0; y < side; ++y) {
+				for (int x = 0; x < side && added < options.bodies; ++x, ++added) {
+					AddBody(world, box, corner + Vec3{ offset + x * 1.01f, offset + y * 1.01f, 0.5f + level }, true);
+				}
+			}
+		}
+	}
+}
+
+
+// Columns of 10 boxes on a grid, returns the side of the grid.
+static float BuildStacks(BenchmarkWorld& world, const PhysicsOptions& options) {
+	constexpr int height = 10;
+	constexpr float spacing = 3.0f;
+	const int numStacks = int((options.bodies + height - 1) / height);
+	const int columns = int(std::ceil(std::sqrt(float(numStacks))));
+	const float extent = columns * spacing;
+	AddGround(world, extent);
+
+	const MeshShape* box = AddBoxShape(world, { 0.5f, 0.5f, 0.5f }, true);
+	for (unsigned i = 0; i < options.bodies; ++i) {
+		const int stack = int(i / height);
+		const int level = int(i % height);
+		AddBody(world, box, { (stack % columns) * spacing - extent / 2, (stack / columns) * spacing - extent / 2, 0.5f + level }, true);
+	}
+	return extent;
+}
+
+
+// Boxes dropped on a bumpy static triangle mesh of 128 by 128 quads.
+static void BuildTerrain(BenchmarkWorld& world, const PhysicsOptions& options) {
+	constexpr int quads = 128;
+	const float extent = std::max(100.0f, 2.0f * std::sqrt(float(options.bodies)));
+	auto height = [](float x, float y) {
+		return 2.0f * std::sin(x * 0.1f) * std::cos(y * 0.13f) + 0.5f * std::sin(x * 0.37f + y * 0.23f);
+	};
+
+	std::vector<Vec3> vertices;
+	std::vector<unsigned> indices;
+	for (int y = 0; y <= quads; ++y) {
+		for (int x = 0; x <= quads; ++x) {
+			const float px = (float(x) / quads - 0.5f) * extent;
+			const float py = (float(y) / quads - 0.5f) * extent;
+			vertices.push_back({ px, py, height(px, py) });
+		}
+	}
+	for (int y = 0; y < quads; ++y) {
+		for (int x = 0; x < quads; ++x) {
+			const unsigned corner = unsigned(y * (quads + 1) + x);
+			const unsigned quad[6] = { corner, corner + 1, corner + quads + 2, corner, corner + quads + 2, corner + quads + 1 };
+			indices.insert(indices.end(), std::begin(quad), std::end(quad));
+		}
+	}
+
+	// The scene uses the built mesh, the cooked one is only loaded to time it.
+	auto terrain = std::make_unique<MeshShape>();
+	Timer timer;
+	timer.Start();
+	terrain->SetMesh(vertices.data(), vertices.size(), indices.data(), indices.size(), false);
+	world.bvhBuildTime = timer.Elapsed();
+
+	const size_t bvhSize = terrain->GetBvhSize();
+	std::shared_ptr<void> bvh(btAlignedAlloc(bvhSize, 16), [](void* ptr) { btAlignedFree(ptr); });
+	terrain->SerializeBvh(bvh.get());
+	MeshShape cooked;
+	timer.Reset();
+	cooked.SetCookedMesh(terrain->GetVertices(), terrain->GetIndices(), std::move(bvh), bvhSize);
+	world.bvhLoadTime = timer.Elapsed();
+
+	world.shapes.push_back(std::move(terrain));
+	AddBody(world, world.shapes.back().get(), { 0.0f, 0.0f, 0.0f }, false);
+
+	std::mt19937 rng(options.seed);
+	std::uniform_real_distribution<float> position(-0.45f * extent, 0.45f * extent);
+	std::uniform_real_distribution<float> drop(3.0f, 13.0f);
+	const MeshShape* box = AddBoxShape(world, { 0.5f, 0.5f, 0.5f }, true);
+	for (unsigned i = 0; i < options.bodies; ++i) {
+		const float x = position(rng);
+		const float y = position(rng);
+		AddBody(world, box, { x, y, height(x, y) + drop(rng) }, true);
+	}
+}
+
+
+// Chains of 10 links that start out horizontal and swing down. Each chain hangs from a fixed anchor
+// by a ball joint, the links are joined with the limited cone twist joints of ragdolls.
+static void BuildChains(BenchmarkWorld& world, const PhysicsOptions& options) {
+	constexpr int links = 10;
+	constexpr float linkLength = 1.0f;
+	constexpr float anchorHeight = links * linkLength + 2.0f;
+	const int numChains = int((options.bodies + links - 1) / links);
+	const int columns = int(std::ceil(std::sqrt(float(numChains))));
+	const Vec2 spacing = { links * linkLength + 2.0f, 1.0f };
+	const Vec2 extent = { columns * spacing.x, columns * spacing.y };
+	AddGround(world, std::max(extent.x, extent.y));
+
+	const MeshShape* anchorShape = AddBoxShape(world, { 0.25f, 0.25f, 0.25f }, false);
+	const MeshShape* linkShape = AddBoxShape(world, { linkLength / 2, 0.15f, 0.15f }, true);
+	const btTransform linkStart(btQuaternion::getIdentity(), btVector3(-linkLength / 2, 0, 0));
+	const btTransform linkEnd(btQuaternion::getIdentity(), btVector3(linkLength / 2, 0, 0));
+
+	unsigned added = 0;
+	for (int chain = 0; chain < numChains; ++chain) {
+		const Vec3 anchorPosition = { (chain % columns) * spacing.x - extent.x / 2, (chain / columns) * spacing.y - extent.y / 2, anchorHeight };
+		RigidBody* previous = AddBody(world, anchorShape, anchorPosition, false);
+		for (int link = 0; link < links && added < options.bodies; ++link, ++added) {
+			RigidBody* body = AddBody(world, linkShape, anchorPosition + Vec3{ (link + 0.5f) * linkLength, 0.0f, 0.0f }, true);
+			if (link == 0) {
+				world.constraints.push_back(std::make_unique<btPoint2PointConstraint>(*previous->GetObject(), *body->GetObject(), btVector3(0, 0, 0), linkStart.getOrigin()));
+			}
+			else {
+				auto joint = std::make_unique<btConeTwistConstraint>(*previous->GetObject(), *body->GetObject(), linkEnd, linkStart);
+				joint->setLimit(btScalar(SIMD_PI / 4), btScalar(SIMD_PI / 4), btScalar(SIMD_PI / 8));
+				world.constraints.push_back(std::move(joint));
+			}
+			world.scene->AddConstraint(world.constraints.back().get());
+			previous = body;
+		}
+	}
+}
+
+
+// The stacks, with rays cast straight down at random points over them after each step.
+static void BuildRays(BenchmarkWorld& world, const PhysicsOptions& options) {
+	const float extent = BuildStacks(world, options);
+
+	std::mt19937 rng(options.seed);
+	std::uniform_real_distribution<float> position(-extent / 2, extent / 2);
+	world.rays.resize(options.rays);
+	for (pxeng_bl::Ray& ray : world.rays) {
+		const float x = position(rng);
+		const float y = position(rng);
+		ray = { { x, y, 20.0f }, { x, y, -1.0f } };
+	}
+}
+
+
+std::unique_ptr<BenchmarkWorld> CreateWorld(const std::string& name, const PhysicsOptions& options, jobs::Scheduler* scheduler) {
+	auto world = std::make_unique<BenchmarkWorld>();
+	world->scene = std::make_unique<Scene>(scheduler);
+	world->scene->SetGravity({ 0.0f, 0.0f, -9.81f });
+	world->scene->SetFixedTimestep(1.0f / 60.0f, 1);
+
+	if (name == "pyramids") {
+		BuildPyramids(*world, options);
+	}
+	else if (name == "stacks") {
+		BuildStacks(*world, options);
+	}
+	else if (name == "terrain") {
+		BuildTerrain(*world, options);
+	}
+	else if (name == "chains") {
+		BuildChains(*world, options);
+	}
+	else if (name == "rays") {
+		BuildRays(*world, options);
+	}
+	else {
+		throw InvalidArgumentException("Unknown scene.", name);
+	}
+	return world;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "PhysicsOptions.hpp"
+
+#include <PhysicsEngine_Bullet/MeshShape.hpp>
+#include <PhysicsEngine_Bullet/RigidBody.hpp>
+#include <PhysicsEngine_Bullet/Scene.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace inl::jobs {
+class Scheduler;
+}
+
+
+/// <summary> A physics scene with everything it is made of. </summary>
+struct BenchmarkWorld {
+	std::vector<std::unique_ptr<inl::pxeng_bl::MeshShape>> shapes;
+	std::vector<std::unique_ptr<inl::pxeng_bl::RigidBody>> bodies; // All are in the scene.
+	std::vector<std::unique_ptr<btTypedConstraint>> constraints; // All are in the scene.
+	std::unique_ptr<inl::pxeng_bl::Scene> scene;
+
+	std::vector<inl::pxeng_bl::Ray> rays; // Cast after each step.
+
+	// Seconds taken to make the static mesh of the scene, by building its BVH and by loading the BVH cooked from it.
+	// Negative if the scene has no such mesh.
+	double bvhBuildTime = -1.0;
+	double bvhLoadTime = -1.0;
+
+	~BenchmarkWorld();
+};
+
+
+/// <summary> Builds one of the scenes of <see cref="GetSceneNames"/>. </summary>
+/// <remarks> Bodies are 1 m boxes above the ground at Z = 0, gravity points down Z.
+///		The same options and seed always give the same scene. </remarks>
+/// <param name="scheduler"> Null steps the scene on the calling thread. </param>
+std::unique_ptr<BenchmarkWorld> CreateWorld(const std::string& name, const PhysicsOptions& options, inl::jobs::Scheduler* scheduler);
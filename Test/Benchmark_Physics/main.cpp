@@ -0,0 +1,115 @@
+#include "PhysicsOptions.hpp"
+#include "PhysicsReport.hpp"
+#include "PhysicsScenes.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+#include <BaseLibrary/JobSystem/ThreadpoolScheduler.hpp>
+#include <BaseLibrary/Timer.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+
+using namespace inl;
+
+
+static PhysicsRun RunScene(const std::string& name, const PhysicsOptions& options, jobs::Scheduler* scheduler, unsigned threads) {
+	std::unique_ptr<BenchmarkWorld> world = CreateWorld(name, options, scheduler);
+
+	PhysicsRun run;
+	run.scene = name;
+	run.dispatch = scheduler ? "jobs" : "single";
+	run.threads = threads;
+	run.bodies = world->bodies.size();
+	run.constraints = world->constraints.size();
+	run.bvhBuild = world->bvhBuildTime * 1000.0;
+	run.bvhLoad = world->bvhLoadTime * 1000.0;
+
+	// Exactly one fixed step per update.
+	const float step = world->scene->GetFixedTimestep();
+	std::vector<pxeng_bl::QueryHit> hits(world->rays.size());
+	for (unsigned i = 0; i < options.warmupSteps + options.steps; ++i) {
+		world->scene->Update(step);
+		if (i < options.warmupSteps) {
+			continue;
+		}
+
+		const pxeng_bl::SceneStats stats = world->scene->GetStats();
+		run.step.push_back(stats.updateTime * 1000.0);
+		run.broadphase.push_back(stats.broadphaseTime * 1000.0);
+		run.narrowphase.push_back(stats.narrowphaseTime * 1000.0);
+		run.solver.push_back(stats.solverTime * 1000.0);
+		run.overlappingPairs.push_back(stats.numOverlappingPairs);
+		run.manifolds.push_back(stats.numManifolds);
+		run.activeBodies.push_back(stats.numActiveBodies);
+		run.sleepingBodies.push_back(stats.numSleepingBodies);
+		run.islands.push_back(stats.numIslands);
+
+		if (!world->rays.empty()) {
+			Timer timer;
+			timer.Start();
+			world->scene->RayCast(world->rays.data(), hits.data(), hits.size());
+			run.query.push_back(timer.Elapsed() * 1000.0);
+			run.rays += hits.size();
+			run.rayHits += std::count_if(hits.begin(), hits.end(), [](const pxeng_bl::QueryHit& hit) { return hit.IsHit(); });
+		}
+	}
+	return run;
+}
+
+
+// Steps the physics scenes without graphics for a fixed number of steps and prints the step time percentiles,
+// the phase timings and counts of the physics profiler, and ray query times as JSON.
+// By default each scene runs twice, on the calling thread and on a thread pool, and the report has the speedups.
+int main(int argc, char* argv[]) {
+	PhysicsOptions options;
+	try {
+		options = ParseOptions(argc, argv);
+	}
+	catch (InvalidArgumentException& ex) {
+		std::cerr << ex.what() << " " << ex.Subject() << std::endl;
+		std::cerr << GetUsage();
+		return 2;
+	}
+
+	try {
+		const std::vector<std::string>& scenes = options.scenes.empty() ? GetSceneNames() : options.scenes;
+		std::vector<PhysicsRun> runs;
+
+		// Runs on the pool come last: Bullet keeps the last scheduler installed for all worlds,
+		// and the single threaded world would use it for its own parallel loops as well.
+		if (options.dispatch != "jobs") {
+			for (const std::string& scene : scenes) {
+				runs.push_back(RunScene(scene, options, nullptr, 1));
+			}
+		}
+		if (options.dispatch != "single") {
+			const unsigned threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+			jobs::ThreadpoolScheduler scheduler{ int(threads) };
+			for (const std::string& scene : scenes) {
+				runs.push_back(RunScene(scene, options, &scheduler, threads));
+			}
+		}
+
+		// Write report.
+		if (options.output.empty()) {
+			WriteReport(std::cout, options, runs);
+		}
+		else {
+			std::ofstream outputFile(options.output);
+			if (!outputFile.is_open()) {
+				throw RuntimeException("Failed to open output file.", options.output);
+			}
+			WriteReport(outputFile, options, runs);
+		}
+		return 0;
+	}
+	catch (Exception& ex) {
+		std::cerr << "Unhandled exception occured." << std::endl;
+		std::cerr << "MESSAGE:" << ex.what() << std::endl;
+		std::cerr << "STACK TRACE:" << std::endl;
+		ex.PrintStackTrace(std::cerr);
+		return 1;
+	}
+}
@@ -0,0 +1,159 @@
+#include "BenchmarkOptions.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <string_view>
+
+
+using namespace inl;
+
+
+static unsigned ParseUnsigned(std::string_view option, const std::string& value) {
+	try {
+		size_t length;
+		unsigned long result = std::stoul(value, &length);
+		if (length != value.size()) {
+			throw std::invalid_argument(value);
+		}
+		return (unsigned)result;
+	}
+	catch (std::exception&) {
+		throw InvalidArgumentException("Option expects a non-negative integer.", std::string(option) + " " + value);
+	}
+}
+
+
+static float ParseFloat(std::string_view option, const std::string& value, float min, float max) {
+	try {
+		size_t length;
+		float result = std::stof(value, &length);
+		if (length != value.size() || !(min <= result && result <= max)) {
+			throw std::invalid_argument(value);
+		}
+		return result;
+	}
+	catch (std::exception&) {
+		throw InvalidArgumentException("Option expects a number between " + std::to_string(min) + " and " + std::to_string(max) + ".", std::string(option) + " " + value);
+	}
+}
+
+
+BenchmarkOptions ParseOptions(int argc, char* argv[]) {
+	BenchmarkOptions options;
+	for (int i = 1; i + 1 < argc; ++i) {
+		if (std::string_view(argv[i]) == "--preset") {
+			options.preset = argv[i + 1];
+		}
+	}
+	options.scene = GetScenePreset(options.preset);
+
+	for (int i = 1; i < argc; ++i) {
+		std::string_view option = argv[i];
+		if (i + 1 >= argc) {
+			throw InvalidArgumentException("Option has no value.", std::string(option));
+		}
+		std::string value = argv[++i];
+
+		if (option == "--pipeline") {
+			options.pipeline = value;
+		}
+		else if (option == "--output") {
+			options.output = value;
+		}
+		else if (option == "--frames") {
+			options.frames = ParseUnsigned(option, value);
+		}
+		else if (option == "--warmup") {
+			options.warmupFrames = ParseUnsigned(option, value);
+		}
+		else if (option == "--baseline") {
+			options.baseline = value;
+		}
+		else if (option == "--save-baseline") {
+			options.saveBaseline = value;
+		}
+		else if (option == "--replay") {
+			options.replay = value;
+		}
+		else if (option == "--threshold") {
+			options.threshold = ParseFloat(option, value, 0.0f, 10.0f);
+		}
+		else if (option == "--api") {
+			if (value != "d3d12" && value != "null") {
+				throw InvalidArgumentException("Graphics API must be d3d12 or null.", value);
+			}
+			options.api = value;
+		}
+		else if (option == "--preset") {
+			// Applied above.
+		}
+		else if (option == "--entities") {
+			options.scene.entities = ParseUnsigned(option, value);
+		}
+		else if (option == "--meshes") {
+			options.scene.instancedMeshes = ParseUnsigned(option, value);
+		}
+		else if (option == "--unique-meshes") {
+			options.scene.uniqueMeshes = ParseUnsigned(option, value);
+		}
+		else if (option == "--materials") {
+			options.scene.materials = ParseUnsigned(option, value);
+		}
+		else if (option == "--lights") {
+			options.scene.directionalLights = ParseUnsigned(option, value);
+		}
+		else if (option == "--point-lights") {
+			options.scene.pointLights = ParseUnsigned(option, value);
+		}
+		else if (option == "--dynamic") {
+			options.scene.dynamicRatio = ParseFloat(option, value, 0.0f, 1.0f);
+		}
+		else if (option == "--texts") {
+			options.scene.texts = ParseUnsigned(option, value);
+		}
+		else if (option == "--overlays") {
+			options.scene.overlays = ParseUnsigned(option, value);
+		}
+		else if (option == "--camera") {
+			options.scene.cameraPath = ParseCameraPath(value);
+		}
+		else if (option == "--font") {
+			options.scene.fontFile = value;
+		}
+		else if (option == "--seed") {
+			options.scene.seed = ParseUnsigned(option, value);
+		}
+		else if (option == "--width") {
+			options.scene.width = ParseUnsigned(option, value);
+		}
+		else if (option == "--height") {
+			options.scene.height = ParseUnsigned(option, value);
+		}
+		else {
+			throw InvalidArgumentException("Unknown option.", std::string(option));
+		}
+	}
+
+	if (options.frames == 0 || options.scene.materials == 0 || options.scene.instancedMeshes == 0 || options.scene.width == 0 || options.scene.height == 0) {
+		throw InvalidArgumentException("Frames, materials, meshes and resolution must be positive.");
+	}
+	return options;
+}
+
+
+std::string GetUsage() {
+	std::string presets;
+	for (const std::string& name : GetScenePresetNames()) {
+		presets += (presets.empty() ? "" : ", ") + name;
+	}
+	return "Benchmark_Pipeline [--pipeline new_forward.json] [--output report.json]\n"
+		   "                   [--frames 600] [--warmup 60] [--preset default] [--api d3d12|null]\n"
+		   "                   [--baseline baseline.json] [--save-baseline baseline.json] [--threshold 0.1]\n"
+		   "                   [--entities 1000] [--meshes 1] [--unique-meshes 0] [--materials 16]\n"
+		   "                   [--lights 1] [--point-lights 0] [--dynamic 0.0]\n"
+		   "                   [--texts 0] [--overlays 0] [--font file.ttf]\n"
+		   "                   [--camera orbit|flythrough|static] [--seed 1] [--width 1280] [--height 720]\n"
+		   "                   [--replay capture.json]\n"
+		   "Replays render a frame capture of GraphicsEngine::CaptureFrame instead of the scene, with its pipeline.\n"
+		   "Presets: " + presets + "\n";
+}
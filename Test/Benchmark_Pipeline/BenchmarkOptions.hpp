@@ -0,0 +1,29 @@
+#pragma once
+
+#include <SceneGenerator/SceneDesc.hpp>
+
+#include <cstdint>
+#include <string>
+
+
+struct BenchmarkOptions {
+	std::string pipeline = "new_forward.json"; // Name in GameData/Pipelines, or a path.
+	std::string output; // The JSON report goes to this file, or to stdout if empty.
+	std::string preset = "default"; // Scene the other scene options start from.
+	std::string api = "d3d12"; // Graphics API, d3d12 or null. The null API has no GPU work, it measures the CPU side only.
+	unsigned frames = 600; // Measured frames.
+	unsigned warmupFrames = 60; // Rendered before measuring, covers shader compilation and uploads.
+	std::string baseline; // Metrics are compared to this baseline file, the run fails on regressions.
+	std::string saveBaseline; // Metrics of this run are written to this file as the new baseline.
+	float threshold = 0.1f; // A metric regresses if it grows by more than this part of its baseline.
+	std::string replay; // Frame capture to render instead of the generated scene, its pipeline and resolution override the options.
+	SceneDesc scene;
+};
+
+
+/// <summary> Reads options like --frames 300 from the command line, unknown options throw InvalidArgumentException. </summary>
+/// <remarks> The --preset option is applied first wherever it is, so that the others override the preset's settings. </remarks>
+BenchmarkOptions ParseOptions(int argc, char* argv[]);
+
+/// <summary> Short description of the options. </summary>
+std::string GetUsage();
@@ -0,0 +1,234 @@
+#include "BenchmarkReport.hpp"
+
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <ostream>
+
+
+using namespace inl;
+
+
+void BenchmarkReport::AddCpuFrame(const ProfiledFrame& frame) {
+	m_cpuFrames.push_back((frame.end - frame.begin) * 1000.0);
+
+	std::vector<std::pair<const char*, double>> totals;
+	for (const auto& zone : frame.zones) {
+		auto it = std::find_if(totals.begin(), totals.end(), [&zone](const auto& total) { return std::strcmp(total.first, zone.name) == 0; });
+		if (it == totals.end()) {
+			totals.push_back({ zone.name, 0.0 });
+			it = totals.end() - 1;
+		}
+		it->second += (zone.end - zone.begin) * 1000.0;
+	}
+	for (const auto& [name, milliseconds] : totals) {
+		GetSamples(m_cpuZones, name).push_back(milliseconds);
+	}
+}
+
+
+void BenchmarkReport::AddGpuFrame(const gxeng::GpuFrameReport& frame) {
+	if (frame.nodes.empty() || (m_anyGpuFrame && frame.frame == m_lastGpuFrame)) {
+		return;
+	}
+	m_anyGpuFrame = true;
+	m_lastGpuFrame = frame.frame;
+
+	double total = 0.0;
+	size_t drawCalls = 0;
+	size_t descriptors = 0;
+	for (const auto& node : frame.nodes) {
+		GetSamples(m_gpuNodes, node.name).push_back(node.milliseconds);
+		if (node.name.find('/') == std::string::npos) { // Sub-scopes are inside their node.
+			total += node.milliseconds;
+			drawCalls += node.counters.numDrawCalls;
+			descriptors += node.counters.numScratchSpaceDescriptors;
+		}
+	}
+	m_gpuFrames.push_back(total);
+	m_drawCalls.push_back(double(drawCalls));
+	m_descriptors.push_back(double(descriptors));
+}
+
+
+void BenchmarkReport::AddMemory(const gxeng::MemoryStatistics& memory) {
+	m_peakVideoMemory = std::max(m_peakVideoMemory, memory.residency.currentUsage);
+	m_peakTransientMemory = std::max(m_peakTransientMemory, memory.transient.allocatedBytes);
+}
+
+
+std::vector<PerfMetric> BenchmarkReport::GetMetrics() const {
+	// The minimum deltas are about the run to run noise on an idle machine.
+	constexpr double MB = 1024.0 * 1024.0;
+	const Statistics cpu = Summarize(m_cpuFrames);
+	const Statistics gpu = Summarize(m_gpuFrames);
+	std::vector<PerfMetric> metrics = {
+		{ "cpu.frame.p50", cpu.p50, 0.1 },
+		{ "cpu.frame.p95", cpu.p95, 0.2 },
+		{ "gpu.frame.p50", gpu.p50, 0.1 },
+		{ "gpu.frame.p95", gpu.p95, 0.2 },
+		{ "drawCalls", Summarize(m_drawCalls).mean, 1.0 },
+		{ "descriptors", Summarize(m_descriptors).mean, 1.0 },
+		{ "videoMemoryMB", m_peakVideoMemory / MB, 8.0 },
+		{ "transientMemoryMB", m_peakTransientMemory / MB, 1.0 },
+	};
+	for (const auto& [name, samples] : m_gpuNodes) {
+		metrics.push_back({ "gpu.node." + name + ".p50", Summarize(samples).p50, 0.05 });
+	}
+	return metrics;
+}
+
+
+void BenchmarkReport::Write(std::ostream& output, const BenchmarkOptions& options, const std::vector<PerfRegression>* regressions) const {
+	rapidjson::OStreamWrapper stream(output);
+	rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(stream);
+
+	auto writeStatistics = [&writer](const std::vector<double>& samples) {
+		Statistics statistics = Summarize(samples);
+		writer.StartObject();
+		writer.Key("count");
+		writer.Uint64(statistics.count);
+		const std::pair<const char*, double> fields[] = {
+			{ "total", statistics.total },
+			{ "mean", statistics.mean },
+			{ "min", statistics.min },
+			{ "p50", statistics.p50 },
+			{ "p90", statistics.p90 },
+			{ "p95", statistics.p95 },
+			{ "p99", statistics.p99 },
+			{ "max", statistics.max },
+		};
+		for (const auto& [key, value] : fields) {
+			writer.Key(key);
+			writer.Double(value);
+		}
+		writer.EndObject();
+	};
+	auto writeSection = [&](const char* key, const char* listKey, const std::vector<double>& frames, const SampleList& list) {
+		writer.Key(key);
+		writer.StartObject();
+		writer.Key("frame");
+		writeStatistics(frames);
+		writer.Key(listKey);
+		writer.StartArray();
+		for (const auto& [name, samples] : list) {
+			writer.StartObject();
+			writer.Key("name");
+			writer.String(name.c_str());
+			writer.Key("milliseconds");
+			writeStatistics(samples);
+			writer.EndObject();
+		}
+		writer.EndArray();
+		writer.EndObject();
+	};
+
+	writer.StartObject();
+	writer.Key("pipeline");
+	writer.String(options.pipeline.c_str());
+	writer.Key("preset");
+	writer.String(options.preset.c_str());
+	if (!options.replay.empty()) {
+		writer.Key("replay");
+		writer.String(options.replay.c_str());
+	}
+	const std::pair<const char*, unsigned> settings[] = {
+		{ "frames", options.frames },
+		{ "warmupFrames", options.warmupFrames },
+		{ "entities", options.scene.entities },
+		{ "instancedMeshes", options.scene.instancedMeshes },
+		{ "uniqueMeshes", options.scene.uniqueMeshes },
+		{ "materials", options.scene.materials },
+		{ "lights", options.scene.directionalLights },
+		{ "pointLights", options.scene.pointLights },
+		{ "texts", options.scene.texts },
+		{ "overlays", options.scene.overlays },
+		{ "seed", options.scene.seed },
+		{ "width", options.scene.width },
+		{ "height", options.scene.height },
+	};
+	for (const auto& [key, value] : settings) {
+		writer.Key(key);
+		writer.Uint(value);
+	}
+	writer.Key("dynamicRatio");
+	writer.Double(options.scene.dynamicRatio);
+	writer.Key("camera");
+	const char* cameraPaths[] = { "orbit", "flythrough", "static" };
+	writer.String(cameraPaths[int(options.scene.cameraPath)]);
+	writeSection("cpu", "zones", m_cpuFrames, m_cpuZones);
+	writeSection("gpu", "nodes", m_gpuFrames, m_gpuNodes);
+	writer.Key("drawCalls");
+	writeStatistics(m_drawCalls);
+	writer.Key("descriptors");
+	writeStatistics(m_descriptors);
+	writer.Key("peakVideoMemory");
+	writer.Uint64(m_peakVideoMemory);
+	writer.Key("peakTransientMemory");
+	writer.Uint64(m_peakTransientMemory);
+
+	if (regressions) {
+		writer.Key("gate");
+		writer.StartObject();
+		writer.Key("baseline");
+		writer.String(options.baseline.c_str());
+		writer.Key("threshold");
+		writer.Double(options.threshold);
+		writer.Key("passed");
+		writer.Bool(regressions->empty());
+		writer.Key("regressions");
+		writer.StartArray();
+		for (const PerfRegression& regression : *regressions) {
+			writer.StartObject();
+			writer.Key("metric");
+			writer.String(regression.name.c_str());
+			writer.Key("baseline");
+			writer.Double(regression.baseline);
+			writer.Key("value");
+			writer.Double(regression.value);
+			writer.EndObject();
+		}
+		writer.EndArray();
+		writer.EndObject();
+	}
+	writer.EndObject();
+	output << std::endl;
+}
+
+
+BenchmarkReport::Statistics BenchmarkReport::Summarize(std::vector<double> samples) {
+	Statistics statistics;
+	if (samples.empty()) {
+		return statistics;
+	}
+	std::sort(samples.begin(), samples.end());
+
+	auto percentile = [&samples](double p) {
+		size_t rank = (size_t)std::ceil(p / 100.0 * samples.size());
+		return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+	};
+	statistics.count = samples.size();
+	statistics.total = std::accumulate(samples.begin(), samples.end(), 0.0);
+	statistics.mean = statistics.total / samples.size();
+	statistics.min = samples.front();
+	statistics.p50 = percentile(50);
+	statistics.p90 = percentile(90);
+	statistics.p95 = percentile(95);
+	statistics.p99 = percentile(99);
+	statistics.max = samples.back();
+	return statistics;
+}
+
+
+std::vector<double>& BenchmarkReport::GetSamples(SampleList& list, const std::string& name) {
+	auto it = std::find_if(list.begin(), list.end(), [&name](const auto& entry) { return entry.first == name; });
+	if (it != list.end()) {
+		return it->second;
+	}
+	list.push_back({ name, {} });
+	return list.back().second;
+}
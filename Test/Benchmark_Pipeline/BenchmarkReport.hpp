@@ -0,0 +1,70 @@
+#pragma once
+
+#include "BenchmarkOptions.hpp"
+#include "PerfGate.hpp"
+
+#include <BaseLibrary/FrameProfiler.hpp>
+#include <GraphicsEngine_LL/GpuProfiler.hpp>
+#include <GraphicsEngine_LL/GraphicsEngine.hpp>
+
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/// <summary>
+/// Collects per frame CPU zone and GPU node times, command counts and memory use of a benchmark run
+/// and writes their percentiles as JSON.
+/// </summary>
+class BenchmarkReport {
+public:
+	struct Statistics {
+		size_t count = 0;
+		double total = 0.0;
+		double mean = 0.0;
+		double min = 0.0;
+		double p50 = 0.0;
+		double p90 = 0.0;
+		double p95 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+	};
+
+public:
+	/// <summary> Zones with the same name are summed within the frame. </summary>
+	void AddCpuFrame(const inl::ProfiledFrame& frame);
+	/// <summary> Call with the latest report every frame, each measured frame is only added once. </summary>
+	void AddGpuFrame(const inl::gxeng::GpuFrameReport& frame);
+	/// <summary> Call once per measured frame, the peaks are reported. </summary>
+	void AddMemory(const inl::gxeng::MemoryStatistics& memory);
+
+	size_t GetCpuFrameCount() const { return m_cpuFrames.size(); }
+	size_t GetGpuFrameCount() const { return m_gpuFrames.size(); }
+
+	/// <summary> What the performance gate compares: frame time percentiles, median node times,
+	///		draw calls and scratch space descriptors per frame, and peak video memory. </summary>
+	std::vector<PerfMetric> GetMetrics() const;
+
+	/// <param name="regressions"> Result of the performance gate, if it ran. </param>
+	void Write(std::ostream& output, const BenchmarkOptions& options, const std::vector<PerfRegression>* regressions = nullptr) const;
+
+	/// <summary> Nearest rank percentiles, all zero for no samples. </summary>
+	static Statistics Summarize(std::vector<double> samples);
+
+private:
+	using SampleList = std::vector<std::pair<std::string, std::vector<double>>>; // In order of first appearance.
+	static std::vector<double>& GetSamples(SampleList& list, const std::string& name);
+
+private:
+	std::vector<double> m_cpuFrames; // Milliseconds.
+	std::vector<double> m_gpuFrames;
+	SampleList m_cpuZones;
+	SampleList m_gpuNodes;
+	std::vector<double> m_drawCalls; // Per GPU frame.
+	std::vector<double> m_descriptors;
+	uint64_t m_peakVideoMemory = 0;
+	uint64_t m_peakTransientMemory = 0;
+	uint64_t m_lastGpuFrame = 0;
+	bool m_anyGpuFrame = false;
+};
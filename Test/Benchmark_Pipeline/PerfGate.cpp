@@ -0,0 +1,75 @@
+#include "PerfGate.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <rapidjson/document.h>
+#include <rapidjson/istreamwrapper.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+#include <algorithm>
+#include <fstream>
+#include <ostream>
+
+
+using namespace inl;
+
+
+void WriteBaseline(std::ostream& output, const std::vector<PerfMetric>& metrics, const std::string& pipeline, const std::string& preset) {
+	rapidjson::OStreamWrapper stream(output);
+	rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(stream);
+
+	writer.StartObject();
+	writer.Key("pipeline");
+	writer.String(pipeline.c_str());
+	writer.Key("preset");
+	writer.String(preset.c_str());
+	writer.Key("metrics");
+	writer.StartObject();
+	for (const PerfMetric& metric : metrics) {
+		writer.Key(metric.name.c_str());
+		writer.Double(metric.value);
+	}
+	writer.EndObject();
+	writer.EndObject();
+	output << std::endl;
+}
+
+
+std::vector<PerfMetric> ReadBaseline(const std::string& path) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		throw FileNotFoundException("Failed to open baseline.", path);
+	}
+	rapidjson::IStreamWrapper stream(file);
+	rapidjson::Document document;
+	document.ParseStream(stream);
+	if (document.HasParseError() || !document.IsObject() || !document.HasMember("metrics") || !document["metrics"].IsObject()) {
+		throw InvalidArgumentException("Baseline has no metrics object.", path);
+	}
+
+	std::vector<PerfMetric> metrics;
+	for (const auto& member : document["metrics"].GetObject()) {
+		if (!member.value.IsNumber()) {
+			throw InvalidArgumentException("Baseline metric is not a number.", member.name.GetString());
+		}
+		metrics.push_back({ member.name.GetString(), member.value.GetDouble() });
+	}
+	return metrics;
+}
+
+
+std::vector<PerfRegression> FindRegressions(const std::vector<PerfMetric>& baseline, const std::vector<PerfMetric>& current, double threshold) {
+	std::vector<PerfRegression> regressions;
+	for (const PerfMetric& metric : current) {
+		auto it = std::find_if(baseline.begin(), baseline.end(), [&metric](const PerfMetric& base) { return base.name == metric.name; });
+		if (it == baseline.end()) {
+			continue;
+		}
+		const double delta = metric.value - it->value;
+		if (delta > threshold * it->value && delta > metric.minDelta) {
+			regressions.push_back({ metric.name, it->value, metric.value });
+		}
+	}
+	return regressions;
+}
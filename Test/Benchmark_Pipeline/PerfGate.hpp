@@ -0,0 +1,34 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+
+/// <summary> A measurement the performance gate compares to the baseline, larger is always worse. </summary>
+struct PerfMetric {
+	std::string name;
+	double value = 0.0;
+	double minDelta = 0.0; // Smaller increases are noise and never regressions, however large relative to the baseline.
+};
+
+
+struct PerfRegression {
+	std::string name;
+	double baseline = 0.0;
+	double value = 0.0;
+};
+
+
+/// <summary> Writes the metrics as a baseline file for <see cref="ReadBaseline"/>. </summary>
+void WriteBaseline(std::ostream& output, const std::vector<PerfMetric>& metrics, const std::string& pipeline, const std::string& preset);
+
+/// <summary> Reads a file written by <see cref="WriteBaseline"/>. Only the names and values are stored. </summary>
+/// <exception cref="inl::FileNotFoundException"> If the file can't be opened. </exception>
+/// <exception cref="inl::InvalidArgumentException"> If it is not a baseline. </exception>
+std::vector<PerfMetric> ReadBaseline(const std::string& path);
+
+/// <summary> The metrics that grew past the baseline by more than <paramref name="threshold"/> times the baseline
+///		and by more than their minimum delta. </summary>
+/// <remarks> Metrics missing from either list are skipped, so that adding or removing a node doesn't fail the gate. </remarks>
+std::vector<PerfRegression> FindRegressions(const std::vector<PerfMetric>& baseline, const std::vector<PerfMetric>& current, double threshold);
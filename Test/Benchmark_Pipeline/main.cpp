@@ -0,0 +1,177 @@
+#include "BenchmarkOptions.hpp"
+#include "BenchmarkReport.hpp"
+#include "PerfGate.hpp"
+
+#include <BaseLibrary/FrameProfiler.hpp>
+#include <BaseLibrary/Logging_All.hpp>
+#include <BaseLibrary/Platform/Window.hpp>
+#include <GraphicsApi_D3D12/GxapiManager.hpp>
+#include <GraphicsApi_Null/GxapiManager.hpp>
+#include <GraphicsApi_LL/IGraphicsApi.hpp>
+#include <GraphicsApi_LL/IGxapiManager.hpp>
+#include <GraphicsEngine_LL/GraphicsEngine.hpp>
+#include <SceneGenerator/GeneratedScene.hpp>
+#include <SceneGenerator/ReplayScene.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+
+
+using namespace inl;
+
+
+// Renders a pipeline on a generated scene for a fixed number of frames and prints the per node CPU and GPU
+// time percentiles as JSON. Frames advance by a fixed time step so that time dependent nodes behave the same
+// on every run. The engine needs a swap chain, so the frames go to a window that is never shown.
+// With --baseline, the run is a performance test: it fails with exit code 3 if any metric regressed.
+// With --replay, the frame of a capture is rendered over and over instead, with the capture's pipeline,
+// resolution and time step.
+int main(int argc, char* argv[]) {
+	BenchmarkOptions options;
+	try {
+		options = ParseOptions(argc, argv);
+	}
+	catch (InvalidArgumentException& ex) {
+		std::cerr << ex.what() << " " << ex.Subject() << std::endl;
+		std::cerr << GetUsage();
+		return 2;
+	}
+
+	try {
+		std::optional<gxeng::FrameCapture> capture;
+		if (!options.replay.empty()) {
+			std::ifstream captureFile(options.replay);
+			if (!captureFile.is_open()) {
+				throw FileNotFoundException("Failed to open frame capture.", options.replay);
+			}
+			capture = gxeng::FrameCapture::Read(captureFile);
+			options.scene.width = capture->width;
+			options.scene.height = capture->height;
+		}
+
+		Logger logger;
+		Window window{ "Pipeline benchmark", { options.scene.width, options.scene.height }, false, false, true };
+
+		// Create graphics API.
+		std::unique_ptr<gxapi::IGxapiManager> gxapiManager;
+		if (options.api == "null") {
+			gxapiManager.reset(new gxapi_null::GxapiManager());
+		}
+		else {
+			gxapiManager.reset(new gxapi_dx12::GxapiManager());
+		}
+
+		auto adapters = gxapiManager->EnumerateAdapters();
+		if (adapters.empty()) {
+			throw RuntimeException("No suitable graphics adapter found.");
+		}
+
+		std::unique_ptr<gxapi::IGraphicsApi> graphicsApi(gxapiManager->CreateGraphicsApi(adapters[0].adapterId));
+
+		// Create graphics engine.
+		gxeng::GraphicsEngineDesc graphicsEngineDesc;
+		graphicsEngineDesc.gxapiManager = gxapiManager.get();
+		graphicsEngineDesc.graphicsApi = graphicsApi.get();
+		graphicsEngineDesc.fullScreen = false;
+		graphicsEngineDesc.width = window.GetClientSize().x;
+		graphicsEngineDesc.height = window.GetClientSize().y;
+		graphicsEngineDesc.logger = &logger;
+		graphicsEngineDesc.targetWindow = window.GetNativeHandle();
+		std::unique_ptr<gxeng::GraphicsEngine> graphicsEngine(new gxeng::GraphicsEngine(graphicsEngineDesc));
+		graphicsEngine->SetShaderDirectories({ INL_NODE_SHADER_DIRECTORY, INL_MTL_SHADER_DIRECTORY, "./Shaders", "./Materials" });
+		graphicsEngine->SetGpuProfiling(true);
+
+		// Load graphics pipeline.
+		std::string pipelineDesc;
+		if (capture) {
+			pipelineDesc = capture->pipeline;
+		}
+		else {
+			std::filesystem::path pipelinePath = options.pipeline;
+			if (!std::filesystem::exists(pipelinePath)) {
+				pipelinePath = std::filesystem::path(INL_GAMEDATA) / "Pipelines" / options.pipeline;
+			}
+			std::ifstream pipelineFile(pipelinePath);
+			if (!pipelineFile.is_open()) {
+				throw FileNotFoundException("Failed to open pipeline JSON.", pipelinePath.string());
+			}
+			pipelineDesc.assign(std::istreambuf_iterator<char>(pipelineFile), std::istreambuf_iterator<char>());
+		}
+		graphicsEngine->LoadPipeline(pipelineDesc);
+
+		std::unique_ptr<GeneratedScene> generatedScene;
+		std::unique_ptr<ReplayScene> replayScene;
+		if (capture) {
+			replayScene = std::make_unique<ReplayScene>(graphicsEngine.get(), *capture);
+		}
+		else {
+			generatedScene = std::make_unique<GeneratedScene>(graphicsEngine.get(), options.scene);
+		}
+
+		// Render. GPU times arrive a few frames late, the extra frames collect those of the last measured ones.
+		FrameProfiler& profiler = FrameProfiler::GetGlobal();
+		profiler.SetEnabled(true);
+		BenchmarkReport report;
+		const float frameTime = capture && capture->elapsed > 0.0f ? capture->elapsed : 1.0f / 60.0f;
+		const unsigned firstMeasured = options.warmupFrames;
+		const unsigned lastMeasured = options.warmupFrames + options.frames;
+		for (unsigned frame = 0; frame < lastMeasured + gxeng::GpuProfiler::FrameLatency; ++frame) {
+			window.CallEvents();
+			if (generatedScene) {
+				generatedScene->Update(frame);
+			}
+			graphicsEngine->Update(frameTime);
+
+			if (firstMeasured <= frame && frame < lastMeasured) {
+				report.AddCpuFrame(profiler.GetLastFrame());
+				report.AddMemory(graphicsEngine->GetMemoryStatistics());
+			}
+			gxeng::GpuFrameReport gpuFrame = graphicsEngine->GetGpuFrameReport();
+			if (firstMeasured <= gpuFrame.frame && gpuFrame.frame < lastMeasured) {
+				report.AddGpuFrame(gpuFrame);
+			}
+		}
+
+		// Compare to and update baseline.
+		const std::vector<PerfMetric> metrics = report.GetMetrics();
+		std::vector<PerfRegression> regressions;
+		if (!options.baseline.empty()) {
+			regressions = FindRegressions(ReadBaseline(options.baseline), metrics, options.threshold);
+			for (const PerfRegression& regression : regressions) {
+				const double change = regression.baseline != 0.0 ? (regression.value / regression.baseline - 1.0) * 100.0 : 100.0;
+				std::cerr << "Regression: " << regression.name << " " << regression.baseline << " -> " << regression.value
+						  << " (+" << change << "%)" << std::endl;
+			}
+		}
+		if (!options.saveBaseline.empty()) {
+			std::ofstream baselineFile(options.saveBaseline);
+			if (!baselineFile.is_open()) {
+				throw RuntimeException("Failed to open baseline file.", options.saveBaseline);
+			}
+			WriteBaseline(baselineFile, metrics, options.pipeline, options.preset);
+		}
+
+		// Write report.
+		const std::vector<PerfRegression>* gate = options.baseline.empty() ? nullptr : &regressions;
+		if (options.output.empty()) {
+			report.Write(std::cout, options, gate);
+		}
+		else {
+			std::ofstream outputFile(options.output);
+			if (!outputFile.is_open()) {
+				throw RuntimeException("Failed to open output file.", options.output);
+			}
+			report.Write(outputFile, options, gate);
+		}
+		return regressions.empty() ? 0 : 3;
+	}
+	catch (Exception& ex) {
+		std::cerr << "Unhandled exception occured." << std::endl;
+		std::cerr << "MESSAGE:" << ex.what() << std::endl;
+		std::cerr << "STACK TRACE:" << std::endl;
+		ex.PrintStackTrace(std::cerr);
+		return 1;
+	}
+}
@@ -0,0 +1,151 @@
+#include "BatchSimulator.hpp"
+#include "QCSimulation.hpp"
+
+#include <BaseLibrary/JobSystem/Parallel.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+
+// Hover, tilt forward, stop, tilt right, turn, then climb, with a second of settling after each.
+static void ApplyManoeuvre(ControlInfo& controls, float time) {
+	controls.front = (time >= 1.0f && time < 3.0f) ? 1.0f : 0.0f;
+	controls.right = (time >= 4.0f && time < 5.0f) ? 1.0f : 0.0f;
+	controls.rotateLeft = (time >= 6.0f && time < 7.5f) ? 1.0f : 0.0f;
+	controls.ascend = (time >= 8.5f && time < 10.0f) ? 1.0f : 0.0f;
+}
+
+
+static SimulationResult RunCase(const SimulationCase& parameters, const BatchSettings& settings) {
+	SimulationResult result;
+	result.parameters = parameters;
+
+	QCSimulation simulation;
+	simulation.Controller().SetGains(parameters.Kp, parameters.Ki, parameters.Kd);
+	const float startAltitude = simulation.Body().GetPosition().z;
+
+	int numSteps = std::max(1, int(std::ceil(settings.duration / settings.timestep)));
+	if (settings.sampleInterval > 0) {
+		result.trajectory.reserve(numSteps / settings.sampleInterval + 1);
+	}
+
+	double sumSquaredError = 0.0;
+	int step = 0;
+	for (; step < numSteps; ++step) {
+		float time = step * settings.timestep;
+		ApplyManoeuvre(simulation.Controls(), time);
+		simulation.Step(settings.timestep);
+
+		const RigidBody& body = simulation.Body();
+		float error = simulation.GetAttitudeError();
+		inl::Vec3 position = body.GetPosition();
+		if (!std::isfinite(error) || !std::isfinite(position.x) || !std::isfinite(position.y) || !std::isfinite(position.z)
+			|| position.z < 0.0f) {
+			result.diverged = true;
+			++step;
+			break;
+		}
+
+		sumSquaredError += double(error) * error;
+		result.maxAttitudeError = std::max(result.maxAttitudeError, error);
+		result.maxAltitudeError = std::max(result.maxAltitudeError, std::abs(position.z - startAltitude));
+		if (settings.sampleInterval > 0 && step % settings.sampleInterval == 0) {
+			result.trajectory.push_back({ time + settings.timestep, position, body.GetRotation(), error });
+		}
+	}
+
+	result.rmsAttitudeError = float(std::sqrt(sumSquaredError / step));
+	result.finalPosition = simulation.Body().GetPosition();
+	return result;
+}
+
+
+std::vector<SimulationResult> RunBatch(inl::jobs::Scheduler* scheduler, const std::vector<SimulationCase>& cases, const BatchSettings& settings) {
+	std::vector<SimulationResult> results(cases.size());
+	// A flight takes about a millisecond, a few in a job keep the scheduling overhead low.
+	inl::jobs::CooperativeFor(scheduler, cases.size(), 4, [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i) {
+			results[i] = RunCase(cases[i], settings);
+		}
+	});
+	return results;
+}
+
+
+static void WriteVec3Csv(std::ostream& os, const inl::Vec3& v) {
+	os << v.x << ',' << v.y << ',' << v.z;
+}
+
+
+void WriteSummaryCsv(std::ostream& os, const std::vector<SimulationResult>& results) {
+	os << "case,kp_x,kp_y,kp_z,ki_x,ki_y,ki_z,kd_x,kd_y,kd_z,rms_attitude_error,max_attitude_error,max_altitude_error,final_x,final_y,final_z,diverged\n";
+	os << std::setprecision(6);
+	for (size_t i = 0; i < results.size(); ++i) {
+		const SimulationResult& result = results[i];
+		os << i << ',';
+		WriteVec3Csv(os, result.parameters.Kp);
+		os << ',';
+		WriteVec3Csv(os, result.parameters.Ki);
+		os << ',';
+		WriteVec3Csv(os, result.parameters.Kd);
+		os << ',' << result.rmsAttitudeError << ',' << result.maxAttitudeError << ',' << result.maxAltitudeError << ',';
+		WriteVec3Csv(os, result.finalPosition);
+		os << ',' << int(result.diverged) << '\n';
+	}
+}
+
+
+void WriteTrajectoriesCsv(std::ostream& os, const std::vector<SimulationResult>& results) {
+	os << "case,time,x,y,z,qw,qx,qy,qz,attitude_error\n";
+	os << std::setprecision(6);
+	for (size_t i = 0; i < results.size(); ++i) {
+		for (const TrajectorySample& sample : results[i].trajectory) {
+			os << i << ',' << sample.time << ',';
+			WriteVec3Csv(os, sample.position);
+			os << ',' << sample.rotation.w << ',' << sample.rotation.x << ',' << sample.rotation.y << ',' << sample.rotation.z;
+			os << ',' << sample.attitudeError << '\n';
+		}
+	}
+}
+
+
+static void WriteVec3Json(std::ostream& os, const inl::Vec3& v) {
+	os << '[' << v.x << ", " << v.y << ", " << v.z << ']';
+}
+
+
+void WriteJson(std::ostream& os, const std::vector<SimulationResult>& results) {
+	os << std::setprecision(6);
+	os << "[\n";
+	for (size_t i = 0; i < results.size(); ++i) {
+		const SimulationResult& result = results[i];
+		os << "  {\n";
+		os << "    \"case\": " << i << ",\n";
+		os << "    \"kp\": ";
+		WriteVec3Json(os, result.parameters.Kp);
+		os << ",\n    \"ki\": ";
+		WriteVec3Json(os, result.parameters.Ki);
+		os << ",\n    \"kd\": ";
+		WriteVec3Json(os, result.parameters.Kd);
+		os << ",\n    \"rmsAttitudeError\": " << result.rmsAttitudeError;
+		os << ",\n    \"maxAttitudeError\": " << result.maxAttitudeError;
+		os << ",\n    \"maxAltitudeError\": " << result.maxAltitudeError;
+		os << ",\n    \"finalPosition\": ";
+		WriteVec3Json(os, result.finalPosition);
+		os << ",\n    \"diverged\": " << (result.diverged ? "true" : "false");
+		if (!result.trajectory.empty()) {
+			os << ",\n    \"trajectory\": [";
+			for (size_t s = 0; s < result.trajectory.size(); ++s) {
+				const TrajectorySample& sample = result.trajectory[s];
+				os << (s == 0 ? "\n" : ",\n") << "      { \"t\": " << sample.time << ", \"p\": ";
+				WriteVec3Json(os, sample.position);
+				os << ", \"q\": [" << sample.rotation.w << ", " << sample.rotation.x << ", " << sample.rotation.y << ", " << sample.rotation.z << ']';
+				os << ", \"e\": " << sample.attitudeError << " }";
+			}
+			os << "\n    ]";
+		}
+		os << "\n  }" << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	os << "]\n";
+}
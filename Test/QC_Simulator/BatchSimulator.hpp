@@ -0,0 +1,55 @@
+#pragma once
+
+#include <InlineMath.hpp>
+
+#include <ostream>
+#include <vector>
+
+
+namespace inl::jobs {
+class Scheduler;
+}
+
+
+// One simulated flight: the controller gains to try.
+struct SimulationCase {
+	inl::Vec3 Kp, Ki, Kd;
+};
+
+
+struct BatchSettings {
+	float duration = 12.0f; // Seconds of simulated flight.
+	float timestep = 0.005f;
+	int sampleInterval = 10; // Steps between trajectory samples, 0 to not record trajectories.
+};
+
+
+struct TrajectorySample {
+	float time;
+	inl::Vec3 position;
+	inl::Quat rotation;
+	float attitudeError;
+};
+
+
+struct SimulationResult {
+	SimulationCase parameters;
+	float rmsAttitudeError = 0.0f; // Radians.
+	float maxAttitudeError = 0.0f;
+	float maxAltitudeError = 0.0f; // Meters away from the starting altitude.
+	inl::Vec3 finalPosition = { 0, 0, 0 };
+	bool diverged = false; // The state became invalid or the copter fell to the ground.
+	std::vector<TrajectorySample> trajectory;
+};
+
+
+// Flies the same scripted manoeuvre with every case, without graphics and as fast as possible.
+// Cases are independent and run as jobs on the scheduler, or on the calling thread if it is null.
+std::vector<SimulationResult> RunBatch(inl::jobs::Scheduler* scheduler, const std::vector<SimulationCase>& cases, const BatchSettings& settings);
+
+// One line per case with its gains and error metrics.
+void WriteSummaryCsv(std::ostream& os, const std::vector<SimulationResult>& results);
+// One line per trajectory sample, cases are told apart by their index.
+void WriteTrajectoriesCsv(std::ostream& os, const std::vector<SimulationResult>& results);
+// Metrics of every case, with trajectories if they were recorded.
+void WriteJson(std::ostream& os, const std::vector<SimulationResult>& results);
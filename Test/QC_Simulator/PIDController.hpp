@@ -8,6 +8,8 @@ public:
 	PIDController();
 	void Update(inl::Quat r, float lift, inl::Quat q, inl::Vec3 w, float elapsed, inl::Vec3& force, inl::Vec3& torque);
 	void SetInertia(inl::Mat33 inertia) { this->inertia = inertia; }
+	void SetGains(inl::Vec3 Kp, inl::Vec3 Ki, inl::Vec3 Kd) { this->Kp = Kp; this->Ki = Ki; this->Kd = Kd; }
+	void GetGains(inl::Vec3& Kp, inl::Vec3& Ki, inl::Vec3& Kd) const { Kp = this->Kp; Ki = this->Ki; Kd = this->Kd; }
 private:
 	inl::Mat33 inertia;
 
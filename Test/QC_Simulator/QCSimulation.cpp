@@ -0,0 +1,58 @@
+#include "QCSimulation.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+QCSimulation::QCSimulation() {
+	m_rigidBody.SetPosition({0, 0, 1});
+	m_rigidBody.SetRotation({ 1, 0, 0, 0 });
+
+	// copter parameters
+	float m = 2;
+	float Ixx = 0.026f;
+	float Iyy = 0.024f;
+	float Izz = 0.048f;
+	inl::Mat33 I = {
+		Ixx, 0, 0,
+		0, Iyy, 0,
+		0, 0, Izz };
+	m_rigidBody.SetMass(m);
+	m_rigidBody.SetInertia(I);
+	m_rigidBody.SetGravity({ 0, 0, -9.81f });
+	m_controller.SetInertia(I);
+}
+
+
+void QCSimulation::Step(float timestep, bool useController) {
+	// Update QC heading
+	m_rotorInfo.heading += 2.0f*(m_rotorInfo.rotateLeft - m_rotorInfo.rotateRight)*timestep;
+
+	if (!useController) {
+		inl::Vec4 rpm = m_rotorInfo.RPM(m_rotor);
+		inl::Vec3 force;
+		inl::Vec3 torque;
+		m_rotor.SetRPM(rpm, force, torque);
+		m_rigidBody.Update(timestep, force, torque);
+	}
+	else {
+		inl::Quat orientation = m_rotorInfo.Orientation();
+		inl::Quat q = m_rigidBody.GetRotation();
+		inl::Vec3 force;
+		inl::Vec3 torque;
+		inl::Vec4 rpm;
+		float lift = 2.0f * 9.81f + 5.f*(m_rotorInfo.ascend - m_rotorInfo.descend);
+		m_controller.Update(orientation, lift, q, m_rigidBody.GetAngularVelocity(), timestep, force, torque);
+		m_rotor.SetTorque(force, torque, rpm);
+		m_rotor.SetRPM(rpm, force, torque);
+		m_rigidBody.Update(timestep, force, torque);
+	}
+}
+
+
+float QCSimulation::GetAttitudeError() const {
+	inl::Quat e = m_rotorInfo.Orientation() * m_rigidBody.GetRotation().Inverse();
+	// q and -q are the same rotation, take the shorter way.
+	float w = std::min(std::abs(e.w), 1.0f);
+	return 2.0f * std::acos(w);
+}
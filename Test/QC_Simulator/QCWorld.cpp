@@ -478,6 +478,7 @@ QCWorld::QCWorld(inl::gxeng::GraphicsEngine* graphicsEngine) {
 	m_quadcopterEntity->SetPosition({ 0,0,-3 });
 	m_quadcopterEntity->SetRotation({ 1,0,0,0 });
 	m_quadcopterEntity->SetScale({ 1,1,1 });
+	m_quadcopterEntity->SetDynamic(true);
 	m_worldScene->GetEntities<MeshEntity>().Add(m_quadcopterEntity.get());
 
 	// Set up axes
@@ -515,31 +516,10 @@ QCWorld::QCWorld(inl::gxeng::GraphicsEngine* graphicsEngine) {
 	m_worldScene->GetEntities<MeshEntity>().Add(m_billboardEntity.get());
 	m_worldScene->GetEntities<MeshEntity>().Add(m_billboardEntity2.get());
 
-	// Set up simulation
-	m_rigidBody.SetPosition({0, 0, 1});
-	m_rigidBody.SetRotation({ 1, 0, 0, 0 });
-
-	// copter parameters
-	float m = 2;
-	float Ixx = 0.026f;
-	float Iyy = 0.024f;
-	float Izz = 0.048f;
-	inl::Mat33 I = {
-		Ixx, 0, 0,
-		0, Iyy, 0,
-		0, 0, Izz };
-	m_rigidBody.SetMass(m);
-	m_rigidBody.SetInertia(I);
-	m_rigidBody.SetGravity({ 0, 0, -9.81f });
-	m_controller.SetInertia(I);
-
 	CreatePipelineResources();
 }
 
 void QCWorld::UpdateWorld(float elapsed) {
-	// Update QC heading
-	m_rotorInfo.heading += 2.0f*(m_rotorInfo.rotateLeft - m_rotorInfo.rotateRight)*elapsed;
-
 	// Update simulation
 	float simulationStep = Clamp(elapsed, 0.001f, 0.5f);
 	int numSubiters = 1;
@@ -547,31 +527,13 @@ void QCWorld::UpdateWorld(float elapsed) {
 		numSubiters = int(ceil(simulationStep/0.02f) + 0.1);
 		simulationStep = simulationStep/numSubiters;
 	}
-	bool controller = true;
 	for (int i=0; i<numSubiters; ++i) {
-		if (!controller) {
-			inl::Vec4 rpm = m_rotorInfo.RPM(m_rotor);
-			inl::Vec3 force;
-			inl::Vec3 torque;
-			m_rotor.SetRPM(rpm, force, torque);
-			m_rigidBody.Update(simulationStep, force, torque);
-		}
-		else {
-			inl::Quat orientation = m_rotorInfo.Orientation();
-			inl::Quat q = m_rigidBody.GetRotation();
-			inl::Vec3 force;
-			inl::Vec3 torque;
-			inl::Vec4 rpm;
-			float lift = 2.0f * 9.81f + 5.f*(m_rotorInfo.ascend - m_rotorInfo.descend);
-			m_controller.Update(orientation, lift, q, m_rigidBody.GetAngularVelocity(), simulationStep, force, torque);
-			m_rotor.SetTorque(force, torque, rpm);
-			m_rotor.SetRPM(rpm, force, torque);
-			m_rigidBody.Update(simulationStep, force, torque);
-		}	
-	}
-
-	float speed = m_rigidBody.GetVelocity().Length();
-	float altitude = m_rigidBody.GetPosition().z;
+		m_simulation.Step(simulationStep);
+	}
+
+	const RigidBody& rigidBody = m_simulation.Body();
+	float speed = rigidBody.GetVelocity().Length();
+	float altitude = rigidBody.GetPosition().z;
 	std::stringstream infoString;
 	infoString << std::setprecision(4);
 	infoString << "Speed: " << speed*3.6f << " km/h, Alt.: " << altitude << " m";
@@ -579,11 +541,11 @@ void QCWorld::UpdateWorld(float elapsed) {
 
 
 	// Move quadcopter entity
-	m_quadcopterEntity->SetPosition(m_rigidBody.GetPosition());
-	m_quadcopterEntity->SetRotation(m_rigidBody.GetRotation());
+	m_quadcopterEntity->SetPosition(rigidBody.GetPosition());
+	m_quadcopterEntity->SetRotation(rigidBody.GetRotation());
 
 	m_axesEntity->SetPosition(m_quadcopterEntity->GetPosition());
-	m_axesEntity->SetRotation(m_rotorInfo.Orientation());
+	m_axesEntity->SetRotation(m_simulation.Controls().Orientation());
 
 	// Update fidesz text
 	if (Distance(m_quadcopterEntity->GetPosition(), m_billboardEntity->GetPosition()) < 3.f
@@ -602,13 +564,13 @@ void QCWorld::UpdateWorld(float elapsed) {
 	}
 
 	// Follow copter with camera
-	inl::Vec3 frontDir = m_rigidBody.GetRotation() * inl::Vec3{ 0, 1, 0 };
-	inl::Vec3 upDir = m_rigidBody.GetRotation() * inl::Vec3{ 0, 0, 1 };
+	inl::Vec3 frontDir = rigidBody.GetRotation() * inl::Vec3{ 0, 1, 0 };
+	inl::Vec3 upDir = rigidBody.GetRotation() * inl::Vec3{ 0, 0, 1 };
 	frontDir.z = 0;
 	upDir.z = 0;
 	inl::Vec3 viewDir = (5*frontDir.LengthSquared() > upDir.LengthSquared()) ? frontDir.Normalized() : upDir.Normalized();
-	m_camera->SetTarget(m_rigidBody.GetPosition());
-	m_camera->SetPosition(m_rigidBody.GetPosition() + (-viewDir * 1.5 + inl::Vec3{ 0,0,-lookTilt }).Normalized() * 1.5f);
+	m_camera->SetTarget(rigidBody.GetPosition());
+	m_camera->SetPosition(rigidBody.GetPosition() + (-viewDir * 1.5 + inl::Vec3{ 0,0,-lookTilt }).Normalized() * 1.5f);
 
 	unsigned width, height;
 	m_graphicsEngine->GetScreenSize(width, height);
@@ -650,28 +612,28 @@ void QCWorld::AddTree(inl::Vec3 position) {
 
 
 void QCWorld::TiltForward(float set) {
-	m_rotorInfo.front = set;
+	m_simulation.Controls().front = set;
 }
 void QCWorld::TiltBackward(float set) {
-	m_rotorInfo.back = set;
+	m_simulation.Controls().back = set;
 }
 void QCWorld::TiltRight(float set) {
-	m_rotorInfo.right = set;
+	m_simulation.Controls().right = set;
 }
 void QCWorld::TiltLeft(float set) {
-	m_rotorInfo.left = set;
+	m_simulation.Controls().left = set;
 }
 void QCWorld::RotateRight(float set) {
-	m_rotorInfo.rotateRight = set;
+	m_simulation.Controls().rotateRight = set;
 }
 void QCWorld::RotateLeft(float set) {
-	m_rotorInfo.rotateLeft = set;
+	m_simulation.Controls().rotateLeft = set;
 }
 void QCWorld::Ascend(float set) {
-	m_rotorInfo.ascend = set;
+	m_simulation.Controls().ascend = set;
 }
 void QCWorld::Descend(float set) {
-	m_rotorInfo.descend = set;
+	m_simulation.Controls().descend = set;
 }
 void QCWorld::IncreaseBase() {
 	//m_rotorInfo.baseRpm += 15.f;
@@ -680,10 +642,10 @@ void QCWorld::DecreaseBase() {
 	//m_rotorInfo.baseRpm -= 15.f;
 }
 void QCWorld::Heading(float set) {
-	m_rotorInfo.heading = set;
+	m_simulation.Controls().heading = set;
 }
 float QCWorld::Heading() const {
-	return m_rotorInfo.heading;
+	return m_simulation.Controls().heading;
 }
 
 
@@ -14,49 +14,10 @@
 #include <GraphicsEngine_LL/DirectionalLight.hpp>
 #include <GraphicsEngine_LL/Font.hpp>
 #include <GraphicsEngine_LL/TextEntity.hpp>
-#include "RigidBody.hpp"
-#include "Rotor.hpp"
-#include "PIDController.hpp"
+#include "QCSimulation.hpp"
 #include <InlineMath.hpp>
 
 
-struct ControlInfo {
-	float weight = 19.62f; // weight!=mass is in newtowns, not kg!
-	float offsetRpm = 100.f;
-	float ascend = 0.f, descend = 0.f;
-	float front = 0.f, back = 0.f, left = 0.f, right = 0.f;
-	float rotateLeft = 0.f, rotateRight = 0.f;
-	float heading = 0.0f;
-
-	//           >   y   <
-	//           1       2
-	//             \ ^ /
-	//               |       x
-	//             /   \
-	//           3       4
-	//           >       <
-	inl::Vec4 RPM(const Rotor& rotor) const {
-		inl::Vec3 force, torque;
-		force = { 0, 0, weight + ascend - descend };
-		torque = {
-			0.05f*(back - front),
-			0.05f*(right - left),
-			0.2f*(rotateLeft - rotateRight)
-		};
-		inl::Vec4 rpm;
-		rotor.SetTorque(force, torque, rpm);
-		return rpm;
-	}
-
-	inl::Quat Orientation() const {
-		auto x = inl::Quat::AxisAngle(inl::Vec3{ 1, 0, 0 }, 0.35f*(back - front));
-		auto y = inl::Quat::AxisAngle(inl::Vec3{ 0, 1, 0 }, 0.35f*(right - left));
-		auto z = inl::Quat::AxisAngle(inl::Vec3{ 0, 0, 1 }, heading);
-		return z*y*x;
-	}
-};
-
-
 class QCWorld {
 public:
 	QCWorld(inl::gxeng::GraphicsEngine* graphicsEngine);
@@ -158,9 +119,6 @@ private:
 	bool m_textFlashing = false;
 
 	// Simulation
-	PIDController m_controller;
-	Rotor m_rotor;
-	RigidBody m_rigidBody;
-	ControlInfo m_rotorInfo;
+	QCSimulation m_simulation;
 	float lookTilt = -0.4f;
 };
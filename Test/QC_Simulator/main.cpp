@@ -4,6 +4,7 @@
 #include <BaseLibrary/Platform/Input.hpp>
 #include <BaseLibrary/Platform/Window.hpp>
 #include <BaseLibrary/Timer.hpp>
+#include <BaseLibrary/JobSystem/ThreadpoolScheduler.hpp>
 
 // include interfaces
 #include <GraphicsApi_LL/IGraphicsApi.hpp>
@@ -20,6 +21,7 @@
 #include <string>
 
 #include "QCWorld.hpp"
+#include "BatchSimulator.hpp"
 
 
 using std::cout;
@@ -46,6 +48,7 @@ std::string errorMessage;
 // Function prototypes
 std::string SelectPipeline(IGraphicsApi* gxapi);
 void OnTerminate();
+int RunHeadless(int argc, char* argv[]);
 
 
 // -----------------------------------------------------------------------------
@@ -78,6 +81,11 @@ private:
 // main()
 
 int main(int argc, char* argv[]) {
+	// Batch simulation without window or graphics
+	if (argc >= 2 && argv[1] == std::string("--headless")) {
+		return RunHeadless(argc, argv);
+	}
+
 	// Initialize logger
 	logFile.open("engine_test.log");
 	logFilePath = std::filesystem::current_path();
@@ -149,6 +157,8 @@ int main(int argc, char* argv[]) {
 		desc.height = window.GetClientSize().y;
 		desc.targetWindow = window.GetNativeHandle();
 		desc.logger = &logger;
+		desc.pipelineCachePath = "PipelineCache.bin";
+		desc.shaderCacheDirectory = "ShaderCache";
 
 		engine.reset(new GraphicsEngine(desc));
 
@@ -379,6 +389,120 @@ std::string SelectPipeline(IGraphicsApi* gxapi) {
 }
 
 
+// Parses "min:max:count", count values evenly spaced from min to max.
+static std::vector<float> ParseRange(const std::string& arg) {
+	float min = 1.0f, max = 1.0f;
+	int count = 1;
+	if (sscanf(arg.c_str(), "%f:%f:%d", &min, &max, &count) < 1 || count < 1) {
+		throw InvalidArgumentException("Range must look like min:max:count.");
+	}
+	if (count == 1) {
+		return { min };
+	}
+	std::vector<float> values;
+	for (int i = 0; i < count; ++i) {
+		values.push_back(min + (max - min) * i / (count - 1));
+	}
+	return values;
+}
+
+
+// Usage: --headless [--kp min:max:count] [--kd min:max:count] [--duration s] [--step s]
+//		[--sample steps] [--threads n] [--out prefix] [--json]
+// Flies every combination of the scaled default P and D gains.
+int RunHeadless(int argc, char* argv[]) {
+	std::vector<float> kpScales = { 1.0f }, kdScales = { 1.0f };
+	BatchSettings settings;
+	int numThreads = std::thread::hardware_concurrency();
+	std::string outPrefix = "qc_batch";
+	bool json = false;
+
+	try {
+		for (int i = 2; i < argc; ++i) {
+			std::string arg = argv[i];
+			bool hasValue = i + 1 < argc;
+			if (arg == "--json") {
+				json = true;
+			}
+			else if (!hasValue) {
+				throw InvalidArgumentException("Missing value for " + arg);
+			}
+			else if (arg == "--kp") {
+				kpScales = ParseRange(argv[++i]);
+			}
+			else if (arg == "--kd") {
+				kdScales = ParseRange(argv[++i]);
+			}
+			else if (arg == "--duration") {
+				settings.duration = std::stof(argv[++i]);
+			}
+			else if (arg == "--step") {
+				settings.timestep = std::stof(argv[++i]);
+			}
+			else if (arg == "--sample") {
+				settings.sampleInterval = std::stoi(argv[++i]);
+			}
+			else if (arg == "--threads") {
+				numThreads = std::max(1, std::stoi(argv[++i]));
+			}
+			else if (arg == "--out") {
+				outPrefix = argv[++i];
+			}
+			else {
+				throw InvalidArgumentException("Unknown option " + arg);
+			}
+		}
+		if (settings.timestep <= 0.0f || settings.duration <= 0.0f) {
+			throw InvalidArgumentException("Duration and step must be positive.");
+		}
+	}
+	catch (std::exception& ex) {
+		cout << ex.what() << endl;
+		return 1;
+	}
+
+	Vec3 Kp, Ki, Kd;
+	PIDController().GetGains(Kp, Ki, Kd);
+	std::vector<SimulationCase> cases;
+	for (float kpScale : kpScales) {
+		for (float kdScale : kdScales) {
+			cases.push_back({ kpScale * Kp, Ki, kdScale * Kd });
+		}
+	}
+
+	cout << "Simulating " << cases.size() << " flights on " << numThreads << " threads..." << endl;
+	Timer timer;
+	timer.Start();
+	std::vector<SimulationResult> results;
+	{
+		jobs::ThreadpoolScheduler scheduler(numThreads);
+		results = RunBatch(&scheduler, cases, settings);
+	}
+	cout << "Finished in " << timer.Elapsed() << " s." << endl;
+
+	if (json) {
+		std::ofstream file(outPrefix + ".json");
+		WriteJson(file, results);
+	}
+	else {
+		std::ofstream summary(outPrefix + "_summary.csv");
+		WriteSummaryCsv(summary, results);
+		if (settings.sampleInterval > 0) {
+			std::ofstream trajectories(outPrefix + "_trajectories.csv");
+			WriteTrajectoriesCsv(trajectories, results);
+		}
+	}
+
+	auto best = std::min_element(results.begin(), results.end(), [](const SimulationResult& lhs, const SimulationResult& rhs) {
+		return std::make_pair(lhs.diverged, lhs.rmsAttitudeError) < std::make_pair(rhs.diverged, rhs.rmsAttitudeError);
+	});
+	if (best != results.end()) {
+		cout << "Lowest RMS attitude error: case " << (best - results.begin()) << ", " << best->rmsAttitudeError << " rad." << endl;
+	}
+	return 0;
+}
+
+
 void OnTerminate() {
 	try {
 		std::rethrow_exception(std::current_exception());
@@ -0,0 +1,279 @@
+#include "GeneratedScene.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+#include <BaseLibrary/StringUtil.hpp>
+#include <GraphicsEngine/Resources/Pixel.hpp>
+#include <GraphicsEngine/Resources/Vertex.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <string>
+
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+GeneratedScene::GeneratedScene(GraphicsEngine* graphicsEngine, const SceneDesc& desc)
+	: m_graphicsEngine(graphicsEngine), m_desc(desc) {
+	if (m_desc.materials == 0 || m_desc.instancedMeshes == 0 || m_desc.cameraPeriod == 0) {
+		throw InvalidArgumentException("Materials, instanced meshes and camera period must be positive.");
+	}
+	m_desc.dynamicRatio = std::clamp(m_desc.dynamicRatio, 0.0f, 1.0f);
+	std::mt19937 rng(m_desc.seed);
+
+	m_scene.reset(m_graphicsEngine->CreateScene("MainScene"));
+	m_camera.reset(m_graphicsEngine->CreatePerspectiveCamera("MainCamera"));
+	m_camera->SetTargeted(true);
+	m_camera->SetTarget({ 0, 0, 0 });
+	m_camera->SetUpVector({ 0, 0, 1 });
+	m_camera->SetNearPlane(0.1f);
+	m_camera->SetFarPlane(500.0f);
+	m_camera->SetFOVAspect(Deg2Rad(75.f), float(m_desc.width) / float(m_desc.height));
+
+	CreateMaterials(m_desc.materials, rng);
+	CreateMeshEntities(rng);
+	CreateLights(rng);
+	if (m_desc.texts > 0 || m_desc.overlays > 0) {
+		CreateGui(rng);
+	}
+
+	Update(0);
+}
+
+
+void GeneratedScene::Update(unsigned frame) {
+	const float angle = 2.0f * Constants<float>::Pi * float(frame % m_desc.cameraPeriod) / float(m_desc.cameraPeriod);
+
+	switch (m_desc.cameraPath) {
+		case eCameraPath::ORBIT: {
+			float radius = 1.2f * m_extent;
+			m_camera->SetPosition({ radius * std::cos(angle), radius * std::sin(angle), 0.6f * m_extent });
+			m_camera->SetTarget({ 0, 0, 0 });
+			break;
+		}
+		case eCameraPath::FLYTHROUGH: {
+			// Just above the tallest props, looking a bit ahead along the loop.
+			float radius = 0.5f * m_extent;
+			const float lookAhead = 0.2f;
+			m_camera->SetPosition({ radius * std::cos(angle), radius * std::sin(angle), 2.5f });
+			m_camera->SetTarget({ radius * std::cos(angle + lookAhead), radius * std::sin(angle + lookAhead), 2.0f });
+			break;
+		}
+		case eCameraPath::STATIC: {
+			float radius = 1.2f * m_extent;
+			m_camera->SetPosition({ radius, 0, 0.6f * m_extent });
+			m_camera->SetTarget({ 0, 0, 0 });
+			break;
+		}
+	}
+
+	// Dynamic entities bob and spin, each out of phase with the others.
+	for (const DynamicEntity& dynamic : m_dynamicEntities) {
+		float entityAngle = angle + dynamic.phase;
+		dynamic.entity->SetPosition(dynamic.position + Vec3{ 0, 0, 0.5f + 0.5f * std::sin(entityAngle) });
+		dynamic.entity->SetRotation(Quat::AxisAngle(Vec3{ 0, 0, 1 }, entityAngle));
+	}
+}
+
+
+void GeneratedScene::CreateMeshEntities(std::mt19937& rng) {
+	// The instanced meshes differ in tessellation and shape, so that they don't batch together.
+	std::uniform_real_distribution<float> roundness(0.0f, 0.8f);
+	for (unsigned i = 0; i < m_desc.instancedMeshes + m_desc.uniqueMeshes; ++i) {
+		m_meshes.push_back(CreateRoundedBox(1 + i % 4, roundness(rng)));
+	}
+
+	// Scatter the entities over a square that grows with their count, so the density stays the same.
+	const unsigned numEntities = m_desc.entities + m_desc.uniqueMeshes;
+	const unsigned numDynamic = unsigned(std::round(m_desc.dynamicRatio * float(numEntities)));
+	m_extent = 2.0f * std::sqrt(float(std::max(numEntities, 1u)));
+	std::uniform_real_distribution<float> position(-m_extent, m_extent);
+	std::uniform_real_distribution<float> scale(0.3f, 1.2f);
+	std::uniform_real_distribution<float> phase(0.0f, 2.0f * Constants<float>::Pi);
+	std::uniform_int_distribution<size_t> material(0, m_materials.size() - 1);
+	std::uniform_int_distribution<size_t> instancedMesh(0, m_desc.instancedMeshes - 1);
+	for (unsigned i = 0; i < numEntities; ++i) {
+		size_t mesh = i < m_desc.entities ? instancedMesh(rng) : m_desc.instancedMeshes + (i - m_desc.entities);
+		std::unique_ptr<MeshEntity> entity(m_graphicsEngine->CreateMeshEntity());
+		entity->SetMesh(m_meshes[mesh].get());
+		entity->SetMaterial(m_materials[material(rng)].get());
+		float x = position(rng);
+		float y = position(rng);
+		float size = scale(rng);
+		entity->SetPosition({ x, y, size });
+		entity->SetRotation({ 1, 0, 0, 0 });
+		entity->SetScale({ size, size, size });
+		// Every n-th entity moves, so that the dynamic ones are spread over the scene and the meshes.
+		if (numDynamic > 0 && (uint64_t(i) * numDynamic) % numEntities < numDynamic) {
+			m_dynamicEntities.push_back({ entity.get(), Vec3{ x, y, size }, phase(rng) });
+		}
+		m_scene->GetEntities<MeshEntity>().Add(entity.get());
+		m_entities.push_back(std::move(entity));
+	}
+}
+
+
+void GeneratedScene::CreateLights(std::mt19937& rng) {
+	std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> color(0.3f, 1.0f);
+	for (unsigned i = 0; i < m_desc.directionalLights; ++i) {
+		Vec3 lightDirection{ direction(rng), direction(rng), -1.0f };
+		auto light = std::make_unique<DirectionalLight>(lightDirection.Normalized(), Vec3{ color(rng), color(rng), color(rng) });
+		m_scene->GetEntities<DirectionalLight>().Add(light.get());
+		m_directionalLights.push_back(std::move(light));
+	}
+
+	std::uniform_real_distribution<float> position(-m_extent, m_extent);
+	std::uniform_real_distribution<float> height(1.0f, 3.0f);
+	std::uniform_real_distribution<float> range(4.0f, 10.0f);
+	for (unsigned i = 0; i < m_desc.pointLights; ++i) {
+		Vec3 lightPosition{ position(rng), position(rng), height(rng) };
+		auto light = std::make_unique<PointLight>(lightPosition, Vec3{ color(rng), color(rng), color(rng) }, range(rng));
+		m_scene->GetEntities<PointLight>().Add(light.get());
+		m_pointLights.push_back(std::move(light));
+	}
+}
+
+
+void GeneratedScene::CreateGui(std::mt19937& rng) {
+	const Vec2 extent = { float(m_desc.width), float(m_desc.height) };
+	m_guiScene.reset(m_graphicsEngine->CreateScene("GuiScene"));
+	m_guiCamera.reset(m_graphicsEngine->CreateCamera2D("GuiCamera"));
+	m_guiCamera->SetExtent(extent);
+	m_guiCamera->SetPosition(extent / 2);
+
+	std::vector<Vertex<Position<0>, TexCoord<0>>> vertices(4);
+	const std::array<Vec2, 4> corners = { { { -1, -1 }, { -1, 1 }, { 1, 1 }, { 1, -1 } } };
+	for (size_t i = 0; i < corners.size(); ++i) {
+		vertices[i].position = Vec3{ corners[i].x, corners[i].y, 0 };
+		vertices[i].texCoord = (corners[i] + Vec2{ 1, 1 }) * 0.5f;
+	}
+	std::vector<unsigned> indices = { 0, 1, 2, 0, 2, 3 };
+	m_quadMesh.reset(m_graphicsEngine->CreateMesh());
+	m_quadMesh->Set(vertices.data(), &vertices[0].GetReader(), vertices.size(), indices.data(), indices.size());
+
+	// Overlays are panels of all sizes over each other, every other one textured.
+	std::uniform_real_distribution<float> x(0.0f, extent.x);
+	std::uniform_real_distribution<float> y(0.0f, extent.y);
+	std::uniform_real_distribution<float> size(10.0f, 200.0f);
+	std::uniform_real_distribution<float> channel(0.1f, 1.0f);
+	for (unsigned i = 0; i < m_desc.overlays; ++i) {
+		std::unique_ptr<OverlayEntity> overlay(m_graphicsEngine->CreateOverlayEntity());
+		overlay->SetMesh(m_quadMesh.get());
+		overlay->SetPosition({ x(rng), y(rng) });
+		overlay->SetScale({ size(rng) / 2, size(rng) / 4 });
+		overlay->SetColor({ channel(rng), channel(rng), channel(rng), 1.0f });
+		if (i % 2 == 1) {
+			overlay->SetTexture(m_textures[i % m_textures.size()].get());
+		}
+		overlay->SetZDepth(float(i));
+		m_guiScene->GetEntities<OverlayEntity>().Add(overlay.get());
+		m_overlays.push_back(std::move(overlay));
+	}
+
+	if (m_desc.texts == 0) {
+		return;
+	}
+	std::ifstream fontFile(m_desc.fontFile, std::ios::binary);
+	if (!fontFile.is_open()) {
+		throw FileNotFoundException("Texts need a font file.", m_desc.fontFile);
+	}
+	m_font.reset(m_graphicsEngine->CreateFont());
+	m_font->LoadFile(fontFile);
+
+	// Labels of different lengths and sizes on top of the overlays.
+	std::uniform_real_distribution<float> fontSize(10.0f, 32.0f);
+	std::uniform_int_distribution<unsigned> words(1, 6);
+	for (unsigned i = 0; i < m_desc.texts; ++i) {
+		std::u32string text = U"Label " + EncodeString<char32_t>(std::to_string(i));
+		for (unsigned w = words(rng); w > 0; --w) {
+			text += U" lorem ipsum";
+		}
+		float textSize = fontSize(rng);
+		std::unique_ptr<TextEntity> entity(m_graphicsEngine->CreateTextEntity());
+		entity->SetFont(m_font.get());
+		entity->SetFontSize(textSize);
+		entity->SetColor({ 1, 1, 1, 1 });
+		entity->SetPosition({ x(rng), y(rng) });
+		entity->SetScale({ 1.f, 1.f });
+		entity->SetSize({ textSize * 0.6f * float(text.size()), textSize * 1.5f });
+		entity->SetText(std::move(text));
+		entity->SetZDepth(float(m_desc.overlays + i));
+		entity->SetHorizontalAlignment(TextEntity::ALIGN_LEFT);
+		entity->SetVerticalAlignment(TextEntity::ALIGN_CENTER);
+		m_guiScene->GetEntities<TextEntity>().Add(entity.get());
+		m_texts.push_back(std::move(entity));
+	}
+}
+
+
+std::unique_ptr<Mesh> GeneratedScene::CreateRoundedBox(unsigned subdivisions, float roundness) const {
+	using VertexT = Vertex<Position<0>, Normal<0>, TexCoord<0>>;
+
+	// A unit cube with each face split into a grid, pulled towards the circumscribed sphere by the roundness.
+	std::vector<VertexT> vertices;
+	std::vector<unsigned> indices;
+	const std::array<Vec3, 6> normals = { { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } } };
+	const unsigned rowLength = subdivisions + 1;
+	for (const Vec3& normal : normals) {
+		// Two axes spanning the face, ordered so that the winding is the same on every face.
+		Vec3 u = std::abs(normal.z) > 0.5f ? Vec3{ 1, 0, 0 } : Vec3{ 0, 0, 1 };
+		Vec3 v = Cross(normal, u);
+		unsigned base = (unsigned)vertices.size();
+		for (unsigned row = 0; row < rowLength; ++row) {
+			for (unsigned column = 0; column < rowLength; ++column) {
+				Vec2 corner = Vec2{ float(column), float(row) } / float(subdivisions) * 2.0f - Vec2{ 1, 1 };
+				Vec3 onCube = normal + corner.x * u + corner.y * v;
+				Vec3 onSphere = onCube.Normalized() * std::sqrt(3.0f);
+				VertexT vertex;
+				vertex.position = onCube + (onSphere - onCube) * roundness;
+				vertex.normal = (normal + (onSphere.Normalized() - normal) * roundness).Normalized();
+				vertex.texCoord = (corner + Vec2{ 1, 1 }) * 0.5f;
+				vertices.push_back(vertex);
+			}
+		}
+		for (unsigned row = 0; row < subdivisions; ++row) {
+			for (unsigned column = 0; column < subdivisions; ++column) {
+				unsigned first = base + row * rowLength + column;
+				indices.insert(indices.end(), { first, first + rowLength, first + rowLength + 1, first, first + rowLength + 1, first + 1 });
+			}
+		}
+	}
+
+	std::unique_ptr<Mesh> mesh(m_graphicsEngine->CreateMesh());
+	mesh->Set(vertices.data(), &vertices[0].GetReader(), vertices.size(), indices.data(), indices.size());
+	return mesh;
+}
+
+
+void GeneratedScene::CreateMaterials(unsigned count, std::mt19937& rng) {
+	m_shader.reset(m_graphicsEngine->CreateMaterialShaderGraph());
+	std::unique_ptr<MaterialShaderEquation> mapShader(m_graphicsEngine->CreateMaterialShaderEquation());
+	std::unique_ptr<MaterialShaderEquation> diffuseShader(m_graphicsEngine->CreateMaterialShaderEquation());
+	mapShader->SetSourceFile("BitmapColor2D.mtl");
+	diffuseShader->SetSourceFile("SimpleDiffuse.mtl");
+	mapShader->GetOutput(0)->Link(diffuseShader->GetInput(0));
+	std::vector<std::unique_ptr<MaterialShader>> nodes;
+	nodes.push_back(std::move(mapShader));
+	nodes.push_back(std::move(diffuseShader));
+	m_shader->SetGraph(std::move(nodes));
+
+	using PixelT = Pixel<ePixelChannelType::INT8_NORM, 4, ePixelClass::LINEAR>;
+	std::uniform_int_distribution<int> channel(32, 255);
+	for (unsigned i = 0; i < count; ++i) {
+		PixelT pixel = { uint8_t(channel(rng)), uint8_t(channel(rng)), uint8_t(channel(rng)), 255 };
+		std::unique_ptr<Image> texture(m_graphicsEngine->CreateImage());
+		texture->SetLayout(1, 1, ePixelChannelType::INT8_NORM, 4, ePixelClass::LINEAR);
+		texture->Update(0, 0, 1, 1, 0, &pixel, PixelT::Reader());
+
+		std::unique_ptr<Material> material(m_graphicsEngine->CreateMaterial());
+		material->SetShader(m_shader.get());
+		(*material)[0] = texture.get();
+
+		m_textures.push_back(std::move(texture));
+		m_materials.push_back(std::move(material));
+	}
+}
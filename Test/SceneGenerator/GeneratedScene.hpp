@@ -0,0 +1,77 @@
+#pragma once
+
+#include "SceneDesc.hpp"
+
+#include <GraphicsEngine_LL/Camera2D.hpp>
+#include <GraphicsEngine_LL/DirectionalLight.hpp>
+#include <GraphicsEngine_LL/Font.hpp>
+#include <GraphicsEngine_LL/GraphicsEngine.hpp>
+#include <GraphicsEngine_LL/Image.hpp>
+#include <GraphicsEngine_LL/Material.hpp>
+#include <GraphicsEngine_LL/MaterialShader.hpp>
+#include <GraphicsEngine_LL/Mesh.hpp>
+#include <GraphicsEngine_LL/MeshEntity.hpp>
+#include <GraphicsEngine_LL/OverlayEntity.hpp>
+#include <GraphicsEngine_LL/PerspectiveCamera.hpp>
+#include <GraphicsEngine_LL/PointLight.hpp>
+#include <GraphicsEngine_LL/Scene.hpp>
+#include <GraphicsEngine_LL/TextEntity.hpp>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+
+/// <summary>
+/// Procedurally generated scene for the pipelines' MainScene and MainCamera, and GuiScene and GuiCamera.
+/// </summary>
+/// <remarks> Everything is generated from the seed, so the same description always gives the same scene.
+///		Mesh entities are rounded boxes scattered on a square in front of the camera that grows with their count,
+///		each material has its own solid color texture. The GUI scene is only created if there are texts or overlays. </remarks>
+class GeneratedScene {
+public:
+	GeneratedScene(inl::gxeng::GraphicsEngine* graphicsEngine, const SceneDesc& desc);
+
+	/// <summary> Moves the camera along its path and the dynamic entities, <paramref name="frame"/> alone determines where they are. </summary>
+	void Update(unsigned frame);
+
+	const SceneDesc& GetDesc() const { return m_desc; }
+	inl::gxeng::Scene* GetScene() const { return m_scene.get(); }
+	inl::gxeng::PerspectiveCamera* GetCamera() const { return m_camera.get(); }
+
+private:
+	struct DynamicEntity {
+		inl::gxeng::MeshEntity* entity;
+		inl::Vec3 position;
+		float phase;
+	};
+
+	void CreateMeshEntities(std::mt19937& rng);
+	void CreateLights(std::mt19937& rng);
+	void CreateGui(std::mt19937& rng);
+	std::unique_ptr<inl::gxeng::Mesh> CreateRoundedBox(unsigned subdivisions, float roundness) const;
+	void CreateMaterials(unsigned count, std::mt19937& rng);
+
+private:
+	inl::gxeng::GraphicsEngine* m_graphicsEngine;
+	SceneDesc m_desc;
+	std::unique_ptr<inl::gxeng::Scene> m_scene;
+	std::unique_ptr<inl::gxeng::PerspectiveCamera> m_camera;
+	float m_extent;
+
+	std::vector<std::unique_ptr<inl::gxeng::Mesh>> m_meshes;
+	std::unique_ptr<inl::gxeng::MaterialShaderGraph> m_shader;
+	std::vector<std::unique_ptr<inl::gxeng::Image>> m_textures;
+	std::vector<std::unique_ptr<inl::gxeng::Material>> m_materials;
+	std::vector<std::unique_ptr<inl::gxeng::MeshEntity>> m_entities;
+	std::vector<DynamicEntity> m_dynamicEntities;
+	std::vector<std::unique_ptr<inl::gxeng::DirectionalLight>> m_directionalLights;
+	std::vector<std::unique_ptr<inl::gxeng::PointLight>> m_pointLights;
+
+	std::unique_ptr<inl::gxeng::Scene> m_guiScene;
+	std::unique_ptr<inl::gxeng::Camera2D> m_guiCamera;
+	std::unique_ptr<inl::gxeng::Mesh> m_quadMesh;
+	std::unique_ptr<inl::gxeng::Font> m_font;
+	std::vector<std::unique_ptr<inl::gxeng::OverlayEntity>> m_overlays;
+	std::vector<std::unique_ptr<inl::gxeng::TextEntity>> m_texts;
+};
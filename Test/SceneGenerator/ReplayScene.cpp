@@ -0,0 +1,187 @@
+#include "ReplayScene.hpp"
+
+#include <GraphicsEngine_LL/OrthographicCamera.hpp>
+#include <GraphicsEngine_LL/PerspectiveCamera.hpp>
+
+#include <BaseLibrary/Exception/Exception.hpp>
+#include <GraphicsEngine/Resources/Vertex.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+ReplayScene::ReplayScene(GraphicsEngine* graphicsEngine, const FrameCapture& capture)
+	: m_graphicsEngine(graphicsEngine), m_capture(capture) {
+	CreateMeshes();
+	CreateImages();
+	CreateMaterials();
+	CreateScenes();
+	CreateCameras();
+	SetEnvVariables();
+}
+
+
+void ReplayScene::CreateMeshes() {
+	using VertexT = Vertex<Position<0>, Normal<0>, TexCoord<0>>;
+
+	for (const FrameCapture::MeshDesc& desc : m_capture.meshes) {
+		if (desc.vertexCount == 0 || desc.lodIndexCounts.empty()) {
+			m_meshes.push_back(nullptr);
+			continue;
+		}
+
+		// Vertices fill the bounds evenly, each triangle joins neighbouring ones, so that the coverage is about right.
+		const BoundingBox& bounds = desc.localBounds;
+		const Vec3 extent = bounds.upper - bounds.lower;
+		std::vector<VertexT> vertices(desc.vertexCount);
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			const float t = float(i) / float(vertices.size());
+			const Vec3 offset = { std::fmod(float(i) * 0.618034f, 1.0f), std::fmod(float(i) * 0.754878f, 1.0f), t };
+			vertices[i].position = bounds.lower + offset * extent;
+			vertices[i].normal = { 0, 0, 1 };
+			vertices[i].texCoord = { offset.x, offset.y };
+		}
+
+		std::vector<std::vector<unsigned>> lodIndices;
+		for (uint32_t indexCount : desc.lodIndexCounts) {
+			std::vector<unsigned>& indices = lodIndices.emplace_back(indexCount);
+			for (uint32_t i = 0; i < indexCount; ++i) {
+				indices[i] = unsigned((i / 3 + i % 3) % vertices.size());
+			}
+		}
+
+		std::unique_ptr<Mesh> mesh(m_graphicsEngine->CreateMesh());
+		mesh->Set(vertices.data(), &vertices[0].GetReader(), vertices.size(), lodIndices);
+		m_meshes.push_back(std::move(mesh));
+	}
+}
+
+
+void ReplayScene::CreateImages() {
+	for (const FrameCapture::ImageDesc& desc : m_capture.images) {
+		std::unique_ptr<Image> image(m_graphicsEngine->CreateImage());
+		image->SetLayout(desc.width, desc.height, desc.channelType, desc.channelCount, desc.pixelClass, desc.mipLevels);
+		m_images.push_back(std::move(image));
+	}
+}
+
+
+void ReplayScene::CreateMaterials() {
+	for (const FrameCapture::MaterialShaderDesc& desc : m_capture.materialShaders) {
+		std::unique_ptr<MaterialShaderEquation> shader(m_graphicsEngine->CreateMaterialShaderEquation());
+		shader->SetSourceCode(desc.code);
+		m_materialShaders.push_back(std::move(shader));
+	}
+
+	for (const FrameCapture::MaterialDesc& desc : m_capture.materials) {
+		std::unique_ptr<Material> material(m_graphicsEngine->CreateMaterial());
+		if (desc.shader >= 0) {
+			material->SetShader(m_materialShaders[desc.shader].get());
+		}
+
+		// The shader comes from the captured code, so its parameters are those of the capture unless the code did not parse the same.
+		const size_t count = std::min(material->GetParameterCount(), desc.parameters.size());
+		for (size_t i = 0; i < count; ++i) {
+			const FrameCapture::ParameterDesc& parameterDesc = desc.parameters[i];
+			Material::Parameter& parameter = (*material)[i];
+			if (!parameterDesc.set || parameter.GetType() != parameterDesc.type) {
+				continue;
+			}
+			switch (parameterDesc.type) {
+				case eMaterialShaderParamType::COLOR: parameter = parameterDesc.color; break;
+				case eMaterialShaderParamType::VALUE: parameter = parameterDesc.value; break;
+				case eMaterialShaderParamType::BITMAP_COLOR_2D: [[fallthrough]];
+				case eMaterialShaderParamType::BITMAP_VALUE_2D:
+					if (parameterDesc.image >= 0) {
+						parameter = m_images[parameterDesc.image].get();
+					}
+					break;
+				default: break;
+			}
+		}
+		m_materials.push_back(std::move(material));
+	}
+}
+
+
+void ReplayScene::CreateScenes() {
+	for (const FrameCapture::SceneDesc& desc : m_capture.scenes) {
+		std::unique_ptr<Scene> scene(m_graphicsEngine->CreateScene(desc.name));
+
+		for (const FrameCapture::MeshEntityDesc& entityDesc : desc.meshEntities) {
+			if (entityDesc.mesh < 0 || !m_meshes[entityDesc.mesh]) {
+				continue; // The pipeline would not have drawn it either.
+			}
+			std::unique_ptr<MeshEntity> entity(m_graphicsEngine->CreateMeshEntity());
+			entity->SetMesh(m_meshes[entityDesc.mesh].get());
+			entity->SetMaterial(entityDesc.material >= 0 ? m_materials[entityDesc.material].get() : nullptr);
+			entity->SetTransform(entityDesc.transform);
+			entity->SetDynamic(entityDesc.dynamic);
+			entity->SetOccluderHint(entityDesc.occluderHint);
+			scene->GetEntities<MeshEntity>().Add(entity.get());
+			m_entities.push_back(std::move(entity));
+		}
+		for (const FrameCapture::DirectionalLightDesc& lightDesc : desc.directionalLights) {
+			auto light = std::make_unique<DirectionalLight>(lightDesc.direction, lightDesc.color);
+			scene->GetEntities<DirectionalLight>().Add(light.get());
+			m_directionalLights.push_back(std::move(light));
+		}
+		for (const FrameCapture::PointLightDesc& lightDesc : desc.pointLights) {
+			auto light = std::make_unique<PointLight>(lightDesc.position, lightDesc.color, lightDesc.range);
+			scene->GetEntities<PointLight>().Add(light.get());
+			m_pointLights.push_back(std::move(light));
+		}
+		for (const FrameCapture::SpotLightDesc& lightDesc : desc.spotLights) {
+			auto light = std::make_unique<SpotLight>(lightDesc.position, lightDesc.direction, lightDesc.color, lightDesc.range, lightDesc.innerAngle, lightDesc.outerAngle);
+			scene->GetEntities<SpotLight>().Add(light.get());
+			m_spotLights.push_back(std::move(light));
+		}
+		m_scenes.push_back(std::move(scene));
+	}
+}
+
+
+void ReplayScene::CreateCameras() {
+	for (const FrameCapture::CameraDesc& desc : m_capture.cameras) {
+		std::unique_ptr<BasicCamera> camera;
+		if (desc.perspective) {
+			std::unique_ptr<PerspectiveCamera> perspective(m_graphicsEngine->CreatePerspectiveCamera(desc.name));
+			perspective->SetFOVAxis(desc.fovHorizontal, desc.fovVertical);
+			camera = std::move(perspective);
+		}
+		else {
+			std::unique_ptr<OrthographicCamera> orthographic(m_graphicsEngine->CreateOrthographicCamera(desc.name));
+			orthographic->SetWidth(desc.width);
+			orthographic->SetHeight(desc.height);
+			camera = std::move(orthographic);
+		}
+		camera->SetTargeted(false);
+		camera->SetPosition(desc.position);
+		camera->SetLookDirection(desc.lookDirection);
+		camera->SetUpVector(desc.upVector);
+		camera->SetNearPlane(desc.nearPlane);
+		camera->SetFarPlane(desc.farPlane);
+		camera->SetFocus(desc.focus);
+		m_cameras.push_back(std::move(camera));
+	}
+}
+
+
+void ReplayScene::SetEnvVariables() {
+	for (const FrameCapture::EnvVariableDesc& desc : m_capture.envVariables) {
+		std::visit([this, &desc](const auto& value) {
+			using T = std::decay_t<decltype(value)>;
+			if constexpr (std::is_same_v<T, FrameCapture::ImageRef>) {
+				m_graphicsEngine->SetEnvVariable(desc.name, Any(value.image >= 0 ? m_images[value.image].get() : nullptr));
+			}
+			else {
+				m_graphicsEngine->SetEnvVariable(desc.name, Any(value));
+			}
+		},
+				   desc.value);
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <GraphicsEngine_LL/BasicCamera.hpp>
+#include <GraphicsEngine_LL/DirectionalLight.hpp>
+#include <GraphicsEngine_LL/FrameCapture.hpp>
+#include <GraphicsEngine_LL/GraphicsEngine.hpp>
+#include <GraphicsEngine_LL/Image.hpp>
+#include <GraphicsEngine_LL/Material.hpp>
+#include <GraphicsEngine_LL/MaterialShader.hpp>
+#include <GraphicsEngine_LL/Mesh.hpp>
+#include <GraphicsEngine_LL/MeshEntity.hpp>
+#include <GraphicsEngine_LL/PointLight.hpp>
+#include <GraphicsEngine_LL/Scene.hpp>
+#include <GraphicsEngine_LL/SpotLight.hpp>
+
+#include <memory>
+#include <vector>
+
+
+/// <summary>
+/// Recreates the scenes, cameras and env variables of a frame capture, so that the captured frame can be rendered again.
+/// </summary>
+/// <remarks> Scenes and cameras get their captured names, which the pipeline looks them up by.
+///		Meshes are stand-ins spread over the captured bounds with the same vertex and index counts for each level of detail,
+///		images have the captured size and format but undefined contents. Material shaders are compiled from the captured code.
+///		Load the capture's pipeline into the engine to replay the frame. </remarks>
+class ReplayScene {
+public:
+	ReplayScene(inl::gxeng::GraphicsEngine* graphicsEngine, const inl::gxeng::FrameCapture& capture);
+
+	const inl::gxeng::FrameCapture& GetCapture() const { return m_capture; }
+
+private:
+	void CreateMeshes();
+	void CreateImages();
+	void CreateMaterials();
+	void CreateScenes();
+	void CreateCameras();
+	void SetEnvVariables();
+
+private:
+	inl::gxeng::GraphicsEngine* m_graphicsEngine;
+	inl::gxeng::FrameCapture m_capture;
+
+	std::vector<std::unique_ptr<inl::gxeng::Mesh>> m_meshes; // Indexed by the capture's ids, null if the mesh was empty.
+	std::vector<std::unique_ptr<inl::gxeng::Image>> m_images;
+	std::vector<std::unique_ptr<inl::gxeng::MaterialShaderEquation>> m_materialShaders;
+	std::vector<std::unique_ptr<inl::gxeng::Material>> m_materials;
+
+	std::vector<std::unique_ptr<inl::gxeng::Scene>> m_scenes;
+	std::vector<std::unique_ptr<inl::gxeng::MeshEntity>> m_entities;
+	std::vector<std::unique_ptr<inl::gxeng::DirectionalLight>> m_directionalLights;
+	std::vector<std::unique_ptr<inl::gxeng::PointLight>> m_pointLights;
+	std::vector<std::unique_ptr<inl::gxeng::SpotLight>> m_spotLights;
+	std::vector<std::unique_ptr<inl::gxeng::BasicCamera>> m_cameras;
+};
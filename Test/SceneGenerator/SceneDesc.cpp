@@ -0,0 +1,87 @@
+#include "SceneDesc.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <utility>
+
+
+using namespace inl;
+
+
+static std::vector<std::pair<std::string, SceneDesc>> MakePresets() {
+	std::vector<std::pair<std::string, SceneDesc>> presets;
+
+	// What Benchmark_Pipeline has always rendered.
+	SceneDesc standard;
+	presets.push_back({ "default", standard });
+
+	// Many copies of a few meshes that never move: instancing, batching and culling.
+	SceneDesc staticProps;
+	staticProps.entities = 10000;
+	staticProps.instancedMeshes = 8;
+	staticProps.uniqueMeshes = 0;
+	staticProps.materials = 32;
+	staticProps.cameraPath = eCameraPath::FLYTHROUGH;
+	presets.push_back({ "10k-static-props", staticProps });
+
+	// Everything moves every frame and many meshes are unique: per frame uploads and bounds updates.
+	SceneDesc dynamic;
+	dynamic.entities = 1000;
+	dynamic.instancedMeshes = 4;
+	dynamic.uniqueMeshes = 200;
+	dynamic.materials = 16;
+	dynamic.pointLights = 32;
+	dynamic.dynamicRatio = 1.0f;
+	presets.push_back({ "1k-dynamic", dynamic });
+
+	// A light 3D scene under a GUI of many overlays and texts.
+	SceneDesc gui;
+	gui.entities = 100;
+	gui.materials = 4;
+	gui.texts = 500;
+	gui.overlays = 2000;
+	gui.cameraPath = eCameraPath::STATIC;
+	presets.push_back({ "gui-heavy", gui });
+
+	return presets;
+}
+
+
+static const std::vector<std::pair<std::string, SceneDesc>>& GetPresets() {
+	static const std::vector<std::pair<std::string, SceneDesc>> presets = MakePresets();
+	return presets;
+}
+
+
+SceneDesc GetScenePreset(std::string_view name) {
+	const auto& presets = GetPresets();
+	auto it = std::find_if(presets.begin(), presets.end(), [name](const auto& preset) { return preset.first == name; });
+	if (it == presets.end()) {
+		throw InvalidArgumentException("No scene preset of this name.", std::string(name));
+	}
+	return it->second;
+}
+
+
+std::vector<std::string> GetScenePresetNames() {
+	std::vector<std::string> names;
+	for (const auto& preset : GetPresets()) {
+		names.push_back(preset.first);
+	}
+	return names;
+}
+
+
+eCameraPath ParseCameraPath(std::string_view name) {
+	if (name == "orbit") {
+		return eCameraPath::ORBIT;
+	}
+	if (name == "flythrough") {
+		return eCameraPath::FLYTHROUGH;
+	}
+	if (name == "static") {
+		return eCameraPath::STATIC;
+	}
+	throw InvalidArgumentException("Camera path must be orbit, flythrough or static.", std::string(name));
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+enum class eCameraPath {
+	/// <summary> Circles the scene high above, looking at its center, sees most of it. </summary>
+	ORBIT,
+	/// <summary> Flies low between the props along a loop, looking ahead, the occlusion heavy case. </summary>
+	FLYTHROUGH,
+	/// <summary> Stays where the orbit starts. </summary>
+	STATIC,
+};
+
+
+/// <summary> Parameters of a <see cref="GeneratedScene"/>. The same description always gives the same scene. </summary>
+struct SceneDesc {
+	unsigned entities = 1000; // Mesh entities sharing the instanced meshes.
+	unsigned instancedMeshes = 1; // Meshes the entities above are spread over.
+	unsigned uniqueMeshes = 0; // Further mesh entities, each with a mesh of its own.
+	unsigned materials = 16;
+	unsigned directionalLights = 1;
+	unsigned pointLights = 0;
+	float dynamicRatio = 0.0f; // Part of the mesh entities that move every frame, the others never do.
+	unsigned texts = 0;
+	unsigned overlays = 0;
+	eCameraPath cameraPath = eCameraPath::ORBIT;
+	unsigned cameraPeriod = 600; // Frames until the camera path and the moving entities repeat.
+	uint32_t seed = 1;
+	unsigned width = 1280; // Gives the camera's aspect ratio and the extent of the GUI.
+	unsigned height = 720;
+	std::string fontFile = R"(C:\Windows\Fonts\calibri.ttf)"; // TrueType font of the texts, loaded only if there are texts.
+};
+
+
+/// <summary> The standard scenes that features are measured against, e.g. "10k-static-props", "1k-dynamic" or "gui-heavy". </summary>
+/// <exception cref="InvalidArgumentException"> If there is no preset of that name. </exception>
+SceneDesc GetScenePreset(std::string_view name);
+
+/// <summary> Names accepted by <see cref="GetScenePreset"/>. </summary>
+std::vector<std::string> GetScenePresetNames();
+
+/// <summary> Parses "orbit", "flythrough" or "static". </summary>
+/// <exception cref="InvalidArgumentException"> For anything else. </exception>
+eCameraPath ParseCameraPath(std::string_view name);
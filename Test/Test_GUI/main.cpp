@@ -1,4 +1,5 @@
 #include <AssetLibrary/AssetStore.hpp>
+#include <BaseLibrary/JobSystem/InitGraph.hpp>
 #include <BaseLibrary/Logging_All.hpp>
 #include <BaseLibrary/Platform/Window.hpp>
 #include <BaseLibrary/Timer.hpp>
@@ -85,21 +86,37 @@ int main() {
 		graphicsEngineDesc.targetWindow = window.GetNativeHandle();
 		std::unique_ptr<gxeng::GraphicsEngine> graphicsEngine(new gxeng::GraphicsEngine(graphicsEngineDesc));
 
-		// Load graphics pipeline.
-		std::ifstream pipelineFile(INL_GAMEDATA R"(\Pipelines\new_forward_with_gui.json)");
-		if (!pipelineFile.is_open()) {
-			throw FileNotFoundException("Failed to open pipeline JSON.");
-		}
-		std::string pipelineDesc((std::istreambuf_iterator<char>(pipelineFile)), std::istreambuf_iterator<char>());
-		graphicsEngine->LoadPipeline(pipelineDesc);
-		graphicsEngine->SetShaderDirectories({ INL_NODE_SHADER_DIRECTORY, INL_MTL_SHADER_DIRECTORY, "./Shaders", "./Materials" });
-
-		// Create physics engine.
-		std::unique_ptr<pxeng_bl::PhysicsEngine> physicsEngine(new pxeng_bl::PhysicsEngine());
+		// Load the pipeline, physics and scene, overlapping file reads with the thread-bound parts.
+		std::string pipelineDesc;
+		std::unique_ptr<pxeng_bl::PhysicsEngine> physicsEngine;
+		std::unique_ptr<GameScene> gameScene;
 
+		jobs::InitGraph startup;
+		const auto readPipeline = startup.Add("Read pipeline", [&pipelineDesc] {
+			std::ifstream pipelineFile(INL_GAMEDATA R"(\Pipelines\new_forward_with_gui.json)");
+			if (!pipelineFile.is_open()) {
+				throw FileNotFoundException("Failed to open pipeline JSON.");
+			}
+			pipelineDesc.assign((std::istreambuf_iterator<char>(pipelineFile)), std::istreambuf_iterator<char>());
+		});
+		startup.Add("Create physics engine", [&physicsEngine] {
+			physicsEngine.reset(new pxeng_bl::PhysicsEngine());
+		});
+		startup.AddOnCaller("Load pipeline", [&] {
+			graphicsEngine->LoadPipeline(pipelineDesc);
+			graphicsEngine->SetShaderDirectories({ INL_NODE_SHADER_DIRECTORY, INL_MTL_SHADER_DIRECTORY, "./Shaders", "./Materials" });
+		}, { readPipeline });
 		// Create scene and camera.
-		GameScene gameScene(graphicsEngine.get(), &window);
-		gameScene.LoadAssets();
+		const auto createScene = startup.AddOnCaller("Create scene", [&] {
+			gameScene = std::make_unique<GameScene>(graphicsEngine.get(), &window);
+		});
+		startup.AddOnCaller("Load assets", [&gameScene] {
+			gameScene->LoadAssets();
+		}, { createScene });
+
+		startup.Start(graphicsEngine->GetJobScheduler());
+		startup.Wait();
+		startup.WriteReport(std::cout);
 
 		// Game loop.
 		Timer timer;
@@ -110,7 +127,7 @@ int main() {
 			float elapsed = timer.Elapsed();
 			timer.Reset();
 			window.CallEvents();
-			gameScene.Update(elapsed);
+			gameScene->Update(elapsed);
 
 			++numFrames;
 			totalElapsed += elapsed;
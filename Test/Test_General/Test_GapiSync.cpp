@@ -1,5 +1,6 @@
 #include "Test.hpp"
 #include <thread>
+#include <future>
 #include <iostream>
 #include "GraphicsApi_D3D12/GxapiManager.hpp"
 #include "GraphicsApi_LL/IGraphicsApi.hpp"
@@ -57,5 +58,11 @@ int TestGapiSync::Run() {
 
 	th.join();	
 
+	std::promise<uint64_t> completed;
+	fence->OnCompletion(4, [&] { completed.set_value(fence->Fetch()); });
+	cout << "Signaling fence with 4." << endl;
+	fence->Signal(4);
+	cout << "[watcher] Fence reached: " << completed.get_future().get() << endl;
+
 	return 0;
 }
\ No newline at end of file
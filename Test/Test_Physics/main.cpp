@@ -139,7 +139,7 @@ inline GameScene::GameScene(gxeng::GraphicsEngine * graphicsEngine, pxeng_bl::Ph
 	m_camera.reset(m_graphicsEngine->CreatePerspectiveCamera("MainCamera"));
 	m_light.reset(new gxeng::DirectionalLight());
 
-	m_pxScene.reset(m_physicsEngine->CreateScene());
+	m_pxScene.reset(m_physicsEngine->CreateScene(&m_graphicsEngine->GetJobScheduler()));
 	m_pxScene->SetGravity({ 0,0,-9.81f });
 
 	m_light->SetDirection(Vec3{ -1, -2, -3 }.Normalized());
@@ -187,10 +187,10 @@ std::unique_ptr<gxeng::MeshEntity> GameScene::CreateGraphicsEntity(std::string_v
 std::unique_ptr<pxeng_bl::RigidBody> GameScene::CreatePhysicsEntity(std::string_view mesh){
 	std::unique_ptr<pxeng_bl::RigidBody> entity(m_physicsEngine->CreateRigidBody());
 
-	auto meshResource = m_assetStore.LoadPhysicsMesh(mesh, true);
+	auto meshResource = m_assetStore.LoadPhysicsMesh(mesh, false);
 
 	entity->SetShape(meshResource.get());
-	entity->SetDynamic(true);
+	entity->SetDynamic(false);
 
 	return entity;
 }
@@ -0,0 +1,90 @@
+#include <BaseLibrary/Serialization/BinaryStream.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <cstring>
+#include <sstream>
+
+using namespace inl;
+
+
+TEST_CASE("BinaryStream - Values", "[BinaryStream]") {
+	std::stringstream stream;
+	BinaryStreamWriter writer(stream);
+	writer.WriteVarint(0);
+	writer.WriteVarint(127);
+	writer.WriteVarint(128);
+	writer.WriteVarint(UINT64_MAX);
+	writer.WriteVarintSigned(-1);
+	writer.WriteVarintSigned(INT64_MIN);
+	writer.WriteBool(true);
+	writer.WriteFloat(1.5f);
+	writer.WriteDouble(-2.25);
+	writer.WriteString("text");
+	REQUIRE(writer.GetPosition() == 1 + 1 + 2 + 10 + 1 + 10 + 1 + 4 + 8 + 5);
+
+	std::string data = stream.str();
+	BinaryStreamReader reader(data.data(), data.size());
+	REQUIRE(reader.ReadVarint() == 0);
+	REQUIRE(reader.ReadVarint() == 127);
+	REQUIRE(reader.ReadVarint() == 128);
+	REQUIRE(reader.ReadVarint() == UINT64_MAX);
+	REQUIRE(reader.ReadVarintSigned() == -1);
+	REQUIRE(reader.ReadVarintSigned() == INT64_MIN);
+	REQUIRE(reader.ReadBool() == true);
+	REQUIRE(reader.ReadFloat() == 1.5f);
+	REQUIRE(reader.ReadDouble() == -2.25);
+	REQUIRE(reader.ReadString() == "text");
+	REQUIRE(reader.IsEnd());
+	REQUIRE_THROWS_AS(reader.ReadVarint(), OutOfRangeException);
+}
+
+
+TEST_CASE("BinaryStream - Chunks are skipped", "[BinaryStream]") {
+	std::stringstream stream;
+	BinaryStreamWriter writer(stream);
+	writer.BeginChunk(1);
+	writer.WriteString("unknown to the reader");
+	writer.BeginChunk(2);
+	writer.WriteVarint(5);
+	writer.EndChunk();
+	writer.EndChunk();
+	writer.BeginChunk(3);
+	writer.WriteVarint(42);
+	writer.EndChunk();
+	REQUIRE_THROWS_AS(writer.EndChunk(), InvalidCallException);
+
+	BinaryStreamReader reader(stream);
+	REQUIRE(reader.SkipChunk().tag == 1);
+	auto chunk = reader.BeginChunk();
+	REQUIRE(chunk.tag == 3);
+	REQUIRE(reader.ReadVarint() == 42);
+	REQUIRE(reader.IsEnd());
+	REQUIRE_THROWS_AS(reader.ReadVarint(), OutOfRangeException);
+	reader.EndChunk();
+}
+
+
+TEST_CASE("BinaryStream - Arrays", "[BinaryStream]") {
+	const std::vector<double> values = { 1.0, 2.0, 3.0 };
+	std::stringstream stream;
+	BinaryStreamWriter writer(stream);
+	writer.WriteBool(false); // Forces padding before the array.
+	writer.WriteArray(values.data(), values.size());
+
+	std::string data = stream.str();
+	std::vector<double> aligned((data.size() + sizeof(double) - 1) / sizeof(double));
+	std::memcpy(aligned.data(), data.data(), data.size());
+
+	BinaryStreamReader reader(aligned.data(), data.size());
+	reader.ReadBool();
+	ArrayView<const double> view = reader.ReadArrayView<double>();
+	REQUIRE(view.Size() == 3);
+	REQUIRE(view[2] == 3.0);
+	REQUIRE(reinterpret_cast<const std::byte*>(&view[0]) == reinterpret_cast<const std::byte*>(aligned.data()) + 8);
+
+	BinaryStreamReader streamReader(stream);
+	streamReader.ReadBool();
+	REQUIRE(streamReader.ReadArray<double>() == values);
+	REQUIRE_THROWS_AS(streamReader.ReadArrayView<double>(), InvalidCallException);
+}
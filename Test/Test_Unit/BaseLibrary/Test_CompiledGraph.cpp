@@ -0,0 +1,69 @@
+#include <BaseLibrary/Graph/CompiledGraph.hpp>
+#include <BaseLibrary/Graph/Node_Arithmetic.hpp>
+#include <BaseLibrary/Graph/Node_Logic.hpp>
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+
+using namespace inl;
+
+
+// (a + b) * c
+struct TestNetwork {
+	TestNetwork() {
+		add.GetInput<0>().Set(1.0f);
+		add.GetInput<1>().Set(2.0f);
+		multiply.GetInput<1>().Set(3.0f);
+		add.GetOutput<0>().Link(&multiply.GetInput<0>());
+	}
+
+	FloatAdd add;
+	FloatMultiply multiply;
+};
+
+
+TEST_CASE("Compiled graph - Evaluates in link order", "[CompiledGraph]") {
+	TestNetwork network;
+	// Listed in the wrong order on purpose.
+	CompiledGraph graph({ &network.multiply, &network.add });
+
+	REQUIRE(graph.GetNumNodes() == 2);
+	REQUIRE(graph.GetNumLevels() == 2);
+
+	auto state = graph.CreateState();
+	graph.Execute(state);
+	REQUIRE(graph.GetOutput<float>(state, &network.add, 0) == 3.0f);
+	REQUIRE(graph.GetOutput<float>(state, &network.multiply, 0) == 9.0f);
+}
+
+
+TEST_CASE("Compiled graph - Instances keep their own values", "[CompiledGraph]") {
+	TestNetwork network;
+	CompiledGraph graph({ &network.add, &network.multiply });
+
+	std::vector<std::vector<std::byte>> states;
+	for (int i = 0; i < 100; ++i) {
+		states.push_back(graph.CreateState());
+		graph.SetInput(states.back(), &network.add, 1, float(i));
+	}
+	graph.Execute(states.data(), states.size());
+
+	for (int i = 0; i < 100; ++i) {
+		REQUIRE(graph.GetOutput<float>(states[i], &network.multiply, 0) == (1.0f + i) * 3.0f);
+	}
+	REQUIRE_THROWS_AS(graph.SetInput(states[0], &network.multiply, 0, 1.0f), InvalidArgumentException);
+	REQUIRE_THROWS_AS(graph.SetInput(states[0], &network.add, 0, 1), InvalidArgumentException);
+}
+
+
+TEST_CASE("Compiled graph - Rejects what it cannot compile", "[CompiledGraph]") {
+	FloatAdd first;
+	FloatAdd second;
+	first.GetOutput<0>().Link(&second.GetInput<0>());
+	second.GetOutput<0>().Link(&first.GetInput<0>());
+	REQUIRE_THROWS_AS(CompiledGraph({ &first, &second }), InvalidArgumentException);
+
+	LogicAny logic;
+	REQUIRE_THROWS_AS(CompiledGraph({ &logic }), InvalidArgumentException);
+}
@@ -0,0 +1,105 @@
+#include <BaseLibrary/Memory/ConcurrentSlabAllocatorEngine.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+
+using namespace inl;
+
+
+TEST_CASE("ConcurrentSlab - Allocate until full", "[ConcurrentSlab]") {
+	ConcurrentSlabAllocatorEngine engine(70);
+	std::set<size_t> indices;
+	size_t index;
+	while (engine.TryAllocate(index)) {
+		REQUIRE(indices.insert(index).second);
+	}
+	REQUIRE(indices.size() == 70);
+	REQUIRE(*indices.rbegin() == 69);
+	REQUIRE_THROWS_AS(engine.Allocate(), std::bad_alloc);
+
+	engine.Grow(130);
+	while (engine.TryAllocate(index)) {
+		REQUIRE(indices.insert(index).second);
+	}
+	REQUIRE(indices.size() == 130);
+
+	engine.Deallocate(42);
+	REQUIRE(engine.Allocate() == 42);
+}
+
+
+TEST_CASE("ConcurrentSlab - Allocate many at once", "[ConcurrentSlab]") {
+	ConcurrentSlabAllocatorEngine engine(150);
+	engine.Deallocate(engine.Allocate());
+
+	std::vector<size_t> batch(100);
+	REQUIRE(engine.TryAllocate(batch.data(), batch.size()) == 100);
+	std::set<size_t> indices(batch.begin(), batch.end());
+	REQUIRE(indices.size() == 100);
+	REQUIRE(*indices.rbegin() < 150);
+
+	// Only 50 are left.
+	REQUIRE(engine.TryAllocate(batch.data(), batch.size()) == 50);
+	indices.insert(batch.begin(), batch.begin() + 50);
+	REQUIRE(indices.size() == 150);
+	REQUIRE(engine.TryAllocate(batch.data(), batch.size()) == 0);
+
+	engine.Deallocate(7);
+	engine.Deallocate(99);
+	REQUIRE(engine.TryAllocate(batch.data(), batch.size()) == 2);
+	REQUIRE(std::set<size_t>(batch.begin(), batch.begin() + 2) == std::set<size_t>{ 7, 99 });
+}
+
+
+TEST_CASE("ConcurrentSlab - Reset", "[ConcurrentSlab]") {
+	ConcurrentSlabAllocatorEngine engine(10);
+	for (int i = 0; i < 10; ++i) {
+		engine.Allocate();
+	}
+	engine.Reset();
+	REQUIRE(engine.Size() == 10);
+	REQUIRE(engine.Allocate() == 0);
+}
+
+
+TEST_CASE("ConcurrentSlab - Threads never share a slot", "[ConcurrentSlab]") {
+	constexpr size_t MaxSlots = 8 * 256;
+	ConcurrentSlabAllocatorEngine engine(16);
+	std::vector<std::atomic_int> owners(MaxSlots);
+	std::atomic_bool conflict = false;
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 8; ++t) {
+		threads.emplace_back([&] {
+			std::vector<size_t> mine;
+			for (int i = 0; i < 20000; ++i) {
+				if (mine.size() < 256 && i % 3 != 0) {
+					size_t index;
+					while (!engine.TryAllocate(index)) {
+						engine.Grow(engine.Size() + 16);
+					}
+					if (index >= MaxSlots || owners[index].exchange(1) != 0) {
+						conflict = true;
+						return;
+					}
+					mine.push_back(index);
+				}
+				else if (!mine.empty()) {
+					owners[mine.back()] = 0;
+					engine.Deallocate(mine.back());
+					mine.pop_back();
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	REQUIRE(!conflict);
+}
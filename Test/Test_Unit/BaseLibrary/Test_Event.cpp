@@ -57,4 +57,21 @@ TEST_CASE("Copy and fire", "[Event]") {
 	evt2(value);
 
 	REQUIRE(value == 2);
-}
\ No newline at end of file
+}
+TEST_CASE("Change while firing", "[Event]") {
+	int value = 0;
+	Incrementer inc;
+
+	Event<int&> evt;
+	evt += [&evt, &inc](int& value) {
+		evt -= Delegate<void(int&)>{ &Incrementer::operator(), &inc };
+		++value;
+	};
+	evt += Delegate<void(int&)>{&Incrementer::operator(), &inc};
+
+	// The removal only affects the next firing.
+	evt(value);
+	REQUIRE(value == 2);
+	evt(value);
+	REQUIRE(value == 3);
+}
@@ -0,0 +1,49 @@
+#include <BaseLibrary/Memory/FifoRingAllocationEngine.hpp>
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+
+using namespace inl;
+
+
+TEST_CASE("FifoRing - Fill and free in order", "[FifoRing]") {
+	FifoRingAllocationEngine engine(10);
+	REQUIRE(engine.Allocate(4) == 0);
+	REQUIRE(engine.Allocate(4) == 4);
+	REQUIRE_THROWS_AS(engine.Allocate(3), std::bad_alloc);
+	REQUIRE(engine.Allocate(2) == 8);
+	REQUIRE(engine.Used() == 10);
+
+	engine.Deallocate(0);
+	REQUIRE(engine.Allocate(3) == 0);
+	REQUIRE_THROWS_AS(engine.Allocate(2), std::bad_alloc);
+}
+
+
+TEST_CASE("FifoRing - Wrap around accounts skipped slots", "[FifoRing]") {
+	FifoRingAllocationEngine engine(10);
+	engine.Allocate(6);
+	engine.Allocate(2);
+	engine.DeallocateOldest();
+
+	// 2 slots left at the end, so this one wraps to the beginning.
+	REQUIRE(engine.Allocate(5) == 0);
+	REQUIRE(engine.Used() == 2 + 2 + 5);
+
+	// Skipped slots are only released together with the wrapped allocation.
+	engine.DeallocateOldest();
+	REQUIRE(engine.Used() == 2 + 5);
+	engine.DeallocateOldest();
+	REQUIRE(engine.Used() == 0);
+	REQUIRE(engine.Allocate(10) == 0);
+}
+
+
+TEST_CASE("FifoRing - Out of order free is rejected", "[FifoRing]") {
+	FifoRingAllocationEngine engine(10);
+	engine.Allocate(2);
+	size_t second = engine.Allocate(2);
+	REQUIRE_THROWS_AS(engine.Deallocate(second), InvalidArgumentException);
+	REQUIRE_THROWS_AS(engine.Allocate(0), InvalidArgumentException);
+}
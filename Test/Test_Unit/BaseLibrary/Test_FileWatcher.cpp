@@ -0,0 +1,73 @@
+#include <BaseLibrary/FileWatcher.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+using namespace inl;
+
+
+static void WriteFile(const std::filesystem::path& path, const char* contents) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file << contents;
+}
+
+
+TEST_CASE("FileWatcher - Changes", "[FileWatcher]") {
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "InlineFileWatcherTest";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory / "nested");
+	WriteFile(directory / "kept.txt", "kept");
+	WriteFile(directory / "modified.txt", "before");
+	WriteFile(directory / "deleted.txt", "deleted");
+
+	FileWatcher watcher;
+	watcher.AddDirectory(directory);
+	watcher.AddDirectory(directory / "nested");
+	REQUIRE(watcher.Poll().empty());
+
+	WriteFile(directory / "modified.txt", "after the change");
+	std::filesystem::remove(directory / "deleted.txt");
+	WriteFile(directory / "nested" / "created.txt", "created");
+
+	std::vector<std::filesystem::path> changed = watcher.Poll();
+	std::vector<std::filesystem::path> expected = {
+		std::filesystem::absolute(directory / "deleted.txt").lexically_normal(),
+		std::filesystem::absolute(directory / "modified.txt").lexically_normal(),
+		std::filesystem::absolute(directory / "nested" / "created.txt").lexically_normal(),
+	};
+	std::sort(expected.begin(), expected.end());
+	REQUIRE(changed == expected);
+	REQUIRE(watcher.Poll().empty());
+
+	// Same size, only the write time differs.
+	std::filesystem::last_write_time(directory / "kept.txt", std::filesystem::last_write_time(directory / "kept.txt") + std::chrono::seconds(2));
+	REQUIRE(watcher.Poll().size() == 1);
+
+	watcher.RemoveDirectory(directory);
+	watcher.RemoveDirectory(directory / "nested");
+	WriteFile(directory / "modified.txt", "ignored");
+	REQUIRE(watcher.Poll().empty());
+
+	std::filesystem::remove_all(directory);
+}
+
+
+TEST_CASE("FileWatcher - Missing directory", "[FileWatcher]") {
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "InlineFileWatcherMissing";
+	std::filesystem::remove_all(directory);
+
+	FileWatcher watcher;
+	watcher.AddDirectory(directory);
+	REQUIRE(watcher.Poll().empty());
+
+	std::filesystem::create_directories(directory);
+	WriteFile(directory / "appeared.txt", "appeared");
+	REQUIRE(watcher.Poll().size() == 1);
+
+	std::filesystem::remove_all(directory);
+	REQUIRE(watcher.Poll().size() == 1);
+}
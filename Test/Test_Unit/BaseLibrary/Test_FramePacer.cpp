@@ -0,0 +1,34 @@
+#include <BaseLibrary/FramePacer.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl;
+
+
+TEST_CASE("Frames last the target frame time", "[FramePacer]") {
+	FramePacer pacer;
+	pacer.SetTargetFrameTime(0.005);
+	pacer.Reset();
+
+	constexpr int numFrames = 40;
+	double total = 0.0;
+	for (int i = 0; i < numFrames; ++i) {
+		total += pacer.Wait();
+	}
+
+	REQUIRE(total >= numFrames * 0.005 * 0.95);
+	REQUIRE(total <= numFrames * 0.005 * 1.5);
+}
+
+
+TEST_CASE("Pacing is off without a target", "[FramePacer]") {
+	FramePacer pacer;
+	pacer.SetTargetFrameRate(0.0);
+	REQUIRE(pacer.GetTargetFrameTime() == 0.0);
+
+	double total = 0.0;
+	for (int i = 0; i < 100; ++i) {
+		total += pacer.Wait();
+	}
+	REQUIRE(total < 0.1);
+}
@@ -0,0 +1,99 @@
+#include <BaseLibrary/FrameProfiler.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <sstream>
+#include <thread>
+
+
+using namespace inl;
+
+
+TEST_CASE("FrameProfiler - Nested zones", "[FrameProfiler]") {
+	FrameProfiler profiler;
+
+	profiler.BeginFrame(7);
+	{
+		ProfileScope outer("Outer", profiler);
+		{
+			ProfileScope inner("Inner", profiler);
+		}
+	}
+	std::thread([&profiler] {
+		ProfileScope worker("Worker", profiler);
+	}).join();
+	profiler.EndFrame();
+
+	ProfiledFrame frame = profiler.GetLastFrame();
+	REQUIRE(frame.index == 7);
+	REQUIRE(frame.zones.size() == 3);
+	REQUIRE(frame.zones[0].name == std::string("Outer"));
+	REQUIRE(frame.zones[0].depth == 0);
+	REQUIRE(frame.zones[1].name == std::string("Inner"));
+	REQUIRE(frame.zones[1].depth == 1);
+	REQUIRE(frame.zones[0].begin <= frame.zones[1].begin);
+	REQUIRE(frame.zones[1].end <= frame.zones[0].end);
+	REQUIRE(frame.zones[2].name == std::string("Worker"));
+	REQUIRE(frame.zones[2].depth == 0);
+	REQUIRE(frame.zones[2].thread != frame.zones[0].thread);
+	REQUIRE(profiler.GetThreadNames().size() == 2);
+}
+
+
+TEST_CASE("FrameProfiler - History", "[FrameProfiler]") {
+	FrameProfiler profiler;
+	for (uint64_t i = 0; i < FrameProfiler::HistoryLength + 5; ++i) {
+		profiler.BeginFrame(i);
+		ProfileScope zone(profiler.Intern("Frame " + std::to_string(i)), profiler);
+		profiler.EndFrame(); // The zone is still open, it goes to the next frame.
+	}
+	auto history = profiler.GetHistory();
+	REQUIRE(history.size() == FrameProfiler::HistoryLength);
+	REQUIRE(history.front().index == 5);
+	REQUIRE(history.back().index == FrameProfiler::HistoryLength + 4);
+	REQUIRE(history.back().zones.size() == 1);
+
+	profiler.SetEnabled(false);
+	profiler.BeginFrame(0);
+	{
+		ProfileScope zone("Disabled", profiler);
+	}
+	profiler.EndFrame();
+	REQUIRE(profiler.GetLastFrame().zones.size() == 1); // Only the last zone of the previous loop.
+}
+
+
+TEST_CASE("FrameProfiler - Chrome trace", "[FrameProfiler]") {
+	ProfiledFrame frame;
+	frame.zones.push_back({ "Quote\"d", 0, 0, 0.001, 0.003 });
+
+	std::stringstream ss;
+	FrameProfiler::ExportChromeTrace(ss, { frame }, { "Main" });
+	std::string trace = ss.str();
+	REQUIRE(trace.find("\"traceEvents\"") != std::string::npos);
+	REQUIRE(trace.find(R"("name":"thread_name","ph":"M","pid":0,"tid":0,"args":{"name":"Main"})") != std::string::npos);
+	REQUIRE(trace.find(R"("name":"Quote\"d","ph":"X","pid":0,"tid":0,"ts":1000,"dur":2000)") != std::string::npos);
+}
+
+
+TEST_CASE("FrameProfiler - Counters", "[FrameProfiler]") {
+	FrameProfiler profiler;
+	profiler.BeginFrame(0);
+	profiler.RecordCounter("Bodies", 3);
+	std::thread([&profiler] {
+		profiler.RecordCounter("Pairs", 12);
+	}).join();
+	profiler.EndFrame();
+
+	ProfiledFrame frame = profiler.GetLastFrame();
+	REQUIRE(frame.counters.size() == 2);
+	REQUIRE(frame.counters[0].name == std::string("Bodies"));
+	REQUIRE(frame.counters[0].value == 3);
+	REQUIRE(frame.counters[1].name == std::string("Pairs"));
+	REQUIRE(frame.counters[0].time <= frame.counters[1].time);
+
+	std::stringstream ss;
+	FrameProfiler::ExportChromeTrace(ss, { frame }, profiler.GetThreadNames());
+	REQUIRE(ss.str().find(R"("name":"Pairs","ph":"C","pid":0,)") != std::string::npos);
+	REQUIRE(ss.str().find(R"("args":{"value":12})") != std::string::npos);
+}
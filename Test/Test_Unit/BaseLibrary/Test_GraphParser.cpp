@@ -0,0 +1,88 @@
+#include <BaseLibrary/GraphEditor/GraphParser.hpp>
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+
+using namespace inl;
+
+
+static const char* TestGraph = R"(
+{
+	"header": { "contentType": "pipeline" },
+	"nodes": [
+		{ "class": "A", "name": "first" },
+		{ "class": "B", "id": 7 },
+		{ "class": "C", "name": "last", "inputs": [ "1", {} ] }
+	],
+	"links": [
+		{ "src": "first", "srcp": 0, "dst": 7, "dstp": 0 },
+		{ "src": 7, "srcp": 0, "dst": "last", "dstp": 1 }
+	]
+}
+)";
+
+
+TEST_CASE("Add node updates lookups", "[GraphParser]") {
+	GraphParser parser;
+	parser.Parse(TestGraph);
+
+	NodeDescription node;
+	node.cl = "D";
+	node.name = "added";
+	size_t index = parser.AddNode(node);
+
+	REQUIRE(index == 3);
+	REQUIRE(parser.FindNode(std::string("added")) == 3);
+	REQUIRE_THROWS_AS(parser.AddNode(node), InvalidArgumentException);
+}
+
+
+TEST_CASE("Remove node drops its links and shifts lookups", "[GraphParser]") {
+	GraphParser parser;
+	parser.Parse(TestGraph);
+
+	parser.RemoveNode(0);
+
+	REQUIRE(parser.GetNodes().size() == 2);
+	REQUIRE(parser.GetLinks().size() == 1);
+	REQUIRE(parser.FindNode(7) == 0);
+	REQUIRE(parser.FindNode(std::string("last")) == 1);
+	REQUIRE_THROWS_AS(parser.FindNode(std::string("first")), OutOfRangeException);
+}
+
+
+TEST_CASE("Edits round trip through serialization", "[GraphParser]") {
+	GraphParser parser;
+	parser.Parse(TestGraph);
+
+	parser.SetDefaultInput(parser.FindNode(7), 2, std::string("3.5"));
+	LinkDescription link;
+	link.srcname = "first";
+	link.srcpidx = 1;
+	link.dstname = "last";
+	link.dstpidx = 0;
+	parser.AddLink(link);
+
+	GraphParser reparsed;
+	reparsed.Parse(parser.Serialize());
+
+	const auto& node = reparsed.GetNodes()[reparsed.FindNode(7)];
+	REQUIRE(node.defaultInputs.size() == 3);
+	REQUIRE(node.defaultInputs[2] == std::string("3.5"));
+	REQUIRE(reparsed.GetLinks().size() == 3);
+}
+
+
+TEST_CASE("Link to missing node is rejected", "[GraphParser]") {
+	GraphParser parser;
+	parser.Parse(TestGraph);
+
+	LinkDescription link;
+	link.srcname = "missing";
+	link.srcpidx = 0;
+	link.dstid = 7;
+	link.dstpidx = 0;
+	REQUIRE_THROWS_AS(parser.AddLink(link), OutOfRangeException);
+	REQUIRE(parser.GetLinks().size() == 2);
+}
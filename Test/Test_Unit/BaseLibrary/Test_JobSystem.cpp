@@ -1,12 +1,19 @@
 #include <BaseLibrary/JobSystem/Future.hpp>
+#include <BaseLibrary/JobSystem/InitGraph.hpp>
 #include <BaseLibrary/JobSystem/Scheduler.hpp>
 #include <BaseLibrary/JobSystem/Mutex.hpp>
 #include <BaseLibrary/JobSystem/ConditionVariable.hpp>
 #include <BaseLibrary/JobSystem/ThreadpoolScheduler.hpp>
 #include <BaseLibrary/JobSystem/Wait.hpp>
+#include <BaseLibrary/JobSystem/Parallel.hpp>
+#include <BaseLibrary/JobSystem/Tracer.hpp>
 
 #include <Catch2/catch.hpp>
 
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
 
 using namespace inl::jobs;
 using std::cout;
@@ -54,6 +61,48 @@ TEST_CASE("JobSystem - Future nested await", "[JobSystem]") {
 }
 
 
+TEST_CASE("JobSystem - Work stealing nested await", "[JobSystem]") {
+	ThreadpoolScheduler scheduler(4, eQueueMode::WORK_STEALING);
+	std::vector<Future<int>> futures;
+	for (int i = 0; i < 64; ++i) {
+		futures.push_back(scheduler.Enqueue(AddJob, i, 1));
+	}
+
+	for (int i = 0; i < 64; ++i) {
+		REQUIRE(futures[i].get() == i + 1);
+	}
+}
+
+
+TEST_CASE("JobSystem - Priority and affinity", "[JobSystem]") {
+	ThreadpoolScheduler scheduler(4, eQueueMode::WORK_STEALING);
+	std::atomic_int counter = 0;
+
+	auto func = [&counter](int value) -> Future<int> {
+		++counter;
+		co_return value;
+	};
+
+	JobOptions critical;
+	critical.priority = eJobPriority::CRITICAL;
+	JobOptions background;
+	background.priority = eJobPriority::BACKGROUND;
+	JobOptions pinned;
+	pinned.affinityMask = 0b0010;
+
+	Future<int> fut1 = scheduler.Enqueue(critical, func, 1);
+	Future<int> fut2 = scheduler.Enqueue(background, func, 2);
+	Future<int> fut3 = scheduler.Enqueue(pinned, func, 3);
+	Future<int> fut4 = scheduler.Enqueue(pinned, AddJob, 2, 2);
+
+	REQUIRE(fut1.get() == 1);
+	REQUIRE(fut2.get() == 2);
+	REQUIRE(fut3.get() == 3);
+	REQUIRE(fut4.get() == 4);
+	REQUIRE(counter == 3);
+}
+
+
 TEST_CASE("JobSystem - Promise explicit", "[JobSystem]") {
 	return;
 	ThreadpoolScheduler scheduler(1);
@@ -182,6 +231,34 @@ TEST_CASE("JobSystem - Mutex", "[JobSystem]") {
 }
 
 
+TEST_CASE("JobSystem - Adaptive mutex", "[JobSystem]") {
+	ThreadpoolScheduler scheduler(4);
+	Mutex mutex(eMutexMode::ADAPTIVE);
+	int counter = 0;
+
+	auto func = [&mutex, &counter]() -> Future<void> {
+		for (int i = 0; i < 1000; ++i) {
+			co_await mutex.Lock();
+			++counter;
+			mutex.Unlock();
+		}
+	};
+
+	std::vector<Future<void>> futures;
+	for (int i = 0; i < 8; ++i) {
+		futures.push_back(scheduler.Enqueue(func));
+	}
+	for (auto& fut : futures) {
+		fut.get();
+	}
+
+	REQUIRE(counter == 8000);
+	MutexStatistics statistics = mutex.GetStatistics();
+	REQUIRE(statistics.numLocks == 8000);
+	REQUIRE(statistics.numSpinAcquired + statistics.numSuspended <= statistics.numContended);
+}
+
+
 TEST_CASE("JobSystem - Condvar notify one", "[JobSystem]") {
 	ThreadpoolScheduler scheduler(3);
 	Mutex mutex;
@@ -344,4 +421,215 @@ TEST_CASE("JobSystem - WaitAny", "[JobSystem]") {
 	fut1.get();
 	fut2.get();
 	fut3.get();
-}
\ No newline at end of file
+}
+
+
+TEST_CASE("JobSystem - WhenAll", "[JobSystem]") {
+	ThreadpoolScheduler scheduler(4);
+	Fence release;
+	std::atomic_int numDone = 0;
+	bool allDoneOnResume = false;
+
+	auto child = [&release, &numDone](int i) -> Future<int> {
+		co_await release.Wait(1);
+		++numDone;
+		co_return i;
+	};
+	auto parent = [&]() -> Future<int> {
+		std::vector<Future<int>> children;
+		for (int i = 0; i < 16; ++i) {
+			children.push_back(scheduler.Enqueue(child, i));
+		}
+		release.Signal(1);
+		co_await WhenAll(children);
+		allDoneOnResume = numDone == 16;
+
+		int sum = 0;
+		for (auto& fut : children) {
+			sum += co_await fut;
+		}
+		co_return sum;
+	};
+
+	REQUIRE(scheduler.Enqueue(parent).get() == 120);
+	REQUIRE(allDoneOnResume);
+}
+
+
+TEST_CASE("JobSystem - WhenAny", "[JobSystem]") {
+	ThreadpoolScheduler scheduler(4);
+	Fence slow;
+
+	auto child = [&slow](bool isSlow) -> Future<void> {
+		if (isSlow) {
+			co_await slow.Wait(1);
+		}
+	};
+	auto parent = [&]() -> Future<size_t> {
+		std::vector<Future<void>> children;
+		children.push_back(scheduler.Enqueue(child, true));
+		children.push_back(scheduler.Enqueue(child, false));
+		children.push_back(scheduler.Enqueue(child, true));
+		size_t first = co_await WhenAny(children);
+
+		slow.Signal(1);
+		co_await WhenAll(children);
+		co_return first;
+	};
+
+	REQUIRE(scheduler.Enqueue(parent).get() == 1);
+}
+
+
+TEST_CASE("JobSystem - ParallelFor", "[JobSystem]") {
+	ThreadpoolScheduler scheduler(4);
+	std::vector<int> values(1000, 0);
+
+	auto fut = ParallelFor(scheduler, 0, 1000, 16, [&values](int i) {
+		values[i] = i * 2;
+	});
+	fut.get();
+
+	for (int i = 0; i < 1000; ++i) {
+		REQUIRE(values[i] == i * 2);
+	}
+}
+
+
+TEST_CASE("JobSystem - ParallelFor exception", "[JobSystem]") {
+	ThreadpoolScheduler scheduler(4);
+
+	auto fut = ParallelFor(scheduler, 0, 100, 0, [](int i) {
+		if (i == 37) {
+			throw std::runtime_error("Ooops");
+		}
+	});
+
+	REQUIRE_THROWS(fut.get());
+}
+
+
+TEST_CASE("JobSystem - ParallelReduce", "[JobSystem]") {
+	ThreadpoolScheduler scheduler(4);
+
+	auto fut = ParallelReduce(scheduler, 1, 1001, 0, int64_t(0), [](int i) { return int64_t(i); }, [](int64_t a, int64_t b) { return a + b; });
+
+	REQUIRE(fut.get() == 500500);
+}
+
+
+TEST_CASE("JobSystem - ParallelSort", "[JobSystem]") {
+	ThreadpoolScheduler scheduler(4);
+	std::vector<int> values;
+	for (int i = 0; i < 1000; ++i) {
+		values.push_back((i * 7919) % 1000);
+	}
+
+	auto fut = ParallelSort(scheduler, values.begin(), values.end(), 50);
+	fut.get();
+
+	REQUIRE(std::is_sorted(values.begin(), values.end()));
+}
+
+
+TEST_CASE("JobSystem - CooperativeFor", "[JobSystem]") {
+	ThreadpoolScheduler scheduler(4);
+	std::vector<int> values(1000, 0);
+
+	CooperativeFor(&scheduler, values.size(), 64, [&values](size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i) {
+			values[i] += int(i);
+		}
+	});
+
+	for (int i = 0; i < 1000; ++i) {
+		REQUIRE(values[i] == i);
+	}
+	REQUIRE_THROWS(CooperativeFor(&scheduler, 100, 10, [](size_t first, size_t last) {
+		if (first == 50) {
+			throw std::runtime_error("Ooops");
+		}
+	}));
+}
+
+
+TEST_CASE("JobSystem - Frame pool recycles frames", "[JobSystem]") {
+	FramePool::ReleaseThreadCache();
+	FramePool::ResetStatistics();
+
+	for (int i = 0; i < 10; ++i) {
+		Future<int> fut = DoJob(i);
+		REQUIRE(fut.get() == i);
+	}
+
+	FramePoolStatistics statistics = FramePool::GetStatistics();
+	REQUIRE(statistics.numAllocations == 10);
+	REQUIRE(statistics.numDeallocations == 10);
+	REQUIRE(statistics.numPoolHits == 9);
+}
+
+
+TEST_CASE("JobSystem - Tracer exports Chrome trace", "[JobSystem]") {
+	Tracer::Clear();
+	Tracer::Enable(true);
+	{
+		ThreadpoolScheduler scheduler(2);
+		REQUIRE(scheduler.Enqueue(AddJob, 1, 2).get() == 3);
+	}
+	Tracer::Enable(false);
+
+	std::stringstream ss;
+	Tracer::WriteChromeTrace(ss);
+	std::string trace = ss.str();
+	REQUIRE(trace.find("\"traceEvents\"") != std::string::npos);
+	REQUIRE(trace.find("\"ph\":\"X\"") != std::string::npos);
+	REQUIRE(trace.find("Jobsys Pool #") != std::string::npos);
+	Tracer::Clear();
+}
+
+
+TEST_CASE("JobSystem - Init graph order", "[JobSystem]") {
+	ThreadpoolScheduler scheduler(2);
+	std::atomic_int counter = 0;
+	int a = -1, b = -1, c = -1, d = -1;
+	bool cOnCaller = false;
+	const auto caller = std::this_thread::get_id();
+
+	InitGraph graph;
+	const auto taskA = graph.Add("A", [&] { a = counter++; });
+	const auto taskB = graph.Add("B", [&] { b = counter++; });
+	const auto taskC = graph.AddOnCaller("C", [&] {
+		c = counter++;
+		cOnCaller = std::this_thread::get_id() == caller;
+	}, { taskA });
+	graph.Add("D", [&] { d = counter++; }, { taskB, taskC });
+	graph.Start(scheduler);
+	graph.Wait();
+
+	REQUIRE(counter == 4);
+	REQUIRE(c > a);
+	REQUIRE(d > b);
+	REQUIRE(d > c);
+	REQUIRE(cOnCaller);
+	REQUIRE(graph.GetTimeline().zones.size() == 4);
+
+	std::stringstream ss;
+	graph.WriteReport(ss);
+	REQUIRE(ss.str().find("Critical path:") != std::string::npos);
+}
+
+
+TEST_CASE("JobSystem - Init graph failure", "[JobSystem]") {
+	ThreadpoolScheduler scheduler(2);
+	std::atomic_int numRun = 0;
+
+	InitGraph graph;
+	const auto failing = graph.Add("Failing", [] { throw std::runtime_error("failed"); });
+	const auto dependent = graph.Add("Dependent", [&] { ++numRun; }, { failing });
+	graph.AddOnCaller("Dependent on caller", [&] { ++numRun; }, { dependent });
+	graph.Add("Independent", [&] { ++numRun; });
+	graph.Start(scheduler);
+
+	REQUIRE_THROWS_AS(graph.Wait(), std::runtime_error);
+	REQUIRE(numRun == 1);
+}
@@ -0,0 +1,89 @@
+#include <BaseLibrary/Memory/LinearArena.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+using namespace inl;
+
+
+TEST_CASE("LinearArena - Alignment", "[LinearArena]") {
+	LinearArena arena(1024);
+	for (size_t alignment : { 1, 2, 8, 16, 64, 256 }) {
+		arena.Allocate(3, 1);
+		void* ptr = arena.Allocate(5, alignment);
+		REQUIRE(reinterpret_cast<uintptr_t>(ptr) % alignment == 0);
+	}
+}
+
+
+TEST_CASE("LinearArena - Reset merges chunks", "[LinearArena]") {
+	LinearArena arena(64);
+	for (int i = 0; i < 100; ++i) {
+		arena.Allocate(16, 1);
+	}
+	REQUIRE(arena.GetNumChunks() > 1);
+	size_t capacity = arena.GetCapacity();
+	REQUIRE(capacity >= 1600);
+
+	arena.Reset();
+	REQUIRE(arena.GetNumChunks() == 1);
+	REQUIRE(arena.GetCapacity() == capacity);
+
+	// Same workload fits in the merged chunk.
+	for (int i = 0; i < 100; ++i) {
+		arena.Allocate(16, 1);
+	}
+	REQUIRE(arena.GetNumChunks() == 1);
+}
+
+
+TEST_CASE("LinearArena - Concurrent allocations don't overlap", "[LinearArena]") {
+	constexpr int numThreads = 8;
+	constexpr int numAllocations = 2000;
+	LinearArena arena(256);
+
+	std::vector<std::vector<uint32_t*>> results(numThreads);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < numThreads; ++t) {
+		threads.emplace_back([&arena, &results, t] {
+			for (int i = 0; i < numAllocations; ++i) {
+				auto ptr = static_cast<uint32_t*>(arena.Allocate(sizeof(uint32_t) * 4, alignof(uint32_t)));
+				std::fill(ptr, ptr + 4, uint32_t(t));
+				results[t].push_back(ptr);
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	bool intact = true;
+	for (int t = 0; t < numThreads; ++t) {
+		for (uint32_t* ptr : results[t]) {
+			intact = intact && std::all_of(ptr, ptr + 4, [t](uint32_t v) { return v == uint32_t(t); });
+		}
+	}
+	REQUIRE(intact);
+}
+
+
+TEST_CASE("LinearArena - STL allocator", "[LinearArena]") {
+	LinearArena arena(1024);
+	std::vector<int, ArenaAllocator<int>> v{ ArenaAllocator<int>(&arena) };
+	for (int i = 0; i < 1000; ++i) {
+		v.push_back(i);
+	}
+	REQUIRE(v[999] == 999);
+	v.clear();
+	v.shrink_to_fit();
+
+	std::vector<int, ArenaAllocator<int>> heap;
+	heap.assign(10, 4);
+	REQUIRE(heap.get_allocator().GetArena() == nullptr);
+	REQUIRE(ArenaAllocator<int>(&arena) == ArenaAllocator<float>(&arena));
+}
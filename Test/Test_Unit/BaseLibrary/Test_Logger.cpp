@@ -0,0 +1,162 @@
+// Verbose sites are compiled out in this file, whatever the build.
+#define INL_LOG_MIN_LEVEL ::inl::eLogLevel::DEBUG
+
+#include <BaseLibrary/Exception/Exception.hpp>
+#include <BaseLibrary/Logging/BinaryLog.hpp>
+#include <BaseLibrary/Logging/Logger.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace inl;
+
+
+static size_t CountLines(const std::string& text, const std::string& part) {
+	size_t count = 0;
+	for (size_t pos = text.find(part); pos != std::string::npos; pos = text.find(part, pos + 1)) {
+		++count;
+	}
+	return count;
+}
+
+
+TEST_CASE("Logger - Synchronous events are written on flush", "[Logger]") {
+	std::stringstream output;
+	Logger logger;
+	logger.OpenStream(&output);
+	LogStream stream = logger.CreateLogStream("Test");
+	stream.Event("first");
+	stream.Event("second");
+	logger.Flush();
+
+	std::string text = output.str();
+	REQUIRE(text.find("[Test] first") != std::string::npos);
+	REQUIRE(text.find("first") < text.find("second"));
+}
+
+
+TEST_CASE("Logger - Asynchronous events from many threads", "[Logger]") {
+	std::stringstream output;
+	Logger logger;
+	logger.OpenStream(&output);
+	logger.SetAsync(true);
+
+	constexpr int numThreads = 4;
+	constexpr int numEvents = 500;
+	{
+		LogStream stream = logger.CreateLogStream("Async");
+		std::vector<std::thread> threads;
+		for (int i = 0; i < numThreads; ++i) {
+			threads.emplace_back([&stream] {
+				for (int j = 0; j < numEvents; ++j) {
+					stream.Event("event");
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		logger.Flush();
+	}
+	// Waits for the writer.
+	logger.SetAsync(false);
+
+	std::string text = output.str();
+	REQUIRE(CountLines(text, "[Async] event") == numThreads * numEvents);
+}
+
+
+TEST_CASE("Logger - Formats are filled in when written", "[Logger]") {
+	static const LogFormat format("Frame {} took {} ms on {}, {}");
+	std::stringstream output;
+	Logger logger;
+	logger.OpenStream(&output);
+	LogStream stream = logger.CreateLogStream("Test");
+	stream.Event(format, 42, 1.5, "the GPU");
+	logger.Flush();
+
+	REQUIRE(output.str().find("[Test] Frame 42 took 1.5 ms on the GPU, {}") != std::string::npos);
+}
+
+
+TEST_CASE("Logger - Binary log decodes to the text log", "[Logger]") {
+	static const LogFormat format("Value {} is {}");
+	auto logEvents = [](Logger& logger) {
+		LogStream stream = logger.CreateLogStream("Binary");
+		stream.Event("plain");
+		stream.Event(format, "x", -7);
+		stream.Event(format, "flag", true);
+	};
+
+	std::stringstream binary(std::ios::in | std::ios::out | std::ios::binary);
+	{
+		Logger logger;
+		logger.OpenStream(&binary, eLogFileFormat::BINARY);
+		logger.SetAsync(true);
+		logEvents(logger);
+		logger.SetAsync(false);
+	}
+
+	std::stringstream decoded;
+	REQUIRE(DecodeBinaryLog(binary, decoded));
+	std::string text = decoded.str();
+	REQUIRE(text.find("[Binary] plain") != std::string::npos);
+	REQUIRE(text.find("[Binary] Value x is -7") != std::string::npos);
+	REQUIRE(text.find("[Binary] Value flag is true") != std::string::npos);
+
+	std::string data = binary.str();
+	std::stringstream truncated(data.substr(0, data.size() - 1));
+	std::stringstream partial;
+	REQUIRE_FALSE(DecodeBinaryLog(truncated, partial));
+
+	std::stringstream notBinary("[0.1][Text] message\n");
+	REQUIRE_THROWS_AS(DecodeBinaryLog(notBinary, partial), InvalidArgumentException);
+}
+
+
+TEST_CASE("Logger - Levels below the minimum are dropped", "[Logger]") {
+	static const LogFormat format("value {}");
+	std::stringstream output;
+	Logger logger;
+	logger.OpenStream(&output);
+	LogStream stream = logger.CreateLogStream("Test");
+	stream.SetMinimumLevel(eLogLevel::WARNING);
+
+	int evaluated = 0;
+	auto argument = [&evaluated](int value) { ++evaluated; return value; };
+	INL_LOG(stream, eLogLevel::INFO, format, argument(1));
+	INL_LOG(stream, eLogLevel::WARNING, format, argument(2));
+	stream.Event(eLogLevel::ERROR, LogEvent("error"));
+	stream.Event(eLogLevel::DEBUG, LogEvent("debug"));
+	logger.Flush();
+
+	std::string text = output.str();
+	REQUIRE(evaluated == 1);
+	REQUIRE(text.find("value 1") == std::string::npos);
+	REQUIRE(text.find("value 2") != std::string::npos);
+	REQUIRE(text.find("error") != std::string::npos);
+	REQUIRE(text.find("debug") == std::string::npos);
+}
+
+
+TEST_CASE("Logger - Sites below the compile-time minimum are removed", "[Logger]") {
+	static const LogFormat format("value {}");
+	std::stringstream output;
+	Logger logger;
+	logger.OpenStream(&output);
+	LogStream stream = logger.CreateLogStream("Test");
+
+	int evaluated = 0;
+	auto argument = [&evaluated](int value) { ++evaluated; return value; };
+	INL_LOG(stream, eLogLevel::VERBOSE, format, argument(1));
+	INL_LOG(stream, eLogLevel::DEBUG, format, argument(2));
+	logger.Flush();
+
+	std::string text = output.str();
+	REQUIRE(evaluated == 1);
+	REQUIRE(text.find("value 1") == std::string::npos);
+	REQUIRE(text.find("value 2") != std::string::npos);
+}
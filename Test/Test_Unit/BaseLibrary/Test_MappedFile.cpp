@@ -0,0 +1,43 @@
+#include <BaseLibrary/Platform/MappedFile.hpp>
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace inl;
+
+
+TEST_CASE("MappedFile - Contents", "[MappedFile]") {
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "InlineMappedFileTest.bin";
+	const std::string contents = "mapped file contents";
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << contents;
+	}
+
+	MappedFile mapped(path);
+	REQUIRE(mapped.GetSize() == contents.size());
+	REQUIRE(std::memcmp(mapped.GetData(), contents.data(), contents.size()) == 0);
+
+	MappedFile moved = std::move(mapped);
+	REQUIRE(mapped.GetData() == nullptr);
+	REQUIRE(moved.GetSize() == contents.size());
+}
+
+
+TEST_CASE("MappedFile - Empty and missing files", "[MappedFile]") {
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "InlineMappedFileTest.empty";
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	}
+
+	MappedFile mapped(path);
+	REQUIRE(mapped.GetSize() == 0);
+	REQUIRE(mapped.GetData() == nullptr);
+
+	REQUIRE_THROWS_AS(MappedFile(std::filesystem::temp_directory_path() / "InlineMappedFileTest.missing"), FileNotFoundException);
+}
@@ -0,0 +1,49 @@
+#include <BaseLibrary/Memory/MemoryTracker.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <thread>
+
+using namespace inl;
+
+
+TEST_CASE("Tag scopes nest", "[MemoryTracker]") {
+	REQUIRE(MemoryTracker::GetThreadTag() == eMemoryTag::UNTAGGED);
+	{
+		MemoryTagScope graphics(eMemoryTag::GRAPHICS);
+		REQUIRE(MemoryTracker::GetThreadTag() == eMemoryTag::GRAPHICS);
+		{
+			MemoryTagScope assets(eMemoryTag::ASSETS);
+			REQUIRE(MemoryTracker::GetThreadTag() == eMemoryTag::ASSETS);
+			std::thread other([] {
+				REQUIRE(MemoryTracker::GetThreadTag() == eMemoryTag::UNTAGGED);
+			});
+			other.join();
+		}
+		REQUIRE(MemoryTracker::GetThreadTag() == eMemoryTag::GRAPHICS);
+	}
+	REQUIRE(MemoryTracker::GetThreadTag() == eMemoryTag::UNTAGGED);
+}
+
+
+TEST_CASE("Live bytes, peaks and rates", "[MemoryTracker]") {
+	MemorySnapshot begin = MemoryTracker::GetSnapshot();
+	MemoryTracker::ResetPeaks();
+
+	MemoryTracker::RecordAllocation(eMemoryTag::NETWORK, 1000);
+	MemoryTracker::RecordAllocation(eMemoryTag::NETWORK, 500);
+	MemoryTracker::RecordFree(eMemoryTag::NETWORK, 1000);
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	MemorySnapshot end = MemoryTracker::GetSnapshot(begin);
+	const MemoryTagStatistics& before = begin[eMemoryTag::NETWORK];
+	const MemoryTagStatistics& after = end[eMemoryTag::NETWORK];
+	REQUIRE(after.liveBytes - before.liveBytes == 500);
+	REQUIRE(after.peakBytes == before.liveBytes + 1500);
+	REQUIRE(after.numAllocations - before.numAllocations == 2);
+	REQUIRE(after.numFrees - before.numFrees == 1);
+	REQUIRE(after.allocationsPerSecond > 0.0);
+	REQUIRE(after.allocatedBytesPerSecond > 0.0);
+
+	MemoryTracker::RecordFree(eMemoryTag::NETWORK, 500);
+}
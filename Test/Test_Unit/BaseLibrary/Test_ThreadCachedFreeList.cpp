@@ -0,0 +1,82 @@
+#include <BaseLibrary/Memory/ThreadCachedFreeList.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+
+using namespace inl;
+
+
+TEST_CASE("ThreadCachedFreeList - Pop returns pushed objects", "[ThreadCachedFreeList]") {
+	ThreadCachedFreeList<int> list(2);
+	int objects[5];
+
+	REQUIRE(list.Pop() == nullptr);
+	for (int& object : objects) {
+		list.Push(&object);
+	}
+
+	std::set<int*> popped;
+	while (int* object = list.Pop()) {
+		REQUIRE(popped.insert(object).second);
+	}
+	REQUIRE(popped.size() == 5);
+
+	list.Push(&objects[0]);
+	list.Clear();
+	REQUIRE(list.Pop() == nullptr);
+}
+
+
+TEST_CASE("ThreadCachedFreeList - Lists don't share thread caches", "[ThreadCachedFreeList]") {
+	ThreadCachedFreeList<int> first;
+	ThreadCachedFreeList<int> second;
+	int a, b;
+
+	first.Push(&a);
+	second.Push(&b);
+	REQUIRE(first.Pop() == &a);
+	REQUIRE(second.Pop() == &b);
+	REQUIRE(first.Pop() == nullptr);
+	REQUIRE(second.Pop() == nullptr);
+}
+
+
+TEST_CASE("ThreadCachedFreeList - Objects recycled on another thread", "[ThreadCachedFreeList]") {
+	constexpr int numObjects = 64;
+	constexpr int numThreads = 4;
+	std::vector<int> objects(numObjects);
+	ThreadCachedFreeList<int> list(4);
+	for (int& object : objects) {
+		list.Push(&object);
+	}
+
+	// Every thread uses what it pops exclusively, then gives it back.
+	std::vector<std::atomic_int> owners(numObjects);
+	std::atomic_bool overlap = false;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < numThreads; ++t) {
+		threads.emplace_back([&, t] {
+			for (int i = 0; i < 1000; ++i) {
+				int* object = list.Pop();
+				if (!object) {
+					continue;
+				}
+				auto& owner = owners[object - objects.data()];
+				if (owner.exchange(t + 1) != 0) {
+					overlap = true;
+				}
+				owner = 0;
+				list.Push(object);
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	REQUIRE(!overlap);
+}
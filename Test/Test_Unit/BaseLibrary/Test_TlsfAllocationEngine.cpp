@@ -0,0 +1,98 @@
+#include <BaseLibrary/Memory/TlsfAllocationEngine.hpp>
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+
+
+using namespace inl;
+
+
+TEST_CASE("Tlsf - Fill and free", "[Tlsf]") {
+	TlsfAllocationEngine engine(1024);
+	auto a = engine.Allocate(256);
+	auto b = engine.Allocate(512);
+	auto c = engine.Allocate(256);
+	REQUIRE(a.offset == 0);
+	REQUIRE(b.offset == 256);
+	REQUIRE(c.offset == 768);
+	REQUIRE(engine.GetFreeSize() == 0);
+	REQUIRE_THROWS_AS(engine.Allocate(1), std::bad_alloc);
+
+	engine.Deallocate(b);
+	REQUIRE(engine.GetFreeSize() == 512);
+	auto d = engine.Allocate(300);
+	REQUIRE(d.offset == 256);
+	REQUIRE_THROWS_AS(engine.Allocate(300), std::bad_alloc);
+}
+
+
+TEST_CASE("Tlsf - Freed neighbours merge", "[Tlsf]") {
+	TlsfAllocationEngine engine(1024);
+	auto a = engine.Allocate(256);
+	auto b = engine.Allocate(256);
+	auto c = engine.Allocate(256);
+	engine.Deallocate(a);
+	engine.Deallocate(c);
+	REQUIRE_THROWS_AS(engine.Allocate(768), std::bad_alloc);
+
+	engine.Deallocate(b);
+	REQUIRE(engine.IsEmpty());
+	REQUIRE(engine.Allocate(1024).offset == 0);
+}
+
+
+TEST_CASE("Tlsf - Granularity and alignment", "[Tlsf]") {
+	TlsfAllocationEngine engine(1 << 20, 4096);
+	auto a = engine.Allocate(100);
+	REQUIRE(engine.GetFreeSize() == (1 << 20) - 4096);
+
+	auto b = engine.Allocate(4096, 65536);
+	REQUIRE(b.offset % 65536 == 0);
+	// The padding before the aligned allocation stays usable.
+	auto c = engine.Allocate(4096);
+	REQUIRE(c.offset == 4096);
+
+	engine.Deallocate(a);
+	engine.Deallocate(b);
+	engine.Deallocate(c);
+	REQUIRE(engine.IsEmpty());
+
+	REQUIRE_THROWS_AS(engine.Allocate(0), InvalidArgumentException);
+	REQUIRE_THROWS_AS(engine.Allocate(16, 3), InvalidArgumentException);
+	REQUIRE_THROWS_AS(engine.Deallocate(c), InvalidArgumentException);
+}
+
+
+TEST_CASE("Tlsf - Random allocations do not overlap", "[Tlsf]") {
+	TlsfAllocationEngine engine(1 << 26, 256);
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<uint64_t> size(1, 1 << 16);
+	std::vector<std::pair<TlsfAllocationEngine::Allocation, uint64_t>> live;
+
+	for (int i = 0; i < 2000; ++i) {
+		if (!live.empty() && rng() % 3 == 0) {
+			size_t index = rng() % live.size();
+			engine.Deallocate(live[index].first);
+			live.erase(live.begin() + index);
+		}
+		else {
+			uint64_t bytes = size(rng);
+			live.push_back({ engine.Allocate(bytes), bytes });
+		}
+	}
+
+	std::sort(live.begin(), live.end(), [](const auto& l, const auto& r) { return l.first.offset < r.first.offset; });
+	for (size_t i = 1; i < live.size(); ++i) {
+		REQUIRE(live[i - 1].first.offset + live[i - 1].second <= live[i].first.offset);
+	}
+	REQUIRE(live.back().first.offset + live.back().second <= engine.Size());
+
+	for (auto& [allocation, bytes] : live) {
+		engine.Deallocate(allocation);
+	}
+	REQUIRE(engine.IsEmpty());
+	REQUIRE(engine.Allocate(1 << 26).offset == 0);
+}
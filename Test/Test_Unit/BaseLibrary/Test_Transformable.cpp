@@ -2,6 +2,8 @@
 
 #include <Catch2/catch.hpp>
 
+#include <vector>
+
 using namespace inl;
 
 
@@ -267,4 +269,51 @@ TEST_CASE("Motion concat", "[Transformable]") {
 	Mat44 motionProductRule = motiona*B2 + A2*motionb;
 
 	REQUIRE(motionProductRule.Approx() == motionm);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Cached transform", "[Transformable]") {
+	Quat rot = Quat::AxisAngle(Vec3{ 1,2,3 }.Normalized(), 0.5f);
+	Transformable3D t;
+	auto expected = [&t] {
+		Mat44 composed = Mat44::Translation(t.GetPosition());
+		composed.Submatrix<3, 3>(0, 0) = t.GetLinearTransform();
+		return composed;
+	};
+
+	REQUIRE(t.IsTransformDirty());
+	REQUIRE(t.GetTransform().Approx() == Mat44::Identity());
+	REQUIRE(!t.IsTransformDirty());
+
+	SECTION("Absolute setters") {
+		t.SetPosition({ 1,2,3 });
+		REQUIRE(t.IsTransformDirty());
+		REQUIRE(t.GetTransform().Approx() == expected());
+		t.SetRotation(rot);
+		REQUIRE(t.GetTransform().Approx() == expected());
+		t.SetScale({ 2,3,4 });
+		REQUIRE(t.GetTransform().Approx() == expected());
+		Mat44 full = Mat44::Scale(Vec3{ 3,4,5 }) * Mat44(rot) * Mat44::Translation(4, 5, 6);
+		t.SetTransform(full);
+		REQUIRE(t.GetTransform().Approx() == full);
+	}
+	SECTION("Relative transforms") {
+		t.Move({ 1,2,3 });
+		REQUIRE(t.GetTransform().Approx() == expected());
+		t.Rotate(rot);
+		REQUIRE(t.GetTransform().Approx() == expected());
+		t.Scale({ 2,3,4 });
+		REQUIRE(t.GetTransform().Approx() == expected());
+		t.ShearXY(0.5f);
+		REQUIRE(t.GetTransform().Approx() == expected());
+	}
+	SECTION("Flush") {
+		std::vector<Transformable3D> objects(3);
+		objects[1].SetPosition({ 1,2,3 });
+		Transformable3D* pointers[] = { &objects[0], &objects[1], &objects[2] };
+		FlushTransforms(std::begin(pointers), std::end(pointers));
+		for (auto& object : objects) {
+			REQUIRE(!object.IsTransformDirty());
+		}
+		REQUIRE(objects[1].GetTransform().Approx() == Mat44::Translation(1, 2, 3));
+	}
+}
@@ -0,0 +1,114 @@
+#include <GraphicsEngine_LL/AnimationState.hpp>
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <cmath>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+// A root at the origin and a child one unit along x, bound in the rest pose.
+static Skeleton MakeChain() {
+	Skeleton::Joint root;
+	Skeleton::Joint child;
+	child.parent = 0;
+	child.restPose.translation = { 1, 0, 0 };
+	child.inverseBind(3, 0) = -1.0f;
+	return Skeleton({ root, child });
+}
+
+
+static AnimationClip MakeRootRotation(float angle, bool negate = false) {
+	const float sign = negate ? -1.0f : 1.0f;
+	JointPose root;
+	root.rotation = Quat(sign * std::cos(angle / 2), 0, 0, sign * std::sin(angle / 2));
+	JointPose child;
+	child.translation = { 1, 0, 0 };
+	return AnimationClip(2, 30.0f, { root, child });
+}
+
+
+static Vec3 Transform(const SkinningMatrix& matrix, const Vec3& point) {
+	const Vec4 position = { point, 1.0f };
+	return { Dot(Vec4(matrix.rows[0]), position), Dot(Vec4(matrix.rows[1]), position), Dot(Vec4(matrix.rows[2]), position) };
+}
+
+
+TEST_CASE("Animation palettes follow the hierarchy", "[GraphicsEngine]") {
+	const Skeleton skeleton = MakeChain();
+	AnimationState state(&skeleton);
+	SkinningMatrix palette[2];
+
+	// The rest pose leaves the bind pose as is.
+	state.EvaluatePalette(palette);
+	REQUIRE(Transform(palette[1], { 2, 0, 0 }).x == Approx(2.0f));
+
+	// Turning the root takes the child along.
+	const AnimationClip clip = MakeRootRotation(Constants<float>::Pi / 2);
+	state.AddLayer(&clip);
+	state.EvaluatePalette(palette);
+	const Vec3 moved = Transform(palette[1], { 2, 0, 0 });
+	REQUIRE(moved.x == Approx(0.0f).margin(1e-5f));
+	REQUIRE(moved.y == Approx(2.0f));
+}
+
+
+TEST_CASE("Animation layers blend the short way", "[GraphicsEngine]") {
+	const Skeleton skeleton = MakeChain();
+	const AnimationClip clip = MakeRootRotation(Constants<float>::Pi / 2);
+	const AnimationClip negated = MakeRootRotation(Constants<float>::Pi / 2, true);
+	SkinningMatrix palette[2];
+
+	// The same rotation with opposite signs blends into itself.
+	AnimationState state(&skeleton);
+	state.AddLayer(&clip, 0.5f);
+	state.AddLayer(&negated, 0.5f);
+	state.EvaluatePalette(palette);
+	REQUIRE(Transform(palette[0], { 1, 0, 0 }).y == Approx(1.0f));
+
+	// Half a layer is half way from the rest pose.
+	AnimationState half(&skeleton);
+	half.AddLayer(&clip, 0.5f);
+	half.EvaluatePalette(palette);
+	const Vec3 moved = Transform(palette[0], { 1, 0, 0 });
+	REQUIRE(moved.x == Approx(std::sqrt(0.5f)));
+	REQUIRE(moved.y == Approx(std::sqrt(0.5f)));
+}
+
+
+TEST_CASE("Animation clips loop or stop", "[GraphicsEngine]") {
+	std::vector<JointPose> poses(3);
+	const AnimationClip clip(1, 1.0f, poses);
+	REQUIRE(clip.GetDuration() == 2.0f);
+
+	Skeleton skeleton({ Skeleton::Joint{} });
+	AnimationState state(&skeleton);
+	state.AddLayer(&clip, 1.0f, true);
+	state.AddLayer(&clip, 1.0f, false);
+	state.Advance(2.5f);
+	REQUIRE(state.GetLayer(0).time == Approx(0.5f));
+	REQUIRE(state.GetLayer(1).time == 2.0f);
+
+	const AnimationClip otherSkeleton = MakeRootRotation(1.0f);
+	REQUIRE_THROWS_AS(state.AddLayer(&otherSkeleton), InvalidArgumentException);
+	REQUIRE_THROWS_AS(Skeleton({ Skeleton::Joint{ 1 }, Skeleton::Joint{} }), InvalidArgumentException);
+}
+
+
+TEST_CASE("Skin weights add up to one", "[GraphicsEngine]") {
+	Skin::Influence influence;
+	influence.joints = { 3, 1, 2, 0 };
+	influence.weights = { 0.5f, 0.25f, 0.25f, 0.0f };
+	const Skin skin({ influence }, BoundingBox({ -1, -1, -1 }, { 1, 1, 1 }));
+
+	REQUIRE(skin.GetVertexCount() == 1);
+	const uint32_t joints = skin.GetPacked()[0];
+	const uint32_t weights = skin.GetPacked()[1];
+	REQUIRE(joints == (3u | (1u << 8) | (2u << 16)));
+	REQUIRE((weights & 0xFF) + ((weights >> 8) & 0xFF) + ((weights >> 16) & 0xFF) + (weights >> 24) == 255);
+	REQUIRE(skin.GetPositionQuantization().scale == 2.0f);
+	REQUIRE(skin.GetId() != Skin({}, {}).GetId());
+}
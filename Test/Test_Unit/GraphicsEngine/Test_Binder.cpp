@@ -0,0 +1,122 @@
+#include <GraphicsApi_Null/GraphicsApi.hpp>
+#include <GraphicsApi_Null/GxapiManager.hpp>
+#include <GraphicsEngine_LL/Binder.hpp>
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <memory>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+static BindParameterDesc MakeDesc(eBindParameterType type, unsigned reg, unsigned constantSize = 0) {
+	BindParameterDesc desc;
+	desc.parameter = BindParameter(type, reg);
+	desc.constantSize = constantSize;
+	return desc;
+}
+
+
+TEST_CASE("Binder resolves parameters to their translation", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	Binder binder(api.get(),
+				  { MakeDesc(eBindParameterType::CONSTANT, 0, 64),
+					MakeDesc(eBindParameterType::TEXTURE, 0),
+					MakeDesc(eBindParameterType::TEXTURE, 1),
+					MakeDesc(eBindParameterType::UNORDERED, 0) });
+
+	for (BindParameter parameter : { BindParameter(eBindParameterType::CONSTANT, 0),
+									 BindParameter(eBindParameterType::TEXTURE, 0),
+									 BindParameter(eBindParameterType::TEXTURE, 1),
+									 BindParameter(eBindParameterType::UNORDERED, 0) }) {
+		int rootParamIndex, rootTableIndex;
+		binder.Translate(parameter, rootParamIndex, rootTableIndex);
+		const BindSlot slot = binder.Resolve(parameter);
+		REQUIRE(slot.binder == &binder);
+		REQUIRE(slot.rootParamIndex == rootParamIndex);
+		const bool isTable = binder.GetRootSignatureDesc().rootParameters[rootParamIndex].type == gxapi::RootParameterDesc::DESCRIPTOR_TABLE;
+		if (isTable) {
+			REQUIRE(slot.rootTableIndex == rootTableIndex);
+		}
+	}
+
+	REQUIRE_THROWS_AS(binder.Resolve(BindParameter(eBindParameterType::UNORDERED, 7)), OutOfRangeException);
+}
+
+
+static int RootSignatureSize(const gxapi::RootSignatureDesc& desc) {
+	int size = 0;
+	for (const auto& param : desc.rootParameters) {
+		switch (param.type) {
+			case gxapi::RootParameterDesc::CONSTANT: size += param.As<gxapi::RootParameterDesc::CONSTANT>().numConstants; break;
+			case gxapi::RootParameterDesc::DESCRIPTOR_TABLE: size += 1; break;
+			default: size += 2; break;
+		}
+	}
+	return size;
+}
+
+
+static gxapi::RootParameterDesc::eType RootParameterType(const Binder& binder, BindParameter parameter) {
+	const BindSlot slot = binder.Resolve(parameter);
+	return binder.GetRootSignatureDesc().rootParameters[slot.rootParamIndex].type;
+}
+
+
+TEST_CASE("Binder places constants by size", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	Binder binder(api.get(),
+				  { MakeDesc(eBindParameterType::CONSTANT, 0, 16),
+					MakeDesc(eBindParameterType::CONSTANT, 1),
+					MakeDesc(eBindParameterType::TEXTURE, 0) });
+
+	REQUIRE(RootParameterType(binder, BindParameter(eBindParameterType::CONSTANT, 0)) == gxapi::RootParameterDesc::CONSTANT);
+	REQUIRE(RootParameterType(binder, BindParameter(eBindParameterType::CONSTANT, 1)) == gxapi::RootParameterDesc::CBV);
+	REQUIRE(RootParameterType(binder, BindParameter(eBindParameterType::TEXTURE, 0)) == gxapi::RootParameterDesc::DESCRIPTOR_TABLE);
+}
+
+
+TEST_CASE("Binder keeps frequently changing constants in the root signature", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+
+	// 5 x 16 DWORDs of constants don't fit beside the texture table.
+	std::vector<BindParameterDesc> parameters;
+	for (unsigned reg = 0; reg < 5; ++reg) {
+		parameters.push_back(MakeDesc(eBindParameterType::CONSTANT, reg, 64));
+		parameters.back().relativeChangeFrequency = reg == 2 ? 100.0f : 1.0f;
+	}
+	parameters.push_back(MakeDesc(eBindParameterType::TEXTURE, 0));
+	Binder binder(api.get(), parameters);
+
+	REQUIRE(RootSignatureSize(binder.GetRootSignatureDesc()) <= 64);
+	REQUIRE(RootParameterType(binder, BindParameter(eBindParameterType::CONSTANT, 2)) == gxapi::RootParameterDesc::CONSTANT);
+	for (unsigned reg : { 0u, 1u, 3u, 4u }) {
+		REQUIRE(RootParameterType(binder, BindParameter(eBindParameterType::CONSTANT, reg)) != gxapi::RootParameterDesc::DESCRIPTOR_TABLE);
+	}
+}
+
+
+TEST_CASE("Binder moves rarely changing constants to tables", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+
+	// 40 root CBVs would take 80 DWORDs.
+	std::vector<BindParameterDesc> parameters;
+	for (unsigned reg = 0; reg < 40; ++reg) {
+		parameters.push_back(MakeDesc(eBindParameterType::CONSTANT, reg));
+		parameters.back().relativeChangeFrequency = reg < 20 ? 10.0f : 1.0f;
+	}
+	Binder binder(api.get(), parameters);
+
+	REQUIRE(RootSignatureSize(binder.GetRootSignatureDesc()) <= 64);
+	for (unsigned reg = 0; reg < 20; ++reg) {
+		REQUIRE(RootParameterType(binder, BindParameter(eBindParameterType::CONSTANT, reg)) == gxapi::RootParameterDesc::CBV);
+	}
+	REQUIRE(RootParameterType(binder, BindParameter(eBindParameterType::CONSTANT, 20)) == gxapi::RootParameterDesc::DESCRIPTOR_TABLE);
+}
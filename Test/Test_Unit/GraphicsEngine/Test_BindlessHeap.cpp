@@ -0,0 +1,39 @@
+#include <GraphicsEngine_LL/BindlessHeap.hpp>
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("Bindless indices are reused after the frames in flight", "[GraphicsEngine]") {
+	BindlessIndexAllocator allocator(8);
+
+	REQUIRE(allocator.Allocate() == 0);
+	REQUIRE(allocator.Allocate() == 1);
+	REQUIRE(allocator.Allocate() == 2);
+	REQUIRE(allocator.GetHighWaterMark() == 3);
+
+	allocator.Free(1);
+	allocator.Free(0);
+	for (uint64_t i = 1; i < BindlessIndexAllocator::ReuseLatency; ++i) {
+		allocator.BeginFrame();
+		REQUIRE(allocator.Allocate() >= 3); // The GPU may still use the freed ones.
+	}
+	allocator.BeginFrame();
+
+	// Lowest freed index first.
+	REQUIRE(allocator.Allocate() == 0);
+	REQUIRE(allocator.Allocate() == 1);
+	REQUIRE(allocator.GetHighWaterMark() == 3 + BindlessIndexAllocator::ReuseLatency - 1);
+}
+
+
+TEST_CASE("Bindless allocator capacity", "[GraphicsEngine]") {
+	BindlessIndexAllocator allocator(2);
+	allocator.Allocate();
+	allocator.Allocate();
+	REQUIRE_THROWS_AS(allocator.Allocate(), OutOfMemoryException);
+}
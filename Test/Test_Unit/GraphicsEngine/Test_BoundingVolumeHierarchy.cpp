@@ -0,0 +1,121 @@
+#include <GraphicsEngine_LL/BoundingVolumeHierarchy.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+namespace {
+
+std::vector<BoundingBox> RandomBoxes(size_t count, std::mt19937& rne) {
+	std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> size(0.1f, 5.0f);
+	std::vector<BoundingBox> boxes;
+	for (size_t i = 0; i < count; ++i) {
+		Vec3 lower = { position(rne), position(rne), position(rne) };
+		boxes.push_back({ lower, lower + Vec3{ size(rne), size(rne), size(rne) } });
+	}
+	return boxes;
+}
+
+// Every leaf that overlaps the volume must be reported, and only those whose inflated box overlaps.
+template <class Volume>
+bool MatchesBruteForce(const BoundingVolumeHierarchy<int>& bvh, const std::vector<int>& leaves, const std::vector<BoundingBox>& boxes, const std::vector<bool>& alive, const Volume& volume) {
+	std::vector<int> result;
+	bvh.Query(volume, [&result](int value) { result.push_back(value); });
+	std::sort(result.begin(), result.end());
+	if (std::adjacent_find(result.begin(), result.end()) != result.end()) {
+		return false;
+	}
+	for (size_t i = 0; i < boxes.size(); ++i) {
+		bool found = std::binary_search(result.begin(), result.end(), int(i));
+		if (!alive[i] && found) {
+			return false;
+		}
+		if (alive[i] && volume.Classify(boxes[i]) != eContainment::OUTSIDE && !found) {
+			return false;
+		}
+		if (found && volume.Classify(bvh.GetBounds(leaves[i])) == eContainment::OUTSIDE) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+
+TEST_CASE("BoundingVolumeHierarchy - Queries match brute force", "[BoundingVolumeHierarchy]") {
+	std::mt19937 rne(723);
+	std::vector<BoundingBox> boxes = RandomBoxes(2000, rne);
+	std::vector<bool> alive(boxes.size(), true);
+	std::vector<int> leaves;
+
+	BoundingVolumeHierarchy<int> bvh;
+	for (size_t i = 0; i < boxes.size(); ++i) {
+		leaves.push_back(bvh.Insert(boxes[i], int(i)));
+	}
+	REQUIRE(bvh.Size() == boxes.size());
+	REQUIRE(bvh.GetHeight() < 32);
+
+	// Move some, remove some.
+	std::uniform_real_distribution<float> offset(-10.0f, 10.0f);
+	for (size_t i = 0; i < boxes.size(); i += 3) {
+		Vec3 move = { offset(rne), offset(rne), offset(rne) };
+		boxes[i] = { boxes[i].lower + move, boxes[i].upper + move };
+		bvh.Move(leaves[i], boxes[i]);
+	}
+	for (size_t i = 0; i < boxes.size(); i += 7) {
+		bvh.Remove(leaves[i]);
+		alive[i] = false;
+	}
+	REQUIRE(bvh.Size() == size_t(std::count(alive.begin(), alive.end(), true)));
+
+	REQUIRE(MatchesBruteForce(bvh, leaves, boxes, alive, BoundingBox{ { -20, -30, -40 }, { 30, 20, 10 } }));
+	REQUIRE(MatchesBruteForce(bvh, leaves, boxes, alive, BoundingSphere{ { 10, -5, 20 }, 35.0f }));
+
+	// Ortho projection of the box [-50, 50] x [-50, 50] x [0, 100].
+	Mat44 ortho = Mat44::Identity();
+	ortho(0, 0) = 0.02f;
+	ortho(1, 1) = 0.02f;
+	ortho(2, 2) = 0.01f;
+	REQUIRE(MatchesBruteForce(bvh, leaves, boxes, alive, Frustum{ ortho }));
+}
+
+
+TEST_CASE("BoundingVolumeHierarchy - Small moves keep the leaf", "[BoundingVolumeHierarchy]") {
+	BoundingVolumeHierarchy<int> bvh(0.5f);
+	BoundingBox box{ { 0, 0, 0 }, { 2, 2, 2 } };
+	int leaf = bvh.Insert(box, 1);
+	bvh.Insert({ { 10, 10, 10 }, { 11, 11, 11 } }, 2);
+
+	REQUIRE(!bvh.Move(leaf, { { 0.2f, 0.2f, 0.2f }, { 2.2f, 2.2f, 2.2f } }));
+	REQUIRE(bvh.Move(leaf, { { 5, 5, 5 }, { 7, 7, 7 } }));
+	REQUIRE(bvh.GetValue(leaf) == 1);
+	REQUIRE(bvh.GetBounds(leaf).Contains({ { 5, 5, 5 }, { 7, 7, 7 } }));
+}
+
+
+TEST_CASE("Frustum - Perspective classification", "[BoundingVolumeHierarchy]") {
+	// 90 degree perspective looking down +Z, near 1, far 100.
+	const float n = 1.0f, f = 100.0f;
+	Mat44 projection = Mat44::Identity();
+	projection(2, 2) = f / (f - n);
+	projection(2, 3) = 1.0f;
+	projection(3, 2) = -n * f / (f - n);
+	projection(3, 3) = 0.0f;
+	Frustum frustum{ projection };
+
+	REQUIRE(frustum.Classify(BoundingBox{ { -1, -1, 49 }, { 1, 1, 51 } }) == eContainment::INSIDE);
+	REQUIRE(frustum.Classify(BoundingBox{ { 60, -1, 49 }, { 62, 1, 51 } }) == eContainment::OUTSIDE);
+	REQUIRE(frustum.Classify(BoundingBox{ { 49, -1, 49 }, { 51, 1, 51 } }) == eContainment::INTERSECTING);
+	REQUIRE(frustum.Classify(BoundingBox{ { -1, -1, -5 }, { 1, 1, -3 } }) == eContainment::OUTSIDE);
+	REQUIRE(frustum.Classify(BoundingBox{ { -1, -1, 150 }, { 1, 1, 152 } }) == eContainment::OUTSIDE);
+	REQUIRE(frustum.Classify(BoundingSphere{ { 0, 0, 50 }, 2.0f }) == eContainment::INSIDE);
+	REQUIRE(frustum.Classify(BoundingSphere{ { 0, 0, 102 }, 3.0f }) == eContainment::INTERSECTING);
+}
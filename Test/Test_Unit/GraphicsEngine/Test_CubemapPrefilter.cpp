@@ -0,0 +1,52 @@
+#include <GraphicsEngine_LL/CubemapPrefilterTask.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("Cubemap prefilter slices start with the radiance chain", "[GraphicsEngine]") {
+	auto slices = CubemapPrefilterTask::GetSlices(256, 128, 5);
+	REQUIRE(slices.size() == 7);
+	REQUIRE(slices[0].type == CubemapPrefilterTask::Slice::RADIANCE);
+	REQUIRE(slices[1].type == CubemapPrefilterTask::Slice::IRRADIANCE);
+	REQUIRE(slices[1].mip == 3); // 256 >> 3 == 32
+	for (unsigned mip = 0; mip < 5; ++mip) {
+		REQUIRE(slices[2 + mip].type == CubemapPrefilterTask::Slice::SPECULAR);
+		REQUIRE(slices[2 + mip].mip == mip);
+	}
+	// The sharpest level is a copy, the rough ones take all samples.
+	REQUIRE(slices[2].cost == 6 * 128 * 128);
+	REQUIRE(slices[3].cost == 6 * 64 * 64 * CubemapPrefilterTask::SampleCount);
+}
+
+
+TEST_CASE("Cubemap prefilter slices are spread over frames by the budget", "[GraphicsEngine]") {
+	std::vector<CubemapPrefilterTask::Slice> slices = {
+		{ CubemapPrefilterTask::Slice::RADIANCE, 0, 40 },
+		{ CubemapPrefilterTask::Slice::IRRADIANCE, 0, 10 },
+		{ CubemapPrefilterTask::Slice::SPECULAR, 0, 60 },
+		{ CubemapPrefilterTask::Slice::SPECULAR, 1, 200 },
+	};
+
+	uint64_t budget = 100;
+	REQUIRE(CubemapPrefilterTask::TakeSlices(slices, 0, budget) == 2);
+	REQUIRE(budget == 50);
+
+	// A slice over the budget still goes alone, so every frame makes progress.
+	budget = 100;
+	REQUIRE(CubemapPrefilterTask::TakeSlices(slices, 2, budget) == 1);
+	budget = 100;
+	REQUIRE(CubemapPrefilterTask::TakeSlices(slices, 3, budget) == 1);
+	REQUIRE(budget == 0);
+	REQUIRE(CubemapPrefilterTask::TakeSlices(slices, 4, budget) == 0);
+}
+
+
+TEST_CASE("Cubemap prefilter roughness spans the specular chain", "[GraphicsEngine]") {
+	REQUIRE(CubemapPrefilterTask::GetRoughness(0, 5) == 0.0f);
+	REQUIRE(CubemapPrefilterTask::GetRoughness(2, 5) == Approx(0.5f));
+	REQUIRE(CubemapPrefilterTask::GetRoughness(4, 5) == 1.0f);
+	REQUIRE(CubemapPrefilterTask::GetRoughness(0, 1) == 0.0f);
+}
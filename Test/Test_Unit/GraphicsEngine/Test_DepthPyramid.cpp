@@ -0,0 +1,107 @@
+#include <GraphicsEngine_LL/DepthPyramid.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <vector>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+namespace {
+
+// Orthographic camera looking down +Z, mapping x, y in [-1, 1] to the screen and z in [0, 1] to depth.
+const Mat44 viewProjection = Mat44::Identity();
+
+} // namespace
+
+
+TEST_CASE("DepthPyramid levels hold maximum depths", "[GraphicsEngine]") {
+	std::vector<float> depth = {
+		0.1f, 0.2f, 0.3f,
+		0.4f, 0.5f, 0.6f,
+		0.7f, 0.8f, 0.9f,
+	};
+	DepthPyramid pyramid;
+	pyramid.Assign(depth.data(), 3, 3, 3, { 3.0f, 3.0f }, viewProjection);
+
+	REQUIRE(pyramid.GetLevelCount() == 3);
+	REQUIRE(pyramid.GetWidth(1) == 2);
+	REQUIRE(pyramid.GetHeight(1) == 2);
+	REQUIRE(pyramid.GetDepth(1, 0, 0) == 0.5f);
+	REQUIRE(pyramid.GetDepth(1, 1, 0) == 0.6f);
+	REQUIRE(pyramid.GetDepth(1, 0, 1) == 0.8f);
+	REQUIRE(pyramid.GetDepth(1, 1, 1) == 0.9f);
+	REQUIRE(pyramid.GetDepth(2, 0, 0) == 0.9f);
+}
+
+
+TEST_CASE("DepthPyramid row pitch", "[GraphicsEngine]") {
+	std::vector<float> depth = {
+		0.1f, 0.2f, -1.0f, -1.0f,
+		0.3f, 0.4f, -1.0f, -1.0f,
+	};
+	DepthPyramid pyramid;
+	pyramid.Assign(depth.data(), 2, 2, 4, { 2.0f, 2.0f }, viewProjection);
+
+	REQUIRE(pyramid.GetDepth(0, 1, 1) == 0.4f);
+	REQUIRE(pyramid.GetDepth(1, 0, 0) == 0.4f);
+}
+
+
+TEST_CASE("DepthPyramid occlusion", "[GraphicsEngine]") {
+	// Left half of the screen is covered by a wall at depth 0.5.
+	const size_t size = 64;
+	std::vector<float> depth(size * size, 1.0f);
+	for (size_t y = 0; y < size; ++y) {
+		for (size_t x = 0; x < size / 2; ++x) {
+			depth[y * size + x] = 0.5f;
+		}
+	}
+	DepthPyramid pyramid;
+	pyramid.Assign(depth.data(), size, size, size, { float(size), float(size) }, viewProjection);
+
+	SECTION("Behind the occluder") {
+		REQUIRE(pyramid.IsOccluded({ { -0.9f, -0.5f, 0.6f }, { -0.1f, 0.5f, 0.8f } }));
+	}
+	SECTION("In front of the occluder") {
+		REQUIRE(!pyramid.IsOccluded({ { -0.9f, -0.5f, 0.2f }, { -0.1f, 0.5f, 0.4f } }));
+	}
+	SECTION("Pokes out from behind the occluder") {
+		REQUIRE(!pyramid.IsOccluded({ { -0.9f, -0.5f, 0.6f }, { 0.1f, 0.5f, 0.8f } }));
+	}
+	SECTION("Nothing in front") {
+		REQUIRE(!pyramid.IsOccluded({ { 0.1f, -0.5f, 0.6f }, { 0.9f, 0.5f, 0.8f } }));
+	}
+	SECTION("Off screen") {
+		REQUIRE(!pyramid.IsOccluded({ { -3.0f, -0.5f, 0.6f }, { -2.0f, 0.5f, 0.8f } }));
+	}
+	SECTION("Crosses the near plane") {
+		REQUIRE(!pyramid.IsOccluded({ { -0.9f, -0.5f, -0.1f }, { -0.1f, 0.5f, 0.8f } }));
+	}
+	SECTION("Empty pyramid") {
+		pyramid.Clear();
+		REQUIRE(!pyramid.IsOccluded({ { -0.9f, -0.5f, 0.6f }, { -0.1f, 0.5f, 0.8f } }));
+	}
+}
+
+
+TEST_CASE("DepthPyramid perspective occlusion", "[GraphicsEngine]") {
+	// Perspective projection with near 1 and far 100, looking down +Z.
+	const float n = 1.0f, f = 100.0f;
+	Mat44 projection = {
+		1, 0, 0, 0,
+		0, 1, 0, 0,
+		0, 0, f / (f - n), 1,
+		0, 0, -n * f / (f - n), 0,
+	};
+	// A wall at z = 10 over the whole screen.
+	float wallDepth = (10.0f * f / (f - n) - n * f / (f - n)) / 10.0f;
+	std::vector<float> depth(32 * 32, wallDepth);
+	DepthPyramid pyramid;
+	pyramid.Assign(depth.data(), 32, 32, 32, { 32.0f, 32.0f }, projection);
+
+	REQUIRE(pyramid.IsOccluded({ { -1.0f, -1.0f, 20.0f }, { 1.0f, 1.0f, 22.0f } }));
+	REQUIRE(!pyramid.IsOccluded({ { -1.0f, -1.0f, 5.0f }, { 1.0f, 1.0f, 22.0f } }));
+	REQUIRE(!pyramid.IsOccluded({ { -1.0f, -1.0f, -5.0f }, { 1.0f, 1.0f, 22.0f } }));
+}
@@ -0,0 +1,53 @@
+#include <GraphicsApi_Null/GxapiManager.hpp>
+#include <GraphicsApi_LL/IGraphicsApi.hpp>
+#include <GraphicsEngine_LL/DynamicBufferRing.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <memory>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("Dynamic buffer ranges of a frame do not overlap", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	DynamicBufferRing ring(api.get());
+	ring.OnFrameBeginHost(1);
+
+	TransientVertexBuffer vertices = ring.AllocateVertices(100);
+	TransientIndexBuffer indices = ring.AllocateIndices(30, false);
+	REQUIRE(vertices.buffer.GetHeap() == eResourceHeap::UPLOAD);
+	REQUIRE(indices.buffer.GetIndexCount() == 30);
+	REQUIRE(static_cast<uint8_t*>(indices.data) >= static_cast<uint8_t*>(vertices.data) + 100);
+	REQUIRE((reinterpret_cast<uintptr_t>(indices.data) - reinterpret_cast<uintptr_t>(vertices.data)) % 16 == 0);
+	REQUIRE(ring.GetFrameUsage() == 160);
+}
+
+
+TEST_CASE("Dynamic buffer pages are reused once their frame finished", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	DynamicBufferRing ring(api.get());
+
+	ring.OnFrameBeginHost(1);
+	void* first = ring.AllocateVertices(64).data;
+	const size_t capacity = ring.GetCapacity();
+
+	// Frame 1 is still in flight, frame 2 gets new memory.
+	ring.OnFrameBeginHost(2);
+	REQUIRE(ring.GetFrameUsage() == 0);
+	REQUIRE(ring.AllocateVertices(64).data != first);
+
+	// Once it finished, its page starts over.
+	ring.OnFrameCompleteDevice(1);
+	ring.OnFrameCompleteDevice(2);
+	ring.OnFrameBeginHost(3);
+	REQUIRE(ring.AllocateVertices(64).data == first);
+	REQUIRE(ring.GetCapacity() == capacity);
+
+	// Allocations larger than a page get a page of their own.
+	REQUIRE(ring.AllocateVertices(3 * capacity).data != nullptr);
+	REQUIRE(ring.GetCapacity() == 4 * capacity);
+}
@@ -0,0 +1,82 @@
+#include <GraphicsEngine_LL/DynamicResolution.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+static DynamicResolutionDesc TestDesc() {
+	DynamicResolutionDesc desc;
+	desc.enabled = true;
+	desc.budgetMilliseconds = 10.0;
+	desc.minScale = 0.5f;
+	desc.maxScale = 1.0f;
+	desc.step = 0.1f;
+	return desc;
+}
+
+
+TEST_CASE("Dynamic resolution is off by default", "[GraphicsEngine]") {
+	DynamicResolution controller;
+	REQUIRE(controller.Update(1, 100.0, 4) == 1.0f);
+}
+
+
+TEST_CASE("Dynamic resolution drops at once on a spike", "[GraphicsEngine]") {
+	DynamicResolution controller(TestDesc());
+	REQUIRE(controller.GetScale() == Approx(1.0f));
+
+	// Four times the budget needs half the pixels in each direction, and a little more for the margin.
+	float scale = controller.Update(10, 40.0, 13);
+	REQUIRE(scale == Approx(0.5f));
+
+	// Frames recorded before the change don't count.
+	REQUIRE(controller.Update(12, 40.0, 15) == Approx(0.5f));
+
+	// Never below the minimum.
+	REQUIRE(controller.Update(13, 40.0, 16) == Approx(0.5f));
+}
+
+
+TEST_CASE("Dynamic resolution drops at least a step", "[GraphicsEngine]") {
+	DynamicResolution controller(TestDesc());
+	REQUIRE(controller.Update(10, 10.5, 13) == Approx(0.9f));
+}
+
+
+TEST_CASE("Dynamic resolution raises slowly", "[GraphicsEngine]") {
+	DynamicResolution controller(TestDesc());
+	controller.Update(10, 40.0, 13);
+	REQUIRE(controller.GetScale() == Approx(0.5f));
+
+	// The next step must fit in the headroom for a while.
+	uint64_t frame = 13;
+	for (unsigned i = 0; i < DynamicResolution::RaiseDelay - 1; ++i, ++frame) {
+		REQUIRE(controller.Update(frame, 4.0, frame + 3) == Approx(0.5f));
+	}
+	REQUIRE(controller.Update(frame, 4.0, frame + 3) == Approx(0.6f));
+
+	// Repeated measurements of the same frame are ignored.
+	DynamicResolution other(TestDesc());
+	other.Update(10, 40.0, 13);
+	for (unsigned i = 0; i < DynamicResolution::RaiseDelay; ++i) {
+		other.Update(13, 4.0, 16 + i);
+	}
+	REQUIRE(other.GetScale() == Approx(0.5f));
+
+	// Not raised when the next step would not fit.
+	DynamicResolution full(TestDesc());
+	full.Update(10, 40.0, 13);
+	for (uint64_t i = 13; i < 13 + 2 * DynamicResolution::RaiseDelay; ++i) {
+		full.Update(i, 7.0, i + 3);
+	}
+	REQUIRE(full.GetScale() == Approx(0.5f));
+}
+
+
+TEST_CASE("Dynamic resolution scales sizes", "[GraphicsEngine]") {
+	REQUIRE(DynamicResolution::ScaleSize(1920, 0.5f) == 960);
+	REQUIRE(DynamicResolution::ScaleSize(1080, 0.75f) == 810);
+	REQUIRE(DynamicResolution::ScaleSize(1, 0.1f) == 1);
+}
@@ -0,0 +1,44 @@
+#include <GraphicsEngine/Scene/EntityCollection.hpp>
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("EntityCollection - Add and remove", "[EntityCollection]") {
+	std::vector<int> entities(8);
+	EntityCollection<int> collection;
+	for (auto& entity : entities) {
+		collection.Add(&entity);
+	}
+	REQUIRE(collection.Size() == 8);
+	REQUIRE_THROWS_AS(collection.Add(&entities[3]), InvalidArgumentException);
+
+	collection.Remove(&entities[0]);
+	collection.Remove(&entities[5]);
+	collection.Remove(&entities[7]);
+	collection.Remove(&entities[7]);
+	REQUIRE(collection.Size() == 5);
+	REQUIRE(!collection.Contains(&entities[0]));
+	REQUIRE(!collection.Contains(&entities[5]));
+	REQUIRE(!collection.Contains(&entities[7]));
+
+	// Remaining entities are all reachable by iteration and lookup.
+	std::vector<const int*> remaining(collection.begin(), collection.end());
+	std::sort(remaining.begin(), remaining.end());
+	REQUIRE(remaining == std::vector<const int*>{ &entities[1], &entities[2], &entities[3], &entities[4], &entities[6] });
+	for (size_t i = 0; i < collection.Size(); ++i) {
+		REQUIRE(collection.Contains(collection[i]));
+		REQUIRE(collection.Data()[i] == collection[i]);
+	}
+
+	collection.Clear();
+	REQUIRE(collection.IsEmpty());
+	collection.Add(&entities[0]);
+	REQUIRE(collection.Contains(&entities[0]));
+}
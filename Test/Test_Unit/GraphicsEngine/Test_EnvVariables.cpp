@@ -0,0 +1,56 @@
+#include <GraphicsEngine_LL/EnvVariables.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("Env variable handles are valid before the value is set", "[GraphicsEngine]") {
+	EnvVariables variables;
+	REQUIRE(!variables.Find("exposure").IsValid());
+
+	EnvVariableHandle handle = variables.Intern("exposure");
+	REQUIRE(handle.IsValid());
+	REQUIRE(variables.Intern("exposure") == handle);
+	REQUIRE(variables.Find("exposure") == handle);
+	REQUIRE(!variables.HasValue(handle));
+	REQUIRE(variables.GetVersion(handle) == 0);
+	REQUIRE_THROWS_AS(variables.Get(handle), InvalidArgumentException);
+
+	REQUIRE(variables.Set("exposure", Any(1.5f)));
+	REQUIRE(variables.HasValue(handle));
+	REQUIRE(variables.Get(handle).Get<float>() == 1.5f);
+	REQUIRE(variables.GetName(handle) == "exposure");
+}
+
+
+TEST_CASE("Env variable versions change on set", "[GraphicsEngine]") {
+	EnvVariables variables;
+	EnvVariableHandle exposure = variables.Intern("exposure");
+	EnvVariableHandle bloom = variables.Intern("bloom.enabled");
+
+	REQUIRE(variables.Set(exposure, Any(1.0f)));
+	uint64_t exposureVersion = variables.GetVersion(exposure);
+	REQUIRE(exposureVersion != 0);
+
+	REQUIRE(variables.Set(bloom, Any(false)));
+	REQUIRE(variables.GetVersion(exposure) == exposureVersion);
+	REQUIRE(variables.GetVersion() == variables.GetVersion(bloom));
+
+	REQUIRE(!variables.Set(exposure, Any(2.0f)));
+	REQUIRE(variables.GetVersion(exposure) > exposureVersion);
+}
+
+
+TEST_CASE("Env variable typed access", "[GraphicsEngine]") {
+	EnvVariables variables;
+	EnvVariableHandle handle = variables.Intern("bloom.enabled");
+	REQUIRE(variables.GetIf<bool>(handle) == nullptr);
+
+	variables.Set(handle, Any(true));
+	REQUIRE(variables.GetIf<bool>(handle) != nullptr);
+	REQUIRE(*variables.GetIf<bool>(handle));
+	REQUIRE(variables.GetIf<float>(handle) == nullptr);
+	REQUIRE(variables.GetIf<bool>(EnvVariableHandle{}) == nullptr);
+}
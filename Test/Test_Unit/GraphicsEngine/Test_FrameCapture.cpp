@@ -0,0 +1,123 @@
+#include <GraphicsEngine_LL/FrameCapture.hpp>
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <sstream>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+static FrameCapture MakeCapture() {
+	FrameCapture capture;
+	capture.frame = 120;
+	capture.elapsed = 0.016f;
+	capture.width = 1280;
+	capture.height = 720;
+	capture.pipeline = R"({ "nodes": [] })";
+
+	capture.meshes.push_back({ "rock.fbx", 24, { 36, 12 }, BoundingBox({ -1, -1, -1 }, { 1, 1, 2 }) });
+	FrameCapture::ImageDesc image;
+	image.name = "rock.jpg";
+	image.width = 256;
+	image.height = 128;
+	image.channelType = ePixelChannelType::BC1;
+	image.mipLevels = 8;
+	capture.images.push_back(image);
+	capture.materialShaders.push_back({ "float4 main() { return 1; }" });
+
+	FrameCapture::MaterialDesc material;
+	material.name = "rock.mtl";
+	material.shader = 0;
+	material.parameters.push_back({ "albedo", eMaterialShaderParamType::BITMAP_COLOR_2D, true, {}, 0.0f, 0 });
+	material.parameters.push_back({ "roughness", eMaterialShaderParamType::VALUE, true, {}, 0.75f, -1 });
+	capture.materials.push_back(material);
+
+	FrameCapture::SceneDesc scene;
+	scene.name = "World";
+	FrameCapture::MeshEntityDesc entity;
+	entity.mesh = 0;
+	entity.material = 0;
+	entity.transform(0, 3) = 5.0f;
+	entity.occluderHint = eOccluderHint::NEVER;
+	scene.meshEntities.push_back(entity);
+	scene.directionalLights.push_back({ { 0, 0.6f, -0.8f }, { 2, 2, 2 } });
+	scene.spotLights.emplace_back().range = 12.0f;
+	capture.scenes.push_back(scene);
+
+	FrameCapture::CameraDesc camera;
+	camera.name = "WorldCam";
+	camera.position = { 1, 2, 3 };
+	camera.fovHorizontal = 1.2f;
+	capture.cameras.push_back(camera);
+
+	capture.envVariables.push_back({ "Shadows.enabled", false });
+	capture.envVariables.push_back({ "exposure", 1.5f });
+	capture.envVariables.push_back({ "sunColor", Vec3{ 1, 0.9f, 0.8f } });
+	capture.envVariables.push_back({ "environment", FrameCapture::ImageRef{ 0 } });
+	capture.skippedEnvVariables.push_back("physicsWorld");
+	return capture;
+}
+
+
+static FrameCapture RoundTrip(const FrameCapture& capture) {
+	std::stringstream stream;
+	capture.Write(stream);
+	return FrameCapture::Read(stream);
+}
+
+
+TEST_CASE("Frame captures read back what they wrote", "[GraphicsEngine]") {
+	const FrameCapture capture = MakeCapture();
+	const FrameCapture read = RoundTrip(capture);
+
+	REQUIRE(read.frame == 120);
+	REQUIRE(read.elapsed == Approx(0.016f));
+	REQUIRE(read.width == 1280);
+	REQUIRE(read.pipeline == capture.pipeline);
+
+	REQUIRE(read.meshes.size() == 1);
+	REQUIRE(read.meshes[0].lodIndexCounts == std::vector<uint32_t>{ 36, 12 });
+	REQUIRE(read.meshes[0].localBounds.upper.z == 2.0f);
+	REQUIRE(read.images[0].channelType == ePixelChannelType::BC1);
+	REQUIRE(read.images[0].mipLevels == 8);
+	REQUIRE(read.materialShaders[0].code == capture.materialShaders[0].code);
+	REQUIRE(read.materials[0].parameters[0].image == 0);
+	REQUIRE(read.materials[0].parameters[1].value == 0.75f);
+
+	const FrameCapture::MeshEntityDesc& entity = read.scenes[0].meshEntities[0];
+	REQUIRE(entity.transform(0, 3) == 5.0f);
+	REQUIRE(entity.transform(1, 1) == 1.0f);
+	REQUIRE(entity.occluderHint == eOccluderHint::NEVER);
+	REQUIRE(read.scenes[0].directionalLights[0].direction.y == Approx(0.6f));
+	REQUIRE(read.scenes[0].spotLights[0].range == 12.0f);
+	REQUIRE(read.cameras[0].fovHorizontal == Approx(1.2f));
+
+	REQUIRE(read.envVariables.size() == 4);
+	REQUIRE(read.envVariables[0].value == FrameCapture::EnvValue{ false });
+	REQUIRE(std::get<float>(read.envVariables[1].value) == 1.5f);
+	REQUIRE(std::get<Vec3>(read.envVariables[2].value).y == Approx(0.9f));
+	REQUIRE(std::get<FrameCapture::ImageRef>(read.envVariables[3].value).image == 0);
+	REQUIRE(read.skippedEnvVariables == std::vector<std::string>{ "physicsWorld" });
+}
+
+
+TEST_CASE("Frame captures keep binary pipelines", "[GraphicsEngine]") {
+	FrameCapture capture = MakeCapture();
+	capture.pipeline = std::string("INLPIPEB\0\x01\xff", 11);
+	REQUIRE(RoundTrip(capture).pipeline == capture.pipeline);
+}
+
+
+TEST_CASE("Frame captures refuse ids out of range", "[GraphicsEngine]") {
+	FrameCapture capture = MakeCapture();
+	capture.scenes[0].meshEntities[0].material = 3;
+	std::stringstream stream;
+	capture.Write(stream);
+	REQUIRE_THROWS_AS(FrameCapture::Read(stream), InvalidArgumentException);
+
+	std::stringstream truncated(R"({ "frame": 1 })");
+	REQUIRE_THROWS_AS(FrameCapture::Read(truncated), InvalidArgumentException);
+}
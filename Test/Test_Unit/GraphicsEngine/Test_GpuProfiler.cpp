@@ -0,0 +1,44 @@
+#include <GraphicsEngine_LL/GpuProfiler.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("GPU profiler sums scopes per node", "[GraphicsEngine]") {
+	std::vector<GpuNodeReport> nodes;
+	GpuProfiler::FindOrAdd(nodes, "Shadows").milliseconds += GpuProfiler::ToMilliseconds(1000, 3000, 1000000);
+	GpuProfiler::FindOrAdd(nodes, "Forward").milliseconds += GpuProfiler::ToMilliseconds(3000, 4000, 1000000);
+	GpuProfiler::FindOrAdd(nodes, "Shadows").milliseconds += GpuProfiler::ToMilliseconds(4000, 5000, 1000000); // Secondary list of the same node.
+	GpuProfiler::FindOrAdd(nodes, "Tonemap").milliseconds += GpuProfiler::ToMilliseconds(5000, 4000, 1000000); // Disjoint timestamps don't go negative.
+
+	REQUIRE(nodes.size() == 3);
+	REQUIRE(nodes[0].name == "Shadows");
+	REQUIRE(nodes[0].milliseconds == Approx(3.0));
+	REQUIRE(nodes[1].name == "Forward");
+	REQUIRE(nodes[1].milliseconds == Approx(1.0));
+	REQUIRE(nodes[2].name == "Tonemap");
+	REQUIRE(nodes[2].milliseconds == 0.0);
+}
+
+
+TEST_CASE("GPU profiler sums counters and statistics", "[GraphicsEngine]") {
+	GpuNodeReport node;
+	CommandListCounters counters;
+	counters.numDrawCalls = 3;
+	GpuProfiler::Accumulate(node, counters);
+	GpuProfiler::Accumulate(node, counters);
+
+	gxapi::PipelineStatistics statistics = {};
+	statistics.inputVertices = 300;
+	statistics.pixelShaderInvocations = 1000;
+	GpuProfiler::Accumulate(node, statistics);
+	GpuProfiler::Accumulate(node, statistics);
+
+	REQUIRE(node.counters.numDrawCalls == 6);
+	REQUIRE(node.counters.numKernels == 0);
+	REQUIRE(node.statistics.inputVertices == 600);
+	REQUIRE(node.statistics.pixelShaderInvocations == 2000);
+	REQUIRE(node.statistics.computeShaderInvocations == 0);
+}
@@ -0,0 +1,116 @@
+#include <GraphicsEngine_LL/ImageAtlas.hpp>
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <vector>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+namespace {
+
+class FakeImage : public IImage {
+public:
+	FakeImage(size_t width, size_t height) : m_width(width), m_height(height) {}
+
+	size_t GetWidth() const override { return m_width; }
+	size_t GetHeight() const override { return m_height; }
+	ePixelChannelType GetChannelType() const override { return ePixelChannelType::INT8_NORM; }
+	int GetChannelCount() const override { return 4; }
+	ePixelClass GetPixelClass() const override { return ePixelClass::LINEAR; }
+
+	void SetLayout(uint64_t, uint32_t, ePixelChannelType, int, ePixelClass) override {}
+	void SetLayout(uint64_t, uint32_t, ePixelChannelType, int, ePixelClass, int) override {}
+	void SetMipGeneration(eMipFilter, bool) override {}
+	void Update(uint64_t x, uint32_t y, uint64_t width, uint32_t height, int, const void*, const IPixelReader&, size_t) override {
+		updates.push_back(RectI::FromSize((int)y, (int)x, (int)width, (int)height));
+	}
+	void UpdateCompressed(int, const void*, size_t) override {}
+
+	std::vector<RectI> updates;
+
+private:
+	size_t m_width, m_height;
+};
+
+} // namespace
+
+
+TEST_CASE("Atlas places do not overlap", "[GraphicsEngine]") {
+	FakeImage image(64, 64);
+	ImageAtlas atlas(&image, 1);
+
+	std::vector<RectI> places;
+	for (unsigned size : { 10u, 7u, 12u, 10u, 5u, 9u, 16u, 3u }) {
+		auto place = atlas.Allocate(size, size);
+		REQUIRE(place);
+		REQUIRE(place->GetWidth() == (int)size);
+		REQUIRE(place->GetHeight() == (int)size);
+		REQUIRE(place->left >= 1);
+		REQUIRE(place->bottom >= 1);
+		REQUIRE(place->right <= 63);
+		REQUIRE(place->top <= 63);
+		for (const auto& other : places) {
+			// Padding included.
+			bool separateX = place->right + 1 <= other.left || other.right + 1 <= place->left;
+			bool separateY = place->top + 1 <= other.bottom || other.top + 1 <= place->bottom;
+			REQUIRE((separateX || separateY));
+		}
+		places.push_back(*place);
+	}
+}
+
+
+TEST_CASE("Atlas reuses shelves of the same height", "[GraphicsEngine]") {
+	FakeImage image(64, 64);
+	ImageAtlas atlas(&image, 1);
+
+	auto first = atlas.Allocate(20, 10);
+	auto tall = atlas.Allocate(10, 20);
+	auto second = atlas.Allocate(20, 10);
+	REQUIRE(first);
+	REQUIRE(tall);
+	REQUIRE(second);
+	REQUIRE(second->bottom == first->bottom);
+	REQUIRE(second->left == first->right + 1);
+	REQUIRE(tall->bottom > first->top);
+}
+
+
+TEST_CASE("Atlas reports when full", "[GraphicsEngine]") {
+	FakeImage image(32, 32);
+	ImageAtlas atlas(&image, 1);
+
+	REQUIRE(!atlas.Allocate(40, 4));
+	REQUIRE(!atlas.Allocate(0, 4));
+
+	int count = 0;
+	while (atlas.Allocate(14, 14)) {
+		++count;
+	}
+	REQUIRE(count == 4);
+
+	atlas.Clear();
+	REQUIRE(atlas.Allocate(14, 14));
+}
+
+
+TEST_CASE("Atlas uploads pixels and returns texture rects", "[GraphicsEngine]") {
+	FakeImage image(64, 32);
+	ImageAtlas atlas(&image, 0);
+
+	uint32_t pixels[8 * 4] = {};
+	auto rect = atlas.Add(8, 4, pixels, Pixel<ePixelChannelType::INT8_NORM, 4, ePixelClass::LINEAR>::Reader());
+	REQUIRE(rect);
+	REQUIRE(image.updates.size() == 1);
+	REQUIRE(image.updates[0] == RectI(0, 8, 0, 4));
+	REQUIRE(rect->left == Approx(0.0f));
+	REQUIRE(rect->right == Approx(8.0f / 64.0f));
+	REQUIRE(rect->bottom == Approx(0.0f));
+	REQUIRE(rect->top == Approx(4.0f / 32.0f));
+
+	REQUIRE_THROWS_AS(ImageAtlas(nullptr), InvalidArgumentException);
+}
@@ -0,0 +1,89 @@
+#include <GraphicsEngine_LL/InstanceBatcher.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("InstanceBatcher merges neighbours", "[GraphicsEngine]") {
+	// Batching only compares pointers, they are never dereferenced.
+	Mesh* meshA = reinterpret_cast<Mesh*>(0x10);
+	Mesh* meshB = reinterpret_cast<Mesh*>(0x20);
+	Material* material = reinterpret_cast<Material*>(0x30);
+
+	auto translation = [](float x) {
+		Mat44 m = Mat44::Identity();
+		m(3, 0) = x;
+		return m;
+	};
+
+	InstanceBatcher batcher;
+	batcher.Add(meshA, material, translation(1));
+	batcher.Add(meshA, material, translation(2));
+	batcher.Add(meshA, nullptr, translation(3));
+	batcher.Add(meshB, nullptr, translation(4));
+	batcher.Add(meshB, nullptr, translation(5));
+	batcher.Add(meshA, material, translation(6));
+
+	const auto& batches = batcher.GetBatches();
+	REQUIRE(batches.size() == 4);
+	REQUIRE(batcher.GetInstanceCount() == 6);
+
+	REQUIRE(batches[0].mesh == meshA);
+	REQUIRE(batches[0].material == material);
+	REQUIRE(batches[0].firstInstance == 0);
+	REQUIRE(batches[0].instanceCount == 2);
+
+	REQUIRE(batches[1].firstInstance == 2);
+	REQUIRE(batches[1].instanceCount == 1);
+
+	REQUIRE(batches[2].mesh == meshB);
+	REQUIRE(batches[2].firstInstance == 3);
+	REQUIRE(batches[2].instanceCount == 2);
+
+	REQUIRE(batches[3].firstInstance == 5);
+	REQUIRE(batches[3].instanceCount == 1);
+
+	for (size_t i = 0; i < 6; ++i) {
+		REQUIRE(batcher.GetTransforms()[i](3, 0) == float(i + 1));
+	}
+
+	batcher.Clear();
+	REQUIRE(batcher.GetBatches().empty());
+	REQUIRE(batcher.GetInstanceCount() == 0);
+}
+
+
+TEST_CASE("InstanceBatcher split", "[GraphicsEngine]") {
+	Mesh* mesh = reinterpret_cast<Mesh*>(0x10);
+
+	InstanceBatcher batcher;
+	batcher.Add(mesh, nullptr, Mat44::Identity());
+	batcher.Split();
+	batcher.Split();
+	batcher.Add(mesh, nullptr, Mat44::Identity());
+	batcher.Add(mesh, nullptr, Mat44::Identity());
+
+	const auto& batches = batcher.GetBatches();
+	REQUIRE(batches.size() == 2);
+	REQUIRE(batches[0].instanceCount == 1);
+	REQUIRE(batches[1].firstInstance == 1);
+	REQUIRE(batches[1].instanceCount == 2);
+}
+
+
+TEST_CASE("InstanceBatcher keeps views apart", "[GraphicsEngine]") {
+	Mesh* mesh = reinterpret_cast<Mesh*>(0x10);
+
+	InstanceBatcher batcher;
+	batcher.Add(mesh, nullptr, Mat44::Identity(), 0, nullptr, 0b01);
+	batcher.Add(mesh, nullptr, Mat44::Identity(), 0, nullptr, 0b01);
+	batcher.Add(mesh, nullptr, Mat44::Identity(), 0, nullptr, 0b11);
+
+	const auto& batches = batcher.GetBatches();
+	REQUIRE(batches.size() == 2);
+	REQUIRE(batches[0].viewMask == 0b01);
+	REQUIRE(batches[0].instanceCount == 2);
+	REQUIRE(batches[1].viewMask == 0b11);
+}
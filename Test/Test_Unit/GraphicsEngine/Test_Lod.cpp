@@ -0,0 +1,88 @@
+#include <GraphicsEngine_LL/LodSelector.hpp>
+#include <GraphicsEngine_LL/MeshSimplifier.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <vector>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+static void MakeGrid(int size, std::vector<Vec3>& positions, std::vector<unsigned>& indices) {
+	for (int y = 0; y <= size; ++y) {
+		for (int x = 0; x <= size; ++x) {
+			positions.push_back({ float(x), float(y), 0.0f });
+		}
+	}
+	for (int y = 0; y < size; ++y) {
+		for (int x = 0; x < size; ++x) {
+			unsigned i = y * (size + 1) + x;
+			indices.insert(indices.end(), { i, i + 1, i + size + 2, i, i + size + 2, i + size + 1 });
+		}
+	}
+}
+
+
+TEST_CASE("MeshSimplifier cluster", "[GraphicsEngine]") {
+	std::vector<Vec3> positions;
+	std::vector<unsigned> indices;
+	MakeGrid(8, positions, indices);
+
+	// Cells smaller than the vertex spacing change nothing.
+	REQUIRE(MeshSimplifier::Cluster(positions, indices, 0.5f) == indices);
+
+	std::vector<unsigned> simplified = MeshSimplifier::Cluster(positions, indices, 2.0f);
+	REQUIRE(!simplified.empty());
+	REQUIRE(simplified.size() % 3 == 0);
+	REQUIRE(simplified.size() < indices.size());
+	for (size_t i = 0; i < simplified.size(); i += 3) {
+		REQUIRE(simplified[i] < positions.size());
+		REQUIRE(simplified[i] != simplified[i + 1]);
+		REQUIRE(simplified[i + 1] != simplified[i + 2]);
+		REQUIRE(simplified[i + 2] != simplified[i]);
+
+		// Winding is kept, the grid faces +Z.
+		Vec3 a = positions[simplified[i]], b = positions[simplified[i + 1]], c = positions[simplified[i + 2]];
+		REQUIRE(Cross(b - a, c - a).z > 0.0f);
+	}
+
+	REQUIRE_THROWS(MeshSimplifier::Cluster(positions, indices, 0.0f));
+}
+
+
+TEST_CASE("MeshSimplifier LOD chain", "[GraphicsEngine]") {
+	std::vector<Vec3> positions;
+	std::vector<unsigned> indices;
+	MakeGrid(64, positions, indices);
+
+	auto levels = MeshSimplifier::BuildLodChain(positions, indices, 4);
+	REQUIRE(levels.size() > 1);
+	REQUIRE(levels.size() <= 4);
+	REQUIRE(levels[0] == indices);
+	for (size_t i = 1; i < levels.size(); ++i) {
+		REQUIRE(float(levels[i].size()) <= MeshSimplifier::MaxLevelRatio * float(levels[i - 1].size()));
+	}
+
+	REQUIRE(MeshSimplifier::BuildLodChain(positions, indices, 1).size() == 1);
+}
+
+
+TEST_CASE("LodSelector hysteresis", "[GraphicsEngine]") {
+	const float finest = LodSelector::FinestScreenSize;
+
+	REQUIRE(LodSelector::Select(finest * 2.0f, 4, 0) == 0);
+	REQUIRE(LodSelector::Select(finest / 16.0f, 4, 0) == 3);
+	REQUIRE(LodSelector::Select(finest / 100.0f, 4, 0) == 3);
+	REQUIRE(LodSelector::Select(finest / 100.0f, 1, 0) == 0);
+
+	// Just past a boundary, the previous level stays.
+	REQUIRE(LodSelector::Select(finest / 2.1f, 4, 0) == 0);
+	REQUIRE(LodSelector::Select(finest / 1.9f, 4, 1) == 1);
+	// Well past it, the level changes.
+	REQUIRE(LodSelector::Select(finest / 2.5f, 4, 0) == 1);
+	REQUIRE(LodSelector::Select(finest / 1.5f, 4, 1) == 0);
+
+	// Out of range previous levels are clamped.
+	REQUIRE(LodSelector::Select(finest / 8.0f, 2, 7) == 1);
+}
@@ -1,3 +1,4 @@
+#include <GraphicsEngine_LL/Material.hpp>
 #include <GraphicsEngine_LL/MaterialShader.hpp>
 #include <GraphicsEngine_LL/ShaderManager.hpp>
 #include <BaseLibrary/Exception/Exception.hpp>
@@ -114,4 +115,68 @@ TEST_CASE_METHOD(ShaderManagerFixture, "MaterialShader make graph", "[MaterialSh
 
 	REQUIRE(graph->GetNumInputs() == 5);
 	REQUIRE(graph->GetNumOutputs() == 1);
-}
\ No newline at end of file
+}
+
+TEST_CASE_METHOD(ShaderManagerFixture, "MaterialShader identical graphs share generated code", "[MaterialShader]") {
+	auto MakeNodes = [this](bool swapLinks) {
+		auto add = std::make_unique<MaterialShaderEquation>(&shaderManager);
+		auto sub = std::make_unique<MaterialShaderEquation>(&shaderManager);
+		auto mad = std::make_unique<MaterialShaderEquation>(&shaderManager);
+		add->SetDisplayName("Add");
+		sub->SetDisplayName("Sub");
+		mad->SetDisplayName("Mad");
+		add->SetSourceCode(adderSource);
+		sub->SetSourceCode(subtractorSource);
+		mad->SetSourceCode(mad4Source);
+		add->GetOutput(0)->Link(mad->GetInput(swapLinks ? 1 : 0));
+		sub->GetOutput(0)->Link(mad->GetInput(swapLinks ? 0 : 1));
+
+		std::vector<std::unique_ptr<MaterialShader>> nodes;
+		nodes.push_back(std::move(add));
+		nodes.push_back(std::move(sub));
+		nodes.push_back(std::move(mad));
+		return nodes;
+	};
+
+	MaterialShaderGraph first(&shaderManager);
+	first.SetGraph(MakeNodes(false));
+	MaterialShaderGraph second(&shaderManager);
+	second.SetGraph(MakeNodes(false));
+	MaterialShaderGraph swapped(&shaderManager);
+	swapped.SetGraph(MakeNodes(true));
+
+	REQUIRE(second.GetShaderCode() == first.GetShaderCode());
+	REQUIRE(second.GetId() == first.GetId());
+	REQUIRE(second.GetNumInputs() == first.GetNumInputs());
+	REQUIRE(second.GetNumOutputs() == first.GetNumOutputs());
+	for (size_t i = 0; i < first.GetNumInputs(); ++i) {
+		REQUIRE(second.GetInput(i)->name == first.GetInput(i)->name);
+		REQUIRE(second.GetInput(i)->type == first.GetInput(i)->type);
+		REQUIRE(second.GetInput(i)->index == first.GetInput(i)->index);
+	}
+	REQUIRE(swapped.GetShaderCode() != first.GetShaderCode());
+}
+
+
+TEST_CASE_METHOD(ShaderManagerFixture, "Material version changes with its parameters", "[MaterialShader]") {
+	MaterialShaderEquation shader(&shaderManager);
+	shader.SetSourceCode(adderSource);
+
+	Material material;
+	material.SetShader(&shader);
+	const uint64_t initial = material.GetVersion();
+	material["a"] = 1.0f;
+	const uint64_t assigned = material.GetVersion();
+	REQUIRE(assigned != initial);
+
+	Material copy = material;
+	REQUIRE(copy.GetVersion() != assigned);
+	copy["b"] = 2.0f;
+	REQUIRE(material.GetVersion() == assigned);
+
+	material = std::move(copy);
+	const uint64_t moved = material.GetVersion();
+	material["b"] = 3.0f;
+	REQUIRE(material.GetVersion() != moved);
+	REQUIRE((float)material["a"] == 1.0f);
+}
@@ -0,0 +1,130 @@
+#include <GraphicsEngine_LL/MeshOptimizer.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+static void MakeShuffledGrid(int size, std::vector<Vec3>& positions, std::vector<unsigned>& indices) {
+	for (int y = 0; y <= size; ++y) {
+		for (int x = 0; x <= size; ++x) {
+			positions.push_back({ float(x), float(y), 0.0f });
+		}
+	}
+	std::vector<std::array<unsigned, 3>> triangles;
+	for (int y = 0; y < size; ++y) {
+		for (int x = 0; x < size; ++x) {
+			unsigned i = y * (size + 1) + x;
+			triangles.push_back({ i, i + 1, i + size + 2 });
+			triangles.push_back({ i, i + size + 2, i + size + 1 });
+		}
+	}
+	std::shuffle(triangles.begin(), triangles.end(), std::mt19937(42));
+	for (const auto& triangle : triangles) {
+		indices.insert(indices.end(), triangle.begin(), triangle.end());
+	}
+}
+
+
+static std::vector<std::array<unsigned, 3>> SortedTriangles(const std::vector<unsigned>& indices) {
+	std::vector<std::array<unsigned, 3>> triangles;
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		triangles.push_back({ indices[i], indices[i + 1], indices[i + 2] });
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+
+TEST_CASE("MeshOptimizer vertex cache", "[GraphicsEngine]") {
+	std::vector<Vec3> positions;
+	std::vector<unsigned> indices;
+	MakeShuffledGrid(32, positions, indices);
+
+	std::vector<unsigned> optimized = MeshOptimizer::OptimizeVertexCache(indices, positions.size());
+	REQUIRE(SortedTriangles(optimized) == SortedTriangles(indices));
+
+	float before = MeshOptimizer::AverageCacheMissRatio(indices, positions.size());
+	float after = MeshOptimizer::AverageCacheMissRatio(optimized, positions.size());
+	REQUIRE(after < 0.5f * before);
+	REQUIRE(after < 1.0f);
+
+	REQUIRE(MeshOptimizer::OptimizeVertexCache({}, 0).empty());
+	REQUIRE_THROWS(MeshOptimizer::OptimizeVertexCache({ 0, 1 }, 2));
+	REQUIRE_THROWS(MeshOptimizer::OptimizeVertexCache({ 0, 1, 2 }, 2));
+}
+
+
+TEST_CASE("MeshOptimizer overdraw keeps triangles and cache efficiency", "[GraphicsEngine]") {
+	std::vector<Vec3> positions;
+	std::vector<unsigned> indices;
+	MakeShuffledGrid(32, positions, indices);
+	indices = MeshOptimizer::OptimizeVertexCache(indices, positions.size());
+
+	std::vector<unsigned> reordered = MeshOptimizer::OptimizeOverdraw(indices, positions, 1.05f);
+	REQUIRE(SortedTriangles(reordered) == SortedTriangles(indices));
+
+	float before = MeshOptimizer::AverageCacheMissRatio(indices, positions.size());
+	float after = MeshOptimizer::AverageCacheMissRatio(reordered, positions.size());
+	REQUIRE(after <= 1.05f * before + 0.05f);
+}
+
+
+TEST_CASE("MeshOptimizer vertex fetch", "[GraphicsEngine]") {
+	std::vector<std::vector<unsigned>> lodIndices = {
+		{ 4, 2, 0, 0, 2, 5 },
+		{ 4, 2, 5, 1, 4, 5 },
+	};
+	std::vector<unsigned> remap = MeshOptimizer::OptimizeVertexFetch(lodIndices, 7);
+
+	// Vertex 3 and 6 are unused, they go to the end.
+	REQUIRE(remap == std::vector<unsigned>{ 2, 4, 1, 5, 0, 3, 6 });
+	REQUIRE(lodIndices[0] == std::vector<unsigned>{ 0, 1, 2, 2, 1, 3 });
+	REQUIRE(lodIndices[1] == std::vector<unsigned>{ 0, 1, 3, 4, 0, 3 });
+}
+
+
+TEST_CASE("MeshOptimizer meshlets", "[GraphicsEngine]") {
+	std::vector<Vec3> positions;
+	std::vector<unsigned> indices;
+	MakeShuffledGrid(32, positions, indices);
+	indices = MeshOptimizer::OptimizeVertexCache(indices, positions.size());
+
+	std::vector<Meshlet> meshlets = MeshOptimizer::BuildMeshlets(indices, positions, 12);
+	REQUIRE(!meshlets.empty());
+
+	uint32_t next = 12;
+	for (const Meshlet& meshlet : meshlets) {
+		// Consecutive runs that cover all triangles.
+		REQUIRE(meshlet.firstIndex == next);
+		REQUIRE(meshlet.indexCount % 3 == 0);
+		REQUIRE(meshlet.indexCount <= 3 * MeshOptimizer::MeshletMaxTriangles);
+		next += meshlet.indexCount;
+
+		auto first = indices.begin() + (meshlet.firstIndex - 12);
+		std::vector<unsigned> vertices(first, first + meshlet.indexCount);
+		std::sort(vertices.begin(), vertices.end());
+		vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+		REQUIRE(vertices.size() <= MeshOptimizer::MeshletMaxVertices);
+		for (unsigned vertex : vertices) {
+			REQUIRE((positions[vertex] - Vec3(meshlet.center)).Length() <= meshlet.radius + 1e-4f);
+		}
+
+		// The grid is flat and faces +Z.
+		REQUIRE(meshlet.coneAxis.z == Approx(1.0f));
+		REQUIRE(meshlet.coneCutoff == Approx(0.0f).margin(1e-3f));
+	}
+	REQUIRE(next == 12 + indices.size());
+
+	// Vertex cache order keeps the meshlets nearly full.
+	REQUIRE(meshlets.size() < 1.5f * indices.size() / 3 / MeshOptimizer::MeshletMaxTriangles);
+
+	REQUIRE(MeshOptimizer::BuildMeshlets({}, positions).empty());
+	REQUIRE_THROWS(MeshOptimizer::BuildMeshlets({ 0, 1, 2 }, positions, 0, 2, 1));
+}
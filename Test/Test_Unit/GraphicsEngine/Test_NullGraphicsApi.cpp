@@ -0,0 +1,135 @@
+#include <GraphicsApi_Null/CommandList.hpp>
+#include <GraphicsApi_Null/CommandQueue.hpp>
+#include <GraphicsApi_Null/DescriptorHeap.hpp>
+#include <GraphicsApi_Null/GraphicsApi.hpp>
+#include <GraphicsApi_Null/GxapiManager.hpp>
+#include <GraphicsApi_LL/ICommandAllocator.hpp>
+#include <GraphicsApi_LL/IFence.hpp>
+#include <GraphicsApi_LL/IQueryHeap.hpp>
+#include <GraphicsApi_LL/IResource.hpp>
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <chrono>
+#include <memory>
+
+using namespace inl;
+using namespace inl::gxapi_null;
+
+
+TEST_CASE("Null command lists record their commands", "[GraphicsEngine]") {
+	GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	std::unique_ptr<gxapi::ICommandAllocator> allocator(api->CreateCommandAllocator(gxapi::eCommandListType::GRAPHICS));
+	std::unique_ptr<gxapi::IGraphicsCommandList> list(api->CreateGraphicsCommandList({ allocator.get() }));
+
+	const uint32_t constants[] = { 1, 2, 3 };
+	list->SetGraphicsRootConstants(0, 4, 3, constants);
+	list->DrawInstanced(3);
+	list->DrawIndexedInstanced(36, 0, 0, 10);
+	list->BeginDebuggerEvent("Shadows");
+	list->Dispatch(8, 8);
+	list->EndDebuggerEvent();
+	list->Close();
+
+	const CommandStream& stream = dynamic_cast<BasicCommandList&>(*list).GetCommands();
+	REQUIRE(stream.Count(eCommand::DRAW_INSTANCED) == 1);
+	REQUIRE(stream.Count(eCommand::DRAW_INDEXED_INSTANCED) == 1);
+	REQUIRE(stream.Count(eCommand::DISPATCH) == 1);
+	REQUIRE(stream.commands.front().type == eCommand::SET_ROOT_CONSTANTS);
+	REQUIRE(stream.commands.front().values[3] == HashRootConstants(constants, 3));
+	REQUIRE(stream.commands[2].values[3] == 10);
+	REQUIRE(stream.eventNames == std::vector<std::string>{ "Shadows" });
+
+	// Reset starts over, the closed stream stays with whoever held it.
+	auto executed = dynamic_cast<BasicCommandList&>(*list).GetSharedCommands();
+	list->Reset(allocator.get());
+	REQUIRE(executed->Count(eCommand::DISPATCH) == 1);
+	REQUIRE(dynamic_cast<BasicCommandList&>(*list).GetCommands().Count(eCommand::DISPATCH) == 0);
+}
+
+
+TEST_CASE("Null queues signal after the simulated latency", "[GraphicsEngine]") {
+	SimulationDesc simulation;
+	simulation.submitLatency = std::chrono::milliseconds(20);
+	GxapiManager manager(simulation);
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	std::unique_ptr<gxapi::ICommandQueue> queue(api->CreateCommandQueue({ gxapi::eCommandListType::GRAPHICS }));
+	std::unique_ptr<gxapi::ICommandAllocator> allocator(api->CreateCommandAllocator(gxapi::eCommandListType::GRAPHICS));
+	std::unique_ptr<gxapi::IGraphicsCommandList> list(api->CreateGraphicsCommandList({ allocator.get() }));
+	std::unique_ptr<gxapi::IFence> fence(api->CreateFence(0));
+
+	list->DrawInstanced(3);
+	list->Close();
+	gxapi::ICommandList* lists[] = { list.get() };
+
+	const auto start = std::chrono::steady_clock::now();
+	queue->ExecuteCommandLists(1, lists);
+	queue->Signal(fence.get(), 1);
+	REQUIRE(fence->Fetch() == 0);
+
+	fence->Wait(1);
+	REQUIRE(std::chrono::steady_clock::now() - start >= simulation.submitLatency);
+	REQUIRE(fence->Fetch() == 1);
+}
+
+
+TEST_CASE("Null timestamps resolve into readback buffers", "[GraphicsEngine]") {
+	GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	std::unique_ptr<gxapi::ICommandQueue> queue(api->CreateCommandQueue({ gxapi::eCommandListType::GRAPHICS }));
+	std::unique_ptr<gxapi::ICommandAllocator> allocator(api->CreateCommandAllocator(gxapi::eCommandListType::GRAPHICS));
+	std::unique_ptr<gxapi::IGraphicsCommandList> list(api->CreateGraphicsCommandList({ allocator.get() }));
+	std::unique_ptr<gxapi::IFence> fence(api->CreateFence(0));
+	std::unique_ptr<gxapi::IQueryHeap> queries(api->CreateQueryHeap({ gxapi::eQueryHeapType::TIMESTAMP, 2 }));
+	std::unique_ptr<gxapi::IResource> readback(api->CreateCommittedResource(gxapi::HeapProperties{ gxapi::eHeapType::READBACK },
+																			 gxapi::eHeapFlags::NONE,
+																			 gxapi::ResourceDesc::Buffer(2 * sizeof(uint64_t)),
+																			 gxapi::eResourceState::COPY_DEST));
+
+	list->EndQuery(queries.get(), gxapi::eQueryType::TIMESTAMP, 0);
+	list->DrawInstanced(3);
+	list->EndQuery(queries.get(), gxapi::eQueryType::TIMESTAMP, 1);
+	list->ResolveQueryData(queries.get(), gxapi::eQueryType::TIMESTAMP, 0, 2, readback.get(), 0);
+	list->Close();
+	gxapi::ICommandList* lists[] = { list.get() };
+	queue->ExecuteCommandLists(1, lists);
+	queue->Signal(fence.get(), 1);
+	fence->Wait(1);
+
+	const uint64_t* timestamps = static_cast<const uint64_t*>(readback->Map(0));
+	REQUIRE(timestamps[0] > 0);
+	REQUIRE(timestamps[1] >= timestamps[0]);
+	readback->Unmap(0);
+
+	REQUIRE(api->QueryVideoMemoryInfo(gxapi::eMemorySegmentGroup::NON_LOCAL).currentUsage >= 2 * sizeof(uint64_t));
+	REQUIRE(api->QueryVideoMemoryInfo(gxapi::eMemorySegmentGroup::LOCAL).currentUsage == 0);
+}
+
+
+TEST_CASE("Null views are written to their descriptors", "[GraphicsEngine]") {
+	GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	std::unique_ptr<gxapi::IDescriptorHeap> staging(api->CreateDescriptorHeap({ gxapi::eDescriptorHeapType::CBV_SRV_UAV, 4, false }));
+	std::unique_ptr<gxapi::IDescriptorHeap> visible(api->CreateDescriptorHeap({ gxapi::eDescriptorHeapType::CBV_SRV_UAV, 4, true }));
+	std::unique_ptr<gxapi::IResource> texture(api->CreateCommittedResource(gxapi::HeapProperties{ gxapi::eHeapType::DEFAULT },
+																			gxapi::eHeapFlags::NONE,
+																			gxapi::ResourceDesc::Texture2D(64, 64, gxapi::eFormat::R8G8B8A8_UNORM, gxapi::eResourceFlags::NONE, gxapi::TextureDesc::ALL_MIPLEVELS),
+																			gxapi::eResourceState::COMMON));
+	REQUIRE(texture->GetNumMipLevels() == 7);
+	REQUIRE_THROWS_AS(texture->Map(0), InvalidCallException);
+
+	api->CreateShaderResourceView(texture.get(), staging->At(0));
+	api->CreateUnorderedAccessView(texture.get(), staging->At(1));
+	api->CopyDescriptors(staging->At(0), visible->At(2), 2, gxapi::eDescriptorHeapType::CBV_SRV_UAV);
+
+	const Descriptor& srv = *static_cast<const Descriptor*>(visible->At(2).cpuAddress);
+	const Descriptor& uav = *static_cast<const Descriptor*>(visible->At(3).cpuAddress);
+	REQUIRE(srv.kind == eDescriptorKind::SRV);
+	REQUIRE(srv.resource == texture.get());
+	REQUIRE(uav.kind == eDescriptorKind::UAV);
+	REQUIRE(visible->At(3).gpuAddress != nullptr);
+	REQUIRE(staging->At(0).gpuAddress == nullptr);
+}
@@ -0,0 +1,89 @@
+#include <GraphicsEngine_LL/PixelConversion.hpp>
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <vector>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+static const PixelFormat Rgb8 = { ePixelChannelType::INT8_NORM, 3 };
+static const PixelFormat Rgba8 = { ePixelChannelType::INT8_NORM, 4 };
+static const PixelFormat Rgba16 = { ePixelChannelType::INT16_NORM, 4 };
+static const PixelFormat RgbaFloat = { ePixelChannelType::FLOAT32, 4 };
+
+
+TEST_CASE("RGB pixels expand to opaque RGBA", "[GraphicsEngine]") {
+	// Long enough for the vectorized loop and its remainder.
+	constexpr size_t width = 37;
+	std::vector<uint8_t> source(width * 3);
+	for (size_t i = 0; i < source.size(); ++i) {
+		source[i] = uint8_t(i);
+	}
+	std::vector<uint8_t> destination(width * 4);
+	PixelConversion::ConvertRow(source.data(), Rgb8, destination.data(), Rgba8, width);
+
+	for (size_t x = 0; x < width; ++x) {
+		REQUIRE(destination[4 * x + 0] == source[3 * x + 0]);
+		REQUIRE(destination[4 * x + 1] == source[3 * x + 1]);
+		REQUIRE(destination[4 * x + 2] == source[3 * x + 2]);
+		REQUIRE(destination[4 * x + 3] == 255);
+	}
+}
+
+
+TEST_CASE("Integer pixels round trip through floats", "[GraphicsEngine]") {
+	constexpr size_t width = 9;
+	std::vector<uint8_t> bytes(width * 4);
+	for (size_t i = 0; i < bytes.size(); ++i) {
+		bytes[i] = uint8_t(i * 7);
+	}
+	std::vector<float> floats(width * 4);
+	PixelConversion::ConvertRow(bytes.data(), Rgba8, floats.data(), RgbaFloat, width);
+	REQUIRE(floats[1] == Approx(7.0f / 255.0f));
+
+	std::vector<uint8_t> roundTrip(width * 4);
+	PixelConversion::ConvertRow(floats.data(), RgbaFloat, roundTrip.data(), Rgba8, width);
+	REQUIRE(roundTrip == bytes);
+
+	// Out of range floats are clamped.
+	floats[0] = -1.0f;
+	floats[1] = 2.0f;
+	std::vector<uint16_t> words(width * 4);
+	PixelConversion::ConvertRow(floats.data(), RgbaFloat, words.data(), Rgba16, width);
+	REQUIRE(words[0] == 0);
+	REQUIRE(words[1] == 65535);
+	REQUIRE(words[2] == 14 * 257);
+}
+
+
+TEST_CASE("Pixels are swizzled and sRGB decoded", "[GraphicsEngine]") {
+	const uint8_t bgra[] = { 0, 128, 255, 64 };
+	float rgba[4];
+	PixelFormat srgb = Rgba8;
+	srgb.srgb = true;
+	PixelConversion::ConvertRow(bgra, srgb, rgba, RgbaFloat, 1, PixelConversion::SwapRedBlue);
+	REQUIRE(rgba[0] == Approx(1.0f));
+	REQUIRE(rgba[1] == Approx(PixelConversion::SrgbToLinear(128.0f / 255.0f)));
+	REQUIRE(rgba[2] == Approx(0.0f));
+	REQUIRE(rgba[3] == Approx(64.0f / 255.0f)); // Alpha stays linear.
+
+	uint8_t encoded[4];
+	PixelConversion::ConvertRow(rgba, RgbaFloat, encoded, srgb, 1);
+	REQUIRE(encoded[0] == 255);
+	REQUIRE(encoded[1] == 128);
+	REQUIRE(encoded[3] == 64);
+}
+
+
+TEST_CASE("Pixel conversions of integers are limited", "[GraphicsEngine]") {
+	const PixelFormat integers = { ePixelChannelType::INT32, 4 };
+	REQUIRE(PixelConversion::IsSupported(integers, { ePixelChannelType::INT32, 2 }));
+	REQUIRE_FALSE(PixelConversion::IsSupported(integers, RgbaFloat));
+	REQUIRE_FALSE(PixelConversion::IsSupported({ ePixelChannelType::BC1, 4 }, Rgba8));
+	uint32_t pixel[4] = {};
+	REQUIRE_THROWS_AS(PixelConversion::ConvertRow(pixel, integers, pixel, Rgba8, 1), InvalidArgumentException);
+}
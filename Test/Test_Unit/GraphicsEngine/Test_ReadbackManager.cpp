@@ -0,0 +1,145 @@
+#include <GraphicsApi_Null/GxapiManager.hpp>
+#include <GraphicsApi_LL/IGraphicsApi.hpp>
+#include <GraphicsApi_LL/IResource.hpp>
+#include <GraphicsEngine_LL/ReadbackManager.hpp>
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <cstring>
+#include <memory>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+static LinearBuffer CreateSource(gxapi::IGraphicsApi* api, size_t size) {
+	auto resource = MemoryObject::UniquePtr(
+		api->CreateCommittedResource(gxapi::HeapProperties(gxapi::eHeapType::DEFAULT),
+									 gxapi::eHeapFlags::NONE,
+									 gxapi::ResourceDesc::Buffer(size),
+									 gxapi::eResourceState::COMMON),
+		std::default_delete<const gxapi::IResource>());
+	return LinearBuffer(std::move(resource), true, eResourceHeap::CRITICAL);
+}
+
+
+static Texture2D CreateSourceTexture(gxapi::IGraphicsApi* api, uint64_t width, uint32_t height) {
+	auto resource = MemoryObject::UniquePtr(
+		api->CreateCommittedResource(gxapi::HeapProperties(gxapi::eHeapType::DEFAULT),
+									 gxapi::eHeapFlags::NONE,
+									 gxapi::ResourceDesc::Texture2D(width, height, gxapi::eFormat::R8G8B8A8_UNORM),
+									 gxapi::eResourceState::COMMON),
+		std::default_delete<const gxapi::IResource>());
+	return Texture2D(std::move(resource), true, eResourceHeap::CRITICAL);
+}
+
+
+// Stands in for the copy the GPU makes.
+static uint8_t* GetDestination(const ReadbackManager::ReadbackDescription& readback) {
+	return static_cast<uint8_t*>(readback.destination._GetResourcePtr()->Map(0, nullptr)) + readback.destinationOffset;
+}
+
+
+TEST_CASE("Buffer readbacks resolve when the frame completes", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	ReadbackManager readbackManager(api.get());
+	LinearBuffer source = CreateSource(api.get(), 256);
+
+	readbackManager.OnFrameBeginHost(1);
+	auto future = readbackManager.RequestReadback(source, 64, 16);
+	auto readbacks = readbackManager.PrepareReadbacks();
+	REQUIRE(readbacks.size() == 1);
+	REQUIRE(readbacks[0].sourceType == ReadbackManager::SourceType::BUFFER);
+	REQUIRE(readbacks[0].sourceOffset == 64);
+	REQUIRE(readbacks[0].size == 16);
+	REQUIRE(readbackManager.PrepareReadbacks().empty());
+
+	for (uint8_t i = 0; i < 16; ++i) {
+		GetDestination(readbacks[0])[i] = i;
+	}
+	REQUIRE(!future.ready());
+
+	readbackManager.OnFrameCompleteDevice(1);
+	REQUIRE(future.ready());
+	ReadbackData data = future.get();
+	REQUIRE(data.frame == 1);
+	REQUIRE(data.bytes.size() == 16);
+	for (uint8_t i = 0; i < 16; ++i) {
+		REQUIRE(data.bytes[i] == i);
+	}
+	REQUIRE(readbackManager.GetPendingCount() == 0);
+}
+
+
+TEST_CASE("Texture readbacks come back with tightly packed rows", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	ReadbackManager readbackManager(api.get());
+	Texture2D source = CreateSourceTexture(api.get(), 16, 16);
+
+	readbackManager.OnFrameBeginHost(1);
+	auto future = readbackManager.RequestReadback(source, ReadbackRegion{ 0, 4, 5, 3, 2 });
+	auto readbacks = readbackManager.PrepareReadbacks();
+	REQUIRE(readbacks.size() == 1);
+	REQUIRE(readbacks[0].destinationOffset % 512 == 0);
+	REQUIRE(readbacks[0].textureBufferDesc.byteOffset == readbacks[0].destinationOffset);
+	REQUIRE(readbacks[0].size == 2 * 256);
+
+	// Rows land at the aligned pitch in the page.
+	uint8_t* rows = GetDestination(readbacks[0]);
+	for (uint8_t i = 0; i < 12; ++i) {
+		rows[i] = i;
+		rows[256 + i] = 100 + i;
+	}
+
+	readbackManager.OnFrameCompleteDevice(1);
+	ReadbackData data = future.get();
+	REQUIRE(data.bytes.size() == 24);
+	REQUIRE(data.bytes[0] == 0);
+	REQUIRE(data.bytes[11] == 11);
+	REQUIRE(data.bytes[12] == 100);
+	REQUIRE(data.bytes[23] == 111);
+}
+
+
+TEST_CASE("Readback pages are reused once their frame completed", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	ReadbackManager readbackManager(api.get());
+	LinearBuffer source = CreateSource(api.get(), 256);
+
+	readbackManager.OnFrameBeginHost(1);
+	auto first = readbackManager.RequestReadback(source, 0, 256);
+	readbackManager.PrepareReadbacks();
+	const size_t capacity = readbackManager.GetCapacity();
+	REQUIRE(capacity > 0);
+
+	readbackManager.OnFrameCompleteDevice(1);
+	readbackManager.OnFrameBeginHost(2);
+	auto second = readbackManager.RequestReadback(source, 0, 256);
+	auto readbacks = readbackManager.PrepareReadbacks();
+	REQUIRE(readbacks[0].destinationOffset == 0);
+	REQUIRE(readbackManager.GetCapacity() == capacity);
+
+	REQUIRE(first.ready());
+	REQUIRE(!second.ready());
+	readbackManager.OnFrameCompleteDevice(2);
+	REQUIRE(second.ready());
+}
+
+
+TEST_CASE("Invalid readback requests throw", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	ReadbackManager readbackManager(api.get());
+	LinearBuffer source = CreateSource(api.get(), 256);
+	Texture2D texture = CreateSourceTexture(api.get(), 16, 16);
+
+	REQUIRE_THROWS_AS(readbackManager.RequestReadback(source, 0, 0), InvalidArgumentException);
+	REQUIRE_THROWS_AS(readbackManager.RequestReadback(source, 200, 100), OutOfRangeException);
+	REQUIRE_THROWS_AS(readbackManager.RequestReadback(texture, ReadbackRegion{ 0, 0, 0, 0, 4 }), InvalidArgumentException);
+	REQUIRE(readbackManager.GetPendingCount() == 0);
+}
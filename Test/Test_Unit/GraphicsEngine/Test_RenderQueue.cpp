@@ -0,0 +1,63 @@
+#include <GraphicsEngine_LL/RenderQueue.hpp>
+
+#include <BaseLibrary/JobSystem/ThreadpoolScheduler.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("RenderQueue key order", "[GraphicsEngine]") {
+	// State is more significant than depth.
+	REQUIRE(RenderQueue::MakeKey(0, 0, 0, 100.0f) < RenderQueue::MakeKey(0, 0, 1, 1.0f));
+	REQUIRE(RenderQueue::MakeKey(0, 0, 7, 100.0f) < RenderQueue::MakeKey(0, 1, 0, 1.0f));
+	REQUIRE(RenderQueue::MakeKey(0, 9, 7, 100.0f) < RenderQueue::MakeKey(1, 0, 0, 1.0f));
+
+	// Front to back within the same state.
+	REQUIRE(RenderQueue::MakeKey(3, 4, 5, 1.0f) < RenderQueue::MakeKey(3, 4, 5, 2.0f));
+	REQUIRE(RenderQueue::MakeKey(3, 4, 5, 0.5f) < RenderQueue::MakeKey(3, 4, 5, 1000.0f));
+	REQUIRE(RenderQueue::MakeKey(3, 4, 5, -1.0f) == RenderQueue::MakeKey(3, 4, 5, 0.0f));
+}
+
+
+TEST_CASE("RenderQueue sort", "[GraphicsEngine]") {
+	std::mt19937_64 rng(42);
+	std::uniform_int_distribution<int> state(0, 3);
+	std::uniform_real_distribution<float> depth(0.0f, 500.0f);
+
+	auto check = [&](size_t count, jobs::Scheduler* scheduler) {
+		RenderQueue queue;
+		std::vector<RenderQueue::Item> expected;
+		for (size_t i = 0; i < count; ++i) {
+			uint64_t key = RenderQueue::MakeKey(state(rng), state(rng), state(rng), depth(rng));
+			queue.Add(key, uint32_t(i));
+			expected.push_back({ key, uint32_t(i) });
+		}
+		std::stable_sort(expected.begin(), expected.end(), [](const auto& lhs, const auto& rhs) { return lhs.key < rhs.key; });
+
+		queue.Sort(scheduler);
+
+		REQUIRE(queue.Size() == count);
+		for (size_t i = 0; i < count; ++i) {
+			REQUIRE(queue[i].key == expected[i].key);
+			REQUIRE(queue[i].index == expected[i].index);
+		}
+	};
+
+	SECTION("Single thread") {
+		check(1000, nullptr);
+	}
+	SECTION("Parallel") {
+		jobs::ThreadpoolScheduler scheduler(4);
+		check(20000, &scheduler);
+	}
+	SECTION("Empty and single") {
+		check(0, nullptr);
+		check(1, nullptr);
+	}
+}
@@ -0,0 +1,39 @@
+#include <GraphicsEngine_LL/ResidencyManager.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("Residency evicts the least recently used first", "[GraphicsEngine]") {
+	std::vector<ResidencyManager::Candidate> candidates = {
+		{ 5, 100 },
+		{ 2, 100 },
+		{ 7, 100 },
+		{ 2, 300 },
+	};
+
+	// Of the equally old ones, the larger goes first.
+	auto selected = ResidencyManager::SelectEvictions(candidates, 250);
+	REQUIRE(selected == std::vector<size_t>{ 3 });
+
+	selected = ResidencyManager::SelectEvictions(candidates, 450);
+	REQUIRE(selected == std::vector<size_t>{ 3, 1, 0 });
+}
+
+
+TEST_CASE("Residency evicts nothing when nothing is needed", "[GraphicsEngine]") {
+	std::vector<ResidencyManager::Candidate> candidates = { { 1, 100 }, { 2, 100 } };
+	REQUIRE(ResidencyManager::SelectEvictions(candidates, 0).empty());
+	REQUIRE(ResidencyManager::SelectEvictions({}, 100).empty());
+}
+
+
+TEST_CASE("Residency evicts all candidates if they are not enough", "[GraphicsEngine]") {
+	std::vector<ResidencyManager::Candidate> candidates = { { 3, 100 }, { 1, 100 }, { 2, 100 } };
+	auto selected = ResidencyManager::SelectEvictions(candidates, 1000);
+	REQUIRE(selected == std::vector<size_t>{ 1, 2, 0 });
+}
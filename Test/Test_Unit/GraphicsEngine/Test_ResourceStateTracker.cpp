@@ -0,0 +1,140 @@
+#include <GraphicsApi_Null/GxapiManager.hpp>
+#include <GraphicsApi_LL/IGraphicsApi.hpp>
+#include <GraphicsApi_LL/IResource.hpp>
+#include <GraphicsEngine_LL/ResourceStateTracker.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+static Texture2D CreateTexture(gxapi::IGraphicsApi* api, uint16_t mipLevels) {
+	auto resource = MemoryObject::UniquePtr(
+		api->CreateCommittedResource(gxapi::HeapProperties(gxapi::eHeapType::DEFAULT),
+									 gxapi::eHeapFlags::NONE,
+									 gxapi::ResourceDesc::Texture2D(64, 64, gxapi::eFormat::R8G8B8A8_UNORM, gxapi::eResourceFlags::NONE, mipLevels),
+									 gxapi::eResourceState::COMMON),
+		std::default_delete<const gxapi::IResource>());
+	return Texture2D(std::move(resource), true, eResourceHeap::CRITICAL);
+}
+
+
+using Transitions = std::vector<std::pair<unsigned, gxapi::eResourceState>>;
+
+static auto Collect(Transitions& transitions) {
+	return [&transitions](unsigned subresource, gxapi::eResourceState before) {
+		transitions.push_back({ subresource, before });
+	};
+}
+
+
+TEST_CASE("Resource indices are dense within a frame", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	Texture2D first = CreateTexture(api.get(), 1);
+	Texture2D second = CreateTexture(api.get(), 1);
+	ResourceIndexRegistry registry;
+
+	registry.BeginFrame();
+	REQUIRE(registry.GetIndex(first) == 0);
+	REQUIRE(registry.GetIndex(second) == 1);
+	REQUIRE(registry.GetIndex(first) == 0);
+	REQUIRE(registry.GetCount() == 2);
+
+	// The next frame hands them out again, in the order of their use.
+	registry.BeginFrame();
+	REQUIRE(registry.GetCount() == 0);
+	REQUIRE(registry.GetIndex(second) == 0);
+	REQUIRE(registry.GetIndex(first) == 1);
+}
+
+
+TEST_CASE("Whole resources take a single entry and transition", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	Texture2D texture = CreateTexture(api.get(), 4);
+	REQUIRE(texture.GetNumSubresources() == 4);
+	ResourceIndexRegistry registry;
+	registry.BeginFrame();
+	ResourceStateTracker tracker(&registry);
+
+	Transitions transitions;
+	tracker.SetState(texture, gxapi::ALL_SUBRESOURCES, gxapi::eResourceState::RENDER_TARGET, Collect(transitions));
+	REQUIRE(transitions.empty());
+	tracker.SetState(texture, gxapi::ALL_SUBRESOURCES, gxapi::eResourceState::RENDER_TARGET, Collect(transitions));
+	REQUIRE(transitions.empty());
+	tracker.SetState(texture, gxapi::ALL_SUBRESOURCES, gxapi::eResourceState::PIXEL_SHADER_RESOURCE, Collect(transitions));
+	REQUIRE(transitions == Transitions{ { gxapi::ALL_SUBRESOURCES, gxapi::eResourceState::RENDER_TARGET } });
+	REQUIRE(tracker.GetState(texture, 2) == gxapi::eResourceState::PIXEL_SHADER_RESOURCE);
+
+	auto usages = tracker.TakeUsages();
+	REQUIRE(usages.size() == 1);
+	REQUIRE(usages[0].subresource == gxapi::ALL_SUBRESOURCES);
+	REQUIRE(usages[0].firstState == gxapi::eResourceState::RENDER_TARGET);
+	REQUIRE(usages[0].lastState == gxapi::eResourceState::PIXEL_SHADER_RESOURCE);
+	REQUIRE(usages[0].multipleStates);
+	REQUIRE(tracker.GetResourceCount() == 0);
+	REQUIRE(!tracker.GetState(texture, 0));
+}
+
+
+TEST_CASE("Setting a single subresource splits the resource", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	Texture2D texture = CreateTexture(api.get(), 3);
+	ResourceIndexRegistry registry;
+	registry.BeginFrame();
+	ResourceStateTracker tracker(&registry);
+
+	// Mipmap generation: read the level above, write the next one.
+	Transitions transitions;
+	tracker.SetState(texture, gxapi::ALL_SUBRESOURCES, gxapi::eResourceState::UNORDERED_ACCESS, Collect(transitions));
+	tracker.SetState(texture, 0, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE, Collect(transitions));
+	REQUIRE(transitions == Transitions{ { 0, gxapi::eResourceState::UNORDERED_ACCESS } });
+	REQUIRE(tracker.GetState(texture, 0) == gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
+	REQUIRE(tracker.GetState(texture, 1) == gxapi::eResourceState::UNORDERED_ACCESS);
+
+	// The rest follow one by one, only those in another state transition.
+	transitions.clear();
+	tracker.SetState(texture, gxapi::ALL_SUBRESOURCES, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE, Collect(transitions));
+	REQUIRE(transitions == Transitions{ { 1, gxapi::eResourceState::UNORDERED_ACCESS }, { 2, gxapi::eResourceState::UNORDERED_ACCESS } });
+
+	auto usages = tracker.TakeUsages();
+	REQUIRE(usages.size() == 3);
+	for (unsigned s = 0; s < 3; ++s) {
+		REQUIRE(usages[s].subresource == s);
+		REQUIRE(usages[s].firstState == gxapi::eResourceState::UNORDERED_ACCESS);
+		REQUIRE(usages[s].lastState == gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE);
+	}
+}
+
+
+TEST_CASE("Subresources used on their own are the only ones reported", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	Texture2D texture = CreateTexture(api.get(), 3);
+	Texture2D other = CreateTexture(api.get(), 1);
+	ResourceIndexRegistry registry;
+	registry.BeginFrame();
+	ResourceStateTracker tracker(&registry);
+
+	Transitions transitions;
+	tracker.SetState(texture, 1, gxapi::eResourceState::COPY_DEST, Collect(transitions));
+	tracker.SetState(other, gxapi::ALL_SUBRESOURCES, gxapi::eResourceState::COPY_SOURCE, Collect(transitions));
+	REQUIRE(transitions.empty());
+	REQUIRE(!tracker.GetState(texture, 0));
+	REQUIRE(tracker.GetState(texture, 1) == gxapi::eResourceState::COPY_DEST);
+	REQUIRE(tracker.GetResourceCount() == 2);
+
+	auto usages = tracker.TakeUsages();
+	REQUIRE(usages.size() == 2);
+	REQUIRE(usages[0].resource == texture);
+	REQUIRE(usages[0].subresource == 1);
+	REQUIRE(!usages[0].multipleStates);
+	REQUIRE(usages[1].resource == other);
+}
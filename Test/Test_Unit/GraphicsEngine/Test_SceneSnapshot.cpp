@@ -0,0 +1,123 @@
+#include <GraphicsEngine_LL/PerspectiveCamera.hpp>
+#include <GraphicsEngine_LL/SceneSnapshot.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("Scene snapshot copies follow the originals", "[GraphicsEngine]") {
+	Scene scene("World");
+	MeshEntity entity;
+	entity.SetPosition({ 1, 2, 3 });
+	PointLight light;
+	light.SetRange(5.0f);
+	scene.GetEntities<MeshEntity>().Add(&entity);
+	scene.GetEntities<PointLight>().Add(&light);
+	PerspectiveCamera camera;
+	camera.SetName("WorldCam");
+	camera.SetPosition({ 4, 5, 6 });
+
+	SceneSnapshot snapshot;
+	snapshot.Update({ &scene }, { &camera }, {});
+
+	REQUIRE(snapshot.GetScenes().size() == 1);
+	const Scene& copy = *snapshot.GetScenes()[0];
+	REQUIRE(&copy != &scene);
+	REQUIRE(copy.GetName() == "World");
+	REQUIRE(copy.GetEntities<MeshEntity>().Size() == 1);
+	const MeshEntity* entityCopy = copy.GetEntities<MeshEntity>()[0];
+	REQUIRE(entityCopy == snapshot.Find(&entity));
+	REQUIRE(entityCopy != &entity);
+	REQUIRE(entityCopy->GetPosition() == Vec3(1, 2, 3));
+	REQUIRE(snapshot.Find(&light)->GetRange() == 5.0f);
+
+	REQUIRE(snapshot.GetCameras().size() == 1);
+	const BasicCamera* cameraCopy = snapshot.GetCameras()[0];
+	REQUIRE(cameraCopy != &camera);
+	REQUIRE(dynamic_cast<const PerspectiveCamera*>(cameraCopy) != nullptr);
+	REQUIRE(cameraCopy->GetName() == "WorldCam");
+
+	// Changes reach the same copies at the next update only.
+	entity.SetPosition({ 7, 8, 9 });
+	camera.SetPosition({ 0, 0, 1 });
+	REQUIRE(entityCopy->GetPosition() == Vec3(1, 2, 3));
+	snapshot.Update({ &scene }, { &camera }, {});
+	REQUIRE(snapshot.Find(&entity) == entityCopy);
+	REQUIRE(entityCopy->GetPosition() == Vec3(7, 8, 9));
+	REQUIRE(snapshot.Find(&camera) == cameraCopy);
+	REQUIRE(cameraCopy->GetPosition() == Vec3(0, 0, 1));
+}
+
+
+TEST_CASE("Scene snapshot copies particle emitters", "[GraphicsEngine]") {
+	Scene scene("World");
+	ParticleEmitter emitter({ 1, 2, 3 }, { 0, 0, 1 }, 500.0f, 3.0f);
+	emitter.SetSize(0.2f, 0.5f);
+	scene.GetEntities<ParticleEmitter>().Add(&emitter);
+
+	SceneSnapshot snapshot;
+	snapshot.Update({ &scene }, {}, {});
+
+	const ParticleEmitter* copy = snapshot.Find(&emitter);
+	REQUIRE(copy != nullptr);
+	REQUIRE(copy != &emitter);
+	REQUIRE(snapshot.GetScenes()[0]->GetEntities<ParticleEmitter>()[0] == copy);
+	REQUIRE(copy->GetPosition() == Vec3(1, 2, 3));
+	REQUIRE(copy->GetEmissionRate() == 500.0f);
+	REQUIRE(copy->GetEndSize() == 0.5f);
+
+	emitter.SetEmissionRate(0.0f);
+	snapshot.Update({ &scene }, {}, {});
+	REQUIRE(snapshot.Find(&emitter) == copy);
+	REQUIRE(copy->GetEmissionRate() == 0.0f);
+}
+
+
+TEST_CASE("Scene snapshot keeps what the pipeline writes", "[GraphicsEngine]") {
+	Scene scene("World");
+	MeshEntity entity;
+	entity.SetLod(1);
+	scene.GetEntities<MeshEntity>().Add(&entity);
+
+	SceneSnapshot snapshot;
+	snapshot.Update({ &scene }, {}, {});
+	const MeshEntity* copy = snapshot.Find(&entity);
+	REQUIRE(copy->GetLod() == 1);
+
+	copy->SetLod(3);
+	entity.SetDynamic(true);
+	snapshot.Update({ &scene }, {}, {});
+	REQUIRE(copy->GetLod() == 3);
+	REQUIRE(copy->IsDynamic());
+	REQUIRE(entity.GetLod() == 1);
+}
+
+
+TEST_CASE("Scene snapshot drops removed entities and scenes", "[GraphicsEngine]") {
+	Scene scene("World");
+	Scene other("Other");
+	MeshEntity first;
+	MeshEntity second;
+	scene.GetEntities<MeshEntity>().Add(&first);
+	scene.GetEntities<MeshEntity>().Add(&second);
+
+	SceneSnapshot snapshot;
+	snapshot.Update({ &scene, &other }, {}, {});
+	REQUIRE(snapshot.GetScenes().size() == 2);
+	REQUIRE(snapshot.Find(&first) != nullptr);
+	REQUIRE(snapshot.Find(&second) != nullptr);
+
+	scene.GetEntities<MeshEntity>().Remove(&first);
+	snapshot.Update({ &scene }, {}, {});
+	REQUIRE(snapshot.GetScenes().size() == 1);
+	REQUIRE(snapshot.Find(&first) == nullptr);
+	const auto& copies = snapshot.GetScenes()[0]->GetEntities<MeshEntity>();
+	REQUIRE(copies.Size() == 1);
+	REQUIRE(copies[0] == snapshot.Find(&second));
+
+	snapshot.Clear();
+	REQUIRE(snapshot.GetScenes().empty());
+	REQUIRE(snapshot.Find(&second) == nullptr);
+}
@@ -0,0 +1,24 @@
+#include <GraphicsEngine_LL/ScratchSpacePool.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("Scratch spaces are sized after the previous frame", "[GraphicsEngine]") {
+	ScratchSpacePool pool(nullptr, gxapi::eDescriptorHeapType::CBV_SRV_UAV);
+	REQUIRE(pool.GetPreferredSize() == ScratchSpacePool::DEFAULT_SCRATCH_SPACE_SIZE);
+
+	// Only the usage of the frame before counts, with some headroom.
+	pool.ReportUsage(3000);
+	pool.ReportUsage(1200);
+	REQUIRE(pool.GetPreferredSize() == ScratchSpacePool::DEFAULT_SCRATCH_SPACE_SIZE);
+	pool.BeginFrame();
+	REQUIRE(pool.GetPreferredSize() >= 3000 + 3000 / 4);
+	REQUIRE(pool.GetPreferredSize() % 256 == 0);
+
+	pool.ReportUsage(100);
+	pool.BeginFrame();
+	REQUIRE(pool.GetPreferredSize() == ScratchSpacePool::DEFAULT_SCRATCH_SPACE_SIZE);
+}
@@ -0,0 +1,229 @@
+#include <GraphicsEngine_LL/ShaderManager.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+// Pretends to compile by returning the source with the entry point and the shader model.
+class FakeShaderCompiler : public gxapi::IGxapiManager {
+public:
+	std::vector<gxapi::AdapterInfo> EnumerateAdapters() override { return {}; }
+	gxapi::ISwapChain* CreateSwapChain(gxapi::SwapChainDesc, gxapi::ICommandQueue*) override { return nullptr; }
+	gxapi::IGraphicsApi* CreateGraphicsApi(unsigned) override { return nullptr; }
+
+	gxapi::ShaderProgramBinary CompileShader(const char* source,
+											 const char* mainFunction,
+											 gxapi::eShaderType,
+											 gxapi::eShaderCompileFlags flags,
+											 gxapi::IShaderIncludeProvider*,
+											 const char* macroDefinitions,
+											 gxapi::eShaderModel shaderModel) override {
+		std::string text = std::string(mainFunction) + ":" + macroDefinitions + ":" + std::to_string(int(shaderModel)) + ":" + source;
+		gxapi::ShaderProgramBinary binary{ std::vector<uint8_t>(text.begin(), text.end()) };
+		if (flags & gxapi::eShaderCompileFlags::DEBUG) {
+			binary.debugInfo = binary.data;
+			binary.debugName = std::string(mainFunction) + ".pdb";
+		}
+		return binary;
+	}
+
+	gxapi::ShaderProgramBinary CompileShaderFromFile(const std::string&,
+													 const std::string&,
+													 gxapi::eShaderType,
+													 gxapi::eShaderCompileFlags,
+													 const std::vector<gxapi::ShaderMacroDefinition>&,
+													 gxapi::eShaderModel) override {
+		return {};
+	}
+};
+
+
+class ShaderCacheFixture {
+public:
+	ShaderCacheFixture() {
+		std::filesystem::remove_all(cacheDirectory);
+	}
+	~ShaderCacheFixture() {
+		std::error_code ec;
+		std::filesystem::remove_all(cacheDirectory, ec);
+	}
+
+	void AddSources(ShaderManager& shaderManager, const std::string& common) {
+		shaderManager.AddSourceCode("common", common);
+		shaderManager.AddSourceCode("lit", "#include \"common.hlsl\"\nfloat4 PSMain() : SV_TARGET { return Light(); }");
+		shaderManager.AddSourceCode("unlit", "float4 PSMain() : SV_TARGET { return 1; }");
+	}
+
+protected:
+	FakeShaderCompiler compiler;
+	std::filesystem::path cacheDirectory = std::filesystem::temp_directory_path() / "InlineShaderCacheTest";
+};
+
+
+TEST_CASE_METHOD(ShaderCacheFixture, "Shader cache warm start", "[GraphicsEngine]") {
+	ShaderParts parts;
+	parts.vs = parts.ps = true;
+
+	ShaderManager cold(&compiler);
+	cold.SetCacheDirectory(cacheDirectory);
+	AddSources(cold, "float4 Light() { return 0; }");
+	ShaderProgram compiled = cold.CreateShader("lit", parts, "A=1");
+	REQUIRE(cold.GetCompileCount() == 2);
+	REQUIRE(cold.GetCacheHitCount() == 0);
+
+	ShaderManager warm(&compiler);
+	warm.SetCacheDirectory(cacheDirectory);
+	AddSources(warm, "float4 Light() { return 0; }");
+	ShaderProgram loaded = warm.CreateShader("lit", parts, "A=1");
+	REQUIRE(warm.GetCompileCount() == 0);
+	REQUIRE(warm.GetCacheHitCount() == 2);
+	REQUIRE(loaded.ps.Size() == compiled.ps.Size());
+	REQUIRE(std::memcmp(loaded.ps.Data(), compiled.ps.Data(), loaded.ps.Size()) == 0);
+
+	SECTION("Different macros") {
+		warm.CreateShader("lit", parts, "A=2");
+		REQUIRE(warm.GetCompileCount() == 2);
+	}
+	SECTION("Changed include") {
+		ShaderManager edited(&compiler);
+		edited.SetCacheDirectory(cacheDirectory);
+		AddSources(edited, "float4 Light() { return 1; }");
+		edited.CreateShader("lit", parts, "A=1");
+		REQUIRE(edited.GetCompileCount() == 2);
+	}
+}
+
+
+TEST_CASE_METHOD(ShaderCacheFixture, "Shader reload drops changed shaders only", "[GraphicsEngine]") {
+	ShaderParts parts;
+	parts.ps = true;
+
+	ShaderManager shaderManager(&compiler);
+	AddSources(shaderManager, "float4 Light() { return 0; }");
+	shaderManager.CreateShader("lit", parts);
+	shaderManager.CreateShader("unlit", parts);
+	REQUIRE(shaderManager.GetCompileCount() == 2);
+
+	REQUIRE(shaderManager.ReloadShaders() == 0);
+
+	shaderManager.RemoveSourceCode("common");
+	shaderManager.AddSourceCode("common", "float4 Light() { return 1; }");
+	REQUIRE(shaderManager.ReloadShaders() == 1);
+
+	shaderManager.CreateShader("lit", parts);
+	shaderManager.CreateShader("unlit", parts);
+	REQUIRE(shaderManager.GetCompileCount() == 3);
+}
+
+
+TEST_CASE_METHOD(ShaderCacheFixture, "Shader warm-up list", "[GraphicsEngine]") {
+	ShaderParts parts;
+	parts.vs = parts.ps = true;
+
+	ShaderManager previousRun(&compiler);
+	AddSources(previousRun, "float4 Light() { return 0; }");
+	previousRun.CreateShader("lit", parts, "A=1 B=2");
+	previousRun.CreateShader("unlit", parts);
+
+	std::filesystem::create_directories(cacheDirectory);
+	ShaderManager::SaveShaderRequests(cacheDirectory / "WarmupList.bin", previousRun.GetShaderRequests());
+	auto requests = ShaderManager::LoadShaderRequests(cacheDirectory / "WarmupList.bin");
+	REQUIRE(requests.size() == 2);
+	auto lit = std::find_if(requests.begin(), requests.end(), [](const ShaderRequest& r) { return r.name == "lit"; });
+	REQUIRE(lit != requests.end());
+	REQUIRE(lit->macros == "A=1 B=2");
+	REQUIRE(lit->parts.vs);
+	REQUIRE(lit->parts.ps);
+	REQUIRE(!lit->parts.cs);
+
+	jobs::ImmediateScheduler scheduler;
+	ShaderManager nextRun(&compiler);
+	AddSources(nextRun, "float4 Light() { return 0; }");
+	nextRun.Precompile(scheduler, requests);
+	nextRun.WaitPrecompile();
+	REQUIRE(nextRun.GetCompileCount() == 4);
+
+	nextRun.CreateShader("lit", parts, "A=1 B=2");
+	REQUIRE(nextRun.GetCompileCount() == 4);
+}
+
+
+TEST_CASE_METHOD(ShaderCacheFixture, "Generated shaders are compiled once and warmed up", "[GraphicsEngine]") {
+	ShaderParts parts;
+	parts.ps = true;
+	const std::string generated = "#include \"common.hlsl\"\nfloat4 PSMain() : SV_TARGET { return Light() * 2; }";
+
+	ShaderManager previousRun(&compiler);
+	AddSources(previousRun, "float4 Light() { return 0; }");
+	ShaderProgram first = previousRun.CompileShader(generated, parts);
+	ShaderProgram second = previousRun.CompileShader(generated, parts);
+	REQUIRE(previousRun.GetCompileCount() == 1);
+	REQUIRE(second.ps.Size() == first.ps.Size());
+
+	std::filesystem::create_directories(cacheDirectory);
+	ShaderManager::SaveShaderRequests(cacheDirectory / "WarmupList.bin", previousRun.GetShaderRequests());
+	auto requests = ShaderManager::LoadShaderRequests(cacheDirectory / "WarmupList.bin");
+	REQUIRE(requests.size() == 1);
+	REQUIRE(requests[0].sourceCode == generated);
+	REQUIRE(requests[0].parts.ps);
+
+	jobs::ImmediateScheduler scheduler;
+	ShaderManager nextRun(&compiler);
+	AddSources(nextRun, "float4 Light() { return 0; }");
+	nextRun.Precompile(scheduler, requests);
+	nextRun.WaitPrecompile();
+	REQUIRE(nextRun.GetCompileCount() == 1);
+
+	nextRun.CompileShader(generated, parts);
+	REQUIRE(nextRun.GetCompileCount() == 1);
+}
+
+
+TEST_CASE_METHOD(ShaderCacheFixture, "Shader model from the default and the source", "[GraphicsEngine]") {
+	ShaderParts parts;
+	parts.cs = true;
+
+	auto modelOf = [](const ShaderStage& stage) {
+		std::string text(reinterpret_cast<const char*>(stage.Data()), stage.Size());
+		return std::stoi(text.substr(text.find(':', text.find(':') + 1) + 1));
+	};
+
+	ShaderManager shaderManager(&compiler);
+	shaderManager.SetCacheDirectory(cacheDirectory);
+	shaderManager.SetShaderModel(gxapi::eShaderModel::SM_6_0);
+	shaderManager.AddSourceCode("plain", "[numthreads(64, 1, 1)] void CSMain() {}");
+	shaderManager.AddSourceCode("bindless", "#pragma shader_model 6_6\n[numthreads(64, 1, 1)] void CSMain() {}");
+	REQUIRE(modelOf(shaderManager.CreateShader("plain", parts).cs) == int(gxapi::eShaderModel::SM_6_0));
+	REQUIRE(modelOf(shaderManager.CreateShader("bindless", parts).cs) == int(gxapi::eShaderModel::SM_6_6));
+
+	// Binaries of another model are not taken from the cache.
+	ShaderManager legacy(&compiler);
+	legacy.SetCacheDirectory(cacheDirectory);
+	legacy.AddSourceCode("plain", "[numthreads(64, 1, 1)] void CSMain() {}");
+	REQUIRE(modelOf(legacy.CreateShader("plain", parts).cs) == int(gxapi::eShaderModel::SM_5_1));
+	REQUIRE(legacy.GetCacheHitCount() == 0);
+
+	SECTION("Unknown model") {
+		shaderManager.AddSourceCode("future", "#pragma shader_model 9_9\n[numthreads(64, 1, 1)] void CSMain() {}");
+		REQUIRE_THROWS_AS(shaderManager.CreateShader("future", parts), gxapi::ShaderCompilationError);
+	}
+}
+
+
+TEST_CASE_METHOD(ShaderCacheFixture, "Shader debug info is written to its directory", "[GraphicsEngine]") {
+	ShaderParts parts;
+	parts.cs = true;
+
+	ShaderManager shaderManager(&compiler);
+	shaderManager.SetShaderCompileFlags(gxapi::eShaderCompileFlags::DEBUG);
+	shaderManager.SetDebugInfoDirectory(cacheDirectory / "pdb");
+	shaderManager.AddSourceCode("plain", "[numthreads(64, 1, 1)] void CSMain() {}");
+	ShaderProgram program = shaderManager.CreateShader("plain", parts);
+
+	REQUIRE(std::filesystem::file_size(cacheDirectory / "pdb" / "CSMain.pdb") == program.cs.Size());
+}
@@ -0,0 +1,117 @@
+#include <GraphicsEngine_LL/ShadowAtlas.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+static ShadowAtlas::Request MakeRequest(uintptr_t id, float importance, float coverage = 1.0f) {
+	ShadowAtlas::Request request;
+	request.light = reinterpret_cast<const void*>(id);
+	request.position = { float(id), 0, 0 };
+	request.range = 10.0f;
+	request.importance = importance;
+	request.screenCoverage = coverage;
+	return request;
+}
+
+
+TEST_CASE("ShadowAtlas gives slots to the most important lights", "[GraphicsEngine]") {
+	ShadowAtlas atlas(2, 1);
+	atlas.Allocate({ MakeRequest(1, 0.5f), MakeRequest(2, 2.0f), MakeRequest(3, 1.0f) });
+	REQUIRE(atlas.Find(reinterpret_cast<const void*>(1)) == nullptr);
+	const ShadowAtlas::Slot* slot2 = atlas.Find(reinterpret_cast<const void*>(2));
+	const ShadowAtlas::Slot* slot3 = atlas.Find(reinterpret_cast<const void*>(3));
+	REQUIRE(slot2 != nullptr);
+	REQUIRE(slot3 != nullptr);
+
+	// Lights keep their slots while they stay important, a more important light pushes out the least.
+	atlas.Allocate({ MakeRequest(4, 3.0f), MakeRequest(2, 2.0f), MakeRequest(3, 1.0f) });
+	REQUIRE(atlas.Find(reinterpret_cast<const void*>(2)) == slot2);
+	REQUIRE(atlas.Find(reinterpret_cast<const void*>(3)) == nullptr);
+	REQUIRE(atlas.Find(reinterpret_cast<const void*>(4)) == slot3);
+}
+
+
+TEST_CASE("ShadowAtlas caches faces and keeps to the budget", "[GraphicsEngine]") {
+	ShadowAtlas atlas(2, 1);
+	atlas.SetUpdateBudget(8);
+	atlas.Allocate({ MakeRequest(1, 1.0f), MakeRequest(2, 2.0f) });
+	std::vector<uint64_t> hashes(2 * ShadowAtlas::NumFaces, 0);
+
+	// The more important light is completed first.
+	auto updates = atlas.ScheduleUpdates(hashes);
+	REQUIRE(updates.size() == 8);
+	const ShadowAtlas::Slot* slot1 = atlas.Find(reinterpret_cast<const void*>(1));
+	const ShadowAtlas::Slot* slot2 = atlas.Find(reinterpret_cast<const void*>(2));
+	REQUIRE(slot2->IsComplete());
+	REQUIRE(!slot1->IsComplete());
+
+	updates = atlas.ScheduleUpdates(hashes);
+	REQUIRE(updates.size() == 4);
+	REQUIRE(slot1->IsComplete());
+	REQUIRE(atlas.ScheduleUpdates(hashes).empty());
+
+	// Changed casters render the face again.
+	const unsigned slotIdx = unsigned(slot1 - atlas.GetSlots().data());
+	hashes[slotIdx * ShadowAtlas::NumFaces + 3] = 42;
+	updates = atlas.ScheduleUpdates(hashes);
+	REQUIRE(updates.size() == 1);
+	REQUIRE(updates[0].slot == slotIdx);
+	REQUIRE(updates[0].face == 3);
+
+	// Moving the light renders all its faces again.
+	ShadowAtlas::Request moved = MakeRequest(1, 1.0f);
+	moved.position.y = 1.0f;
+	atlas.Allocate({ moved, MakeRequest(2, 2.0f) });
+	REQUIRE(!slot1->IsComplete());
+	REQUIRE(atlas.ScheduleUpdates(hashes).size() == ShadowAtlas::NumFaces);
+
+	REQUIRE_THROWS(atlas.ScheduleUpdates({}));
+}
+
+
+TEST_CASE("ShadowAtlas mip selection", "[GraphicsEngine]") {
+	REQUIRE(ShadowAtlas::SelectMip(1.0f, 4) == 0);
+	REQUIRE(ShadowAtlas::SelectMip(0.5f, 4) == 0);
+	REQUIRE(ShadowAtlas::SelectMip(0.3f, 4) == 1);
+	REQUIRE(ShadowAtlas::SelectMip(0.2f, 4) == 2);
+	REQUIRE(ShadowAtlas::SelectMip(0.01f, 4) == 3);
+	REQUIRE(ShadowAtlas::SelectMip(0.01f, 1) == 0);
+
+	// Small changes around a mip boundary keep the mip and the cached faces.
+	ShadowAtlas atlas(1, 4);
+	atlas.Allocate({ MakeRequest(1, 1.0f, 0.24f) });
+	REQUIRE(atlas.GetSlots()[0].mip == 2);
+	atlas.ScheduleUpdates(std::vector<uint64_t>(ShadowAtlas::NumFaces, 0));
+	atlas.Allocate({ MakeRequest(1, 1.0f, 0.26f) });
+	REQUIRE(atlas.GetSlots()[0].mip == 2);
+	REQUIRE(atlas.GetSlots()[0].IsComplete());
+	atlas.Allocate({ MakeRequest(1, 1.0f, 0.4f) });
+	REQUIRE(atlas.GetSlots()[0].mip == 1);
+	REQUIRE(!atlas.GetSlots()[0].IsComplete());
+}
+
+
+TEST_CASE("ShadowAtlas faces", "[GraphicsEngine]") {
+	// A narrow spot light only needs the face it points at.
+	REQUIRE(ShadowAtlas::GetSpotFaceMask({ 0, 0, -1 }, 0.1f) == (1u << 5));
+	REQUIRE(ShadowAtlas::GetSpotFaceMask({ 1, 0, 0 }, 0.1f) == (1u << 0));
+	REQUIRE(ShadowAtlas::GetSpotFaceMask({ 1, 0, 0 }, 3.0f) == ShadowAtlas::AllFaces);
+
+	// Each face looks along its axis.
+	const Vec3 position = { 1, 2, 3 };
+	for (unsigned face = 0; face < ShadowAtlas::NumFaces; ++face) {
+		Mat44 viewProjection = ShadowAtlas::GetFaceViewProjection(position, 10.0f, face);
+		Vec4 clip = Vec4(position + ShadowAtlas::GetFaceAxis(face) * 5.0f, 1.0f) * viewProjection;
+		REQUIRE(clip.w > 0.0f);
+		REQUIRE(std::abs(clip.x / clip.w) < 1e-4f);
+		REQUIRE(std::abs(clip.y / clip.w) < 1e-4f);
+		REQUIRE(clip.z / clip.w > 0.0f);
+		REQUIRE(clip.z / clip.w < 1.0f);
+	}
+}
@@ -0,0 +1,64 @@
+#include <GraphicsEngine_LL/SignedDistanceField.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <cmath>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("Distance field of a square", "[GraphicsEngine]") {
+	// A 16x16 square in the middle of a 32x32 bitmap.
+	std::vector<uint8_t> bitmap(32 * 32, 0);
+	for (int y = 8; y < 24; ++y) {
+		for (int x = 8; x < 24; ++x) {
+			bitmap[y * 32 + x] = 255;
+		}
+	}
+
+	DistanceField field = ComputeSignedDistanceField(bitmap.data(), 32, 32, 32, 1, 4.0f, 2);
+	REQUIRE(field.width == 36);
+	REQUIRE(field.height == 36);
+	auto At = [&](int x, int y) { return (int)field.pixels[y * field.width + x]; };
+
+	// Deep inside and far outside saturate.
+	REQUIRE(At(18, 18) == 255);
+	REQUIRE(At(0, 0) == 0);
+
+	// The edge is in the middle, values grow by an eighth of the range per pixel towards the inside with a spread of 4.
+	int outerEdge = At(2 + 7, 18);
+	int innerEdge = At(2 + 8, 18);
+	REQUIRE(outerEdge < 128);
+	REQUIRE(innerEdge > 128);
+	REQUIRE(std::abs(outerEdge + innerEdge - 255) <= 1);
+	REQUIRE(At(2 + 9, 18) - innerEdge == Approx(32).margin(1));
+
+	// Symmetric.
+	REQUIRE(At(2 + 7, 18) == At(2 + 24, 18));
+	REQUIRE(At(18, 2 + 7) == At(18, 2 + 24));
+}
+
+
+TEST_CASE("Distance field downscales the bitmap", "[GraphicsEngine]") {
+	std::vector<uint8_t> bitmap(64 * 40, 0);
+	for (int y = 0; y < 40; ++y) {
+		for (int x = 0; x < 32; ++x) {
+			bitmap[y * 64 + x] = 200;
+		}
+	}
+
+	DistanceField field = ComputeSignedDistanceField(bitmap.data(), 64, 40, 64, 4, 2.0f, 1);
+	REQUIRE(field.width == 18);
+	REQUIRE(field.height == 12);
+
+	// The left half is inside, the right half outside.
+	int row = 6;
+	REQUIRE(field.pixels[row * field.width + 4] == 255);
+	REQUIRE(field.pixels[row * field.width + 14] == 0);
+	REQUIRE(field.pixels[row * field.width + 8] > 128);
+	REQUIRE(field.pixels[row * field.width + 9] < 128);
+
+	// Nothing outside the bitmap is inside.
+	REQUIRE(field.pixels[0] < 128);
+}
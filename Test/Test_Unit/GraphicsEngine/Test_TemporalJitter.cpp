@@ -0,0 +1,74 @@
+#include <GraphicsEngine_LL/PerspectiveCamera.hpp>
+#include <GraphicsEngine_LL/TemporalJitter.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("Temporal jitter offsets stay within a pixel and repeat", "[GraphicsEngine]") {
+	const unsigned phaseCount = TemporalJitter::BasePhaseCount;
+	std::vector<Vec2> offsets;
+	Vec2 sum = { 0.0f, 0.0f };
+	for (uint64_t frame = 0; frame < phaseCount; ++frame) {
+		Vec2 offset = TemporalJitter::GetPixelOffset(frame, phaseCount);
+		REQUIRE(offset.x >= -0.5f);
+		REQUIRE(offset.x < 0.5f);
+		REQUIRE(offset.y >= -0.5f);
+		REQUIRE(offset.y < 0.5f);
+		for (const Vec2& other : offsets) {
+			REQUIRE((other.x != offset.x || other.y != offset.y));
+		}
+		offsets.push_back(offset);
+		sum += offset;
+	}
+
+	// The sequence is spread evenly around the pixel center.
+	REQUIRE(std::abs(sum.x / phaseCount) < 0.1f);
+	REQUIRE(std::abs(sum.y / phaseCount) < 0.1f);
+
+	Vec2 repeated = TemporalJitter::GetPixelOffset(phaseCount, phaseCount);
+	REQUIRE(repeated.x == offsets[0].x);
+	REQUIRE(repeated.y == offsets[0].y);
+}
+
+
+TEST_CASE("Temporal jitter uses more phases at lower render scales", "[GraphicsEngine]") {
+	REQUIRE(TemporalJitter::GetPhaseCount(1.0f) == TemporalJitter::BasePhaseCount);
+	// Half the resolution in each direction puts four output pixels under a render pixel.
+	REQUIRE(TemporalJitter::GetPhaseCount(0.5f) == 4 * TemporalJitter::BasePhaseCount);
+	REQUIRE(TemporalJitter::GetPhaseCount(0.1f) == TemporalJitter::MaxPhaseCount);
+}
+
+
+TEST_CASE("Camera jitter shifts the projected image by the offset", "[GraphicsEngine]") {
+	PerspectiveCamera camera;
+	camera.SetPosition({ 0, 0, 0 });
+	camera.SetLookDirection({ 0, 1, 0 });
+	camera.SetUpVector({ 0, 0, 1 });
+	camera.SetNearPlane(0.1f);
+	camera.SetFarPlane(100.0f);
+
+	// Half a pixel right and down on a 200 by 100 target.
+	Vec2 clipOffset = TemporalJitter::ToClipSpace(Vec2(0.5f, 0.5f), 200, 100);
+	REQUIRE(clipOffset.x == Approx(0.005f));
+	REQUIRE(clipOffset.y == Approx(-0.01f));
+
+	camera.SetJitter(clipOffset);
+	REQUIRE(camera.GetJitter().x == clipOffset.x);
+
+	Vec4 point = Vec4(1.0f, 10.0f, 2.0f, 1.0f) * camera.GetViewMatrix();
+	Vec4 jittered = point * camera.GetProjectionMatrix();
+	Vec4 unjittered = point * camera.GetUnjitteredProjectionMatrix();
+	REQUIRE(jittered.x / jittered.w - unjittered.x / unjittered.w == Approx(clipOffset.x).margin(1e-5f));
+	REQUIRE(jittered.y / jittered.w - unjittered.y / unjittered.w == Approx(clipOffset.y).margin(1e-5f));
+	REQUIRE(jittered.z / jittered.w == Approx(unjittered.z / unjittered.w));
+
+	camera.SetJitter({ 0.0f, 0.0f });
+	Vec4 cleared = point * camera.GetProjectionMatrix();
+	REQUIRE(cleared.x == Approx(unjittered.x));
+}
@@ -0,0 +1,63 @@
+#include <GraphicsEngine_LL/TextureStreamer.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+// Four levels, 85 bytes with all of them resident, 21 from the second level on, 5 and 1.
+static const std::vector<uint64_t> levelSizes = { 64, 16, 4, 1 };
+
+
+TEST_CASE("Texture streaming moves one level per update, furthest first", "[GraphicsEngine]") {
+	std::vector<TextureStreamer::Candidate> candidates = {
+		{ levelSizes, 3, 3, 0, 10 },
+		{ levelSizes, 2, 3, 1, 12 },
+	};
+	REQUIRE(TextureStreamer::Plan(candidates, 1000, 1000) == std::vector<unsigned>{ 2, 1 });
+
+	// The second one does not fit into the uploads after the first.
+	REQUIRE(TextureStreamer::Plan(candidates, 1000, 10) == std::vector<unsigned>{ 2, 2 });
+
+	// One image always moves, even over the upload budget.
+	REQUIRE(TextureStreamer::Plan(candidates, 1000, 1) == std::vector<unsigned>{ 2, 2 });
+}
+
+
+TEST_CASE("Texture streaming drops unwanted detail only to make room", "[GraphicsEngine]") {
+	std::vector<TextureStreamer::Candidate> candidates = {
+		{ levelSizes, 0, 3, 3, 1 },
+		{ levelSizes, 0, 3, 2, 5 },
+		{ levelSizes, 2, 3, 1, 9 },
+	};
+	REQUIRE(TextureStreamer::Plan(candidates, 191, 1000) == std::vector<unsigned>{ 0, 0, 1 });
+
+	// The least recently requested goes first.
+	REQUIRE(TextureStreamer::Plan(candidates, 180, 1000) == std::vector<unsigned>{ 3, 0, 1 });
+
+	// Nothing to free is left, the third one stays.
+	REQUIRE(TextureStreamer::Plan(candidates, 20, 1000) == std::vector<unsigned>{ 3, 2, 2 });
+}
+
+
+TEST_CASE("Texture streaming trims wanted levels over budget", "[GraphicsEngine]") {
+	std::vector<TextureStreamer::Candidate> candidates = {
+		{ levelSizes, 0, 3, 0, 1 },
+		{ levelSizes, 0, 3, 0, 2 },
+	};
+	REQUIRE(TextureStreamer::Plan(candidates, 170, 1000) == std::vector<unsigned>{ 0, 0 });
+	REQUIRE(TextureStreamer::Plan(candidates, 110, 1000) == std::vector<unsigned>{ 1, 0 });
+	REQUIRE(TextureStreamer::Plan(candidates, 100, 1000) == std::vector<unsigned>{ 1, 1 });
+}
+
+
+TEST_CASE("Texture streaming required level", "[GraphicsEngine]") {
+	REQUIRE(TextureStreamer::RequiredMip(1024, 1024.0f) == 0);
+	REQUIRE(TextureStreamer::RequiredMip(1024, 4096.0f) == 0);
+	REQUIRE(TextureStreamer::RequiredMip(1024, 256.0f) == 2);
+	REQUIRE(TextureStreamer::RequiredMip(1024, 300.0f) == 1);
+	REQUIRE(TextureStreamer::RequiredMip(1024, 0.0f) == IStreamedImage::NoRequest);
+	REQUIRE(TextureStreamer::GetResidentSize(levelSizes, 1) == 21);
+	REQUIRE(TextureStreamer::GetResidentSize(levelSizes, 4) == 0);
+}
@@ -0,0 +1,84 @@
+#include <GraphicsEngine_LL/TransientTexturePool.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+// Tasks: 0 -> 1 -> 3, 0 -> 2 -> 3, so 1 and 2 are unordered.
+static std::vector<std::vector<bool>> DiamondPrecedence() {
+	std::vector<std::vector<bool>> precedes(4, std::vector<bool>(4, false));
+	precedes[0][1] = precedes[0][2] = precedes[0][3] = true;
+	precedes[1][3] = true;
+	precedes[2][3] = true;
+	return precedes;
+}
+
+
+TEST_CASE("Transient textures are shared along the task order", "[GraphicsEngine]") {
+	TransientTexturePool pool;
+	pool.SetPrecedence(DiamondPrecedence());
+	pool.BeginFrame();
+
+	const Texture2DDesc desc{ 256, 256, gxapi::eFormat::R8G8B8A8_UNORM };
+	const auto flags = gxapi::eResourceFlags::ALLOW_RENDER_TARGET;
+
+	size_t first = pool.AcquireSlot(0, desc, flags);
+	size_t second = pool.AcquireSlot(0, desc, flags);
+	REQUIRE(first != second); // Same task, two textures.
+
+	size_t left = pool.AcquireSlot(1, desc, flags);
+	size_t right = pool.AcquireSlot(2, desc, flags);
+	REQUIRE(left != right); // Unordered tasks never share.
+	REQUIRE(pool.GetSlotCount() == 2);
+
+	size_t last = pool.AcquireSlot(3, desc, flags);
+	REQUIRE(last < 2);
+
+	SECTION("Different descriptions") {
+		pool.AcquireSlot(3, Texture2DDesc{ 128, 128, gxapi::eFormat::R8G8B8A8_UNORM }, flags);
+		pool.AcquireSlot(3, desc, gxapi::eResourceFlags::ALLOW_UNORDERED_ACCESS);
+		REQUIRE(pool.GetSlotCount() == 4);
+	}
+	SECTION("Statistics") {
+		pool.BeginFrame();
+		auto stats = pool.GetStatistics();
+		REQUIRE(stats.requestCount == 5);
+		REQUIRE(stats.textureCount == 2);
+		REQUIRE(stats.requestedBytes == 5 * 256 * 256 * 4);
+		REQUIRE(stats.allocatedBytes == 2 * 256 * 256 * 4);
+	}
+	SECTION("Stable across frames") {
+		pool.BeginFrame();
+		REQUIRE(pool.AcquireSlot(1, desc, flags) == left);
+		REQUIRE(pool.AcquireSlot(2, desc, flags) == right);
+	}
+}
+
+
+TEST_CASE("Transient textures without aliasing", "[GraphicsEngine]") {
+	TransientTexturePool pool;
+	pool.SetPrecedence(DiamondPrecedence());
+	pool.SetAliasing(false);
+	pool.BeginFrame();
+
+	const Texture2DDesc desc{ 64, 64, gxapi::eFormat::R16G16B16A16_FLOAT };
+	for (size_t task = 0; task < 4; ++task) {
+		pool.AcquireSlot(task, desc, gxapi::eResourceFlags::NONE);
+	}
+	REQUIRE(pool.GetSlotCount() == 4);
+
+	// Unused textures go away after a few frames.
+	for (int i = 0; i < 6; ++i) {
+		pool.BeginFrame();
+	}
+	REQUIRE(pool.GetSlotCount() == 0);
+}
+
+
+TEST_CASE("Transient texture size estimate", "[GraphicsEngine]") {
+	REQUIRE(TransientTexturePool::EstimateSize({ 4, 4, gxapi::eFormat::R8G8B8A8_UNORM }) == 64);
+	REQUIRE(TransientTexturePool::EstimateSize({ 4, 4, gxapi::eFormat::R8G8B8A8_UNORM, 0 }) == 64 + 16 + 4);
+	REQUIRE(TransientTexturePool::EstimateSize({ 4, 4, gxapi::eFormat::R8G8B8A8_UNORM, 2, 3 }) == (64 + 16) * 3);
+}
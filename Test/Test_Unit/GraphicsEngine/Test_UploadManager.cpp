@@ -0,0 +1,83 @@
+#include <GraphicsApi_Null/GxapiManager.hpp>
+#include <GraphicsApi_LL/IGraphicsApi.hpp>
+#include <GraphicsApi_LL/IResource.hpp>
+#include <GraphicsEngine_LL/UploadManager.hpp>
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <cstring>
+#include <memory>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+static LinearBuffer CreateTarget(gxapi::IGraphicsApi* api, size_t size) {
+	auto resource = MemoryObject::UniquePtr(
+		api->CreateCommittedResource(gxapi::HeapProperties(gxapi::eHeapType::DEFAULT),
+									 gxapi::eHeapFlags::NONE,
+									 gxapi::ResourceDesc::Buffer(size),
+									 gxapi::eResourceState::COMMON),
+		std::default_delete<const gxapi::IResource>());
+	return LinearBuffer(std::move(resource), true, eResourceHeap::CRITICAL);
+}
+
+
+static const uint8_t* GetSourceData(const UploadManager::UploadDescription& upload) {
+	return static_cast<const uint8_t*>(upload.source._GetResourcePtr()->Map(0, nullptr)) + upload.sourceOffset;
+}
+
+
+TEST_CASE("In-place uploads of touching ranges merge into one copy", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	UploadManager uploadManager(api.get());
+	uploadManager.OnFrameBeginAwait(1);
+
+	LinearBuffer target = CreateTarget(api.get(), 256);
+	std::memset(uploadManager.UploadInPlace(target, 16, 16), 1, 16);
+	std::memset(uploadManager.UploadInPlace(target, 32, 16), 2, 16);
+	std::memset(uploadManager.UploadInPlace(target, 0, 16), 3, 16);
+	// Inside the merged range, the later write wins.
+	std::memset(uploadManager.UploadInPlace(target, 20, 4), 4, 4);
+
+	size_t copies = 0;
+	for (const auto& upload : uploadManager.GetQueuedUploads()) {
+		if (upload.sourceSize == 0) {
+			continue;
+		}
+		++copies;
+		REQUIRE(upload.dstOffsetX == 0);
+		REQUIRE(upload.sourceSize == 48);
+		const uint8_t* data = GetSourceData(upload);
+		REQUIRE(data[0] == 3);
+		REQUIRE(data[16] == 1);
+		REQUIRE(data[20] == 4);
+		REQUIRE(data[24] == 1);
+		REQUIRE(data[47] == 2);
+	}
+	REQUIRE(copies == 1);
+}
+
+
+TEST_CASE("In-place uploads keep separate ranges and buffers apart", "[GraphicsEngine]") {
+	gxapi_null::GxapiManager manager;
+	std::unique_ptr<gxapi::IGraphicsApi> api(manager.CreateGraphicsApi(0));
+	UploadManager uploadManager(api.get());
+	uploadManager.OnFrameBeginAwait(1);
+
+	LinearBuffer first = CreateTarget(api.get(), 256);
+	LinearBuffer second = CreateTarget(api.get(), 256);
+	uploadManager.UploadInPlace(first, 0, 16);
+	uploadManager.UploadInPlace(first, 64, 16);
+	uploadManager.UploadInPlace(second, 16, 16);
+
+	size_t copies = 0;
+	for (const auto& upload : uploadManager.GetQueuedUploads()) {
+		copies += upload.sourceSize > 0;
+	}
+	REQUIRE(copies == 3);
+	REQUIRE_THROWS_AS(uploadManager.UploadInPlace(first, 250, 16), InvalidArgumentException);
+}
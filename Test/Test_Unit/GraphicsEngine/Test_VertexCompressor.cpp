@@ -0,0 +1,130 @@
+#include <GraphicsEngine_LL/VertexCompressor.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <cmath>
+#include <cstring>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("Vertex compressor half floats", "[GraphicsEngine]") {
+	REQUIRE(VertexCompressor::FloatToHalf(0.0f) == 0x0000);
+	REQUIRE(VertexCompressor::FloatToHalf(1.0f) == 0x3C00);
+	REQUIRE(VertexCompressor::FloatToHalf(-2.0f) == 0xC000);
+	REQUIRE(VertexCompressor::FloatToHalf(65504.0f) == 0x7BFF);
+	REQUIRE(VertexCompressor::FloatToHalf(1e6f) == 0x7C00);
+	REQUIRE(VertexCompressor::FloatToHalf(std::ldexp(1.0f, -24)) == 0x0001);
+
+	for (float value : { 0.5f, 0.1f, 0.999f, 3.14159f, -17.25f, 1000.3f, 1e-5f }) {
+		float roundTrip = VertexCompressor::HalfToFloat(VertexCompressor::FloatToHalf(value));
+		REQUIRE(std::abs(roundTrip - value) <= std::abs(value) * 0.001f + 1e-7f);
+	}
+}
+
+
+TEST_CASE("Vertex compressor octahedral directions", "[GraphicsEngine]") {
+	for (Vec3 direction : { Vec3(0, 0, 1), Vec3(0, 0, -1), Vec3(1, 0, 0), Vec3(-0.3f, 0.8f, -0.52f), Vec3(0.6f, -0.6f, 0.529f) }) {
+		direction.Normalize();
+		Vec2 encoded = VertexCompressor::EncodeOctahedral(direction);
+		REQUIRE(std::abs(encoded.x) <= 1.0f);
+		REQUIRE(std::abs(encoded.y) <= 1.0f);
+		Vec3 decoded = VertexCompressor::DecodeOctahedral(encoded);
+		REQUIRE(Dot(decoded, direction) > 0.9999f);
+	}
+}
+
+
+TEST_CASE("Vertex compressor layout and quantization", "[GraphicsEngine]") {
+	using VertexT = Vertex<Position<0>, Normal<0>, TexCoord<0>, Color<0>>;
+	std::vector<VertexT> vertices(5);
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		vertices[i].position = Vec3(-2.0f + float(i), 1.0f, 0.5f * float(i));
+		vertices[i].normal = Vec3(1.0f, float(i) - 2.0f, -1.0f).Normalized();
+		vertices[i].texCoord = Vec2(0.25f * float(i), 1.0f);
+		vertices[i].color = Vec3(0.1f, 0.2f, float(i));
+	}
+
+	BoundingBox bounds;
+	for (const auto& vertex : vertices) {
+		bounds.Extend(Vec3(vertex.position));
+	}
+	PositionQuantization quantization = PositionQuantization::FromBounds(bounds);
+	REQUIRE(quantization.scale == Approx(4.0f));
+
+	const IVertexReader* reader = &vertices[0].GetReader();
+	VertexCompressor compressor{ reader, std::vector<bool>(reader->GetElements().size(), true), quantization };
+	REQUIRE(compressor.GetCompressedStride() == 28);
+
+	std::vector<int> offsets = compressor.GetCompressedOffsets();
+	std::vector<gxapi::eFormat> formats = compressor.GetCompressedFormats();
+	const auto& elements = reader->GetElements();
+	for (size_t i = 0; i < elements.size(); ++i) {
+		switch (elements[i].semantic) {
+			case eVertexElementSemantic::POSITION:
+				REQUIRE(offsets[i] == 0);
+				REQUIRE(formats[i] == gxapi::eFormat::R16G16B16A16_UNORM);
+				break;
+			case eVertexElementSemantic::NORMAL:
+				REQUIRE(offsets[i] == 8);
+				REQUIRE(formats[i] == gxapi::eFormat::R16G16_SNORM);
+				break;
+			case eVertexElementSemantic::TEX_COORD:
+				REQUIRE(offsets[i] == 12);
+				REQUIRE(formats[i] == gxapi::eFormat::R16G16_FLOAT);
+				break;
+			case eVertexElementSemantic::COLOR:
+				REQUIRE(offsets[i] == 16);
+				REQUIRE(formats[i] == gxapi::eFormat::R32G32B32_FLOAT);
+				break;
+			default:
+				FAIL();
+		}
+	}
+
+	std::vector<uint8_t> data = compressor.GetCompressedStream(vertices.data(), vertices.size());
+	REQUIRE(data.size() == 28 * vertices.size());
+	Mat44 dequantization = quantization.GetDequantization();
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		const uint8_t* vertex = data.data() + 28 * i;
+
+		uint16_t position[4];
+		std::memcpy(position, vertex, sizeof(position));
+		REQUIRE(position[3] == 0xFFFF);
+		Vec4 restored = Vec4(position[0] / 65535.0f, position[1] / 65535.0f, position[2] / 65535.0f, 1.0f) * dequantization;
+		REQUIRE(restored.x == Approx(vertices[i].position.x).margin(1e-4f));
+		REQUIRE(restored.y == Approx(vertices[i].position.y).margin(1e-4f));
+		REQUIRE(restored.z == Approx(vertices[i].position.z).margin(1e-4f));
+
+		int16_t normal[2];
+		std::memcpy(normal, vertex + 8, sizeof(normal));
+		Vec3 decoded = VertexCompressor::DecodeOctahedral({ normal[0] / 32767.0f, normal[1] / 32767.0f });
+		REQUIRE(Dot(decoded, Vec3(vertices[i].normal)) > 0.9999f);
+
+		uint16_t texCoord[2];
+		std::memcpy(texCoord, vertex + 12, sizeof(texCoord));
+		REQUIRE(VertexCompressor::HalfToFloat(texCoord[0]) == vertices[i].texCoord.x);
+		REQUIRE(VertexCompressor::HalfToFloat(texCoord[1]) == vertices[i].texCoord.y);
+
+		REQUIRE(std::memcmp(vertex + 16, &vertices[i].color, 12) == 0);
+	}
+}
+
+
+TEST_CASE("Vertex compressor clamps positions outside the range", "[GraphicsEngine]") {
+	using VertexT = Vertex<Position<0>>;
+	std::vector<VertexT> vertices(3);
+	vertices[0].position = Vec3(-1.0f, 0.5f, 2.0f);
+	vertices[1].position = Vec3(0.25f, 0.5f, 0.75f);
+	vertices[2].position = Vec3(0.0f, 0.0f, 1.0f);
+
+	PositionQuantization quantization = PositionQuantization::FromBounds(BoundingBox(Vec3(0.0f), Vec3(1.0f)));
+	const IVertexReader* reader = &vertices[0].GetReader();
+	VertexCompressor compressor{ reader, { true }, quantization };
+	std::vector<uint8_t> data = compressor.GetCompressedStream(vertices.data(), vertices.size());
+
+	std::vector<uint16_t> values(data.size() / sizeof(uint16_t));
+	std::memcpy(values.data(), data.data(), data.size());
+	REQUIRE(values == std::vector<uint16_t>{ 0, 32768, 65535, 65535, 16384, 32768, 49151, 65535, 0, 0, 65535, 65535 });
+}
@@ -0,0 +1,49 @@
+#include <GraphicsEngine_LL/ViewSet.hpp>
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+TEST_CASE("ViewSet split screen layout", "[GraphicsEngine]") {
+	// Views only store the cameras, they are never dereferenced.
+	const BasicCamera* cameras[] = {
+		reinterpret_cast<const BasicCamera*>(0x10),
+		reinterpret_cast<const BasicCamera*>(0x20),
+		reinterpret_cast<const BasicCamera*>(0x30),
+	};
+
+	ViewSet views;
+	views.AddSplitScreen(cameras, 2);
+	REQUIRE(views.GetViewCount() == 2);
+	REQUIRE(views[1].camera == cameras[1]);
+	REQUIRE(views[1].left == Approx(0.5f));
+	REQUIRE(views[1].width == Approx(0.5f));
+	REQUIRE(views[1].height == Approx(1.0f));
+
+	views.Clear();
+	views.AddSplitScreen(cameras, 3);
+	REQUIRE(views.GetViewCount() == 3);
+	REQUIRE(views[2].left == Approx(0.0f));
+	REQUIRE(views[2].top == Approx(0.5f));
+	REQUIRE(views[2].height == Approx(0.5f));
+}
+
+
+TEST_CASE("ViewSet masks", "[GraphicsEngine]") {
+	const MeshEntity* culled = reinterpret_cast<const MeshEntity*>(0x10);
+	const MeshEntity* unknown = reinterpret_cast<const MeshEntity*>(0x20);
+
+	ViewSet views;
+	views.SetMask(culled, 0b10);
+	REQUIRE(views.GetMask(culled) == 0b10);
+	REQUIRE(views.GetMask(unknown) == ViewSet::AllViews);
+
+	for (size_t i = 0; i < ViewSet::MaxViews; ++i) {
+		views.AddView(nullptr, 0.0f, 0.0f, 1.0f, 1.0f);
+	}
+	REQUIRE_THROWS_AS(views.AddView(nullptr, 0.0f, 0.0f, 1.0f, 1.0f), InvalidArgumentException);
+}